@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * remux.c: LibVLC batch remuxer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc/vlc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <getopt.h>
+
+static void version (void)
+{
+    puts ("LibVLC batch remuxer version "VERSION);
+}
+
+static void usage (const char *path)
+{
+    printf (
+"Usage: %s [options] <input> <output> [<input> <output>...]\n"
+"Rewrite media into another container without decoding them.\n"
+"\n"
+"  -j, --jobs <n>     remux n media concurrently (default: 1)\n"
+"  -m, --mux <name>   muxer of the outputs (default: mp4)\n"
+"  -v, --verbose      print LibVLC messages\n"
+"  -h, --help         print this help and exit\n"
+"  -V, --version      print version and exit\n",
+            path);
+}
+
+int main (int argc, char *argv[])
+{
+    static const struct option opts[] =
+    {
+        { "jobs",       required_argument, NULL, 'j' },
+        { "mux",        required_argument, NULL, 'm' },
+        { "verbose",    no_argument,       NULL, 'v' },
+        { "help",       no_argument,       NULL, 'h' },
+        { "version",    no_argument,       NULL, 'V' },
+        { NULL,         no_argument,       NULL, '\0'}
+    };
+
+    const char *mux = "mp4";
+    unsigned jobs = 1;
+    bool verbose = false;
+    int c;
+
+    while ((c = getopt_long (argc, argv, "j:m:vhV", opts, NULL)) != -1)
+        switch (c)
+        {
+            case 'j':
+                jobs = strtoul (optarg, NULL, 0);
+                break;
+            case 'm':
+                mux = optarg;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'h':
+                usage (argv[0]);
+                return 0;
+            case 'V':
+                version ();
+                return 0;
+            default:
+                usage (argv[0]);
+                return 1;
+        }
+
+    if (optind == argc || ((argc - optind) & 1))
+    {
+        usage (argv[0]);
+        return 1;
+    }
+
+    const char *vlc_argv[4];
+    int vlc_argc = 0;
+
+    if (!verbose)
+        vlc_argv[vlc_argc++] = "--quiet";
+    vlc_argv[vlc_argc++] = "--ignore-config";
+    vlc_argv[vlc_argc++] = "--"; /* end of options */
+    vlc_argv[vlc_argc] = NULL;
+
+    libvlc_instance_t *vlc = libvlc_new (vlc_argc, vlc_argv);
+    if (vlc == NULL)
+        return 1;
+
+    libvlc_remux_t *remux = libvlc_remux_new (vlc, jobs);
+    if (remux == NULL)
+    {
+        libvlc_release (vlc);
+        return 1;
+    }
+
+    unsigned failed = 0;
+
+    for (int i = optind; i < argc; i += 2)
+    {
+        const char *in = argv[i], *out = argv[i + 1];
+        char *mrl = NULL;
+
+        /* Plain paths are taken as local files */
+        if (strstr (in, "://") == NULL)
+        {
+            libvlc_media_t *m = libvlc_media_new_path (in);
+            if (m != NULL)
+            {
+                mrl = libvlc_media_get_mrl (m);
+                libvlc_media_release (m);
+            }
+        }
+
+        if (libvlc_remux_add (remux, (mrl != NULL) ? mrl : in, mux, out))
+        {
+            fprintf (stderr, "%s: %s\n", in, libvlc_errmsg ());
+            failed++;
+        }
+        free (mrl);
+    }
+
+    failed += libvlc_remux_wait (remux);
+    libvlc_remux_release (remux);
+    libvlc_release (vlc);
+
+    if (failed > 0)
+        fprintf (stderr, "%u media could not be remuxed\n", failed);
+    return failed > 0;
+}
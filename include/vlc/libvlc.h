@@ -567,6 +567,45 @@ static inline int64_t libvlc_delay(int64_t pts)
 
 /** @} */
 
+/** \defgroup libvlc_memory LibVLC memory accounting
+ * The large allocations are charged to the subsystem owning them, each with
+ * a budget set by the --frame-memory-budget, --picture-memory-budget and
+ * --cache-memory-budget options, in MiB.
+ * \note The accounting is shared by all the instances of the process.
+ * @{
+ */
+
+typedef enum libvlc_memory_subsystem_t
+{
+    libvlc_memory_frame = 0,   /**< data frames: demuxed, encoded, buffered */
+    libvlc_memory_picture,     /**< software picture buffers */
+    libvlc_memory_cache,       /**< content caches */
+} libvlc_memory_subsystem_t;
+
+typedef struct libvlc_memory_stats_t
+{
+    uint64_t i_used;   /**< bytes currently charged */
+    uint64_t i_peak;   /**< highest charge since the process started */
+    uint64_t i_budget; /**< budget in bytes, 0 if unlimited */
+} libvlc_memory_stats_t;
+
+/**
+ * Get the memory accounting of a subsystem.
+ *
+ * \version LibVLC 4.0.0 and later.
+ *
+ * \param p_instance libvlc instance
+ * \param subsystem the subsystem
+ * \param p_stats structure to fill [OUT]
+ * \return 0 on success, -1 if the subsystem is unknown
+ */
+LIBVLC_API
+int libvlc_memory_get_stats( libvlc_instance_t *p_instance,
+                             libvlc_memory_subsystem_t subsystem,
+                             libvlc_memory_stats_t *p_stats );
+
+/** @} */
+
 # ifdef __cplusplus
 }
 # endif
@@ -99,6 +99,8 @@ enum
     libvlc_media_option_unique = 0x100
 };
 
+#define LIBVLC_MEDIA_STATS_DECODE_TIME_BUCKETS 8
+
 typedef struct libvlc_media_stats_t
 {
     /* Input */
@@ -114,6 +116,12 @@ typedef struct libvlc_media_stats_t
     /* Decoders */
     int         i_decoded_video;
     int         i_decoded_audio;
+    /** Decode calls by duration: the first bucket counts the calls shorter
+     * than 1 ms, bucket n those between 2^(n-1) and 2^n ms, and the last
+     * bucket all the longer ones */
+    int         i_decode_time[LIBVLC_MEDIA_STATS_DECODE_TIME_BUCKETS];
+    /** Deepest decoder input queue, in frames, over the last second or so */
+    int         i_decoder_queue_max;
 
     /* Video Output */
     int         i_displayed_pictures;
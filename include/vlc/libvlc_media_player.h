@@ -500,6 +500,153 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup );
 
+/**
+ * Decoded video frame, as handed over by @ref libvlc_video_frame_cb.
+ */
+typedef struct libvlc_video_frame_t libvlc_video_frame_t;
+
+/**
+ * Kind of hardware surface backing a video frame.
+ */
+typedef enum libvlc_video_surface_type_t {
+    libvlc_video_surface_none = 0,      /**< planes in main memory */
+    libvlc_video_surface_dmabuf,        /**< Linux DMA buffer file descriptor */
+    libvlc_video_surface_d3d11,         /**< ID3D11Texture2D* */
+    libvlc_video_surface_cvpixelbuffer, /**< CVPixelBufferRef */
+} libvlc_video_surface_type_t;
+
+/**
+ * Format of a video frame.
+ */
+typedef struct libvlc_video_frame_format_t
+{
+    char chroma[5];                  /**< four-characters chroma, e.g. "I420" */
+    unsigned width, height;          /**< buffer size in pixels */
+    unsigned x_offset, y_offset;     /**< top left corner of the visible area */
+    unsigned visible_width, visible_height; /**< visible size in pixels */
+    unsigned sar_num, sar_den;       /**< sample aspect ratio */
+} libvlc_video_frame_format_t;
+
+/**
+ * Callback prototype to receive a decoded video frame.
+ *
+ * The callback is invoked when the frame needs to be shown, as determined by
+ * the media playback clock. The application owns a reference to the frame
+ * and must release it with libvlc_video_frame_release(), from any thread,
+ * when it is done with it.
+ *
+ * \warning The decoder reuses a bounded number of pictures: holding too many
+ * frames for too long stalls the playback.
+ *
+ * \param[in] opaque private pointer as passed to
+ *                   libvlc_video_set_frame_callback()
+ * \param[in] frame the decoded frame
+ */
+typedef void (*libvlc_video_frame_cb)(void *opaque,
+                                      libvlc_video_frame_t *frame);
+
+/**
+ * Set a callback to receive the decoded video frames without any copy.
+ *
+ * Unlike libvlc_video_set_callbacks(), the frames are handed over as decoded:
+ * there is no chroma conversion and no copy into application buffers.
+ * Hardware decoded frames are handed over as their surfaces, if the
+ * platform allows sharing them (DMA buffers from VA-API, Direct3D 11
+ * textures, CoreVideo pixel buffers); other hardware decoders fall back to
+ * software decoding.
+ *
+ * This must be called before the playback starts.
+ *
+ * \param mp the media player
+ * \param cb callback to receive the frames (must not be NULL)
+ * \param opaque private pointer for the callback (as first parameter)
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_set_frame_callback( libvlc_media_player_t *mp,
+                                      libvlc_video_frame_cb cb,
+                                      void *opaque );
+
+/**
+ * Retain a reference to a video frame.
+ *
+ * \param frame the frame
+ * \return the same frame
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+libvlc_video_frame_t *libvlc_video_frame_retain( libvlc_video_frame_t *frame );
+
+/**
+ * Release a reference to a video frame.
+ *
+ * The underlying picture is given back to the decoder with the last
+ * reference.
+ *
+ * \param frame the frame
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_frame_release( libvlc_video_frame_t *frame );
+
+/**
+ * Get the format of a video frame.
+ *
+ * \param frame the frame
+ * \param[out] format the format of the frame
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_frame_get_format( const libvlc_video_frame_t *frame,
+                                    libvlc_video_frame_format_t *format );
+
+/**
+ * Get the presentation time of a video frame.
+ *
+ * \param frame the frame
+ * \return the time of the frame in the media, in milliseconds
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+libvlc_time_t libvlc_video_frame_get_time( const libvlc_video_frame_t *frame );
+
+/**
+ * Get a plane of a video frame.
+ *
+ * \param frame the frame
+ * \param plane index of the plane
+ * \param[out] pitch scanline pitch of the plane in bytes
+ * \param[out] lines number of scanlines of the plane
+ * \param[out] offset offset of the plane within the DMA buffer
+ *                    (or NULL if not needed; 0 for other frames)
+ * \return the pixels of the plane, NULL for hardware surfaces, or NULL with
+ *         a zero pitch if there is no such plane
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+const void *libvlc_video_frame_get_plane( const libvlc_video_frame_t *frame,
+                                          unsigned plane, unsigned *pitch,
+                                          unsigned *lines, size_t *offset );
+
+/**
+ * Get the hardware surface of a video frame.
+ *
+ * The surface remains valid as long as the frame is retained. A DMA buffer
+ * file descriptor is owned by the frame and must be duplicated to outlive it.
+ *
+ * \param frame the frame
+ * \param[out] handle the surface: the file descriptor (cast from intptr_t)
+ *                    for DMA buffers, the object pointer otherwise
+ *                    (or NULL if not needed)
+ * \param[out] index the texture array slice for Direct3D 11, 0 otherwise
+ *                   (or NULL if not needed)
+ * \return the type of surface, libvlc_video_surface_none for main memory
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API libvlc_video_surface_type_t
+libvlc_video_frame_get_surface( const libvlc_video_frame_t *frame,
+                                void **handle, unsigned *index );
+
 
 typedef struct libvlc_video_setup_device_cfg_t
 {
@@ -1122,6 +1269,111 @@ LIBVLC_API
 void libvlc_audio_set_format( libvlc_media_player_t *mp, const char *format,
                               unsigned rate, unsigned channels );
 
+/**
+ * Decoded audio frame, as handed over by @ref libvlc_audio_frame_cb.
+ */
+typedef struct libvlc_audio_frame_t libvlc_audio_frame_t;
+
+/**
+ * Callback prototype to receive decoded audio samples.
+ *
+ * The application owns a reference to the frame and must release it with
+ * libvlc_audio_frame_release(), from any thread, when it is done with it.
+ *
+ * \param[in] opaque private pointer as passed to
+ *                   libvlc_audio_set_frame_callback()
+ * \param[in] frame the audio frame
+ */
+typedef void (*libvlc_audio_frame_cb)(void *opaque,
+                                      libvlc_audio_frame_t *frame);
+
+/**
+ * Set a callback to receive the decoded audio samples without any copy.
+ *
+ * Unlike the play callback of libvlc_audio_set_callbacks(), the samples are
+ * handed over in their buffer, which the application keeps as long as
+ * needed.
+ *
+ * Unless libvlc_audio_set_format() or libvlc_audio_set_format_callbacks()
+ * request another format, the samples keep the decoded format, rate and
+ * channels layout (up to 8 channels), so that no conversion happens. A
+ * setup callback is proposed the decoded format likewise, rather than
+ * "S16N".
+ *
+ * \note This overrides any other audio output mechanism, including the play
+ * callback of libvlc_audio_set_callbacks().
+ *
+ * \param mp the media player
+ * \param cb callback to receive the frames (must not be NULL)
+ * \param opaque private pointer for the callback (as first parameter), and
+ *               for the format callbacks
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_audio_set_frame_callback( libvlc_media_player_t *mp,
+                                      libvlc_audio_frame_cb cb,
+                                      void *opaque );
+
+/**
+ * Retain a reference to an audio frame.
+ *
+ * \param frame the frame
+ * \return the same frame
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+libvlc_audio_frame_t *libvlc_audio_frame_retain( libvlc_audio_frame_t *frame );
+
+/**
+ * Release a reference to an audio frame.
+ *
+ * \param frame the frame
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_audio_frame_release( libvlc_audio_frame_t *frame );
+
+/**
+ * Get the samples of an audio frame.
+ *
+ * The samples are interleaved.
+ *
+ * \param frame the frame
+ * \param[out] count number of samples per channel
+ * \return the samples
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+const void *libvlc_audio_frame_get_samples( const libvlc_audio_frame_t *frame,
+                                            unsigned *count );
+
+/**
+ * Get the format of an audio frame.
+ *
+ * \param frame the frame
+ * \param[out] format four-characters sample format, e.g. "FL32"
+ * \param[out] rate sample rate in Hz
+ * \param[out] channels number of channels
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_audio_frame_get_format( const libvlc_audio_frame_t *frame,
+                                    char format[5], unsigned *rate,
+                                    unsigned *channels );
+
+/**
+ * Get the timestamps of an audio frame.
+ *
+ * \param frame the frame
+ * \param[out] pts the play date, as passed to @ref libvlc_audio_play_cb
+ *                 (or NULL if not needed)
+ * \return the time of the frame in the media, in milliseconds
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+libvlc_time_t libvlc_audio_frame_get_time( const libvlc_audio_frame_t *frame,
+                                           int64_t *pts );
+
 /** \bug This might go away ... to be replaced by a broader system */
 
 /**
@@ -2064,6 +2316,51 @@ int libvlc_video_take_snapshot( libvlc_media_player_t *p_mi, unsigned num,
                                 const char *psz_filepath, unsigned int i_width,
                                 unsigned int i_height );
 
+/**
+ * Callback prototype for asynchronous snapshots
+ *
+ * \param opaque the data given to libvlc_video_take_snapshot_async()
+ * \param picture the snapshot, or NULL on error or if the video output was
+ * closed before displaying a picture. The picture must be retained with
+ * libvlc_picture_retain() to be used after the callback returns.
+ */
+typedef void (*libvlc_video_snapshot_cb)( void *opaque,
+                                          libvlc_picture_t *picture );
+
+/**
+ * Take a snapshot of the current video window asynchronously.
+ *
+ * Unlike libvlc_video_take_snapshot(), the picture is neither converted nor
+ * encoded by the video output thread: it is referenced when displayed, then
+ * downloaded, scaled and encoded on a snapshot worker thread, which calls the
+ * callback. This is suited for frequent snapshots of playing videos.
+ *
+ * If i_width AND i_height is 0, original size is used.
+ * If i_width XOR i_height is 0, original aspect-ratio is preserved.
+ *
+ * The callback is called exactly once if this function succeeds, at the
+ * latest when the video output is closed. It must not call LibVLC functions
+ * of the media player.
+ *
+ * \param p_mi media player instance
+ * \param num number of video output (typically 0 for the first/only one)
+ * \param type the picture type
+ * \param i_width the snapshot's width
+ * \param i_height the snapshot's height
+ * \param cb the completion callback
+ * \param opaque data passed to the callback
+ * \return 0 on success, -1 if the video was not found or on error
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+int libvlc_video_take_snapshot_async( libvlc_media_player_t *p_mi,
+                                      unsigned num,
+                                      libvlc_picture_type_t type,
+                                      unsigned int i_width,
+                                      unsigned int i_height,
+                                      libvlc_video_snapshot_cb cb,
+                                      void *opaque );
+
 /**
  * Enable or disable deinterlace filter
  *
@@ -2700,6 +2997,29 @@ LIBVLC_API int libvlc_media_player_get_role(libvlc_media_player_t *p_mi);
 LIBVLC_API int libvlc_media_player_set_role(libvlc_media_player_t *p_mi,
                                             unsigned role);
 
+/**
+ * Sets the placement and priority of the threads playing the media.
+ *
+ * The policy applies to the threads of the next played media (input,
+ * decoders, outputs), and overrides the one of the LibVLC instance
+ * (--thread-affinity, --thread-priorities and --thread-cgroup options).
+ * Passing NULL for all the parameters restores the policy of the instance.
+ *
+ * \version LibVLC 4.0.0 and later.
+ *
+ * \param p_mi media player
+ * \param cpus list of processors, such as "0-3,8", or NULL for any
+ * \param priorities scheduling classes by thread role, such as
+ *        "vout=high,aout=realtime", or NULL for the default classes
+ * \param cgroup path of a threaded control group (version 2) to move the
+ *        threads to, or NULL (Linux only)
+ * \return 0 on success, -1 on error
+ */
+LIBVLC_API int libvlc_media_player_set_thread_policy(libvlc_media_player_t *p_mi,
+                                                     const char *cpus,
+                                                     const char *priorities,
+                                                     const char *cgroup);
+
 /**
  * Start/stop recording
  *
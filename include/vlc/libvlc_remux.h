@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * libvlc_remux.h:  libvlc external API
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_LIBVLC_REMUX_H
+#define VLC_LIBVLC_REMUX_H 1
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** \defgroup libvlc_remux LibVLC batch remuxing
+ * \ingroup libvlc
+ * LibVLC batch remuxing rewrites media into another container, without
+ * decoding, several files at a time.
+ *
+ * The media are demuxed as fast as the outputs accept the data, instead of
+ * being paced by the clock, and the output files are written with large
+ * sequential writes. The timestamps are kept as they are.
+ * @{
+ * \file
+ * LibVLC batch remuxing external API
+ */
+
+typedef struct libvlc_remux_t libvlc_remux_t;
+
+/**
+ * Create a batch remuxer.
+ *
+ * \param p_instance the libvlc instance
+ * \param i_jobs number of media remuxed concurrently (at least 1)
+ * \return the batch remuxer, or NULL on error
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API libvlc_remux_t *
+libvlc_remux_new( libvlc_instance_t *p_instance, unsigned i_jobs );
+
+/**
+ * Queue a media to remux.
+ *
+ * The media is processed as soon as one of the jobs is available.
+ *
+ * \param p_remux the batch remuxer
+ * \param psz_mrl the media to read
+ * \param psz_mux the muxer to write with (e.g. "mp4", "mkv", "ts")
+ * \param psz_dst the path of the file to write, overwritten if it exists
+ * \return 0 on success, -1 on error
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API int
+libvlc_remux_add( libvlc_remux_t *p_remux, const char *psz_mrl,
+                  const char *psz_mux, const char *psz_dst );
+
+/**
+ * Wait for the queued media to be remuxed.
+ *
+ * \param p_remux the batch remuxer
+ * \return the number of media which failed since the remuxer was created
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API unsigned
+libvlc_remux_wait( libvlc_remux_t *p_remux );
+
+/**
+ * Release a batch remuxer.
+ *
+ * The media still queued are dropped, and the ones being remuxed are
+ * interrupted, leaving incomplete outputs.
+ *
+ * \param p_remux the batch remuxer
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API void
+libvlc_remux_release( libvlc_remux_t *p_remux );
+
+/**@} */
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif /* VLC_LIBVLC_REMUX_H */
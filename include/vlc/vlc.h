@@ -44,6 +44,7 @@ extern "C" {
 #include "libvlc_media_list.h"
 #include "libvlc_media_list_player.h"
 #include "libvlc_media_discoverer.h"
+#include "libvlc_remux.h"
 #include "libvlc_events.h"
 #include "libvlc_dialog.h"
 #include "libvlc_version.h"
@@ -59,6 +59,11 @@
  * above which upsampling will be performed */
 #define AOUT_MAX_PTS_DELAY              VLC_TICK_FROM_MS(60)
 
+/** Target output latency in low-latency mode ("audio-low-latency").
+ * Outputs size their device buffer to this value, and the drift tolerances
+ * are reduced to half of it. */
+#define AOUT_LOW_LATENCY_TIME           VLC_TICK_FROM_MS(20)
+
 /* Max acceptable resampling (in %) */
 #define AOUT_MAX_RESAMPLING             10
 
@@ -568,6 +573,11 @@ typedef struct
      * binauralizer audio filter).
      */
     bool headphones;
+    /**
+     * Replay gain of the played track, if known. It is forwarded to the audio
+     * filters in their input format.
+     */
+    audio_replay_gain_t replay_gain;
 } aout_filters_cfg_t;
 
 #define AOUT_FILTERS_CFG_INIT (aout_filters_cfg_t) \
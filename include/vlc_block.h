@@ -80,11 +80,16 @@
 
 #define block_Init vlc_frame_Init
 #define block_Alloc vlc_frame_Alloc
+#define block_AllocPooled vlc_frame_AllocPooled
 #define block_TryRealloc vlc_frame_TryRealloc
 #define block_Realloc vlc_frame_Realloc
 #define block_Release vlc_frame_Release
 #define block_CopyProperties vlc_frame_CopyProperties
 #define block_Duplicate vlc_frame_Duplicate
+#define block_MakeShared vlc_frame_MakeShared
+#define block_MoveLocal vlc_frame_MoveLocal
+#define block_Share vlc_frame_Share
+#define block_Writable vlc_frame_Writable
 #define block_heap_Alloc vlc_frame_heap_Alloc
 #define block_mmap_Alloc vlc_frame_mmap_Alloc
 #define block_shm_Alloc vlc_frame_shm_Alloc
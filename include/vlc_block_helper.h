@@ -228,6 +228,40 @@ static inline int block_SkipByte( block_bytestream_t *p_bytestream )
     return block_GetBytes( p_bytestream, NULL, 1 );
 }
 
+/**
+ * Skips data up to the next occurrence of a byte value.
+ *
+ * This looks for the first byte of a synchronization word much faster than
+ * checking the data byte per byte.
+ *
+ * @return VLC_SUCCESS if the read pointer is now on the byte value, or
+ * VLC_EGENERIC if it was not found, in which case all the data was skipped
+ */
+static inline int block_SkipToByte( block_bytestream_t *p_bytestream,
+                                    uint8_t i_byte )
+{
+    size_t i_offset = p_bytestream->i_block_offset;
+    for( block_t *p_block = p_bytestream->p_block;
+         p_block != NULL; p_block = p_block->p_next )
+    {
+        const uint8_t *p = (const uint8_t *)
+            memchr( &p_block->p_buffer[i_offset], i_byte,
+                    p_block->i_buffer - i_offset );
+        if( p != NULL || p_block->p_next == NULL )
+        {
+            p_bytestream->p_block = p_block;
+            p_bytestream->i_block_offset = p ? (size_t)(p - p_block->p_buffer)
+                                             : p_block->i_buffer;
+            return p ? VLC_SUCCESS : VLC_EGENERIC;
+        }
+
+        p_bytestream->i_base_offset += p_block->i_buffer;
+        i_offset = 0;
+    }
+
+    return VLC_EGENERIC;
+}
+
 static inline int block_PeekOffsetBytes( block_bytestream_t *p_bytestream,
     size_t i_peek_offset, uint8_t *p_data, size_t i_data )
 {
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ * vlc_cachefile.h: files of the user cache directory
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_CACHEFILE_H
+#define VLC_CACHEFILE_H
+
+#include <stdio.h>
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/**
+ * \defgroup cachefile Cache files
+ * \ingroup misc
+ *
+ * Data computed from a resource (indexes, preparsing results...), stored in
+ * the user cache directory to be reused later.
+ *
+ * The entries of a cache are files of a sub-directory of the user cache
+ * directory, named after the MD5 hash of a key, usually the URL of the
+ * resource. They are written to a temporary file and renamed, so that
+ * concurrent readers never see a partial entry. The oldest entries of the
+ * sub-directory are removed when it exceeds a given size.
+ * @{
+ */
+
+/** Cache entry being written (opaque) */
+typedef struct vlc_cachefile vlc_cachefile_t;
+
+/**
+ * Returns the path of the entry of a key.
+ *
+ * \param dir name of the cache sub-directory
+ * \param key key of the entry
+ * \return the path (to be freed), or NULL on error
+ */
+VLC_API char *vlc_cachefile_GetPath(const char *dir, const char *key)
+VLC_USED VLC_MALLOC;
+
+/**
+ * Opens the entry of a key for reading, in text mode.
+ *
+ * \return the file (to be closed with fclose()), or NULL if there is no
+ * entry for this key
+ */
+VLC_API FILE *vlc_cachefile_Open(const char *dir, const char *key) VLC_USED;
+
+/**
+ * Starts writing the entry of a key.
+ *
+ * The directories are created if needed. The entry is written in text mode
+ * to the file returned by vlc_cachefile_GetFile(), and replaces the
+ * previous entry of the key only once committed.
+ *
+ * \param obj object used for logging
+ * \param dir name of the cache sub-directory
+ * \param key key of the entry
+ * \return the entry, or NULL on error
+ */
+VLC_API vlc_cachefile_t *vlc_cachefile_Create(vlc_object_t *obj,
+                                              const char *dir,
+                                              const char *key) VLC_USED;
+#define vlc_cachefile_Create(o, d, k) vlc_cachefile_Create(VLC_OBJECT(o), d, k)
+
+/**
+ * Returns the file to write the entry to.
+ */
+VLC_API FILE *vlc_cachefile_GetFile(vlc_cachefile_t *entry) VLC_USED;
+
+/**
+ * Completes and stores an entry, and releases it.
+ *
+ * Then, if the entries of the sub-directory total more than max_size bytes,
+ * the least recently stored other ones are removed.
+ *
+ * \param max_size size limit of the cache sub-directory, in bytes
+ * \return VLC_SUCCESS, or an error if the entry could not be written
+ */
+VLC_API int vlc_cachefile_Commit(vlc_cachefile_t *entry, uint64_t max_size);
+
+/**
+ * Discards an entry being written, and releases it.
+ */
+VLC_API void vlc_cachefile_Abort(vlc_cachefile_t *entry);
+
+/** @} */
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
@@ -126,6 +126,7 @@ struct decoder_t
 #       define VLCDEC_SUCCESS   VLC_SUCCESS
 #       define VLCDEC_ECRITICAL VLC_EGENERIC
 #       define VLCDEC_RELOAD    (-100)
+#       define VLCDEC_FALLBACK  (-101)
         /* This function is called to decode one packetized block.
          *
          * The module implementation will own the input block (p_block) and should
@@ -146,6 +147,11 @@ struct decoder_t
          *  When returning this status, the implementation shouldn't release or
          *  modify the frame in argument (The same frame will be feed to the
          *  next decoder module).
+         *  VLCDEC_FALLBACK: Same as VLCDEC_RELOAD, but the module cannot handle
+         *  the stream after all (e.g. a hardware decoder failing mid-stream).
+         *  Another module will be loaded in its place, and this module will
+         *  not be probed again for the same format while the input resources
+         *  are alive.
          */
         int             ( * pf_decode )   ( decoder_t *, vlc_frame_t *frame );
 
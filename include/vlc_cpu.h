@@ -47,6 +47,7 @@ unsigned vlc_CPU_raw(void);
 #  define VLC_CPU_SSE4_1 0x00000400
 #  define VLC_CPU_AVX    0x00002000
 #  define VLC_CPU_AVX2   0x00004000
+#  define VLC_CPU_AVX512 0x00008000 /* F and BW */
 
 #  if defined (__SSE__)
 #   define VLC_SSE
@@ -88,8 +89,18 @@ unsigned vlc_CPU_raw(void);
 
 #  ifdef __AVX2__
 #   define vlc_CPU_AVX2() (1)
+#   define VLC_AVX2
 #  else
 #   define vlc_CPU_AVX2() ((vlc_CPU() & VLC_CPU_AVX2) != 0)
+#   define VLC_AVX2 __attribute__ ((__target__ ("avx2")))
+#  endif
+
+#  if defined (__AVX512F__) && defined (__AVX512BW__)
+#   define vlc_CPU_AVX512() (1)
+#   define VLC_AVX512
+#  else
+#   define vlc_CPU_AVX512() ((vlc_CPU() & VLC_CPU_AVX512) != 0)
+#   define VLC_AVX512 __attribute__ ((__target__ ("avx512f,avx512bw")))
 #  endif
 
 # elif defined (__ppc__) || defined (__ppc64__) || defined (__powerpc__)
@@ -44,6 +44,10 @@
 #define VLC_DEMUXER_EGENERIC -1
 #define VLC_DEMUXER_SUCCESS   1
 
+/* pf_readdir return value of a playlist demuxer that added a batch of items
+ * to the node and must be called again, with a new node, for the next ones */
+#define VLC_DEMUXER_READDIR_MORE 1
+
 /* DEMUX_TEST_AND_CLEAR flags */
 #define INPUT_UPDATE_TITLE      0x0010
 #define INPUT_UPDATE_SEEKPOINT  0x0020
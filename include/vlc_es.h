@@ -64,6 +64,21 @@ typedef struct
     float      pf_gain[AUDIO_REPLAY_GAIN_MAX];
 } audio_replay_gain_t;
 
+/**
+ * Gapless playback information.
+ *
+ * The samples are counted in the decoded audio, from the start of the stream
+ * (at VLC_TICK_0). The decoded samples outside of the content (encoder delay
+ * and padding) are dropped by the core.
+ */
+typedef struct
+{
+    /* number of samples to drop at the start of the stream */
+    uint32_t i_priming;
+    /* number of samples of content after them, 0 if unknown */
+    uint64_t i_samples;
+} audio_gapless_t;
+
 
 /**
  * Audio channel type
@@ -753,6 +768,7 @@ struct es_format_t
         struct {
             audio_format_t  audio;    /**< description of audio format */
             audio_replay_gain_t audio_replay_gain; /**< audio replay gain information */
+            audio_gapless_t audio_gapless; /**< gapless playback information */
         };
         video_format_t video;     /**< description of video format */
         subs_format_t  subs;      /**< description of subtitle format */
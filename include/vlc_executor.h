@@ -31,6 +31,18 @@ extern "C" {
 /** Executor type (opaque) */
 typedef struct vlc_executor vlc_executor_t;
 
+/**
+ * Priority of a runnable
+ *
+ * Queued runnables of higher priority are started first.
+ */
+enum vlc_executor_priority
+{
+    VLC_EXECUTOR_PRIORITY_LOW, /**< background work */
+    VLC_EXECUTOR_PRIORITY_NORMAL, /**< default */
+    VLC_EXECUTOR_PRIORITY_HIGH, /**< requested interactively by the user */
+};
+
 /**
  * A Runnable encapsulates a task to be run from an executor thread.
  */
@@ -145,6 +157,21 @@ vlc_executor_Delete(vlc_executor_t *executor);
 VLC_API void
 vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable);
 
+/**
+ * Submit a runnable for execution, with a given priority.
+ *
+ * This is the same as vlc_executor_Submit(), except that the runnable will be
+ * started before any queued runnable of lower priority.
+ *
+ * \param executor the executor
+ * \param runnable the task to run
+ * \param priority the priority of the task
+ */
+VLC_API void
+vlc_executor_SubmitWithPriority(vlc_executor_t *executor,
+                                struct vlc_runnable *runnable,
+                                enum vlc_executor_priority priority);
+
 /**
  * Cancel a runnable previously submitted.
  *
@@ -176,6 +203,26 @@ vlc_executor_Cancel(vlc_executor_t *executor, struct vlc_runnable *runnable);
 VLC_API void
 vlc_executor_WaitIdle(vlc_executor_t *executor);
 
+/**
+ * Mark the start of a blocking wait in the current runnable.
+ *
+ * A runnable blocked on I/O (or waiting for another component) does not use
+ * the CPU: while it is blocked, it does not count against the maximum number
+ * of threads of its executor, so that other queued runnables may start. The
+ * executor spawns at most max_threads additional threads for this purpose.
+ *
+ * This must be followed by vlc_executor_EndIO() before run() returns. It does
+ * nothing if the calling thread is not an executor thread.
+ */
+VLC_API void
+vlc_executor_BeginIO(void);
+
+/**
+ * Mark the end of a blocking wait started by vlc_executor_BeginIO().
+ */
+VLC_API void
+vlc_executor_EndIO(void);
+
 # ifdef __cplusplus
 }
 # endif
@@ -442,6 +442,9 @@
 /* GStreamer Memory opaque buffer type */
 #define VLC_CODEC_GST_MEM_OPAQUE  VLC_FOURCC('G','S','T','M')
 
+/* V4L2 memory-to-memory decoder DMA buffers */
+#define VLC_CODEC_V4L2M2M_OPAQUE  VLC_FOURCC('V','4','L','M')
+
 /* Image codec (video) */
 #define VLC_CODEC_PNG             VLC_FOURCC('p','n','g',' ')
 #define VLC_CODEC_PPM             VLC_FOURCC('p','p','m',' ')
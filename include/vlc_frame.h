@@ -170,6 +170,38 @@ VLC_API vlc_frame_t *vlc_frame_Init(vlc_frame_t *frame,
  */
 VLC_API vlc_frame_t *vlc_frame_Alloc(size_t size) VLC_USED VLC_MALLOC;
 
+/**
+ * Allocates a pooled frame.
+ *
+ * This function behaves as vlc_frame_Alloc(), but recycles the memory of
+ * previously released pooled frames of the same size class, avoiding heap
+ * allocations on hot paths with small and frequent packets (network access,
+ * demuxers, muxers...).
+ *
+ * The frame must be released with vlc_frame_Release(). Large sizes are not
+ * pooled and fall back to vlc_frame_Alloc().
+ *
+ * @param size size in bytes (possibly zero)
+ * @return the created frame, or NULL on memory error.
+ */
+VLC_API vlc_frame_t *vlc_frame_AllocPooled(size_t size) VLC_USED VLC_MALLOC;
+
+/**
+ * Pooled frames statistics.
+ */
+struct vlc_frame_pool_stats
+{
+    uint64_t hits; /**< Number of frames recycled from the pool */
+    uint64_t misses; /**< Number of frames allocated from the heap */
+};
+
+/**
+ * Gets the process-wide pooled frames statistics.
+ *
+ * @param stats structure to fill [OUT]
+ */
+VLC_API void vlc_frame_GetPoolStats(struct vlc_frame_pool_stats *stats);
+
 VLC_API vlc_frame_t *vlc_frame_TryRealloc(vlc_frame_t *, ssize_t pre, size_t body) VLC_USED;
 
 /**
@@ -268,6 +300,54 @@ static inline vlc_frame_t *vlc_frame_Duplicate( const vlc_frame_t *frame )
     return p_dup;
 }
 
+/**
+ * Makes a frame shareable.
+ *
+ * Turns a frame into a read-only view of its payload, that can then be
+ * handed to several consumers with vlc_frame_Share() without copying the
+ * data. The payload is released along with the last view.
+ *
+ * A view has no spare room around its payload, so that vlc_frame_Realloc()
+ * copies the data rather than writing into the shared buffer. Any other
+ * in-place modification of the payload requires vlc_frame_Writable() first.
+ *
+ * @param frame frame to share (this function takes ownership of it)
+ * @return the view, or NULL on memory error (the frame is then released)
+ */
+VLC_API vlc_frame_t *vlc_frame_MakeShared(vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Shares a frame.
+ *
+ * Creates a frame with the same payload and properties as the given one.
+ * The payload of a frame made shareable with vlc_frame_MakeShared() is
+ * referenced, any other frame is duplicated.
+ *
+ * @return the new frame on success, NULL on error.
+ */
+VLC_API vlc_frame_t *vlc_frame_Share(const vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Gets a frame with a writable payload.
+ *
+ * This is the copy-on-write counterpart of vlc_frame_Share(): a frame that
+ * references a shared payload is replaced with a private copy, unless it
+ * holds the last reference. Other frames are returned as is.
+ *
+ * @param frame frame to write to (this function takes ownership of it)
+ * @return a writable frame, or NULL on memory error (the frame is then
+ * released)
+ */
+VLC_API vlc_frame_t *vlc_frame_Writable(vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Moves the payload of a frame to the memory of the calling thread.
+ *
+ * With --numa-local, a large payload is migrated to the NUMA node of the
+ * calling thread. Otherwise, this does nothing.
+ */
+VLC_API void vlc_frame_MoveLocal(vlc_frame_t *frame);
+
 /**
  * Wraps heap in a frame.
  *
@@ -567,6 +647,22 @@ static inline vlc_frame_t *vlc_frame_ChainGather( vlc_frame_t *p_list )
  */
 VLC_API vlc_fifo_t *vlc_fifo_New(void) VLC_USED VLC_MALLOC;
 
+/**
+ * Creates a thread-safe FIFO queue of blocks with a lock-free producer.
+ *
+ * This creates a FIFO like vlc_fifo_New(), optimized for a single producer
+ * thread that queues blocks with vlc_fifo_Put(): blocks are queued without
+ * locking, and the consumer is only signaled if it is waiting in
+ * vlc_fifo_Wait() or vlc_fifo_Get(). All other functions, including block
+ * and byte accounting, behave as with any other FIFO.
+ *
+ * @note The count and size of a FIFO can transiently under-estimate the
+ * blocks being concurrently queued by vlc_fifo_Put().
+ *
+ * @return the FIFO or NULL on memory error
+ */
+VLC_API vlc_fifo_t *vlc_fifo_NewSPSC(void) VLC_USED VLC_MALLOC;
+
 /**
  * Delete a FIFO created by vlc_fifo_New().
  *
@@ -657,10 +753,7 @@ static inline void vlc_fifo_Signal(vlc_fifo_t *fifo)
  * @note This function is a cancellation point. In case of cancellation, the
  * the FIFO will be locked before cancellation cleanup handlers are processed.
  */
-static inline void vlc_fifo_Wait(vlc_fifo_t *fifo)
-{
-    vlc_queue_Wait(vlc_fifo_queue(fifo));
-}
+VLC_API void vlc_fifo_Wait(vlc_fifo_t *fifo);
 
 static inline void vlc_fifo_WaitCond(vlc_fifo_t *fifo, vlc_cond_t *condvar)
 {
@@ -763,10 +856,10 @@ VLC_API bool vlc_fifo_Held(const vlc_fifo_t *fifo) VLC_USED;
  */
 #define vlc_fifo_Assert(fifo) assert(vlc_fifo_Held(fifo))
 
-VLC_USED static inline bool vlc_fifo_IsEmpty(const vlc_fifo_t *fifo)
-{
-    return vlc_queue_IsEmpty(vlc_fifo_queue(fifo));
-}
+/**
+ * Checks whether a FIFO is empty.
+ */
+VLC_API bool vlc_fifo_IsEmpty(const vlc_fifo_t *fifo) VLC_USED;
 
 static inline void vlc_fifo_Cleanup(void *fifo)
 {
@@ -793,12 +886,7 @@ static inline void vlc_fifo_Empty(vlc_fifo_t *fifo)
  * @param fifo queue
  * @param block head of a block list to queue (may be NULL)
  */
-static inline void vlc_fifo_Put(vlc_fifo_t *fifo, vlc_frame_t *block)
-{
-    vlc_fifo_Lock(fifo);
-    vlc_fifo_QueueUnlocked(fifo, block);
-    vlc_fifo_Unlock(fifo);
-}
+VLC_API void vlc_fifo_Put(vlc_fifo_t *fifo, vlc_frame_t *block);
 
 /* FIXME: not (really) thread-safe */
 VLC_USED VLC_DEPRECATED
@@ -205,6 +205,11 @@ struct input_item_node_t
     input_item_t *         p_item;
     int                    i_children;
     input_item_node_t      **pp_children;
+    bool                   b_continued; /**< Children follow the ones of a
+                                             previously posted subtree of
+                                             the same item */
+    bool                   b_partial;   /**< More children of the same item
+                                             will be posted */
 };
 
 VLC_API void input_item_CopyOptions( input_item_t *p_child, input_item_t *p_parent );
@@ -518,6 +523,8 @@ VLC_API void libvlc_MetadataCancel( libvlc_int_t *, void * );
 /******************
  * Input stats
  ******************/
+#define INPUT_STATS_DECODE_TIME_BUCKETS 8
+
 struct input_stats_t
 {
     /* Input */
@@ -535,6 +542,12 @@ struct input_stats_t
     /* Decoders */
     int64_t i_decoded_audio;
     int64_t i_decoded_video;
+    /** Decode calls by duration: the first bucket counts the calls shorter
+     * than 1 ms, bucket n those between 2^(n-1) and 2^n ms, and the last
+     * bucket all the longer ones. */
+    int64_t pi_decode_time[INPUT_STATS_DECODE_TIME_BUCKETS];
+    /** Deepest decoder input queue, in frames, since the previous update */
+    int64_t i_decoder_queue_max;
 
     /* Vout */
     int64_t i_displayed_pictures;
@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * vlc_memaccount.h: memory accounting
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_MEMACCOUNT_H
+#define VLC_MEMACCOUNT_H 1
+
+/**
+ * \defgroup memaccount Memory accounting
+ * \ingroup os
+ *
+ * Process-wide accounting of the large allocations, charged to the
+ * subsystem that owns them. Each subsystem may have a budget
+ * (--frame-memory-budget...): the accounting never fails an allocation,
+ * but caches shrink and optional buffering stops while the budget of their
+ * subsystem is exceeded.
+ *
+ * @{
+ * \file
+ * Memory accounting functions
+ */
+
+enum vlc_memaccount_type
+{
+    VLC_MEMACCOUNT_FRAME,   /**< Frames and blocks data */
+    VLC_MEMACCOUNT_PICTURE, /**< Software picture buffers */
+    VLC_MEMACCOUNT_CACHE,   /**< Content caches */
+};
+
+#define VLC_MEMACCOUNT_COUNT (VLC_MEMACCOUNT_CACHE + 1)
+
+struct vlc_memaccount_stats
+{
+    size_t used;   /**< Bytes currently charged */
+    size_t peak;   /**< Highest charge since start */
+    size_t budget; /**< Budget in bytes, 0 if unlimited */
+};
+
+/**
+ * Charges memory to a subsystem.
+ */
+VLC_API void vlc_memaccount_Add(enum vlc_memaccount_type, size_t size);
+
+/**
+ * Releases memory charged with vlc_memaccount_Add().
+ */
+VLC_API void vlc_memaccount_Remove(enum vlc_memaccount_type, size_t size);
+
+/**
+ * Checks whether a subsystem exceeds its budget.
+ *
+ * Optional buffering should stop, and caches should shrink, while true.
+ */
+VLC_API bool vlc_memaccount_IsOverBudget(enum vlc_memaccount_type);
+
+/**
+ * Gets the accounting of a subsystem.
+ */
+VLC_API void vlc_memaccount_GetStats(enum vlc_memaccount_type,
+                                     struct vlc_memaccount_stats *);
+
+/** @} */
+
+#endif
@@ -103,6 +103,7 @@ enum vlc_video_context_type
     VLC_VIDEO_CONTEXT_CVPX,      //!< private: cvpx_video_context*
     VLC_VIDEO_CONTEXT_MMAL,      //!< empty
     VLC_VIDEO_CONTEXT_GSTDECODE, //!< empty
+    VLC_VIDEO_CONTEXT_V4L2M2M,   //!< private: v4l2m2m_video_context
 };
 
 VLC_API vlc_video_context * vlc_video_context_Create(vlc_decoder_device *,
@@ -407,6 +408,15 @@ VLC_API void plane_CopyPixels( plane_t *p_dst, const plane_t *p_src );
  */
 VLC_API void picture_Copy( picture_t *p_dst, const picture_t *p_src );
 
+/**
+ * Moves the pixels of a picture to the memory of the calling thread.
+ *
+ * With --numa-local, the large planes are migrated to the NUMA node of the
+ * calling thread, typically the consumer of the picture. Otherwise, or for
+ * pictures without CPU planes, this does nothing.
+ */
+VLC_API void picture_MoveLocal(picture_t *);
+
 /**
  * Perform a shallow picture copy
  *
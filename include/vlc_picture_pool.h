@@ -68,6 +68,24 @@ VLC_API picture_pool_t * picture_pool_New(unsigned count,
 VLC_API picture_pool_t * picture_pool_NewFromFormat(const video_format_t *fmt,
                                                     unsigned count) VLC_USED;
 
+/**
+ * Changes the number of pictures of a pool.
+ *
+ * Only pools created by picture_pool_NewFromFormat() can be resized, up to
+ * 64 pictures. Growing allocates the missing pictures. Shrinking destroys
+ * the free pictures beyond the new size at once, and the others when they
+ * are released.
+ *
+ * @param count new number of pictures
+ *
+ * @return VLC_SUCCESS, or an error if the pool cannot be resized or on
+ * memory error (the pool may then be partially grown)
+ *
+ * @note This function is thread-safe with regards to obtaining and releasing
+ * pictures, but not to picture_pool_Release().
+ */
+VLC_API int picture_pool_Resize(picture_pool_t *, unsigned count);
+
 /**
  * Releases a pool created by picture_pool_New()
  * or picture_pool_NewFromFormat().
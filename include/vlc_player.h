@@ -1205,6 +1205,29 @@ vlc_player_program_Dup(const struct vlc_player_program *prgm);
 VLC_API void
 vlc_player_program_Delete(struct vlc_player_program *prgm);
 
+/**
+ * Get a copy of the programs without the player lock
+ *
+ * @see vlc_player_CopyTrackList
+ *
+ * @param player unlocked player instance
+ * @param count pointer to the number of programs returned
+ * @return an array of duplicated programs to be released with
+ * vlc_player_program_DeleteList(), or NULL if there are no programs or in case
+ * of allocation error
+ */
+VLC_API struct vlc_player_program **
+vlc_player_CopyProgramList(vlc_player_t *player, size_t *count);
+
+/**
+ * Delete an array of duplicated programs
+ *
+ * @see vlc_player_CopyProgramList
+ */
+VLC_API void
+vlc_player_program_DeleteList(struct vlc_player_program **programs,
+                              size_t count);
+
 /**
  * Get the number of programs
  *
@@ -1368,6 +1391,33 @@ vlc_player_track_Dup(const struct vlc_player_track *track);
 VLC_API void
 vlc_player_track_Delete(struct vlc_player_track *track);
 
+/**
+ * Get a copy of the tracks of an ES category without the player lock
+ *
+ * Unlike vlc_player_GetTrackCount() and vlc_player_GetTrackAt(), this
+ * function does not need the player lock: the player publishes an immutable
+ * snapshot of its track lists whenever they change. It is meant for UI or
+ * API threads that only need to inspect the tracks.
+ *
+ * @param player unlocked player instance
+ * @param cat VIDEO_ES, AUDIO_ES or SPU_ES
+ * @param count pointer to the number of tracks returned
+ * @return an array of duplicated tracks to be released with
+ * vlc_player_track_DeleteList(), or NULL if there are no tracks or in case of
+ * allocation error
+ */
+VLC_API struct vlc_player_track **
+vlc_player_CopyTrackList(vlc_player_t *player, enum es_format_category_e cat,
+                         size_t *count);
+
+/**
+ * Delete an array of duplicated tracks
+ *
+ * @see vlc_player_CopyTrackList
+ */
+VLC_API void
+vlc_player_track_DeleteList(struct vlc_player_track **tracks, size_t count);
+
 /**
  * Get the number of tracks for an ES category
  *
@@ -860,6 +860,9 @@ vlc_playlist_PlayAt(vlc_playlist_t *playlist, size_t index)
 /**
  * Preparse a media, and expand it in the playlist on subitems added.
  *
+ * Only the items following the current one are preparsed automatically, so
+ * user interfaces should call this function for the items they display.
+ *
  * \param playlist the playlist (not necessarily locked)
  * \param media the media to preparse
  */
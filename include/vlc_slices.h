@@ -0,0 +1,138 @@
+/*****************************************************************************
+ * vlc_slices.h: slice threading of picture processing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_SLICES_H
+#define VLC_SLICES_H
+
+#include <vlc_common.h>
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/**
+ * \defgroup slices Slice threading
+ * \ingroup misc
+ *
+ * Splits the processing of a picture in horizontal slices, run
+ * concurrently on a pool of threads. It is used by the video filters and
+ * converters whose output lines do not depend on each other.
+ * @{
+ */
+
+/** Maximum number of slices a job is split in */
+#define VLC_SLICES_MAX 16
+
+/** Slice threads (opaque) */
+typedef struct vlc_slices vlc_slices_t;
+
+/**
+ * Processes one slice of a job.
+ *
+ * The slices of a job run concurrently: they must only write their own part
+ * of the output, as given by vlc_slices_GetRange() or vlc_slices_GetView(),
+ * and their own state.
+ *
+ * \param opaque data given to vlc_slices_Run()
+ * \param slice slice index, from 0 to slices - 1
+ * \param slices number of slices of the job
+ */
+typedef void (*vlc_slice_cb)(void *opaque, unsigned slice, unsigned slices);
+
+/**
+ * Creates the slice threads for pictures of a given size.
+ *
+ * With threads set to 0, there is one slice per CPU from 720p pictures, and
+ * a single one below. In any case, the count is limited so that the slices
+ * are at least 64 lines high. The jobs are run on the calling thread only
+ * when there is a single slice.
+ *
+ * \param obj parent object, for logging
+ * \param threads number of slices, or 0 for automatic
+ * \param width width of the pictures
+ * \param height height of the pictures, in lines
+ * \return the slice threads, or NULL on allocation error
+ */
+VLC_API vlc_slices_t *vlc_slices_New(vlc_object_t *obj, unsigned threads,
+                                     unsigned width, unsigned height);
+#define vlc_slices_New(o, t, w, h) vlc_slices_New(VLC_OBJECT(o), t, w, h)
+
+/**
+ * Stops the slice threads.
+ */
+VLC_API void vlc_slices_Delete(vlc_slices_t *slices);
+
+/**
+ * Returns the number of slices the jobs are split in.
+ */
+VLC_API unsigned vlc_slices_Count(const vlc_slices_t *slices);
+
+/**
+ * Runs all the slices of a job, and waits for them.
+ *
+ * The first slice is run on the calling thread. Jobs must not be run
+ * concurrently on the same slice threads.
+ */
+VLC_API void vlc_slices_Run(vlc_slices_t *slices, vlc_slice_cb cb,
+                            void *opaque);
+
+/**
+ * Range of items (lines, columns...) covered by a slice.
+ *
+ * The slices start at a multiple of align items, and the last one ends at
+ * count.
+ */
+static inline void vlc_slices_GetRange(unsigned count, unsigned slice,
+                                       unsigned slices, unsigned align,
+                                       unsigned *start, unsigned *end)
+{
+    *start = (uint64_t)count * slice / slices / align * align;
+    if (slice + 1 == slices)
+        *end = count;
+    else
+        *end = (uint64_t)count * (slice + 1) / slices / align * align;
+}
+
+/**
+ * Makes a picture referring to a range of lines of another one.
+ *
+ * The range is given in luma lines, and scaled for each plane according to
+ * the chroma of the picture, so that the views of pictures of different
+ * subsampling match. A range ending at the last visible luma line covers all
+ * the remaining lines of each plane.
+ *
+ * The pixels are shared with pic; only the metadata is generated. The view
+ * must not be released.
+ *
+ * \param view picture to initialize
+ * \param pic full picture
+ * \param start first luma line
+ * \param end luma line after the range
+ */
+VLC_API void vlc_slices_GetView(picture_t *view, const picture_t *pic,
+                                unsigned start, unsigned end);
+
+/** @} */
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
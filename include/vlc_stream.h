@@ -72,6 +72,7 @@ struct vlc_stream_operations {
             int (*set_record_state)(stream_t *, bool, const char *, const char *);
             int (*set_private_id_state)(stream_t *, int, bool);
             int (*set_private_id_ca)(stream_t *, void *);
+            int (*set_read_hint)(stream_t *, uint64_t, uint64_t);
         } stream;
         struct {
             bool (*can_record)(demux_t *);
@@ -254,6 +255,7 @@ enum stream_query_e
     /* XXX only data read through vlc_stream_Read/Block will be recorded */
     STREAM_SET_RECORD_STATE,     /**< arg1=bool, arg2=const char *dir_path (if arg1 is true)
                                       arg3=const char *psz_ext (if arg1 is true)  res=can fail */
+    STREAM_SET_READ_HINT,        /**< arg1= uint64_t offset, arg2= uint64_t length  res=can fail */
 
     STREAM_SET_PRIVATE_ID_STATE = 0x1000, /* arg1= int i_private_data, bool b_selected    res=can fail */
     STREAM_SET_PRIVATE_ID_CA,             /* arg1= void * */
@@ -517,6 +519,18 @@ VLC_USED static inline int vlc_stream_SetRecordState(stream_t *s, bool record_st
     return vlc_stream_Control(s, STREAM_SET_RECORD_STATE, record_state, dir_path, ext);
 }
 
+/**
+ * Hints the byte range that will be read next.
+ *
+ * This is purely advisory. Stream filters and access modules may use it to
+ * avoid reading ahead past the end of the range, e.g. when a demuxer reads an
+ * index of a known size before going back to the data.
+ */
+static inline int vlc_stream_SetReadHint(stream_t *s, uint64_t offset, uint64_t length)
+{
+    return vlc_stream_Control(s, STREAM_SET_READ_HINT, offset, length);
+}
+
 VLC_USED static inline int vlc_stream_SetPrivateIdState(stream_t *s, int priv_id, bool state)
 {
     return vlc_stream_Control(s, STREAM_SET_PRIVATE_ID_STATE, priv_id, state);
@@ -43,6 +43,21 @@ typedef struct vlc_thumbnailer_request_t vlc_thumbnailer_request_t;
  */
 typedef void(*vlc_thumbnailer_cb)( void* data, picture_t* thumbnail );
 
+/**
+ * \brief vlc_thumbnailer_batch_cb defines a callback invoked for each
+ * thumbnail of a batch request
+ *
+ * It is called once per requested time, in order, with the same semantics as
+ * vlc_thumbnailer_cb.
+ *
+ * \param data Is the opaque pointer passed as the request last parameter
+ * \param index The index of the requested time
+ * \param thumbnail The generated thumbnail, or NULL in case of failure or
+ * timeout
+ */
+typedef void(*vlc_thumbnailer_batch_cb)( void* data, size_t index,
+                                         picture_t* thumbnail );
+
 
 /**
  * \brief vlc_thumbnailer_Create Creates a thumbnailer object
@@ -112,6 +127,66 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
                               input_item_t *input_item, vlc_tick_t timeout,
                               vlc_thumbnailer_cb cb, void* user_data );
 
+/**
+ * \brief vlc_thumbnailer_RequestBatchByTime Requests thumbnails at several
+ * times from a single input
+ * \param thumbnailer A thumbnailer object
+ * \param times The times at which the thumbnails should be taken
+ * \param count The number of times (must not be 0)
+ * \param speed The seeking speed \sa{enum vlc_thumbnailer_seek_speed}
+ * \param input_item The input item to generate the thumbnails for
+ * \param timeout A timeout value for each thumbnail, or VLC_TICK_INVALID to
+ * disable timeout
+ * \param cb A user callback to be called for each thumbnail (success & error)
+ * \param user_data An opaque value, provided as pf_cb's first parameter
+ * \return An opaque request object, or NULL in case of failure
+ *
+ * The input is opened once, and the same decoder is used for all the
+ * thumbnails, which is much faster than one request per time (e.g. for
+ * timeline previews). With VLC_THUMBNAILER_SEEK_FAST, only keyframes are
+ * decoded.
+ *
+ * The callback is called once per time, in order, unless the request is
+ * destroyed early. The returned request object must be freed with
+ * vlc_thumbnailer_DestroyRequest().
+ */
+VLC_API vlc_thumbnailer_request_t*
+vlc_thumbnailer_RequestBatchByTime( vlc_thumbnailer_t *thumbnailer,
+                                    const vlc_tick_t *times, size_t count,
+                                    enum vlc_thumbnailer_seek_speed speed,
+                                    input_item_t *input_item,
+                                    vlc_tick_t timeout,
+                                    vlc_thumbnailer_batch_cb cb,
+                                    void* user_data );
+
+/**
+ * Priority of a thumbnail request
+ */
+enum vlc_thumbnailer_priority
+{
+    /** Background work, e.g. populating a media library */
+    VLC_THUMBNAILER_PRIORITY_BACKGROUND,
+    /** Default priority of the requests */
+    VLC_THUMBNAILER_PRIORITY_NORMAL,
+    /** The thumbnail is about to be displayed */
+    VLC_THUMBNAILER_PRIORITY_VISIBLE,
+};
+
+/**
+ * \brief vlc_thumbnailer_SetPriority Changes the priority of a request
+ * \param thumbnailer A thumbnailer object
+ * \param request An opaque thumbnail request object
+ * \param priority The new priority
+ *
+ * Pending requests are started by decreasing priority, then in the order
+ * they were made. New requests have the VLC_THUMBNAILER_PRIORITY_NORMAL
+ * priority. This has no effect once the request is started.
+ */
+VLC_API void
+vlc_thumbnailer_SetPriority( vlc_thumbnailer_t *thumbnailer,
+                             vlc_thumbnailer_request_t *request,
+                             enum vlc_thumbnailer_priority priority );
+
 /**
  * \brief vlc_thumbnailer_DestroyRequest Destroy a thumbnail request
  * \param thumbnailer A thumbnailer object
@@ -103,6 +103,14 @@ VLC_API void vlc_tracer_TraceWithTs(struct vlc_tracer *tracer, vlc_tick_t ts, ..
  * @{
  */
 
+static inline struct vlc_tracer_entry vlc_tracer_entry_FromInt(const char *key, int64_t value)
+{
+    vlc_tracer_value_t tracer_value;
+    tracer_value.integer = value;
+    struct vlc_tracer_entry trace = { key, tracer_value, VLC_TRACER_INT };
+    return trace;
+}
+
 static inline struct vlc_tracer_entry vlc_tracer_entry_FromTick(const char *key, vlc_tick_t value)
 {
     vlc_tracer_value_t tracer_value;
@@ -148,6 +156,10 @@ static inline struct vlc_tracer_entry VLC_TRACE(const char *key, const char *val
 }
 #endif
 
+/* vlc_tick_t and int64_t are the same type, integers must be explicit */
+#define VLC_TRACE_INT(key, value) \
+        vlc_tracer_entry_FromInt(key, value)
+
 /*
  * Helper trace functions
  */
@@ -170,6 +182,15 @@ static inline void vlc_tracer_TraceStreamDTS(struct vlc_tracer *tracer, const ch
                      VLC_TRACE("dts", dts), VLC_TRACE_END);
 }
 
+static inline void vlc_tracer_TraceStreamSize(struct vlc_tracer *tracer,
+                                const char *type, const char *id,
+                                const char *stream, size_t size)
+{
+    vlc_tracer_Trace(tracer, VLC_TRACE("type", type), VLC_TRACE("id", id),
+                     VLC_TRACE("stream", stream),
+                     VLC_TRACE_INT("size", size), VLC_TRACE_END);
+}
+
 static inline void vlc_tracer_TraceRender(struct vlc_tracer *tracer, const char *type,
                                 const char *id, vlc_tick_t now, vlc_tick_t pts)
 {
@@ -206,6 +206,75 @@ VLC_API int var_GetAndSet(vlc_object_t *obj, const char *name, int op,
  */
 VLC_API int var_Inherit( vlc_object_t *, const char *, int, vlc_value_t * );
 
+/**
+ * \defgroup var_handle Variable handles
+ *
+ * A variable handle resolves an inherited variable once, as var_Inherit()
+ * does, and keeps its value until a variable of the same name is created,
+ * destroyed or set, or the configuration item of that name changes. Reading
+ * an unchanged value takes no locks, which suits the values checked for every
+ * picture or audio buffer.
+ *
+ * \note A handle must not be used by several threads at once, and must be
+ * deleted before its object.
+ * @{
+ */
+typedef struct vlc_var_handle vlc_var_handle_t;
+
+/**
+ * Creates a variable handle.
+ *
+ * \param obj Object to inherit the variable from
+ * \param name Variable name
+ * \param type Variable type: boolean, integer, float or string
+ * \return the handle, or NULL on memory error
+ */
+VLC_API vlc_var_handle_t *var_HandleNew(vlc_object_t *obj, const char *name,
+                                        int type) VLC_USED;
+
+/**
+ * Deletes a variable handle.
+ */
+VLC_API void var_HandleDelete(vlc_var_handle_t *);
+
+/**
+ * Gets the inherited value of a variable handle.
+ *
+ * \return the value, valid until the next call on the handle
+ */
+VLC_API const vlc_value_t *var_HandleGet(vlc_var_handle_t *) VLC_USED;
+
+VLC_USED
+static inline bool var_HandleGetBool(vlc_var_handle_t *handle)
+{
+    return var_HandleGet(handle)->b_bool;
+}
+
+VLC_USED
+static inline int64_t var_HandleGetInteger(vlc_var_handle_t *handle)
+{
+    return var_HandleGet(handle)->i_int;
+}
+
+VLC_USED
+static inline float var_HandleGetFloat(vlc_var_handle_t *handle)
+{
+    return var_HandleGet(handle)->f_float;
+}
+
+/**
+ * Gets the inherited value of a string variable handle.
+ *
+ * \return the string (never NULL), valid until the next call on the handle
+ */
+VLC_USED
+static inline const char *var_HandleGetString(vlc_var_handle_t *handle)
+{
+    return var_HandleGet(handle)->psz_string;
+}
+
+/** @} */
+
 
 /*****************************************************************************
  * Variable callbacks
@@ -830,6 +899,7 @@ VLC_API int var_LocationParse(vlc_object_t *obj, const char *mrl, const char *pr
 #define var_GetAddress(a,b) var_GetAddress(VLC_OBJECT(a),b)
 
 #define var_LocationParse(o, m, p) var_LocationParse(VLC_OBJECT(o), m, p)
+#define var_HandleNew(o, n, t) var_HandleNew(VLC_OBJECT(o), n, t)
 #endif
 
 /**
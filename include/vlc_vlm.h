@@ -58,6 +58,8 @@ typedef struct
     struct
     {
         bool b_loop;    /*< this vlc_media_t broadcast item should loop */
+        bool b_shared;  /*< share the input with the other shared broadcasts
+                            of the same inputs and options */
     } broadcast;        /*< Broadcast specific information */
 
 } vlm_media_t;
@@ -212,6 +214,7 @@ static inline void vlm_media_Init( vlm_media_t *p_media )
     p_media->psz_output = NULL;
 
     p_media->broadcast.b_loop = false;
+    p_media->broadcast.b_shared = false;
 }
 
 /**
@@ -243,6 +246,7 @@ vlm_media_Copy( vlm_media_t *p_dst, const vlm_media_t *p_src )
         p_dst->psz_output = strdup( p_src->psz_output );
 
     p_dst->broadcast.b_loop = p_src->broadcast.b_loop;
+    p_dst->broadcast.b_shared = p_src->broadcast.b_shared;
 }
 
 /**
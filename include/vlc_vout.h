@@ -118,6 +118,32 @@ VLC_API int vout_GetSnapshot( vout_thread_t *p_vout,
                               video_format_t *p_fmt,
                               const char *psz_format, vlc_tick_t i_timeout );
 
+/**
+ * Snapshot completion callback.
+ *
+ * \param opaque the data given to vout_GetSnapshotAsync()
+ * \param picture the snapshot picture (with the crop and aspect ratio of the
+ * display), or NULL on error or if the vout was closed before displaying a
+ * picture; it is only valid during the call and must be held to be kept
+ */
+typedef void (*vout_snapshot_cb)(void *opaque, picture_t *picture);
+
+/**
+ * This function will request a snapshot asynchronously.
+ *
+ * The next displayed picture is only referenced by the render thread (it may
+ * be a hardware picture), and the callback is called on a snapshot worker
+ * thread, where any conversion or encoding (e.g. with picture_Export()) can
+ * be done without delaying the display.
+ *
+ * The callback is called exactly once if this function succeeds, at the
+ * latest during vout_Close().
+ *
+ * \return VLC_SUCCESS, or an error code if the vout is closing or is a dummy
+ */
+VLC_API int vout_GetSnapshotAsync( vout_thread_t *p_vout,
+                                   vout_snapshot_cb cb, void *opaque );
+
 /* */
 VLC_API void vout_PutPicture( vout_thread_t *, picture_t * );
 
@@ -129,6 +129,17 @@ typedef struct vout_display_cfg {
 typedef struct {
     bool can_scale_spu;                     /* Handles subpictures with a non default zoom factor */
     const vlc_fourcc_t *subpicture_chromas; /* List of supported chromas for subpicture rendering. */
+    /**
+     * Number of pictures the display can hold prepared but not displayed
+     * yet (0 or 1 if the display holds only one).
+     *
+     * If larger than 1, the next pictures may be prepared before the
+     * previous ones are displayed, and display is called from another
+     * thread, so that the video output can render ahead while a picture
+     * waits for its date. The callbacks are never invoked concurrently and
+     * the pictures are displayed in the order they were prepared.
+     */
+    unsigned queue_depth;
 } vout_display_info_t;
 
 /**
@@ -204,6 +215,7 @@ struct vout_display_owner_t {
      * from multiple threads.
      */
     void (*viewpoint_moved)(void *sys, const vlc_viewpoint_t *vp);
+    void (*presented)(void *sys, vlc_tick_t date, vlc_tick_t refresh_period);
 };
 
 /**
@@ -251,7 +263,9 @@ struct vlc_display_operations
      * implicit guarantee that display will be invoked with the exact same
      * picture afterwards:
      * prepare 1st picture, display 1st picture, prepare 2nd picture, display
-     * 2nd picture, and so on.
+     * 2nd picture, and so on. If \ref vout_display_info_t.queue_depth is
+     * larger than 1, up to that many pictures may be prepared before the
+     * first of them is displayed.
      *
      * \note The picture buffers may have multiple references.
      * Therefore the pixel content of the picture or of the subpicture
@@ -462,6 +476,25 @@ static inline void vout_display_SendEventViewpointMoved(vout_display_t *vd,
         vd->owner.viewpoint_moved(vd->owner.sys, vp);
 }
 
+/**
+ * Reports that the last displayed picture reached the screen.
+ *
+ * Displays that know when their pictures are flipped (vertical blanking,
+ * presentation feedback) should report it, so that the video output can
+ * schedule the pictures on the refreshes of the display.
+ *
+ * \param vd vout_display_t.
+ * \param date system date of the refresh the picture was shown on.
+ * \param refresh_period refresh period of the display, or 0 if unknown.
+ */
+static inline void vout_display_SendEventPresented(vout_display_t *vd,
+                                                   vlc_tick_t date,
+                                                   vlc_tick_t refresh_period)
+{
+    if (vd->owner.presented)
+        vd->owner.presented(vd->owner.sys, date, refresh_period);
+}
+
 /**
  * Helper function that applies the necessary transforms to the mouse position
  * and then calls vout_display_SendEventMouseMoved.
@@ -36,6 +36,7 @@
 
 #include <vlc_common.h>
 #include <vlc_aout.h>
+#include <vlc_atomic.h>
 #include <vlc_modules.h>
 
 #include "libvlc_internal.h"
@@ -600,3 +601,103 @@ float libvlc_audio_equalizer_get_amp_at_index( libvlc_equalizer_t *p_equalizer,
 
     return p_equalizer->f_amp[ u_band ];
 }
+
+/******************************************************************************
+ * Decoded audio frames
+ *****************************************************************************/
+
+struct libvlc_audio_frame_t
+{
+    vlc_atomic_rc_t rc;
+    block_t *block;
+    vlc_tick_t date;
+    vlc_fourcc_t format;
+    unsigned rate;
+    unsigned channels;
+};
+
+/* Called by the amem audio output, from the audio output thread */
+static void audio_frame_deliver( void *opaque, block_t *block,
+                                 const audio_sample_format_t *fmt,
+                                 vlc_tick_t date )
+{
+    libvlc_media_player_t *mp = opaque;
+    libvlc_audio_frame_t *frame = malloc( sizeof( *frame ) );
+
+    if( unlikely(frame == NULL) )
+    {
+        block_Release( block );
+        return;
+    }
+
+    vlc_atomic_rc_init( &frame->rc );
+    frame->block = block;
+    frame->date = date;
+    frame->format = fmt->i_format;
+    frame->rate = fmt->i_rate;
+    frame->channels = aout_FormatNbChannels( fmt );
+    mp->audio_frames.cb( mp->audio_frames.opaque, frame );
+}
+
+void libvlc_audio_set_frame_callback( libvlc_media_player_t *mp,
+                                      libvlc_audio_frame_cb cb,
+                                      void *opaque )
+{
+    assert( cb != NULL );
+    mp->audio_frames.cb = cb;
+    mp->audio_frames.opaque = opaque;
+    var_SetAddress( mp, "amem-frame", audio_frame_deliver );
+    var_SetAddress( mp, "amem-frame-data", mp );
+    var_SetAddress( mp, "amem-data", opaque );
+    var_SetString( mp, "aout", "amem,none" );
+
+    vlc_player_aout_Reset( mp->player );
+}
+
+libvlc_audio_frame_t *libvlc_audio_frame_retain( libvlc_audio_frame_t *frame )
+{
+    vlc_atomic_rc_inc( &frame->rc );
+    return frame;
+}
+
+void libvlc_audio_frame_release( libvlc_audio_frame_t *frame )
+{
+    if( !vlc_atomic_rc_dec( &frame->rc ) )
+        return;
+
+    block_Release( frame->block );
+    free( frame );
+}
+
+const void *libvlc_audio_frame_get_samples( const libvlc_audio_frame_t *frame,
+                                            unsigned *count )
+{
+    *count = frame->block->i_nb_samples;
+    return frame->block->p_buffer;
+}
+
+void libvlc_audio_frame_get_format( const libvlc_audio_frame_t *frame,
+                                    char format[5], unsigned *rate,
+                                    unsigned *channels )
+{
+    /* Same names as the format callbacks */
+    switch( frame->format )
+    {
+        case VLC_CODEC_S16N: strcpy( format, "S16N" ); break;
+        case VLC_CODEC_S32N: strcpy( format, "S32N" ); break;
+        case VLC_CODEC_FL32: strcpy( format, "FL32" ); break;
+        default:
+            memcpy( format, &frame->format, 4 );
+            format[4] = '\0';
+    }
+    *rate = frame->rate;
+    *channels = frame->channels;
+}
+
+libvlc_time_t libvlc_audio_frame_get_time( const libvlc_audio_frame_t *frame,
+                                           int64_t *pts )
+{
+    if( pts != NULL )
+        *pts = US_FROM_VLC_TICK( frame->date );
+    return libvlc_time_from_vlc_tick( frame->block->i_pts );
+}
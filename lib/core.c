@@ -29,6 +29,7 @@
 #include <vlc/vlc.h>
 
 #include <vlc_interface.h>
+#include <vlc_memaccount.h>
 
 #include <stdarg.h>
 #include <limits.h>
@@ -234,4 +235,26 @@ int64_t libvlc_clock(void)
     return US_FROM_VLC_TICK(vlc_tick_now());
 }
 
+int libvlc_memory_get_stats( libvlc_instance_t *p_instance,
+                             libvlc_memory_subsystem_t subsystem,
+                             libvlc_memory_stats_t *p_stats )
+{
+    static const enum vlc_memaccount_type types[] = {
+        [libvlc_memory_frame] = VLC_MEMACCOUNT_FRAME,
+        [libvlc_memory_picture] = VLC_MEMACCOUNT_PICTURE,
+        [libvlc_memory_cache] = VLC_MEMACCOUNT_CACHE,
+    };
+    struct vlc_memaccount_stats stats;
+    (void) p_instance;
+
+    if( (unsigned)subsystem >= ARRAY_SIZE(types) )
+        return -1;
+
+    vlc_memaccount_GetStats( types[subsystem], &stats );
+    p_stats->i_used = stats.used;
+    p_stats->i_peak = stats.peak;
+    p_stats->i_budget = stats.budget;
+    return 0;
+}
+
 const char vlc_module_name[] = "libvlc";
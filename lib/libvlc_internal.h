@@ -53,6 +53,7 @@ VLC_API int libvlc_InternalAddIntf( libvlc_int_t *, const char * );
 VLC_API void libvlc_InternalPlay( libvlc_int_t * );
 VLC_API void libvlc_InternalWait( libvlc_int_t * );
 VLC_API void libvlc_SetExitHandler( libvlc_int_t *, void (*) (void *), void * );
+VLC_API struct vlc_thumbnailer_t *libvlc_GetThumbnailer( libvlc_int_t * );
 
 /***************************************************************************
  * Opaque structures for libvlc API
@@ -740,6 +740,11 @@ bool libvlc_media_get_stats(libvlc_media_t *p_md,
 
     p_stats->i_decoded_video = p_itm_stats->i_decoded_video;
     p_stats->i_decoded_audio = p_itm_stats->i_decoded_audio;
+    static_assert(LIBVLC_MEDIA_STATS_DECODE_TIME_BUCKETS
+                  == INPUT_STATS_DECODE_TIME_BUCKETS, "Mismatched buckets");
+    for( size_t i = 0; i < LIBVLC_MEDIA_STATS_DECODE_TIME_BUCKETS; i++ )
+        p_stats->i_decode_time[i] = p_itm_stats->pi_decode_time[i];
+    p_stats->i_decoder_queue_max = p_itm_stats->i_decoder_queue_max;
 
     p_stats->i_displayed_pictures = p_itm_stats->i_displayed_pictures;
     p_stats->i_late_pictures = p_itm_stats->i_late_pictures;
@@ -999,8 +1004,9 @@ libvlc_media_thumbnail_request_by_time( libvlc_instance_t *inst,
 {
     assert( md );
 
-    libvlc_priv_t *p_priv = libvlc_priv(inst->p_libvlc_int);
-    if( unlikely( p_priv->p_thumbnailer == NULL ) )
+    vlc_thumbnailer_t *thumbnailer =
+        libvlc_GetThumbnailer( inst->p_libvlc_int );
+    if( unlikely( thumbnailer == NULL ) )
         return NULL;
 
     libvlc_media_thumbnail_request_t *req = malloc( sizeof( *req ) );
@@ -1014,7 +1020,7 @@ libvlc_media_thumbnail_request_by_time( libvlc_instance_t *inst,
     req->type = picture_type;
     req->crop = crop;
     libvlc_media_retain( md );
-    req->req = vlc_thumbnailer_RequestByTime( p_priv->p_thumbnailer,
+    req->req = vlc_thumbnailer_RequestByTime( thumbnailer,
         vlc_tick_from_libvlc_time( time ),
         speed == libvlc_media_thumbnail_seek_fast ?
             VLC_THUMBNAILER_SEEK_FAST : VLC_THUMBNAILER_SEEK_PRECISE,
@@ -1042,8 +1048,9 @@ libvlc_media_thumbnail_request_by_pos( libvlc_instance_t *inst,
 {
     assert( md );
 
-    libvlc_priv_t *priv = libvlc_priv(inst->p_libvlc_int);
-    if( unlikely( priv->p_thumbnailer == NULL ) )
+    vlc_thumbnailer_t *thumbnailer =
+        libvlc_GetThumbnailer( inst->p_libvlc_int );
+    if( unlikely( thumbnailer == NULL ) )
         return NULL;
 
     libvlc_media_thumbnail_request_t *req = malloc( sizeof( *req ) );
@@ -1057,7 +1064,7 @@ libvlc_media_thumbnail_request_by_pos( libvlc_instance_t *inst,
     req->crop = crop;
     req->type = picture_type;
     libvlc_media_retain( md );
-    req->req = vlc_thumbnailer_RequestByPos( priv->p_thumbnailer, pos,
+    req->req = vlc_thumbnailer_RequestByPos( thumbnailer, pos,
         speed == libvlc_media_thumbnail_seek_fast ?
             VLC_THUMBNAILER_SEEK_FAST : VLC_THUMBNAILER_SEEK_PRECISE,
         md->p_input_item,
@@ -1076,9 +1083,11 @@ libvlc_media_thumbnail_request_by_pos( libvlc_instance_t *inst,
 // Destroy a thumbnail request
 void libvlc_media_thumbnail_request_destroy( libvlc_media_thumbnail_request_t *req )
 {
-    libvlc_priv_t *p_priv = libvlc_priv(req->instance->p_libvlc_int);
-    assert( p_priv->p_thumbnailer != NULL );
-    vlc_thumbnailer_DestroyRequest( p_priv->p_thumbnailer, req->req );
+    /* The thumbnailer was created with the request */
+    vlc_thumbnailer_t *thumbnailer =
+        libvlc_GetThumbnailer( req->instance->p_libvlc_int );
+    assert( thumbnailer != NULL );
+    vlc_thumbnailer_DestroyRequest( thumbnailer, req->req );
     libvlc_media_release( req->md );
     libvlc_release(req->instance);
     free( req );
@@ -629,6 +629,8 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create (mp, "vmem-width", VLC_VAR_INTEGER);
     var_Create (mp, "vmem-height", VLC_VAR_INTEGER);
     var_Create (mp, "vmem-pitch", VLC_VAR_INTEGER);
+    var_Create (mp, "vframe-cb", VLC_VAR_ADDRESS);
+    var_Create (mp, "vframe-data", VLC_VAR_ADDRESS);
 
     var_Create (mp, "vout-cb-type", VLC_VAR_INTEGER );
     var_Create( mp, "vout-cb-opaque", VLC_VAR_ADDRESS );
@@ -714,10 +716,15 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create (mp, "corks", VLC_VAR_INTEGER);
     var_Create (mp, "audio-filter", VLC_VAR_STRING);
     var_Create (mp, "role", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
+    var_Create (mp, "thread-affinity", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
+    var_Create (mp, "thread-priorities", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
+    var_Create (mp, "thread-cgroup", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
     var_Create (mp, "amem-data", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-setup", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-cleanup", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-play", VLC_VAR_ADDRESS);
+    var_Create (mp, "amem-frame", VLC_VAR_ADDRESS);
+    var_Create (mp, "amem-frame-data", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-pause", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-resume", VLC_VAR_ADDRESS);
     var_Create (mp, "amem-flush", VLC_VAR_ADDRESS);
@@ -742,6 +749,8 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create(mp, "record-file", VLC_VAR_STRING);
 
     mp->timer.id = NULL;
+    mp->video_frames.cb = NULL;
+    mp->audio_frames.cb = NULL;
     mp->p_md = NULL;
     mp->p_libvlc_instance = instance;
     /* use a reentrant lock to allow calling libvlc functions from callbacks */
@@ -2214,6 +2223,19 @@ int libvlc_media_player_set_role(libvlc_media_player_t *mp, unsigned role)
     return 0;
 }
 
+int libvlc_media_player_set_thread_policy(libvlc_media_player_t *mp,
+                                          const char *cpus,
+                                          const char *priorities,
+                                          const char *cgroup)
+{
+    /* An empty string is no setting, NULL would inherit the instance one */
+    if (var_SetString(mp, "thread-affinity", cpus ? cpus : "")
+     || var_SetString(mp, "thread-priorities", priorities ? priorities : "")
+     || var_SetString(mp, "thread-cgroup", cgroup ? cgroup : ""))
+        return -1;
+    return 0;
+}
+
 int libvlc_media_player_get_role(libvlc_media_player_t *mp)
 {
     int ret = -1;
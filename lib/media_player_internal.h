@@ -56,6 +56,16 @@ struct libvlc_media_player_t
         libvlc_media_player_watch_time_on_discontinuity on_discontinuity;
         void *cbs_data;
     } timer;
+
+    struct {
+        libvlc_video_frame_cb cb;
+        void *opaque;
+    } video_frames;
+
+    struct {
+        libvlc_audio_frame_cb cb;
+        void *opaque;
+    } audio_frames;
 };
 
 libvlc_track_description_t * libvlc_get_track_description(
@@ -0,0 +1,274 @@
+/*****************************************************************************
+ * remux.c: libvlc batch remuxing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc/libvlc.h>
+#include <vlc/libvlc_renderer_discoverer.h>
+#include <vlc/libvlc_picture.h>
+#include <vlc/libvlc_media.h>
+#include <vlc/libvlc_media_player.h>
+#include <vlc/libvlc_events.h>
+#include <vlc/libvlc_remux.h>
+
+#include <vlc_common.h>
+#include <vlc_configuration.h>
+#include <vlc_list.h>
+
+#include "libvlc_internal.h"
+
+/* Write buffer of the output files, in KiB */
+#define REMUX_WRITE_BUFFER 4096
+
+struct remux_job
+{
+    struct vlc_list node;
+    libvlc_media_t *media;
+};
+
+struct libvlc_remux_t
+{
+    libvlc_instance_t *instance;
+
+    vlc_mutex_t lock;
+    vlc_cond_t wait;   /* a job was queued, or the remuxer is released */
+    vlc_cond_t done;   /* a job or a player ended */
+    struct vlc_list jobs;
+    unsigned running;
+    unsigned failed;
+    bool exiting;
+
+    unsigned thread_count;
+    vlc_thread_t threads[];
+};
+
+struct remux_run
+{
+    libvlc_remux_t *remux;
+    bool ended;
+    bool error;
+};
+
+static void remux_on_event(const struct libvlc_event_t *event, void *data)
+{
+    struct remux_run *run = data;
+    libvlc_remux_t *remux = run->remux;
+
+    vlc_mutex_lock(&remux->lock);
+    if (event->type == libvlc_MediaPlayerEncounteredError)
+        run->error = true;
+    else
+        run->ended = true;
+    vlc_cond_broadcast(&remux->done);
+    vlc_mutex_unlock(&remux->lock);
+}
+
+/* Called with the lock held, returns true on success */
+static bool remux_run(libvlc_remux_t *remux, libvlc_media_t *media)
+{
+    struct remux_run run = { .remux = remux };
+    bool interrupted;
+
+    vlc_mutex_unlock(&remux->lock);
+
+    libvlc_media_player_t *mp =
+        libvlc_media_player_new_from_media(remux->instance, media);
+    if (mp == NULL)
+    {
+        vlc_mutex_lock(&remux->lock);
+        return false;
+    }
+
+    libvlc_event_manager_t *em = libvlc_media_player_event_manager(mp);
+    libvlc_event_attach(em, libvlc_MediaPlayerStopped, remux_on_event, &run);
+    libvlc_event_attach(em, libvlc_MediaPlayerEncounteredError,
+                        remux_on_event, &run);
+
+    bool started = libvlc_media_player_play(mp) == 0;
+
+    vlc_mutex_lock(&remux->lock);
+    while (started && !run.ended && !remux->exiting)
+        vlc_cond_wait(&remux->done, &remux->lock);
+    interrupted = !run.ended;
+    vlc_mutex_unlock(&remux->lock);
+
+    libvlc_media_player_stop_async(mp);
+    libvlc_event_detach(em, libvlc_MediaPlayerStopped, remux_on_event, &run);
+    libvlc_event_detach(em, libvlc_MediaPlayerEncounteredError,
+                        remux_on_event, &run);
+    libvlc_media_player_release(mp);
+
+    vlc_mutex_lock(&remux->lock);
+    return started && !interrupted && !run.error;
+}
+
+static void *remux_thread(void *data)
+{
+    libvlc_remux_t *remux = data;
+
+    vlc_thread_set_name("vlc-remux");
+
+    vlc_mutex_lock(&remux->lock);
+    for (;;)
+    {
+        struct remux_job *job =
+            vlc_list_first_entry_or_null(&remux->jobs, struct remux_job, node);
+
+        if (remux->exiting)
+            break;
+        if (job == NULL)
+        {
+            vlc_cond_wait(&remux->wait, &remux->lock);
+            continue;
+        }
+
+        vlc_list_remove(&job->node);
+        remux->running++;
+
+        if (!remux_run(remux, job->media))
+            remux->failed++;
+
+        remux->running--;
+        vlc_cond_broadcast(&remux->done);
+
+        libvlc_media_release(job->media);
+        free(job);
+    }
+    vlc_mutex_unlock(&remux->lock);
+    return NULL;
+}
+
+libvlc_remux_t *libvlc_remux_new(libvlc_instance_t *instance, unsigned jobs)
+{
+    if (jobs == 0)
+        jobs = 1;
+
+    libvlc_remux_t *remux = malloc(sizeof (*remux)
+                                   + jobs * sizeof (remux->threads[0]));
+    if (unlikely(remux == NULL))
+    {
+        libvlc_printerr("Not enough memory");
+        return NULL;
+    }
+
+    remux->instance = instance;
+    vlc_mutex_init(&remux->lock);
+    vlc_cond_init(&remux->wait);
+    vlc_cond_init(&remux->done);
+    vlc_list_init(&remux->jobs);
+    remux->running = 0;
+    remux->failed = 0;
+    remux->exiting = false;
+
+    for (remux->thread_count = 0; remux->thread_count < jobs;
+         remux->thread_count++)
+        if (vlc_clone(&remux->threads[remux->thread_count], remux_thread,
+                      remux))
+            break;
+
+    if (remux->thread_count == 0)
+    {
+        libvlc_printerr("Cannot start the remuxing threads");
+        free(remux);
+        return NULL;
+    }
+
+    libvlc_retain(instance);
+    return remux;
+}
+
+int libvlc_remux_add(libvlc_remux_t *remux, const char *mrl, const char *mux,
+                     const char *dst)
+{
+    char *dst_escaped = config_StringEscape(dst);
+    char *mux_escaped = config_StringEscape(mux);
+    char *option;
+
+    if (unlikely(dst_escaped == NULL || mux_escaped == NULL)
+     || asprintf(&option, ":sout=#std{access=file{no-append,no-format,"
+                 "overwrite,buffer=%u},mux='%s',dst='%s'}",
+                 REMUX_WRITE_BUFFER, mux_escaped, dst_escaped) == -1)
+        option = NULL;
+    free(dst_escaped);
+    free(mux_escaped);
+
+    struct remux_job *job = malloc(sizeof (*job));
+    if (unlikely(job == NULL || option == NULL))
+        goto error;
+
+    job->media = libvlc_media_new_location(mrl);
+    if (job->media == NULL)
+        goto error;
+
+    libvlc_media_add_option(job->media, option);
+    /* Paced by the output rather than by the clock */
+    libvlc_media_add_option(job->media, ":offline");
+    libvlc_media_add_option(job->media, ":sout-all");
+    free(option);
+
+    vlc_mutex_lock(&remux->lock);
+    vlc_list_append(&job->node, &remux->jobs);
+    vlc_cond_signal(&remux->wait);
+    vlc_mutex_unlock(&remux->lock);
+    return 0;
+
+error:
+    libvlc_printerr("Not enough memory");
+    free(job);
+    free(option);
+    return -1;
+}
+
+unsigned libvlc_remux_wait(libvlc_remux_t *remux)
+{
+    vlc_mutex_lock(&remux->lock);
+    while (!vlc_list_is_empty(&remux->jobs) || remux->running > 0)
+        vlc_cond_wait(&remux->done, &remux->lock);
+    unsigned failed = remux->failed;
+    vlc_mutex_unlock(&remux->lock);
+    return failed;
+}
+
+void libvlc_remux_release(libvlc_remux_t *remux)
+{
+    struct remux_job *job;
+
+    vlc_mutex_lock(&remux->lock);
+    remux->exiting = true;
+    vlc_cond_broadcast(&remux->wait);
+    vlc_cond_broadcast(&remux->done);
+    vlc_mutex_unlock(&remux->lock);
+
+    for (unsigned i = 0; i < remux->thread_count; i++)
+        vlc_join(remux->threads[i], NULL);
+
+    vlc_list_foreach(job, &remux->jobs, node)
+    {
+        libvlc_media_release(job->media);
+        free(job);
+    }
+
+    libvlc_release(remux->instance);
+    free(remux);
+}
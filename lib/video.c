@@ -38,9 +38,13 @@
 #include <vlc_modules.h>
 #include <vlc_vout.h>
 #include <vlc_url.h>
+#include <vlc_atomic.h>
+#include <vlc_fs.h>
 
 #include "libvlc_internal.h"
 #include "media_player_internal.h"
+#include "picture_internal.h"
+#include "../modules/video_output/vframe.h"
 #include <math.h>
 #include <assert.h>
 
@@ -155,6 +159,70 @@ libvlc_video_take_snapshot( libvlc_media_player_t *p_mi, unsigned num,
     return 0;
 }
 
+struct snapshot_ctx
+{
+    vlc_object_t *obj;
+    libvlc_video_snapshot_cb cb;
+    void *opaque;
+    libvlc_picture_type_t type;
+    unsigned width;
+    unsigned height;
+};
+
+/* Called on the vout snapshot worker */
+static void on_snapshot( void *opaque, picture_t *input )
+{
+    struct snapshot_ctx *ctx = opaque;
+    libvlc_picture_t *pic = NULL;
+
+    if( input != NULL )
+        pic = libvlc_picture_new( ctx->obj, input, ctx->type,
+                                  ctx->width, ctx->height, false );
+
+    ctx->cb( ctx->opaque, pic );
+    if( pic != NULL )
+        libvlc_picture_release( pic );
+    free( ctx );
+}
+
+int
+libvlc_video_take_snapshot_async( libvlc_media_player_t *p_mi, unsigned num,
+                                  libvlc_picture_type_t type,
+                                  unsigned int i_width, unsigned int i_height,
+                                  libvlc_video_snapshot_cb cb, void *opaque )
+{
+    assert( cb != NULL );
+
+    vout_thread_t *p_vout = GetVout (p_mi, num);
+    if (p_vout == NULL)
+        return -1;
+
+    struct snapshot_ctx *ctx = malloc( sizeof( *ctx ) );
+    if( unlikely( ctx == NULL ) )
+    {
+        vout_Release(p_vout);
+        return -1;
+    }
+
+    /* The vout outlives the callback, which is called at the latest when it
+     * is closed */
+    ctx->obj = VLC_OBJECT(p_vout);
+    ctx->cb = cb;
+    ctx->opaque = opaque;
+    ctx->type = type;
+    ctx->width = i_width;
+    ctx->height = i_height;
+
+    int ret = vout_GetSnapshotAsync( p_vout, on_snapshot, ctx );
+    vout_Release(p_vout);
+    if( ret != VLC_SUCCESS )
+    {
+        free( ctx );
+        return -1;
+    }
+    return 0;
+}
+
 int libvlc_video_get_size( libvlc_media_player_t *p_mi, unsigned ignored,
                            unsigned *restrict px, unsigned *restrict py )
 {
@@ -550,6 +618,7 @@ void libvlc_video_set_deinterlace( libvlc_media_player_t *p_mi, int deinterlace,
      && strcmp (psz_mode, "discard")  && strcmp (psz_mode, "linear")
      && strcmp (psz_mode, "mean")     && strcmp (psz_mode, "x")
      && strcmp (psz_mode, "yadif")    && strcmp (psz_mode, "yadif2x")
+     && strcmp (psz_mode, "bwdif")    && strcmp (psz_mode, "bwdif2x")
      && strcmp (psz_mode, "phosphor") && strcmp (psz_mode, "ivtc")
      && strcmp (psz_mode, "auto"))
         return;
@@ -932,3 +1001,146 @@ float libvlc_video_get_adjust_float( libvlc_media_player_t *p_mi,
 {
     return get_float( p_mi, "adjust", adjust_option_bynumber(option) );
 }
+
+/******************************************************************************
+ * Decoded video frames
+ *****************************************************************************/
+
+struct libvlc_video_frame_t
+{
+    vlc_atomic_rc_t rc;
+    picture_t *pic;
+    struct vlc_vframe_surface surface;
+};
+
+static_assert((int)libvlc_video_surface_dmabuf == VLC_VFRAME_SURFACE_DMABUF
+           && (int)libvlc_video_surface_d3d11 == VLC_VFRAME_SURFACE_D3D11
+           && (int)libvlc_video_surface_cvpixelbuffer
+              == VLC_VFRAME_SURFACE_CVPIXELBUFFER,
+              "surface types mismatch");
+
+/* Called by the vframe video output, from the video output thread */
+static void video_frame_deliver( void *opaque, picture_t *pic,
+                                 const struct vlc_vframe_surface *surface )
+{
+    libvlc_media_player_t *mp = opaque;
+    libvlc_video_frame_t *frame = malloc( sizeof( *frame ) );
+
+    if( unlikely(frame == NULL) )
+    {
+        if( surface->fd != -1 )
+            vlc_close( surface->fd );
+        picture_Release( pic );
+        return;
+    }
+
+    vlc_atomic_rc_init( &frame->rc );
+    frame->pic = pic;
+    frame->surface = *surface;
+    mp->video_frames.cb( mp->video_frames.opaque, frame );
+}
+
+void libvlc_video_set_frame_callback( libvlc_media_player_t *mp,
+                                      libvlc_video_frame_cb cb,
+                                      void *opaque )
+{
+    assert( cb != NULL );
+    mp->video_frames.cb = cb;
+    mp->video_frames.opaque = opaque;
+    var_SetAddress( mp, "vframe-cb", video_frame_deliver );
+    var_SetAddress( mp, "vframe-data", mp );
+    var_SetString( mp, "vout", "vframe" );
+    var_SetString( mp, "window", "dummy" );
+}
+
+libvlc_video_frame_t *libvlc_video_frame_retain( libvlc_video_frame_t *frame )
+{
+    vlc_atomic_rc_inc( &frame->rc );
+    return frame;
+}
+
+void libvlc_video_frame_release( libvlc_video_frame_t *frame )
+{
+    if( !vlc_atomic_rc_dec( &frame->rc ) )
+        return;
+
+    if( frame->surface.fd != -1 )
+        vlc_close( frame->surface.fd );
+    picture_Release( frame->pic );
+    free( frame );
+}
+
+void libvlc_video_frame_get_format( const libvlc_video_frame_t *frame,
+                                    libvlc_video_frame_format_t *format )
+{
+    const video_format_t *fmt = &frame->pic->format;
+    vlc_fourcc_t chroma = frame->surface.chroma != 0 ? frame->surface.chroma
+                                                     : fmt->i_chroma;
+
+    memcpy( format->chroma, &chroma, 4 );
+    format->chroma[4] = '\0';
+    format->width = fmt->i_width;
+    format->height = fmt->i_height;
+    format->x_offset = fmt->i_x_offset;
+    format->y_offset = fmt->i_y_offset;
+    format->visible_width = fmt->i_visible_width;
+    format->visible_height = fmt->i_visible_height;
+    format->sar_num = fmt->i_sar_num;
+    format->sar_den = fmt->i_sar_den;
+}
+
+libvlc_time_t libvlc_video_frame_get_time( const libvlc_video_frame_t *frame )
+{
+    return libvlc_time_from_vlc_tick( frame->pic->date );
+}
+
+const void *libvlc_video_frame_get_plane( const libvlc_video_frame_t *frame,
+                                          unsigned plane, unsigned *pitch,
+                                          unsigned *lines, size_t *offset )
+{
+    const struct vlc_vframe_surface *surface = &frame->surface;
+    const picture_t *pic = frame->pic;
+    const void *pixels = NULL;
+
+    *pitch = *lines = 0;
+    if( offset != NULL )
+        *offset = 0;
+
+    switch( surface->type )
+    {
+        case VLC_VFRAME_SURFACE_NONE:
+            if( plane < (unsigned)pic->i_planes )
+            {
+                pixels = pic->p[plane].p_pixels;
+                *pitch = pic->p[plane].i_pitch;
+                *lines = pic->p[plane].i_lines;
+            }
+            break;
+        case VLC_VFRAME_SURFACE_DMABUF:
+            if( plane < surface->planes )
+            {
+                *pitch = surface->pitches[plane];
+                *lines = surface->lines[plane];
+                if( offset != NULL )
+                    *offset = surface->offsets[plane];
+            }
+            break;
+        default:
+            break;
+    }
+    return pixels;
+}
+
+libvlc_video_surface_type_t
+libvlc_video_frame_get_surface( const libvlc_video_frame_t *frame,
+                                void **handle, unsigned *index )
+{
+    const struct vlc_vframe_surface *surface = &frame->surface;
+
+    if( handle != NULL )
+        *handle = surface->type == VLC_VFRAME_SURFACE_DMABUF
+                ? (void *)(intptr_t)surface->fd : surface->handle;
+    if( index != NULL )
+        *index = surface->index;
+    return (libvlc_video_surface_type_t)surface->type;
+}
@@ -52,6 +52,9 @@
 #include "sdi.h"
 
 #include <atomic>
+#include <cassert>
+#include <new>
+#include <vector>
 
 static int  Open (vlc_object_t *);
 static void Close(vlc_object_t *);
@@ -141,12 +144,14 @@ static int Control(demux_t *, int, va_list);
 namespace {
 
 class DeckLinkCaptureDelegate;
+class DeckLinkBlockAllocator;
 
 struct demux_sys_t
 {
     IDeckLink *card;
     IDeckLinkInput *input;
     DeckLinkCaptureDelegate *delegate;
+    DeckLinkBlockAllocator *allocator;
 
     /* We need to hold onto the IDeckLinkConfiguration object, or our settings will not apply.
        See section 2.4.15 of the Blackmagic DeckLink SDK documentation. */
@@ -246,6 +251,198 @@ static es_format_t GetModeSettings(demux_t *demux, IDeckLinkDisplayMode *m,
 }
 namespace {
 
+/* Capture buffers allocator.
+ *
+ * The card captures straight into buffers that can be handed over to the
+ * pipeline as blocks. A buffer is only recycled once both the driver and
+ * the block are done with it. */
+class DeckLinkBlockAllocator : public IDeckLinkMemoryAllocator
+{
+public:
+    DeckLinkBlockAllocator() : committed(false)
+    {
+        m_ref_.store(1);
+        vlc_mutex_init(&lock);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, LPVOID *) override { return E_NOINTERFACE; }
+
+    ULONG STDMETHODCALLTYPE AddRef(void) override
+    {
+        return m_ref_.fetch_add(1) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release(void) override
+    {
+        ULONG new_ref = m_ref_.fetch_sub(1) - 1;
+        if (new_ref == 0)
+            delete this;
+        return new_ref;
+    }
+
+    HRESULT STDMETHODCALLTYPE AllocateBuffer(uint32_t size, void **allocated) override
+    {
+        vlc_mutex_lock(&lock);
+        for (auto it = idle.begin(); it != idle.end(); ++it) {
+            buffer *buf = *it;
+            if (buf->size == size) {
+                idle.erase(it);
+                buf->refs = 1;
+                vlc_mutex_unlock(&lock);
+                *allocated = buf->data;
+                return S_OK;
+            }
+        }
+        vlc_mutex_unlock(&lock);
+
+        buffer *buf = new (std::nothrow) buffer;
+        if (buf == NULL)
+            return E_OUTOFMEMORY;
+        buf->data = static_cast<uint8_t *>(aligned_alloc(4096, (size + 4095) & ~4095u));
+        if (buf->data == NULL) {
+            delete buf;
+            return E_OUTOFMEMORY;
+        }
+        buf->owner = this;
+        buf->size = size;
+        buf->refs = 1;
+        AddRef();
+
+        vlc_mutex_lock(&lock);
+        buffers.push_back(buf);
+        vlc_mutex_unlock(&lock);
+        *allocated = buf->data;
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE ReleaseBuffer(void *data) override
+    {
+        buffer *buf = Find(data);
+        if (buf == NULL)
+            return E_INVALIDARG;
+        Unref(buf);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE Commit(void) override
+    {
+        vlc_mutex_lock(&lock);
+        committed = true;
+        vlc_mutex_unlock(&lock);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE Decommit(void) override
+    {
+        std::vector<buffer *> unused;
+
+        vlc_mutex_lock(&lock);
+        committed = false;
+        unused.swap(idle);
+        for (buffer *buf : unused)
+            Forget(buf);
+        vlc_mutex_unlock(&lock);
+
+        for (buffer *buf : unused)
+            Destroy(buf);
+        return S_OK;
+    }
+
+    /* Wraps captured bytes into a block, or returns NULL if the bytes are not
+     * from one of our buffers. */
+    block_t *Hold(const void *data, size_t length)
+    {
+        static const struct vlc_block_callbacks cbs = { BlockRelease };
+
+        vlc_mutex_lock(&lock);
+        buffer *buf = NULL;
+        for (buffer *b : buffers) {
+            if (b->data == data && b->refs == 1 && length <= b->size) {
+                buf = b;
+                buf->refs++;
+                break;
+            }
+        }
+        vlc_mutex_unlock(&lock);
+
+        if (buf == NULL)
+            return NULL;
+        return block_Init(&buf->self, &cbs, buf->data, length);
+    }
+
+private:
+    struct buffer
+    {
+        block_t self;
+        DeckLinkBlockAllocator *owner;
+        uint8_t *data;
+        size_t size;
+        unsigned refs; /* driver and block references, protected by <lock> */
+    };
+
+    virtual ~DeckLinkBlockAllocator()
+    {
+        assert(buffers.empty());
+    }
+
+    buffer *Find(const void *data)
+    {
+        vlc_mutex_locker locker(&lock);
+        for (buffer *buf : buffers)
+            if (buf->data == data)
+                return buf;
+        return NULL;
+    }
+
+    void Forget(buffer *buf)
+    {
+        for (auto it = buffers.begin(); it != buffers.end(); ++it)
+            if (*it == buf) {
+                buffers.erase(it);
+                break;
+            }
+    }
+
+    void Unref(buffer *buf)
+    {
+        vlc_mutex_lock(&lock);
+        assert(buf->refs > 0);
+        if (--buf->refs > 0) {
+            vlc_mutex_unlock(&lock);
+            return;
+        }
+        if (committed) {
+            idle.push_back(buf);
+            vlc_mutex_unlock(&lock);
+            return;
+        }
+        Forget(buf);
+        vlc_mutex_unlock(&lock);
+        Destroy(buf);
+    }
+
+    void Destroy(buffer *buf)
+    {
+        DeckLinkBlockAllocator *owner = buf->owner;
+
+        aligned_free(buf->data);
+        delete buf;
+        owner->Release();
+    }
+
+    static void BlockRelease(block_t *block)
+    {
+        buffer *buf = container_of(block, buffer, self);
+        buf->owner->Unref(buf);
+    }
+
+    std::atomic_uint m_ref_;
+    vlc_mutex_t lock;
+    bool committed;
+    std::vector<buffer *> buffers; /* all the live buffers */
+    std::vector<buffer *> idle; /* buffers ready for reuse */
+};
+
 class DeckLinkCaptureDelegate : public IDeckLinkInputCallback
 {
 public:
@@ -356,13 +553,22 @@ HRESULT DeckLinkCaptureDelegate::VideoInputFrameArrived(IDeckLinkVideoInputFrame
                 bpp = 2;
                 break;
         };
-        block_t *video_frame = block_Alloc(width * height * bpp);
-        if (!video_frame)
-            return S_OK;
-
         const uint32_t *frame_bytes;
         videoFrame->GetBytes((void**)&frame_bytes);
 
+        /* Packed frames without padding are passed as captured */
+        block_t *video_frame = NULL;
+        if (sys->allocator != NULL && sys->video_fmt.i_codec != VLC_CODEC_I422_10L
+         && stride == width * bpp)
+            video_frame = sys->allocator->Hold(frame_bytes, stride * height);
+
+        const bool copy = video_frame == NULL;
+        if (copy) {
+            video_frame = block_Alloc(width * height * bpp);
+            if (!video_frame)
+                return S_OK;
+        }
+
         BMDTimeValue stream_time, frame_duration;
         videoFrame->GetStreamTime(&stream_time, &frame_duration, CLOCK_FREQ);
         video_frame->i_flags = BLOCK_FLAG_TYPE_I | sys->dominance_flags;
@@ -401,6 +607,8 @@ HRESULT DeckLinkCaptureDelegate::VideoInputFrameArrived(IDeckLinkVideoInputFrame
                 }
                 vanc->Release();
             }
+        } else if (!copy) {
+            /* already in place */
         } else if (sys->video_fmt.i_codec == VLC_CODEC_UYVY) {
             for (int y = 0; y < height; ++y) {
                 const uint8_t *src = (const uint8_t *)frame_bytes + stride * y;
@@ -616,6 +824,13 @@ static int Open(vlc_object_t *p_this)
     if (GetVideoConn(demux) || GetAudioConn(demux))
         goto finish;
 
+    sys->allocator = new DeckLinkBlockAllocator();
+    if (sys->input->SetVideoInputFrameMemoryAllocator(sys->allocator) != S_OK) {
+        msg_Warn(demux, "Failed to set the capture allocator, frames will be copied");
+        sys->allocator->Release();
+        sys->allocator = NULL;
+    }
+
     BMDPixelFormat fmt;
     fmt = sys->tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV;
     if (sys->attributes->GetFlag(BMDDeckLinkSupportsInputFormatDetection, &sys->autodetect) != S_OK) {
@@ -796,6 +1011,10 @@ static void Close(vlc_object_t *p_this)
         sys->input->Release();
     }
 
+    /* Blocks still in the pipeline keep their buffers, and the allocator */
+    if (sys->allocator)
+        sys->allocator->Release();
+
     if (sys->card)
         sys->card->Release();
 
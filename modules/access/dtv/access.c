@@ -53,6 +53,11 @@
     "Only useful programs are normally demultiplexed from the transponder. " \
     "This option will disable demultiplexing and receive all programs.")
 
+#define SHARED_TEXT N_("Share the tuner")
+#define SHARED_LONGTEXT N_( \
+    "Inputs of the same adapter and device share the tuner, so that each " \
+    "one can receive different programs from the same transponder.")
+
 #define NAME_TEXT N_("Network name")
 #define NAME_LONGTEXT N_("Unique network name in the System Tuning Spaces")
 
@@ -267,6 +272,7 @@ vlc_module_begin ()
         change_integer_range (0, 255)
         change_safe ()
     add_bool ("dvb-budget-mode", false, BUDGET_TEXT, BUDGET_LONGTEXT)
+    add_bool ("dvb-shared", false, SHARED_TEXT, SHARED_LONGTEXT)
 #endif
 #ifdef _WIN32
     add_integer ("dvb-adapter", -1, ADAPTER_TEXT, ADAPTER_LONGTEXT)
@@ -426,16 +432,22 @@ vlc_module_end ()
 typedef struct
 {
     dvb_device_t *dev;
+    dtv_subscriber_t *sub;
     uint8_t signal_poll;
     tuner_setup_t pf_setup;
 } access_sys_t;
 
 static block_t *Read (stream_t *, bool * restrict);
 static int Control (stream_t *, int, va_list);
+#ifdef HAVE_LINUX_DVB
+static block_t *ReadShared (stream_t *, bool * restrict);
+static int ControlShared (stream_t *, int, va_list);
+#endif
 static dtv_delivery_t GuessSystem (const char *, dvb_device_t *);
 static dtv_delivery_t GetDeliveryByScheme(const char *psz_scheme);
 static int Tune (vlc_object_t *, dvb_device_t *, tuner_setup_t, uint64_t);
 static uint64_t var_InheritFrequency (vlc_object_t *);
+static int TuneAccess (vlc_object_t *, dvb_device_t *, uint64_t);
 
 tuner_setup_t dtv_get_delivery_tuner_setup( dtv_delivery_t d );
 
@@ -448,35 +460,40 @@ static int Open (vlc_object_t *obj)
 
     var_LocationParse (obj, access->psz_location, "dvb-");
 
-    dvb_device_t *dev = dvb_open (obj);
-    if (dev == NULL)
-    {
-        free (sys);
-        return VLC_EGENERIC;
-    }
-
-    sys->dev = dev;
+    sys->dev = NULL;
+    sys->sub = NULL;
     sys->signal_poll = 0;
     sys->pf_setup = NULL;
     access->p_sys = sys;
 
     uint64_t freq = var_InheritFrequency (obj);
-    if (freq != 0)
+#ifdef HAVE_LINUX_DVB
+    if (var_InheritBool (obj, "dvb-shared"))
     {
-        dtv_delivery_t d = GuessSystem (access->psz_name, dev);
-        if(d != DTV_DELIVERY_NONE)
-            sys->pf_setup = dtv_get_delivery_tuner_setup(d);
-
-        if (sys->pf_setup == NULL || Tune (obj, dev, sys->pf_setup, freq))
+        sys->sub = dtv_share_Join (obj, freq, TuneAccess);
+        if (sys->sub == NULL)
         {
-            msg_Err (obj, "tuning to %"PRIu64" Hz failed", freq);
-            vlc_dialog_display_error (obj, N_("Digital broadcasting"),
-                N_("The selected digital tuner does not support "
-                   "the specified parameters.\n"
-                   "Please check the preferences."));
-            goto error;
+            free (sys);
+            return VLC_EGENERIC;
         }
+
+        access->pf_block = ReadShared;
+        access->pf_control = ControlShared;
+        return VLC_SUCCESS;
     }
+#endif
+
+    dvb_device_t *dev = dvb_open (obj);
+    if (dev == NULL)
+    {
+        free (sys);
+        return VLC_EGENERIC;
+    }
+
+    sys->dev = dev;
+
+    if (freq != 0 && TuneAccess (obj, dev, freq))
+        goto error;
     dvb_add_pid (dev, 0);
 
     access->pf_block = Read;
@@ -494,10 +511,37 @@ static void Close (vlc_object_t *obj)
     stream_t *access = (stream_t *)obj;
     access_sys_t *sys = access->p_sys;
 
-    dvb_close (sys->dev);
+#ifdef HAVE_LINUX_DVB
+    if (sys->sub != NULL)
+        dtv_share_Leave (sys->sub);
+    else
+#endif
+        dvb_close (sys->dev);
     free (sys);
 }
 
+/** Selects the delivery system and tunes the device of the access */
+static int TuneAccess (vlc_object_t *obj, dvb_device_t *dev, uint64_t freq)
+{
+    stream_t *access = (stream_t *)obj;
+    access_sys_t *sys = access->p_sys;
+
+    dtv_delivery_t d = GuessSystem (access->psz_name, dev);
+    if (d != DTV_DELIVERY_NONE)
+        sys->pf_setup = dtv_get_delivery_tuner_setup (d);
+
+    if (sys->pf_setup == NULL || Tune (obj, dev, sys->pf_setup, freq))
+    {
+        msg_Err (obj, "tuning to %"PRIu64" Hz failed", freq);
+        vlc_dialog_display_error (obj, N_("Digital broadcasting"),
+            N_("The selected digital tuner does not support "
+               "the specified parameters.\n"
+               "Please check the preferences."));
+        return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
 static block_t *Read (stream_t *access, bool *restrict eof)
 {
 #define BUFSIZE (20*188)
@@ -598,6 +642,65 @@ static int Control (stream_t *access, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+#ifdef HAVE_LINUX_DVB
+static block_t *ReadShared (stream_t *access, bool *restrict eof)
+{
+    access_sys_t *sys = access->p_sys;
+
+    return dtv_share_Read (sys->sub, eof);
+}
+
+static int ControlShared (stream_t *access, int query, va_list args)
+{
+    access_sys_t *sys = access->p_sys;
+    dtv_subscriber_t *sub = sys->sub;
+
+    switch (query)
+    {
+        case STREAM_GET_SIGNAL:
+        {
+            if ((sys->signal_poll++))
+                return VLC_EGENERIC;
+
+            double *snr = va_arg (args, double *);
+            double *strength = va_arg (args, double *);
+            dtv_share_GetSignal (sub, snr, strength);
+            return VLC_SUCCESS;
+        }
+
+        case STREAM_SET_PRIVATE_ID_STATE:
+        {
+            unsigned pid = va_arg (args, int);
+            bool add = va_arg (args, int);
+
+            if (unlikely(pid > 0x1FFF))
+                return VLC_EGENERIC;
+            return dtv_share_SetPID (sub, pid, add) ? VLC_EGENERIC
+                                                    : VLC_SUCCESS;
+        }
+
+        case STREAM_SET_PRIVATE_ID_CA:
+        {
+            en50221_capmt_info_t *pmt = va_arg(args, void *);
+
+            return dtv_share_SetCA (sub, pmt) ? VLC_SUCCESS : VLC_EGENERIC;
+        }
+
+        case STREAM_GET_PRIVATE_ID_STATE:
+        {
+            unsigned pid = va_arg (args, int);
+            bool *on = va_arg (args, bool *);
+
+            *on = likely(pid <= 0x1FFF) ? dtv_share_GetPID (sub, pid) : false;
+            return VLC_SUCCESS;
+        }
+
+        default:
+            /* The other queries do not involve the device */
+            return Control (access, query, args);
+    }
+}
+#endif
 
 /*** Generic tuning ***/
 /** Set parameters and tune the device */
@@ -78,6 +78,18 @@ bool dvb_set_ca_pmt (dvb_device_t *, en50221_capmt_info_t *);
 int dvb_set_inversion (dvb_device_t *, int);
 int dvb_tune (dvb_device_t *);
 
+/* Shared tuners */
+typedef struct dtv_subscriber dtv_subscriber_t;
+typedef int (*dtv_tune_cb) (vlc_object_t *, dvb_device_t *, uint64_t freq);
+
+dtv_subscriber_t *dtv_share_Join (vlc_object_t *, uint64_t freq, dtv_tune_cb);
+void dtv_share_Leave (dtv_subscriber_t *);
+block_t *dtv_share_Read (dtv_subscriber_t *, bool *restrict eof);
+int dtv_share_SetPID (dtv_subscriber_t *, uint16_t, bool);
+bool dtv_share_GetPID (dtv_subscriber_t *, uint16_t);
+bool dtv_share_SetCA (dtv_subscriber_t *, en50221_capmt_info_t *);
+void dtv_share_GetSignal (dtv_subscriber_t *, double *snr, double *strength);
+
 typedef struct
 {
     struct
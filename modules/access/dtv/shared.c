@@ -0,0 +1,473 @@
+/**
+ * @file shared.c
+ * @brief Digital TV tuner sharing
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_interrupt.h>
+#include <vlc_list.h>
+#include <vlc_queue.h>
+
+#include "dtv.h"
+
+/*
+ * A shared tuner is opened by the first access of a given adapter and
+ * device, and stays open until the last one leaves. A thread reads the
+ * transport stream and hands each subscriber the packets of the PIDs it
+ * selected. The hardware PID filter gets the union of the selections.
+ */
+
+#define TS_PACKET_SIZE 188
+#define BUFSIZE (20*TS_PACKET_SIZE)
+/* Packets pending for a subscriber that does not keep up are dropped */
+#define MAX_QUEUED (16 << 20)
+/* Longest time the reader holds the device */
+#define READ_TIMEOUT_MS 50
+
+typedef struct dtv_tuner
+{
+    struct vlc_list node;
+    vlc_object_t *obj;
+    unsigned id;
+    uint64_t freq;
+
+    vlc_mutex_t dev_lock;
+    dvb_device_t *dev;
+
+    vlc_thread_t thread;
+    vlc_interrupt_t *intr;
+
+    vlc_mutex_t lock;
+    struct vlc_list subscribers;
+    uint16_t users[0x2000]; /**< Subscribers of each PID */
+    bool dead;
+
+    size_t carry;
+    uint8_t buf[BUFSIZE + TS_PACKET_SIZE];
+} dtv_tuner_t;
+
+struct dtv_subscriber
+{
+    struct vlc_list node;
+    dtv_tuner_t *tuner;
+    vlc_object_t *obj;
+
+    vlc_queue_t queue;
+    size_t queued;
+    bool dead;
+    bool woken;
+    bool overflow;
+
+    uint8_t pids[0x2000 / 8];
+};
+
+static vlc_mutex_t tuners_lock = VLC_STATIC_MUTEX;
+static struct vlc_list tuners = VLC_LIST_INITIALIZER(&tuners);
+
+static bool HasPID(const dtv_subscriber_t *sub, uint16_t pid)
+{
+    return (sub->pids[pid >> 3] >> (pid & 7)) & 1;
+}
+
+static void Deliver(dtv_subscriber_t *sub, const uint8_t *buf, size_t len)
+{
+    block_t *block = NULL;
+    size_t count = 0;
+
+    for (size_t i = 0; i < len; i += TS_PACKET_SIZE)
+    {
+        uint16_t pid = GetWBE(&buf[i + 1]) & 0x1FFF;
+
+        if (buf[i] != 0x47 || !HasPID(sub, pid))
+            continue;
+
+        if (block == NULL)
+        {
+            block = block_Alloc(len - i);
+            if (unlikely(block == NULL))
+                return;
+        }
+        memcpy(&block->p_buffer[count], &buf[i], TS_PACKET_SIZE);
+        count += TS_PACKET_SIZE;
+    }
+
+    if (block == NULL)
+        return;
+    block->i_buffer = count;
+
+    vlc_queue_Lock(&sub->queue);
+    if (sub->queued + count <= MAX_QUEUED)
+    {
+        vlc_queue_EnqueueUnlocked(&sub->queue, block);
+        sub->queued += count;
+        block = NULL;
+        sub->overflow = false;
+    }
+    else if (!sub->overflow)
+    {
+        msg_Warn(sub->obj, "dropping packets: reader too slow");
+        sub->overflow = true;
+    }
+    vlc_queue_Unlock(&sub->queue);
+
+    if (block != NULL)
+        block_Release(block);
+}
+
+static void Kill(dtv_subscriber_t *sub)
+{
+    vlc_queue_Kill(&sub->queue, &sub->dead);
+}
+
+static void *Thread(void *data)
+{
+    dtv_tuner_t *tuner = data;
+
+    vlc_thread_set_name("vlc-dtv-tuner");
+    vlc_interrupt_set(tuner->intr);
+
+    for (;;)
+    {
+        vlc_mutex_lock(&tuner->dev_lock);
+        ssize_t val = dvb_read(tuner->dev, tuner->buf + tuner->carry,
+                               BUFSIZE, READ_TIMEOUT_MS);
+        vlc_mutex_unlock(&tuner->dev_lock);
+
+        if (val == 0)
+            break; /* end of stream */
+        if (val < 0)
+        {
+            if (vlc_killed())
+                break;
+            continue;
+        }
+
+        /* Resynchronize on packet boundaries */
+        size_t len = tuner->carry + val, offset = 0;
+        while (offset < len && tuner->buf[offset] != 0x47)
+            offset++;
+
+        size_t count = (len - offset) / TS_PACKET_SIZE * TS_PACKET_SIZE;
+
+        if (count > 0)
+        {
+            dtv_subscriber_t *sub;
+
+            vlc_mutex_lock(&tuner->lock);
+            vlc_list_foreach(sub, &tuner->subscribers, node)
+                Deliver(sub, tuner->buf + offset, count);
+            vlc_mutex_unlock(&tuner->lock);
+        }
+
+        tuner->carry = len - offset - count;
+        memmove(tuner->buf, tuner->buf + offset + count, tuner->carry);
+    }
+
+    /* Wake up the subscribers */
+    dtv_subscriber_t *sub;
+
+    vlc_mutex_lock(&tuner->lock);
+    tuner->dead = true;
+    vlc_list_foreach(sub, &tuner->subscribers, node)
+        Kill(sub);
+    vlc_mutex_unlock(&tuner->lock);
+    return NULL;
+}
+
+static dtv_tuner_t *TunerNew(vlc_object_t *obj, unsigned id, uint64_t freq,
+                             dtv_tune_cb tune)
+{
+    dtv_tuner_t *tuner = malloc(sizeof (*tuner));
+    if (unlikely(tuner == NULL))
+        return NULL;
+
+    tuner->intr = NULL;
+
+    /* The tuner outlives the access that opened it: it has its own object,
+     * with the device settings of the access. */
+    tuner->obj = vlc_object_create(vlc_object_instance(obj),
+                                   sizeof (*tuner->obj));
+    if (unlikely(tuner->obj == NULL))
+        goto error;
+
+    static const char *const ints[] = {
+        "dvb-adapter", "dvb-device", "dvb-satno", "dvb-uncommitted", "dvb-tone",
+    };
+    static const char *const bools[] = {
+        "dvb-budget-mode", "dvb-high-voltage",
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(ints); i++)
+    {
+        var_Create(tuner->obj, ints[i], VLC_VAR_INTEGER);
+        var_SetInteger(tuner->obj, ints[i], var_InheritInteger(obj, ints[i]));
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(bools); i++)
+    {
+        var_Create(tuner->obj, bools[i], VLC_VAR_BOOL);
+        var_SetBool(tuner->obj, bools[i], var_InheritBool(obj, bools[i]));
+    }
+
+    tuner->intr = vlc_interrupt_create();
+    if (unlikely(tuner->intr == NULL))
+        goto error;
+
+    tuner->dev = dvb_open(tuner->obj);
+    if (tuner->dev == NULL)
+        goto error;
+
+    /* The tuning parameters are those of the access */
+    if (freq != 0 && tune(obj, tuner->dev, freq))
+    {
+        dvb_close(tuner->dev);
+        goto error;
+    }
+
+    tuner->id = id;
+    tuner->freq = freq;
+    vlc_mutex_init(&tuner->dev_lock);
+    vlc_mutex_init(&tuner->lock);
+    vlc_list_init(&tuner->subscribers);
+    memset(tuner->users, 0, sizeof (tuner->users));
+    tuner->dead = false;
+    tuner->carry = 0;
+
+    if (vlc_clone(&tuner->thread, Thread, tuner))
+    {
+        dvb_close(tuner->dev);
+        goto error;
+    }
+    return tuner;
+
+error:
+    if (tuner->intr != NULL)
+        vlc_interrupt_destroy(tuner->intr);
+    if (tuner->obj != NULL)
+        vlc_object_delete(tuner->obj);
+    free(tuner);
+    return NULL;
+}
+
+static void TunerDelete(dtv_tuner_t *tuner)
+{
+    assert(vlc_list_is_empty(&tuner->subscribers));
+
+    vlc_interrupt_kill(tuner->intr);
+    vlc_join(tuner->thread, NULL);
+    vlc_interrupt_destroy(tuner->intr);
+    dvb_close(tuner->dev);
+    vlc_object_delete(tuner->obj);
+    free(tuner);
+}
+
+static int SetPIDLocked(dtv_subscriber_t *sub, uint16_t pid, bool on)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+    int ret = 0;
+
+    if (HasPID(sub, pid) == on)
+        return 0;
+
+    if (on)
+    {
+        if (tuner->users[pid] == 0)
+        {
+            vlc_mutex_lock(&tuner->dev_lock);
+            ret = dvb_add_pid(tuner->dev, pid);
+            vlc_mutex_unlock(&tuner->dev_lock);
+            if (ret)
+                return ret;
+        }
+        tuner->users[pid]++;
+        sub->pids[pid >> 3] |= 1 << (pid & 7);
+    }
+    else
+    {
+        sub->pids[pid >> 3] &= ~(1 << (pid & 7));
+        if (--tuner->users[pid] == 0)
+        {
+            vlc_mutex_lock(&tuner->dev_lock);
+            dvb_remove_pid(tuner->dev, pid);
+            vlc_mutex_unlock(&tuner->dev_lock);
+        }
+    }
+    return ret;
+}
+
+dtv_subscriber_t *dtv_share_Join(vlc_object_t *obj, uint64_t freq,
+                                 dtv_tune_cb tune)
+{
+    unsigned id = (var_InheritInteger(obj, "dvb-adapter") << 8)
+                | (var_InheritInteger(obj, "dvb-device") & 0xFF);
+    dtv_subscriber_t *sub = malloc(sizeof (*sub));
+    if (unlikely(sub == NULL))
+        return NULL;
+
+    sub->obj = obj;
+    vlc_queue_Init(&sub->queue, offsetof (block_t, p_next));
+    sub->queued = 0;
+    sub->dead = false;
+    sub->woken = false;
+    sub->overflow = false;
+    memset(sub->pids, 0, sizeof (sub->pids));
+
+    dtv_tuner_t *tuner = NULL, *t;
+
+    vlc_mutex_lock(&tuners_lock);
+    vlc_list_foreach(t, &tuners, node)
+        if (t->id == id)
+        {
+            tuner = t;
+            break;
+        }
+
+    if (tuner != NULL)
+    {
+        if (freq != 0 && freq != tuner->freq)
+        {
+            msg_Err(obj, "tuner busy at %"PRIu64" Hz", tuner->freq);
+            goto error;
+        }
+        msg_Dbg(obj, "sharing tuner at %"PRIu64" Hz", tuner->freq);
+    }
+    else
+    {
+        tuner = TunerNew(obj, id, freq, tune);
+        if (tuner == NULL)
+            goto error;
+        vlc_list_append(&tuner->node, &tuners);
+    }
+
+    sub->tuner = tuner;
+    vlc_mutex_lock(&tuner->lock);
+    vlc_list_append(&sub->node, &tuner->subscribers);
+    sub->dead = tuner->dead;
+    SetPIDLocked(sub, 0, true);
+    vlc_mutex_unlock(&tuner->lock);
+    vlc_mutex_unlock(&tuners_lock);
+    return sub;
+
+error:
+    vlc_mutex_unlock(&tuners_lock);
+    free(sub);
+    return NULL;
+}
+
+void dtv_share_Leave(dtv_subscriber_t *sub)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+    bool last;
+
+    vlc_mutex_lock(&tuners_lock);
+    vlc_mutex_lock(&tuner->lock);
+    for (unsigned pid = 0; pid < 0x2000; pid++)
+        SetPIDLocked(sub, pid, false);
+    vlc_list_remove(&sub->node);
+    last = vlc_list_is_empty(&tuner->subscribers);
+    vlc_mutex_unlock(&tuner->lock);
+    if (last)
+        vlc_list_remove(&tuner->node);
+    vlc_mutex_unlock(&tuners_lock);
+
+    if (last)
+        TunerDelete(tuner);
+
+    block_ChainRelease(vlc_queue_DequeueAll(&sub->queue));
+    free(sub);
+}
+
+static void Wake(void *data)
+{
+    dtv_subscriber_t *sub = data;
+
+    vlc_queue_Lock(&sub->queue);
+    sub->woken = true;
+    vlc_queue_Signal(&sub->queue);
+    vlc_queue_Unlock(&sub->queue);
+}
+
+block_t *dtv_share_Read(dtv_subscriber_t *sub, bool *restrict eof)
+{
+    block_t *block;
+
+    vlc_interrupt_register(Wake, sub);
+    vlc_queue_Lock(&sub->queue);
+    while (vlc_queue_IsEmpty(&sub->queue) && !sub->dead && !sub->woken)
+        vlc_queue_Wait(&sub->queue);
+
+    block = vlc_queue_DequeueUnlocked(&sub->queue);
+    if (block != NULL)
+        sub->queued -= block->i_buffer;
+    else if (sub->dead)
+        *eof = true;
+    sub->woken = false;
+    vlc_queue_Unlock(&sub->queue);
+    vlc_interrupt_unregister();
+    return block;
+}
+
+int dtv_share_SetPID(dtv_subscriber_t *sub, uint16_t pid, bool on)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+
+    vlc_mutex_lock(&tuner->lock);
+    int ret = SetPIDLocked(sub, pid, on);
+    vlc_mutex_unlock(&tuner->lock);
+    return ret;
+}
+
+bool dtv_share_GetPID(dtv_subscriber_t *sub, uint16_t pid)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+
+    vlc_mutex_lock(&tuner->lock);
+    bool on = HasPID(sub, pid);
+    vlc_mutex_unlock(&tuner->lock);
+    return on;
+}
+
+bool dtv_share_SetCA(dtv_subscriber_t *sub, en50221_capmt_info_t *pmt)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+
+    /* The CAM serves the programs of all the subscribers */
+    vlc_mutex_lock(&tuner->dev_lock);
+    bool ok = dvb_set_ca_pmt(tuner->dev, pmt);
+    vlc_mutex_unlock(&tuner->dev_lock);
+    return ok;
+}
+
+void dtv_share_GetSignal(dtv_subscriber_t *sub, double *snr, double *strength)
+{
+    dtv_tuner_t *tuner = sub->tuner;
+
+    vlc_mutex_lock(&tuner->dev_lock);
+    *snr = dvb_get_snr(tuner->dev);
+    *strength = dvb_get_signal_strength(tuner->dev);
+    vlc_mutex_unlock(&tuner->dev_lock);
+}
@@ -60,12 +60,22 @@
 #include <vlc_fs.h>
 #include <vlc_url.h>
 #include <vlc_interrupt.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
+/* Size of the memory-mapped windows in block mode */
+#define FILE_MMAP_WINDOW (4 << 20)
 
 typedef struct
 {
     int fd;
 
     bool b_pace_control;
+
+    /* Memory-mapped block mode */
+    uint64_t offset;
+    uint64_t size;
 } access_sys_t;
 
 #if !defined (_WIN32) && !defined (__OS2__)
@@ -167,6 +177,10 @@ static bool IsRemote (const char *path)
 
 static ssize_t Read (stream_t *, void *, size_t);
 static int FileSeek (stream_t *, uint64_t);
+#ifdef HAVE_MMAP
+static block_t *MmapBlock (stream_t *, bool *);
+static int MmapSeek (stream_t *, uint64_t);
+#endif
 static int FileControl (stream_t *, int, va_list);
 
 /*****************************************************************************
@@ -270,6 +284,20 @@ int FileOpen( vlc_object_t *p_this )
             fcntl (fd, F_RDAHEAD, 0);
         else
             fcntl (fd, F_RDAHEAD, 1);
+#endif
+#ifdef HAVE_MMAP
+        /* Mapped files from network file systems are too likely to fault */
+        if (S_ISREG (st.st_mode)
+         && var_InheritBool (p_access, "file-mmap")
+         && !IsRemote(fd, p_access->psz_filepath))
+        {
+            msg_Dbg (p_access, "using memory-mapped windows");
+            p_access->pf_read = NULL;
+            p_access->pf_block = MmapBlock;
+            p_access->pf_seek = MmapSeek;
+            p_sys->offset = 0;
+            p_sys->size = st.st_size;
+        }
 #endif
     }
     else
@@ -292,7 +320,7 @@ void FileClose (vlc_object_t * p_this)
 {
     stream_t     *p_access = (stream_t*)p_this;
 
-    if (p_access->pf_read == NULL)
+    if (p_access->pf_readdir != NULL)
     {
         DirClose (p_this);
         return;
@@ -326,6 +354,92 @@ static ssize_t Read (stream_t *p_access, void *p_buffer, size_t i_len)
     return val;
 }
 
+#ifdef HAVE_MMAP
+/*****************************************************************************
+ * MmapRead: read the next data, where the file cannot be mapped
+ *****************************************************************************/
+static block_t *MmapRead (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+    size_t length = __MIN(p_sys->size - p_sys->offset, 65536);
+
+    block_t *block = block_Alloc (length);
+    if (unlikely(block == NULL))
+        return NULL;
+
+    ssize_t val = pread (p_sys->fd, block->p_buffer, length, p_sys->offset);
+    if (val <= 0)
+    {
+        if (val < 0)
+            msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+        block_Release (block);
+        *eof = true;
+        return NULL;
+    }
+
+    block->i_buffer = val;
+    p_sys->offset += val;
+    return block;
+}
+
+/*****************************************************************************
+ * MmapBlock: map the next window of the file
+ *****************************************************************************/
+static block_t *MmapBlock (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    if (p_sys->offset >= p_sys->size)
+    {   /* The file may have grown */
+        struct stat st;
+
+        if (fstat (p_sys->fd, &st) == 0)
+            p_sys->size = st.st_size;
+        if (p_sys->offset >= p_sys->size)
+        {
+            *eof = true;
+            return NULL;
+        }
+    }
+
+    const uint64_t page_mask = sysconf (_SC_PAGESIZE) - 1;
+    uint64_t start = p_sys->offset & ~page_mask;
+    size_t skip = p_sys->offset - start;
+    size_t length = __MIN(p_sys->size - start, FILE_MMAP_WINDOW);
+
+    void *addr = mmap (NULL, length, PROT_READ, MAP_SHARED, p_sys->fd, start);
+    if (addr == MAP_FAILED)
+    {
+        msg_Err (p_access, "cannot map file: %s", vlc_strerror_c(errno));
+        return MmapRead (p_access, eof);
+    }
+
+    posix_madvise (addr, length, POSIX_MADV_SEQUENTIAL);
+    posix_madvise (addr, length, POSIX_MADV_WILLNEED);
+    /* Read the next window ahead */
+    posix_fadvise (p_sys->fd, start + length, FILE_MMAP_WINDOW,
+                   POSIX_FADV_WILLNEED);
+
+    /* The whole mapping is handed over, and unmapped on error */
+    block_t *block = block_mmap_Alloc (addr, length);
+    if (unlikely(block == NULL))
+        return NULL;
+
+    block->p_buffer += skip;
+    block->i_buffer -= skip;
+    p_sys->offset += block->i_buffer;
+    return block;
+}
+
+static int MmapSeek (stream_t *p_access, uint64_t i_pos)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    p_sys->offset = i_pos;
+    return VLC_SUCCESS;
+}
+#endif
+
 /*****************************************************************************
  * Seek: seek to a specific location in a file
  *****************************************************************************/
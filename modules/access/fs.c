@@ -37,6 +37,11 @@ vlc_module_begin ()
     set_capability( "access", 50 )
     add_shortcut( "file", "fd", "stream" )
     set_callbacks( FileOpen, FileClose )
+    add_bool( "file-mmap", false, N_("Memory-mapped file input"),
+              N_("Map local regular files in memory and pass mapped windows "
+                 "to the demuxer instead of copying the data. This avoids "
+                 "copying the whole file, but the input may crash if the "
+                 "file is truncated while playing.") )
 
     add_submodule()
     set_section( N_("Directory" ), NULL )
@@ -148,6 +148,7 @@ struct access_sys_t
 
     char       sz_epsv_ip[NI_MAXNUMERICHOST];
     bool       out;
+    bool       binary; /* TYPE I was accepted */
     uint64_t   offset;
     uint64_t   size;
 };
@@ -872,10 +873,36 @@ static int SeekCommon( vlc_object_t *p_access, access_sys_t *p_sys,
     return VLC_SUCCESS;
 }
 
+/* Restarting the transfer costs several round trips (ABOR, PASV, REST,
+ * RETR) and a new TCP or TLS handshake: short forward seeks read through the
+ * open data connection instead. */
+#define FTP_SKIP_MAX (1 << 20)
+
+static int Skip( stream_t *p_access, uint64_t i_pos )
+{
+    access_sys_t *p_sys = p_access->p_sys;
+    char buf[16384];
+
+    while( p_sys->offset < i_pos )
+    {
+        size_t i_len = __MIN( i_pos - p_sys->offset, sizeof (buf) );
+        ssize_t i_read = vlc_tls_Read( p_sys->data, buf, i_len, true );
+        if( i_read <= 0 )
+            return VLC_EGENERIC;
+        p_sys->offset += i_read;
+    }
+    return VLC_SUCCESS;
+}
+
 static int Seek( stream_t *p_access, uint64_t i_pos )
 {
     access_sys_t *p_sys = p_access->p_sys;
 
+    if( p_sys->data != NULL && i_pos >= p_sys->offset
+     && i_pos - p_sys->offset <= FTP_SKIP_MAX
+     && Skip( p_access, i_pos ) == VLC_SUCCESS )
+        return VLC_SUCCESS;
+
     int val = SeekCommon( VLC_OBJECT(p_access), p_sys, i_pos );
     if( val )
         return val;
@@ -1142,7 +1169,7 @@ static int Control( stream_t *p_access, int i_query, va_list args )
         case STREAM_SET_PAUSE_STATE:
             pb_bool = va_arg( args, bool * );
             if ( !pb_bool )
-                 return Seek( p_access, sys->offset );
+                 return SeekCommon( VLC_OBJECT(p_access), sys, sys->offset );
             break;
 
         default:
@@ -1207,11 +1234,16 @@ static int ftp_StartStream( vlc_object_t *p_access, access_sys_t *p_sys,
 
     msg_Dbg( p_access, "ip:%s port:%d", psz_ip, i_port );
 
-    if( ftp_SendCommand( p_access, p_sys, "TYPE I" ) < 0 ||
-        ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) != 2 )
+    /* The transfer type persists on the control connection */
+    if( !p_sys->binary )
     {
-        msg_Err( p_access, "cannot set binary transfer mode" );
-        return VLC_EGENERIC;
+        if( ftp_SendCommand( p_access, p_sys, "TYPE I" ) < 0 ||
+            ftp_RecvCommand( p_access, p_sys, &i_answer, NULL ) != 2 )
+        {
+            msg_Err( p_access, "cannot set binary transfer mode" );
+            return VLC_EGENERIC;
+        }
+        p_sys->binary = true;
     }
 
     if( i_start > 0 )
@@ -40,20 +40,66 @@
 #include "resource.h"
 #include "file.h"
 #include "live.h"
+#include "parallel.h"
+
+/* Size of the ranges fetched by each connection in parallel mode */
+#define HTTP_CHUNK_SIZE (4 << 20)
 
 typedef struct
 {
     struct vlc_http_mgr *manager;
     struct vlc_http_resource *resource;
+    struct vlc_http_resource **files; /**< parallel connections */
+    unsigned file_count;
+    struct vlc_http_parallel *parallel;
+    uintmax_t size;
+    uintmax_t offset;
+    uintmax_t streak; /**< bytes read sequentially since the last seek */
 } access_sys_t;
 
 static block_t *FileRead(stream_t *access, bool *restrict eof)
 {
     access_sys_t *sys = access->p_sys;
+    block_t *b;
+
+    /* Only go parallel once the file is read sequentially: seeking around
+     * headers and indexes is better served by a single connection. */
+    if (sys->parallel == NULL && sys->file_count > 0
+     && sys->streak >= HTTP_CHUNK_SIZE && sys->offset < sys->size)
+    {
+        sys->parallel = vlc_http_parallel_create(sys->files, sys->file_count,
+                                                 sys->offset, sys->size,
+                                                 HTTP_CHUNK_SIZE);
+        if (sys->parallel != NULL)
+            msg_Dbg(access, "reading over %u connections from offset %ju",
+                    sys->file_count, sys->offset);
+    }
+
+    if (sys->parallel != NULL)
+    {
+        b = vlc_http_parallel_read(sys->parallel);
+        if (b == NULL)
+        {   /* Carry on over a single connection after a failure */
+            vlc_http_parallel_destroy(sys->parallel);
+            sys->parallel = NULL;
+            sys->streak = 0;
+
+            if (sys->offset < sys->size
+             && vlc_http_file_seek(sys->resource, sys->offset) == 0)
+                b = vlc_http_file_read(sys->resource);
+        }
+    }
+    else
+        b = vlc_http_file_read(sys->resource);
 
-    block_t *b = vlc_http_file_read(sys->resource);
     if (b == NULL)
+    {
         *eof = true;
+        return NULL;
+    }
+
+    sys->offset += b->i_buffer;
+    sys->streak += b->i_buffer;
     return b;
 }
 
@@ -61,11 +107,78 @@ static int FileSeek(stream_t *access, uint64_t pos)
 {
     access_sys_t *sys = access->p_sys;
 
+    if (sys->parallel != NULL)
+    {
+        vlc_http_parallel_destroy(sys->parallel);
+        sys->parallel = NULL;
+    }
+
     if (vlc_http_file_seek(sys->resource, pos))
         return VLC_EGENERIC;
+
+    sys->offset = pos;
+    sys->streak = 0;
     return VLC_SUCCESS;
 }
 
+/**
+ * Prepares additional connections for parallel reading.
+ *
+ * This is only worth it for seekable files of known size spanning several
+ * chunks.
+ */
+static void FileOpenParallel(stream_t *access,
+                             const struct vlc_credential *crd)
+{
+    access_sys_t *sys = access->p_sys;
+    unsigned count = var_InheritInteger(access, "http-connections");
+
+    sys->size = vlc_http_file_get_size(sys->resource);
+
+    if (count < 2 || !vlc_http_file_can_seek(sys->resource)
+     || sys->size == (uintmax_t)-1 || sys->size <= 2 * HTTP_CHUNK_SIZE)
+        return;
+
+    sys->files = vlc_alloc(count, sizeof (*sys->files));
+    if (unlikely(sys->files == NULL))
+        return;
+
+    char *ua = var_InheritString(access, "http-user-agent");
+    char *referer = var_InheritString(access, "http-referrer");
+
+    while (sys->file_count < count)
+    {
+        struct vlc_http_resource *file =
+            vlc_http_file_create(sys->manager, access->psz_url, ua, referer);
+        if (unlikely(file == NULL))
+            break;
+
+        if (crd->psz_username != NULL)
+            vlc_http_res_set_login(file, crd->psz_username,
+                                   crd->psz_password);
+        sys->files[sys->file_count++] = file;
+    }
+    free(referer);
+    free(ua);
+
+    if (sys->file_count < 2)
+    {
+        while (sys->file_count > 0)
+            vlc_http_file_destroy(sys->files[--sys->file_count]);
+        free(sys->files);
+        sys->files = NULL;
+    }
+}
+
+static void FileCloseParallel(access_sys_t *sys)
+{
+    if (sys->parallel != NULL)
+        vlc_http_parallel_destroy(sys->parallel);
+    for (unsigned i = 0; i < sys->file_count; i++)
+        vlc_http_file_destroy(sys->files[i]);
+    free(sys->files);
+}
+
 static int FileControl(stream_t *access, int query, va_list args)
 {
     access_sys_t *sys = access->p_sys;
@@ -107,6 +220,15 @@ static int FileControl(stream_t *access, int query, va_list args)
         case STREAM_SET_PAUSE_STATE:
             break;
 
+        case STREAM_SET_READ_HINT:
+        {
+            uint64_t offset = va_arg(args, uint64_t);
+            uint64_t length = va_arg(args, uint64_t);
+
+            vlc_http_file_set_hint(sys->resource, offset, length);
+            break;
+        }
+
         default:
             return VLC_EGENERIC;
     }
@@ -162,6 +284,12 @@ static int Open(vlc_object_t *obj)
 
     sys->manager = NULL;
     sys->resource = NULL;
+    sys->files = NULL;
+    sys->file_count = 0;
+    sys->parallel = NULL;
+    sys->size = -1;
+    sys->offset = 0;
+    sys->streak = 0;
 
     void *jar = NULL;
     if (var_InheritBool(obj, "http-forward-cookies"))
@@ -240,6 +368,10 @@ static int Open(vlc_object_t *obj)
         goto error;
     }
 
+    access->p_sys = sys;
+    if (!live)
+        FileOpenParallel(access, &crd);
+
     vlc_credential_store(&crd, obj);
     free(psz_realm);
     vlc_credential_clean(&crd);
@@ -258,7 +390,6 @@ static int Open(vlc_object_t *obj)
         access->pf_seek = FileSeek;
         access->pf_control = FileControl;
     }
-    access->p_sys = sys;
     return VLC_SUCCESS;
 
 error:
@@ -278,6 +409,7 @@ static void Close(vlc_object_t *obj)
     stream_t *access = (stream_t *)obj;
     access_sys_t *sys = access->p_sys;
 
+    FileCloseParallel(sys);
     vlc_http_res_destroy(sys->resource);
     vlc_http_mgr_destroy(sys->manager);
     free(sys);
@@ -294,6 +426,11 @@ vlc_module_begin()
     add_bool("http-continuous", false, N_("Continuous stream"),
              N_("Keep reading a resource that keeps being updated."))
         change_volatile()
+    add_integer_with_range("http-connections", 1, 1, 4,
+                           N_("Parallel connections"),
+                           N_("Read files over this many connections at once, "
+                              "each fetching a different range. This can "
+                              "speed up downloads over long fat networks."))
     add_bool("http-forward-cookies", true, N_("Cookies forwarding"),
              N_("Forward cookies across HTTP redirections."))
     add_string("http-referrer", NULL, N_("Referrer"),
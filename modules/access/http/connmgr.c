@@ -96,53 +96,170 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
+/* Maximum number of connections kept for reuse */
+#define VLC_HTTP_MGR_CONNS 4
+
+struct vlc_http_mgr_conn
+{
+    char *host;
+    unsigned port;
+    bool https;
+    unsigned users; /**< threads opening a stream, without the lock */
+    bool removed; /**< released by the manager while in use */
+    struct vlc_http_conn *conn;
+};
+
 struct vlc_http_mgr
 {
     struct vlc_logger *logger;
     vlc_object_t *obj;
     vlc_tls_client_t *creds;
     struct vlc_http_cookie_jar_t *jar;
-    struct vlc_http_conn *conn;
+    vlc_mutex_t lock;
+    unsigned count;
+    struct vlc_http_mgr_conn *conns[VLC_HTTP_MGR_CONNS];
 };
 
-static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
-                                               const char *host, unsigned port)
+static void vlc_http_mgr_conn_delete(struct vlc_http_mgr_conn *c)
+{
+    vlc_http_conn_release(c->conn);
+    free(c->host);
+    free(c);
+}
+
+static void vlc_http_mgr_remove(struct vlc_http_mgr *mgr, unsigned i)
 {
-    (void) host; (void) port;
-    return mgr->conn;
+    struct vlc_http_mgr_conn *c = mgr->conns[i];
+
+    mgr->count--;
+    memmove(mgr->conns + i, mgr->conns + i + 1,
+            (mgr->count - i) * sizeof (mgr->conns[0]));
+
+    /* The last thread opening a stream on it will delete it */
+    if (c->users > 0)
+        c->removed = true;
+    else
+        vlc_http_mgr_conn_delete(c);
 }
 
 static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
                                  struct vlc_http_conn *conn)
 {
-    assert(mgr->conn == conn);
-    mgr->conn = NULL;
+    vlc_mutex_lock(&mgr->lock);
+    /* Another thread may have released it already */
+    for (unsigned i = 0; i < mgr->count; i++)
+        if (mgr->conns[i]->conn == conn)
+        {
+            vlc_http_mgr_remove(mgr, i);
+            break;
+        }
+    vlc_mutex_unlock(&mgr->lock);
+}
 
-    vlc_http_conn_release(conn);
+/**
+ * Opens a stream on a connection to the given origin, if any.
+ *
+ * The candidate connections are picked with the manager lock held, and kept
+ * from being deleted while the stream is opened without the lock, so that a
+ * blocking request write does not serialize the other requests.
+ */
+static struct vlc_http_stream *vlc_http_mgr_open(struct vlc_http_mgr *mgr,
+                                                 bool https, const char *host,
+                                                 unsigned port,
+                                                 const struct vlc_http_msg *req,
+                                                 bool payload,
+                                                 struct vlc_http_conn **connp)
+{
+    struct vlc_http_mgr_conn *cands[VLC_HTTP_MGR_CONNS];
+    struct vlc_http_stream *stream = NULL;
+    unsigned n = 0;
+
+    vlc_mutex_lock(&mgr->lock);
+    /* Most recent connections first: older ones are more likely closed */
+    for (unsigned i = mgr->count; i-- > 0;)
+    {
+        struct vlc_http_mgr_conn *c = mgr->conns[i];
+
+        if (c->https != https || c->port != port || strcasecmp(c->host, host))
+            continue;
+
+        c->users++;
+        cands[n++] = c;
+    }
+    vlc_mutex_unlock(&mgr->lock);
+
+    for (unsigned i = 0; i < n && stream == NULL; i++)
+    {
+        /* Fails if the HTTP/1 connection is busy with another stream */
+        stream = vlc_http_stream_open(cands[i]->conn, req, payload);
+        if (stream != NULL)
+            *connp = cands[i]->conn;
+    }
+
+    vlc_mutex_lock(&mgr->lock);
+    for (unsigned i = 0; i < n; i++)
+        /* The stream, if any, keeps the released connection alive */
+        if (--cands[i]->users == 0 && cands[i]->removed)
+            vlc_http_mgr_conn_delete(cands[i]);
+    vlc_mutex_unlock(&mgr->lock);
+    return stream;
 }
 
 static
-struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
+struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr, bool https,
                                         const char *host, unsigned port,
                                         const struct vlc_http_msg *req,
                                         bool payload)
 {
-    struct vlc_http_conn *conn = vlc_http_mgr_find(mgr, host, port);
-    if (conn == NULL)
+    struct vlc_http_conn *conn;
+
+    struct vlc_http_stream *stream = vlc_http_mgr_open(mgr, https, host, port,
+                                                       req, payload, &conn);
+
+    if (stream == NULL)
         return NULL;
 
-    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
-    if (stream != NULL)
-    {
-        struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
-        if (m != NULL)
-            return m;
-    }
+    struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+    if (m != NULL)
+        return m;
+
     /* Get rid of closing or reset connection */
     vlc_http_mgr_release(mgr, conn);
     return NULL;
 }
 
+/**
+ * Keeps a new connection for reuse.
+ *
+ * Must be called with the manager lock held.
+ */
+static bool vlc_http_mgr_insert(struct vlc_http_mgr *mgr, bool https,
+                                const char *host, unsigned port,
+                                struct vlc_http_conn *conn)
+{
+    struct vlc_http_mgr_conn *c = malloc(sizeof (*c));
+    if (unlikely(c == NULL))
+        return false;
+
+    c->host = strdup(host);
+    if (unlikely(c->host == NULL))
+    {
+        free(c);
+        return false;
+    }
+    c->port = port;
+    c->https = https;
+    c->users = 0;
+    c->removed = false;
+    c->conn = conn;
+
+    if (mgr->count == VLC_HTTP_MGR_CONNS)
+        vlc_http_mgr_remove(mgr, 0);
+
+    mgr->conns[mgr->count++] = c;
+    return true;
+}
+
 static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
                                               const char *host, unsigned port,
                                               const struct vlc_http_msg *req,
@@ -151,15 +268,17 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
     vlc_tls_t *tls;
     bool http2 = true;
 
-    if (mgr->creds == NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTP to HTTPS not implemented */
-
+    vlc_mutex_lock(&mgr->lock);
     if (mgr->creds == NULL)
     {   /* First TLS connection: load x509 credentials */
         mgr->creds = vlc_tls_ClientCreate(mgr->obj);
         if (mgr->creds == NULL)
+        {
+            vlc_mutex_unlock(&mgr->lock);
             return NULL;
+        }
     }
+    vlc_mutex_unlock(&mgr->lock);
 
     if (idempotent)
     {   /* If the request is idempotent, try to reuse an existing connection.
@@ -167,8 +286,8 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
          * the nonidempotent request was processed if the connection fails
          * before the response is received.
          */
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, true, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp; /* existing connection reused */
     }
@@ -206,11 +325,24 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    /* No other thread knows the new connection yet */
+    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
+    if (stream == NULL)
+    {
+        vlc_http_conn_release(conn);
+        return NULL;
+    }
+
+    vlc_mutex_lock(&mgr->lock);
+    bool kept = vlc_http_mgr_insert(mgr, true, host, port, conn);
+    vlc_mutex_unlock(&mgr->lock);
+    if (!kept)
+        vlc_http_conn_release(conn); /* not kept for reuse */
 
-    mgr->conn = conn;
-    return vlc_http_mgr_reuse(mgr, host, port, req, payload);
+    struct vlc_http_msg *resp = vlc_http_msg_get_initial(stream);
+    if (resp == NULL && kept)
+        vlc_http_mgr_release(mgr, conn);
+    return resp;
 }
 
 static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
@@ -218,13 +350,10 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
                                              const struct vlc_http_msg *req,
                                              bool idempotent, bool payload)
 {
-    if (mgr->creds != NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTPS to HTTP not implemented */
-
     if (idempotent)
     {
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, false, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp;
     }
@@ -263,10 +392,10 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    vlc_mutex_lock(&mgr->lock);
+    if (!vlc_http_mgr_insert(mgr, false, host, port, conn))
+        vlc_http_conn_release(conn); /* not kept for reuse */
+    vlc_mutex_unlock(&mgr->lock);
     return resp;
 }
 
@@ -298,14 +427,15 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     mgr->obj = obj;
     mgr->creds = NULL;
     mgr->jar = jar;
-    mgr->conn = NULL;
+    vlc_mutex_init(&mgr->lock);
+    mgr->count = 0;
     return mgr;
 }
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    while (mgr->count > 0)
+        vlc_http_mgr_remove(mgr, mgr->count - 1);
     if (mgr->creds != NULL)
         vlc_tls_ClientDelete(mgr->creds);
     free(mgr);
@@ -43,8 +43,28 @@ struct vlc_http_file
 {
     struct vlc_http_resource resource;
     uintmax_t offset;
+    uintmax_t hint_offset;
+    uintmax_t hint_end;
 };
 
+static bool vlc_http_msg_has_total_size(const struct vlc_http_msg *resp)
+{
+    const char *range = vlc_http_msg_get_header(resp, "Content-Range");
+    uintmax_t total;
+
+    if (range == NULL)
+        return false;
+
+    switch (vlc_http_msg_get_status(resp))
+    {
+        case 206:
+            return sscanf(range, "bytes %*u-%*u/%" SCNuMAX, &total) == 1;
+        case 416:
+            return sscanf(range, "bytes */%" SCNuMAX, &total) == 1;
+    }
+    return false;
+}
+
 static int vlc_http_file_req(const struct vlc_http_resource *res,
                              struct vlc_http_msg *req, void *opaque)
 {
@@ -69,6 +89,19 @@ static int vlc_http_file_req(const struct vlc_http_resource *res,
         }
     }
 
+    /* Only ask for the hinted range if the file size is known, as it
+     * would otherwise be deduced from the end of the range. A hint set
+     * before the first request is taken as a range-only read. */
+    if (file->hint_offset <= *offset && *offset < file->hint_end
+     && (file->resource.response == NULL
+      || vlc_http_msg_has_total_size(file->resource.response)))
+    {
+        if (vlc_http_msg_add_header(req, "Range", "bytes=%" PRIuMAX "-%"
+                                    PRIuMAX, *offset, file->hint_end - 1))
+            return -1;
+        return 0;
+    }
+
     if (vlc_http_msg_add_header(req, "Range", "bytes=%" PRIuMAX "-", *offset)
      && *offset != 0)
         return -1;
@@ -126,6 +159,8 @@ struct vlc_http_resource *vlc_http_file_create(struct vlc_http_mgr *mgr,
     }
 
     file->offset = 0;
+    file->hint_offset = 0;
+    file->hint_end = 0;
     return &file->resource;
 }
 
@@ -247,8 +282,27 @@ block_t *vlc_http_file_read(struct vlc_http_resource *res)
     }
 
     if (block == NULL)
-        return NULL; /* End of stream */
+    {   /* End of a hinted range: go on with the rest of the file */
+        if (file->offset != file->hint_end || res->response == NULL
+         || file->offset >= vlc_http_msg_get_file_size(res->response)
+         || vlc_http_file_seek(res, file->offset))
+            return NULL; /* End of stream */
+
+        block = vlc_http_res_read(res);
+        if (block == NULL || block == vlc_http_error)
+            return NULL;
+    }
 
     file->offset += block->i_buffer;
     return block;
 }
+
+void vlc_http_file_set_hint(struct vlc_http_resource *res, uintmax_t offset,
+                            uintmax_t length)
+{
+    struct vlc_http_file *file = (struct vlc_http_file *)res;
+
+    file->hint_offset = offset;
+    file->hint_end = (length < UINTMAX_MAX - offset) ? offset + length
+                                                     : UINTMAX_MAX;
+}
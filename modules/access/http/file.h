@@ -79,6 +79,21 @@ int vlc_http_file_seek(struct vlc_http_resource *, uintmax_t offset);
  */
 block_t *vlc_http_file_read(struct vlc_http_resource *);
 
+/**
+ * Hints the byte range to be read next.
+ *
+ * Subsequent requests starting within the range ask for the range only,
+ * rather than for the rest of the file.
+ * The following data is requested when the end of the range is read.
+ * If set before the first request, only the range is requested even though
+ * the file size is not known yet.
+ *
+ * @param offset start offset of the range
+ * @param length length of the range in bytes
+ */
+void vlc_http_file_set_hint(struct vlc_http_resource *, uintmax_t offset,
+                            uintmax_t length);
+
 #define vlc_http_file_get_status vlc_http_res_get_status
 #define vlc_http_file_get_redirect vlc_http_res_get_redirect
 #define vlc_http_file_get_type vlc_http_res_get_type
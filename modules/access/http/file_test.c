@@ -45,6 +45,7 @@ static const char ua[] = PACKAGE_NAME "/" PACKAGE_VERSION " (test suite)";
 
 static const char *replies[2] = { NULL, NULL };
 static uintmax_t offset = 0;
+static uintmax_t range_end = UINTMAX_MAX;
 static bool secure = true;
 static bool etags = false;
 static int lang = -1;
@@ -133,6 +134,25 @@ int main(void)
     assert(vlc_http_file_can_seek(f));
     assert(vlc_http_file_get_size(f) == 4567);
     assert(vlc_http_file_read(f) == NULL);
+
+    /* Hinted range */
+    replies[0] = "HTTP/1.1 206 Partial Content\r\n"
+                 "Content-Range: bytes 1234-2233/4567\r\n"
+                 "ETag: W/\"foobar42\"\r\n"
+                 "Last-Modified: Mon, 21 Oct 2013 20:13:22 GMT\r\n"
+                 "\r\n";
+    replies[1] = "HTTP/1.1 206 Partial Content\r\n"
+                 "Content-Range: bytes 2234-4566/4567\r\n"
+                 "ETag: W/\"foobar42\"\r\n"
+                 "Last-Modified: Mon, 21 Oct 2013 20:13:22 GMT\r\n"
+                 "\r\n";
+    vlc_http_file_set_hint(f, 1000, 1234);
+    range_end = 2233;
+    assert(vlc_http_file_seek(f, offset = 1234) == 0);
+    assert(vlc_http_file_get_size(f) == 4567);
+    range_end = UINTMAX_MAX;
+    assert(vlc_http_file_seek(f, offset = 2234) == 0);
+    assert(vlc_http_file_get_size(f) == 4567);
     vlc_http_file_destroy(f);
 
     /* Redirect */
@@ -378,6 +398,10 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
     str = vlc_http_msg_get_header(req, "Range");
     assert(str != NULL && !strncmp(str, "bytes=", 6)
         && strtoul(str + 6, &end, 10) == offset && *end == '-');
+    if (range_end != UINTMAX_MAX)
+        assert(strtoul(end + 1, &end, 10) == range_end && *end == '\0');
+    else
+        assert(end[1] == '\0');
 
     time_t mtime = vlc_http_msg_get_time(req, "If-Unmodified-Since");
     str = vlc_http_msg_get_header(req, "If-Match");
@@ -293,7 +293,13 @@ block_t *vlc_http_msg_read(struct vlc_http_msg *m)
     if (m->payload == NULL)
         return NULL;
 
-    return vlc_http_stream_read(m->payload);
+    block_t *block = vlc_http_stream_read(m->payload);
+    if (block == NULL)
+    {   /* Release the stream now, so that the connection can be reused */
+        vlc_http_stream_close(m->payload, false);
+        m->payload = NULL;
+    }
+    return block;
 }
 
 int vlc_http_msg_write(struct vlc_http_msg *m, block_t *block, bool eos)
@@ -290,6 +290,8 @@ struct vlc_http_msg *vlc_http_msg_get_final(struct vlc_http_msg *) VLC_USED;
  * Dequeues the next block of data from an HTTP message. If no pending data has
  * been received, waits until data is received, the stream ends or the
  * underlying connection fails.
+ * At the end of the stream, the stream is closed and the underlying
+ * connection can be reused for another message.
  *
  * @return data block
  * @retval NULL on end-of-stream
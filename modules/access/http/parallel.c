@@ -0,0 +1,324 @@
+/*****************************************************************************
+ * parallel.c: HTTP parallel range download
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_interrupt.h>
+#include "message.h"
+#include "resource.h"
+#include "file.h"
+#include "parallel.h"
+
+#pragma GCC visibility push(default)
+
+struct vlc_http_chunk
+{
+    block_t *head;
+    block_t **tailp;
+    size_t length;
+    size_t received;
+    bool failed;
+};
+
+struct vlc_http_worker
+{
+    struct vlc_http_parallel *owner;
+    struct vlc_http_resource *file;
+    vlc_interrupt_t *interrupt;
+    vlc_thread_t thread;
+};
+
+struct vlc_http_parallel
+{
+    vlc_mutex_t lock;
+    vlc_cond_t wait_data; /**< signaled to the reader */
+    vlc_cond_t wait_space; /**< signaled to the workers */
+    uintmax_t start;
+    uintmax_t size;
+    uintmax_t offset;
+    size_t chunk_size;
+    uintmax_t read_chunk; /**< index of the chunk being read */
+    uintmax_t next_chunk; /**< index of the next chunk to fetch */
+    bool stopped;
+    unsigned window;
+    struct vlc_http_chunk *chunks; /**< ring of window chunks */
+    unsigned count;
+    struct vlc_http_worker workers[];
+};
+
+static uintmax_t vlc_http_chunk_offset(const struct vlc_http_parallel *p,
+                                       uintmax_t index)
+{
+    return p->start + index * p->chunk_size;
+}
+
+/**
+ * Fetches one chunk.
+ *
+ * Requests the chunk range, and queues the received data for the reader
+ * as it arrives.
+ */
+static bool vlc_http_parallel_fetch(struct vlc_http_parallel *p,
+                                    struct vlc_http_resource *file,
+                                    struct vlc_http_chunk *c,
+                                    uintmax_t offset, size_t length)
+{
+    size_t received = 0;
+
+    vlc_http_file_set_hint(file, offset, length);
+
+    /* Anything but a partial response would not start at the offset. */
+    if (vlc_http_file_seek(file, offset)
+     || vlc_http_file_get_status(file) != 206)
+        return false;
+
+    while (received < length)
+    {
+        block_t *block = vlc_http_file_read(file);
+        if (block == NULL)
+            return false;
+
+        if (block->i_buffer > length - received)
+            block->i_buffer = length - received; /* range not honored */
+        received += block->i_buffer;
+
+        vlc_mutex_lock(&p->lock);
+        *(c->tailp) = block;
+        c->tailp = &block->p_next;
+        c->received = received;
+        vlc_cond_signal(&p->wait_data);
+        vlc_mutex_unlock(&p->lock);
+    }
+
+    /* Reach the end of the response, so that the connection is free for the
+     * next chunk. */
+    block_t *block = vlc_http_res_read(file);
+    if (block != NULL && block != vlc_http_error)
+        block_Release(block);
+    return true;
+}
+
+static void *vlc_http_parallel_thread(void *data)
+{
+    struct vlc_http_worker *w = data;
+    struct vlc_http_parallel *p = w->owner;
+
+    vlc_thread_set_name("vlc-http-range");
+    vlc_interrupt_set(w->interrupt);
+
+    vlc_mutex_lock(&p->lock);
+    for (;;)
+    {
+        uintmax_t offset = vlc_http_chunk_offset(p, p->next_chunk);
+
+        if (p->stopped || offset >= p->size)
+            break;
+
+        /* Do not get further ahead of the reader than the window. */
+        if (p->next_chunk - p->read_chunk >= p->window)
+        {
+            vlc_cond_wait(&p->wait_space, &p->lock);
+            continue;
+        }
+
+        struct vlc_http_chunk *c = &p->chunks[p->next_chunk % p->window];
+        size_t length = p->chunk_size;
+
+        if (length > p->size - offset)
+            length = p->size - offset;
+
+        c->head = NULL;
+        c->tailp = &c->head;
+        c->length = length;
+        c->received = 0;
+        c->failed = false;
+        p->next_chunk++;
+        vlc_mutex_unlock(&p->lock);
+
+        bool ok = vlc_http_parallel_fetch(p, w->file, c, offset, length);
+
+        vlc_mutex_lock(&p->lock);
+        if (!ok)
+        {
+            c->failed = true;
+            vlc_cond_signal(&p->wait_data);
+        }
+    }
+    vlc_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+static void vlc_http_parallel_stop(struct vlc_http_parallel *p,
+                                   unsigned count)
+{
+    vlc_mutex_lock(&p->lock);
+    p->stopped = true;
+    vlc_cond_broadcast(&p->wait_space);
+    vlc_mutex_unlock(&p->lock);
+
+    for (unsigned i = 0; i < count; i++)
+        vlc_interrupt_kill(p->workers[i].interrupt);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        vlc_join(p->workers[i].thread, NULL);
+        vlc_interrupt_destroy(p->workers[i].interrupt);
+    }
+}
+
+static void vlc_http_parallel_free(struct vlc_http_parallel *p)
+{
+    for (unsigned i = 0; i < p->window; i++)
+        block_ChainRelease(p->chunks[i].head);
+    free(p->chunks);
+    free(p);
+}
+
+struct vlc_http_parallel *
+vlc_http_parallel_create(struct vlc_http_resource *const *files,
+                         unsigned count, uintmax_t offset, uintmax_t size,
+                         size_t chunk_size)
+{
+    struct vlc_http_parallel *p = malloc(sizeof (*p)
+                                         + count * sizeof (p->workers[0]));
+    if (unlikely(p == NULL))
+        return NULL;
+
+    /* Twice as many chunks as workers, so that all workers keep fetching
+     * while the reader drains the oldest chunks. */
+    p->window = 2 * count;
+    p->chunks = calloc(p->window, sizeof (*p->chunks));
+    if (unlikely(p->chunks == NULL))
+    {
+        free(p);
+        return NULL;
+    }
+
+    vlc_mutex_init(&p->lock);
+    vlc_cond_init(&p->wait_data);
+    vlc_cond_init(&p->wait_space);
+    p->start = offset;
+    p->size = size;
+    p->offset = offset;
+    p->chunk_size = chunk_size;
+    p->read_chunk = 0;
+    p->next_chunk = 0;
+    p->stopped = false;
+    p->count = count;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        struct vlc_http_worker *w = &p->workers[i];
+
+        w->owner = p;
+        w->file = files[i];
+        w->interrupt = vlc_interrupt_create();
+
+        if (unlikely(w->interrupt == NULL))
+        {
+            vlc_http_parallel_stop(p, i);
+            vlc_http_parallel_free(p);
+            return NULL;
+        }
+
+        if (vlc_clone(&w->thread, vlc_http_parallel_thread, w))
+        {
+            vlc_interrupt_destroy(w->interrupt);
+            vlc_http_parallel_stop(p, i);
+            vlc_http_parallel_free(p);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+static void vlc_http_parallel_wake(void *data)
+{
+    struct vlc_http_parallel *p = data;
+
+    vlc_mutex_lock(&p->lock);
+    vlc_cond_signal(&p->wait_data);
+    vlc_mutex_unlock(&p->lock);
+}
+
+block_t *vlc_http_parallel_read(struct vlc_http_parallel *p)
+{
+    block_t *block = NULL;
+
+    vlc_interrupt_register(vlc_http_parallel_wake, p);
+    vlc_mutex_lock(&p->lock);
+
+    while (p->offset < p->size)
+    {
+        if (p->read_chunk < p->next_chunk)
+        {
+            struct vlc_http_chunk *c = &p->chunks[p->read_chunk % p->window];
+
+            if (c->head != NULL)
+            {
+                block = c->head;
+                c->head = block->p_next;
+                if (c->head == NULL)
+                    c->tailp = &c->head;
+                block->p_next = NULL;
+                p->offset += block->i_buffer;
+                break;
+            }
+
+            if (c->received == c->length)
+            {   /* Chunk fully read: make room for another one */
+                p->read_chunk++;
+                vlc_cond_signal(&p->wait_space);
+                continue;
+            }
+
+            if (c->failed)
+                break;
+        }
+
+        if (vlc_killed())
+            break;
+
+        vlc_cond_wait(&p->wait_data, &p->lock);
+    }
+
+    vlc_mutex_unlock(&p->lock);
+    vlc_interrupt_unregister();
+    return block;
+}
+
+uintmax_t vlc_http_parallel_tell(const struct vlc_http_parallel *p)
+{
+    return p->offset;
+}
+
+void vlc_http_parallel_destroy(struct vlc_http_parallel *p)
+{
+    vlc_http_parallel_stop(p, p->count);
+    vlc_http_parallel_free(p);
+}
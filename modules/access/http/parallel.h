@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * parallel.h: HTTP parallel range download declarations
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include <stdint.h>
+
+/**
+ * \defgroup http_parallel Parallel downloads
+ * Reading an HTTP file over several connections at once
+ * \ingroup http_file
+ * @{
+ */
+
+struct vlc_http_resource;
+struct vlc_http_parallel;
+
+/**
+ * Starts a parallel download.
+ *
+ * Splits the file into adjacent chunks from the given offset until the end,
+ * and fetches several chunks at once, one per HTTP file. The data is returned
+ * in order by vlc_http_parallel_read().
+ *
+ * The HTTP files must all refer to the same URL. They remain owned by the
+ * caller, and must not be used until vlc_http_parallel_destroy() is called.
+ *
+ * @param files table of HTTP files to read from, one per worker thread
+ * @param count number of HTTP files in the table
+ * @param offset start offset in bytes
+ * @param size total file size in bytes
+ * @param chunk_size size of each chunk in bytes
+ *
+ * @return a parallel download object, or NULL on error
+ */
+struct vlc_http_parallel *
+vlc_http_parallel_create(struct vlc_http_resource *const *files,
+                         unsigned count, uintmax_t offset, uintmax_t size,
+                         size_t chunk_size);
+
+/**
+ * Reads data.
+ *
+ * Returns the next data block in file order, waiting for it if needed.
+ * This function is interruptible.
+ *
+ * @return a data block, or NULL at the end of the file, on error or if
+ * interrupted
+ */
+block_t *vlc_http_parallel_read(struct vlc_http_parallel *);
+
+/**
+ * Gets the current offset.
+ *
+ * @return the file offset of the next data to be read
+ */
+uintmax_t vlc_http_parallel_tell(const struct vlc_http_parallel *);
+
+/**
+ * Stops a parallel download.
+ *
+ * Aborts pending requests and releases all resources, except the HTTP files.
+ */
+void vlc_http_parallel_destroy(struct vlc_http_parallel *);
+
+/** @} */
@@ -0,0 +1,184 @@
+/*****************************************************************************
+ * parallel_test.c: HTTP parallel range download test
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_tick.h>
+#include "message.h"
+#include "resource.h"
+#include "file.h"
+#include "parallel.h"
+
+const char vlc_module_name[] = "test_http_parallel";
+
+#define FILES 3
+
+struct test_file
+{
+    struct vlc_http_resource resource;
+    uintmax_t offset;
+    uintmax_t end;
+};
+
+static uintmax_t fail_offset = UINTMAX_MAX;
+static bool overrun = false;
+
+static unsigned char pattern(uintmax_t offset)
+{
+    return offset % 251;
+}
+
+static void test_read(uintmax_t size, uintmax_t offset, size_t chunk_size,
+                      uintmax_t stop)
+{
+    struct test_file files[FILES];
+    struct vlc_http_resource *tab[FILES];
+
+    for (unsigned i = 0; i < FILES; i++)
+    {
+        files[i].offset = 0;
+        files[i].end = 0;
+        tab[i] = &files[i].resource;
+    }
+
+    struct vlc_http_parallel *p = vlc_http_parallel_create(tab, FILES, offset,
+                                                           size, chunk_size);
+    assert(p != NULL);
+    assert(vlc_http_parallel_tell(p) == offset);
+
+    block_t *block;
+
+    while (vlc_http_parallel_tell(p) < stop
+        && (block = vlc_http_parallel_read(p)) != NULL)
+    {
+        assert(block->i_buffer > 0);
+        for (size_t i = 0; i < block->i_buffer; i++)
+            assert(block->p_buffer[i] == pattern(offset + i));
+        offset += block->i_buffer;
+        assert(vlc_http_parallel_tell(p) == offset);
+        block_Release(block);
+    }
+
+    if (stop >= size)
+    {
+        if (fail_offset < size)
+        {   /* Everything up to the failed chunk must have been read */
+            assert(offset <= fail_offset);
+            assert(fail_offset - offset < chunk_size);
+        }
+        else
+        {
+            assert(offset == size);
+            assert(vlc_http_parallel_read(p) == NULL);
+        }
+    }
+    vlc_http_parallel_destroy(p);
+}
+
+int main(void)
+{
+    /* Whole file */
+    test_read(3000000, 0, 100000, UINTMAX_MAX);
+    /* From an offset, with a trailing partial chunk */
+    test_read(1234567, 4321, 65536, UINTMAX_MAX);
+    /* Fewer chunks than connections */
+    test_read(100000, 0, 65536, UINTMAX_MAX);
+    /* Stopped half-way */
+    test_read(3000000, 0, 100000, 1000000);
+    /* Server ignoring the end of the ranges */
+    overrun = true;
+    test_read(1000000, 0, 65536, UINTMAX_MAX);
+    overrun = false;
+    /* Failed chunk */
+    fail_offset = 600000;
+    test_read(3000000, 0, 100000, UINTMAX_MAX);
+    return 0;
+}
+
+/* Callback hooks */
+
+static char error_loc;
+void *const vlc_http_error = &error_loc;
+
+void vlc_http_file_set_hint(struct vlc_http_resource *res, uintmax_t offset,
+                            uintmax_t length)
+{
+    struct test_file *f = container_of(res, struct test_file, resource);
+
+    f->end = offset + length;
+}
+
+int vlc_http_file_seek(struct vlc_http_resource *res, uintmax_t offset)
+{
+    struct test_file *f = container_of(res, struct test_file, resource);
+
+    assert(offset < f->end);
+    if (offset == fail_offset)
+        return -1;
+    f->offset = offset;
+    return 0;
+}
+
+int vlc_http_res_get_status(struct vlc_http_resource *res)
+{
+    (void) res;
+    return 206;
+}
+
+block_t *vlc_http_file_read(struct vlc_http_resource *res)
+{
+    struct test_file *f = container_of(res, struct test_file, resource);
+
+    if (f->offset >= f->end && !overrun)
+        return NULL;
+
+    /* Uneven block sizes and delays to mix up chunk completion order */
+    size_t len = 1 + (f->offset * 2654435761u >> 5) % 16384;
+    if (!overrun && len > f->end - f->offset)
+        len = f->end - f->offset;
+
+    if (f->offset % 3 == 0)
+        vlc_tick_wait(vlc_tick_now() + VLC_TICK_FROM_MS(1));
+
+    block_t *block = block_Alloc(len);
+    assert(block != NULL);
+    for (size_t i = 0; i < len; i++)
+        block->p_buffer[i] = pattern(f->offset + i);
+    f->offset += len;
+    return block;
+}
+
+block_t *vlc_http_res_read(struct vlc_http_resource *res)
+{
+    struct test_file *f = container_of(res, struct test_file, resource);
+
+    assert(f->offset >= f->end);
+    return NULL;
+}
@@ -49,6 +49,13 @@
 #define AUTO_GUID_TEXT N_("Set NFS uid/guid automatically")
 #define AUTO_GUID_LONGTEXT N_("If uid/gid are not specified in " \
     "the url, VLC will automatically set a uid/gid.")
+#define READ_DEPTH_TEXT N_("Outstanding read requests")
+#define READ_DEPTH_LONGTEXT N_("Number of read requests kept in flight " \
+    "ahead of the current position. Higher values hide the network " \
+    "latency at the cost of memory.")
+
+/* Maximum size of a single read request, see FileReadAhead() */
+#define NFS_READ_CHUNK 524288
 
 static int Open(vlc_object_t *);
 static void Close(vlc_object_t *);
@@ -58,11 +65,23 @@ vlc_module_begin()
     set_description(N_("NFS input"))
     set_subcategory(SUBCAT_INPUT_ACCESS)
     add_bool("nfs-auto-guid", true, AUTO_GUID_TEXT, AUTO_GUID_LONGTEXT)
+    add_integer_with_range("nfs-read-depth", 8, 1, 16,
+                           READ_DEPTH_TEXT, READ_DEPTH_LONGTEXT)
     set_capability("access", 0)
     add_shortcut("nfs")
     set_callbacks(Open, Close)
 vlc_module_end()
 
+struct nfs_read_chunk
+{
+    stream_t *  p_access;
+    uint8_t *   p_buf;
+    uint64_t    i_offset;
+    size_t      i_size; /* requested size */
+    size_t      i_len;
+    bool        b_done;
+};
+
 typedef struct
 {
     struct rpc_context *    p_mount; /* used to to get exports mount point */
@@ -78,21 +97,23 @@ typedef struct
     bool                    b_error;
     bool                    b_auto_guid;
 
+    /* Ring of outstanding positional reads, from the current position */
+    struct nfs_read_chunk * p_reads;
+    unsigned                i_read_depth;
+    unsigned                i_read_head;
+    unsigned                i_read_count;
+    size_t                  i_read_size; /* size of the requests */
+    uint64_t                i_read_next; /* offset of the next request */
+    uint64_t                i_pos;
+    uint64_t                i_hint_offset; /* range hinted by STREAM_SET_READ_HINT */
+    uint64_t                i_hint_end;
+
     union {
         struct
         {
             char **         ppsz_names;
             int             i_count;
         } exports;
-        struct
-        {
-            uint8_t *p_buf;
-            size_t i_len;
-        } read;
-        struct
-        {
-            bool b_done;
-        } seek;
     } res;
 } access_sys_t;
 
@@ -177,71 +198,162 @@ nfs_read_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
             void *p_private_data)
 {
     VLC_UNUSED(p_nfs);
-    stream_t *p_access = p_private_data;
+    struct nfs_read_chunk *p_chunk = p_private_data;
+    stream_t *p_access = p_chunk->p_access;
     access_sys_t *p_sys = p_access->p_sys;
     assert(p_sys->p_nfs == p_nfs);
+    p_chunk->b_done = true;
     if (NFS_CHECK_STATUS(p_access, i_status, p_data))
         return;
 
-    if (i_status == 0)
-        p_sys->b_eof = true;
-    else
-    {
-        p_sys->res.read.i_len = i_status;
-        memcpy(p_sys->res.read.p_buf, p_data, i_status);
-    }
+    p_chunk->i_len = i_status;
+    memcpy(p_chunk->p_buf, p_data, i_status);
 }
 
 static bool
 nfs_read_finished_cb(stream_t *p_access)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.read.i_len > 0 || p_sys->b_eof;
+    return p_sys->p_reads[p_sys->i_read_head].b_done;
 }
 
-static ssize_t
-FileRead(stream_t *p_access, void *p_buf, size_t i_len)
+static inline struct nfs_read_chunk *
+FileReadAt(access_sys_t *p_sys, unsigned i)
 {
-    access_sys_t *p_sys = p_access->p_sys;
+    return &p_sys->p_reads[(p_sys->i_read_head + i) % p_sys->i_read_depth];
+}
 
-    if (p_sys->b_eof)
-        return 0;
+static void
+FileReadPop(access_sys_t *p_sys)
+{
+    assert(p_sys->i_read_count > 0);
+    p_sys->i_read_head = (p_sys->i_read_head + 1) % p_sys->i_read_depth;
+    p_sys->i_read_count--;
+}
+
+/* Waits for all the outstanding reads, since their buffers are reused, and
+ * restarts reading at the given offset */
+static void
+FileReadFlush(stream_t *p_access, uint64_t i_offset)
+{
+    access_sys_t *p_sys = p_access->p_sys;
 
-    p_sys->res.read.i_len = 0;
-    p_sys->res.read.p_buf = p_buf;
-    if (nfs_read_async(p_sys->p_nfs, p_sys->p_nfsfh, i_len, nfs_read_cb,
-                       p_access) < 0)
+    while (p_sys->i_read_count > 0)
     {
-        msg_Err(p_access, "nfs_read_async failed");
-        return 0;
+        vlc_nfs_mainloop(p_access, nfs_read_finished_cb);
+        FileReadPop(p_sys);
     }
+    p_sys->i_read_next = i_offset;
+}
 
-    if (vlc_nfs_mainloop(p_access, nfs_read_finished_cb) < 0)
-        return 0;
+static bool
+FileReadInWindow(const access_sys_t *p_sys, uint64_t i_offset)
+{
+    if (p_sys->i_read_count == 0)
+        return false;
 
-    return p_sys->res.read.i_len;
+    const struct nfs_read_chunk *p_head = &p_sys->p_reads[p_sys->i_read_head];
+    return i_offset >= p_head->i_offset && i_offset < p_sys->i_read_next;
 }
 
+/* Keeps up to i_read_depth requests in flight, to hide the round-trip time
+ * of the synchronous NFS reads */
 static void
-nfs_seek_cb(int i_status, struct nfs_context *p_nfs, void *p_data,
-            void *p_private_data)
+FileReadAhead(stream_t *p_access)
 {
-    VLC_UNUSED(p_nfs);
-    stream_t *p_access = p_private_data;
     access_sys_t *p_sys = p_access->p_sys;
-    assert(p_sys->p_nfs == p_nfs);
-    (void) p_data;
-    if (NFS_CHECK_STATUS(p_access, i_status, p_data))
-        return;
 
-    p_sys->res.seek.b_done = true;
+    while (p_sys->i_read_count < p_sys->i_read_depth && !p_sys->b_error)
+    {
+        uint64_t i_end = p_sys->stat.nfs_size;
+        size_t i_size = p_sys->i_read_size;
+
+        if (p_sys->i_read_count > 0)
+        {
+            /* Do not read ahead past the end of the file nor the end of the
+             * hinted range, until it is reached. The first request is always
+             * sent, in case the file grew. */
+            const struct nfs_read_chunk *p_head =
+                &p_sys->p_reads[p_sys->i_read_head];
+            if (p_head->i_offset >= p_sys->i_hint_offset
+             && p_head->i_offset < p_sys->i_hint_end
+             && p_sys->i_hint_end < i_end)
+                i_end = p_sys->i_hint_end;
+
+            if (p_sys->i_read_next >= i_end)
+                break;
+            if (i_size > i_end - p_sys->i_read_next)
+                i_size = i_end - p_sys->i_read_next;
+        }
+
+        struct nfs_read_chunk *p_chunk = FileReadAt(p_sys, p_sys->i_read_count);
+        p_chunk->i_offset = p_sys->i_read_next;
+        p_chunk->i_size = i_size;
+        p_chunk->i_len = 0;
+        p_chunk->b_done = false;
+
+        if (nfs_pread_async(p_sys->p_nfs, p_sys->p_nfsfh, p_chunk->i_offset,
+                            i_size, nfs_read_cb, p_chunk) < 0)
+        {
+            msg_Err(p_access, "nfs_pread_async failed");
+            p_sys->b_error = true;
+            break;
+        }
+        p_sys->i_read_next += i_size;
+        p_sys->i_read_count++;
+    }
 }
 
-static bool
-nfs_seek_finished_cb(stream_t *p_access)
+static ssize_t
+FileRead(stream_t *p_access, void *p_buf, size_t i_len)
 {
     access_sys_t *p_sys = p_access->p_sys;
-    return p_sys->res.seek.b_done;
+
+    if (p_sys->b_eof || p_sys->b_error)
+        return 0;
+
+    for (;;)
+    {
+        if (!FileReadInWindow(p_sys, p_sys->i_pos))
+            FileReadFlush(p_access, p_sys->i_pos);
+
+        FileReadAhead(p_access);
+        if (p_sys->i_read_count == 0
+         || vlc_nfs_mainloop(p_access, nfs_read_finished_cb) < 0)
+            return 0;
+
+        struct nfs_read_chunk *p_chunk = FileReadAt(p_sys, 0);
+        if (p_chunk->i_len == 0)
+        {
+            FileReadFlush(p_access, p_sys->i_pos);
+            p_sys->b_eof = true;
+            return 0;
+        }
+
+        assert(p_sys->i_pos >= p_chunk->i_offset);
+        size_t i_offset = p_sys->i_pos - p_chunk->i_offset;
+        if (i_offset < p_chunk->i_len)
+        {
+            if (i_len > p_chunk->i_len - i_offset)
+                i_len = p_chunk->i_len - i_offset;
+
+            memcpy(p_buf, p_chunk->p_buf + i_offset, i_len);
+            p_sys->i_pos += i_len;
+            return i_len;
+        }
+
+        /* The server may cap the size of the reads: use smaller requests
+         * from now on. The next request starts past the position and the
+         * window is flushed. */
+        if (p_chunk->i_len < p_chunk->i_size
+         && p_chunk->i_offset + p_chunk->i_len < p_sys->stat.nfs_size)
+        {
+            msg_Dbg(p_access, "short read, using %zu bytes requests",
+                    p_chunk->i_len);
+            p_sys->i_read_size = p_chunk->i_len;
+        }
+        FileReadPop(p_sys);
+    }
 }
 
 static int
@@ -249,22 +361,38 @@ FileSeek(stream_t *p_access, uint64_t i_pos)
 {
     access_sys_t *p_sys = p_access->p_sys;
 
-    p_sys->res.seek.b_done = false;
-    if (nfs_lseek_async(p_sys->p_nfs, p_sys->p_nfsfh, i_pos, SEEK_SET,
-                        nfs_seek_cb, p_access) < 0)
-    {
-        msg_Err(p_access, "nfs_seek_async failed");
-        return VLC_EGENERIC;
-    }
+    /* Keep the outstanding reads if the new position is within them */
+    if (!FileReadInWindow(p_sys, i_pos))
+        FileReadFlush(p_access, i_pos);
 
-    if (vlc_nfs_mainloop(p_access, nfs_seek_finished_cb) < 0)
+    if (p_sys->b_error)
         return VLC_EGENERIC;
 
+    p_sys->i_pos = i_pos;
     p_sys->b_eof = false;
 
     return VLC_SUCCESS;
 }
 
+static void
+FileSetReadHint(stream_t *p_access, uint64_t i_offset, uint64_t i_length)
+{
+    access_sys_t *p_sys = p_access->p_sys;
+
+    p_sys->i_hint_offset = i_offset;
+    p_sys->i_hint_end = i_length < UINT64_MAX - i_offset
+                      ? i_offset + i_length : UINT64_MAX;
+
+    /* Prefetch the hinted range right away, so that the data is already in
+     * flight when the demuxer seeks there. */
+    if (p_sys->b_error || FileReadInWindow(p_sys, i_offset)
+     || i_offset >= p_sys->stat.nfs_size)
+        return;
+
+    FileReadFlush(p_access, i_offset);
+    FileReadAhead(p_access);
+}
+
 static int
 FileControl(stream_t *p_access, int i_query, va_list args)
 {
@@ -299,6 +427,15 @@ FileControl(stream_t *p_access, int i_query, va_list args)
         case STREAM_SET_PAUSE_STATE:
             break;
 
+        case STREAM_SET_READ_HINT:
+        {
+            uint64_t i_offset = va_arg(args, uint64_t);
+            uint64_t i_length = va_arg(args, uint64_t);
+
+            FileSetReadHint(p_access, i_offset, i_length);
+            break;
+        }
+
         default:
             return VLC_EGENERIC;
     }
@@ -699,6 +836,25 @@ Open(vlc_object_t *p_obj)
 
         if (p_sys->p_nfsfh != NULL)
         {
+            /* Requests larger than the server limit would be short reads */
+            p_sys->i_read_size = NFS_READ_CHUNK;
+            uint64_t i_readmax = nfs_get_readmax(p_sys->p_nfs);
+            if (i_readmax > 0 && i_readmax < p_sys->i_read_size)
+                p_sys->i_read_size = i_readmax;
+
+            p_sys->i_read_depth = var_InheritInteger(p_access, "nfs-read-depth");
+            p_sys->p_reads = vlc_obj_calloc(p_obj, p_sys->i_read_depth,
+                                            sizeof (*p_sys->p_reads));
+            uint8_t *p_read_buf = vlc_obj_malloc(p_obj,
+                                    p_sys->i_read_depth * p_sys->i_read_size);
+            if (unlikely(p_sys->p_reads == NULL || p_read_buf == NULL))
+                goto error;
+            for (unsigned i = 0; i < p_sys->i_read_depth; i++)
+            {
+                p_sys->p_reads[i].p_access = p_access;
+                p_sys->p_reads[i].p_buf = p_read_buf + i * p_sys->i_read_size;
+            }
+
             p_access->pf_read = FileRead;
             p_access->pf_seek = FileSeek;
             p_access->pf_control = FileControl;
@@ -162,6 +162,10 @@ static inline bool rist_add_peers(vlc_object_t *p_this, struct rist_ctx *ctx, ch
     psz_srp_password = var_InheritString( p_this, RIST_CFG_PREFIX RIST_URL_PARAM_SRP_PASSWORD );
 
     int recovery_mode = RIST_RECOVERY_MODE_TIME;
+    /* EAP-SRP authentication is only defined by the main profile */
+    bool b_srp = var_InheritInteger( p_this, RIST_CFG_PREFIX RIST_URL_PARAM_PROFILE ) != RIST_PROFILE_SIMPLE
+              && psz_srp_username != NULL && psz_srp_username[0] != '\0'
+              && psz_srp_password != NULL && psz_srp_password[0] != '\0';
 
     msg_Info( p_this, "Setting retry buffer to %d ms", i_recovery_length );
 
@@ -223,9 +227,14 @@ static inline bool rist_add_peers(vlc_object_t *p_this, struct rist_ctx *ctx, ch
             free(addr[i]);
             continue;
         }
-        else {
-            b_peer_alive = true;
+        if (b_srp && rist_enable_eap_srp(peer, psz_srp_username, psz_srp_password, NULL, NULL)) {
+            msg_Err( p_this, "Could not enable authentication for peer #%i at %s", (int)(i + 1), addr[i] );
+            rist_peer_destroy(ctx, peer);
+            free(addr[i]);
+            continue;
         }
+        msg_Dbg( p_this, "Added peer #%i with weight %"PRIu32, (int)(i + 1), peer_config->weight );
+        b_peer_alive = true;
         free(addr[i]);
     }
 
@@ -0,0 +1,243 @@
+/**
+ * @file fec.c
+ * @brief SMPTE 2022-1 forward error correction
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+#include "rtp.h"
+
+/* The largest SMPTE 2022-1 matrix has 100 packets, and the column FEC
+ * packets are sent up to one matrix later than the media packets. */
+#define FEC_WINDOW 512
+#define FEC_MAX_PAYLOAD 1472
+#define FEC_HEADER_SIZE 16
+
+struct rtp_fec_packet
+{
+    bool     valid;
+    uint8_t  pt;
+    uint16_t seq;
+    uint16_t length;
+    uint32_t ts;
+    uint32_t ssrc;
+    uint8_t  payload[FEC_MAX_PAYLOAD];
+};
+
+struct rtp_fec
+{
+    struct rtp_fec_packet packets[FEC_WINDOW]; /* indexed by sequence */
+    vlc_tick_t last_rx; /* last media packet local timestamp */
+    vlc_tick_t interval; /* media packets inter-arrival average */
+    unsigned   span; /* media packets covered by a FEC matrix */
+};
+
+/**
+ * Gets the payload of an RTP packet.
+ * @return the payload offset, or 0 if the packet is invalid
+ */
+static size_t rtp_fec_payload(const uint8_t *buf, size_t *restrict lenp)
+{
+    size_t len = *lenp;
+    size_t skip = 12u + (buf[0] & 0x0F) * 4;
+
+    if (buf[0] & 0x10)
+    {   /* Extension header */
+        skip += 4;
+        if (len < skip)
+            return 0;
+        skip += 4 * GetWBE(buf + skip - 2);
+    }
+    if (buf[0] & 0x20)
+    {   /* Padding */
+        if (len <= skip || buf[len - 1] == 0 || buf[len - 1] > len - skip)
+            return 0;
+        len -= buf[len - 1];
+    }
+    if (len < skip)
+        return 0;
+
+    *lenp = len - skip;
+    return skip;
+}
+
+struct rtp_fec *rtp_fec_create(void)
+{
+    struct rtp_fec *fec = malloc(sizeof (*fec));
+    if (unlikely(fec == NULL))
+        return NULL;
+
+    for (size_t i = 0; i < FEC_WINDOW; i++)
+        fec->packets[i].valid = false;
+    fec->last_rx = VLC_TICK_INVALID;
+    fec->interval = 0;
+    fec->span = 0;
+    return fec;
+}
+
+void rtp_fec_destroy(struct rtp_fec *fec)
+{
+    free(fec);
+}
+
+static void rtp_fec_store(struct rtp_fec *fec, uint16_t seq, uint8_t pt,
+                          uint32_t ts, uint32_t ssrc,
+                          const uint8_t *payload, size_t length)
+{
+    struct rtp_fec_packet *p = &fec->packets[seq % FEC_WINDOW];
+
+    p->valid = true;
+    p->pt = pt;
+    p->seq = seq;
+    p->length = length;
+    p->ts = ts;
+    p->ssrc = ssrc;
+    memcpy(p->payload, payload, length);
+}
+
+static const struct rtp_fec_packet *rtp_fec_find(const struct rtp_fec *fec,
+                                                 uint16_t seq)
+{
+    const struct rtp_fec_packet *p = &fec->packets[seq % FEC_WINDOW];
+
+    return (p->valid && p->seq == seq) ? p : NULL;
+}
+
+void rtp_fec_record(struct rtp_fec *fec, const block_t *block, vlc_tick_t now)
+{
+    size_t len = block->i_buffer;
+
+    if (len < 12)
+        return;
+
+    size_t skip = rtp_fec_payload(block->p_buffer, &len);
+    if (skip == 0 || len > FEC_MAX_PAYLOAD)
+        return;
+
+    rtp_fec_store(fec, GetWBE(block->p_buffer + 2), rtp_ptype(block),
+                  GetDWBE(block->p_buffer + 4), GetDWBE(block->p_buffer + 8),
+                  block->p_buffer + skip, len);
+
+    if (fec->last_rx != VLC_TICK_INVALID && now > fec->last_rx)
+        fec->interval += ((now - fec->last_rx) - fec->interval) / 16;
+    fec->last_rx = now;
+}
+
+block_t *rtp_fec_recover(struct rtp_fec *fec, const block_t *block)
+{
+    size_t len = block->i_buffer;
+
+    if (len < 12 || (block->p_buffer[0] >> 6) != 2)
+        return NULL;
+
+    size_t skip = rtp_fec_payload(block->p_buffer, &len);
+    if (skip == 0 || len < FEC_HEADER_SIZE)
+        return NULL;
+
+    const uint8_t *hdr = block->p_buffer + skip;
+    const uint8_t *fec_payload = hdr + FEC_HEADER_SIZE;
+    size_t fec_length = len - FEC_HEADER_SIZE;
+    uint16_t sn_base = GetWBE(hdr);
+    uint16_t length = GetWBE(hdr + 2);
+    uint8_t pt = hdr[4] & 0x7F;
+    uint32_t ts = GetDWBE(hdr + 8);
+    unsigned type = (hdr[12] >> 3) & 7;
+    unsigned offset = hdr[13];
+    unsigned na = hdr[14];
+
+    if (type != 0 /* XOR */ || offset == 0 || na == 0
+     || fec_length > FEC_MAX_PAYLOAD)
+        return NULL;
+
+    if (fec->span < offset * na)
+        fec->span = offset * na;
+
+    /* Exactly one protected packet must be missing */
+    const struct rtp_fec_packet *any = NULL;
+    uint16_t missing = 0;
+    unsigned missingc = 0;
+
+    for (unsigned i = 0; i < na; i++)
+    {
+        uint16_t seq = sn_base + i * offset;
+        const struct rtp_fec_packet *p = rtp_fec_find(fec, seq);
+
+        if (p == NULL)
+        {
+            missing = seq;
+            if (++missingc > 1)
+                return NULL;
+        }
+        else
+            any = p;
+    }
+    if (missingc == 0 || any == NULL)
+        return NULL;
+
+    uint8_t payload[FEC_MAX_PAYLOAD];
+
+    memcpy(payload, fec_payload, fec_length);
+    memset(payload + fec_length, 0, sizeof (payload) - fec_length);
+
+    for (unsigned i = 0; i < na; i++)
+    {
+        const struct rtp_fec_packet *p = rtp_fec_find(fec, sn_base + i * offset);
+        if (p == NULL)
+            continue;
+
+        for (size_t j = 0; j < p->length; j++)
+            payload[j] ^= p->payload[j];
+        length ^= p->length;
+        pt ^= p->pt;
+        ts ^= p->ts;
+    }
+
+    if (length > fec_length)
+        return NULL; /* inconsistent FEC */
+
+    block_t *out = block_Alloc(12 + length);
+    if (unlikely(out == NULL))
+        return NULL;
+
+    out->p_buffer[0] = 0x80;
+    out->p_buffer[1] = pt & 0x7F;
+    SetWBE(out->p_buffer + 2, missing);
+    SetDWBE(out->p_buffer + 4, ts);
+    SetDWBE(out->p_buffer + 8, any->ssrc);
+    memcpy(out->p_buffer + 12, payload, length);
+
+    /* The recovered packet may in turn help recover another one */
+    rtp_fec_store(fec, missing, pt & 0x7F, ts, any->ssrc, payload, length);
+    return out;
+}
+
+vlc_tick_t rtp_fec_delay(const struct rtp_fec *fec)
+{
+    return fec->span * fec->interval;
+}
@@ -74,12 +74,33 @@ static void rtp_process (demux_t *demux, block_t *block)
     }
 #endif
 
+    if (sys->fec != NULL)
+        rtp_fec_record (sys->fec, block, vlc_tick_now ());
     rtp_queue (demux, sys->session, block);
     return;
 drop:
     block_Release (block);
 }
 
+/**
+ * Processes a packet received from a FEC socket.
+ */
+static void rtp_fec_process (demux_t *demux, block_t *block)
+{
+    demux_sys_t *sys = demux->p_sys;
+    block_t *recovered = NULL;
+
+    if (!(block->i_flags & BLOCK_FLAG_CORRUPTED))
+        recovered = rtp_fec_recover (sys->fec, block);
+    block_Release (block);
+    if (recovered != NULL)
+    {
+        msg_Dbg (demux, "recovered packet (sequence: %"PRIu16")",
+                 GetWBE (recovered->p_buffer + 2));
+        rtp_queue (demux, sys->session, recovered);
+    }
+}
+
 static int rtp_timeout (vlc_tick_t deadline)
 {
     if (deadline == VLC_TICK_INVALID)
@@ -107,14 +128,25 @@ void *rtp_dgram_thread (void *opaque)
 
     vlc_thread_set_name("vlc-rtp");
 
+    /* The RTP socket comes first, then the FEC sockets if any */
+    struct vlc_dtls *socks[1 + ARRAY_SIZE(sys->fec_sock)] = { rtp_sock };
+    unsigned sockc = 1;
+
+    for (size_t i = 0; i < ARRAY_SIZE(sys->fec_sock); i++)
+        if (sys->fec_sock[i] != NULL)
+            socks[sockc++] = sys->fec_sock[i];
+
     for (;;)
     {
-        struct pollfd ufd[1];
+        struct pollfd ufd[ARRAY_SIZE(socks)];
 
-        ufd[0].events = POLLIN;
-        ufd[0].fd = vlc_dtls_GetPollFD(rtp_sock, &ufd[0].events);
+        for (unsigned i = 0; i < sockc; i++)
+        {
+            ufd[i].events = POLLIN;
+            ufd[i].fd = vlc_dtls_GetPollFD(socks[i], &ufd[i].events);
+        }
 
-        int n = poll (ufd, 1, rtp_timeout (deadline));
+        int n = poll (ufd, sockc, rtp_timeout (deadline));
         if (n == -1)
             continue;
 
@@ -122,14 +154,17 @@ void *rtp_dgram_thread (void *opaque)
         if (n == 0)
             goto dequeue;
 
-        if (ufd[0].revents)
+        for (unsigned i = 0; i < sockc; i++)
         {
-            block_t *block = block_Alloc(DEFAULT_MRU);
+            if (!ufd[i].revents)
+                continue;
+
+            block_t *block = block_AllocPooled(DEFAULT_MRU);
             if (unlikely(block == NULL))
-                break; /* we are totallly screwed */
+                goto out; /* we are totallly screwed */
 
             bool truncated;
-            ssize_t len = vlc_dtls_Recv(rtp_sock, block->p_buffer,
+            ssize_t len = vlc_dtls_Recv(socks[i], block->p_buffer,
                                        block->i_buffer, &truncated);
             if (len >= 0) {
                 if (truncated) {
@@ -140,18 +175,19 @@ void *rtp_dgram_thread (void *opaque)
                 else
                     block->i_buffer = len;
 
-                rtp_process (demux, block);
+                if (i == 0)
+                    rtp_process (demux, block);
+                else
+                    rtp_fec_process (demux, block);
             }
             else
             {
-                if (errno == EPIPE)
-                    break; /* connection terminated */
+                if (errno == EPIPE && i == 0)
+                    goto out; /* connection terminated */
                 msg_Warn (demux, "RTP network error: %s",
                           vlc_strerror_c(errno));
                 block_Release (block);
             }
-
-            n--;
         }
 
     dequeue:
@@ -159,5 +195,6 @@ void *rtp_dgram_thread (void *opaque)
             deadline = VLC_TICK_INVALID;
         vlc_restorecancel (canc);
     }
+out:
     return NULL;
 }
@@ -277,6 +277,11 @@ static void Close (vlc_object_t *obj)
         srtp_destroy (p_sys->srtp);
 #endif
     rtp_session_destroy (demux, p_sys->session);
+    for (size_t i = 0; i < ARRAY_SIZE(p_sys->fec_sock); i++)
+        if (p_sys->fec_sock[i] != NULL)
+            vlc_dtls_Close(p_sys->fec_sock[i]);
+    if (p_sys->fec != NULL)
+        rtp_fec_destroy(p_sys->fec);
     if (p_sys->rtcp_sock != NULL)
         vlc_dtls_Close(p_sys->rtcp_sock);
     vlc_dtls_Close(p_sys->rtp_sock);
@@ -311,6 +316,8 @@ static int OpenSDP(vlc_object_t *obj)
 
     sys->rtp_sock = NULL;
     sys->rtcp_sock = NULL;
+    sys->fec_sock[0] = sys->fec_sock[1] = NULL;
+    sys->fec = NULL;
     sys->session = NULL;
 #ifdef HAVE_SRTP
     sys->srtp = NULL;
@@ -512,7 +519,7 @@ static int OpenURL(vlc_object_t *obj)
     int rtcp_dport = var_CreateGetInteger (obj, "rtcp-port");
 
     /* Try to connect */
-    int fd = -1, rtcp_fd = -1;
+    int fd = -1, rtcp_fd = -1, fec_fd[2] = { -1, -1 };
     bool co = false;
 
     switch (tp)
@@ -524,6 +531,17 @@ static int OpenURL(vlc_object_t *obj)
                 break;
             if (rtcp_dport > 0) /* XXX: source port is unknown */
                 rtcp_fd = net_OpenDgram (obj, dhost, rtcp_dport, shost, 0, tp);
+            if (var_InheritBool (obj, "rtp-fec"))
+            {   /* SMPTE 2022-1 column and row FEC ports */
+                for (int i = 0; i < 2; i++)
+                {
+                    fec_fd[i] = net_OpenDgram (obj, dhost, dport + 2 * (i + 1),
+                                               shost, 0, tp);
+                    if (fec_fd[i] == -1)
+                        msg_Warn (obj, "cannot receive FEC on port %d",
+                                  dport + 2 * (i + 1));
+                }
+            }
             break;
 
          case IPPROTO_DCCP:
@@ -552,6 +570,9 @@ static int OpenURL(vlc_object_t *obj)
     if (p_sys->rtp_sock == NULL) {
         if (rtcp_fd != -1)
             net_Close(rtcp_fd);
+        for (int i = 0; i < 2; i++)
+            if (fec_fd[i] != -1)
+                net_Close(fec_fd[i]);
         return VLC_EGENERIC;
     }
     net_SetCSCov (fd, -1, 12);
@@ -563,6 +584,16 @@ static int OpenURL(vlc_object_t *obj)
     } else
         p_sys->rtcp_sock = NULL;
 
+    for (int i = 0; i < 2; i++) {
+        p_sys->fec_sock[i] = NULL;
+        if (fec_fd[i] != -1) {
+            p_sys->fec_sock[i] = vlc_datagram_CreateFD(fec_fd[i]);
+            if (p_sys->fec_sock[i] == NULL)
+                net_Close(fec_fd[i]);
+        }
+    }
+    p_sys->fec = NULL;
+
     /* Initializes demux */
     p_sys->chained_demux = NULL;
 #ifdef HAVE_SRTP
@@ -610,11 +641,23 @@ static int OpenURL(vlc_object_t *obj)
     }
 #endif
 
+    if (p_sys->fec_sock[0] != NULL || p_sys->fec_sock[1] != NULL)
+    {
+        p_sys->fec = rtp_fec_create();
+        if (unlikely(p_sys->fec == NULL))
+            goto error;
+    }
+
     if (vlc_clone (&p_sys->thread, rtp_dgram_thread, demux))
         goto error;
     return VLC_SUCCESS;
 
 error:
+    if (p_sys->fec != NULL)
+        rtp_fec_destroy(p_sys->fec);
+    for (int i = 0; i < 2; i++)
+        if (p_sys->fec_sock[i] != NULL)
+            vlc_dtls_Close(p_sys->fec_sock[i]);
 #ifdef HAVE_SRTP
     if (p_sys->srtp != NULL)
         srtp_destroy(p_sys->srtp);
@@ -643,6 +686,11 @@ error:
     "Secure RTP requires a (non-secret) master salt value. " \
     "This must be a 28-character-long hexadecimal string.")
 
+#define RTP_FEC_TEXT N_("SMPTE 2022-1 FEC")
+#define RTP_FEC_LONGTEXT N_( \
+    "Receive the column and row forward error correction packets on the " \
+    "RTP port plus 2 and plus 4, and recover the lost RTP packets.")
+
 #define RTP_MAX_SRC_TEXT N_("Maximum RTP sources")
 #define RTP_MAX_SRC_LONGTEXT N_( \
     "How many distinct active RTP sources are allowed at a time." )
@@ -687,6 +735,8 @@ vlc_module_begin()
                SRTP_SALT_TEXT, SRTP_SALT_LONGTEXT)
         change_safe()
 #endif
+    add_bool("rtp-fec", false, RTP_FEC_TEXT, RTP_FEC_LONGTEXT)
+        change_safe()
     add_integer("rtp-max-src", 1, RTP_MAX_SRC_TEXT,
                 RTP_MAX_SRC_LONGTEXT)
         change_integer_range (1, 255)
@@ -370,6 +370,34 @@ int vlc_rtp_add_media_types(vlc_object_t *obj, rtp_session_t *ses,
 
 void *rtp_dgram_thread (void *data);
 
+/** @} */
+
+/**
+ * \defgroup rtp_fec SMPTE 2022-1 forward error correction
+ * @{
+ */
+struct rtp_fec;
+
+struct rtp_fec *rtp_fec_create(void);
+void rtp_fec_destroy(struct rtp_fec *);
+
+/**
+ * Keeps a copy of a received media packet, to recover the other packets of
+ * its FEC rows and columns.
+ */
+void rtp_fec_record(struct rtp_fec *, const block_t *, vlc_tick_t now);
+
+/**
+ * Processes a row or column FEC packet.
+ * @return the recovered media packet, or NULL if none could be recovered
+ */
+block_t *rtp_fec_recover(struct rtp_fec *, const block_t *);
+
+/**
+ * Estimates how long to wait for the FEC packets protecting a lost packet.
+ */
+vlc_tick_t rtp_fec_delay(const struct rtp_fec *);
+
 /** @} */
 /** @} */
 
@@ -383,6 +411,8 @@ typedef struct
 #endif
     struct vlc_dtls *rtp_sock;
     struct vlc_dtls *rtcp_sock;
+    struct vlc_dtls *fec_sock[2]; /**< Column and row FEC sockets */
+    struct rtp_fec *fec;
     vlc_thread_t  thread;
 
     vlc_tick_t    timeout;
@@ -362,6 +362,7 @@ static void rtp_decode (demux_t *, const rtp_session_t *, rtp_source_t *);
 bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
                   vlc_tick_t *restrict deadlinep)
 {
+    demux_sys_t *p_sys = demux->p_sys;
     vlc_tick_t now = vlc_tick_now ();
     bool pending = false;
 
@@ -410,6 +411,11 @@ bool rtp_dequeue (demux_t *demux, const rtp_session_t *session,
             if (deadline < VLC_TICK_FROM_MS(25))
                 deadline = VLC_TICK_FROM_MS(25);
 
+            /* With FEC, also wait for the rest of the FEC matrix, as the
+             * lost packet can only be recovered after it. */
+            if (p_sys->fec != NULL)
+                deadline += rtp_fec_delay (p_sys->fec);
+
             /* Additionally, we implicitly wait for the packetization time
              * multiplied by the number of missing packets. block is the first
              * non-missing packet (lowest sequence number). We have no better
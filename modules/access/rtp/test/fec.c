@@ -0,0 +1,152 @@
+/**
+ * @file fec.c
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include "../rtp.h"
+
+const char vlc_module_name[] = "fec_test";
+
+#define L 4 /* columns */
+#define D 3 /* rows */
+#define SN_BASE 65530 /* wraps around */
+#define PT 33
+
+static block_t *media_packet(unsigned i)
+{
+    size_t size = 100 + 10 * i; /* different lengths */
+    block_t *b = block_Alloc(12 + size);
+    assert(b != NULL);
+
+    b->p_buffer[0] = 0x80;
+    b->p_buffer[1] = PT;
+    SetWBE(b->p_buffer + 2, SN_BASE + i);
+    SetDWBE(b->p_buffer + 4, 90000 * i);
+    SetDWBE(b->p_buffer + 8, 0xdeadbeef);
+    for (size_t j = 0; j < size; j++)
+        b->p_buffer[12 + j] = i * 7 + j;
+    return b;
+}
+
+/* Makes the FEC packet of the media packets first + k * offset, k < na */
+static block_t *fec_packet(unsigned first, unsigned offset, unsigned na,
+                           bool column)
+{
+    uint8_t payload[256] = { 0 };
+    uint16_t length = 0;
+    uint8_t pt = 0;
+    uint32_t ts = 0;
+
+    for (unsigned k = 0; k < na; k++)
+    {
+        block_t *m = media_packet(first + k * offset);
+        size_t size = m->i_buffer - 12;
+
+        for (size_t j = 0; j < size; j++)
+            payload[j] ^= m->p_buffer[12 + j];
+        length ^= size;
+        pt ^= PT;
+        ts ^= GetDWBE(m->p_buffer + 4);
+        block_Release(m);
+    }
+
+    block_t *b = block_Alloc(12 + 16 + sizeof (payload));
+    assert(b != NULL);
+    memset(b->p_buffer, 0, b->i_buffer);
+    b->p_buffer[0] = 0x80;
+    b->p_buffer[1] = 96;
+
+    uint8_t *h = b->p_buffer + 12;
+    SetWBE(h, (uint16_t)(SN_BASE + first));
+    SetWBE(h + 2, length);
+    h[4] = 0x80 | pt;
+    SetDWBE(h + 8, ts);
+    h[12] = column ? 0 : 0x40;
+    h[13] = offset;
+    h[14] = na;
+    memcpy(h + 16, payload, sizeof (payload));
+    return b;
+}
+
+static void check_recovered(block_t *r, unsigned i)
+{
+    block_t *m = media_packet(i);
+
+    assert(r != NULL);
+    assert(r->i_buffer == m->i_buffer);
+    assert(memcmp(r->p_buffer, m->p_buffer, m->i_buffer) == 0);
+    block_Release(m);
+    block_Release(r);
+}
+
+int main(void)
+{
+    struct rtp_fec *fec = rtp_fec_create();
+    assert(fec != NULL);
+
+    /* Lose packet 5, and both 8 and 9 which are on the same row */
+    for (unsigned i = 0; i < L * D; i++)
+    {
+        if (i == 5 || i == 8 || i == 9)
+            continue;
+
+        block_t *m = media_packet(i);
+        rtp_fec_record(fec, m, VLC_TICK_FROM_MS(i));
+        block_Release(m);
+    }
+
+    /* Row FEC recovers the single loss of the second row */
+    block_t *f = fec_packet(L, 1, L, false);
+    check_recovered(rtp_fec_recover(fec, f), 5);
+    /* Nothing left to recover */
+    assert(rtp_fec_recover(fec, f) == NULL);
+    block_Release(f);
+
+    /* Two losses on the third row */
+    f = fec_packet(2 * L, 1, L, false);
+    assert(rtp_fec_recover(fec, f) == NULL);
+    block_Release(f);
+
+    /* Column FEC recovers them one by one... */
+    f = fec_packet(0, L, D, true);
+    check_recovered(rtp_fec_recover(fec, f), 8);
+    block_Release(f);
+
+    /* ...and then the row FEC can recover the last one */
+    f = fec_packet(2 * L, 1, L, false);
+    check_recovered(rtp_fec_recover(fec, f), 9);
+    block_Release(f);
+
+    /* The receiver waits for a whole matrix */
+    assert(rtp_fec_delay(fec) > 0);
+    assert(rtp_fec_delay(fec) <= L * D * VLC_TICK_FROM_MS(1));
+
+    rtp_fec_destroy(fec);
+    return 0;
+}
@@ -36,6 +36,7 @@
 #include <vlc_access.h>
 #include <vlc_network.h>
 #include <vlc_block.h>
+#include <vlc_memstream.h>
 #include <vlc_queue.h>
 #include <vlc_rand.h>
 #include <vlc_url.h>
@@ -63,6 +64,11 @@ static void satip_close(vlc_object_t *);
 
 #define SATIP_HOST_TEXT N_("Host")
 
+#define PID_FILTER_TEXT N_("Request only the selected PIDs")
+#define PID_FILTER_LONGTEXT N_("Instead of the full transponder requested " \
+    "with pids=all, only request the PIDs of the selected programs, and " \
+    "update the list as the selection changes.")
+
 vlc_module_begin()
     set_shortname("satip")
     set_description( N_("SAT>IP Receiver Plugin") )
@@ -73,6 +79,7 @@ vlc_module_begin()
     add_bool("satip-multicast", false, MULTICAST_TEXT, MULTICAST_LONGTEXT)
     add_string("satip-host", "", SATIP_HOST_TEXT, NULL)
     change_safe()
+    add_bool("satip-pid-filter", true, PID_FILTER_TEXT, PID_FILTER_LONGTEXT)
     add_shortcut("rtsp", "satip")
 vlc_module_end()
 
@@ -112,6 +119,13 @@ typedef struct
     uint16_t last_seq_nr;
 
     bool woken;
+
+    /* PIDs requested with addpids and delpids instead of pids=all */
+    bool pid_filter;
+    vlc_mutex_t pids_lock;
+    bool pids_changed;
+    uint8_t pids[0x2000 / 8]; /**< Selected PIDs */
+    uint8_t server_pids[0x2000 / 8]; /**< PIDs requested from the server */
 } access_sys_t;
 
 VLC_FORMAT(3, 4)
@@ -433,6 +447,79 @@ static void satip_teardown(void *data) {
     }
 }
 
+static bool pid_is_set(const uint8_t *pids, unsigned pid)
+{
+    return (pids[pid >> 3] >> (pid & 7)) & 1;
+}
+
+static void append_pids(struct vlc_memstream *ms, const char *param,
+                        const uint8_t *set, const uint8_t *unset, bool *empty)
+{
+    char sep = *empty ? '?' : '&';
+
+    for (unsigned pid = 0; pid < 0x2000; pid++) {
+        if (!pid_is_set(set, pid) || pid_is_set(unset, pid))
+            continue;
+
+        vlc_memstream_printf(ms, "%c%s%u", sep, param, pid);
+        sep = ',';
+        param = "";
+        *empty = false;
+    }
+}
+
+/* Applies the changes of the PID selection, in a single PLAY request */
+static void satip_update_pids(stream_t *access)
+{
+    access_sys_t *sys = access->p_sys;
+    uint8_t pids[sizeof (sys->pids)];
+    struct vlc_memstream query;
+
+    vlc_mutex_lock(&sys->pids_lock);
+    if (!sys->pids_changed) {
+        vlc_mutex_unlock(&sys->pids_lock);
+        return;
+    }
+    memcpy(pids, sys->pids, sizeof (pids));
+    sys->pids_changed = false;
+    vlc_mutex_unlock(&sys->pids_lock);
+
+    bool empty = true;
+
+    vlc_memstream_open(&query);
+    append_pids(&query, "addpids=", pids, sys->server_pids, &empty);
+    append_pids(&query, "delpids=", sys->server_pids, pids, &empty);
+    if (vlc_memstream_close(&query))
+        return;
+
+    if (!empty) {
+        net_Printf(access, sys->tcp_sock,
+                "PLAY %s%s RTSP/1.0\r\n"
+                "CSeq: %d\r\n"
+                "Session: %s\r\n\r\n",
+                sys->control, query.ptr, sys->cseq++, sys->session_id);
+
+        if (rtsp_handle(access, NULL) == RTSP_RESULT_OK)
+            memcpy(sys->server_pids, pids, sizeof (pids));
+        else {
+            /* Servers limit the length of the PID list */
+            msg_Warn(access, "Failed to update PIDs, requesting all of them");
+            net_Printf(access, sys->tcp_sock,
+                    "PLAY %s?pids=all RTSP/1.0\r\n"
+                    "CSeq: %d\r\n"
+                    "Session: %s\r\n\r\n",
+                    sys->control, sys->cseq++, sys->session_id);
+            if (rtsp_handle(access, NULL) != RTSP_RESULT_OK)
+                msg_Err(access, "Failed to request all PIDs");
+
+            vlc_mutex_lock(&sys->pids_lock);
+            sys->pid_filter = false;
+            vlc_mutex_unlock(&sys->pids_lock);
+        }
+    }
+    free(query.ptr);
+}
+
 #define RECV_TIMEOUT VLC_TICK_FROM_SEC(2)
 static void *satip_thread(void *data) {
     stream_t *access = data;
@@ -485,18 +572,23 @@ static void *satip_thread(void *data) {
             continue;
 
         last_recv = vlc_tick_now();
+
+        /* Queue the whole batch at once */
+        block_t *chain = NULL, **last = &chain;
         for (int i = 0; i < retval; ++i) {
             block_t *block = input_blocks[i];
 
             len = msgs[i].msg_len;
-            if (check_rtp_seq(access, block))
+            if (len < RTP_HEADER_SIZE || check_rtp_seq(access, block))
                 continue;
 
             block->p_buffer += RTP_HEADER_SIZE;
             block->i_buffer = len - RTP_HEADER_SIZE;
-            vlc_queue_Enqueue(&sys->queue, block);
+            block_ChainLastAppend(&last, block);
             input_blocks[i] = NULL;
         }
+        if (chain != NULL)
+            vlc_queue_Enqueue(&sys->queue, chain);
 #else
         if (poll(&ufd, 1, 20) == -1)
             continue;
@@ -526,6 +618,9 @@ static void *satip_thread(void *data) {
         vlc_queue_Enqueue(&sys->queue, block);
 #endif
 
+        if (sys->pid_filter)
+            satip_update_pids(access);
+
         if (sys->keepalive_interval > 0 && vlc_tick_now() > next_keepalive) {
             net_Printf(access, sys->tcp_sock,
                     "OPTIONS %s RTSP/1.0\r\n"
@@ -558,6 +653,7 @@ static block_t* satip_block(stream_t *access, bool *restrict eof) {
 }
 
 static int satip_control(stream_t *access, int i_query, va_list args) {
+    access_sys_t *sys = access->p_sys;
     bool *pb_bool;
 
     switch(i_query)
@@ -574,6 +670,41 @@ static int satip_control(stream_t *access, int i_query, va_list args) {
                 VLC_TICK_FROM_MS(var_InheritInteger(access, "live-caching"));
             break;
 
+        case STREAM_SET_PRIVATE_ID_STATE:
+        {
+            unsigned pid = va_arg(args, int);
+            bool add = va_arg(args, int);
+
+            if (pid > 0x1FFF)
+                return VLC_EGENERIC;
+
+            /* The receiving thread sends the changes to the server */
+            vlc_mutex_lock(&sys->pids_lock);
+            if (!sys->pid_filter) {
+                vlc_mutex_unlock(&sys->pids_lock);
+                return VLC_EGENERIC;
+            }
+            if (add)
+                sys->pids[pid >> 3] |= 1 << (pid & 7);
+            else
+                sys->pids[pid >> 3] &= ~(1 << (pid & 7));
+            sys->pids_changed = true;
+            vlc_mutex_unlock(&sys->pids_lock);
+            break;
+        }
+
+        case STREAM_GET_PRIVATE_ID_STATE:
+        {
+            unsigned pid = va_arg(args, int);
+            bool *on = va_arg(args, bool *);
+
+            vlc_mutex_lock(&sys->pids_lock);
+            /* Without filtering, the server sends every PID */
+            *on = !sys->pid_filter || (pid <= 0x1FFF && pid_is_set(sys->pids, pid));
+            vlc_mutex_unlock(&sys->pids_lock);
+            break;
+        }
+
         default:
             return VLC_EGENERIC;
 
@@ -581,6 +712,39 @@ static int satip_control(stream_t *access, int i_query, va_list args) {
     return VLC_SUCCESS;
 }
 
+/* Replaces pids=all with pids=0, to let the demux select the PIDs */
+static char *satip_filter_query(const char *query)
+{
+    struct vlc_memstream ms;
+    bool found = false;
+    const char *param = query;
+
+    vlc_memstream_open(&ms);
+    while (*param != '\0') {
+        size_t len = strcspn(param, "&");
+
+        if (param != query)
+            vlc_memstream_putc(&ms, '&');
+        if (len == 8 && strncmp(param, "pids=all", 8) == 0) {
+            vlc_memstream_puts(&ms, "pids=0");
+            found = true;
+        } else
+            vlc_memstream_write(&ms, param, len);
+
+        param += len;
+        if (*param == '&')
+            param++;
+    }
+
+    if (vlc_memstream_close(&ms))
+        return NULL;
+    if (!found) {
+        free(ms.ptr);
+        return NULL;
+    }
+    return ms.ptr;
+}
+
 /* Bind two adjacent free ports, of which the first one is even (for RTP data)
  * and the second is odd (RTCP). This is a requirement of the satip
  * specification */
@@ -635,6 +799,7 @@ static int satip_open(vlc_object_t *obj)
 
     char *psz_host = var_InheritString(access, "satip-host");
 
+    vlc_mutex_init(&sys->pids_lock);
     sys->udp_sock = -1;
     sys->rtcp_sock = -1;
     sys->tcp_sock = -1;
@@ -687,6 +852,17 @@ static int satip_open(vlc_object_t *obj)
 
     vlc_url_t setup_url = url;
 
+    char *filtered_query = NULL;
+    if (setup_url.psz_option != NULL
+     && var_InheritBool(access, "satip-pid-filter"))
+        filtered_query = satip_filter_query(setup_url.psz_option);
+    if (filtered_query != NULL) {
+        /* Start with the PAT, the demux will select the other PIDs */
+        setup_url.psz_option = filtered_query;
+        sys->pid_filter = true;
+        sys->pids[0] = sys->server_pids[0] = 1;
+    }
+
     // substitute "sat.ip" if present with an the host IP that was fetched during device discovery
     if( !strncasecmp( setup_url.psz_host, "sat.ip", 6 ) ) {
         setup_url.psz_host = psz_host;
@@ -700,6 +876,7 @@ static int satip_open(vlc_object_t *obj)
     }
 
     char *psz_setup_url = vlc_uri_compose(&setup_url);
+    free(filtered_query);
     if( psz_setup_url == NULL )
         goto error;
 
@@ -33,6 +33,7 @@
 #include <d3d11_1.h>
 
 #include <new>
+#include <vector>
 
 #include <wrl/client.h>
 using Microsoft::WRL::ComPtr;
@@ -47,8 +48,15 @@ struct screen_data_t
 
     ComPtr<IDXGIOutputDuplication> duplication;
 
+    /* Last captured picture, sent again while its region is not damaged */
+    picture_t *last_pic = nullptr;
+    D3D11_BOX last_box = {};
+    std::vector<BYTE> metadata;
+
     ~screen_data_t()
     {
+        if (last_pic)
+            picture_Release(last_pic);
         if (vctx)
             vlc_video_context_Release(vctx);
     }
@@ -61,6 +69,48 @@ static void CaptureBlockRelease( block_t *p_block )
     delete d3d11_block;
 }
 
+static bool IntersectsBox(const RECT &rect, const D3D11_BOX &box)
+{
+    return rect.left < (LONG)box.right && rect.right > (LONG)box.left &&
+           rect.top < (LONG)box.bottom && rect.bottom > (LONG)box.top;
+}
+
+/* Checks whether the desktop changed within the captured region */
+static bool IsDamaged(screen_data_t *p_data,
+                      const DXGI_OUTDUPL_FRAME_INFO &frameInfo,
+                      const D3D11_BOX &box)
+{
+    /* Only the mouse pointer was updated */
+    if (frameInfo.LastPresentTime.QuadPart == 0)
+        return false;
+
+    try {
+        if (p_data->metadata.size() < frameInfo.TotalMetadataBufferSize)
+            p_data->metadata.resize(frameInfo.TotalMetadataBufferSize);
+    } catch (const std::bad_alloc &) {
+        return true;
+    }
+
+    UINT capacity = p_data->metadata.size();
+    UINT size;
+    auto moves = reinterpret_cast<DXGI_OUTDUPL_MOVE_RECT *>(p_data->metadata.data());
+
+    if (FAILED(p_data->duplication->GetFrameMoveRects(capacity, moves, &size)))
+        return true;
+    for (UINT i = 0; i < size / sizeof (*moves); i++)
+        if (IntersectsBox(moves[i].DestinationRect, box))
+            return true;
+
+    auto dirty = reinterpret_cast<RECT *>(p_data->metadata.data());
+
+    if (FAILED(p_data->duplication->GetFrameDirtyRects(capacity, dirty, &size)))
+        return true;
+    for (UINT i = 0; i < size / sizeof (*dirty); i++)
+        if (IntersectsBox(dirty[i], box))
+            return true;
+    return false;
+}
+
 static block_t *screen_Capture(demux_t *p_demux)
 {
     demux_sys_t *p_sys = static_cast<demux_sys_t*>(p_demux->p_sys);
@@ -81,18 +131,17 @@ static block_t *screen_Capture(demux_t *p_demux)
     };
     block_Init( &d3d11_block->self, &cbs, nullptr, 1 );
 
-    d3d11_block->d3d11_pic = D3D11_AllocPicture(VLC_OBJECT(p_demux),
-                                                &p_sys->fmt.video, p_data->vctx,
-                                                true, p_data->output_format);
-    if ( d3d11_block->d3d11_pic == nullptr )
-    {
-        msg_Err(p_demux, "Failed to allocate the output texture");
-        goto error;
-    }
-
+    /* Do not wait for the desktop to change, if the last picture can be
+     * sent again */
     DXGI_OUTDUPL_FRAME_INFO frameInfo;
     HRESULT hr;
-    hr = p_data->duplication->AcquireNextFrame(1000, &frameInfo, &resource);
+    hr = p_data->duplication->AcquireNextFrame(p_data->last_pic ? 0 : 1000,
+                                               &frameInfo, &resource);
+    if (hr == DXGI_ERROR_WAIT_TIMEOUT && p_data->last_pic)
+    {
+        d3d11_block->d3d11_pic = picture_Hold(p_data->last_pic);
+        return &d3d11_block->self;
+    }
     if (FAILED(hr))
     {
         msg_Err(p_demux, "Failed to capture a frame. (hr=0x%lX)", hr);
@@ -110,14 +159,6 @@ static block_t *screen_Capture(demux_t *p_demux)
     }
 #endif // SCREEN_SUBSCREEN && !VLC_WINSTORE_APP
 
-    /* copy the texture into the block texture */
-    hr = resource.As(&d3d11res);
-    if (unlikely(FAILED(hr)))
-    {
-        msg_Err(p_demux, "Failed to get the texture. (hr=0x%lX)", hr);
-        goto error;
-    }
-    pic_sys = ActiveD3D11PictureSys(d3d11_block->d3d11_pic);
 #ifdef SCREEN_SUBSCREEN
     copyBox.left   = p_sys->i_left;
     copyBox.right  = copyBox.left + p_sys->i_width;
@@ -131,6 +172,36 @@ static block_t *screen_Capture(demux_t *p_demux)
 #endif // !SCREEN_SUBSCREEN
     copyBox.front = 0;
     copyBox.back = 1;
+
+    /* Static desktop: send the last picture again, without any copy */
+    if (p_data->last_pic &&
+        memcmp(&copyBox, &p_data->last_box, sizeof (copyBox)) == 0 &&
+        !IsDamaged(p_data, frameInfo, copyBox))
+    {
+        p_data->duplication->ReleaseFrame();
+        d3d11_block->d3d11_pic = picture_Hold(p_data->last_pic);
+        return &d3d11_block->self;
+    }
+
+    d3d11_block->d3d11_pic = D3D11_AllocPicture(VLC_OBJECT(p_demux),
+                                                &p_sys->fmt.video, p_data->vctx,
+                                                true, p_data->output_format);
+    if ( d3d11_block->d3d11_pic == nullptr )
+    {
+        msg_Err(p_demux, "Failed to allocate the output texture");
+        p_data->duplication->ReleaseFrame();
+        goto error;
+    }
+
+    /* copy the texture into the block texture */
+    hr = resource.As(&d3d11res);
+    if (unlikely(FAILED(hr)))
+    {
+        msg_Err(p_demux, "Failed to get the texture. (hr=0x%lX)", hr);
+        p_data->duplication->ReleaseFrame();
+        goto error;
+    }
+    pic_sys = ActiveD3D11PictureSys(d3d11_block->d3d11_pic);
     d3d11_device_lock( &d3d_dev->d3d_dev );
     d3d_dev->d3d_dev.d3dcontext->CopySubresourceRegion(
                                               pic_sys->resource[KNOWN_DXGI_INDEX], 0,
@@ -143,6 +214,11 @@ static block_t *screen_Capture(demux_t *p_demux)
 
     d3d11_device_unlock( &d3d_dev->d3d_dev );
 
+    if (p_data->last_pic)
+        picture_Release(p_data->last_pic);
+    p_data->last_pic = picture_Hold(d3d11_block->d3d11_pic);
+    p_data->last_box = copyBox;
+
     return &d3d11_block->self;
 error:
     if (d3d11_block->d3d11_pic)
@@ -25,58 +25,22 @@
 #endif
 
 #include "sdi.h"
-
-static inline uint32_t av_le2ne32(uint32_t val)
-{
-    union {
-        uint32_t v;
-        uint8_t b[4];
-    } u;
-    u.v = val;
-    return (u.b[0] << 0) | (u.b[1] << 8) | (u.b[2] << 16) | (u.b[3] << 24);
-}
+#include "../video_chroma/v210.h"
 
 void v210_convert(uint16_t *dst, const uint32_t *bytes, const int width, const int height)
 {
-    const int stride = ((width + 47) / 48) * 48 * 8 / 3 / 4;
+    const size_t stride = v210_LineSize(width);
+    const uint8_t *src = (const uint8_t *)bytes;
     uint16_t *y = &dst[0];
     uint16_t *u = &dst[width * height * 2 / 2];
     uint16_t *v = &dst[width * height * 3 / 2];
 
-#define READ_PIXELS(a, b, c)         \
-    do {                             \
-        val  = av_le2ne32(*src++);   \
-        *a++ =  val & 0x3FF;         \
-        *b++ = (val >> 10) & 0x3FF;  \
-        *c++ = (val >> 20) & 0x3FF;  \
-    } while (0)
-
     for (int h = 0; h < height; h++) {
-        const uint32_t *src = bytes;
-        uint32_t val = 0;
-        int w;
-        for (w = 0; w < width - 5; w += 6) {
-            READ_PIXELS(u, y, v);
-            READ_PIXELS(y, u, y);
-            READ_PIXELS(v, y, u);
-            READ_PIXELS(y, v, y);
-        }
-        if (w < width - 1) {
-            READ_PIXELS(u, y, v);
-
-            val  = av_le2ne32(*src++);
-            *y++ =  val & 0x3FF;
-        }
-        if (w < width - 3) {
-            *u++ = (val >> 10) & 0x3FF;
-            *y++ = (val >> 20) & 0x3FF;
-
-            val  = av_le2ne32(*src++);
-            *v++ =  val & 0x3FF;
-            *y++ = (val >> 10) & 0x3FF;
-        }
-
-        bytes += stride;
+        v210_UnpackLine(src, y, u, v, width);
+        src += stride;
+        y += width;
+        u += width / 2;
+        v += width / 2;
     }
 }
 
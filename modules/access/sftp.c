@@ -61,6 +61,10 @@ static void Close( vlc_object_t* );
 #define PRIVATEKEY_LONGTEXT N_("Private-key file used for SSH public key authentication. "\
         "Public-key file is assumed to be in the same directory with '.pub' appended. "\
         "If unset, standard key paths will be attempted (e.g. '~/.ssh/id_rsa').")
+#define READ_SIZE_TEXT N_("Read size")
+#define READ_SIZE_LONGTEXT N_("Size of the reads, in KiB. libssh2 keeps up " \
+        "to four times this amount of read requests in flight, so larger " \
+        "values hide the network latency at the cost of memory.")
 
 vlc_module_begin ()
     set_shortname( "SFTP" )
@@ -71,6 +75,8 @@ vlc_module_begin ()
     add_string( "sftp-user", NULL, USER_TEXT, USER_LONGTEXT )
     add_password("sftp-pwd", NULL, PASS_TEXT, PASS_LONGTEXT)
     add_loadfile("sftp-privatekey", NULL, PRIVATEKEY_TEXT, PRIVATEKEY_LONGTEXT)
+    add_integer_with_range( "sftp-read-size", 512, 32, 2048,
+                            READ_SIZE_TEXT, READ_SIZE_LONGTEXT )
     add_shortcut( "sftp" )
     set_callbacks( Open, Close )
 vlc_module_end ()
@@ -93,6 +99,13 @@ typedef struct
     LIBSSH2_SFTP_HANDLE* file;
     uint64_t filesize;
     char *psz_base_url;
+
+    /* Read buffer, p_buf[0] is at offset i_buf_offset in the file */
+    uint8_t *p_buf;
+    size_t i_buf_size;
+    size_t i_buf_len;
+    size_t i_buf_pos;
+    uint64_t i_buf_offset;
 } access_sys_t;
 
 static int AuthKeyAgent( stream_t *p_access, const char *psz_username )
@@ -530,6 +543,11 @@ static int Open( vlc_object_t* p_this )
         p_sys->file = libssh2_sftp_open( p_sys->sftp_session, psz_path, LIBSSH2_FXF_READ, 0 );
         p_sys->filesize = attributes.filesize;
 
+        p_sys->i_buf_size = var_InheritInteger( p_access, "sftp-read-size" ) * 1024;
+        p_sys->p_buf = vlc_obj_malloc( p_this, p_sys->i_buf_size );
+        if( !p_sys->p_buf )
+            goto error;
+
         ACCESS_SET_CALLBACKS( Read, NULL, Control, Seek );
     }
     else
@@ -589,18 +607,34 @@ static void Close( vlc_object_t* p_this )
 }
 
 
+/* libssh2 pipelines the read requests according to the size of the buffer
+ * given to libssh2_sftp_read(), hence the reads through a large buffer even
+ * if the caller asks for less. */
 static ssize_t Read( stream_t *p_access, void *buf, size_t len )
 {
     access_sys_t *p_sys = p_access->p_sys;
 
-    ssize_t val = libssh2_sftp_read(  p_sys->file, buf, len );
-    if( val < 0 )
+    if( p_sys->i_buf_pos == p_sys->i_buf_len )
     {
-        msg_Err( p_access, "read failed" );
-        return 0;
+        ssize_t val = libssh2_sftp_read( p_sys->file, (char *)p_sys->p_buf,
+                                         p_sys->i_buf_size );
+        if( val < 0 )
+        {
+            msg_Err( p_access, "read failed" );
+            return 0;
+        }
+
+        p_sys->i_buf_offset += p_sys->i_buf_len;
+        p_sys->i_buf_len = val;
+        p_sys->i_buf_pos = 0;
     }
 
-    return val;
+    if( len > p_sys->i_buf_len - p_sys->i_buf_pos )
+        len = p_sys->i_buf_len - p_sys->i_buf_pos;
+
+    memcpy( buf, p_sys->p_buf + p_sys->i_buf_pos, len );
+    p_sys->i_buf_pos += len;
+    return len;
 }
 
 
@@ -608,7 +642,18 @@ static int Seek( stream_t* p_access, uint64_t i_pos )
 {
     access_sys_t *sys = p_access->p_sys;
 
-    libssh2_sftp_seek( sys->file, i_pos );
+    /* Seeking the handle drops the pending read requests: avoid it if the
+     * data is already buffered */
+    if( i_pos >= sys->i_buf_offset
+     && i_pos - sys->i_buf_offset <= sys->i_buf_len )
+    {
+        sys->i_buf_pos = i_pos - sys->i_buf_offset;
+        return VLC_SUCCESS;
+    }
+
+    libssh2_sftp_seek64( sys->file, i_pos );
+    sys->i_buf_offset = i_pos;
+    sys->i_buf_len = sys->i_buf_pos = 0;
     return VLC_SUCCESS;
 }
 
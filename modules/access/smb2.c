@@ -96,6 +96,14 @@ netbios_ns_interrupt_unregister(void)
 #include "smb_common.h"
 #include "cache.h"
 
+#define READ_DEPTH_TEXT N_("Outstanding read requests")
+#define READ_DEPTH_LONGTEXT N_("Number of read requests kept in flight " \
+    "ahead of the current position. Higher values hide the network " \
+    "latency at the cost of memory.")
+
+/* Maximum size of a single read request, see FileReadAhead() */
+#define SMB2_READ_CHUNK 262144
+
 static int Open(vlc_object_t *);
 static void Close(vlc_object_t *);
 
@@ -108,26 +116,14 @@ vlc_module_begin()
     add_string("smb-user", NULL, SMB_USER_TEXT, SMB_USER_LONGTEXT)
     add_password("smb-pwd", NULL, SMB_PASS_TEXT, SMB_PASS_LONGTEXT)
     add_string("smb-domain", NULL, SMB_DOMAIN_TEXT, SMB_DOMAIN_LONGTEXT)
+    add_integer_with_range("smb-read-depth", 4, 1, 16,
+                           READ_DEPTH_TEXT, READ_DEPTH_LONGTEXT)
     add_shortcut("smb", "smb2")
     set_callbacks(Open, Close)
 vlc_module_end()
 
 VLC_ACCESS_CACHE_REGISTER(smb2_cache);
 
-struct access_sys
-{
-    struct smb2_context *   smb2;
-    struct smb2fh *         smb2fh;
-    struct smb2dir *        smb2dir;
-    struct srvsvc_netshareenumall_rep *share_enum;
-    uint64_t                smb2_size;
-    vlc_url_t               encoded_url;
-    bool                    eof;
-    bool                    smb2_connected;
-
-    struct vlc_access_cache_entry *cache_entry;
-};
-
 struct vlc_smb2_op
 {
     struct vlc_logger *log;
@@ -147,6 +143,39 @@ struct vlc_smb2_op
     } res;
 };
 
+struct vlc_smb2_read
+{
+    struct vlc_smb2_op op;
+    uint8_t *buf;
+    uint64_t offset;
+    size_t size; /* requested size, the result is in op.res.read.len */
+};
+
+struct access_sys
+{
+    struct smb2_context *   smb2;
+    struct smb2fh *         smb2fh;
+    struct smb2dir *        smb2dir;
+    struct srvsvc_netshareenumall_rep *share_enum;
+    uint64_t                smb2_size;
+    vlc_url_t               encoded_url;
+    bool                    eof;
+    bool                    smb2_connected;
+
+    /* Ring of outstanding positional reads, from the current position */
+    struct vlc_smb2_read *  reads;
+    unsigned                read_depth;
+    unsigned                read_head;
+    unsigned                read_count;
+    size_t                  read_size; /* size of the requests */
+    uint64_t                read_next; /* offset of the next request */
+    uint64_t                pos;
+    uint64_t                hint_offset; /* range hinted by STREAM_SET_READ_HINT */
+    uint64_t                hint_end;
+
+    struct vlc_access_cache_entry *cache_entry;
+};
+
 #define VLC_SMB2_OP(access, smb2p_) { \
     .log = access ? vlc_object_logger(access) : NULL, \
     .smb2p = smb2p_, \
@@ -281,6 +310,94 @@ smb2_read_cb(struct smb2_context *smb2, int status, void *data,
     op->res.read.len = status;
 }
 
+static inline struct vlc_smb2_read *
+FileReadAt(struct access_sys *sys, unsigned i)
+{
+    return &sys->reads[(sys->read_head + i) % sys->read_depth];
+}
+
+static void
+FileReadPop(struct access_sys *sys)
+{
+    assert(sys->read_count > 0);
+    sys->read_head = (sys->read_head + 1) % sys->read_depth;
+    sys->read_count--;
+}
+
+/* Waits for all the outstanding reads, since their buffers are reused, and
+ * restarts reading at the given offset */
+static void
+FileReadFlush(stream_t *access, uint64_t offset)
+{
+    struct access_sys *sys = access->p_sys;
+
+    while (sys->read_count > 0)
+    {
+        /* Destroying the context on error completes the other requests */
+        if (sys->smb2 != NULL)
+            vlc_smb2_mainloop(&FileReadAt(sys, 0)->op);
+        FileReadPop(sys);
+    }
+    sys->read_next = offset;
+}
+
+static bool
+FileReadInWindow(const struct access_sys *sys, uint64_t offset)
+{
+    if (sys->read_count == 0)
+        return false;
+
+    const struct vlc_smb2_read *head = &sys->reads[sys->read_head];
+    return offset >= head->offset && offset < sys->read_next;
+}
+
+/* Keeps up to read_depth requests in flight. A request only completes once
+ * all its data is received, so a few medium sized requests in flight hide the
+ * round-trip time without delaying the first bytes. */
+static void
+FileReadAhead(stream_t *access)
+{
+    struct access_sys *sys = access->p_sys;
+
+    while (sys->read_count < sys->read_depth && sys->smb2 != NULL)
+    {
+        uint64_t end = sys->smb2_size;
+        size_t size = sys->read_size;
+
+        if (sys->read_count > 0)
+        {
+            /* Do not read ahead past the end of the file nor the end of the
+             * hinted range, until it is reached. The first request is always
+             * sent, in case the file grew. */
+            const struct vlc_smb2_read *head = &sys->reads[sys->read_head];
+            if (head->offset >= sys->hint_offset && head->offset < sys->hint_end
+             && sys->hint_end < end)
+                end = sys->hint_end;
+
+            if (sys->read_next >= end)
+                break;
+            if (size > end - sys->read_next)
+                size = end - sys->read_next;
+        }
+
+        struct vlc_smb2_read *rd = FileReadAt(sys, sys->read_count);
+        vlc_smb2_op_reset(&rd->op, &sys->smb2);
+        rd->op.res.read.len = 0;
+        rd->offset = sys->read_next;
+        rd->size = size;
+
+        int err = smb2_pread_async(sys->smb2, sys->smb2fh, rd->buf, size,
+                                   rd->offset, smb2_read_cb, &rd->op);
+        if (err < 0)
+        {
+            VLC_SMB2_SET_ERROR(&rd->op, "smb2_pread_async", err);
+            break;
+        }
+        sys->read_next += size;
+        sys->read_count++;
+    }
+}
+
 static ssize_t
 FileRead(stream_t *access, void *buf, size_t len)
 {
@@ -289,30 +406,53 @@ FileRead(stream_t *access, void *buf, size_t len)
     if (sys->eof || sys->smb2 == NULL)
         return 0;
 
-    /* Limit the read size since smb2_read_async() will complete only after
-     * reading the whole requested data and not when whatever data is available
-     * (high read size means a faster I/O but a higher latency). */
-    if (len > 262144)
-        len = 262144;
+    for (;;)
+    {
+        if (!FileReadInWindow(sys, sys->pos))
+            FileReadFlush(access, sys->pos);
 
-    struct vlc_smb2_op op = VLC_SMB2_OP(access, &sys->smb2);
-    op.res.read.len = 0;
+        FileReadAhead(access);
+        if (sys->smb2 == NULL)
+            break;
 
-    int err = smb2_read_async(sys->smb2, sys->smb2fh, buf, len,
-                              smb2_read_cb, &op);
-    if (err < 0)
-    {
-        VLC_SMB2_SET_ERROR(&op, "smb2_read_async", err);
-        return 0;
-    }
+        struct vlc_smb2_read *rd = FileReadAt(sys, 0);
+        if (vlc_smb2_mainloop(&rd->op) < 0)
+            break;
 
-    if (vlc_smb2_mainloop(&op) < 0)
-        return 0;
+        size_t rlen = rd->op.res.read.len;
+        if (rlen == 0)
+        {
+            FileReadFlush(access, sys->pos);
+            sys->eof = true;
+            return 0;
+        }
 
-    if (op.res.read.len == 0)
-        sys->eof = true;
+        assert(sys->pos >= rd->offset);
+        if (sys->pos - rd->offset < rlen)
+        {
+            size_t offset = sys->pos - rd->offset;
+            if (len > rlen - offset)
+                len = rlen - offset;
 
-    return op.res.read.len;
+            memcpy(buf, rd->buf + offset, len);
+            sys->pos += len;
+            return len;
+        }
+
+        /* The server may cap the size of the reads: use smaller requests
+         * from now on. The next request starts past the position and the
+         * window is flushed. */
+        if (rlen < rd->size && rd->offset + rlen < sys->smb2_size)
+        {
+            msg_Dbg(access, "short read, using %zu bytes requests", rlen);
+            sys->read_size = rlen;
+        }
+        FileReadPop(sys);
+    }
+
+    /* The context is gone: the callbacks of the pending requests ran */
+    sys->read_count = 0;
+    return 0;
 }
 
 static int
@@ -330,19 +470,37 @@ FileSeek(stream_t *access, uint64_t i_pos)
         return VLC_EGENERIC;
     }
 
-    struct vlc_smb2_op op = VLC_SMB2_OP(access, &sys->smb2);
+    /* Keep the outstanding reads if the new position is within them */
+    if (!FileReadInWindow(sys, i_pos))
+        FileReadFlush(access, i_pos);
 
-    int64_t err = smb2_lseek(op.smb2, sys->smb2fh, i_pos, SEEK_SET, NULL);
-    if (err < 0)
-    {
-        VLC_SMB2_SET_ERROR(&op, "smb2_lseek", err);
-        return err;
-    }
+    if (sys->smb2 == NULL)
+        return VLC_EGENERIC;
+
+    sys->pos = i_pos;
     sys->eof = false;
 
     return VLC_SUCCESS;
 }
 
+static void
+FileSetReadHint(stream_t *access, uint64_t offset, uint64_t length)
+{
+    struct access_sys *sys = access->p_sys;
+
+    sys->hint_offset = offset;
+    sys->hint_end = length < UINT64_MAX - offset ? offset + length : UINT64_MAX;
+
+    /* Prefetch the hinted range right away, so that the data is already in
+     * flight when the demuxer seeks there. */
+    if (sys->smb2 == NULL || FileReadInWindow(sys, offset)
+     || offset >= sys->smb2_size)
+        return;
+
+    FileReadFlush(access, offset);
+    FileReadAhead(access);
+}
+
 static int
 FileControl(stream_t *access, int i_query, va_list args)
 {
@@ -377,6 +535,15 @@ FileControl(stream_t *access, int i_query, va_list args)
         case STREAM_SET_PAUSE_STATE:
             break;
 
+        case STREAM_SET_READ_HINT:
+        {
+            uint64_t offset = va_arg(args, uint64_t);
+            uint64_t length = va_arg(args, uint64_t);
+
+            FileSetReadHint(access, offset, length);
+            break;
+        }
+
         default:
             return VLC_EGENERIC;
     }
@@ -847,6 +1014,23 @@ Open(vlc_object_t *p_obj)
     if (sys->encoded_url.psz_path == NULL)
         sys->encoded_url.psz_path = (char *) "/";
 
+    /* Allocated before connecting, as this cannot fail afterwards */
+    sys->read_depth = var_InheritInteger(access, "smb-read-depth");
+    sys->read_size = SMB2_READ_CHUNK;
+    sys->reads = vlc_obj_calloc(p_obj, sys->read_depth, sizeof (*sys->reads));
+    uint8_t *read_buf = vlc_obj_malloc(p_obj,
+                                       sys->read_depth * SMB2_READ_CHUNK);
+    if (unlikely(sys->reads == NULL || read_buf == NULL))
+    {
+        vlc_UrlClean(&sys->encoded_url);
+        return VLC_ENOMEM;
+    }
+    for (unsigned i = 0; i < sys->read_depth; i++)
+    {
+        sys->reads[i].op.log = vlc_object_logger(access);
+        sys->reads[i].buf = read_buf + i * SMB2_READ_CHUNK;
+    }
+
     char *resolved_host = NULL;
     ret = vlc_smb2_resolve(access, sys->encoded_url.psz_host,
                            sys->encoded_url.i_port, &resolved_host);
@@ -940,6 +1124,14 @@ Open(vlc_object_t *p_obj)
     else
         vlc_assert_unreachable();
 
+    if (sys->smb2fh == NULL)
+    {
+        /* The read buffers are only used by files */
+        vlc_obj_free(p_obj, sys->reads[0].buf);
+        vlc_obj_free(p_obj, sys->reads);
+        sys->reads = NULL;
+    }
+
     free(var_domain);
     return VLC_SUCCESS;
 
@@ -963,6 +1155,7 @@ Close(vlc_object_t *p_obj)
 
     if (sys->smb2fh != NULL)
     {
+        FileReadFlush(access, 0);
         if (sys->smb2)
             vlc_smb2_close_fh(access, &sys->smb2, sys->smb2fh);
     }
@@ -42,6 +42,7 @@ typedef struct
     char       *psz_host;
     int         i_port;
     int         i_chunks; /* Number of chunks to allocate in the next read */
+    srt_stats_t stats;
 } stream_sys_t;
 
 
@@ -167,6 +168,7 @@ static bool srt_schedule_reconnect(stream_t *p_stream)
         &(int) { 0 }, sizeof( int ) );
 
     /* Set latency */
+    i_latency = srt_auto_latency( strm_obj, &p_sys->stats, i_latency );
     srt_set_socket_option( strm_obj, SRT_PARAM_LATENCY, p_sys->sock,
             SRTO_LATENCY, &i_latency, sizeof(i_latency) );
 
@@ -319,6 +321,9 @@ static block_t *BlockSRT(stream_t *p_stream, bool *restrict eof)
             }
         }
 
+        srt_stats_update( VLC_OBJECT(p_stream), &p_sys->stats, p_sys->sock,
+                          false );
+
         goto out;
     }
 
@@ -376,6 +381,8 @@ static int Open(vlc_object_t *p_this)
 
     vlc_UrlClean( &parsed_url );
 
+    srt_stats_init( p_this, &p_sys->stats );
+
     p_sys->i_poll_id = srt_epoll_create();
     if ( p_sys->i_poll_id == -1 )
     {
@@ -437,6 +444,8 @@ vlc_module_begin ()
     add_string(SRT_PARAM_STREAMID, "",
             N_(" SRT Stream ID"), NULL)
     change_safe()
+    add_bool( SRT_PARAM_LATENCY_AUTO, false, SRT_LATENCY_AUTO_TEXT,
+            SRT_LATENCY_AUTO_LONGTEXT )
 
     set_capability("access", 0)
     add_shortcut("srt")
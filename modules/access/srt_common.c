@@ -170,3 +170,74 @@ int srt_set_socket_option(vlc_object_t *this, const char *srt_param,
     return stat;
 }
 
+
+
+void srt_stats_init(vlc_object_t *obj, srt_stats_t *stats)
+{
+    stats->next_update = VLC_TICK_INVALID;
+    stats->rtt = 0.;
+
+    var_Create( obj, "srt-rtt", VLC_VAR_FLOAT );
+    var_Create( obj, "srt-bandwidth", VLC_VAR_FLOAT );
+    var_Create( obj, "srt-rate", VLC_VAR_FLOAT );
+    var_Create( obj, "srt-lost", VLC_VAR_INTEGER );
+    var_Create( obj, "srt-retransmitted", VLC_VAR_INTEGER );
+    var_Create( obj, "srt-dropped", VLC_VAR_INTEGER );
+    var_Create( obj, "srt-buffer", VLC_VAR_INTEGER );
+}
+
+void srt_stats_update(vlc_object_t *obj, srt_stats_t *stats, SRTSOCKET u,
+        bool sender)
+{
+    vlc_tick_t now = vlc_tick_now();
+    SRT_TRACEBSTATS perf;
+
+    if (stats->next_update != VLC_TICK_INVALID && now < stats->next_update)
+        return;
+    stats->next_update = now + SRT_STATS_INTERVAL;
+
+    if (srt_bstats( u, &perf, 0 ) == SRT_ERROR)
+        return;
+
+    if (perf.msRTT > 0.)
+        stats->rtt = perf.msRTT;
+
+    var_SetFloat( obj, "srt-rtt", perf.msRTT );
+    var_SetFloat( obj, "srt-bandwidth", perf.mbpsBandwidth );
+    if (sender) {
+        var_SetFloat( obj, "srt-rate", perf.mbpsSendRate );
+        var_SetInteger( obj, "srt-lost", perf.pktSndLossTotal );
+        var_SetInteger( obj, "srt-retransmitted", perf.pktRetransTotal );
+        var_SetInteger( obj, "srt-dropped", perf.pktSndDropTotal );
+        var_SetInteger( obj, "srt-buffer", perf.msSndBuf );
+    } else {
+        var_SetFloat( obj, "srt-rate", perf.mbpsRecvRate );
+        var_SetInteger( obj, "srt-lost", perf.pktRcvLossTotal );
+        var_SetInteger( obj, "srt-retransmitted", perf.pktRcvRetransTotal );
+        var_SetInteger( obj, "srt-dropped", perf.pktRcvDropTotal );
+        var_SetInteger( obj, "srt-buffer", perf.msRcvBuf );
+    }
+
+    msg_Dbg( obj, "SRT stats: RTT %.1f ms, link %.2f Mbit/s, rate %.2f Mbit/s,"
+             " lost %"PRId64", retransmitted %"PRId64", dropped %"PRId64,
+             perf.msRTT, perf.mbpsBandwidth,
+             sender ? perf.mbpsSendRate : perf.mbpsRecvRate,
+             (int64_t)var_GetInteger( obj, "srt-lost" ),
+             (int64_t)var_GetInteger( obj, "srt-retransmitted" ),
+             (int64_t)var_GetInteger( obj, "srt-dropped" ) );
+}
+
+int srt_auto_latency(vlc_object_t *obj, const srt_stats_t *stats,
+        int latency)
+{
+    if (!var_InheritBool( obj, SRT_PARAM_LATENCY_AUTO ) || stats->rtt <= 0.)
+        return latency;
+
+    int rtt_latency = SRT_LATENCY_RTT_FACTOR * stats->rtt + .5;
+    if (rtt_latency > latency) {
+        msg_Dbg( obj, "Raising latency from %d to %d ms (RTT %.1f ms)",
+                 latency, rtt_latency, stats->rtt );
+        latency = rtt_latency;
+    }
+    return latency;
+}
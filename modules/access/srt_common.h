@@ -40,6 +40,7 @@
 #define SRT_PARAM_POLL_TIMEOUT                "poll-timeout"
 #define SRT_PARAM_KEY_LENGTH                  "key-length"
 #define SRT_PARAM_STREAMID                    "streamid"
+#define SRT_PARAM_LATENCY_AUTO                "latency-auto"
 
 
 #define SRT_DEFAULT_BANDWIDTH_OVERHEAD_LIMIT 25
@@ -60,6 +61,16 @@
 #define SRT_KEY_LENGTH_TEXT N_("Crypto key length in bytes")
 #define SRT_DEFAULT_KEY_LENGTH 16
 static const int srt_key_lengths[] = { 16, 24, 32, };
+/* Automatic latency */
+#define SRT_LATENCY_AUTO_TEXT N_("Automatic latency")
+#define SRT_LATENCY_AUTO_LONGTEXT N_( \
+    "Use a latency of several times the round-trip time measured on the " \
+    "previous connection when reconnecting, if it is larger than the " \
+    "configured latency." )
+/* Latency per round-trip time, as recommended for links with low losses */
+#define SRT_LATENCY_RTT_FACTOR 4
+/* Statistics update period */
+#define SRT_STATS_INTERVAL VLC_TICK_FROM_SEC(1)
 
 extern const char * const srt_key_length_names[];
 
@@ -72,9 +83,36 @@ typedef struct srt_params {
     const char* streamid;
 } srt_params_t;
 
+typedef struct srt_stats {
+    vlc_tick_t next_update;
+    double rtt; /* last round-trip time in ms, 0 if not measured yet */
+} srt_stats_t;
+
 bool srt_parse_url(char* url, srt_params_t* params);
 
 int srt_set_socket_option(vlc_object_t *this, const char *srt_param,
         SRTSOCKET u, SRT_SOCKOPT opt, const void *optval, int optlen);
 
+/**
+ * Creates the statistics variables of the object.
+ *
+ * The variables are "srt-rtt" (ms), "srt-bandwidth" (Mbit/s, estimated link
+ * capacity), "srt-rate" (Mbit/s), "srt-lost", "srt-retransmitted" and
+ * "srt-dropped" (packets since the connection) and "srt-buffer" (ms of data
+ * in the send or receive buffer).
+ */
+void srt_stats_init(vlc_object_t *obj, srt_stats_t *stats);
+
+/**
+ * Updates the statistics variables, at most once per SRT_STATS_INTERVAL.
+ */
+void srt_stats_update(vlc_object_t *obj, srt_stats_t *stats, SRTSOCKET u,
+        bool sender);
+
+/**
+ * Gets the latency to use for the next connection.
+ */
+int srt_auto_latency(vlc_object_t *obj, const srt_stats_t *stats,
+        int latency);
+
 #endif
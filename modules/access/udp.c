@@ -47,15 +47,37 @@
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
+#ifdef HAVE_LINUX_IO_URING_H
+# include <errno.h>
+# include <limits.h>
+# include "udp_uring.h"
+#endif
 
 /* Buffer can be max theoretical datagram content minus anticipated MTU.
  * IPv6 headers are larger than IPv4, ignore IPv6 jumbograms.
  */
 #define MRU 65507u
 
+/* Number of datagram buffers kept queued in the io_uring receive ring */
+#define URING_SLOTS 32
+
+/* Maximum number of datagrams received per recvmmsg() call */
+#define BATCH 16
+
 typedef struct {
     int fd;
     int timeout;
+#ifdef HAVE_LINUX_IO_URING_H
+    struct udp_uring *ring;
+    unsigned slot; /**< ring buffer of the residual data, or UINT_MAX */
+#endif
+#ifdef HAVE_RECVMMSG
+    char *batch; /**< buffers for the datagrams after the first one */
+    unsigned count; /**< number of datagrams in the last batch */
+    unsigned next; /**< next datagram to read from the last batch */
+    struct mmsghdr msgs[BATCH];
+    struct iovec iov[BATCH + 1];
+#endif
 
     size_t length;
     char *offset;
@@ -83,19 +105,115 @@ static int Control(stream_t *access, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+static ssize_t ReadResidual(access_sys_t *sys, void *buf, size_t len)
+{
+    if (len > sys->length)
+        len = sys->length;
+
+    memcpy(buf, sys->offset, len);
+    sys->offset += len;
+    sys->length -= len;
+#ifdef HAVE_LINUX_IO_URING_H
+    if (sys->length == 0 && sys->slot != UINT_MAX) {
+        udp_uring_Release(sys->ring, sys->slot);
+        sys->slot = UINT_MAX;
+    }
+#endif
+    return len;
+}
+
+#ifdef HAVE_LINUX_IO_URING_H
+static ssize_t ReadRing(stream_t *access, void *buf, size_t len)
+{
+    access_sys_t *sys = access->p_sys;
+    char *data;
+    unsigned slot;
+    ssize_t val;
+
+    while ((val = udp_uring_Next(sys->ring, &data, &slot)) < 0) {
+        if (errno != EAGAIN)
+            return -1;
+
+        struct pollfd ufd[1];
+
+        ufd[0].fd = udp_uring_GetFD(sys->ring);
+        ufd[0].events = POLLIN;
+
+        switch (vlc_poll_i11e(ufd, 1, sys->timeout)) {
+            case 0:
+                msg_Err(access, "receive time-out");
+                return 0;
+            case -1:
+                return -1;
+        }
+    }
+
+    sys->offset = data;
+    sys->length = val;
+    sys->slot = slot;
+
+    if (val == 0) { /* empty payload */
+        udp_uring_Release(sys->ring, slot);
+        sys->slot = UINT_MAX;
+        return -1;
+    }
+    return ReadResidual(sys, buf, len);
+}
+#endif
+
+#ifdef HAVE_RECVMMSG
+static ssize_t ReadBatch(access_sys_t *sys, void *buf, size_t len)
+{
+    /* The first datagram is received directly into the caller buffer,
+     * the overflow and any further datagrams are queued. */
+    sys->iov[0].iov_base = buf;
+    sys->iov[0].iov_len = len;
+
+    int n = recvmmsg(sys->fd, sys->msgs, BATCH, MSG_WAITFORONE, NULL);
+    if (n <= 0)
+        return -1;
+
+    sys->count = n;
+    sys->next = 1;
+
+    ssize_t val = sys->msgs[0].msg_len;
+
+    if (val == 0) /* empty (0 bytes) payload does *not* mean EOF here */
+        return -1;
+
+    if (unlikely((size_t)val > len)) {
+        sys->offset = sys->buf;
+        sys->length = val - len;
+        val = len;
+    }
+    return val;
+}
+#endif
+
 static ssize_t Read(stream_t *access, void *buf, size_t len)
 {
     access_sys_t *sys = access->p_sys;
 
-    if (sys->length > 0) {
-        if (len > sys->length)
-            len = sys->length;
+    if (sys->length > 0)
+        return ReadResidual(sys, buf, len);
+
+#ifdef HAVE_RECVMMSG
+    if (sys->next < sys->count) {
+        const struct mmsghdr *msg = &sys->msgs[sys->next++];
 
-        memcpy(buf, sys->offset, len);
-        sys->offset += len;
-        sys->length -= len;
-        return len;
+        if (msg->msg_len == 0)
+            return -1;
+
+        sys->offset = msg->msg_hdr.msg_iov[0].iov_base;
+        sys->length = msg->msg_len;
+        return ReadResidual(sys, buf, len);
     }
+#endif
+
+#ifdef HAVE_LINUX_IO_URING_H
+    if (sys->ring != NULL)
+        return ReadRing(access, buf, len);
+#endif
 
     struct pollfd ufd[1];
 
@@ -110,6 +228,11 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
             return -1;
     }
 
+#ifdef HAVE_RECVMMSG
+    if (sys->batch != NULL)
+        return ReadBatch(sys, buf, len);
+#endif
+
     struct iovec iov[] = {
         { .iov_base = buf,      .iov_len = len, },
         { .iov_base = sys->buf, .iov_len = MRU, },
@@ -213,10 +336,42 @@ static int Open( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
+#ifdef HAVE_RECVMMSG
+    sys->count = sys->next = 0;
+    sys->batch = malloc( (BATCH - 1) * MRU );
+    if( sys->batch != NULL )
+    {
+        memset( sys->msgs, 0, sizeof (sys->msgs) );
+        sys->iov[1].iov_base = sys->buf;
+        sys->iov[1].iov_len = MRU;
+        sys->msgs[0].msg_hdr.msg_iov = sys->iov;
+        sys->msgs[0].msg_hdr.msg_iovlen = 2;
+
+        for( unsigned i = 1; i < BATCH; i++ )
+        {
+            sys->iov[i + 1].iov_base = sys->batch + (i - 1) * MRU;
+            sys->iov[i + 1].iov_len = MRU;
+            sys->msgs[i].msg_hdr.msg_iov = &sys->iov[i + 1];
+            sys->msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+#endif
+
     sys->timeout = var_InheritInteger( p_access, "udp-timeout");
     if( sys->timeout > 0)
         sys->timeout *= 1000;
 
+#ifdef HAVE_LINUX_IO_URING_H
+    sys->ring = NULL;
+    sys->slot = UINT_MAX;
+    if( var_InheritBool( p_access, "udp-io-uring" ) )
+    {
+        sys->ring = udp_uring_Create( sys->fd, URING_SLOTS, MRU );
+        if( sys->ring == NULL )
+            msg_Warn( p_access, "io_uring not available: %s",
+                      vlc_strerror_c(errno) );
+    }
+#endif
     return VLC_SUCCESS;
 }
 
@@ -228,10 +383,21 @@ static void Close( vlc_object_t *p_this )
     stream_t     *p_access = (stream_t*)p_this;
     access_sys_t *sys = p_access->p_sys;
 
+#ifdef HAVE_LINUX_IO_URING_H
+    if( sys->ring != NULL )
+        udp_uring_Destroy( sys->ring );
+#endif
+#ifdef HAVE_RECVMMSG
+    free( sys->batch );
+#endif
     net_Close( sys->fd );
 }
 
 #define TIMEOUT_TEXT N_("UDP Source timeout (sec)")
+#define URING_TEXT N_("Use io_uring for receiving")
+#define URING_LONGTEXT N_( \
+    "Keep a ring of receive buffers queued in the kernel with io_uring, " \
+    "so that datagrams are received in batches with fewer system calls.")
 
 vlc_module_begin()
     set_shortname(N_("UDP"))
@@ -240,6 +406,9 @@ vlc_module_begin()
 
     add_obsolete_integer("udp-buffer") /* since 3.0.0 */
     add_integer("udp-timeout", -1, TIMEOUT_TEXT, NULL)
+#ifdef HAVE_LINUX_IO_URING_H
+    add_bool("udp-io-uring", false, URING_TEXT, URING_LONGTEXT)
+#endif
 
     set_capability("access", 0)
     add_shortcut("udp", "udpstream", "udp4", "udp6")
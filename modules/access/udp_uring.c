@@ -0,0 +1,386 @@
+/*****************************************************************************
+ * udp_uring.c: io_uring datagram receive ring
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef HAVE_LINUX_IO_URING_H
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include <vlc_common.h>
+#include <vlc_fs.h>
+
+#include "udp_uring.h"
+
+#ifdef __NR_io_uring_setup
+struct udp_uring
+{
+    int fd; /**< ring file descriptor */
+    int sock;
+    unsigned slots;
+    size_t mru;
+    char *bufs;
+    bool fixed; /**< whether buffers are registered */
+    unsigned to_submit;
+    unsigned inflight; /**< reads owned by the kernel */
+
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+
+    _Atomic unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned *sq_array;
+    _Atomic unsigned *cq_head;
+    _Atomic unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+};
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                              unsigned flags)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                   NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void *arg,
+                                 unsigned nr)
+{
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nr);
+}
+
+/* Tag of the cancellation requests completions */
+#define UDP_URING_CANCEL UINT64_MAX
+
+static void udp_uring_Push(struct udp_uring *r, const struct io_uring_sqe *sqe)
+{
+    /* Only this thread writes the tail */
+    unsigned tail = atomic_load_explicit(r->sq_tail, memory_order_relaxed);
+    unsigned index = tail & r->sq_mask;
+
+    r->sqes[index] = *sqe;
+    r->sq_array[index] = index;
+
+    atomic_store_explicit(r->sq_tail, tail + 1, memory_order_release);
+    r->to_submit++;
+}
+
+static void udp_uring_Queue(struct udp_uring *r, unsigned slot)
+{
+    struct io_uring_sqe sqe;
+
+    memset(&sqe, 0, sizeof (sqe));
+    sqe.opcode = r->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe.fd = r->sock;
+    sqe.addr = (uintptr_t)(r->bufs + slot * r->mru);
+    sqe.len = r->mru;
+    sqe.buf_index = r->fixed ? slot : 0;
+    sqe.user_data = slot;
+    udp_uring_Push(r, &sqe);
+}
+
+void udp_uring_Release(struct udp_uring *r, unsigned slot)
+{
+    udp_uring_Queue(r, slot);
+}
+
+static int udp_uring_Submit(struct udp_uring *r)
+{
+    while (r->to_submit > 0)
+    {
+        int val = sys_io_uring_enter(r->fd, r->to_submit, 0, 0);
+        if (val < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        r->to_submit -= val;
+        r->inflight += val;
+    }
+    return 0;
+}
+
+ssize_t udp_uring_Next(struct udp_uring *r, char **bufp, unsigned *slotp)
+{
+    for (;;)
+    {
+        unsigned head = atomic_load_explicit(r->cq_head, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(r->cq_tail, memory_order_acquire);
+
+        if (head == tail)
+        {   /* Nothing received: submit the released buffers (if any) */
+            if (udp_uring_Submit(r))
+                return -1;
+            errno = EAGAIN;
+            return -1;
+        }
+
+        const struct io_uring_cqe *cqe = &r->cqes[head & r->cq_mask];
+        unsigned slot = cqe->user_data;
+        int res = cqe->res;
+
+        atomic_store_explicit(r->cq_head, head + 1, memory_order_release);
+        r->inflight--;
+
+        if (res < 0)
+        {
+            udp_uring_Queue(r, slot);
+            if (res == -EINTR || res == -EAGAIN)
+                continue;
+            errno = -res;
+            return -1;
+        }
+
+        *bufp = r->bufs + slot * r->mru;
+        *slotp = slot;
+        return res;
+    }
+}
+
+int udp_uring_GetFD(const struct udp_uring *r)
+{
+    return r->fd;
+}
+
+static void udp_uring_Unmap(struct udp_uring *r)
+{
+    if (r->sqes != NULL)
+        munmap(r->sqes, r->sqes_size);
+    if (r->cq_ring != NULL && r->cq_ring != r->sq_ring)
+        munmap(r->cq_ring, r->cq_ring_size);
+    if (r->sq_ring != NULL)
+        munmap(r->sq_ring, r->sq_ring_size);
+}
+
+struct udp_uring *udp_uring_Create(int sock, unsigned slots, size_t mru)
+{
+    struct udp_uring *r = calloc(1, sizeof (*r));
+    if (unlikely(r == NULL))
+        return NULL;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof (params));
+
+    r->fd = sys_io_uring_setup(slots, &params);
+    if (r->fd == -1)
+    {
+        free(r);
+        return NULL;
+    }
+    r->sock = sock;
+    r->slots = slots;
+    r->mru = mru;
+
+    r->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+    r->cq_ring_size = params.cq_off.cqes
+                    + params.cq_entries * sizeof (struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        r->sq_ring_size = r->cq_ring_size =
+            __MAX(r->sq_ring_size, r->cq_ring_size);
+
+    r->sq_ring = mmap(NULL, r->sq_ring_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ring == MAP_FAILED)
+    {
+        r->sq_ring = NULL;
+        goto error;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        r->cq_ring = r->sq_ring;
+    else
+    {
+        r->cq_ring = mmap(NULL, r->cq_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_ring == MAP_FAILED)
+        {
+            r->cq_ring = NULL;
+            goto error;
+        }
+    }
+
+    r->sqes_size = params.sq_entries * sizeof (struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED)
+    {
+        r->sqes = NULL;
+        goto error;
+    }
+
+    char *sq = r->sq_ring, *cq = r->cq_ring;
+    r->sq_tail = (_Atomic unsigned *)(sq + params.sq_off.tail);
+    r->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + params.sq_off.array);
+    r->cq_head = (_Atomic unsigned *)(cq + params.cq_off.head);
+    r->cq_tail = (_Atomic unsigned *)(cq + params.cq_off.tail);
+    r->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    r->bufs = mmap(NULL, slots * mru, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (r->bufs == MAP_FAILED)
+    {
+        r->bufs = NULL;
+        goto error;
+    }
+
+    /* Registered buffers are pinned, and can exceed the locked memory limit.
+     * Fall back to plain reads in that case. */
+    struct iovec *iov = vlc_alloc(slots, sizeof (*iov));
+    if (likely(iov != NULL))
+    {
+        for (unsigned i = 0; i < slots; i++)
+        {
+            iov[i].iov_base = r->bufs + i * mru;
+            iov[i].iov_len = mru;
+        }
+        r->fixed = sys_io_uring_register(r->fd, IORING_REGISTER_BUFFERS,
+                                         iov, slots) == 0;
+        free(iov);
+    }
+
+    for (unsigned i = 0; i < slots; i++)
+        udp_uring_Queue(r, i);
+    if (udp_uring_Submit(r))
+        goto error;
+    return r;
+
+error:
+    udp_uring_Destroy(r);
+    return NULL;
+}
+
+/**
+ * Cancels the pending reads and waits for the kernel to complete them.
+ *
+ * Closing the ring only cancels the reads asynchronously, and the kernel
+ * could still write to the buffers afterwards.
+ *
+ * \return 0 once the kernel owns no buffers, -1 on error
+ */
+static int udp_uring_Drain(struct udp_uring *r)
+{
+    /* Released buffers must leave the submission queue first */
+    if (udp_uring_Submit(r))
+        return -1;
+
+    for (unsigned i = 0; i < r->slots; i++)
+    {
+        struct io_uring_sqe sqe;
+
+        memset(&sqe, 0, sizeof (sqe));
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.addr = i;
+        sqe.user_data = UDP_URING_CANCEL;
+        udp_uring_Push(r, &sqe);
+    }
+    /* Cancellations do not own buffers */
+    unsigned inflight = r->inflight;
+    int ret = udp_uring_Submit(r);
+    r->inflight = inflight;
+    if (ret)
+        return -1;
+
+    while (r->inflight > 0)
+    {
+        unsigned head = atomic_load_explicit(r->cq_head, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(r->cq_tail, memory_order_acquire);
+
+        if (head == tail)
+        {
+            if (sys_io_uring_enter(r->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0
+             && errno != EINTR)
+                return -1;
+            continue;
+        }
+
+        if (r->cqes[head & r->cq_mask].user_data != UDP_URING_CANCEL)
+            r->inflight--;
+        atomic_store_explicit(r->cq_head, head + 1, memory_order_release);
+    }
+    return 0;
+}
+
+void udp_uring_Destroy(struct udp_uring *r)
+{
+    /* If the reads cannot be reaped, leak the buffers rather than let the
+     * kernel write to unmapped (or reused) memory. */
+    if (r->sqes != NULL && r->inflight > 0 && udp_uring_Drain(r))
+        r->bufs = NULL;
+
+    vlc_close(r->fd);
+    udp_uring_Unmap(r);
+    if (r->bufs != NULL)
+        munmap(r->bufs, r->slots * r->mru);
+    free(r);
+}
+
+#else /* !__NR_io_uring_setup */
+struct udp_uring *udp_uring_Create(int sock, unsigned slots, size_t mru)
+{
+    VLC_UNUSED(sock); VLC_UNUSED(slots); VLC_UNUSED(mru);
+    return NULL;
+}
+
+void udp_uring_Destroy(struct udp_uring *r)
+{
+    VLC_UNUSED(r);
+    vlc_assert_unreachable();
+}
+
+int udp_uring_GetFD(const struct udp_uring *r)
+{
+    VLC_UNUSED(r);
+    vlc_assert_unreachable();
+}
+
+ssize_t udp_uring_Next(struct udp_uring *r, char **bufp, unsigned *slotp)
+{
+    VLC_UNUSED(r); VLC_UNUSED(bufp); VLC_UNUSED(slotp);
+    vlc_assert_unreachable();
+}
+
+void udp_uring_Release(struct udp_uring *r, unsigned slot)
+{
+    VLC_UNUSED(r); VLC_UNUSED(slot);
+    vlc_assert_unreachable();
+}
+#endif
+#endif /* HAVE_LINUX_IO_URING_H */
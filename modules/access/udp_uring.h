@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * udp_uring.h: io_uring datagram receive ring
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_ACCESS_UDP_URING_H
+#define VLC_ACCESS_UDP_URING_H
+
+/**
+ * Datagram receive ring
+ *
+ * A fixed number of receive buffers, registered with the kernel, are kept
+ * queued for reading on a datagram socket. Received datagrams are reaped in
+ * batches and their buffer is queued again once released, so that only one
+ * system call is needed per batch of datagrams.
+ */
+struct udp_uring;
+
+/**
+ * Creates a receive ring.
+ *
+ * \param fd datagram socket
+ * \param slots number of receive buffers
+ * \param mru size of each receive buffer
+ * \return the ring, or NULL if io_uring is not available
+ */
+struct udp_uring *udp_uring_Create(int fd, unsigned slots, size_t mru);
+
+void udp_uring_Destroy(struct udp_uring *);
+
+/**
+ * Gets the file descriptor to poll for completed receptions.
+ */
+int udp_uring_GetFD(const struct udp_uring *);
+
+/**
+ * Gets the next received datagram.
+ *
+ * \param bufp pointer to the datagram payload [OUT]
+ * \param slotp buffer index to release with udp_uring_Release() [OUT]
+ * \return the datagram length, -1 with errno set on error, or -1 with
+ * errno set to EAGAIN if no datagrams were received yet
+ */
+ssize_t udp_uring_Next(struct udp_uring *, char **bufp, unsigned *slotp);
+
+/**
+ * Queues a receive buffer for reading again.
+ *
+ * The buffer is only submitted to the kernel by the next udp_uring_Next()
+ * call that finds no received datagrams.
+ */
+void udp_uring_Release(struct udp_uring *, unsigned slot);
+
+#endif
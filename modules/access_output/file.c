@@ -57,14 +57,51 @@
 
 #define SOUT_CFG_PREFIX "sout-file-"
 
+typedef struct
+{
+    int fd;
+
+    /* Write-behind buffer of regular files, coalescing the small writes
+     * of the muxers into large sequential ones */
+    uint8_t *buf;
+    size_t   buf_size;
+    size_t   buf_used;
+} sout_access_out_sys_t;
+
+static int Flush( sout_access_out_t *p_access )
+{
+    sout_access_out_sys_t *sys = p_access->p_sys;
+    size_t done = 0;
+
+    while (done < sys->buf_used)
+    {
+        ssize_t val = write(sys->fd, sys->buf + done, sys->buf_used - done);
+        if (val <= 0)
+        {
+            if (errno == EINTR)
+                continue;
+            msg_Err( p_access, "cannot write: %s", vlc_strerror_c(errno) );
+            sys->buf_used = 0;
+            return -1;
+        }
+        done += val;
+    }
+    sys->buf_used = 0;
+    return 0;
+}
+
 /*****************************************************************************
  * Read: standard read on a file descriptor.
  *****************************************************************************/
 static ssize_t Read( sout_access_out_t *p_access, block_t *p_buffer )
 {
-    int *fdp = p_access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = p_access->p_sys;
+    int fd = sys->fd;
     ssize_t val;
 
+    if (sys->buf_used > 0 && Flush(p_access))
+        return -1;
+
     do
         val = read(fd, p_buffer->p_buffer, p_buffer->i_buffer);
     while (val == -1 && errno == EINTR);
@@ -76,7 +113,8 @@ static ssize_t Read( sout_access_out_t *p_access, block_t *p_buffer )
  *****************************************************************************/
 static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
 {
-    int *fdp = p_access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = p_access->p_sys;
+    int fd = sys->fd;
     size_t i_write = 0;
 
     while( p_buffer )
@@ -107,9 +145,48 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
     return i_write;
 }
 
+static ssize_t WriteBuffered( sout_access_out_t *p_access, block_t *p_buffer )
+{
+    sout_access_out_sys_t *sys = p_access->p_sys;
+    size_t i_write = 0;
+
+    while( p_buffer )
+    {
+        block_t *p_next = p_buffer->p_next;
+        size_t len = p_buffer->i_buffer;
+
+        if (sys->buf_used + len > sys->buf_size && Flush(p_access))
+        {
+            block_ChainRelease(p_buffer);
+            return -1;
+        }
+
+        if (len >= sys->buf_size)
+        {
+            /* Large enough on its own, bypass the buffer */
+            p_buffer->p_next = NULL;
+            if (Write(p_access, p_buffer) < 0)
+            {
+                block_ChainRelease(p_next);
+                return -1;
+            }
+        }
+        else
+        {
+            memcpy(sys->buf + sys->buf_used, p_buffer->p_buffer, len);
+            sys->buf_used += len;
+            block_Release(p_buffer);
+        }
+        i_write += len;
+        p_buffer = p_next;
+    }
+    return i_write;
+}
+
 static ssize_t WritePipe(sout_access_out_t *access, block_t *block)
 {
-    int *fdp = access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = access->p_sys;
+    int fd = sys->fd;
     ssize_t total = 0;
 
     while (block != NULL)
@@ -148,7 +225,8 @@ static ssize_t WritePipe(sout_access_out_t *access, block_t *block)
 #ifdef S_ISSOCK
 static ssize_t Send(sout_access_out_t *access, block_t *block)
 {
-    int *fdp = access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = access->p_sys;
+    int fd = sys->fd;
     size_t total = 0;
 
     while (block != NULL)
@@ -187,9 +265,11 @@ static ssize_t Send(sout_access_out_t *access, block_t *block)
  *****************************************************************************/
 static int Seek( sout_access_out_t *p_access, uint64_t i_pos )
 {
-    int *fdp = p_access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = p_access->p_sys;
 
-    return lseek(fd, i_pos, SEEK_SET);
+    if (sys->buf_used > 0 && Flush(p_access))
+        return -1;
+    return lseek(sys->fd, i_pos, SEEK_SET);
 }
 
 static int Control( sout_access_out_t *p_access, int i_query, va_list args )
@@ -218,6 +298,7 @@ static int Control( sout_access_out_t *p_access, int i_query, va_list args )
 
 static const char *const ppsz_sout_options[] = {
     "append",
+    "buffer",
     "format",
     "overwrite",
 #ifdef O_SYNC
@@ -233,9 +314,9 @@ static int Open( vlc_object_t *p_this )
 {
     sout_access_out_t   *p_access = (sout_access_out_t*)p_this;
     int fd;
-    int *fdp = vlc_obj_malloc(p_this, sizeof (*fdp));
+    sout_access_out_sys_t *sys = vlc_obj_malloc(p_this, sizeof (*sys));
 
-    if (unlikely(fdp == NULL))
+    if (unlikely(sys == NULL))
         return VLC_ENOMEM;
 
     config_ChainParse( p_access, SOUT_CFG_PREFIX, ppsz_sout_options, p_access->p_cfg );
@@ -320,8 +401,11 @@ static int Open( vlc_object_t *p_this )
             return VLC_EGENERIC;
     }
 
-    *fdp = fd;
-    p_access->p_sys = fdp;
+    sys->fd = fd;
+    sys->buf = NULL;
+    sys->buf_size = 0;
+    sys->buf_used = 0;
+    p_access->p_sys = sys;
 
     struct stat st;
 
@@ -336,8 +420,20 @@ static int Open( vlc_object_t *p_this )
 
     if (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode))
     {
+        int64_t buffer = var_GetInteger(p_access, SOUT_CFG_PREFIX"buffer");
+
         p_access->pf_write = Write;
         p_access->pf_seek  = Seek;
+
+        if (buffer > 0)
+        {
+            sys->buf_size = __MIN(buffer, 65536) * 1024;
+            sys->buf = vlc_obj_malloc(p_this, sys->buf_size);
+            if (sys->buf != NULL)
+                p_access->pf_write = WriteBuffered;
+            else
+                sys->buf_size = 0;
+        }
     }
 #ifdef S_ISSOCK
     else if (S_ISSOCK(st.st_mode))
@@ -366,9 +462,11 @@ static int Open( vlc_object_t *p_this )
 static void Close( vlc_object_t * p_this )
 {
     sout_access_out_t *p_access = (sout_access_out_t*)p_this;
-    int *fdp = p_access->p_sys, fd = *fdp;
+    sout_access_out_sys_t *sys = p_access->p_sys;
 
-    vlc_close(fd);
+    if (sys->buf_used > 0)
+        Flush(p_access);
+    vlc_close(sys->fd);
     msg_Dbg( p_access, "file access output closed" );
 }
 
@@ -381,6 +479,9 @@ static void Close( vlc_object_t * p_this )
 #define FORMAT_TEXT N_("Format time and date")
 #define FORMAT_LONGTEXT N_("Perform ISO C time and date formatting " \
     "on the file path")
+#define BUFFER_TEXT N_("Write buffer size (KiB)")
+#define BUFFER_LONGTEXT N_( "Coalesce the writes to regular files into " \
+    "large sequential ones of this size. 0 writes the data as it comes.")
 #define SYNC_TEXT N_("Synchronous writing")
 #define SYNC_LONGTEXT N_( "Open the file with synchronous writing.")
 
@@ -394,6 +495,8 @@ vlc_module_begin ()
               OVERWRITE_LONGTEXT )
     add_bool( SOUT_CFG_PREFIX "append", false, APPEND_TEXT,APPEND_LONGTEXT )
     add_bool( SOUT_CFG_PREFIX "format", false, FORMAT_TEXT, FORMAT_LONGTEXT )
+    add_integer_with_range( SOUT_CFG_PREFIX "buffer", 0, 0, 65536,
+                            BUFFER_TEXT, BUFFER_LONGTEXT )
 #ifdef O_SYNC
     add_bool( SOUT_CFG_PREFIX "sync", false, SYNC_TEXT,SYNC_LONGTEXT )
 #endif
@@ -43,6 +43,8 @@
 #include <vlc_fs.h>
 #include <vlc_strings.h>
 #include <vlc_charset.h>
+#include <vlc_httpd.h>
+#include <vlc_memstream.h>
 
 #include <gcrypt.h>
 #include <vlc_gcrypt.h>
@@ -105,6 +107,12 @@ static void Close( vlc_object_t * );
 #define INTITIAL_SEG_TEXT N_("Number of first segment")
 #define INITIAL_SEG_LONGTEXT N_("The number of the first segment generated")
 
+#define MEMORY_TEXT N_("Serve segments from memory")
+#define MEMORY_LONGTEXT N_("Keep the segments and the index in memory and " \
+                           "serve them with the built-in HTTP server, " \
+                           "instead of writing files. The segment path and " \
+                           "the index are then URL paths on that server.")
+
 vlc_module_begin ()
     set_description( N_("HTTP Live streaming output") )
     set_shortname( N_("LiveHTTP" ))
@@ -124,6 +132,8 @@ vlc_module_begin ()
               NOCACHE_TEXT, NOCACHE_LONGTEXT )
     add_bool( SOUT_CFG_PREFIX "generate-iv", false,
               RANDOMIV_TEXT, RANDOMIV_LONGTEXT )
+    add_bool( SOUT_CFG_PREFIX "memory", false,
+              MEMORY_TEXT, MEMORY_LONGTEXT )
     add_string( SOUT_CFG_PREFIX "index", NULL,
                 INDEX_TEXT, INDEX_LONGTEXT )
     add_string( SOUT_CFG_PREFIX "index-url", NULL,
@@ -155,6 +165,7 @@ static const char *const ppsz_sout_options[] = {
     "key-loadfile",
     "generate-iv",
     "initial-segment-number",
+    "memory",
     NULL
 };
 
@@ -170,6 +181,8 @@ typedef struct output_segment
     vlc_tick_t segment_length;
     uint32_t i_segment_number;
     uint8_t aes_ivs[16];
+    block_t *p_data;       /* memory mode */
+    httpd_file_t *p_file;  /* memory mode */
 } output_segment_t;
 
 typedef struct
@@ -201,6 +214,15 @@ typedef struct
     uint8_t stuffing_bytes[16];
     ssize_t stuffing_size;
     vlc_array_t segments_t;
+    bool b_segment_open;
+    /* memory mode */
+    httpd_host_t *p_httpd_host;
+    httpd_file_t *p_index_file;
+    vlc_mutex_t index_lock;
+    char *psz_index;         /* protected by index_lock */
+    size_t i_index;
+    block_t *segment_data;
+    block_t **segment_data_end;
 } sout_access_out_sys_t;
 
 static int LoadCryptFile( sout_access_out_t *p_access);
@@ -208,6 +230,7 @@ static int CryptSetup( sout_access_out_t *p_access, char *keyfile );
 static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer );
 static ssize_t writeSegment( sout_access_out_t *p_access );
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys );
+static int MemorySetup( sout_access_out_t *p_access );
 /*****************************************************************************
  * Open: open the file
  *****************************************************************************/
@@ -246,6 +269,15 @@ static int Open( vlc_object_t *p_this )
     p_sys->b_caching = var_GetBool( p_access, SOUT_CFG_PREFIX "caching") ;
     p_sys->b_generate_iv = var_GetBool( p_access, SOUT_CFG_PREFIX "generate-iv") ;
     p_sys->b_segment_has_data = false;
+    p_sys->b_segment_open = false;
+
+    bool b_memory = var_GetBool( p_access, SOUT_CFG_PREFIX "memory" );
+    if( b_memory && p_access->psz_path[0] != '/' )
+    {
+        msg_Err( p_access, "segment path must be an URL path in memory mode" );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
 
     vlc_array_init( &p_sys->segments_t );
 
@@ -264,7 +296,7 @@ static int Open( vlc_object_t *p_this )
             return VLC_ENOMEM;
         }
         p_sys->psz_indexPath = psz_tmp;
-        if( p_sys->i_initial_segment != 1 )
+        if( p_sys->i_initial_segment != 1 && !b_memory )
             vlc_unlink( p_sys->psz_indexPath );
     }
 
@@ -291,6 +323,19 @@ static int Open( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
+    if( b_memory && MemorySetup( p_access ) )
+    {
+        if( p_sys->key_uri )
+        {
+            gcry_cipher_close( p_sys->aes_ctx );
+            free( p_sys->key_uri );
+        }
+        free( p_sys->psz_indexUrl );
+        free( p_sys->psz_indexPath );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
     p_sys->i_handle = -1;
     p_sys->i_segment = p_sys->i_initial_segment-1;
     p_sys->psz_cursegPath = NULL;
@@ -301,6 +346,89 @@ static int Open( vlc_object_t *p_this )
     return VLC_SUCCESS;
 }
 
+/************************************************************************
+ * MemorySetup: Serve the index and the segments with httpd
+ ************************************************************************/
+static int IndexCallback( httpd_file_sys_t *p_args, httpd_file_t *f,
+                          uint8_t *p_request, uint8_t **pp_data, int *pi_data )
+{
+    VLC_UNUSED(f); VLC_UNUSED(p_request);
+    sout_access_out_sys_t *p_sys = (sout_access_out_sys_t *)p_args;
+
+    vlc_mutex_lock( &p_sys->index_lock );
+    *pp_data = NULL;
+    *pi_data = 0;
+    if( p_sys->psz_index )
+    {
+        *pp_data = malloc( p_sys->i_index );
+        if( likely( *pp_data ) )
+        {
+            memcpy( *pp_data, p_sys->psz_index, p_sys->i_index );
+            *pi_data = p_sys->i_index;
+        }
+    }
+    vlc_mutex_unlock( &p_sys->index_lock );
+
+    return VLC_SUCCESS;
+}
+
+static int SegmentCallback( httpd_file_sys_t *p_args, httpd_file_t *f,
+                            uint8_t *p_request, uint8_t **pp_data, int *pi_data )
+{
+    VLC_UNUSED(f); VLC_UNUSED(p_request);
+    /* The segment is only published once complete, and is never modified */
+    const block_t *p_data = ((output_segment_t *)p_args)->p_data;
+
+    *pp_data = NULL;
+    *pi_data = 0;
+    if( !p_data )
+        return VLC_SUCCESS;
+
+    *pp_data = malloc( p_data->i_buffer );
+    if( likely( *pp_data ) )
+    {
+        memcpy( *pp_data, p_data->p_buffer, p_data->i_buffer );
+        *pi_data = p_data->i_buffer;
+    }
+    return VLC_SUCCESS;
+}
+
+static int MemorySetup( sout_access_out_t *p_access )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+    if( p_sys->psz_indexPath && p_sys->psz_indexPath[0] != '/' )
+    {
+        msg_Err( p_access, "index must be an URL path in memory mode" );
+        return VLC_EGENERIC;
+    }
+
+    vlc_mutex_init( &p_sys->index_lock );
+    p_sys->psz_index = NULL;
+    p_sys->i_index = 0;
+    p_sys->segment_data = NULL;
+    p_sys->segment_data_end = &p_sys->segment_data;
+
+    p_sys->p_httpd_host = vlc_http_HostNew( VLC_OBJECT(p_access) );
+    if( !p_sys->p_httpd_host )
+        return VLC_EGENERIC;
+
+    if( p_sys->psz_indexPath )
+    {
+        p_sys->p_index_file = httpd_FileNew( p_sys->p_httpd_host,
+                                             p_sys->psz_indexPath,
+                                             "application/vnd.apple.mpegurl",
+                                             NULL, NULL, IndexCallback,
+                                             (httpd_file_sys_t *)p_sys );
+        if( !p_sys->p_index_file )
+        {
+            httpd_HostDelete( p_sys->p_httpd_host );
+            return VLC_EGENERIC;
+        }
+    }
+    return VLC_SUCCESS;
+}
+
 /************************************************************************
  * CryptSetup: Initialize encryption
  ************************************************************************/
@@ -500,6 +628,10 @@ static char *formatSegmentPath( char *psz_path, uint32_t i_seg )
 
 static void destroySegment( output_segment_t *segment )
 {
+    if( segment->p_file )
+        httpd_FileDelete( segment->p_file );
+    if( segment->p_data )
+        block_Release( segment->p_data );
     free( segment->psz_filename );
     free( segment->psz_duration );
     free( segment->psz_uri );
@@ -549,6 +681,48 @@ static bool isFirstItemRemovable( sout_access_out_sys_t *p_sys, uint32_t i_first
     return duration >= (first->segment_length + (p_sys->i_numsegs * p_sys->segment_max_length));
 }
 
+/************************************************************************
+ * writeIndexFile: Replace the index file
+ ************************************************************************/
+static int writeIndexFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys,
+                           const char *psz_index, size_t i_index )
+{
+    int val;
+    FILE *fp;
+    char *psz_idxTmp;
+    if ( asprintf( &psz_idxTmp, "%s.tmp", p_sys->psz_indexPath ) < 0)
+        return -1;
+
+    fp = vlc_fopen( psz_idxTmp, "wt");
+    if ( !fp )
+    {
+        msg_Err( p_access, "cannot open index file `%s'", psz_idxTmp );
+        free( psz_idxTmp );
+        return -1;
+    }
+
+    if ( fwrite( psz_index, 1, i_index, fp ) != i_index )
+    {
+        free( psz_idxTmp );
+        fclose( fp );
+        return -1;
+    }
+    fclose( fp );
+
+    val = vlc_rename ( psz_idxTmp, p_sys->psz_indexPath);
+
+    if ( val < 0 )
+    {
+        vlc_unlink( psz_idxTmp );
+        msg_Err( p_access, "Error moving LiveHttp index file" );
+    }
+    else
+        msg_Dbg( p_access, "LiveHttpIndexComplete: %s" , p_sys->psz_indexPath );
+
+    free( psz_idxTmp );
+    return 0;
+}
+
 /************************************************************************
  * updateIndexAndDel: If necessary, update index file & delete old segments
  ************************************************************************/
@@ -573,33 +747,16 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
     // First update index
     if ( p_sys->psz_indexPath )
     {
-        int val;
-        FILE *fp;
-        char *psz_idxTmp;
-        if ( asprintf( &psz_idxTmp, "%s.tmp", p_sys->psz_indexPath ) < 0)
-            return -1;
-
-        fp = vlc_fopen( psz_idxTmp, "wt");
-        if ( !fp )
-        {
-            msg_Err( p_access, "cannot open index file `%s'", psz_idxTmp );
-            free( psz_idxTmp );
-            return -1;
-        }
+        struct vlc_memstream ms;
+        vlc_memstream_open( &ms );
 
-        if ( fprintf( fp, "#EXTM3U\n#EXT-X-TARGETDURATION:%.0f\n#EXT-X-VERSION:3\n#EXT-X-ALLOW-CACHE:%s"
+        vlc_memstream_printf( &ms, "#EXTM3U\n#EXT-X-TARGETDURATION:%.0f\n#EXT-X-VERSION:3\n#EXT-X-ALLOW-CACHE:%s"
                           "%s\n#EXT-X-MEDIA-SEQUENCE:%"PRIu32"\n%s", ceil(secf_from_vlc_tick( p_sys->segment_max_length )) ,
                           p_sys->b_caching ? "YES" : "NO",
                           p_sys->i_numsegs > 0 ? "" : b_isend ? "\n#EXT-X-PLAYLIST-TYPE:VOD" : "\n#EXT-X-PLAYLIST-TYPE:EVENT",
                           i_firstseg, ((p_sys->i_initial_segment > 1) && (p_sys->i_initial_segment == i_firstseg)) ? "#EXT-X-DISCONTINUITY\n" : ""
-                          ) < 0 )
-        {
-            free( psz_idxTmp );
-            fclose( fp );
-            return -1;
-        }
-        char *psz_current_uri=NULL;
-
+                          );
+        const char *psz_current_uri = NULL;
 
         for ( uint32_t i = i_firstseg; i <= p_sys->i_segment; i++ )
         {
@@ -611,9 +768,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
                 ( !psz_current_uri ||  strcmp( psz_current_uri, segment->psz_key_uri ) )
               )
             {
-                int ret = 0;
-                free( psz_current_uri );
-                psz_current_uri = strdup( segment->psz_key_uri );
+                psz_current_uri = segment->psz_key_uri;
                 if( p_sys->b_generate_iv )
                 {
                     unsigned long long iv_hi = segment->aes_ivs[0];
@@ -625,55 +780,38 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
                         iv_lo <<= 8;
                         iv_lo |= segment->aes_ivs[8+j] & 0xff;
                     }
-                    ret = fprintf( fp, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\",IV=0X%16.16llx%16.16llx\n",
+                    vlc_memstream_printf( &ms, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\",IV=0X%16.16llx%16.16llx\n",
                                    segment->psz_key_uri, iv_hi, iv_lo );
 
                 } else {
-                    ret = fprintf( fp, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\"\n", segment->psz_key_uri );
-                }
-                if( ret < 0 )
-                {
-                    free( psz_current_uri );
-                    free( psz_idxTmp );
-                    fclose( fp );
-                    return -1;
+                    vlc_memstream_printf( &ms, "#EXT-X-KEY:METHOD=AES-128,URI=\"%s\"\n", segment->psz_key_uri );
                 }
             }
 
-            val = fprintf( fp, "#EXTINF:%s,\n%s\n", segment->psz_duration, segment->psz_uri);
-            if ( val < 0 )
-            {
-                free( psz_current_uri );
-                free( psz_idxTmp );
-                fclose( fp );
-                return -1;
-            }
+            vlc_memstream_printf( &ms, "#EXTINF:%s,\n%s\n", segment->psz_duration, segment->psz_uri);
         }
-        free( psz_current_uri );
 
         if ( b_isend )
-        {
-            if ( fputs ( STR_ENDLIST, fp ) < 0)
-            {
-                free( psz_idxTmp );
-                fclose( fp ) ;
-                return -1;
-            }
+            vlc_memstream_puts( &ms, STR_ENDLIST );
 
-        }
-        fclose( fp );
-
-        val = vlc_rename ( psz_idxTmp, p_sys->psz_indexPath);
+        if ( vlc_memstream_close( &ms ) )
+            return -1;
 
-        if ( val < 0 )
+        if ( p_sys->p_httpd_host )
         {
-            vlc_unlink( psz_idxTmp );
-            msg_Err( p_access, "Error moving LiveHttp index file" );
+            vlc_mutex_lock( &p_sys->index_lock );
+            free( p_sys->psz_index );
+            p_sys->psz_index = ms.ptr;
+            p_sys->i_index = ms.length;
+            vlc_mutex_unlock( &p_sys->index_lock );
         }
         else
-            msg_Dbg( p_access, "LiveHttpIndexComplete: %s" , p_sys->psz_indexPath );
-
-        free( psz_idxTmp );
+        {
+            int ret = writeIndexFile( p_access, p_sys, ms.ptr, ms.length );
+            free( ms.ptr );
+            if ( ret )
+                return -1;
+        }
     }
 
     // Then take care of deletion
@@ -686,7 +824,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
          msg_Dbg( p_access, "Removing segment number %d", segment->i_segment_number );
          vlc_array_remove( &p_sys->segments_t, 0 );
 
-         if ( segment->psz_filename )
+         if ( segment->psz_filename && !p_sys->p_httpd_host )
          {
              vlc_unlink( segment->psz_filename );
          }
@@ -704,7 +842,7 @@ static int updateIndexAndDel( sout_access_out_t *p_access, sout_access_out_sys_t
  *****************************************************************************/
 static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys, bool b_isend )
 {
-    if ( p_sys->i_handle >= 0 )
+    if ( p_sys->b_segment_open )
     {
         output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, vlc_array_count( &p_sys->segments_t ) - 1 );
 
@@ -716,6 +854,13 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
 
             if( err ) {
                msg_Err( p_access, "Couldn't encrypt 16 bytes: %s", gpg_strerror(err) );
+            } else if( p_sys->p_httpd_host ) {
+                block_t *p_stuffing = block_Alloc( 16 );
+                if( likely( p_stuffing ) )
+                {
+                    memcpy( p_stuffing->p_buffer, p_sys->stuffing_bytes, 16 );
+                    block_ChainLastAppend( &p_sys->segment_data_end, p_stuffing );
+                }
             } else {
 
             int ret = vlc_write( p_sys->i_handle, p_sys->stuffing_bytes, 16 );
@@ -726,8 +871,24 @@ static void closeCurrentSegment( sout_access_out_t *p_access, sout_access_out_sy
         }
 
 
-        vlc_close( p_sys->i_handle );
+        if( p_sys->i_handle >= 0 )
+            vlc_close( p_sys->i_handle );
         p_sys->i_handle = -1;
+        p_sys->b_segment_open = false;
+
+        if( p_sys->p_httpd_host )
+        {
+            /* Publish the complete segment before listing it in the index */
+            segment->p_data = block_ChainGather( p_sys->segment_data );
+            p_sys->segment_data = NULL;
+            p_sys->segment_data_end = &p_sys->segment_data;
+            segment->p_file = httpd_FileNew( p_sys->p_httpd_host,
+                                             segment->psz_filename, "video/MP2T",
+                                             NULL, NULL, SegmentCallback,
+                                             (httpd_file_sys_t *)segment );
+            if( !segment->p_file )
+                msg_Err( p_access, "cannot serve segment `%s'", segment->psz_filename );
+        }
 
         if( vlc_asprintf_c( &segment->psz_duration, "%.2f", secf_from_vlc_tick( p_sys->current_segment_length ) ) == -1 )
         {
@@ -802,7 +963,8 @@ static void Close( vlc_object_t * p_this )
     {
         output_segment_t *segment = vlc_array_item_at_index( &p_sys->segments_t, 0 );
         vlc_array_remove( &p_sys->segments_t, 0 );
-        if( p_sys->b_delsegs && p_sys->i_numsegs && segment->psz_filename )
+        if( p_sys->b_delsegs && p_sys->i_numsegs && segment->psz_filename &&
+            !p_sys->p_httpd_host )
         {
             msg_Dbg( p_access, "Removing segment number %d name %s", segment->i_segment_number, segment->psz_filename );
             vlc_unlink( segment->psz_filename );
@@ -811,6 +973,16 @@ static void Close( vlc_object_t * p_this )
         destroySegment( segment );
     }
 
+    if( p_sys->p_httpd_host )
+    {
+        if( p_sys->p_index_file )
+            httpd_FileDelete( p_sys->p_index_file );
+        httpd_HostDelete( p_sys->p_httpd_host );
+        if( p_sys->segment_data )
+            block_ChainRelease( p_sys->segment_data );
+        free( p_sys->psz_index );
+    }
+
     free( p_sys->psz_indexUrl );
     free( p_sys->psz_indexPath );
     free( p_sys );
@@ -843,7 +1015,7 @@ static int Control( sout_access_out_t *p_access, int i_query, va_list args )
  *****************************************************************************/
 static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t *p_sys )
 {
-    int fd;
+    int fd = -1;
 
     uint32_t i_newseg = p_sys->i_segment + 1;
 
@@ -864,14 +1036,17 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
         return -1;
     }
 
-    fd = vlc_open( segment->psz_filename, O_WRONLY | O_CREAT | O_LARGEFILE |
-                     O_TRUNC, 0666 );
-    if ( fd == -1 )
+    if ( !p_sys->p_httpd_host )
     {
-        msg_Err( p_access, "cannot open `%s' (%s)", segment->psz_filename,
-                 vlc_strerror_c(errno) );
-        destroySegment( segment );
-        return -1;
+        fd = vlc_open( segment->psz_filename, O_WRONLY | O_CREAT | O_LARGEFILE |
+                         O_TRUNC, 0666 );
+        if ( fd == -1 )
+        {
+            msg_Err( p_access, "cannot open `%s' (%s)", segment->psz_filename,
+                     vlc_strerror_c(errno) );
+            destroySegment( segment );
+            return -1;
+        }
     }
 
     vlc_array_append_or_abort( &p_sys->segments_t, segment );
@@ -892,9 +1067,10 @@ static ssize_t openNextFile( sout_access_out_t *p_access, sout_access_out_sys_t
 
     p_sys->psz_cursegPath = strdup(segment->psz_filename);
     p_sys->i_handle = fd;
+    p_sys->b_segment_open = true;
     p_sys->i_segment = i_newseg;
     p_sys->b_segment_has_data = false;
-    return fd;
+    return 0;
 }
 /*****************************************************************************
  * CheckSegmentChange: Check if segment needs to be closed and new opened
@@ -910,7 +1086,7 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
     block_ChainProperties( p_sys->full_segments, NULL, NULL, &current_length );
     block_ChainProperties( p_sys->ongoing_segment, NULL, NULL, &ongoing_length );
 
-    if( p_sys->i_handle > 0 &&
+    if( p_sys->b_segment_open &&
        (( p_buffer->i_length + current_length + ongoing_length ) >= p_sys->segment_max_length ) )
     {
         writevalue = writeSegment( p_access );
@@ -923,7 +1099,7 @@ static int CheckSegmentChange( sout_access_out_t *p_access, block_t *p_buffer )
         return writevalue;
     }
 
-    if ( unlikely( p_sys->i_handle < 0 ) )
+    if ( unlikely( !p_sys->b_segment_open ) )
     {
         if ( openNextFile( p_access, p_sys ) < 0 )
            return -1;
@@ -979,6 +1155,17 @@ static ssize_t writeSegment( sout_access_out_t *p_access )
 
         }
 
+        if( p_sys->p_httpd_host )
+        {
+            block_t *p_next = output->p_next;
+            output->p_next = NULL;
+            i_write += output->i_buffer;
+            block_ChainLastAppend( &p_sys->segment_data_end, output );
+            output = p_next;
+            encrypted = false;
+            continue;
+        }
+
         ssize_t val = vlc_write( p_sys->i_handle, output->p_buffer, output->i_buffer );
         if ( val == -1 )
         {
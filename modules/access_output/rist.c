@@ -116,7 +116,7 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
         {
             size_t i_write = __MIN( p_buffer->i_buffer, p_sys->i_max_packet_size );
             rist_buffer.payload = p_buffer->p_buffer;
-            rist_buffer.payload_len = p_buffer->i_buffer;
+            rist_buffer.payload_len = i_write;
             rist_sender_data_write(p_sys->sender_ctx, &rist_buffer);
             p_buffer->p_buffer += i_write;
             p_buffer->i_buffer -= i_write;
@@ -259,7 +259,9 @@ failed:
 #define RIST_MULTIPEER_MODE_TEXT N_("Multipeer mode")
 #define RIST_MULTIPEER_MODE_LONGTEXT N_( \
     "This allows you to select between duplicate or load balanced modes when " \
-    "sending data to multiple peers (several network paths)" )
+    "sending data to multiple peers (several network paths). In load " \
+    "balanced mode, the share of each path can be set with the weight " \
+    "parameter of its URL, e.g. rist://host:port?weight=10" )
 static const int multipeer_mode_type[] = { 0, 5, };
 static const char *const multipeer_mode_type_names[] = {
     N_("Duplicate"), N_("Load balanced"),
@@ -40,6 +40,7 @@ typedef struct
     vlc_mutex_t   lock;
     size_t        i_payload_size;
     block_bytestream_t block_stream;
+    srt_stats_t   stats;
 } sout_access_out_sys_t;
 
 static void srt_wait_interrupted(void *p_data)
@@ -168,6 +169,7 @@ static bool srt_schedule_reconnect(sout_access_out_t *p_access)
         &(int) { 1 }, sizeof( int ) );
 
     /* Set latency */
+    i_latency = srt_auto_latency( access_obj, &p_sys->stats, i_latency );
     srt_set_socket_option( access_obj, SRT_PARAM_LATENCY, p_sys->sock,
             SRTO_LATENCY, &i_latency, sizeof(i_latency) );
 
@@ -349,6 +351,8 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
         }
     }
 
+    srt_stats_update( VLC_OBJECT(p_access), &p_sys->stats, p_sys->sock, true );
+
 out:
     block_BytestreamEmpty( &p_sys->block_stream );
     vlc_interrupt_unregister();
@@ -408,6 +412,7 @@ static int Open( vlc_object_t *p_this )
 
     vlc_mutex_init( &p_sys->lock );
     block_BytestreamInit( &p_sys->block_stream );
+    srt_stats_init( p_this, &p_sys->stats );
 
     p_access->p_sys = p_sys;
 
@@ -478,6 +483,8 @@ vlc_module_begin()
     add_string(SRT_PARAM_STREAMID, "",
             N_(" SRT Stream ID"), NULL)
     change_safe()
+    add_bool( SRT_PARAM_LATENCY_AUTO, false, SRT_LATENCY_AUTO_TEXT,
+            SRT_LATENCY_AUTO_LONGTEXT )
 
     set_capability( "sout access", 0 )
     add_shortcut( "srt" )
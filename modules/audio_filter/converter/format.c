@@ -38,6 +38,7 @@
 #include <vlc_aout.h>
 #include <vlc_block.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -83,6 +84,447 @@ static int Open(vlc_object_t *object)
 }
 
 
+/*****************************************************************************
+ * Vector kernels
+ *****************************************************************************
+ * Each kernel converts as many samples as it can in whole vectors, and
+ * returns that count. The scalar loop converts the remaining samples.
+ * Narrowing kernels can work in place: each vector is loaded before the
+ * (smaller) result is stored.
+ *****************************************************************************/
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define FORMAT_SSE2 1
+# include <emmintrin.h>
+#endif
+
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# define FORMAT_AVX2 1
+# include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+# define FORMAT_NEON 1
+# include <arm_neon.h>
+#endif
+
+#ifdef FORMAT_TEST_NOOPTIM
+# undef FORMAT_SSE2
+# undef FORMAT_AVX2
+# undef FORMAT_NEON
+#endif
+
+#ifdef FORMAT_SSE2
+VLC_SSE
+static size_t SSE2_S16toFl32(float *dst, const int16_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_Fl32toS16(int16_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(32768.f);
+    const __m128 max = _mm_set1_ps(32767.f);
+    size_t i = 0;
+
+    /* Too large negative values convert to INT32_MIN, which saturates to
+     * INT16_MIN as expected. Only the positive side needs clamping. */
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), max);
+        __m128 b = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), max);
+        __m128i v = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_S32toFl32(float *dst, const int32_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(0x1.p-31f);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_Fl32toS32(int32_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(0x1.p31f);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+        /* Out of range values convert to INT32_MIN: flip the positive
+         * ones to INT32_MAX. */
+        __m128i over = _mm_castps_si128(_mm_cmpge_ps(s, scale));
+        __m128i v = _mm_xor_si128(_mm_cvtps_epi32(s), over);
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_Fl32toFl64(double *dst, const float *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_Fl64toFl32(float *dst, const double *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 b = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(a, b));
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_S16toS32(int32_t *dst, const int16_t *src, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(zero, v));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(zero, v));
+    }
+    return i;
+}
+
+VLC_SSE
+static size_t SSE2_S32toS16(int16_t *dst, const int32_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(src + i)), 16);
+        __m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(src + i + 4)), 16);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a, b));
+    }
+    return i;
+}
+#endif /* FORMAT_SSE2 */
+
+#ifdef FORMAT_AVX2
+VLC_AVX2
+static size_t AVX2_S16toFl32(float *dst, const int16_t *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.f / 32768.f);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_Fl32toS16(int16_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(32768.f);
+    const __m256 max = _mm256_set1_ps(32767.f);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256 a = _mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), max);
+        __m256 b = _mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), max);
+        __m256i v = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        /* The pack works within each 128-bit lane */
+        v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_S32toFl32(float *dst, const int32_t *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(0x1.p-31f);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_Fl32toS32(int32_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(0x1.p31f);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 s = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+        __m256i over = _mm256_castps_si256(_mm256_cmp_ps(s, scale, _CMP_GE_OQ));
+        __m256i v = _mm256_xor_si256(_mm256_cvtps_epi32(s), over);
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_Fl32toFl64(double *dst, const float *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_Fl64toFl32(float *dst, const double *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+        __m128 b = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+        _mm256_storeu_ps(dst + i, _mm256_set_m128(b, a));
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_S16toS32(int32_t *dst, const int16_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(src + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_slli_epi32(v, 16));
+    }
+    return i;
+}
+
+VLC_AVX2
+static size_t AVX2_S32toS16(int16_t *dst, const int32_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i a = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(src + i)), 16);
+        __m256i b = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(src + i + 8)), 16);
+        __m256i v = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b),
+                                             _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+    }
+    return i;
+}
+#endif /* FORMAT_AVX2 */
+
+#ifdef FORMAT_NEON
+static size_t NEON_S16toFl32(float *dst, const int16_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t v = vld1q_s16(src + i);
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(v)), 15));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(v)), 15));
+    }
+    return i;
+}
+
+static inline int32x4_t NEON_RoundFloat(float32x4_t v)
+{
+#ifdef __aarch64__
+    return vcvtnq_s32_f32(v);
+#else
+    /* Round half away from zero, as lroundf() */
+    uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000));
+    float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(sign,
+                                vreinterpretq_u32_f32(vdupq_n_f32(.5f))));
+    return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+}
+
+static size_t NEON_Fl32toS16(int16_t *dst, const float *src, size_t count)
+{
+    size_t i = 0;
+
+    /* The conversions to integer saturate */
+    for (; i + 8 <= count; i += 8)
+    {
+        int32x4_t a = NEON_RoundFloat(vmulq_n_f32(vld1q_f32(src + i), 32768.f));
+        int32x4_t b = NEON_RoundFloat(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.f));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    return i;
+}
+
+static size_t NEON_S32toFl32(float *dst, const int32_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vld1q_s32(src + i), 31));
+    return i;
+}
+
+static size_t NEON_Fl32toS32(int32_t *dst, const float *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+        vst1q_s32(dst + i, NEON_RoundFloat(vmulq_n_f32(vld1q_f32(src + i),
+                                                        0x1.p31f)));
+    return i;
+}
+
+static size_t NEON_S16toS32(int32_t *dst, const int16_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t v = vld1q_s16(src + i);
+        vst1q_s32(dst + i, vshll_n_s16(vget_low_s16(v), 16));
+        vst1q_s32(dst + i + 4, vshll_n_s16(vget_high_s16(v), 16));
+    }
+    return i;
+}
+
+static size_t NEON_S32toS16(int16_t *dst, const int32_t *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x4_t a = vshrn_n_s32(vld1q_s32(src + i), 16);
+        int16x4_t b = vshrn_n_s32(vld1q_s32(src + i + 4), 16);
+        vst1q_s16(dst + i, vcombine_s16(a, b));
+    }
+    return i;
+}
+
+# ifdef __aarch64__
+static size_t NEON_Fl32toFl64(double *dst, const float *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t v = vld1q_f32(src + i);
+        vst1q_f64(dst + i, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(dst + i + 2, vcvt_high_f64_f32(v));
+    }
+    return i;
+}
+
+static size_t NEON_Fl64toFl32(float *dst, const double *src, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x2_t a = vcvt_f32_f64(vld1q_f64(src + i));
+        float32x4_t v = vcvt_high_f32_f64(a, vld1q_f64(src + i + 2));
+        vst1q_f32(dst + i, v);
+    }
+    return i;
+}
+# endif
+#endif /* FORMAT_NEON */
+
+/* Picks the widest kernel supported by the CPU, if any */
+#ifdef FORMAT_AVX2
+# define DISPATCH_AVX2(name) \
+    if (vlc_CPU_AVX2()) \
+        return AVX2_##name(dst, src, count);
+#else
+# define DISPATCH_AVX2(name)
+#endif
+#ifdef FORMAT_SSE2
+# define DISPATCH_SSE2(name) \
+    if (vlc_CPU_SSE2()) \
+        return SSE2_##name(dst, src, count);
+#else
+# define DISPATCH_SSE2(name)
+#endif
+#ifdef FORMAT_NEON
+# define DISPATCH_NEON(name) \
+    if (vlc_CPU_ARM_NEON()) \
+        return NEON_##name(dst, src, count);
+#else
+# define DISPATCH_NEON(name)
+#endif
+
+#define SIMD_KERNEL(name, dst_type, src_type, neon) \
+static size_t name##_SIMD(dst_type *dst, const src_type *src, size_t count) \
+{ \
+    DISPATCH_AVX2(name) \
+    DISPATCH_SSE2(name) \
+    neon(name) \
+    (void) dst; (void) src; (void) count; \
+    return 0; \
+}
+
+#if defined(FORMAT_NEON) && defined(__aarch64__)
+# define DISPATCH_NEON64(name) DISPATCH_NEON(name)
+#else
+# define DISPATCH_NEON64(name)
+#endif
+
+SIMD_KERNEL(S16toFl32,  float,   int16_t, DISPATCH_NEON)
+SIMD_KERNEL(S16toS32,   int32_t, int16_t, DISPATCH_NEON)
+SIMD_KERNEL(Fl32toS16,  int16_t, float,   DISPATCH_NEON)
+SIMD_KERNEL(Fl32toS32,  int32_t, float,   DISPATCH_NEON)
+SIMD_KERNEL(Fl32toFl64, double,  float,   DISPATCH_NEON64)
+SIMD_KERNEL(S32toS16,   int16_t, int32_t, DISPATCH_NEON)
+SIMD_KERNEL(S32toFl32,  float,   int32_t, DISPATCH_NEON)
+SIMD_KERNEL(Fl64toFl32, float,   double,  DISPATCH_NEON64)
+
+
 /*** from U8 ***/
 static block_t *U8toS16(filter_t *filter, block_t *bsrc)
 {
@@ -175,7 +617,11 @@ static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
     block_CopyProperties(bdst, bsrc);
     int16_t *src = (int16_t *)bsrc->p_buffer;
     float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 2; i--;)
+    size_t count = bsrc->i_buffer / 2;
+    size_t done = S16toFl32_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
 #if 0
         /* Slow version */
         *dst++ = (float)*src++ / 32768.f;
@@ -203,7 +649,11 @@ static block_t *S16toS32(filter_t *filter, block_t *bsrc)
     block_CopyProperties(bdst, bsrc);
     int16_t *src = (int16_t *)bsrc->p_buffer;
     int32_t *dst = (int32_t *)bdst->p_buffer;
-    for (int i = bsrc->i_buffer / 2; i--;)
+    size_t count = bsrc->i_buffer / 2;
+    size_t done = S16toS32_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
         *dst++ = *src++ << 16;
 out:
     block_Release(bsrc);
@@ -219,7 +669,7 @@ static block_t *S16toFl64(filter_t *filter, block_t *bsrc)
 
     block_CopyProperties(bdst, bsrc);
     int16_t *src = (int16_t *)bsrc->p_buffer;
-    float   *dst = (float *)bdst->p_buffer;
+    double  *dst = (double *)bdst->p_buffer;
     for (size_t i = bsrc->i_buffer / 2; i--;)
         *dst++ = (double)*src++ / 32768.;
 out:
@@ -255,7 +705,11 @@ static block_t *Fl32toS16(filter_t *filter, block_t *b)
     VLC_UNUSED(filter);
     float   *src = (float *)b->p_buffer;
     int16_t *dst = (int16_t *)src;
-    for (int i = b->i_buffer / 4; i--;) {
+    size_t count = b->i_buffer / 4;
+    size_t done = Fl32toS16_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;) {
 #if 0
         /* Slow version. */
         if (*src >= 1.0) *dst = 32767;
@@ -282,7 +736,11 @@ static block_t *Fl32toS32(filter_t *filter, block_t *b)
 {
     float   *src = (float *)b->p_buffer;
     int32_t *dst = (int32_t *)src;
-    for (size_t i = b->i_buffer / 4; i--;)
+    size_t count = b->i_buffer / 4;
+    size_t done = Fl32toS32_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
     {
         float s = *(src++) * -((float)INT32_MIN);
         if (s >= ((float)INT32_MAX))
@@ -306,7 +764,11 @@ static block_t *Fl32toFl64(filter_t *filter, block_t *bsrc)
     block_CopyProperties(bdst, bsrc);
     float  *src = (float *)bsrc->p_buffer;
     double *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 4; i--;)
+    size_t count = bsrc->i_buffer / 4;
+    size_t done = Fl32toFl64_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
         *(dst++) = *(src++);
 out:
     block_Release(bsrc);
@@ -333,7 +795,11 @@ static block_t *S32toS16(filter_t *filter, block_t *b)
     VLC_UNUSED(filter);
     int32_t *src = (int32_t *)b->p_buffer;
     int16_t *dst = (int16_t *)src;
-    for (size_t i = b->i_buffer / 4; i--;)
+    size_t count = b->i_buffer / 4;
+    size_t done = S32toS16_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
         *dst++ = (*src++) >> 16;
 
     b->i_buffer /= 2;
@@ -345,7 +811,11 @@ static block_t *S32toFl32(filter_t *filter, block_t *b)
     VLC_UNUSED(filter);
     int32_t *src = (int32_t*)b->p_buffer;
     float   *dst = (float *)src;
-    for (int i = b->i_buffer / 4; i--;)
+    size_t count = b->i_buffer / 4;
+    size_t done = S32toFl32_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
         *dst++ = (float)(*src++) / -((float)INT32_MIN);
     return b;
 }
@@ -412,7 +882,11 @@ static block_t *Fl64toFl32(filter_t *filter, block_t *b)
 {
     double *src = (double *)b->p_buffer;
     float  *dst = (float *)src;
-    for (size_t i = b->i_buffer / 8; i--;)
+    size_t count = b->i_buffer / 8;
+    size_t done = Fl64toFl32_SIMD(dst, src, count);
+    src += done;
+    dst += done;
+    for (size_t i = count - done; i--;)
         *(dst++) = *(src++);
     b->i_buffer /= 2;
 
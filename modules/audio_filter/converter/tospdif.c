@@ -50,8 +50,12 @@ vlc_module_end ()
 
 typedef struct
 {
+    /* Burst being packed, kept across flushes so that it can be reused */
     block_t *p_out_buf;
-    size_t i_out_offset;
+    size_t i_out_offset; /* 0 if no burst is in progress */
+
+    /* Expected pts of the next burst */
+    vlc_tick_t i_next_pts;
 
     union
     {
@@ -174,10 +178,26 @@ static int write_init( filter_t *p_filter, block_t *p_in_buf,
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    assert( p_sys->p_out_buf == NULL );
+    assert( p_sys->i_out_offset == 0 );
     assert( i_out_size > SPDIF_HEADER_SIZE && ( i_out_size & 3 ) == 0 );
 
-    p_sys->p_out_buf = block_Alloc( i_out_size );
+    if( p_sys->p_out_buf != NULL )
+    {
+        /* Reuse the burst left by a flush or an error, its content is
+         * discarded */
+        p_sys->p_out_buf->i_buffer = 0;
+        block_t *p_out_buf = block_TryRealloc( p_sys->p_out_buf, 0, i_out_size );
+        if( p_out_buf == NULL )
+            block_Release( p_sys->p_out_buf );
+        p_sys->p_out_buf = p_out_buf;
+        if( p_out_buf != NULL )
+        {
+            p_out_buf->i_flags = 0;
+            p_out_buf->i_length = 0;
+        }
+    }
+    if( p_sys->p_out_buf == NULL )
+        p_sys->p_out_buf = block_AllocPooled( i_out_size );
     if( !p_sys->p_out_buf )
         return VLC_ENOMEM;
     p_sys->p_out_buf->i_dts = p_in_buf->i_dts;
@@ -283,7 +303,7 @@ static int write_buffer_eac3( filter_t *p_filter, block_t *p_in_buf )
             return SPDIF_ERROR;
     }
 
-    if( !p_sys->p_out_buf
+    if( p_sys->i_out_offset == 0
      && write_init( p_filter, p_in_buf, AOUT_SPDIF_SIZE * 4, AOUT_SPDIF_SIZE ) )
         return SPDIF_ERROR;
     if( p_in_buf->i_buffer > p_sys->p_out_buf->i_buffer - p_sys->i_out_offset )
@@ -319,7 +339,7 @@ static int write_buffer_truehd( filter_t *p_filter, block_t *p_in_buf )
 
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    if( !p_sys->p_out_buf
+    if( p_sys->i_out_offset == 0
      && write_init( p_filter, p_in_buf, 61440, 61440 / 16 ) )
         return SPDIF_ERROR;
 
@@ -531,11 +551,9 @@ static void Flush( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    if( p_sys->p_out_buf != NULL )
-    {
-        block_Release( p_sys->p_out_buf );
-        p_sys->p_out_buf = NULL;
-    }
+    /* Drop the pending burst, but keep its buffer for the next one */
+    p_sys->i_out_offset = 0;
+    p_sys->i_next_pts = VLC_TICK_INVALID;
     switch( p_filter->fmt_in.audio.i_format )
     {
         case VLC_CODEC_TRUEHD:
@@ -549,6 +567,30 @@ static void Flush( filter_t *p_filter )
     }
 }
 
+/* Bursts are sent at a constant rate, but their pts come from the first
+ * gathered input frame and carry the container jitter. Follow the length
+ * of the previous burst instead, unless the gap is too large to be jitter,
+ * so that the output does not drift into an underrun. */
+static void SmoothTimestamp( filter_t *p_filter, block_t *p_out_buf )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_out_buf->i_pts == VLC_TICK_INVALID )
+        p_out_buf->i_pts = p_sys->i_next_pts;
+    else if( p_sys->i_next_pts != VLC_TICK_INVALID )
+    {
+        vlc_tick_t i_drift = p_out_buf->i_pts - p_sys->i_next_pts;
+        if( llabs( i_drift ) < p_out_buf->i_length / 2 )
+            p_out_buf->i_pts = p_sys->i_next_pts;
+    }
+    p_out_buf->i_dts = p_out_buf->i_pts;
+
+    if( p_out_buf->i_pts != VLC_TICK_INVALID && p_out_buf->i_length > 0 )
+        p_sys->i_next_pts = p_out_buf->i_pts + p_out_buf->i_length;
+    else
+        p_sys->i_next_pts = VLC_TICK_INVALID;
+}
+
 static block_t *DoWork( filter_t *p_filter, block_t *p_in_buf )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -583,6 +625,8 @@ static block_t *DoWork( filter_t *p_filter, block_t *p_in_buf )
             assert( p_sys->p_out_buf->i_buffer == p_sys->i_out_offset );
             p_out_buf = p_sys->p_out_buf;
             p_sys->p_out_buf = NULL;
+            p_sys->i_out_offset = 0;
+            SmoothTimestamp( p_filter, p_out_buf );
             break;
         case SPDIF_MORE_DATA:
             break;
@@ -597,8 +641,11 @@ static block_t *DoWork( filter_t *p_filter, block_t *p_in_buf )
 
 static void Close( filter_t *p_filter )
 {
-    Flush( p_filter );
-    free( p_filter->p_sys );
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->p_out_buf != NULL )
+        block_Release( p_sys->p_out_buf );
+    free( p_sys );
 }
 
 static int Open( vlc_object_t *p_this )
@@ -619,6 +666,7 @@ static int Open( vlc_object_t *p_this )
     p_sys = p_filter->p_sys = calloc( 1, sizeof(filter_sys_t) );
     if( unlikely( p_sys == NULL ) )
         return VLC_ENOMEM;
+    p_sys->i_next_pts = VLC_TICK_INVALID;
 
     static const struct vlc_filter_operations filter_ops =
     {
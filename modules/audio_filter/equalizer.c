@@ -36,11 +36,16 @@
 
 #include <vlc_aout.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define EQZ_SSE 1
+# include <xmmintrin.h>
+#endif
 
 #include "equalizer_presets.h"
 
 /* TODO:
- *  - optimize a bit (you can hardly do slower ;)
  *  - add tables for more bands (15 and 32 would be cool), maybe with auto coeffs
  *    computation (not too hard once the Q is found).
  *  - support for external preset
@@ -99,34 +104,51 @@ vlc_module_end ()
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
+/* The bands are padded with null coefficients to a multiple of 4, so that
+ * they can be processed 4 at a time */
+#define EQZ_BANDS_PAD ((EQZ_BANDS_MAX + 3) & ~3)
+
 typedef struct
+{
+    float x[2];
+    float y0[EQZ_BANDS_PAD];
+    float y1[EQZ_BANDS_PAD];
+} eqz_state_t;
+
+typedef struct filter_sys_t filter_sys_t;
+
+struct filter_sys_t
 {
     /* Filter static config */
     int i_band;
-    float *f_alpha;
-    float *f_beta;
-    float *f_gamma;
+    float f_alpha[EQZ_BANDS_PAD];
+    float f_beta[EQZ_BANDS_PAD];
+    float f_gamma[EQZ_BANDS_PAD];
 
     /* Filter dyn config */
-    float *f_amp;   /* Per band amp */
+    float f_amp[EQZ_BANDS_PAD];   /* Per band amp */
     float f_gamp;   /* Global preamp */
     bool b_2eqz;
 
     /* Filter state */
-    float x[32][2];
-    float y[32][128][2];
+    eqz_state_t state[32];
 
     /* Second filter state */
-    float x2[32][2];
-    float y2[32][128][2];
+    eqz_state_t state2[32];
+
+    float (*pf_pass)( const filter_sys_t *, eqz_state_t *, float );
 
     vlc_mutex_t lock;
-} filter_sys_t;
+};
 
 static block_t *DoWork( filter_t *, block_t * );
 
 #define EQZ_IN_FACTOR (0.25f)
 static int  EqzInit( filter_t *, int );
+static float EqzPass( const filter_sys_t *, eqz_state_t *, float );
+#ifdef EQZ_SSE
+static float SSE_EqzPass( const filter_sys_t *, eqz_state_t *, float );
+#endif
 static void EqzFilter( filter_t *, float *, float *, int, int );
 static void EqzClean( filter_t * );
 
@@ -280,57 +302,40 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     eqz_config_t cfg;
-    int i, ch;
+    int i;
     vlc_value_t val1, val2, val3;
     vlc_object_t *p_aout = vlc_object_parent(p_filter);
-    int i_ret = VLC_ENOMEM;
 
     bool b_vlcFreqs = var_InheritBool( p_aout, "equalizer-vlcfreqs" );
     EqzCoeffs( i_rate, 1.0f, b_vlcFreqs, &cfg );
 
     /* Create the static filter config */
     p_sys->i_band = cfg.i_band;
-    p_sys->f_alpha = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_beta  = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_gamma = vlc_alloc( p_sys->i_band, sizeof(float) );
-    if( !p_sys->f_alpha || !p_sys->f_beta || !p_sys->f_gamma )
-        goto error;
-
-    for( i = 0; i < p_sys->i_band; i++ )
+    for( i = 0; i < EQZ_BANDS_PAD; i++ )
     {
-        p_sys->f_alpha[i] = cfg.band[i].f_alpha;
-        p_sys->f_beta[i]  = cfg.band[i].f_beta;
-        p_sys->f_gamma[i] = cfg.band[i].f_gamma;
+        bool b_band = i < p_sys->i_band;
+        p_sys->f_alpha[i] = b_band ? cfg.band[i].f_alpha : 0.0f;
+        p_sys->f_beta[i]  = b_band ? cfg.band[i].f_beta : 0.0f;
+        p_sys->f_gamma[i] = b_band ? cfg.band[i].f_gamma : 0.0f;
     }
 
     /* Filter dyn config */
     p_sys->b_2eqz = false;
     p_sys->f_gamp = 1.0f;
-    p_sys->f_amp  = vlc_alloc( p_sys->i_band, sizeof(float) );
-    if( !p_sys->f_amp )
-        goto error;
-
-    for( i = 0; i < p_sys->i_band; i++ )
+    for( i = 0; i < EQZ_BANDS_PAD; i++ )
     {
         p_sys->f_amp[i] = 0.0f;
     }
 
     /* Filter state */
-    for( ch = 0; ch < 32; ch++ )
-    {
-        p_sys->x[ch][0]  =
-        p_sys->x[ch][1]  =
-        p_sys->x2[ch][0] =
-        p_sys->x2[ch][1] = 0.0f;
+    memset( p_sys->state, 0, sizeof(p_sys->state) );
+    memset( p_sys->state2, 0, sizeof(p_sys->state2) );
 
-        for( i = 0; i < p_sys->i_band; i++ )
-        {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
-        }
-    }
+    p_sys->pf_pass = EqzPass;
+#ifdef EQZ_SSE
+    if( vlc_CPU_SSE2() )
+        p_sys->pf_pass = SSE_EqzPass;
+#endif
 
     var_Create( p_aout, "equalizer-bands", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
     var_Create( p_aout, "equalizer-preset", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
@@ -356,9 +361,7 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     {
         msg_Err(p_filter, "No preset selected");
         free( val2.psz_string );
-        free( p_sys->f_amp );
-        i_ret = VLC_EGENERIC;
-        goto error;
+        return VLC_EGENERIC;
     }
     free( val2.psz_string );
 
@@ -377,19 +380,66 @@ static int EqzInit( filter_t *p_filter, int i_rate )
                  p_sys->f_alpha[i], p_sys->f_beta[i], p_sys->f_gamma[i]);
     }
     return VLC_SUCCESS;
+}
+
+/* Runs all the bands on one sample and returns the weighted sum of their
+ * outputs. The bands are independent from each other, which is what allows
+ * processing several of them at once. */
+static float EqzPass( const filter_sys_t *p_sys, eqz_state_t *st, float x )
+{
+    const float dx = x - st->x[1];
+    float o = 0.0f;
+
+    for( int j = 0; j < p_sys->i_band; j++ )
+    {
+        float y = p_sys->f_alpha[j] * dx +
+                  p_sys->f_gamma[j] * st->y0[j] -
+                  p_sys->f_beta[j]  * st->y1[j];
+
+        st->y1[j] = st->y0[j];
+        st->y0[j] = y;
 
-error:
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
-    return i_ret;
+        o += y * p_sys->f_amp[j];
+    }
+    st->x[1] = st->x[0];
+    st->x[0] = x;
+    return o;
 }
 
+#ifdef EQZ_SSE
+VLC_SSE
+static float SSE_EqzPass( const filter_sys_t *p_sys, eqz_state_t *st, float x )
+{
+    const __m128 dx = _mm_set1_ps( x - st->x[1] );
+    __m128 o = _mm_setzero_ps();
+
+    for( int j = 0; j < EQZ_BANDS_PAD; j += 4 )
+    {
+        __m128 y0 = _mm_loadu_ps( &st->y0[j] );
+        __m128 y1 = _mm_loadu_ps( &st->y1[j] );
+        __m128 y = _mm_mul_ps( _mm_loadu_ps( &p_sys->f_alpha[j] ), dx );
+        y = _mm_add_ps( y, _mm_mul_ps( _mm_loadu_ps( &p_sys->f_gamma[j] ), y0 ) );
+        y = _mm_sub_ps( y, _mm_mul_ps( _mm_loadu_ps( &p_sys->f_beta[j] ), y1 ) );
+
+        _mm_storeu_ps( &st->y1[j], y0 );
+        _mm_storeu_ps( &st->y0[j], y );
+
+        o = _mm_add_ps( o, _mm_mul_ps( y, _mm_loadu_ps( &p_sys->f_amp[j] ) ) );
+    }
+    st->x[1] = st->x[0];
+    st->x[0] = x;
+
+    o = _mm_add_ps( o, _mm_movehl_ps( o, o ) );
+    o = _mm_add_ss( o, _mm_shuffle_ps( o, o, 1 ) );
+    return _mm_cvtss_f32( o );
+}
+#endif
+
 static void EqzFilter( filter_t *p_filter, float *out, float *in,
                        int i_samples, int i_channels )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    int i, ch, j;
+    int i, ch;
 
     vlc_mutex_lock( &p_sys->lock );
     for( i = 0; i < i_samples; i++ )
@@ -397,40 +447,13 @@ static void EqzFilter( filter_t *p_filter, float *out, float *in,
         for( ch = 0; ch < i_channels; ch++ )
         {
             const float x = in[ch];
-            float o = 0.0f;
-
-            for( j = 0; j < p_sys->i_band; j++ )
-            {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
-
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
-
-                o += y * p_sys->f_amp[j];
-            }
-            p_sys->x[ch][1] = p_sys->x[ch][0];
-            p_sys->x[ch][0] = x;
+            float o = p_sys->pf_pass( p_sys, &p_sys->state[ch], x );
 
             /* Second filter */
             if( p_sys->b_2eqz )
             {
                 const float x2 = EQZ_IN_FACTOR * x + o;
-                o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
-                {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
-
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
-
-                    o += y * p_sys->f_amp[j];
-                }
-                p_sys->x2[ch][1] = p_sys->x2[ch][0];
-                p_sys->x2[ch][0] = x2;
+                o = p_sys->pf_pass( p_sys, &p_sys->state2[ch], x2 );
 
                 /* We add source PCM + filtered PCM */
                 out[ch] = p_sys->f_gamp * p_sys->f_gamp *( EQZ_IN_FACTOR * x2 + o );
@@ -457,12 +480,6 @@ static void EqzClean( filter_t *p_filter )
     var_DelCallback( p_aout, "equalizer-preset", PresetCallback, p_sys );
     var_DelCallback( p_aout, "equalizer-preamp", PreampCallback, p_sys );
     var_DelCallback( p_aout, "equalizer-2pass", TwoPassCallback, p_sys );
-
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
-
-    free( p_sys->f_amp );
 }
 
 
@@ -0,0 +1,540 @@
+/*****************************************************************************
+ * loudnorm.c : EBU R 128 loudness normalizer with a true-peak limiter
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * The loudness is measured as specified by ITU-R BS.1770: K-weighting, 100 ms
+ * blocks and a 3 s short-term window gated at -70 LUFS. The gain slowly
+ * follows the short-term loudness towards the target.
+ *
+ * When the track loudness is already known from its replay gain, the gain is
+ * applied from the first sample and stays fixed, and the measurement is
+ * skipped altogether.
+ *
+ * In both cases, the output goes through a limiter that looks ahead by
+ * LOOKAHEAD and keeps the 4x oversampled (true) peaks under the ceiling. The
+ * output timestamps are moved back by the lookahead so that the delay does not
+ * affect the synchronization.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_filter.h>
+#include <vlc_plugin.h>
+
+#define CFG_PREFIX "loudnorm-"
+
+#define LOOKAHEAD VLC_TICK_FROM_MS(10)
+#define BLOCK_LENGTH VLC_TICK_FROM_MS(100)
+#define SHORTTERM_BLOCKS 30 /* 3 s */
+#define MOMENTARY_BLOCKS 4 /* 400 ms */
+#define ABSOLUTE_GATE (-70.)
+#define GAIN_TIME_CONSTANT 1.f /* in seconds */
+#define RELEASE_TIME_CONSTANT .2f /* in seconds */
+
+/* ReplayGain 2.0 reference loudness, in LUFS */
+#define REPLAY_GAIN_REFERENCE (-18.f)
+
+#define TP_PHASES 4
+#define TP_TAPS 12
+
+struct biquad
+{
+    double b0, b1, b2, a1, a2;
+};
+
+struct filter_sys
+{
+    unsigned channels;
+    float target;
+    float ceiling;
+    float max_gain;
+
+    /* Loudness measurement, unused when the gain is fixed */
+    bool fixed;
+    struct biquad shelf, highpass;
+    double (*kstate)[4];
+    float *weights;
+    double block_sum;
+    unsigned block_frames;
+    unsigned block_size;
+    double shortterm[SHORTTERM_BLOCKS];
+    unsigned shortterm_index;
+    unsigned shortterm_count;
+
+    float gain;
+    float gain_target;
+    float gain_coef;
+
+    /* True-peak estimation, phase 0 being the sample itself */
+    float tp_coefs[TP_PHASES - 1][TP_TAPS];
+    float *tp_history; /* 2 * TP_TAPS per channel */
+    unsigned tp_pos;
+
+    /* Lookahead limiter */
+    unsigned la_size;
+    float *la_samples; /* la_size frames */
+    float *la_required; /* la_size + 1 gains */
+    uint64_t *la_mins; /* monotonic queue of frame numbers */
+    unsigned la_mins_head;
+    unsigned la_mins_count;
+    uint64_t la_frame;
+    float limiter_gain;
+    float release_coef;
+    float attack_coef;
+
+    vlc_tick_t next_pts;
+};
+
+static void
+biquad_HighShelf(struct biquad *bq, unsigned rate)
+{
+    const double f0 = 1681.974450955533;
+    const double G = 3.999843853973347;
+    const double Q = 0.7071752369554196;
+
+    const double K = tan(M_PI * f0 / rate);
+    const double Vh = pow(10., G / 20.);
+    const double Vb = pow(Vh, 0.4996667741545416);
+    const double a0 = 1. + K / Q + K * K;
+
+    bq->b0 = (Vh + Vb * K / Q + K * K) / a0;
+    bq->b1 = 2. * (K * K - Vh) / a0;
+    bq->b2 = (Vh - Vb * K / Q + K * K) / a0;
+    bq->a1 = 2. * (K * K - 1.) / a0;
+    bq->a2 = (1. - K / Q + K * K) / a0;
+}
+
+static void
+biquad_HighPass(struct biquad *bq, unsigned rate)
+{
+    const double f0 = 38.13547087602444;
+    const double Q = 0.5003270373238773;
+
+    const double K = tan(M_PI * f0 / rate);
+    const double a0 = 1. + K / Q + K * K;
+
+    bq->b0 = 1.;
+    bq->b1 = -2.;
+    bq->b2 = 1.;
+    bq->a1 = 2. * (K * K - 1.) / a0;
+    bq->a2 = (1. - K / Q + K * K) / a0;
+}
+
+static inline double
+biquad_Process(const struct biquad *bq, double *state, double x)
+{
+    /* Transposed direct form II */
+    double y = bq->b0 * x + state[0];
+    state[0] = bq->b1 * x - bq->a1 * y + state[1];
+    state[1] = bq->b2 * x - bq->a2 * y;
+    return y;
+}
+
+static void
+InitChannelWeights(float *weights, const audio_format_t *fmt)
+{
+    unsigned n = 0;
+
+    /* BS.1770 weights: surround channels count 1.41, the LFE is ignored */
+    for (unsigned i = 0; pi_vlc_chan_order_wg4[i] != 0; ++i)
+    {
+        uint32_t chan = pi_vlc_chan_order_wg4[i];
+        if (!(fmt->i_physical_channels & chan) || n >= fmt->i_channels)
+            continue;
+
+        switch (chan)
+        {
+            case AOUT_CHAN_LFE:
+                weights[n++] = 0.f;
+                break;
+            case AOUT_CHAN_MIDDLELEFT:
+            case AOUT_CHAN_MIDDLERIGHT:
+            case AOUT_CHAN_REARLEFT:
+            case AOUT_CHAN_REARRIGHT:
+            case AOUT_CHAN_REARCENTER:
+                weights[n++] = 1.41f;
+                break;
+            default:
+                weights[n++] = 1.f;
+                break;
+        }
+    }
+
+    for (; n < fmt->i_channels; ++n)
+        weights[n] = 1.f;
+}
+
+static void
+InitTruePeakCoefs(float coefs[TP_PHASES - 1][TP_TAPS])
+{
+    /* Hann-windowed sinc interpolating between the two middle taps */
+    for (unsigned p = 1; p < TP_PHASES; ++p)
+        for (unsigned k = 0; k < TP_TAPS; ++k)
+        {
+            double t = TP_TAPS / 2 - 1 + (double) p / TP_PHASES - k;
+            double sinc = sin(M_PI * t) / (M_PI * t);
+            double window = .5 * (1. + cos(2. * M_PI * t / TP_TAPS));
+            coefs[p - 1][k] = sinc * window;
+        }
+}
+
+static float
+GainFromReplayGain(const audio_replay_gain_t *rg, float target, bool *known)
+{
+    for (unsigned i = 0; i < AUDIO_REPLAY_GAIN_MAX; ++i)
+    {
+        /* Prefer the track gain */
+        if (rg->pb_gain[i])
+        {
+            float loudness = REPLAY_GAIN_REFERENCE - rg->pf_gain[i];
+            *known = true;
+            return target - loudness;
+        }
+    }
+    *known = false;
+    return 0.f;
+}
+
+static void
+ResetLimiter(struct filter_sys *sys)
+{
+    memset(sys->la_samples, 0,
+           sizeof (*sys->la_samples) * sys->la_size * sys->channels);
+    memset(sys->tp_history, 0,
+           sizeof (*sys->tp_history) * 2 * TP_TAPS * sys->channels);
+    sys->tp_pos = 0;
+    sys->la_mins_head = sys->la_mins_count = 0;
+    sys->la_frame = 0;
+    sys->limiter_gain = 1.f;
+    sys->next_pts = VLC_TICK_INVALID;
+}
+
+static void
+Measure(struct filter_sys *sys, const float *frame)
+{
+    double sum = 0.;
+
+    for (unsigned c = 0; c < sys->channels; ++c)
+    {
+        double x = biquad_Process(&sys->shelf, &sys->kstate[c][0], frame[c]);
+        x = biquad_Process(&sys->highpass, &sys->kstate[c][2], x);
+        sum += sys->weights[c] * x * x;
+    }
+    sys->block_sum += sum;
+
+    if (++sys->block_frames < sys->block_size)
+        return;
+
+    sys->shortterm[sys->shortterm_index] = sys->block_sum / sys->block_frames;
+    sys->shortterm_index = (sys->shortterm_index + 1) % SHORTTERM_BLOCKS;
+    if (sys->shortterm_count < SHORTTERM_BLOCKS)
+        sys->shortterm_count++;
+    sys->block_sum = 0.;
+    sys->block_frames = 0;
+
+    if (sys->shortterm_count < MOMENTARY_BLOCKS)
+        return;
+
+    double power = 0.;
+    for (unsigned i = 0; i < sys->shortterm_count; ++i)
+        power += sys->shortterm[i];
+    power /= sys->shortterm_count;
+
+    double loudness = -0.691 + 10. * log10(power);
+    if (!(loudness > ABSOLUTE_GATE))
+        return; /* keep the gain during silences */
+
+    float gain = sys->target - loudness;
+    if (gain > sys->max_gain)
+        gain = sys->max_gain;
+    sys->gain_target = powf(10.f, gain / 20.f);
+}
+
+static float
+PeakRequirement(struct filter_sys *sys, const float *frame)
+{
+    float peak = 0.f;
+
+    for (unsigned c = 0; c < sys->channels; ++c)
+    {
+        float *hist = &sys->tp_history[c * 2 * TP_TAPS];
+
+        /* The history is doubled so that TP_TAPS consecutive samples are
+         * always available without wrapping */
+        hist[sys->tp_pos] = hist[sys->tp_pos + TP_TAPS] = frame[c];
+        const float *x = &hist[sys->tp_pos + 1];
+
+        float v = fabsf(frame[c]);
+        if (v > peak)
+            peak = v;
+
+        for (unsigned p = 0; p < TP_PHASES - 1; ++p)
+        {
+            float y = 0.f;
+            for (unsigned k = 0; k < TP_TAPS; ++k)
+                y += sys->tp_coefs[p][k] * x[k];
+            v = fabsf(y);
+            if (v > peak)
+                peak = v;
+        }
+    }
+    sys->tp_pos = (sys->tp_pos + 1) % TP_TAPS;
+
+    return peak > sys->ceiling ? sys->ceiling / peak : 1.f;
+}
+
+static float
+Limit(struct filter_sys *sys, float required)
+{
+    const unsigned window = sys->la_size + 1;
+    const uint64_t frame = sys->la_frame++;
+    float *req = sys->la_required;
+
+    /* Sliding minimum of the required gains over the lookahead */
+    if (sys->la_mins_count > 0
+     && sys->la_mins[sys->la_mins_head] + window <= frame)
+    {
+        sys->la_mins_head = (sys->la_mins_head + 1) % window;
+        sys->la_mins_count--;
+    }
+
+    req[frame % window] = required;
+
+    while (sys->la_mins_count > 0)
+    {
+        unsigned back = (sys->la_mins_head + sys->la_mins_count - 1) % window;
+        if (req[sys->la_mins[back] % window] < required)
+            break;
+        sys->la_mins_count--;
+    }
+    sys->la_mins[(sys->la_mins_head + sys->la_mins_count++) % window] = frame;
+
+    float target = req[sys->la_mins[sys->la_mins_head] % window];
+    float coef = target < sys->limiter_gain ? sys->attack_coef
+                                            : sys->release_coef;
+    sys->limiter_gain += (target - sys->limiter_gain) * coef;
+    return sys->limiter_gain;
+}
+
+static void
+ProcessFrames(struct filter_sys *sys, float *buf, unsigned frames)
+{
+    const unsigned channels = sys->channels;
+    float *delayed = sys->la_samples;
+
+    for (unsigned i = 0; i < frames; ++i, buf += channels)
+    {
+        if (!sys->fixed)
+        {
+            Measure(sys, buf);
+            sys->gain += (sys->gain_target - sys->gain) * sys->gain_coef;
+        }
+
+        for (unsigned c = 0; c < channels; ++c)
+            buf[c] *= sys->gain;
+
+        float gain = Limit(sys, PeakRequirement(sys, buf));
+
+        /* Swap with the frame from LOOKAHEAD ago */
+        float *slot = &delayed[(sys->la_frame % sys->la_size) * channels];
+        for (unsigned c = 0; c < channels; ++c)
+        {
+            float out = slot[c] * gain;
+            slot[c] = buf[c];
+
+            if (out > sys->ceiling)
+                out = sys->ceiling;
+            else if (out < -sys->ceiling)
+                out = -sys->ceiling;
+            buf[c] = out;
+        }
+    }
+}
+
+static block_t *
+Process(filter_t *filter, block_t *block)
+{
+    struct filter_sys *sys = filter->p_sys;
+
+    ProcessFrames(sys, (float *) block->p_buffer, block->i_nb_samples);
+
+    sys->next_pts = block->i_pts + block->i_length;
+    block->i_pts -= LOOKAHEAD;
+    block->i_dts = block->i_pts;
+    return block;
+}
+
+static block_t *
+Drain(filter_t *filter)
+{
+    struct filter_sys *sys = filter->p_sys;
+
+    if (sys->next_pts == VLC_TICK_INVALID)
+        return NULL;
+
+    block_t *block = block_Alloc(sys->la_size * sys->channels * sizeof (float));
+    if (unlikely(block == NULL))
+        return NULL;
+    memset(block->p_buffer, 0, block->i_buffer);
+    block->i_nb_samples = sys->la_size;
+    block->i_pts = block->i_dts = sys->next_pts - LOOKAHEAD;
+    block->i_length = LOOKAHEAD;
+
+    ProcessFrames(sys, (float *) block->p_buffer, block->i_nb_samples);
+    ResetLimiter(sys);
+    return block;
+}
+
+static void
+Flush(filter_t *filter)
+{
+    struct filter_sys *sys = filter->p_sys;
+
+    /* Same track: keep the measured loudness and the gain */
+    ResetLimiter(sys);
+}
+
+static void
+DeleteSys(struct filter_sys *sys)
+{
+    free(sys->kstate);
+    free(sys->weights);
+    free(sys->tp_history);
+    free(sys->la_samples);
+    free(sys->la_required);
+    free(sys->la_mins);
+    free(sys);
+}
+
+static void
+Close(filter_t *filter)
+{
+    DeleteSys(filter->p_sys);
+}
+
+static const struct vlc_filter_operations filter_ops = {
+    .filter_audio = Process, .drain_audio = Drain, .flush = Flush,
+    .close = Close,
+};
+
+static int Open(vlc_object_t *this)
+{
+    filter_t *filter = (filter_t *) this;
+    const unsigned channels = filter->fmt_in.audio.i_channels;
+    const unsigned rate = filter->fmt_in.audio.i_rate;
+
+    if (channels == 0 || rate == 0)
+        return VLC_EGENERIC;
+
+    static const char *const options[] = {
+        "target", "true-peak", "max-gain", NULL
+    };
+    config_ChainParse(filter, CFG_PREFIX, options, filter->p_cfg);
+
+    struct filter_sys *sys = malloc(sizeof(*sys));
+    if (sys == NULL)
+        return VLC_ENOMEM;
+
+    sys->channels = channels;
+    sys->target = var_InheritFloat(filter, CFG_PREFIX "target");
+    sys->ceiling = powf(10.f,
+                        var_InheritFloat(filter, CFG_PREFIX "true-peak") / 20.f);
+    sys->max_gain = var_InheritFloat(filter, CFG_PREFIX "max-gain");
+
+    sys->la_size = samples_from_vlc_tick(LOOKAHEAD, rate);
+    if (sys->la_size == 0)
+        sys->la_size = 1;
+    sys->kstate = calloc(channels, sizeof (*sys->kstate));
+    sys->weights = vlc_alloc(channels, sizeof (*sys->weights));
+    sys->tp_history = vlc_alloc(2 * TP_TAPS * channels,
+                                sizeof (*sys->tp_history));
+    sys->la_samples = vlc_alloc(sys->la_size * channels,
+                                sizeof (*sys->la_samples));
+    sys->la_required = vlc_alloc(sys->la_size + 1,
+                                 sizeof (*sys->la_required));
+    sys->la_mins = vlc_alloc(sys->la_size + 1, sizeof (*sys->la_mins));
+    if (sys->kstate == NULL || sys->weights == NULL || sys->tp_history == NULL
+     || sys->la_samples == NULL || sys->la_required == NULL
+     || sys->la_mins == NULL)
+    {
+        DeleteSys(sys);
+        return VLC_ENOMEM;
+    }
+
+    float gain = GainFromReplayGain(&filter->fmt_in.audio_replay_gain,
+                                    sys->target, &sys->fixed);
+    if (gain > sys->max_gain)
+        gain = sys->max_gain;
+    sys->gain = sys->gain_target = powf(10.f, gain / 20.f);
+    sys->gain_coef = 1.f - expf(-1.f / (GAIN_TIME_CONSTANT * rate));
+    if (sys->fixed)
+        msg_Dbg(filter, "track loudness known, applying %.1f dB", gain);
+
+    biquad_HighShelf(&sys->shelf, rate);
+    biquad_HighPass(&sys->highpass, rate);
+    InitChannelWeights(sys->weights, &filter->fmt_in.audio);
+    sys->block_sum = 0.;
+    sys->block_frames = 0;
+    sys->block_size = samples_from_vlc_tick(BLOCK_LENGTH, rate);
+    sys->shortterm_index = sys->shortterm_count = 0;
+
+    InitTruePeakCoefs(sys->tp_coefs);
+    /* Reach the required gain within the lookahead */
+    sys->attack_coef = 1.f - expf(-5.f / sys->la_size);
+    sys->release_coef = 1.f - expf(-1.f / (RELEASE_TIME_CONSTANT * rate));
+    ResetLimiter(sys);
+
+    filter->p_sys = sys;
+    filter->fmt_in.audio.i_format = VLC_CODEC_FL32;
+    aout_FormatPrepare(&filter->fmt_in.audio);
+    filter->fmt_out.audio = filter->fmt_in.audio;
+    filter->ops = &filter_ops;
+    return VLC_SUCCESS;
+}
+
+#define TARGET_TEXT N_("Target loudness (LUFS)")
+#define TARGET_LONGTEXT N_("Integrated loudness to normalize to. EBU R 128 " \
+    "uses -23 LUFS, ATSC A/85 -24 LKFS.")
+#define TRUE_PEAK_TEXT N_("Maximum true peak (dBTP)")
+#define TRUE_PEAK_LONGTEXT N_("The limiter keeps the oversampled peaks of " \
+    "the output under this level.")
+#define MAX_GAIN_TEXT N_("Maximum gain (dB)")
+#define MAX_GAIN_LONGTEXT N_("Upper bound of the gain applied to quiet " \
+    "content.")
+
+vlc_module_begin()
+    set_shortname(N_("Loudness normalizer"))
+    set_description(N_("EBU R 128 loudness normalizer"))
+    set_subcategory(SUBCAT_AUDIO_AFILTER)
+    add_float_with_range(CFG_PREFIX "target", -23.f, -70.f, 0.f,
+                         TARGET_TEXT, TARGET_LONGTEXT)
+    add_float_with_range(CFG_PREFIX "true-peak", -1.f, -20.f, 0.f,
+                         TRUE_PEAK_TEXT, TRUE_PEAK_LONGTEXT)
+    add_float_with_range(CFG_PREFIX "max-gain", 12.f, 0.f, 40.f,
+                         MAX_GAIN_TEXT, MAX_GAIN_LONGTEXT)
+    set_capability("audio filter", 0)
+    set_callback(Open)
+vlc_module_end()
@@ -56,6 +56,7 @@ typedef struct
     int i_nb;
     float *p_last;
     float f_max;
+    vlc_var_handle_t *max_level;
 } filter_sys_t;
 
 /*****************************************************************************
@@ -106,10 +107,20 @@ static int Open( vlc_object_t *p_this )
 
     if( p_sys->f_max <= 0 ) p_sys->f_max = 0.01;
 
+    /* The level is read for every buffer */
+    p_sys->max_level = var_HandleNew( vlc_object_parent(p_filter),
+                                      "norm-max-level", VLC_VAR_FLOAT );
+    if( !p_sys->max_level )
+    {
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
     /* We need to store (nb_buffers+1)*nb_channels floats */
     p_sys->p_last = calloc( i_channels * (p_sys->i_nb + 2), sizeof(float) );
     if( !p_sys->p_last )
     {
+        var_HandleDelete( p_sys->max_level );
         free( p_sys );
         return VLC_ENOMEM;
     }
@@ -188,8 +199,7 @@ static block_t *DoWork( filter_t *p_filter, block_t *p_in_buf )
         f_average = f_average / p_sys->i_nb;
 
         /* Seuil arbitraire */
-        p_sys->f_max = var_GetFloat( vlc_object_parent(p_filter),
-                                     "norm-max-level" );
+        p_sys->f_max = var_HandleGetFloat( p_sys->max_level );
 
         //fprintf(stderr,"Average %f, max %f\n", f_average, p_sys->f_max );
         if( f_average > p_sys->f_max )
@@ -228,6 +238,7 @@ static void Close( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
+    var_HandleDelete( p_sys->max_level );
     free( p_sys->p_last );
     free( p_sys );
 }
@@ -149,8 +149,13 @@ static int Open( vlc_object_t *p_this )
                       i_samplerate, p_sys->coeffs+3*5);
     CalcShelfEQCoeffs(p_sys->f_highf, 1, p_sys->f_highgain, 0,
                       i_samplerate, p_sys->coeffs+4*5);
-    p_sys->p_state = (float*)calloc( p_filter->fmt_in.audio.i_channels*5*4,
+    p_sys->p_state = (float*)calloc( p_filter->fmt_in.audio.i_channels*5*2,
                                      sizeof(float) );
+    if( !p_sys->p_state )
+    {
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
 
     return VLC_SUCCESS;
 }
@@ -281,7 +286,7 @@ static void CalcShelfEQCoeffs( float f0, float slope, float gainDB, int high,
 /*
   src is assumed to be interleaved
   dest is assumed to be interleaved
-  size of state is 4*channels*eqCount
+  size of state is 2*channels*eqCount
   samples is not premultiplied by channels
   size of coeffs is 5*eqCount
 */
@@ -289,37 +294,37 @@ void ProcessEQ( const float *src, float *dest, float *state,
                 unsigned channels, unsigned samples, const float *coeffs,
                 unsigned eqCount )
 {
-    unsigned i, chn, eq;
-    float   b0, b1, b2, a1, a2;
-    float   x, y = 0;
-    const float *src1 = src;
-    float *dest1 = dest;
+    if (dest != src)
+        memcpy(dest, src, sizeof (*dest) * channels * samples);
 
-    for (i = 0; i < samples; i++)
+    for (unsigned i = 0; i < samples; i++)
     {
+        const float *coeffs1 = coeffs;
         float *state1 = state;
-        for (chn = 0; chn < channels; chn++)
+
+        /* Transposed direct form 2 IIRs, the channels being independent from
+         * each other, they are processed together for each filter */
+        for (unsigned eq = 0; eq < eqCount; eq++)
         {
-            const float *coeffs1 = coeffs;
-            x = *src1++;
-            /* Direct form 1 IIRs */
-            for (eq = 0; eq < eqCount; eq++)
+            const float b0 = coeffs1[0];
+            const float b1 = coeffs1[1];
+            const float b2 = coeffs1[2];
+            const float a1 = coeffs1[3];
+            const float a2 = coeffs1[4];
+            float *restrict s1 = state1;
+            float *restrict s2 = state1 + channels;
+            float *restrict x = dest;
+
+            for (unsigned chn = 0; chn < channels; chn++)
             {
-                b0 = coeffs1[0];
-                b1 = coeffs1[1];
-                b2 = coeffs1[2];
-                a1 = coeffs1[3];
-                a2 = coeffs1[4];
-                coeffs1 += 5;
-                y = x*b0 + state1[0]*b1 + state1[1]*b2 - state1[2]*a1 - state1[3]*a2;
-                state1[1] = state1[0];
-                state1[0] = x;
-                state1[3] = state1[2];
-                state1[2] = y;
-                x = y;
-                state1 += 4;
+                const float y = b0 * x[chn] + s1[chn];
+                s1[chn] = b1 * x[chn] - a1 * y + s2[chn];
+                s2[chn] = b2 * x[chn] - a2 * y;
+                x[chn] = y;
             }
-            *dest1++ = y;
+            coeffs1 += 5;
+            state1 += 2 * channels;
         }
+        dest += channels;
     }
 }
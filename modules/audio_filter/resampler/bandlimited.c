@@ -41,9 +41,23 @@
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 #include <vlc_block.h>
+#include <vlc_cpu.h>
 
 #include <assert.h>
 
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define BANDLIMITED_SSE 1
+# include <xmmintrin.h>
+#endif
+#if defined(CAN_COMPILE_AVX)
+# define BANDLIMITED_AVX 1
+# include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+# define BANDLIMITED_NEON 1
+# include <arm_neon.h>
+#endif
+
 #include "bandlimited.h"
 
 /*****************************************************************************
@@ -62,14 +76,46 @@ static void ResampleFloat( filter_t *p_filter,
                            double d_factor, bool b_factor_old,
                            int i_nb_channels, int i_bytes_per_frame );
 
+struct bandlimited_table;
+static struct bandlimited_table *TableHold( unsigned, unsigned );
+static void TableRelease( struct bandlimited_table * );
+
 /*****************************************************************************
  * Local structures
  *****************************************************************************/
+
+/* Polyphase filter: the taps of every output phase, for a pair of rates.
+ * The phases are the multiples of the rates GCD, below the output rate.
+ * The tables are shared by all the instances using the same rates. */
+typedef struct bandlimited_table
+{
+    unsigned i_in_rate;
+    unsigned i_out_rate;
+    unsigned i_phase_step;         /* remainder increment between phases */
+    unsigned i_left;      /* taps up to, and including, the current frame */
+    unsigned i_taps;                                    /* taps per phase */
+    unsigned i_refs;
+    struct bandlimited_table *p_next;
+    float p_taps[];
+} bandlimited_table_t;
+
+/* Larger tables are not worth it: such rates are used for small clock
+ * drift corrections, which change too often. */
+#define BANDLIMITED_TABLE_MAX_PHASES 1024
+#define BANDLIMITED_TABLE_MAX_TAPS   (1 << 18)
+
+static vlc_mutex_t tables_lock = VLC_STATIC_MUTEX;
+static bandlimited_table_t *tables = NULL;
+
 typedef struct
 {
     int32_t *p_buf;                        /* this filter introduces a delay */
     size_t i_buf_size;
 
+    bandlimited_table_t *p_table;
+    float *p_taps;           /* taps of a single output, without a table */
+    size_t i_taps_size;
+
     double d_old_factor;
     size_t i_old_wing;
 
@@ -142,7 +188,7 @@ static block_t *Resample( filter_t * p_filter, block_t * p_in_buf )
                                  p_filter->fmt_out.audio.i_bitspersample / 8;
     size_t i_out_size = i_bytes_per_frame * ( 1 + ( p_in_buf->i_nb_samples *
               p_filter->fmt_out.audio.i_rate / p_filter->fmt_in.audio.i_rate) )
-            + p_filter->p_sys->i_buf_size;
+            + p_sys->i_buf_size;
     block_t *p_out_buf = block_Alloc( i_out_size );
     if( !p_out_buf )
     {
@@ -163,6 +209,17 @@ static block_t *Resample( filter_t * p_filter, block_t * p_in_buf )
         p_sys->b_first = false;
     }
 
+    /* The input rate of the audio resampler changes with the clock drift */
+    if( p_sys->p_table == NULL ||
+        p_sys->p_table->i_in_rate != p_filter->fmt_in.audio.i_rate ||
+        p_sys->p_table->i_out_rate != i_out_rate )
+    {
+        if( p_sys->p_table != NULL )
+            TableRelease( p_sys->p_table );
+        p_sys->p_table = TableHold( p_filter->fmt_in.audio.i_rate,
+                                    i_out_rate );
+    }
+
     size_t i_in_nb = p_in_buf->i_nb_samples;
     size_t i_in, i_out = 0;
     double d_factor, d_scale_factor, d_old_scale_factor;
@@ -300,12 +357,15 @@ static int OpenFilter( vlc_object_t *p_this )
     }
 
     /* Allocate the memory needed to store the module's structure */
-    p_filter->p_sys = p_sys = malloc( sizeof(struct filter_sys_t) );
+    p_filter->p_sys = p_sys = malloc( sizeof(*p_sys) );
     if( p_sys == NULL )
         return VLC_ENOMEM;
 
     p_sys->p_buf = NULL;
     p_sys->i_buf_size = 0;
+    p_sys->p_table = NULL;
+    p_sys->p_taps = NULL;
+    p_sys->i_taps_size = 0;
 
     p_sys->i_old_wing = 0;
     p_sys->b_first = true;
@@ -330,18 +390,26 @@ static int OpenFilter( vlc_object_t *p_this )
  *****************************************************************************/
 static void CloseFilter( filter_t *p_filter )
 {
-    free( p_filter->p_sys->p_buf );
-    free( p_filter->p_sys );
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->p_table != NULL )
+        TableRelease( p_sys->p_table );
+    free( p_sys->p_taps );
+    free( p_sys->p_buf );
+    free( p_sys );
 }
 
-static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing, float *p_in,
-                            float *p_out, uint32_t ui_remainder,
-                            uint32_t ui_output_rate, int16_t Inc, int i_nb_channels )
+/*****************************************************************************
+ * Filter taps
+ *****************************************************************************/
+static unsigned WingUP( float *taps, const float Imp[], const float ImpD[],
+                        uint16_t Nwing, uint32_t ui_remainder,
+                        uint32_t ui_output_rate, int16_t Inc )
 {
     const float *Hp, *Hdp, *End;
-    float t, temp;
+    float t;
     uint32_t ui_linear_remainder;
-    int i;
+    unsigned n = 0;
 
     Hp = &Imp[(ui_remainder<<Nhc)/ui_output_rate];
     Hdp = &ImpD[(ui_remainder<<Nhc)/ui_output_rate];
@@ -365,27 +433,23 @@ static void FilterFloatUP( const float Imp[], const float ImpD[], uint16_t Nwing
         t = *Hp;                /* Get filter coeff */
                                 /* t is now interp'd filter coeff */
         t += *Hdp * ui_linear_remainder / ui_output_rate / Npc;
-        for( i = 0; i < i_nb_channels; i++ )
-        {
-            temp = t;
-            temp *= *(p_in+i);  /* Mult coeff by input sample */
-            *(p_out+i) += temp; /* The filter output */
-        }
+        taps[n++] = t;
         Hdp += Npc;             /* Filter coeff differences step */
         Hp += Npc;              /* Filter coeff step */
-        p_in += (Inc * i_nb_channels); /* Input signal step */
     }
+    return n;
 }
 
-static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing, float *p_in,
-                           float *p_out, uint32_t ui_remainder,
-                           uint32_t ui_output_rate, uint32_t ui_input_rate,
-                           int16_t Inc, int i_nb_channels )
+static unsigned WingUD( float *taps, const float Imp[], const float ImpD[],
+                        uint16_t Nwing, uint32_t ui_remainder,
+                        uint32_t ui_output_rate, uint32_t ui_input_rate,
+                        int16_t Inc )
 {
     const float *Hp, *Hdp, *End;
-    float t, temp;
+    float t;
     uint32_t ui_linear_remainder;
-    int i, ui_counter = 0;
+    int ui_counter = 0;
+    unsigned n = 0;
 
     Hp = Imp + (ui_remainder<<Nhc) / ui_input_rate;
     Hdp = ImpD  + (ui_remainder<<Nhc) / ui_input_rate;
@@ -413,12 +477,7 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
           ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) /
           ui_input_rate * ui_input_rate;
         t += *Hdp * ui_linear_remainder / ui_input_rate / Npc;
-        for( i = 0; i < i_nb_channels; i++ )
-        {
-            temp = t;
-            temp *= *(p_in+i);  /* Mult coeff by input sample */
-            *(p_out+i) += temp; /* The filter output */
-        }
+        taps[n++] = t;
 
         ui_counter++;
 
@@ -428,9 +487,277 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
         /* Filter coeff differences step */
         Hdp = ImpD + ((ui_output_rate * ui_counter + ui_remainder)<< Nhc)
                      / ui_input_rate;
+    }
+    return n;
+}
 
-        p_in += (Inc * i_nb_channels); /* Input signal step */
+/* Upper bound of the taps count of a wing */
+static unsigned WingSize( bool b_up, unsigned i_in_rate, unsigned i_out_rate )
+{
+    if( b_up )
+        return SMALL_FILTER_NWING / Npc + 2;
+    return (uint64_t)SMALL_FILTER_NWING * i_in_rate / i_out_rate / Npc + 2;
+}
+
+/**
+ * Computes the taps of an output sample.
+ *
+ * taps[k] applies to the input frame k - (i_left - 1) frames away from the
+ * current one. Returns the count of taps, at most 2 * i_left.
+ */
+static unsigned BuildTaps( float *taps, unsigned i_left, bool b_up,
+                           uint32_t i_remainder,
+                           uint32_t i_out_rate, uint32_t i_in_rate )
+{
+    unsigned n_left, n_right;
+
+    /* The left wing goes backward from the current frame */
+    if( b_up )
+        n_left = WingUP( taps, SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
+                         SMALL_FILTER_NWING, i_remainder, i_out_rate, -1 );
+    else
+        n_left = WingUD( taps, SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
+                         SMALL_FILTER_NWING, i_remainder,
+                         i_out_rate, i_in_rate, -1 );
+    assert( n_left <= i_left );
+    for( unsigned i = 0; i < n_left / 2; i++ )
+    {
+        float t = taps[i];
+        taps[i] = taps[n_left - 1 - i];
+        taps[n_left - 1 - i] = t;
     }
+    memmove( taps + i_left - n_left, taps, n_left * sizeof(*taps) );
+    memset( taps, 0, (i_left - n_left) * sizeof(*taps) );
+
+    /* The right wing starts from the next frame */
+    if( b_up )
+        n_right = WingUP( taps + i_left, SMALL_FILTER_FLOAT_IMP,
+                          SMALL_FILTER_FLOAT_IMPD, SMALL_FILTER_NWING,
+                          i_out_rate - i_remainder, i_out_rate, 1 );
+    else
+        n_right = WingUD( taps + i_left, SMALL_FILTER_FLOAT_IMP,
+                          SMALL_FILTER_FLOAT_IMPD, SMALL_FILTER_NWING,
+                          i_out_rate - i_remainder, i_out_rate, i_in_rate, 1 );
+    assert( n_right <= i_left );
+    return i_left + n_right;
+}
+
+static bandlimited_table_t *TableHold( unsigned i_in_rate,
+                                       unsigned i_out_rate )
+{
+    bandlimited_table_t *p_table;
+
+    vlc_mutex_lock( &tables_lock );
+    for( p_table = tables; p_table != NULL; p_table = p_table->p_next )
+        if( p_table->i_in_rate == i_in_rate &&
+            p_table->i_out_rate == i_out_rate )
+        {
+            p_table->i_refs++;
+            goto out;
+        }
+
+    const unsigned i_step = GCD( i_in_rate, i_out_rate );
+    const unsigned i_phases = i_out_rate / i_step;
+    const bool b_up = i_out_rate >= i_in_rate;
+    const unsigned i_left = WingSize( b_up, i_in_rate, i_out_rate );
+    /* Even, for the stereo kernels */
+    const unsigned i_taps = 2 * i_left;
+
+    if( i_phases > BANDLIMITED_TABLE_MAX_PHASES ||
+        (size_t)i_phases * i_taps > BANDLIMITED_TABLE_MAX_TAPS )
+        goto out;
+
+    p_table = malloc( sizeof(*p_table) +
+                      (size_t)i_phases * i_taps * sizeof(float) );
+    if( unlikely(p_table == NULL) )
+        goto out;
+
+    p_table->i_in_rate = i_in_rate;
+    p_table->i_out_rate = i_out_rate;
+    p_table->i_phase_step = i_step;
+    p_table->i_left = i_left;
+    p_table->i_taps = i_taps;
+    p_table->i_refs = 1;
+    for( unsigned i = 0; i < i_phases; i++ )
+    {
+        float *taps = p_table->p_taps + i * i_taps;
+        unsigned n = BuildTaps( taps, i_left, b_up, i * i_step,
+                                i_out_rate, i_in_rate );
+        memset( taps + n, 0, (i_taps - n) * sizeof(*taps) );
+    }
+    p_table->p_next = tables;
+    tables = p_table;
+out:
+    vlc_mutex_unlock( &tables_lock );
+    return p_table;
+}
+
+static void TableRelease( bandlimited_table_t *p_table )
+{
+    vlc_mutex_lock( &tables_lock );
+    if( --p_table->i_refs == 0 )
+    {
+        bandlimited_table_t **pp = &tables;
+        while( *pp != p_table )
+            pp = &(*pp)->p_next;
+        *pp = p_table->p_next;
+        free( p_table );
+    }
+    vlc_mutex_unlock( &tables_lock );
+}
+
+/*****************************************************************************
+ * Inner products, over all the channels of the frames at once
+ *****************************************************************************/
+/* Applies the taps to the i_channels first channels of frames of
+ * i_nb_channels channels */
+static void ApplyTapsC( float *restrict p_out, const float *restrict p_in,
+                        const float *restrict taps, unsigned n,
+                        unsigned i_channels, unsigned i_nb_channels )
+{
+    for( unsigned k = 0; k < n; k++ )
+    {
+        const float t = taps[k];
+        if( t == 0.f )
+            continue;
+        for( unsigned c = 0; c < i_channels; c++ )
+            p_out[c] += t * p_in[k * i_nb_channels + c];
+    }
+}
+
+#ifdef BANDLIMITED_SSE
+/* Two stereo frames per vector: n must be even */
+VLC_SSE
+static void ApplyTapsStereoSSE( float *p_out, const float *p_in,
+                                const float *taps, unsigned n )
+{
+    __m128 acc = _mm_setzero_ps();
+
+    for( unsigned k = 0; k < n; k += 2 )
+    {
+        __m128 t = _mm_loadl_pi( _mm_setzero_ps(), (const __m64 *)(taps + k) );
+        t = _mm_unpacklo_ps( t, t );
+        acc = _mm_add_ps( acc, _mm_mul_ps( t, _mm_loadu_ps( p_in + 2 * k ) ) );
+    }
+    acc = _mm_add_ps( acc, _mm_movehl_ps( acc, acc ) );
+    acc = _mm_add_ps( acc, _mm_loadl_pi( _mm_setzero_ps(),
+                                         (const __m64 *)p_out ) );
+    _mm_storel_pi( (__m64 *)p_out, acc );
+}
+
+/* Four channels per vector: returns the count of processed channels */
+VLC_SSE
+static unsigned ApplyTaps4SSE( float *p_out, const float *p_in,
+                               const float *taps, unsigned n,
+                               unsigned i_nb_channels )
+{
+    unsigned c = 0;
+
+    for( ; c + 4 <= i_nb_channels; c += 4 )
+    {
+        __m128 acc = _mm_setzero_ps();
+
+        for( unsigned k = 0; k < n; k++ )
+            acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( taps[k] ),
+                        _mm_loadu_ps( p_in + k * i_nb_channels + c ) ) );
+        _mm_storeu_ps( p_out + c, _mm_add_ps( acc, _mm_loadu_ps( p_out + c ) ) );
+    }
+    return c;
+}
+#endif
+
+#ifdef BANDLIMITED_AVX
+VLC_AVX
+static void ApplyTaps8AVX( float *p_out, const float *p_in,
+                           const float *taps, unsigned n,
+                           unsigned i_nb_channels )
+{
+    for( unsigned c = 0; c < i_nb_channels; c += 8 )
+    {
+        __m256 acc = _mm256_setzero_ps();
+
+        for( unsigned k = 0; k < n; k++ )
+            acc = _mm256_add_ps( acc, _mm256_mul_ps( _mm256_set1_ps( taps[k] ),
+                        _mm256_loadu_ps( p_in + k * i_nb_channels + c ) ) );
+        _mm256_storeu_ps( p_out + c,
+                          _mm256_add_ps( acc, _mm256_loadu_ps( p_out + c ) ) );
+    }
+}
+#endif
+
+#ifdef BANDLIMITED_NEON
+static void ApplyTapsStereoNEON( float *p_out, const float *p_in,
+                                 const float *taps, unsigned n )
+{
+    float32x4_t acc = vdupq_n_f32( 0.f );
+
+    for( unsigned k = 0; k < n; k += 2 )
+    {
+        float32x2_t t = vld1_f32( taps + k );
+        float32x4_t tt = vcombine_f32( vdup_lane_f32( t, 0 ),
+                                       vdup_lane_f32( t, 1 ) );
+        acc = vmlaq_f32( acc, tt, vld1q_f32( p_in + 2 * k ) );
+    }
+    float32x2_t sum = vadd_f32( vget_low_f32( acc ), vget_high_f32( acc ) );
+    vst1_f32( p_out, vadd_f32( sum, vld1_f32( p_out ) ) );
+}
+
+static unsigned ApplyTaps4NEON( float *p_out, const float *p_in,
+                                const float *taps, unsigned n,
+                                unsigned i_nb_channels )
+{
+    unsigned c = 0;
+
+    for( ; c + 4 <= i_nb_channels; c += 4 )
+    {
+        float32x4_t acc = vdupq_n_f32( 0.f );
+
+        for( unsigned k = 0; k < n; k++ )
+            acc = vmlaq_n_f32( acc, vld1q_f32( p_in + k * i_nb_channels + c ),
+                               taps[k] );
+        vst1q_f32( p_out + c, vaddq_f32( acc, vld1q_f32( p_out + c ) ) );
+    }
+    return c;
+}
+#endif
+
+static void ApplyTaps( float *p_out, const float *p_in, const float *taps,
+                       unsigned n, unsigned i_nb_channels )
+{
+    unsigned c = 0;
+
+#ifdef BANDLIMITED_AVX
+    if( (i_nb_channels & 7) == 0 && vlc_CPU_AVX() )
+    {
+        ApplyTaps8AVX( p_out, p_in, taps, n, i_nb_channels );
+        return;
+    }
+#endif
+#ifdef BANDLIMITED_SSE
+    if( vlc_CPU_SSE2() )
+    {
+        if( i_nb_channels == 2 && (n & 1) == 0 )
+        {
+            ApplyTapsStereoSSE( p_out, p_in, taps, n );
+            return;
+        }
+        c = ApplyTaps4SSE( p_out, p_in, taps, n, i_nb_channels );
+    }
+#endif
+#ifdef BANDLIMITED_NEON
+    if( vlc_CPU_ARM_NEON() )
+    {
+        if( i_nb_channels == 2 && (n & 1) == 0 )
+        {
+            ApplyTapsStereoNEON( p_out, p_in, taps, n );
+            return;
+        }
+        c = ApplyTaps4NEON( p_out, p_in, taps, n, i_nb_channels );
+    }
+#endif
+    if( c < i_nb_channels )
+        ApplyTapsC( p_out + c, p_in + c, taps, n, i_nb_channels - c,
+                    i_nb_channels );
 }
 
 static int ReallocBuffer( block_t **pp_out_buf,
@@ -461,11 +788,31 @@ static void ResampleFloat( filter_t *p_filter,
                            int i_nb_channels, int i_bytes_per_frame )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
+    const unsigned i_in_rate = p_filter->fmt_in.audio.i_rate;
+    const unsigned i_out_rate = p_filter->fmt_out.audio.i_rate;
 
     float *p_in = *pp_in;
     size_t i_out = *pi_out;
     float *p_out = (float*)(*pp_out_buf)->p_buffer + i_out * i_nb_channels;
 
+    /* The UP taps are faster if we can use them */
+    const bool b_up = d_factor >= 1;
+    const bandlimited_table_t *p_table = p_sys->p_table;
+    if( p_table != NULL && (i_out_rate >= i_in_rate) != b_up )
+        p_table = NULL;
+
+    /* Taps computed on the fly, when the table does not apply */
+    const unsigned i_left = WingSize( b_up, i_in_rate, i_out_rate );
+    if( p_sys->i_taps_size < 2 * i_left )
+    {
+        float *p_taps = realloc( p_sys->p_taps,
+                                 2 * i_left * sizeof(*p_taps) );
+        if( unlikely(p_taps == NULL) )
+            return;
+        p_sys->p_taps = p_taps;
+        p_sys->i_taps_size = 2 * i_left;
+    }
+
     for( ; i_in < i_in_end; i_in++ )
     {
         if( b_factor_old && d_factor == 1 )
@@ -481,67 +828,45 @@ static void ResampleFloat( filter_t *p_filter,
             continue;
         }
 
-        while( p_sys->i_remainder < p_filter->fmt_out.audio.i_rate )
+        while( p_sys->i_remainder < i_out_rate )
         {
             if( ReallocBuffer( pp_out_buf, &p_out,
                                i_out, i_nb_channels, i_bytes_per_frame ) )
                 return;
 
-            if( d_factor >= 1 )
-            {
-                /* FilterFloatUP() is faster if we can use it */
-
-                /* Perform left-wing inner product */
-                FilterFloatUP( SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
-                               SMALL_FILTER_NWING, p_in, p_out,
-                               p_sys->i_remainder,
-                               p_filter->fmt_out.audio.i_rate,
-                               -1, i_nb_channels );
-                /* Perform right-wing inner product */
-                FilterFloatUP( SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
-                               SMALL_FILTER_NWING, p_in + i_nb_channels, p_out,
-                               p_filter->fmt_out.audio.i_rate -
-                               p_sys->i_remainder,
-                               p_filter->fmt_out.audio.i_rate,
-                               1, i_nb_channels );
+            const float *taps;
+            unsigned n, left;
 
-#if 0
-                /* Normalize for unity filter gain */
-                for( i = 0; i < i_nb_channels; i++ )
-                {
-                    *(p_out+i) *= d_old_scale_factor;
-                }
-#endif
+            if( p_table != NULL &&
+                p_sys->i_remainder % p_table->i_phase_step == 0 )
+            {
+                taps = p_table->p_taps + p_sys->i_remainder
+                       / p_table->i_phase_step * p_table->i_taps;
+                n = p_table->i_taps;
+                left = p_table->i_left;
             }
             else
             {
-                /* Perform left-wing inner product */
-                FilterFloatUD( SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
-                               SMALL_FILTER_NWING, p_in, p_out,
-                               p_sys->i_remainder,
-                               p_filter->fmt_out.audio.i_rate, p_filter->fmt_in.audio.i_rate,
-                               -1, i_nb_channels );
-                /* Perform right-wing inner product */
-                FilterFloatUD( SMALL_FILTER_FLOAT_IMP, SMALL_FILTER_FLOAT_IMPD,
-                               SMALL_FILTER_NWING, p_in + i_nb_channels, p_out,
-                               p_filter->fmt_out.audio.i_rate -
-                               p_sys->i_remainder,
-                               p_filter->fmt_out.audio.i_rate, p_filter->fmt_in.audio.i_rate,
-                               1, i_nb_channels );
+                n = BuildTaps( p_sys->p_taps, i_left, b_up,
+                               p_sys->i_remainder, i_out_rate, i_in_rate );
+                taps = p_sys->p_taps;
+                left = i_left;
             }
 
+            /* Perform both wings inner products */
+            ApplyTaps( p_out, p_in - (left - 1) * i_nb_channels, taps, n,
+                       i_nb_channels );
+
             p_out += i_nb_channels;
             i_out++;
 
-            p_sys->i_remainder += p_filter->fmt_in.audio.i_rate;
+            p_sys->i_remainder += i_in_rate;
         }
 
         p_in += i_nb_channels;
-        p_sys->i_remainder -= p_filter->fmt_out.audio.i_rate;
+        p_sys->i_remainder -= i_out_rate;
     }
 
     *pp_in  = p_in;
     *pi_out = i_out;
 }
-
-
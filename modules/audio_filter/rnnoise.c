@@ -24,17 +24,42 @@
 
 #include <vlc_common.h>
 #include <vlc_aout.h>
+#include <vlc_executor.h>
 #include <vlc_filter.h>
 #include <vlc_plugin.h>
 
 #include <rnnoise.h>
 
-typedef struct
+#define FRAME_SIZE 480
+
+/* The channels are denoised in parallel from this number of channels */
+#define THREADS_MIN_CHANNELS 3
+
+typedef struct filter_sys_t filter_sys_t;
+
+struct rnnoise_task
+{
+    struct vlc_runnable runnable;
+    filter_sys_t *owner;
+    unsigned i_first;
+    unsigned i_count;
+};
+
+struct filter_sys_t
 {
     DenoiseState **p_sts;
     float *p_scratch_buffer;
+    size_t i_scratch_stride; /* per channel, in samples */
     bool b_first;
-} filter_sys_t;
+
+    /* Current block, one FRAME_SIZE aligned plane per channel */
+    size_t i_stride;
+    unsigned i_nb_samples;
+
+    vlc_executor_t *executor;
+    unsigned i_tasks;
+    struct rnnoise_task tasks[];
+};
 
 static void
 Flush(filter_t *p_filter)
@@ -73,16 +98,25 @@ static DenoiseState **init_denoise_state(unsigned i_channels)
     return p_sts;
 }
 
+static void RunChannels(void *userdata)
+{
+    struct rnnoise_task *task = userdata;
+    filter_sys_t *p_sys = task->owner;
 
-#define FRAME_SIZE 480
+    for (unsigned i = task->i_first; i < task->i_first + task->i_count; i++)
+    {
+        float *plane = p_sys->p_scratch_buffer + i * p_sys->i_stride;
+        for (unsigned j = 0; j < p_sys->i_nb_samples; j += FRAME_SIZE)
+            rnnoise_process_frame(p_sys->p_sts[i], plane + j, plane + j);
+    }
+}
 
 static block_t *Process(filter_t *p_filter, block_t *p_block)
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     float *p_buffer = (float *)p_block->p_buffer;
-    const int i_channels = p_filter->fmt_in.audio.i_channels;
-
-    float *tmp = p_sys->p_scratch_buffer;
+    const unsigned i_channels = p_filter->fmt_in.audio.i_channels;
+    const unsigned i_nb_samples = p_block->i_nb_samples;
 
     if (unlikely(p_sys->p_sts == NULL))
     {
@@ -92,36 +126,50 @@ static block_t *Process(filter_t *p_filter, block_t *p_block)
             return p_block;
     }
 
-    for (int i_nb_samples = p_block->i_nb_samples; i_nb_samples > 0; i_nb_samples -= FRAME_SIZE)
+    /* The whole block is handled at once, padded to a whole number of
+     * frames, so that the channels only need to be synchronized once */
+    const size_t i_stride = (i_nb_samples + FRAME_SIZE - 1)
+                          / FRAME_SIZE * FRAME_SIZE;
+    if (i_stride > p_sys->i_scratch_stride)
     {
-        /* handle case where we have fewer than FRAME_SIZE samples left to process */
-        const unsigned frame_size = __MIN(FRAME_SIZE, i_nb_samples);
-
-        /* rnnoise processes blocks of 480 samples, and expects input to be in the 32768 scale. */
-        for (unsigned i = 0; i < frame_size; i++) {
-            for (int j = 0; j < i_channels; j++) {
-                tmp[i + j * frame_size] = p_buffer[i * i_channels + j] * 32768.f;
-            }
-        }
+        float *p_scratch = realloc(p_sys->p_scratch_buffer,
+                                   i_stride * i_channels * sizeof(*p_scratch));
+        if (unlikely(p_scratch == NULL))
+            return p_block;
+        p_sys->p_scratch_buffer = p_scratch;
+        p_sys->i_scratch_stride = i_stride;
+    }
+    p_sys->i_stride = i_stride;
+    p_sys->i_nb_samples = i_nb_samples;
 
-        for (int i = 0; i < i_channels; i++) {
-            rnnoise_process_frame(p_sys->p_sts[i], tmp + i * frame_size , tmp + i * frame_size);
-        }
+    /* rnnoise processes blocks of 480 samples, and expects input to be in the 32768 scale. */
+    for (unsigned j = 0; j < i_channels; j++) {
+        float *plane = p_sys->p_scratch_buffer + j * i_stride;
+        for (unsigned i = 0; i < i_nb_samples; i++)
+            plane[i] = p_buffer[i * i_channels + j] * 32768.f;
+        memset(plane + i_nb_samples, 0,
+               (i_stride - i_nb_samples) * sizeof(*plane));
+    }
 
-        /* Skip writing first frame to output (as per the examples) I guess to prime rnnoise? */
-        if(!p_sys->b_first)
-        {
-            for (unsigned i = 0; i < frame_size; i++) {
-                for (int j = 0; j < i_channels; j++) {
-                    p_buffer[i * i_channels + j] = tmp[i + j * frame_size] / 32768.f;
-                }
-            }
-        }
-        else
-        {
-            p_sys->b_first = false;
-        }
-        p_buffer += frame_size * i_channels;
+    /* The first group of channels is denoised by the calling thread */
+    for (unsigned i = 1; i < p_sys->i_tasks; i++)
+        vlc_executor_Submit(p_sys->executor, &p_sys->tasks[i].runnable);
+    RunChannels(&p_sys->tasks[0]);
+    if (p_sys->executor != NULL)
+        vlc_executor_WaitIdle(p_sys->executor);
+
+    /* Skip writing first frame to output (as per the examples) I guess to prime rnnoise? */
+    unsigned i_start = 0;
+    if (p_sys->b_first)
+    {
+        i_start = __MIN(FRAME_SIZE, i_nb_samples);
+        p_sys->b_first = false;
+    }
+
+    for (unsigned j = 0; j < i_channels; j++) {
+        const float *plane = p_sys->p_scratch_buffer + j * i_stride;
+        for (unsigned i = i_start; i < i_nb_samples; i++)
+            p_buffer[i * i_channels + j] = plane[i] / 32768.f;
     }
 
     return p_block;
@@ -132,32 +180,62 @@ static void Close( filter_t *obj )
     filter_t *p_filter = (filter_t *)obj;
     filter_sys_t *p_sys = p_filter->p_sys;
     Flush(p_filter);
+    if (p_sys->executor != NULL)
+        vlc_executor_Delete(p_sys->executor);
     free(p_sys->p_scratch_buffer);
 }
 
 static int Open (vlc_object_t *obj)
 {
     filter_t *p_filter = (filter_t *)obj;
+    unsigned i_channels = p_filter->fmt_in.audio.i_channels;
+
+    unsigned i_tasks = 1;
+    if (i_channels >= THREADS_MIN_CHANNELS)
+        i_tasks = VLC_CLIP(vlc_GetCPUCount(), 1, i_channels);
 
-    filter_sys_t *p_sys = p_filter->p_sys = vlc_obj_malloc(VLC_OBJECT(p_filter), sizeof(*p_sys));
+    filter_sys_t *p_sys = p_filter->p_sys =
+        vlc_obj_malloc(VLC_OBJECT(p_filter),
+                       sizeof(*p_sys) + i_tasks * sizeof(p_sys->tasks[0]));
     if(unlikely(!p_sys))
         return VLC_ENOMEM;
 
     p_sys->b_first = true;
+    p_sys->p_scratch_buffer = NULL;
+    p_sys->i_scratch_stride = 0;
+
+    p_sys->executor = NULL;
+    if (i_tasks > 1)
+    {
+        p_sys->executor = vlc_executor_New(i_tasks - 1);
+        if (p_sys->executor == NULL)
+            i_tasks = 1;
+    }
+
+    /* Spread the channels evenly over the tasks */
+    p_sys->i_tasks = i_tasks;
+    for (unsigned i = 0, i_first = 0; i < i_tasks; i++)
+    {
+        struct rnnoise_task *task = &p_sys->tasks[i];
+        task->runnable.run = RunChannels;
+        task->runnable.userdata = task;
+        task->owner = p_sys;
+        task->i_first = i_first;
+        task->i_count = (i_channels - i_first) / (i_tasks - i);
+        i_first += task->i_count;
+    }
 
-    int i_channels = p_filter->fmt_in.audio.i_channels;
     p_sys->p_sts = init_denoise_state(i_channels);
     if (unlikely(!p_sys->p_sts)) {
+        if (p_sys->executor != NULL)
+            vlc_executor_Delete(p_sys->executor);
         vlc_obj_free(VLC_OBJECT(p_filter), p_sys);
         return VLC_ENOMEM;
     }
 
-    p_sys->p_scratch_buffer = malloc(FRAME_SIZE * i_channels * sizeof(*p_sys->p_scratch_buffer));
-    if (unlikely(!p_sys->p_scratch_buffer)) {
-        Flush(p_filter);
-        vlc_obj_free(VLC_OBJECT(p_filter), p_sys);
-        return VLC_ENOMEM;
-    }
+    if (i_tasks > 1)
+        msg_Dbg(p_filter, "denoising %u channels with %u threads",
+                i_channels, i_tasks);
 
     p_filter->fmt_in.audio.i_format = VLC_CODEC_FL32;
     aout_FormatPrepare(&p_filter->fmt_in.audio);
@@ -32,6 +32,12 @@
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 #include <vlc_modules.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define SCALETEMPO_SSE 1
+# include <xmmintrin.h>
+#endif
 
 #include <stdatomic.h>
 #include <string.h> /* for memset */
@@ -55,6 +61,11 @@ static block_t *DoPitchWork( filter_t *, block_t * );
 # define MODULES_SHORTNAME N_("Scaletempo")
 #endif
 
+static const int quality_values[] = { 0, 1, 2 };
+static const char *const quality_texts[] = {
+    N_("Fast"), N_("Normal"), N_("Best"),
+};
+
 vlc_module_begin ()
     set_description( MODULE_DESC )
     set_shortname( MODULES_SHORTNAME )
@@ -67,6 +78,10 @@ vlc_module_begin ()
         N_("Overlap Length"), N_("Percentage of stride to overlap") )
     add_integer_with_range( "scaletempo-search", 14, 0, 200,
         N_("Search Length"), N_("Length in milliseconds to search for best overlap position") )
+    add_integer( "scaletempo-quality", 2, N_("Search Quality"),
+        N_("Fast and Normal compare the channels mixed together, Fast also "
+           "searches at a lower resolution first") )
+        change_integer_list( quality_values, quality_texts )
 #ifdef PITCH_SHIFTER
     add_float_with_range( "pitch-shift", 0, -12, 12,
         N_("Pitch Shift"), N_("Pitch shift in semitones.") )
@@ -101,6 +116,7 @@ typedef struct
     unsigned  ms_stride;
     double    percent_overlap;
     unsigned  ms_search;
+    int       quality;
     /* audio format */
     unsigned  samples_per_frame;  /* AKA number of channels */
     unsigned  bytes_per_sample;
@@ -127,7 +143,10 @@ typedef struct
     unsigned  frames_search;
     void     *buf_pre_corr;
     void     *table_window;
+    float    *buf_mix;       /* channels mixed together, for the search */
+    float    *buf_decimated; /* pre_corr and buf_mix at a lower resolution */
     unsigned(*best_overlap_offset)( filter_t *p_filter );
+    float   (*dot)( const float *, const float *, unsigned );
 #ifdef PITCH_SHIFTER
     /* pitch */
     filter_t * resampler;
@@ -135,6 +154,43 @@ typedef struct
 #endif
 } filter_sys_t;
 
+/*****************************************************************************
+ * dot: correlation of two buffers
+ *****************************************************************************/
+static float dot_float( const float *a, const float *b, unsigned n )
+{
+    float corr = 0;
+    for( unsigned i = 0; i < n; i++ )
+        corr += a[i] * b[i];
+    return corr;
+}
+
+#ifdef SCALETEMPO_SSE
+VLC_SSE
+static float dot_sse( const float *a, const float *b, unsigned n )
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    unsigned i = 0;
+
+    for( ; i + 8 <= n; i += 8 )
+    {
+        acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a + i ),
+                                             _mm_loadu_ps( b + i ) ) );
+        acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( a + i + 4 ),
+                                             _mm_loadu_ps( b + i + 4 ) ) );
+    }
+    acc0 = _mm_add_ps( acc0, acc1 );
+    acc0 = _mm_add_ps( acc0, _mm_movehl_ps( acc0, acc0 ) );
+    acc0 = _mm_add_ss( acc0, _mm_shuffle_ps( acc0, acc0, 1 ) );
+
+    float corr = _mm_cvtss_f32( acc0 );
+    for( ; i < n; i++ )
+        corr += a[i] * b[i];
+    return corr;
+}
+#endif
+
 /*****************************************************************************
  * best_overlap_offset: calculate best offset for overlap
  *****************************************************************************/
@@ -145,6 +201,7 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
     float best_corr = INT_MIN;
     unsigned best_off = 0;
     unsigned i, off;
+    const unsigned samples_corr = p->samples_overlap - p->samples_per_frame;
 
     pw  = p->table_window;
     po  = p->buf_overlap;
@@ -156,12 +213,7 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
 
     search_start = (float *)p->buf_queue + p->samples_per_frame;
     for( off = 0; off < p->frames_search; off++ ) {
-      float corr = 0;
-      float *ps = search_start;
-      ppc = p->buf_pre_corr;
-      for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-        corr += *ppc++ * *ps++;
-      }
+      float corr = p->dot( p->buf_pre_corr, search_start, samples_corr );
       if( corr > best_corr ) {
         best_corr = corr;
         best_off  = off;
@@ -172,6 +224,91 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
     return best_off * p->bytes_per_frame;
 }
 
+/* Decimation factor of the coarse search */
+#define SEARCH_DECIMATION 4
+
+static unsigned search_float( filter_t *p_filter, const float *pre_corr,
+                              const float *mix, unsigned frames_corr,
+                              unsigned off_start, unsigned off_end )
+{
+    filter_sys_t *p = p_filter->p_sys;
+    float best_corr = INT_MIN;
+    unsigned best_off = off_start;
+
+    for( unsigned off = off_start; off < off_end; off++ ) {
+      float corr = p->dot( pre_corr, mix + off, frames_corr );
+      if( corr > best_corr ) {
+        best_corr = corr;
+        best_off  = off;
+      }
+    }
+    return best_off;
+}
+
+static void decimate_float( float *dst, const float *src, unsigned n )
+{
+    for( unsigned i = 0; i < n; i++, src += SEARCH_DECIMATION ) {
+      float sum = 0;
+      for( unsigned j = 0; j < SEARCH_DECIMATION; j++ )
+        sum += src[j];
+      dst[i] = sum;
+    }
+}
+
+/*****************************************************************************
+ * best_overlap_offset_mix: calculate best offset for overlap on the channels
+ * mixed together, optionally with a coarse search first
+ *****************************************************************************/
+static unsigned best_overlap_offset_mix( filter_t *p_filter )
+{
+    filter_sys_t *p = p_filter->p_sys;
+    const unsigned channels = p->samples_per_frame;
+    const unsigned frames_corr = p->samples_overlap / channels - 1;
+    const unsigned frames_mix = p->frames_search + frames_corr;
+    float *pre_corr = p->buf_pre_corr;
+    const float *pw = p->table_window;
+    const float *po = (float *)p->buf_overlap + channels;
+    const float *pq = (float *)p->buf_queue + channels;
+
+    for( unsigned i = 0; i < frames_corr; i++ ) {
+      float sum = 0;
+      for( unsigned c = 0; c < channels; c++ )
+        sum += *po++;
+      pre_corr[i] = sum * pw[i * channels];
+    }
+    for( unsigned i = 0; i < frames_mix; i++ ) {
+      float sum = 0;
+      for( unsigned c = 0; c < channels; c++ )
+        sum += *pq++;
+      p->buf_mix[i] = sum;
+    }
+
+    unsigned off_start = 0, off_end = p->frames_search;
+    if( p->quality == 0 && p->frames_search >= 4 * SEARCH_DECIMATION
+     && frames_corr >= 4 * SEARCH_DECIMATION )
+    {
+        const unsigned corr_dec = frames_corr / SEARCH_DECIMATION;
+        const unsigned search_dec = p->frames_search / SEARCH_DECIMATION;
+        float *pre_corr_dec = p->buf_decimated;
+        float *mix_dec = p->buf_decimated + corr_dec;
+
+        decimate_float( pre_corr_dec, pre_corr, corr_dec );
+        decimate_float( mix_dec, p->buf_mix, search_dec + corr_dec );
+
+        unsigned best = SEARCH_DECIMATION *
+            search_float( p_filter, pre_corr_dec, mix_dec, corr_dec,
+                          0, search_dec );
+
+        /* Refine around the coarse result at full resolution */
+        off_start = best >= SEARCH_DECIMATION ? best - SEARCH_DECIMATION + 1 : 0;
+        off_end = __MIN( best + SEARCH_DECIMATION, p->frames_search );
+    }
+
+    unsigned best_off = search_float( p_filter, pre_corr, p->buf_mix,
+                                      frames_corr, off_start, off_end );
+    return best_off * p->bytes_per_frame;
+}
+
 /*****************************************************************************
  * output_overlap: blend end of previous stride with beginning of current stride
  *****************************************************************************/
@@ -351,6 +488,18 @@ static int reinit_buffers( filter_t *p_filter )
                 *pw++ = v;
         }
         p->best_overlap_offset = best_overlap_offset_float;
+
+        if( p->quality < 2 )
+        {
+            unsigned frames_mix = p->frames_search + frames_overlap;
+            p->buf_mix = vlc_alloc( frames_mix, sizeof (float) );
+            p->buf_decimated = vlc_alloc( ( frames_mix + frames_overlap )
+                                          / SEARCH_DECIMATION + 1,
+                                          sizeof (float) );
+            if( !p->buf_mix || !p->buf_decimated )
+                return VLC_ENOMEM;
+            p->best_overlap_offset = best_overlap_offset_mix;
+        }
     }
 
     unsigned new_size = ( p->frames_search + frames_stride + frames_overlap ) * p->bytes_per_frame;
@@ -420,15 +569,25 @@ static int Open( vlc_object_t *p_this )
     p_sys->ms_stride       = var_InheritInteger( p_this, "scaletempo-stride" );
     p_sys->percent_overlap = var_InheritFloat( p_this, "scaletempo-overlap" );
     p_sys->ms_search       = var_InheritInteger( p_this, "scaletempo-search" );
+    p_sys->quality         = var_InheritInteger( p_this, "scaletempo-quality" );
+
+    msg_Dbg( p_this, "params: %i stride, %.3f overlap, %i search, %i quality",
+             p_sys->ms_stride, p_sys->percent_overlap, p_sys->ms_search,
+             p_sys->quality );
 
-    msg_Dbg( p_this, "params: %i stride, %.3f overlap, %i search",
-             p_sys->ms_stride, p_sys->percent_overlap, p_sys->ms_search );
+    p_sys->dot = dot_float;
+#ifdef SCALETEMPO_SSE
+    if( vlc_CPU_SSE2() )
+        p_sys->dot = dot_sse;
+#endif
 
     p_sys->buf_queue      = NULL;
     p_sys->buf_overlap    = NULL;
     p_sys->table_blend    = NULL;
     p_sys->buf_pre_corr   = NULL;
     p_sys->table_window   = NULL;
+    p_sys->buf_mix        = NULL;
+    p_sys->buf_decimated  = NULL;
     p_sys->bytes_overlap  = 0;
     p_sys->bytes_queued   = 0;
     p_sys->bytes_to_slide = 0;
@@ -532,6 +691,8 @@ static void Close( filter_t *p_filter )
     free( p_sys->table_blend );
     free( p_sys->buf_pre_corr );
     free( p_sys->table_window );
+    free( p_sys->buf_mix );
+    free( p_sys->buf_decimated );
     free( p_sys );
 }
 
@@ -14,6 +14,7 @@ public:
         allpass();
     void    setbuffer(float *buf, int size);
     inline  float    process(float inp);
+    inline  void     processblock(float *io, int n);
     void    mute();
     void    setfeedback(float val);
     float    getfeedback();
@@ -42,6 +43,34 @@ inline float allpass::process(float input)
     return output;
 }
 
+// Filters n samples in place, see comb::processblock()
+
+inline void allpass::processblock(float *io, int n)
+{
+    const float fb = feedback;
+
+    while (n > 0)
+    {
+        int len = bufsize - bufidx;
+        if (len > n)
+            len = n;
+
+        float *buf = buffer + bufidx;
+        for (int i = 0; i < len; i++)
+        {
+            float input = io[i];
+            float bufout = undenormalise( buf[i] );
+            io[i] = -input + bufout;
+            buf[i] = input + (bufout*fb);
+        }
+
+        io += len;
+        n -= len;
+        bufidx += len;
+        if (bufidx >= bufsize) bufidx = 0;
+    }
+}
+
 #endif//_allpass
 
 //ends
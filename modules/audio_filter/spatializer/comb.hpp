@@ -19,6 +19,7 @@ public:
     comb();
     void    setbuffer(float *buf, int size);
     inline  float    process(float inp);
+    inline  void     processblock(const float *inp, float *acc, int n);
     void    mute();
     void    setdamp(float val);
     float    getdamp();
@@ -55,6 +56,39 @@ inline float comb::process(float input)
     return output;
 }
 
+// Accumulates the output for n input samples into acc.
+// Within a run that does not wrap around the buffer, each sample only
+// depends on the buffer contents from the previous round, so the loop
+// can be vectorized.
+
+inline void comb::processblock(const float *input, float *acc, int n)
+{
+    const float damp = damp2;
+    const float fb = feedback;
+
+    while (n > 0)
+    {
+        int len = bufsize - bufidx;
+        if (len > n)
+            len = n;
+
+        float *buf = buffer + bufidx;
+        for (int i = 0; i < len; i++)
+        {
+            float output = undenormalise( buf[i] );
+            float store = undenormalise( output*damp );
+            buf[i] = input[i] + store*fb;
+            acc[i] += output;
+        }
+
+        input += len;
+        acc += len;
+        n -= len;
+        bufidx += len;
+        if (bufidx >= bufsize) bufidx = 0;
+    }
+}
+
 #endif //_comb_
 
 //ends
@@ -8,11 +8,14 @@
 #ifndef _denormals_
 #define _denormals_
 
+#include <math.h>
+#include <float.h>
 
-#ifdef __cplusplus
-extern "C"
-#endif
-float undenormalise( float );
+/* Inlined, and without branches, so that the filter loops can be
+ * vectorized. Zero is the only normal value that is affected. */
+static inline float undenormalise( float f )
+{
+    return fabsf( f ) < FLT_MIN ? 0.f : f;
+}
 
 #endif//_denormals_
-
@@ -89,70 +89,75 @@ void revmodel::mute()
  * /param long numsamples  number of samples to be processed
  * /param int skip             number of channels in the audio stream
  *****************************************************************************/
-void revmodel::processreplace(float *inputL, float *outputL, long /* numsamples */, int skip)
+void revmodel::processreplace(float *inputL, float *outputL, long numsamples, int skip)
 {
-    float outL,outR,input;
-    float inputR;
-    int i;
-
-    outL = outR = 0;
-        /* TODO this module supports only 2 audio channels, let's improve this */
-        if (skip > 1)
-           inputR = inputL[1];
-        else
-           inputR = inputL[0];
-        input = (inputL[0] + inputR) * gain;
-
-        // Accumulate comb filters in parallel
-        for(i=0; i<numcombs; i++)
-        {
-            outL += combL[i].process(input);
-            outR += combR[i].process(input);
-        }
-
-        // Feed through allpasses in series
-        for(i=0; i<numallpasses; i++)
-        {
-            outL = allpassL[i].process(outL);
-            outR = allpassR[i].process(outR);
-        }
+    process(inputL, outputL, numsamples, skip, false);
+}
 
-        // Calculate output REPLACING anything already there
-        outputL[0] = (outL*wet1 + outR*wet2 + inputR*dry);
-           if (skip > 1)
-        outputL[1] = (outR*wet1 + outL*wet2 + inputR*dry);
+void revmodel::processmix(float *inputL, float *outputL, long numsamples, int skip)
+{
+    process(inputL, outputL, numsamples, skip, true);
 }
 
-void revmodel::processmix(float *inputL, float *outputL, long /* numsamples */, int skip)
+void revmodel::process(float *inputL, float *outputL, long numsamples, int skip,
+                       bool mix)
 {
-    float outL,outR,input;
-    float inputR;
+    /* The filters run on chunks of samples rather than one sample at a time,
+     * so that their loops can be vectorized */
+    const int chunk = 256;
+    float input[chunk], outL[chunk], outR[chunk];
 
-    outL = outR = 0;
-        if (skip > 1)
-           inputR = inputL[1];
-        else
-           inputR = inputL[0];
-        input = (inputL[0] + inputR) * gain;
+    while (numsamples > 0)
+    {
+        int n = numsamples < chunk ? (int)numsamples : chunk;
+        int i;
+
+        /* TODO this module supports only 2 audio channels, let's improve this */
+        const int right = skip > 1 ? 1 : 0;
+        for (i = 0; i < n; i++)
+        {
+            input[i] = (inputL[i * skip] + inputL[i * skip + right]) * gain;
+            outL[i] = outR[i] = 0;
+        }
 
         // Accumulate comb filters in parallel
-        for(int i=0; i<numcombs; i++)
+        for (i = 0; i < numcombs; i++)
         {
-            outL += combL[i].process(input);
-            outR += combR[i].process(input);
+            combL[i].processblock(input, outL, n);
+            combR[i].processblock(input, outR, n);
         }
 
         // Feed through allpasses in series
-        for(int i=0; i<numallpasses; i++)
+        for (i = 0; i < numallpasses; i++)
         {
-            outL = allpassL[i].process(outL);
-            outR = allpassR[i].process(outR);
+            allpassL[i].processblock(outL, n);
+            allpassR[i].processblock(outR, n);
         }
 
-        // Calculate output REPLACING anything already there
-        outputL[0] += (outL*wet1 + outR*wet2 + inputR*dry);
-           if (skip > 1)
-        outputL[1] += (outR*wet1 + outL*wet2 + inputR*dry);
+        for (i = 0; i < n; i++)
+        {
+            float inputR = inputL[right];
+            float l = outL[i]*wet1 + outR[i]*wet2 + inputR*dry;
+            float r = outR[i]*wet1 + outL[i]*wet2 + inputR*dry;
+
+            // Calculate output REPLACING or MIXING with anything already there
+            if (mix)
+            {
+                outputL[0] += l;
+                if (skip > 1)
+                    outputL[1] += r;
+            }
+            else
+            {
+                outputL[0] = l;
+                if (skip > 1)
+                    outputL[1] = r;
+            }
+            inputL += skip;
+            outputL += skip;
+        }
+        numsamples -= n;
+    }
 }
 
 void revmodel::update()
@@ -34,6 +34,8 @@ public:
     float    getwidth();
     void    setmode(float value);
 private:
+    void    process(float *inputL, float *outputL, long numsamples, int skip,
+                    bool mix);
     void    update();
 private:
     float    gain;
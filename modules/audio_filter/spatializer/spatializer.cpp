@@ -214,16 +214,16 @@ static void SpatFilter( filter_t *p_filter, float *out, float *in,
     filter_sys_t *p_sys = reinterpret_cast<filter_sys_t *>( p_filter->p_sys );
     vlc_mutex_locker locker( &p_sys->lock );
 
+    float *p = in;
     for( unsigned i = 0; i < i_samples; i++ )
     {
-        for( unsigned ch = 0 ; ch < 2; ch++)
+        for( unsigned ch = 0 ; ch < __MIN(i_channels, 2u); ch++)
         {
-            in[ch] = in[ch] * SPAT_AMP;
+            p[ch] = p[ch] * SPAT_AMP;
         }
-        p_sys->p_reverbm->processreplace( in, out , 1, i_channels);
-        in  += i_channels;
-        out += i_channels;
+        p += i_channels;
     }
+    p_sys->p_reverbm->processreplace( in, out, i_samples, i_channels );
 }
 
 static block_t *DoWork( filter_t * p_filter, block_t * p_in_buf )
@@ -33,6 +33,20 @@
 #include <vlc_plugin.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
+#include <vlc_cpu.h>
+
+#ifdef CAN_COMPILE_AVX
+# define VOLUME_AVX 1
+# include <immintrin.h>
+#endif
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define VOLUME_SSE 1
+# include <xmmintrin.h>
+#endif
+#ifdef __wasm_simd128__
+# define VOLUME_WASM 1
+# include <wasm_simd128.h>
+#endif
 
 /*****************************************************************************
  * Local prototypes
@@ -49,6 +63,59 @@ vlc_module_begin ()
     set_callback( Create )
 vlc_module_end ()
 
+#ifdef VOLUME_AVX
+VLC_AVX
+static size_t AVX_AmplifyFL32( float *p, size_t i_count, float f_multiplier )
+{
+    const __m256 mult = _mm256_set1_ps( f_multiplier );
+    size_t i = 0;
+
+    for( ; i + 16 <= i_count; i += 16 )
+    {
+        __m256 a = _mm256_loadu_ps( p + i );
+        __m256 b = _mm256_loadu_ps( p + i + 8 );
+        _mm256_storeu_ps( p + i, _mm256_mul_ps( a, mult ) );
+        _mm256_storeu_ps( p + i + 8, _mm256_mul_ps( b, mult ) );
+    }
+    return i;
+}
+#endif
+
+#ifdef VOLUME_SSE
+VLC_SSE
+static size_t SSE_AmplifyFL32( float *p, size_t i_count, float f_multiplier )
+{
+    const __m128 mult = _mm_set1_ps( f_multiplier );
+    size_t i = 0;
+
+    for( ; i + 8 <= i_count; i += 8 )
+    {
+        __m128 a = _mm_loadu_ps( p + i );
+        __m128 b = _mm_loadu_ps( p + i + 4 );
+        _mm_storeu_ps( p + i, _mm_mul_ps( a, mult ) );
+        _mm_storeu_ps( p + i + 4, _mm_mul_ps( b, mult ) );
+    }
+    return i;
+}
+#endif
+
+#ifdef VOLUME_WASM
+static size_t WASM_AmplifyFL32( float *p, size_t i_count, float f_multiplier )
+{
+    const v128_t mult = wasm_f32x4_splat( f_multiplier );
+    size_t i = 0;
+
+    for( ; i + 8 <= i_count; i += 8 )
+    {
+        v128_t a = wasm_v128_load( p + i );
+        v128_t b = wasm_v128_load( p + i + 4 );
+        wasm_v128_store( p + i, wasm_f32x4_mul( a, mult ) );
+        wasm_v128_store( p + i + 4, wasm_f32x4_mul( b, mult ) );
+    }
+    return i;
+}
+#endif
+
 /**
  * Mixes a new output buffer
  */
@@ -59,7 +126,24 @@ static void FilterFL32( audio_volume_t *p_volume, block_t *p_buffer,
         return; /* nothing to do */
 
     float *p = (float *)p_buffer->p_buffer;
-    for( size_t i = p_buffer->i_buffer / sizeof(*p); i > 0; i-- )
+    size_t i_count = p_buffer->i_buffer / sizeof(*p);
+    size_t i_done = 0;
+
+#ifdef VOLUME_AVX
+    if( vlc_CPU_AVX() )
+        i_done = AVX_AmplifyFL32( p, i_count, f_multiplier );
+#endif
+#ifdef VOLUME_SSE
+    if( i_done == 0 && vlc_CPU_SSE2() )
+        i_done = SSE_AmplifyFL32( p, i_count, f_multiplier );
+#endif
+#ifdef VOLUME_WASM
+    /* SIMD is a build-time feature of the WebAssembly module */
+    i_done = WASM_AmplifyFL32( p, i_count, f_multiplier );
+#endif
+
+    p += i_done;
+    for( size_t i = i_count - i_done; i > 0; i-- )
         *(p++) *= f_multiplier;
 
     (void) p_volume;
@@ -29,6 +29,20 @@
 #include <vlc_plugin.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
+#include <vlc_cpu.h>
+
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define VOLUME_SSE2 1
+# include <emmintrin.h>
+#endif
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# define VOLUME_AVX2 1
+# include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+# define VOLUME_NEON 1
+# include <arm_neon.h>
+#endif
 
 static int Activate (vlc_object_t *);
 
@@ -60,6 +74,87 @@ static void FilterS32N (audio_volume_t *vol, block_t *block, float volume)
     (void) vol;
 }
 
+/* The vector kernels amplify whole vectors of samples with 16-bit
+ * multipliers, and return the count of amplified samples. */
+#ifdef VOLUME_SSE2
+VLC_SSE
+static size_t SSE2_AmplifyS16 (int16_t *p, size_t count, int16_t mult)
+{
+    const __m128i m = _mm_set1_epi16 (mult);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128 ((const __m128i *)(p + i));
+        __m128i lo = _mm_mullo_epi16 (v, m);
+        __m128i hi = _mm_mulhi_epi16 (v, m);
+        __m128i a = _mm_srai_epi32 (_mm_unpacklo_epi16 (lo, hi), 8);
+        __m128i b = _mm_srai_epi32 (_mm_unpackhi_epi16 (lo, hi), 8);
+        _mm_storeu_si128 ((__m128i *)(p + i), _mm_packs_epi32 (a, b));
+    }
+    return i;
+}
+#endif
+
+#ifdef VOLUME_AVX2
+VLC_AVX2
+static size_t AVX2_AmplifyS16 (int16_t *p, size_t count, int16_t mult)
+{
+    const __m256i m = _mm256_set1_epi16 (mult);
+    size_t i = 0;
+
+    /* Unpacking and packing both work within 128-bit lanes: the samples
+     * come back in order. */
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256 ((const __m256i *)(p + i));
+        __m256i lo = _mm256_mullo_epi16 (v, m);
+        __m256i hi = _mm256_mulhi_epi16 (v, m);
+        __m256i a = _mm256_srai_epi32 (_mm256_unpacklo_epi16 (lo, hi), 8);
+        __m256i b = _mm256_srai_epi32 (_mm256_unpackhi_epi16 (lo, hi), 8);
+        _mm256_storeu_si256 ((__m256i *)(p + i), _mm256_packs_epi32 (a, b));
+    }
+    return i;
+}
+#endif
+
+#ifdef VOLUME_NEON
+static size_t NEON_AmplifyS16 (int16_t *p, size_t count, int16_t mult)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t v = vld1q_s16 (p + i);
+        int32x4_t a = vmull_n_s16 (vget_low_s16 (v), mult);
+        int32x4_t b = vmull_n_s16 (vget_high_s16 (v), mult);
+        vst1q_s16 (p + i, vcombine_s16 (vqshrn_n_s32 (a, 8),
+                                        vqshrn_n_s32 (b, 8)));
+    }
+    return i;
+}
+#endif
+
+static size_t AmplifyS16 (int16_t *p, size_t count, int_fast32_t mult)
+{
+    if (mult > INT16_MAX)
+        return 0;
+#ifdef VOLUME_AVX2
+    if (vlc_CPU_AVX2 ())
+        return AVX2_AmplifyS16 (p, count, mult);
+#endif
+#ifdef VOLUME_SSE2
+    if (vlc_CPU_SSE2 ())
+        return SSE2_AmplifyS16 (p, count, mult);
+#endif
+#ifdef VOLUME_NEON
+    if (vlc_CPU_ARM_NEON ())
+        return NEON_AmplifyS16 (p, count, mult);
+#endif
+    (void) p; (void) count;
+    return 0;
+}
+
 static void FilterS16N (audio_volume_t *vol, block_t *block, float volume)
 {
     int16_t *p = (int16_t *)block->p_buffer;
@@ -68,7 +163,11 @@ static void FilterS16N (audio_volume_t *vol, block_t *block, float volume)
     if (mult == (1 << 8))
         return;
 
-    for (size_t n = block->i_buffer / sizeof (*p); n > 0; n--)
+    size_t count = block->i_buffer / sizeof (*p);
+    size_t done = AmplifyS16 (p, count, mult);
+    p += done;
+
+    for (size_t n = count - done; n > 0; n--)
     {
         int_fast32_t s = (*p * (int_fast32_t)mult) >> 8;
         if (s > INT16_MAX)
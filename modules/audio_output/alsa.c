@@ -110,6 +110,7 @@ typedef struct
     vlc_fourcc_t format; /**< Sample format */
     uint8_t chans_table[AOUT_CHAN_MAX]; /**< Channels order table */
     uint8_t chans_to_reorder; /**< Number of channels to reorder */
+    bool mmap; /**< Direct ring buffer access (low-latency mode) */
 
     bool soft_mute;
     float soft_gain;
@@ -326,7 +327,9 @@ static void * InjectionThread(void * data)
         }
 
         vlc_frame_t * f = sys->frame_chain;
-        snd_pcm_sframes_t frames = snd_pcm_writei(pcm, f->p_buffer, f->i_nb_samples);
+        snd_pcm_sframes_t frames =
+            sys->mmap ? snd_pcm_mmap_writei(pcm, f->p_buffer, f->i_nb_samples)
+                      : snd_pcm_writei(pcm, f->p_buffer, f->i_nb_samples);
         if (frames >= 0)
         {
             size_t bytes = snd_pcm_frames_to_bytes(pcm, frames);
@@ -814,8 +817,18 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
         goto error;
     }
 
-    val = snd_pcm_hw_params_set_access (pcm, hw,
-                                        SND_PCM_ACCESS_RW_INTERLEAVED);
+    /* In low-latency mode, write directly into the device ring buffer to
+     * avoid the intermediate copy and the extra period of latency of some
+     * plugins. Fall back to read/write access if unsupported. */
+    const bool low_latency = var_InheritBool (aout, "audio-low-latency");
+    sys->mmap = low_latency
+        && snd_pcm_hw_params_set_access (pcm, hw,
+                                         SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+    if (sys->mmap)
+        val = 0;
+    else
+        val = snd_pcm_hw_params_set_access (pcm, hw,
+                                            SND_PCM_ACCESS_RW_INTERLEAVED);
     if (val)
     {
         msg_Err (aout, "cannot set access mode: %s", snd_strerror (val));
@@ -891,7 +904,7 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
     sys->rate = fmt->i_rate;
 
 #if 1 /* work-around for period-long latency outputs (e.g. PulseAudio): */
-    param = AOUT_MIN_PREPARE_TIME;
+    param = low_latency ? AOUT_LOW_LATENCY_TIME / 4 : AOUT_MIN_PREPARE_TIME;
     val = snd_pcm_hw_params_set_period_time_near (pcm, hw, &param, NULL);
     if (val)
     {
@@ -900,7 +913,7 @@ static int Start (audio_output_t *aout, audio_sample_format_t *restrict fmt)
     }
 #endif
     /* Set buffer size */
-    param = AOUT_MAX_ADVANCE_TIME;
+    param = low_latency ? AOUT_LOW_LATENCY_TIME : AOUT_MAX_ADVANCE_TIME;
     val = snd_pcm_hw_params_set_buffer_time_near (pcm, hw, &param, NULL);
     if (val)
     {
@@ -87,6 +87,11 @@ typedef struct
         };
     };
     void (*play) (void *opaque, const void *data, unsigned count, int64_t pts);
+    /* NOTE: the prototype must match the LibVLC trampoline */
+    void (*frame) (void *opaque, block_t *block,
+                   const audio_sample_format_t *fmt, vlc_tick_t date);
+    void *frame_opaque;
+    audio_sample_format_t fmt;
     void (*pause) (void *opaque, int64_t pts);
     void (*resume) (void *opaque, int64_t pts);
     void (*flush) (void *opaque);
@@ -103,6 +108,12 @@ static void Play(audio_output_t *aout, block_t *block, vlc_tick_t date)
     aout_sys_t *sys = aout->sys;
 
     vlc_mutex_lock(&sys->lock);
+    if (sys->frame != NULL)
+    {   /* The application takes over the block, no copy */
+        sys->frame(sys->frame_opaque, block, &sys->fmt, date);
+        vlc_mutex_unlock(&sys->lock);
+        return;
+    }
     sys->play(sys->opaque, block->p_buffer, block->i_nb_samples, US_FROM_VLC_TICK(date));
     vlc_mutex_unlock(&sys->lock);
     block_Release (block);
@@ -223,10 +234,21 @@ static int Start (audio_output_t *aout, audio_sample_format_t * restrict fmt)
     if (aout_FormatNbChannels(fmt) == 0)
         return VLC_EGENERIC;
 
+    /* Frames are handed over as they come: propose the input format as is,
+     * so that multichannel float audio is not converted unless requested */
+    const unsigned in_channels = aout_FormatNbChannels(fmt);
+    if (sys->frame != NULL)
+    {
+        strcpy(format, "FL32");
+        for (i_idx = 0; i_idx < AMEM_NB_FORMATS; i_idx++)
+            if (fmt->i_format == format_list_fourcc[i_idx])
+                strcpy(format, format_list[i_idx]);
+    }
+
     vlc_mutex_lock(&sys->lock);
     if (sys->setup != NULL)
     {
-        channels = aout_FormatNbChannels(fmt);
+        channels = in_channels;
 
         sys->opaque = sys->setup_opaque;
         if (sys->setup (&sys->opaque, format, &fmt->i_rate, &channels))
@@ -235,6 +257,10 @@ static int Start (audio_output_t *aout, audio_sample_format_t * restrict fmt)
             return VLC_EGENERIC;
         }
     }
+    else if (sys->frame != NULL && sys->rate == 0)
+    {   /* No format requested: keep the proposed one */
+        channels = in_channels;
+    }
     else
     {
         char *psz_format;
@@ -293,6 +319,10 @@ static int Start (audio_output_t *aout, audio_sample_format_t * restrict fmt)
     }
 
     /* channel mapping */
+    if (sys->frame != NULL && channels == in_channels
+     && fmt->channel_type == AUDIO_CHANNEL_TYPE_BITMAP)
+        ; /* keep the input layout, not to remix */
+    else
     switch (channels)
     {
         case 1:
@@ -327,6 +357,7 @@ static int Start (audio_output_t *aout, audio_sample_format_t * restrict fmt)
     }
 
     fmt->channel_type = AUDIO_CHANNEL_TYPE_BITMAP;
+    sys->fmt = *fmt;
     return VLC_SUCCESS;
 }
 
@@ -353,6 +384,8 @@ static int Open (vlc_object_t *obj)
     }
 
     sys->play = var_InheritAddress (obj, "amem-play");
+    sys->frame = var_InheritAddress (obj, "amem-frame");
+    sys->frame_opaque = var_InheritAddress (obj, "amem-frame-data");
     sys->pause = var_InheritAddress (obj, "amem-pause");
     sys->resume = var_InheritAddress (obj, "amem-resume");
     sys->flush = var_InheritAddress (obj, "amem-flush");
@@ -363,7 +396,7 @@ static int Open (vlc_object_t *obj)
     sys->ready = false;
     vlc_mutex_init(&sys->lock);
 
-    if (sys->play == NULL)
+    if (sys->play == NULL && sys->frame == NULL)
     {
         free (sys);
         return VLC_EGENERIC;
@@ -896,6 +896,15 @@ static int Start(audio_output_t *aout, audio_sample_format_t *restrict fmt)
     attr.minreq = pa_usec_to_bytes(AOUT_MIN_PREPARE_TIME, &ss);
     attr.fragsize = 0; /* not used for output */
 
+    if (var_InheritBool(aout, "audio-low-latency"))
+    {
+        /* Let the server (or PipeWire) shrink the sink latency to match the
+         * requested target length. */
+        flags |= PA_STREAM_ADJUST_LATENCY;
+        attr.tlength = pa_usec_to_bytes(AOUT_LOW_LATENCY_TIME, &ss);
+        attr.minreq = pa_usec_to_bytes(AOUT_LOW_LATENCY_TIME / 4, &ss);
+    }
+
     pa_cvolume *cvolume = NULL, cvolumebuf;
     if (PA_VOLUME_IS_VALID(sys->volume_force))
     {
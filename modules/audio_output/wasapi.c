@@ -777,7 +777,7 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
     WAVEFORMATEXTENSIBLE *pwfe = &wf_iec61937.FormatExt;
     WAVEFORMATEX *pwf = &pwfe->Format, *pwf_closest, *pwf_mix = NULL;
     AUDCLNT_SHAREMODE shared_mode;
-    REFERENCE_TIME buffer_duration;
+    REFERENCE_TIME buffer_duration, periodicity = 0;
     audio_sample_format_t fmt = *pfmt;
     bool b_spdif = AOUT_FMT_SPDIF(&fmt);
     bool b_hdmi = AOUT_FMT_HDMI(&fmt);
@@ -847,6 +847,27 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
             hr = IAudioClient_IsFormatSupported(sys->client, shared_mode,
                                                 pwf, &pwf_closest);
         }
+
+        if (var_InheritBool(s, "audio-low-latency"))
+        {
+            if (shared_mode == AUDCLNT_SHAREMODE_EXCLUSIVE)
+            {
+                /* Event-driven exclusive streams require the buffer duration
+                 * to match the periodicity: use the smallest period the
+                 * device supports. */
+                REFERENCE_TIME def_period, min_period;
+                if (SUCCEEDED(IAudioClient_GetDevicePeriod(sys->client,
+                                                           &def_period,
+                                                           &min_period)))
+                {
+                    buffer_duration = periodicity = min_period;
+                    msg_Dbg(s, "low-latency exclusive period: %"PRId64" us",
+                            (int64_t) VLC_TICK_FROM_MSFTIME(min_period));
+                }
+            }
+            else
+                buffer_duration = MSFTIME_FROM_VLC_TICK(AOUT_LOW_LATENCY_TIME);
+        }
     }
     else
         hr = E_FAIL;
@@ -889,7 +910,7 @@ static HRESULT Start(aout_stream_t *s, audio_sample_format_t *restrict pfmt,
 
     hr = IAudioClient_Initialize(sys->client, shared_mode,
                                  AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
-                                 buffer_duration, 0, pwf, sid);
+                                 buffer_duration, periodicity, pwf, sid);
     CoTaskMemFree(pwf_closest);
     if (FAILED(hr))
     {
@@ -265,6 +265,21 @@ static int lavc_UpdateVideoFormat(decoder_t *dec, AVCodecContext *ctx,
     fmt_out.p_palette = dec->fmt_out.video.p_palette;
     dec->fmt_out.video.p_palette = NULL;
 
+    /* The pictures of a new format come from a new pool: give direct
+     * rendering another chance */
+    if (fmt_out.i_chroma != dec->fmt_out.video.i_chroma ||
+        fmt_out.i_width != dec->fmt_out.video.i_width ||
+        fmt_out.i_height != dec->fmt_out.video.i_height)
+        p_sys->b_dr_failure = false;
+
+    /* Besides the references, libavcodec holds the pictures being decoded by
+     * the other frame threads and the ones waiting for reordering. The
+     * reordering depth is only known once the stream headers are parsed
+     * and may increase while decoding: the pool grows accordingly. */
+    dec->i_extra_picture_buffers = __MAX(ctx->has_b_frames, 0);
+    if (ctx->active_thread_type & FF_THREAD_FRAME)
+        dec->i_extra_picture_buffers += 2 * ctx->thread_count;
+
     vlc_fourcc_t i_chroma;
     if (fmt == swfmt)
         i_chroma = fmt_out.i_chroma;
@@ -1524,9 +1539,12 @@ static int lavc_dr_GetFrame(struct AVCodecContext *ctx, AVFrame *frame)
 
     avcodec_align_dimensions2(ctx, &width, &height, aligns);
 
-    /* Check that the picture is suitable for libavcodec */
-    assert(pic->p[0].i_pitch >= width * pic->p[0].i_pixel_pitch);
-    assert(pic->p[0].i_lines >= height);
+    /* Check that the picture is suitable for libavcodec. Frames larger than
+     * the output format (e.g. with reference scaling) use an internal buffer
+     * and are copied, without disabling direct rendering for the others. */
+    if (pic->p[0].i_pitch < width * pic->p[0].i_pixel_pitch ||
+        pic->p[0].i_lines < height)
+        goto error;
 
     for (int i = 0; i < pic->i_planes; i++)
     {
@@ -209,9 +209,22 @@ typedef struct
     } last;
 } eia608_t;
 
+/* Last conversion of a displayed row, reused while the row is unchanged */
+typedef struct
+{
+    uint8_t characters[EIA608_SCREEN_COLUMNS+1];
+    eia608_color_t colors[EIA608_SCREEN_COLUMNS+1];
+    eia608_font_t fonts[EIA608_SCREEN_COLUMNS+1];
+    text_segment_t *p_segments;
+    bool b_valid;
+} eia608_row_cache_t;
+
 static void         Eia608Init( eia608_t * );
 static eia608_status_t Eia608Parse( eia608_t *h, int i_channel_selected, const uint8_t data[2] );
-static void         Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t *h );
+static bool         Eia608IsBlank( const eia608_t *h );
+static void         Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t *h,
+                                              eia608_row_cache_t *p_rows );
+static void         Eia608CleanRowsCache( eia608_row_cache_t *p_rows );
 
 /* It will be enough up to 63 B frames, which is far too high for
  * broadcast environment */
@@ -230,6 +243,8 @@ typedef struct
 
     cea708_t *p_cea708;
     eia608_t *p_eia608;
+    eia608_row_cache_t eia608_rows[EIA608_SCREEN_ROWS];
+    bool b_blank_queued; /* an empty screen was last output */
     bool b_opaque;
 } decoder_sys_t;
 
@@ -326,6 +341,7 @@ static void Flush( decoder_t *p_dec )
     if( p_sys->p_eia608 )
     {
         Eia608Init( p_sys->p_eia608 );
+        p_sys->b_blank_queued = false;
     }
     else
     {
@@ -373,6 +389,7 @@ static int Decode( decoder_t *p_dec, block_t *p_block )
             if( p_sys->p_eia608 )
             {
                 Eia608Init( p_sys->p_eia608 );
+                p_sys->b_blank_queued = false;
             }
             else
             {
@@ -418,6 +435,7 @@ static void Close( vlc_object_t *p_this )
     decoder_sys_t *p_sys = p_dec->p_sys;
 
     free( p_sys->p_eia608 );
+    Eia608CleanRowsCache( p_sys->eia608_rows );
     if( p_sys->p_cea708 )
     {
         CEA708_Decoder_Release( p_sys->p_cea708 );
@@ -531,7 +549,7 @@ static subpicture_t *Subtitle( decoder_t *p_dec, eia608_t *h, vlc_tick_t i_pts )
                                                  FONT_TO_LINE_HEIGHT_RATIO;
     p_spu_sys->p_default_style->i_features |= (STYLE_HAS_FONT_COLOR | STYLE_HAS_FLAGS);
 
-    Eia608FillUpdaterRegions( p_spu_sys, h );
+    Eia608FillUpdaterRegions( p_spu_sys, h, p_dec_sys->eia608_rows );
 
     return p_spu;
 }
@@ -564,9 +582,17 @@ static void Convert( decoder_t *p_dec, vlc_tick_t i_pts,
                 if( i_status & (EIA608_STATUS_DISPLAY | EIA608_STATUS_CHANGED) )
                 {
                     Debug(printf("\n"));
-                    subpicture_t *p_spu = Subtitle( p_dec, p_sys->p_eia608, i_spupts );
-                    if( p_spu )
-                        decoder_QueueSub( p_dec, p_spu );
+                    /* Clearing an already cleared screen changes nothing */
+                    const bool b_blank = Eia608IsBlank( p_sys->p_eia608 );
+                    if( !b_blank || !p_sys->b_blank_queued )
+                    {
+                        subpicture_t *p_spu = Subtitle( p_dec, p_sys->p_eia608, i_spupts );
+                        if( p_spu )
+                        {
+                            decoder_QueueSub( p_dec, p_spu );
+                            p_sys->b_blank_queued = b_blank;
+                        }
+                    }
                 }
             }
             else if( p_sys->p_cea708 && (p_buffer[0] & 0x03) >= 2 )
@@ -1234,7 +1260,47 @@ static text_segment_t * Eia608TextLine( struct eia608_screen *screen, int i_row
     return p_segments_head;
 }
 
-static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t *h )
+static text_segment_t * Eia608TextLineCached( struct eia608_screen *screen, int i_row,
+                                               eia608_row_cache_t *p_cache )
+{
+    if( !p_cache->b_valid ||
+        memcmp( p_cache->characters, screen->characters[i_row], sizeof(p_cache->characters) ) ||
+        memcmp( p_cache->colors, screen->colors[i_row], sizeof(p_cache->colors) ) ||
+        memcmp( p_cache->fonts, screen->fonts[i_row], sizeof(p_cache->fonts) ) )
+    {
+        text_segment_ChainDelete( p_cache->p_segments );
+        p_cache->p_segments = Eia608TextLine( screen, i_row );
+        memcpy( p_cache->characters, screen->characters[i_row], sizeof(p_cache->characters) );
+        memcpy( p_cache->colors, screen->colors[i_row], sizeof(p_cache->colors) );
+        memcpy( p_cache->fonts, screen->fonts[i_row], sizeof(p_cache->fonts) );
+        p_cache->b_valid = true;
+    }
+    return text_segment_Copy( p_cache->p_segments );
+}
+
+static void Eia608CleanRowsCache( eia608_row_cache_t *p_rows )
+{
+    for( int i = 0; i < EIA608_SCREEN_ROWS; i++ )
+    {
+        text_segment_ChainDelete( p_rows[i].p_segments );
+        p_rows[i].p_segments = NULL;
+        p_rows[i].b_valid = false;
+    }
+}
+
+static bool Eia608IsBlank( const eia608_t *h )
+{
+    const struct eia608_screen *screen = &h->screen[h->i_screen];
+    for( int i = 0; i < EIA608_SCREEN_ROWS; i++ )
+    {
+        if( screen->row_used[i] )
+            return false;
+    }
+    return true;
+}
+
+static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t *h,
+                                      eia608_row_cache_t *p_rows )
 {
     struct eia608_screen *screen = &h->screen[h->i_screen];
     substext_updater_region_t *p_region = &p_updater->region;
@@ -1246,7 +1312,7 @@ static void Eia608FillUpdaterRegions( subtext_updater_sys_t *p_updater, eia608_t
         if( !screen->row_used[i] )
             continue;
 
-        text_segment_t *p_segments = Eia608TextLine( screen, i );
+        text_segment_t *p_segments = Eia608TextLineCached( screen, i, &p_rows[i] );
         if( p_segments )
         {
             if( b_newregion )
@@ -368,10 +368,21 @@ struct cea708_text_row_t
     cea708_pen_style_t styles[CEA708_WINDOW_MAX_COLS];
     uint8_t firstcol;
     uint8_t lastcol;
+    /* last conversion, reset on any change of the row */
+    text_segment_t *p_segments;
+    bool b_segments_newline;
 };
 
+static void cea708_text_row_Invalidate( cea708_text_row_t *p_row )
+{
+    text_segment_ChainDelete( p_row->p_segments );
+    p_row->p_segments = NULL;
+}
+
 static void cea708_text_row_Delete( cea708_text_row_t *p_row )
 {
+    if( p_row )
+        cea708_text_row_Invalidate( p_row );
     free( p_row );
 }
 
@@ -383,6 +394,8 @@ static cea708_text_row_t * cea708_text_row_New( void )
         p_row->firstcol = CEA708_WINDOW_MAX_COLS;
         p_row->lastcol = 0;
         memset(p_row->characters, 0, 4 * CEA708_WINDOW_MAX_COLS);
+        p_row->p_segments = NULL;
+        p_row->b_segments_newline = false;
     }
     return p_row;
 }
@@ -680,6 +693,7 @@ static void CEA708_Window_Scroll( cea708_window_t *p_w )
                          (row->lastcol - row->firstcol + 1) * sizeof(cea708_pen_style_t) );
                 row->firstcol++;
                 row->lastcol++;
+                cea708_text_row_Invalidate( row );
             }
             break;
         case CEA708_WA_DIRECTION_RTL:
@@ -697,6 +711,7 @@ static void CEA708_Window_Scroll( cea708_window_t *p_w )
                          (row->lastcol - row->firstcol + 1) * sizeof(cea708_pen_style_t) );
                 row->firstcol--;
                 row->lastcol--;
+                cea708_text_row_Invalidate( row );
             }
             break;
         case CEA708_WA_DIRECTION_TB:
@@ -838,6 +853,7 @@ static void CEA708_Window_Write( const uint8_t c[4], cea708_window_t *p_w )
 
     memcpy( &p_row->characters[p_w->col * 4U], c, 4 );
     p_row->styles[p_w->col] = p_w->pen;
+    cea708_text_row_Invalidate( p_row );
     if( p_w->col < p_row->firstcol )
         p_row->firstcol = p_w->col;
     if( p_w->col > p_row->lastcol )
@@ -1016,9 +1032,18 @@ static void CEA708SpuConvert( const cea708_window_t *p_w,
         if( !p_w->rows[i] )
             continue;
 
-        *pp_last = CEA708RowToSegments( p_w->rows[i], i < p_w->i_lastrow );
-        if( *pp_last )
-            pp_last  = &((*pp_last)->p_next);
+        cea708_text_row_t *p_row = p_w->rows[i];
+        const bool b_newline = i < p_w->i_lastrow;
+        if( p_row->p_segments == NULL || p_row->b_segments_newline != b_newline )
+        {
+            text_segment_ChainDelete( p_row->p_segments );
+            p_row->p_segments = CEA708RowToSegments( p_row, b_newline );
+            p_row->b_segments_newline = b_newline;
+        }
+
+        *pp_last = text_segment_Copy( p_row->p_segments );
+        while( *pp_last )
+            pp_last = &((*pp_last)->p_next);
     }
 
     if( p_w->b_relative )
@@ -1078,7 +1103,7 @@ static void CEA708SpuConvert( const cea708_window_t *p_w,
     p_region->inner_align = SUBPICTURE_ALIGN_BOTTOM|SUBPICTURE_ALIGN_LEFT;
 }
 
-static subpicture_t *CEA708_BuildSubtitle( cea708_t *p_cea708 )
+static subpicture_t *CEA708_BuildSubtitle( cea708_t *p_cea708, vlc_tick_t i_start )
 {
     subpicture_t *p_spu = decoder_NewSubpictureText( p_cea708->p_dec );
     if( !p_spu )
@@ -1112,8 +1137,8 @@ static subpicture_t *CEA708_BuildSubtitle( cea708_t *p_cea708 )
         }
     }
 
-    p_spu->i_start    = p_cea708->i_clock;
-    p_spu->i_stop     = p_cea708->i_clock + VLC_TICK_FROM_SEC(10);   /* 10s max */
+    p_spu->i_start    = i_start;
+    p_spu->i_stop     = i_start + VLC_TICK_FROM_SEC(10);   /* 10s max */
 
     p_spu->b_ephemer  = true;
     p_spu->b_absolute = false;
@@ -1168,10 +1193,10 @@ cea708_t * CEA708_Decoder_New( decoder_t *p_dec )
                             return CEA708_STATUS_STARVING
 #define REQUIRE_ARGS_AND_POP_COMMAND(n) REQUIRE_ARGS(n); else POP_COMMAND()
 
-static void CEA708_Output( cea708_t *p_cea708 )
+static void CEA708_Output( cea708_t *p_cea708, vlc_tick_t i_start )
 {
-    Debug(printf("@%ld ms\n", MS_FROM_VLC_TICK(p_cea708->i_clock)));
-    subpicture_t *p_spu = CEA708_BuildSubtitle( p_cea708 );
+    Debug(printf("@%ld ms\n", MS_FROM_VLC_TICK(i_start)));
+    subpicture_t *p_spu = CEA708_BuildSubtitle( p_cea708, i_start );
     if( p_spu )
         decoder_QueueSub( p_cea708->p_dec, p_spu );
 }
@@ -1679,6 +1704,11 @@ static int CEA708_Decode_P16( uint16_t ucs2, cea708_t *p_cea708 )
 
 static void CEA708_Decode_ServiceBuffer( cea708_t *h )
 {
+    /* Windows are only rendered once per buffer, with their final state,
+     * as intermediate states would not last more than a few bytes time */
+    bool b_output = false;
+    vlc_tick_t i_output = 0;
+
     for( ;; )
     {
         const uint8_t i_in = cea708_input_buffer_size( &h->input_buffer );
@@ -1698,7 +1728,10 @@ static void CEA708_Decode_ServiceBuffer( cea708_t *h )
             i_ret = CEA708_Decode_G1( c, h );
 
         if( i_ret & CEA708_STATUS_OUTPUT )
-            CEA708_Output( h );
+        {
+            b_output = true;
+            i_output = h->i_clock;
+        }
 
         if( i_ret & CEA708_STATUS_STARVING )
             break;
@@ -1708,6 +1741,9 @@ static void CEA708_Decode_ServiceBuffer( cea708_t *h )
         if( i_consumed )
             h->i_clock += vlc_tick_from_samples(1, 9600) * i_consumed;
     }
+
+    if( b_output )
+        CEA708_Output( h, i_output );
 }
 
 void CEA708_Decoder_Push( cea708_t *h, vlc_tick_t i_time,
@@ -55,7 +55,21 @@ static void CloseDecoder(vlc_object_t *);
 #define THREAD_FRAMES_LONGTEXT N_( "Max number of threads used for frame decoding, default 0=auto" )
 #define THREAD_TILES_TEXT N_("Tiles Threads")
 #define THREAD_TILES_LONGTEXT N_( "Max number of threads used for tile decoding, default 0=auto" )
+#define PRESET_TEXT N_("Threading preset")
+#define PRESET_LONGTEXT N_( "Throughput decodes several frames in parallel. " \
+    "Low latency decodes one frame at a time, with all the threads, so " \
+    "that each picture is output as soon as its data is received." )
 
+enum
+{
+    PRESET_THROUGHPUT,
+    PRESET_LOW_LATENCY,
+};
+
+static const int pi_preset_values_list[] =
+  { PRESET_THROUGHPUT, PRESET_LOW_LATENCY };
+static const char *const ppsz_preset_text [] =
+  { N_("Throughput"), N_("Low latency") };
 
 vlc_module_begin ()
     set_shortname("dav1d")
@@ -74,6 +88,8 @@ vlc_module_begin ()
     add_integer_with_range("dav1d-thread-tiles", 0, 0, DAV1D_MAX_TILE_THREADS,
                 THREAD_TILES_TEXT, THREAD_TILES_LONGTEXT)
 #endif
+    add_integer("dav1d-preset", PRESET_THROUGHPUT, PRESET_TEXT, PRESET_LONGTEXT)
+        change_integer_list(pi_preset_values_list, ppsz_preset_text)
 vlc_module_end ()
 
 /*****************************************************************************
@@ -84,6 +100,9 @@ typedef struct
     Dav1dSettings s;
     Dav1dContext *c;
     cc_data_t cc;
+    /* output format requested by the last successful format update */
+    video_format_t fmt_last;
+    bool b_fmt_last;
 } decoder_sys_t;
 
 struct user_data_s
@@ -157,9 +176,27 @@ static void UpdateDecoderOutput(decoder_t *dec, const Dav1dSequenceHeader *seq_h
     }
 }
 
+/* Only the fields set from the dav1d pictures need to be checked: updating the
+ * output format for every picture would request the video output again */
+static bool OutputFormatChanged(const video_format_t *a, const video_format_t *b)
+{
+    return a->i_chroma != b->i_chroma ||
+           a->i_width != b->i_width || a->i_height != b->i_height ||
+           a->i_visible_width != b->i_visible_width ||
+           a->i_visible_height != b->i_visible_height ||
+           a->primaries != b->primaries || a->transfer != b->transfer ||
+           a->space != b->space || a->color_range != b->color_range ||
+           memcmp(&a->mastering, &b->mastering, sizeof(a->mastering)) ||
+           memcmp(&a->lighting, &b->lighting, sizeof(a->lighting)) ||
+           a->projection_mode != b->projection_mode ||
+           a->multiview_mode != b->multiview_mode ||
+           memcmp(&a->pose, &b->pose, sizeof(a->pose));
+}
+
 static int NewPicture(Dav1dPicture *img, void *cookie)
 {
     decoder_t *dec = cookie;
+    decoder_sys_t *p_sys = dec->p_sys;
 
     video_format_t *v = &dec->fmt_out.video;
 
@@ -203,24 +240,34 @@ static int NewPicture(Dav1dPicture *img, void *cookie)
     v->i_height = (img->p.h + 0x7F) & ~0x7F;
     v->i_chroma = dec->fmt_out.i_codec;
 
-    if (decoder_UpdateVideoFormat(dec) == 0)
+    if (!p_sys->b_fmt_last || OutputFormatChanged(v, &p_sys->fmt_last))
     {
-        picture_t *pic;
-        pic = decoder_NewPicture(dec);
-        if (unlikely(pic == NULL))
+        video_format_t fmt_req = *v;
+        p_sys->b_fmt_last = false;
+        if (decoder_UpdateVideoFormat(dec) != 0)
             return -1;
+        p_sys->fmt_last = fmt_req;
+        p_sys->b_fmt_last = true;
+    }
+
+    /* dav1d decodes, and applies the film grain, directly in the pictures of
+     * the output pool */
+    picture_t *pic = decoder_NewPicture(dec);
+    if (unlikely(pic == NULL))
+        return -1;
 
-        img->data[0] = pic->p[0].p_pixels;
-        img->stride[0] = pic->p[0].i_pitch;
+    img->data[0] = pic->p[0].p_pixels;
+    img->stride[0] = pic->p[0].i_pitch;
+    if (pic->i_planes > 1)
+    {
         img->data[1] = pic->p[1].p_pixels;
         img->data[2] = pic->p[2].p_pixels;
         assert(pic->p[1].i_pitch == pic->p[2].i_pitch);
         img->stride[1] = pic->p[1].i_pitch;
-
-        img->allocator_data = pic;
-        return 0;
     }
-    return -1;
+
+    img->allocator_data = pic;
+    return 0;
 }
 
 static void ExtractCaptions(decoder_t *dec, const Dav1dPicture *img)
@@ -429,6 +476,11 @@ static int OpenDecoder(vlc_object_t *p_this)
     if (!p_sys)
         return VLC_ENOMEM;
 
+    p_sys->b_fmt_last = false;
+
+    const bool b_low_latency =
+        var_InheritInteger(p_this, "dav1d-preset") == PRESET_LOW_LATENCY;
+
     dav1d_default_settings(&p_sys->s);
 #if DAV1D_API_VERSION_MAJOR >= 6
     p_sys->s.n_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
@@ -454,6 +506,9 @@ static int OpenDecoder(vlc_object_t *p_this)
     else
         p_sys->s.max_frame_delay = fc_lut[p_sys->s.n_threads - 1];
 #endif
+    if (b_low_latency)
+        /* the threads only work on the tiles and post-filters of one frame */
+        p_sys->s.max_frame_delay = 1;
 
 #else // before dav1d 1.0.0
     p_sys->s.n_tile_threads = var_InheritInteger(p_this, "dav1d-thread-tiles");
@@ -462,6 +517,8 @@ static int OpenDecoder(vlc_object_t *p_this)
     p_sys->s.n_frame_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_frame_threads == 0)
         p_sys->s.n_frame_threads = __MAX(1, vlc_GetCPUCount());
+    if (b_low_latency)
+        p_sys->s.n_frame_threads = 1;
 #endif
     p_sys->s.allocator.cookie = dec;
     p_sys->s.allocator.alloc_picture_callback = NewPicture;
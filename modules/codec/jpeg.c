@@ -463,6 +463,40 @@ static int jpeg_GetOrientation( j_decompress_ptr cinfo )
     return orientation;
 }
 
+/*
+ * Let libjpeg downscale in the DCT domain when the image handler only needs
+ * a smaller picture, while staying at least as large as the requested size.
+ */
+static void jpeg_SetTargetScale( decoder_t *p_dec, j_decompress_ptr cinfo,
+                                 int i_otag )
+{
+    unsigned i_width = var_GetInteger( p_dec, "image-target-width" );
+    unsigned i_height = var_GetInteger( p_dec, "image-target-height" );
+    if( i_width == 0 && i_height == 0 )
+        return;
+
+    /* The requested size applies after the rotation */
+    if( i_otag > 1 && ORIENT_IS_SWAP( ORIENT_FROM_EXIF( i_otag ) ) )
+    {
+        unsigned i_tmp = i_width;
+        i_width = i_height;
+        i_height = i_tmp;
+    }
+
+    unsigned i_denom = 1;
+    while( i_denom < 8 &&
+           (cinfo->image_width + 2 * i_denom - 1) / (2 * i_denom) >= i_width &&
+           (cinfo->image_height + 2 * i_denom - 1) / (2 * i_denom) >= i_height )
+        i_denom *= 2;
+
+    if( i_denom > 1 )
+    {
+        msg_Dbg( p_dec, "decoding at 1/%u scale", i_denom );
+        cinfo->scale_num = 1;
+        cinfo->scale_denom = i_denom;
+    }
+}
+
 /*
  * This function must be fed with a complete compressed frame.
  */
@@ -498,6 +532,11 @@ static int DecodeBlock(decoder_t *p_dec, block_t *p_block)
 
     p_sys->p_jpeg.out_color_space = JCS_RGB;
 
+    int i_otag; /* Orientation tag has valid range of 1-8. 1 is normal orientation, 0 = unspecified = normal */
+    i_otag = jpeg_GetOrientation( &p_sys->p_jpeg );
+
+    jpeg_SetTargetScale( p_dec, &p_sys->p_jpeg, i_otag );
+
     jpeg_start_decompress(&p_sys->p_jpeg);
 
     /* Set output properties */
@@ -506,8 +545,6 @@ static int DecodeBlock(decoder_t *p_dec, block_t *p_block)
     p_dec->fmt_out.video.i_sar_num = 1;
     p_dec->fmt_out.video.i_sar_den = 1;
 
-    int i_otag; /* Orientation tag has valid range of 1-8. 1 is normal orientation, 0 = unspecified = normal */
-    i_otag = jpeg_GetOrientation( &p_sys->p_jpeg );
     if ( i_otag > 1 )
     {
         msg_Dbg( p_dec, "Jpeg orientation is %d", i_otag );
@@ -89,7 +89,20 @@ typedef struct
 
     /* */
     ASS_Track      *p_track;
+
+    /* Regions drawn from the last images returned by libass. They are
+     * reused as long as libass reports no change. */
+    unsigned       i_generation;
+    bool           b_cache;
+    int            i_cache;
+    struct
+    {
+        picture_t *p_picture;
+        int       i_x;
+        int       i_y;
+    } cache[4];
 } decoder_sys_t;
+static void DecSysCacheClean( decoder_sys_t *p_sys );
 static void DecSysRelease( decoder_sys_t *p_sys );
 static void DecSysHold( decoder_sys_t *p_sys );
 
@@ -110,6 +123,7 @@ typedef struct
     vlc_tick_t    i_pts;
 
     ASS_Image     *p_img;
+    unsigned      i_generation; /* of the images in the regions */
 } libass_spu_updater_sys_t;
 
 typedef struct
@@ -122,6 +136,7 @@ typedef struct
 
 static int BuildRegions( rectangle_t *p_region, int i_max_region, ASS_Image *p_img_list, int i_width, int i_height );
 static void RegionDraw( subpicture_region_t *p_region, ASS_Image *p_img );
+static subpicture_region_t *RegionFromCache( decoder_sys_t *p_sys, int i );
 
 //#define DEBUG_REGION
 
@@ -147,6 +162,9 @@ static int Create( vlc_object_t *p_this )
     vlc_mutex_init( &p_sys->lock );
     p_sys->i_refcount = 1;
     video_format_Init( &p_sys->fmt, 0 );
+    p_sys->i_generation = 1;
+    p_sys->b_cache = false;
+    p_sys->i_cache = 0;
     p_sys->i_last_pts = VLC_TICK_INVALID;
     p_sys->i_max_stop = VLC_TICK_INVALID;
     p_sys->p_library  = NULL;
@@ -313,6 +331,7 @@ static void DecSysRelease( decoder_sys_t *p_sys )
     }
     vlc_mutex_unlock( &p_sys->lock );
 
+    DecSysCacheClean( p_sys );
     if( p_sys->p_track )
         ass_free_track( p_sys->p_track );
     if( p_sys->p_renderer )
@@ -323,6 +342,14 @@ static void DecSysRelease( decoder_sys_t *p_sys )
     free( p_sys );
 }
 
+static void DecSysCacheClean( decoder_sys_t *p_sys )
+{
+    for( int i = 0; i < p_sys->i_cache; i++ )
+        picture_Release( p_sys->cache[i].p_picture );
+    p_sys->i_cache = 0;
+    p_sys->b_cache = false;
+}
+
 /*****************************************************************************
  * Flush:
  *****************************************************************************/
@@ -385,6 +412,7 @@ static int DecodeBlock( decoder_t *p_dec, block_t *p_block )
         }
 
         p_spu_sys->p_img = NULL;
+        p_spu_sys->i_generation = 0;
         p_spu_sys->p_dec_sys = p_sys;
         p_spu_sys->i_pts = p_block->i_pts;
         p_spu->i_start = p_block->i_pts;
@@ -451,8 +479,17 @@ static int SubpictureValidate( subpicture_t *p_subpic,
     ASS_Image *p_img = ass_render_frame( p_sys->p_renderer, p_sys->p_track,
                                          MS_FROM_VLC_TICK( i_stream_date ), &i_changed );
 
-    if( !i_changed && !b_fmt_src && !b_fmt_dst &&
-        (p_img != NULL) == (p_subpic->p_region != NULL) )
+    /* The change detection of libass is relative to the previous call,
+     * which may have been done for another subpicture */
+    if( i_changed || b_fmt_src || b_fmt_dst )
+    {
+        DecSysCacheClean( p_sys );
+        if( ++p_sys->i_generation == 0 )
+            p_sys->i_generation = 1;
+    }
+
+    if( p_spusys->i_generation == p_sys->i_generation &&
+        !b_fmt_src && !b_fmt_dst )
     {
         vlc_mutex_unlock( &p_sys->lock );
         return VLC_SUCCESS;
@@ -480,16 +517,37 @@ static void SubpictureUpdate( subpicture_t *p_subpic,
     p_subpic->i_original_picture_height = fmt.i_visible_height;
     p_subpic->i_original_picture_width = fmt.i_visible_width;
 
+    p_spusys->i_generation = p_sys->i_generation;
+
+    /* The images did not change since they were last drawn, possibly for
+     * another subpicture: share the pictures instead of drawing again. */
+    if( p_sys->b_cache )
+    {
+        subpicture_region_t **pp_region_last = &p_subpic->p_region;
+
+        for( int i = 0; i < p_sys->i_cache; i++ )
+        {
+            subpicture_region_t *r = RegionFromCache( p_sys, i );
+            if( !r )
+                break;
+            *pp_region_last = r;
+            pp_region_last = &r->p_next;
+        }
+        vlc_mutex_unlock( &p_sys->lock );
+        return;
+    }
+
     /* XXX to improve efficiency we merge regions that are close minimizing
      * the lost surface.
      * libass tends to create a lot of small regions and thus spu engine
      * reinstanciate a lot the scaler, and as we do not support subpel blending
      * it looks ugly (text unaligned).
      */
-    const int i_max_region = 4;
-    rectangle_t region[i_max_region];
+    const int i_max_region = ARRAY_SIZE(p_sys->cache);
+    rectangle_t region[ARRAY_SIZE(p_sys->cache)];
     const int i_region = BuildRegions( region, i_max_region, p_img, fmt.i_width, fmt.i_height );
 
+    p_sys->b_cache = true;
     if( i_region <= 0 )
     {
         vlc_mutex_unlock( &p_sys->lock );
@@ -513,7 +571,11 @@ static void SubpictureUpdate( subpicture_t *p_subpic,
 
         r = subpicture_region_New( &fmt_region );
         if( !r )
+        {
+            /* Do not reuse an incomplete drawing */
+            DecSysCacheClean( p_sys );
             break;
+        }
         r->i_x = region[i].x0;
         r->i_y = region[i].y0;
         r->i_align = SUBPICTURE_ALIGN_TOP | SUBPICTURE_ALIGN_LEFT;
@@ -522,12 +584,39 @@ static void SubpictureUpdate( subpicture_t *p_subpic,
         RegionDraw( r, p_img );
 
         /* */
+        p_sys->cache[p_sys->i_cache].p_picture = picture_Hold( r->p_picture );
+        p_sys->cache[p_sys->i_cache].i_x = r->i_x;
+        p_sys->cache[p_sys->i_cache].i_y = r->i_y;
+        p_sys->i_cache++;
+
         *pp_region_last = r;
         pp_region_last = &r->p_next;
     }
     vlc_mutex_unlock( &p_sys->lock );
 
 }
+
+static subpicture_region_t *RegionFromCache( decoder_sys_t *p_sys, int i )
+{
+    picture_t *p_picture = p_sys->cache[i].p_picture;
+    video_format_t fmt_region = p_sys->fmt;
+
+    fmt_region.i_width =
+    fmt_region.i_visible_width  = p_picture->format.i_visible_width;
+    fmt_region.i_height =
+    fmt_region.i_visible_height = p_picture->format.i_visible_height;
+
+    subpicture_region_t *r = subpicture_region_New( &fmt_region );
+    if( !r )
+        return NULL;
+    picture_Release( r->p_picture );
+    r->p_picture = picture_Hold( p_picture );
+    r->i_x = p_sys->cache[i].i_x;
+    r->i_y = p_sys->cache[i].i_y;
+    r->i_align = SUBPICTURE_ALIGN_TOP | SUBPICTURE_ALIGN_LEFT;
+    return r;
+}
+
 static void SubpictureDestroy( subpicture_t *p_subpic )
 {
     libass_spu_updater_sys_t *p_spusys = p_subpic->updater.p_sys;
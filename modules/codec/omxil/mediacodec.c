@@ -470,6 +470,7 @@ static int StartMediaCodec(decoder_t *p_dec)
         if (p_sys->b_adaptive)
             msg_Dbg(p_dec, "mediacodec configured for adaptative playback");
         args.video.b_adaptive_playback = p_sys->b_adaptive;
+        args.video.b_low_latency = var_InheritBool(p_dec, "low-delay");
     }
     else
     {
@@ -1727,7 +1728,7 @@ reload:
     /* Add an empty variable so that mediacodec won't be loaded again
      * for this ES */
     var_Create(p_dec, "mediacodec-failed", VLC_VAR_VOID);
-    return VLCDEC_RELOAD;
+    return VLCDEC_FALLBACK;
 }
 
 static int Video_OnNewBlock(decoder_t *p_dec, block_t **pp_block)
@@ -598,6 +598,10 @@ static int ConfigureDecoder(mc_api *api, union mc_api_args* p_args)
             if (p_args->video.b_adaptive_playback)
                 SET_INTEGER(jformat, "feature-adaptive-playback", 1);
         }
+
+        /* low-latency available since API 30, ignored before */
+        if (p_args->video.b_low_latency)
+            SET_INTEGER(jformat, "low-latency", 1);
     }
     else
     {
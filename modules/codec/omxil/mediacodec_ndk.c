@@ -31,6 +31,7 @@
 #include <assert.h>
 
 #include <vlc_common.h>
+#include <vlc_vector.h>
 
 #include <media/NdkMediaCodec.h>
 #include <OMX_Core.h>
@@ -112,6 +113,26 @@ typedef media_status_t (*pf_AMediaCodec_releaseOutputBufferAtTime)(AMediaCodec*,
 typedef media_status_t (*pf_AMediaCodec_setOutputSurface)(AMediaCodec*,
         ANativeWindow *surface);
 
+/* Async notifications, since API 28. Declared here since the NDK headers
+ * hide them when targeting older APIs. */
+struct AMediaCodecOnAsyncNotifyCallback_compat
+{
+    void (*onAsyncInputAvailable)(AMediaCodec *, void *userdata,
+                                  int32_t index);
+    void (*onAsyncOutputAvailable)(AMediaCodec *, void *userdata,
+                                   int32_t index,
+                                   AMediaCodecBufferInfo *info);
+    void (*onAsyncFormatChanged)(AMediaCodec *, void *userdata,
+                                 AMediaFormat *format);
+    void (*onAsyncError)(AMediaCodec *, void *userdata,
+                         media_status_t error, int32_t action_code,
+                         const char *detail);
+};
+
+typedef media_status_t (*pf_AMediaCodec_setAsyncNotifyCallback)(AMediaCodec*,
+        struct AMediaCodecOnAsyncNotifyCallback_compat callback,
+        void *userdata);
+
 typedef AMediaFormat *(*pf_AMediaFormat_new)();
 typedef media_status_t (*pf_AMediaFormat_delete)(AMediaFormat*);
 
@@ -142,6 +163,7 @@ struct syms
         pf_AMediaCodec_releaseOutputBuffer releaseOutputBuffer;
         pf_AMediaCodec_releaseOutputBufferAtTime releaseOutputBufferAtTime;
         pf_AMediaCodec_setOutputSurface setOutputSurface;
+        pf_AMediaCodec_setAsyncNotifyCallback setAsyncNotifyCallback;
     } AMediaCodec;
     struct {
         pf_AMediaFormat_new new;
@@ -177,6 +199,7 @@ static struct members members[] =
     { "AMediaCodec_releaseOutputBuffer", OFF(releaseOutputBuffer), true },
     { "AMediaCodec_releaseOutputBufferAtTime", OFF(releaseOutputBufferAtTime), true },
     { "AMediaCodec_setOutputSurface", OFF(setOutputSurface), false },
+    { "AMediaCodec_setAsyncNotifyCallback", OFF(setAsyncNotifyCallback), false },
 #undef OFF
 #define OFF(x) offsetof(struct syms, AMediaFormat.x)
     { "AMediaFormat_new", OFF(new), true },
@@ -234,13 +257,129 @@ end:
  * Local prototypes
  ****************************************************************************/
 
+struct mc_async_out
+{
+    int i_index; /* or MC_API_INFO_OUTPUT_FORMAT_CHANGED */
+    AMediaCodecBufferInfo info;
+};
+
 struct mc_api_sys
 {
     AMediaCodec* p_codec;
     AMediaFormat* p_format;
     AMediaCodecBufferInfo info;
+
+    /* Buffers notified by the codec in async mode, waited for by the
+     * dequeue functions instead of polling the codec */
+    bool b_async;
+    struct
+    {
+        vlc_mutex_t lock;
+        vlc_cond_t cond;
+        struct VLC_VECTOR(int32_t) in;
+        struct VLC_VECTOR(struct mc_async_out) out;
+        unsigned i_generation; /* bumped on flush/stop to wake waiters */
+        bool b_error;
+    } async;
 };
 
+/*****************************************************************************
+ * Async notifications
+ *****************************************************************************/
+static void AsyncOnInput(AMediaCodec *p_codec, void *userdata, int32_t i_index)
+{
+    mc_api_sys *p_sys = ((mc_api *)userdata)->p_sys;
+    (void) p_codec;
+
+    vlc_mutex_lock(&p_sys->async.lock);
+    if (!vlc_vector_push(&p_sys->async.in, i_index))
+        p_sys->async.b_error = true;
+    vlc_cond_broadcast(&p_sys->async.cond);
+    vlc_mutex_unlock(&p_sys->async.lock);
+}
+
+static void AsyncPushOutput(mc_api_sys *p_sys, int i_index,
+                            const AMediaCodecBufferInfo *p_info)
+{
+    struct mc_async_out out = { .i_index = i_index };
+    if (p_info != NULL)
+        out.info = *p_info;
+
+    vlc_mutex_lock(&p_sys->async.lock);
+    if (!vlc_vector_push(&p_sys->async.out, out))
+        p_sys->async.b_error = true;
+    vlc_cond_broadcast(&p_sys->async.cond);
+    vlc_mutex_unlock(&p_sys->async.lock);
+}
+
+static void AsyncOnOutput(AMediaCodec *p_codec, void *userdata, int32_t i_index,
+                          AMediaCodecBufferInfo *p_info)
+{
+    (void) p_codec;
+    AsyncPushOutput(((mc_api *)userdata)->p_sys, i_index, p_info);
+}
+
+static void AsyncOnFormatChanged(AMediaCodec *p_codec, void *userdata,
+                                 AMediaFormat *p_format)
+{
+    (void) p_codec; (void) p_format;
+    /* Read back with getOutputFormat() by GetOutput */
+    AsyncPushOutput(((mc_api *)userdata)->p_sys,
+                    MC_API_INFO_OUTPUT_FORMAT_CHANGED, NULL);
+}
+
+static void AsyncOnError(AMediaCodec *p_codec, void *userdata,
+                         media_status_t i_error, int32_t i_action_code,
+                         const char *psz_detail)
+{
+    mc_api *api = userdata;
+    mc_api_sys *p_sys = api->p_sys;
+    (void) p_codec;
+
+    msg_Err(api->p_obj, "AMediaCodec error %d (action %d): %s", i_error,
+            i_action_code, psz_detail ? psz_detail : "");
+
+    vlc_mutex_lock(&p_sys->async.lock);
+    p_sys->async.b_error = true;
+    vlc_cond_broadcast(&p_sys->async.cond);
+    vlc_mutex_unlock(&p_sys->async.lock);
+}
+
+/* Drop the notified buffers, which are invalid after a flush or a stop, and
+ * wake up the dequeue functions */
+static void AsyncReset(mc_api_sys *p_sys)
+{
+    vlc_mutex_lock(&p_sys->async.lock);
+    vlc_vector_clear(&p_sys->async.in);
+    vlc_vector_clear(&p_sys->async.out);
+    p_sys->async.i_generation++;
+    p_sys->async.b_error = false;
+    vlc_cond_broadcast(&p_sys->async.cond);
+    vlc_mutex_unlock(&p_sys->async.lock);
+}
+
+/* Wait for a notified buffer, called with the async lock held.
+ * Returns false on timeout, flush or stop */
+static bool AsyncWait(mc_api_sys *p_sys, size_t *pi_size, vlc_tick_t i_timeout)
+{
+    const unsigned i_generation = p_sys->async.i_generation;
+    const vlc_tick_t i_deadline = i_timeout > 0 ?
+        vlc_tick_now() + i_timeout : VLC_TICK_INVALID;
+
+    while (*pi_size == 0 && !p_sys->async.b_error
+        && p_sys->async.i_generation == i_generation)
+    {
+        if (i_timeout == 0)
+            return false;
+        if (i_timeout < 0)
+            vlc_cond_wait(&p_sys->async.cond, &p_sys->async.lock);
+        else if (vlc_cond_timedwait(&p_sys->async.cond, &p_sys->async.lock,
+                                    i_deadline))
+            break;
+    }
+    return *pi_size > 0 && p_sys->async.i_generation == i_generation;
+}
+
 /*****************************************************************************
  * ConfigureDecoder
  *****************************************************************************/
@@ -259,6 +398,21 @@ static int ConfigureDecoder(mc_api *api, union mc_api_args *p_args)
         return MC_API_ERROR;
     }
 
+    if (syms.AMediaCodec.setAsyncNotifyCallback != NULL)
+    {
+        const struct AMediaCodecOnAsyncNotifyCallback_compat cbs = {
+            .onAsyncInputAvailable = AsyncOnInput,
+            .onAsyncOutputAvailable = AsyncOnOutput,
+            .onAsyncFormatChanged = AsyncOnFormatChanged,
+            .onAsyncError = AsyncOnError,
+        };
+        p_sys->b_async =
+            syms.AMediaCodec.setAsyncNotifyCallback(p_sys->p_codec, cbs,
+                                                    api) == AMEDIA_OK;
+        if (!p_sys->b_async)
+            msg_Warn(api->p_obj, "AMediaCodec.setAsyncNotifyCallback failed");
+    }
+
     p_sys->p_format = syms.AMediaFormat.new();
     if (!p_sys->p_format)
     {
@@ -285,6 +439,9 @@ static int ConfigureDecoder(mc_api *api, union mc_api_args *p_args)
                 syms.AMediaFormat.setInt32(p_sys->p_format,
                                            "feature-adaptive-playback", 1);
         }
+        /* low-latency available since API 30, ignored before */
+        if (p_args->video.b_low_latency)
+            syms.AMediaFormat.setInt32(p_sys->p_format, "low-latency", 1);
     }
     else
     {
@@ -323,6 +480,11 @@ static int Stop(mc_api *api)
         syms.AMediaCodec.delete(p_sys->p_codec);
         p_sys->p_codec = NULL;
     }
+    if (p_sys->b_async)
+    {
+        AsyncReset(p_sys);
+        p_sys->b_async = false;
+    }
     if (p_sys->p_format)
     {
         syms.AMediaFormat.delete(p_sys->p_format);
@@ -364,10 +526,17 @@ static int Flush(mc_api *api)
 {
     mc_api_sys *p_sys = api->p_sys;
 
-    if (syms.AMediaCodec.flush(p_sys->p_codec) == AMEDIA_OK)
-        return 0;
-    else
+    if (syms.AMediaCodec.flush(p_sys->p_codec) != AMEDIA_OK)
         return MC_API_ERROR;
+
+    if (p_sys->b_async)
+    {
+        AsyncReset(p_sys);
+        /* The codec stays idle after a flush in async mode */
+        if (syms.AMediaCodec.start(p_sys->p_codec) != AMEDIA_OK)
+            return MC_API_ERROR;
+    }
+    return 0;
 }
 
 /*****************************************************************************
@@ -378,6 +547,24 @@ static int DequeueInput(mc_api *api, vlc_tick_t i_timeout)
     mc_api_sys *p_sys = api->p_sys;
     ssize_t i_index;
 
+    if (p_sys->b_async)
+    {
+        vlc_mutex_lock(&p_sys->async.lock);
+        if (AsyncWait(p_sys, &p_sys->async.in.size, i_timeout))
+        {
+            i_index = p_sys->async.in.data[0];
+            vlc_vector_remove(&p_sys->async.in, 0);
+        }
+        else
+            i_index = p_sys->async.b_error ? MC_API_ERROR
+                                           : MC_API_INFO_TRYAGAIN;
+        vlc_mutex_unlock(&p_sys->async.lock);
+
+        if (i_index == MC_API_ERROR)
+            msg_Err(api->p_obj, "AMediaCodec input failed");
+        return i_index;
+    }
+
     i_index = syms.AMediaCodec.dequeueInputBuffer(p_sys->p_codec, i_timeout);
     if (i_index >= 0)
         return i_index;
@@ -438,6 +625,22 @@ static int DequeueOutput(mc_api *api, vlc_tick_t i_timeout)
     mc_api_sys *p_sys = api->p_sys;
     ssize_t i_index;
 
+    if (p_sys->b_async)
+    {
+        vlc_mutex_lock(&p_sys->async.lock);
+        if (AsyncWait(p_sys, &p_sys->async.out.size, i_timeout))
+        {
+            i_index = p_sys->async.out.data[0].i_index;
+            p_sys->info = p_sys->async.out.data[0].info;
+            vlc_vector_remove(&p_sys->async.out, 0);
+        }
+        else
+            i_index = p_sys->async.b_error ? MC_API_ERROR
+                                           : MC_API_INFO_TRYAGAIN;
+        vlc_mutex_unlock(&p_sys->async.lock);
+        return i_index;
+    }
+
     i_index = syms.AMediaCodec.dequeueOutputBuffer(p_sys->p_codec, &p_sys->info,
                                                    i_timeout);
 
@@ -568,8 +771,12 @@ static int SetOutputSurface(mc_api *api, void *p_surface, void *p_jsurface)
  *****************************************************************************/
 static void Clean(mc_api *api)
 {
+    mc_api_sys *p_sys = api->p_sys;
+
+    vlc_vector_destroy(&p_sys->async.in);
+    vlc_vector_destroy(&p_sys->async.out);
     free(api->psz_name);
-    free(api->p_sys);
+    free(p_sys);
 }
 
 /*****************************************************************************
@@ -602,6 +809,10 @@ int MediaCodecNdk_Init(mc_api *api)
     api->p_sys = calloc(1, sizeof(mc_api_sys));
     if (!api->p_sys)
         return MC_API_ERROR;
+    vlc_mutex_init(&api->p_sys->async.lock);
+    vlc_cond_init(&api->p_sys->async.cond);
+    vlc_vector_init(&api->p_sys->async.in);
+    vlc_vector_init(&api->p_sys->async.out);
 
     api->clean = Clean;
     api->prepare = Prepare;
@@ -34,6 +34,7 @@
 
 #include <ctype.h>
 #include <assert.h>
+#include <search.h>
 
 #include "../substext.h"
 #include "ttml.h"
@@ -82,9 +83,18 @@ typedef struct
     } display;
 }  ttml_style_t;
 
+/* Per document lookups, shared by all the rendered intervals */
+typedef struct
+{
+    vlc_dictionary_t styles;    /* xml:id to <style> node */
+    vlc_dictionary_t regions;   /* xml:id to <region> node */
+    void *           p_inherited; /* node to its resolved ttml_style_t */
+} ttml_doc_cache_t;
+
 typedef struct
 {
     vlc_dictionary_t regions;
+    ttml_doc_cache_t *p_cache;
     tt_node_t *      p_rootnode; /* for now. FIXME: split header */
     ttml_length_t    root_extent_h, root_extent_v;
     unsigned         i_cell_resolution_v;
@@ -161,11 +171,16 @@ static void ttml_region_Delete( ttml_region_t *p_region )
 
 static ttml_style_t * ttml_style_Duplicate( const ttml_style_t *p_src )
 {
-    ttml_style_t *p_dup = ttml_style_New( );
+    ttml_style_t *p_dup = malloc( sizeof( *p_dup ) );
     if( p_dup )
     {
         *p_dup = *p_src;
         p_dup->font_style = text_style_Duplicate( p_src->font_style );
+        if( unlikely( p_src->font_style && !p_dup->font_style ) )
+        {
+            free( p_dup );
+            return NULL;
+        }
     }
     return p_dup;
 }
@@ -312,6 +327,68 @@ static tt_node_t * FindNode( tt_node_t *p_node, const char *psz_nodename,
     return NULL;
 }
 
+typedef struct
+{
+    const tt_node_t *p_node;
+    ttml_style_t *p_style;
+} ttml_inherited_t;
+
+static int ttml_inherited_Compare( const void *a, const void *b )
+{
+    const tt_node_t *p_a = ((const ttml_inherited_t *) a)->p_node;
+    const tt_node_t *p_b = ((const ttml_inherited_t *) b)->p_node;
+    return (p_a < p_b) ? -1 : (p_a > p_b);
+}
+
+static void ttml_inherited_Delete( void *p_data )
+{
+    ttml_inherited_t *p_entry = p_data;
+    if( p_entry->p_style )
+        ttml_style_Delete( p_entry->p_style );
+    free( p_entry );
+}
+
+static void IndexNodeIDs( tt_node_t *p_node, ttml_doc_cache_t *p_cache )
+{
+    vlc_dictionary_t *p_dict = NULL;
+    if( !tt_node_NameCompare( p_node->psz_node_name, "style" ) )
+        p_dict = &p_cache->styles;
+    else if( !tt_node_NameCompare( p_node->psz_node_name, "region" ) )
+        p_dict = &p_cache->regions;
+
+    if( p_dict )
+    {
+        const char *psz = vlc_dictionary_value_for_key( &p_node->attr_dict, "xml:id" );
+        if( !psz ) /* People can't do xml properly */
+            psz = vlc_dictionary_value_for_key( &p_node->attr_dict, "id" );
+        /* Same as FindNode(), first one in document order wins */
+        if( psz && !vlc_dictionary_has_key( p_dict, psz ) )
+            vlc_dictionary_insert( p_dict, psz, p_node );
+    }
+
+    for( tt_basenode_t *p_child = p_node->p_child;
+                        p_child; p_child = p_child->p_next )
+    {
+        if( p_child->i_type != TT_NODE_TYPE_TEXT )
+            IndexNodeIDs( (tt_node_t *) p_child, p_cache );
+    }
+}
+
+static void ttml_doc_cache_Init( ttml_doc_cache_t *p_cache, tt_node_t *p_rootnode )
+{
+    vlc_dictionary_init( &p_cache->styles, 0 );
+    vlc_dictionary_init( &p_cache->regions, 0 );
+    p_cache->p_inherited = NULL;
+    IndexNodeIDs( p_rootnode, p_cache );
+}
+
+static void ttml_doc_cache_Clean( ttml_doc_cache_t *p_cache )
+{
+    vlc_dictionary_clear( &p_cache->styles, NULL, NULL );
+    vlc_dictionary_clear( &p_cache->regions, NULL, NULL );
+    tdestroy( p_cache->p_inherited, ttml_inherited_Delete );
+}
+
 static void FillTextStyle( const char *psz_attr, const char *psz_val,
                            text_style_t *p_text_style )
 {
@@ -611,8 +688,8 @@ static void DictMergeWithStyleID( ttml_context_t *p_ctx, const char *psz_styles,
         while( psz_id )
         {
             /* Lookup referenced style ID */
-            const tt_node_t *p_node = FindNode( p_ctx->p_rootnode,
-                                                "style", -1, psz_id );
+            const tt_node_t *p_node =
+                    vlc_dictionary_value_for_key( &p_ctx->p_cache->styles, psz_id );
             if( p_node )
                 DictionaryMerge( &p_node->attr_dict, &tempdict, true );
 
@@ -633,8 +710,8 @@ static void DictMergeWithRegionID( ttml_context_t *p_ctx, const char *psz_id,
     assert(p_ctx->p_rootnode);
     if( psz_id && p_ctx->p_rootnode )
     {
-        const tt_node_t *p_regionnode = FindNode( p_ctx->p_rootnode,
-                                                 "region", -1, psz_id );
+        const tt_node_t *p_regionnode =
+                vlc_dictionary_value_for_key( &p_ctx->p_cache->regions, psz_id );
         if( !p_regionnode )
             return;
 
@@ -678,6 +755,17 @@ static ttml_style_t * InheritTTMLStyles( ttml_context_t *p_ctx, tt_node_t *p_nod
 {
     assert( p_node );
     ttml_style_t *p_ttml_style = NULL;
+
+    /* Resolution only depends on the document: reuse it for sibling
+     * text nodes and for every interval the node is displayed in */
+    ttml_inherited_t key = { .p_node = p_node };
+    ttml_inherited_t **pp_entry = tfind( &key, &p_ctx->p_cache->p_inherited,
+                                         ttml_inherited_Compare );
+    if( pp_entry )
+        return (*pp_entry)->p_style ? ttml_style_Duplicate( (*pp_entry)->p_style )
+                                    : NULL;
+
+    const tt_node_t *p_leaf = p_node;
     vlc_dictionary_t merged;
     vlc_dictionary_init( &merged, 0 );
 
@@ -704,6 +792,16 @@ static ttml_style_t * InheritTTMLStyles( ttml_context_t *p_ctx, tt_node_t *p_nod
 
     vlc_dictionary_clear( &merged, NULL, NULL );
 
+    ttml_inherited_t *p_entry = malloc( sizeof( *p_entry ) );
+    if( p_entry )
+    {
+        p_entry->p_node = p_leaf;
+        p_entry->p_style = p_ttml_style ? ttml_style_Duplicate( p_ttml_style ) : NULL;
+        if( (p_ttml_style && !p_entry->p_style) ||
+            !tsearch( p_entry, &p_ctx->p_cache->p_inherited, ttml_inherited_Compare ) )
+            ttml_inherited_Delete( p_entry );
+    }
+
     return p_ttml_style;
 }
 
@@ -1078,7 +1176,8 @@ static void InitTTMLContext( tt_node_t *p_rootnode, ttml_context_t *p_ctx )
     }
 }
 
-static ttml_region_t *GenerateRegions( tt_node_t *p_rootnode, tt_time_t playbacktime )
+static ttml_region_t *GenerateRegions( tt_node_t *p_rootnode, ttml_doc_cache_t *p_cache,
+                                       tt_time_t playbacktime )
 {
     ttml_region_t*  p_regions = NULL;
     ttml_region_t** pp_region_last = &p_regions;
@@ -1091,6 +1190,7 @@ static ttml_region_t *GenerateRegions( tt_node_t *p_rootnode, tt_time_t playback
             ttml_context_t context;
             InitTTMLContext( p_rootnode, &context );
             context.p_rootnode = p_rootnode;
+            context.p_cache = p_cache;
 
             vlc_dictionary_init( &context.regions, 1 );
             ConvertNodesToRegionContent( &context, p_bodynode, NULL, NULL, playbacktime );
@@ -1254,6 +1354,9 @@ static int ParseBlock( decoder_t *p_dec, const block_t *p_block )
     tt_timings_Resolve( (tt_basenode_t *) p_rootnode, &temporal_extent,
                         &p_timings_array, &i_timings_count );
 
+    ttml_doc_cache_t cache;
+    ttml_doc_cache_Init( &cache, p_rootnode );
+
 #ifdef TTML_DEBUG
     for( size_t i=0; i<i_timings_count; i++ )
         printf("%ld ", tt_time_Convert( &p_timings_array[i] ) );
@@ -1279,7 +1382,7 @@ static int ParseBlock( decoder_t *p_dec, const block_t *p_block )
 
         bool b_bitmap_regions = false;
         subpicture_t *p_spu = NULL;
-        ttml_region_t *p_regions = GenerateRegions( p_rootnode, p_timings_array[i] );
+        ttml_region_t *p_regions = GenerateRegions( p_rootnode, &cache, p_timings_array[i] );
         if( p_regions )
         {
             if( p_regions->bgbitmap.i_bytes > 0 && p_regions->updt.p_segments == NULL )
@@ -1320,6 +1423,7 @@ static int ParseBlock( decoder_t *p_dec, const block_t *p_block )
             decoder_QueueSub( p_dec, p_spu );
     }
 
+    ttml_doc_cache_Clean( &cache );
     tt_node_RecursiveDelete( p_rootnode );
 
     free( p_timings_array );
@@ -0,0 +1,1144 @@
+/*****************************************************************************
+ * v4l2m2m.c: Video4Linux2 memory-to-memory video decoder
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * This drives the stateful decoders of the system-on-chips, as specified by
+ * the V4L2 memory-to-memory stateful video decoder interface: the bitstream
+ * is queued on the OUTPUT queue, and the driver parses it and returns the
+ * decoded frames on the CAPTURE queue.
+ *
+ * The capture buffers are exported as DMA buffers. If the video output can
+ * take them (DRM planes, EGL), the frames are handed over without a copy;
+ * otherwise they are copied to CPU pictures.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_codec.h>
+#include <vlc_atomic.h>
+#include <vlc_fs.h>
+
+#include "hxxx_helper.h"
+#include "v4l2m2m.h"
+
+#ifndef V4L2_PIX_FMT_HEVC
+# define V4L2_PIX_FMT_HEVC v4l2_fourcc('H', 'E', 'V', 'C')
+#endif
+#ifndef V4L2_PIX_FMT_VP9
+# define V4L2_PIX_FMT_VP9 v4l2_fourcc('V', 'P', '9', '0')
+#endif
+
+#define DEVICE_TEXT N_("Decoder device")
+#define DEVICE_LONGTEXT N_( \
+    "Video4Linux2 memory-to-memory decoder device node. " \
+    "By default, all the /dev/video nodes are probed.")
+
+static int OpenDecoder(vlc_object_t *);
+static void CloseDecoder(vlc_object_t *);
+
+vlc_module_begin()
+    set_description(N_("Video4Linux2 memory-to-memory video decoder"))
+    set_shortname(N_("V4L2 M2M"))
+    set_subcategory(SUBCAT_INPUT_VCODEC)
+    set_capability("video decoder", 80)
+    set_callbacks(OpenDecoder, CloseDecoder)
+    add_string("v4l2m2m-dev", NULL, DEVICE_TEXT, DEVICE_LONGTEXT)
+    add_shortcut("v4l2m2m")
+vlc_module_end()
+
+/* Bitstream buffers */
+#define OUTPUT_BUFFERS 8
+/* Capture buffers on top of what the driver needs, for the video output */
+#define EXTRA_CAPTURE_BUFFERS 6
+/* Maximum wait for the driver, before giving up on a block */
+#define DEVICE_TIMEOUT_MS 1000
+
+/**
+ * Capture buffers.
+ *
+ * The pool outlives the decoder if pictures still refer to its buffers.
+ */
+struct v4l2m2m_pool
+{
+    vlc_atomic_rc_t refs;
+    vlc_mutex_t lock;
+    int fd; /**< Device, or -1 once the buffers are no longer in use */
+    uint32_t type;
+    unsigned count;
+    unsigned planes; /**< Buffer planes, not picture planes */
+    struct
+    {
+        void *base[VIDEO_MAX_PLANES];
+        size_t length[VIDEO_MAX_PLANES];
+        int fds[VIDEO_MAX_PLANES];
+        unsigned holds; /**< Pictures using the buffer */
+    } bufs[];
+};
+
+typedef struct
+{
+    int fd;
+    bool mplane;
+    uint32_t out_type;
+    uint32_t cap_type;
+
+    /* Bitstream buffers */
+    struct
+    {
+        void *base;
+        size_t length;
+        bool queued;
+    } out[OUTPUT_BUFFERS];
+    unsigned out_count;
+
+    /* Decoded frames */
+    struct v4l2m2m_pool *pool;
+    vlc_video_context *vctx;
+    bool zero_copy;
+    bool drained;
+    /* Picture planes within the buffer planes */
+    unsigned pic_planes;
+    unsigned buf_plane[PICTURE_PLANE_MAX];
+    uint32_t offsets[PICTURE_PLANE_MAX];
+    uint32_t pitches[PICTURE_PLANE_MAX];
+    unsigned lines[PICTURE_PLANE_MAX];
+    unsigned width;
+    unsigned height;
+
+    /* Bitstream conversion */
+    bool b_hxxx;
+    bool b_xps_pushed;
+    struct hxxx_helper hh;
+    bool b_extra_pushed;
+} decoder_sys_t;
+
+static const struct
+{
+    vlc_fourcc_t codec;
+    uint32_t pixelformat;
+} codecs[] = {
+    { VLC_CODEC_H264, V4L2_PIX_FMT_H264 },
+    { VLC_CODEC_HEVC, V4L2_PIX_FMT_HEVC },
+    { VLC_CODEC_VP8,  V4L2_PIX_FMT_VP8 },
+    { VLC_CODEC_VP9,  V4L2_PIX_FMT_VP9 },
+    { VLC_CODEC_MPGV, V4L2_PIX_FMT_MPEG2 },
+    { VLC_CODEC_MP4V, V4L2_PIX_FMT_MPEG4 },
+};
+
+/* Frame layouts, in order of preference */
+static const struct
+{
+    uint32_t pixelformat;
+    vlc_fourcc_t chroma;
+    bool contiguous; /**< All planes in the first buffer plane */
+} layouts[] = {
+    { V4L2_PIX_FMT_NV12,    VLC_CODEC_NV12, true },
+    { V4L2_PIX_FMT_NV12M,   VLC_CODEC_NV12, false },
+    { V4L2_PIX_FMT_YUV420,  VLC_CODEC_I420, true },
+    { V4L2_PIX_FMT_YUV420M, VLC_CODEC_I420, false },
+};
+
+static int xioctl(int fd, unsigned long request, void *arg)
+{
+    int ret;
+
+    do
+        ret = ioctl(fd, request, arg);
+    while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+/*****************************************************************************
+ * Capture buffers
+ *****************************************************************************/
+
+static void PoolRelease(struct v4l2m2m_pool *pool)
+{
+    if (!vlc_atomic_rc_dec(&pool->refs))
+        return;
+
+    for (unsigned i = 0; i < pool->count; i++)
+        for (unsigned j = 0; j < pool->planes; j++) {
+            if (pool->bufs[i].base[j] != MAP_FAILED)
+                munmap(pool->bufs[i].base[j], pool->bufs[i].length[j]);
+            if (pool->bufs[i].fds[j] >= 0)
+                vlc_close(pool->bufs[i].fds[j]);
+        }
+    free(pool);
+}
+
+/* Call with the pool lock held */
+static int PoolQueue(struct v4l2m2m_pool *pool, unsigned index)
+{
+    struct v4l2_plane planes[VIDEO_MAX_PLANES];
+    struct v4l2_buffer buf = {
+        .type = pool->type,
+        .memory = V4L2_MEMORY_MMAP,
+        .index = index,
+    };
+
+    if (pool->type == V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE) {
+        memset(planes, 0, sizeof (planes));
+        buf.m.planes = planes;
+        buf.length = pool->planes;
+    }
+    return xioctl(pool->fd, VIDIOC_QBUF, &buf);
+}
+
+/**
+ * Gives a buffer back to the decoder, once no pictures use it.
+ */
+static void PoolReleaseBuffer(struct v4l2m2m_pool *pool, unsigned index)
+{
+    assert(index < pool->count);
+
+    vlc_mutex_lock(&pool->lock);
+    assert(pool->bufs[index].holds > 0);
+    if (--pool->bufs[index].holds == 0 && pool->fd >= 0)
+        PoolQueue(pool, index);
+    vlc_mutex_unlock(&pool->lock);
+    PoolRelease(pool);
+}
+
+static void PoolHoldBuffer(struct v4l2m2m_pool *pool, unsigned index)
+{
+    vlc_atomic_rc_inc(&pool->refs);
+    vlc_mutex_lock(&pool->lock);
+    pool->bufs[index].holds++;
+    vlc_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Detaches the pool from the device.
+ *
+ * The buffers still used by pictures are not queued back anymore.
+ */
+static void PoolDetach(struct v4l2m2m_pool *pool)
+{
+    vlc_mutex_lock(&pool->lock);
+    pool->fd = -1;
+    vlc_mutex_unlock(&pool->lock);
+    PoolRelease(pool);
+}
+
+static struct v4l2m2m_pool *PoolCreate(decoder_t *dec, unsigned count,
+                                       unsigned planes)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2m2m_pool *pool =
+        malloc(sizeof (*pool) + count * sizeof (pool->bufs[0]));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    vlc_atomic_rc_init(&pool->refs);
+    vlc_mutex_init(&pool->lock);
+    pool->fd = sys->fd;
+    pool->type = sys->cap_type;
+    pool->count = count;
+    pool->planes = planes;
+
+    for (unsigned i = 0; i < count; i++) {
+        pool->bufs[i].holds = 0;
+        for (unsigned j = 0; j < planes; j++) {
+            pool->bufs[i].base[j] = MAP_FAILED;
+            pool->bufs[i].fds[j] = -1;
+        }
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        struct v4l2_plane bplanes[VIDEO_MAX_PLANES] = { 0 };
+        struct v4l2_buffer buf = {
+            .type = sys->cap_type,
+            .memory = V4L2_MEMORY_MMAP,
+            .index = i,
+        };
+
+        if (sys->mplane) {
+            buf.m.planes = bplanes;
+            buf.length = planes;
+        }
+
+        if (xioctl(sys->fd, VIDIOC_QUERYBUF, &buf) < 0)
+            goto error;
+
+        for (unsigned j = 0; j < planes; j++) {
+            size_t length = sys->mplane ? bplanes[j].length : buf.length;
+            off_t offset = sys->mplane ? bplanes[j].m.mem_offset
+                                       : buf.m.offset;
+
+            pool->bufs[i].length[j] = length;
+            pool->bufs[i].base[j] = mmap(NULL, length, PROT_READ, MAP_SHARED,
+                                         sys->fd, offset);
+            if (pool->bufs[i].base[j] == MAP_FAILED)
+                goto error;
+
+            struct v4l2_exportbuffer exp = {
+                .type = sys->cap_type,
+                .index = i,
+                .plane = j,
+                .flags = O_RDONLY | O_CLOEXEC,
+            };
+
+            /* Without DMA buffers, the frames are copied */
+            if (xioctl(sys->fd, VIDIOC_EXPBUF, &exp) == 0)
+                pool->bufs[i].fds[j] = exp.fd;
+        }
+
+        if (PoolQueue(pool, i) < 0)
+            goto error;
+    }
+    return pool;
+
+error:
+    msg_Err(dec, "capture buffers error: %s", vlc_strerror_c(errno));
+    PoolRelease(pool);
+    return NULL;
+}
+
+static bool PoolCanExport(const struct v4l2m2m_pool *pool)
+{
+    for (unsigned i = 0; i < pool->count; i++)
+        for (unsigned j = 0; j < pool->planes; j++)
+            if (pool->bufs[i].fds[j] < 0)
+                return false;
+    return true;
+}
+
+/*****************************************************************************
+ * Pictures
+ *****************************************************************************/
+
+static void PicContextDestroy(picture_context_t *ctx)
+{
+    struct v4l2m2m_pic_context *pctx =
+        container_of(ctx, struct v4l2m2m_pic_context, s);
+
+    PoolReleaseBuffer(pctx->pool, pctx->index);
+    vlc_video_context_Release(ctx->vctx);
+    free(pctx);
+}
+
+static picture_context_t *PicContextCopy(picture_context_t *ctx)
+{
+    struct v4l2m2m_pic_context *pctx =
+        container_of(ctx, struct v4l2m2m_pic_context, s);
+    struct v4l2m2m_pic_context *copy = malloc(sizeof (*copy));
+    if (unlikely(copy == NULL))
+        return NULL;
+
+    *copy = *pctx;
+    PoolHoldBuffer(copy->pool, copy->index);
+    vlc_video_context_Hold(copy->s.vctx);
+    return &copy->s;
+}
+
+/* Wraps the capture buffer, which is given back when the picture is freed */
+static picture_t *WrapBuffer(decoder_t *dec, unsigned index)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2m2m_pool *pool = sys->pool;
+    struct v4l2m2m_pic_context *pctx = malloc(sizeof (*pctx));
+    if (unlikely(pctx == NULL))
+        return NULL;
+
+    picture_t *pic = decoder_NewPicture(dec);
+    if (pic == NULL) {
+        free(pctx);
+        return NULL;
+    }
+
+    pctx->s = (picture_context_t) {
+        PicContextDestroy, PicContextCopy, sys->vctx,
+    };
+    pctx->pool = pool;
+    pctx->index = index;
+    pctx->width = sys->width;
+    pctx->height = sys->height;
+    pctx->planes = sys->pic_planes;
+    for (unsigned i = 0; i < sys->pic_planes; i++) {
+        pctx->fds[i] = pool->bufs[index].fds[sys->buf_plane[i]];
+        pctx->offsets[i] = sys->offsets[i];
+        pctx->pitches[i] = sys->pitches[i];
+    }
+
+    /* The buffer was dequeued, so it is not held yet */
+    vlc_atomic_rc_inc(&pool->refs);
+    vlc_mutex_lock(&pool->lock);
+    pool->bufs[index].holds = 1;
+    vlc_mutex_unlock(&pool->lock);
+    vlc_video_context_Hold(sys->vctx);
+    pic->context = &pctx->s;
+    return pic;
+}
+
+/* Copies the capture buffer, which is given back immediately */
+static picture_t *CopyBuffer(decoder_t *dec, unsigned index)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2m2m_pool *pool = sys->pool;
+    picture_t *pic = decoder_NewPicture(dec);
+
+    if (pic != NULL)
+        for (int i = 0; i < pic->i_planes
+                     && (unsigned)i < sys->pic_planes; i++) {
+            const uint8_t *src = pool->bufs[index].base[sys->buf_plane[i]];
+            plane_t *dst = &pic->p[i];
+            unsigned lines = __MIN((unsigned)dst->i_visible_lines,
+                                   sys->lines[i]);
+            size_t width = __MIN((unsigned)dst->i_visible_pitch,
+                                 sys->pitches[i]);
+
+            src += sys->offsets[i];
+            for (unsigned y = 0; y < lines; y++)
+                memcpy(dst->p_pixels + y * dst->i_pitch,
+                       src + y * sys->pitches[i], width);
+        }
+
+    vlc_mutex_lock(&pool->lock);
+    PoolQueue(pool, index);
+    vlc_mutex_unlock(&pool->lock);
+    return pic;
+}
+
+/*****************************************************************************
+ * Capture queue
+ *****************************************************************************/
+
+static void StopCapture(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    uint32_t type = sys->cap_type;
+
+    if (sys->pool == NULL)
+        return;
+
+    xioctl(sys->fd, VIDIOC_STREAMOFF, &type);
+    PoolDetach(sys->pool);
+    sys->pool = NULL;
+
+    struct v4l2_requestbuffers req = {
+        .type = sys->cap_type,
+        .memory = V4L2_MEMORY_MMAP,
+        .count = 0,
+    };
+    xioctl(sys->fd, VIDIOC_REQBUFS, &req);
+}
+
+static int SetLayout(decoder_t *dec, const struct v4l2_format *fmt)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    uint32_t pixelformat = sys->mplane ? fmt->fmt.pix_mp.pixelformat
+                                       : fmt->fmt.pix.pixelformat;
+    size_t i = 0;
+
+    while (layouts[i].pixelformat != pixelformat)
+        if (++i >= ARRAY_SIZE(layouts))
+            return -1;
+
+    /* The single-planar API cannot describe non-contiguous planes */
+    if (!sys->mplane && !layouts[i].contiguous)
+        return -1;
+
+    const vlc_chroma_description_t *desc =
+        vlc_fourcc_GetChromaDescription(layouts[i].chroma);
+    unsigned height = sys->mplane ? fmt->fmt.pix_mp.height
+                                  : fmt->fmt.pix.height;
+    uint32_t offset = 0;
+
+    sys->width = sys->mplane ? fmt->fmt.pix_mp.width : fmt->fmt.pix.width;
+    sys->height = height;
+    sys->pic_planes = desc->plane_count;
+
+    for (unsigned p = 0; p < desc->plane_count; p++) {
+        unsigned lines = height * desc->p[p].h.num / desc->p[p].h.den;
+
+        if (layouts[i].contiguous) {
+            uint32_t pitch = sys->mplane
+                ? fmt->fmt.pix_mp.plane_fmt[0].bytesperline
+                : fmt->fmt.pix.bytesperline;
+
+            /* The chroma pitches follow from the luma pitch */
+            if (p > 0 && layouts[i].chroma == VLC_CODEC_I420)
+                pitch /= 2;
+            sys->buf_plane[p] = 0;
+            sys->pitches[p] = pitch;
+            sys->offsets[p] = offset;
+            offset += sys->pitches[p] * lines;
+        } else {
+            if (p >= fmt->fmt.pix_mp.num_planes)
+                return -1;
+            sys->buf_plane[p] = p;
+            sys->pitches[p] = fmt->fmt.pix_mp.plane_fmt[p].bytesperline;
+            sys->offsets[p] = 0;
+        }
+        sys->lines[p] = lines;
+    }
+
+    dec->fmt_out.i_codec = layouts[i].chroma;
+    return 0;
+}
+
+static int SelectLayout(decoder_t *dec, struct v4l2_format *fmt)
+{
+    decoder_sys_t *sys = dec->p_sys;
+
+    if (SetLayout(dec, fmt) == 0)
+        return 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(layouts); i++) {
+        struct v4l2_format try = *fmt;
+
+        if (sys->mplane)
+            try.fmt.pix_mp.pixelformat = layouts[i].pixelformat;
+        else
+            try.fmt.pix.pixelformat = layouts[i].pixelformat;
+
+        if (xioctl(sys->fd, VIDIOC_S_FMT, &try) == 0
+         && SetLayout(dec, &try) == 0) {
+            *fmt = try;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * (Re)allocates the capture buffers after a change of the stream format.
+ */
+static int StartCapture(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2_format fmt = { .type = sys->cap_type };
+
+    StopCapture(dec);
+
+    if (xioctl(sys->fd, VIDIOC_G_FMT, &fmt) < 0
+     || SelectLayout(dec, &fmt)) {
+        msg_Err(dec, "no supported frame format");
+        return -1;
+    }
+
+    struct v4l2_control ctrl = { .id = V4L2_CID_MIN_BUFFERS_FOR_CAPTURE };
+    unsigned count = EXTRA_CAPTURE_BUFFERS;
+
+    if (xioctl(sys->fd, VIDIOC_G_CTRL, &ctrl) == 0 && ctrl.value > 0)
+        count += ctrl.value;
+    else
+        count += 16;
+
+    struct v4l2_requestbuffers req = {
+        .type = sys->cap_type,
+        .memory = V4L2_MEMORY_MMAP,
+        .count = __MIN(count, VIDEO_MAX_FRAME),
+    };
+
+    if (xioctl(sys->fd, VIDIOC_REQBUFS, &req) < 0 || req.count == 0) {
+        msg_Err(dec, "capture buffers error: %s", vlc_strerror_c(errno));
+        return -1;
+    }
+
+    sys->pool = PoolCreate(dec, req.count,
+                           sys->mplane ? fmt.fmt.pix_mp.num_planes : 1);
+    if (sys->pool == NULL)
+        return -1;
+
+    uint32_t type = sys->cap_type;
+    if (xioctl(sys->fd, VIDIOC_STREAMON, &type) < 0) {
+        msg_Err(dec, "capture streaming error: %s", vlc_strerror_c(errno));
+        StopCapture(dec);
+        return -1;
+    }
+
+    /* The visible area is the composing rectangle */
+    video_format_t *vfmt = &dec->fmt_out.video;
+    struct v4l2_selection sel = {
+        .type = V4L2_BUF_TYPE_VIDEO_CAPTURE,
+        .target = V4L2_SEL_TGT_COMPOSE,
+    };
+
+    vfmt->i_width = sys->width;
+    vfmt->i_height = sys->height;
+    if (xioctl(sys->fd, VIDIOC_G_SELECTION, &sel) == 0
+     && sel.r.width > 0 && sel.r.height > 0) {
+        vfmt->i_x_offset = sel.r.left;
+        vfmt->i_y_offset = sel.r.top;
+        vfmt->i_visible_width = sel.r.width;
+        vfmt->i_visible_height = sel.r.height;
+    } else {
+        vfmt->i_x_offset = vfmt->i_y_offset = 0;
+        vfmt->i_visible_width = dec->fmt_in->video.i_visible_width
+                              ? dec->fmt_in->video.i_visible_width
+                              : sys->width;
+        vfmt->i_visible_height = dec->fmt_in->video.i_visible_height
+                               ? dec->fmt_in->video.i_visible_height
+                               : sys->height;
+    }
+    if (vfmt->i_sar_num == 0 || vfmt->i_sar_den == 0) {
+        vfmt->i_sar_num = 1;
+        vfmt->i_sar_den = 1;
+    }
+
+    msg_Dbg(dec, "decoding to %4.4s %ux%u, %u buffers",
+            (const char *)&dec->fmt_out.i_codec, sys->width, sys->height,
+            req.count);
+
+    /* Hand the DMA buffers over, if the video output takes them */
+    vlc_fourcc_t chroma = dec->fmt_out.i_codec;
+
+    if (sys->vctx != NULL) {
+        vlc_video_context_Release(sys->vctx);
+        sys->vctx = NULL;
+    }
+
+    if (PoolCanExport(sys->pool)) {
+        vlc_decoder_device *device = decoder_GetDecoderDevice(dec);
+
+        sys->vctx = vlc_video_context_Create(device, VLC_VIDEO_CONTEXT_V4L2M2M,
+                                   sizeof (struct v4l2m2m_video_context), NULL);
+        if (device != NULL)
+            vlc_decoder_device_Release(device);
+    }
+
+    if (sys->vctx != NULL) {
+        struct v4l2m2m_video_context *priv =
+            vlc_video_context_GetPrivate(sys->vctx, VLC_VIDEO_CONTEXT_V4L2M2M);
+
+        priv->chroma = chroma;
+        vfmt->i_chroma = dec->fmt_out.i_codec = VLC_CODEC_V4L2M2M_OPAQUE;
+        if (decoder_UpdateVideoOutput(dec, sys->vctx) == VLC_SUCCESS) {
+            sys->zero_copy = true;
+            return 0;
+        }
+
+        msg_Dbg(dec, "DMA buffers not supported by the video output");
+        vlc_video_context_Release(sys->vctx);
+        sys->vctx = NULL;
+    }
+
+    sys->zero_copy = false;
+    vfmt->i_chroma = dec->fmt_out.i_codec = chroma;
+    return decoder_UpdateVideoOutput(dec, NULL);
+}
+
+/**
+ * Handles the pending events.
+ */
+static int HandleEvents(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2_event ev;
+
+    while (xioctl(sys->fd, VIDIOC_DQEVENT, &ev) == 0)
+        if (ev.type == V4L2_EVENT_SOURCE_CHANGE
+         && (ev.u.src_change.changes & V4L2_EVENT_SRC_CH_RESOLUTION)) {
+            /* The frames decoded before the change must be output first */
+            msg_Dbg(dec, "stream format changed");
+            if (StartCapture(dec))
+                return -1;
+        }
+    return 0;
+}
+
+/**
+ * Outputs the decoded frames.
+ *
+ * \return true if the last frame before a stop command was dequeued
+ */
+static bool DequeueCapture(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+
+    while (sys->pool != NULL) {
+        struct v4l2_plane planes[VIDEO_MAX_PLANES] = { 0 };
+        struct v4l2_buffer buf = {
+            .type = sys->cap_type,
+            .memory = V4L2_MEMORY_MMAP,
+        };
+
+        if (sys->mplane) {
+            buf.m.planes = planes;
+            buf.length = sys->pool->planes;
+        }
+
+        if (xioctl(sys->fd, VIDIOC_DQBUF, &buf) < 0)
+            /* EPIPE: the last frame was already dequeued */
+            return errno == EPIPE;
+
+        size_t used = sys->mplane ? planes[0].bytesused : buf.bytesused;
+        bool last = (buf.flags & V4L2_BUF_FLAG_LAST) != 0;
+
+        if ((buf.flags & V4L2_BUF_FLAG_ERROR) || used == 0) {
+            vlc_mutex_lock(&sys->pool->lock);
+            PoolQueue(sys->pool, buf.index);
+            vlc_mutex_unlock(&sys->pool->lock);
+        } else {
+            picture_t *pic = sys->zero_copy ? WrapBuffer(dec, buf.index)
+                                            : CopyBuffer(dec, buf.index);
+
+            if (pic != NULL) {
+                pic->date = vlc_tick_from_timeval(&buf.timestamp);
+                pic->b_progressive = buf.field == V4L2_FIELD_NONE
+                                  || buf.field == V4L2_FIELD_ANY;
+                pic->b_top_field_first = buf.field != V4L2_FIELD_INTERLACED_BT;
+                decoder_QueueVideo(dec, pic);
+            } else if (sys->zero_copy) {
+                vlc_mutex_lock(&sys->pool->lock);
+                PoolQueue(sys->pool, buf.index);
+                vlc_mutex_unlock(&sys->pool->lock);
+            }
+        }
+
+        if (last)
+            return true;
+    }
+    return false;
+}
+
+/*****************************************************************************
+ * Output queue
+ *****************************************************************************/
+
+static void DequeueOutput(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+
+    for (;;) {
+        struct v4l2_plane plane = { 0 };
+        struct v4l2_buffer buf = {
+            .type = sys->out_type,
+            .memory = V4L2_MEMORY_MMAP,
+        };
+
+        if (sys->mplane) {
+            buf.m.planes = &plane;
+            buf.length = 1;
+        }
+
+        if (xioctl(sys->fd, VIDIOC_DQBUF, &buf) < 0)
+            break;
+
+        assert(buf.index < sys->out_count);
+        sys->out[buf.index].queued = false;
+    }
+}
+
+/**
+ * Waits for the device, and processes whatever it is ready for.
+ */
+static int Wait(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct pollfd ufd = {
+        .fd = sys->fd,
+        .events = POLLIN | POLLOUT | POLLPRI,
+    };
+    int val = poll(&ufd, 1, DEVICE_TIMEOUT_MS);
+
+    if (val <= 0) {
+        if (val == 0)
+            errno = ETIMEDOUT;
+        return -1;
+    }
+
+    if ((ufd.revents & POLLPRI) && HandleEvents(dec))
+        return -1;
+    if (ufd.revents & POLLOUT)
+        DequeueOutput(dec);
+    if (ufd.revents & POLLIN)
+        sys->drained |= DequeueCapture(dec);
+    return 0;
+}
+
+static int QueueOutput(decoder_t *dec, const uint8_t *data, size_t size,
+                       vlc_tick_t ts)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    unsigned index = 0;
+
+    DequeueOutput(dec);
+    while (sys->out[index].queued)
+        if (++index == sys->out_count) {
+            if (Wait(dec)) {
+                msg_Err(dec, "device error: %s", vlc_strerror_c(errno));
+                return -1;
+            }
+            index = 0;
+        }
+
+    if (size > sys->out[index].length) {
+        msg_Warn(dec, "truncating %zu bytes block", size);
+        size = sys->out[index].length;
+    }
+    memcpy(sys->out[index].base, data, size);
+
+    struct v4l2_plane plane = { .bytesused = size };
+    struct v4l2_buffer buf = {
+        .type = sys->out_type,
+        .memory = V4L2_MEMORY_MMAP,
+        .index = index,
+        .timestamp = {
+            .tv_sec = SEC_FROM_VLC_TICK(ts),
+            .tv_usec = US_FROM_VLC_TICK(ts % CLOCK_FREQ),
+        },
+    };
+
+    if (sys->mplane) {
+        buf.m.planes = &plane;
+        buf.length = 1;
+    } else
+        buf.bytesused = size;
+
+    if (xioctl(sys->fd, VIDIOC_QBUF, &buf) < 0) {
+        msg_Err(dec, "bitstream buffer error: %s", vlc_strerror_c(errno));
+        return -1;
+    }
+    sys->out[index].queued = true;
+    return 0;
+}
+
+/*****************************************************************************
+ * Decoder
+ *****************************************************************************/
+
+static int Drain(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    struct v4l2_decoder_cmd cmd = { .cmd = V4L2_DEC_CMD_STOP };
+
+    if (sys->pool == NULL)
+        return VLCDEC_SUCCESS;
+
+    if (xioctl(sys->fd, VIDIOC_DECODER_CMD, &cmd) < 0) {
+        msg_Warn(dec, "drain error: %s", vlc_strerror_c(errno));
+        return VLCDEC_SUCCESS;
+    }
+
+    sys->drained = false;
+    while (!sys->drained && sys->pool != NULL)
+        if (Wait(dec)) {
+            msg_Warn(dec, "drain error: %s", vlc_strerror_c(errno));
+            break;
+        }
+
+    /* Resume decoding for the next blocks */
+    cmd.cmd = V4L2_DEC_CMD_START;
+    xioctl(sys->fd, VIDIOC_DECODER_CMD, &cmd);
+    return VLCDEC_SUCCESS;
+}
+
+static int Decode(decoder_t *dec, block_t *block)
+{
+    decoder_sys_t *sys = dec->p_sys;
+
+    if (block == NULL)
+        return Drain(dec);
+
+    if (block->i_flags & BLOCK_FLAG_CORRUPTED) {
+        block_Release(block);
+        return VLCDEC_SUCCESS;
+    }
+
+    vlc_tick_t ts = (block->i_pts != VLC_TICK_INVALID) ? block->i_pts
+                                                       : block->i_dts;
+
+    if (sys->b_hxxx) {
+        if (!sys->b_xps_pushed) {
+            /* Parameter sets (SPS/PPS/VPS) from the extradata */
+            block_t *xps = hxxx_helper_get_extradata_block(&sys->hh);
+
+            if (xps != NULL) {
+                QueueOutput(dec, xps->p_buffer, xps->i_buffer, ts);
+                block_Release(xps);
+            }
+            sys->b_xps_pushed = true;
+        }
+
+        block = hxxx_helper_process_block(&sys->hh, block);
+        if (block == NULL)
+            return VLCDEC_SUCCESS;
+    } else if (!sys->b_extra_pushed) {
+        /* Sequence headers from the extradata */
+        if (dec->fmt_in->i_extra > 0)
+            QueueOutput(dec, dec->fmt_in->p_extra, dec->fmt_in->i_extra, ts);
+        sys->b_extra_pushed = true;
+    }
+
+    int ret = QueueOutput(dec, block->p_buffer, block->i_buffer, ts);
+    block_Release(block);
+    if (ret)
+        return VLCDEC_ECRITICAL;
+
+    /* Process whatever is ready, without waiting */
+    if (HandleEvents(dec))
+        return VLCDEC_ECRITICAL;
+    DequeueOutput(dec);
+    DequeueCapture(dec);
+    return VLCDEC_SUCCESS;
+}
+
+static void Flush(decoder_t *dec)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    uint32_t type = sys->out_type;
+
+    /* Stopping the queue returns all the bitstream buffers */
+    xioctl(sys->fd, VIDIOC_STREAMOFF, &type);
+    for (unsigned i = 0; i < sys->out_count; i++)
+        sys->out[i].queued = false;
+    xioctl(sys->fd, VIDIOC_STREAMON, &type);
+
+    struct v4l2m2m_pool *pool = sys->pool;
+
+    if (pool != NULL) {
+        /* Requeue the capture buffers, but those used by pictures */
+        type = sys->cap_type;
+        vlc_mutex_lock(&pool->lock);
+        xioctl(sys->fd, VIDIOC_STREAMOFF, &type);
+        for (unsigned i = 0; i < pool->count; i++)
+            if (pool->bufs[i].holds == 0)
+                PoolQueue(pool, i);
+        xioctl(sys->fd, VIDIOC_STREAMON, &type);
+        vlc_mutex_unlock(&pool->lock);
+    }
+}
+
+/**
+ * Finds a stateful decoder for the codec.
+ */
+static int OpenDevice(decoder_t *dec, const char *path, uint32_t pixelformat)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    int fd = vlc_open(path, O_RDWR | O_NONBLOCK);
+    if (fd < 0)
+        return -1;
+
+    struct v4l2_capability cap;
+
+    if (xioctl(fd, VIDIOC_QUERYCAP, &cap) < 0)
+        goto error;
+
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS)
+                  ? cap.device_caps : cap.capabilities;
+
+    if (!(caps & V4L2_CAP_STREAMING))
+        goto error;
+    if (caps & V4L2_CAP_VIDEO_M2M_MPLANE) {
+        sys->mplane = true;
+        sys->out_type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+        sys->cap_type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+    } else if (caps & V4L2_CAP_VIDEO_M2M) {
+        sys->mplane = false;
+        sys->out_type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+        sys->cap_type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    } else
+        goto error;
+
+    /* Stateless decoders take parsed slices, not the bitstream */
+    struct v4l2_fmtdesc desc = { .type = sys->out_type };
+
+    for (desc.index = 0; xioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0;
+         desc.index++)
+        if (desc.pixelformat == pixelformat) {
+            msg_Dbg(dec, "using %s (%s)", path, (const char *)cap.card);
+            return fd;
+        }
+
+error:
+    vlc_close(fd);
+    return -1;
+}
+
+static int SetupOutput(decoder_t *dec, uint32_t pixelformat)
+{
+    decoder_sys_t *sys = dec->p_sys;
+    const video_format_t *vfmt = &dec->fmt_in->video;
+    /* Room for an intra frame at worst compression */
+    uint32_t size = __MAX(vfmt->i_width * vfmt->i_height * 3 / 4, 1 << 20);
+    struct v4l2_format fmt = { .type = sys->out_type };
+
+    if (sys->mplane) {
+        fmt.fmt.pix_mp.pixelformat = pixelformat;
+        fmt.fmt.pix_mp.width = vfmt->i_width;
+        fmt.fmt.pix_mp.height = vfmt->i_height;
+        fmt.fmt.pix_mp.num_planes = 1;
+        fmt.fmt.pix_mp.plane_fmt[0].sizeimage = size;
+    } else {
+        fmt.fmt.pix.pixelformat = pixelformat;
+        fmt.fmt.pix.width = vfmt->i_width;
+        fmt.fmt.pix.height = vfmt->i_height;
+        fmt.fmt.pix.sizeimage = size;
+    }
+
+    if (xioctl(sys->fd, VIDIOC_S_FMT, &fmt) < 0)
+        goto error;
+
+    struct v4l2_requestbuffers req = {
+        .type = sys->out_type,
+        .memory = V4L2_MEMORY_MMAP,
+        .count = OUTPUT_BUFFERS,
+    };
+
+    if (xioctl(sys->fd, VIDIOC_REQBUFS, &req) < 0 || req.count == 0)
+        goto error;
+
+    sys->out_count = __MIN(req.count, OUTPUT_BUFFERS);
+    for (unsigned i = 0; i < sys->out_count; i++) {
+        struct v4l2_plane plane = { 0 };
+        struct v4l2_buffer buf = {
+            .type = sys->out_type,
+            .memory = V4L2_MEMORY_MMAP,
+            .index = i,
+        };
+
+        if (sys->mplane) {
+            buf.m.planes = &plane;
+            buf.length = 1;
+        }
+
+        if (xioctl(sys->fd, VIDIOC_QUERYBUF, &buf) < 0)
+            goto error;
+
+        size_t length = sys->mplane ? plane.length : buf.length;
+        off_t offset = sys->mplane ? plane.m.mem_offset : buf.m.offset;
+
+        sys->out[i].base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, sys->fd, offset);
+        if (sys->out[i].base == MAP_FAILED)
+            goto error;
+        sys->out[i].length = length;
+        sys->out[i].queued = false;
+    }
+
+    struct v4l2_event_subscription sub = {
+        .type = V4L2_EVENT_SOURCE_CHANGE,
+    };
+    uint32_t type = sys->out_type;
+
+    if (xioctl(sys->fd, VIDIOC_SUBSCRIBE_EVENT, &sub) < 0
+     || xioctl(sys->fd, VIDIOC_STREAMON, &type) < 0)
+        goto error;
+    return 0;
+
+error:
+    msg_Err(dec, "bitstream setup error: %s", vlc_strerror_c(errno));
+    return -1;
+}
+
+static void CloseDecoder(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t *)obj;
+    decoder_sys_t *sys = dec->p_sys;
+    uint32_t type = sys->out_type;
+
+    StopCapture(dec);
+    xioctl(sys->fd, VIDIOC_STREAMOFF, &type);
+    for (unsigned i = 0; i < sys->out_count; i++)
+        if (sys->out[i].base != MAP_FAILED)
+            munmap(sys->out[i].base, sys->out[i].length);
+    vlc_close(sys->fd);
+
+    if (sys->vctx != NULL)
+        vlc_video_context_Release(sys->vctx);
+    if (sys->b_hxxx)
+        hxxx_helper_clean(&sys->hh);
+    free(sys);
+}
+
+static int OpenDecoder(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t *)obj;
+    uint32_t pixelformat = 0;
+
+    if (dec->fmt_in->i_cat != VIDEO_ES || !var_InheritBool(dec, "hw-dec"))
+        return VLC_EGENERIC;
+
+    for (size_t i = 0; i < ARRAY_SIZE(codecs); i++)
+        if (codecs[i].codec == dec->fmt_in->i_codec)
+            pixelformat = codecs[i].pixelformat;
+    if (pixelformat == 0)
+        return VLC_EGENERIC;
+
+    decoder_sys_t *sys = calloc(1, sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    dec->p_sys = sys;
+    sys->fd = -1;
+
+    char *path = var_InheritString(dec, "v4l2m2m-dev");
+
+    if (path != NULL) {
+        sys->fd = OpenDevice(dec, path, pixelformat);
+        free(path);
+    } else
+        for (unsigned i = 0; i < 64 && sys->fd < 0; i++) {
+            char name[sizeof ("/dev/video64")];
+
+            snprintf(name, sizeof (name), "/dev/video%u", i);
+            sys->fd = OpenDevice(dec, name, pixelformat);
+        }
+
+    if (sys->fd < 0) {
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    for (unsigned i = 0; i < OUTPUT_BUFFERS; i++)
+        sys->out[i].base = MAP_FAILED;
+
+    if (SetupOutput(dec, pixelformat))
+        goto error;
+
+    if (dec->fmt_in->i_codec == VLC_CODEC_H264
+     || dec->fmt_in->i_codec == VLC_CODEC_HEVC) {
+        /* The decoder takes Annex B streams */
+        sys->b_hxxx = true;
+        hxxx_helper_init(&sys->hh, VLC_OBJECT(dec),
+                         dec->fmt_in->i_codec, 0, 0);
+        if (hxxx_helper_set_extra(&sys->hh, dec->fmt_in->p_extra,
+                                  dec->fmt_in->i_extra) != VLC_SUCCESS)
+            goto error;
+    }
+
+    es_format_Copy(&dec->fmt_out, dec->fmt_in);
+    dec->fmt_out.i_cat = VIDEO_ES;
+    dec->fmt_out.i_codec = VLC_CODEC_NV12;
+    dec->fmt_out.video.i_chroma = VLC_CODEC_NV12;
+
+    dec->pf_decode = Decode;
+    dec->pf_flush = Flush;
+    return VLC_SUCCESS;
+
+error:
+    CloseDecoder(obj);
+    return VLC_EGENERIC;
+}
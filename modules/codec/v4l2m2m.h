@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * v4l2m2m.h: V4L2 memory-to-memory decoder pictures
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_V4L2M2M_H
+#define VLC_V4L2M2M_H 1
+
+#include <vlc_picture.h>
+
+/**
+ * Private data of the VLC_VIDEO_CONTEXT_V4L2M2M video contexts.
+ */
+struct v4l2m2m_video_context
+{
+    vlc_fourcc_t chroma; /**< Layout of the DMA buffers, NV12 or I420 */
+};
+
+struct v4l2m2m_pool;
+
+/**
+ * Context of the VLC_CODEC_V4L2M2M_OPAQUE pictures.
+ *
+ * The decoder does not reuse the capture buffer of the picture, and the DMA
+ * buffers stay open, as long as the context exists.
+ */
+struct v4l2m2m_pic_context
+{
+    picture_context_t s;
+    struct v4l2m2m_pool *pool;
+    unsigned index;
+    unsigned width; /**< Allocated width, in pixels */
+    unsigned height; /**< Allocated height, in pixels */
+    unsigned planes;
+    int fds[PICTURE_PLANE_MAX]; /**< DMA buffer of each plane */
+    uint32_t offsets[PICTURE_PLANE_MAX];
+    uint32_t pitches[PICTURE_PLANE_MAX];
+};
+
+static inline vlc_fourcc_t v4l2m2m_GetChroma(vlc_video_context *vctx)
+{
+    const struct v4l2m2m_video_context *priv =
+        vlc_video_context_GetPrivate(vctx, VLC_VIDEO_CONTEXT_V4L2M2M);
+
+    return (priv != NULL) ? priv->chroma : 0;
+}
+
+static inline const struct v4l2m2m_pic_context *
+v4l2m2m_GetPicContext(const picture_t *pic)
+{
+    return container_of(pic->context, struct v4l2m2m_pic_context, s);
+}
+
+#endif
@@ -382,7 +382,7 @@ static bool FillReorderInfoH264(decoder_t *p_dec, const block_t *p_block,
 
                 for (size_t i = 0; i < i_sei_count; i++)
                     HxxxParseSEI(sei_array[i].p_nal, sei_array[i].i_nal, 1,
-                                 ParseH264SEI, &sei);
+                                 HXXX_SEI_MASK_PIC_TIMING, ParseH264SEI, &sei);
 
                 p_info->i_num_ts = h264_get_num_ts(p_sps, &slice, sei.i_pic_struct,
                                                    p_info->i_foc, bFOC);
@@ -761,7 +761,7 @@ static bool FillReorderInfoHEVC(decoder_t *p_dec, const block_t *p_block,
 
                 for (size_t i=0; i<i_sei_count; i++)
                     HxxxParseSEI(sei_array[i].p_nal, sei_array[i].i_nal,
-                                 2, ParseHEVCSEI, &sei);
+                                 2, HXXX_SEI_MASK_PIC_TIMING, ParseHEVCSEI, &sei);
 
                 p_info->i_poc = POC;
                 p_info->i_foc = POC; /* clearly looks wrong :/ */
@@ -1995,7 +1995,7 @@ static int DecodeBlock(decoder_t *p_dec, block_t *p_block)
         /* Add an empty variable so that videotoolbox won't be loaded again for
          * this ES */
         var_Create(p_dec, "videotoolbox-failed", VLC_VAR_VOID);
-        return VLCDEC_RELOAD;
+        return VLCDEC_FALLBACK;
     }
     else if (p_sys->vtsession_status == VTSESSION_STATUS_VOUT_FAILURE)
     {
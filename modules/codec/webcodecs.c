@@ -0,0 +1,559 @@
+/*****************************************************************************
+ * webcodecs.c: WebCodecs video decoder for emscripten
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * The browser VideoDecoder is driven from the decoder thread, which is a web
+ * worker: the asynchronous calls (configuration check, backpressure, frame
+ * copies) suspend the thread with Asyncify until the browser completes them,
+ * like the emjsfile access does. The output callback of the VideoDecoder only
+ * queues the frames; they are copied into the pictures from Decode().
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_codec.h>
+#include <vlc_picture.h>
+
+#include <emscripten.h>
+
+#include "../packetizer/h264_nal.h"
+#include "../packetizer/hevc_nal.h"
+#include "../packetizer/hxxx_nal.h"
+
+/* Number of chunks queued in the browser decoder before Decode() waits */
+#define WEBCODECS_MAX_QUEUE 8
+
+static int  OpenDecoder(vlc_object_t *);
+static void CloseDecoder(vlc_object_t *);
+
+vlc_module_begin ()
+    set_shortname("WebCodecs")
+    set_description(N_("WebCodecs video decoder"))
+    set_capability("video decoder", 800)
+    set_callbacks(OpenDecoder, CloseDecoder)
+    set_subcategory(SUBCAT_INPUT_VCODEC)
+vlc_module_end ()
+
+typedef struct
+{
+    /* The browser decoder needs a key chunk after the configuration */
+    bool b_need_key;
+    bool b_fmt_set;
+} decoder_sys_t;
+
+static const struct
+{
+    char psz_name[8];
+    vlc_fourcc_t i_chroma;
+} formats[] = {
+    { "I420",    VLC_CODEC_I420 },
+    { "I420P10", VLC_CODEC_I420_10L },
+    { "I422",    VLC_CODEC_I422 },
+    { "I444",    VLC_CODEC_I444 },
+    { "NV12",    VLC_CODEC_NV12 },
+    { "RGBA",    VLC_CODEC_RGBA },
+    { "BGRA",    VLC_CODEC_BGRA },
+};
+
+/* Format of the frames the browser cannot output in one of the formats
+ * above: it converts them when copying */
+#define WEBCODECS_CONVERT_FORMAT "RGBA"
+#define WEBCODECS_CONVERT_CHROMA VLC_CODEC_RGBA
+
+EM_ASYNC_JS(int, webcodecs_open, (decoder_t *dec, const char *codec,
+                                  unsigned width, unsigned height), {
+    if (typeof VideoDecoder === 'undefined')
+        return -1;
+
+    const config = {
+        codec: UTF8ToString(codec),
+        hardwareAcceleration: 'prefer-hardware',
+        optimizeForLatency: true,
+    };
+    if (width > 0 && height > 0) {
+        config.codedWidth = width;
+        config.codedHeight = height;
+    }
+    try {
+        const support = await VideoDecoder.isConfigSupported(config);
+        if (!support.supported)
+            return -1;
+    }
+    catch (error) {
+        return -1;
+    }
+
+    if (Module.vlcWebCodecs === undefined)
+        Module.vlcWebCodecs = {};
+    const state = { config: config, frames: [], error: false, wake: undefined };
+    state.decoder = new VideoDecoder({
+        output: (frame) => {
+            state.frames.push(frame);
+        },
+        error: (error) => {
+            console.error("webcodecs decoder error: " + error);
+            state.error = true;
+            if (state.wake !== undefined)
+                state.wake();
+        },
+    });
+    try {
+        state.decoder.configure(config);
+    }
+    catch (error) {
+        console.error("webcodecs configure error: " + error);
+        return -1;
+    }
+    Module.vlcWebCodecs[dec] = state;
+    return 0;
+});
+
+EM_JS(void, webcodecs_close, (decoder_t *dec), {
+    const state = Module.vlcWebCodecs[dec];
+    for (const frame of state.frames)
+        frame.close();
+    if (state.decoder.state !== 'closed')
+        state.decoder.close();
+    delete Module.vlcWebCodecs[dec];
+});
+
+EM_ASYNC_JS(int, webcodecs_decode, (decoder_t *dec, const uint8_t *data,
+                                    size_t size, double timestamp, int key,
+                                    unsigned max_queue), {
+    const state = Module.vlcWebCodecs[dec];
+    if (state.error)
+        return -1;
+
+    try {
+        /* The chunk data cannot be a view of the shared wasm memory */
+        state.decoder.decode(new EncodedVideoChunk({
+            type: key ? 'key' : 'delta',
+            timestamp: timestamp,
+            data: HEAPU8.slice(data, data + size),
+        }));
+    }
+    catch (error) {
+        console.error("webcodecs decode error: " + error);
+        return -1;
+    }
+
+    /* Return to the event loop, so that the output callback is called, and
+     * wait for the browser decoder if too many chunks are pending */
+    await new Promise((resolve) => {
+        state.wake = resolve;
+        if (state.decoder.decodeQueueSize < max_queue)
+            setTimeout(resolve, 0);
+        else
+            state.decoder.addEventListener('dequeue', resolve, { once: true });
+    });
+    state.wake = undefined;
+    return state.error ? -1 : 0;
+});
+
+EM_ASYNC_JS(int, webcodecs_drain, (decoder_t *dec), {
+    const state = Module.vlcWebCodecs[dec];
+    if (state.error)
+        return -1;
+    try {
+        await state.decoder.flush();
+    }
+    catch (error) {
+        return -1;
+    }
+    return 0;
+});
+
+EM_JS(void, webcodecs_flush, (decoder_t *dec), {
+    const state = Module.vlcWebCodecs[dec];
+    for (const frame of state.frames)
+        frame.close();
+    state.frames = [];
+    if (state.error)
+        return;
+    state.decoder.reset();
+    state.decoder.configure(state.config);
+});
+
+EM_JS(int, webcodecs_peek_frame, (decoder_t *dec, char *format,
+                                  size_t format_size, unsigned *size,
+                                  double *timestamp), {
+    const state = Module.vlcWebCodecs[dec];
+    if (state.frames.length === 0)
+        return 0;
+
+    const frame = state.frames[0];
+    stringToUTF8(frame.format !== null ? frame.format : "", format, format_size);
+    HEAPU32[(size >> 2) + 0] = frame.visibleRect.width;
+    HEAPU32[(size >> 2) + 1] = frame.visibleRect.height;
+    HEAPU32[(size >> 2) + 2] = frame.displayWidth;
+    HEAPU32[(size >> 2) + 3] = frame.displayHeight;
+    HEAPF64[timestamp >> 3] = frame.timestamp;
+    return 1;
+});
+
+EM_ASYNC_JS(int, webcodecs_copy_frame, (decoder_t *dec, uint8_t *data,
+                                        size_t size, const unsigned *layout,
+                                        int planes, const char *format), {
+    const state = Module.vlcWebCodecs[dec];
+    const frame = state.frames.shift();
+    let ret = 0;
+
+    if (planes > 0) {
+        const options = { layout: [] };
+        for (let i = 0; i < planes; i++)
+            options.layout.push({
+                offset: HEAPU32[(layout >> 2) + 2 * i],
+                stride: HEAPU32[(layout >> 2) + 2 * i + 1],
+            });
+        if (format) {
+            options.format = UTF8ToString(format);
+            options.colorSpace = 'srgb';
+        }
+        try {
+            await frame.copyTo(HEAPU8.subarray(data, data + size), options);
+        }
+        catch (error) {
+            console.error("webcodecs copy error: " + error);
+            ret = -1;
+        }
+    }
+    frame.close();
+    return ret;
+});
+
+static vlc_fourcc_t GetChroma(const char *psz_format)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(formats); i++)
+        if (!strcmp(psz_format, formats[i].psz_name))
+            return formats[i].i_chroma;
+    return 0;
+}
+
+static int UpdateFormat(decoder_t *dec, vlc_fourcc_t i_chroma,
+                        const unsigned size[static 4])
+{
+    decoder_sys_t *p_sys = dec->p_sys;
+    video_format_t *fmt = &dec->fmt_out.video;
+
+    if (p_sys->b_fmt_set && fmt->i_chroma == i_chroma
+     && fmt->i_visible_width == size[0] && fmt->i_visible_height == size[1])
+        return VLC_SUCCESS;
+
+    dec->fmt_out.i_codec = i_chroma;
+    fmt->i_chroma = i_chroma;
+    fmt->i_width = fmt->i_visible_width = size[0];
+    fmt->i_height = fmt->i_visible_height = size[1];
+    fmt->i_x_offset = fmt->i_y_offset = 0;
+    if (size[0] > 0 && size[1] > 0 && size[2] > 0 && size[3] > 0)
+    {
+        fmt->i_sar_num = size[2] * size[1];
+        fmt->i_sar_den = size[3] * size[0];
+        vlc_ureduce(&fmt->i_sar_num, &fmt->i_sar_den,
+                    fmt->i_sar_num, fmt->i_sar_den, 0);
+    }
+    if (fmt->i_sar_num == 0 || fmt->i_sar_den == 0)
+        fmt->i_sar_num = fmt->i_sar_den = 1;
+
+    p_sys->b_fmt_set = false;
+    if (decoder_UpdateVideoFormat(dec))
+        return VLC_EGENERIC;
+    p_sys->b_fmt_set = true;
+    return VLC_SUCCESS;
+}
+
+static int CopyFrame(decoder_t *dec, picture_t *pic, const char *psz_convert)
+{
+    /* The planes are relative to the lowest one, all of them are in the
+     * wasm memory */
+    const uint8_t *p_base = pic->p[0].p_pixels;
+    for (int i = 1; i < pic->i_planes; i++)
+        if (pic->p[i].p_pixels < p_base)
+            p_base = pic->p[i].p_pixels;
+
+    unsigned layout[2 * PICTURE_PLANE_MAX];
+    size_t i_size = 0;
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        const plane_t *p = &pic->p[i];
+        layout[2 * i + 0] = p->p_pixels - p_base;
+        layout[2 * i + 1] = p->i_pitch;
+        i_size = __MAX(i_size, layout[2 * i] + (size_t)p->i_pitch * p->i_lines);
+    }
+
+    return webcodecs_copy_frame(dec, (uint8_t *)p_base, i_size, layout,
+                                pic->i_planes, psz_convert);
+}
+
+static void OutputFrames(decoder_t *dec)
+{
+    char psz_format[16];
+    unsigned size[4];
+    double timestamp;
+
+    while (webcodecs_peek_frame(dec, psz_format, sizeof(psz_format), size,
+                                &timestamp))
+    {
+        const char *psz_convert = NULL;
+        vlc_fourcc_t i_chroma = GetChroma(psz_format);
+        if (i_chroma == 0)
+        {
+            i_chroma = WEBCODECS_CONVERT_CHROMA;
+            psz_convert = WEBCODECS_CONVERT_FORMAT;
+        }
+
+        picture_t *pic = NULL;
+        if (UpdateFormat(dec, i_chroma, size) == VLC_SUCCESS)
+            pic = decoder_NewPicture(dec);
+        if (pic == NULL)
+        {
+            /* drop the frame */
+            webcodecs_copy_frame(dec, NULL, 0, NULL, 0, NULL);
+            continue;
+        }
+
+        if (CopyFrame(dec, pic, psz_convert))
+        {
+            picture_Release(pic);
+            continue;
+        }
+
+        pic->date = VLC_TICK_FROM_US((int64_t)timestamp);
+        pic->b_progressive = true;
+        decoder_QueueVideo(dec, pic);
+    }
+}
+
+static bool IsKeyframe(decoder_t *dec, const block_t *block)
+{
+    const uint8_t *p_buf = block->p_buffer;
+    size_t i_buf = block->i_buffer;
+
+    switch (dec->fmt_in->i_codec)
+    {
+        case VLC_CODEC_H264:
+        case VLC_CODEC_HEVC:
+        {
+            /* Only IDR (or IRAP) access units are key chunks for the
+             * browser, not every I picture */
+            hxxx_iterator_ctx_t it;
+            const uint8_t *p_nal;
+            size_t i_nal;
+
+            hxxx_iterator_init(&it, p_buf, i_buf, 0);
+            while (hxxx_annexb_iterate_next(&it, &p_nal, &i_nal))
+            {
+                if (i_nal < 2)
+                    continue;
+                if (dec->fmt_in->i_codec == VLC_CODEC_H264)
+                {
+                    if (h264_getNALType(p_nal) == H264_NAL_SLICE_IDR)
+                        return true;
+                }
+                else
+                {
+                    uint8_t i_type = hevc_getNALType(p_nal);
+                    if (i_type >= HEVC_NAL_BLA_W_LP &&
+                        i_type <= HEVC_NAL_IRAP_VCL23)
+                        return true;
+                }
+            }
+            return false;
+        }
+        case VLC_CODEC_VP8:
+            return i_buf > 0 && !(p_buf[0] & 0x01);
+        case VLC_CODEC_VP9:
+        {
+            if (i_buf == 0 || (p_buf[0] >> 6) != 0x2)
+                return false;
+            /* frame_marker, profile, [reserved_zero], show_existing_frame,
+             * frame_type */
+            unsigned i_profile = ((p_buf[0] >> 5) & 1) | (((p_buf[0] >> 4) & 1) << 1);
+            unsigned i_bit = (i_profile == 3) ? 5 : 4;
+            if (p_buf[0] & (0x80 >> i_bit))
+                return false;
+            return !(p_buf[0] & (0x80 >> (i_bit + 1)));
+        }
+        default:
+            return block->i_flags & BLOCK_FLAG_TYPE_I;
+    }
+}
+
+static int Decode(decoder_t *dec, block_t *block)
+{
+    decoder_sys_t *p_sys = dec->p_sys;
+
+    if (block == NULL)
+    {
+        if (!p_sys->b_need_key && webcodecs_drain(dec) == 0)
+            OutputFrames(dec);
+        return VLCDEC_SUCCESS;
+    }
+
+    if (block->i_flags & BLOCK_FLAG_CORRUPTED)
+    {
+        block_Release(block);
+        return VLCDEC_SUCCESS;
+    }
+
+    const bool b_key = IsKeyframe(dec, block);
+    if (p_sys->b_need_key)
+    {
+        if (!b_key)
+        {
+            block_Release(block);
+            return VLCDEC_SUCCESS;
+        }
+
+        /* The in-band parameter sets may have been skipped by the
+         * packetizer: the first key chunk carries them */
+        const uint8_t *p_extra = dec->fmt_in->p_extra;
+        size_t i_extra = dec->fmt_in->i_extra;
+        if ((dec->fmt_in->i_codec == VLC_CODEC_H264 ||
+             dec->fmt_in->i_codec == VLC_CODEC_HEVC) &&
+            i_extra > 3 && hxxx_strip_AnnexB_startcode(&p_extra, &i_extra))
+        {
+            block_t *xps = block_Alloc(dec->fmt_in->i_extra);
+            if (xps != NULL)
+            {
+                memcpy(xps->p_buffer, dec->fmt_in->p_extra,
+                       dec->fmt_in->i_extra);
+                block_CopyProperties(xps, block);
+                block_ChainAppend(&xps, block);
+                block = block_ChainGather(xps);
+                if (block == NULL)
+                {
+                    block_ChainRelease(xps);
+                    return VLCDEC_SUCCESS;
+                }
+            }
+        }
+        p_sys->b_need_key = false;
+    }
+
+    vlc_tick_t i_ts = block->i_pts != VLC_TICK_INVALID ? block->i_pts
+                                                       : block->i_dts;
+    int ret = webcodecs_decode(dec, block->p_buffer, block->i_buffer,
+                               US_FROM_VLC_TICK(i_ts), b_key,
+                               WEBCODECS_MAX_QUEUE);
+    block_Release(block);
+
+    if (ret != 0)
+    {
+        msg_Err(dec, "decoder failure, falling back");
+        /* Do not load the module again for this ES */
+        var_Create(dec, "webcodecs-failed", VLC_VAR_VOID);
+        return VLCDEC_FALLBACK;
+    }
+
+    OutputFrames(dec);
+    return VLCDEC_SUCCESS;
+}
+
+static void Flush(decoder_t *dec)
+{
+    decoder_sys_t *p_sys = dec->p_sys;
+
+    webcodecs_flush(dec);
+    p_sys->b_need_key = true;
+}
+
+static int GetCodecString(const es_format_t *fmt, char *psz, size_t i_size)
+{
+    int i_profile = fmt->i_profile, i_level = fmt->i_level;
+
+    switch (fmt->i_codec)
+    {
+        case VLC_CODEC_H264:
+            /* avc1.PPCCLL, without the constraint flags */
+            return snprintf(psz, i_size, "avc1.%02X00%02X",
+                            i_profile > 0 ? i_profile : 100,
+                            i_level > 0 ? i_level : 51);
+        case VLC_CODEC_HEVC:
+            /* hev1.P.C.Ltier+level.B0, Main or Main 10 */
+            if (i_profile <= 0)
+                i_profile = 1;
+            return snprintf(psz, i_size, "hev1.%d.%d.L%d.B0", i_profile,
+                            i_profile == 2 ? 4 : 6,
+                            i_level > 0 ? i_level : 153);
+        case VLC_CODEC_VP8:
+            return snprintf(psz, i_size, "vp8");
+        case VLC_CODEC_VP9:
+            /* vp09.PP.LL.DD */
+            if (i_profile < 0)
+                i_profile = 0;
+            return snprintf(psz, i_size, "vp09.%02d.%02d.%02d", i_profile,
+                            i_level > 0 ? i_level : 51,
+                            i_profile >= 2 ? 10 : 8);
+        case VLC_CODEC_AV1:
+            /* av01.P.LLT.DD */
+            if (i_profile < 0)
+                i_profile = 0;
+            return snprintf(psz, i_size, "av01.%d.%02dM.08", i_profile,
+                            i_level >= 0 ? i_level : 13);
+        default:
+            return -1;
+    }
+}
+
+static int OpenDecoder(vlc_object_t *p_this)
+{
+    decoder_t *dec = (decoder_t *)p_this;
+    char psz_codec[32];
+
+    if (var_Type(dec, "webcodecs-failed") != 0)
+        return VLC_EGENERIC;
+
+    int i_len = GetCodecString(dec->fmt_in, psz_codec, sizeof(psz_codec));
+    if (i_len < 0 || (size_t)i_len >= sizeof(psz_codec))
+        return VLC_EGENERIC;
+
+    decoder_sys_t *p_sys = vlc_obj_malloc(p_this, sizeof(*p_sys));
+    if (unlikely(p_sys == NULL))
+        return VLC_ENOMEM;
+
+    if (webcodecs_open(dec, psz_codec, dec->fmt_in->video.i_width,
+                       dec->fmt_in->video.i_height))
+    {
+        msg_Dbg(dec, "%s is not supported by the browser", psz_codec);
+        return VLC_EGENERIC;
+    }
+    msg_Dbg(dec, "decoding %s", psz_codec);
+
+    p_sys->b_need_key = true;
+    p_sys->b_fmt_set = false;
+    dec->p_sys = p_sys;
+
+    video_format_Copy(&dec->fmt_out.video, &dec->fmt_in->video);
+    dec->fmt_out.i_codec = VLC_CODEC_I420;
+    dec->pf_decode = Decode;
+    dec->pf_flush = Flush;
+    return VLC_SUCCESS;
+}
+
+static void CloseDecoder(vlc_object_t *p_this)
+{
+    decoder_t *dec = (decoder_t *)p_this;
+
+    webcodecs_close(dec);
+}
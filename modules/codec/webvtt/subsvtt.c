@@ -1707,25 +1707,101 @@ static void ClearCSSStyles( webvtt_dom_node_t *p_node )
 }
 
 #ifdef HAVE_CSS
+/* Selections of a rule, kept for all the intervals of a single Render()
+ * as the DOM does not change in between. Only rules depending on the
+ * playback time need to be matched again. */
+typedef struct
+{
+    bool b_timed;
+    bool b_selected;
+    vlc_array_t nodes;
+} webvtt_css_selection_t;
+
+static bool webvtt_css_selector_IsTimed( const vlc_css_selector_t *p_sel )
+{
+    for( ; p_sel; p_sel = p_sel->p_next )
+    {
+        if( p_sel->type == SELECTOR_PSEUDOCLASS &&
+            ( !strcmp( p_sel->psz_name, "past" ) || !strcmp( p_sel->psz_name, "future" ) ) )
+            return true;
+        if( webvtt_css_selector_IsTimed( p_sel->specifiers.p_first ) )
+            return true;
+    }
+    return false;
+}
+
+static webvtt_css_selection_t * webvtt_css_selections_New( const vlc_css_rule_t *p_rules,
+                                                           size_t *pi_count )
+{
+    size_t i_count = 0;
+    for( const vlc_css_rule_t *p_rule = p_rules; p_rule; p_rule = p_rule->p_next )
+        i_count++;
+
+    webvtt_css_selection_t *p_selections = NULL;
+    if( i_count )
+        p_selections = vlc_alloc( i_count, sizeof(*p_selections) );
+    if( !p_selections )
+    {
+        *pi_count = 0;
+        return NULL;
+    }
+
+    webvtt_css_selection_t *p_sel = p_selections;
+    for( const vlc_css_rule_t *p_rule = p_rules; p_rule; p_rule = p_rule->p_next )
+    {
+        p_sel->b_timed = webvtt_css_selector_IsTimed( p_rule->p_selectors );
+        p_sel->b_selected = false;
+        vlc_array_init( &p_sel->nodes );
+        p_sel++;
+    }
+    *pi_count = i_count;
+    return p_selections;
+}
+
+static void webvtt_css_selections_Delete( webvtt_css_selection_t *p_selections,
+                                          size_t i_count )
+{
+    for( size_t i=0; i<i_count; i++ )
+        vlc_array_clear( &p_selections[i].nodes );
+    free( p_selections );
+}
+
 static void ApplyCSSRules( decoder_t *p_dec, const vlc_css_rule_t *p_rule,
-                           vlc_tick_t i_nzplaybacktime )
+                           vlc_tick_t i_nzplaybacktime,
+                           webvtt_css_selection_t *p_selections, size_t i_selections )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
 
-    for ( ;  p_rule ; p_rule = p_rule->p_next )
+    for ( size_t i_rule = 0;  p_rule ; p_rule = p_rule->p_next, i_rule++ )
     {
         vlc_array_t results;
+        vlc_array_t *p_results = &results;
         vlc_array_init( &results );
 
-        webvtt_domnode_SelectRuleNodes( (webvtt_dom_node_t *) p_sys->p_root,
-                                        p_rule, i_nzplaybacktime, &results );
+        webvtt_css_selection_t *p_cached = ( i_rule < i_selections )
+                                         ? &p_selections[i_rule] : NULL;
+        if( p_cached && !p_cached->b_timed )
+        {
+            p_results = &p_cached->nodes;
+            if( !p_cached->b_selected )
+            {
+                webvtt_domnode_SelectRuleNodes( (webvtt_dom_node_t *) p_sys->p_root,
+                                                p_rule, i_nzplaybacktime, p_results );
+                p_cached->b_selected = true;
+            }
+        }
+        else
+        {
+            webvtt_domnode_SelectRuleNodes( (webvtt_dom_node_t *) p_sys->p_root,
+                                            p_rule, i_nzplaybacktime, p_results );
+        }
 
         for( const vlc_css_declaration_t *p_decl = p_rule->p_declarations;
                                           p_decl; p_decl = p_decl->p_next )
         {
-            for( size_t i=0; i<vlc_array_count(&results); i++ )
+            for( size_t i=0; i<vlc_array_count(p_results); i++ )
             {
-                webvtt_dom_node_t *p_node = vlc_array_item_at_index( &results, i );
+                webvtt_dom_node_t *p_node = vlc_array_item_at_index( p_results, i );
                 if( !webvtt_domnode_supportsCSSStyle( p_node ) )
                     continue;
 
@@ -1745,16 +1821,21 @@ static void ApplyCSSRules( decoder_t *p_dec, const vlc_css_rule_t *p_rule,
         vlc_array_clear( &results );
     }
 }
+#else
+typedef void webvtt_css_selection_t;
 #endif
 
-static void RenderRegions( decoder_t *p_dec, vlc_tick_t i_nzstart, vlc_tick_t i_nzstop )
+static void RenderRegions( decoder_t *p_dec, vlc_tick_t i_nzstart, vlc_tick_t i_nzstop,
+                           webvtt_css_selection_t *p_selections, size_t i_selections )
 {
     subpicture_t *p_spu = NULL;
     substext_updater_region_t *p_updtregion = NULL;
     decoder_sys_t *p_sys = p_dec->p_sys;
 
 #ifdef HAVE_CSS
-    ApplyCSSRules( p_dec, p_sys->p_css_rules, i_nzstart );
+    ApplyCSSRules( p_dec, p_sys->p_css_rules, i_nzstart, p_selections, i_selections );
+#else
+    VLC_UNUSED(p_selections); VLC_UNUSED(i_selections);
 #endif
 
     const webvtt_dom_cue_t *p_rlcue = NULL;
@@ -1891,6 +1972,14 @@ static void Render( decoder_t *p_dec, vlc_tick_t i_nzstart, vlc_tick_t i_nzstop
     if( timedtags.i_count )
         qsort( timedtags.pp_elems, timedtags.i_count, sizeof(*timedtags.pp_elems), timedtagsArrayCmp );
 
+    webvtt_css_selection_t *p_selections = NULL;
+    size_t i_selections = 0;
+#ifdef HAVE_CSS
+    /* Timed tags split the rendering, but the tree stays the same */
+    if( timedtags.i_count )
+        p_selections = webvtt_css_selections_New( p_sys->p_css_rules, &i_selections );
+#endif
+
     vlc_tick_t i_subnzstart = i_nzstart;
     for( size_t i=0; i<timedtags.i_count; i++ )
     {
@@ -1900,7 +1989,8 @@ static void Render( decoder_t *p_dec, vlc_tick_t i_nzstart, vlc_tick_t i_nzstop
          {
              if( i > 0 )
                  ClearCSSStyles( (webvtt_dom_node_t *)p_sys->p_root );
-             RenderRegions( p_dec, i_subnzstart, p_tag->i_nzstart );
+             RenderRegions( p_dec, i_subnzstart, p_tag->i_nzstart,
+                            p_selections, i_selections );
              i_subnzstart = p_tag->i_nzstart;
          }
     }
@@ -1908,9 +1998,14 @@ static void Render( decoder_t *p_dec, vlc_tick_t i_nzstart, vlc_tick_t i_nzstop
     {
         if( i_subnzstart != i_nzstart )
             ClearCSSStyles( (webvtt_dom_node_t *)p_sys->p_root );
-        RenderRegions( p_dec, i_subnzstart, i_nzstop );
+        RenderRegions( p_dec, i_subnzstart, i_nzstop,
+                       p_selections, i_selections );
     }
 
+#ifdef HAVE_CSS
+    if( p_selections )
+        webvtt_css_selections_Delete( p_selections, i_selections );
+#endif
     vlc_array_clear( &timedtags );
 }
 
@@ -152,7 +152,9 @@ static int  Open (vlc_object_t *p_this)
     x265_param *param = &p_sys->param;
     x265_param_default(param);
 
-    param->frameNumThreads = vlc_GetCPUCount();
+    /* frame parallel encoding, as many as requested by transcode */
+    param->frameNumThreads = p_enc->i_threads > 0 ? p_enc->i_threads
+                                                  : vlc_GetCPUCount();
     param->bEnableWavefront = 0; // buggy in x265, use frame threading for now
     param->maxCUSize = 16; /* use smaller macroblock */
 
@@ -0,0 +1,212 @@
+/*****************************************************************************
+ * metrics.c: Prometheus metrics exporter
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#define VLC_MODULE_LICENSE VLC_LICENSE_GPL_2_PLUS
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_interface.h>
+#include <vlc_input_item.h>
+#include <vlc_player.h>
+#include <vlc_playlist.h>
+#include <vlc_httpd.h>
+#include <vlc_memstream.h>
+
+/* Prometheus text exposition format */
+#define METRICS_MIME "text/plain; version=0.0.4; charset=utf-8"
+
+struct intf_sys_t
+{
+    vlc_playlist_t *playlist;
+    httpd_host_t *host;
+    httpd_file_t *file;
+};
+
+static void PrintHeader(struct vlc_memstream *ms, const char *name,
+                        const char *type, const char *help)
+{
+    vlc_memstream_printf(ms, "# HELP %s %s\n# TYPE %s %s\n",
+                         name, help, name, type);
+}
+
+static void PrintMetric(struct vlc_memstream *ms, const char *name,
+                        const char *type, const char *help, int64_t value)
+{
+    PrintHeader(ms, name, type, help);
+    vlc_memstream_printf(ms, "%s %"PRId64"\n", name, value);
+}
+
+#define PrintCounter(ms, name, help, value) \
+    PrintMetric(ms, "vlc_" name "_total", "counter", help, value)
+#define PrintGauge(ms, name, help, value) \
+    PrintMetric(ms, "vlc_" name, "gauge", help, value)
+
+static void PrintStats(struct vlc_memstream *ms, const input_stats_t *st)
+{
+    /* The rates are in bytes per tick */
+    PrintCounter(ms, "input_read_bytes", "Bytes read by the access",
+                 st->i_read_bytes);
+    PrintCounter(ms, "input_read_packets", "Blocks read by the access",
+                 st->i_read_packets);
+    PrintGauge(ms, "input_bitrate_bytes", "Access bitrate, in bytes/s",
+               st->f_input_bitrate * CLOCK_FREQ);
+
+    PrintCounter(ms, "demux_read_bytes", "Bytes output by the demuxer",
+                 st->i_demux_read_bytes);
+    PrintCounter(ms, "demux_read_packets", "Blocks output by the demuxer",
+                 st->i_demux_read_packets);
+    PrintGauge(ms, "demux_bitrate_bytes", "Demuxer bitrate, in bytes/s",
+               st->f_demux_bitrate * CLOCK_FREQ);
+    PrintCounter(ms, "demux_corrupted", "Corrupted blocks",
+                 st->i_demux_corrupted);
+    PrintCounter(ms, "demux_discontinuities", "Discontinuities",
+                 st->i_demux_discontinuity);
+
+    PrintHeader(ms, "vlc_decoded_total", "counter", "Decoded blocks");
+    vlc_memstream_printf(ms, "vlc_decoded_total{type=\"audio\"} %"PRId64"\n"
+                             "vlc_decoded_total{type=\"video\"} %"PRId64"\n",
+                         st->i_decoded_audio, st->i_decoded_video);
+
+    /* The buckets are exclusive, the histogram ones are cumulative */
+    PrintHeader(ms, "vlc_decode_duration_seconds", "histogram",
+                "Time spent in each decode call");
+    int64_t count = 0;
+    for (size_t i = 0; i < INPUT_STATS_DECODE_TIME_BUCKETS - 1; i++)
+    {
+        count += st->pi_decode_time[i];
+        vlc_memstream_printf(ms, "vlc_decode_duration_seconds_bucket"
+                             "{le=\"%g\"} %"PRId64"\n",
+                             (double)(1 << i) / 1000., count);
+    }
+    count += st->pi_decode_time[INPUT_STATS_DECODE_TIME_BUCKETS - 1];
+    vlc_memstream_printf(ms, "vlc_decode_duration_seconds_bucket"
+                         "{le=\"+Inf\"} %"PRId64"\n"
+                         "vlc_decode_duration_seconds_count %"PRId64"\n",
+                         count, count);
+    PrintGauge(ms, "decoder_queue_max_frames",
+               "Deepest decoder input queue since the previous update",
+               st->i_decoder_queue_max);
+
+    PrintCounter(ms, "vout_displayed_pictures", "Displayed pictures",
+                 st->i_displayed_pictures);
+    PrintCounter(ms, "vout_late_pictures", "Pictures displayed late",
+                 st->i_late_pictures);
+    PrintCounter(ms, "vout_lost_pictures", "Dropped pictures",
+                 st->i_lost_pictures);
+    PrintCounter(ms, "aout_played_buffers", "Played audio buffers",
+                 st->i_played_abuffers);
+    PrintCounter(ms, "aout_lost_buffers", "Dropped audio buffers",
+                 st->i_lost_abuffers);
+}
+
+static int Fill(httpd_file_sys_t *opaque, httpd_file_t *file,
+                uint8_t *request, uint8_t **data, int *len)
+{
+    intf_sys_t *sys = (intf_sys_t *)opaque;
+    vlc_player_t *player = vlc_playlist_GetPlayer(sys->playlist);
+    struct vlc_memstream ms;
+    input_stats_t stats;
+    bool has_stats;
+    (void) file; (void) request;
+
+    /* Copy the statistics so as to hold the player lock briefly */
+    vlc_player_Lock(player);
+    enum vlc_player_state state = vlc_player_GetState(player);
+    const input_stats_t *st = vlc_player_GetStatistics(player);
+    has_stats = st != NULL;
+    if (has_stats)
+        stats = *st;
+    vlc_player_Unlock(player);
+
+    vlc_memstream_open(&ms);
+    PrintGauge(&ms, "player_playing", "Whether the player is playing",
+               state == VLC_PLAYER_STATE_PLAYING);
+    if (has_stats)
+        PrintStats(&ms, &stats);
+
+    if (vlc_memstream_close(&ms))
+    {
+        *data = NULL;
+        *len = 0;
+        return VLC_ENOMEM;
+    }
+
+    *data = (uint8_t *)ms.ptr;
+    *len = ms.length;
+    return VLC_SUCCESS;
+}
+
+static int Open(vlc_object_t *obj)
+{
+    intf_thread_t *intf = (intf_thread_t *)obj;
+    intf_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    sys->playlist = vlc_intf_GetMainPlaylist(intf);
+    sys->host = vlc_http_HostNew(obj);
+    if (sys->host == NULL)
+    {
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    char *url = var_InheritString(intf, "metrics-url");
+    sys->file = httpd_FileNew(sys->host, url != NULL ? url : "/metrics",
+                              METRICS_MIME, NULL, NULL, Fill,
+                              (httpd_file_sys_t *)sys);
+    free(url);
+    if (sys->file == NULL)
+    {
+        httpd_HostDelete(sys->host);
+        free(sys);
+        return VLC_EGENERIC;
+    }
+
+    intf->p_sys = sys;
+    return VLC_SUCCESS;
+}
+
+static void Close(vlc_object_t *obj)
+{
+    intf_thread_t *intf = (intf_thread_t *)obj;
+    intf_sys_t *sys = intf->p_sys;
+
+    httpd_FileDelete(sys->file);
+    httpd_HostDelete(sys->host);
+    free(sys);
+}
+
+#define URL_TEXT N_("Metrics URL")
+#define URL_LONGTEXT N_("Path of the metrics on the HTTP server. " \
+    "The server listens on the --http-host and --http-port addresses.")
+
+vlc_module_begin()
+    set_shortname(N_("Metrics"))
+    set_description(N_("Prometheus metrics exporter"))
+    set_subcategory(SUBCAT_INTERFACE_CONTROL)
+    set_capability("interface", 0)
+    set_callbacks(Open, Close)
+
+    add_string("metrics-url", "/metrics", URL_TEXT, URL_LONGTEXT)
+vlc_module_end()
@@ -36,6 +36,7 @@
 #include "logic/AlwaysLowestAdaptationLogic.hpp"
 #include "logic/PredictiveAdaptationLogic.hpp"
 #include "logic/NearOptimalAdaptationLogic.hpp"
+#include "logic/HybridAdaptationLogic.hpp"
 #include "logic/BufferingLogic.hpp"
 #include "tools/Debug.hpp"
 #ifdef ADAPTIVE_DEBUGGING_LOGIC
@@ -44,6 +45,7 @@
 #include <vlc_stream.h>
 #include <vlc_demux.h>
 #include <vlc_threads.h>
+#include <vlc_memaccount.h>
 
 #include <algorithm>
 #include <ctime>
@@ -74,6 +76,8 @@ PlaylistManager::PlaylistManager( demux_t *p_demux_,
     b_preparsing = false;
     nextPlaylistupdate = 0;
     demux.pcr_syncpoint = TimestampSynchronizationPoint::RandomAccess;
+    demux.latency = VLC_TICK_INVALID;
+    demux.latencycheck = VLC_TICK_INVALID;
     vlc_mutex_init(&demux.lock);
     vlc_cond_init(&demux.cond);
     vlc_mutex_init(&cached.lock);
@@ -440,6 +444,61 @@ vlc_tick_t PlaylistManager::getMinAheadTime() const
     return minbuffer;
 }
 
+void PlaylistManager::updateLiveLatency(const Times &times)
+{
+    if(times.segment.media == VLC_TICK_INVALID)
+        return;
+
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    const vlc_tick_t now = vlc_tick_from_timespec(&ts);
+
+    for(const AbstractStream *st : streams)
+    {
+        vlc_tick_t edge;
+        if(st->isValid() && !st->isDisabled() && st->isSelected() &&
+           st->getLiveEdgeTime(now, &edge))
+        {
+            vlc_mutex_locker locker(&demux.lock);
+            demux.latency = VLC_TICK_0 + edge - times.segment.media;
+            break;
+        }
+    }
+}
+
+void PlaylistManager::applyLatencyCorrection()
+{
+    vlc_mutex_lock(&demux.lock);
+    const vlc_tick_t latency = demux.latency;
+    vlc_mutex_unlock(&demux.lock);
+    if(latency == VLC_TICK_INVALID)
+        return;
+
+    /* Gently move the clock origin, which the outputs follow by
+     * resampling or dropping, as a bounded playback rate change */
+    const vlc_tick_t now = vlc_tick_now();
+    if(demux.latencycheck == VLC_TICK_INVALID)
+        demux.latencycheck = now;
+    const vlc_tick_t elapsed = now - demux.latencycheck;
+    if(elapsed < VLC_TICK_FROM_SEC(1))
+        return;
+    demux.latencycheck = now;
+
+    vlc_tick_t system, delay;
+    if(es_out_ControlGetPcrSystem(p_demux->out, &system, &delay) != VLC_SUCCESS)
+        return;
+
+    const vlc_tick_t shift = bufferingLogic->getLatencyCorrection(playlist,
+                                                                  latency + delay,
+                                                                  elapsed);
+    if(shift)
+    {
+        msg_Dbg(p_demux, "latency %" PRId64 "ms, shifting clock by %" PRId64 "ms",
+                MS_FROM_VLC_TICK(latency + delay), MS_FROM_VLC_TICK(shift));
+        es_out_ControlModifyPcrSystem(p_demux->out, true, system + shift);
+    }
+}
+
 bool PlaylistManager::reactivateStream(AbstractStream *stream)
 {
     return stream->reactivate(getResumePosition());
@@ -489,6 +548,7 @@ int PlaylistManager::doDemux(vlc_tick_t increment)
     vlc_mutex_unlock(&demux.lock);
 
     updateControlsPosition();
+    applyLatencyCorrection();
 
     switch(status)
     {
@@ -727,8 +787,18 @@ void PlaylistManager::Run()
         Times pcr = demux.times;
         vlc_mutex_unlock(&demux.lock);
 
-        AbstractStream::BufferingStatus i_return = bufferize(pcr, i_min_buffering,
-                                                             i_max_buffering, i_target_buffering);
+        /* Only keep the minimum buffering while the frames are over
+         * budget, so that the demuxed data does not grow further */
+        AbstractStream::BufferingStatus i_return;
+        if(vlc_memaccount_IsOverBudget(VLC_MEMACCOUNT_FRAME))
+            i_return = bufferize(pcr, i_min_buffering,
+                                 i_min_buffering, i_min_buffering);
+        else
+            i_return = bufferize(pcr, i_min_buffering,
+                                 i_max_buffering, i_target_buffering);
+
+        if(playlist->isLive() && playlist->targetLatency.Get())
+            updateLiveLatency(pcr);
 
         if(i_return != AbstractStream::BufferingStatus::Lessthanmin)
         {
@@ -896,6 +966,15 @@ AbstractAdaptationLogic *PlaylistManager::createLogic(AbstractAdaptationLogic::L
             logic = noplogic;
             break;
         }
+        case AbstractAdaptationLogic::LogicType::Hybrid:
+        {
+            HybridAdaptationLogic *hybridlogic =
+                    new (std::nothrow) HybridAdaptationLogic(obj);
+            if(hybridlogic)
+                conn->setDownloadRateObserver(hybridlogic);
+            logic = hybridlogic;
+            break;
+        }
         case AbstractAdaptationLogic::LogicType::Predictive:
         {
             AbstractAdaptationLogic *predictivelogic =
@@ -940,6 +1019,7 @@ AbstractBufferingLogic *PlaylistManager::createBufferingLogic() const
         v = var_InheritInteger(p_demux, "adaptive-maxbuffer");
         if(v)
             bl->setUserMaxBuffering(VLC_TICK_FROM_MS(v));
+        bl->setUserMaxPrefetch(var_InheritInteger(p_demux, "adaptive-prefetch"));
     }
     return bl;
 }
@@ -87,6 +87,8 @@ namespace adaptive
 
             Times getTimes(bool = false) const;
             vlc_tick_t getMinAheadTime() const;
+            void updateLiveLatency(const Times &);
+            void applyLatencyCorrection();
 
             virtual bool reactivateStream(AbstractStream *);
             bool setupPeriod();
@@ -121,6 +123,8 @@ namespace adaptive
             {
                 TimestampSynchronizationPoint pcr_syncpoint;
                 Times times, firsttimes;
+                vlc_tick_t  latency; /* from live edge, at demux output */
+                vlc_tick_t  latencycheck;
                 mutable vlc_mutex_t lock;
                 vlc_cond_t  cond;
             } demux;
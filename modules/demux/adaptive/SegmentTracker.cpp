@@ -28,6 +28,7 @@
 #include "playlist/BaseRepresentation.h"
 #include "playlist/BaseAdaptationSet.h"
 #include "playlist/Segment.h"
+#include "playlist/SegmentBaseType.hpp"
 #include "playlist/SegmentChunk.hpp"
 #include "logic/AbstractAdaptationLogic.h"
 #include "logic/BufferingLogic.hpp"
@@ -138,6 +139,7 @@ SegmentTracker::SegmentTracker(SharedResources *res,
     first = true;
     initializing = true;
     bufferingLogic = bl;
+    bufferingLevel = 0;
     setAdaptationLogic(logic_);
     adaptationSet = adaptSet;
     synchronizationReferences = refs;
@@ -155,6 +157,7 @@ SegmentTracker::Position::Position()
     rep = nullptr;
     init_sent = false;
     index_sent = false;
+    part = 0;
 }
 
 SegmentTracker::Position::Position(BaseRepresentation *rep, uint64_t number)
@@ -163,6 +166,7 @@ SegmentTracker::Position::Position(BaseRepresentation *rep, uint64_t number)
     this->number = number;
     init_sent = false;
     index_sent = false;
+    part = 0;
 }
 
 bool SegmentTracker::Position::isValid() const
@@ -176,10 +180,14 @@ std::string SegmentTracker::Position::toString() const
     std::stringstream ss;
     ss.imbue(std::locale("C"));
     if(isValid())
+    {
         ss << "seg# " << number
            << " " << init_sent
-           << ":" << index_sent
-           << " " << rep->getID().str();
+           << ":" << index_sent;
+        if(part)
+            ss << " part " << part;
+        ss << " " << rep->getID().str();
+    }
     else
         ss << "invalid";
     return ss.str();
@@ -190,7 +198,12 @@ SegmentTracker::Position & SegmentTracker::Position::operator ++()
     if(isValid())
     {
         if(index_sent)
-            ++number;
+        {
+            /* When reading by parts, next one is resolved from the
+               segment state at chunk preparation time */
+            if(!part)
+                ++number;
+        }
         else if(init_sent)
             index_sent = true;
         else
@@ -226,6 +239,7 @@ void SegmentTracker::reset()
     current = Position();
     next = Position();
     resetChunksSequence();
+    bufferingLevel = 0;
     initializing = true;
     format = StreamFormat::Type::Unknown;
 }
@@ -264,7 +278,18 @@ SegmentTracker::prepareChunk(bool switch_allowed, Position pos) const
     }
     else /* continuing, or seek */
     {
-        if(!adaptationSet->isSegmentAligned() || !pos.init_sent || !pos.index_sent)
+        /* Done with the parts of a segment that is now complete */
+        if(pos.part)
+        {
+            const Segment *parted = pos.rep->getMediaSegment(pos.number);
+            if(!parted || (!parted->isIncomplete() && pos.part >= parted->getParts().size()))
+            {
+                ++pos.number;
+                pos.part = 0;
+            }
+        }
+
+        if(!adaptationSet->isSegmentAligned() || !pos.init_sent || !pos.index_sent || pos.part)
             switch_allowed = false;
 
         if(switch_allowed)
@@ -294,11 +319,15 @@ SegmentTracker::prepareChunk(bool switch_allowed, Position pos) const
     }
 
     bool b_gap = true;
-    ISegment *datasegment = pos.rep->getNextMediaSegment(pos.number, &pos.number, &b_gap);
+    const uint64_t wanted = pos.number;
+    Segment *datasegment = pos.rep->getNextMediaSegment(pos.number, &pos.number, &b_gap);
 
     if(!datasegment)
         return ChunkEntry();
 
+    if(pos.number != wanted)
+        pos.part = 0;
+
     ISegment *segment = nullptr;
     if(!pos.init_sent)
     {
@@ -315,9 +344,25 @@ SegmentTracker::prepareChunk(bool switch_allowed, Position pos) const
             ++pos;
     }
 
+    Segment *part = nullptr;
+    stime_t partoffset = 0;
     if(!segment)
+    {
         segment = datasegment;
 
+        /* Segment still being produced, or which reading started by parts */
+        if(datasegment->isIncomplete() || pos.part)
+        {
+            const std::vector<Segment *> &parts = datasegment->getParts();
+            if(pos.part >= parts.size())
+                return ChunkEntry(); /* wait for the next ones */
+            for(size_t i = 0; i < pos.part; i++)
+                partoffset += parts[i]->duration.Get();
+            part = parts[pos.part++];
+            segment = part;
+        }
+    }
+
     SegmentChunk *segmentChunk = segment->toChunk(resources, pos.number, pos.rep);
     if(!segmentChunk)
         return ChunkEntry();
@@ -332,6 +377,16 @@ SegmentTracker::prepareChunk(bool switch_allowed, Position pos) const
     if(pos.rep->getPlaybackTimeDurationBySegmentNumber(pos.number, &startTime, &duration))
         startTime += VLC_TICK_0;
 
+    if(part)
+    {
+        const Timescale timescale = pos.rep->inheritSegmentProfile()->inheritTimescale();
+        if(startTime != VLC_TICK_INVALID)
+            startTime += timescale.ToTime(partoffset);
+        if(displayTime != VLC_TICK_INVALID)
+            displayTime += timescale.ToTime(partoffset);
+        duration = timescale.ToTime(part->duration.Get());
+    }
+
     return ChunkEntry(segmentChunk, pos, startTime, duration, displayTime);
 }
 
@@ -344,6 +399,45 @@ void SegmentTracker::resetChunksSequence()
     }
 }
 
+void SegmentTracker::prefetchChunks(bool switch_allowed, vlc_tick_t ahead)
+{
+    const BasePlaylist *playlist = adaptationSet->getPlaylist();
+    const unsigned max = bufferingLogic->getMaxPrefetch(playlist);
+    if(!max)
+        return;
+
+    /* Only request what would fit in the buffer: already demuxed,
+     * currently read and already queued chunks */
+    const vlc_tick_t maxbuffering = bufferingLogic->getMaxBuffering(playlist);
+    ahead += bufferingLevel;
+    for(const ChunkEntry &entry : chunkssequence)
+        if(entry.pos.init_sent && entry.pos.index_sent)
+            ahead += entry.duration;
+
+    Position pos = next;
+    if(!chunkssequence.empty())
+    {
+        pos = chunkssequence.back().pos;
+        ++pos;
+    }
+
+    while(chunkssequence.size() < max && ahead < maxbuffering)
+    {
+        ChunkEntry entry = prepareChunk(switch_allowed, pos);
+        if(!entry.isValid())
+        {
+            delete entry.chunk;
+            break;
+        }
+        chunkssequence.push_back(entry);
+        /* Init and index have the segment timings */
+        if(entry.pos.init_sent && entry.pos.index_sent)
+            ahead += entry.duration;
+        pos = entry.pos;
+        ++pos;
+    }
+}
+
 ChunkInterface * SegmentTracker::getNextChunk(bool switch_allowed)
 {
     if(!adaptationSet || !next.isValid())
@@ -363,8 +457,10 @@ ChunkInterface * SegmentTracker::getNextChunk(bool switch_allowed)
         return nullptr;
     }
 
-    /* here next == wanted chunk pos */
+    /* here next == wanted chunk pos, or the one following a segment read by parts */
     bool b_gap = (next.number != chunk.pos.number);
+    if(b_gap && next.part && chunk.pos.number == next.number + 1)
+        b_gap = false;
     const bool b_switched = (current.rep != chunk.pos.rep) || !current.rep;
     bool b_discontinuity = chunk.chunk->discontinuity && current.isValid();
     if(b_discontinuity && current.number == next.number)
@@ -436,7 +532,12 @@ ChunkInterface * SegmentTracker::getNextChunk(bool switch_allowed)
                                chunk.starttime, chunk.duration, chunk.displaytime));
 
     if(!b_gap)
+    {
         ++next;
+        /* Start downloading the next ones */
+        prefetchChunks(switch_allowed, chunk.pos.init_sent && chunk.pos.index_sent
+                                       ? chunk.duration : 0);
+    }
 
     return returnedChunk;
 }
@@ -480,6 +581,7 @@ void SegmentTracker::setPosition(const Position &pos, bool restarted)
     current = Position();
     next = pos;
     resetChunksSequence();
+    bufferingLevel = 0;
     notify(PositionChangedEvent(getPlaybackTime(true)));
 }
 
@@ -536,6 +638,13 @@ bool SegmentTracker::getMediaPlaybackRange(vlc_tick_t *start, vlc_tick_t *end,
     return current.rep->getMediaPlaybackRange(start, end, length);
 }
 
+bool SegmentTracker::getLiveEdgeTime(vlc_tick_t now, vlc_tick_t *edge) const
+{
+    if(!current.rep)
+        return false;
+    return current.rep->getLiveEdgeTime(now, edge);
+}
+
 vlc_tick_t SegmentTracker::getMinAheadTime() const
 {
     BaseRepresentation *rep = current.rep;
@@ -555,7 +664,19 @@ vlc_tick_t SegmentTracker::getMinAheadTime() const
         if(startnumber == std::numeric_limits<uint64_t>::max())
             startnumber = bufferingLogic->getStartSegmentNumber(rep);
         if(startnumber != std::numeric_limits<uint64_t>::max())
-            return rep->getMinAheadTime(startnumber);
+        {
+            vlc_tick_t ahead = rep->getMinAheadTime(startnumber);
+            /* also count the published parts not read yet */
+            const Segment *parted = current.part ? rep->getMediaSegment(startnumber) : nullptr;
+            if(parted)
+            {
+                const Timescale timescale = rep->inheritSegmentProfile()->inheritTimescale();
+                const std::vector<Segment *> &parts = parted->getParts();
+                for(size_t i = current.part; i < parts.size(); i++)
+                    ahead += timescale.ToTime(parts[i]->duration.Get());
+            }
+            return ahead;
+        }
     }
     return 0;
 }
@@ -579,8 +700,9 @@ void SegmentTracker::notifyBufferingState(bool enabled) const
 }
 
 void SegmentTracker::notifyBufferingLevel(vlc_tick_t min, vlc_tick_t max,
-                                          vlc_tick_t current, vlc_tick_t target) const
+                                          vlc_tick_t current, vlc_tick_t target)
 {
+    bufferingLevel = current;
     notify(BufferingLevelChangedEvent(adaptationSet->getID(), min, max, current, target));
 }
 
@@ -217,6 +217,7 @@ namespace adaptive
                     BaseRepresentation *rep;
                     bool init_sent;
                     bool index_sent;
+                    size_t part; /* parts already read from the segment */
             };
 
             void getCodecsDesc(CodecDescriptionList *) const;
@@ -229,11 +230,12 @@ namespace adaptive
             Position getStartPosition() const;
             vlc_tick_t getPlaybackTime(bool = false) const; /* Current segment start time if selected */
             bool getMediaPlaybackRange(vlc_tick_t *, vlc_tick_t *, vlc_tick_t *) const;
+            bool getLiveEdgeTime(vlc_tick_t, vlc_tick_t *) const;
             vlc_tick_t getMinAheadTime() const;
             bool getSynchronizationReference(uint64_t, vlc_tick_t, SynchronizationReference &) const;
             void updateSynchronizationReference(uint64_t, const Times &);
             void notifyBufferingState(bool) const;
-            void notifyBufferingLevel(vlc_tick_t, vlc_tick_t, vlc_tick_t, vlc_tick_t) const;
+            void notifyBufferingLevel(vlc_tick_t, vlc_tick_t, vlc_tick_t, vlc_tick_t);
             void registerListener(SegmentTrackerListenerInterface *);
             bool updateSelected();
             bool bufferingAvailable() const;
@@ -253,11 +255,13 @@ namespace adaptive
             };
             std::list<ChunkEntry> chunkssequence;
             ChunkEntry prepareChunk(bool switch_allowed, Position pos) const;
+            void prefetchChunks(bool switch_allowed, vlc_tick_t);
             void resetChunksSequence();
             void setAdaptationLogic(AbstractAdaptationLogic *);
             void notify(const TrackerEvent &) const;
             bool first;
             bool initializing;
+            vlc_tick_t bufferingLevel; /* last demuxed amount */
             Position current;
             Position next;
             StreamFormat format;
@@ -39,8 +39,9 @@ SharedResources::SharedResources(AuthStorage *auth, Keyring *ring,
 
 SharedResources::~SharedResources()
 {
-    delete connManager;
+    /* The keyring retrieves keys through the connection manager */
     delete encryptionKeyring;
+    delete connManager;
     delete authStorage;
 }
 
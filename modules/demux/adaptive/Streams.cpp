@@ -716,6 +716,11 @@ bool AbstractStream::getMediaPlaybackTimes(vlc_tick_t *start, vlc_tick_t *end,
     return segmentTracker->getMediaPlaybackRange(start, end, length);
 }
 
+bool AbstractStream::getLiveEdgeTime(vlc_tick_t now, vlc_tick_t *edge) const
+{
+    return segmentTracker->getLiveEdgeTime(now, edge);
+}
+
 bool AbstractStream::getMediaAdvanceAmount(vlc_tick_t *duration) const
 {
     if(startTimeContext.media == VLC_TICK_INVALID)
@@ -100,6 +100,7 @@ namespace adaptive
         virtual bool reactivate(const StreamPosition &);
         virtual bool setPosition(const StreamPosition &, bool);
         bool getMediaPlaybackTimes(vlc_tick_t *, vlc_tick_t *, vlc_tick_t *) const;
+        bool getLiveEdgeTime(vlc_tick_t, vlc_tick_t *) const;
         bool getMediaAdvanceAmount(vlc_tick_t *) const;
         bool runUpdates(bool = false);
 
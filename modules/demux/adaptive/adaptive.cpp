@@ -84,10 +84,23 @@ static void Close   (vlc_object_t *);
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
+#define ADAPT_DOWNLOADS_TEXT N_("Concurrent downloads")
+#define ADAPT_DOWNLOADS_LONGTEXT N_("Maximum number of segments downloaded at the same time")
+
+#define ADAPT_PREFETCH_TEXT N_("Prefetched segments")
+#define ADAPT_PREFETCH_LONGTEXT N_("Number of segments requested ahead for each stream, " \
+    "within the maximum buffering")
+
+#define ADAPT_CACHE_TEXT N_("Shared segment cache size (KiB)")
+#define ADAPT_CACHE_LONGTEXT N_("Segments are kept in a cache shared by all the " \
+    "playbacks of the same instance, and are only downloaded once when " \
+    "requested concurrently. 0 disables the shared cache.")
+
 static const AbstractAdaptationLogic::LogicType pi_logics[] = {
                                 AbstractAdaptationLogic::LogicType::Default,
                                 AbstractAdaptationLogic::LogicType::Predictive,
                                 AbstractAdaptationLogic::LogicType::NearOptimal,
+                                AbstractAdaptationLogic::LogicType::Hybrid,
                                 AbstractAdaptationLogic::LogicType::RateBased,
                                 AbstractAdaptationLogic::LogicType::FixedRate,
                                 AbstractAdaptationLogic::LogicType::AlwaysLowest,
@@ -97,6 +110,7 @@ static const char *const ppsz_logics_values[] = {
                                 "",
                                 "predictive",
                                 "nearoptimal",
+                                "hybrid",
                                 "rate",
                                 "fixedrate",
                                 "lowest",
@@ -105,6 +119,7 @@ static const char *const ppsz_logics_values[] = {
 static const char *const ppsz_logics[] = { N_("Default"),
                                            N_("Predictive"),
                                            N_("Near Optimal"),
+                                           N_("Hybrid Throughput and Buffer"),
                                            N_("Bandwidth Adaptive"),
                                            N_("Fixed Bandwidth"),
                                            N_("Lowest Bandwidth/Quality"),
@@ -143,6 +158,12 @@ vlc_module_begin ()
                      ADAPT_MAXBUFFER_TEXT, nullptr );
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT );
             change_integer_list(rgi_latency, ppsz_latency)
+        add_integer( "adaptive-downloads", 1, ADAPT_DOWNLOADS_TEXT, ADAPT_DOWNLOADS_LONGTEXT )
+            change_integer_range( 1, 8 )
+        add_integer( "adaptive-prefetch", 0, ADAPT_PREFETCH_TEXT, ADAPT_PREFETCH_LONGTEXT )
+            change_integer_range( 0, 16 )
+        add_integer( "adaptive-cache-size", 0, ADAPT_CACHE_TEXT, ADAPT_CACHE_LONGTEXT )
+            change_integer_range( 0, 1 << 22 )
         set_callbacks( Open, Close )
 vlc_module_end ()
 
@@ -282,14 +303,19 @@ static PlaylistManager * HandleDash(demux_t *p_demux, DOMParser &xmlParser,
                                     const std::string & playlisturl,
                                     AbstractAdaptationLogic::LogicType logic)
 {
+    SegmentTimelineHandler timelineHandler;
+    xmlParser.setSubNodesHandler("SegmentTimeline", &timelineHandler);
     if(!xmlParser.reset(p_demux->s) || !xmlParser.parse(true))
     {
+        xmlParser.setSubNodesHandler("SegmentTimeline", nullptr);
         msg_Err(p_demux, "Cannot parse MPD");
         return nullptr;
     }
     IsoffMainParser mpdparser(xmlParser.getRootNode(), VLC_OBJECT(p_demux),
                               p_demux->s, playlisturl);
+    mpdparser.setSegmentTimelineHandler(&timelineHandler);
     MPD *p_playlist = mpdparser.parse();
+    xmlParser.setSubNodesHandler("SegmentTimeline", nullptr);
     if(p_playlist == nullptr)
     {
         msg_Err( p_demux, "Cannot create/unknown MPD for profile");
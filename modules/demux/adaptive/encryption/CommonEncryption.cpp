@@ -27,6 +27,9 @@
 #include "../SharedResources.hpp"
 
 #include <vlc_common.h>
+#include <vlc_block.h>
+
+#include <algorithm>
 
 #ifdef HAVE_GCRYPT
  #include <gcrypt.h>
@@ -54,7 +57,9 @@ void CommonEncryption::mergeWith(const CommonEncryption &other)
 
 CommonEncryptionSession::CommonEncryptionSession()
 {
+    resources = nullptr;
     ctx = nullptr;
+    failed = false;
 }
 
 
@@ -68,80 +73,111 @@ bool CommonEncryptionSession::start(SharedResources *res, const CommonEncryption
     if(ctx)
         close();
     encryption = enc;
+    resources = res;
+    residue.clear();
+    failed = false;
 #ifndef HAVE_GCRYPT
     /* We don't use the SharedResources */
     VLC_UNUSED(res);
 #else
     if(encryption.method == CommonEncryption::Method::AES_128)
     {
-        if(key.empty())
-        {
-            if(!encryption.uri.empty())
-                key = res->getKeyring()->getKey(res, encryption.uri);
-            if(key.size() != 16)
-                return false;
-        }
-
-        vlc_gcrypt_init();
-        gcry_cipher_hd_t handle;
-        if( gcry_cipher_open(&handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_CBC, 0) ||
-                gcry_cipher_setkey(handle, &key[0], 16) ||
-                gcry_cipher_setiv(handle, &encryption.iv[0], 16) )
-        {
-            gcry_cipher_close(handle);
-            ctx = nullptr;
+        if(encryption.uri.empty() || encryption.iv.size() != 16)
             return false;
-        }
-        ctx = handle;
+        /* Retrieved in the background until the first data is decrypted */
+        res->getKeyring()->prefetchKey(res, encryption.uri);
     }
 #endif
     return true;
 }
 
-void CommonEncryptionSession::close()
+bool CommonEncryptionSession::open()
 {
 #ifdef HAVE_GCRYPT
-    gcry_cipher_hd_t handle = reinterpret_cast<gcry_cipher_hd_t>(ctx);
+    if(!ctx && !failed)
+    {
+        ctx = resources->getKeyring()->getCipher(resources, encryption.uri);
+        gcry_cipher_hd_t handle = reinterpret_cast<gcry_cipher_hd_t>(ctx);
+        if(handle && gcry_cipher_setiv(handle, &encryption.iv[0], 16))
+            close();
+        failed = !ctx;
+    }
+#endif
+    return ctx != nullptr;
+}
+
+void CommonEncryptionSession::close()
+{
     if(ctx)
-        gcry_cipher_close(handle);
+        resources->getKeyring()->releaseCipher(encryption.uri, ctx);
     ctx = nullptr;
-#endif
+    residue.clear();
 }
 
-size_t CommonEncryptionSession::decrypt(void *inputdata, size_t inputbytes, bool last)
+block_t * CommonEncryptionSession::decrypt(block_t *p_block, bool last)
 {
 #ifndef HAVE_GCRYPT
-    VLC_UNUSED(inputdata);
     VLC_UNUSED(last);
 #else
-    gcry_cipher_hd_t handle = reinterpret_cast<gcry_cipher_hd_t>(ctx);
-    if(encryption.method == CommonEncryption::Method::AES_128 && ctx)
+    if(encryption.method == CommonEncryption::Method::AES_128 && open())
     {
-        if ((inputbytes % 16) != 0 || inputbytes < 16 ||
-            gcry_cipher_decrypt(handle, inputdata, inputbytes, nullptr, 0))
+        gcry_cipher_hd_t handle = reinterpret_cast<gcry_cipher_hd_t>(ctx);
+
+        /* Data is decrypted as it is received, by whole cipher blocks */
+        if(!residue.empty())
+        {
+            const size_t offset = residue.size();
+            p_block = block_Realloc(p_block, offset, p_block->i_buffer);
+            if(!p_block)
+            {
+                residue.clear();
+                return nullptr;
+            }
+            memcpy(p_block->p_buffer, &residue[0], offset);
+            residue.clear();
+        }
+
+        /* The last block is held back until we know if it has the padding */
+        size_t size = p_block->i_buffer;
+        if(!last)
+        {
+            size_t keep = size % 16;
+            if(keep == 0)
+                keep = std::min<size_t>(size, 16);
+            size -= keep;
+            residue.assign(&p_block->p_buffer[size], &p_block->p_buffer[size + keep]);
+        }
+
+        if(size == 0)
+        {
+            /* everything held back */
+        }
+        else if ((size % 16) != 0 ||
+            gcry_cipher_decrypt(handle, p_block->p_buffer, size, nullptr, 0))
         {
-            inputbytes = 0;
+            size = 0;
         }
         else if(last)
         {
             /* last bytes */
             /* remove the PKCS#7 padding from the buffer */
-            const uint8_t pad = reinterpret_cast<uint8_t *>(inputdata)[inputbytes - 1];
+            const uint8_t pad = p_block->p_buffer[size - 1];
             for(uint8_t i=0; i<pad && i<16; i++)
             {
-                if(reinterpret_cast<uint8_t *>(inputdata)[inputbytes - i - 1] != pad)
+                if(p_block->p_buffer[size - i - 1] != pad)
                     break;
                 if(i+1==pad)
-                    inputbytes -= pad;
+                    size -= pad;
             }
         }
+        p_block->i_buffer = size;
     }
     else
 #endif
     if(encryption.method != CommonEncryption::Method::None)
     {
-        inputbytes = 0;
+        p_block->i_buffer = 0;
     }
 
-    return inputbytes;
+    return p_block;
 }
@@ -20,6 +20,8 @@
 #ifndef COMMONENCRYPTION_H
 #define COMMONENCRYPTION_H
 
+#include <vlc_common.h>
+
 #include <vector>
 #include <string>
 
@@ -52,12 +54,16 @@ namespace adaptive
 
                 bool start(SharedResources *, const CommonEncryption &);
                 void close();
-                size_t decrypt(void *, size_t, bool);
+                block_t * decrypt(block_t *, bool);
 
             private:
-                std::vector<unsigned char> key;
+                bool open();
+                SharedResources *resources;
                 CommonEncryption encryption;
+                /* incomplete cipher block, or the held back last one */
+                std::vector<unsigned char> residue;
                 void *ctx;
+                bool failed;
         };
     }
 }
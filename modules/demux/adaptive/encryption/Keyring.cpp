@@ -28,6 +28,11 @@
 
 #include <vlc_block.h>
 
+#ifdef HAVE_GCRYPT
+ #include <gcrypt.h>
+ #include <vlc_gcrypt.h>
+#endif
+
 #include <algorithm>
 
 using namespace adaptive::encryption;
@@ -35,11 +40,55 @@ using namespace adaptive::encryption;
 Keyring::Keyring(vlc_object_t *obj_)
 {
     obj = obj_;
+    prefetchResources = nullptr;
+    b_thread = false;
+    b_killed = false;
     vlc_mutex_init(&lock);
+    vlc_cond_init(&cond);
 }
 
 Keyring::~Keyring()
 {
+    vlc_mutex_lock(&lock);
+    b_killed = true;
+    vlc_cond_broadcast(&cond);
+    vlc_mutex_unlock(&lock);
+
+    if(b_thread)
+        vlc_join(thread, nullptr);
+
+    while(!ciphers.empty())
+        closeCiphers(std::string((*ciphers.begin()).first));
+}
+
+/* Called with the lock held, which is released during the retrieval */
+void Keyring::fetchKey(SharedResources *resources, const std::string &uri)
+{
+    fetching.push_back(uri);
+    vlc_mutex_unlock(&lock);
+
+    msg_Dbg(obj, "Retrieving AES key %s", uri.c_str());
+    block_t *p_block = Retrieve::HTTP(resources, http::ChunkType::Key, uri);
+
+    vlc_mutex_lock(&lock);
+    fetching.erase(std::find(fetching.begin(), fetching.end(), uri));
+    if(p_block)
+    {
+        if(p_block->i_buffer == 16 && keys.find(uri) == keys.end())
+        {
+            KeyringKey key(p_block->p_buffer, p_block->p_buffer + 16);
+            keys.insert(std::pair<std::string, KeyringKey>(uri, key));
+            lru.push_front(uri);
+            if(lru.size() > Keyring::MAX_KEYS)
+            {
+                closeCiphers(lru.back());
+                keys.erase(keys.find(lru.back()));
+                lru.pop_back();
+            }
+        }
+        block_Release(p_block);
+    }
+    vlc_cond_broadcast(&cond);
 }
 
 KeyringKey Keyring::getKey(SharedResources *resources, const std::string &uri)
@@ -47,28 +96,19 @@ KeyringKey Keyring::getKey(SharedResources *resources, const std::string &uri)
     KeyringKey key;
 
     vlc_mutex_locker locker(&lock);
+
+    /* Wait for a prefetch instead of retrieving the key twice */
+    while(std::find(fetching.begin(), fetching.end(), uri) != fetching.end())
+        vlc_cond_wait(&cond, &lock);
+
     std::map<std::string, KeyringKey>::iterator it = keys.find(uri);
     if(it == keys.end())
     {
-        /* Pretty bad inside the lock */
-        msg_Dbg(obj, "Retrieving AES key %s", uri.c_str());
-        block_t *p_block = Retrieve::HTTP(resources, http::ChunkType::Key, uri);
-        if(p_block)
-        {
-            if(p_block->i_buffer == 16)
-            {
-                key.resize(16);
-                memcpy(&key[0], p_block->p_buffer, 16);
-                keys.insert(std::pair<std::string, KeyringKey>(uri, key));
-                lru.push_front(uri);
-                if(lru.size() > Keyring::MAX_KEYS)
-                {
-                    keys.erase(keys.find(lru.back()));
-                    lru.pop_back();
-                }
-            }
-            block_Release(p_block);
-        }
+        pending.remove(uri);
+        fetchKey(resources, uri);
+        it = keys.find(uri);
+        if(it == keys.end())
+            return key;
     }
     else
     {
@@ -78,8 +118,127 @@ KeyringKey Keyring::getKey(SharedResources *resources, const std::string &uri)
             lru.erase(it2);
             lru.push_front(uri);
         }
-        key = (*it).second;
     }
+    key = (*it).second;
 
     return key;
 }
+
+void Keyring::prefetchKey(SharedResources *resources, const std::string &uri)
+{
+    vlc_mutex_locker locker(&lock);
+
+    if(keys.find(uri) != keys.end() ||
+       std::find(pending.begin(), pending.end(), uri) != pending.end() ||
+       std::find(fetching.begin(), fetching.end(), uri) != fetching.end())
+        return;
+
+    if(!b_thread)
+    {
+        /* Otherwise the key is retrieved on use */
+        if(vlc_clone(&thread, prefetchThread, static_cast<void *>(this)))
+            return;
+        b_thread = true;
+    }
+
+    prefetchResources = resources;
+    pending.push_back(uri);
+    vlc_cond_broadcast(&cond);
+}
+
+void * Keyring::prefetchThread(void *opaque)
+{
+    vlc_thread_set_name("vlc-adapt-key");
+    static_cast<Keyring *>(opaque)->prefetchRun();
+    return nullptr;
+}
+
+void Keyring::prefetchRun()
+{
+    vlc_mutex_lock(&lock);
+    for(;;)
+    {
+        while(pending.empty() && !b_killed)
+            vlc_cond_wait(&cond, &lock);
+        if(b_killed)
+            break;
+
+        std::string uri = pending.front();
+        pending.pop_front();
+        if(keys.find(uri) == keys.end() &&
+           std::find(fetching.begin(), fetching.end(), uri) == fetching.end())
+            fetchKey(prefetchResources, uri);
+    }
+    vlc_mutex_unlock(&lock);
+}
+
+void * Keyring::getCipher(SharedResources *resources, const std::string &uri)
+{
+#ifdef HAVE_GCRYPT
+    {
+        vlc_mutex_locker locker(&lock);
+        std::multimap<std::string, void *>::iterator it = ciphers.find(uri);
+        if(it != ciphers.end())
+        {
+            void *ctx = (*it).second;
+            ciphers.erase(it);
+            return ctx;
+        }
+    }
+
+    KeyringKey key = getKey(resources, uri);
+    if(key.size() != 16)
+        return nullptr;
+
+    vlc_gcrypt_init();
+    gcry_cipher_hd_t handle;
+    if(gcry_cipher_open(&handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_CBC, 0))
+        return nullptr;
+    if(gcry_cipher_setkey(handle, &key[0], 16))
+    {
+        gcry_cipher_close(handle);
+        return nullptr;
+    }
+    return handle;
+#else
+    VLC_UNUSED(resources);
+    VLC_UNUSED(uri);
+    return nullptr;
+#endif
+}
+
+void Keyring::releaseCipher(const std::string &uri, void *ctx)
+{
+#ifdef HAVE_GCRYPT
+    gcry_cipher_hd_t handle = reinterpret_cast<gcry_cipher_hd_t>(ctx);
+
+    vlc_mutex_locker locker(&lock);
+    /* Evicted keys don't keep their contexts */
+    if(keys.find(uri) != keys.end() &&
+       ciphers.count(uri) < (size_t) Keyring::MAX_IDLE_CIPHERS)
+    {
+        gcry_cipher_reset(handle);
+        ciphers.insert(std::pair<std::string, void *>(uri, ctx));
+        return;
+    }
+    gcry_cipher_close(handle);
+#else
+    VLC_UNUSED(uri);
+    VLC_UNUSED(ctx);
+#endif
+}
+
+void Keyring::closeCiphers(const std::string &uri)
+{
+#ifdef HAVE_GCRYPT
+    std::pair<std::multimap<std::string, void *>::iterator,
+              std::multimap<std::string, void *>::iterator> range =
+            ciphers.equal_range(uri);
+    for(std::multimap<std::string, void *>::iterator it = range.first;
+        it != range.second; ++it)
+        gcry_cipher_close(reinterpret_cast<gcry_cipher_hd_t>((*it).second));
+    ciphers.erase(range.first, range.second);
+#else
+    VLC_UNUSED(uri);
+#endif
+}
@@ -41,13 +41,30 @@ namespace adaptive
                 Keyring(vlc_object_t *);
                 ~Keyring();
                 KeyringKey getKey(SharedResources *, const std::string &);
+                void prefetchKey(SharedResources *, const std::string &);
+                /* AES-128-CBC cipher contexts with the key set */
+                void *getCipher(SharedResources *, const std::string &);
+                void releaseCipher(const std::string &, void *);
 
             private:
                 static const int MAX_KEYS = 50;
+                static const int MAX_IDLE_CIPHERS = 4;
+                static void * prefetchThread(void *);
+                void prefetchRun();
+                void fetchKey(SharedResources *, const std::string &);
+                void closeCiphers(const std::string &);
                 std::map<std::string, KeyringKey> keys;
                 std::list<std::string> lru;
+                std::list<std::string> pending;
+                std::list<std::string> fetching;
+                std::multimap<std::string, void *> ciphers;
                 vlc_object_t *obj;
                 vlc_mutex_t lock;
+                vlc_cond_t cond;
+                SharedResources *prefetchResources;
+                vlc_thread_t thread;
+                bool b_thread;
+                bool b_killed;
         };
     }
 }
@@ -29,6 +29,7 @@
 #include "HTTPConnection.hpp"
 #include "HTTPConnectionManager.h"
 #include "Downloader.hpp"
+#include "SegmentCache.hpp"
 
 #include <vlc_common.h>
 #include <vlc_block.h>
@@ -124,7 +125,8 @@ block_t * AbstractChunk::doRead(size_t size, bool b_block)
             block->i_flags |= BLOCK_FLAG_HEADER;
         bytesRead += block->i_buffer;
         onDownload(&block);
-        block->i_flags &= ~BLOCK_FLAG_HEADER;
+        if(block)
+            block->i_flags &= ~BLOCK_FLAG_HEADER;
     }
 
     return block;
@@ -343,6 +345,8 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     held = false;
     p_read = nullptr;
     inblockreadoffset = 0;
+    downloadTime = 0;
+    sharedCache = nullptr;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -355,6 +359,9 @@ HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
     while(held) /* wait release if not in queue but currently downloaded */
         avail.wait(lock);
 
+    if(sharedEntry)
+        unshare(false);
+
     if(p_head)
     {
         block_ChainRelease(p_head);
@@ -384,18 +391,48 @@ void HTTPChunkBufferedSource::release()
     avail.signal();
 }
 
-void HTTPChunkBufferedSource::bufferize(size_t readsize)
+void HTTPChunkBufferedSource::share(SegmentCache *cache,
+                                    const std::shared_ptr<SegmentCacheEntry> &entry)
+{
+    sharedCache = cache;
+    sharedEntry = entry;
+}
+
+void HTTPChunkBufferedSource::unshare(bool b_complete)
+{
+    SegmentCacheEntry::State state;
+    if(!b_complete)
+        state = SegmentCacheEntry::State::Aborted;
+    else if(requeststatus != RequestStatus::Success ||
+            (contentLength && buffered != contentLength))
+        state = SegmentCacheEntry::State::Failed;
+    else if(!prepared) /* no connection, let others retry */
+        state = SegmentCacheEntry::State::Aborted;
+    else
+        state = SegmentCacheEntry::State::Done;
+    sharedCache->finish(sharedEntry, state, requeststatus);
+    sharedEntry.reset();
+    sharedCache = nullptr;
+}
+
+void HTTPChunkBufferedSource::bufferize(size_t readsize, unsigned concurrency)
 {
+    const vlc_tick_t stepStartTime = vlc_tick_now();
     {
         mutex_locker locker {lock};
         if(!prepare())
         {
             done = true;
             eof = true;
+            if(sharedEntry)
+                unshare(true);
             avail.signal();
             return;
         }
 
+        if(sharedEntry && buffered == 0)
+            sharedEntry->setContentType(connection->getContentType());
+
         if(readsize < HTTPChunkSource::CHUNK_SIZE)
             readsize = HTTPChunkSource::CHUNK_SIZE;
 
@@ -418,6 +455,7 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
     } rate = {0,0,0};
 
     ssize_t ret = connection->read(p_block->p_buffer, readsize);
+    const vlc_tick_t stepEndTime = vlc_tick_now();
     if(ret <= 0)
     {
         block_Release(p_block);
@@ -425,14 +463,26 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         mutex_locker locker {lock};
         done = true;
         downloadEndTime = vlc_tick_now();
+        downloadTime += (downloadEndTime - stepStartTime) / concurrency;
         rate.size = buffered;
-        rate.time = downloadEndTime - requestStartTime;
+        rate.time = downloadTime;
         rate.latency = responseTime - requestStartTime;
+        if(sharedEntry)
+            unshare(ret == 0);
     }
     else
     {
         p_block->i_buffer = (size_t) ret;
         mutex_locker locker {lock};
+        if(sharedEntry)
+        {
+            /* the data is shared with the cache, not copied */
+            block_t *p_ref = sharedEntry->share(p_block);
+            if(p_ref)
+                p_block = p_ref;
+            else
+                unshare(false);
+        }
         buffered += p_block->i_buffer;
         block_ChainLastAppend(&pp_tail, p_block);
         if(p_read == nullptr)
@@ -444,12 +494,26 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         {
             done = true;
             downloadEndTime = vlc_tick_now();
+            downloadTime += (downloadEndTime - stepStartTime) / concurrency;
             rate.size = buffered;
-            rate.time = downloadEndTime - requestStartTime;
+            rate.time = downloadTime;
             rate.latency = responseTime - requestStartTime;
+            if(sharedEntry)
+                unshare(true);
+        }
+        else
+        {
+            downloadTime += (vlc_tick_now() - stepStartTime) / concurrency;
         }
     }
 
+    if(ret > 0 && type == ChunkType::Segment)
+    {
+        /* exclude the request latency from the first read */
+        const vlc_tick_t stepTime = stepEndTime - std::max(stepStartTime, responseTime);
+        connManager->updateDownloadProgress(sourceid, ret, stepTime / concurrency);
+    }
+
     if(rate.size && rate.time && type == ChunkType::Segment)
     {
         connManager->updateDownloadRate(sourceid, rate.size,
@@ -26,6 +26,7 @@
 #define CHUNK_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "BytesRange.hpp"
@@ -42,6 +43,8 @@ namespace adaptive
         class AbstractConnection;
         class AbstractConnectionManager;
         class AbstractChunk;
+        class SegmentCache;
+        class SegmentCacheEntry;
 
         enum class ChunkType
         {
@@ -170,12 +173,15 @@ namespace adaptive
                 HTTPChunkBufferedSource(const std::string &url, AbstractConnectionManager *,
                                         const ID &, ChunkType, const BytesRange &,
                                         bool = false);
-                void               bufferize(size_t);
+                void               bufferize(size_t, unsigned = 1);
                 bool               isDone() const;
                 void               hold();
                 void               release();
+                void               share(SegmentCache *,
+                                         const std::shared_ptr<SegmentCacheEntry> &);
 
             private:
+                void               unshare(bool);
                 block_t            *p_head; /* read cache buffer */
                 block_t           **pp_tail;
                 const block_t      *p_read;
@@ -185,6 +191,9 @@ namespace adaptive
                 bool                eof;
                 vlc::threads::condition_variable avail;
                 bool                held;
+                vlc_tick_t          downloadTime; /* share of the bandwidth usage */
+                SegmentCache       *sharedCache; /* also filled while downloading */
+                std::shared_ptr<SegmentCacheEntry> sharedEntry;
         };
 
         class HTTPChunk : public AbstractChunk
@@ -25,42 +25,41 @@
 
 #include <vlc_threads.h>
 
-#include <atomic>
+#include <algorithm>
 
 using namespace adaptive::http;
 
-Downloader::Downloader()
+Downloader::Downloader(unsigned count)
 {
     killed = false;
-    thread_handle_valid = false;
-    current = nullptr;
-    cancel_current = false;
+    thread_count = count ? count : 1;
 }
 
 bool Downloader::start()
 {
-    if(!thread_handle_valid &&
-       vlc_clone(&thread_handle, downloaderThread, static_cast<void *>(this)))
+    while(thread_handles.size() < thread_count)
     {
-        return false;
+        vlc_thread_t th;
+        if(vlc_clone(&th, downloaderThread, static_cast<void *>(this)))
+            break;
+        thread_handles.push_back(th);
     }
-    thread_handle_valid = true;
-    return true;
+    return !thread_handles.empty();
 }
 
 Downloader::~Downloader()
 {
     kill();
 
-    if(thread_handle_valid)
-        vlc_join(thread_handle, nullptr);
+    for(vlc_thread_t th : thread_handles)
+        vlc_join(th, nullptr);
 }
 
 void Downloader::kill()
 {
     vlc::threads::mutex_locker locker {lock};
     killed = true;
-    wait_cond.signal();
+    wait_cond.broadcast();
 }
 
 void Downloader::schedule(HTTPChunkBufferedSource *source)
@@ -71,13 +70,19 @@ void Downloader::schedule(HTTPChunkBufferedSource *source)
     wait_cond.signal();
 }
 
+bool Downloader::isCurrent(const HTTPChunkBufferedSource *source) const
+{
+    return std::find(current.begin(), current.end(), source) != current.end();
+}
+
 void Downloader::cancel(HTTPChunkBufferedSource *source)
 {
     vlc::threads::mutex_locker locker {lock};
-    while (current == source)
+    if(isCurrent(source))
     {
-        cancel_current = true;
-        updated_cond.wait(lock);
+        cancelled.push_back(source);
+        while(isCurrent(source))
+            updated_cond.wait(lock);
     }
 
     if(!source->isDone())
@@ -87,6 +92,17 @@ void Downloader::cancel(HTTPChunkBufferedSource *source)
     }
 }
 
+HTTPChunkBufferedSource * Downloader::getNextChunk() const
+{
+    /* Oldest chunk not already being downloaded by another thread */
+    for(HTTPChunkBufferedSource *source : chunks)
+    {
+        if(!isCurrent(source))
+            return source;
+    }
+    return nullptr;
+}
+
 void * Downloader::downloaderThread(void *opaque)
 {
     vlc_thread_set_name("vlc-adapt-dl");
@@ -101,7 +117,8 @@ void Downloader::Run()
     {
         lock.lock();
 
-        while(chunks.empty() && !killed)
+        HTTPChunkBufferedSource *source;
+        while(!(source = getNextChunk()) && !killed)
             wait_cond.wait(lock);
 
         if(killed)
@@ -110,18 +127,22 @@ void Downloader::Run()
             break;
         }
 
-        current = chunks.front();
+        current.push_back(source);
+        /* Concurrent downloads share the bandwidth */
+        const unsigned concurrency = current.size();
         lock.unlock();
-        current->bufferize(HTTPChunkSource::CHUNK_SIZE);
+        source->bufferize(HTTPChunkSource::CHUNK_SIZE, concurrency);
         lock.lock();
-        if(current->isDone() || cancel_current)
+        current.remove(source);
+        const bool b_cancel = std::find(cancelled.begin(), cancelled.end(),
+                                        source) != cancelled.end();
+        if(source->isDone() || b_cancel)
         {
-            chunks.pop_front();
-            current->release();
+            chunks.remove(source);
+            source->release();
         }
-        cancel_current = false;
-        current = nullptr;
-        updated_cond.signal();
+        cancelled.remove(source);
+        updated_cond.broadcast();
         lock.unlock();
     }
 }
@@ -25,6 +25,7 @@
 #include <vlc_common.h>
 #include <vlc_cxx_helpers.hpp>
 #include <list>
+#include <vector>
 
 namespace adaptive
 {
@@ -35,7 +36,7 @@ namespace adaptive
         class Downloader
         {
             public:
-                Downloader();
+                Downloader(unsigned = 1);
                 ~Downloader();
                 bool start();
                 void schedule(HTTPChunkBufferedSource *);
@@ -45,15 +46,18 @@ namespace adaptive
                 static void * downloaderThread(void *);
                 void Run();
                 void kill();
-                vlc_thread_t thread_handle;
+                HTTPChunkBufferedSource * getNextChunk() const;
+                bool isCurrent(const HTTPChunkBufferedSource *) const;
+                std::vector<vlc_thread_t> thread_handles;
+                unsigned     thread_count;
                 vlc::threads::mutex lock;
                 vlc::threads::condition_variable wait_cond;
                 vlc::threads::condition_variable updated_cond;
-                bool         thread_handle_valid;
                 bool         killed;
-                bool         cancel_current;
                 std::list<HTTPChunkBufferedSource *> chunks;
-                HTTPChunkBufferedSource *current;
+                /* being downloaded, and their cancellation requests */
+                std::list<HTTPChunkBufferedSource *> current;
+                std::list<const HTTPChunkBufferedSource *> cancelled;
         };
 
     }
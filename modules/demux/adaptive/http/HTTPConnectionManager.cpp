@@ -29,6 +29,7 @@
 #include "HTTPConnection.hpp"
 #include "ConnectionParams.hpp"
 #include "Downloader.hpp"
+#include "SegmentCache.hpp"
 #include "../tools/Debug.hpp"
 #include <vlc_url.h>
 #include <vlc_http.h>
@@ -62,6 +63,13 @@ void AbstractConnectionManager::updateDownloadRate(const adaptive::ID &sourceid,
     }
 }
 
+void AbstractConnectionManager::updateDownloadProgress(const adaptive::ID &sourceid,
+                                                       size_t size, vlc_tick_t time)
+{
+    if(rateObserver)
+        rateObserver->updateDownloadProgress(sourceid, size, time);
+}
+
 void AbstractConnectionManager::setDownloadRateObserver(IDownloadRateObserver *obs)
 {
     rateObserver = obs;
@@ -77,12 +85,17 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
       localAllowed(false)
 {
     vlc_mutex_init(&lock);
-    downloader = new Downloader();
+    int64_t downloads = var_InheritInteger(p_object, "adaptive-downloads");
+    downloader = new Downloader(downloads > 1 ? downloads : 1);
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
     cache_total = 0;
     cache_max = 1 << 19;
+    sharedcache = nullptr;
+    int64_t sharedsize = var_InheritInteger(p_object, "adaptive-cache-size");
+    if(sharedsize > 0)
+        sharedcache = SegmentCache::acquire(p_object, sharedsize * 1024);
 }
 
 HTTPConnectionManager::~HTTPConnectionManager   ()
@@ -99,6 +112,8 @@ HTTPConnectionManager::~HTTPConnectionManager   ()
     }
     delete downloader;
     delete downloaderhp;
+    if(sharedcache)
+        SegmentCache::release(sharedcache);
     this->closeAllConnections();
     while(!factories.empty())
     {
@@ -191,6 +206,22 @@ AbstractChunkSource *HTTPConnectionManager::makeSource(const std::string &url,
             }
             // fallthrough
         case ChunkType::Segment:
+            if(sharedcache)
+            {
+                bool owner;
+                std::shared_ptr<SegmentCacheEntry> entry = sharedcache->get(storageid, &owner);
+                if(!owner)
+                {
+                    CacheDebug(msg_Dbg(p_object, "Shared cache GET '%s'",
+                                       storageid.c_str()));
+                    return new SharedChunkSource(url, this, id, type, range, entry);
+                }
+                HTTPChunkBufferedSource *src = new HTTPChunkBufferedSource(url, this, id,
+                                                                           type, range);
+                src->share(sharedcache, entry);
+                return src;
+            }
+            return new HTTPChunkBufferedSource(url, this, id, type, range);
         case ChunkType::Key:
         case ChunkType::Playlist:
         default:
@@ -44,6 +44,7 @@ namespace adaptive
         class Downloader;
         class AbstractChunkSource;
         class HTTPChunkBufferedSource;
+        class SegmentCache;
         enum class ChunkType;
 
         class AbstractConnectionManager : public IDownloadRateObserver
@@ -63,6 +64,7 @@ namespace adaptive
 
                 virtual void updateDownloadRate(const ID &, size_t,
                                                 vlc_tick_t, vlc_tick_t) override;
+                virtual void updateDownloadProgress(const ID &, size_t, vlc_tick_t) override;
                 void setDownloadRateObserver(IDownloadRateObserver *);
 
             protected:
@@ -104,6 +106,7 @@ namespace adaptive
                 std::list<HTTPChunkBufferedSource *> cache;
                 size_t cache_total;
                 size_t cache_max;
+                SegmentCache *sharedcache;
         };
     }
 }
@@ -0,0 +1,446 @@
+/*
+ * SegmentCache.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "SegmentCache.hpp"
+#include "HTTPConnectionManager.h"
+
+#include <vlc_block.h>
+#include <vlc_interrupt.h>
+#include <vlc_memaccount.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+using namespace adaptive::http;
+using vlc::threads::mutex_locker;
+
+SegmentCacheEntry::Cursor::Cursor()
+{
+    p_block = nullptr;
+    offset = 0;
+    position = 0;
+}
+
+size_t SegmentCacheEntry::Cursor::getPosition() const
+{
+    return position;
+}
+
+SegmentCacheEntry::SegmentCacheEntry(const StorageID &id_)
+{
+    id = id_;
+    p_head = nullptr;
+    pp_tail = &p_head;
+    size = 0;
+    state = State::Pending;
+    status = RequestStatus::Success;
+}
+
+SegmentCacheEntry::~SegmentCacheEntry()
+{
+    if(p_head)
+        block_ChainRelease(p_head);
+}
+
+const StorageID & SegmentCacheEntry::getStorageID() const
+{
+    return id;
+}
+
+void SegmentCacheEntry::setContentType(const std::string &type)
+{
+    mutex_locker locker {lock};
+    contentType = type;
+}
+
+std::string SegmentCacheEntry::getContentType() const
+{
+    mutex_locker locker {lock};
+    return contentType;
+}
+
+RequestStatus SegmentCacheEntry::getRequestStatus() const
+{
+    mutex_locker locker {lock};
+    return status;
+}
+
+size_t SegmentCacheEntry::getSize() const
+{
+    mutex_locker locker {lock};
+    return size;
+}
+
+void SegmentCacheEntry::append(block_t *p_block)
+{
+    mutex_locker locker {lock};
+    assert(state == State::Pending);
+    size += p_block->i_buffer;
+    block_ChainLastAppend(&pp_tail, p_block);
+    avail.broadcast();
+}
+
+namespace
+{
+    struct SharedBlock
+    {
+        block_t self;
+        std::shared_ptr<SegmentCacheEntry> *entry;
+    };
+
+    struct Waiter
+    {
+        SegmentCacheEntry *entry;
+        bool interrupted;
+    };
+}
+
+static void SharedBlockFree(block_t *p_block)
+{
+    SharedBlock *shared = container_of(p_block, SharedBlock, self);
+    delete shared->entry;
+    delete shared;
+}
+
+static const struct vlc_frame_callbacks SharedBlockCbs =
+{
+    SharedBlockFree,
+};
+
+block_t * SegmentCacheEntry::share(block_t *p_block)
+{
+    SharedBlock *shared = new (std::nothrow) SharedBlock;
+    if(!shared)
+        return nullptr;
+    shared->entry = new (std::nothrow) std::shared_ptr<SegmentCacheEntry>(shared_from_this());
+    if(!shared->entry)
+    {
+        delete shared;
+        return nullptr;
+    }
+    /* the data is owned by the entry, only referenced by the downloader */
+    block_t *p_ref = block_Init(&shared->self, &SharedBlockCbs,
+                                p_block->p_buffer, p_block->i_buffer);
+    append(p_block);
+    return p_ref;
+}
+
+void SegmentCacheEntry::finish(State s, RequestStatus st)
+{
+    mutex_locker locker {lock};
+    assert(s != State::Pending);
+    state = s;
+    status = st;
+    avail.broadcast();
+}
+
+void SegmentCacheEntry::wakeUp(void *opaque)
+{
+    Waiter *waiter = static_cast<Waiter *>(opaque);
+    SegmentCacheEntry *entry = waiter->entry;
+    mutex_locker locker {entry->lock};
+    waiter->interrupted = true;
+    entry->avail.broadcast();
+}
+
+block_t * SegmentCacheEntry::read(Cursor &cursor, size_t readsize, State *p_state)
+{
+    /* a stalled download must not block closing or seeking */
+    Waiter waiter = { this, false };
+    vlc_interrupt_register(wakeUp, &waiter);
+    block_t *p_block = read(cursor, readsize, p_state, &waiter.interrupted);
+    vlc_interrupt_unregister();
+    return p_block;
+}
+
+block_t * SegmentCacheEntry::read(Cursor &cursor, size_t readsize, State *p_state,
+                                  const bool *interrupted)
+{
+    mutex_locker locker {lock};
+
+    const size_t wanted = readsize ? readsize : 1;
+    while(size - cursor.position < wanted && state == State::Pending)
+    {
+        if(*interrupted)
+        {
+            *p_state = state;
+            return nullptr;
+        }
+        avail.wait(lock);
+    }
+
+    *p_state = state;
+    if(cursor.position == size)
+        return nullptr;
+
+    if(cursor.p_block == nullptr)
+        cursor.p_block = p_head;
+
+    if(readsize == 0) /* remaining of current block */
+    {
+        if(cursor.offset == cursor.p_block->i_buffer)
+        {
+            cursor.p_block = cursor.p_block->p_next;
+            cursor.offset = 0;
+        }
+        readsize = cursor.p_block->i_buffer - cursor.offset;
+    }
+    readsize = std::min(readsize, size - cursor.position);
+
+    block_t *p_block = block_Alloc(readsize);
+    if(!p_block)
+        return nullptr;
+
+    size_t copied = 0;
+    while(copied < readsize)
+    {
+        if(cursor.offset == cursor.p_block->i_buffer)
+        {
+            cursor.p_block = cursor.p_block->p_next;
+            cursor.offset = 0;
+        }
+        const size_t tocopy = std::min(cursor.p_block->i_buffer - cursor.offset,
+                                       readsize - copied);
+        memcpy(&p_block->p_buffer[copied],
+               &cursor.p_block->p_buffer[cursor.offset], tocopy);
+        cursor.offset += tocopy;
+        copied += tocopy;
+    }
+    cursor.position += copied;
+
+    /* Report the final state along with the last data */
+    if(cursor.position < size)
+        *p_state = State::Pending;
+
+    return p_block;
+}
+
+SegmentCache::SegmentCache(size_t max_)
+{
+    total = 0;
+    max = max_;
+    instance = nullptr;
+    refs = 0;
+}
+
+SegmentCache::~SegmentCache()
+{
+    assert(refs == 0);
+    vlc_memaccount_Remove(VLC_MEMACCOUNT_CACHE, total);
+}
+
+std::shared_ptr<SegmentCacheEntry> SegmentCache::get(const StorageID &id, bool *owner)
+{
+    mutex_locker locker {lock};
+    for(auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if((*it)->getStorageID() == id)
+        {
+            std::shared_ptr<SegmentCacheEntry> entry = *it;
+            entries.splice(entries.begin(), entries, it); /* LRU */
+            *owner = false;
+            return entry;
+        }
+    }
+
+    std::shared_ptr<SegmentCacheEntry> entry = std::make_shared<SegmentCacheEntry>(id);
+    entries.push_front(entry);
+    *owner = true;
+    return entry;
+}
+
+void SegmentCache::evict()
+{
+    /* The memory budget of all the caches can be lower than our own */
+    for(auto it = entries.end(); it != entries.begin() &&
+        (total > max || vlc_memaccount_IsOverBudget(VLC_MEMACCOUNT_CACHE));)
+    {
+        --it;
+        if((*it)->state == SegmentCacheEntry::State::Pending)
+            continue;
+        /* readers keep their own reference */
+        total -= (*it)->size;
+        vlc_memaccount_Remove(VLC_MEMACCOUNT_CACHE, (*it)->size);
+        it = entries.erase(it);
+    }
+}
+
+void SegmentCache::finish(const std::shared_ptr<SegmentCacheEntry> &entry,
+                          SegmentCacheEntry::State state, RequestStatus status)
+{
+    mutex_locker locker {lock};
+    entry->finish(state, status);
+    /* Only cache completed downloads */
+    if(state != SegmentCacheEntry::State::Done || entry->getSize() > max)
+    {
+        entries.remove(entry);
+        return;
+    }
+    total += entry->getSize();
+    vlc_memaccount_Add(VLC_MEMACCOUNT_CACHE, entry->getSize());
+    evict();
+}
+
+size_t SegmentCache::getUsage() const
+{
+    mutex_locker locker {lock};
+    return total;
+}
+
+/* One cache per libvlc instance */
+static vlc::threads::mutex caches_lock;
+static std::list<SegmentCache *> caches;
+
+SegmentCache * SegmentCache::acquire(vlc_object_t *obj, size_t max)
+{
+    vlc_object_t *instance = VLC_OBJECT(vlc_object_instance(obj));
+    mutex_locker locker {caches_lock};
+    for(SegmentCache *cache : caches)
+    {
+        if(cache->instance == instance)
+        {
+            cache->refs++;
+            return cache;
+        }
+    }
+    SegmentCache *cache = new SegmentCache(max);
+    cache->instance = instance;
+    cache->refs = 1;
+    caches.push_back(cache);
+    return cache;
+}
+
+void SegmentCache::release(SegmentCache *cache)
+{
+    mutex_locker locker {caches_lock};
+    if(--cache->refs == 0)
+    {
+        caches.remove(cache);
+        delete cache;
+    }
+}
+
+SharedChunkSource::SharedChunkSource(const std::string &url_,
+                                     AbstractConnectionManager *manager,
+                                     const adaptive::ID &id, ChunkType t,
+                                     const BytesRange &range,
+                                     const std::shared_ptr<SegmentCacheEntry> &entry_)
+    : AbstractChunkSource(t, range),
+      url(url_),
+      sourceid(id),
+      connManager(manager),
+      entry(entry_)
+{
+    storeid = entry->getStorageID();
+    fallback = nullptr;
+    eof = false;
+}
+
+SharedChunkSource::~SharedChunkSource()
+{
+    if(fallback)
+        fallback->recycle();
+}
+
+block_t * SharedChunkSource::doRead(size_t size)
+{
+    if(fallback)
+        return size ? fallback->read(size) : fallback->readBlock();
+
+    if(eof)
+        return nullptr;
+
+    SegmentCacheEntry::State state;
+    block_t *p_block = entry->read(cursor, size, &state);
+    if(p_block)
+    {
+        if(state != SegmentCacheEntry::State::Pending)
+            eof = true;
+        return p_block;
+    }
+
+    eof = true;
+    if(state == SegmentCacheEntry::State::Aborted && cursor.getPosition() == 0)
+    {
+        /* Owner went away before sending anything: do our own request,
+         * which can in turn be shared */
+        fallback = connManager->makeSource(url, sourceid, type, bytesRange);
+        if(fallback)
+        {
+            connManager->start(fallback);
+            return size ? fallback->read(size) : fallback->readBlock();
+        }
+    }
+    else if(state == SegmentCacheEntry::State::Done && size == 0 && cursor.getPosition() == 0)
+    {
+        p_block = block_Alloc(0); /* empty content */
+    }
+    return p_block;
+}
+
+block_t * SharedChunkSource::readBlock()
+{
+    return doRead(0);
+}
+
+block_t * SharedChunkSource::read(size_t size)
+{
+    if(size == 0)
+        return nullptr;
+    return doRead(size);
+}
+
+bool SharedChunkSource::hasMoreData() const
+{
+    if(fallback)
+        return fallback->hasMoreData();
+    return !eof;
+}
+
+size_t SharedChunkSource::getBytesRead() const
+{
+    if(fallback)
+        return fallback->getBytesRead();
+    return cursor.getPosition();
+}
+
+std::string SharedChunkSource::getContentType() const
+{
+    if(fallback)
+        return fallback->getContentType();
+    return entry->getContentType();
+}
+
+RequestStatus SharedChunkSource::getRequestStatus() const
+{
+    if(fallback)
+        return fallback->getRequestStatus();
+    return entry->getRequestStatus();
+}
+
+void SharedChunkSource::recycle()
+{
+    connManager->recycleSource(this);
+}
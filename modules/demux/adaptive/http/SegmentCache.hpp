@@ -0,0 +1,159 @@
+/*
+ * SegmentCache.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef SEGMENTCACHE_HPP
+#define SEGMENTCACHE_HPP
+
+#include "Chunk.h"
+
+#include <vlc_common.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <list>
+#include <memory>
+
+namespace adaptive
+{
+    namespace http
+    {
+        /* Content of a single URL + range, filled by the one source doing
+         * the actual download, and read by any number of other sources */
+        class SegmentCacheEntry : public std::enable_shared_from_this<SegmentCacheEntry>
+        {
+            friend class SegmentCache;
+
+            public:
+                enum class State
+                {
+                    Pending,
+                    Done,
+                    Failed,  /* request completed with an error */
+                    Aborted, /* download was cancelled */
+                };
+
+                class Cursor
+                {
+                    friend class SegmentCacheEntry;
+                    public:
+                        Cursor();
+                        size_t getPosition() const;
+                    private:
+                        const block_t *p_block;
+                        size_t offset;
+                        size_t position;
+                };
+
+                SegmentCacheEntry(const StorageID &);
+                ~SegmentCacheEntry();
+
+                const StorageID & getStorageID() const;
+                void setContentType(const std::string &);
+                std::string getContentType() const;
+                RequestStatus getRequestStatus() const;
+                size_t getSize() const;
+
+                void append(block_t *);
+                /* Appends the block, and returns a block referencing the
+                 * same data for the downloader, which keeps the entry alive.
+                 * Ownership is only taken on success. */
+                block_t * share(block_t *);
+                void finish(State, RequestStatus);
+
+                /* Reads up to the cursor block end if size is 0, waiting
+                 * for data. The state is only final along with the last
+                 * data, or at end when returning nullptr. The wait can be
+                 * interrupted, in which case nullptr is returned with a
+                 * Pending state. */
+                block_t * read(Cursor &, size_t, State *);
+
+            private:
+                static void wakeUp(void *);
+                block_t * read(Cursor &, size_t, State *, const bool *);
+                StorageID id;
+                mutable vlc::threads::mutex lock;
+                vlc::threads::condition_variable avail;
+                block_t *p_head;
+                block_t **pp_tail;
+                size_t size;
+                State state;
+                RequestStatus status;
+                std::string contentType;
+        };
+
+        /* Size bounded cache shared by all the connection managers of a
+         * libvlc instance. Entries are registered before their download,
+         * so that concurrent requests of the same content are served by
+         * a single fetch. */
+        class SegmentCache
+        {
+            public:
+                SegmentCache(size_t);
+                ~SegmentCache();
+
+                /* Returns the existing entry, or a new pending one to be
+                 * downloaded by the caller if owner is set */
+                std::shared_ptr<SegmentCacheEntry> get(const StorageID &, bool *owner);
+                void finish(const std::shared_ptr<SegmentCacheEntry> &,
+                            SegmentCacheEntry::State, RequestStatus);
+                size_t getUsage() const;
+
+                static SegmentCache * acquire(vlc_object_t *, size_t);
+                static void release(SegmentCache *);
+
+            private:
+                void evict();
+                mutable vlc::threads::mutex lock;
+                std::list<std::shared_ptr<SegmentCacheEntry>> entries;
+                size_t total;
+                size_t max;
+                vlc_object_t *instance;
+                unsigned refs;
+        };
+
+        class SharedChunkSource : public AbstractChunkSource
+        {
+            public:
+                SharedChunkSource(const std::string &, AbstractConnectionManager *,
+                                  const ID &, ChunkType, const BytesRange &,
+                                  const std::shared_ptr<SegmentCacheEntry> &);
+                virtual ~SharedChunkSource();
+
+                virtual block_t *   readBlock       () override;
+                virtual block_t *   read            (size_t) override;
+                virtual bool        hasMoreData     () const override;
+                virtual size_t      getBytesRead    () const override;
+                virtual std::string getContentType  () const override;
+                virtual RequestStatus getRequestStatus() const override;
+                virtual void        recycle() override;
+
+            private:
+                block_t *           doRead(size_t);
+                std::string         url;
+                ID                  sourceid;
+                AbstractConnectionManager *connManager;
+                std::shared_ptr<SegmentCacheEntry> entry;
+                SegmentCacheEntry::Cursor cursor;
+                AbstractChunkSource *fallback; /* own source if the shared
+                                                  download was cancelled */
+                bool                eof;
+        };
+    }
+}
+
+#endif // SEGMENTCACHE_HPP
@@ -29,6 +29,8 @@
 #include "../playlist/SegmentList.h"
 #include "../playlist/SegmentBase.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <cassert>
 
@@ -46,6 +48,7 @@ AbstractBufferingLogic::AbstractBufferingLogic()
     userMinBuffering = 0;
     userMaxBuffering = 0;
     userLiveDelay = 0;
+    userMaxPrefetch = 0;
 }
 
 void AbstractBufferingLogic::setLowDelay(bool b)
@@ -68,11 +71,26 @@ void AbstractBufferingLogic::setUserLiveDelay(vlc_tick_t v)
     userLiveDelay = v;
 }
 
+void AbstractBufferingLogic::setUserMaxPrefetch(unsigned v)
+{
+    userMaxPrefetch = v;
+}
+
+unsigned AbstractBufferingLogic::getMaxPrefetch(const BasePlaylist *) const
+{
+    return userMaxPrefetch;
+}
+
 /* Try to never buffer up to really end */
 /* Enforce no overlap for demuxers segments 3.0.0 */
 /* FIXME: check duration instead ? */
 const unsigned DefaultBufferingLogic::SAFETY_BUFFERING_EDGE_OFFSET = 1;
 const unsigned DefaultBufferingLogic::SAFETY_EXPURGING_OFFSET = 2;
+/* Latency control */
+const vlc_tick_t DefaultBufferingLogic::LATENCY_TOLERANCE = VLC_TICK_FROM_MS(100);
+const vlc_tick_t DefaultBufferingLogic::LATENCY_CATCHUP_TIME = VLC_TICK_FROM_SEC(10);
+const float DefaultBufferingLogic::DEFAULT_MIN_PLAYBACK_RATE = 0.96f;
+const float DefaultBufferingLogic::DEFAULT_MAX_PLAYBACK_RATE = 1.04f;
 
 DefaultBufferingLogic::DefaultBufferingLogic()
     : AbstractBufferingLogic()
@@ -128,10 +146,12 @@ vlc_tick_t DefaultBufferingLogic::getMaxBuffering(const BasePlaylist *p) const
 vlc_tick_t DefaultBufferingLogic::getLiveDelay(const BasePlaylist *p) const
 {
     if(isLowLatency(p))
-        return getMinBuffering(p);
+        return std::max(getMinBuffering(p), p->targetLatency.Get());
     vlc_tick_t delay = userLiveDelay ? userLiveDelay
                                      : DEFAULT_LIVE_BUFFERING;
-    if(p->suggestedPresentationDelay.Get())
+    if(p->targetLatency.Get())
+        delay = p->targetLatency.Get();
+    else if(p->suggestedPresentationDelay.Get())
         delay = p->suggestedPresentationDelay.Get();
     else if(p->presentationStartOffset.Get())
         delay = p->presentationStartOffset.Get();
@@ -151,6 +171,39 @@ vlc_tick_t DefaultBufferingLogic::getStableBuffering(const BasePlaylist *p) cons
     return std::min(getMinBuffering(p) * 2, max);
 }
 
+vlc_tick_t DefaultBufferingLogic::getLatencyCorrection(const BasePlaylist *p,
+                                                       vlc_tick_t latency,
+                                                       vlc_tick_t elapsed) const
+{
+    const vlc_tick_t target = p->targetLatency.Get();
+    if(!p->isLive() || !target || elapsed <= 0)
+        return 0;
+
+    const vlc_tick_t diff = latency - target;
+    if(std::abs(diff) <= LATENCY_TOLERANCE)
+        return 0;
+
+    float minrate = p->minPlaybackRate.Get();
+    float maxrate = p->maxPlaybackRate.Get();
+    if(minrate <= 0.f || minrate > 1.f)
+        minrate = DEFAULT_MIN_PLAYBACK_RATE;
+    if(maxrate < 1.f)
+        maxrate = DEFAULT_MAX_PLAYBACK_RATE;
+
+    /* Proportional rate change, up to the bounds when leaving the allowed range */
+    float rate = 1.f + (float) diff / LATENCY_CATCHUP_TIME;
+    if((p->maxLatency.Get() && latency > p->maxLatency.Get()) ||
+       (p->minLatency.Get() && latency < p->minLatency.Get()))
+        rate = (diff > 0) ? maxrate : minrate;
+    rate = std::max(minrate, std::min(maxrate, rate));
+
+    vlc_tick_t shift = (rate - 1.f) * elapsed;
+    /* do not overshoot */
+    if(std::abs(shift) > std::abs(diff) - LATENCY_TOLERANCE)
+        shift = (diff > 0) ? diff - LATENCY_TOLERANCE : diff + LATENCY_TOLERANCE;
+    return -shift;
+}
+
 uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *rep) const
 {
     BasePlaylist *playlist = rep->getPlaylist();
@@ -178,7 +231,10 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
         uint64_t safeMinElementNumber = timeline->minElementNumber();
         uint64_t safeMaxElementNumber = timeline->maxElementNumber();
         stime_t safeedgetime, safestarttime, duration;
-        for(unsigned i=0; i<SAFETY_BUFFERING_EDGE_OFFSET; i++)
+        /* The last chunked segment can be read while being produced */
+        const unsigned edgeoffset = timeline->inheritAvailabilityTimeComplete()
+                                  ? SAFETY_BUFFERING_EDGE_OFFSET : 0;
+        for(unsigned i=0; i<edgeoffset; i++)
         {
             if(safeMinElementNumber == safeMaxElementNumber)
                 break;
@@ -263,14 +319,19 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
                 if(playbacktime < minavailtime)
                     playbacktime = minavailtime;
             }
-            /* Get completed segment containing the time ref */
-            start = mediaSegmentTemplate->getLiveTemplateNumber(playbacktime);
+            /* Get completed segment containing the time ref,
+             * or the one being produced when chunked */
+            start = mediaSegmentTemplate->getLiveTemplateNumber(playbacktime +
+                        mediaSegmentTemplate->getLiveAvailabilityOffset());
             if (unlikely(start < startnumber))
             {
                 assert(startnumber > start); /* blame getLiveTemplateNumber() */
                 start = startnumber;
             }
 
+            if(!mediaSegmentTemplate->inheritAvailabilityTimeComplete())
+                return start;
+
             const uint64_t max_safety_offset = playbacktime - minavailtime / duration;
             const uint64_t safety_offset = std::min((uint64_t)SAFETY_BUFFERING_EDGE_OFFSET,
                                                     max_safety_offset);
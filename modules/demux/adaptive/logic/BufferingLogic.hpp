@@ -47,10 +47,18 @@ namespace adaptive
                 virtual vlc_tick_t getMaxBuffering(const BasePlaylist *) const = 0;
                 virtual vlc_tick_t getLiveDelay(const BasePlaylist *) const = 0;
                 virtual vlc_tick_t getStableBuffering(const BasePlaylist *) const = 0;
+                /* Returns the shift of the presentation clock, over the elapsed
+                 * time, to move the live latency towards the target.
+                 * Negative values catch up. */
+                virtual vlc_tick_t getLatencyCorrection(const BasePlaylist *,
+                                                        vlc_tick_t latency,
+                                                        vlc_tick_t elapsed) const = 0;
+                virtual unsigned getMaxPrefetch(const BasePlaylist *) const;
                 void setUserMinBuffering(vlc_tick_t);
                 void setUserMaxBuffering(vlc_tick_t);
                 void setUserLiveDelay(vlc_tick_t);
                 void setLowDelay(bool);
+                void setUserMaxPrefetch(unsigned);
                 static const vlc_tick_t BUFFERING_LOWEST_LIMIT;
                 static const vlc_tick_t DEFAULT_MIN_BUFFERING;
                 static const vlc_tick_t DEFAULT_MAX_BUFFERING;
@@ -60,6 +68,7 @@ namespace adaptive
                 vlc_tick_t userMinBuffering;
                 vlc_tick_t userMaxBuffering;
                 vlc_tick_t userLiveDelay;
+                unsigned userMaxPrefetch;
                 Undef<bool> userLowLatency;
         };
 
@@ -73,8 +82,14 @@ namespace adaptive
                 virtual vlc_tick_t getMaxBuffering(const BasePlaylist *) const override;
                 virtual vlc_tick_t getLiveDelay(const BasePlaylist *) const override;
                 virtual vlc_tick_t getStableBuffering(const BasePlaylist *) const override;
+                virtual vlc_tick_t getLatencyCorrection(const BasePlaylist *,
+                                                        vlc_tick_t, vlc_tick_t) const override;
                 static const unsigned SAFETY_BUFFERING_EDGE_OFFSET;
                 static const unsigned SAFETY_EXPURGING_OFFSET;
+                static const vlc_tick_t LATENCY_TOLERANCE;
+                static const vlc_tick_t LATENCY_CATCHUP_TIME;
+                static const float DEFAULT_MIN_PLAYBACK_RATE;
+                static const float DEFAULT_MAX_PLAYBACK_RATE;
 
             protected:
                 vlc_tick_t getBufferingOffset(const BasePlaylist *) const;
@@ -0,0 +1,360 @@
+/*
+ * HybridAdaptationLogic.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "HybridAdaptationLogic.hpp"
+#include "Representationselectors.hpp"
+
+#include "../playlist/BaseAdaptationSet.h"
+#include "../playlist/BaseRepresentation.h"
+#include "../tools/Debug.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace adaptive::logic;
+using namespace adaptive;
+
+const vlc_tick_t ThroughputEstimator::FAST_HALFLIFE = VLC_TICK_FROM_SEC(2);
+const vlc_tick_t ThroughputEstimator::SLOW_HALFLIFE = VLC_TICK_FROM_SEC(8);
+const vlc_tick_t ThroughputEstimator::IDLE_GAP = VLC_TICK_FROM_MS(50);
+const unsigned   ThroughputEstimator::IDLE_RATIO = 4;
+const unsigned   ThroughputEstimator::MAX_IDLE_SAMPLES = 8;
+
+ThroughputEstimator::ThroughputEstimator()
+{
+    fast = slow = 0.0;
+    fastweight = slowweight = 1.0;
+    idlesamples = 0;
+    idlecount = 0;
+}
+
+void ThroughputEstimator::push(size_t size, vlc_tick_t time)
+{
+    if(size == 0 || time <= 0)
+        return;
+
+    const double bps = 8.0 * size * CLOCK_FREQ / time;
+    const uint64_t estimate = get();
+
+    /* Waiting for data is not a link measurement */
+    const bool idle = estimate && time > IDLE_GAP && bps * IDLE_RATIO < estimate;
+    if(!idle)
+        idlesamples = 0;
+    else if(++idlesamples <= MAX_IDLE_SAMPLES)
+    {
+        idlecount++;
+        return;
+    }
+
+    const double af = std::pow(0.5, (double) time / FAST_HALFLIFE);
+    const double as = std::pow(0.5, (double) time / SLOW_HALFLIFE);
+    fast = af * fast + (1.0 - af) * bps;
+    slow = as * slow + (1.0 - as) * bps;
+    fastweight *= af;
+    slowweight *= as;
+}
+
+uint64_t ThroughputEstimator::get() const
+{
+    if(fastweight >= 1.0 || slowweight >= 1.0)
+        return 0;
+    /* unbias the averages from their zero start */
+    const double f = fast / (1.0 - fastweight);
+    const double s = slow / (1.0 - slowweight);
+    return std::min(f, s);
+}
+
+unsigned ThroughputEstimator::getIdleCount() const
+{
+    return idlecount;
+}
+
+RepresentationSwitchStats::RepresentationSwitchStats()
+{
+    selections = 0;
+    upswitches = 0;
+    downswitches = 0;
+    duration = 0;
+    since = VLC_TICK_INVALID;
+}
+
+HybridContext::HybridContext()
+{
+    buffering_min = VLC_TICK_FROM_SEC(6);
+    buffering_level = 0;
+    buffering_target = VLC_TICK_FROM_SEC(30);
+    progressed = false;
+}
+
+const float HybridAdaptationLogic::BANDWIDTH_SAFETY_FACTOR = 0.9f;
+
+HybridAdaptationLogic::HybridAdaptationLogic(vlc_object_t *obj)
+    : AbstractAdaptationLogic(obj)
+    , currentBps( 0 )
+    , usedBps( 0 )
+{
+    vlc_mutex_init(&lock);
+}
+
+HybridAdaptationLogic::~HybridAdaptationLogic()
+{
+}
+
+/*
+ * BOLA: Near-Optimal Bitrate Adaptation for Online Videos
+ * http://arxiv.org/abs/1601.06748
+ */
+BaseRepresentation *
+HybridAdaptationLogic::getBolaRepresentation(BaseAdaptationSet *adaptSet,
+                                             RepresentationSelector &selector,
+                                             const HybridContext &ctx) const
+{
+    BaseRepresentation *lowest = selector.lowest(adaptSet);
+    BaseRepresentation *highest = selector.highest(adaptSet);
+    const float minbuffer = secf_from_vlc_tick(ctx.buffering_min);
+    const float target = secf_from_vlc_tick(ctx.buffering_target);
+    if(target <= minbuffer || !lowest->getBandwidth())
+        return nullptr;
+
+    /* utilities are log(S/Smin) + 1 */
+    const float lowestbw = lowest->getBandwidth();
+    const float umax = std::log(highest->getBandwidth() / lowestbw) + 1.f;
+    const float gp = (umax - 1.f) / (target / minbuffer - 1.f);
+    if(gp <= 0.f)
+        return nullptr;
+    const float Vp = minbuffer / gp;
+    const float Q = secf_from_vlc_tick(ctx.buffering_level);
+
+    BaseRepresentation *ret = nullptr;
+    BaseRepresentation *prev = nullptr;
+    float argmax = 0;
+    for(BaseRepresentation *rep = lowest; rep && rep != prev;
+                            rep = selector.higher(adaptSet, rep))
+    {
+        const float u = std::log(rep->getBandwidth() / lowestbw) + 1.f;
+        const float arg = (Vp * (u + gp) - Q) / rep->getBandwidth();
+        if(ret == nullptr || argmax <= arg)
+        {
+            ret = rep;
+            argmax = arg;
+        }
+        prev = rep;
+    }
+    return ret;
+}
+
+BaseRepresentation *HybridAdaptationLogic::getNextRepresentation(BaseAdaptationSet *adaptSet,
+                                                                 BaseRepresentation *prevRep)
+{
+    RepresentationSelector selector(maxwidth, maxheight);
+
+    BaseRepresentation *lowest = selector.lowest(adaptSet);
+    BaseRepresentation *highest = selector.highest(adaptSet);
+    if(lowest == nullptr || highest == nullptr)
+        return nullptr;
+
+    if(lowest == highest)
+        return lowest;
+
+    vlc_mutex_lock(&lock);
+
+    std::map<ID, HybridContext>::const_iterator it = streams.find(adaptSet->getID());
+    if(it == streams.end())
+    {
+        vlc_mutex_unlock(&lock);
+        return lowest;
+    }
+    const HybridContext ctxcopy = (*it).second;
+    const unsigned bps = getAvailableBw(currentBps * BANDWIDTH_SAFETY_FACTOR, prevRep);
+
+    vlc_mutex_unlock(&lock);
+
+    /* throughput choice */
+    BaseRepresentation *mt = selector.select(adaptSet, bps);
+    if(prevRep == nullptr && mt == lowest)
+    {
+        /* Handle HLS specific cases where the lowest is audio only. Try to pick first A+V */
+        BaseRepresentation *n = selector.higher(adaptSet, mt);
+        if(mt != n  && mt->getCodecs().size() == 1 && n->getCodecs().size() > 1)
+            mt = n;
+    }
+
+    BaseRepresentation *m = mt;
+    if(prevRep && ctxcopy.buffering_level >= ctxcopy.buffering_min)
+    {
+        BaseRepresentation *mb = getBolaRepresentation(adaptSet, selector, ctxcopy);
+        if(mb)
+        {
+            /* Do not go higher than the sustainable throughput */
+            if(mb->getBandwidth() > prevRep->getBandwidth() &&
+               mb->getBandwidth() > mt->getBandwidth())
+                mb = (mt->getBandwidth() > prevRep->getBandwidth()) ? mt : prevRep;
+            m = mb;
+        }
+    }
+
+    BwDebug( msg_Info(p_obj, "buffering level %.2f%% rep %" PRIu64 " kBps %u kBps",
+             (float) 100 * ctxcopy.buffering_level / ctxcopy.buffering_target,
+             m->getBandwidth()/8000, bps / 8000); );
+
+    return m;
+}
+
+unsigned HybridAdaptationLogic::getAvailableBw(unsigned i_bw, const BaseRepresentation *curRep) const
+{
+    unsigned i_remain = i_bw;
+    if(i_remain > usedBps)
+        i_remain -= usedBps;
+    else
+        i_remain = 0;
+    if(curRep)
+        i_remain += curRep->getBandwidth();
+    return i_remain > i_bw ? i_bw : i_remain;
+}
+
+unsigned HybridAdaptationLogic::getMaxCurrentBw() const
+{
+    uint64_t i_max_bitrate = 0;
+    for(std::map<ID, HybridContext>::const_iterator it = streams.begin();
+                                                    it != streams.end(); ++it)
+        i_max_bitrate = std::max(i_max_bitrate, ((*it).second).estimator.get());
+    return std::min(i_max_bitrate, (uint64_t) std::numeric_limits<unsigned>::max());
+}
+
+void HybridAdaptationLogic::updateDownloadRate(const ID &id, size_t dlsize,
+                                               vlc_tick_t time, vlc_tick_t)
+{
+    vlc_mutex_locker locker(&lock);
+    std::map<ID, HybridContext>::iterator it = streams.find(id);
+    if(it == streams.end())
+        return;
+    HybridContext &ctx = (*it).second;
+    /* Only use the whole chunk rate when there was no progress report */
+    if(!ctx.progressed)
+        ctx.estimator.push(dlsize, time);
+    ctx.progressed = false;
+    currentBps = getMaxCurrentBw();
+}
+
+void HybridAdaptationLogic::updateDownloadProgress(const ID &id, size_t size,
+                                                   vlc_tick_t time)
+{
+    vlc_mutex_locker locker(&lock);
+    std::map<ID, HybridContext>::iterator it = streams.find(id);
+    if(it == streams.end())
+        return;
+    HybridContext &ctx = (*it).second;
+    ctx.estimator.push(size, time);
+    ctx.progressed = true;
+    currentBps = getMaxCurrentBw();
+}
+
+bool HybridAdaptationLogic::getSwitchStats(const ID &id, RepresentationSwitchStats *stats) const
+{
+    vlc_mutex_locker locker(&lock);
+    std::map<ID, RepresentationSwitchStats>::const_iterator it = switchstats.find(id);
+    if(it == switchstats.end())
+        return false;
+    *stats = (*it).second;
+    if(stats->since != VLC_TICK_INVALID)
+        stats->duration += vlc_tick_now() - stats->since;
+    return true;
+}
+
+void HybridAdaptationLogic::trackerEvent(const TrackerEvent &ev)
+{
+    switch(ev.getType())
+    {
+    case TrackerEvent::Type::RepresentationSwitch:
+        {
+            const RepresentationSwitchEvent &event =
+                    static_cast<const RepresentationSwitchEvent &>(ev);
+            const vlc_tick_t now = vlc_tick_now();
+            vlc_mutex_locker locker(&lock);
+            if(event.prev)
+            {
+                usedBps -= event.prev->getBandwidth();
+                RepresentationSwitchStats &s = switchstats[event.prev->getID()];
+                if(s.since != VLC_TICK_INVALID)
+                    s.duration += now - s.since;
+                s.since = VLC_TICK_INVALID;
+            }
+            if(event.next)
+            {
+                usedBps += event.next->getBandwidth();
+                RepresentationSwitchStats &s = switchstats[event.next->getID()];
+                s.selections++;
+                s.since = now;
+                if(event.prev && event.prev->getBandwidth() < event.next->getBandwidth())
+                    s.upswitches++;
+                else if(event.prev && event.prev->getBandwidth() > event.next->getBandwidth())
+                    s.downswitches++;
+                BwDebug(msg_Info(p_obj, "Representation %s selected %u times, %u up %u down",
+                                 event.next->getID().str().c_str(), s.selections,
+                                 s.upswitches, s.downswitches));
+            }
+            BwDebug(msg_Info(p_obj, "New total bandwidth usage %u kBps", (usedBps / 8000)));
+        }
+        break;
+
+    case TrackerEvent::Type::BufferingStateUpdate:
+        {
+            const BufferingStateUpdatedEvent &event =
+                    static_cast<const BufferingStateUpdatedEvent &>(ev);
+            const ID &id = *event.id;
+            vlc_mutex_locker locker(&lock);
+            if(event.enabled)
+            {
+                if(streams.find(id) == streams.end())
+                    streams.insert(std::pair<ID, HybridContext>(id, HybridContext()));
+            }
+            else
+            {
+                std::map<ID, HybridContext>::iterator it = streams.find(id);
+                if(it != streams.end())
+                    streams.erase(it);
+            }
+        }
+        break;
+
+    case TrackerEvent::Type::BufferingLevelChange:
+        {
+            const BufferingLevelChangedEvent &event =
+                    static_cast<const BufferingLevelChangedEvent &>(ev);
+            const ID &id = *event.id;
+            vlc_mutex_locker locker(&lock);
+            std::map<ID, HybridContext>::iterator it = streams.find(id);
+            if(it == streams.end())
+                break;
+            HybridContext &ctx = (*it).second;
+            ctx.buffering_min = event.minimum;
+            ctx.buffering_level = event.current;
+            ctx.buffering_target = event.target;
+        }
+        break;
+
+    default:
+            break;
+    }
+}
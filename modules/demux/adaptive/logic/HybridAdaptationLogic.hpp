@@ -0,0 +1,126 @@
+/*
+ * HybridAdaptationLogic.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef HYBRIDADAPTATIONLOGIC_HPP
+#define HYBRIDADAPTATIONLOGIC_HPP
+
+#include "AbstractAdaptationLogic.h"
+#include "Representationselectors.hpp"
+#include <map>
+
+namespace adaptive
+{
+    namespace logic
+    {
+        /* Bandwidth estimate from partial download progress, as the lowest
+         * of a fast and a slow average weighted by the samples duration.
+         * Samples waiting for data much longer than the estimate allows are
+         * idle gaps (live edge, server pacing) and are not accounted, unless
+         * they last. */
+        class ThroughputEstimator
+        {
+            public:
+                ThroughputEstimator();
+                void push(size_t, vlc_tick_t);
+                uint64_t get() const;
+                unsigned getIdleCount() const;
+
+                static const vlc_tick_t FAST_HALFLIFE;
+                static const vlc_tick_t SLOW_HALFLIFE;
+                static const vlc_tick_t IDLE_GAP;
+                static const unsigned   IDLE_RATIO;
+                static const unsigned   MAX_IDLE_SAMPLES;
+
+            private:
+                double fast;
+                double slow;
+                double fastweight;
+                double slowweight;
+                unsigned idlesamples;
+                unsigned idlecount;
+        };
+
+        class RepresentationSwitchStats
+        {
+            friend class HybridAdaptationLogic;
+
+            public:
+                RepresentationSwitchStats();
+                unsigned selections;   /* times switched to */
+                unsigned upswitches;   /* from a lower bandwidth */
+                unsigned downswitches; /* from a higher bandwidth */
+                vlc_tick_t duration;   /* total time selected */
+
+            private:
+                vlc_tick_t since;
+        };
+
+        class HybridContext
+        {
+            friend class HybridAdaptationLogic;
+
+            public:
+                HybridContext();
+
+            private:
+                vlc_tick_t buffering_min;
+                vlc_tick_t buffering_level;
+                vlc_tick_t buffering_target;
+                bool progressed;
+                ThroughputEstimator estimator;
+        };
+
+        /*
+         * Throughput based selection at startup and on low buffer, then
+         * buffer based BOLA selection capped by the sustainable throughput
+         */
+        class HybridAdaptationLogic : public AbstractAdaptationLogic
+        {
+            public:
+                HybridAdaptationLogic(vlc_object_t *);
+                virtual ~HybridAdaptationLogic();
+
+                virtual BaseRepresentation* getNextRepresentation(BaseAdaptationSet *,
+                                                                  BaseRepresentation *) override;
+                virtual void                updateDownloadRate     (const ID &, size_t,
+                                                                    vlc_tick_t, vlc_tick_t) override;
+                virtual void                updateDownloadProgress (const ID &, size_t,
+                                                                    vlc_tick_t) override;
+                virtual void                trackerEvent           (const TrackerEvent &) override;
+
+                bool getSwitchStats(const ID &, RepresentationSwitchStats *) const;
+
+                static const float BANDWIDTH_SAFETY_FACTOR;
+
+            private:
+                BaseRepresentation *        getBolaRepresentation(BaseAdaptationSet *,
+                                                                  RepresentationSelector &,
+                                                                  const HybridContext &) const;
+                unsigned                    getAvailableBw(unsigned, const BaseRepresentation *) const;
+                unsigned                    getMaxCurrentBw() const;
+                std::map<adaptive::ID, HybridContext> streams;
+                std::map<adaptive::ID, RepresentationSwitchStats> switchstats;
+                unsigned                    currentBps;
+                unsigned                    usedBps;
+                mutable vlc_mutex_t         lock;
+        };
+    }
+}
+
+#endif // HYBRIDADAPTATIONLOGIC_HPP
@@ -36,6 +36,9 @@ namespace adaptive
         public:
             virtual void updateDownloadRate(const ID &, size_t,
                                             vlc_tick_t, vlc_tick_t) = 0;
+            /* Partial progress of a segment download: bytes received
+             * over the time spent waiting for them */
+            virtual void updateDownloadProgress(const ID &, size_t, vlc_tick_t) {}
             virtual ~IDownloadRateObserver(){}
     };
 }
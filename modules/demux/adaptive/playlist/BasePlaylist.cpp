@@ -48,6 +48,11 @@ BasePlaylist::BasePlaylist (vlc_object_t *p_object_) :
     timeShiftBufferDepth.Set( 0 );
     suggestedPresentationDelay.Set( 0 );
     presentationStartOffset.Set( 0 );
+    targetLatency.Set( 0 );
+    minLatency.Set( 0 );
+    maxLatency.Set( 0 );
+    minPlaybackRate.Set( 0 );
+    maxPlaybackRate.Set( 0 );
     b_needsUpdates = true;
 }
 
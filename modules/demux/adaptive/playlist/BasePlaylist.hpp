@@ -74,6 +74,12 @@ namespace adaptive
                 Property<vlc_tick_t>                   timeShiftBufferDepth;
                 Property<vlc_tick_t>                   suggestedPresentationDelay;
                 Property<vlc_tick_t>                   presentationStartOffset;
+                /* Service latency and playback rate bounds, 0 if unset */
+                Property<vlc_tick_t>                   targetLatency;
+                Property<vlc_tick_t>                   minLatency;
+                Property<vlc_tick_t>                   maxLatency;
+                Property<float>                        minPlaybackRate;
+                Property<float>                        maxPlaybackRate;
 
             protected:
                 vlc_object_t                       *p_object;
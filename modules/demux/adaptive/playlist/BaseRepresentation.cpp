@@ -289,3 +289,26 @@ bool BaseRepresentation::getMediaPlaybackRange(vlc_tick_t *rangeBegin,
 
     return false;
 }
+
+bool BaseRepresentation::getLiveEdgeTime(vlc_tick_t now, vlc_tick_t *edge) const
+{
+    SegmentTemplate *mediaSegmentTemplate = inheritSegmentTemplate();
+    if( mediaSegmentTemplate && !mediaSegmentTemplate->inheritSegmentTimeline() )
+    {
+        const Timescale timescale = mediaSegmentTemplate->inheritTimescale();
+        const vlc_tick_t duration = timescale.ToTime(mediaSegmentTemplate->inheritDuration());
+        if( !duration )
+            return false;
+        vlc_tick_t elapsed = now - getPlaylist()->availabilityStartTime.Get() - getPeriodStart();
+        if( elapsed < 0 )
+            return false;
+        /* Chunked segments are available as soon as produced */
+        if( mediaSegmentTemplate->inheritAvailabilityTimeComplete() )
+            elapsed -= elapsed % duration;
+        *edge = elapsed;
+        return true;
+    }
+
+    vlc_tick_t start, length;
+    return getMediaPlaybackRange(&start, edge, &length);
+}
@@ -32,6 +32,7 @@
 #include "BasePlaylist.hpp"
 #include "SegmentChunk.hpp"
 #include "../SharedResources.hpp"
+#include "../encryption/Keyring.hpp"
 #include "../http/BytesRange.hpp"
 #include "../http/HTTPConnectionManager.h"
 #include "../http/Downloader.hpp"
@@ -52,6 +53,7 @@ ISegment::ISegment(const ICanonicalUrl *parent):
     discontinuitySequenceNumber = std::numeric_limits<uint64_t>::max();
     templated = false;
     discontinuity = false;
+    accessPointOffset = 0;
     displayTime = VLC_TICK_INVALID;
 }
 
@@ -73,6 +75,12 @@ bool ISegment::prepareChunk(SharedResources *res, SegmentChunk *chunk, BaseRepre
             return false;
         }
         chunk->setEncryptionSession(encryptionSession);
+
+        /* Retrieve a rotated key before the next segment needs it */
+        const ISegment *next = rep->getMediaSegment(chunk->sequence + 1);
+        if(next && next->encryption.method == CommonEncryption::Method::AES_128 &&
+           !next->encryption.uri.empty() && next->encryption.uri != enc.uri)
+            res->getKeyring()->prefetchKey(res, next->encryption.uri);
     }
     return true;
 }
@@ -201,6 +209,7 @@ vlc_tick_t ISegment::getDisplayTime() const
 Segment::Segment(ICanonicalUrl *parent) :
         ISegment(parent)
 {
+    b_incomplete = false;
 }
 
 SegmentChunk* Segment::createChunk(AbstractChunkSource *source, BaseRepresentation *rep)
@@ -225,6 +234,28 @@ Segment::~Segment()
     std::vector<Segment*>::iterator it;
     for(it=subsegments.begin();it!=subsegments.end();++it)
         delete *it;
+    for(it=parts.begin();it!=parts.end();++it)
+        delete *it;
+}
+
+void Segment::addPart(Segment *part)
+{
+    parts.push_back(part);
+}
+
+const std::vector<Segment *> & Segment::getParts() const
+{
+    return parts;
+}
+
+void Segment::setIncomplete(bool b)
+{
+    b_incomplete = b;
+}
+
+bool Segment::isIncomplete() const
+{
+    return b_incomplete;
 }
 
 void                    Segment::setSourceUrl   ( const std::string &url )
@@ -75,6 +75,9 @@ namespace adaptive
                 Property<stime_t>       startTime;
                 Property<stime_t>       duration;
                 bool                    discontinuity;
+                /* Time of the first access point from startTime,
+                   or -1 if there is none in the segment */
+                stime_t                 accessPointOffset;
 
             protected:
                 virtual bool                            prepareChunk    (SharedResources *,
@@ -101,10 +104,17 @@ namespace adaptive
                 virtual const std::vector<Segment*> & subSegments() const;
                 virtual void debug(vlc_object_t *,int = 0) const override;
                 virtual void addSubSegment(SubSegment *);
+                /* Partial segments, published before the whole segment */
+                void addPart(Segment *);
+                const std::vector<Segment *> & getParts() const;
+                void setIncomplete(bool);
+                bool isIncomplete() const; /* only readable by parts */
 
             protected:
                 std::vector<Segment *> subsegments;
+                std::vector<Segment *> parts;
                 Url sourceUrl;
+                bool b_incomplete;
         };
 
         class InitSegment : public Segment
@@ -85,8 +85,25 @@ bool SegmentBase::getSegmentNumberByTime(vlc_tick_t time, uint64_t *ret) const
     if(!timescale.isValid())
         return false;
     stime_t st = timescale.ToScaled(time);
-    *ret = AbstractSegmentBaseType::findSegmentNumberByScaledTime(subsegments, st);
-    return *ret != std::numeric_limits<uint64_t>::max();
+    uint64_t number = AbstractSegmentBaseType::findSegmentNumberByScaledTime(subsegments, st);
+    if(number == std::numeric_limits<uint64_t>::max())
+        return false;
+
+    /* Start from the closest access point, so that decoding can start with
+       the first fetched subsegment instead of waiting for the next one */
+    for(uint64_t i = number + 1; i-- > 0;)
+    {
+        const Segment *seg = subsegments[i];
+        if(seg->accessPointOffset >= 0 &&
+           seg->startTime.Get() + seg->accessPointOffset <= st)
+        {
+            number = i;
+            break;
+        }
+    }
+
+    *ret = number;
+    return true;
 }
 
 bool SegmentBase::getPlaybackTimeDurationBySegmentNumber(uint64_t number,
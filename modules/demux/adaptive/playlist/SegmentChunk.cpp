@@ -55,13 +55,12 @@ bool SegmentChunk::decrypt(block_t **pp_block)
     if(encryptionSession)
     {
         bool b_last = !hasMoreData();
-        p_block->i_buffer = encryptionSession->decrypt(p_block->p_buffer,
-                                                       p_block->i_buffer, b_last);
+        *pp_block = encryptionSession->decrypt(p_block, b_last);
         if(b_last)
             encryptionSession->close();
     }
 
-    return true;
+    return *pp_block != nullptr;
 }
 
 void SegmentChunk::onDownload(block_t **pp_block)
@@ -253,13 +253,15 @@ void SegmentInformation::setSegmentTemplate(SegmentTemplate *templ)
 }
 
 static void insertIntoSegment(Segment *container, size_t start,
-                              size_t end, stime_t time, stime_t duration)
+                              size_t end, stime_t time, stime_t duration,
+                              stime_t accesspoint)
 {
     if(end == 0 || container->contains(end))
     {
         SubSegment *subsegment = new SubSegment(container, start, (end != 0) ? end : 0);
         subsegment->startTime.Set(time);
         subsegment->duration.Set(duration);
+        subsegment->accessPointOffset = accesspoint;
         container->addSubSegment(subsegment);
     }
 }
@@ -272,6 +274,7 @@ void SegmentInformation::SplitUsingIndex(std::vector<SplitPoint> &splitlist)
 
     size_t prevstart = 0;
     stime_t prevtime = 0;
+    stime_t prevaccesspoint = 0;
 
     SplitPoint split = {0,0,0};
     std::vector<SplitPoint>::const_iterator splitIt;
@@ -281,19 +284,23 @@ void SegmentInformation::SplitUsingIndex(std::vector<SplitPoint> &splitlist)
         if(splitIt != splitlist.begin())
         {
             /* do previous splitpoint */
-            insertIntoSegment(segmentBase, prevstart, split.offset - 1, prevtime, split.duration);
+            insertIntoSegment(segmentBase, prevstart, split.offset - 1, prevtime,
+                              split.duration, prevaccesspoint);
         }
         prevstart = split.offset;
         prevtime = split.time;
+        prevaccesspoint = split.accesspoint;
     }
 
     if(splitlist.size() == 1)
     {
-        insertIntoSegment(segmentBase, prevstart, 0, prevtime, split.duration);
+        insertIntoSegment(segmentBase, prevstart, 0, prevtime,
+                          split.duration, prevaccesspoint);
     }
     else if(splitlist.size() > 1)
     {
-        insertIntoSegment(segmentBase, prevstart, split.offset - 1, prevtime, split.duration);
+        insertIntoSegment(segmentBase, prevstart, split.offset - 1, prevtime,
+                          split.duration, prevaccesspoint);
     }
 }
 
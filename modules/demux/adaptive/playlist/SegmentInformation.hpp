@@ -64,6 +64,7 @@ namespace adaptive
                         size_t offset;
                         stime_t time;
                         stime_t duration;
+                        stime_t accesspoint = 0; /* -1 if none */
                 };
                 void SplitUsingIndex(std::vector<SplitPoint>&);
 
@@ -101,6 +101,14 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
 
     b_restamp = b_relative_mediatimes;
 
+    /* last segment was still being produced, and is replaced by the update */
+    if(b_restamp && !segments.empty() && segments.back()->isIncomplete())
+    {
+        totalLength -= segments.back()->duration.Get();
+        delete segments.back();
+        segments.pop_back();
+    }
+
     if(!b_restamp || segments.empty())
     {
         if(!segments.empty())
@@ -114,6 +114,14 @@ uint64_t SegmentTemplate::getLiveTemplateNumber(vlc_tick_t playbacktime, bool ab
     return number;
 }
 
+vlc_tick_t SegmentTemplate::getLiveAvailabilityOffset() const
+{
+    /* Chunked segments can be read while they are being produced */
+    if(!inheritAvailabilityTimeComplete())
+        return inheritTimescale().ToTime(inheritDuration());
+    return inheritAvailabilityTimeOffset();
+}
+
 void SegmentTemplate::debug(vlc_object_t *obj, int indent) const
 {
     AbstractSegmentBaseType::debug(obj, indent);
@@ -135,7 +143,8 @@ vlc_tick_t SegmentTemplate::getMinAheadTime(uint64_t number) const
     else
     {
         const Timescale timescale = inheritTimescale();
-        uint64_t current = getLiveTemplateNumber(vlc_tick_from_sec(time(nullptr)));
+        uint64_t current = getLiveTemplateNumber(vlc_tick_from_sec(time(nullptr)) +
+                                                 getLiveAvailabilityOffset());
         stime_t i_length = (current - number) * inheritDuration();
         return timescale.ToTime(i_length);
     }
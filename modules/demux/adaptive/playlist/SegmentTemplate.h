@@ -55,6 +55,8 @@ namespace adaptive
                 virtual ~SegmentTemplate();
                 void setSourceUrl( const std::string &url );
                 uint64_t getLiveTemplateNumber(vlc_tick_t, bool = true) const;
+                /* Advance on wall clock for the segments availability */
+                vlc_tick_t getLiveAvailabilityOffset() const;
                 void pruneByPlaybackTime(vlc_tick_t);
                 size_t pruneBySequenceNumber(uint64_t);
 
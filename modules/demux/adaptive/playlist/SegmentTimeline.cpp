@@ -224,14 +224,21 @@ void SegmentTimeline::updateWith(SegmentTimeline &other)
 {
     if(elements.empty())
     {
-        while(other.elements.size())
-        {
-            elements.push_back(other.elements.front());
-            other.elements.pop_front();
-        }
+        elements.swap(other.elements);
+        totalLength = other.totalLength;
+        other.totalLength = 0;
         return;
     }
 
+    /* Drop what went out of the updated window */
+    if(!other.elements.empty())
+    {
+        const Element *back = elements.back();
+        const stime_t start = other.elements.front()->t;
+        if(start > elements.front()->t && start < back->t + back->d * (stime_t)(back->r + 1))
+            pruneBySequenceNumber(getElementNumberByScaledPlaybackTime(start));
+    }
+
     Element *last = elements.back();
     while(other.elements.size())
     {
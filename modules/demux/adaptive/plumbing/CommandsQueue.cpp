@@ -43,6 +43,112 @@ enum
     ES_OUT_PRIVATE_COMMAND_PROGRESS,
 };
 
+namespace
+{
+    /* Free lists of released commands, by size class, as commands are
+     * created and destroyed for every block and PCR of every stream */
+    class CommandsPool
+    {
+        public:
+            static CommandsPool & get()
+            {
+                static CommandsPool pool;
+                return pool;
+            }
+
+            void * alloc( std::size_t size )
+            {
+                if( size > GRANULARITY * CLASSES )
+                    return ::operator new( size, std::nothrow );
+                unsigned index = (size - 1) / GRANULARITY;
+                {
+                    vlc_mutex_locker locker( &lock );
+                    FreeCommand *cmd = lists[index];
+                    if( cmd )
+                    {
+                        lists[index] = cmd->next;
+                        counts[index]--;
+                        return cmd;
+                    }
+                }
+                return ::operator new( (index + 1) * GRANULARITY, std::nothrow );
+            }
+
+            void release( void *p, std::size_t size )
+            {
+                if( size <= GRANULARITY * CLASSES )
+                {
+                    unsigned index = (size - 1) / GRANULARITY;
+                    vlc_mutex_locker locker( &lock );
+                    if( counts[index] < MAX_FREE )
+                    {
+                        FreeCommand *cmd = static_cast<FreeCommand *>(p);
+                        cmd->next = lists[index];
+                        lists[index] = cmd;
+                        counts[index]++;
+                        return;
+                    }
+                }
+                ::operator delete( p );
+            }
+
+        private:
+            static const std::size_t GRANULARITY = 16;
+            static const unsigned CLASSES = 8;
+            static const unsigned MAX_FREE = 512;
+
+            struct FreeCommand
+            {
+                FreeCommand *next;
+            };
+
+            CommandsPool()
+            {
+                vlc_mutex_init( &lock );
+                for( unsigned i = 0; i < CLASSES; i++ )
+                {
+                    lists[i] = nullptr;
+                    counts[i] = 0;
+                }
+            }
+
+            ~CommandsPool()
+            {
+                for( unsigned i = 0; i < CLASSES; i++ )
+                {
+                    while( lists[i] )
+                    {
+                        FreeCommand *next = lists[i]->next;
+                        ::operator delete( lists[i] );
+                        lists[i] = next;
+                    }
+                }
+            }
+
+            vlc_mutex_t lock;
+            FreeCommand *lists[CLASSES];
+            unsigned counts[CLASSES];
+    };
+}
+
+void * AbstractCommand::operator new( std::size_t size )
+{
+    void *p = CommandsPool::get().alloc( size );
+    if( !p )
+        throw std::bad_alloc();
+    return p;
+}
+
+void * AbstractCommand::operator new( std::size_t size, const std::nothrow_t & ) noexcept
+{
+    return CommandsPool::get().alloc( size );
+}
+
+void AbstractCommand::operator delete( void *p, std::size_t size )
+{
+    CommandsPool::get().release( p, size );
+}
+
 AbstractCommand::AbstractCommand( int type_ )
 {
     type = type_;
@@ -63,6 +169,11 @@ int AbstractCommand::getType() const
     return type;
 }
 
+const void * AbstractCommand::esIdentifier() const
+{
+    return nullptr;
+}
+
 AbstractFakeEsCommand::AbstractFakeEsCommand( int type, AbstractFakeESOutID *p_es ) :
     AbstractCommand( type )
 {
@@ -310,6 +421,7 @@ CommandsQueue::CommandsQueue()
 {
     bufferinglevel = Times();
     nextsequence = 0;
+    lastrun = 0;
 }
 
 CommandsQueue::~CommandsQueue()
@@ -362,7 +474,23 @@ void CommandsQueue::Schedule( AbstractCommand *command, EsType )
     }
     else
     {
-        incoming.push_back( Queueentry(nextsequence++, command) );
+        /* Most of the time, the same ES sends several blocks in a row */
+        const void *id = command->esIdentifier();
+        if( lastrun >= incoming.size() || incoming[lastrun].id != id )
+        {
+            lastrun = 0;
+            while( lastrun < incoming.size() && incoming[lastrun].id != id )
+                lastrun++;
+            if( lastrun == incoming.size() )
+                incoming.push_back( IncomingRun{id, {}, true} );
+        }
+
+        IncomingRun &run = incoming[lastrun];
+        Queueentry entry( nextsequence++, command );
+        if( run.b_sorted && !run.entries.empty() &&
+            compareCommands( entry, run.entries.back() ) )
+            run.b_sorted = false;
+        run.entries.push_back( entry );
     }
 }
 
@@ -461,9 +589,27 @@ Times CommandsQueue::Process( Times barrier )
 
 void CommandsQueue::LockedCommit()
 {
-    /* reorder all blocks by time between 2 PCR and merge with main list */
-    incoming.sort( compareCommands );
-    commands.splice( commands.end(), incoming );
+    /* reorder all blocks by time between 2 PCR and merge with main list.
+     * Each ES is already in order unless its timestamps went back, so only
+     * the runs need merging. */
+    std::list<Queueentry> merged;
+    for( IncomingRun &run : incoming )
+    {
+        if( !run.b_sorted )
+        {
+            run.entries.sort( compareCommands );
+            run.b_sorted = true;
+        }
+        merged.merge( run.entries, compareCommands );
+    }
+    commands.splice( commands.end(), merged );
+
+    /* ES come and go, don't keep their runs forever */
+    if( incoming.size() > 8 )
+    {
+        incoming.clear();
+        lastrun = 0;
+    }
 }
 
 void CommandsQueue::Commit()
@@ -473,7 +619,10 @@ void CommandsQueue::Commit()
 
 void CommandsQueue::Abort( bool b_reset )
 {
-    commands.splice( commands.end(), incoming );
+    for( IncomingRun &run : incoming )
+        commands.splice( commands.end(), run.entries );
+    incoming.clear();
+    lastrun = 0;
     while( !commands.empty() )
     {
         delete commands.front().second;
@@ -492,7 +641,12 @@ void CommandsQueue::Abort( bool b_reset )
 
 bool CommandsQueue::isEmpty() const
 {
-    return commands.empty() && incoming.empty();
+    if( !commands.empty() )
+        return false;
+    for( const IncomingRun &run : incoming )
+        if( !run.entries.empty() )
+            return false;
+    return true;
 }
 
 void CommandsQueue::setDraining()
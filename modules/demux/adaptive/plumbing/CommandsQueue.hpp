@@ -28,6 +28,8 @@
 
 #include <atomic>
 #include <list>
+#include <new>
+#include <vector>
 
 namespace adaptive
 {
@@ -41,6 +43,12 @@ namespace adaptive
             virtual void Execute( ) = 0;
             virtual const Times & getTimes() const;
             int getType() const;
+            virtual const void * esIdentifier() const;
+
+            /* Commands are recycled through a shared pool */
+            static void * operator new( std::size_t );
+            static void * operator new( std::size_t, const std::nothrow_t & ) noexcept;
+            static void operator delete( void *, std::size_t );
 
         protected:
             AbstractCommand( int );
@@ -51,7 +59,7 @@ namespace adaptive
     class AbstractFakeEsCommand : public AbstractCommand
     {
         public:
-            const void * esIdentifier() const;
+            virtual const void * esIdentifier() const override;
 
         protected:
             AbstractFakeEsCommand( int, AbstractFakeESOutID * );
@@ -227,7 +235,17 @@ namespace adaptive
         private:
             void LockedCommit();
             void LockedSetDraining();
-            std::list<Queueentry> incoming;
+            /* Commands scheduled since the last commit, one run per ES in
+             * scheduling order, merged by time on commit */
+            class IncomingRun
+            {
+                public:
+                    const void *id;
+                    std::list<Queueentry> entries;
+                    bool b_sorted;
+            };
+            std::vector<IncomingRun> incoming;
+            size_t lastrun;
             std::list<Queueentry> commands;
             SegmentTimes bufferinglevel_media;
             Times bufferinglevel;
@@ -188,6 +188,8 @@ class SegmentTrackerListener : public SegmentTrackerListenerInterface
                     positionchanged.resumeTime = e->resumeTime;
                 }
                     break;
+                case TrackerEvent::Type::SegmentGap:
+                    break;
                 default:
                     return;
             }
@@ -731,6 +733,128 @@ static int SegmentTracker_check_HLSseeks(BaseAdaptationSet *adaptSet,
     return 0;
 }
 
+/****** check partial segments ******/
+static int SegmentTracker_check_parts(BaseAdaptationSet *adaptSet,
+                                      DummyLogic *,
+                                      SegmentTracker *tracker,
+                                      SegmentTrackerListener &events)
+{
+    const stime_t START = 1337;
+    Timescale timescale(100);
+
+    ChunkInterface *currentChunk = nullptr;
+    try
+    {
+        DummyRepresentation *rep0 = new DummyRepresentation(adaptSet);
+        adaptSet->addRepresentation(rep0);
+        rep0->setID(ID("0"));
+
+        SegmentList *segmentList = nullptr;
+        Segment *incomplete = nullptr;
+        try
+        {
+            segmentList = new SegmentList(rep0);
+            segmentList->addAttribute(new TimescaleAttr(timescale));
+            for(int i=0; i<3; i++)
+            {
+                Segment *seg = new Segment(rep0);
+                seg->setSequenceNumber(123 + i);
+                seg->startTime.Set(START + 100 * i);
+                seg->duration.Set(i < 2 ? 100 : 80);
+                seg->setSourceUrl("sample/aac");
+                segmentList->addSegment(seg);
+                incomplete = seg;
+            }
+            /* last one is being produced */
+            incomplete->setIncomplete(true);
+            for(int i=0; i<2; i++)
+            {
+                Segment *part = new Segment(rep0);
+                part->setSequenceNumber(125);
+                part->duration.Set(40);
+                part->setSourceUrl("sample/aac");
+                incomplete->addPart(part);
+            }
+        } catch (...) {
+            delete segmentList;
+            std::rethrow_exception(std::current_exception());
+        }
+        rep0->addAttribute(segmentList);
+
+        Expect(tracker->setStartPosition() == true);
+        for(int i=0; i<2; i++)
+        {
+            currentChunk = tracker->getNextChunk(true);
+            Expect(currentChunk);
+            delete currentChunk;
+            currentChunk = nullptr;
+        }
+
+        /* read by parts */
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 200) + VLC_TICK_0);
+        Expect(events.segmentchanged.duration == timescale.ToTime(40));
+        Expect(events.occured(TrackerEvent::Type::SegmentGap) == false);
+        Expect(tracker->getMinAheadTime() == timescale.ToTime(40));
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 240) + VLC_TICK_0);
+        Expect(tracker->getMinAheadTime() == 0);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* no more published parts */
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk == nullptr);
+
+        /* following update */
+        Segment *part = new Segment(rep0);
+        part->setSequenceNumber(125);
+        part->duration.Set(20);
+        part->setSourceUrl("sample/aac");
+        incomplete->addPart(part);
+
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 280) + VLC_TICK_0);
+        Expect(events.segmentchanged.duration == timescale.ToTime(20));
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* segment completed, continue with next whole segment */
+        incomplete->setIncomplete(false);
+        incomplete->duration.Set(100);
+        Segment *seg = new Segment(rep0);
+        seg->setSequenceNumber(126);
+        seg->startTime.Set(START + 300);
+        seg->duration.Set(100);
+        seg->setSourceUrl("sample/aac");
+        segmentList->addSegment(seg);
+
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 300) + VLC_TICK_0);
+        Expect(events.segmentchanged.duration == timescale.ToTime(100));
+        Expect(events.occured(TrackerEvent::Type::SegmentGap) == false);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+    } catch( ... ) {
+        delete currentChunk;
+        return 1;
+    }
+
+    return 0;
+}
+
 typedef decltype(SegmentTracker_check_formats) testfunc;
 
 static int Prepare_test(testfunc func)
@@ -786,5 +910,6 @@ int SegmentTracker_test()
         Prepare_test(SegmentTracker_check_seeks) ||
         Prepare_test(SegmentTracker_check_switches) ||
         Prepare_test(SegmentTracker_check_HLSseeks) ||
+        Prepare_test(SegmentTracker_check_parts) ||
         0;
 }
@@ -0,0 +1,138 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/SegmentCache.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#include <cstring>
+
+using namespace adaptive::http;
+
+static block_t * makeBlock(size_t size, uint8_t val)
+{
+    block_t *b = block_Alloc(size);
+    if(b)
+        memset(b->p_buffer, val, size);
+    return b;
+}
+
+int SegmentCache_test()
+{
+    SegmentCache cache(100);
+    bool owner;
+
+    try
+    {
+        /* first request owns the download, next ones share it */
+        std::shared_ptr<SegmentCacheEntry> entry = cache.get("0@a", &owner);
+        Expect(owner);
+        std::shared_ptr<SegmentCacheEntry> other = cache.get("0@a", &owner);
+        Expect(!owner);
+        Expect(other == entry);
+        Expect(cache.get("0@b", &owner) != entry);
+        Expect(owner);
+        cache.finish(cache.get("0@b", &owner), SegmentCacheEntry::State::Aborted,
+                     RequestStatus::Success);
+
+        entry->append(makeBlock(10, 1));
+        entry->append(makeBlock(20, 2));
+
+        SegmentCacheEntry::Cursor cursor;
+        SegmentCacheEntry::State state;
+        block_t *b = entry->read(cursor, 0, &state);
+        Expect(b);
+        Expect(b->i_buffer == 10);
+        Expect(b->p_buffer[0] == 1);
+        Expect(state == SegmentCacheEntry::State::Pending);
+        block_Release(b);
+
+        b = entry->read(cursor, 15, &state);
+        Expect(b);
+        Expect(b->i_buffer == 15);
+        Expect(b->p_buffer[14] == 2);
+        block_Release(b);
+        Expect(cursor.getPosition() == 25);
+
+        entry->append(makeBlock(30, 3));
+        cache.finish(entry, SegmentCacheEntry::State::Done, RequestStatus::Success);
+        Expect(cache.getUsage() == 60);
+
+        /* read across blocks, final state comes with the last data */
+        b = entry->read(cursor, 100, &state);
+        Expect(b);
+        Expect(b->i_buffer == 35);
+        Expect(b->p_buffer[0] == 2);
+        Expect(b->p_buffer[34] == 3);
+        Expect(state == SegmentCacheEntry::State::Done);
+        block_Release(b);
+        Expect(entry->read(cursor, 0, &state) == nullptr);
+
+        /* aborted downloads are not kept */
+        Expect(cache.get("0@b", &owner));
+        Expect(owner);
+
+        /* failed downloads are not kept */
+        std::shared_ptr<SegmentCacheEntry> failed = cache.get("0@c", &owner);
+        Expect(owner);
+        cache.finish(failed, SegmentCacheEntry::State::Failed, RequestStatus::NotFound);
+        Expect(failed->getRequestStatus() == RequestStatus::NotFound);
+        Expect(cache.getUsage() == 60);
+        cache.get("0@c", &owner);
+        Expect(owner);
+
+        /* least recently used goes first */
+        std::shared_ptr<SegmentCacheEntry> big = cache.get("0@d", &owner);
+        big->append(makeBlock(50, 4));
+        cache.finish(big, SegmentCacheEntry::State::Done, RequestStatus::Success);
+        Expect(cache.getUsage() == 50);
+        cache.get("0@d", &owner);
+        Expect(!owner);
+        cache.get("0@a", &owner);
+        Expect(owner);
+        /* readers still hold evicted content */
+        Expect(entry->getSize() == 60);
+
+        /* downloaded data is referenced, not copied */
+        std::shared_ptr<SegmentCacheEntry> shared = cache.get("0@e", &owner);
+        Expect(owner);
+        block_t *data = makeBlock(40, 5);
+        b = shared->share(data);
+        Expect(b);
+        Expect(b->p_buffer == data->p_buffer);
+        Expect(shared->getSize() == 40);
+        cache.finish(shared, SegmentCacheEntry::State::Done, RequestStatus::Success);
+        Expect(cache.getUsage() == 90);
+        shared.reset();
+        Expect(b->p_buffer[39] == 5);
+        block_Release(b);
+    }
+    catch(...)
+    {
+        return 1;
+    }
+
+    return 0;
+}
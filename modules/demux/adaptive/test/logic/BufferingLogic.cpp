@@ -163,6 +163,32 @@ int BufferingLogic_test()
         Expect(bufferinglogic.getStartSegmentNumber(rep) >=
                22 + DefaultBufferingLogic::SAFETY_EXPURGING_OFFSET);
 
+        /* Latency control */
+        const vlc_tick_t target = DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT + VLC_TICK_FROM_SEC(1);
+        const vlc_tick_t second = VLC_TICK_FROM_SEC(1);
+        playlist->b_live = true;
+        playlist->b_lowlatency = true;
+        Expect(bufferinglogic.getLatencyCorrection(playlist, target * 2, second) == 0);
+        playlist->targetLatency.Set(target);
+        Expect(bufferinglogic.getLiveDelay(playlist) == target);
+        Expect(bufferinglogic.getLatencyCorrection(playlist, target +
+                                    DefaultBufferingLogic::LATENCY_TOLERANCE, second) == 0);
+        vlc_tick_t shift = bufferinglogic.getLatencyCorrection(playlist, target * 2, second);
+        Expect(shift < 0);
+        Expect(shift >= -second * (DefaultBufferingLogic::DEFAULT_MAX_PLAYBACK_RATE - 1) - 1);
+        shift = bufferinglogic.getLatencyCorrection(playlist, target / 2, second);
+        Expect(shift > 0);
+        Expect(shift <= second * (1 - DefaultBufferingLogic::DEFAULT_MIN_PLAYBACK_RATE) + 1);
+        /* out of range uses the rate bounds, without overshooting */
+        playlist->maxPlaybackRate.Set(1.5f);
+        playlist->maxLatency.Set(target + VLC_TICK_FROM_MS(150));
+        shift = bufferinglogic.getLatencyCorrection(playlist, target * 2, second);
+        Expect(shift == -second / 2);
+        shift = bufferinglogic.getLatencyCorrection(playlist, target + VLC_TICK_FROM_MS(200), second);
+        Expect(shift == -(VLC_TICK_FROM_MS(200) - DefaultBufferingLogic::LATENCY_TOLERANCE));
+        playlist->b_live = false;
+        Expect(bufferinglogic.getLatencyCorrection(playlist, target * 2, second) == 0);
+
         delete playlist;
     } catch(...) {
         delete playlist;
@@ -0,0 +1,135 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../playlist/BasePlaylist.hpp"
+#include "../../playlist/BasePeriod.h"
+#include "../../playlist/BaseAdaptationSet.h"
+#include "../../playlist/BaseRepresentation.h"
+#include "../../logic/HybridAdaptationLogic.hpp"
+
+#include "../test.hpp"
+
+using namespace adaptive;
+using namespace adaptive::playlist;
+using namespace adaptive::logic;
+
+static int Estimator_test()
+{
+    ThroughputEstimator estimator;
+    Expect(estimator.get() == 0);
+
+    /* 10 Mbps */
+    for(int i = 0; i < 20; i++)
+        estimator.push(125000, VLC_TICK_FROM_MS(100));
+    Expect(estimator.get() > 9900000 && estimator.get() < 10100000);
+
+    /* waiting for data does not lower the estimate */
+    estimator.push(1000, VLC_TICK_FROM_MS(500));
+    Expect(estimator.getIdleCount() == 1);
+    Expect(estimator.get() > 9900000);
+
+    /* but a lasting lower rate does */
+    for(unsigned i = 0; i < ThroughputEstimator::MAX_IDLE_SAMPLES * 4; i++)
+        estimator.push(12500, VLC_TICK_FROM_MS(100));
+    Expect(estimator.getIdleCount() == ThroughputEstimator::MAX_IDLE_SAMPLES);
+    Expect(estimator.get() < 5000000);
+
+    return 0;
+}
+
+int HybridAdaptationLogic_test()
+{
+    if(Estimator_test())
+        return 1;
+
+    BasePlaylist *playlist = nullptr;
+    try
+    {
+        playlist = new BasePlaylist(nullptr);
+        BasePeriod *period = new BasePeriod(playlist);
+        playlist->addPeriod(period);
+        BaseAdaptationSet *set = new BaseAdaptationSet(period);
+        set->setID(ID(1));
+        period->addAdaptationSet(set);
+        BaseRepresentation *reps[3];
+        for(int i = 0; i < 3; i++)
+        {
+            reps[i] = new BaseRepresentation(set);
+            reps[i]->setID(ID(std::to_string(i)));
+            reps[i]->setBandwidth(1000000 << i);
+            set->addRepresentation(reps[i]);
+        }
+
+        HybridAdaptationLogic logic(nullptr);
+
+        /* unknown stream */
+        Expect(logic.getNextRepresentation(set, nullptr) == reps[0]);
+
+        logic.trackerEvent(BufferingStateUpdatedEvent(set->getID(), true));
+        Expect(logic.getNextRepresentation(set, nullptr) == reps[0]);
+
+        /* throughput based start */
+        for(int i = 0; i < 20; i++)
+            logic.updateDownloadProgress(set->getID(), 31250, VLC_TICK_FROM_MS(100));
+        logic.updateDownloadRate(set->getID(), 31250 * 20, VLC_TICK_FROM_SEC(2), 0);
+        Expect(logic.getNextRepresentation(set, nullptr) == reps[1]);
+
+        /* a short transfer stalled by the server does not switch down */
+        logic.trackerEvent(RepresentationSwitchEvent(nullptr, reps[1]));
+        logic.updateDownloadProgress(set->getID(), 2000, VLC_TICK_FROM_MS(400));
+        Expect(logic.getNextRepresentation(set, reps[1]) == reps[1]);
+
+        /* full buffer is BOLA, but capped by the throughput */
+        logic.trackerEvent(BufferingLevelChangedEvent(set->getID(), VLC_TICK_FROM_SEC(6),
+                                                      VLC_TICK_FROM_SEC(30), VLC_TICK_FROM_SEC(30),
+                                                      VLC_TICK_FROM_SEC(30)));
+        Expect(logic.getNextRepresentation(set, reps[1]) == reps[1]);
+        for(int i = 0; i < 40; i++)
+            logic.updateDownloadProgress(set->getID(), 125000, VLC_TICK_FROM_MS(100));
+        Expect(logic.getNextRepresentation(set, reps[1]) == reps[2]);
+
+        /* switch statistics */
+        RepresentationSwitchStats stats;
+        Expect(!logic.getSwitchStats(reps[2]->getID(), &stats));
+        logic.trackerEvent(RepresentationSwitchEvent(reps[1], reps[2]));
+        logic.trackerEvent(RepresentationSwitchEvent(reps[2], reps[0]));
+        logic.trackerEvent(RepresentationSwitchEvent(reps[0], reps[2]));
+        Expect(logic.getSwitchStats(reps[2]->getID(), &stats));
+        Expect(stats.selections == 2);
+        Expect(stats.upswitches == 2);
+        Expect(stats.downswitches == 0);
+        Expect(logic.getSwitchStats(reps[0]->getID(), &stats));
+        Expect(stats.selections == 1);
+        Expect(stats.downswitches == 1);
+        Expect(logic.getSwitchStats(reps[1]->getID(), &stats));
+        Expect(stats.selections == 1);
+        Expect(stats.upswitches == 0);
+
+        delete playlist;
+    } catch(...) {
+        delete playlist;
+        return 1;
+    }
+
+    return 0;
+}
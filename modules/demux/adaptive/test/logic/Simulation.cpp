@@ -0,0 +1,370 @@
+/*****************************************************************************
+ * Simulation.cpp: adaptation logic network simulation bench
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Plays a session of fixed duration segments against each adaptation logic,
+ * over a simulated link following a bandwidth trace, with request latency
+ * and packet loss. The downloads report their progress and rate the same
+ * way the HTTP chunks do, and the buffering level is notified after each
+ * segment like the streams do. One JSON object per trace and logic gives
+ * the startup time, the rebuffering ratio, the average bitrate and the
+ * count of switches.
+ *
+ * Traces are text files with one bandwidth sample per line, in kbit/s, for
+ * each second of the session. Lines starting with # are ignored.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../playlist/BasePlaylist.hpp"
+#include "../../playlist/BasePeriod.h"
+#include "../../playlist/BaseAdaptationSet.h"
+#include "../../playlist/BaseRepresentation.h"
+#include "../../logic/AlwaysBestAdaptationLogic.h"
+#include "../../logic/AlwaysLowestAdaptationLogic.hpp"
+#include "../../logic/HybridAdaptationLogic.hpp"
+#include "../../logic/NearOptimalAdaptationLogic.hpp"
+#include "../../logic/PredictiveAdaptationLogic.hpp"
+#include "../../logic/RateBasedAdaptationLogic.h"
+#include "../../http/Chunk.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern const char vlc_module_name[] = "adaptive_simulation";
+
+using namespace adaptive;
+using namespace adaptive::http;
+using namespace adaptive::playlist;
+using namespace adaptive::logic;
+
+namespace
+{
+    /* Segments and buffering as in the default buffering logic */
+    const vlc_tick_t SEGMENT_DURATION = VLC_TICK_FROM_SEC(4);
+    const unsigned   SEGMENT_COUNT = 150;
+    const vlc_tick_t MIN_BUFFERING = VLC_TICK_FROM_SEC(6);
+    const vlc_tick_t MAX_BUFFERING = VLC_TICK_FROM_SEC(30);
+
+    const uint64_t LADDER[] = {
+        235000, 375000, 750000, 1750000, 3000000, 5800000,
+    };
+
+    class Random
+    {
+        public:
+            Random(uint32_t seed) : state(seed) {}
+            /* uniform in [0, 1) */
+            double next()
+            {
+                state = state * 1103515245 + 12345;
+                return (state >> 8) / (double)(1 << 24);
+            }
+
+        private:
+            uint32_t state;
+    };
+
+    struct Trace
+    {
+        std::string name;
+        std::vector<double> kbps; /* one sample per second, looped */
+        vlc_tick_t latency;
+        double loss; /* probability for each chunk to be retransmitted */
+    };
+
+    /* Random walk around a mean, with outages */
+    Trace makeTrace(const char *name, double mean, double variation,
+                    double outage, vlc_tick_t latency, double loss,
+                    uint32_t seed)
+    {
+        Trace trace{name, {}, latency, loss};
+        Random rnd(seed);
+        double kbps = mean;
+        for(unsigned i = 0; i < SEGMENT_COUNT * 8; i++)
+        {
+            kbps += (rnd.next() - 0.5) * variation * mean;
+            kbps = std::max(mean * 0.1, std::min(kbps, mean * 2));
+            trace.kbps.push_back(rnd.next() < outage ? mean * 0.05 : kbps);
+        }
+        return trace;
+    }
+
+    bool loadTrace(const char *path, vlc_tick_t latency, double loss,
+                   Trace *trace)
+    {
+        std::ifstream file(path);
+        if(!file)
+            return false;
+
+        trace->name = path;
+        trace->latency = latency;
+        trace->loss = loss;
+        std::string line;
+        while(std::getline(file, line))
+        {
+            if(line.empty() || line[0] == '#')
+                continue;
+            double kbps = std::strtod(line.c_str(), nullptr);
+            if(kbps > 0)
+                trace->kbps.push_back(kbps);
+        }
+        return !trace->kbps.empty();
+    }
+
+    struct Results
+    {
+        vlc_tick_t startup = VLC_TICK_INVALID;
+        vlc_tick_t played = 0;
+        vlc_tick_t stalled = 0;
+        unsigned rebuffers = 0;
+        unsigned switches = 0;
+        uint64_t bits = 0;
+    };
+
+    class Session
+    {
+        public:
+            Session(const Trace &trace_, AbstractAdaptationLogic *logic_,
+                    BaseAdaptationSet *set_)
+                : trace(trace_), logic(logic_), set(set_), rnd(1) {}
+
+            Results run()
+            {
+                BaseRepresentation *rep = nullptr;
+
+                logic->trackerEvent(BufferingStateUpdatedEvent(set->getID(), true));
+                for(unsigned seq = 0; seq < SEGMENT_COUNT; seq++)
+                {
+                    /* The buffering logic stops fetching when full */
+                    if(buffer > MAX_BUFFERING - SEGMENT_DURATION)
+                        elapse(buffer - (MAX_BUFFERING - SEGMENT_DURATION));
+
+                    BaseRepresentation *next = logic->getNextRepresentation(set, rep);
+                    if(next == nullptr)
+                        break;
+                    if(next != rep)
+                    {
+                        logic->trackerEvent(RepresentationSwitchEvent(rep, next));
+                        if(rep != nullptr)
+                            results.switches++;
+                        rep = next;
+                    }
+                    logic->trackerEvent(SegmentChangedEvent(set->getID(), seq,
+                                                            seq * SEGMENT_DURATION,
+                                                            seq * SEGMENT_DURATION,
+                                                            SEGMENT_DURATION));
+
+                    download(rep->getBandwidth() * SEGMENT_DURATION / CLOCK_FREQ / 8);
+                    buffer += SEGMENT_DURATION;
+                    results.bits += rep->getBandwidth() * SEGMENT_DURATION / CLOCK_FREQ;
+
+                    if(!playing && buffer >= MIN_BUFFERING)
+                    {
+                        playing = true;
+                        if(results.startup == VLC_TICK_INVALID)
+                            results.startup = now;
+                    }
+                    logic->trackerEvent(BufferingLevelChangedEvent(set->getID(),
+                                                                   MIN_BUFFERING, MAX_BUFFERING,
+                                                                   buffer, MAX_BUFFERING));
+                }
+                logic->trackerEvent(BufferingStateUpdatedEvent(set->getID(), false));
+                logic->trackerEvent(RepresentationSwitchEvent(rep, nullptr));
+                return results;
+            }
+
+        private:
+            /* Lets time pass, playing the buffer if started */
+            void elapse(vlc_tick_t duration)
+            {
+                now += duration;
+                if(results.startup == VLC_TICK_INVALID)
+                    return;
+                if(!playing)
+                {
+                    results.stalled += duration;
+                    return;
+                }
+                if(buffer >= duration)
+                {
+                    buffer -= duration;
+                    results.played += duration;
+                    return;
+                }
+                /* Ran dry: rebuffering until the minimum level again */
+                results.played += buffer;
+                results.stalled += duration - buffer;
+                results.rebuffers++;
+                buffer = 0;
+                playing = false;
+            }
+
+            /* Time to transfer bytes at the traced bandwidth from now on */
+            vlc_tick_t transfer(size_t bytes) const
+            {
+                vlc_tick_t t = now;
+                double bits = bytes * 8.;
+                for(;;)
+                {
+                    size_t slot = (t / CLOCK_FREQ) % trace.kbps.size();
+                    vlc_tick_t slotEnd = (t / CLOCK_FREQ + 1) * CLOCK_FREQ;
+                    double bps = trace.kbps[slot] * 1000.;
+                    double slotBits = bps * (slotEnd - t) / CLOCK_FREQ;
+                    if(slotBits >= bits)
+                        return t + bits * CLOCK_FREQ / bps - now;
+                    bits -= slotBits;
+                    t = slotEnd;
+                }
+            }
+
+            /* Downloads by chunks, reporting like HTTPChunkBufferedSource */
+            void download(size_t size)
+            {
+                elapse(trace.latency);
+                vlc_tick_t downloadTime = 0;
+
+                for(size_t done = 0; done < size;)
+                {
+                    size_t chunk = std::min(size - done, HTTPChunkSource::CHUNK_SIZE);
+                    vlc_tick_t step = transfer(chunk);
+                    /* A lost packet stalls the transfer for a retransmission */
+                    if(rnd.next() < trace.loss)
+                        step += std::max(VLC_TICK_FROM_MS(200), 2 * trace.latency);
+                    elapse(step);
+                    downloadTime += step;
+                    done += chunk;
+                    logic->updateDownloadProgress(set->getID(), chunk, step);
+                }
+                logic->updateDownloadRate(set->getID(), size,
+                                          downloadTime, trace.latency);
+            }
+
+            const Trace &trace;
+            AbstractAdaptationLogic *logic;
+            BaseAdaptationSet *set;
+            Random rnd;
+            Results results;
+            vlc_tick_t now = 0;
+            vlc_tick_t buffer = 0;
+            bool playing = false;
+    };
+
+    struct LogicFactory
+    {
+        const char *name;
+        std::function<AbstractAdaptationLogic *()> create;
+    };
+
+    const LogicFactory logics[] = {
+        { "lowest",      [] { return new AlwaysLowestAdaptationLogic(nullptr); } },
+        { "best",        [] { return new AlwaysBestAdaptationLogic(nullptr); } },
+        { "rate",        [] { return new RateBasedAdaptationLogic(nullptr); } },
+        { "predictive",  [] { return new PredictiveAdaptationLogic(nullptr); } },
+        { "nearoptimal", [] { return new NearOptimalAdaptationLogic(nullptr); } },
+        { "hybrid",      [] { return new HybridAdaptationLogic(nullptr); } },
+    };
+
+    void report(const Trace &trace, const char *logic, const Results &r)
+    {
+        const vlc_tick_t total = r.played + r.stalled;
+        std::cout << "{\"trace\":\"" << trace.name << "\",\"logic\":\"" << logic
+                  << "\",\"startup_ms\":"
+                  << (r.startup != VLC_TICK_INVALID ? MS_FROM_VLC_TICK(r.startup) : -1)
+                  << ",\"rebuffers\":" << r.rebuffers
+                  << ",\"rebuffer_ratio\":" << (total ? (double) r.stalled / total : 0.)
+                  << ",\"avg_kbps\":" << r.bits / (SEGMENT_COUNT * SEC_FROM_VLC_TICK(SEGMENT_DURATION)) / 1000
+                  << ",\"switches\":" << r.switches << "}" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<Trace> traces;
+    vlc_tick_t latency = VLC_TICK_FROM_MS(50);
+    double loss = 0.;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "-l") && i + 1 < argc)
+            latency = VLC_TICK_FROM_MS(atoi(argv[++i]));
+        else if(!strcmp(argv[i], "-p") && i + 1 < argc)
+            loss = atof(argv[++i]) / 100.;
+        else if(argv[i][0] == '-')
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [-l latency_ms] [-p loss_percent] [trace]..." << std::endl;
+            return 1;
+        }
+        else
+        {
+            Trace trace;
+            if(!loadTrace(argv[i], latency, loss, &trace))
+            {
+                std::cerr << "cannot load trace " << argv[i] << std::endl;
+                return 1;
+            }
+            traces.push_back(trace);
+        }
+    }
+
+    /* Built-in profiles, roughly shaped after mobile and broadband traces */
+    if(traces.empty())
+    {
+        traces.push_back(makeTrace("3g", 1200, 0.4, 0.03, VLC_TICK_FROM_MS(150), 0.02, 1));
+        traces.push_back(makeTrace("lte", 8000, 0.5, 0.01, VLC_TICK_FROM_MS(50), 0.005, 2));
+        traces.push_back(makeTrace("broadband", 4000, 0.1, 0., VLC_TICK_FROM_MS(20), 0.001, 3));
+    }
+
+    std::unique_ptr<BasePlaylist> playlist(new BasePlaylist(nullptr));
+    BasePeriod *period = new BasePeriod(playlist.get());
+    playlist->addPeriod(period);
+    BaseAdaptationSet *set = new BaseAdaptationSet(period);
+    set->setID(ID(1));
+    period->addAdaptationSet(set);
+    for(size_t i = 0; i < ARRAY_SIZE(LADDER); i++)
+    {
+        BaseRepresentation *rep = new BaseRepresentation(set);
+        rep->setID(ID(std::to_string(i)));
+        rep->setBandwidth(LADDER[i]);
+        set->addRepresentation(rep);
+    }
+
+    for(const Trace &trace : traces)
+    {
+        for(const LogicFactory &factory : logics)
+        {
+            std::unique_ptr<AbstractAdaptationLogic> logic(factory.create());
+            Session session(trace, logic.get(), set);
+            report(trace, factory.name, session.run());
+        }
+    }
+
+    return 0;
+}
@@ -545,3 +545,100 @@ int M3U8Playlist_test()
 
     return 0;
 }
+
+int M3U8LowLatency_test()
+{
+    vlc_object_t *obj = static_cast<vlc_object_t*>(nullptr);
+
+    const char manifest0[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-VERSION:6\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=1.5,CAN-SKIP-UNTIL=24.0\n"
+    "#EXT-X-PART-INF:PART-TARGET=0.5\n"
+    "#EXT-X-MEDIA-SEQUENCE:100\n"
+    "#EXT-X-PROGRAM-DATE-TIME:1970-01-01T01:00:00.000+00:00\n"
+    "#EXTINF:4.0,\n"
+    "seg100.mp4\n"
+    "#EXT-X-PART:DURATION=2.0,URI=\"part101.0.mp4\",INDEPENDENT=YES\n"
+    "#EXT-X-PART:DURATION=2.0,URI=\"part101.1.mp4\"\n"
+    "#EXTINF:4.0,\n"
+    "seg101.mp4\n"
+    "#EXT-X-PART:DURATION=0.5,URI=\"part102.mp4\",BYTERANGE=\"1000@0\"\n"
+    "#EXT-X-PART:DURATION=0.5,URI=\"part102.mp4\",BYTERANGE=\"500\"\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"part102.mp4\",BYTERANGE-START=1500,BYTERANGE-LENGTH=500\n";
+
+    M3U8 *m3u = ParseM3U8(obj, manifest0, sizeof(manifest0));
+    try
+    {
+        Expect(m3u);
+        Expect(m3u->isLive());
+        Expect(m3u->isLowLatency());
+        HLSRepresentation *rep = static_cast<HLSRepresentation *>(m3u->getFirstPeriod()->
+                                 getAdaptationSets().front()->getRepresentations().front());
+
+        Segment *seg = rep->getMediaSegment(101);
+        Expect(seg);
+        Expect(!seg->isIncomplete());
+        Expect(seg->getParts().size() == 2);
+        Expect(seg->getParts().front()->getSequenceNumber() == 101);
+
+        /* segment being produced: 2 parts and the hinted one */
+        seg = rep->getMediaSegment(102);
+        Expect(seg);
+        Expect(seg->isIncomplete());
+        Expect(seg->getParts().size() == 3);
+        Expect(seg->getParts().at(1)->getOffset() == 1000);
+        Expect(seg->getParts().at(2)->getOffset() == 1500);
+        Expect(seg->duration.Get() == rep->inheritTimescale().ToScaled(VLC_TICK_FROM_MS(1500)));
+        Expect(seg->getDisplayTime() == VLC_TICK_0 + vlc_tick_from_sec(3600 + 8));
+
+        /* blocking reload for the hinted part, as a delta from the fresh list */
+        const std::string url = rep->getUpdateUrl();
+        Expect(url.find("?_HLS_msn=102&_HLS_part=2&_HLS_skip=YES") != std::string::npos);
+
+        /* delta update */
+        const char delta[] =
+        "#EXTM3U\n"
+        "#EXT-X-TARGETDURATION:4\n"
+        "#EXT-X-VERSION:9\n"
+        "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=1.5,CAN-SKIP-UNTIL=24.0\n"
+        "#EXT-X-PART-INF:PART-TARGET=0.5\n"
+        "#EXT-X-MEDIA-SEQUENCE:100\n"
+        "#EXT-X-SKIP:SKIPPED-SEGMENTS=2\n"
+        "#EXT-X-PROGRAM-DATE-TIME:1970-01-01T01:00:08.000+00:00\n"
+        "#EXTINF:4.0,\n"
+        "seg102.mp4\n"
+        "#EXT-X-PART:DURATION=0.5,URI=\"part103.0.mp4\"\n";
+
+        M3U8Parser parser(nullptr);
+        stream_t *substream = vlc_stream_MemoryNew(obj, (uint8_t *)delta, sizeof(delta), true);
+        Expect(substream);
+        parser.appendSegmentsFromStream(obj, substream, rep);
+        vlc_stream_Delete(substream);
+
+        const SegmentList *list = rep->inheritSegmentList();
+        Expect(list->getSegments().size() == 4);
+        seg = rep->getMediaSegment(100);
+        Expect(seg);
+        Expect(seg->getUrlSegment().toString().find("seg100.mp4") != std::string::npos);
+        Expect(seg->getDisplayTime() == VLC_TICK_0 + vlc_tick_from_sec(3600));
+        seg = rep->getMediaSegment(102);
+        Expect(seg);
+        Expect(!seg->isIncomplete());
+        seg = rep->getMediaSegment(103);
+        Expect(seg);
+        Expect(seg->isIncomplete());
+        Expect(seg->getParts().size() == 1);
+        Expect(rep->getUpdateUrl().find("?_HLS_msn=103&_HLS_part=1") != std::string::npos);
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    return 0;
+}
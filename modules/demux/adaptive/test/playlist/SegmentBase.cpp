@@ -95,6 +95,27 @@ int SegmentBase_test()
 
         delete rep;
 
+        /* Seeking to closest access point */
+        rep = new BaseRepresentation(nullptr);
+        segmentBase = new SegmentBase(nullptr);
+        segmentBase->addAttribute(new TimescaleAttr(timescale));
+        rep->addAttribute(segmentBase);
+        segmentBase->setByteRange(111, 2000);
+        segmentBase->duration.Set(100 * 10);
+        for(int i=0; i<10; i++)
+            splitlist[i].accesspoint = (i % 3) ? -1 : 50;
+        rep->SplitUsingIndex(splitlist);
+        Expect(segmentBase->getSegmentNumberByTime(timescale.ToTime(5 * 100), &number));
+        Expect(number == 3);
+        Expect(segmentBase->getSegmentNumberByTime(timescale.ToTime(6 * 100 + 49), &number));
+        Expect(number == 3);
+        Expect(segmentBase->getSegmentNumberByTime(timescale.ToTime(6 * 100 + 50), &number));
+        Expect(number == 6);
+        Expect(segmentBase->getSegmentNumberByTime(timescale.ToTime(10), &number));
+        Expect(number == 0); /* no previous access point */
+
+        delete rep;
+
     } catch (...) {
         delete rep;
         return 1;
@@ -96,6 +96,21 @@ int SegmentTemplate_test()
         Expect(templ->getLiveTemplateNumber(now + timescale.ToTime(100) * 2 + 1, true) ==
                templ->getStartSegmentNumber() + 1);
 
+        /* early availability, then chunked */
+        Expect(templ->getLiveAvailabilityOffset() == 0);
+        Expect(rep->getLiveEdgeTime(now + timescale.ToTime(250), &time));
+        Expect(time == timescale.ToTime(200));
+        rep->addAttribute(new AvailabilityTimeOffsetAttr(timescale.ToTime(50)));
+        Expect(templ->getLiveAvailabilityOffset() == timescale.ToTime(50));
+        rep->addAttribute(new AvailabilityTimeCompleteAttr(false));
+        Expect(templ->getLiveAvailabilityOffset() == timescale.ToTime(100));
+        Expect(templ->getLiveTemplateNumber(now + timescale.ToTime(250) +
+                                            templ->getLiveAvailabilityOffset(), true) ==
+               templ->getStartSegmentNumber() + 2);
+        Expect(rep->getLiveEdgeTime(now + timescale.ToTime(250), &time));
+        Expect(time == timescale.ToTime(250));
+        rep->replaceAttribute(new AvailabilityTimeCompleteAttr(true));
+
         /* reset */
         pl->availabilityStartTime.Set(0);
         pl->availabilityEndTime.Set(0);
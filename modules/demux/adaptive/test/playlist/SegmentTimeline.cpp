@@ -162,6 +162,9 @@ int Timeline_test()
         timeline2->addElement(4+1, 2, 99-1, START+1000 + 2000 * 2 + 2 * 1);
         timeline->updateWith(*timeline2);
         Expect(timeline->maxElementNumber() == 4+99);
+        /* but prunes what is no longer in the window */
+        Expect(timeline->minElementNumber() == 4+1);
+        Expect(timeline->getTotalLength() == 2 * 99);
 
         delete timeline2;
         timeline2 = new SegmentTimeline(nullptr);
@@ -169,6 +172,21 @@ int Timeline_test()
         timeline2->addElement(4+1, 2, 99-1+10, START+1000 + 2000 * 2 + 2 * 1);
         timeline->updateWith(*timeline2);
         Expect(timeline->maxElementNumber() == 4+99+10);
+        Expect(timeline->minElementNumber() == 4+1);
+        Expect(timeline->getTotalLength() == 2 * (99 + 10));
+
+        /* update of an empty timeline */
+        delete timeline2;
+        timeline2 = new SegmentTimeline(nullptr);
+        timeline2->addElement(1, 1000, 0, START);
+        timeline2->addElement(2, 2000, 1, 0);
+        delete timeline;
+        timeline = new SegmentTimeline(nullptr);
+        timeline->updateWith(*timeline2);
+        Expect(timeline->minElementNumber() == 1);
+        Expect(timeline->maxElementNumber() == 2+1);
+        Expect(timeline->getTotalLength() == 1000 + 2000 * 2);
+        Expect(timeline2->getTotalLength() == 0);
 
         delete timeline;
         delete timeline2;
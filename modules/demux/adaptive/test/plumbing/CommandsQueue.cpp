@@ -304,6 +304,39 @@ int CommandsQueue_test()
         Expect(esout.output.empty());
         queue.Abort(true);
 
+        /* reordering of out of order ES */
+        do
+        {
+            const int order[2][2] = { { 2, 0 }, { 1, 3 } };
+            for(size_t j=0; j<2; j++)
+            {
+                TestEsOutID *id = (j % 2) ? id1 : id0;
+                for(size_t i=0; i<2; i++)
+                {
+                    block_t *data = block_Alloc(0);
+                    Expect(data);
+                    data->i_dts = VLC_TICK_0 + OFFSET + vlc_tick_from_sec(order[j][i]);
+                    cmd = factory.createEsOutSendCommand(id, SegmentTimes(), data);
+                    queue.Schedule(cmd);
+                }
+            }
+            cmd = factory.createEsOutControlPCRCommand(0, SegmentTimes(),
+                                                       VLC_TICK_0 + OFFSET + vlc_tick_from_sec(3));
+            queue.Schedule(cmd);
+            queue.Process(Times(SegmentTimes(), std::numeric_limits<vlc_tick_t>::max()));
+            Expect(esout.output.size() == 4);
+            for(size_t i=0; i<4; i++)
+            {
+                TestEsOutID *id = (i % 2) ? id1 : id0;
+                OutputVal val = esout.output.front();
+                Expect(val.first == id);
+                Expect(val.second->i_dts == VLC_TICK_0 + OFFSET + vlc_tick_from_sec(i));
+                block_Release(val.second);
+                esout.output.pop_front();
+            }
+            queue.Abort(true);
+        } while(0);
+
         /* reordering PCR before PTS */
         for(size_t i=0; i<2; i++)
         {
@@ -46,9 +46,12 @@ int main()
     TEST(Conversions) ||
     TEST(TemplatedUri) ||
     TEST(BufferingLogic) ||
+    TEST(HybridAdaptationLogic) ||
     TEST(CommandsQueue) ||
     TEST(M3U8MasterPlaylist) ||
     TEST(M3U8Playlist) ||
-    TEST(SegmentTracker)
+    TEST(M3U8LowLatency) ||
+    TEST(SegmentTracker) ||
+    TEST(SegmentCache)
     ;
 }
@@ -77,6 +77,14 @@ bool    DOMParser::parse                    (bool b)
     return true;
 }
 
+void DOMParser::setSubNodesHandler(const std::string &name, SubNodesHandler *handler)
+{
+    if(handler)
+        handlers[name] = handler;
+    else
+        handlers.erase(name);
+}
+
 bool DOMParser::reset(stream_t *s)
 {
     stream = s;
@@ -95,6 +103,8 @@ Node* DOMParser::processNode(bool b_strict)
     const char *data;
     int type;
     std::stack<Node *> lifo;
+    /* handler for the children of the current node */
+    SubNodesHandler *handler = nullptr;
 
     while( (type = xml_ReaderNextNode(vlc_reader, &data)) > 0 )
     {
@@ -103,6 +113,18 @@ Node* DOMParser::processNode(bool b_strict)
             case XML_READER_STARTELEM:
             {
                 bool empty = xml_ReaderIsEmptyElement(vlc_reader);
+                if(handler)
+                {
+                    handler->startElement(lifo.top(), data);
+                    const char *attrName, *attrValue;
+                    while((attrName = xml_ReaderNextAttr(vlc_reader, &attrValue)) != nullptr)
+                        handler->attribute(attrName, attrValue);
+                    handler->endElement();
+                    if(!empty) /* no grandchildren */
+                        skipNode();
+                    break;
+                }
+
                 Node *node = new (std::nothrow) Node();
                 if(node)
                 {
@@ -112,6 +134,13 @@ Node* DOMParser::processNode(bool b_strict)
 
                     node->setName(std::string(data));
                     addAttributesToNode(node);
+
+                    if(!handlers.empty() && !empty)
+                    {
+                        auto it = handlers.find(node->getName());
+                        if(it != handlers.end())
+                            handler = (*it).second;
+                    }
                 }
 
                 if(empty && lifo.size() > 1)
@@ -133,6 +162,7 @@ Node* DOMParser::processNode(bool b_strict)
 
                 Node *node = lifo.top();
                 lifo.pop();
+                handler = nullptr;
                 if(lifo.empty())
                     return node;
             }
@@ -156,6 +186,27 @@ Node* DOMParser::processNode(bool b_strict)
     return node;
 }
 
+void DOMParser::skipNode()
+{
+    const char *data;
+    int type;
+    unsigned depth = 1;
+
+    while( (type = xml_ReaderNextNode(vlc_reader, &data)) > 0 )
+    {
+        if(type == XML_READER_STARTELEM)
+        {
+            if(!xml_ReaderIsEmptyElement(vlc_reader))
+                depth++;
+        }
+        else if(type == XML_READER_ENDELEM)
+        {
+            if(--depth == 0)
+                return;
+        }
+    }
+}
+
 void    DOMParser::addAttributesToNode      (Node *node)
 {
     const char *attrValue;
@@ -30,6 +30,9 @@
 
 #include "Node.h"
 
+#include <map>
+#include <string>
+
 namespace adaptive
 {
     namespace xml
@@ -37,6 +40,19 @@ namespace adaptive
         class DOMParser
         {
             public:
+                /* Receives the child elements of a given element, as they
+                 * are read, instead of having them built into the tree.
+                 * Avoids the nodes and attributes allocations for huge
+                 * lists of small leaf elements. */
+                class SubNodesHandler
+                {
+                    public:
+                        virtual ~SubNodesHandler() = default;
+                        virtual void startElement(const Node *parent, const char *name) = 0;
+                        virtual void attribute(const char *name, const char *value) = 0;
+                        virtual void endElement() = 0;
+                };
+
                 DOMParser           ();
                 DOMParser           (stream_t *stream);
                 virtual ~DOMParser  ();
@@ -45,14 +61,17 @@ namespace adaptive
                 bool                reset       (stream_t *);
                 Node*               getRootNode ();
                 void                print       ();
+                void                setSubNodesHandler(const std::string &, SubNodesHandler *);
 
             private:
                 Node                *root;
                 stream_t            *stream;
 
                 xml_reader_t        *vlc_reader;
+                std::map<std::string, SubNodesHandler *> handlers;
 
                 Node*   processNode             (bool);
+                void    skipNode                ();
                 void    addAttributesToNode     (Node *node);
                 void    print                   (Node *node, int offset);
         };
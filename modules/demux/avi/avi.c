@@ -121,24 +121,29 @@ typedef struct
 
 typedef struct
 {
-    vlc_fourcc_t i_id;
-    uint32_t     i_flags;
     uint64_t     i_pos;
     uint32_t     i_length;
-    uint64_t     i_lengthtotal;
+    uint32_t     i_flags;
 
 } avi_entry_t;
 
+/* The cumulated length is only stored once every
+ * (1 << AVI_INDEX_TOTAL_SHIFT) entries, and summed up from there */
+#define AVI_INDEX_TOTAL_SHIFT 4
+
 typedef struct
 {
     uint32_t        i_size;
     uint32_t        i_max;
     avi_entry_t     *p_entry;
+    uint64_t        *p_lengthtotal;
+    uint64_t        i_lengthtotal; /* cumulated length of all entries */
 
 } avi_index_t;
 static void avi_index_Init( avi_index_t * );
 static void avi_index_Clean( avi_index_t * );
 static int64_t avi_index_Append( avi_index_t *, uint64_t *, avi_entry_t * );
+static uint64_t avi_index_LengthTotal( const avi_index_t *, uint32_t );
 
 typedef struct
 {
@@ -810,9 +815,7 @@ aviindex:
             p_auds->p_wf->wFormatTag != WAVE_FORMAT_PCM &&
             tk->i_rate == p_auds->p_wf->nSamplesPerSec )
         {
-            int64_t i_track_length =
-                tk->idx.p_entry[tk->idx.i_size-1].i_length +
-                tk->idx.p_entry[tk->idx.i_size-1].i_lengthtotal;
+            int64_t i_track_length = tk->idx.i_lengthtotal;
             vlc_tick_t i_length = VLC_TICK_FROM_US( p_avih->i_totalframes *
                                                     p_avih->i_microsecperframe );
 
@@ -1205,11 +1208,9 @@ static int Demux_Seekable( demux_t *p_demux )
 
                     /* add this chunk to the index */
                     avi_entry_t index;
-                    index.i_id     = avi_pk.i_fourcc;
                     index.i_flags  = AVI_GetKeyFlag(tk, avi_pk.i_peek);
                     index.i_pos    = avi_pk.i_pos;
                     index.i_length = avi_pk.i_size;
-                    index.i_lengthtotal = index.i_length;
                     int64_t i_indexid = avi_index_Append( &tk->idx, &p_sys->i_movi_lastchunk_pos, &index );
 
                     /* do we will read this data ? */
@@ -1837,14 +1838,12 @@ static vlc_tick_t AVI_GetPTS( avi_track_t *tk )
         /* we need a valid entry we will emulate one */
         if( idx >= tk->idx.i_size )
         {
-            /* use the last entry */
-            idx = tk->idx.i_size - 1;
-            i_count = tk->idx.p_entry[idx].i_lengthtotal
-                    + tk->idx.p_entry[idx].i_length;
+            /* use the end of the last entry */
+            i_count = tk->idx.i_lengthtotal;
         }
         else
         {
-            i_count = tk->idx.p_entry[idx].i_lengthtotal;
+            i_count = avi_index_LengthTotal( &tk->idx, idx );
         }
         return AVI_GetDPTS( tk, i_count + tk->i_idxposb );
     }
@@ -1902,11 +1901,9 @@ static int AVI_StreamChunkFind( demux_t *p_demux, avi_track_t *tk )
 
             /* add this chunk to the index */
             avi_entry_t index;
-            index.i_id     = avi_pk.i_fourcc;
             index.i_flags  = AVI_GetKeyFlag(tk_pk, avi_pk.i_peek);
             index.i_pos    = avi_pk.i_pos;
             index.i_length = avi_pk.i_size;
-            index.i_lengthtotal = index.i_length;
             avi_index_Append( &tk_pk->idx, &p_sys->i_movi_lastchunk_pos, &index );
 
             if( tk_pk == tk )
@@ -1952,8 +1949,7 @@ static int AVI_StreamBytesSet( demux_t    *p_demux,
                                uint64_t  i_byte )
 {
     if( ( p_stream->idx.i_size > 0 )
-        &&( i_byte < p_stream->idx.p_entry[p_stream->idx.i_size - 1].i_lengthtotal +
-                p_stream->idx.p_entry[p_stream->idx.i_size - 1].i_length ) )
+        &&( i_byte < p_stream->idx.i_lengthtotal ) )
     {
         /* index is valid to find the ck */
         /* uses dichototmie to be fast enough */
@@ -1962,15 +1958,15 @@ static int AVI_StreamBytesSet( demux_t    *p_demux,
         int i_idxmin  = 0;
         for( ;; )
         {
-            if( p_stream->idx.p_entry[i_idxposc].i_lengthtotal > i_byte )
+            uint64_t i_total = avi_index_LengthTotal( &p_stream->idx, i_idxposc );
+            if( i_total > i_byte )
             {
                 i_idxmax  = i_idxposc ;
                 i_idxposc = ( i_idxmin + i_idxposc ) / 2 ;
             }
             else
             {
-                if( p_stream->idx.p_entry[i_idxposc].i_lengthtotal +
-                        p_stream->idx.p_entry[i_idxposc].i_length <= i_byte)
+                if( i_total + p_stream->idx.p_entry[i_idxposc].i_length <= i_byte )
                 {
                     i_idxmin  = i_idxposc ;
                     i_idxposc = (i_idxmax + i_idxposc ) / 2 ;
@@ -1978,8 +1974,7 @@ static int AVI_StreamBytesSet( demux_t    *p_demux,
                 else
                 {
                     p_stream->i_idxposc = i_idxposc;
-                    p_stream->i_idxposb = i_byte -
-                            p_stream->idx.p_entry[i_idxposc].i_lengthtotal;
+                    p_stream->i_idxposb = i_byte - i_total;
                     return VLC_SUCCESS;
                 }
             }
@@ -1998,11 +1993,10 @@ static int AVI_StreamBytesSet( demux_t    *p_demux,
                 return VLC_EGENERIC;
             }
 
-        } while( p_stream->idx.p_entry[p_stream->i_idxposc].i_lengthtotal +
-                    p_stream->idx.p_entry[p_stream->i_idxposc].i_length <= i_byte );
+        } while( p_stream->idx.i_lengthtotal <= i_byte );
 
         p_stream->i_idxposb = i_byte -
-                       p_stream->idx.p_entry[p_stream->i_idxposc].i_lengthtotal;
+            avi_index_LengthTotal( &p_stream->idx, p_stream->i_idxposc );
         return VLC_SUCCESS;
     }
 }
@@ -2329,10 +2323,21 @@ static void avi_index_Init( avi_index_t *p_index )
     p_index->i_size  = 0;
     p_index->i_max   = 0;
     p_index->p_entry = NULL;
+    p_index->p_lengthtotal = NULL;
+    p_index->i_lengthtotal = 0;
 }
 static void avi_index_Clean( avi_index_t *p_index )
 {
     free( p_index->p_entry );
+    free( p_index->p_lengthtotal );
+}
+static uint64_t avi_index_LengthTotal( const avi_index_t *p_index, uint32_t i )
+{
+    /* cumulated length of the entries before i */
+    uint64_t i_total = p_index->p_lengthtotal[i >> AVI_INDEX_TOTAL_SHIFT];
+    for( uint32_t j = i & ~((1U << AVI_INDEX_TOTAL_SHIFT) - 1); j < i; j++ )
+        i_total += p_index->p_entry[j].i_length;
+    return i_total;
 }
 #define MAX_INDEX_ENTRIES __MIN(SIZE_MAX/sizeof(avi_entry_t), UINT32_MAX)
 #define INDEX_EXTENT 16384
@@ -2353,25 +2358,27 @@ static int64_t avi_index_Append( avi_index_t *p_index, uint64_t *pi_last_pos,
             p_index->i_max += INDEX_EXTENT;
         else
             p_index->i_max = MAX_INDEX_ENTRIES;
-        p_index->p_entry = realloc_or_free( p_index->p_entry,
-                                            p_index->i_max * sizeof(avi_entry_t) );
-        if( !p_index->p_entry )
-        {
+        avi_entry_t *p_entries = realloc( p_index->p_entry,
+                                          p_index->i_max * sizeof(avi_entry_t) );
+        if( p_entries )
+            p_index->p_entry = p_entries;
+        uint64_t *p_totals = !p_entries ? NULL :
+            realloc( p_index->p_lengthtotal,
+                     (((p_index->i_max - 1) >> AVI_INDEX_TOTAL_SHIFT) + 1) *
+                         sizeof(uint64_t) );
+        if( !p_totals )
+        {
+            avi_index_Clean( p_index );
             avi_index_Init( p_index );
             return -1;
         }
+        p_index->p_lengthtotal = p_totals;
     }
-    /* calculate cumulate length */
-    if( p_index->i_size > 0 )
-    {
-        p_entry->i_lengthtotal =
-            p_index->p_entry[p_index->i_size - 1].i_length +
-                p_index->p_entry[p_index->i_size - 1].i_lengthtotal;
-    }
-    else
-    {
-        p_entry->i_lengthtotal = 0;
-    }
+    /* store the cumulated length at each checkpoint */
+    if( (p_index->i_size & ((1U << AVI_INDEX_TOTAL_SHIFT) - 1)) == 0 )
+        p_index->p_lengthtotal[p_index->i_size >> AVI_INDEX_TOTAL_SHIFT] =
+            p_index->i_lengthtotal;
+    p_index->i_lengthtotal += p_entry->i_length;
 
     p_index->p_entry[p_index->i_size++] = *p_entry;
     return p_index->i_size - 1;
@@ -2466,11 +2473,9 @@ static int AVI_IndexLoad_idx1( demux_t *p_demux,
             (i_cat == p_sys->track[i_stream]->fmt.i_cat || i_cat == UNKNOWN_ES ) )
         {
             avi_entry_t index;
-            index.i_id     = p_idx1->entry[i_index].i_fourcc;
             index.i_flags  = p_idx1->entry[i_index].i_flags&(~AVIIF_FIXKEYFRAME);
             index.i_pos    = p_idx1->entry[i_index].i_pos + i_offset;
             index.i_length = p_idx1->entry[i_index].i_length;
-            index.i_lengthtotal = index.i_length;
 
             avi_index_Append( &p_index[i_stream], pi_last_offset, &index );
         }
@@ -2485,7 +2490,7 @@ static int AVI_IndexLoad_idx1( demux_t *p_demux,
             if( p_sys->track[i_index]->i_samplesize )
             {
                 i_length = AVI_GetDPTS( p_sys->track[i_index],
-                                        p_index[i_index].p_entry[i].i_lengthtotal );
+                                        avi_index_LengthTotal( &p_index[i_index], i ) );
             }
             else
             {
@@ -2512,11 +2517,9 @@ static void __Parse_indx( demux_t *p_demux, avi_index_t *p_index, uint64_t *pi_m
     {
         for( unsigned i = 0; i < p_indx->i_entriesinuse; i++ )
         {
-            index.i_id     = p_indx->i_id;
             index.i_flags  = p_indx->idx.std[i].i_size & 0x80000000 ? 0 : AVIIF_KEYFRAME;
             index.i_pos    = p_indx->i_baseoffset + p_indx->idx.std[i].i_offset - 8;
             index.i_length = p_indx->idx.std[i].i_size&0x7fffffff;
-            index.i_lengthtotal = index.i_length;
 
             avi_index_Append( p_index, pi_max_offset, &index );
         }
@@ -2525,11 +2528,9 @@ static void __Parse_indx( demux_t *p_demux, avi_index_t *p_index, uint64_t *pi_m
     {
         for( unsigned i = 0; i < p_indx->i_entriesinuse; i++ )
         {
-            index.i_id     = p_indx->i_id;
             index.i_flags  = p_indx->idx.field[i].i_size & 0x80000000 ? 0 : AVIIF_KEYFRAME;
             index.i_pos    = p_indx->i_baseoffset + p_indx->idx.field[i].i_offset - 8;
             index.i_length = p_indx->idx.field[i].i_size;
-            index.i_lengthtotal = index.i_length;
 
             avi_index_Append( p_index, pi_max_offset, &index );
         }
@@ -2623,14 +2624,14 @@ static void AVI_IndexLoad( demux_t *p_demux )
         if( p_idx_indx[i].i_size > p_idx_idx1[i].i_size )
         {
             msg_Dbg( p_demux, "selected ODML index for stream[%u]", i );
-            free(p_sys->track[i]->idx.p_entry);
+            avi_index_Clean( &p_sys->track[i]->idx );
             p_sys->track[i]->idx = p_idx_indx[i];
             avi_index_Clean( &p_idx_idx1[i] );
         }
         else
         {
             msg_Dbg( p_demux, "selected standard index for stream[%u]", i );
-            free(p_sys->track[i]->idx.p_entry);
+            avi_index_Clean( &p_sys->track[i]->idx );
             p_sys->track[i]->idx = p_idx_idx1[i];
             avi_index_Clean( &p_idx_indx[i] );
         }
@@ -2727,11 +2728,9 @@ static void AVI_IndexCreate( demux_t *p_demux )
             avi_track_t *tk = p_sys->track[pk.i_stream];
 
             avi_entry_t index;
-            index.i_id      = pk.i_fourcc;
             index.i_flags   = AVI_GetKeyFlag(tk, pk.i_peek);
             index.i_pos     = pk.i_pos;
             index.i_length  = pk.i_size;
-            index.i_lengthtotal = pk.i_size;
             avi_index_Append( &tk->idx, &p_sys->i_movi_lastchunk_pos, &index );
         }
         else
@@ -3084,9 +3083,7 @@ static vlc_tick_t  AVI_MovieGetLength( demux_t *p_demux )
 
         if( tk->i_samplesize )
         {
-            i_length = AVI_GetDPTS( tk,
-                                    tk->idx.p_entry[tk->idx.i_size-1].i_lengthtotal +
-                                        tk->idx.p_entry[tk->idx.i_size-1].i_length );
+            i_length = AVI_GetDPTS( tk, tk->idx.i_lengthtotal );
         }
         else
         {
@@ -105,6 +105,8 @@ bool DASHManager::updatePlaylist()
         }
 
         xml::DOMParser parser(mpdstream);
+        SegmentTimelineHandler timelineHandler;
+        parser.setSubNodesHandler("SegmentTimeline", &timelineHandler);
         if(!parser.parse(true))
         {
             vlc_stream_Delete(mpdstream);
@@ -114,6 +116,7 @@ bool DASHManager::updatePlaylist()
 
         IsoffMainParser mpdparser(parser.getRootNode(), VLC_OBJECT(p_demux),
                                   mpdstream, Helper::getDirectoryPath(url).append("/"));
+        mpdparser.setSegmentTimelineHandler(&timelineHandler);
         MPD *newmpd = mpdparser.parse();
         if(newmpd)
         {
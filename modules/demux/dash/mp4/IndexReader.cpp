@@ -50,8 +50,20 @@ bool IndexReader::parseIndex(block_t *p_block, BaseRepresentation *rep, uint64_t
         point.time = 0;
         if(!sidx->i_timescale)
             return false;
+        /* Only trust the access points flags if some are set */
+        bool b_accesspoints = false;
+        for(uint16_t i=0; i<sidx->i_reference_count; i++)
+            b_accesspoints |= sidx->p_items[i].b_starts_with_SAP ||
+                              sidx->p_items[i].i_SAP_type != 0;
         for(uint16_t i=0; i<sidx->i_reference_count; i++)
         {
+            const MP4_Box_sidx_item_t *item = &sidx->p_items[i];
+            if(!b_accesspoints || item->b_starts_with_SAP)
+                point.accesspoint = 0;
+            else if(item->i_SAP_type != 0)
+                point.accesspoint = item->i_SAP_delta_time;
+            else
+                point.accesspoint = -1;
             splitlist.push_back(point);
             point.offset += sidx->p_items[i].i_referenced_size;
             point.duration = sidx->p_items[i].i_subsegment_duration;
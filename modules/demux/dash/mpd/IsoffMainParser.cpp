@@ -45,6 +45,7 @@
 #include "../../adaptive/tools/Conversions.hpp"
 #include <vlc_stream.h>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 using namespace dash::mpd;
@@ -58,12 +59,18 @@ IsoffMainParser::IsoffMainParser    (Node *root_, vlc_object_t *p_object_,
     p_stream = stream;
     p_object = p_object_;
     playlisturl = streambaseurl_;
+    timelineHandler = nullptr;
 }
 
 IsoffMainParser::~IsoffMainParser   ()
 {
 }
 
+void IsoffMainParser::setSegmentTimelineHandler(const SegmentTimelineHandler *handler)
+{
+    timelineHandler = handler;
+}
+
 template <class T>
 static void parseAvailability(MPD *mpd, Node *node, T *s)
 {
@@ -98,6 +105,7 @@ MPD * IsoffMainParser::parse()
     {
         parseMPDAttributes(mpd, root);
         parseProgramInformation(DOMHelper::getFirstChildElementByName(root, "ProgramInformation"), mpd);
+        parseServiceDescription(DOMHelper::getFirstChildElementByName(root, "ServiceDescription"), mpd);
         parseMPDBaseUrl(mpd, root);
         parsePeriods(mpd, root);
         mpd->addAttribute(new StartnumberAttr(1));
@@ -523,6 +531,23 @@ void IsoffMainParser::parseTimeline(Node *node, AbstractMultipleSegmentBaseType
     SegmentTimeline *timeline = new (std::nothrow) SegmentTimeline(base);
     if(timeline)
     {
+        const std::vector<SegmentTimelineHandler::Element> *streamed =
+                timelineHandler ? timelineHandler->getElements(node) : nullptr;
+        if(streamed)
+        {
+            std::vector<SegmentTimelineHandler::Element>::const_iterator it;
+            for(it = streamed->begin(); it != streamed->end(); ++it)
+            {
+                if(!(*it).has_d) /* Mandatory */
+                    continue;
+                int64_t r = (*it).r;
+                if(r < 0)
+                    r = std::numeric_limits<unsigned>::max();
+                timeline->addElement(number, (*it).d, r, (*it).has_t ? (*it).t : 0);
+                number += (1 + r);
+            }
+        }
+
         std::vector<Node *> elements = DOMHelper::getElementByTagName(node, "S", false);
         std::vector<Node *>::const_iterator it;
         for(it = elements.begin(); it != elements.end(); ++it)
@@ -580,6 +605,36 @@ void IsoffMainParser::parseProgramInformation(Node * node, MPD *mpd)
     }
 }
 
+void IsoffMainParser::parseServiceDescription(Node * node, MPD *mpd)
+{
+    if(!node)
+        return;
+
+    /* Latency values are in milliseconds */
+    Node *child = DOMHelper::getFirstChildElementByName(node, "Latency");
+    if(child)
+    {
+        if(child->hasAttribute("target"))
+            mpd->targetLatency.Set(VLC_TICK_FROM_MS(
+                Integer<uint64_t>(child->getAttributeValue("target"))));
+        if(child->hasAttribute("min"))
+            mpd->minLatency.Set(VLC_TICK_FROM_MS(
+                Integer<uint64_t>(child->getAttributeValue("min"))));
+        if(child->hasAttribute("max"))
+            mpd->maxLatency.Set(VLC_TICK_FROM_MS(
+                Integer<uint64_t>(child->getAttributeValue("max"))));
+    }
+
+    child = DOMHelper::getFirstChildElementByName(node, "PlaybackRate");
+    if(child)
+    {
+        if(child->hasAttribute("min"))
+            mpd->minPlaybackRate.Set(Integer<float>(child->getAttributeValue("min")));
+        if(child->hasAttribute("max"))
+            mpd->maxPlaybackRate.Set(Integer<float>(child->getAttributeValue("max")));
+    }
+}
+
 Profile IsoffMainParser::getProfile() const
 {
     Profile res(Profile::Name::Unknown);
@@ -602,3 +657,67 @@ Profile IsoffMainParser::getProfile() const
 
     return res;
 }
+
+SegmentTimelineHandler::Element::Element()
+{
+    t = d = 0;
+    r = 0;
+    has_t = has_d = false;
+}
+
+SegmentTimelineHandler::SegmentTimelineHandler()
+{
+    current = nullptr;
+}
+
+void SegmentTimelineHandler::startElement(const Node *parent, const char *name)
+{
+    element = Element();
+    if(!strcmp(name, "S"))
+        current = &timelines[parent];
+    else
+        current = nullptr;
+}
+
+void SegmentTimelineHandler::attribute(const char *name, const char *value)
+{
+    if(!current)
+        return;
+    /* not using Integer<>, which is far too slow for that amount of entries */
+    if(!strcmp(name, "d"))
+    {
+        element.d = strtoll(value, nullptr, 10);
+        element.has_d = true;
+    }
+    else if(!strcmp(name, "t"))
+    {
+        element.t = strtoll(value, nullptr, 10);
+        element.has_t = true;
+    }
+    else if(!strcmp(name, "r"))
+    {
+        element.r = strtoll(value, nullptr, 10);
+    }
+}
+
+void SegmentTimelineHandler::endElement()
+{
+    if(current)
+        current->push_back(element);
+    current = nullptr;
+}
+
+const std::vector<SegmentTimelineHandler::Element> *
+SegmentTimelineHandler::getElements(const Node *node) const
+{
+    auto it = timelines.find(node);
+    if(it == timelines.end())
+        return nullptr;
+    return &(*it).second;
+}
+
+void SegmentTimelineHandler::clear()
+{
+    timelines.clear();
+    current = nullptr;
+}
@@ -30,9 +30,12 @@
 #endif
 
 #include "../../adaptive/playlist/SegmentBaseType.hpp"
+#include "../../adaptive/xml/DOMParser.h"
 #include "Profile.hpp"
 
 #include <cstdlib>
+#include <map>
+#include <vector>
 
 #include <vlc_common.h>
 
@@ -45,10 +48,6 @@ namespace adaptive
         class BasePeriod;
         class CommonAttributesElements;
     }
-    namespace xml
-    {
-        class Node;
-    }
 }
 
 namespace dash
@@ -61,6 +60,36 @@ namespace dash
         using namespace adaptive::playlist;
         using namespace adaptive;
 
+        /* Collects the SegmentTimeline S elements while the MPD is read,
+         * so that no DOM is built for them */
+        class SegmentTimelineHandler : public xml::DOMParser::SubNodesHandler
+        {
+            public:
+                class Element
+                {
+                    public:
+                        Element();
+                        stime_t  t;
+                        stime_t  d;
+                        int64_t  r;
+                        bool     has_t;
+                        bool     has_d;
+                };
+
+                SegmentTimelineHandler();
+                virtual ~SegmentTimelineHandler() = default;
+                virtual void startElement(const xml::Node *, const char *) override;
+                virtual void attribute(const char *, const char *) override;
+                virtual void endElement() override;
+                const std::vector<Element> * getElements(const xml::Node *) const;
+                void clear();
+
+            private:
+                std::map<const xml::Node *, std::vector<Element>> timelines;
+                std::vector<Element> *current;
+                Element element;
+        };
+
         class IsoffMainParser
         {
             public:
@@ -68,6 +97,7 @@ namespace dash
                                              stream_t *p_stream, const std::string &);
                 virtual ~IsoffMainParser    ();
                 MPD *   parse();
+                void    setSegmentTimelineHandler(const SegmentTimelineHandler *);
 
             private:
                 mpd::Profile getProfile     () const;
@@ -83,6 +113,7 @@ namespace dash
                 size_t  parseSegmentList    (MPD *, xml::Node *, SegmentInformation *);
                 size_t  parseSegmentTemplate(MPD *, xml::Node *, SegmentInformation *);
                 void    parseProgramInformation(xml::Node *, MPD *);
+                void    parseServiceDescription(xml::Node *, MPD *);
                 void    parseSegmentBaseType(MPD *mpd, xml::Node *node,
                                              AbstractSegmentBaseType *base,
                                              SegmentInformation *parent);
@@ -95,6 +126,7 @@ namespace dash
                 vlc_object_t    *p_object;
                 stream_t        *p_stream;
                 std::string      playlisturl;
+                const SegmentTimelineHandler *timelineHandler;
         };
     }
 }
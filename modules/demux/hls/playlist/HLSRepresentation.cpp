@@ -32,6 +32,7 @@
 
 #include <ctime>
 #include <limits>
+#include <sstream>
 
 using namespace hls;
 using namespace hls::playlist;
@@ -44,6 +45,11 @@ HLSRepresentation::HLSRepresentation  ( BaseAdaptationSet *set ) :
     updateFailureCount = 0;
     lastUpdateTime = 0;
     targetDuration = 0;
+    partTarget = 0;
+    b_canBlockReload = false;
+    canSkipUntil = 0;
+    nextMediaSequence = 0;
+    nextPart = 0;
     streamFormat = StreamFormat::Type::Unknown;
     channels = 0;
 }
@@ -62,6 +68,11 @@ bool HLSRepresentation::isLive() const
     return b_live;
 }
 
+bool HLSRepresentation::isLowLatency() const
+{
+    return b_live && partTarget;
+}
+
 bool HLSRepresentation::initialized() const
 {
     return b_loaded;
@@ -87,6 +98,32 @@ Url HLSRepresentation::getPlaylistUrl() const
     }
 }
 
+std::string HLSRepresentation::getUpdateUrl() const
+{
+    std::string url = getPlaylistUrl().toString();
+    if(!b_loaded || !isLive())
+        return url;
+
+    /* Delivery directives */
+    std::stringstream ss;
+    ss.imbue(std::locale("C"));
+    char sep = (url.find('?') == std::string::npos) ? '?' : '&';
+    if(b_canBlockReload)
+    {
+        /* Request is held by the server until the next segment or part */
+        ss << sep << "_HLS_msn=" << nextMediaSequence;
+        if(partTarget)
+            ss << "&_HLS_part=" << nextPart;
+        sep = '&';
+    }
+    /* Delta update, only while the current playlist is recent enough */
+    if(canSkipUntil && lastUpdateTime &&
+       vlc_tick_now() - lastUpdateTime < canSkipUntil / 2)
+        ss << sep << "_HLS_skip=YES";
+
+    return url.append(ss.str());
+}
+
 void HLSRepresentation::debug(vlc_object_t *obj, int indent) const
 {
     BaseRepresentation::debug(obj, indent);
@@ -138,7 +175,12 @@ bool HLSRepresentation::needsUpdate(uint64_t number) const
                             : VLC_TICK_FROM_SEC(2);
         if(updateFailureCount)
             duration /= 2;
-        if(elapsed < duration)
+        /* Blocking reloads return as soon as the next part or segment
+         * is published, so that we can request them early */
+        vlc_tick_t interval = duration;
+        if(b_canBlockReload && !updateFailureCount)
+            interval = (partTarget ? partTarget : duration) / 2;
+        if(elapsed < interval)
             return false;
 
         if(number == std::numeric_limits<uint64_t>::max())
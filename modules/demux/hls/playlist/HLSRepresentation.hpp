@@ -45,7 +45,9 @@ namespace hls
 
                 void setPlaylistUrl(const std::string &);
                 Url getPlaylistUrl() const;
+                std::string getUpdateUrl() const;
                 bool isLive() const;
+                bool isLowLatency() const;
                 bool initialized() const;
                 virtual void scheduleNextUpdate(uint64_t, bool) override;
                 virtual bool needsUpdate(uint64_t) const override;
@@ -60,6 +62,7 @@ namespace hls
 
             protected:
                 time_t targetDuration;
+                vlc_tick_t partTarget;
                 Url playlistUrl;
 
             private:
@@ -70,6 +73,11 @@ namespace hls
                 unsigned updateFailureCount;
                 vlc_tick_t lastUpdateTime;
                 unsigned channels;
+                /* Server control */
+                bool b_canBlockReload;
+                vlc_tick_t canSkipUntil;
+                uint64_t nextMediaSequence; /* next expected segment and part */
+                unsigned nextPart;
         };
     }
 }
@@ -224,18 +224,14 @@ void M3U8Parser::fillAdaptsetFromMediainfo(const AttributesTag *mediatag,
 
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresentation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUrl().toString());
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getUpdateUrl());
     if(p_block)
     {
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
-            std::list<Tag *> tagslist = parseEntries(substream);
+            appendSegmentsFromStream(p_obj, substream, rep);
             vlc_stream_Delete(substream);
-
-            parseSegments(p_obj, rep, tagslist);
-
-            releaseTagsList(tagslist);
         }
         block_Release(p_block);
         return true;
@@ -243,6 +239,55 @@ bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresent
     return false;
 }
 
+void M3U8Parser::appendSegmentsFromStream(vlc_object_t *p_obj, stream_t *p_stream,
+                                          HLSRepresentation *rep)
+{
+    std::list<Tag *> tagslist = parseEntries(p_stream);
+    parseSegments(p_obj, rep, tagslist);
+    releaseTagsList(tagslist);
+}
+
+HLSSegment * M3U8Parser::createPart(HLSRepresentation *rep, const Attribute *uriAttr,
+                                    const Attribute *byterangeAttr, std::size_t *prevoffset)
+{
+    HLSSegment *part = new (std::nothrow) HLSSegment(rep, 0);
+    if(!part)
+        return nullptr;
+    part->setSourceUrl(uriAttr->quotedString());
+    if(byterangeAttr)
+    {
+        /* offset defaults to the end of the previous part */
+        const std::string value = byterangeAttr->quotedString();
+        std::pair<std::size_t,std::size_t> range = byterangeAttr->unescapeQuotes().getByteRange();
+        if(value.find('@') == std::string::npos)
+            range.first = *prevoffset;
+        *prevoffset = range.first + range.second;
+        part->setByteRange(range.first, *prevoffset - 1);
+    }
+    else *prevoffset = 0;
+    return part;
+}
+
+/* Copies a segment omitted from a delta update */
+HLSSegment * M3U8Parser::cloneSegment(HLSRepresentation *rep, const Segment *seg) const
+{
+    const HLSSegment *src = dynamic_cast<const HLSSegment *>(seg);
+    if(!src || src->isIncomplete())
+        return nullptr;
+    HLSSegment *segment = new (std::nothrow) HLSSegment(rep, src->getSequenceNumber());
+    if(!segment)
+        return nullptr;
+    segment->sourceUrl = src->sourceUrl;
+    segment->startByte = src->startByte;
+    segment->endByte = src->endByte;
+    segment->duration.Set(src->duration.Get());
+    segment->setDisplayTime(src->getDisplayTime());
+    segment->setDiscontinuitySequenceNumber(src->getDiscontinuitySequenceNumber());
+    segment->discontinuity = src->discontinuity;
+    segment->encryption = src->encryption;
+    return segment;
+}
+
 static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
                             CommonEncryption &encryption)
 {
@@ -300,9 +345,28 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     const SingleValueTag *ctx_byterange = nullptr;
     CommonEncryption encryption;
     const ValuesListTag *ctx_extinf = nullptr;
+    std::vector<HLSSegment *> ctx_parts; /* parts of the next segment */
+    std::size_t prevpartbyterangeoffset = 0;
+    bool b_preloadhint = false;
 
     std::list<HLSSegment *> segmentstoappend;
 
+    auto attachParts = [&](HLSSegment *segment)
+    {
+        for(HLSSegment *part : ctx_parts)
+        {
+            part->setSequenceNumber(segment->getSequenceNumber());
+            part->setDiscontinuitySequenceNumber(segment->getDiscontinuitySequenceNumber());
+            if(encryption.method != CommonEncryption::Method::None)
+                part->setEncryption(encryption);
+            segment->addPart(part);
+        }
+        if(!ctx_parts.empty())
+            ctx_parts.front()->discontinuity = segment->discontinuity;
+        ctx_parts.clear();
+        b_preloadhint = false;
+    };
+
     std::list<Tag *>::const_iterator it;
     for(it = tagslist.begin(); it != tagslist.end(); ++it)
     {
@@ -374,6 +438,8 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
 
                 if(encryption.method != CommonEncryption::Method::None)
                     segment->setEncryption(encryption);
+
+                attachParts(segment);
             }
             break;
 
@@ -447,8 +513,137 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
 
             case Tag::EXTXENDLIST:
                 break;
+
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const AttributesTag *ctltag = static_cast<const AttributesTag *>(tag);
+                const Attribute *attr = ctltag->getAttributeByName("CAN-BLOCK-RELOAD");
+                rep->b_canBlockReload = attr && attr->value == "YES";
+                attr = ctltag->getAttributeByName("CAN-SKIP-UNTIL");
+                rep->canSkipUntil = attr ? vlc_tick_from_sec(attr->floatingPoint()) : 0;
+            }
+            break;
+
+            case AttributesTag::EXTXPARTINF:
+            {
+                const Attribute *targetAttr = static_cast<const AttributesTag *>(tag)->
+                                              getAttributeByName("PART-TARGET");
+                if(targetAttr)
+                    rep->partTarget = vlc_tick_from_sec(targetAttr->floatingPoint());
+            }
+            break;
+
+            case AttributesTag::EXTXPART:
+            {
+                const AttributesTag *parttag = static_cast<const AttributesTag *>(tag);
+                const Attribute *uriAttr = parttag->getAttributeByName("URI");
+                if(!uriAttr || b_preloadhint)
+                    break;
+                HLSSegment *part = createPart(rep, uriAttr, parttag->getAttributeByName("BYTERANGE"),
+                                              &prevpartbyterangeoffset);
+                if(!part)
+                    break;
+                const Attribute *durAttribute = parttag->getAttributeByName("DURATION");
+                vlc_tick_t nzDuration = durAttribute ? vlc_tick_from_sec(durAttribute->floatingPoint())
+                                                     : rep->partTarget;
+                part->duration.Set(timescale.ToScaled(nzDuration));
+                ctx_parts.push_back(part);
+            }
+            break;
+
+            case AttributesTag::EXTXPRELOADHINT:
+            {
+                const AttributesTag *hinttag = static_cast<const AttributesTag *>(tag);
+                const Attribute *typeAttr = hinttag->getAttributeByName("TYPE");
+                const Attribute *uriAttr = hinttag->getAttributeByName("URI");
+                if(!typeAttr || typeAttr->value != "PART" || !uriAttr || b_preloadhint)
+                    break;
+                const Attribute *startAttr = hinttag->getAttributeByName("BYTERANGE-START");
+                const Attribute *lengthAttr = hinttag->getAttributeByName("BYTERANGE-LENGTH");
+                if(startAttr && startAttr->decimal() && !lengthAttr)
+                    break; /* open ended range, unsupported */
+                HLSSegment *part = createPart(rep, uriAttr, nullptr, &prevpartbyterangeoffset);
+                if(!part)
+                    break;
+                if(lengthAttr && lengthAttr->decimal())
+                {
+                    const std::size_t start = startAttr ? startAttr->decimal() : 0;
+                    part->setByteRange(start, start + lengthAttr->decimal() - 1);
+                }
+                /* Hinted part of the next update, requested in advance */
+                part->duration.Set(timescale.ToScaled(rep->partTarget));
+                ctx_parts.push_back(part);
+                b_preloadhint = true;
+            }
+            break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Delta update: take the skipped segments from the current list */
+                const Attribute *skippedAttr = static_cast<const AttributesTag *>(tag)->
+                                               getAttributeByName("SKIPPED-SEGMENTS");
+                if(!skippedAttr)
+                    break;
+                const uint64_t skipped = skippedAttr->decimal();
+                const SegmentList *previous = rep->inheritSegmentList();
+                for(uint64_t i = 0; previous && i < skipped; i++)
+                {
+                    const Segment *prevseg = previous->getMediaSegment(sequenceNumber + i);
+                    HLSSegment *segment = prevseg ? cloneSegment(rep, prevseg) : nullptr;
+                    if(!segment)
+                        continue;
+                    const vlc_tick_t nzDuration = timescale.ToTime(segment->duration.Get());
+                    segment->startTime.Set(timescale.ToScaled(nzStartTime));
+                    nzStartTime += nzDuration;
+                    totalduration += nzDuration;
+                    if(segment->getDisplayTime() != VLC_TICK_INVALID)
+                        absReferenceTime = segment->getDisplayTime() + nzDuration;
+                    discontinuitySequence = segment->getDiscontinuitySequenceNumber();
+                    segmentstoappend.push_back(segment);
+                }
+                sequenceNumber += skipped;
+            }
+            break;
+        }
+    }
+
+    if(!ctx_parts.empty())
+    {
+        /* Segment still being produced, only available through its parts */
+        HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber);
+        if(segment)
+        {
+            vlc_tick_t nzDuration = 0;
+            for(const HLSSegment *part : ctx_parts)
+                nzDuration += timescale.ToTime(part->duration.Get());
+            segment->duration.Set(timescale.ToScaled(nzDuration));
+            segment->startTime.Set(timescale.ToScaled(nzStartTime));
+            totalduration += nzDuration;
+            if(absReferenceTime != VLC_TICK_INVALID)
+                segment->setDisplayTime(absReferenceTime);
+            segment->setDiscontinuitySequenceNumber(discontinuitySequence);
+            segment->discontinuity = discontinuity;
+            segment->setIncomplete(true);
+            if(encryption.method != CommonEncryption::Method::None)
+                segment->setEncryption(encryption);
+
+            rep->nextMediaSequence = sequenceNumber;
+            rep->nextPart = ctx_parts.size() - (b_preloadhint ? 1 : 0);
+            attachParts(segment);
+            segmentstoappend.push_back(segment);
+        }
+        else
+        {
+            for(HLSSegment *part : ctx_parts)
+                delete part;
+            ctx_parts.clear();
         }
     }
+    else
+    {
+        rep->nextMediaSequence = sequenceNumber;
+        rep->nextPart = 0;
+    }
 
     for(HLSSegment *seg : segmentstoappend)
         segmentList->addSegment(seg);
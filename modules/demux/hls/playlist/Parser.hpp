@@ -35,6 +35,7 @@ namespace adaptive
     namespace playlist
     {
         class SegmentInformation;
+        class Segment;
         class SegmentTemplate;
         class BaseAdaptationSet;
     }
@@ -50,6 +51,8 @@ namespace hls
         class AttributesTag;
         class Tag;
         class HLSRepresentation;
+        class HLSSegment;
+        class Attribute;
 
         class M3U8Parser
         {
@@ -59,6 +62,7 @@ namespace hls
 
                 M3U8 *             parse  (vlc_object_t *p_obj, stream_t *p_stream, const std::string &);
                 bool appendSegmentsFromPlaylistURI(vlc_object_t *, HLSRepresentation *);
+                void appendSegmentsFromStream(vlc_object_t *, stream_t *, HLSRepresentation *);
 
             private:
                 HLSRepresentation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
@@ -69,6 +73,9 @@ namespace hls
                 void fillAdaptsetFromMediainfo(const AttributesTag *, const std::string &,
                                                const std::string &, BaseAdaptationSet *);
                 void parseSegments(vlc_object_t *, HLSRepresentation *, const std::list<Tag *>&);
+                HLSSegment * createPart(HLSRepresentation *, const Attribute *uri,
+                                        const Attribute *byterange, std::size_t *);
+                HLSSegment * cloneSegment(HLSRepresentation *, const Segment *) const;
                 std::list<Tag *> parseEntries(stream_t *);
                 adaptive::SharedResources *resources;
         };
@@ -0,0 +1,317 @@
+/*****************************************************************************
+ * cluster_index.cpp : matroska demuxer
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "cluster_index.hpp"
+
+#include <vlc_cachefile.h>
+#include <vlc_stream.h>
+
+#include <cinttypes>
+#include <cstdio>
+
+/*
+ * One file per URL, named after its MD5, in the "mkv-index" sub-directory of
+ * the user cache directory. It is only written once a whole segment has been
+ * indexed:
+ *
+ *   vlc-mkv-index <version>
+ *   id <identity>
+ *   <cluster position> <cluster time> <cluster size>
+ *   ...
+ */
+#define INDEX_VERSION 1
+#define INDEX_DIR "mkv-index"
+/* Size limit of the cache directory */
+#define INDEX_MAX_SIZE (32 << 20)
+
+#define MKV_ID_SEGMENT          UINT64_C(0x18538067)
+#define MKV_ID_CLUSTER          UINT64_C(0x1F43B675)
+#define MKV_ID_CLUSTER_TIMECODE UINT64_C(0xE7)
+
+/* Enough for the Cluster header, a CRC-32 and the Timecode */
+#define CLUSTER_HEADER_SIZE 64
+
+namespace {
+    /* Parses an EBML element ID or size, returns its length or 0 if invalid.
+     * Sizes with all bits set (unknown) are returned as UINT64_MAX. */
+    size_t ReadVint( const uint8_t *p, size_t len, uint64_t *value, bool b_id )
+    {
+        if( len == 0 || p[0] == 0 )
+            return 0;
+
+        size_t n = 1;
+        while( !( p[0] & ( 0x80 >> ( n - 1 ) ) ) )
+            n++;
+        if( n > len )
+            return 0;
+
+        uint64_t v = b_id ? p[0] : p[0] & ( 0xFF >> n );
+        for( size_t i = 1; i < n; i++ )
+            v = ( v << 8 ) | p[i];
+
+        if( !b_id && v == ( UINT64_C(1) << ( 7 * n ) ) - 1 )
+            v = UINT64_MAX;
+        *value = v;
+        return n;
+    }
+}
+
+namespace mkv {
+
+ClusterIndexer::ClusterIndexer( vlc_object_t *obj, const char *url,
+                                std::string const& identity,
+                                uint64_t segment_pos, uint64_t data_start,
+                                uint64_t data_end, uint64_t timescale )
+    : obj( obj )
+    , url( url )
+    , identity( identity )
+    , segment_pos( segment_pos )
+    , data_start( data_start )
+    , data_end( data_end )
+    , timescale( timescale )
+    , interrupt( NULL )
+    , b_started( false )
+{
+    vlc_mutex_init( &lock );
+}
+
+ClusterIndexer::~ClusterIndexer()
+{
+    if( b_started )
+    {
+        vlc_interrupt_kill( interrupt );
+        vlc_join( thread, NULL );
+    }
+    if( interrupt != NULL )
+        vlc_interrupt_destroy( interrupt );
+}
+
+bool ClusterIndexer::Load( clusters_t & clusters )
+{
+    FILE *file = vlc_cachefile_Open( INDEX_DIR, url.c_str() );
+    if( file == NULL )
+        return false;
+
+    char *line = NULL;
+    size_t linesize = 0;
+    unsigned version;
+    bool b_valid = false;
+
+    if( getline( &line, &linesize, file ) != -1
+     && sscanf( line, "vlc-mkv-index %u", &version ) == 1
+     && version == INDEX_VERSION
+     && getline( &line, &linesize, file ) != -1
+     && std::string( line ) == "id " + identity + "\n" )
+    {
+        clusters_t loaded;
+        b_valid = true;
+
+        while( getline( &line, &linesize, file ) != -1 )
+        {
+            Cluster c;
+            int64_t pts;
+
+            if( sscanf( line, "%" SCNu64 " %" SCNd64 " %" SCNu64,
+                        &c.fpos, &pts, &c.size ) != 3 )
+            {
+                b_valid = false;
+                break;
+            }
+            c.pts = pts;
+            loaded.push_back( c );
+        }
+
+        if( b_valid )
+            clusters.swap( loaded );
+    }
+
+    free( line );
+    fclose( file );
+
+    if( b_valid )
+        msg_Dbg( obj, "%zu clusters restored from the index cache",
+                 clusters.size() );
+    return b_valid;
+}
+
+void ClusterIndexer::Store() const
+{
+    vlc_cachefile_t *entry = vlc_cachefile_Create( obj, INDEX_DIR, url.c_str() );
+    if( entry == NULL )
+        return;
+
+    FILE *file = vlc_cachefile_GetFile( entry );
+
+    fprintf( file, "vlc-mkv-index %u\nid %s\n", INDEX_VERSION,
+             identity.c_str() );
+    for( clusters_t::const_iterator it = found.begin(); it != found.end(); ++it )
+        fprintf( file, "%" PRIu64 " %" PRId64 " %" PRIu64 "\n",
+                 it->fpos, int64_t( it->pts ), it->size );
+
+    vlc_cachefile_Commit( entry, INDEX_MAX_SIZE );
+}
+
+bool ClusterIndexer::Start()
+{
+    interrupt = vlc_interrupt_create();
+    if( unlikely( interrupt == NULL ) )
+        return false;
+
+    if( vlc_clone( &thread, Run, this ) )
+        return false;
+
+    b_started = true;
+    return true;
+}
+
+void ClusterIndexer::Fetch( clusters_t & clusters )
+{
+    vlc_mutex_lock( &lock );
+    clusters.insert( clusters.end(), pending.begin(), pending.end() );
+    pending.clear();
+    vlc_mutex_unlock( &lock );
+}
+
+bool ClusterIndexer::ParseCluster( const uint8_t *p, size_t len,
+                                   uint64_t fpos, uint64_t size )
+{
+    /* The Timecode is the first child, possibly after a CRC-32 or a Void */
+    while( len > 0 )
+    {
+        uint64_t id, child_size;
+        size_t n = ReadVint( p, len, &id, true );
+        size_t m = n ? ReadVint( p + n, len - n, &child_size, false ) : 0;
+
+        if( m == 0 || child_size > len - n - m )
+            return false;
+        p += n + m;
+        len -= n + m;
+
+        if( id == MKV_ID_CLUSTER_TIMECODE )
+        {
+            if( child_size > 8 )
+                return false;
+
+            uint64_t timecode = 0;
+            for( size_t i = 0; i < child_size; i++ )
+                timecode = ( timecode << 8 ) | p[i];
+
+            Cluster c = { fpos, VLC_TICK_FROM_NS( int64_t( timecode * timescale ) ),
+                           size };
+            found.push_back( c );
+
+            vlc_mutex_lock( &lock );
+            pending.push_back( c );
+            vlc_mutex_unlock( &lock );
+            return true;
+        }
+
+        p += child_size;
+        len -= child_size;
+    }
+    return false;
+}
+
+bool ClusterIndexer::Index( stream_t *s )
+{
+    uint8_t buf[CLUSTER_HEADER_SIZE];
+    uint64_t id, size;
+
+    /* Make sure both streams agree on the file layout */
+    if( vlc_stream_Seek( s, segment_pos )
+     || vlc_stream_Read( s, buf, 4 ) != 4
+     || ReadVint( buf, 4, &id, true ) != 4 || id != MKV_ID_SEGMENT )
+    {
+        msg_Warn( obj, "cannot index clusters: unexpected file layout" );
+        return false;
+    }
+
+    uint64_t end = data_end;
+    if( end == UINT64_MAX && vlc_stream_GetSize( s, &end ) )
+        end = UINT64_MAX;
+
+    for( uint64_t pos = data_start; pos < end; )
+    {
+        if( vlc_killed() )
+            return false;
+
+        /* Only the element header is needed: do not read ahead */
+        vlc_stream_SetReadHint( s, pos, sizeof (buf) );
+        if( vlc_stream_Seek( s, pos ) )
+            return false;
+
+        ssize_t len = vlc_stream_Read( s, buf, sizeof (buf) );
+        if( len == 0 && end == UINT64_MAX )
+            break; /* end of a segment of unknown size */
+        if( len <= 0 )
+            return false;
+
+        size_t n = ReadVint( buf, len, &id, true );
+        size_t m = n ? ReadVint( buf + n, len - n, &size, false ) : 0;
+        if( m == 0 )
+        {
+            msg_Dbg( obj, "cannot index clusters: invalid element at %" PRIu64,
+                     pos );
+            return false;
+        }
+        if( size == UINT64_MAX )
+        {   /* Cannot skip an element of unknown size */
+            msg_Dbg( obj, "cannot index clusters: unknown size at %" PRIu64,
+                     pos );
+            return false;
+        }
+
+        if( id == MKV_ID_CLUSTER )
+            ParseCluster( buf + n + m, len - n - m, pos, n + m + size );
+
+        pos += n + m + size;
+    }
+    return true;
+}
+
+void *ClusterIndexer::Run( void *data )
+{
+    ClusterIndexer *p_this = static_cast<ClusterIndexer *>( data );
+
+    vlc_thread_set_name( "vlc-mkv-index" );
+    vlc_interrupt_set( p_this->interrupt );
+
+    stream_t *s = vlc_stream_NewURL( p_this->obj, p_this->url.c_str() );
+    if( s == NULL )
+        return NULL;
+
+    vlc_tick_t start = vlc_tick_now();
+    bool b_complete = p_this->Index( s );
+    vlc_stream_Delete( s );
+
+    if( b_complete )
+    {
+        msg_Dbg( p_this->obj, "%zu clusters indexed in %" PRId64 " ms",
+                 p_this->found.size(), MS_FROM_VLC_TICK( vlc_tick_now() - start ) );
+        p_this->Store();
+    }
+    return NULL;
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * cluster_index.hpp : matroska demuxer
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_MKV_CLUSTER_INDEX_HPP_
+#define VLC_MKV_CLUSTER_INDEX_HPP_
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include <vlc_interrupt.h>
+
+#include <string>
+#include <vector>
+
+namespace mkv {
+
+/*
+ * Builds the list of the clusters of a segment in the background, by jumping
+ * from cluster to cluster on a separate stream, and keeps it in the user
+ * cache directory so that the next opening of the same file gets it at once.
+ */
+class ClusterIndexer
+{
+    public:
+        struct Cluster
+        {
+            uint64_t   fpos;
+            vlc_tick_t pts;
+            uint64_t   size;
+        };
+
+        typedef std::vector<Cluster> clusters_t;
+
+        /**
+         * @param url URL of the file, to open the indexing stream
+         * @param identity string that changes if the file changes
+         * @param segment_pos position of the Segment element
+         * @param data_start position of the first element of the Segment
+         * @param data_end end of the Segment, or UINT64_MAX if unknown
+         * @param timescale Segment timestamp scale in nanoseconds
+         */
+        ClusterIndexer( vlc_object_t *obj, const char *url,
+                        std::string const& identity, uint64_t segment_pos,
+                        uint64_t data_start, uint64_t data_end,
+                        uint64_t timescale );
+        ~ClusterIndexer();
+
+        /** Gets the clusters from the cache, if it has a complete index */
+        bool Load( clusters_t & );
+
+        /** Starts indexing in the background */
+        bool Start();
+
+        /** Moves the clusters found since the last call */
+        void Fetch( clusters_t & );
+
+    private:
+        static void *Run( void * );
+        bool Index( stream_t * );
+        bool ParseCluster( const uint8_t *, size_t, uint64_t fpos, uint64_t size );
+        void Store() const;
+
+        vlc_object_t *obj;
+        std::string   url;
+        std::string   identity;
+        uint64_t      segment_pos;
+        uint64_t      data_start;
+        uint64_t      data_end;
+        uint64_t      timescale;
+
+        vlc_thread_t      thread;
+        vlc_interrupt_t  *interrupt;
+        bool              b_started;
+        vlc_mutex_t       lock;
+        clusters_t        pending; /* found, not fetched yet */
+        clusters_t        found;   /* owned by the indexing thread */
+};
+
+} // namespace
+
+#endif
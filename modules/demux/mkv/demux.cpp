@@ -275,6 +275,12 @@ bool demux_sys_t::FreeUnused()
     return !streams.empty() && !opened_segments.empty();
 }
 
+void demux_sys_t::LoadAttachments()
+{
+    for( size_t i = 0; i < opened_segments.size(); i++ )
+        opened_segments[i]->LoadAttachments();
+}
+
 bool demux_sys_t::PreparePlayback( virtual_segment_c & new_vsegment, vlc_tick_t i_mk_date )
 {
     if ( p_current_vsegment != &new_vsegment )
@@ -289,7 +295,10 @@ bool demux_sys_t::PreparePlayback( virtual_segment_c & new_vsegment, vlc_tick_t
     if( !p_current_vsegment->CurrentSegment() )
         return false;
     if( !p_current_vsegment->CurrentSegment()->b_cues )
+    {
         msg_Warn( &p_current_vsegment->CurrentSegment()->sys.demuxer, "no cues/empty cues found->seek won't be precise" );
+        p_current_vsegment->CurrentSegment()->IndexClusters();
+    }
 
     i_duration = p_current_vsegment->Duration();
 
@@ -45,6 +45,7 @@ public:
         :demuxer(demux)
         ,b_seekable(false)
         ,b_fastseekable(false)
+        ,b_keyframes_only(false)
         ,i_pts(VLC_TICK_INVALID)
         ,i_pcr(VLC_TICK_INVALID)
         ,i_start_pts(VLC_TICK_0)
@@ -68,6 +69,7 @@ public:
     demux_t                 & demuxer;
     bool                    b_seekable;
     bool                    b_fastseekable;
+    bool                    b_keyframes_only;
 
     vlc_tick_t              i_pts;
     vlc_tick_t              i_pcr;
@@ -106,6 +108,7 @@ public:
     void PreloadFamily( const matroska_segment_c & of_segment );
     bool PreloadLinked();
     bool FreeUnused();
+    void LoadAttachments();
     bool PreparePlayback( virtual_segment_c & new_vsegment, vlc_tick_t i_mk_date );
     bool AnalyseAllSegmentsFound( demux_t *p_demux, matroska_stream_c * );
     void JumpTo( virtual_segment_c & vsegment, virtual_chapter_c & vchapter );
@@ -28,10 +28,16 @@
 #include "Ebml_parser.hpp"
 #include "Ebml_dispatcher.hpp"
 
+#include <vlc_fs.h>
+#include <vlc_strings.h>
+#include <vlc_url.h>
+
 #include <new>
 #include <iterator>
 #include <limits>
 
+#include <sys/stat.h>
+
 namespace mkv {
 
 matroska_segment_c::matroska_segment_c( demux_sys_t & demuxer, EbmlStream & estream, KaxSegment *p_seg )
@@ -47,6 +53,7 @@ matroska_segment_c::matroska_segment_c( demux_sys_t & demuxer, EbmlStream & estr
     ,i_info_position(-1)
     ,i_chapters_position(-1)
     ,i_attachments_position(-1)
+    ,b_attachments_loaded(false)
     ,cluster(NULL)
     ,i_block_pos(0)
     ,p_segment_uid(NULL)
@@ -518,6 +525,73 @@ bool matroska_segment_c::PreloadClusters(uint64 i_cluster_pos)
     return true;
 }
 
+void matroska_segment_c::IndexClusters()
+{
+    if( indexer || !sys.b_seekable || sys.demuxer.psz_url == NULL
+     || !var_InheritBool( &sys.demuxer, "mkv-index-clusters" ) )
+        return;
+
+    /* Identify the file by its size, its modification time if local, and the
+     * segment UID */
+    uint64_t i_size;
+    if( vlc_stream_GetSize( sys.demuxer.s, &i_size ) )
+        return;
+
+    std::string identity = std::to_string( i_size );
+
+    char *psz_path = vlc_uri2path( sys.demuxer.psz_url );
+    struct stat st;
+    if( psz_path != NULL && vlc_stat( psz_path, &st ) == 0 )
+        identity += " " + std::to_string( (intmax_t) st.st_mtime );
+    free( psz_path );
+
+    if( p_segment_uid != NULL && p_segment_uid->GetSize() > 0 )
+    {
+        std::vector<char> hex( 2 * p_segment_uid->GetSize() + 1 );
+        vlc_hex_encode_binary( p_segment_uid->GetBuffer(),
+                               p_segment_uid->GetSize(), hex.data() );
+        identity += " ";
+        identity += hex.data();
+    }
+
+    uint64_t i_end = segment->IsFiniteSize() ? segment->GetEndPosition()
+                                             : UINT64_MAX;
+
+    indexer.reset( new (std::nothrow) ClusterIndexer( VLC_OBJECT( &sys.demuxer ),
+        sys.demuxer.psz_url, identity, segment->GetElementPosition(),
+        segment->GetDataStart(), i_end, i_timescale ) );
+    if( !indexer )
+        return;
+
+    ClusterIndexer::clusters_t clusters;
+    if( indexer->Load( clusters ) )
+    {
+        AddIndexedClusters( clusters );
+        indexer.reset();
+        return;
+    }
+
+    msg_Dbg( &sys.demuxer, "indexing clusters in the background" );
+    if( !indexer->Start() )
+        indexer.reset();
+}
+
+void matroska_segment_c::AddIndexedClusters( ClusterIndexer::clusters_t const& clusters )
+{
+    for( ClusterIndexer::clusters_t::const_iterator it = clusters.begin();
+         it != clusters.end(); ++it )
+    {
+        SegmentSeeker::Cluster cinfo = {
+            /* fpos     */ it->fpos,
+            /* pts      */ it->pts,
+            /* duration */ vlc_tick_t( -1 ),
+            /* size     */ it->size
+        };
+
+        _seeker.add_cluster( cinfo );
+    }
+}
+
 bool matroska_segment_c::PreloadFamily( const matroska_segment_c & of_segment )
 {
     if ( b_preloaded )
@@ -651,14 +725,12 @@ bool matroska_segment_c::Preload( )
             /* stop pre-parsing the stream */
             break;
         }
-        else if( MKV_CHECKED_PTR_DECL ( ka_ptr, KaxAttachments, el ) )
+        else if( MKV_IS_ID( el, KaxAttachments ) )
         {
+            /* Parsed on demand, see LoadAttachments() */
             msg_Dbg( &sys.demuxer, "|   + Attachments" );
             if( i_attachments_position < 0 )
-            {
-                ParseAttachments( ka_ptr );
                 i_attachments_position = el->GetElementPosition();
-            }
         }
         else if( MKV_CHECKED_PTR_DECL ( chapters, KaxChapters, el ) )
         {
@@ -756,14 +828,12 @@ bool matroska_segment_c::LoadSeekHeadItem( const EbmlCallbacks & ClassInfos, int
             i_cues_position = i_element_position;
         }
     }
-    else if( MKV_CHECKED_PTR_DECL ( ka_ptr, KaxAttachments, el ) )
+    else if( MKV_IS_ID( el, KaxAttachments ) )
     {
+        /* Parsed on demand, see LoadAttachments() */
         msg_Dbg( &sys.demuxer, "|   + Attachments" );
         if( i_attachments_position < 0 )
-        {
-            ParseAttachments( ka_ptr );
             i_attachments_position = i_element_position;
-        }
     }
     else if( MKV_CHECKED_PTR_DECL ( chapters, KaxChapters, el ) )
     {
@@ -792,6 +862,32 @@ bool matroska_segment_c::LoadSeekHeadItem( const EbmlCallbacks & ClassInfos, int
     return true;
 }
 
+/* Attachments are only parsed when they are first queried, as they can hold
+ * many megabytes of fonts that are useless for probing and linked segments */
+void matroska_segment_c::LoadAttachments()
+{
+    if( b_attachments_loaded || i_attachments_position < 0 )
+        return;
+    b_attachments_loaded = true;
+
+    int64_t     i_sav_position = static_cast<int64_t>( es.I_O().getFilePointer() );
+    EbmlElement *el;
+
+    es.I_O().setFilePointer( i_attachments_position, seek_beginning );
+    el = es.FindNextID( EBML_INFO(KaxAttachments), 0xFFFFFFFFL );
+
+    if( MKV_CHECKED_PTR_DECL ( ka_ptr, KaxAttachments, el ) )
+    {
+        msg_Dbg( &sys.demuxer, "+ Attachments" );
+        ParseAttachments( ka_ptr );
+    }
+    else
+        msg_Err( &sys.demuxer, "cannot load the attachments (broken seekhead or file)" );
+    delete el;
+
+    es.I_O().setFilePointer( i_sav_position, seek_beginning );
+}
+
 bool matroska_segment_c::Seek( demux_t &demuxer, vlc_tick_t i_absolute_mk_date, vlc_tick_t i_mk_time_offset, bool b_accurate )
 {
     SegmentSeeker::tracks_seekpoint_t seekpoints;
@@ -836,6 +932,15 @@ bool matroska_segment_c::Seek( demux_t &demuxer, vlc_tick_t i_absolute_mk_date,
             priority = selected_tracks;
     }
 
+    // use the clusters indexed in the background so far //
+
+    if( indexer )
+    {
+        ClusterIndexer::clusters_t clusters;
+        indexer->Fetch( clusters );
+        AddIndexedClusters( clusters );
+    }
+
     // find appropriate seekpoints //
 
     try {
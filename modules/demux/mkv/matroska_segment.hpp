@@ -27,6 +27,7 @@
 #include "demux.hpp"
 #include "mkv.hpp"
 #include "matroska_segment_seeker.hpp"
+#include "cluster_index.hpp"
 #include <vector>
 #include <string>
 
@@ -108,6 +109,7 @@ public:
     int64_t                 i_info_position;
     int64_t                 i_chapters_position;
     int64_t                 i_attachments_position;
+    bool                    b_attachments_loaded;
 
     KaxCluster              *cluster;
     uint64                  i_block_pos;
@@ -142,6 +144,8 @@ public:
     bool Preload();
     bool PreloadFamily( const matroska_segment_c & segment );
     bool PreloadClusters( uint64 i_cluster_position );
+    void IndexClusters();
+    void LoadAttachments();
     void InformationCreate();
 
     bool Seek( demux_t &, vlc_tick_t i_mk_date, vlc_tick_t i_mk_time_offset, bool b_accurate );
@@ -174,8 +178,10 @@ private:
     bool TrackInit( mkv_track_t * p_tk );
     void ComputeTrackPriority();
     void EnsureDuration();
+    void AddIndexedClusters( ClusterIndexer::clusters_t const& );
 
     SegmentSeeker _seeker;
+    std::unique_ptr<ClusterIndexer> indexer;
 
     friend SegmentSeeker;
 };
@@ -81,6 +81,11 @@ vlc_module_begin ()
             N_("Preload clusters"),
             N_("Find all cluster positions by jumping cluster-to-cluster before playback") );
 
+    add_bool( "mkv-index-clusters", true,
+            N_("Index clusters in the background"),
+            N_("Find all cluster positions in the background when there are no "
+               "cues, and keep them in the cache for faster seeking.") );
+
     add_shortcut( "mka", "mkv" )
     add_file_extension("mka")
     add_file_extension("mks")
@@ -128,6 +133,7 @@ static int OpenInternal( demux_t *p_demux, bool trust_cues )
     if ( !p_sys->b_seekable || vlc_stream_Control(
           p_demux->s, STREAM_CAN_FASTSEEK, &p_sys->b_fastseekable ) )
         p_sys->b_fastseekable = false;
+    p_sys->b_keyframes_only = var_InheritBool( p_demux, "keyframes-only" );
 
     es_out_Control( p_demux->out, ES_OUT_SET_ES_CAT_POLICY, VIDEO_ES,
                     ES_OUT_ES_POLICY_EXCLUSIVE );
@@ -329,6 +335,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
             ppp_attach = va_arg( args, input_attachment_t*** );
             pi_int = va_arg( args, int * );
 
+            p_sys->LoadAttachments();
             if( p_sys->stored_attachments.size() <= 0 )
                 return VLC_EGENERIC;
 
@@ -345,6 +352,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         case DEMUX_GET_META:
             p_meta = va_arg( args, vlc_meta_t* );
+            p_sys->LoadAttachments(); /* for the cover art */
             vlc_meta_Merge( p_meta, p_sys->meta );
             return VLC_SUCCESS;
 
@@ -572,6 +580,10 @@ void BlockDecode( demux_t *p_demux, KaxBlock *block, KaxSimpleBlock *simpleblock
         }
     }
 
+    if( p_sys->b_keyframes_only && track.fmt.i_cat == VIDEO_ES &&
+        !b_key_picture )
+        return;
+
     size_t frame_size = 0;
     size_t block_size = internal_block.GetSize();
     const unsigned i_number_frames = internal_block.NumberFrames();
@@ -118,6 +118,7 @@ typedef struct
     bool         b_seekable;
     bool         b_fastseekable;
     bool         b_error;        /* unrecoverable */
+    bool         b_keyframes_only; /* skip the video non sync samples */
 
     bool            b_index_probed;     /* mFra sync points index */
     bool            b_fragments_probed; /* moof segments index created */
@@ -201,6 +202,8 @@ static int FragGetMoofBySidxIndex( demux_t *p_demux, vlc_tick_t i_target_time,
                                    uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime );
 static int FragGetMoofByTfraIndex( demux_t *p_demux, const vlc_tick_t i_target_time, unsigned i_track_ID,
                                    uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime );
+static int FragGetMoofByProbing( demux_t *p_demux, vlc_tick_t i_target_time, unsigned i_track_index,
+                                 uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime );
 static void FragResetContext( demux_sys_t * );
 
 /* ASF Handlers */
@@ -1006,6 +1009,7 @@ static int Open( vlc_object_t * p_this )
 
     /* I need to seek */
     vlc_stream_Control( p_demux->s, STREAM_CAN_SEEK, &p_sys->b_seekable );
+    p_sys->b_keyframes_only = var_InheritBool( p_demux, "keyframes-only" );
     if( p_sys->b_seekable )
         vlc_stream_Control( p_demux->s, STREAM_CAN_FASTSEEK, &p_sys->b_fastseekable );
 
@@ -1559,6 +1563,31 @@ static uint64_t OverflowCheck( demux_t *p_demux, mp4_track_t *tk,
     return i_samplessize;
 }
 
+/* Without a Sync Sample Box, all the samples are sync samples */
+static bool MP4_TrackIsSyncSample( const mp4_track_t *tk, uint32_t i_sample )
+{
+    const MP4_Box_t *p_stss = MP4_BoxGet( tk->p_stbl, "stss" );
+    if( p_stss == NULL || BOXDATA(p_stss) == NULL )
+        return true;
+
+    const MP4_Box_data_stss_t *p_stss_data = BOXDATA(p_stss);
+    size_t i_low = 0, i_high = p_stss_data->i_entry_count;
+
+    while( i_low < i_high )
+    {
+        size_t i_mid = ( i_low + i_high ) / 2;
+        uint32_t i_sync = p_stss_data->i_sample_number[i_mid];
+
+        if( i_sync == i_sample )
+            return true;
+        if( i_sync < i_sample )
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    return false;
+}
+
 /*****************************************************************************
  * Demux: read packet and send them to decoders
  *****************************************************************************
@@ -1596,6 +1625,13 @@ static int DemuxTrack( demux_t *p_demux, mp4_track_t *tk, uint64_t i_readpos,
 #endif
 
         i_samplessize = MP4_TrackGetReadSize( tk, &i_nb_samples );
+
+        /* The non sync samples are skipped without being read */
+        if( i_samplessize > 0 && p_sys->b_keyframes_only
+         && tk->fmt.i_cat == VIDEO_ES
+         && !MP4_TrackIsSyncSample( tk, tk->i_sample ) )
+            i_samplessize = 0;
+
         if( i_samplessize > 0 )
         {
             block_t *p_block;
@@ -2073,6 +2109,13 @@ static int FragSeekToTime( demux_t *p_demux, vlc_tick_t i_nztime, bool b_accurat
             /* Does only provide segment position and a sync sample time */
             msg_Dbg( p_demux, "seeking to sync point %" PRId64, i_sync_time );
         }
+        else if( !p_sys->b_fragments_probed && !p_sys->b_fastseekable &&
+                 FragGetMoofByProbing( p_demux, i_nztime, i_seek_track_index,
+                                       &i64, &i_sync_time ) == VLC_SUCCESS )
+        {
+            /* Avoids reading every moof of a remote file */
+            msg_Dbg( p_demux, "seeking to probed moof pos %" PRId64 " %" PRId64, i64, i_sync_time );
+        }
         else if( !p_sys->b_fragments_probed )
         {
             int i_ret = ProbeFragmentsChecked( p_demux );
@@ -2735,19 +2778,12 @@ static int TrackCreateSamplesIndex( demux_t *p_demux,
     }
     else
     {
-        /* 2: each sample can have a different size */
+        /* 2: each sample can have a different size, use the box table
+         * as is instead of duplicating it */
         p_demux_track->i_sample_size = 0;
-        p_demux_track->p_sample_size =
-            calloc( p_demux_track->i_sample_count, sizeof( uint32_t ) );
-        if( p_demux_track->p_sample_size == NULL )
-            return VLC_ENOMEM;
-
-        for( uint32_t i_sample = 0; i_sample < p_demux_track->i_sample_count; i_sample++ )
-        {
-            p_demux_track->p_sample_size[i_sample] =
-                    stsz->i_entry_size[i_sample];
-        }
+        p_demux_track->p_sample_size = stsz->i_entry_size;
     }
+    p_demux_track->i_pos_cache_sample = UINT32_MAX;
 
     if ( p_demux_track->i_chunk_count && p_demux_track->i_sample_size == 0 )
     {
@@ -3113,6 +3149,17 @@ static int TrackFillConfig( demux_t *p_demux, const mp4_track_t *p_track,
     return VLC_SUCCESS;
 }
 
+static bool TrackHasMediaTimeOffset( const mp4_track_t *p_track )
+{
+    if( !p_track->p_elst )
+        return false;
+    const MP4_Box_data_elst_t *elst = p_track->BOXDATA(p_elst);
+    for( uint32_t i = 0; i < elst->i_entry_count; i++ )
+        if( elst->entries[i].i_media_time > 0 )
+            return true;
+    return false;
+}
+
 /*
  * TrackCreateES:
  * Create ES and PES to init decoder if needed, for a track starting at i_chunk
@@ -3187,6 +3234,20 @@ static int TrackCreateES( demux_t *p_demux, mp4_track_t *p_track,
                     p_arg->pf_peak[AUDIO_REPLAY_GAIN_TRACK] = f_gain;
                     p_arg->pb_peak[AUDIO_REPLAY_GAIN_TRACK] = f_gain > 0;
                 }
+                /* iTunes gapless info, unless an edit list already skips
+                 * the priming samples */
+                psz_meta = vlc_meta_GetExtra( p_sys->p_meta, "iTunSMPB" );
+                if( psz_meta && !TrackHasMediaTimeOffset( p_track ) )
+                {
+                    unsigned i_unused, i_priming, i_padding;
+                    unsigned long long i_samples;
+                    if( sscanf( psz_meta, "%x %x %x %llx", &i_unused, &i_priming,
+                                &i_padding, &i_samples ) == 4 )
+                    {
+                        p_fmt->audio_gapless.i_priming = i_priming;
+                        p_fmt->audio_gapless.i_samples = i_samples;
+                    }
+                }
             }
             break;
         default:
@@ -3855,9 +3916,6 @@ static void MP4_TrackClean( es_out_t *out, mp4_track_t *p_track )
     }
     free( p_track->chunk );
 
-    if( !p_track->i_sample_size )
-        free( p_track->p_sample_size );
-
     ASFPacketTrackReset( &p_track->asfinfo );
 
     free( p_track->context.runs.p_array );
@@ -4212,11 +4270,21 @@ static uint64_t MP4_TrackGetPos( mp4_track_t *p_track )
     }
     else
     {
-        for( i_sample = p_track->chunk[p_track->i_chunk].i_sample_first;
-             i_sample < p_track->i_sample; i_sample++ )
+        i_sample = p_track->chunk[p_track->i_chunk].i_sample_first;
+
+        /* Resume from the last computed position within the same chunk */
+        if( p_track->i_pos_cache_sample >= i_sample &&
+            p_track->i_pos_cache_sample <= p_track->i_sample )
         {
-            i_pos += p_track->p_sample_size[i_sample];
+            i_sample = p_track->i_pos_cache_sample;
+            i_pos = p_track->i_pos_cache;
         }
+
+        for( ; i_sample < p_track->i_sample; i_sample++ )
+            i_pos += p_track->p_sample_size[i_sample];
+
+        p_track->i_pos_cache_sample = i_sample;
+        p_track->i_pos_cache = i_pos;
     }
 
     return i_pos;
@@ -4427,6 +4495,9 @@ static int ProbeIndex( demux_t *p_demux )
         return VLC_EGENERIC;
 
     i_stream_size = stream_Size( p_demux->s );
+    if ( !( i_stream_size >> 62 ) && i_stream_size >= MP4_MFRO_BOXSIZE )
+        vlc_stream_SetReadHint( p_demux->s, i_stream_size - MP4_MFRO_BOXSIZE,
+                                MP4_MFRO_BOXSIZE );
     if ( ( i_stream_size >> 62 ) ||
          ( i_stream_size < MP4_MFRO_BOXSIZE ) ||
          ( vlc_stream_Seek( p_demux->s, i_stream_size - MP4_MFRO_BOXSIZE ) != VLC_SUCCESS )
@@ -4442,8 +4513,11 @@ static int ProbeIndex( demux_t *p_demux )
     {
         uint32_t i_offset = GetDWBE( &mfro[12] );
         msg_Dbg( p_demux, "will read mfra index at %"PRIu64, i_stream_size - i_offset );
-        if ( i_stream_size > i_offset &&
-             vlc_stream_Seek( p_demux->s, i_stream_size - i_offset ) == VLC_SUCCESS )
+        if ( i_stream_size <= i_offset )
+            return VLC_SUCCESS;
+
+        vlc_stream_SetReadHint( p_demux->s, i_stream_size - i_offset, i_offset );
+        if ( vlc_stream_Seek( p_demux->s, i_stream_size - i_offset ) == VLC_SUCCESS )
         {
             msg_Dbg( p_demux, "reading mfra index at %"PRIu64, i_stream_size - i_offset );
             const uint32_t stoplist[] = { ATOM_mfra, 0 };
@@ -5165,6 +5239,70 @@ static int FragCreateTrunIndex( demux_t *p_demux, MP4_Box_t *p_moof,
     return VLC_SUCCESS;
 }
 
+/* Maximum depth of sidx referencing other sidx */
+#define SIDX_MAX_DEPTH 8
+
+static int FragGetMoofBySidx( demux_t *p_demux, const MP4_Box_t *p_sidx,
+                              vlc_tick_t target_time, vlc_tick_t i_start_time,
+                              unsigned i_depth,
+                              uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime )
+{
+    const MP4_Box_data_sidx_t *p_data = BOXDATA(p_sidx);
+    if( !p_data || !p_data->i_timescale )
+        return VLC_EGENERIC;
+
+    /* sidx refers to offsets from end of sidx pos in the file + first offset */
+    uint64_t i_pos = p_data->i_first_offset + p_sidx->i_pos + p_sidx->i_size;
+    stime_t i_time = 0;
+    for( uint16_t i=0; i<p_data->i_reference_count; i++ )
+    {
+        const MP4_Box_sidx_item_t *p_item = &p_data->p_items[i];
+        vlc_tick_t i_end_time = i_start_time +
+            MP4_rescale_mtime( i_time + p_item->i_subsegment_duration, p_data->i_timescale );
+
+        if( i_end_time > target_time )
+        {
+            vlc_tick_t i_item_time = i_start_time +
+                                     MP4_rescale_mtime( i_time, p_data->i_timescale );
+
+            if( p_item->b_reference_type == 0 ) /* moof */
+            {
+                *pi_sampletime = i_item_time;
+                *pi_moof_pos = i_pos;
+                return VLC_SUCCESS;
+            }
+
+            /* Reference to another sidx, only loaded when needed */
+            if( i_depth >= SIDX_MAX_DEPTH )
+                return VLC_EGENERIC;
+
+            MP4_Box_t *p_vroot = MP4_BoxNew( ATOM_root );
+            if( !p_vroot )
+                return VLC_EGENERIC;
+
+            int i_ret = VLC_EGENERIC;
+            vlc_stream_SetReadHint( p_demux->s, i_pos, p_item->i_referenced_size );
+            if( vlc_stream_Seek( p_demux->s, i_pos ) == VLC_SUCCESS )
+            {
+                const uint32_t stoplist[] = { ATOM_sidx, 0 };
+                MP4_ReadBoxContainerChildren( p_demux->s, p_vroot, stoplist );
+
+                const MP4_Box_t *p_subsidx = MP4_BoxGet( p_vroot, "sidx" );
+                if( p_subsidx && p_subsidx->i_pos == i_pos )
+                    i_ret = FragGetMoofBySidx( p_demux, p_subsidx, target_time,
+                                               i_item_time, i_depth + 1,
+                                               pi_moof_pos, pi_sampletime );
+            }
+            MP4_BoxFree( p_vroot );
+            return i_ret;
+        }
+
+        i_pos += p_item->i_referenced_size;
+        i_time += p_item->i_subsegment_duration;
+    }
+    return VLC_EGENERIC;
+}
+
 static int FragGetMoofBySidxIndex( demux_t *p_demux, vlc_tick_t target_time,
                                    uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime )
 {
@@ -5175,32 +5313,31 @@ static int FragGetMoofBySidxIndex( demux_t *p_demux, vlc_tick_t target_time,
         if( p_sidx->i_type != ATOM_sidx )
             continue;
 
-        const MP4_Box_data_sidx_t *p_data = BOXDATA(p_sidx);
-        if( !p_data || !p_data->i_timescale )
+        if( !BOXDATA(p_sidx) || !BOXDATA(p_sidx)->i_timescale )
             break;
 
-        stime_t i_target_time = MP4_rescale_qtime( target_time, p_data->i_timescale );
-
-        /* sidx refers to offsets from end of sidx pos in the file + first offset */
-        uint64_t i_pos = p_data->i_first_offset + p_sidx->i_pos + p_sidx->i_size;
-        stime_t i_time = 0;
-        for( uint16_t i=0; i<p_data->i_reference_count; i++ )
-        {
-            if(p_data->p_items[i].b_reference_type != 0)
-                continue;
-            if( i_time + p_data->p_items[i].i_subsegment_duration > i_target_time )
-            {
-                *pi_sampletime = MP4_rescale_mtime( i_time, p_data->i_timescale );
-                *pi_moof_pos = i_pos;
-                return VLC_SUCCESS;
-            }
-            i_pos += p_data->p_items[i].i_referenced_size;
-            i_time += p_data->p_items[i].i_subsegment_duration;
-        }
+        if( FragGetMoofBySidx( p_demux, p_sidx, target_time, 0, 0,
+                               pi_moof_pos, pi_sampletime ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
     }
     return VLC_EGENERIC;
 }
 
+static void FragGetTfraEntry( const MP4_Box_data_tfra_t *p_data, uint32_t i,
+                              stime_t *pi_time, uint64_t *pi_offset )
+{
+    if ( p_data->i_version == 1 )
+    {
+        *pi_time = ((const uint64_t *)p_data->p_time)[i];
+        *pi_offset = ((const uint64_t *)p_data->p_moof_offset)[i];
+    }
+    else
+    {
+        *pi_time = p_data->p_time[i];
+        *pi_offset = p_data->p_moof_offset[i];
+    }
+}
+
 static int FragGetMoofByTfraIndex( demux_t *p_demux, const vlc_tick_t i_target_time, unsigned i_track_ID,
                                    uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime )
 {
@@ -5211,47 +5348,186 @@ static int FragGetMoofByTfraIndex( demux_t *p_demux, const vlc_tick_t i_target_t
         if ( p_tfra->i_type == ATOM_tfra )
         {
             const MP4_Box_data_tfra_t *p_data = BOXDATA(p_tfra);
-            if( !p_data || p_data->i_track_ID != i_track_ID )
+            if( !p_data || p_data->i_track_ID != i_track_ID ||
+                p_data->i_number_of_entries == 0 )
                 continue;
 
-            uint64_t i_pos = 0;
             mp4_track_t *p_track = MP4_GetTrackByTrackID( p_demux, p_data->i_track_ID );
-            if ( p_track )
-            {
-                stime_t i_track_target_time = MP4_rescale_qtime( i_target_time, p_track->i_timescale );
-                for ( uint32_t i = 0; i<p_data->i_number_of_entries; i += ( p_data->i_version == 1 ) ? 2 : 1 )
-                {
-                    stime_t i_time;
-                    uint64_t i_offset;
-                    if ( p_data->i_version == 1 )
-                    {
-                        i_time = *((uint64_t *)(p_data->p_time + i));
-                        i_offset = *((uint64_t *)(p_data->p_moof_offset + i));
-                    }
-                    else
-                    {
-                        i_time = p_data->p_time[i];
-                        i_offset = p_data->p_moof_offset[i];
-                    }
+            if ( !p_track )
+                continue;
 
-                    if ( i_time >= i_track_target_time )
-                    {
-                        if ( i_pos == 0 ) /* Not in this traf */
-                            break;
+            stime_t i_track_target_time = MP4_rescale_qtime( i_target_time, p_track->i_timescale );
+            stime_t i_time;
+            uint64_t i_offset;
 
-                        *pi_moof_pos = i_pos;
-                        *pi_sampletime = MP4_rescale_mtime( i_time, p_track->i_timescale );
-                        return VLC_SUCCESS;
-                    }
-                    else
-                        i_pos = i_offset;
-                }
+            FragGetTfraEntry( p_data, 0, &i_time, &i_offset );
+            if ( i_time > i_track_target_time ) /* Not in this traf */
+                continue;
+
+            /* Entries are in time order: find the last one before the target */
+            uint32_t i_low = 0, i_high = p_data->i_number_of_entries;
+            while( i_high - i_low > 1 )
+            {
+                uint32_t i_mid = i_low + (i_high - i_low) / 2;
+                FragGetTfraEntry( p_data, i_mid, &i_time, &i_offset );
+                if( i_time > i_track_target_time )
+                    i_high = i_mid;
+                else
+                    i_low = i_mid;
             }
+
+            FragGetTfraEntry( p_data, i_low, &i_time, &i_offset );
+            *pi_moof_pos = i_offset;
+            *pi_sampletime = MP4_rescale_mtime( i_time, p_track->i_timescale );
+            return VLC_SUCCESS;
         }
     }
     return VLC_EGENERIC;
 }
 
+/* Bytes scanned after a probed position to find the next moof */
+#define FRAG_PROBE_WINDOW  (256 * 1024)
+/* Maximum number of probes for a seek */
+#define FRAG_PROBE_MAX     16
+
+/* Finds the first moof starting within the probe window at i_pos, and returns
+ * its position and its decode time for the given track.
+ * Returns VLC_ENOENT if there is no moof in the window */
+static int FragProbeMoof( demux_t *p_demux, uint64_t i_pos, uint64_t i_end,
+                          unsigned i_track_ID, uint64_t *pi_moof_pos, stime_t *pi_time )
+{
+    size_t i_window = __MIN( FRAG_PROBE_WINDOW, i_end - i_pos );
+    if( i_window < 16 )
+        return VLC_ENOENT;
+
+    uint8_t *p_buf = malloc( i_window );
+    if( !p_buf )
+        return VLC_ENOMEM;
+
+    vlc_stream_SetReadHint( p_demux->s, i_pos, i_window );
+    ssize_t i_read = -1;
+    if( vlc_stream_Seek( p_demux->s, i_pos ) == VLC_SUCCESS )
+        i_read = vlc_stream_Read( p_demux->s, p_buf, i_window );
+
+    /* A moof always starts with its mfhd */
+    uint32_t i_moof_size = 0;
+    ssize_t i;
+    for( i = 0; i + 16 <= i_read; i++ )
+    {
+        if( !memcmp( &p_buf[i + 4], "moof", 4 ) &&
+            !memcmp( &p_buf[i + 12], "mfhd", 4 ) &&
+            GetDWBE( &p_buf[i + 8] ) == 16 )
+        {
+            i_moof_size = GetDWBE( &p_buf[i] );
+            break;
+        }
+    }
+    free( p_buf );
+
+    if( i_moof_size < 16 )
+        return ( i_read < 0 ) ? VLC_EGENERIC : VLC_ENOENT;
+
+    uint64_t i_moof_pos = i_pos + i;
+    vlc_stream_SetReadHint( p_demux->s, i_moof_pos, i_moof_size );
+    if( vlc_stream_Seek( p_demux->s, i_moof_pos ) != VLC_SUCCESS )
+        return VLC_EGENERIC;
+
+    MP4_Box_t *p_vroot = MP4_BoxGetNextChunk( p_demux->s );
+    if( !p_vroot )
+        return VLC_EGENERIC;
+
+    int i_ret = VLC_EGENERIC;
+    MP4_Box_t *p_moof = MP4_BoxGet( p_vroot, "moof" );
+    MP4_Box_t *p_traf = p_moof ? MP4_GetTrafByTrackID( p_moof, i_track_ID ) : NULL;
+    MP4_Box_t *p_tfdt = p_traf ? MP4_BoxGet( p_traf, "tfdt" ) : NULL;
+    if( p_tfdt && BOXDATA(p_tfdt) )
+    {
+        *pi_moof_pos = i_moof_pos;
+        *pi_time = BOXDATA(p_tfdt)->i_base_media_decode_time;
+        i_ret = VLC_SUCCESS;
+    }
+    MP4_BoxFree( p_vroot );
+    return i_ret;
+}
+
+/* Looks for the last moof before the target time with a bounded number of
+ * probes, interpolating the next position from the moofs found so far.
+ * Needs moofs with decode times (tfdt). */
+static int FragGetMoofByProbing( demux_t *p_demux, vlc_tick_t i_target_time, unsigned i_track_index,
+                                 uint64_t *pi_moof_pos, vlc_tick_t *pi_sampletime )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    const mp4_track_t *p_track = &p_sys->track[i_track_index];
+    uint64_t i_size;
+
+    if( !p_track->i_timescale || vlc_stream_GetSize( p_demux->s, &i_size ) )
+        return VLC_EGENERIC;
+
+    const stime_t i_target = MP4_rescale_qtime( i_target_time, p_track->i_timescale );
+    const uint64_t i_duration = __MAX(p_sys->i_duration, p_sys->i_cumulated_duration);
+
+    /* The moof we look for starts within [low, high) */
+    uint64_t i_low = p_sys->p_moov->i_pos + p_sys->p_moov->i_size;
+    uint64_t i_high = i_size;
+    stime_t i_low_time;
+    stime_t i_high_time = MP4_rescale( i_duration, p_sys->i_timescale, p_track->i_timescale );
+
+    /* The first moof gives the start time, and the fallback position */
+    uint64_t i_best_pos;
+    stime_t i_best_time;
+    if( FragProbeMoof( p_demux, i_low, i_high, p_track->i_track_ID,
+                       &i_best_pos, &i_best_time ) != VLC_SUCCESS ||
+        i_best_time > i_target )
+        return VLC_EGENERIC;
+    i_low = i_best_pos + 1;
+    i_low_time = i_best_time;
+
+    for( unsigned i_probe = 1; i_probe < FRAG_PROBE_MAX && i_low < i_high; i_probe++ )
+    {
+        /* Guess the position assuming a constant bitrate */
+        uint64_t i_pos = i_low;
+        if( i_high_time > i_low_time && i_target > i_low_time )
+        {
+            double f = (double)(i_target - i_low_time) / (i_high_time - i_low_time);
+            if( f < 1.0 )
+                i_pos += (uint64_t)( f * (i_high - i_low) );
+            else
+                i_pos = i_high - 1;
+        }
+
+        uint64_t i_moof_pos;
+        stime_t i_moof_time;
+        int i_ret = FragProbeMoof( p_demux, i_pos, i_high, p_track->i_track_ID,
+                                   &i_moof_pos, &i_moof_time );
+        if( i_ret == VLC_ENOENT )
+        {
+            /* No moof starts within the window: look before it */
+            i_high = i_pos;
+            continue;
+        }
+        if( i_ret != VLC_SUCCESS )
+            return VLC_EGENERIC;
+
+        if( i_moof_time <= i_target )
+        {
+            i_best_pos = i_moof_pos;
+            i_best_time = i_moof_time;
+            i_low = i_moof_pos + 1;
+            i_low_time = i_moof_time;
+        }
+        else
+        {
+            /* No moof starts between the probed position and this one */
+            i_high = i_pos;
+            i_high_time = i_moof_time;
+        }
+    }
+
+    *pi_moof_pos = i_best_pos;
+    *pi_sampletime = MP4_rescale_mtime( i_best_time, p_track->i_timescale );
+    return VLC_SUCCESS;
+}
+
 static void MP4_GetDefaultSizeAndDuration( MP4_Box_t *p_moov,
                                            const MP4_Box_data_tfhd_t *p_tfhd_data,
                                            uint32_t *pi_default_size,
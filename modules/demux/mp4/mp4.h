@@ -146,10 +146,16 @@ typedef struct
     mp4_chunk_t    *chunk; /* always defined  for each chunk */
 
     /* sample size, p_sample_size defined only if i_sample_size == 0
-        else i_sample_size is size for all sample */
+        else i_sample_size is size for all sample.
+        p_sample_size points to the stsz box table, which the track does
+        not own */
     uint32_t         i_sample_size;
-    uint32_t         *p_sample_size; /* XXX perhaps add file offset if take
-//                                    too much time to do sumations each time*/
+    const uint32_t   *p_sample_size;
+
+    /* last sample position found by MP4_TrackGetPos(), so that the sizes
+     * are not summed again from the start of the chunk for each sample */
+    uint32_t         i_pos_cache_sample; /* UINT32_MAX if none */
+    uint64_t         i_pos_cache;
 
     const MP4_Box_t *p_track;
     const MP4_Box_t *p_stbl;  /* will contain all timing information */
@@ -364,6 +364,8 @@ typedef struct
     float rgf_replay_gain[AUDIO_REPLAY_GAIN_MAX];
     float rgf_replay_peak[AUDIO_REPLAY_GAIN_MAX];
 
+    audio_gapless_t gapless;
+
     sync_table_t mllt;
     struct
     {
@@ -480,6 +482,7 @@ static int OpenCommon( demux_t *p_demux,
             p_fmt->audio_replay_gain.pf_peak[i] = p_sys->rgf_replay_peak[i];
         }
     }
+    p_fmt->audio_gapless = p_sys->gapless;
 
     for( ;; )
     {
@@ -1396,6 +1399,15 @@ static int MpgaInit( demux_t *p_demux )
                 p_sys->i_duration = vlc_tick_from_samples( i_total_samples - i_dropped_samples,
                                                            p_sys->mpgah.i_sample_rate );
             }
+
+            /* The encoder delay and padding from the LAME tag, the layer 3
+             * decoders add their own 529 samples delay */
+            if( xing->i_delay_samples != 0 || xing->i_padding_samples != 0 )
+            {
+                p_sys->gapless.i_priming = xing->i_delay_samples
+                                         + (p_sys->mpgah.i_layer == 3 ? 529 : 0);
+                p_sys->gapless.i_samples = i_total_samples - i_dropped_samples;
+            }
         }
 
         unsigned i_bitrate = 0;
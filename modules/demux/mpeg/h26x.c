@@ -29,12 +29,21 @@
 # include "config.h"
 #endif
 
+#include <sys/stat.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_demux.h>
 #include <vlc_codec.h>
+#include <vlc_bits.h>
+#include <vlc_cachefile.h>
+#include <vlc_fs.h>
+#include <vlc_interrupt.h>
+#include <vlc_url.h>
+#include <vlc_vector.h>
 #include "../../packetizer/hevc_nal.h" /* definitions, inline helpers */
 #include "../../packetizer/h264_nal.h" /* definitions, inline helpers */
+#include "../../packetizer/startcode_helper.h"
 
 /*****************************************************************************
  * Module descriptor
@@ -45,6 +54,10 @@ static void Close( vlc_object_t * );
 
 #define FPS_TEXT N_("Frames per Second")
 #define FPS_LONGTEXT N_("Desired frame rate for the stream.")
+#define INDEX_TEXT N_("Index keyframes")
+#define INDEX_LONGTEXT N_("Index the keyframes of local files in the " \
+    "background, and keep the index in the cache directory, for precise " \
+    "seeking.")
 
 vlc_module_begin ()
     set_shortname( "H264")
@@ -53,6 +66,7 @@ vlc_module_begin ()
     set_capability( "demux", 6 )
     set_section( N_("H264 video demuxer" ), NULL )
     add_float( "h264-fps", 0.0, FPS_TEXT, FPS_LONGTEXT )
+    add_bool( "h26x-index", true, INDEX_TEXT, INDEX_LONGTEXT )
     set_callbacks( OpenH264, Close )
     add_shortcut( "h264" )
     add_file_extension("h264")
@@ -72,6 +86,30 @@ vlc_module_end ()
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
+typedef struct
+{
+    uint64_t i_offset;  /* start of the keyframe access unit */
+    uint64_t i_picture; /* number of pictures before it */
+} h26x_keyframe_t;
+
+typedef struct
+{
+    vlc_object_t *p_obj;
+    char         *psz_url;
+    char         *psz_identity;
+    uint64_t      i_size;
+    bool          b_hevc;
+
+    vlc_thread_t     thread;
+    vlc_interrupt_t *p_interrupt;
+    bool             b_started;
+
+    vlc_mutex_t lock;
+    struct VLC_VECTOR(h26x_keyframe_t) keyframes;
+    uint64_t    i_pictures; /* pictures indexed so far */
+    bool        b_complete;
+} h26x_index_t;
+
 typedef struct
 {
     es_out_id_t *p_es;
@@ -82,6 +120,8 @@ typedef struct
     unsigned    frame_rate_den;
 
     decoder_t *p_packetizer;
+
+    h26x_index_t *p_index;
 } demux_sys_t;
 
 static int Demux( demux_t * );
@@ -230,6 +270,369 @@ static int ProbeH264( const uint8_t *p_peek, size_t i_peek, void *p_priv )
     return 0;
 }
 
+/*****************************************************************************
+ * Keyframes index
+ *****************************************************************************
+ * The file is scanned on a separate stream, looking only at the NAL headers
+ * and the first bits of the slices, to record where each keyframe access
+ * unit starts and how many pictures precede it. Once complete, the index is
+ * stored in the user cache directory, one file per URL:
+ *
+ *   vlc-h26x-index <version>
+ *   id <identity>
+ *   pictures <count>
+ *   <access unit offset> <picture number>
+ *   ...
+ *****************************************************************************/
+#define H26X_INDEX_VERSION   1
+#define H26X_INDEX_DIR       "h26x-index"
+#define H26X_INDEX_MAX_SIZE  (32 << 20) /* of the cache directory */
+#define H26X_INDEX_CHUNK     (1 << 18)
+#define H26X_INDEX_NAL_PEEK  8 /* enough for the slice fields we look at */
+
+static bool h26x_index_Load( h26x_index_t *p_index )
+{
+    FILE *p_file = vlc_cachefile_Open( H26X_INDEX_DIR, p_index->psz_url );
+    if( p_file == NULL )
+        return false;
+
+    char *psz_line = NULL;
+    size_t i_line = 0;
+    unsigned i_version;
+    uint64_t i_pictures;
+    bool b_valid = false;
+
+    const size_t i_identity = strlen( p_index->psz_identity );
+
+    if( getline( &psz_line, &i_line, p_file ) != -1 &&
+        sscanf( psz_line, "vlc-h26x-index %u", &i_version ) == 1 &&
+        i_version == H26X_INDEX_VERSION &&
+        getline( &psz_line, &i_line, p_file ) != -1 &&
+        !strncmp( psz_line, "id ", 3 ) &&
+        !strncmp( psz_line + 3, p_index->psz_identity, i_identity ) &&
+        !strcmp( psz_line + 3 + i_identity, "\n" ) &&
+        getline( &psz_line, &i_line, p_file ) != -1 &&
+        sscanf( psz_line, "pictures %"SCNu64, &i_pictures ) == 1 )
+    {
+        b_valid = true;
+        while( getline( &psz_line, &i_line, p_file ) != -1 )
+        {
+            h26x_keyframe_t kf;
+            if( sscanf( psz_line, "%"SCNu64" %"SCNu64,
+                        &kf.i_offset, &kf.i_picture ) != 2 ||
+                !vlc_vector_push( &p_index->keyframes, kf ) )
+            {
+                b_valid = false;
+                break;
+            }
+        }
+    }
+
+    free( psz_line );
+    fclose( p_file );
+
+    if( !b_valid )
+    {
+        vlc_vector_clear( &p_index->keyframes );
+        return false;
+    }
+
+    p_index->i_pictures = i_pictures;
+    p_index->b_complete = true;
+    msg_Dbg( p_index->p_obj, "%zu keyframes restored from the index cache",
+             p_index->keyframes.size );
+    return true;
+}
+
+static void h26x_index_Store( const h26x_index_t *p_index )
+{
+    vlc_cachefile_t *p_entry = vlc_cachefile_Create( p_index->p_obj,
+                                                     H26X_INDEX_DIR,
+                                                     p_index->psz_url );
+    if( p_entry == NULL )
+        return;
+
+    FILE *p_file = vlc_cachefile_GetFile( p_entry );
+
+    fprintf( p_file, "vlc-h26x-index %u\nid %s\npictures %"PRIu64"\n",
+             H26X_INDEX_VERSION, p_index->psz_identity, p_index->i_pictures );
+    h26x_keyframe_t kf;
+    vlc_vector_foreach( kf, &p_index->keyframes )
+        fprintf( p_file, "%"PRIu64" %"PRIu64"\n", kf.i_offset, kf.i_picture );
+
+    vlc_cachefile_Commit( p_entry, H26X_INDEX_MAX_SIZE );
+}
+
+/* Looks at one NAL, returns true if it starts a new picture */
+static bool h26x_index_ParseNAL( bool b_hevc, const uint8_t *p_nal,
+                                 size_t i_nal, bool *pb_vcl, bool *pb_key )
+{
+    bs_t bs;
+    *pb_vcl = false;
+    *pb_key = false;
+
+    if( b_hevc )
+    {
+        if( i_nal < 3 )
+            return false;
+        const uint8_t i_type = hevc_getNALType( p_nal );
+        if( i_type >= HEVC_NAL_VPS ) /* 32 and above are not VCL */
+            return false;
+        *pb_vcl = true;
+        *pb_key = i_type >= HEVC_NAL_BLA_W_LP && i_type <= HEVC_NAL_IRAP_VCL23;
+        return p_nal[2] & 0x80; /* first_slice_segment_in_pic_flag */
+    }
+
+    if( i_nal < 2 )
+        return false;
+    const uint8_t i_type = h264_getNALType( p_nal );
+    if( i_type != H264_NAL_SLICE && i_type != H264_NAL_SLICE_IDR )
+        return false;
+    *pb_vcl = true;
+
+    bs_init( &bs, &p_nal[1], i_nal - 1 );
+    if( bs_read_ue( &bs ) != 0 ) /* first_mb_in_slice */
+        return false;
+    const unsigned i_slice_type = bs_read_ue( &bs ) % 5;
+    *pb_key = i_type == H264_NAL_SLICE_IDR ||
+              i_slice_type == 2 /* I */ || i_slice_type == 4 /* SI */;
+    return !bs_error( &bs );
+}
+
+/* Non-VCL NALs which come at the start of an access unit */
+static bool h26x_index_IsAUPrefix( bool b_hevc, uint8_t i_header )
+{
+    if( b_hevc )
+    {
+        const uint8_t i_type = (i_header & 0x7E) >> 1;
+        return ( i_type >= HEVC_NAL_VPS && i_type <= HEVC_NAL_AUD ) ||
+                 i_type == HEVC_NAL_PREF_SEI ||
+               ( i_type >= HEVC_NAL_RSV_NVCL41 && i_type <= HEVC_NAL_RSV_NVCL44 ) ||
+               ( i_type >= HEVC_NAL_UNSPEC48 && i_type <= HEVC_NAL_UNSPEC55 );
+    }
+
+    const uint8_t i_type = i_header & 0x1F;
+    return ( i_type >= H264_NAL_SEI && i_type <= H264_NAL_AU_DELIMITER ) ||
+           ( i_type >= H264_NAL_SPS_EXT && i_type <= H264_NAL_RESERVED_18 );
+}
+
+static bool h26x_index_Scan( h26x_index_t *p_index, stream_t *s )
+{
+    uint8_t *p_buf = malloc( H26X_INDEX_CHUNK );
+    if( p_buf == NULL )
+        return false;
+
+    uint64_t i_buf_pos = 0; /* file offset of p_buf[0] */
+    size_t i_buf = 0;
+    uint64_t i_au_start = UINT64_MAX;
+    uint64_t i_pictures = 0;
+    bool b_eof = false;
+
+    while( !b_eof )
+    {
+        if( vlc_killed() )
+        {
+            free( p_buf );
+            return false;
+        }
+
+        ssize_t i_read = vlc_stream_Read( s, &p_buf[i_buf],
+                                          H26X_INDEX_CHUNK - i_buf );
+        if( i_read < 0 )
+            break;
+        b_eof = i_read == 0;
+        i_buf += i_read;
+
+        /* Keep enough data after each startcode to parse its NAL, until the
+         * end of the file */
+        const uint8_t *p_end = &p_buf[i_buf];
+        const uint8_t *p_limit = b_eof ? p_end : p_end - 3 - H26X_INDEX_NAL_PEEK;
+        const uint8_t *p = p_buf;
+
+        while( p < p_limit &&
+               (p = startcode_FindAnnexB( p, p_end )) != NULL && p < p_limit )
+        {
+            const uint8_t *p_nal = p + 3;
+            const uint64_t i_nal_pos = i_buf_pos + (p - p_buf);
+            size_t i_nal = __MIN( (size_t)(p_end - p_nal), H26X_INDEX_NAL_PEEK );
+            bool b_vcl = false, b_key;
+
+            if( i_nal > 0 &&
+                h26x_index_ParseNAL( p_index->b_hevc, p_nal, i_nal, &b_vcl, &b_key ) )
+            {
+                if( b_key )
+                {
+                    h26x_keyframe_t kf = {
+                        .i_offset = i_au_start != UINT64_MAX ? i_au_start : i_nal_pos,
+                        .i_picture = i_pictures,
+                    };
+                    vlc_mutex_lock( &p_index->lock );
+                    vlc_vector_push( &p_index->keyframes, kf );
+                    vlc_mutex_unlock( &p_index->lock );
+                }
+                i_pictures++;
+            }
+
+            if( b_vcl )
+                i_au_start = UINT64_MAX;
+            else if( i_nal > 0 && i_au_start == UINT64_MAX &&
+                     h26x_index_IsAUPrefix( p_index->b_hevc, p_nal[0] ) )
+                i_au_start = i_nal_pos;
+
+            p = p_nal;
+        }
+
+        vlc_mutex_lock( &p_index->lock );
+        p_index->i_pictures = i_pictures;
+        vlc_mutex_unlock( &p_index->lock );
+
+        /* Move the unparsed tail back to the start of the buffer */
+        if( p == NULL || p > p_limit )
+            p = p_limit;
+        const size_t i_keep = p_end - p;
+        memmove( p_buf, p, i_keep );
+        i_buf_pos += i_buf - i_keep;
+        i_buf = i_keep;
+    }
+
+    free( p_buf );
+    /* The file must not have changed while being scanned */
+    return b_eof && i_buf_pos + i_buf == p_index->i_size;
+}
+
+static void *h26x_index_Run( void *data )
+{
+    h26x_index_t *p_index = data;
+
+    vlc_thread_set_name( "vlc-h26x-index" );
+    vlc_interrupt_set( p_index->p_interrupt );
+
+    stream_t *s = vlc_stream_NewURL( p_index->p_obj, p_index->psz_url );
+    if( s == NULL )
+        return NULL;
+
+    vlc_tick_t i_start = vlc_tick_now();
+    bool b_complete = h26x_index_Scan( p_index, s );
+    vlc_stream_Delete( s );
+
+    if( b_complete )
+    {
+        msg_Dbg( p_index->p_obj, "%zu keyframes of %"PRIu64" pictures indexed "
+                 "in %"PRId64" ms", p_index->keyframes.size, p_index->i_pictures,
+                 MS_FROM_VLC_TICK( vlc_tick_now() - i_start ) );
+        h26x_index_Store( p_index );
+
+        vlc_mutex_lock( &p_index->lock );
+        p_index->b_complete = true;
+        vlc_mutex_unlock( &p_index->lock );
+    }
+    return NULL;
+}
+
+static void h26x_index_Delete( h26x_index_t *p_index )
+{
+    if( p_index->b_started )
+    {
+        vlc_interrupt_kill( p_index->p_interrupt );
+        vlc_join( p_index->thread, NULL );
+    }
+    if( p_index->p_interrupt != NULL )
+        vlc_interrupt_destroy( p_index->p_interrupt );
+    vlc_vector_destroy( &p_index->keyframes );
+    free( p_index->psz_identity );
+    free( p_index->psz_url );
+    free( p_index );
+}
+
+static h26x_index_t *h26x_index_New( demux_t *p_demux, bool b_hevc )
+{
+    bool b_fastseek;
+    uint64_t i_size;
+
+    if( p_demux->psz_url == NULL || !var_InheritBool( p_demux, "h26x-index" ) ||
+        vlc_stream_Control( p_demux->s, STREAM_CAN_FASTSEEK, &b_fastseek ) ||
+        !b_fastseek || vlc_stream_GetSize( p_demux->s, &i_size ) )
+        return NULL;
+
+    h26x_index_t *p_index = calloc( 1, sizeof(*p_index) );
+    if( unlikely(p_index == NULL) )
+        return NULL;
+
+    p_index->p_obj = VLC_OBJECT(p_demux);
+    p_index->i_size = i_size;
+    p_index->b_hevc = b_hevc;
+    vlc_mutex_init( &p_index->lock );
+    vlc_vector_init( &p_index->keyframes );
+    p_index->psz_url = strdup( p_demux->psz_url );
+
+    /* Only local files can be identified, by their size and modification
+     * time */
+    struct stat st;
+    char *psz_path = vlc_uri2path( p_demux->psz_url );
+    if( psz_path == NULL || vlc_stat( psz_path, &st ) ||
+        asprintf( &p_index->psz_identity, "%"PRIu64" %jd",
+                  i_size, (intmax_t) st.st_mtime ) == -1 )
+        p_index->psz_identity = NULL;
+    free( psz_path );
+
+    if( p_index->psz_url == NULL || p_index->psz_identity == NULL )
+    {
+        h26x_index_Delete( p_index );
+        return NULL;
+    }
+
+    if( h26x_index_Load( p_index ) )
+        return p_index;
+
+    p_index->p_interrupt = vlc_interrupt_create();
+    if( p_index->p_interrupt == NULL ||
+        vlc_clone( &p_index->thread, h26x_index_Run, p_index ) )
+    {
+        h26x_index_Delete( p_index );
+        return NULL;
+    }
+    p_index->b_started = true;
+    msg_Dbg( p_demux, "indexing keyframes in the background" );
+    return p_index;
+}
+
+/* Finds the last keyframe at or before a picture, if it was indexed */
+static bool h26x_index_Find( h26x_index_t *p_index, uint64_t i_picture,
+                             h26x_keyframe_t *p_kf )
+{
+    bool b_found = false;
+
+    vlc_mutex_lock( &p_index->lock );
+    if( p_index->b_complete || i_picture < p_index->i_pictures )
+    {
+        size_t i_low = 0, i_high = p_index->keyframes.size;
+        while( i_low < i_high )
+        {
+            size_t i_mid = i_low + (i_high - i_low) / 2;
+            if( p_index->keyframes.data[i_mid].i_picture <= i_picture )
+                i_low = i_mid + 1;
+            else
+                i_high = i_mid;
+        }
+        if( i_low > 0 )
+        {
+            *p_kf = p_index->keyframes.data[i_low - 1];
+            b_found = true;
+        }
+    }
+    vlc_mutex_unlock( &p_index->lock );
+    return b_found;
+}
+
+static bool h26x_index_GetPictures( h26x_index_t *p_index, uint64_t *pi_pictures )
+{
+    vlc_mutex_lock( &p_index->lock );
+    bool b_complete = p_index->b_complete;
+    *pi_pictures = p_index->i_pictures;
+    vlc_mutex_unlock( &p_index->lock );
+    return b_complete;
+}
+
 /*****************************************************************************
  * Shared Open code
  *****************************************************************************/
@@ -367,6 +770,8 @@ static int GenericOpen( demux_t *p_demux, const char *psz_module,
         return VLC_EGENERIC;
     }
 
+    p_sys->p_index = h26x_index_New( p_demux, i_codec == VLC_CODEC_HEVC );
+
     return VLC_SUCCESS;
 }
 
@@ -401,6 +806,8 @@ static void Close( vlc_object_t * p_this )
     demux_t     *p_demux = (demux_t*)p_this;
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    if( p_sys->p_index )
+        h26x_index_Delete( p_sys->p_index );
     demux_PacketizerDestroy( p_sys->p_packetizer );
     free( p_sys );
 }
@@ -514,15 +921,108 @@ static int Demux( demux_t *p_demux)
 /*****************************************************************************
  * Control:
  *****************************************************************************/
-static int Control( demux_t *p_demux, int i_query, va_list args )
+/* Converts between times and picture numbers, at two fields per picture */
+static uint64_t PictureFromTime( const date_t *p_date, vlc_tick_t i_time )
 {
-    /* demux_sys_t *p_sys  = p_demux->p_sys; */
-    /* FIXME calculate the bitrate */
-    if( i_query == DEMUX_SET_TIME )
+    if( i_time <= VLC_TICK_0 )
+        return 0;
+    return (uint64_t)(i_time - VLC_TICK_0) * p_date->i_divider_num
+           / ( 2 * (uint64_t) p_date->i_divider_den * CLOCK_FREQ );
+}
+
+static vlc_tick_t TimeFromPicture( const date_t *p_date, uint64_t i_picture )
+{
+    return VLC_TICK_0 + vlc_tick_from_samples( 2 * i_picture * p_date->i_divider_den,
+                                               p_date->i_divider_num );
+}
+
+static int SeekPicture( demux_t *p_demux, uint64_t i_picture, bool b_precise )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    h26x_keyframe_t kf;
+
+    if( !h26x_index_Find( p_sys->p_index, i_picture, &kf ) ||
+        vlc_stream_Seek( p_demux->s, kf.i_offset ) )
         return VLC_EGENERIC;
-    else
+
+    if( p_sys->p_packetizer->pf_flush )
+        p_sys->p_packetizer->pf_flush( p_sys->p_packetizer );
+
+    date_Set( &p_sys->output_dts, TimeFromPicture( &p_sys->output_dts, kf.i_picture ) );
+    p_sys->feed_dts = p_sys->output_dts;
+
+    if( b_precise && i_picture > kf.i_picture )
+        es_out_Control( p_demux->out, ES_OUT_SET_NEXT_DISPLAY_TIME,
+                        TimeFromPicture( &p_sys->output_dts, i_picture ) );
+    return VLC_SUCCESS;
+}
+
+static int Control( demux_t *p_demux, int i_query, va_list args )
+{
+    demux_sys_t *p_sys  = p_demux->p_sys;
+    uint64_t i_pictures;
+
+    /* Without a keyframe index, there is no way to seek by time */
+    if( p_sys->p_index == NULL )
+    {
+        /* FIXME calculate the bitrate */
+        if( i_query == DEMUX_SET_TIME )
+            return VLC_EGENERIC;
         return demux_vaControlHelper( p_demux->s,
                                        0, -1,
                                        0, 1, i_query, args );
-}
+    }
+
+    const bool b_complete = h26x_index_GetPictures( p_sys->p_index, &i_pictures );
+
+    switch( i_query )
+    {
+        case DEMUX_GET_TIME:
+            *va_arg( args, vlc_tick_t * ) = date_Get( &p_sys->output_dts );
+            return VLC_SUCCESS;
+
+        case DEMUX_GET_LENGTH:
+            if( !b_complete )
+                return VLC_EGENERIC;
+            *va_arg( args, vlc_tick_t * ) =
+                TimeFromPicture( &p_sys->output_dts, i_pictures ) - VLC_TICK_0;
+            return VLC_SUCCESS;
+
+        case DEMUX_GET_POSITION:
+        {
+            if( !b_complete || i_pictures == 0 )
+                break;
+            uint64_t i_picture = PictureFromTime( &p_sys->output_dts,
+                                                  date_Get( &p_sys->output_dts ) );
+            *va_arg( args, double * ) = (double) i_picture / i_pictures;
+            return VLC_SUCCESS;
+        }
+
+        case DEMUX_SET_TIME:
+        {
+            vlc_tick_t i_time = va_arg( args, vlc_tick_t );
+            bool b_precise = va_arg( args, int );
+            return SeekPicture( p_demux, PictureFromTime( &p_sys->output_dts, i_time ),
+                                b_precise );
+        }
 
+        case DEMUX_SET_POSITION:
+        {
+            if( !b_complete )
+                break;
+            va_list ap;
+            va_copy( ap, args ); /* don't break args for helper fallback */
+            double f_pos = va_arg( ap, double );
+            bool b_precise = va_arg( ap, int );
+            va_end( ap );
+            if( f_pos < 0.0 || f_pos > 1.0 )
+                break;
+            return SeekPicture( p_demux, f_pos * i_pictures, b_precise );
+        }
+    }
+
+    /* FIXME calculate the bitrate */
+    return demux_vaControlHelper( p_demux->s,
+                                   0, -1,
+                                   0, 1, i_query, args );
+}
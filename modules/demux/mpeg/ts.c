@@ -39,6 +39,8 @@
 #include "ts_streams.h"
 #include "ts_streams_private.h"
 #include "ts_pes.h"
+#include "ts_workers.h"
+#include "ts_psicache.h"
 #include "ts_psi.h"
 #include "ts_si.h"
 #include "ts_psip.h"
@@ -123,6 +125,18 @@ static void Close ( vlc_object_t * );
 #define TS_OFFSETFIX_TEXT   "Try to fix too early PCR (or late DTS)"
 #define TS_GENERATED_PCR_OFFSET_TEXT "Offset in ms for generated PCR"
 
+#define THREADS_TEXT N_("PES gathering threads")
+#define THREADS_LONGTEXT N_( \
+    "Number of threads gathering the PES of the selected streams, " \
+    "or 0 to gather on the demux thread. This is useful with high " \
+    "bitrate or multiple programs streams." )
+
+#define PSI_CACHE_TEXT N_("Reuse the PAT/PMT of live streams")
+#define PSI_CACHE_LONGTEXT N_( \
+    "Remember the last program tables of live streams, so that the programs " \
+    "are known at once when the same stream is opened again, e.g. when " \
+    "zapping between multicast channels." )
+
 #define PCR_TEXT N_("Trust in-stream PCR")
 #define PCR_LONGTEXT N_("Use the stream PCR as a reference.")
 
@@ -163,6 +177,9 @@ vlc_module_begin ()
     add_bool( "ts-pcr-offsetfix", true, TS_OFFSETFIX_TEXT, NULL )
     add_integer_with_range( "ts-generated-pcr-offset", 120, 0, 500,
                             TS_GENERATED_PCR_OFFSET_TEXT, NULL )
+    add_integer_with_range( "ts-threads", 0, 0, 32,
+                            THREADS_TEXT, THREADS_LONGTEXT )
+    add_bool( "ts-psi-cache", true, PSI_CACHE_TEXT, PSI_CACHE_LONGTEXT )
 
     set_capability( "demux", 10 )
     set_callbacks( Open, Close )
@@ -191,9 +208,12 @@ static stime_t GetPCR( const block_t * );
 static block_t * ProcessTSPacket( demux_t *p_demux, ts_pid_t *pid, block_t *p_pkt, int * );
 static bool GatherSectionsData( demux_t *p_demux, ts_pid_t *, block_t *, size_t );
 static bool GatherPESData( demux_t *p_demux, ts_pid_t *, block_t *, size_t );
+static void QueuePESData( demux_t *p_demux, ts_pid_t *, block_t *, size_t );
+static void PESDataChainHandle( vlc_object_t *, void *, block_t *, uint32_t, stime_t );
 static void ProgramSetPCR( demux_t *p_demux, ts_pmt_t *p_prg, stime_t i_pcr );
 
 static block_t* ReadTSPacket( demux_t *p_demux );
+static block_t* ReadTSPacketDescrambled( demux_t *p_demux );
 static int SeekToTime( demux_t *p_demux, const ts_pmt_t *, stime_t time );
 static void ReadyQueuesPostSeek( demux_t *p_demux );
 static void PCRHandle( demux_t *p_demux, ts_pid_t *, stime_t );
@@ -362,6 +382,17 @@ static int DetectPVRHeadersAndHeaderSize( demux_t *p_demux, unsigned *pi_header_
 /*****************************************************************************
  * Open
  *****************************************************************************/
+static void ReplayPSIPacket( void *opaque, uint16_t i_pid, const uint8_t *p_pkt )
+{
+    demux_t *p_demux = opaque;
+    demux_sys_t *p_sys = p_demux->p_sys;
+    ts_pid_t *p_pid = GetPID( p_sys, i_pid );
+
+    /* Stale PMT are ignored, as they are not declared by the PAT */
+    if( p_pid->type == TYPE_PAT || p_pid->type == TYPE_PMT )
+        ts_psi_Packet_Push( p_pid, p_pkt );
+}
+
 static int Open( vlc_object_t *p_this )
 {
     demux_t     *p_demux = (demux_t*)p_this;
@@ -405,7 +436,11 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_packet_size = i_packet_size;
     p_sys->i_packet_header_size = i_packet_header_size;
     p_sys->i_ts_read = 50;
+    p_sys->p_workers = NULL;
+    p_sys->p_psicache = NULL;
     p_sys->csa = NULL;
+    p_sys->csa_batch.p_head = NULL;
+    p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
     p_sys->b_start_record = false;
     p_sys->record_dir_path = NULL;
 
@@ -542,6 +577,33 @@ static int Open( vlc_object_t *p_this )
     else
         p_sys->es_creation = CREATE_ES;
 
+    unsigned i_threads = var_InheritInteger( p_demux, "ts-threads" );
+    if( i_threads > 0 && !p_demux->b_preparsing )
+    {
+        ts_pes_parse_callback cb = { .p_obj = VLC_OBJECT(p_demux),
+                                     .pf_parse = PESDataChainHandle };
+        p_sys->p_workers = ts_workers_New( VLC_OBJECT(p_demux), i_threads, &cb );
+        if( p_sys->p_workers )
+        {
+            /* Amortize the threads synchronization over more packets */
+            p_sys->i_ts_read = TS_WORKERS_READ;
+            msg_Dbg( p_demux, "gathering PES with %u threads", i_threads );
+        }
+    }
+
+    if( !p_sys->b_canseek && !p_demux->b_preparsing && p_demux->psz_url != NULL
+     && var_InheritBool( p_demux, "ts-psi-cache" ) )
+    {
+        p_sys->p_psicache = ts_psi_cache_New( p_demux->psz_url );
+        if( p_sys->p_psicache )
+        {
+            unsigned i_tables = ts_psi_cache_Replay( p_sys->p_psicache,
+                                                     ReplayPSIPacket, p_demux );
+            if( i_tables > 0 )
+                msg_Dbg( p_demux, "%u cached PSI tables replayed", i_tables );
+        }
+    }
+
     /* Preparse time */
     if( p_demux->b_preparsing && p_sys->b_canseek )
     {
@@ -567,6 +629,11 @@ static void Close( vlc_object_t *p_this )
     demux_t     *p_demux = (demux_t*)p_this;
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    if( p_sys->p_workers )
+        ts_workers_Delete( p_sys->p_workers );
+    if( p_sys->p_psicache )
+        ts_psi_cache_Delete( p_sys->p_psicache );
+
     PIDRelease( p_demux, GetPID(p_sys, 0) );
 
     vlc_mutex_lock( &p_sys->csa_lock );
@@ -577,6 +644,7 @@ static void Close( vlc_object_t *p_this )
         csa_Delete( p_sys->csa );
     }
     vlc_mutex_unlock( &p_sys->csa_lock );
+    block_ChainRelease( p_sys->csa_batch.p_head );
 
     ARRAY_RESET( p_sys->programs );
 
@@ -646,8 +714,10 @@ static int Demux( demux_t *p_demux )
         bool         b_frame = false;
         int          i_header = 0;
         block_t     *p_pkt;
-        if( !(p_pkt = ReadTSPacket( p_demux )) )
+        if( !(p_pkt = ReadTSPacketDescrambled( p_demux )) )
         {
+            if( p_sys->p_workers )
+                ts_workers_Flush( p_sys->p_workers );
             return VLC_DEMUXER_EOF;
         }
 
@@ -699,7 +769,14 @@ static int Demux( demux_t *p_demux )
         /* Adaptation field cannot be scrambled */
         stime_t i_pcr = GetPCR( p_pkt );
         if( i_pcr >= 0 )
+        {
+            /* The queued PES predate that PCR, and must be sent before it
+             * moves the program clock. Any output ends this demux call, as
+             * completing a frame does without workers. */
+            if( p_sys->p_workers )
+                b_frame = ts_workers_Flush( p_sys->p_workers );
             PCRHandle( p_demux, p_pid, i_pcr );
+        }
 
         /* Probe streams to build PAT/PMT after MIN_PAT_INTERVAL in case we don't see any PAT */
         if( !SEEN( GetPID( p_sys, 0 ) ) &&
@@ -715,6 +792,9 @@ static int Demux( demux_t *p_demux )
         case TYPE_PAT:
         case TYPE_PMT:
             /* PAT and PMT are not allowed to be scrambled */
+            if( p_sys->p_psicache && !(p_pkt->i_flags & BLOCK_FLAG_CORRUPTED) )
+                ts_psi_cache_Record( p_sys->p_psicache, p_pid->i_pid,
+                                     p_pkt->p_buffer );
             ts_psi_Packet_Push( p_pid, p_pkt->p_buffer );
             block_Release( p_pkt );
             break;
@@ -739,11 +819,14 @@ static int Demux( demux_t *p_demux )
 
             if( p_pid->u.p_stream->transport == TS_TRANSPORT_PES )
             {
-                b_frame = GatherPESData( p_demux, p_pid, p_pkt, i_header );
+                if( p_sys->p_workers )
+                    QueuePESData( p_demux, p_pid, p_pkt, i_header );
+                else
+                    b_frame = GatherPESData( p_demux, p_pid, p_pkt, i_header );
             }
             else if( p_pid->u.p_stream->transport == TS_TRANSPORT_SECTIONS )
             {
-                b_frame = GatherSectionsData( p_demux, p_pid, p_pkt, i_header );
+                b_frame |= GatherSectionsData( p_demux, p_pid, p_pkt, i_header );
             }
             else // pid->u.p_pes->transport == TS_TRANSPORT_IGNORE
             {
@@ -775,6 +858,9 @@ static int Demux( demux_t *p_demux )
             break;
     }
 
+    if( p_sys->p_workers )
+        ts_workers_Flush( p_sys->p_workers );
+
     demux_UpdateTitleFromStream( p_demux );
     return VLC_DEMUXER_SUCCESS;
 }
@@ -1833,35 +1919,43 @@ static block_t* ReadTSPacket( demux_t *p_demux )
     {
         msg_Warn( p_demux, "lost synchro" );
         block_Release( p_pkt );
+        const unsigned i_header = p_sys->i_packet_header_size;
         for( ;; )
         {
             const uint8_t *p_peek;
             int i_peek = 0;
-            unsigned i_skip = 0;
 
             i_peek = vlc_stream_Peek( p_sys->stream, &p_peek,
                     p_sys->i_packet_size * 10 );
-            if( i_peek < 0 || (unsigned)i_peek < p_sys->i_packet_size + 1 )
+            if( i_peek < 0 || (unsigned)i_peek < p_sys->i_packet_size + i_header + 1 )
             {
                 msg_Dbg( p_demux, "eof ?" );
                 return NULL;
             }
 
-            while( i_skip < i_peek - p_sys->i_packet_size )
+            /* Look for two consecutive sync bytes */
+            const unsigned i_max = i_peek - p_sys->i_packet_size - i_header;
+            unsigned i_skip = 0;
+            while( i_skip < i_max )
             {
-                if( p_peek[i_skip + p_sys->i_packet_header_size] == 0x47 &&
-                        p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
+                const uint8_t *p_sync = memchr( &p_peek[i_skip + i_header],
+                                                0x47, i_max - i_skip );
+                if( p_sync == NULL )
                 {
+                    i_skip = i_max;
                     break;
                 }
+                i_skip = p_sync - p_peek - i_header;
+                if( p_sync[p_sys->i_packet_size] == 0x47 )
+                    break;
                 i_skip++;
             }
-            msg_Dbg( p_demux, "skipping %d bytes of garbage at %"PRIu64,
+            msg_Dbg( p_demux, "skipping %u bytes of garbage at %"PRIu64,
                      i_skip, vlc_stream_Tell( p_sys->stream ) );
             if (vlc_stream_Read( p_sys->stream, NULL, i_skip ) != i_skip)
                 return NULL;
 
-            if( i_skip < i_peek - p_sys->i_packet_size )
+            if( i_skip < i_max )
             {
                 break;
             }
@@ -1876,6 +1970,51 @@ static block_t* ReadTSPacket( demux_t *p_demux )
     return p_pkt;
 }
 
+/* Reads packets ahead when descrambling, so that they are descrambled
+ * together */
+static block_t* ReadTSPacketDescrambled( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( p_sys->csa == NULL )
+        return ReadTSPacket( p_demux );
+
+    if( p_sys->csa_batch.p_head == NULL )
+    {
+        uint8_t *pkts[CSA_BATCH_SIZE];
+        size_t i_count = 0;
+
+        p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
+        for( unsigned i = 0; i < CSA_BATCH_SIZE; i++ )
+        {
+            block_t *p_pkt = ReadTSPacket( p_demux );
+            if( p_pkt == NULL )
+                break;
+
+            /* Truncated packets are rejected later on */
+            if( p_pkt->i_buffer >= TS_PACKET_SIZE_188 &&
+                (p_pkt->p_buffer[3]&0x80) )
+                pkts[i_count++] = p_pkt->p_buffer;
+            block_ChainLastAppend( &p_sys->csa_batch.pp_last, p_pkt );
+        }
+
+        if( i_count > 0 )
+        {
+            vlc_mutex_lock( &p_sys->csa_lock );
+            csa_DecryptBatch( p_sys->csa, pkts, i_count, p_sys->i_csa_pkt_size );
+            vlc_mutex_unlock( &p_sys->csa_lock );
+        }
+    }
+
+    block_t *p_pkt = p_sys->csa_batch.p_head;
+    if( p_pkt != NULL )
+    {
+        p_sys->csa_batch.p_head = p_pkt->p_next;
+        p_pkt->p_next = NULL;
+    }
+    return p_pkt;
+}
+
 static stime_t GetPCR( const block_t *p_pkt )
 {
     const uint8_t *p = p_pkt->p_buffer;
@@ -1949,6 +2088,11 @@ static void ReadyQueuesPostSeek( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
 
+    /* Packets read ahead of the previous position */
+    block_ChainRelease( p_sys->csa_batch.p_head );
+    p_sys->csa_batch.p_head = NULL;
+    p_sys->csa_batch.pp_last = &p_sys->csa_batch.p_head;
+
     ts_pat_t *p_pat = GetPID(p_sys, 0)->u.p_pat;
     for( int i=0; i< p_pat->programs.i_size; i++ )
     {
@@ -2690,6 +2834,22 @@ static bool GatherPESData( demux_t *p_demux, ts_pid_t *p_pid, block_t *p_pkt, si
                           i_append_pcr );
 }
 
+static void QueuePESData( demux_t *p_demux, ts_pid_t *p_pid, block_t *p_pkt, size_t i_skip )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    const bool b_unit_start = p_pkt->p_buffer[1]&0x40;
+    p_pkt->p_buffer += i_skip; /* point to PES */
+    p_pkt->i_buffer -= i_skip;
+
+    /* The PCR is sampled now, as it will have moved on once gathered */
+    const ts_es_t *p_es = p_pid->u.p_stream->p_es;
+    stime_t i_append_pcr = ( p_es && p_es->p_program )
+                         ? p_es->p_program->pcr.i_current : TS_TICK_UNKNOWN;
+
+    ts_workers_Gather( p_sys->p_workers, p_pid, p_pkt, b_unit_start,
+                       p_sys->b_valid_scrambling, i_append_pcr );
+}
+
 static bool GatherSectionsData( demux_t *p_demux, ts_pid_t *p_pid, block_t *p_pkt, size_t i_skip )
 {
     VLC_UNUSED(i_skip); VLC_UNUSED(p_demux);
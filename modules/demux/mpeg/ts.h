@@ -24,6 +24,8 @@
     typedef struct arib_instance_t arib_instance_t;
 #endif
 typedef struct csa_t csa_t;
+typedef struct ts_workers_t ts_workers_t;
+typedef struct ts_psi_cache_t ts_psi_cache_t;
 
 #define TS_USER_PMT_NUMBER (0)
 
@@ -70,6 +72,12 @@ struct demux_sys_t
     /* how many TS packet we read at once */
     unsigned    i_ts_read;
 
+    /* PES gathering threads, if any */
+    ts_workers_t *p_workers;
+
+    /* PAT/PMT recorder for the next opening of a live stream, if any */
+    ts_psi_cache_t *p_psicache;
+
     bool        b_cc_check;
     bool        b_ignore_time_for_positions;
 
@@ -100,6 +108,11 @@ struct demux_sys_t
 
     csa_t       *csa;
     int         i_csa_pkt_size;
+    struct
+    {
+        block_t *p_head;
+        block_t **pp_last;
+    } csa_batch; /* packets read ahead and descrambled together */
     bool        b_split_es;
     bool        b_valid_scrambling;
 
@@ -44,7 +44,7 @@ static bool block_Split( block_t **pp_block, block_t **pp_remain, size_t i_offse
     {
         if( i_offset > 0 )
         {
-            p_split = block_Alloc( i_offset );
+            p_split = block_AllocPooled( i_offset );
             if( p_split == NULL )
                 return false;
             memcpy( p_split->p_buffer, p_block->p_buffer, i_offset );
@@ -58,7 +58,7 @@ static bool block_Split( block_t **pp_block, block_t **pp_remain, size_t i_offse
     {
         if( i_tocopy > 0 )
         {
-            p_split = block_Alloc( i_tocopy );
+            p_split = block_AllocPooled( i_tocopy );
             if( p_split == NULL )
                 return false;
             memcpy( p_split->p_buffer, &p_block->p_buffer[i_offset], i_tocopy );
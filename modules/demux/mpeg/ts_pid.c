@@ -42,8 +42,10 @@ void ts_pid_list_Init( ts_pid_list_t *p_list )
     p_list->pp_all = NULL;
     p_list->i_all = 0;
     p_list->i_all_alloc = 0;
-    p_list->i_last_pid = 0;
-    p_list->p_last = NULL;
+    memset( p_list->index, 0, sizeof(p_list->index) );
+    p_list->index[0] = &p_list->pat;
+    p_list->index[0x1FFB] = &p_list->base_si;
+    p_list->index[0x1FFF] = &p_list->dummy;
 }
 
 void ts_pid_list_Release( demux_t *p_demux, ts_pid_list_t *p_list )
@@ -80,22 +82,13 @@ static int ts_bsearch_searchkey_Compare( const void *key, const void *other )
 
 ts_pid_t * ts_pid_Get( ts_pid_list_t *p_list, uint16_t i_pid )
 {
-    switch( i_pid )
-    {
-        case 0:
-            return &p_list->pat;
-        case 0x1FFB:
-            return &p_list->base_si;
-        case 0x1FFF:
-            return &p_list->dummy;
-        default:
-            if( p_list->i_last_pid == i_pid )
-                return p_list->p_last;
-        break;
-    }
+    assert( i_pid < TS_PID_COUNT );
+    ts_pid_t *p_pid = p_list->index[i_pid];
+    if( likely(p_pid != NULL) )
+        return p_pid;
 
+    /* First use: keep the PID list sorted for iteration */
     size_t i_index = 0;
-    ts_pid_t *p_pid = NULL;
 
     if( p_list->pp_all )
     {
@@ -152,8 +145,7 @@ ts_pid_t * ts_pid_Get( ts_pid_list_t *p_list, uint16_t i_pid )
 
     }
 
-    p_list->p_last = p_pid;
-    p_list->i_last_pid = i_pid;
+    p_list->index[i_pid] = p_pid;
 
     return p_pid;
 }
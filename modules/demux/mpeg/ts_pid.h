@@ -85,6 +85,8 @@ struct ts_pid_t
 
 };
 
+#define TS_PID_COUNT 0x2000
+
 struct ts_pid_list_t
 {
     ts_pid_t   pat;
@@ -94,10 +96,8 @@ struct ts_pid_list_t
     ts_pid_t **pp_all;
     int        i_all;
     int        i_all_alloc;
-    /* last recently used */
-    uint16_t   i_last_pid;
-    ts_pid_t  *p_last;
-
+    /* direct lookup of all the allocated ones */
+    ts_pid_t  *index[TS_PID_COUNT];
 };
 
 /* opacified pid list */
@@ -39,6 +39,8 @@
 #include "ts_pid.h"
 #include "ts_streams_private.h"
 #include "ts.h"
+#include "ts_pes.h"
+#include "ts_workers.h"
 
 #include "ts_strings.h"
 
@@ -95,6 +97,10 @@ static void PATCallBack( void *data, dvbpsi_pat_t *p_dvbpsipat )
 
     msg_Dbg( p_demux, "PATCallBack called" );
 
+    /* Programs and their streams can be deleted */
+    if( p_sys->p_workers )
+        ts_workers_Flush( p_sys->p_workers );
+
     if(unlikely( GetPID(p_sys, 0)->type != TYPE_PAT ))
     {
         msg_Warn( p_demux, "PATCallBack called on invalid pid" );
@@ -1851,6 +1857,10 @@ static void PMTCallBack( void *data, dvbpsi_pmt_t *p_dvbpsipmt )
 
     msg_Dbg( p_demux, "PMTCallBack called for program %d", p_dvbpsipmt->i_program_number );
 
+    /* Streams can be deleted or reassigned */
+    if( p_sys->p_workers )
+        ts_workers_Flush( p_sys->p_workers );
+
     if (unlikely(GetPID(p_sys, 0)->type != TYPE_PAT))
     {
         assert(GetPID(p_sys, 0)->type == TYPE_PAT);
@@ -0,0 +1,262 @@
+/*****************************************************************************
+ * ts_psicache.c: Transport Stream input module for VLC.
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include "ts_psicache.h"
+
+#define PSI_PACKET_SIZE 188
+/* A PSI section is at most 1024 bytes */
+#define PSI_CACHE_PACKETS 8
+#define PSI_CACHE_TABLES  16
+#define PSI_CACHE_URLS    16
+
+typedef struct
+{
+    uint16_t i_pid;
+    uint8_t  i_count;
+    uint8_t  pkts[PSI_CACHE_PACKETS][PSI_PACKET_SIZE];
+} ts_psi_cache_table_t;
+
+typedef struct
+{
+    char    *psz_url;
+    uint64_t i_use;
+    unsigned i_tables;
+    ts_psi_cache_table_t tables[PSI_CACHE_TABLES];
+} ts_psi_cache_entry_t;
+
+typedef struct
+{
+    ts_psi_cache_table_t table;
+    size_t i_need; /* section bytes */
+    size_t i_have;
+    bool   b_active;
+} ts_psi_cache_slot_t;
+
+struct ts_psi_cache_t
+{
+    char *psz_url;
+    unsigned i_slots;
+    ts_psi_cache_slot_t slots[PSI_CACHE_TABLES];
+};
+
+static vlc_mutex_t cache_lock = VLC_STATIC_MUTEX;
+static ts_psi_cache_entry_t *cache[PSI_CACHE_URLS];
+static uint64_t cache_use;
+
+/* Returns the payload offset of the packet, or 0 if it has none */
+static size_t PayloadOffset( const uint8_t *p_pkt )
+{
+    size_t i_offset = 4;
+
+    if( !(p_pkt[3] & 0x10) )
+        return 0;
+    if( p_pkt[3] & 0x20 )
+        i_offset += 1 + p_pkt[4];
+    return i_offset < PSI_PACKET_SIZE ? i_offset : 0;
+}
+
+static ts_psi_cache_entry_t *GetEntryLocked( const char *psz_url, bool b_create )
+{
+    ts_psi_cache_entry_t **pp_oldest = &cache[0];
+
+    for( size_t i = 0; i < PSI_CACHE_URLS; i++ )
+    {
+        if( cache[i] == NULL )
+        {
+            pp_oldest = &cache[i];
+            continue;
+        }
+        if( !strcmp( cache[i]->psz_url, psz_url ) )
+        {
+            cache[i]->i_use = ++cache_use;
+            return cache[i];
+        }
+        if( *pp_oldest != NULL && cache[i]->i_use < (*pp_oldest)->i_use )
+            pp_oldest = &cache[i];
+    }
+
+    if( !b_create )
+        return NULL;
+
+    ts_psi_cache_entry_t *p_entry = *pp_oldest;
+    if( p_entry == NULL )
+    {
+        p_entry = malloc( sizeof(*p_entry) );
+        if( unlikely(p_entry == NULL) )
+            return NULL;
+    }
+    else
+        free( p_entry->psz_url );
+
+    p_entry->psz_url = strdup( psz_url );
+    if( unlikely(p_entry->psz_url == NULL) )
+    {
+        free( p_entry );
+        *pp_oldest = NULL;
+        return NULL;
+    }
+    p_entry->i_use = ++cache_use;
+    p_entry->i_tables = 0;
+    *pp_oldest = p_entry;
+    return p_entry;
+}
+
+static void Store( ts_psi_cache_t *p_cache, const ts_psi_cache_table_t *p_table )
+{
+    vlc_mutex_lock( &cache_lock );
+    ts_psi_cache_entry_t *p_entry = GetEntryLocked( p_cache->psz_url, true );
+    if( p_entry != NULL )
+    {
+        unsigned i = 0;
+        while( i < p_entry->i_tables && p_entry->tables[i].i_pid != p_table->i_pid )
+            i++;
+        if( i < PSI_CACHE_TABLES )
+        {
+            p_entry->tables[i] = *p_table;
+            if( i == p_entry->i_tables )
+                p_entry->i_tables++;
+        }
+    }
+    vlc_mutex_unlock( &cache_lock );
+}
+
+ts_psi_cache_t *ts_psi_cache_New( const char *psz_url )
+{
+    ts_psi_cache_t *p_cache = malloc( sizeof(*p_cache) );
+    if( unlikely(p_cache == NULL) )
+        return NULL;
+
+    p_cache->psz_url = strdup( psz_url );
+    if( unlikely(p_cache->psz_url == NULL) )
+    {
+        free( p_cache );
+        return NULL;
+    }
+    p_cache->i_slots = 0;
+    return p_cache;
+}
+
+void ts_psi_cache_Delete( ts_psi_cache_t *p_cache )
+{
+    free( p_cache->psz_url );
+    free( p_cache );
+}
+
+void ts_psi_cache_Record( ts_psi_cache_t *p_cache, uint16_t i_pid,
+                          const uint8_t *p_pkt )
+{
+    unsigned i = 0;
+    while( i < p_cache->i_slots && p_cache->slots[i].table.i_pid != i_pid )
+        i++;
+    if( i == p_cache->i_slots )
+    {
+        if( i == PSI_CACHE_TABLES )
+            return;
+        p_cache->i_slots++;
+        p_cache->slots[i].table.i_pid = i_pid;
+        p_cache->slots[i].b_active = false;
+    }
+
+    ts_psi_cache_slot_t *p_slot = &p_cache->slots[i];
+    ts_psi_cache_table_t *p_table = &p_slot->table;
+    size_t i_offset = PayloadOffset( p_pkt );
+    if( i_offset == 0 )
+        return;
+
+    if( p_pkt[1] & 0x40 ) /* payload_unit_start_indicator */
+    {
+        size_t i_section = i_offset + 1 + p_pkt[i_offset];
+
+        p_slot->b_active = false;
+        /* Needs the whole section header up to last_section_number */
+        if( i_section + 8 > PSI_PACKET_SIZE )
+            return;
+        /* Multiple sections tables are not cached */
+        if( p_pkt[i_section + 6] != 0 || p_pkt[i_section + 7] != 0 )
+            return;
+
+        p_slot->i_need = 3 + (((p_pkt[i_section + 1] & 0x0F) << 8)
+                              | p_pkt[i_section + 2]);
+        p_slot->i_have = PSI_PACKET_SIZE - i_section;
+        p_table->i_count = 0;
+        p_slot->b_active = true;
+    }
+    else if( p_slot->b_active )
+    {
+        if( p_table->i_count == PSI_CACHE_PACKETS )
+        {
+            p_slot->b_active = false;
+            return;
+        }
+        p_slot->i_have += PSI_PACKET_SIZE - i_offset;
+    }
+    else
+        return;
+
+    memcpy( p_table->pkts[p_table->i_count++], p_pkt, PSI_PACKET_SIZE );
+
+    if( p_slot->i_have >= p_slot->i_need )
+    {
+        p_slot->b_active = false;
+        Store( p_cache, p_table );
+    }
+}
+
+unsigned ts_psi_cache_Replay( ts_psi_cache_t *p_cache,
+                              ts_psi_cache_replay_cb cb, void *opaque )
+{
+    ts_psi_cache_table_t *p_tables = NULL;
+    unsigned i_tables = 0;
+
+    /* Copy the tables, as the callback will create the programs */
+    vlc_mutex_lock( &cache_lock );
+    const ts_psi_cache_entry_t *p_entry = GetEntryLocked( p_cache->psz_url, false );
+    if( p_entry != NULL && p_entry->i_tables > 0 )
+    {
+        p_tables = vlc_alloc( p_entry->i_tables, sizeof(*p_tables) );
+        if( likely(p_tables != NULL) )
+        {
+            i_tables = p_entry->i_tables;
+            memcpy( p_tables, p_entry->tables, i_tables * sizeof(*p_tables) );
+        }
+    }
+    vlc_mutex_unlock( &cache_lock );
+
+    /* The PAT declares the PMT PIDs */
+    for( int i_pass = 0; i_pass < 2; i_pass++ )
+    {
+        for( unsigned i = 0; i < i_tables; i++ )
+        {
+            const ts_psi_cache_table_t *p_table = &p_tables[i];
+            if( (p_table->i_pid == 0) != (i_pass == 0) )
+                continue;
+            for( unsigned j = 0; j < p_table->i_count; j++ )
+                cb( opaque, p_table->i_pid, p_table->pkts[j] );
+        }
+    }
+
+    free( p_tables );
+    return i_tables;
+}
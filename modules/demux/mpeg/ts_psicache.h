@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * ts_psicache.h: Transport Stream input module for VLC.
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_TS_PSICACHE_H
+#define VLC_TS_PSICACHE_H
+
+/*
+ * Process-wide cache of the last PAT and PMT packets seen for a live URL.
+ *
+ * Replaying them when the same URL is opened again gives the programs and
+ * their ES at once, instead of waiting for the next tables in the stream,
+ * which matters when zapping between multicast channels. Only the tables
+ * made of a single section are cached. The cached tables are overridden by
+ * the stream ones as soon as their version changes.
+ */
+typedef struct ts_psi_cache_t ts_psi_cache_t;
+
+typedef void (*ts_psi_cache_replay_cb)( void *, uint16_t i_pid,
+                                        const uint8_t *p_pkt );
+
+ts_psi_cache_t *ts_psi_cache_New( const char *psz_url );
+void ts_psi_cache_Delete( ts_psi_cache_t * );
+
+/**
+ * Records a 188 bytes PAT or PMT packet.
+ *
+ * The table is stored once all the packets of its section are recorded.
+ */
+void ts_psi_cache_Record( ts_psi_cache_t *, uint16_t i_pid,
+                          const uint8_t *p_pkt );
+
+/**
+ * Replays the cached packets of the URL, PAT first.
+ *
+ * \return the number of tables replayed
+ */
+unsigned ts_psi_cache_Replay( ts_psi_cache_t *, ts_psi_cache_replay_cb,
+                              void *opaque );
+
+#endif
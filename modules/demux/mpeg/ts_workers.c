@@ -0,0 +1,287 @@
+/*****************************************************************************
+ * ts_workers.c: Transport Stream input module for VLC.
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_demux.h>
+#include <vlc_vector.h>
+
+#include "ts_streams.h"
+#include "ts_pid.h"
+#include "ts_streams_private.h"
+
+#include "ts_pes.h"
+#include "ts_workers.h"
+
+#include <assert.h>
+
+typedef struct
+{
+    ts_pid_t *p_pid;
+    block_t  *p_block;     /* input TS payload, or output PES */
+    stime_t   i_append_pcr;
+    uint32_t  i_flags;     /* output PES flags */
+    uint32_t  i_es_flags;  /* output ES flags, set before the PES */
+    bool      b_unit_start;
+    bool      b_valid_scrambling;
+} ts_worker_item_t;
+
+typedef struct VLC_VECTOR(ts_worker_item_t) ts_worker_items_t;
+
+typedef struct
+{
+    ts_workers_t *p_owner;
+    vlc_thread_t thread;
+    vlc_sem_t    start;
+    vlc_sem_t    done;
+    bool         b_busy;
+    ts_pid_t    *p_current;
+    ts_worker_items_t in;
+    ts_worker_items_t out;
+} ts_worker_t;
+
+struct ts_workers_t
+{
+    vlc_object_t *p_obj;
+    ts_pes_parse_callback cb;
+    bool b_pending;
+    bool b_quit;
+    unsigned i_threads;
+    ts_worker_t threads[];
+};
+
+static uint32_t TakeESFlags( ts_pid_t *p_pid )
+{
+    ts_es_t *p_es = p_pid->u.p_stream->p_es;
+    if( p_es == NULL )
+        return 0;
+    uint32_t i_flags = p_es->i_next_block_flags;
+    p_es->i_next_block_flags = 0;
+    return i_flags;
+}
+
+static void WorkerOutput( ts_worker_t *p_worker, block_t *p_data,
+                          uint32_t i_flags, stime_t i_append_pcr )
+{
+    ts_worker_item_t item = {
+        .p_pid = p_worker->p_current,
+        .p_block = p_data,
+        .i_append_pcr = i_append_pcr,
+        .i_flags = i_flags,
+        /* Gathering sets the ES flags for the next PES output, which must
+         * happen in order on the demux thread */
+        .i_es_flags = TakeESFlags( p_worker->p_current ),
+    };
+
+    if( !vlc_vector_push( &p_worker->out, item ) )
+        block_ChainRelease( p_data );
+}
+
+static void WorkerParse( vlc_object_t *p_obj, void *priv, block_t *p_data,
+                         uint32_t i_flags, stime_t i_append_pcr )
+{
+    VLC_UNUSED(p_obj);
+    /* Do the largest copy here, and not on the demux thread */
+    p_data = block_ChainGather( p_data );
+    if( p_data != NULL )
+        WorkerOutput( priv, p_data, i_flags, i_append_pcr );
+}
+
+static void *WorkerThread( void *data )
+{
+    ts_worker_t *p_worker = data;
+    ts_workers_t *p_owner = p_worker->p_owner;
+    ts_pes_parse_callback cb = { .p_obj = p_owner->p_obj,
+                                 .priv = p_worker,
+                                 .pf_parse = WorkerParse };
+
+    vlc_thread_set_name( "vlc-ts-worker" );
+
+    for( ;; )
+    {
+        vlc_sem_wait( &p_worker->start );
+        if( p_owner->b_quit )
+            break;
+
+        for( size_t j = 0; j < p_worker->in.size; j++ )
+        {
+            const ts_worker_item_t *p_item = &p_worker->in.data[j];
+            p_worker->p_current = p_item->p_pid;
+            ts_pes_Gather( &cb, p_item->p_pid->u.p_stream, p_item->p_block,
+                           p_item->b_unit_start, p_item->b_valid_scrambling,
+                           p_item->i_append_pcr );
+
+            /* Flags for a PES that is not complete yet */
+            if( p_item->p_pid->u.p_stream->p_es &&
+                p_item->p_pid->u.p_stream->p_es->i_next_block_flags )
+                WorkerOutput( p_worker, NULL, 0, VLC_TICK_INVALID );
+        }
+
+        vlc_sem_post( &p_worker->done );
+    }
+
+    return NULL;
+}
+
+ts_workers_t *ts_workers_New( vlc_object_t *p_obj, unsigned i_threads,
+                              const ts_pes_parse_callback *cb )
+{
+    ts_workers_t *p_workers = malloc( sizeof(*p_workers) +
+                                      i_threads * sizeof(ts_worker_t) );
+    if( unlikely(p_workers == NULL) )
+        return NULL;
+
+    p_workers->p_obj = p_obj;
+    p_workers->cb = *cb;
+    p_workers->b_pending = false;
+    p_workers->b_quit = false;
+    p_workers->i_threads = 0;
+
+    for( unsigned i = 0; i < i_threads; i++ )
+    {
+        ts_worker_t *p_worker = &p_workers->threads[i];
+
+        p_worker->p_owner = p_workers;
+        p_worker->b_busy = false;
+        p_worker->p_current = NULL;
+        vlc_sem_init( &p_worker->start, 0 );
+        vlc_sem_init( &p_worker->done, 0 );
+        vlc_vector_init( &p_worker->in );
+        vlc_vector_init( &p_worker->out );
+
+        if( vlc_clone( &p_worker->thread, WorkerThread, p_worker ) )
+        {
+            vlc_vector_destroy( &p_worker->in );
+            vlc_vector_destroy( &p_worker->out );
+            break;
+        }
+        p_workers->i_threads++;
+    }
+
+    if( p_workers->i_threads == 0 )
+    {
+        free( p_workers );
+        return NULL;
+    }
+
+    return p_workers;
+}
+
+void ts_workers_Delete( ts_workers_t *p_workers )
+{
+    ts_workers_Flush( p_workers );
+
+    p_workers->b_quit = true;
+    for( unsigned i = 0; i < p_workers->i_threads; i++ )
+        vlc_sem_post( &p_workers->threads[i].start );
+
+    for( unsigned i = 0; i < p_workers->i_threads; i++ )
+    {
+        ts_worker_t *p_worker = &p_workers->threads[i];
+
+        vlc_join( p_worker->thread, NULL );
+        vlc_vector_destroy( &p_worker->in );
+        vlc_vector_destroy( &p_worker->out );
+    }
+
+    free( p_workers );
+}
+
+void ts_workers_Gather( ts_workers_t *p_workers, ts_pid_t *p_pid, block_t *p_pkt,
+                        bool b_unit_start, bool b_valid_scrambling,
+                        stime_t i_append_pcr )
+{
+    ts_worker_t *p_worker = &p_workers->threads[p_pid->i_pid % p_workers->i_threads];
+    ts_worker_item_t item = {
+        .p_pid = p_pid,
+        .p_block = p_pkt,
+        .i_append_pcr = i_append_pcr,
+        .b_unit_start = b_unit_start,
+        .b_valid_scrambling = b_valid_scrambling,
+    };
+
+    if( !vlc_vector_push( &p_worker->in, item ) )
+    {
+        /* Keep the PID in order: gather inline */
+        ts_pes_parse_callback cb = p_workers->cb;
+        cb.priv = p_pid;
+        ts_workers_Flush( p_workers );
+        ts_pes_Gather( &cb, p_pid->u.p_stream, p_pkt,
+                       b_unit_start, b_valid_scrambling, i_append_pcr );
+        return;
+    }
+
+    p_worker->b_busy = true;
+    p_workers->b_pending = true;
+}
+
+bool ts_workers_Flush( ts_workers_t *p_workers )
+{
+    bool b_output = false;
+
+    if( !p_workers->b_pending )
+        return false;
+
+    for( unsigned i = 0; i < p_workers->i_threads; i++ )
+        if( p_workers->threads[i].b_busy )
+            vlc_sem_post( &p_workers->threads[i].start );
+
+    for( unsigned i = 0; i < p_workers->i_threads; i++ )
+    {
+        ts_worker_t *p_worker = &p_workers->threads[i];
+
+        if( !p_worker->b_busy )
+            continue;
+
+        vlc_sem_wait( &p_worker->done );
+        p_worker->b_busy = false;
+        vlc_vector_clear( &p_worker->in );
+    }
+
+    p_workers->b_pending = false;
+
+    /* Each PID has a single owner, so that the output order per PID is
+     * the gathering order */
+    for( unsigned i = 0; i < p_workers->i_threads; i++ )
+    {
+        ts_worker_t *p_worker = &p_workers->threads[i];
+        for( size_t j = 0; j < p_worker->out.size; j++ )
+        {
+            const ts_worker_item_t *p_item = &p_worker->out.data[j];
+            ts_es_t *p_es = p_item->p_pid->u.p_stream->p_es;
+
+            if( p_es )
+                p_es->i_next_block_flags |= p_item->i_es_flags;
+
+            if( p_item->p_block )
+            {
+                p_workers->cb.pf_parse( p_workers->cb.p_obj, p_item->p_pid,
+                                        p_item->p_block, p_item->i_flags,
+                                        p_item->i_append_pcr );
+                b_output = true;
+            }
+        }
+        vlc_vector_clear( &p_worker->out );
+    }
+
+    return b_output;
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * ts_workers.h: Transport Stream input module for VLC.
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_TS_WORKERS_H
+#define VLC_TS_WORKERS_H
+
+/*
+ * PES gathering worker threads.
+ *
+ * Packets are queued to the worker owning their PID, and are gathered
+ * on the next ts_workers_Flush() call. The demux thread waits for the
+ * workers meanwhile, then hands the completed PES to the parse callback,
+ * in order for each PID. The workers therefore only ever run while the
+ * demux thread is idle, and only write to the gathering state of the PID
+ * they own.
+ *
+ * The output is not interleaved across PIDs, so the demuxer flushes
+ * before any PCR update, which is the only ordering es_out relies on.
+ */
+typedef struct ts_workers_t ts_workers_t;
+
+/* Maximum TS packets read per demux call when using workers. The read
+ * also ends on the first PCR completing a PES. */
+#define TS_WORKERS_READ 1000
+
+ts_workers_t *ts_workers_New( vlc_object_t *, unsigned i_threads,
+                              const ts_pes_parse_callback * );
+void ts_workers_Delete( ts_workers_t * );
+
+/**
+ * Queues a TS packet payload for gathering, by the worker owning the PID.
+ */
+void ts_workers_Gather( ts_workers_t *, ts_pid_t *, block_t *p_pkt,
+                        bool b_unit_start, bool b_valid_scrambling,
+                        stime_t i_append_pcr );
+
+/**
+ * Gathers all the queued packets and outputs the completed PES.
+ *
+ * This must be called before any change to the PID streams.
+ *
+ * \return true if any PES was output
+ */
+bool ts_workers_Flush( ts_workers_t * );
+
+#endif
@@ -56,12 +56,17 @@
 static int  Open ( vlc_object_t * );
 static void Close( vlc_object_t * );
 
+#define PROBES_TEXT N_("Remember seek positions")
+#define PROBES_LONGTEXT N_("Keep the page positions located while seeking " \
+    "in local files in the cache directory, to seek faster the next time.")
+
 vlc_module_begin ()
     set_shortname ( "OGG" )
     set_description( N_("OGG demuxer" ) )
     set_subcategory( SUBCAT_INPUT_DEMUX )
     set_capability( "demux", 50 )
     set_callbacks( Open, Close )
+    add_bool( "ogg-seek-cache", true, PROBES_TEXT, PROBES_LONGTEXT )
     add_shortcut( "ogg" )
     add_file_extension("oga")
     add_file_extension("ogg")
@@ -255,6 +260,8 @@ static int Open( vlc_object_t * p_this )
     /* */
     TAB_INIT( p_sys->i_seekpoints, p_sys->pp_seekpoints );
 
+    Oggseek_ProbesOpen( p_demux );
+
     /* Enforce exclusive mode, only one track can be selected at once. */
     es_out_Control( p_demux->out, ES_OUT_SET_ES_CAT_POLICY, AUDIO_ES,
                     ES_OUT_ES_POLICY_EXCLUSIVE );
@@ -278,6 +285,7 @@ static void Close( vlc_object_t *p_this )
     /* Cleanup the bitstream parser */
     ogg_sync_clear( &p_sys->oy );
 
+    Oggseek_ProbesClose( p_demux );
     Ogg_EndOfStream( p_demux );
 
     if( p_sys->p_old_stream )
@@ -2272,6 +2280,8 @@ static int Ogg_BeginningOfStream( demux_t *p_demux )
     /* get total frame count for video stream; we will need this for seeking */
     p_ogg->i_total_frames = 0;
 
+    Oggseek_ProbesLoad( p_demux );
+
     return VLC_SUCCESS;
 }
 
@@ -2366,6 +2376,7 @@ static void Ogg_LogicalStreamDelete( demux_t *p_demux, logical_stream_t *p_strea
     {
         oggseek_index_entries_free( p_stream->idx );
     }
+    free( p_stream->p_probes );
 
     Ogg_FreeSkeleton( p_stream->p_skel );
     p_stream->p_skel = NULL;
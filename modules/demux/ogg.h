@@ -95,6 +95,10 @@ typedef struct logical_stream_s
     /* keyframe index for seeking, created as we discover keyframes */
     demux_index_entry_t *idx;
 
+    /* pages located while bisecting, sorted by position */
+    struct oggseek_probe *p_probes;
+    unsigned i_probes;
+
     /* Skeleton data */
     ogg_skeleton_t *p_skel;
 
@@ -222,6 +226,11 @@ typedef struct
     /* Time length, if available. 0 otherwise. */
     vlc_tick_t i_length;
 
+    /* bisection probes cache, NULL if the file cannot be identified */
+    char *psz_probes_url;
+    char *psz_probes_identity;
+    bool b_probes_changed;
+
     bool b_slave;
 
 } demux_sys_t;
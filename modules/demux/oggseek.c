@@ -36,9 +36,13 @@
 
 #include <vlc_common.h>
 #include <vlc_demux.h>
+#include <vlc_cachefile.h>
+#include <vlc_fs.h>
+#include <vlc_url.h>
 
 #include <ogg/ogg.h>
 #include <limits.h>
+#include <sys/stat.h>
 #include <math.h>
 #include <assert.h>
 
@@ -151,6 +155,211 @@ static bool OggSeekIndexFind ( logical_stream_t *p_stream, vlc_tick_t i_timestam
     return false;
 }
 
+/* Every page probed by a bisection is remembered, so that the next seeks
+   in the same stream start from the narrowest known bounds. Over HTTP, each
+   probe is a range request. */
+static bool OggSeekProbeAdd( logical_stream_t *p_stream, int64_t i_pagepos,
+                             vlc_tick_t i_time )
+{
+    if ( i_time == VLC_TICK_INVALID )
+        return false;
+
+    if ( p_stream->p_probes == NULL )
+    {
+        p_stream->p_probes = malloc( OGGSEEK_PROBES_MAX *
+                                     sizeof(*p_stream->p_probes) );
+        if ( p_stream->p_probes == NULL )
+            return false;
+    }
+
+    unsigned i = p_stream->i_probes;
+    while ( i > 0 && p_stream->p_probes[i - 1].i_pagepos >= i_pagepos )
+    {
+        if ( p_stream->p_probes[i - 1].i_pagepos == i_pagepos )
+            return false;
+        i--;
+    }
+
+    if ( p_stream->i_probes == OGGSEEK_PROBES_MAX )
+        return false;
+
+    memmove( &p_stream->p_probes[i + 1], &p_stream->p_probes[i],
+             ( p_stream->i_probes - i ) * sizeof(*p_stream->p_probes) );
+    p_stream->p_probes[i].i_pagepos = i_pagepos;
+    p_stream->p_probes[i].i_time = i_time;
+    p_stream->i_probes++;
+    return true;
+}
+
+/* Narrows the bisection bounds, -1 meaning unbounded */
+static void OggSeekProbeBounds( logical_stream_t *p_stream, vlc_tick_t i_time,
+                                int64_t *pi_pos_lower, int64_t *pi_pos_upper )
+{
+    int64_t i_lower = *pi_pos_lower;
+    int64_t i_upper = *pi_pos_upper;
+
+    for ( unsigned i = 0; i < p_stream->i_probes; i++ )
+    {
+        const struct oggseek_probe *probe = &p_stream->p_probes[i];
+        if ( probe->i_time <= i_time )
+        {
+            if ( probe->i_pagepos > i_lower )
+                i_lower = probe->i_pagepos;
+        }
+        else if ( i_upper == -1 || probe->i_pagepos < i_upper )
+            i_upper = probe->i_pagepos;
+    }
+
+    /* Timestamps are not monotonic (chained or broken streams) */
+    if ( i_upper != -1 && i_upper <= i_lower )
+        return;
+
+    *pi_pos_lower = i_lower;
+    *pi_pos_upper = i_upper;
+}
+
+/*********************************************************************
+ * bisection probes cache
+ *********************************************************************
+ * The probes of local files are kept in the user cache directory, one
+ * file per URL, so that the next sessions seek without bisecting the
+ * whole file again:
+ *
+ *   vlc-ogg-probes <version>
+ *   id <size> <modification time>
+ *   <serial number> <page position> <time>
+ *   ...
+ *
+ * Only the probes of the current chain link are stored.
+ **********************************************************************/
+#define OGGSEEK_PROBES_VERSION 1
+#define OGGSEEK_PROBES_DIR "ogg-probes"
+#define OGGSEEK_PROBES_MAX_SIZE (8 << 20) /* of the cache directory */
+
+void Oggseek_ProbesOpen( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    uint64_t i_size;
+
+    if ( p_demux->psz_url == NULL ||
+         !var_InheritBool( p_demux, "ogg-seek-cache" ) ||
+         vlc_stream_GetSize( p_demux->s, &i_size ) )
+        return;
+
+    /* Only local files can be identified, by their size and modification
+     * time */
+    struct stat st;
+    char *psz_path = vlc_uri2path( p_demux->psz_url );
+    if ( psz_path == NULL || vlc_stat( psz_path, &st ) ||
+         asprintf( &p_sys->psz_probes_identity, "%"PRIu64" %jd",
+                   i_size, (intmax_t) st.st_mtime ) == -1 )
+        p_sys->psz_probes_identity = NULL;
+    free( psz_path );
+
+    if ( p_sys->psz_probes_identity == NULL )
+        return;
+
+    p_sys->psz_probes_url = strdup( p_demux->psz_url );
+    if ( p_sys->psz_probes_url == NULL )
+    {
+        free( p_sys->psz_probes_identity );
+        p_sys->psz_probes_identity = NULL;
+    }
+}
+
+/* Restores the probes of the logical streams just found */
+void Oggseek_ProbesLoad( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( p_sys->psz_probes_identity == NULL )
+        return;
+
+    FILE *p_file = vlc_cachefile_Open( OGGSEEK_PROBES_DIR,
+                                       p_sys->psz_probes_url );
+    if ( p_file == NULL )
+        return;
+
+    char *psz_line = NULL;
+    size_t i_line = 0;
+    unsigned i_version;
+    unsigned i_loaded = 0;
+    const size_t i_identity = strlen( p_sys->psz_probes_identity );
+
+    if ( getline( &psz_line, &i_line, p_file ) != -1 &&
+         sscanf( psz_line, "vlc-ogg-probes %u", &i_version ) == 1 &&
+         i_version == OGGSEEK_PROBES_VERSION &&
+         getline( &psz_line, &i_line, p_file ) != -1 &&
+         !strncmp( psz_line, "id ", 3 ) &&
+         !strncmp( psz_line + 3, p_sys->psz_probes_identity, i_identity ) &&
+         !strcmp( psz_line + 3 + i_identity, "\n" ) )
+    {
+        while ( getline( &psz_line, &i_line, p_file ) != -1 )
+        {
+            int i_serial;
+            int64_t i_pagepos, i_time;
+
+            if ( sscanf( psz_line, "%d %"SCNd64" %"SCNd64,
+                         &i_serial, &i_pagepos, &i_time ) != 3 ||
+                 i_pagepos < 0 || i_pagepos >= p_sys->i_total_bytes )
+                break;
+
+            for ( int i = 0; i < p_sys->i_streams; i++ )
+            {
+                logical_stream_t *p_stream = p_sys->pp_stream[i];
+                if ( p_stream->i_serial_no == i_serial &&
+                     OggSeekProbeAdd( p_stream, i_pagepos, i_time ) )
+                    i_loaded++;
+            }
+        }
+    }
+
+    free( psz_line );
+    fclose( p_file );
+
+    if ( i_loaded > 0 )
+        msg_Dbg( p_demux, "%u seek positions restored from the cache",
+                 i_loaded );
+}
+
+/* Stores the probes if new ones were found, and releases the cache */
+void Oggseek_ProbesClose( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( p_sys->psz_probes_identity == NULL )
+        return;
+    if ( !p_sys->b_probes_changed )
+        goto end;
+
+    vlc_cachefile_t *p_entry = vlc_cachefile_Create( p_demux,
+                                                     OGGSEEK_PROBES_DIR,
+                                                     p_sys->psz_probes_url );
+    if ( p_entry == NULL )
+        goto end;
+
+    FILE *p_file = vlc_cachefile_GetFile( p_entry );
+
+    fprintf( p_file, "vlc-ogg-probes %u\nid %s\n", OGGSEEK_PROBES_VERSION,
+             p_sys->psz_probes_identity );
+    for ( int i = 0; i < p_sys->i_streams; i++ )
+    {
+        const logical_stream_t *p_stream = p_sys->pp_stream[i];
+        for ( unsigned j = 0; j < p_stream->i_probes; j++ )
+            fprintf( p_file, "%d %"PRId64" %"PRId64"\n", p_stream->i_serial_no,
+                     p_stream->p_probes[j].i_pagepos,
+                     p_stream->p_probes[j].i_time );
+    }
+
+    vlc_cachefile_Commit( p_entry, OGGSEEK_PROBES_MAX_SIZE );
+
+end:
+    free( p_sys->psz_probes_identity );
+    free( p_sys->psz_probes_url );
+    p_sys->psz_probes_identity = NULL;
+    p_sys->psz_probes_url = NULL;
+}
+
 /*********************************************************************
  * private functions
  **********************************************************************/
@@ -657,6 +866,8 @@ static int64_t OggBisectSearchByTime( demux_t *p_demux, logical_stream_t *p_stre
     {
         current.i_timestamp = Ogg_GranuleToTime( p_stream, current.i_granule,
                                                  !p_stream->b_contiguous, false );
+        if( OggSeekProbeAdd( p_stream, current.i_pos, current.i_timestamp ) )
+            p_sys->b_probes_changed = true;
         if( current.i_timestamp <= i_targettime )
             bestlower = current;
         else
@@ -700,6 +911,9 @@ static int64_t OggBisectSearchByTime( demux_t *p_demux, logical_stream_t *p_stre
         if ( current.i_pos != -1 && current.i_granule != -1 )
         {
             /* found a page */
+            if( OggSeekProbeAdd( p_stream, current.i_pos,
+                                 current.i_timestamp ) )
+                p_sys->b_probes_changed = true;
 
             if ( current.i_timestamp <= i_targettime )
             {
@@ -806,9 +1020,13 @@ int Oggseek_BlindSeektoAbsoluteTime( demux_t *p_demux, logical_stream_t *p_strea
     if ( !b_found && b_fastseek )
     {
         int64_t i_sync_time;
+        i_lowerpos = p_stream->i_data_start;
+        i_upperpos = -1;
+        OggSeekProbeBounds( p_stream, i_time, &i_lowerpos, &i_upperpos );
         i_lowerpos = OggBisectSearchByTime( p_demux, p_stream, i_time,
-                                            p_stream->i_data_start, p_sys->i_total_bytes,
+                                            i_lowerpos, i_upperpos,
                                             &i_sync_time );
+        i_upperpos = -1;
         b_found = ( i_lowerpos != -1 );
     }
 
@@ -898,6 +1116,7 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
     vlc_tick_t i_lower_index;
     if(!OggSeekIndexFind( p_stream, i_time, &i_offset_lower, &i_offset_upper, &i_lower_index ))
         i_lower_index = 0;
+    OggSeekProbeBounds( p_stream, i_time, &i_offset_lower, &i_offset_upper );
 
     i_offset_lower = __MAX( i_offset_lower, p_stream->i_data_start );
     i_offset_upper = __MIN( i_offset_upper, p_sys->i_total_bytes );
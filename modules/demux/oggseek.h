@@ -49,11 +49,23 @@ struct oggseek_index_entry
     int64_t i_pagepos;
 };
 
+/* page located by a bisection, kept to bound the next ones */
+struct oggseek_probe
+{
+    int64_t i_pagepos;
+    vlc_tick_t i_time; /* end time of the page */
+};
+
+#define OGGSEEK_PROBES_MAX 512
+
 int     Oggseek_BlindSeektoAbsoluteTime ( demux_t *, logical_stream_t *, vlc_tick_t, bool );
 int     Oggseek_BlindSeektoPosition ( demux_t *, logical_stream_t *, double f, bool );
 int     Oggseek_SeektoAbsolutetime ( demux_t *, logical_stream_t *, vlc_tick_t );
 const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *, vlc_tick_t, int64_t );
 void    Oggseek_ProbeEnd( demux_t * );
+void    Oggseek_ProbesOpen( demux_t * );
+void    Oggseek_ProbesLoad( demux_t * );
+void    Oggseek_ProbesClose( demux_t * );
 
 void oggseek_index_entries_free ( demux_index_entry_t * );
 
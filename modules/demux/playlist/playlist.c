@@ -64,7 +64,7 @@ vlc_module_begin ()
         set_description( N_("M3U playlist import") )
         add_shortcut( "m3u", "m3u8" )
         set_capability( "demux", 10 )
-        set_callback( Import_M3U )
+        set_callbacks( Import_M3U, Close_M3U )
         add_file_extension("m3u")
     add_submodule ()
         set_description( N_("RAM playlist import") )
@@ -27,6 +27,7 @@ char *ProcessMRL( const char *, const char * );
 int PlaylistControl( stream_t *p_access, int i_query, va_list args );
 
 int Import_M3U ( vlc_object_t * );
+void Close_M3U ( vlc_object_t * );
 
 int Import_RAM ( vlc_object_t * );
 
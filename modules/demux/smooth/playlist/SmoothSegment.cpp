@@ -43,9 +43,7 @@ SmoothSegmentChunk::~SmoothSegmentChunk()
 
 void SmoothSegmentChunk::onDownload(block_t **pp_block)
 {
-    decrypt(pp_block);
-
-    if(!rep || ((*pp_block)->i_flags & BLOCK_FLAG_HEADER) == 0)
+    if(!decrypt(pp_block) || !rep || ((*pp_block)->i_flags & BLOCK_FLAG_HEADER) == 0)
         return;
 
     SmoothIndexReader br(rep->getPlaylist()->getVLCObject());
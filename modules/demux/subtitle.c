@@ -103,14 +103,19 @@ enum subtitle_type_e
     SUB_TYPE_SCC,      /* Scenarist Closed Caption */
 };
 
+/* Lines are read from the stream on demand. Only the last few are kept:
+ * parsers only look back at the previous line. */
+#define TEXT_LINES_KEPT 4
+
 typedef struct
 {
-    size_t  i_line_count;
-    size_t  i_line;
-    char    **line;
+    stream_t *s;
+    size_t  i_line_count; /* lines read so far */
+    size_t  i_line;       /* next line to return */
+    char    *line[TEXT_LINES_KEPT];
 } text_t;
 
-static int  TextLoad( text_t *, stream_t *s );
+static void TextLoad( text_t *, stream_t *s );
 static void TextUnload( text_t * );
 
 typedef struct
@@ -167,6 +172,7 @@ typedef struct
         subtitle_t *p_array;
         size_t      i_count;
         size_t      i_current;
+        bool        b_sorted;
     } subtitles;
 
     vlc_tick_t  i_length;
@@ -634,16 +640,15 @@ static int Open ( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
-    /* Load the whole file */
+    /* Parse the file, reading it line by line */
     text_t txtlines;
     TextLoad( &txtlines, p_demux->s );
 
-    /* Parse it */
-    for( size_t i_max = 0; i_max < SIZE_MAX - 500 * sizeof(subtitle_t); )
+    for( size_t i_max = 0; i_max < SIZE_MAX / 2 / sizeof(subtitle_t); )
     {
         if( p_sys->subtitles.i_count >= i_max )
         {
-            i_max += 500;
+            i_max = i_max ? i_max * 2 : 500;
             subtitle_t *p_realloc = realloc( p_sys->subtitles.p_array, sizeof(subtitle_t) * i_max );
             if( p_realloc == NULL )
             {
@@ -664,6 +669,15 @@ static int Open ( vlc_object_t *p_this )
     /* Unload */
     TextUnload( &txtlines );
 
+    if( p_sys->subtitles.i_count > 0 )
+    {
+        /* Release the spare room of the last growth */
+        subtitle_t *p_realloc = realloc( p_sys->subtitles.p_array,
+                                         sizeof(subtitle_t) * p_sys->subtitles.i_count );
+        if( p_realloc != NULL )
+            p_sys->subtitles.p_array = p_realloc;
+    }
+
     msg_Dbg(p_demux, "loaded %zu subtitles", p_sys->subtitles.i_count );
 
     /* *** add subtitle ES *** */
@@ -682,6 +696,16 @@ static int Open ( vlc_object_t *p_this )
     else
         es_format_Init( &fmt, SPU_ES, VLC_CODEC_SUBT );
 
+    /* Seeks can bisect if the cues are in order */
+    p_sys->subtitles.b_sorted = true;
+    for( size_t i = 1; i < p_sys->subtitles.i_count; i++ )
+        if( p_sys->subtitles.p_array[i].i_start <
+            p_sys->subtitles.p_array[i - 1].i_start )
+        {
+            p_sys->subtitles.b_sorted = false;
+            break;
+        }
+
     p_sys->subtitles.i_current = 0;
     p_sys->i_length = 0;
     if( p_sys->subtitles.i_count > 0 )
@@ -745,6 +769,28 @@ static void
 ResetCurrentIndex( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( p_sys->subtitles.b_sorted )
+    {
+        if( p_sys->subtitles.i_count == 0 )
+            return;
+
+        /* Find the first cue starting after the demux date, and restart
+         * from the one before it */
+        size_t i_lower = 0, i_upper = p_sys->subtitles.i_count;
+        while( i_lower < i_upper )
+        {
+            size_t i_split = i_lower + (i_upper - i_lower) / 2;
+            if( p_sys->subtitles.p_array[i_split].i_start * p_sys->f_rate >
+                p_sys->i_next_demux_date )
+                i_upper = i_split;
+            else
+                i_lower = i_split + 1;
+        }
+        p_sys->subtitles.i_current = i_lower > 0 ? i_lower - 1 : 0;
+        return;
+    }
+
     for( size_t i = 0; i < p_sys->subtitles.i_count; i++ )
     {
         if( p_sys->subtitles.p_array[i].i_start * p_sys->f_rate >
@@ -910,70 +956,52 @@ static void Fix( demux_t *p_demux )
     qsort( p_sys->subtitles.p_array, p_sys->subtitles.i_count, sizeof( p_sys->subtitles.p_array[0] ), subtitle_cmp);
 }
 
-static int TextLoad( text_t *txt, stream_t *s )
+static void TextLoad( text_t *txt, stream_t *s )
 {
-    size_t i_line_max;
-
-    /* init txt */
-    i_line_max          = 500;
-    txt->i_line_count   = 0;
-    txt->i_line         = 0;
-    txt->line           = calloc( i_line_max, sizeof( char * ) );
-    if( !txt->line )
-        return VLC_ENOMEM;
-
-    /* load the complete file */
-    for( ;; )
-    {
-        char *psz = vlc_stream_ReadLine( s );
-
-        if( psz == NULL )
-            break;
-
-        txt->line[txt->i_line_count] = psz;
-        if( txt->i_line_count + 1 >= i_line_max )
-        {
-            i_line_max += 100;
-            char **p_realloc = realloc( txt->line, i_line_max * sizeof( char * ) );
-            if( p_realloc == NULL )
-                return VLC_ENOMEM;
-            txt->line = p_realloc;
-        }
-        txt->i_line_count++;
-    }
-
-    if( txt->i_line_count == 0 )
-    {
-        free( txt->line );
-        return VLC_EGENERIC;
-    }
-
-    return VLC_SUCCESS;
+    txt->s            = s;
+    txt->i_line_count = 0;
+    txt->i_line       = 0;
+    for( size_t i = 0; i < TEXT_LINES_KEPT; i++ )
+        txt->line[i] = NULL;
 }
 static void TextUnload( text_t *txt )
 {
-    if( txt->i_line_count )
-    {
-        for( size_t i = 0; i < txt->i_line_count; i++ )
-            free( txt->line[i] );
-        free( txt->line );
-    }
+    for( size_t i = 0; i < TEXT_LINES_KEPT; i++ )
+        free( txt->line[i] );
     txt->i_line       = 0;
     txt->i_line_count = 0;
 }
 
+/* Reads one more line ahead of the current one */
+static bool TextFetchLine( text_t *txt )
+{
+    char *psz = vlc_stream_ReadLine( txt->s );
+    if( psz == NULL )
+        return false;
+
+    char **pp = &txt->line[txt->i_line_count % TEXT_LINES_KEPT];
+    free( *pp );
+    *pp = psz;
+    txt->i_line_count++;
+    return true;
+}
+
 static char *TextGetLine( text_t *txt )
 {
-    if( txt->i_line >= txt->i_line_count )
+    if( txt->i_line >= txt->i_line_count && !TextFetchLine( txt ) )
         return( NULL );
 
-    return txt->line[txt->i_line++];
+    return txt->line[txt->i_line++ % TEXT_LINES_KEPT];
 }
 static void TextPreviousLine( text_t *txt )
 {
-    if( txt->i_line > 0 )
+    if( txt->i_line > 0 && txt->i_line_count - txt->i_line < TEXT_LINES_KEPT - 1 )
         txt->i_line--;
 }
+static bool TextIsEOF( text_t *txt )
+{
+    return txt->i_line >= txt->i_line_count && !TextFetchLine( txt );
+}
 
 /*****************************************************************************
  * Specific Subtitle function
@@ -1640,7 +1668,7 @@ static int ParseAQT(vlc_object_t *p_obj, subs_properties_t *p_props, text_t *txt
                  return VLC_ENOMEM;
             strcat( psz_text, s );
             strcat( psz_text, "\n" );
-            if( txt->i_line == txt->i_line_count )
+            if( TextIsEOF( txt ) )
                 break;
         }
     }
@@ -24,6 +24,7 @@
 #include "playlist_model_p.hpp"
 #include <algorithm>
 #include <assert.h>
+#include <vlc_diffutil.h>
 #include "util/qmlinputitem.hpp"
 
 namespace vlc {
@@ -50,6 +51,35 @@ static QVector<RAW> toRaw(const QVector<WRAPPER> &items)
         vec.push_back(items[i].raw());
     return vec;
 }
+
+/* Above this number of differing items, the diff costs more than letting the
+ * view rebuild its delegates */
+constexpr int DIFF_MAX_ITEMS = 2048;
+
+//callbacks for the diff algorithm to access a slice of the items
+
+struct DiffRange
+{
+    const QVector<PlaylistItem> *items;
+    int offset;
+    int count;
+};
+
+uint32_t diffRangeLength(const void* data)
+{
+    return static_cast<const DiffRange *>(data)->count;
+}
+
+bool diffRangeCompare(const void* dataOld, uint32_t oldIndex,
+                      const void* dataNew, uint32_t newIndex)
+{
+    auto rangeOld = static_cast<const DiffRange *>(dataOld);
+    auto rangeNew = static_cast<const DiffRange *>(dataNew);
+    assert(oldIndex < uint32_t(rangeOld->count));
+    assert(newIndex < uint32_t(rangeNew->count));
+    return rangeOld->items->at(rangeOld->offset + oldIndex).raw()
+        == rangeNew->items->at(rangeNew->offset + newIndex).raw();
+}
 }
 
 extern "C" { // for C callbacks
@@ -170,12 +200,135 @@ PlaylistListModelPrivate::~PlaylistListModelPrivate()
     }
 }
 
+bool PlaylistListModelPrivate::removeMissingItems(const QVector<PlaylistItem>& newContent,
+                                                  int begin, int oldEnd, int newEnd)
+{
+    Q_Q(PlaylistListModel);
+
+    /* Check that the new items are a subsequence of the old ones, and collect
+     * the removed slices */
+    QVector<QPair<int, int>> removed;
+    int j = begin;
+    for (int i = begin; i < oldEnd; ++i)
+    {
+        if (j < newEnd && m_items[i].raw() == newContent[j].raw())
+            ++j;
+        else if (!removed.isEmpty() && removed.last().first + removed.last().second == i)
+            removed.last().second++;
+        else
+            removed.append({i, 1});
+    }
+    if (j != newEnd)
+        return false;
+
+    /* Remove from the end so that the indices stay valid */
+    for (auto it = removed.crbegin(); it != removed.crend(); ++it)
+    {
+        q->beginRemoveRows({}, it->first, it->first + it->second - 1);
+        m_items.remove(it->first, it->second);
+        q->endRemoveRows();
+    }
+    return true;
+}
+
+bool PlaylistListModelPrivate::applyItemsDiff(const QVector<PlaylistItem>& newContent)
+{
+    Q_Q(PlaylistListModel);
+    const int oldSize = m_items.size();
+    const int newSize = newContent.size();
+
+    if (oldSize == 0 || newSize == 0)
+        return false;
+
+    /* Only diff what lies between the common prefix and suffix, the rows of
+     * the items kept keep their state (e.g. selection) */
+    int prefix = 0;
+    while (prefix < oldSize && prefix < newSize
+        && m_items[prefix].raw() == newContent[prefix].raw())
+        ++prefix;
+
+    int suffix = 0;
+    while (suffix < oldSize - prefix && suffix < newSize - prefix
+        && m_items[oldSize - 1 - suffix].raw() == newContent[newSize - 1 - suffix].raw())
+        ++suffix;
+
+    const int oldCount = oldSize - prefix - suffix;
+    const int newCount = newSize - prefix - suffix;
+
+    /* Typically, a batch removal */
+    if (oldCount >= newCount
+     && removeMissingItems(newContent, prefix, oldSize - suffix, newSize - suffix))
+        return true;
+
+    if (oldCount + newCount > DIFF_MAX_ITEMS)
+        return false;
+
+    const DiffRange rangeOld { &m_items, prefix, oldCount };
+    const DiffRange rangeNew { &newContent, prefix, newCount };
+    const vlc_diffutil_callback_t diffOp = {
+        diffRangeLength,
+        diffRangeLength,
+        diffRangeCompare
+    };
+
+    diffutil_snake_t* snake = vlc_diffutil_build_snake(&diffOp, &rangeOld, &rangeNew);
+    if (!snake)
+        return false;
+    vlc_diffutil_changelist_t* changes = vlc_diffutil_build_change_list(
+        snake, &diffOp, &rangeOld, &rangeNew, VLC_DIFFUTIL_RESULT_AGGREGATE);
+    vlc_diffutil_free_snake(snake);
+    if (!changes)
+        return false;
+
+    /* The old items are not accessed by the change list anymore, the model
+     * can be updated in place */
+    for (size_t i = 0; i < changes->size; i++)
+    {
+        const vlc_diffutil_change_t& op = changes->data[i];
+        const int count = op.count;
+        switch (op.type)
+        {
+        case VLC_DIFFUTIL_OP_INSERT:
+        {
+            const int index = prefix + op.op.insert.index;
+            const int y = prefix + op.op.insert.y;
+            q->beginInsertRows({}, index, index + count - 1);
+            m_items.insert(index, count, nullptr);
+            std::copy(newContent.cbegin() + y, newContent.cbegin() + y + count,
+                      m_items.begin() + index);
+            q->endInsertRows();
+            break;
+        }
+        case VLC_DIFFUTIL_OP_REMOVE:
+        {
+            const int index = prefix + op.op.remove.index;
+            q->beginRemoveRows({}, index, index + count - 1);
+            m_items.remove(index, count);
+            q->endRemoveRows();
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    vlc_diffutil_free_change_list(changes);
+
+    assert(m_items.size() == newSize);
+    return true;
+}
+
 void PlaylistListModelPrivate::onItemsReset(const QVector<PlaylistItem>& newContent)
 {
     Q_Q(PlaylistListModel);
-    q->beginResetModel();
-    m_items = newContent;
-    q->endResetModel();
+
+    /* A reset is also notified for batch removals: only notify the rows that
+     * actually changed, unless there are too many of them */
+    if (!applyItemsDiff(newContent))
+    {
+        q->beginResetModel();
+        m_items = newContent;
+        q->endResetModel();
+    }
 
     m_duration = VLC_TICK_FROM_SEC(0);
     if (m_items.size())
@@ -50,6 +50,9 @@ public:
     }
 
     void onItemsReset(const QVector<PlaylistItem>& items);
+    bool applyItemsDiff(const QVector<PlaylistItem>& newContent);
+    bool removeMissingItems(const QVector<PlaylistItem>& newContent,
+                            int begin, int oldEnd, int newEnd);
     void onItemsAdded(const QVector<PlaylistItem>& added, size_t index);
     void onItemsMoved(size_t index, size_t count, size_t target);
     void onItemsRemoved(size_t index, size_t count);
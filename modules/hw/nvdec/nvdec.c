@@ -44,6 +44,12 @@ static int DecoderContextOpen(vlc_decoder_device *, vlc_window_t *);
 #define DEINTERLACE_MODULE_TEXT N_("Integrated deinterlacing")
 #define DEINTERLACE_MODULE_LONGTEXT N_( "Specify the deinterlace mode to use." )
 
+#define MAX_HEIGHT_TEXT N_("Maximum output height")
+#define MAX_HEIGHT_LONGTEXT N_( \
+    "Downscale the decoded pictures with the decoder hardware scaler so " \
+    "that they are at most this high, keeping the aspect ratio. " \
+    "0 keeps the original size." )
+
 static const char *const ppsz_deinterlace_type[] =
 {
     N_("Disable"), N_("Bob"), N_("Adaptive")
@@ -63,6 +69,9 @@ vlc_module_begin ()
     add_integer( "nvdec-deint", cudaVideoDeinterlaceMode_Bob,
                  DEINTERLACE_MODULE_TEXT, DEINTERLACE_MODULE_LONGTEXT )
         change_integer_list( ppsi_deinterlace_type, ppsz_deinterlace_type )
+    add_integer( "nvdec-max-height", 0,
+                 MAX_HEIGHT_TEXT, MAX_HEIGHT_LONGTEXT )
+        change_integer_range( 0, 8192 )
     set_callbacks(OpenDecoder, CloseDecoder)
     add_submodule()
         set_callback_dec_device(DecoderContextOpen, 3)
@@ -97,6 +106,7 @@ struct nvdec_ctx {
     bool                        b_xps_pushed; ///< (for xvcC) parameter sets pushed (SPS/PPS/VPS)
     block_t *                   (*process_block)(decoder_t *, block_t *);
     cudaVideoDeinterlaceMode    deintMode;
+    unsigned                    maxHeight; ///< 0 for no downscaling
     // NVDEC doesn't stop even if HandleVideoSequence fails
     bool                        b_nvparser_success;
     size_t                      decoderHeight;
@@ -273,6 +283,23 @@ static int CUDAAPI HandleVideoSequence(void *p_opaque, CUVIDEOFORMAT *p_format)
     }
     p_dec->fmt_out.i_codec = p_dec->fmt_out.video.i_chroma;
 
+    /* The decoder scales the visible area itself, so that the smaller
+     * pictures are what is copied, displayed or downloaded */
+    video_format_t *fmt_out = &p_dec->fmt_out.video;
+    bool scaled = p_sys->maxHeight > 0
+               && fmt_out->i_visible_height > p_sys->maxHeight;
+    if (scaled)
+    {
+        unsigned height = p_sys->maxHeight & ~1;
+        unsigned width = (uint64_t)fmt_out->i_visible_width * height
+                       / fmt_out->i_visible_height;
+
+        fmt_out->i_width = fmt_out->i_visible_width = (width + 1) & ~1;
+        fmt_out->i_height = fmt_out->i_visible_height = height;
+        fmt_out->i_x_offset = fmt_out->i_y_offset = 0;
+        msg_Dbg(p_dec, "scaling to %ux%u", fmt_out->i_width, height);
+    }
+
     ret = CALL_CUDA_DEC(cuCtxPushCurrent, p_sys->devsys->cuCtx);
     if (ret != VLC_SUCCESS)
         goto error;
@@ -318,6 +345,13 @@ static int CUDAAPI HandleVideoSequence(void *p_opaque, CUVIDEOFORMAT *p_format)
         .ulNumOutputSurfaces = 1,
         .DeinterlaceMode     = p_sys->deintMode
     };
+    if (scaled)
+    {
+        dparams.display_area.left   = p_format->display_area.left;
+        dparams.display_area.top    = p_format->display_area.top;
+        dparams.display_area.right  = p_format->display_area.right;
+        dparams.display_area.bottom = p_format->display_area.bottom;
+    }
     ret = CALL_CUVID(cuvidCreateDecoder, &p_sys->cudecoder, &dparams);
     if (ret != VLC_SUCCESS)
         goto cuda_error;
@@ -392,7 +426,8 @@ static int CUDAAPI HandleVideoSequence(void *p_opaque, CUVIDEOFORMAT *p_format)
             goto cuda_error;
     }
 
-    p_sys->decoderHeight = p_format->coded_height;
+    /* Height of the planes of the mapped frames */
+    p_sys->decoderHeight = p_dec->fmt_out.video.i_height;
 
     CALL_CUDA_DEC(cuCtxPopCurrent, NULL);
 
@@ -683,10 +718,10 @@ static int CuvidPushEOS(decoder_t *p_dec)
 static int DecodeBlock(decoder_t *p_dec, block_t *p_block)
 {
     nvdec_ctx_t *p_sys = p_dec->p_sys;
-    // If HandleVideoSequence fails, we give up decoding
+    // If HandleVideoSequence fails, let another decoder take over
     if (!p_sys->b_nvparser_success) {
         if (p_block != NULL) {
-            block_Release(p_block);
+            return VLCDEC_FALLBACK;
         }
         return VLCDEC_ECRITICAL;
     }
@@ -1010,6 +1045,8 @@ static int OpenDecoder(vlc_object_t *p_this)
     if (result != 0)
         goto error;
 
+    p_sys->maxHeight = var_InheritInteger(p_dec, "nvdec-max-height");
+
     int deinterlace_mode    = var_InheritInteger(p_dec, "nvdec-deint");
     if (deinterlace_mode <= 0)
         p_sys->deintMode = cudaVideoDeinterlaceMode_Weave;
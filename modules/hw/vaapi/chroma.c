@@ -99,17 +99,35 @@ FillPictureFromVAImage(picture_t *dest,
     switch (src_img->format.fourcc)
     {
     case VA_FOURCC_NV12:
-    {
-        assert(dest->format.i_chroma == VLC_CODEC_I420);
-        Copy420_SP_to_P(dest, src_planes, src_pitches, src_img->height, cache);
+        switch (dest->format.i_chroma)
+        {
+            case VLC_CODEC_I420:
+                Copy420_SP_to_P(dest, src_planes, src_pitches,
+                                src_img->height, cache);
+                break;
+            case VLC_CODEC_NV12:
+                Copy420_SP_to_SP(dest, src_planes, src_pitches,
+                                 src_img->height, cache);
+                break;
+            default:
+                vlc_assert_unreachable();
+        }
         break;
-    }
     case VA_FOURCC_I420:
-    {
-        assert(dest->format.i_chroma == VLC_CODEC_I420);
-        Copy420_P_to_P(dest, src_planes, src_pitches, src_img->height, cache);
+        switch (dest->format.i_chroma)
+        {
+            case VLC_CODEC_I420:
+                Copy420_P_to_P(dest, src_planes, src_pitches,
+                               src_img->height, cache);
+                break;
+            case VLC_CODEC_NV12:
+                Copy420_P_to_SP(dest, src_planes, src_pitches,
+                                src_img->height, cache);
+                break;
+            default:
+                vlc_assert_unreachable();
+        }
         break;
-    }
     case VA_FOURCC_P010:
         switch (dest->format.i_chroma)
         {
@@ -294,7 +312,8 @@ static int CheckFmt(const video_format_t *in, const video_format_t *out,
     switch (in->i_chroma)
     {
         case VLC_CODEC_VAAPI_420:
-            if (out->i_chroma == VLC_CODEC_I420)
+            if (out->i_chroma == VLC_CODEC_I420
+             || out->i_chroma == VLC_CODEC_NV12)
                 return VLC_SUCCESS;
             break;
         case VLC_CODEC_VAAPI_420_10BPP:
@@ -218,18 +218,20 @@ Filter(filter_t * filter, picture_t * src,
     vlc_vaapi_PicAttachContext(dest);
     picture_CopyProperties(dest, src);
 
-    void *      p_va_params;
+    if (pf_update_va_filter_params)
+    {
+        void *  p_va_params;
 
-    if (vlc_vaapi_MapBuffer(VLC_OBJECT(filter), filter_sys->va.dpy,
-                            filter_sys->va.buf, &p_va_params))
-        goto error;
+        if (vlc_vaapi_MapBuffer(VLC_OBJECT(filter), filter_sys->va.dpy,
+                                filter_sys->va.buf, &p_va_params))
+            goto error;
 
-    if (pf_update_va_filter_params)
         pf_update_va_filter_params(filter_sys->p_data, p_va_params);
 
-    if (vlc_vaapi_UnmapBuffer(VLC_OBJECT(filter),
-                              filter_sys->va.dpy, filter_sys->va.buf))
-        goto error;
+        if (vlc_vaapi_UnmapBuffer(VLC_OBJECT(filter),
+                                  filter_sys->va.dpy, filter_sys->va.buf))
+            goto error;
+    }
 
     if (vlc_vaapi_BeginPicture(VLC_OBJECT(filter),
                                filter_sys->va.dpy, filter_sys->va.ctx,
@@ -255,8 +257,11 @@ Filter(filter_t * filter, picture_t * src,
 
     *pipeline_params = (typeof(*pipeline_params)){0};
     pipeline_params->surface = vlc_vaapi_PicGetSurface(src);
-    pipeline_params->filters = &filter_sys->va.buf;
-    pipeline_params->num_filters = 1;
+    if (filter_sys->va.buf != VA_INVALID_ID)
+    {
+        pipeline_params->filters = &filter_sys->va.buf;
+        pipeline_params->num_filters = 1;
+    }
     if (filter_sys->b_pipeline_fast)
         pipeline_params->pipeline_flags = VA_PROC_PIPELINE_FAST;
     if (pf_update_pipeline_params)
@@ -405,7 +410,8 @@ Close(filter_t *filter, filter_sys_t * filter_sys)
 {
     vlc_object_t * obj = VLC_OBJECT(filter);
     picture_pool_Release(filter_sys->dest_pics);
-    vlc_vaapi_DestroyBuffer(obj, filter_sys->va.dpy, filter_sys->va.buf);
+    if (filter_sys->va.buf != VA_INVALID_ID)
+        vlc_vaapi_DestroyBuffer(obj, filter_sys->va.dpy, filter_sys->va.buf);
     vlc_vaapi_DestroyContext(obj, filter_sys->va.dpy, filter_sys->va.ctx);
     vlc_vaapi_DestroyConfig(obj, filter_sys->va.dpy, filter_sys->va.conf);
     vlc_decoder_device_Release(filter_sys->va.dec_device);
@@ -1122,6 +1128,156 @@ error:
     return VLC_EGENERIC;
 }
 
+/*******************
+ * Scale functions *
+ *******************/
+
+struct  scale_data
+{
+    VARectangle src;
+    VARectangle dst;
+};
+
+static void
+Scale_UpdatePipelineParams(void * p_data,
+                           VAProcPipelineParameterBuffer * pipeline_param)
+{
+    struct scale_data *const    p_scale_data = p_data;
+
+    pipeline_param->surface_region = &p_scale_data->src;
+    pipeline_param->output_region = &p_scale_data->dst;
+}
+
+static picture_t *
+Scale(filter_t * filter, picture_t * src)
+{
+    picture_t *const    dest =
+        Filter(filter, src, NULL, NULL, Scale_UpdatePipelineParams);
+    picture_Release(src);
+    return dest;
+}
+
+static void
+CloseScale(filter_t *filter)
+{
+    filter_sys_t *const filter_sys = filter->p_sys;
+
+    free(filter_sys->p_data);
+    Close(filter, filter_sys);
+}
+
+static const struct vlc_filter_operations Scale_ops = {
+    .filter_video = Scale, .close = CloseScale,
+};
+
+/* Keeps the pictures as VAAPI surfaces when only their size changes, so
+ * that scaling (e.g. for a transcode towards a hardware encoder) does not
+ * go through system memory */
+static int
+OpenScale(filter_t *filter)
+{
+    video_format_t const *const fmt_in = &filter->fmt_in.video;
+    video_format_t const *const fmt_out = &filter->fmt_out.video;
+
+    if (filter->vctx_in == NULL ||
+        vlc_video_context_GetType(filter->vctx_in) != VLC_VIDEO_CONTEXT_VAAPI ||
+        !vlc_vaapi_IsChromaOpaque(fmt_in->i_chroma) ||
+        fmt_in->i_chroma != fmt_out->i_chroma ||
+        fmt_in->orientation != fmt_out->orientation)
+        return VLC_EGENERIC;
+
+    if (fmt_in->i_visible_width == fmt_out->i_visible_width &&
+        fmt_in->i_visible_height == fmt_out->i_visible_height &&
+        fmt_in->i_x_offset == fmt_out->i_x_offset &&
+        fmt_in->i_y_offset == fmt_out->i_y_offset)
+        return VLC_EGENERIC;
+
+    struct scale_data *const    p_data = malloc(sizeof(*p_data));
+    if (!p_data)
+        return VLC_ENOMEM;
+
+    p_data->src = (VARectangle) {
+        .x = fmt_in->i_x_offset, .y = fmt_in->i_y_offset,
+        .width = fmt_in->i_visible_width, .height = fmt_in->i_visible_height,
+    };
+    p_data->dst = (VARectangle) {
+        .x = fmt_out->i_x_offset, .y = fmt_out->i_y_offset,
+        .width = fmt_out->i_visible_width, .height = fmt_out->i_visible_height,
+    };
+
+    filter_sys_t *      filter_sys = calloc(1, sizeof(*filter_sys));
+    if (!filter_sys)
+    {
+        free(p_data);
+        return VLC_ENOMEM;
+    }
+    filter->p_sys = filter_sys;
+
+    filter_sys->p_data = p_data;
+    filter_sys->va.conf = VA_INVALID_ID;
+    filter_sys->va.ctx = VA_INVALID_ID;
+    filter_sys->va.buf = VA_INVALID_ID;
+    filter_sys->va.dec_device = vlc_video_context_HoldDevice(filter->vctx_in);
+    assert(filter_sys->va.dec_device);
+    filter_sys->va.dpy = filter_sys->va.dec_device->opaque;
+
+    filter_sys->dest_pics =
+        vlc_vaapi_PoolNew(VLC_OBJECT(filter), filter->vctx_in,
+                          filter_sys->va.dpy, DEST_PICS_POOL_SZ,
+                          &filter_sys->va.surface_ids, &filter->fmt_out.video);
+    if (!filter_sys->dest_pics)
+        goto error;
+
+    filter_sys->va.conf =
+        vlc_vaapi_CreateConfigChecked(VLC_OBJECT(filter), filter_sys->va.dpy,
+                                      VAProfileNone, VAEntrypointVideoProc,
+                                      fmt_out->i_chroma);
+    if (filter_sys->va.conf == VA_INVALID_ID)
+        goto error;
+
+    filter_sys->va.ctx =
+        vlc_vaapi_CreateContext(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, filter_sys->va.conf,
+                                fmt_out->i_width, fmt_out->i_height,
+                                0, filter_sys->va.surface_ids,
+                                DEST_PICS_POOL_SZ);
+    if (filter_sys->va.ctx == VA_INVALID_ID)
+        goto error;
+
+    VAProcPipelineCaps  pipeline_caps;
+    if (vlc_vaapi_QueryVideoProcPipelineCaps(VLC_OBJECT(filter),
+                                             filter_sys->va.dpy,
+                                             filter_sys->va.ctx,
+                                             NULL, 0, &pipeline_caps))
+        goto error;
+
+    filter_sys->b_pipeline_fast =
+        pipeline_caps.pipeline_flags & VA_PROC_PIPELINE_FAST;
+
+    filter->vctx_out = vlc_video_context_Hold(filter->vctx_in);
+    filter->ops = &Scale_ops;
+
+    msg_Dbg(filter, "scaling %ux%u -> %ux%u VAAPI surfaces",
+            fmt_in->i_visible_width, fmt_in->i_visible_height,
+            fmt_out->i_visible_width, fmt_out->i_visible_height);
+
+    return VLC_SUCCESS;
+
+error:
+    if (filter_sys->va.ctx != VA_INVALID_ID)
+        vlc_vaapi_DestroyContext(VLC_OBJECT(filter),
+                                 filter_sys->va.dpy, filter_sys->va.ctx);
+    if (filter_sys->va.conf != VA_INVALID_ID)
+        vlc_vaapi_DestroyConfig(VLC_OBJECT(filter),
+                                filter_sys->va.dpy, filter_sys->va.conf);
+    if (filter_sys->dest_pics)
+        picture_pool_Release(filter_sys->dest_pics);
+    vlc_decoder_device_Release(filter_sys->va.dec_device);
+    free(filter_sys);
+    free(p_data);
+    return VLC_EGENERIC;
+}
+
 /*********************
  * Module descriptor *
  *********************/
@@ -1152,4 +1308,8 @@ vlc_module_begin()
 
     add_submodule()
     set_callback_video_converter(vlc_vaapi_OpenChroma, 10)
+
+    add_submodule()
+    set_callback_video_converter(OpenScale, 20)
+    add_shortcut("vaapi_scale")
 vlc_module_end()
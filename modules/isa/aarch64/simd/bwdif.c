@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * bwdif.c : AArch64 Advanced SIMD Bwdif line interpolation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <arm_neon.h>
+
+#include <vlc_common.h>
+#include "../../../video_filter/deinterlace/merge.h"
+
+void bwdif_line8_arm64(void *, const void *, const void *, const void *,
+                       int, ptrdiff_t, int, int);
+void bwdif_line16_arm64(void *, const void *, const void *, const void *,
+                        int, ptrdiff_t, int, int);
+
+/* Same computation as the C version, on 4 pixels in 32-bit lanes.
+ * The arguments are the pixels of prev2, next2, cur, prev and next
+ * on the lines at the given offsets. */
+struct bwdif_pixels
+{
+    int32x4_t p2, n2, p2m2, n2m2, p2p2, n2p2, p2m4, n2m4, p2p4, n2p4;
+    int32x4_t c, e, cm3, cp3, prevm, prevp, nextm, nextp;
+};
+
+static inline int32x4_t bwdif4(const struct bwdif_pixels *px, int32x4_t clip)
+{
+    const int32x4_t zero = vdupq_n_s32(0);
+    int32x4_t sum2 = vaddq_s32(px->p2, px->n2);
+    int32x4_t d = vshrq_n_s32(sum2, 1);
+
+    int32x4_t td0 = vabdq_s32(px->p2, px->n2);
+    int32x4_t td1 = vshrq_n_s32(vaddq_s32(vabdq_s32(px->prevm, px->c),
+                                          vabdq_s32(px->prevp, px->e)), 1);
+    int32x4_t td2 = vshrq_n_s32(vaddq_s32(vabdq_s32(px->nextm, px->c),
+                                          vabdq_s32(px->nextp, px->e)), 1);
+    int32x4_t diff = vmaxq_s32(vshrq_n_s32(td0, 1), vmaxq_s32(td1, td2));
+    uint32x4_t still = vceqq_s32(diff, zero);
+
+    /* Spatial check */
+    int32x4_t sum2m2 = vaddq_s32(px->p2m2, px->n2m2);
+    int32x4_t sum2p2 = vaddq_s32(px->p2p2, px->n2p2);
+    int32x4_t b = vsubq_s32(vshrq_n_s32(sum2m2, 1), px->c);
+    int32x4_t f = vsubq_s32(vshrq_n_s32(sum2p2, 1), px->e);
+    int32x4_t dc = vsubq_s32(d, px->c);
+    int32x4_t de = vsubq_s32(d, px->e);
+    int32x4_t max = vmaxq_s32(vmaxq_s32(de, dc), vminq_s32(b, f));
+    int32x4_t min = vminq_s32(vminq_s32(de, dc), vmaxq_s32(b, f));
+    diff = vmaxq_s32(vmaxq_s32(diff, min), vnegq_s32(max));
+
+    /* Interpolation */
+    int32x4_t ce = vaddq_s32(px->c, px->e);
+    int32x4_t c3 = vaddq_s32(px->cm3, px->cp3);
+    int32x4_t sp = vshrq_n_s32(vmlsq_n_s32(vmulq_n_s32(ce, 5077), c3, 981), 13);
+    int32x4_t sum4 = vaddq_s32(vaddq_s32(px->p2m4, px->n2m4),
+                               vaddq_s32(px->p2p4, px->n2p4));
+    int32x4_t hf = vmulq_n_s32(sum2, 5570);
+    hf = vmlsq_n_s32(hf, vaddq_s32(sum2m2, sum2p2), 3801);
+    hf = vmlaq_n_s32(hf, sum4, 1016);
+    hf = vshrq_n_s32(hf, 2);
+    hf = vmlaq_n_s32(hf, ce, 4309);
+    hf = vshrq_n_s32(vmlsq_n_s32(hf, c3, 213), 13);
+    uint32x4_t moving = vcgtq_s32(vabdq_s32(px->c, px->e), td0);
+    int32x4_t interpol = vbslq_s32(moving, hf, sp);
+
+    interpol = vminq_s32(interpol, vaddq_s32(d, diff));
+    interpol = vmaxq_s32(interpol, vsubq_s32(d, diff));
+    interpol = vminq_s32(vmaxq_s32(interpol, zero), clip);
+    return vbslq_s32(still, d, interpol);
+}
+
+/* Loads 8 pixels as two vectors of 32-bit lanes */
+static inline void load8(int32x4_t v[2], const uint8_t *p)
+{
+    uint16x8_t w = vmovl_u8(vld1_u8(p));
+    v[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(w)));
+    v[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(w)));
+}
+
+static inline void load16(int32x4_t v[2], const uint16_t *p)
+{
+    uint16x8_t w = vld1q_u16(p);
+    v[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(w)));
+    v[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(w)));
+}
+
+#define BWDIF_NEON(pixel, load) \
+    do { \
+        pixel *dst = p_dst; \
+        const pixel *prev = p_prev; \
+        const pixel *cur  = p_cur; \
+        const pixel *next = p_next; \
+        const pixel *prev2 = parity ? prev : cur; \
+        const pixel *next2 = parity ? cur  : next; \
+        const int32x4_t clip = vdupq_n_s32(clip_max); \
+ \
+        for (int x = 0; x < w; x += 8) \
+        { \
+            int32x4_t v[18][2]; \
+            struct bwdif_pixels px[2]; \
+ \
+            load(v[0],  &prev2[x]); \
+            load(v[1],  &next2[x]); \
+            load(v[2],  &prev2[x - 2 * refs]); \
+            load(v[3],  &next2[x - 2 * refs]); \
+            load(v[4],  &prev2[x + 2 * refs]); \
+            load(v[5],  &next2[x + 2 * refs]); \
+            load(v[6],  &prev2[x - 4 * refs]); \
+            load(v[7],  &next2[x - 4 * refs]); \
+            load(v[8],  &prev2[x + 4 * refs]); \
+            load(v[9],  &next2[x + 4 * refs]); \
+            load(v[10], &cur[x - refs]); \
+            load(v[11], &cur[x + refs]); \
+            load(v[12], &cur[x - 3 * refs]); \
+            load(v[13], &cur[x + 3 * refs]); \
+            load(v[14], &prev[x - refs]); \
+            load(v[15], &prev[x + refs]); \
+            load(v[16], &next[x - refs]); \
+            load(v[17], &next[x + refs]); \
+ \
+            for (int i = 0; i < 2; i++) \
+                px[i] = (struct bwdif_pixels) { \
+                    v[0][i],  v[1][i],  v[2][i],  v[3][i],  v[4][i], \
+                    v[5][i],  v[6][i],  v[7][i],  v[8][i],  v[9][i], \
+                    v[10][i], v[11][i], v[12][i], v[13][i], v[14][i], \
+                    v[15][i], v[16][i], v[17][i], \
+                }; \
+ \
+            uint16x8_t out = vcombine_u16(vqmovun_s32(bwdif4(&px[0], clip)), \
+                                          vqmovun_s32(bwdif4(&px[1], clip))); \
+            STORE(&dst[x], out); \
+        } \
+    } while (0)
+
+void bwdif_line8_arm64(void *p_dst, const void *p_prev, const void *p_cur,
+                       const void *p_next, int w, ptrdiff_t refs,
+                       int parity, int clip_max)
+{
+#define STORE(p, v) vst1_u8(p, vqmovn_u16(v))
+    BWDIF_NEON(uint8_t, load8);
+#undef STORE
+}
+
+void bwdif_line16_arm64(void *p_dst, const void *p_prev, const void *p_cur,
+                        const void *p_next, int w, ptrdiff_t refs,
+                        int parity, int clip_max)
+{
+#define STORE(p, v) vst1q_u16(p, v)
+    BWDIF_NEON(uint16_t, load16);
+#undef STORE
+}
@@ -29,6 +29,10 @@
 
 void merge8_arm64(void *, const void *, const void *, size_t);
 void merge16_arm64(void *, const void *, const void *, size_t);
+void bwdif_line8_arm64(void *, const void *, const void *, const void *,
+                       int, ptrdiff_t, int, int);
+void bwdif_line16_arm64(void *, const void *, const void *, const void *,
+                        int, ptrdiff_t, int, int);
 
 static void Probe(void *data)
 {
@@ -37,6 +41,8 @@ static void Probe(void *data)
 
         f->merges[0] = merge8_arm64;
         f->merges[1] = merge16_arm64;
+        f->bwdif_lines[0] = bwdif_line8_arm64;
+        f->bwdif_lines[1] = bwdif_line16_arm64;
     }
 }
 
@@ -0,0 +1,263 @@
+/*****************************************************************************
+ * chrome.c: Chrome trace event tracer plugin
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Writes the traces in the Trace Event Format, as loaded by chrome://tracing
+ * and https://ui.perfetto.dev: each trace becomes an instant event, and each
+ * traced object (ES, vout, aout...) gets its own track, named after its id.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_fs.h>
+#include <vlc_charset.h>
+#include <vlc_tracer.h>
+
+#include <stdarg.h>
+#include <errno.h>
+#include <assert.h>
+#include <string.h>
+
+#define CHROME_FILENAME "vlc-trace.json"
+
+typedef struct
+{
+    FILE *stream;
+    vlc_mutex_t lock;
+    bool first;
+    char **ids; /* track names, the track number is the index + 1 */
+    size_t ids_count;
+} vlc_tracer_sys_t;
+
+static void PrintEscaped(FILE *stream, const char *str)
+{
+    if (!IsUTF8(str))
+    {
+        fputs("invalid string", stream);
+        return;
+    }
+
+    for (; *str != '\0'; str++)
+    {
+        unsigned char byte = *str;
+
+        if (byte == '\"' || byte == '\\')
+            fprintf(stream, "\\%c", byte);
+        else if (byte <= 0x1F || byte == 0x7F)
+            fprintf(stream, "\\u%04x", byte);
+        else
+            fputc(byte, stream); /* UTF-8 is valid JSON as is */
+    }
+}
+
+static void PrintString(FILE *stream, const char *str)
+{
+    fputc('\"', stream);
+    if (str != NULL)
+        PrintEscaped(stream, str);
+    fputc('\"', stream);
+}
+
+static void BeginEvent(vlc_tracer_sys_t *sys)
+{
+    if (!sys->first)
+        fputs(",\n", sys->stream);
+    sys->first = false;
+}
+
+/* Returns the track of an id, naming the track the first time */
+static unsigned GetTrack(vlc_tracer_sys_t *sys, const char *id)
+{
+    if (id == NULL)
+        return 0;
+
+    for (size_t i = 0; i < sys->ids_count; i++)
+        if (strcmp(sys->ids[i], id) == 0)
+            return i + 1;
+
+    char **ids = realloc(sys->ids, (sys->ids_count + 1) * sizeof (*ids));
+    if (unlikely(ids == NULL))
+        return 0;
+    sys->ids = ids;
+
+    char *dup = strdup(id);
+    if (unlikely(dup == NULL))
+        return 0;
+    ids[sys->ids_count++] = dup;
+
+    unsigned track = sys->ids_count;
+
+    BeginEvent(sys);
+    fprintf(sys->stream, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                         "\"tid\":%u,\"args\":{\"name\":", track);
+    PrintString(sys->stream, id);
+    fputs("}}", sys->stream);
+    return track;
+}
+
+static bool IsNameKey(const struct vlc_tracer_entry *entry)
+{
+    return entry->type == VLC_TRACER_STRING
+        && (strcmp(entry->key, "type") == 0 || strcmp(entry->key, "id") == 0
+         || strcmp(entry->key, "stream") == 0
+         || strcmp(entry->key, "event") == 0);
+}
+
+static void TraceChrome(void *opaque, vlc_tick_t ts, va_list entries)
+{
+    vlc_tracer_sys_t *sys = opaque;
+    FILE *stream = sys->stream;
+    const char *type = NULL, *id = NULL, *name = NULL;
+    va_list ap;
+
+    /* First pass: the well-known keys make up the event name and track */
+    va_copy(ap, entries);
+    for (struct vlc_tracer_entry entry = va_arg(ap, struct vlc_tracer_entry);
+         entry.key != NULL; entry = va_arg(ap, struct vlc_tracer_entry))
+    {
+        if (!IsNameKey(&entry))
+            continue;
+        if (strcmp(entry.key, "type") == 0)
+            type = entry.value.string;
+        else if (strcmp(entry.key, "id") == 0)
+            id = entry.value.string;
+        else
+            name = entry.value.string;
+    }
+    va_end(ap);
+
+    vlc_mutex_lock(&sys->lock);
+    unsigned track = GetTrack(sys, id);
+
+    BeginEvent(sys);
+    fputs("{\"name\":\"", stream);
+    if (type != NULL)
+        PrintEscaped(stream, type);
+    if (type != NULL && name != NULL)
+        fputc(' ', stream);
+    if (name != NULL)
+        PrintEscaped(stream, name);
+    fputs("\",\"cat\":", stream);
+    PrintString(stream, type);
+    fprintf(stream, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%"PRId64",\"pid\":1,"
+                    "\"tid\":%u,\"args\":{", US_FROM_VLC_TICK(ts), track);
+
+    /* Second pass: everything else goes to the event arguments */
+    bool first_arg = true;
+    for (struct vlc_tracer_entry entry = va_arg(entries, struct vlc_tracer_entry);
+         entry.key != NULL; entry = va_arg(entries, struct vlc_tracer_entry))
+    {
+        if (IsNameKey(&entry))
+            continue;
+
+        if (!first_arg)
+            fputc(',', stream);
+        first_arg = false;
+
+        PrintString(stream, entry.key);
+        fputc(':', stream);
+        switch (entry.type)
+        {
+            case VLC_TRACER_INT:
+                fprintf(stream, "%"PRId64, entry.value.integer);
+                break;
+            case VLC_TRACER_TICK:
+                fprintf(stream, "%"PRId64, US_FROM_VLC_TICK(entry.value.tick));
+                break;
+            case VLC_TRACER_STRING:
+                PrintString(stream, entry.value.string);
+                break;
+            default:
+                vlc_assert_unreachable();
+        }
+    }
+    fputs("}}", stream);
+    vlc_mutex_unlock(&sys->lock);
+}
+
+static void Close(void *opaque)
+{
+    vlc_tracer_sys_t *sys = opaque;
+
+    fputs("\n]\n", sys->stream);
+    fclose(sys->stream);
+    for (size_t i = 0; i < sys->ids_count; i++)
+        free(sys->ids[i]);
+    free(sys->ids);
+    free(sys);
+}
+
+static const struct vlc_tracer_operations chrome_ops =
+{
+    TraceChrome,
+    Close
+};
+
+static const struct vlc_tracer_operations *Open(vlc_object_t *obj,
+                                               void **restrict sysp)
+{
+    vlc_tracer_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return NULL;
+
+    char *path = var_InheritString(obj, "chrome-tracer-file");
+    const char *filename = (path != NULL) ? path : CHROME_FILENAME;
+
+    /* The file holds a single JSON array, it cannot be appended to */
+    msg_Dbg(obj, "opening trace file `%s'", filename);
+    sys->stream = vlc_fopen(filename, "wt");
+    if (sys->stream == NULL)
+    {
+        msg_Err(obj, "error opening trace file `%s': %s", filename,
+                vlc_strerror_c(errno));
+        free(path);
+        free(sys);
+        return NULL;
+    }
+    free(path);
+
+    vlc_mutex_init(&sys->lock);
+    sys->first = true;
+    sys->ids = NULL;
+    sys->ids_count = 0;
+    fputs("[\n", sys->stream);
+
+    *sysp = sys;
+    return &chrome_ops;
+}
+
+#define TRACEFILE_NAME_TEXT N_("Trace filename")
+#define TRACEFILE_NAME_LONGTEXT N_("Specify the trace filename. " \
+    "It can be loaded in chrome://tracing or in the Perfetto UI.")
+
+vlc_module_begin()
+    set_shortname(N_("Chrome tracer"))
+    set_description(N_("Chrome trace event tracer"))
+    set_subcategory(SUBCAT_ADVANCED_MISC)
+    set_capability("tracer", 0)
+    set_callback(Open)
+
+    add_savefile("chrome-tracer-file", NULL, TRACEFILE_NAME_TEXT,
+                 TRACEFILE_NAME_LONGTEXT)
+vlc_module_end()
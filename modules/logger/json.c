@@ -1,5 +1,5 @@
 /*****************************************************************************
- * json.c: JSON tracer plugin
+ * json.c: JSON tracer and logger plugin
  *****************************************************************************
  * Copyright © 2021 Videolabs
  *
@@ -29,6 +29,7 @@
 #include <vlc_fs.h>
 #include <vlc_charset.h>
 #include <vlc_tracer.h>
+#include <vlc_messages.h>
 #include <vlc_memstream.h>
 
 #include <stdbool.h>
@@ -38,6 +39,7 @@
 #include <ctype.h>
 
 #define JSON_FILENAME "vlc-log.json"
+#define JSON_LOG_FILENAME "vlc-messages.json"
 
 #define TIME_FROM_TICK(ts) NS_FROM_VLC_TICK(ts)
 
@@ -259,6 +261,107 @@ static const struct vlc_tracer_operations *Open(vlc_object_t *obj,
     return ops;
 }
 
+typedef struct
+{
+    FILE *stream;
+    int verbosity;
+} vlc_logger_sys_t;
+
+/* Without any allocation: the formatted message is truncated rather */
+static void LogJson(void *opaque, int type, const vlc_log_t *meta,
+                    const char *format, va_list ap)
+{
+    static const char types[4][8] = { "info", "error", "warning", "debug" };
+    vlc_logger_sys_t *sys = opaque;
+    FILE *stream = sys->stream;
+    char msg[1024];
+
+    if (sys->verbosity < type)
+        return;
+
+    vsnprintf(msg, sizeof (msg), format, ap);
+
+    flockfile(stream);
+    JsonStartObjectSection(stream, NULL);
+    JsonPrintKeyValueNumber(stream, "Timestamp", TIME_FROM_TICK(vlc_tick_now()));
+    fputc(',', stream);
+    JsonPrintKeyValueLabel(stream, "Type", types[type]);
+    fputc(',', stream);
+    JsonPrintKeyValueLabel(stream, "Module", meta->psz_module);
+    fputc(',', stream);
+    JsonPrintKeyValueLabel(stream, "Object", meta->psz_object_type);
+    fputc(',', stream);
+    JsonPrintKeyValueNumber(stream, "ObjectId", meta->i_object_id);
+    fputc(',', stream);
+    JsonPrintKeyValueNumber(stream, "Thread", meta->tid);
+    if (meta->psz_header != NULL)
+    {
+        fputc(',', stream);
+        JsonPrintKeyValueLabel(stream, "Header", meta->psz_header);
+    }
+    fputc(',', stream);
+    JsonPrintKeyValueLabel(stream, "Message", msg);
+    JsonEndObjectSection(stream);
+    fputc('\n', stream);
+    funlockfile(stream);
+}
+
+static void CloseLogger(void *opaque)
+{
+    vlc_logger_sys_t *sys = opaque;
+
+    fclose(sys->stream);
+    free(sys);
+}
+
+static const struct vlc_logger_operations json_logger_ops =
+{
+    LogJson,
+    CloseLogger
+};
+
+static const struct vlc_logger_operations *OpenLogger(vlc_object_t *obj,
+                                                      void **restrict sysp)
+{
+    if (!var_InheritBool(obj, "json-logging"))
+        return NULL;
+
+    int verbosity = var_InheritInteger(obj, "verbose");
+    if (verbosity < 0)
+        return NULL; /* nothing to log */
+
+    vlc_logger_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return NULL;
+
+    sys->verbosity = verbosity + VLC_MSG_ERR;
+
+    const char *filename = JSON_LOG_FILENAME;
+    char *path = var_InheritString(obj, "json-logfile");
+    if (path != NULL)
+        filename = path;
+
+    sys->stream = vlc_fopen(filename, "at");
+    if (sys->stream == NULL)
+    {
+        msg_Err(obj, "error opening log file `%s': %s", filename,
+                vlc_strerror_c(errno));
+        free(path);
+        free(sys);
+        return NULL;
+    }
+    free(path);
+
+    setvbuf(sys->stream, NULL, _IOLBF, 0);
+
+    *sysp = sys;
+    return &json_logger_ops;
+}
+
+#define JSON_LOG_TEXT N_("Log to JSON file")
+#define JSON_LOG_LONGTEXT N_("Log all VLC messages to a file, " \
+    "one JSON object per line.")
+
 #define LOGFILE_NAME_TEXT N_("Log filename")
 #define LOGFILE_NAME_LONGTEXT N_("Specify the log filename.")
 
@@ -270,4 +373,13 @@ vlc_module_begin()
     set_callback(Open)
 
     add_savefile("json-tracer-file", NULL, LOGFILE_NAME_TEXT, LOGFILE_NAME_LONGTEXT)
+
+    add_submodule()
+    set_shortname(N_("Logger"))
+    set_description(N_("JSON logger"))
+    set_capability("logger", 12)
+    set_callback(OpenLogger)
+
+    add_bool("json-logging", false, JSON_LOG_TEXT, JSON_LOG_LONGTEXT)
+    add_savefile("json-logfile", NULL, LOGFILE_NAME_TEXT, LOGFILE_NAME_LONGTEXT)
 vlc_module_end()
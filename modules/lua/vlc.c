@@ -41,6 +41,7 @@
 #include <vlc_fs.h>
 #include <vlc_services_discovery.h>
 #include <vlc_stream.h>
+#include <vlc_memstream.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -574,17 +575,156 @@ int vlclua_add_modules_path( lua_State *L, const char *psz_filename )
     return 0;
 }
 
+/*****************************************************************************
+ * Compiled scripts cache
+ *****************************************************************************
+ * The same scripts are loaded again for each new lua_State (e.g. every
+ * playlist script is probed for each opened URL). Keep their compiled
+ * chunks, so that they are only parsed once as long as they do not change.
+ *****************************************************************************/
+#define VLCLUA_CHUNKS_MAX 256
+
+struct vlclua_chunk
+{
+    struct vlclua_chunk *next;
+    char *path;
+    time_t mtime;
+    off_t size;
+    size_t length;
+    char data[];
+};
+
+static vlc_mutex_t chunks_lock = VLC_STATIC_MUTEX;
+static struct vlclua_chunk *chunks = NULL;
+static unsigned chunks_count = 0;
+
+#ifdef __has_attribute
+# if __has_attribute(destructor)
+__attribute__((destructor))
+static void vlclua_chunks_destructor( void )
+{
+    while( chunks != NULL )
+    {
+        struct vlclua_chunk *chunk = chunks;
+        chunks = chunk->next;
+        free( chunk->path );
+        free( chunk );
+    }
+}
+# endif
+#endif
+
+static int vlclua_chunk_writer( lua_State *L, const void *p, size_t sz,
+                                void *ud )
+{
+    struct vlc_memstream *ms = ud;
+    (void) L;
+    return vlc_memstream_write( ms, p, sz ) == sz ? 0 : 1;
+}
+
+static void vlclua_chunk_store( lua_State *L, const char *path,
+                                const struct stat *st )
+{
+    struct vlc_memstream ms;
+    vlc_memstream_open( &ms );
+#if LUA_VERSION_NUM >= 503
+    int ret = lua_dump( L, vlclua_chunk_writer, &ms, 0 );
+#else
+    int ret = lua_dump( L, vlclua_chunk_writer, &ms );
+#endif
+    if( vlc_memstream_close( &ms ) )
+        return;
+
+    struct vlclua_chunk *chunk = NULL;
+    if( ret == 0 )
+        chunk = malloc( sizeof( *chunk ) + ms.length );
+    if( chunk == NULL || ( chunk->path = strdup( path ) ) == NULL )
+    {
+        free( chunk );
+        free( ms.ptr );
+        return;
+    }
+    chunk->mtime = st->st_mtime;
+    chunk->size = st->st_size;
+    chunk->length = ms.length;
+    memcpy( chunk->data, ms.ptr, ms.length );
+    free( ms.ptr );
+
+    vlc_mutex_lock( &chunks_lock );
+    for( struct vlclua_chunk **pp = &chunks; *pp != NULL; pp = &(*pp)->next )
+        if( !strcmp( (*pp)->path, path ) )
+        {
+            /* the script was modified */
+            struct vlclua_chunk *old = *pp;
+            *pp = old->next;
+            free( old->path );
+            free( old );
+            chunks_count--;
+            break;
+        }
+    if( chunks_count < VLCLUA_CHUNKS_MAX )
+    {
+        chunk->next = chunks;
+        chunks = chunk;
+        chunks_count++;
+        chunk = NULL;
+    }
+    vlc_mutex_unlock( &chunks_lock );
+
+    if( chunk != NULL )
+    {
+        free( chunk->path );
+        free( chunk );
+    }
+}
+
+/** Replacement for luaL_loadfile, reusing the already compiled chunks */
+static int vlclua_loadfile( lua_State *L, const char *path )
+{
+    struct stat st;
+    /* path is in the locale encoding, as expected by luaL_loadfile() */
+    if( stat( path, &st ) )
+        return luaL_loadfile( L, path );
+
+    vlc_mutex_lock( &chunks_lock );
+    for( struct vlclua_chunk *chunk = chunks; chunk != NULL; chunk = chunk->next )
+    {
+        if( strcmp( chunk->path, path ) )
+            continue;
+        if( chunk->mtime != st.st_mtime || chunk->size != st.st_size )
+            break;
+
+        int ret = luaL_loadbuffer( L, chunk->data, chunk->length, path );
+        vlc_mutex_unlock( &chunks_lock );
+        return ret;
+    }
+    vlc_mutex_unlock( &chunks_lock );
+
+    int ret = luaL_loadfile( L, path );
+    if( ret == 0 )
+        vlclua_chunk_store( L, path, &st );
+    return ret;
+}
+
+static int vlclua_dolocalfile( lua_State *L, const char *path )
+{
+    int ret = vlclua_loadfile( L, path );
+    if( ret == 0 )
+        ret = lua_pcall( L, 0, LUA_MULTRET, 0 );
+    return ret;
+}
+
 /** Replacement for luaL_dofile, using VLC's input capabilities */
 int vlclua_dofile( vlc_object_t *p_this, lua_State *L, const char *curi )
 {
     char *uri = ToLocaleDup( curi );
     if( !strstr( uri, "://" ) ) {
-        int ret = luaL_dofile( L, uri );
+        int ret = vlclua_dolocalfile( L, uri );
         free( uri );
         return ret;
     }
     if( !strncasecmp( uri, "file://", 7 ) ) {
-        int ret = luaL_dofile( L, uri + 7 );
+        int ret = vlclua_dolocalfile( L, uri + 7 );
         free( uri );
         return ret;
     }
@@ -30,6 +30,8 @@
 #include <vlc_modules.h>
 #include <vlc_meta.h>
 #include <vlc_url.h>
+#include <vlc_executor.h>
+#include <vlc_list.h>
 
 #include <vlc_player.h>
 #include <vlc_fingerprinter.h>
@@ -40,43 +42,68 @@
  * Local prototypes
  *****************************************************************************/
 
+/* A fingerprinting job, run on the executor, then looked up */
+struct fingerprint_job
+{
+    struct vlc_runnable runnable;
+    struct vlc_list node; /* in jobs, then in lookups */
+    fingerprinter_thread_t *owner;
+    fingerprint_request_t *request;
+
+    vlc_player_t *player; /* protected by the sys lock */
+    vlc_cond_t wait;
+    bool stopped;
+
+    acoustid_fingerprint_t print;
+};
+
 struct fingerprinter_sys_t
 {
+    vlc_executor_t *executor;
     vlc_thread_t thread;
-    vlc_player_t *player;
-    vlc_player_listener_id *listener_id;
+    acoustid_config_t cfg;
 
+    vlc_mutex_t lock;
+    vlc_cond_t lookups_cond;
+    struct vlc_list jobs;    /* queued or being fingerprinted */
+    struct vlc_list lookups; /* waiting for the AcoustID lookup */
     atomic_bool abort;
 
     struct
     {
         vlc_array_t         queue;
         vlc_mutex_t         lock;
-    } incoming, results;
-
-    vlc_cond_t              incoming_cond;
-
-    struct
-    {
-        vlc_array_t         queue;
-        vlc_cond_t          cond;
-        bool                b_working;
-    } processing;
+    } results;
 };
 
 static int  Open            (vlc_object_t *);
 static void Close           (vlc_object_t *);
-static void CleanSys        (fingerprinter_sys_t *);
+static void RunJob          (void *);
 static void *Run(void *);
 
 /*****************************************************************************
  * Module descriptor
  ****************************************************************************/
+#define THREADS_TEXT N_("Fingerprinting threads")
+#define THREADS_LONGTEXT N_( \
+    "Number of tracks fingerprinted at the same time " \
+    "(0 means one per CPU).")
+#define SERVER_TEXT N_("AcoustID server")
+#define SERVER_LONGTEXT N_( \
+    "AcoustID server to query directly. By default, the queries go through " \
+    "the anonymizing VideoLAN proxy, one track at a time.")
+#define APIKEY_TEXT N_("AcoustID API key")
+#define APIKEY_LONGTEXT N_("Client API key of the AcoustID server.")
+
 vlc_module_begin ()
     set_subcategory(SUBCAT_ADVANCED_MISC)
     set_shortname(N_("acoustid"))
     set_description(N_("Track fingerprinter (based on Acoustid)"))
     set_capability("fingerprinter", 10)
+    add_integer("fingerprinter-threads", 0, THREADS_TEXT, THREADS_LONGTEXT)
+        change_integer_range(0, 64)
+    add_string("acoustid-server", NULL, SERVER_TEXT, SERVER_LONGTEXT)
+    add_string("acoustid-apikey", NULL, APIKEY_TEXT, APIKEY_LONGTEXT)
     set_callbacks(Open, Close)
 vlc_module_end ()
 
@@ -84,25 +111,36 @@ vlc_module_end ()
  * Requests lifecycle
  *****************************************************************************/
 
-static int EnqueueRequest( fingerprinter_thread_t *f, fingerprint_request_t *r )
+static void DeleteJob( struct fingerprint_job *job )
 {
-    fingerprinter_sys_t *p_sys = f->p_sys;
-    vlc_mutex_lock( &p_sys->incoming.lock );
-    int i_ret = vlc_array_append( &p_sys->incoming.queue, r );
-    vlc_cond_signal( &p_sys->incoming_cond );
-    vlc_mutex_unlock( &p_sys->incoming.lock );
-    return i_ret;
+    for( unsigned j = 0; j < job->print.results.count; j++ )
+         acoustid_result_release( &job->print.results.p_results[j] );
+    if( job->print.results.count )
+        free( job->print.results.p_results );
+    free( job->print.psz_fingerprint );
+    if( job->request )
+        fingerprint_request_Delete( job->request );
+    free( job );
 }
 
-static void QueueIncomingRequests( fingerprinter_sys_t *p_sys )
+static int EnqueueRequest( fingerprinter_thread_t *f, fingerprint_request_t *r )
 {
-    for( size_t i = vlc_array_count( &p_sys->incoming.queue ); i > 0 ; i-- )
-    {
-        fingerprint_request_t *r = vlc_array_item_at_index( &p_sys->incoming.queue, i - 1 );
-        if( vlc_array_append( &p_sys->processing.queue, r ) )
-            fingerprint_request_Delete( r );
-    }
-    vlc_array_clear( &p_sys->incoming.queue );
+    fingerprinter_sys_t *p_sys = f->p_sys;
+    struct fingerprint_job *job = calloc( 1, sizeof( *job ) );
+    if( unlikely(job == NULL) )
+        return VLC_ENOMEM;
+
+    job->runnable.run = RunJob;
+    job->runnable.userdata = job;
+    job->owner = f;
+    job->request = r;
+    vlc_cond_init( &job->wait );
+
+    vlc_mutex_lock( &p_sys->lock );
+    vlc_list_append( &job->node, &p_sys->jobs );
+    vlc_executor_Submit( p_sys->executor, &job->runnable );
+    vlc_mutex_unlock( &p_sys->lock );
+    return VLC_SUCCESS;
 }
 
 static fingerprint_request_t * GetResult( fingerprinter_thread_t *f )
@@ -136,23 +174,28 @@ static void player_on_state_changed(vlc_player_t *player,
                                     void *p_user_data)
 {
     VLC_UNUSED(player);
-    fingerprinter_sys_t *p_sys = p_user_data;
+    struct fingerprint_job *job = p_user_data;
     if (new_state == VLC_PLAYER_STATE_STOPPED)
     {
-        p_sys->processing.b_working = false;
-        vlc_cond_signal( &p_sys->processing.cond );
+        job->stopped = true;
+        vlc_cond_signal( &job->wait );
     }
 }
 
-static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
-                           acoustid_fingerprint_t *fp,
-                           const char *psz_uri )
+static input_item_t *CreateItem( fingerprinter_thread_t *p_fingerprinter,
+                                 const char *psz_uri )
 {
-    input_item_t *p_item = input_item_New( NULL, NULL );
+    input_item_t *p_item = input_item_New( psz_uri, NULL );
     if ( unlikely(p_item == NULL) )
-         return;
+         return NULL;
+
+    /* Only the beginning of the track is fingerprinted: decode it as fast as
+     * possible, without the video and subtitles */
+    unsigned i_length = CHROMAPRINT_DEFAULT_DURATION;
+    if( config_GetType( "duration" ) )
+        i_length = var_InheritInteger( p_fingerprinter, "duration" );
 
-    char *psz_sout_option;
+    char *psz_sout_option, *psz_stop_option;
     /* Note: need at -max- 2 channels, but we can't guess it before playing */
     /* the stereo upmix could make the mono tracks fingerprint to differ :/ */
     if ( asprintf( &psz_sout_option,
@@ -161,53 +204,142 @@ static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
          == -1 )
     {
         input_item_Release( p_item );
-        return;
+        return NULL;
+    }
+    if ( asprintf( &psz_stop_option, "stop-time=%u", i_length + 1 ) == -1 )
+    {
+        free( psz_sout_option );
+        input_item_Release( p_item );
+        return NULL;
     }
 
-    input_item_AddOption( p_item, psz_sout_option, VLC_INPUT_OPTION_TRUSTED );
+    const char *const ppsz_options[] = {
+        psz_sout_option, psz_stop_option, "offline", "no-video", "no-spu",
+    };
+    int i_ret = input_item_AddOptions( p_item, ARRAY_SIZE(ppsz_options),
+                                       ppsz_options, VLC_INPUT_OPTION_TRUSTED );
+    free( psz_stop_option );
     free( psz_sout_option );
-    if ( fp->i_duration )
+    if ( i_ret != VLC_SUCCESS )
     {
-        if ( asprintf( &psz_sout_option, "stop-time=%u", fp->i_duration ) == -1 )
-        {
-            input_item_Release( p_item );
-            return;
-        }
-        input_item_AddOption( p_item, psz_sout_option, VLC_INPUT_OPTION_TRUSTED );
-        free( psz_sout_option );
+        input_item_Release( p_item );
+        return NULL;
     }
-    input_item_SetURI( p_item, psz_uri ) ;
+    return p_item;
+}
+
+static void DoFingerprint( fingerprinter_thread_t *p_fingerprinter,
+                           struct fingerprint_job *job,
+                           const char *psz_uri )
+{
+    fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
+    acoustid_fingerprint_t *fp = &job->print;
+
+    input_item_t *p_item = CreateItem( p_fingerprinter, psz_uri );
+    if ( p_item == NULL )
+        return;
 
     chromaprint_fingerprint_t chroma_fingerprint;
 
     chroma_fingerprint.psz_fingerprint = NULL;
     chroma_fingerprint.i_duration = fp->i_duration;
 
-    var_Create( p_fingerprinter, "fingerprint-data", VLC_VAR_ADDRESS );
-    var_SetAddress( p_fingerprinter, "fingerprint-data", &chroma_fingerprint );
+    /* Every job has its own player, with its own fingerprint holder */
+    vlc_object_t *p_obj = vlc_object_create( p_fingerprinter, sizeof(*p_obj) );
+    if ( unlikely(p_obj == NULL) )
+        goto end;
+    var_Create( p_obj, "fingerprint-data", VLC_VAR_ADDRESS );
+    var_SetAddress( p_obj, "fingerprint-data", &chroma_fingerprint );
+
+    vlc_player_t *player = vlc_player_New( p_obj, VLC_PLAYER_LOCK_NORMAL,
+                                           NULL, NULL );
+    if ( player == NULL )
+        goto end;
+
+    static const struct vlc_player_cbs cbs = {
+        .on_state_changed = player_on_state_changed,
+    };
+
+    vlc_mutex_lock( &p_sys->lock );
+    job->player = player;
+    vlc_mutex_unlock( &p_sys->lock );
 
-    vlc_player_t *player = p_fingerprinter->p_sys->player;
     vlc_player_Lock(player);
 
-    p_fingerprinter->p_sys->processing.b_working = true;
+    vlc_player_listener_id *listener_id =
+        vlc_player_AddListener( player, &cbs, job );
 
-    int ret = vlc_player_SetCurrentMedia(player, p_item);
-    if (ret == VLC_SUCCESS)
-        ret = vlc_player_Start(player);
-    input_item_Release(p_item);
+    /* Close() stops the players after setting abort: check it with the player
+     * locked, so that the job is not started after being stopped. */
+    int ret = VLC_EGENERIC;
+    if ( listener_id != NULL
+     && !atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
+    {
+        ret = vlc_player_SetCurrentMedia(player, p_item);
+        if (ret == VLC_SUCCESS)
+            ret = vlc_player_Start(player);
+    }
 
     if (ret == VLC_SUCCESS)
     {
-        while( p_fingerprinter->p_sys->processing.b_working )
-            vlc_player_CondWait(player,
-                                &p_fingerprinter->p_sys->processing.cond);
+        while( !job->stopped )
+            vlc_player_CondWait(player, &job->wait);
 
         fp->psz_fingerprint = chroma_fingerprint.psz_fingerprint;
         if( !fp->i_duration ) /* had not given hint */
-            fp->i_duration = chroma_fingerprint.i_duration;
+        {
+            /* the fingerprinting was truncated, prefer the track length */
+            vlc_tick_t i_length = input_item_GetDuration( p_item );
+            if( i_length > 0 )
+                fp->i_duration = SEC_FROM_VLC_TICK( i_length );
+            else
+                fp->i_duration = chroma_fingerprint.i_duration;
+        }
     }
 
+    if ( listener_id != NULL )
+        vlc_player_RemoveListener( player, listener_id );
     vlc_player_Unlock(player);
+
+    vlc_mutex_lock( &p_sys->lock );
+    job->player = NULL;
+    vlc_mutex_unlock( &p_sys->lock );
+
+    vlc_player_Delete( player );
+
+end:
+    if ( p_obj != NULL )
+        vlc_object_delete( p_obj );
+    input_item_Release( p_item );
+}
+
+static void RunJob( void *userdata )
+{
+    struct fingerprint_job *job = userdata;
+    fingerprinter_thread_t *p_fingerprinter = job->owner;
+    fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
+
+    char *psz_uri = input_item_GetURI( job->request->p_item );
+    if ( psz_uri != NULL )
+    {
+        /* overwrite with hint, as in this case, fingerprint's session will be truncated */
+        job->print.i_duration = job->request->i_duration;
+
+        DoFingerprint( p_fingerprinter, job, psz_uri );
+        free( psz_uri );
+    }
+
+    vlc_mutex_lock( &p_sys->lock );
+    vlc_list_remove( &job->node );
+    if ( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
+    {
+        vlc_mutex_unlock( &p_sys->lock );
+        DeleteJob( job );
+        return;
+    }
+    vlc_list_append( &job->node, &p_sys->lookups );
+    vlc_cond_signal( &p_sys->lookups_cond );
+    vlc_mutex_unlock( &p_sys->lock );
 }
 
 /*****************************************************************************
@@ -223,40 +355,33 @@ static int Open(vlc_object_t *p_this)
 
     p_fingerprinter->p_sys = p_sys;
 
-    var_Create(p_fingerprinter, "vout", VLC_VAR_STRING);
-    var_SetString(p_fingerprinter, "vout", "dummy");
-    var_Create(p_fingerprinter, "aout", VLC_VAR_STRING);
-    var_SetString(p_fingerprinter, "aout", "dummy");
-    p_sys->player = vlc_player_New(VLC_OBJECT(p_fingerprinter),
-                                   VLC_PLAYER_LOCK_NORMAL, NULL, NULL );
-    if (!p_sys->player)
+    unsigned i_threads = var_InheritInteger( p_fingerprinter,
+                                             "fingerprinter-threads" );
+    if ( i_threads == 0 )
+        i_threads = vlc_GetCPUCount();
+    p_sys->executor = vlc_executor_New( i_threads );
+    if ( !p_sys->executor )
     {
         free(p_sys);
         return VLC_ENOMEM;
     }
 
-    static const struct vlc_player_cbs cbs = {
-        .on_state_changed = player_on_state_changed,
-    };
+    var_Create(p_fingerprinter, "vout", VLC_VAR_STRING);
+    var_SetString(p_fingerprinter, "vout", "dummy");
+    var_Create(p_fingerprinter, "aout", VLC_VAR_STRING);
+    var_SetString(p_fingerprinter, "aout", "dummy");
 
-    vlc_player_Lock(p_sys->player);
-    p_sys->listener_id =
-        vlc_player_AddListener(p_sys->player, &cbs, p_fingerprinter->p_sys);
-    vlc_player_Unlock(p_sys->player);
-    if (!p_sys->listener_id)
-    {
-        vlc_player_Delete(p_sys->player);
-        free(p_sys);
-        return VLC_ENOMEM;
-    }
+    p_sys->cfg.p_obj = VLC_OBJECT(p_fingerprinter);
+    p_sys->cfg.psz_server = var_InheritString( p_fingerprinter,
+                                               "acoustid-server" );
+    p_sys->cfg.psz_apikey = var_InheritString( p_fingerprinter,
+                                               "acoustid-apikey" );
 
+    vlc_mutex_init( &p_sys->lock );
+    vlc_cond_init( &p_sys->lookups_cond );
+    vlc_list_init( &p_sys->jobs );
+    vlc_list_init( &p_sys->lookups );
     atomic_init( &p_sys->abort, false );
-    vlc_array_init( &p_sys->incoming.queue );
-    vlc_mutex_init( &p_sys->incoming.lock );
-    vlc_cond_init( &p_sys->incoming_cond );
-
-    vlc_array_init( &p_sys->processing.queue );
-    vlc_cond_init( &p_sys->processing.cond );
 
     vlc_array_init( &p_sys->results.queue );
     vlc_mutex_init( &p_sys->results.lock );
@@ -269,15 +394,16 @@ static int Open(vlc_object_t *p_this)
     if( vlc_clone( &p_sys->thread, Run, p_fingerprinter ) )
     {
         msg_Err( p_fingerprinter, "cannot spawn fingerprinter thread" );
-        goto error;
+        vlc_executor_Delete( p_sys->executor );
+        free( p_sys->cfg.psz_server );
+        free( p_sys->cfg.psz_apikey );
+        free( p_sys );
+        return VLC_EGENERIC;
     }
 
+    msg_Dbg( p_fingerprinter, "fingerprinting up to %u tracks at once",
+             i_threads );
     return VLC_SUCCESS;
-
-error:
-    CleanSys( p_sys );
-    free( p_sys );
-    return VLC_EGENERIC;
 }
 
 /*****************************************************************************
@@ -287,35 +413,43 @@ static void Close(vlc_object_t *p_this)
 {
     fingerprinter_thread_t   *p_fingerprinter = (fingerprinter_thread_t*) p_this;
     fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
+    struct fingerprint_job *job;
 
-    vlc_mutex_lock( &p_sys->incoming.lock );
+    vlc_mutex_lock( &p_sys->lock );
     atomic_store_explicit( &p_sys->abort, true, memory_order_relaxed );
-    vlc_cond_signal( &p_sys->incoming_cond );
-    vlc_mutex_unlock( &p_sys->incoming.lock );
-    vlc_join( p_sys->thread, NULL );
-
-    CleanSys( p_sys );
-    free( p_sys );
-}
+    vlc_list_foreach( job, &p_sys->jobs, node )
+    {
+        if ( vlc_executor_Cancel( p_sys->executor, &job->runnable ) )
+        {
+            vlc_list_remove( &job->node );
+            DeleteJob( job );
+        }
+        else if ( job->player != NULL )
+        {
+            vlc_player_Lock( job->player );
+            vlc_player_Stop( job->player );
+            vlc_player_Unlock( job->player );
+        }
+    }
+    vlc_cond_signal( &p_sys->lookups_cond );
+    vlc_mutex_unlock( &p_sys->lock );
 
-static void CleanSys( fingerprinter_sys_t *p_sys )
-{
-    for ( size_t i = 0; i < vlc_array_count( &p_sys->incoming.queue ); i++ )
-        fingerprint_request_Delete( vlc_array_item_at_index( &p_sys->incoming.queue, i ) );
-    vlc_array_clear( &p_sys->incoming.queue );
+    /* The running jobs delete themselves */
+    vlc_executor_WaitIdle( p_sys->executor );
+    vlc_executor_Delete( p_sys->executor );
+    vlc_join( p_sys->thread, NULL );
 
-    for ( size_t i = 0; i < vlc_array_count( &p_sys->processing.queue ); i++ )
-        fingerprint_request_Delete( vlc_array_item_at_index( &p_sys->processing.queue, i ) );
-    vlc_array_clear( &p_sys->processing.queue );
+    assert( vlc_list_is_empty( &p_sys->jobs ) );
+    vlc_list_foreach( job, &p_sys->lookups, node )
+        DeleteJob( job );
 
     for ( size_t i = 0; i < vlc_array_count( &p_sys->results.queue ); i++ )
         fingerprint_request_Delete( vlc_array_item_at_index( &p_sys->results.queue, i ) );
     vlc_array_clear( &p_sys->results.queue );
 
-    vlc_player_Lock(p_sys->player);
-    vlc_player_RemoveListener(p_sys->player, p_sys->listener_id);
-    vlc_player_Unlock(p_sys->player);
-    vlc_player_Delete(p_sys->player);
+    free( p_sys->cfg.psz_server );
+    free( p_sys->cfg.psz_apikey );
+    free( p_sys );
 }
 
 static void fill_metas_with_results( fingerprint_request_t *p_r, acoustid_fingerprint_t *p_f )
@@ -340,11 +474,11 @@ static void fill_metas_with_results( fingerprint_request_t *p_r, acoustid_finger
 }
 
 /*****************************************************************************
- * Run :
+ * Run : looks up the fingerprints, as many at once as available
  *****************************************************************************/
 static void *Run( void *opaque )
 {
-    vlc_thread_set_name("vlc-fingerprint");
+    vlc_thread_set_name("vlc-acoustid");
 
     fingerprinter_thread_t *p_fingerprinter = opaque;
     fingerprinter_sys_t *p_sys = p_fingerprinter->p_sys;
@@ -352,50 +486,51 @@ static void *Run( void *opaque )
     /* main loop */
     for (;;)
     {
-        vlc_mutex_lock( &p_sys->incoming.lock );
+        struct vlc_list batch;
+        struct fingerprint_job *job;
+        size_t i_count = 0;
+
+        vlc_list_init( &batch );
 
-        while( vlc_array_count( &p_sys->incoming.queue ) == 0 )
+        vlc_mutex_lock( &p_sys->lock );
+        while( vlc_list_is_empty( &p_sys->lookups ) )
         {
             if( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
             {
-                vlc_mutex_unlock( &p_sys->incoming.lock );
+                vlc_mutex_unlock( &p_sys->lock );
                 return NULL;
             }
-            vlc_cond_wait( &p_sys->incoming_cond, &p_sys->incoming.lock );
+            vlc_cond_wait( &p_sys->lookups_cond, &p_sys->lock );
         }
+        vlc_list_foreach( job, &p_sys->lookups, node )
+        {
+            vlc_list_remove( &job->node );
+            vlc_list_append( &job->node, &batch );
+            i_count++;
+        }
+        vlc_mutex_unlock( &p_sys->lock );
 
-        QueueIncomingRequests( p_sys );
-
-        vlc_mutex_unlock( &p_sys->incoming.lock );
+        acoustid_fingerprint_t **pp_prints =
+            vlc_alloc( i_count, sizeof( *pp_prints ) );
+        if ( pp_prints != NULL )
+        {
+            size_t i = 0;
+            vlc_list_foreach( job, &batch, node )
+                pp_prints[i++] = &job->print;
+            acoustid_lookup_fingerprints( &p_sys->cfg, pp_prints, i_count );
+            free( pp_prints );
+        }
 
         bool results_available = false;
-        while( vlc_array_count( &p_sys->processing.queue ) )
+        vlc_list_foreach( job, &batch, node )
         {
-            fingerprint_request_t *p_data = vlc_array_item_at_index( &p_sys->processing.queue, 0 );
-
-            char *psz_uri = input_item_GetURI( p_data->p_item );
-            if ( psz_uri != NULL )
-            {
-                 acoustid_fingerprint_t acoustid_print = {0};
-
-                /* overwrite with hint, as in this case, fingerprint's session will be truncated */
-                if ( p_data->i_duration )
-                     acoustid_print.i_duration = p_data->i_duration;
+            fingerprint_request_t *p_data = job->request;
 
-                DoFingerprint( p_fingerprinter, &acoustid_print, psz_uri );
-                free( psz_uri );
-
-                acoustid_config_t cfg = { .p_obj = VLC_OBJECT(p_fingerprinter),
-                                          .psz_server = NULL, .psz_apikey = NULL };
-                acoustid_lookup_fingerprint( &cfg, &acoustid_print );
-                fill_metas_with_results( p_data, &acoustid_print );
-
-                for( unsigned j = 0; j < acoustid_print.results.count; j++ )
-                     acoustid_result_release( &acoustid_print.results.p_results[j] );
-                if( acoustid_print.results.count )
-                    free( acoustid_print.results.p_results );
-                free( acoustid_print.psz_fingerprint );
-            }
+            fill_metas_with_results( p_data, &job->print );
+            p_data->results.psz_fingerprint = job->print.psz_fingerprint;
+            job->print.psz_fingerprint = NULL;
+            job->request = NULL;
+            DeleteJob( job );
 
             /* copy results */
             vlc_mutex_lock( &p_sys->results.lock );
@@ -404,14 +539,6 @@ static void *Run( void *opaque )
             else
                 results_available = true;
             vlc_mutex_unlock( &p_sys->results.lock );
-
-            // the fingerprint request must not exist both in the
-            // processing and results queue, even in case of thread
-            // cancellation, so remove it immediately
-            vlc_array_remove( &p_sys->processing.queue, 0 );
-
-            if( atomic_load_explicit( &p_sys->abort, memory_order_relaxed ) )
-                return NULL;
         }
 
         if ( results_available )
@@ -38,6 +38,7 @@
 #include <vlc_tls.h>
 #include <vlc_block.h>
 #include <vlc_dialog.h>
+#include <vlc_memstream.h>
 
 #include <gnutls/gnutls.h>
 #include <gnutls/x509.h>
@@ -47,8 +48,93 @@ typedef struct vlc_tls_gnutls
     vlc_tls_t tls;
     gnutls_session_t session;
     vlc_object_t *obj;
+    char *cache_key; /* client session resumption key, or NULL */
+    bool handshake_started;
+    bool resumable;
 } vlc_tls_gnutls_t;
 
+/* Maximum number of client sessions kept for resumption */
+#define SESSION_CACHE_SIZE 32
+
+/* Resumption data of the client sessions, shared by all credentials so that
+ * the connections of different inputs to the same server resume each other's
+ * sessions. Keyed by server name, service and ALPN. */
+static struct
+{
+    vlc_mutex_t lock;
+    unsigned count;
+    struct
+    {
+        char *key;
+        gnutls_datum_t data;
+    } entries[SESSION_CACHE_SIZE];
+} session_cache = { VLC_STATIC_MUTEX, 0, { { NULL, { NULL, 0 } } } };
+
+static void gnutls_SessionLoad(vlc_tls_gnutls_t *priv)
+{
+    vlc_mutex_lock(&session_cache.lock);
+    for (unsigned i = 0; i < session_cache.count; i++)
+        if (strcmp(session_cache.entries[i].key, priv->cache_key) == 0)
+        {
+            const gnutls_datum_t *data = &session_cache.entries[i].data;
+
+            /* The data is copied */
+            if (gnutls_session_set_data(priv->session, data->data,
+                                        data->size) == 0)
+                msg_Dbg(priv->obj, "trying to resume TLS session");
+            break;
+        }
+    vlc_mutex_unlock(&session_cache.lock);
+}
+
+static void gnutls_SessionSave(vlc_tls_gnutls_t *priv)
+{
+    gnutls_session_t session = priv->session;
+    gnutls_datum_t data;
+
+#if GNUTLS_VERSION_NUMBER >= 0x030603
+    /* TLS 1.3 tickets are received after the handshake, if at all */
+    if (gnutls_protocol_get_version(session) == GNUTLS_TLS1_3
+     && !(gnutls_session_get_flags(session) & GNUTLS_SFLAGS_SESSION_TICKET))
+        return;
+#endif
+    if (gnutls_session_get_data2(session, &data) != 0)
+        return;
+
+    vlc_mutex_lock(&session_cache.lock);
+    unsigned i = 0;
+    while (i < session_cache.count
+        && strcmp(session_cache.entries[i].key, priv->cache_key) != 0)
+        i++;
+
+    if (i == session_cache.count)
+    {
+        char *key = strdup(priv->cache_key);
+        if (unlikely(key == NULL))
+        {
+            vlc_mutex_unlock(&session_cache.lock);
+            gnutls_free(data.data);
+            return;
+        }
+
+        if (session_cache.count == SESSION_CACHE_SIZE)
+        {   /* Evict the least recently stored session */
+            free(session_cache.entries[0].key);
+            gnutls_free(session_cache.entries[0].data.data);
+            memmove(session_cache.entries, session_cache.entries + 1,
+                    --session_cache.count * sizeof (session_cache.entries[0]));
+            i--;
+        }
+        session_cache.entries[i].key = key;
+        session_cache.count++;
+    }
+    else
+        gnutls_free(session_cache.entries[i].data.data);
+
+    session_cache.entries[i].data = data;
+    vlc_mutex_unlock(&session_cache.lock);
+}
+
 static void gnutls_Banner(vlc_object_t *obj)
 {
     msg_Dbg(obj, "using GnuTLS v%s (built with v"GNUTLS_VERSION")",
@@ -207,6 +293,9 @@ static void gnutls_Close (vlc_tls_t *tls)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
 
+    if (priv->resumable)
+        gnutls_SessionSave(priv); /* in case a ticket was received since */
+    free(priv->cache_key);
     gnutls_deinit(priv->session);
     free(priv);
 }
@@ -297,6 +386,9 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
 
     priv->session = session;
     priv->obj = obj;
+    priv->cache_key = NULL;
+    priv->handshake_started = false;
+    priv->resumable = false;
 
     vlc_tls_t *tls = &priv->tls;
 
@@ -354,6 +446,8 @@ static int gnutls_Handshake(vlc_tls_t *tls, char **restrict alp)
         msg_Dbg(obj, " - encrypt then MAC (RFC7366) enabled");
     if (flags & GNUTLS_SFLAGS_FALSE_START)
         msg_Dbg(obj, " - false start (RFC7918) enabled");
+    if (gnutls_session_is_resumed(session))
+        msg_Dbg(obj, " - session resumed");
 
     if (alp != NULL)
     {
@@ -390,16 +484,28 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
     gnutls_dh_set_prime_bits (session, 1024);
 
     if (likely(hostname != NULL))
+    {
         /* fill Server Name Indication */
         gnutls_server_name_set (session, GNUTLS_NAME_DNS,
                                 hostname, strlen (hostname));
 
+        /* The service is only known at handshake: see below */
+        struct vlc_memstream key;
+
+        vlc_memstream_open(&key);
+        vlc_memstream_puts(&key, hostname);
+        for (const char *const *p = alpn; p != NULL && *p != NULL; p++)
+            vlc_memstream_printf(&key, "%c%s", (p == alpn) ? '/' : ',', *p);
+        if (vlc_memstream_close(&key) == 0)
+            priv->cache_key = key.ptr;
+    }
+
     return &priv->tls;
 }
 
-static int gnutls_ClientHandshake(vlc_tls_t *tls,
-                                  const char *host, const char *service,
-                                  char **restrict alp)
+static int gnutls_ClientHandshakeVerify(vlc_tls_t *tls,
+                                        const char *host, const char *service,
+                                        char **restrict alp)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
     vlc_object_t *obj = priv->obj;
@@ -531,6 +637,40 @@ error:
     return -1;
 }
 
+static int gnutls_ClientHandshake(vlc_tls_t *tls,
+                                  const char *host, const char *service,
+                                  char **restrict alp)
+{
+    vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
+
+    if (!priv->handshake_started)
+    {
+        priv->handshake_started = true;
+
+        /* Complete the resumption key with the service, and look it up */
+        if (priv->cache_key != NULL)
+        {
+            char *key;
+
+            if (asprintf(&key, "%s@%s", service ? service : "",
+                         priv->cache_key) < 0)
+                key = NULL;
+            free(priv->cache_key);
+            priv->cache_key = key;
+            if (key != NULL)
+                gnutls_SessionLoad(priv);
+        }
+    }
+
+    int val = gnutls_ClientHandshakeVerify(tls, host, service, alp);
+    if (val == 0 && priv->cache_key != NULL)
+    {   /* Only keep the sessions with a verified peer */
+        priv->resumable = true;
+        gnutls_SessionSave(priv);
+    }
+    return val;
+}
+
 static void gnutls_ClientDestroy(vlc_tls_client_t *crd)
 {
     gnutls_certificate_credentials_t x509 = crd->sys;
@@ -601,6 +741,7 @@ typedef struct vlc_tls_creds_sys
 {
     gnutls_certificate_credentials_t x509_cred;
     gnutls_dh_params_t dh_params;
+    gnutls_datum_t ticket_key;
 } vlc_tls_creds_sys_t;
 
 /**
@@ -613,7 +754,13 @@ static vlc_tls_t *gnutls_ServerSessionOpen(vlc_tls_server_t *crd,
     vlc_tls_creds_sys_t *sys = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_SERVER,
                                                 sys->x509_cred, sk, alpn);
-    return (priv != NULL) ? &priv->tls : NULL;
+    if (priv == NULL)
+        return NULL;
+
+    /* Let the clients resume their sessions */
+    if (sys->ticket_key.data != NULL)
+        gnutls_session_ticket_enable_server(priv->session, &sys->ticket_key);
+    return &priv->tls;
 }
 
 static void gnutls_ServerDestroy(vlc_tls_server_t *crd)
@@ -623,6 +770,11 @@ static void gnutls_ServerDestroy(vlc_tls_server_t *crd)
     /* all sessions depending on the server are now deinitialized */
     gnutls_certificate_free_credentials(sys->x509_cred);
     gnutls_dh_params_deinit(sys->dh_params);
+    if (sys->ticket_key.data != NULL)
+    {
+        gnutls_memset(sys->ticket_key.data, 0, sys->ticket_key.size);
+        gnutls_free(sys->ticket_key.data);
+    }
     free(sys);
 }
 
@@ -713,6 +865,10 @@ static int OpenServer(vlc_tls_server_t *crd, const char *cert, const char *key)
 
     msg_Dbg (crd, "ciphers parameters loaded");
 
+    /* Session tickets are optional */
+    if (gnutls_session_ticket_key_generate (&sys->ticket_key) != 0)
+        sys->ticket_key.data = NULL;
+
     crd->ops = &gnutls_ServerOps;
     crd->sys = sys;
     return VLC_SUCCESS;
@@ -28,6 +28,8 @@
 #include <vlc_hash.h>
 #include <vlc_fs.h>
 
+#include <algorithm>
+
 EmbeddedThumbnail::EmbeddedThumbnail( input_attachment_t* a, vlc_fourcc_t fcc )
     : m_attachment( vlc_input_attachment_Hold( a ) )
     , m_fcc( fcc )
@@ -83,9 +85,31 @@ std::string EmbeddedThumbnail::extension() const
 }
 
 MetadataExtractor::MetadataExtractor( vlc_object_t* parent )
-    : m_currentCtx( nullptr )
+    : m_stopped( false )
     , m_obj( parent )
 {
+    auto maxInputs = var_InheritInteger( parent, "ml-parser-inputs" );
+    m_maxInputs = maxInputs > 0 ? maxInputs : 1;
+}
+
+bool MetadataExtractor::acquireInput( ParseContext& ctx )
+{
+    vlc::threads::mutex_locker lock( m_mutex );
+    while ( m_stopped == false && m_currentCtxs.size() >= m_maxInputs )
+        m_cond.wait( m_mutex );
+    if ( m_stopped == true )
+        return false;
+    m_currentCtxs.push_back( &ctx );
+    return true;
+}
+
+void MetadataExtractor::releaseInput( ParseContext& ctx )
+{
+    vlc::threads::mutex_locker lock( m_mutex );
+    auto it = std::find( begin( m_currentCtxs ), end( m_currentCtxs ), &ctx );
+    assert( it != end( m_currentCtxs ) );
+    m_currentCtxs.erase( it );
+    m_cond.broadcast();
 }
 
 void MetadataExtractor::onParserEnded( ParseContext& ctx, int status )
@@ -95,7 +119,8 @@ void MetadataExtractor::onParserEnded( ParseContext& ctx, int status )
     // We need to probe the item now, but not from the input thread
     ctx.success = status == VLC_SUCCESS;
     ctx.needsProbing = true;
-    ctx.mde->m_cond.signal();
+    // Other extractions may be waiting for their own item, or for an input
+    ctx.mde->m_cond.broadcast();
 }
 
 void MetadataExtractor::populateItem( medialibrary::parser::IItem& item, input_item_t* inputItem )
@@ -227,18 +252,28 @@ medialibrary::parser::Status MetadataExtractor::run( medialibrary::parser::IItem
         &MetadataExtractor::onParserEnded,
         &MetadataExtractor::onParserSubtreeAdded,
     };
-    m_currentCtx = &ctx;
+    if ( acquireInput( ctx ) == false )
+    {
+        vlc_event_detach( &ctx.inputItem->event_manager, vlc_InputItemAttachmentsFound,
+                          &MetadataExtractor::onAttachmentFound, &ctx );
+        return medialibrary::parser::Status::Fatal;
+    }
     ctx.inputItem->i_preparse_depth = 1;
-    ctx.inputParser = {
-        input_item_Parse( ctx.inputItem.get(), m_obj, &cbs,
-                          std::addressof( ctx ) ),
-        &input_item_parser_id_Release
-    };
+    {
+        // Hold the lock so that stop() cannot miss the new parser
+        vlc::threads::mutex_locker lock( m_mutex );
+        if ( m_stopped == false )
+            ctx.inputParser = {
+                input_item_Parse( ctx.inputItem.get(), m_obj, &cbs,
+                                  std::addressof( ctx ) ),
+                &input_item_parser_id_Release
+            };
+    }
     if ( ctx.inputParser == nullptr )
     {
+        releaseInput( ctx );
         vlc_event_detach( &ctx.inputItem->event_manager, vlc_InputItemAttachmentsFound,
                           &MetadataExtractor::onAttachmentFound, &ctx );
-        m_currentCtx = nullptr;
         return medialibrary::parser::Status::Fatal;
     }
 
@@ -255,8 +290,8 @@ medialibrary::parser::Status MetadataExtractor::run( medialibrary::parser::IItem
                 break;
             }
         }
-        m_currentCtx = nullptr;
     }
+    releaseInput( ctx );
     vlc_event_detach( &ctx.inputItem->event_manager, vlc_InputItemAttachmentsFound,
                       &MetadataExtractor::onAttachmentFound, &ctx );
 
@@ -298,6 +333,11 @@ void MetadataExtractor::onRestarted()
 void MetadataExtractor::stop()
 {
     vlc::threads::mutex_locker lock{ m_mutex };
-    if ( m_currentCtx != nullptr )
-        input_item_parser_id_Interrupt( m_currentCtx->inputParser.get() );
+    m_stopped = true;
+    for ( auto ctx : m_currentCtxs )
+    {
+        if ( ctx->inputParser != nullptr )
+            input_item_parser_id_Interrupt( ctx->inputParser.get() );
+    }
+    m_cond.broadcast();
 }
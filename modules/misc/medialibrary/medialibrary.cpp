@@ -2142,6 +2142,11 @@ static void Close( vlc_object_t* obj )
 
 #define ML_VERBOSE _( "Extra verbose media library logs" )
 
+#define ML_PARSER_INPUTS_TEXT N_( "Concurrent metadata extractions" )
+#define ML_PARSER_INPUTS_LONGTEXT N_( "Maximum number of media the media " \
+    "library extracts metadata from at the same time, when it runs several " \
+    "parser threads." )
+
 vlc_module_begin()
     set_shortname(N_("media library"))
     set_description(N_( "Organize your media" ))
@@ -2149,4 +2154,6 @@ vlc_module_begin()
     set_capability("medialibrary", 100)
     set_callbacks(Open, Close)
     add_bool( "ml-verbose", false, ML_VERBOSE, nullptr )
+    add_integer_with_range( "ml-parser-inputs", 4, 1, 32,
+                            ML_PARSER_INPUTS_TEXT, ML_PARSER_INPUTS_LONGTEXT )
 vlc_module_end()
@@ -36,6 +36,7 @@
 #include <vlc_cxx_helpers.hpp>
 
 #include <cstdarg>
+#include <vector>
 
 struct vlc_event_t;
 struct vlc_object_t;
@@ -98,6 +99,8 @@ private:
     virtual void onRestarted() override;
     virtual void stop() override;
 
+    bool acquireInput( ParseContext& ctx );
+    void releaseInput( ParseContext& ctx );
     void onParserEnded( ParseContext& ctx, int status );
     void addSubtree( ParseContext& ctx, input_item_node_t *root );
     void populateItem( medialibrary::parser::IItem& item, input_item_t* inputItem );
@@ -110,7 +113,11 @@ private:
 private:
     vlc::threads::condition_variable m_cond;
     vlc::threads::mutex m_mutex;
-    ParseContext* m_currentCtx;
+    // run() may be called from several parser threads: all the contexts
+    // being extracted, at most m_maxInputs of them
+    std::vector<ParseContext*> m_currentCtxs;
+    unsigned m_maxInputs;
+    bool m_stopped;
     vlc_object_t* m_obj;
 };
 
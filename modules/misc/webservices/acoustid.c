@@ -25,6 +25,8 @@
 #include "json_helper.h"
 #include "acoustid.h"
 
+#include <vlc_memstream.h>
+
 /*****************************************************************************
  * Requests lifecycle
  *****************************************************************************/
@@ -74,32 +76,16 @@ static void parse_recordings( vlc_object_t *p_obj, const json_value *node, acous
     }
 }
 
-static bool ParseJson( vlc_object_t *p_obj, const void *p_buffer, size_t i_buffer,
-                       acoustid_results_t *p_results )
+static bool ParseResults( vlc_object_t *p_obj, const json_value *node,
+                          acoustid_results_t *p_results )
 {
-    json_value *root = json_parse_document( p_obj, p_buffer, i_buffer );
-    if( !root )
-        return false;
-
-    const json_value *node = json_getbyname( root, "status" );
-    if ( !node || node->type != json_string )
-    {
-        msg_Warn( p_obj, "status node not found or invalid" );
-        goto error;
-    }
-    if ( strcmp( node->u.string.ptr, "ok" ) != 0 )
-    {
-        msg_Warn( p_obj, "Bad request status" );
-        goto error;
-    }
-    node = json_getbyname( root, "results" );
     if ( !node || node->type != json_array )
     {
         msg_Warn( p_obj, "Bad results array or no results" );
-        goto error;
+        return false;
     }
     p_results->p_results = calloc( node->u.array.length, sizeof(acoustid_result_t) );
-    if ( ! p_results->p_results ) goto error;
+    if ( ! p_results->p_results ) return false;
     p_results->count = node->u.array.length;
     for( unsigned int i=0; i<node->u.array.length; i++ )
     {
@@ -114,12 +100,86 @@ static bool ParseJson( vlc_object_t *p_obj, const void *p_buffer, size_t i_buffe
             parse_recordings( p_obj, json_getbyname( resultnode, "recordings" ), p_result );
         }
     }
-    json_value_free( root );
     return true;
+}
+
+static json_value *ParseStatus( vlc_object_t *p_obj, const void *p_buffer,
+                                size_t i_buffer )
+{
+    json_value *root = json_parse_document( p_obj, p_buffer, i_buffer );
+    if( !root )
+        return NULL;
+
+    const json_value *node = json_getbyname( root, "status" );
+    if ( !node || node->type != json_string )
+    {
+        msg_Warn( p_obj, "status node not found or invalid" );
+        goto error;
+    }
+    if ( strcmp( node->u.string.ptr, "ok" ) != 0 )
+    {
+        msg_Warn( p_obj, "Bad request status" );
+        goto error;
+    }
+    return root;
 
 error:
-    if ( root ) json_value_free( root );
-    return false;
+    json_value_free( root );
+    return NULL;
+}
+
+static bool ParseJson( vlc_object_t *p_obj, const void *p_buffer, size_t i_buffer,
+                       acoustid_results_t *p_results )
+{
+    json_value *root = ParseStatus( p_obj, p_buffer, i_buffer );
+    if( !root )
+        return false;
+
+    bool b_ret = ParseResults( p_obj, json_getbyname( root, "results" ),
+                               p_results );
+    json_value_free( root );
+    return b_ret;
+}
+
+/* The results of a batch lookup are listed by index of the fingerprint */
+static bool ParseBatchJson( vlc_object_t *p_obj, const void *p_buffer,
+                            size_t i_buffer, acoustid_fingerprint_t **pp_data,
+                            size_t i_count )
+{
+    json_value *root = ParseStatus( p_obj, p_buffer, i_buffer );
+    if( !root )
+        return false;
+
+    const json_value *node = json_getbyname( root, "fingerprints" );
+    if ( !node || node->type != json_array )
+    {
+        msg_Warn( p_obj, "Bad fingerprints array" );
+        json_value_free( root );
+        return false;
+    }
+
+    for( unsigned int i=0; i<node->u.array.length; i++ )
+    {
+        const json_value *printnode = node->u.array.values[i];
+        if ( !printnode || printnode->type != json_object )
+            continue;
+
+        const json_value *value = json_getbyname( printnode, "index" );
+        size_t i_index;
+        if ( value && value->type == json_integer )
+            i_index = value->u.integer;
+        else if ( value && value->type == json_string )
+            i_index = strtoul( value->u.string.ptr, NULL, 10 );
+        else
+            continue;
+
+        if ( i_index >= i_count || pp_data[i_index]->results.count )
+            continue;
+        ParseResults( p_obj, json_getbyname( printnode, "results" ),
+                      &pp_data[i_index]->results );
+    }
+    json_value_free( root );
+    return true;
 }
 
 int acoustid_lookup_fingerprint( const acoustid_config_t *p_cfg, acoustid_fingerprint_t *p_data )
@@ -168,3 +228,70 @@ int acoustid_lookup_fingerprint( const acoustid_config_t *p_cfg, acoustid_finger
 
     return VLC_SUCCESS;
 }
+
+/* Only the AcoustID servers support batch lookups, not the anonymizing
+ * proxy. The fingerprints are sent in the URL, so a batch is also limited by
+ * its length. */
+static size_t LookupBatch( const acoustid_config_t *p_cfg,
+                           acoustid_fingerprint_t **pp_data, size_t i_count )
+{
+    struct vlc_memstream url;
+    size_t i_batch = 0;
+
+    vlc_memstream_open( &url );
+    vlc_memstream_printf( &url, "https://%s/v2/lookup"
+                          "?client=%s"
+                          "&meta=recordings+tracks+usermeta+releases",
+                          p_cfg->psz_server,
+                          p_cfg->psz_apikey ? p_cfg->psz_apikey : "" );
+
+    while( i_batch < i_count && i_batch < ACOUSTID_BATCH_MAX )
+    {
+        const acoustid_fingerprint_t *p_data = pp_data[i_batch];
+
+        if( i_batch > 0 && url.length + strlen( p_data->psz_fingerprint )
+                           > ACOUSTID_URL_MAX )
+            break;
+        vlc_memstream_printf( &url, "&duration.%zu=%u&fingerprint.%zu=%s",
+                              i_batch, p_data->i_duration,
+                              i_batch, p_data->psz_fingerprint );
+        i_batch++;
+    }
+
+    if( vlc_memstream_close( &url ) )
+        return i_batch;
+
+    msg_Dbg( p_cfg->p_obj, "Querying AcoustID for %zu fingerprints", i_batch );
+    size_t i_buffer;
+    void *p_buffer = json_retrieve_document( p_cfg->p_obj, url.ptr, &i_buffer );
+    free( url.ptr );
+    if( !p_buffer )
+        return i_batch;
+
+    if ( !ParseBatchJson( p_cfg->p_obj, p_buffer, i_buffer, pp_data, i_batch ) )
+        msg_Dbg( p_cfg->p_obj, "No results" );
+    free( p_buffer );
+
+    return i_batch;
+}
+
+void acoustid_lookup_fingerprints( const acoustid_config_t *p_cfg,
+                                   acoustid_fingerprint_t **pp_data,
+                                   size_t i_count )
+{
+    /* Skip the fingerprints which could not be computed */
+    size_t i_valid = 0;
+    for( size_t i = 0; i < i_count; i++ )
+        if( pp_data[i]->psz_fingerprint )
+            pp_data[i_valid++] = pp_data[i];
+
+    if( !p_cfg->psz_server )
+    {
+        for( size_t i = 0; i < i_valid; i++ )
+            acoustid_lookup_fingerprint( p_cfg, pp_data[i] );
+        return;
+    }
+
+    for( size_t i = 0; i < i_valid; )
+        i += LookupBatch( p_cfg, &pp_data[i], i_valid - i );
+}
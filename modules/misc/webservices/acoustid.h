@@ -21,6 +21,10 @@
 #define ACOUSTID_ANON_SERVER_PATH   "/acoustid.php"
 #define MB_ID_SIZE 36
 
+/* Maximum number of fingerprints per lookup, and length of a lookup URL */
+#define ACOUSTID_BATCH_MAX 10
+#define ACOUSTID_URL_MAX   (32 * 1024)
+
 struct acoustid_mb_result_t
 {
     char *psz_artist;
@@ -64,4 +68,13 @@ typedef struct
 } acoustid_config_t;
 
 int acoustid_lookup_fingerprint( const acoustid_config_t *, acoustid_fingerprint_t * );
+
+/**
+ * Looks up several fingerprints, in as few requests as possible.
+ *
+ * The fingerprints without data are skipped. The array is reordered.
+ */
+void acoustid_lookup_fingerprints( const acoustid_config_t *,
+                                   acoustid_fingerprint_t **pp_data,
+                                   size_t i_count );
 void acoustid_result_release( acoustid_result_t * );
@@ -54,6 +54,18 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define CHUNK_TEXT N_("Fragment duration (ms)")
+#define CHUNK_LONGTEXT N_(\
+    "Duration of the fragments (moof and mdat) of the fragmented muxer. " \
+    "Short fragments lower the latency of live streams.")
+
+#define SEGMENT_TEXT N_("Segment duration (ms)")
+#define SEGMENT_LONGTEXT N_(\
+    "Start a new segment at the first video keyframe after each multiple " \
+    "of this duration, and flag its first fragment as a header for " \
+    "segmenters. Renditions encoded with the same keyframes get the same " \
+    "segment boundaries. 0 disables segmentation.")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static void CloseFrag  (vlc_object_t *);
@@ -77,6 +89,10 @@ add_submodule ()
     set_shortname("MP4 Frag")
     add_shortcut("mp4frag", "mp4stream")
     set_capability("sout mux", 0)
+    add_integer(SOUT_CFG_PREFIX "chunk", 1500, CHUNK_TEXT, CHUNK_LONGTEXT)
+        change_integer_range(10, 60000)
+    add_integer(SOUT_CFG_PREFIX "segment", 0, SEGMENT_TEXT, SEGMENT_LONGTEXT)
+        change_integer_range(0, 600000)
     set_callbacks(Open, CloseFrag)
 
 vlc_module_end ()
@@ -85,7 +101,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "chunk", "segment", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -171,6 +187,11 @@ typedef struct
     /* mp4frag */
     vlc_tick_t     i_written_duration;
     uint32_t       i_mfhd_sequence;
+    vlc_tick_t     i_fragment_length;
+    vlc_tick_t     i_segment_length; /* 0 if not segmented */
+    vlc_tick_t     i_next_segment;   /* earliest start of the next segment */
+    vlc_tick_t     i_segment_cut;    /* start of the next segment, if known */
+    bool           b_segment_start;  /* next moof starts a segment */
 } sout_mux_sys_t;
 
 static void mp4_stream_Delete(mp4_stream_t *p_stream)
@@ -289,6 +310,13 @@ static int Open(vlc_object_t *p_this)
     p_sys->i_written_duration= 0;
     p_sys->i_start_dts = VLC_TICK_INVALID;
     p_sys->i_mfhd_sequence = 1;
+    p_sys->i_fragment_length = VLC_TICK_FROM_MS(
+                var_InheritInteger(p_mux, SOUT_CFG_PREFIX "chunk"));
+    p_sys->i_segment_length = VLC_TICK_FROM_MS(
+                var_InheritInteger(p_mux, SOUT_CFG_PREFIX "segment"));
+    p_sys->i_next_segment = p_sys->i_segment_length;
+    p_sys->i_segment_cut = 0;
+    p_sys->b_segment_start = false;
 
     p_mux->p_sys        = p_sys;
     p_mux->pf_control   = Control;
@@ -899,8 +927,6 @@ static void box_send(sout_mux_t *p_mux,  bo_t *box)
 /***************************************************************************
     MP4 Live submodule
 ****************************************************************************/
-#define FRAGMENT_LENGTH  VLC_TICK_FROM_MS(1500)
-
 #define ENQUEUE_ENTRY(object, entry) \
     do {\
         if (object.p_last)\
@@ -1286,7 +1312,7 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
 {
     sout_mux_sys_t *p_sys = (sout_mux_sys_t*) p_mux->p_sys;
     bo_t *moof = NULL;
-    vlc_tick_t i_barrier_time = p_sys->i_written_duration + FRAGMENT_LENGTH;
+    vlc_tick_t i_barrier_time = p_sys->i_written_duration + p_sys->i_fragment_length;
     size_t i_mdat_size = 0;
     bool b_has_samples = false;
 
@@ -1318,6 +1344,12 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
         }
     }
 
+    /* never write a fragment across a segment boundary */
+    if (p_sys->i_segment_cut > p_sys->i_written_duration)
+        i_barrier_time = __MIN(i_barrier_time, p_sys->i_segment_cut);
+    const bool b_segment_end = p_sys->i_segment_cut > 0 &&
+                               i_barrier_time == p_sys->i_segment_cut;
+
     if (!p_sys->b_header_sent)
         FlushHeader(p_mux);
 
@@ -1332,6 +1364,12 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
 
     if (moof)
     {
+        if (p_sys->b_segment_start)
+        {
+            /* let segmenters (livehttp) cut before this fragment */
+            moof->b->i_flags |= BLOCK_FLAG_HEADER;
+            p_sys->b_segment_start = false;
+        }
         msg_Dbg(p_mux, "writing moof @ %"PRId64, p_sys->i_pos);
         p_sys->i_pos += bo_size(moof);
         assert(moof->b->i_flags & BLOCK_FLAG_TYPE_I); /* http sout */
@@ -1345,6 +1383,12 @@ static void WriteFragments(sout_mux_t *p_mux, bool b_flush)
             mp4_stream_t *p_stream = p_sys->pp_streams[i];
             p_stream->i_last_iframe_time = 0;
         }
+
+        if (b_segment_end && !b_flush)
+        {
+            p_sys->i_segment_cut = 0;
+            p_sys->b_segment_start = true;
+        }
     }
 }
 
@@ -1473,8 +1517,22 @@ static int MuxFrag(sout_mux_t *p_mux)
         ENQUEUE_ENTRY(p_stream->read, p_stream->p_held_entry);
         p_stream->p_held_entry = NULL;
 
+        /* The first keyframe after the segment duration starts the next
+         * segment. The boundaries are on a grid of the segment duration, so
+         * that they match across renditions. */
+        const vlc_tick_t i_sample_time = mp4mux_track_GetDuration(p_stream->tinfo);
+        if (p_sys->i_segment_length > 0 && p_sys->i_segment_cut == 0 &&
+            i_sample_time >= p_sys->i_next_segment &&
+            (p_heldblock->i_flags & BLOCK_FLAG_TYPE_I) &&
+            mp4mux_track_GetFmt(p_stream->tinfo)->i_cat == VIDEO_ES)
+        {
+            p_sys->i_segment_cut = i_sample_time;
+            p_sys->i_next_segment = (i_sample_time / p_sys->i_segment_length + 1)
+                                  * p_sys->i_segment_length;
+        }
+
         if (p_stream->b_hasiframes && (p_heldblock->i_flags & BLOCK_FLAG_TYPE_I) &&
-            mp4mux_track_GetDuration(p_stream->tinfo) - p_sys->i_written_duration < FRAGMENT_LENGTH)
+            i_sample_time - p_sys->i_written_duration < p_sys->i_fragment_length)
         {
             /* Flag the last iframe time, we'll use it as boundary so it will start
                next fragment */
@@ -1527,7 +1585,7 @@ static int MuxFrag(sout_mux_t *p_mux)
     p_sys->i_written_duration = i_min_written_duration;
 
     /* we have prerolled enough to know all streams, and have enough date to create a fragment */
-    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= FRAGMENT_LENGTH)
+    if (p_stream->read.p_first && p_sys->i_read_duration - p_sys->i_written_duration >= p_sys->i_fragment_length)
         WriteFragments(p_mux, false);
 
     return VLC_SUCCESS;
@@ -48,6 +48,10 @@ struct csa_t
     int     p, q, r;
 
     bool    use_odd;
+
+    /* csa_DecryptBatch scratch buffers */
+    uint8_t stream[CSA_BATCH_SIZE][184/8][8];
+    uint8_t ib[CSA_BATCH_SIZE * (184/8)][8];
 };
 
 static void csa_ComputeKey( uint8_t kk[57], uint8_t ck[8] );
@@ -57,6 +61,11 @@ static void csa_StreamCypher( csa_t *c, int b_init, uint8_t *ck, uint8_t *sb, ui
 static void csa_BlockDecypher( uint8_t kk[57], uint8_t ib[8], uint8_t bd[8] );
 static void csa_BlockCypher( uint8_t kk[57], uint8_t bd[8], uint8_t ib[8] );
 
+static void csa_BitslicedStream( csa_t *c, uint8_t *pkts[], const int *hdrs,
+                                 int i_count, int i_stream );
+static void csa_BlockDecypherMany( const uint8_t kk[57], uint8_t (*ib)[8],
+                                   int i_count );
+
 /*****************************************************************************
  * csa_New:
  *****************************************************************************/
@@ -221,6 +230,122 @@ void csa_Decrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     }
 }
 
+/*****************************************************************************
+ * csa_DecryptBatch:
+ *****************************************************************************
+ * The keystream of up to CSA_BATCH_SIZE packets is generated at once by the
+ * bitsliced stream cypher, then all the blocks of the batch go through the
+ * block decypher together, one key at a time.
+ *****************************************************************************/
+static void csa_DecryptChunk( csa_t *c, uint8_t *pkts[], int i_count,
+                              int i_pkt_size )
+{
+    uint8_t *lanes[CSA_BATCH_SIZE];
+    int      hdrs[CSA_BATCH_SIZE];
+    int      i_lanes = 0;
+    int      i_stream = 0;
+
+    for( int l = 0; l < i_count; l++ )
+    {
+        uint8_t *pkt = pkts[l];
+
+        if( (pkt[3]&0x80) == 0 )
+            continue; /* not scrambled */
+
+        int i_hdr = 4;
+        if( pkt[3]&0x20 )
+            i_hdr += pkt[4] + 1;
+
+        /* Payloads without any complete block are left to the reference
+         * implementation */
+        if( 188 - i_hdr < 8 || i_pkt_size - i_hdr < 8 )
+        {
+            csa_Decrypt( c, pkt, i_pkt_size );
+            continue;
+        }
+
+        const int n = (i_pkt_size - i_hdr) / 8;
+        const int i_needed = n - 1 + ((i_pkt_size - i_hdr) % 8 > 0);
+        if( i_needed > i_stream )
+            i_stream = i_needed;
+
+        lanes[i_lanes] = pkt;
+        hdrs[i_lanes] = i_hdr;
+        i_lanes++;
+    }
+
+    if( i_lanes == 0 )
+        return;
+
+    /* The scrambling control bits select the key of each lane */
+    csa_BitslicedStream( c, lanes, hdrs, i_lanes, i_stream );
+
+    for( int odd = 0; odd < 2; odd++ )
+    {
+        int i_blocks = 0;
+
+        /* Gather the cypher blocks, xored with the keystream but the first */
+        for( int l = 0; l < i_lanes; l++ )
+        {
+            const uint8_t *pkt = lanes[l];
+            if( !(pkt[3]&0x40) != !odd )
+                continue;
+
+            const int n = (i_pkt_size - hdrs[l]) / 8;
+            memcpy( c->ib[i_blocks++], &pkt[hdrs[l]], 8 );
+            for( int i = 1; i < n; i++, i_blocks++ )
+                for( int j = 0; j < 8; j++ )
+                    c->ib[i_blocks][j] = pkt[hdrs[l]+8*i+j] ^ c->stream[l][i-1][j];
+        }
+
+        if( i_blocks == 0 )
+            continue;
+        csa_BlockDecypherMany( odd ? c->o_kk : c->e_kk, c->ib, i_blocks );
+
+        /* Chain the decyphered blocks, and xor the residue */
+        i_blocks = 0;
+        for( int l = 0; l < i_lanes; l++ )
+        {
+            uint8_t *pkt = lanes[l];
+            if( !(pkt[3]&0x40) != !odd )
+                continue;
+
+            const int i_hdr = hdrs[l];
+            const int n = (i_pkt_size - i_hdr) / 8;
+            const int i_residue = (i_pkt_size - i_hdr) % 8;
+
+            for( int i = 1; i <= n; i++, i_blocks++ )
+                for( int j = 0; j < 8; j++ )
+                {
+                    uint8_t next = 0;
+                    if( i != n )
+                        next = pkt[i_hdr+8*i+j] ^ c->stream[l][i-1][j];
+                    pkt[i_hdr+8*(i-1)+j] = next ^ c->ib[i_blocks][j];
+                }
+
+            for( int j = 0; j < i_residue; j++ )
+                pkt[i_pkt_size - i_residue + j] ^= c->stream[l][n-1][j];
+        }
+    }
+
+    /* clear transport scrambling control */
+    for( int l = 0; l < i_lanes; l++ )
+        lanes[l][3] &= 0x3f;
+}
+
+void csa_DecryptBatch( csa_t *c, uint8_t *pkts[], size_t i_count,
+                       int i_pkt_size )
+{
+    while( i_count > 0 )
+    {
+        const int i_chunk = __MIN( i_count, CSA_BATCH_SIZE );
+
+        csa_DecryptChunk( c, pkts, i_chunk, i_pkt_size );
+        pkts += i_chunk;
+        i_count -= i_chunk;
+    }
+}
+
 /*****************************************************************************
  * csa_Encrypt:
  *****************************************************************************/
@@ -607,3 +732,240 @@ static void csa_BlockCypher( uint8_t kk[57], uint8_t bd[8], uint8_t ib[8] )
     }
 }
 
+
+/* Decyphers many blocks with the same key: the rounds of independent blocks
+ * interleave, instead of waiting on each other's table lookups */
+static void csa_BlockDecypherMany( const uint8_t kk[57], uint8_t (*ib)[8],
+                                   int i_count )
+{
+    for( int i = 56; i > 0; i-- )
+    {
+        for( int b = 0; b < i_count; b++ )
+        {
+            /* R[1]..R[8] are ib[b][0]..ib[b][7] */
+            uint8_t *R = ib[b];
+            const uint8_t sbox_out = block_sbox[ kk[i]^R[6] ];
+            const uint8_t perm_out = block_perm[sbox_out];
+            const uint8_t r8 = R[7] ^ sbox_out;
+            const uint8_t next_R8 = R[6];
+
+            R[6] = R[5] ^ perm_out;
+            R[5] = R[4];
+            R[4] = R[3] ^ r8;
+            R[3] = R[2] ^ r8;
+            R[2] = R[1] ^ r8;
+            R[1] = R[0];
+            R[0] = r8;
+            R[7] = next_R8;
+        }
+    }
+}
+
+/*****************************************************************************
+ * Bitsliced stream cypher
+ *****************************************************************************
+ * Each bit of the cypher state is held in its own word, whose bits are the
+ * states of CSA_BATCH_SIZE packets: the s-boxes become boolean expressions,
+ * evaluated for all the packets at once.
+ *****************************************************************************/
+typedef uint64_t csa_word_t;
+
+static_assert( CSA_BATCH_SIZE == 8 * sizeof( csa_word_t ),
+               "one packet per bit of the words" );
+
+struct csa_bs_state
+{
+    csa_word_t A[11][4];
+    csa_word_t B[11][4];
+    csa_word_t X[4], Y[4], Z[4];
+    csa_word_t D[4], E[4], F[4];
+    csa_word_t p, q, r;
+};
+
+/* a where sel is 0, b where sel is 1 */
+static inline csa_word_t csa_Mux( csa_word_t sel, csa_word_t a, csa_word_t b )
+{
+    return a ^ ((a ^ b) & sel);
+}
+
+/* Evaluates a 5 to 2 bits s-box as a multiplexer tree over its inputs,
+ * from in[0] (most significant) to in[4] */
+static inline void csa_BitslicedSbox( const int sbox[0x20],
+                                      const csa_word_t in[5],
+                                      csa_word_t *hi, csa_word_t *lo )
+{
+    /* the leaves select between two constant bits */
+    const csa_word_t leaf[4] = { 0, in[4], ~in[4], ~(csa_word_t)0 };
+    csa_word_t h[16], l[16];
+
+    for( int k = 0; k < 16; k++ )
+    {
+        h[k] = leaf[ (sbox[2*k]&2) | ((sbox[2*k+1] >> 1)&1) ];
+        l[k] = leaf[ ((sbox[2*k]&1) << 1) | (sbox[2*k+1]&1) ];
+    }
+    for( int n = 8, b = 3; n > 0; n /= 2, b-- )
+    {
+        for( int k = 0; k < n; k++ )
+        {
+            h[k] = csa_Mux( in[b], h[2*k], h[2*k+1] );
+            l[k] = csa_Mux( in[b], l[2*k], l[2*k+1] );
+        }
+    }
+    *hi = h[0];
+    *lo = l[0];
+}
+
+/* One byte of csa_StreamCypher() for all the lanes: in[] is the bitsliced
+ * input byte during initialisation (NULL otherwise), out[] receives the
+ * bitsliced output byte */
+static void csa_BitslicedStreamByte( struct csa_bs_state *s,
+                                     const csa_word_t in[8],
+                                     csa_word_t out[8] )
+{
+    csa_word_t (*A)[4] = s->A;
+    csa_word_t (*B)[4] = s->B;
+
+    for( int j = 0; j < 4; j++ )
+    {
+        // from A[1]..A[10], 35 bits are selected as inputs to 7 s-boxes
+        const csa_word_t i1[5] = { A[4][0], A[1][2], A[6][1], A[7][3], A[9][0] };
+        const csa_word_t i2[5] = { A[2][1], A[3][2], A[6][3], A[7][0], A[9][1] };
+        const csa_word_t i3[5] = { A[1][3], A[2][0], A[5][1], A[5][3], A[6][2] };
+        const csa_word_t i4[5] = { A[3][3], A[1][1], A[2][3], A[4][2], A[8][0] };
+        const csa_word_t i5[5] = { A[5][2], A[4][3], A[6][0], A[8][1], A[9][2] };
+        const csa_word_t i6[5] = { A[3][1], A[4][1], A[5][0], A[7][2], A[9][3] };
+        const csa_word_t i7[5] = { A[2][2], A[3][0], A[7][1], A[8][2], A[8][3] };
+        csa_word_t s1h, s1l, s2h, s2l, s3h, s3l, s4h, s4l;
+        csa_word_t s5h, s5l, s6h, s6l, s7h, s7l;
+
+        csa_BitslicedSbox( sbox1, i1, &s1h, &s1l );
+        csa_BitslicedSbox( sbox2, i2, &s2h, &s2l );
+        csa_BitslicedSbox( sbox3, i3, &s3h, &s3l );
+        csa_BitslicedSbox( sbox4, i4, &s4h, &s4l );
+        csa_BitslicedSbox( sbox5, i5, &s5h, &s5l );
+        csa_BitslicedSbox( sbox6, i6, &s6h, &s6l );
+        csa_BitslicedSbox( sbox7, i7, &s7h, &s7l );
+
+        /* use 4x4 xor to produce extra nibble for T3 */
+        const csa_word_t extra_B[4] = {
+            B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0],
+            B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1],
+            B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2],
+            B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3],
+        };
+
+        // T1, T2: the input nibbles alternate, in1 being the high one
+        csa_word_t next_A1[4], next_B1[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            next_A1[k] = A[10][k] ^ s->X[k];
+            next_B1[k] = B[7][k] ^ B[10][k] ^ s->Y[k];
+            if( in != NULL )
+            {
+                next_A1[k] ^= s->D[k] ^ in[(j % 2) ? k : 4 + k];
+                next_B1[k] ^= in[(j % 2) ? 4 + k : k];
+            }
+        }
+
+        // if p=1, rotate left
+        const csa_word_t rot[4] = { next_B1[3], next_B1[0], next_B1[1], next_B1[2] };
+        for( int k = 0; k < 4; k++ )
+            next_B1[k] = csa_Mux( s->p, next_B1[k], rot[k] );
+
+        // T3 = xor all inputs
+        for( int k = 0; k < 4; k++ )
+            s->D[k] = s->E[k] ^ s->Z[k] ^ extra_B[k];
+
+        // T4 = sum, carry of Z + E + r if q, else E
+        csa_word_t carry = s->r;
+        for( int k = 0; k < 4; k++ )
+        {
+            const csa_word_t E = s->E[k];
+            const csa_word_t sum = s->Z[k] ^ E ^ carry;
+
+            carry = (s->Z[k] & E) | (carry & (s->Z[k] ^ E));
+            s->E[k] = s->F[k];
+            s->F[k] = csa_Mux( s->q, E, sum );
+        }
+        s->r = csa_Mux( s->q, s->r, carry );
+
+        memmove( A[2], A[1], 9 * sizeof( A[1] ) );
+        memmove( B[2], B[1], 9 * sizeof( B[1] ) );
+        memcpy( A[1], next_A1, sizeof( next_A1 ) );
+        memcpy( B[1], next_B1, sizeof( next_B1 ) );
+
+        s->X[3] = s4l; s->X[2] = s3l; s->X[1] = s2h; s->X[0] = s1h;
+        s->Y[3] = s6l; s->Y[2] = s5l; s->Y[1] = s4h; s->Y[0] = s3h;
+        s->Z[3] = s2l; s->Z[2] = s1l; s->Z[1] = s6h; s->Z[0] = s5h;
+        s->p = s7h;
+        s->q = s7l;
+
+        // 2 output bits are a function of the 4 bits of D
+        out[7 - 2*j] = s->D[2] ^ s->D[3];
+        out[6 - 2*j] = s->D[0] ^ s->D[1];
+    }
+}
+
+/* Fills c->stream with the i_stream first keystream blocks of each packet */
+static void csa_BitslicedStream( csa_t *c, uint8_t *pkts[], const int *hdrs,
+                                 int i_count, int i_stream )
+{
+    struct csa_bs_state s;
+    csa_word_t odd = 0;
+    csa_word_t sb[8][8];
+
+    memset( &s, 0, sizeof( s ) );
+
+    for( int l = 0; l < i_count; l++ )
+        if( pkts[l][3]&0x40 )
+            odd |= (csa_word_t)1 << l;
+    const csa_word_t even = ~odd;
+
+    // load first 32 bits of CK into A[1]..A[8]
+    // load last  32 bits of CK into B[1]..B[8]
+    for( int i = 0; i < 4; i++ )
+    {
+        for( int k = 0; k < 4; k++ )
+        {
+            s.A[1+2*i][k] = (-(csa_word_t)((c->o_ck[i] >> (4+k))&1) & odd)
+                          | (-(csa_word_t)((c->e_ck[i] >> (4+k))&1) & even);
+            s.A[2+2*i][k] = (-(csa_word_t)((c->o_ck[i] >> k)&1) & odd)
+                          | (-(csa_word_t)((c->e_ck[i] >> k)&1) & even);
+            s.B[1+2*i][k] = (-(csa_word_t)((c->o_ck[4+i] >> (4+k))&1) & odd)
+                          | (-(csa_word_t)((c->e_ck[4+i] >> (4+k))&1) & even);
+            s.B[2+2*i][k] = (-(csa_word_t)((c->o_ck[4+i] >> k)&1) & odd)
+                          | (-(csa_word_t)((c->e_ck[4+i] >> k)&1) & even);
+        }
+    }
+
+    /* the first 8 bytes of the payloads initialise the state */
+    memset( sb, 0, sizeof( sb ) );
+    for( int l = 0; l < i_count; l++ )
+    {
+        const uint8_t *p = &pkts[l][hdrs[l]];
+
+        for( int i = 0; i < 8; i++ )
+            for( int k = 0; k < 8; k++ )
+                sb[i][k] |= (csa_word_t)((p[i] >> k)&1) << l;
+    }
+
+    csa_word_t out[8];
+    for( int i = 0; i < 8; i++ )
+        csa_BitslicedStreamByte( &s, sb[i], out );
+
+    for( int b = 0; b < i_stream; b++ )
+    {
+        for( int i = 0; i < 8; i++ )
+        {
+            csa_BitslicedStreamByte( &s, NULL, out );
+
+            for( int l = 0; l < i_count; l++ )
+            {
+                uint8_t v = 0;
+                for( int k = 0; k < 8; k++ )
+                    v |= ((out[k] >> l)&1) << k;
+                c->stream[l][b][i] = v;
+            }
+        }
+    }
+}
@@ -30,6 +30,10 @@ typedef struct csa_t csa_t;
 #define csa_UseKey  __csa_UseKey
 #define csa_Decrypt __csa_decrypt
 #define csa_Encrypt __csa_encrypt
+#define csa_DecryptBatch __csa_decrypt_batch
+
+/* Packets descrambled in parallel by csa_DecryptBatch() */
+#define CSA_BATCH_SIZE 64
 
 csa_t *csa_New( void );
 void   csa_Delete( csa_t * );
@@ -40,4 +44,8 @@ void   csa_UseKey( vlc_object_t *p_caller, csa_t *, bool use_odd );
 void   csa_Decrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 void   csa_Encrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 
+/* Same as csa_Decrypt() on each packet, but faster for many packets */
+void   csa_DecryptBatch( csa_t *, uint8_t *pkts[], size_t i_count,
+                         int i_pkt_size );
+
 #endif /* _CSA_H */
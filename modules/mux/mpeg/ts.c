@@ -182,6 +182,22 @@ static const char *const ts_standards_list_text[] =
     "The encryption routines subtract the TS-header from the value before " \
     "encrypting." )
 
+#define PACKETS_TEXT N_("TS packets per output block")
+#define PACKETS_LONGTEXT N_("Number of TS packets gathered in each block " \
+    "sent to the access output. 7 packets fit in a single UDP datagram " \
+    "with the default MTU." )
+
+#define MUXRATE_TEXT N_("Constant multiplex bitrate (bits/s)")
+#define MUXRATE_LONGTEXT N_("Produce a constant bitrate multiplex at this " \
+    "rate, by stuffing it with null packets, with the PCR computed from the " \
+    "packet positions and the decoder buffers modeled. 0 produces a variable " \
+    "bitrate multiplex." )
+
+#define PACING_TEXT N_("Pace the constant bitrate output")
+#define PACING_LONGTEXT N_("Send each output block to the access output at " \
+    "its position in the constant bitrate multiplex, from an output thread, " \
+    "instead of relying on the block dates. This is for live outputs only." )
+
 #define SOUT_CFG_PREFIX "sout-ts-"
 #define MAX_PMT 64       /* Maximum number of programs. FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
 #define MAX_PMT_PID 64       /* Maximum pids in each pmt.  FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
@@ -221,6 +237,11 @@ vlc_module_begin ()
 
     add_integer( SOUT_CFG_PREFIX "pcr", 70, PCR_TEXT, PCR_LONGTEXT)
     add_integer( SOUT_CFG_PREFIX "dts-delay", 400, DTS_TEXT, DTS_LONGTEXT)
+    add_integer_with_range( SOUT_CFG_PREFIX "packets", 7, 1, 64,
+                            PACKETS_TEXT, PACKETS_LONGTEXT )
+    add_integer( SOUT_CFG_PREFIX "muxrate", 0, MUXRATE_TEXT, MUXRATE_LONGTEXT )
+        change_integer_range( 0, INT32_MAX )
+    add_bool( SOUT_CFG_PREFIX "pacing", false, PACING_TEXT, PACING_LONGTEXT )
 
     add_obsolete_integer( "sout-ts-bmin" ) /* since 4.0.0 */
     add_obsolete_integer( "sout-ts-bmax" ) /* since 4.0.0 */
@@ -244,8 +265,8 @@ static const char *const ppsz_sout_options[] = {
     "netid", "sdtdesc",
     "es-id-pid", "shaping", "pcr", "use-key-frames",
     "dts-delay", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
-    "muxpmt", "program-pmt", "alignment",
-    NULL
+    "muxpmt", "program-pmt", "alignment", "packets", "muxrate",
+    "pacing", NULL
 };
 
 typedef struct pmt_map_t   /* Holds the mapping between the pmt-pid/pmt table */
@@ -310,13 +331,55 @@ typedef struct
 
 } pes_state_t;
 
+/* T-STD model of an elementary stream, ISO/IEC 13818-1 2.4.2, with the
+ * transport buffer TB and the elementary buffer B seen as a whole */
+#define TSTD_TB_SIZE        512
+#define TSTD_MAX_AU         64
+
+typedef struct
+{
+    int64_t     i_rx;       /* TB leak rate, bits/s */
+    size_t      i_size;     /* B size, bytes */
+
+    int64_t     i_tb;       /* TB fullness, bits */
+    vlc_tick_t  i_tb_date;
+    size_t      i_fill;     /* B fullness, bytes */
+    vlc_tick_t  i_last;     /* date of the last packet */
+
+    /* access units in B, the last one can still be incomplete. The removal
+     * date is invalid for data sent without its start, after a resync */
+    unsigned    i_au_first;
+    unsigned    i_au_count;
+    struct
+    {
+        vlc_tick_t i_removal;
+        size_t     i_size;
+    } au[TSTD_MAX_AU];
+} tstd_t;
+
 typedef struct
 {
     tsmux_stream_t  ts;
     pesmux_stream_t pes;
     pes_state_t  state;
+    tstd_t       tstd;
+    unsigned     i_cbr_cc;  /* last continuity counter sent */
 } sout_input_sys_t;
 
+/* Constant bitrate output thread */
+typedef struct
+{
+    sout_mux_t      *p_mux;
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;
+    vlc_cond_t      space;
+    block_t        *p_first;
+    block_t       **pp_last;
+    vlc_tick_t      i_last_dts;
+    bool            b_quit;
+} ts_pacer_t;
+
 typedef struct
 {
     sout_input_t    *p_pcr_input;
@@ -352,9 +415,22 @@ typedef struct
     vlc_tick_t      first_dts;
 
     bool            b_use_key_frames;
+    unsigned        i_packets_per_block;
 
     vlc_tick_t      i_pcr;  /* last PCR emitted */
 
+    /* constant bitrate */
+    uint64_t        i_muxrate;      /* bits/s, 0 for variable bitrate */
+    bool            b_cbr_started;
+    bool            b_cbr_discontinuity; /* to flag on the next PCR */
+    vlc_tick_t      i_cbr_start;    /* date of the first packet slot */
+    uint64_t        i_cbr_packets;  /* packet slots since i_cbr_start */
+    int64_t         i_cbr_pcr;      /* last PCR, 27 MHz */
+    int64_t         i_cbr_offset;   /* PTS/DTS restamping, 90 kHz */
+    uint64_t        i_cbr_held;     /* slots without sendable data */
+    sout_buffer_chain_t cbr_carry;  /* packets held by the T-STD model */
+    ts_pacer_t      *p_pacer;
+
     csa_t           *csa;
     int             i_csa_pkt_size;
     bool            b_crypt_audio;
@@ -449,13 +525,20 @@ static block_t *FixPES( sout_mux_t *p_mux, block_fifo_t *p_fifo );
 static block_t *Add_ADTS( block_t *, const es_format_t * );
 static void TSSchedule  ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
+static void TSScheduleCbr( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
 static void TSDate      ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
 static void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
 
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream, bool b_pcr );
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts );
+static void TSSetPCR( block_t *p_ts, int64_t i_pcr );
+
+static void TStdInit( tstd_t *, const es_format_t *, uint64_t i_muxrate );
+static ts_pacer_t *PacerNew( sout_mux_t * );
+static void PacerDelete( ts_pacer_t * );
+static void PacerQueue( ts_pacer_t *, block_t * );
 
 static csa_t *csaSetup( vlc_object_t *p_this )
 {
@@ -697,9 +780,24 @@ static int Open( vlc_object_t *p_this )
              p_sys->i_shaping_delay, p_sys->i_pcr_delay, p_sys->i_dts_delay );
 
     p_sys->b_use_key_frames = var_GetBool( p_mux, SOUT_CFG_PREFIX "use-key-frames" );
-
+    p_sys->i_packets_per_block =
+        __MAX( var_GetInteger( p_mux, SOUT_CFG_PREFIX "packets" ), 1 );
+    p_sys->i_muxrate =
+        __MAX( var_GetInteger( p_mux, SOUT_CFG_PREFIX "muxrate" ), 0 );
+    if( p_sys->i_muxrate > 0 )
+        msg_Dbg( p_mux, "constant bitrate multiplex at %"PRIu64" bits/s",
+                 p_sys->i_muxrate );
+
+    BufferChainInit( &p_sys->cbr_carry );
     p_mux->p_sys        = p_sys;
 
+    if( p_sys->i_muxrate > 0 && var_GetBool( p_mux, SOUT_CFG_PREFIX "pacing" ) )
+    {
+        p_sys->p_pacer = PacerNew( p_mux );
+        if( p_sys->p_pacer == NULL )
+            msg_Warn( p_mux, "cannot pace the output" );
+    }
+
     p_sys->csa = csaSetup(p_this);
 
     p_mux->pf_control   = Control;
@@ -718,6 +816,10 @@ static void Close( vlc_object_t * p_this )
     sout_mux_t          *p_mux = (sout_mux_t*)p_this;
     sout_mux_sys_t      *p_sys = p_mux->p_sys;
 
+    if( p_sys->p_pacer )
+        PacerDelete( p_sys->p_pacer );
+    BufferChainClean( &p_sys->cbr_carry );
+
     if( p_sys->p_dvbpsi )
         dvbpsi_delete( p_sys->p_dvbpsi );
 
@@ -910,6 +1012,9 @@ static int AddStream( sout_mux_t *p_mux, sout_input_t *p_input )
     /* Init pes chain */
     BufferChainInit( &p_stream->state.chain_pes );
 
+    TStdInit( &p_stream->tstd, p_input->p_fmt, p_sys->i_muxrate );
+    p_stream->i_cbr_cc = 15; /* the first packet has 0 */
+
     /* We only change PMT version (PAT isn't changed) */
     p_sys->i_pmt_version_number = ( p_sys->i_pmt_version_number + 1 )%32;
 
@@ -1508,7 +1613,10 @@ static bool MuxStreams(sout_mux_t *p_mux )
     }
 
     /* 4: date and send */
-    TSSchedule( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    if( p_sys->i_muxrate > 0 )
+        TSScheduleCbr( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    else
+        TSSchedule( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
     return false;
 }
 
@@ -1696,6 +1804,87 @@ static void TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         TSDate( p_mux, &new_chain, i_pcr_length, i_pcr_dts );
 }
 
+/* Output blocks of a write to the access output */
+typedef struct
+{
+    block_t  *p_list;
+    block_t **pp_last;
+    block_t  *p_out; /* output block being filled */
+} ts_output_t;
+
+static void TSOutputInit( ts_output_t *p_output )
+{
+    p_output->p_list = NULL;
+    p_output->pp_last = &p_output->p_list;
+    p_output->p_out = NULL;
+}
+
+/* Scrambles a dated packet and appends it to the output */
+static void TSOutputAppend( sout_mux_t *p_mux, ts_output_t *p_output,
+                            block_t *p_ts )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    const size_t i_out_size = 188 * p_sys->i_packets_per_block;
+    block_t *p_out = p_output->p_out;
+
+    if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
+    {
+        vlc_mutex_lock( &p_sys->csa_lock );
+        csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
+        vlc_mutex_unlock( &p_sys->csa_lock );
+    }
+
+    /* latency */
+    p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
+
+    /* Gather the packets into larger blocks, but start a new block at
+     * each PAT flagged as header, as segmenters cut on block boundaries */
+    if( p_out != NULL && ( p_out->i_buffer + 188 > i_out_size ||
+                           ( p_ts->i_flags & BLOCK_FLAG_HEADER ) ) )
+    {
+        block_ChainLastAppend( &p_output->pp_last, p_out );
+        p_out = NULL;
+    }
+    if( p_out == NULL && p_sys->i_packets_per_block > 1 )
+    {
+        p_out = block_Alloc( i_out_size );
+        if( likely(p_out != NULL) )
+        {
+            p_out->i_buffer = 0;
+            p_out->i_flags = p_ts->i_flags & BLOCK_FLAG_HEADER;
+            p_out->i_dts = p_ts->i_dts;
+            p_out->i_length = 0;
+        }
+    }
+    p_output->p_out = p_out;
+    if( p_out == NULL )
+    {
+        block_ChainLastAppend( &p_output->pp_last, p_ts );
+        return;
+    }
+
+    memcpy( &p_out->p_buffer[p_out->i_buffer], p_ts->p_buffer, 188 );
+    p_out->i_buffer += 188;
+    p_out->i_length += p_ts->i_length;
+    block_Release( p_ts );
+}
+
+static void TSOutputSend( sout_mux_t *p_mux, ts_output_t *p_output )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+
+    if( p_output->p_out != NULL )
+        block_ChainLastAppend( &p_output->pp_last, p_output->p_out );
+    if ( p_output->p_list != NULL )
+    {
+        if( p_sys->p_pacer != NULL )
+            PacerQueue( p_sys->p_pacer, p_output->p_list );
+        else
+            sout_AccessOutWrite( p_mux->p_access, p_output->p_list );
+    }
+    TSOutputInit( p_output );
+}
+
 static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                     vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
 {
@@ -1710,8 +1899,8 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     }
 
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
-    block_t *p_list = NULL;
-    block_t **pp_last = &p_list;
+    ts_output_t output;
+    TSOutputInit( &output );
     for (int i = 0; i < i_packet_count; i++ )
     {
         block_t *p_ts = BufferChainGet( p_chain_ts );
@@ -1723,22 +1912,555 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         if( p_ts->i_flags & BLOCK_FLAG_FOR_PCR )
         {
             /* msg_Dbg( p_mux, "pcr=%lld ms", p_ts->i_dts / 1000 ); */
-            TSSetPCR( p_ts, p_ts->i_dts - p_sys->first_dts );
+            TSSetPCR( p_ts, TO_SCALE_NZ(p_ts->i_dts - p_sys->first_dts) * 300 );
+        }
+
+        TSOutputAppend( p_mux, &output, p_ts );
+    }
+    TSOutputSend( p_mux, &output );
+}
+
+static block_t *TSNewNull( void )
+{
+    block_t *p_ts = block_AllocPooled( 188 );
+    if( unlikely(p_ts == NULL) )
+        return NULL;
+
+    p_ts->p_buffer[0] = 0x47;
+    p_ts->p_buffer[1] = 0x1f; /* PID 0x1fff */
+    p_ts->p_buffer[2] = 0xff;
+    p_ts->p_buffer[3] = 0x10; /* payload only */
+    memset( &p_ts->p_buffer[4], 0xff, 184 );
+    return p_ts;
+}
+
+/* Adaptation field only packet carrying a PCR */
+static block_t *TSNewPCR( const sout_input_sys_t *p_stream )
+{
+    block_t *p_ts = block_AllocPooled( 188 );
+    if( unlikely(p_ts == NULL) )
+        return NULL;
+
+    p_ts->i_flags = BLOCK_FLAG_FOR_PCR;
+    p_ts->p_buffer[0] = 0x47;
+    p_ts->p_buffer[1] = ( p_stream->ts.i_pid >> 8 )&0x1f;
+    p_ts->p_buffer[2] = p_stream->ts.i_pid & 0xff;
+    /* no payload: the continuity counter is not incremented */
+    p_ts->p_buffer[3] = 0x20 | p_stream->i_cbr_cc;
+    p_ts->p_buffer[4] = 183;
+    p_ts->p_buffer[5] = 1 << 4; /* PCR_flag */
+    memset( &p_ts->p_buffer[12], 0xff, 176 );
+    return p_ts;
+}
+
+static size_t TSPayloadSize( const block_t *p_ts )
+{
+    if( !( p_ts->p_buffer[3] & 0x10 ) )
+        return 0;
+    if( p_ts->p_buffer[3] & 0x20 )
+        return 183 - __MIN( p_ts->p_buffer[4], 183 );
+    return 184;
+}
+
+static void ShiftTimestamp( uint8_t *p, int64_t i_offset )
+{
+    int64_t i_ts = ( (int64_t)( p[0]&0x0e ) << 29 ) | ( p[1] << 22 ) |
+                   ( ( p[2]&0xfe ) << 14 ) | ( p[3] << 7 ) | ( p[4] >> 1 );
+
+    i_ts = ( i_ts + i_offset )&INT64_C(0x1ffffffff);
+    p[0] = ( p[0]&0xf1 ) | ( ( i_ts >> 29 )&0x0e );
+    p[1] = ( i_ts >> 22 )&0xff;
+    p[2] = ( ( i_ts >> 14 )&0xfe ) | 0x01;
+    p[3] = ( i_ts >> 7 )&0xff;
+    p[4] = ( ( i_ts << 1 )&0xfe ) | 0x01;
+}
+
+/* Restamps the PES header starting in a TS packet, in 90 kHz units */
+static void TSShiftPES( block_t *p_ts, int64_t i_offset )
+{
+    size_t i_skip = 4;
+    if( p_ts->p_buffer[3] & 0x20 )
+        i_skip += 1 + p_ts->p_buffer[4];
+    if( i_skip + 14 > 188 )
+        return;
+
+    uint8_t *p_pes = &p_ts->p_buffer[i_skip];
+    if( p_pes[0] != 0 || p_pes[1] != 0 || p_pes[2] != 1 ||
+        p_pes[3] == 0xbe || p_pes[3] == 0xbf || /* no optional header */
+        ( p_pes[6]&0xc0 ) != 0x80 )
+        return;
+
+    const unsigned i_pts_dts = p_pes[7] >> 6;
+    if( i_pts_dts & 0x02 )
+        ShiftTimestamp( &p_pes[9], i_offset );
+    if( i_pts_dts == 0x03 && i_skip + 19 <= 188 )
+        ShiftTimestamp( &p_pes[14], i_offset );
+}
+
+/* Buffer sizes from ISO/IEC 13818-1 2.4.2.7. The MPEG-2 MP@HL VBV size is
+ * used for all the video codecs, as the levels are not known here: a
+ * smaller buffer only adds stuffing. */
+#define TSTD_VIDEO_SIZE     1222656
+#define TSTD_AUDIO_SIZE     3584
+#define TSTD_AUDIO_RX       2000000
+#define TSTD_SYSTEM_RX      1000000
+
+static void TStdReset( tstd_t *p_tstd )
+{
+    p_tstd->i_tb = 0;
+    p_tstd->i_tb_date = VLC_TICK_INVALID;
+    p_tstd->i_fill = 0;
+    p_tstd->i_last = VLC_TICK_INVALID;
+    p_tstd->i_au_first = 0;
+    p_tstd->i_au_count = 0;
+}
+
+static void TStdInit( tstd_t *p_tstd, const es_format_t *p_fmt,
+                      uint64_t i_muxrate )
+{
+    switch( p_fmt->i_cat )
+    {
+    case VIDEO_ES:
+        /* Rx is 1.2 Rmax, and the stream cannot exceed the multiplex */
+        p_tstd->i_rx = i_muxrate * 6 / 5;
+        p_tstd->i_size = TSTD_VIDEO_SIZE;
+        break;
+    case AUDIO_ES:
+        p_tstd->i_rx = TSTD_AUDIO_RX;
+        p_tstd->i_size = TSTD_AUDIO_SIZE;
+        break;
+    default:
+        p_tstd->i_rx = TSTD_SYSTEM_RX;
+        p_tstd->i_size = TSTD_AUDIO_SIZE;
+        break;
+    }
+    TStdReset( p_tstd );
+}
+
+static void TStdRemove( tstd_t *p_tstd )
+{
+    p_tstd->i_fill -= p_tstd->au[p_tstd->i_au_first].i_size;
+    p_tstd->i_au_first = ( p_tstd->i_au_first + 1 ) % TSTD_MAX_AU;
+    p_tstd->i_au_count--;
+}
+
+static void TStdUpdate( tstd_t *p_tstd, vlc_tick_t i_date )
+{
+    if( i_date - p_tstd->i_tb_date >= CLOCK_FREQ )
+        p_tstd->i_tb = 0;
+    else if( i_date > p_tstd->i_tb_date )
+        p_tstd->i_tb = __MAX( p_tstd->i_tb - p_tstd->i_rx *
+                              ( i_date - p_tstd->i_tb_date ) / CLOCK_FREQ, 0 );
+    p_tstd->i_tb_date = i_date;
+
+    /* Complete access units leave at their decoding time */
+    while( p_tstd->i_au_count > 1 &&
+           ( p_tstd->au[p_tstd->i_au_first].i_removal == VLC_TICK_INVALID ||
+             p_tstd->au[p_tstd->i_au_first].i_removal <= i_date ) )
+        TStdRemove( p_tstd );
+}
+
+static bool TStdCanSend( tstd_t *p_tstd, vlc_tick_t i_date, size_t i_payload )
+{
+    TStdUpdate( p_tstd, i_date );
+    if( p_tstd->i_tb + 188 * 8 > TSTD_TB_SIZE * 8 )
+        return false;
+    /* Only wait for complete access units to leave, and let through an
+     * access unit larger than the buffer */
+    return p_tstd->i_fill + i_payload <= p_tstd->i_size ||
+           p_tstd->i_au_count <= 1;
+}
+
+static void TStdSend( tstd_t *p_tstd, vlc_tick_t i_date, size_t i_payload,
+                      vlc_tick_t i_removal )
+{
+    TStdUpdate( p_tstd, i_date );
+    if( i_removal != VLC_TICK_INVALID || p_tstd->i_au_count == 0 )
+    {
+        if( p_tstd->i_au_count == TSTD_MAX_AU )
+            TStdRemove( p_tstd );
+        unsigned i_au = ( p_tstd->i_au_first + p_tstd->i_au_count++ ) % TSTD_MAX_AU;
+        p_tstd->au[i_au].i_removal = i_removal;
+        p_tstd->au[i_au].i_size = 0;
+    }
+    unsigned i_au = ( p_tstd->i_au_first + p_tstd->i_au_count - 1 ) % TSTD_MAX_AU;
+    p_tstd->au[i_au].i_size += i_payload;
+    p_tstd->i_fill += i_payload;
+    p_tstd->i_tb += 188 * 8;
+    p_tstd->i_last = i_date;
+}
+
+/* Resynchronize the constant bitrate multiplex when the block dates are
+ * that far from the packet slots */
+#define CBR_MAX_DRIFT VLC_TICK_FROM_SEC(1)
+
+/* Number of packet slots of the constant bitrate multiplex in a duration */
+static uint64_t CbrSlots( const sout_mux_sys_t *p_sys, vlc_tick_t i_duration )
+{
+    if( i_duration <= 0 )
+        return 0;
+    uint64_t i_bits = (uint64_t)( i_duration / CLOCK_FREQ ) * p_sys->i_muxrate
+                    + (uint64_t)( i_duration % CLOCK_FREQ ) * p_sys->i_muxrate
+                      / CLOCK_FREQ;
+    return i_bits / ( 188 * 8 );
+}
+
+/* Position of a packet slot, in 27 MHz units since first_dts */
+static int64_t CbrSlotClock( const sout_mux_sys_t *p_sys, uint64_t i_slot )
+{
+    const uint64_t i_bits = i_slot * 188 * 8;
+    return ( p_sys->i_cbr_start - p_sys->first_dts ) * ( 27000000 / CLOCK_FREQ )
+         + i_bits / p_sys->i_muxrate * 27000000
+         + i_bits % p_sys->i_muxrate * 27000000 / p_sys->i_muxrate;
+}
+
+static vlc_tick_t CbrClockDate( const sout_mux_sys_t *p_sys, int64_t i_clock )
+{
+    return p_sys->first_dts + i_clock / ( 27000000 / CLOCK_FREQ );
+}
+
+static sout_input_sys_t *CbrGetStream( sout_mux_t *p_mux, const block_t *p_ts )
+{
+    const int i_pid = ( ( p_ts->p_buffer[1]&0x1f ) << 8 ) | p_ts->p_buffer[2];
+    for( int i = 0; i < p_mux->i_nb_inputs; i++ )
+    {
+        sout_input_sys_t *p_stream = p_mux->pp_inputs[i]->p_sys;
+        if( p_stream->ts.i_pid == i_pid )
+            return p_stream;
+    }
+    return NULL; /* PSI */
+}
+
+static void CbrDelay( sout_mux_t *p_mux, vlc_tick_t i_late )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    if( i_late <= 0 )
+        return;
+    p_sys->i_cbr_offset += TO_SCALE_NZ(i_late) + 1;
+    msg_Dbg( p_mux, "decoder buffer underflow, restamping by %"PRId64" ms",
+             MS_FROM_VLC_TICK(FROM_SCALE_NZ(p_sys->i_cbr_offset)) );
+}
+
+/* Models and restamps an elementary stream packet sent at a date */
+static void CbrSendES( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
+                       block_t *p_ts, vlc_tick_t i_date )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    tstd_t *p_tstd = &p_stream->tstd;
+    vlc_tick_t i_removal = VLC_TICK_INVALID;
+
+    if( p_ts->p_buffer[1] & 0x40 )
+    {
+        /* The previous access unit is now complete, and should have been
+         * before its decoding: delay the next ones by its lateness */
+        if( p_tstd->i_au_count > 0 )
+        {
+            unsigned i_au = ( p_tstd->i_au_first + p_tstd->i_au_count - 1 ) % TSTD_MAX_AU;
+            if( p_tstd->au[i_au].i_removal != VLC_TICK_INVALID )
+                CbrDelay( p_mux, p_tstd->i_last - p_tstd->au[i_au].i_removal );
+        }
+
+        /* The PES timestamps are set from the block dates, dts_delay ahead */
+        i_removal = p_ts->i_dts + p_sys->i_dts_delay +
+                    FROM_SCALE_NZ(p_sys->i_cbr_offset);
+        if( i_date > i_removal )
+        {
+            CbrDelay( p_mux, i_date - i_removal );
+            i_removal = p_ts->i_dts + p_sys->i_dts_delay +
+                        FROM_SCALE_NZ(p_sys->i_cbr_offset);
+        }
+        if( p_sys->i_cbr_offset > 0 )
+            TSShiftPES( p_ts, p_sys->i_cbr_offset );
+    }
+
+    TStdSend( p_tstd, i_date, TSPayloadSize( p_ts ), i_removal );
+    p_stream->i_cbr_cc = p_ts->p_buffer[3]&0x0f;
+}
+
+static void CbrResync( sout_mux_t *p_mux, vlc_tick_t i_start )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+
+    p_sys->b_cbr_discontinuity = p_sys->b_cbr_started;
+    p_sys->b_cbr_started = true;
+    p_sys->i_cbr_start = i_start;
+    p_sys->i_cbr_packets = 0;
+    p_sys->i_cbr_pcr = CbrSlotClock( p_sys, 0 );
+    p_sys->i_cbr_offset = 0;
+    p_sys->i_cbr_held = 0;
+    for( int i = 0; i < p_mux->i_nb_inputs; i++ )
+    {
+        sout_input_sys_t *p_stream = p_mux->pp_inputs[i]->p_sys;
+        TStdReset( &p_stream->tstd );
+    }
+}
+
+/* Takes the first packet that the T-STD model lets through at a date,
+ * keeping the order of each PID, or the first one if forced */
+#define CBR_MAX_SCAN 64
+
+static block_t *CbrTake( sout_mux_t *p_mux, sout_buffer_chain_t *c,
+                         vlc_tick_t i_date, bool b_force )
+{
+    const sout_input_sys_t *held[8];
+    unsigned i_held = 0;
+    block_t **pp = &c->p_first;
+
+    for( unsigned i = 0; *pp != NULL && i < CBR_MAX_SCAN; i++ )
+    {
+        block_t *p_ts = *pp;
+        sout_input_sys_t *p_stream = CbrGetStream( p_mux, p_ts );
+        bool b_send = b_force || p_stream == NULL;
+
+        if( !b_send )
+        {
+            unsigned j = 0;
+            while( j < i_held && held[j] != p_stream )
+                j++;
+            if( j == i_held ) /* not behind a held packet of the same PID */
+            {
+                b_send = TStdCanSend( &p_stream->tstd, i_date,
+                                      TSPayloadSize( p_ts ) );
+                if( !b_send )
+                {
+                    if( i_held == ARRAY_SIZE(held) )
+                        break;
+                    held[i_held++] = p_stream;
+                }
+            }
+        }
+
+        if( b_send )
+        {
+            *pp = p_ts->p_next;
+            if( *pp == NULL )
+                c->pp_last = pp;
+            c->i_depth--;
+            p_ts->p_next = NULL;
+            if( p_stream != NULL )
+                CbrSendES( p_mux, p_stream, p_ts, i_date );
+            return p_ts;
+        }
+        pp = &p_ts->p_next;
+    }
+    return NULL;
+}
+
+/* Constant bitrate: each packet takes the next slot of the multiplex. The
+ * data packets are spread evenly, and the slots left free are filled with
+ * null packets. When the PCR is due, a PCR only packet takes the slot. The
+ * PCR is computed from the slot position, so it does not depend on the
+ * block dates.
+ *
+ * Packets that would overflow the decoder buffers in the T-STD model are
+ * held, letting the other PID through, and are carried over to the next
+ * call if need be. The PES are restamped when the data cannot be sent
+ * before its decoding time. */
+static void TSScheduleCbr( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
+{
+    sout_mux_sys_t  *p_sys = p_mux->p_sys;
+    sout_input_sys_t *p_pcr_stream = p_sys->p_pcr_input->p_sys;
+
+    if( !p_sys->b_cbr_started )
+        CbrResync( p_mux, i_pcr_dts );
+    else
+    {
+        const vlc_tick_t i_slot_date =
+            CbrClockDate( p_sys, CbrSlotClock( p_sys, p_sys->i_cbr_packets ) );
+        if( i_slot_date < i_pcr_dts - CBR_MAX_DRIFT ||
+            i_slot_date > i_pcr_dts + i_pcr_length + CBR_MAX_DRIFT )
+        {
+            msg_Warn( p_mux, "multiplex discontinuity of %"PRId64" ms, "
+                      "resynchronizing", MS_FROM_VLC_TICK(i_pcr_dts - i_slot_date) );
+            CbrResync( p_mux, i_pcr_dts );
         }
-        if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
+    }
+
+    /* Held packets go first */
+    sout_buffer_chain_t *p_carry = &p_sys->cbr_carry;
+    if( p_carry->i_depth > 0 )
+    {
+        *p_carry->pp_last = p_chain_ts->p_first;
+        if( p_chain_ts->i_depth > 0 )
+            p_carry->pp_last = p_chain_ts->pp_last;
+        p_carry->i_depth += p_chain_ts->i_depth;
+        *p_chain_ts = *p_carry;
+        if( p_chain_ts->pp_last == &p_carry->p_first )
+            p_chain_ts->pp_last = &p_chain_ts->p_first;
+        BufferChainInit( p_carry );
+    }
+
+    const uint64_t i_end = CbrSlots( p_sys, i_pcr_dts + i_pcr_length
+                                            - p_sys->i_cbr_start );
+    const uint64_t i_data = p_chain_ts->i_depth;
+    uint64_t i_count = i_data;
+    if( i_end > p_sys->i_cbr_packets + i_data )
+        i_count = i_end - p_sys->i_cbr_packets;
+    else if( i_end < p_sys->i_cbr_packets + i_data )
+        msg_Warn( p_mux, "multiplex bitrate too low, %"PRIu64" packets late",
+                  p_sys->i_cbr_packets + i_data - i_end );
+    /* The resynchronization bounds the drift, bound the stuffing anyway */
+    i_count = __MIN( i_count, i_data + CbrSlots( p_sys, i_pcr_length + CBR_MAX_DRIFT ) );
+
+    const vlc_tick_t i_slot_length =
+        vlc_tick_from_samples( 188 * 8, p_sys->i_muxrate );
+    const int64_t i_pcr_interval = TO_SCALE_NZ(p_sys->i_pcr_delay) * 300;
+    /* Do not hold the data longer than it can stay in the buffers */
+    const uint64_t i_max_held = __MAX( CbrSlots( p_sys, p_sys->i_dts_delay ), 1 );
+    ts_output_t output;
+    TSOutputInit( &output );
+    uint64_t i_taken = 0;
+    for( uint64_t i = 0; i < i_count; i++ )
+    {
+        const int64_t i_clock = CbrSlotClock( p_sys, p_sys->i_cbr_packets++ );
+        const vlc_tick_t i_date = CbrClockDate( p_sys, i_clock );
+        block_t *p_ts = NULL;
+
+        if( i_clock - p_sys->i_cbr_pcr >= i_pcr_interval )
+            p_ts = TSNewPCR( p_pcr_stream );
+        else if( i_taken < i_data && i_taken < ( i + 1 ) * i_data / i_count )
+        {
+            p_ts = CbrTake( p_mux, p_chain_ts, i_date,
+                            p_sys->i_cbr_held >= i_max_held );
+            if( p_ts != NULL )
+            {
+                i_taken++;
+                p_sys->i_cbr_held = 0;
+            }
+            else
+                p_sys->i_cbr_held++;
+        }
+
+        if( p_ts == NULL )
+        {
+            p_ts = TSNewNull();
+            if( unlikely(p_ts == NULL) )
+                continue;
+        }
+
+        p_ts->i_dts = i_date;
+        p_ts->i_length = i_slot_length;
+        if( p_ts->i_flags & BLOCK_FLAG_FOR_PCR )
+        {
+            if( p_sys->b_cbr_discontinuity )
+            {
+                p_ts->p_buffer[5] |= 0x80; /* discontinuity_indicator */
+                p_sys->b_cbr_discontinuity = false;
+            }
+            TSSetPCR( p_ts, i_clock );
+            p_sys->i_cbr_pcr = i_clock;
+        }
+
+        TSOutputAppend( p_mux, &output, p_ts );
+    }
+    TSOutputSend( p_mux, &output );
+
+    *p_carry = *p_chain_ts;
+    if( p_carry->pp_last == &p_chain_ts->p_first )
+        p_carry->pp_last = &p_carry->p_first;
+}
+
+static void *PacerThread( void *data )
+{
+    ts_pacer_t *p_pacer = data;
+    vlc_tick_t i_origin = VLC_TICK_INVALID; /* clock date of i_origin_dts */
+    vlc_tick_t i_origin_dts = VLC_TICK_INVALID;
+
+    vlc_thread_set_name( "vlc-ts-pacer" );
+
+    vlc_mutex_lock( &p_pacer->lock );
+    for( ;; )
+    {
+        while( p_pacer->p_first == NULL && !p_pacer->b_quit )
+            vlc_cond_wait( &p_pacer->wait, &p_pacer->lock );
+        if( p_pacer->p_first == NULL )
+            break;
+
+        block_t *p_block = p_pacer->p_first;
+        if( !p_pacer->b_quit )
         {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
+            vlc_tick_t i_now = vlc_tick_now();
+            vlc_tick_t i_deadline = i_origin + p_block->i_dts - i_origin_dts;
+            if( i_origin == VLC_TICK_INVALID ||
+                i_deadline > i_now + CBR_MAX_DRIFT ||
+                i_deadline < i_now - CBR_MAX_DRIFT )
+            {
+                i_origin = i_deadline = i_now;
+                i_origin_dts = p_block->i_dts;
+            }
+            if( vlc_cond_timedwait( &p_pacer->wait, &p_pacer->lock,
+                                    i_deadline ) == 0 )
+                continue; /* woken up early, check again */
         }
 
-        /* latency */
-        p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
+        p_pacer->p_first = p_block->p_next;
+        if( p_pacer->p_first == NULL )
+            p_pacer->pp_last = &p_pacer->p_first;
+        p_block->p_next = NULL;
+        vlc_cond_signal( &p_pacer->space );
+        vlc_mutex_unlock( &p_pacer->lock );
 
-        block_ChainLastAppend( &pp_last, p_ts );
+        sout_AccessOutWrite( p_pacer->p_mux->p_access, p_block );
+
+        vlc_mutex_lock( &p_pacer->lock );
     }
-    if ( p_list != NULL )
-        sout_AccessOutWrite( p_mux->p_access, p_list );
+    vlc_mutex_unlock( &p_pacer->lock );
+
+    return NULL;
+}
+
+static ts_pacer_t *PacerNew( sout_mux_t *p_mux )
+{
+    ts_pacer_t *p_pacer = malloc( sizeof(*p_pacer) );
+    if( unlikely(p_pacer == NULL) )
+        return NULL;
+
+    p_pacer->p_mux = p_mux;
+    vlc_mutex_init( &p_pacer->lock );
+    vlc_cond_init( &p_pacer->wait );
+    vlc_cond_init( &p_pacer->space );
+    p_pacer->p_first = NULL;
+    p_pacer->pp_last = &p_pacer->p_first;
+    p_pacer->i_last_dts = VLC_TICK_INVALID;
+    p_pacer->b_quit = false;
+
+    if( vlc_clone( &p_pacer->thread, PacerThread, p_pacer ) )
+    {
+        free( p_pacer );
+        return NULL;
+    }
+    return p_pacer;
+}
+
+/* Sends the queued blocks without waiting */
+static void PacerDelete( ts_pacer_t *p_pacer )
+{
+    vlc_mutex_lock( &p_pacer->lock );
+    p_pacer->b_quit = true;
+    vlc_cond_signal( &p_pacer->wait );
+    vlc_mutex_unlock( &p_pacer->lock );
+
+    vlc_join( p_pacer->thread, NULL );
+    free( p_pacer );
+}
+
+static void PacerQueue( ts_pacer_t *p_pacer, block_t *p_list )
+{
+    block_t *p_last = p_list;
+    while( p_last->p_next != NULL )
+        p_last = p_last->p_next;
+
+    vlc_mutex_lock( &p_pacer->lock );
+    p_pacer->i_last_dts = p_last->i_dts;
+    block_ChainLastAppend( &p_pacer->pp_last, p_list );
+    vlc_cond_signal( &p_pacer->wait );
+
+    /* Block faster than real time inputs */
+    while( p_pacer->p_first != NULL &&
+           p_pacer->i_last_dts - p_pacer->p_first->i_dts > CBR_MAX_DRIFT )
+        vlc_cond_wait( &p_pacer->space, &p_pacer->lock );
+    vlc_mutex_unlock( &p_pacer->lock );
 }
 
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
@@ -1764,7 +2486,7 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
         b_adaptation_field = true;
     }
 
-    block_t *p_ts = block_Alloc( 188 );
+    block_t *p_ts = block_AllocPooled( 188 );
 
     if (b_new_pes && !(p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME) && p_pes->i_flags & BLOCK_FLAG_TYPE_I)
     {
@@ -1844,17 +2566,24 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
     return p_ts;
 }
 
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts )
+/* i_pcr is in 27 MHz units */
+static void TSSetPCR( block_t *p_ts, int64_t i_pcr )
 {
-    int64_t i_pcr = TO_SCALE_NZ(i_dts);
-
-    p_ts->p_buffer[6]  = ( i_pcr >> 25 )&0xff;
-    p_ts->p_buffer[7]  = ( i_pcr >> 17 )&0xff;
-    p_ts->p_buffer[8]  = ( i_pcr >> 9  )&0xff;
-    p_ts->p_buffer[9]  = ( i_pcr >> 1  )&0xff;
-    p_ts->p_buffer[10] = ( i_pcr << 7  )&0x80;
-    p_ts->p_buffer[10] |= 0x7e;
-    p_ts->p_buffer[11] = 0; /* we don't set PCR extension */
+    /* 33 bits base */
+    i_pcr %= INT64_C(300) << 33;
+    if( i_pcr < 0 )
+        i_pcr += INT64_C(300) << 33;
+
+    int64_t i_base = i_pcr / 300;
+    int i_ext = i_pcr % 300;
+
+    p_ts->p_buffer[6]  = ( i_base >> 25 )&0xff;
+    p_ts->p_buffer[7]  = ( i_base >> 17 )&0xff;
+    p_ts->p_buffer[8]  = ( i_base >> 9  )&0xff;
+    p_ts->p_buffer[9]  = ( i_base >> 1  )&0xff;
+    p_ts->p_buffer[10] = ( i_base << 7  )&0x80;
+    p_ts->p_buffer[10] |= 0x7e | ( ( i_ext >> 8 )&0x01 );
+    p_ts->p_buffer[11] = i_ext&0xff;
 }
 
 void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
@@ -50,7 +50,7 @@ void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback, block_t *p_pes,
 
         int i_copy = __MIN( i_size, 184 );
         bool b_adaptation_field = i_size < 184;
-        block_t *p_ts = block_Alloc( 188 );
+        block_t *p_ts = block_AllocPooled( 188 );
 
         p_ts->p_buffer[0] = 0x47;
         p_ts->p_buffer[1] = ( b_new_pes ? 0x40 : 0x00 )|
@@ -182,6 +182,7 @@ static block_t *PacketizeBlock( decoder_t *p_dec, block_t **pp_block )
                     break;
                 }
                 block_SkipByte( &p_sys->bytestream );
+                block_SkipToByte( &p_sys->bytestream, 0x0b );
             }
             if( p_sys->i_state != STATE_SYNC )
             {
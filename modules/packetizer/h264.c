@@ -156,6 +156,7 @@ static void PutSPS( decoder_t *p_dec, block_t *p_frag );
 static void PutPPS( decoder_t *p_dec, block_t *p_frag );
 static void PutSPSEXT( decoder_t *p_dec, block_t *p_frag );
 static bool ParseSliceHeader( decoder_t *p_dec, const block_t *p_frag, h264_slice_t *p_slice );
+static unsigned GetSeiTypes( decoder_t * );
 static bool ParseSeiCallback( const hxxx_sei_data_t *, void * );
 
 
@@ -198,6 +199,19 @@ static void StoreSPSEXT( decoder_sys_t *p_sys, uint8_t i_id, block_t *p_block )
     p_sys->spsext[i_id].p_block = p_block;
 }
 
+/* Replaces the stored NAL of a repeated parameter set, so that identical
+ * repeats, as sent at every IDR by broadcasters, are not decoded again */
+static bool ReplaceRepeatedSet( block_t **pp_stored, block_t *p_frag )
+{
+    if( *pp_stored == NULL ||
+        !hxxx_AnnexB_nal_equals( (*pp_stored)->p_buffer, (*pp_stored)->i_buffer,
+                                 p_frag->p_buffer, p_frag->i_buffer ) )
+        return false;
+    block_Release( *pp_stored );
+    *pp_stored = p_frag;
+    return true;
+}
+
 static void ActivateSets( decoder_t *p_dec, const h264_sequence_parameter_set_t *p_sps,
                                             const h264_picture_parameter_set_t *p_pps )
 {
@@ -668,12 +682,15 @@ static block_t *ParseNALBlock( decoder_t *p_dec, bool *pb_ts_used, block_t *p_fr
                 if( b_new_picture )
                 {
                     /* Parse SEI for that frame now we should have matched SPS/PPS */
-                    for( block_t *p_sei = p_sys->leading.p_head; p_sei; p_sei = p_sei->p_next )
+                    const unsigned i_sei_types = GetSeiTypes( p_dec );
+                    for( block_t *p_sei = p_sys->leading.p_head;
+                         p_sei && i_sei_types; p_sei = p_sei->p_next )
                     {
                         if( (p_sei->i_flags & BLOCK_FLAG_PRIVATE_SEI) == 0 )
                             continue;
                         HxxxParse_AnnexB_SEI( p_sei->p_buffer, p_sei->i_buffer,
-                                              1 /* nal header */, ParseSeiCallback, p_dec );
+                                              1 /* nal header */, i_sei_types,
+                                              ParseSeiCallback, p_dec );
                     }
 
                     if( p_sys->b_slice )
@@ -921,7 +938,7 @@ static block_t *OutputPicture( decoder_t *p_dec )
     p_sys->leading.p_head = NULL;
     p_sys->leading.pp_append = &p_sys->leading.p_head;
 
-    p_pic = block_ChainGather( p_pic );
+    p_pic = hxxx_ChainGather( p_pic );
 
     if( !p_pic )
     {
@@ -1102,6 +1119,11 @@ static void PutSPS( decoder_t *p_dec, block_t *p_frag )
         return;
     }
 
+    uint8_t i_id;
+    if( h264_get_xps_id( p_buffer, i_buffer, &i_id ) &&
+        ReplaceRepeatedSet( &p_sys->sps[i_id].p_block, p_frag ) )
+        return;
+
     h264_sequence_parameter_set_t *p_sps = h264_decode_sps( p_buffer, i_buffer, true );
     if( !p_sps )
     {
@@ -1129,6 +1151,11 @@ static void PutPPS( decoder_t *p_dec, block_t *p_frag )
         return;
     }
 
+    uint8_t i_id;
+    if( h264_get_xps_id( p_buffer, i_buffer, &i_id ) &&
+        ReplaceRepeatedSet( &p_sys->pps[i_id].p_block, p_frag ) )
+        return;
+
     h264_picture_parameter_set_t *p_pps = h264_decode_pps( p_buffer, i_buffer, true );
     if( !p_pps )
     {
@@ -1156,6 +1183,11 @@ static void PutSPSEXT( decoder_t *p_dec, block_t *p_frag )
         return;
     }
 
+    uint8_t i_id;
+    if( h264_get_xps_id( p_buffer, i_buffer, &i_id ) &&
+        ReplaceRepeatedSet( &p_sys->spsext[i_id].p_block, p_frag ) )
+        return;
+
     h264_sequence_parameter_set_extension_t *p_spsext =
             h264_decode_sps_extension( p_buffer, i_buffer, true );
     if( !p_spsext )
@@ -1212,6 +1244,27 @@ static bool ParseSliceHeader( decoder_t *p_dec, const block_t *p_frag, h264_slic
     return true;
 }
 
+/* SEI payload types with a consumer, the others are not parsed */
+static unsigned GetSeiTypes( decoder_t *p_dec )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+    const h264_sequence_parameter_set_t *p_sps = p_sys->p_active_sps;
+    unsigned i_types = 0;
+
+    if( p_sps && p_sps->vui.b_valid &&
+        ( p_sps->vui.b_hrd_parameters_present_flag ||
+          p_sps->vui.b_pic_struct_present_flag ) )
+        i_types |= HXXX_SEI_MASK_PIC_TIMING;
+    if( cc_storage_is_wanted( p_sys->p_ccs ) )
+        i_types |= HXXX_SEI_MASK_USER_DATA_REGISTERED_ITU_T_T35;
+    if( !p_sys->b_recovered )
+        i_types |= HXXX_SEI_MASK_RECOVERY_POINT;
+    if( p_dec->fmt_in->video.multiview_mode == MULTIVIEW_2D )
+        i_types |= HXXX_SEI_MASK_FRAME_PACKING_ARRANGEMENT;
+
+    return i_types;
+}
+
 static bool ParseSeiCallback( const hxxx_sei_data_t *p_sei_data, void *cbdata )
 {
     decoder_t *p_dec = (decoder_t *) cbdata;
@@ -662,6 +662,41 @@ IMPL_h264_generic_decode( h264_decode_pps, h264_picture_parameter_set_t,
 IMPL_h264_generic_decode( h264_decode_sps_extension, h264_sequence_parameter_set_extension_t,
                           h264_parse_sequence_parameter_set_extension_rbsp, h264_release_sps_extension )
 
+bool h264_get_xps_id( const uint8_t *p_buf, size_t i_buf, uint8_t *pi_id )
+{
+    if( i_buf < 2 )
+        return false;
+
+    const enum h264_nal_unit_type_e i_nal_type = h264_getNALType( p_buf );
+    bs_t bs;
+    struct hxxx_bsfw_ep3b_ctx_s bsctx;
+    hxxx_bsfw_ep3b_ctx_init( &bsctx );
+    bs_init_custom( &bs, &p_buf[1], i_buf - 1, &hxxx_bsfw_ep3b_callbacks, &bsctx );
+
+    uint32_t i_id, i_max;
+    switch( i_nal_type )
+    {
+        case H264_NAL_SPS:
+            bs_skip( &bs, 24 ); /* profile, constraints, level */
+            i_max = H264_SPS_ID_MAX;
+            break;
+        case H264_NAL_PPS:
+            i_max = H264_PPS_ID_MAX;
+            break;
+        case H264_NAL_SPS_EXT:
+            i_max = H264_SPSEXT_ID_MAX;
+            break;
+        default:
+            return false;
+    }
+
+    i_id = bs_read_ue( &bs );
+    if( bs_error( &bs ) || i_id > i_max )
+        return false;
+    *pi_id = i_id;
+    return true;
+}
+
 block_t *h264_NAL_to_avcC( uint8_t i_nal_length_size,
                            const uint8_t **pp_sps_buf,
                            const size_t *p_sps_size, uint8_t i_sps_count,
@@ -401,17 +401,10 @@ static bool InsertXPS(decoder_t *p_dec, uint8_t i_nal_type, uint8_t i_id,
     }
 
     /* Check if we really need to re-decode/replace */
-    if(p_tuple->p_nal)
-    {
-        const uint8_t *p_stored = p_tuple->p_nal->p_buffer;
-        size_t i_stored = p_tuple->p_nal->i_buffer;
-        hxxx_strip_AnnexB_startcode(&p_stored, &i_stored);
-        const uint8_t *p_new = p_nalb->p_buffer;
-        size_t i_new = p_nalb->i_buffer;
-        hxxx_strip_AnnexB_startcode(&p_new, &i_new);
-        if(i_stored == i_new && !memcmp(p_stored, p_new, i_new))
-            return true;
-    }
+    if(p_tuple->p_nal &&
+       hxxx_AnnexB_nal_equals(p_tuple->p_nal->p_buffer, p_tuple->p_nal->i_buffer,
+                              p_nalb->p_buffer, p_nalb->i_buffer))
+        return true;
 
     /* Free associated decoded version */
     if(p_tuple->p_decoded)
@@ -668,9 +661,29 @@ static void GetXPSSet(uint8_t i_pps_id, void *priv,
             *pp_vps = p_sys->rg_vps[hevc_get_sps_vps_id(*pp_sps)].p_decoded;
 }
 
+/* SEI payload types with a consumer, the others are not parsed */
+static unsigned GetSEITypes( decoder_t *p_dec )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+    unsigned i_types = HXXX_SEI_MASK_MASTERING_DISPLAY_COLOUR_VOLUME |
+                       HXXX_SEI_MASK_CONTENT_LIGHT_LEVEL;
+
+    if( p_sys->p_active_sps )
+        i_types |= HXXX_SEI_MASK_PIC_TIMING;
+    if( cc_storage_is_wanted( p_sys->p_ccs ) )
+        i_types |= HXXX_SEI_MASK_USER_DATA_REGISTERED_ITU_T_T35;
+    if( !p_sys->b_recovery_point )
+        i_types |= HXXX_SEI_MASK_RECOVERY_POINT;
+    if( p_dec->fmt_in->video.multiview_mode == MULTIVIEW_2D )
+        i_types |= HXXX_SEI_MASK_FRAME_PACKING_ARRANGEMENT;
+
+    return i_types;
+}
+
 static void ParseStoredSEI( decoder_t *p_dec )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
+    const unsigned i_sei_types = GetSEITypes( p_dec );
 
     for( block_t *p_nal = p_sys->pre.p_chain;
                   p_nal; p_nal = p_nal->p_next )
@@ -681,7 +694,8 @@ static void ParseStoredSEI( decoder_t *p_dec )
         if( hevc_getNALType(&p_nal->p_buffer[4]) == HEVC_NAL_PREF_SEI )
         {
             HxxxParse_AnnexB_SEI( p_nal->p_buffer, p_nal->i_buffer,
-                                  2 /* nal header */, ParseSEICallback, p_dec );
+                                  2 /* nal header */, i_sei_types,
+                                  ParseSEICallback, p_dec );
         }
     }
 }
@@ -846,7 +860,8 @@ static block_t * ParseAUTail(decoder_t *p_dec, uint8_t i_nal_type, block_t *p_na
 
         case HEVC_NAL_SUFF_SEI:
             HxxxParse_AnnexB_SEI( p_nalb->p_buffer, p_nalb->i_buffer,
-                                  2 /* nal header */, ParseSEICallback, p_dec );
+                                  2 /* nal header */, GetSEITypes( p_dec ),
+                                  ParseSEICallback, p_dec );
             break;
     }
 
@@ -884,7 +899,7 @@ static block_t *GatherAndValidateChain(block_t *p_outputchain)
         if(p_outputchain->i_flags & BLOCK_FLAG_DROP)
             p_output = p_outputchain; /* Avoid useless gather */
         else
-            p_output = block_ChainGather(p_outputchain);
+            p_output = hxxx_ChainGather(p_outputchain);
     }
 
     if(p_output && (p_output->i_flags & BLOCK_FLAG_DROP))
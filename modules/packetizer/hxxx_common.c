@@ -22,6 +22,7 @@
 #endif
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_block.h>
 #include <vlc_codec.h>
 
@@ -31,8 +32,12 @@
 /****************************************************************************
  * Closed captions handling
  ****************************************************************************/
+/* Committed pictures without fetch until the CC are considered unwanted */
+#define CC_STORAGE_UNREAD_MAX 8
+
 struct cc_storage_t
 {
+    unsigned i_unread;
     uint32_t i_flags;
     vlc_tick_t i_dts;
     vlc_tick_t i_pts;
@@ -47,6 +52,7 @@ cc_storage_t * cc_storage_new( void )
     {
         p_ccs->i_pts = VLC_TICK_INVALID;
         p_ccs->i_dts = VLC_TICK_INVALID;
+        p_ccs->i_unread = 0;
         p_ccs->i_flags = 0;
         cc_Init( &p_ccs->current );
         cc_Init( &p_ccs->next );
@@ -77,14 +83,25 @@ void cc_storage_commit( cc_storage_t *p_ccs, block_t *p_pic )
     p_ccs->i_pts = p_pic->i_pts;
     p_ccs->i_dts = p_pic->i_dts;
     p_ccs->i_flags = p_pic->i_flags;
-    p_ccs->current = p_ccs->next;
+    /* Only copy the used part of the payload, not the whole storage */
+    memcpy( &p_ccs->current, &p_ccs->next, offsetof(cc_data_t, p_data) );
+    memcpy( p_ccs->current.p_data, p_ccs->next.p_data, p_ccs->next.i_data );
     cc_Flush( &p_ccs->next );
+    if( p_ccs->i_unread < CC_STORAGE_UNREAD_MAX )
+        p_ccs->i_unread++;
+}
+
+bool cc_storage_is_wanted( const cc_storage_t *p_ccs )
+{
+    return p_ccs->i_unread < CC_STORAGE_UNREAD_MAX;
 }
 
 block_t * cc_storage_get_current( cc_storage_t *p_ccs, decoder_cc_desc_t *p_desc )
 {
     block_t *p_block;
 
+    p_ccs->i_unread = 0;
+
     if( !p_ccs->current.b_reorder && p_ccs->current.i_data <= 0 )
         return NULL;
 
@@ -105,6 +122,92 @@ block_t * cc_storage_get_current( cc_storage_t *p_ccs, decoder_cc_desc_t *p_desc
     return p_block;
 }
 
+/****************************************************************************
+ * NAL views: blocks referencing a part of a larger block, without copy
+ ****************************************************************************/
+typedef struct
+{
+    vlc_atomic_rc_t rc;
+    block_t *p_block;
+} hxxx_view_owner_t;
+
+typedef struct
+{
+    block_t self;
+    hxxx_view_owner_t *p_owner;
+} hxxx_view_t;
+
+static void hxxx_view_owner_Release( hxxx_view_owner_t *p_owner )
+{
+    if( vlc_atomic_rc_dec( &p_owner->rc ) )
+    {
+        block_Release( p_owner->p_block );
+        free( p_owner );
+    }
+}
+
+static void hxxx_view_Release( block_t *p_view )
+{
+    hxxx_view_owner_Release( container_of( p_view, hxxx_view_t, self )->p_owner );
+    free( p_view );
+}
+
+static const struct vlc_block_callbacks hxxx_view_cbs =
+{
+    hxxx_view_Release,
+};
+
+static block_t *hxxx_view_New( hxxx_view_owner_t *p_owner,
+                               uint8_t *p_buf, size_t i_buf )
+{
+    hxxx_view_t *p_view = malloc( sizeof(*p_view) );
+    if( unlikely(p_view == NULL) )
+        return NULL;
+
+    /* Bounds are the view itself, so that any block_Realloc() copies
+     * instead of overwriting the neighbouring NALs */
+    block_Init( &p_view->self, &hxxx_view_cbs, p_buf, i_buf );
+    p_view->p_owner = p_owner;
+    vlc_atomic_rc_inc( &p_owner->rc );
+    return &p_view->self;
+}
+
+block_t *hxxx_ChainGather( block_t *p_list )
+{
+    if( p_list->p_next == NULL )
+        return p_list;
+
+    /* Views of adjacent NALs of the same sample are already contiguous */
+    hxxx_view_owner_t *p_owner = NULL;
+    vlc_tick_t i_length = 0;
+    const block_t *p_last = NULL;
+    for( block_t *b = p_list; b; b = b->p_next )
+    {
+        if( b->cbs != &hxxx_view_cbs )
+            return block_ChainGather( p_list );
+        hxxx_view_owner_t *p = container_of( b, hxxx_view_t, self )->p_owner;
+        if( p_last && ( p != p_owner ||
+                        p_last->p_buffer + p_last->i_buffer != b->p_buffer ) )
+            return block_ChainGather( p_list );
+        p_owner = p;
+        i_length += b->i_length;
+        p_last = b;
+    }
+
+    block_t *g = hxxx_view_New( p_owner, p_list->p_buffer,
+                                p_last->p_buffer + p_last->i_buffer - p_list->p_buffer );
+    if( !g )
+        return block_ChainGather( p_list );
+
+    g->i_flags = p_list->i_flags;
+    g->i_pts   = p_list->i_pts;
+    g->i_dts   = p_list->i_dts;
+    g->i_length = i_length;
+
+    block_ChainRelease( p_list );
+    return g;
+}
+
 /****************************************************************************
  * PacketizeXXC1: Takes VCL blocks of data and creates annexe B type NAL stream
  * Will always use 4 byte 0 0 0 1 startcodes
@@ -115,6 +218,7 @@ block_t *PacketizeXXC1( decoder_t *p_dec, uint8_t i_nal_length_size,
 {
     block_t       *p_block;
     block_t       *p_ret = NULL;
+    hxxx_view_owner_t *p_owner = NULL;
     uint8_t       *p;
 
     if( !pp_block || !*pp_block )
@@ -128,6 +232,18 @@ block_t *PacketizeXXC1( decoder_t *p_dec, uint8_t i_nal_length_size,
     p_block = *pp_block;
     *pp_block = NULL;
 
+    /* With 4 bytes lengths, each length is overwritten with a startcode
+     * and the NALs reference the sample data in place */
+    if( i_nal_length_size == 4 )
+    {
+        p_owner = malloc( sizeof(*p_owner) );
+        if( p_owner )
+        {
+            vlc_atomic_rc_init( &p_owner->rc );
+            p_owner->p_block = p_block;
+        }
+    }
+
     for( p = p_block->p_buffer; p < &p_block->p_buffer[p_block->i_buffer]; )
     {
         bool b_dummy;
@@ -151,8 +267,18 @@ block_t *PacketizeXXC1( decoder_t *p_dec, uint8_t i_nal_length_size,
 
         /* Convert AVC to AnnexB */
         block_t *p_nal;
+        if( p_owner )
+        {
+            p_nal = hxxx_view_New( p_owner, p - 4, 4 + i_size );
+            if( p_nal )
+            {
+                p_nal->i_dts = p_block->i_dts;
+                p_nal->i_pts = p_block->i_pts;
+            }
+            p += i_size;
+        }
         /* If data exactly match remaining bytes (1 NAL only or trailing one) */
-        if( i_size == p_block->p_buffer + p_block->i_buffer - p )
+        else if( i_size == p_block->p_buffer + p_block->i_buffer - p )
         {
             p_block->i_buffer = i_size;
             p_block->p_buffer = p;
@@ -193,7 +319,9 @@ block_t *PacketizeXXC1( decoder_t *p_dec, uint8_t i_nal_length_size,
             break;
     }
 
-    if( p_block )
+    if( p_owner ) /* The sample is released along with its last view */
+        hxxx_view_owner_Release( p_owner );
+    else if( p_block )
         block_Release( p_block );
 
     return p_ret;
@@ -35,10 +35,19 @@ void cc_storage_commit( cc_storage_t *p_ccs, block_t *p_pic );
 
 block_t * cc_storage_get_current( cc_storage_t *p_ccs, decoder_cc_desc_t * );
 
+/* Returns whether the stored CC are fetched, i.e. if cc_storage_get_current()
+ * is called for the committed pictures: the CC are not worth extracting
+ * otherwise (no CC decoder, stream output, demuxer...) */
+bool cc_storage_is_wanted( const cc_storage_t *p_ccs );
+
 /* */
 
 typedef block_t * (*pf_annexb_nal_packetizer)(decoder_t *, bool *, block_t *);
 block_t *PacketizeXXC1( decoder_t *, uint8_t, block_t **, pf_annexb_nal_packetizer );
 
+/* Gathers an access unit, without copy if its NALs are contiguous parts of
+ * the same sample, as output by PacketizeXXC1() */
+block_t *hxxx_ChainGather( block_t * );
+
 #endif // HXXX_COMMON_H
 
@@ -135,6 +135,17 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     }
     else
     {
+        /* Same size, rewritten in place */
+        const uint8_t *p_shared = p_block->p_buffer;
+        p_block = block_Writable( p_block );
+        if( unlikely(!p_block) )
+        {
+            free( p_list );
+            return NULL;
+        }
+        for( unsigned i = 0; i < i_nalcount; i++ )
+            p_list[i].p = p_block->p_buffer + (p_list[i].p - p_shared);
+
         p_source = p_dest = p_block->p_buffer;
         p_sourceend = &p_block->p_buffer[p_block->i_buffer];
     }
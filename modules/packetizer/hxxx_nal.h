@@ -53,6 +53,16 @@ static inline bool hxxx_strip_AnnexB_startcode( const uint8_t **pp_data, size_t
     return false;
 }
 
+/* compares two AnnexB NAL units, regardless of their startcode */
+static inline bool hxxx_AnnexB_nal_equals( const uint8_t *p_a, size_t i_a,
+                                           const uint8_t *p_b, size_t i_b )
+{
+    if( !hxxx_strip_AnnexB_startcode( &p_a, &i_a ) ||
+        !hxxx_strip_AnnexB_startcode( &p_b, &i_b ) )
+        return false;
+    return i_a == i_b && !memcmp( p_a, p_b, i_a );
+}
+
 /* Declarations */
 
 typedef struct
@@ -30,19 +30,21 @@
 #include "hxxx_ep3b.h"
 
 void HxxxParse_AnnexB_SEI(const uint8_t *p_buf, size_t i_buf,
-                          uint8_t i_header, pf_hxxx_sei_callback cb, void *cbdata)
+                          uint8_t i_header, unsigned i_types,
+                          pf_hxxx_sei_callback cb, void *cbdata)
 {
     if( hxxx_strip_AnnexB_startcode( &p_buf, &i_buf ) )
-        HxxxParseSEI(p_buf, i_buf, i_header, cb, cbdata);
+        HxxxParseSEI(p_buf, i_buf, i_header, i_types, cb, cbdata);
 }
 
 void HxxxParseSEI(const uint8_t *p_buf, size_t i_buf,
-                  uint8_t i_header, pf_hxxx_sei_callback pf_callback, void *cbdata)
+                  uint8_t i_header, unsigned i_types,
+                  pf_hxxx_sei_callback pf_callback, void *cbdata)
 {
     bs_t s;
     bool b_continue = true;
 
-    if( i_buf <= i_header )
+    if( i_buf <= i_header || i_types == 0 )
         return;
 
     struct hxxx_bsfw_ep3b_ctx_s bsctx;
@@ -88,7 +90,8 @@ void HxxxParseSEI(const uint8_t *p_buf, size_t i_buf,
 
         /* Save start offset */
         const unsigned i_start_bit_pos = bs_pos( &s );
-        switch( i_type )
+        /* the types without subscribers are skipped as unhandled ones */
+        switch( (i_types & hxxx_sei_type_mask( i_type )) ? i_type : 0 )
         {
             /* Look for pic timing, do not decode locally */
             case HXXX_SEI_PIC_TIMING:
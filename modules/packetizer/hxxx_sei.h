@@ -31,6 +31,39 @@ enum hxxx_sei_type_e
     HXXX_SEI_CONTENT_LIGHT_LEVEL = 144,
 };
 
+/* Subscription to the SEI payload types: HxxxParseSEI() parses and calls
+ * back for the subscribed types only, and skips the others */
+enum hxxx_sei_mask_e
+{
+    HXXX_SEI_MASK_PIC_TIMING                       = 1 << 0,
+    HXXX_SEI_MASK_USER_DATA_REGISTERED_ITU_T_T35   = 1 << 1,
+    HXXX_SEI_MASK_RECOVERY_POINT                   = 1 << 2,
+    HXXX_SEI_MASK_FRAME_PACKING_ARRANGEMENT        = 1 << 3,
+    HXXX_SEI_MASK_MASTERING_DISPLAY_COLOUR_VOLUME  = 1 << 4,
+    HXXX_SEI_MASK_CONTENT_LIGHT_LEVEL              = 1 << 5,
+};
+
+static inline unsigned hxxx_sei_type_mask( unsigned i_type )
+{
+    switch( i_type )
+    {
+        case HXXX_SEI_PIC_TIMING:
+            return HXXX_SEI_MASK_PIC_TIMING;
+        case HXXX_SEI_USER_DATA_REGISTERED_ITU_T_T35:
+            return HXXX_SEI_MASK_USER_DATA_REGISTERED_ITU_T_T35;
+        case HXXX_SEI_RECOVERY_POINT:
+            return HXXX_SEI_MASK_RECOVERY_POINT;
+        case HXXX_SEI_FRAME_PACKING_ARRANGEMENT:
+            return HXXX_SEI_MASK_FRAME_PACKING_ARRANGEMENT;
+        case HXXX_SEI_MASTERING_DISPLAY_COLOUR_VOLUME:
+            return HXXX_SEI_MASK_MASTERING_DISPLAY_COLOUR_VOLUME;
+        case HXXX_SEI_CONTENT_LIGHT_LEVEL:
+            return HXXX_SEI_MASK_CONTENT_LIGHT_LEVEL;
+        default:
+            return 0;
+    }
+}
+
 enum hxxx_sei_t35_type_e
 {
     HXXX_ITU_T35_TYPE_CC,
@@ -89,7 +122,9 @@ typedef struct
 } hxxx_sei_data_t;
 
 typedef bool (*pf_hxxx_sei_callback)(const hxxx_sei_data_t *, void *);
-void HxxxParseSEI(const uint8_t *, size_t, uint8_t, pf_hxxx_sei_callback, void *);
-void HxxxParse_AnnexB_SEI(const uint8_t *, size_t, uint8_t, pf_hxxx_sei_callback, void *);
+void HxxxParseSEI(const uint8_t *, size_t, uint8_t, unsigned i_types,
+                  pf_hxxx_sei_callback, void *);
+void HxxxParse_AnnexB_SEI(const uint8_t *, size_t, uint8_t, unsigned i_types,
+                          pf_hxxx_sei_callback, void *);
 
 #endif
@@ -1202,6 +1202,10 @@ static block_t *PacketizeStreamBlock(decoder_t *p_dec, block_t **pp_block)
                 break;
             }
             block_SkipByte(&p_sys->bytestream);
+            if (p_sys->i_type == TYPE_ADTS)
+                block_SkipToByte(&p_sys->bytestream, 0xff);
+            else if (p_sys->i_type == TYPE_LOAS)
+                block_SkipToByte(&p_sys->bytestream, 0x56);
         }
         if (p_sys->i_state != STATE_SYNC) {
             block_BytestreamFlush(&p_sys->bytestream);
@@ -205,6 +205,7 @@ static block_t *DecodeBlock( decoder_t *p_dec, block_t **pp_block )
                     break;
                 }
                 block_SkipByte( &p_sys->bytestream );
+                block_SkipToByte( &p_sys->bytestream, 0xff );
             }
             if( p_sys->i_state != STATE_SYNC )
             {
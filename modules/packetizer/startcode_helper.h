@@ -22,6 +22,15 @@
 
 #include <vlc_cpu.h>
 
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+#  define STARTCODE_AVX2 1
+#  include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#  define STARTCODE_NEON 1
+#  include <arm_neon.h>
+#endif
+
 #ifdef CAN_COMPILE_SSE2
 #  if defined __has_attribute
 #    if __has_attribute(__vector_size__)
@@ -119,6 +128,63 @@ static inline const uint8_t * startcode_FindAnnexB_SSE2( const uint8_t *p, const
 
 #endif
 
+/* The wide vector versions compare 3 loads, shifted by one byte, at once:
+ * any lane matching 0x00 0x00 0x01 is then an exact startcode position */
+
+#ifdef STARTCODE_AVX2
+VLC_AVX2
+static inline const uint8_t * startcode_FindAnnexB_AVX2( const uint8_t *p, const uint8_t *end )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8( 1 );
+
+    for( ; end - p >= 32 + 2; p += 32 )
+    {
+        __m256i m0 = _mm256_cmpeq_epi8( _mm256_loadu_si256( (const __m256i *) p ), zero );
+        __m256i m1 = _mm256_cmpeq_epi8( _mm256_loadu_si256( (const __m256i *) (p + 1) ), zero );
+        __m256i m2 = _mm256_cmpeq_epi8( _mm256_loadu_si256( (const __m256i *) (p + 2) ), one );
+        uint32_t match = _mm256_movemask_epi8( _mm256_and_si256( _mm256_and_si256( m0, m1 ), m2 ) );
+        if( match )
+            return p + ctz( match );
+    }
+
+    for( end -= 3; p <= end; p++ )
+    {
+        if( p[0] == 0 && p[1] == 0 && p[2] == 1 )
+            return p;
+    }
+
+    return NULL;
+}
+#endif
+
+#ifdef STARTCODE_NEON
+static inline const uint8_t * startcode_FindAnnexB_NEON( const uint8_t *p, const uint8_t *end )
+{
+    const uint8x16_t one = vdupq_n_u8( 1 );
+
+    for( ; end - p >= 16 + 2; p += 16 )
+    {
+        uint8x16_t m = vandq_u8( vandq_u8( vceqzq_u8( vld1q_u8( p ) ),
+                                           vceqzq_u8( vld1q_u8( p + 1 ) ) ),
+                                 vceqq_u8( vld1q_u8( p + 2 ), one ) );
+        /* Narrows the byte mask to 4 bits per lane */
+        uint64_t match = vget_lane_u64( vreinterpret_u64_u8(
+                             vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 );
+        if( match )
+            return p + ctz( match ) / 4;
+    }
+
+    for( end -= 3; p <= end; p++ )
+    {
+        if( p[0] == 0 && p[1] == 0 && p[2] == 1 )
+            return p;
+    }
+
+    return NULL;
+}
+#endif
+
 /* That code is adapted from libav's ff_avc_find_startcode_internal
  * and i believe the trick originated from
  * https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
@@ -150,14 +216,21 @@ static inline const uint8_t * startcode_FindAnnexB_Bits( const uint8_t *p, const
 }
 #undef TRY_MATCH
 
-#ifdef CAN_COMPILE_SSE2
+#if defined(CAN_COMPILE_SSE2) || defined(STARTCODE_AVX2)
 static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint8_t *end )
 {
+#ifdef STARTCODE_AVX2
+    if (vlc_CPU_AVX2())
+        return startcode_FindAnnexB_AVX2(p, end);
+#endif
+#ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return startcode_FindAnnexB_SSE2(p, end);
-    else
-        return startcode_FindAnnexB_Bits(p, end);
+#endif
+    return startcode_FindAnnexB_Bits(p, end);
 }
+#elif defined(STARTCODE_NEON)
+    #define startcode_FindAnnexB startcode_FindAnnexB_NEON
 #else
     #define startcode_FindAnnexB startcode_FindAnnexB_Bits
 #endif
@@ -77,6 +77,11 @@
 #define SAP_V4_LINK_ADDRESS     "224.0.0.255"
 #define ADD_SESSION 1
 
+/* Buckets of the announce table, looked up by message id hash and source */
+#define SAP_HASH_SIZE 256
+/* Packets read in one go before checking the expirations */
+#define SAP_BATCH 64
+
 static int Decompress( const unsigned char *psz_src, unsigned char **_dst, int i_len )
 {
 #ifdef HAVE_ZLIB
@@ -134,43 +139,65 @@ typedef struct sap_announce_t
     uint16_t    i_hash;
     uint32_t    i_source[4];
 
+    /* NULL if the SDP could not be parsed, so that its repetitions are
+     * skipped as well */
     input_item_t * p_item;
+
+    /* Next announce of the same bucket */
+    struct sap_announce_t *p_next;
 } sap_announce_t;
 
+static unsigned AnnounceBucket(uint16_t i_hash, const uint32_t *i_source)
+{
+    uint32_t h = i_hash ^ i_source[0] ^ i_source[1] ^ i_source[2]
+               ^ i_source[3];
+    h ^= h >> 16;
+    return (h ^ (h >> 8)) % SAP_HASH_SIZE;
+}
+
 static sap_announce_t *CreateAnnounce(services_discovery_t *p_sd,
                                       const uint32_t *i_source,
                                       uint16_t i_hash, const char *psz_sdp)
 {
+    sap_announce_t *p_sap = malloc(sizeof (*p_sap));
+    if( p_sap == NULL )
+        return NULL;
+
+    p_sap->i_last = vlc_tick_now();
+    p_sap->i_period = 0;
+    p_sap->i_period_trust = 0;
+    p_sap->i_hash = i_hash;
+    memcpy (p_sap->i_source, i_source, sizeof(p_sap->i_source));
+    p_sap->p_item = NULL;
+    p_sap->p_next = NULL;
+
     /* Parse SDP info */
     struct vlc_sdp *p_sdp = vlc_sdp_parse(psz_sdp, strlen(psz_sdp));
     if (p_sdp == NULL)
-        return NULL;
+    {
+        msg_Dbg(p_sd, "invalid SDP, ignoring its announcements");
+        return p_sap;
+    }
 
     char *uri = NULL;
 
     if (asprintf(&uri, "sdp://%s", psz_sdp) == -1)
     {
         vlc_sdp_free(p_sdp);
+        free( p_sap );
         return NULL;
     }
 
     input_item_t *p_input;
     const char *psz_value;
-    sap_announce_t *p_sap = malloc(sizeof (*p_sap));
-    if( p_sap == NULL )
-        return NULL;
-
-    p_sap->i_last = vlc_tick_now();
-    p_sap->i_period = 0;
-    p_sap->i_period_trust = 0;
-    p_sap->i_hash = i_hash;
-    memcpy (p_sap->i_source, i_source, sizeof(p_sap->i_source));
 
     /* Released in RemoveAnnounce */
     p_input = input_item_NewStream(uri, p_sdp->name,
                                    INPUT_DURATION_INDEFINITE);
+    free(uri);
     if( unlikely(p_input == NULL) )
     {
+        vlc_sdp_free(p_sdp);
         free( p_sap );
         return NULL;
     }
@@ -224,10 +251,39 @@ typedef struct
     /* Table of announces */
     int i_announces;
     struct sap_announce_t **pp_announces;
+    struct sap_announce_t *p_buckets[SAP_HASH_SIZE];
 
     vlc_tick_t i_timeout;
+    /* Earliest time an announce may expire */
+    vlc_tick_t i_next_check;
 } services_discovery_sys_t;
 
+static sap_announce_t *FindAnnounce( services_discovery_sys_t *p_sys,
+                                     uint16_t i_hash,
+                                     const uint32_t *i_source )
+{
+    sap_announce_t *p_announce =
+        p_sys->p_buckets[AnnounceBucket(i_hash, i_source)];
+
+    while( p_announce != NULL
+        && ( p_announce->i_hash != i_hash
+          || memcmp(p_announce->i_source, i_source,
+                    sizeof (p_announce->i_source)) ) )
+        p_announce = p_announce->p_next;
+    return p_announce;
+}
+
+static vlc_tick_t AnnounceDeadline( const services_discovery_sys_t *p_sys,
+                                    const sap_announce_t *p_announce )
+{
+    vlc_tick_t i_deadline = p_announce->i_last + p_sys->i_timeout;
+
+    if( p_announce->i_period_trust > 5 )
+        i_deadline = __MIN(p_announce->i_last + 10 * p_announce->i_period,
+                           i_deadline);
+    return i_deadline;
+}
+
 static int RemoveAnnounce( services_discovery_t *p_sd,
                            sap_announce_t *p_announce )
 {
@@ -239,6 +295,12 @@ static int RemoveAnnounce( services_discovery_t *p_sd,
     }
 
     services_discovery_sys_t *p_sys = p_sd->p_sys;
+    sap_announce_t **pp = &p_sys->p_buckets[AnnounceBucket(p_announce->i_hash,
+                                                          p_announce->i_source)];
+    while( *pp != p_announce )
+        pp = &(*pp)->p_next;
+    *pp = p_announce->p_next;
+
     TAB_REMOVE(p_sys->i_announces, p_sys->pp_announces, p_announce);
     free( p_announce );
 
@@ -312,6 +374,40 @@ static int ParseSAP( services_discovery_t *p_sd, const uint8_t *buf,
     if (buf > end)
         return VLC_EGENERIC;
 
+    /* The message id hash and the source identify the announce (RFC 2974),
+     * so that repetitions are accounted for without decompressing and
+     * parsing their payload again */
+    sap_announce_t *p_announce = FindAnnounce(p_sys, i_hash, i_source);
+    if( p_announce != NULL )
+    {
+        /* We don't support delete announcement as they can easily
+         * Be used to hijack an announcement by a third party.
+         * Instead we cleverly implement Implicit Announcement removal.
+         *
+         * if( b_need_delete )
+         *    RemoveAnnounce( p_sd, p_announce );
+         * else
+         */
+
+        if( !b_need_delete )
+        {
+            /* No need to go after six, as we start to trust the
+             * average period at six */
+            if( p_announce->i_period_trust <= 5 )
+                p_announce->i_period_trust++;
+
+            /* Compute the average period */
+            vlc_tick_t now = vlc_tick_now();
+            p_announce->i_period = ( p_announce->i_period * (p_announce->i_period_trust-1) + (now - p_announce->i_last) ) / p_announce->i_period_trust;
+            p_announce->i_last = now;
+
+            /* A shorter period may bring the expiration forward */
+            p_sys->i_next_check = __MIN(AnnounceDeadline(p_sys, p_announce),
+                                        p_sys->i_next_check);
+        }
+        return VLC_SUCCESS;
+    }
+
     uint8_t *decomp = NULL;
     if( b_compressed )
     {
@@ -356,42 +452,17 @@ static int ParseSAP( services_discovery_t *p_sd, const uint8_t *buf,
         psz_sdp += clen;
     }
 
-    for( int i = 0 ; i < p_sys->i_announces ; i++ )
-    {
-        sap_announce_t * p_announce = p_sys->pp_announces[i];
-        /* FIXME: slow */
-        if (p_announce->i_hash == i_hash
-         && memcmp(p_announce->i_source, i_source, sizeof (i_source)) == 0)
-        {
-            /* We don't support delete announcement as they can easily
-             * Be used to hijack an announcement by a third party.
-             * Instead we cleverly implement Implicit Announcement removal.
-             *
-             * if( b_need_delete )
-             *    RemoveAnnounce( p_sd, p_sys->pp_announces[i]);
-             * else
-             */
-
-            if( !b_need_delete )
-            {
-                /* No need to go after six, as we start to trust the
-                 * average period at six */
-                if( p_announce->i_period_trust <= 5 )
-                    p_announce->i_period_trust++;
-
-                /* Compute the average period */
-                vlc_tick_t now = vlc_tick_now();
-                p_announce->i_period = ( p_announce->i_period * (p_announce->i_period_trust-1) + (now - p_announce->i_last) ) / p_announce->i_period_trust;
-                p_announce->i_last = now;
-            }
-            free (decomp);
-            return VLC_SUCCESS;
-        }
-    }
-
     sap_announce_t *sap = CreateAnnounce(p_sd, i_source, i_hash, psz_sdp);
     if (sap != NULL)
+    {
+        unsigned i_bucket = AnnounceBucket(i_hash, i_source);
+
+        sap->p_next = p_sys->p_buckets[i_bucket];
+        p_sys->p_buckets[i_bucket] = sap;
         TAB_APPEND(p_sys->i_announces, p_sys->pp_announces, sap);
+        p_sys->i_next_check = __MIN(AnnounceDeadline(p_sys, sap),
+                                    p_sys->i_next_check);
+    }
 
     free (decomp);
     return VLC_SUCCESS;
@@ -501,7 +572,9 @@ static void *Run( void *data )
 
         int val = poll (ufd, n, timeout);
         canc = vlc_savecancel ();
-        if (val > 0)
+
+        /* Read what is already queued before looking at the expirations */
+        for (unsigned batch = 0; val > 0 && batch < SAP_BATCH; batch++)
         {
             for (unsigned i = 0; i < n; i++)
             {
@@ -521,42 +594,61 @@ static void *Run( void *data )
                         ParseSAP (p_sd, p_buffer, i_read);
                     }
                 }
+                ufd[i].revents = 0;
             }
+            val = poll (ufd, n, 0);
         }
 
         vlc_tick_t now = vlc_tick_now();
 
+        /* Refreshes only delay the expirations, do not scan all the
+         * announces until the earliest one is due */
+        if (now < p_sys->i_next_check)
+        {
+            if (p_sys->i_next_check == VLC_TICK_MAX)
+                timeout = -1;
+            else
+                timeout = MS_FROM_VLC_TICK(p_sys->i_next_check - now) + 1;
+            continue;
+        }
+
         /* A 1 hour timeout correspond to the RFC Implicit timeout.
          * This timeout is tuned in the following loop. */
         timeout = 1000 * 60 * 60;
+        p_sys->i_next_check = now + VLC_TICK_FROM_MS(timeout);
 
         /* Check for items that need deletion */
         for( int i = 0; i < p_sys->i_announces; i++ )
         {
             sap_announce_t * p_announce = p_sys->pp_announces[i];
-            vlc_tick_t i_last_period = now - p_announce->i_last;
+            vlc_tick_t i_deadline = AnnounceDeadline( p_sys, p_announce );
 
             /* Remove the announcement, if the last announcement was 1 hour ago
              * or if the last packet emitted was 10 times the average time
              * between two packets */
-            if( ( p_announce->i_period_trust > 5 && i_last_period > 10 * p_announce->i_period ) ||
-                i_last_period > p_sys->i_timeout )
+            if( i_deadline < now )
             {
                 RemoveAnnounce( p_sd, p_announce );
+                i--;
             }
             else
             {
                 /* Compute next timeout */
-                if( p_announce->i_period_trust > 5 )
-                    timeout = __MIN(MS_FROM_VLC_TICK(10 * p_announce->i_period - i_last_period), timeout);
-                timeout = __MIN(MS_FROM_VLC_TICK(p_sys->i_timeout - i_last_period), timeout);
+                timeout = __MIN(MS_FROM_VLC_TICK(i_deadline - now), timeout);
+                p_sys->i_next_check = __MIN(i_deadline, p_sys->i_next_check);
             }
         }
 
         if( !p_sys->i_announces )
+        {
             timeout = -1; /* We can safely poll indefinitely. */
+            p_sys->i_next_check = VLC_TICK_MAX;
+        }
         else if( timeout < 200 )
+        {
             timeout = 200; /* Don't wakeup too fast. */
+            p_sys->i_next_check = now + VLC_TICK_FROM_MS(timeout);
+        }
     }
     vlc_assert_unreachable ();
 }
@@ -582,6 +674,9 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->i_announces = 0;
     p_sys->pp_announces = NULL;
+    for( unsigned i = 0; i < SAP_HASH_SIZE; i++ )
+        p_sys->p_buckets[i] = NULL;
+    p_sys->i_next_check = VLC_TICK_MAX;
     /* TODO: create sockets here, and fix racy sockets table */
     if (vlc_clone (&p_sys->thread, Run, p_sd))
     {
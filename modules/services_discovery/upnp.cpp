@@ -55,6 +55,9 @@ const char* CONTENT_DIRECTORY_SERVICE_TYPE = "urn:schemas-upnp-org:service:Conte
 const char* SATIP_SERVER_DEVICE_TYPE = "urn:ses-com:device:SatIPServer:1";
 
 #define UPNP_SEARCH_TIMEOUT_SECONDS 15
+/* Number of objects requested per Browse action: big containers are fetched
+ * in pages, so that no single response has to hold the whole container */
+#define UPNP_BROWSE_PAGE_SIZE 500
 #define SATIP_CHANNEL_LIST N_("SAT>IP channel list")
 #define SATIP_CHANNEL_LIST_URL N_("Custom SAT>IP channel list URL")
 
@@ -1276,14 +1279,12 @@ browseActionCleanup:
  */
 bool MediaServer::fetchContents()
 {
-    std::string StartingIndex = "0";
-    std::string RequestedCount = "5000";
-    const char* psz_TotalMatches = "0";
-    const char* psz_NumberReturned = "0";
-    long  l_reqCount = 0;
+    const std::string RequestedCount = std::to_string( UPNP_BROWSE_PAGE_SIZE );
+    unsigned long i_start = 0;
 
-    do
+    for( ;; )
     {
+        const std::string StartingIndex = std::to_string( i_start );
         IXML_Document* p_response = _browseAction( m_psz_objectId,
                                                   "BrowseDirectChildren",
                                                   "*",
@@ -1298,12 +1299,15 @@ bool MediaServer::fetchContents()
             return false;
         }
 
-        psz_TotalMatches = xml_getChildElementValue( (IXML_Element*)p_response, "TotalMatches" );
-        psz_NumberReturned = xml_getChildElementValue( (IXML_Element*)p_response, "NumberReturned" );
-
-        StartingIndex = std::to_string(  std::stol(psz_NumberReturned) + std::stol(StartingIndex) );
-        l_reqCount = std::stol(psz_TotalMatches) - std::stol(StartingIndex) ;
-        RequestedCount = std::to_string(l_reqCount);
+        const char* psz_TotalMatches =
+            xml_getChildElementValue( (IXML_Element*)p_response, "TotalMatches" );
+        const char* psz_NumberReturned =
+            xml_getChildElementValue( (IXML_Element*)p_response, "NumberReturned" );
+        /* TotalMatches is 0 when the server cannot tell */
+        unsigned long i_total = psz_TotalMatches ?
+                                strtoul( psz_TotalMatches, NULL, 10 ) : 0;
+        unsigned long i_returned = psz_NumberReturned ?
+                                   strtoul( psz_NumberReturned, NULL, 10 ) : 0;
 
         IXML_Document* p_result = parseBrowseResult( p_response );
 
@@ -1316,7 +1320,9 @@ bool MediaServer::fetchContents()
         }
 
 #ifndef NDEBUG
-        msg_Dbg( m_access, "Got DIDL document: %s", ixmlPrintDocument( p_result ) );
+        DOMString psz_didl = ixmlPrintDocument( p_result );
+        msg_Dbg( m_access, "Got DIDL document: %s", psz_didl );
+        ixmlFreeDOMString( psz_didl );
 #endif
 
         IXML_NodeList* containerNodeList =
@@ -1339,8 +1345,13 @@ bool MediaServer::fetchContents()
         }
 
         ixmlDocument_free( p_result );
+
+        i_start += i_returned;
+        if ( i_returned == 0 )
+            break;
+        if ( i_total ? i_start >= i_total : i_returned < UPNP_BROWSE_PAGE_SIZE )
+            break;
     }
-    while( l_reqCount );
     return true;
 }
 
@@ -54,6 +54,12 @@ static int MosaicCallback   ( vlc_object_t *, char const *, vlc_value_t,
 /*****************************************************************************
  * filter_sys_t : filter descriptor
  *****************************************************************************/
+typedef struct
+{
+    picture_t *p_src;         /* Bridged picture, held */
+    picture_t *p_scaled;      /* Its resized and converted version */
+} mosaic_scaled_t;
+
 typedef struct
 {
     vlc_mutex_t lock;         /* Internal filter lock */
@@ -78,6 +84,9 @@ typedef struct
     int i_offsets_length;
 
     vlc_tick_t i_delay;
+
+    mosaic_scaled_t *p_scaled; /* Pictures of the previous mosaic */
+    int i_scaled;
 } filter_sys_t;
 
 /*****************************************************************************
@@ -293,6 +302,9 @@ static int CreateFilter( filter_t *p_filter )
     vlc_mutex_init( &p_sys->lock );
     vlc_mutex_lock( &p_sys->lock );
 
+    p_sys->p_scaled = NULL;
+    p_sys->i_scaled = 0;
+
     config_ChainParse( p_filter, CFG_PREFIX, ppsz_filter_options,
                        p_filter->p_cfg );
 
@@ -372,6 +384,52 @@ static int CreateFilter( filter_t *p_filter )
     return VLC_SUCCESS;
 }
 
+static void ReleaseScaled( mosaic_scaled_t *p_scaled, int i_scaled )
+{
+    for( int i = 0; i < i_scaled; i++ )
+    {
+        if( p_scaled[i].p_src == NULL )
+            continue;
+        picture_Release( p_scaled[i].p_src );
+        picture_Release( p_scaled[i].p_scaled );
+    }
+}
+
+/**
+ * Resizes and converts a bridged picture, unless that was done for the
+ * previous mosaic: most inputs do not have a new picture on every call.
+ */
+static picture_t *GetScaled( filter_t *p_filter, mosaic_scaled_t *p_cache,
+                             picture_t *p_src, video_format_t *p_fmt_in,
+                             video_format_t *p_fmt_out )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    for( int i = 0; i < p_sys->i_scaled; i++ )
+    {
+        mosaic_scaled_t *p_old = &p_sys->p_scaled[i];
+
+        if( p_old->p_src == p_src
+         && p_old->p_scaled->format.i_width == p_fmt_out->i_width
+         && p_old->p_scaled->format.i_height == p_fmt_out->i_height
+         && p_old->p_scaled->format.i_chroma == p_fmt_out->i_chroma )
+        {
+            *p_cache = *p_old;
+            p_old->p_src = NULL;
+            return picture_Hold( p_cache->p_scaled );
+        }
+    }
+
+    picture_t *p_scaled = image_Convert( p_sys->p_image, p_src,
+                                         p_fmt_in, p_fmt_out );
+    if( p_scaled != NULL )
+    {
+        p_cache->p_src = picture_Hold( p_src );
+        p_cache->p_scaled = picture_Hold( p_scaled );
+    }
+    return p_scaled;
+}
+
 /*****************************************************************************
  * DestroyFilter: destroy mosaic video filter
  *****************************************************************************/
@@ -420,6 +478,8 @@ static void DestroyFilter( filter_t *p_filter )
         p_sys->i_offsets_length = 0;
     }
 
+    ReleaseScaled( p_sys->p_scaled, p_sys->i_scaled );
+    free( p_sys->p_scaled );
     free( p_sys );
 }
 
@@ -438,6 +498,7 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
 
     subpicture_region_t *p_region;
     subpicture_region_t *p_region_prev = NULL;
+    mosaic_scaled_t *p_scaled = NULL;
 
     /* Allocate the subpicture internal data. */
     subpicture_t *p_spu = filter_NewSubpicture( p_filter );
@@ -519,6 +580,18 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
 
     i_real_index = 0;
 
+    if( !p_sys->b_keep && p_bridge->i_es_num > 0 )
+    {
+        p_scaled = calloc( p_bridge->i_es_num, sizeof( *p_scaled ) );
+        if( p_scaled == NULL )
+        {
+            subpicture_Delete( p_spu );
+            vlc_global_unlock( VLC_MOSAIC_MUTEX );
+            vlc_mutex_unlock( &p_sys->lock );
+            return NULL;
+        }
+    }
+
     for( int i_index = 0; i_index < p_bridge->i_es_num; i_index++ )
     {
         bridged_es_t *p_es = p_bridge->pp_es[i_index];
@@ -622,8 +695,8 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
             fmt_out.i_visible_width = fmt_out.i_width;
             fmt_out.i_visible_height = fmt_out.i_height;
 
-            p_converted = image_Convert( p_sys->p_image, p_converted,
-                                         &fmt_in, &fmt_out );
+            p_converted = GetScaled( p_filter, &p_scaled[i_index],
+                                     p_converted, &fmt_in, &fmt_out );
             if( !p_converted )
             {
                 msg_Warn( p_filter,
@@ -642,11 +715,16 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
             fmt_out.i_visible_height = fmt_out.i_height;
         }
 
+        /* The region references the picture: the pictures are not
+         * modified once bridged or scaled */
         p_region = subpicture_region_New( &fmt_out );
-        /* FIXME the copy is probably not needed anymore */
         if( p_region )
-            picture_Copy( p_region->p_picture, p_converted );
-        if( !p_sys->b_keep )
+        {
+            picture_Release( p_region->p_picture );
+            p_region->p_picture = p_sys->b_keep ? picture_Hold( p_converted )
+                                                : p_converted;
+        }
+        else if( !p_sys->b_keep )
             picture_Release( p_converted );
 
         if( !p_region )
@@ -655,6 +733,8 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
             video_format_Clean( &fmt_out );
             msg_Err( p_filter, "cannot allocate SPU region" );
             subpicture_Delete( p_spu );
+            ReleaseScaled( p_scaled, p_bridge->i_es_num );
+            free( p_scaled );
             vlc_global_unlock( VLC_MOSAIC_MUTEX );
             vlc_mutex_unlock( &p_sys->lock );
             return NULL;
@@ -726,6 +806,12 @@ static subpicture_t *Filter( filter_t *p_filter, vlc_tick_t date )
         p_region_prev = p_region;
     }
 
+    /* Only the pictures still bridged are kept for the next mosaic */
+    ReleaseScaled( p_sys->p_scaled, p_sys->i_scaled );
+    free( p_sys->p_scaled );
+    p_sys->p_scaled = p_scaled;
+    p_sys->i_scaled = p_scaled != NULL ? p_bridge->i_es_num : 0;
+
     vlc_global_unlock( VLC_MOSAIC_MUTEX );
     vlc_mutex_unlock( &p_sys->lock );
 
@@ -79,6 +79,10 @@ struct private_sys_t
     bool b_seekable_source;
     bool b_seekable_archive;
 
+    bool b_direct; /* stored entry, read straight from the source */
+    uint64_t i_direct_offset;
+    uint64_t i_direct_size;
+
     libarchive_callback_t** pp_callback_data;
     size_t i_callback_data;
 };
@@ -497,6 +501,8 @@ static int Control( stream_extractor_t* p_extractor, int i_query, va_list args )
     switch( i_query )
     {
         case STREAM_CAN_FASTSEEK:
+            if( p_sys->b_direct )
+                return vlc_stream_vaControl( p_extractor->source, i_query, args );
             *va_arg( args, bool* ) = false;
             break;
 
@@ -573,6 +579,229 @@ static int ReadDir( stream_directory_t* p_directory, input_item_node_t* p_node )
     return archive_status == ARCHIVE_EOF ? VLC_SUCCESS : VLC_EGENERIC;
 }
 
+/* ------------------------------------------------------------------------- */
+
+/* Stored (uncompressed) ZIP entries are read straight from the source stream,
+ * so that seeking in them does not require libarchive to extract the entry
+ * again from its start. The entry is looked up in the central directory. */
+
+#define ZIP_EOCD_SIZE 22
+#define ZIP_EOCD64_LOCATOR_SIZE 20
+#define ZIP_EOCD64_SIZE 56
+#define ZIP_CDH_SIZE 46
+#define ZIP_LFH_SIZE 30
+
+static int zip_read_at( stream_t* s, uint64_t i_pos, void* p_buf, size_t i_size )
+{
+    if( vlc_stream_Seek( s, i_pos ) )
+        return VLC_EGENERIC;
+    return vlc_stream_Read( s, p_buf, i_size ) == (ssize_t)i_size ?
+           VLC_SUCCESS : VLC_EGENERIC;
+}
+
+static int zip_find_central_directory( stream_t* s, uint64_t* pi_offset,
+                                       uint64_t* pi_count )
+{
+    uint64_t i_stream_size;
+    if( vlc_stream_GetSize( s, &i_stream_size ) ||
+        i_stream_size < ZIP_EOCD_SIZE )
+        return VLC_EGENERIC;
+
+    /* the end of central directory record is followed by up to 64 KiB of
+     * comment */
+    size_t i_tail = __MIN( i_stream_size, ZIP_EOCD_SIZE + 0xFFFF );
+    uint8_t* p_tail = malloc( i_tail );
+    if( unlikely( p_tail == NULL ) )
+        return VLC_ENOMEM;
+
+    int i_ret = VLC_EGENERIC;
+    if( zip_read_at( s, i_stream_size - i_tail, p_tail, i_tail ) )
+        goto out;
+
+    size_t i_eocd = i_tail - ZIP_EOCD_SIZE + 1;
+    while( i_eocd-- > 0 )
+        if( !memcmp( &p_tail[i_eocd], "PK\x05\x06", 4 ) )
+            break;
+    if( i_eocd == SIZE_MAX )
+        goto out;
+
+    *pi_count = GetWLE( &p_tail[i_eocd + 10] );
+    *pi_offset = GetDWLE( &p_tail[i_eocd + 16] );
+
+    if( *pi_count == 0xFFFF || *pi_offset == 0xFFFFFFFF )
+    {
+        /* ZIP64: the locator precedes the end of central directory */
+        if( i_eocd < ZIP_EOCD64_LOCATOR_SIZE )
+            goto out;
+        const uint8_t* p_locator = &p_tail[i_eocd - ZIP_EOCD64_LOCATOR_SIZE];
+        uint8_t eocd64[ ZIP_EOCD64_SIZE ];
+        if( memcmp( p_locator, "PK\x06\x07", 4 ) ||
+            zip_read_at( s, GetQWLE( &p_locator[8] ), eocd64, sizeof( eocd64 ) ) ||
+            memcmp( eocd64, "PK\x06\x06", 4 ) )
+            goto out;
+
+        *pi_count = GetQWLE( &eocd64[32] );
+        *pi_offset = GetQWLE( &eocd64[48] );
+    }
+    i_ret = VLC_SUCCESS;
+
+out:
+    free( p_tail );
+    return i_ret;
+}
+
+static int zip_find_stored_entry_in_cd( stream_t* s, char const* psz_name,
+                                        uint64_t i_size, uint64_t i_cd_count,
+                                        uint8_t* buffer, uint64_t* pi_data )
+{
+    size_t i_name = strlen( psz_name );
+
+    for( uint64_t i = 0; i < i_cd_count; ++i )
+    {
+        uint8_t cdh[ ZIP_CDH_SIZE ];
+        if( vlc_stream_Read( s, cdh, sizeof( cdh ) ) != sizeof( cdh ) ||
+            memcmp( cdh, "PK\x01\x02", 4 ) )
+            return VLC_EGENERIC;
+
+        uint16_t i_flags = GetWLE( &cdh[8] );
+        uint16_t i_method = GetWLE( &cdh[10] );
+        uint64_t i_usize = GetDWLE( &cdh[24] );
+        uint16_t i_name_len = GetWLE( &cdh[28] );
+        uint16_t i_extra_len = GetWLE( &cdh[30] );
+        uint16_t i_comment_len = GetWLE( &cdh[32] );
+        uint64_t i_local = GetDWLE( &cdh[42] );
+
+        if( vlc_stream_Read( s, buffer, i_name_len ) != i_name_len )
+            return VLC_EGENERIC;
+
+        if( i_name_len != i_name || memcmp( buffer, psz_name, i_name ) )
+        {
+            if( vlc_stream_Read( s, NULL, i_extra_len + i_comment_len )
+                    != i_extra_len + i_comment_len )
+                return VLC_EGENERIC;
+            continue;
+        }
+
+        /* compressed or encrypted entries go through libarchive */
+        if( i_method != 0 || ( i_flags & 0x1 ) )
+            return VLC_EGENERIC;
+
+        if( vlc_stream_Read( s, buffer, i_extra_len ) != i_extra_len )
+            return VLC_EGENERIC;
+
+        /* ZIP64 extended information, only the saturated fields are present */
+        for( size_t i_extra = 0; i_extra + 4 <= i_extra_len; )
+        {
+            uint16_t i_id = GetWLE( &buffer[i_extra] );
+            uint16_t i_len = GetWLE( &buffer[i_extra + 2] );
+            const uint8_t* p_field = &buffer[i_extra + 4];
+            i_extra += 4 + i_len;
+            if( i_id != 0x0001 || i_extra > i_extra_len )
+                continue;
+
+            if( i_usize == 0xFFFFFFFF && i_len >= 8 )
+            {
+                i_usize = GetQWLE( p_field );
+                p_field += 8; i_len -= 8;
+            }
+            if( GetDWLE( &cdh[20] ) == 0xFFFFFFFF && i_len >= 8 )
+            {
+                p_field += 8; i_len -= 8;
+            }
+            if( i_local == 0xFFFFFFFF && i_len >= 8 )
+                i_local = GetQWLE( p_field );
+        }
+
+        if( i_usize != i_size )
+            return VLC_EGENERIC;
+
+        /* the data follows the local file header */
+        uint8_t lfh[ ZIP_LFH_SIZE ];
+        if( zip_read_at( s, i_local, lfh, sizeof( lfh ) ) ||
+            memcmp( lfh, "PK\x03\x04", 4 ) )
+            return VLC_EGENERIC;
+
+        *pi_data = i_local + ZIP_LFH_SIZE + GetWLE( &lfh[26] ) + GetWLE( &lfh[28] );
+        return VLC_SUCCESS;
+    }
+
+    return VLC_EGENERIC;
+}
+
+static int zip_find_stored_entry( stream_t* s, char const* psz_name,
+                                  uint64_t i_size, uint64_t* pi_data )
+{
+    uint64_t i_cd_offset, i_cd_count;
+    if( zip_find_central_directory( s, &i_cd_offset, &i_cd_count ) ||
+        vlc_stream_Seek( s, i_cd_offset ) )
+        return VLC_EGENERIC;
+
+    /* holds a file name or an extra field */
+    uint8_t* buffer = malloc( 0xFFFF );
+    if( unlikely( buffer == NULL ) )
+        return VLC_ENOMEM;
+
+    int i_ret = zip_find_stored_entry_in_cd( s, psz_name, i_size, i_cd_count,
+                                             buffer, pi_data );
+    free( buffer );
+    return i_ret;
+}
+
+static void archive_setup_direct( stream_extractor_t* p_extractor )
+{
+    private_sys_t* p_sys = p_extractor->p_sys;
+    libarchive_t* p_arc = p_sys->p_archive;
+
+    /* only single volume, uncompressed ZIP files can be mapped directly */
+    if( !p_sys->b_seekable_source || p_sys->i_callback_data != 1 ||
+        ( archive_format( p_arc ) & ARCHIVE_FORMAT_BASE_MASK ) != ARCHIVE_FORMAT_ZIP ||
+        archive_filter_code( p_arc, 0 ) != ARCHIVE_FILTER_NONE ||
+        !archive_entry_size_is_set( p_sys->p_entry ) )
+        return;
+
+    uint64_t i_size = archive_entry_size( p_sys->p_entry );
+    uint64_t i_offset;
+    uint64_t i_source_pos = vlc_stream_Tell( p_extractor->source );
+
+    if( zip_find_stored_entry( p_extractor->source, p_extractor->identifier,
+                               i_size, &i_offset ) )
+    {
+        /* libarchive reads on from where it left its source */
+        if( vlc_stream_Seek( p_extractor->source, i_source_pos ) &&
+            archive_extractor_reset( p_extractor ) )
+            msg_Err( p_extractor, "unable to reset libarchive handle" );
+        return;
+    }
+
+    /* past this point, the archive handle is no longer used to read */
+    msg_Dbg( p_extractor, "reading stored entry directly at offset %" PRIu64,
+             i_offset );
+    p_sys->b_direct = true;
+    p_sys->i_direct_offset = i_offset;
+    p_sys->i_direct_size = i_size;
+}
+
+static ssize_t DirectRead( stream_extractor_t *p_extractor, void* p_data,
+                           size_t i_size )
+{
+    private_sys_t* p_sys = p_extractor->p_sys;
+
+    if( p_sys->i_offset >= p_sys->i_direct_size )
+        return 0;
+    if( i_size > p_sys->i_direct_size - p_sys->i_offset )
+        i_size = p_sys->i_direct_size - p_sys->i_offset;
+
+    uint64_t i_pos = p_sys->i_direct_offset + p_sys->i_offset;
+    if( vlc_stream_Tell( p_extractor->source ) != i_pos &&
+        vlc_stream_Seek( p_extractor->source, i_pos ) )
+        return 0;
+
+    ssize_t i_ret = vlc_stream_Read( p_extractor->source, p_data, i_size );
+    if( i_ret > 0 )
+        p_sys->i_offset += i_ret;
+    return i_ret;
+}
+
 static ssize_t Read( stream_extractor_t *p_extractor, void* p_data, size_t i_size )
 {
     char dummy_buffer[ 8192 ];
@@ -584,6 +813,9 @@ static ssize_t Read( stream_extractor_t *p_extractor, void* p_data, size_t i_siz
     if( p_sys->b_dead || p_sys->p_entry == NULL )
         return 0;
 
+    if( p_sys->b_direct )
+        return DirectRead( p_extractor, p_data, i_size );
+
     if( p_sys->b_eof )
         return 0;
 
@@ -640,6 +872,13 @@ static int Seek( stream_extractor_t* p_extractor, uint64_t i_req )
     if( !p_sys->p_entry || !p_sys->b_seekable_source )
         return VLC_EGENERIC;
 
+    if( p_sys->b_direct )
+    {
+        /* the position is only applied on the next read */
+        p_sys->i_offset = i_req;
+        return VLC_SUCCESS;
+    }
+
     if( archive_entry_size_is_set( p_sys->p_entry ) &&
         (uint64_t)archive_entry_size( p_sys->p_entry ) <= i_req )
     {
@@ -755,6 +994,8 @@ static int ExtractorOpen( vlc_object_t* p_obj )
     }
 
     p_extractor->p_sys = p_sys;
+    archive_setup_direct( p_extractor );
+
     p_extractor->pf_read = Read;
     p_extractor->pf_control = Control;
     p_extractor->pf_seek = Seek;
@@ -67,6 +67,7 @@
 typedef struct
 {
     block_bytestream_t cache; /* bytestream chain for storing cache */
+    uint64_t offset; /* stream position of the cache read cursor */
 
     struct
     {
@@ -174,6 +175,7 @@ static void AStreamControlReset(stream_t *s)
     stream_sys_t *sys = s->p_sys;
 
     block_BytestreamEmpty( &sys->cache );
+    sys->offset = 0;
 
     /* Do the prebuffering */
     AStreamPrebufferBlock(s);
@@ -183,14 +185,19 @@ static int AStreamSeekBlock(stream_t *s, uint64_t i_pos)
 {
     stream_sys_t *sys = s->p_sys;
 
-    if( block_SkipBytes( &sys->cache, i_pos) == VLC_SUCCESS )
+    if( i_pos >= sys->offset &&
+        block_SkipBytes( &sys->cache, i_pos - sys->offset ) == VLC_SUCCESS )
+    {
+        sys->offset = i_pos;
         return VLC_SUCCESS;
+    }
 
     /* Not enough bytes, empty and seek */
     /* Do the access seek */
     if (vlc_stream_Seek(s->s, i_pos)) return VLC_EGENERIC;
 
     block_BytestreamEmpty( &sys->cache );
+    sys->offset = i_pos;
 
     /* Refill a block */
     if (AStreamRefillBlock(s))
@@ -222,6 +229,7 @@ static ssize_t AStreamReadBlock(stream_t *s, void *buf, size_t len)
     /* Copy data */
     if( block_GetBytes( &sys->cache, buf, i_copy ) )
         return -1;
+    sys->offset += i_copy;
 
 
     /* If we ended up on refill, try to read refilled cache */
@@ -255,6 +263,7 @@ static int AStreamControl(stream_t *s, int i_query, va_list args)
         case STREAM_SET_PRIVATE_ID_STATE:
         case STREAM_SET_PRIVATE_ID_CA:
         case STREAM_GET_PRIVATE_ID_STATE:
+        case STREAM_SET_READ_HINT:
             return vlc_stream_vaControl(s->s, i_query, args);
 
         case STREAM_SET_TITLE:
@@ -289,6 +298,7 @@ static int Open(vlc_object_t *obj)
 
     /* Init all fields of sys->block */
     block_BytestreamInit( &sys->cache );
+    sys->offset = 0;
 
     s->p_sys = sys;
     /* Do the prebuffering */
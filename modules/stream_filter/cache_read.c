@@ -58,7 +58,8 @@
 /* Method:
  *  - We use ring buffers, only one if unseekable, all if seekable
  *  - Upon seek date current ring, then search if one ring match the pos,
- *      yes: switch to it, seek the access to match the end of the ring
+ *      yes: switch to it, the access is seeked to the end of the ring
+ *           when the ring needs to be refilled
  *      no: search the ring with i_end the closer to i_pos,
  *          if close enough, read data and use this ring
  *          else use the oldest ring, seek and use it.
@@ -123,6 +124,14 @@ static int AStreamRefillStream(stream_t *s)
                  sys->i_used, i_toread);
 #endif
 
+    /* Do the seek delayed by a switch to another track */
+    if (vlc_stream_Tell(s->s) != tk->i_end
+     && vlc_stream_Seek(s->s, tk->i_end))
+    {
+        msg_Err(s, "AStreamRefillStream: hard seek failed");
+        return VLC_EGENERIC;
+    }
+
     vlc_tick_t start = vlc_tick_now();
     while (i_toread > 0)
     {
@@ -378,20 +387,13 @@ static int AStreamSeekStream(stream_t *s, uint64_t i_pos)
                  i_tk_idx, tk->i_start, tk->i_end,
                  tk != p_current ? "seek" : i_pos > tk->i_end ? "skip" : "noseek");
 #endif
-        if (tk != p_current)
-        {
-            assert(b_aseek);
+        /* When switching to another track, the source is only seeked to the
+         * end of that track once it needs to be refilled: a demuxer jumping
+         * back and forth between its index and its data does not pay a
+         * round-trip for every jump. */
+        assert(tk == p_current || b_aseek);
 
-            /* Seek at the end of the buffer
-             * TODO it is stupid to seek now, it would be better to delay it
-             */
-            if (vlc_stream_Seek(s->s, tk->i_end))
-            {
-                msg_Err(s, "AStreamSeekStream: hard seek failed");
-                return VLC_EGENERIC;
-            }
-        }
-        else if (i_pos > tk->i_end)
+        if (tk == p_current && i_pos > tk->i_end)
         {
             uint64_t i_skip = i_pos - tk->i_end;
             while (i_skip > 0)
@@ -468,6 +470,7 @@ static int AStreamControl(stream_t *s, int i_query, va_list args)
         case STREAM_SET_PRIVATE_ID_STATE:
         case STREAM_SET_PRIVATE_ID_CA:
         case STREAM_GET_PRIVATE_ID_STATE:
+        case STREAM_SET_READ_HINT:
             return vlc_stream_vaControl(s->s, i_query, args);
 
         case STREAM_SET_TITLE:
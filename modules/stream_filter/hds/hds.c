@@ -48,6 +48,7 @@ typedef struct chunk_s
 
     uint8_t     *mdat_data;
     uint8_t     *data;
+    bool        downloading; /* claimed by a download thread */
     bool        failed;
     bool        eof;
 } chunk_t;
@@ -120,13 +121,17 @@ typedef struct hds_stream_s
 /* this is effectively just a sanity check  mechanism */
 #define MAX_REQUEST_SIZE (50*1024*1024)
 
+/* fragments downloaded at the same time */
+#define MAX_HDS_DOWNLOADS 3
+
 #define BITRATE_AS_BYTES_PER_SECOND 1024/8
 
 typedef struct
 {
     char         *base_url;    /* URL common part for chunks */
     vlc_thread_t live_thread;
-    vlc_thread_t dl_thread;
+    vlc_thread_t dl_threads[MAX_HDS_DOWNLOADS];
+    unsigned     dl_thread_count;
 
     /* we pend on peek until some number of segments arrives; otherwise
      * the downstream system dies in case of playback */
@@ -813,6 +818,8 @@ static uint8_t* download_chunk( stream_t *s,
     if( size > MAX_REQUEST_SIZE )
     {
         msg_Err(s, "Strangely-large chunk of %"PRIi64" Bytes", size );
+        vlc_stream_Delete( download_stream );
+        chunk->failed = true;
         return NULL;
     }
 
@@ -820,11 +827,14 @@ static uint8_t* download_chunk( stream_t *s,
     if( ! data )
     {
         msg_Err(s, "Couldn't allocate chunk" );
+        vlc_stream_Delete( download_stream );
+        chunk->failed = true;
         return NULL;
     }
 
     int read = vlc_stream_Read( download_stream, data,
                             size );
+    vlc_stream_Delete( download_stream );
     if( read < 0 )
         read = 0;
     chunk->data_len = read;
@@ -833,21 +843,30 @@ static uint8_t* download_chunk( stream_t *s,
     {
         msg_Err( s, "Requested %"PRIi64" bytes, "\
                  "but only got %d", size, read );
-        data = realloc( chunk->data, read );
-        if( data != NULL )
-            chunk->data = data;
+        free( data );
         chunk->failed = true;
         return NULL;
     }
-    else
-    {
-        chunk->failed = false;
-    }
 
-    vlc_stream_Delete( download_stream );
+    chunk->failed = false;
     return data;
 }
 
+/* Oldest chunk that is neither downloaded nor being downloaded.
+ * Must be called with dl_lock held. */
+static chunk_t* next_download_chunk( hds_stream_t* hds_stream )
+{
+    chunk_t* chunk = hds_stream->chunks_downloadpos;
+    if( ! chunk )
+        chunk = hds_stream->chunks_head;
+
+    while( chunk && ( chunk->data || chunk->downloading ) )
+        chunk = chunk->next;
+
+    hds_stream->chunks_downloadpos = chunk ? chunk->next : NULL;
+    return chunk;
+}
+
 static void* download_thread( void* p )
 {
     vlc_thread_set_name("vlc-hds-dl");
@@ -868,46 +887,45 @@ static void* download_thread( void* p )
 
     while( ! sys->closed )
     {
-        if( ! hds_stream->chunks_downloadpos )
+        chunk_t *chunk = next_download_chunk( hds_stream );
+        if( ! chunk )
         {
-            chunk_t* chunk = hds_stream->chunks_head;
-            while(chunk && chunk->data )
-            {
-                chunk = chunk->next;
-            }
-
-            if( chunk && ! chunk->data )
-                hds_stream->chunks_downloadpos = chunk;
+            vlc_cond_wait( & hds_stream->dl_cond,
+                           & hds_stream->dl_lock );
+            continue;
         }
 
-        while( hds_stream->chunks_downloadpos )
-        {
-            chunk_t *chunk = hds_stream->chunks_downloadpos;
-
-            uint8_t *data = download_chunk( (stream_t*)p_this,
-                                            sys,
-                                            hds_stream,
-                                            chunk );
+        /* Fragments are fetched in parallel, each by one thread, while the
+         * reader consumes them in order as soon as they are complete */
+        chunk->downloading = true;
+        if( hds_stream->chunks_downloadpos )
+            vlc_cond_signal( & hds_stream->dl_cond );
+        vlc_mutex_unlock( & hds_stream->dl_lock );
 
-            if( ! chunk->failed )
-            {
-                chunk->mdat_len =
-                    find_chunk_mdat( p_this,
-                                     data,
-                                     data + chunk->data_len,
-                                     & chunk->mdat_data );
-                if( chunk->mdat_len == 0 ) {
-                    chunk->mdat_len = chunk->data_len - (chunk->mdat_data - data);
-                }
-                hds_stream->chunks_downloadpos = chunk->next;
-                chunk->data = data;
+        uint8_t *data;
+        do
+            data = download_chunk( s, sys, hds_stream, chunk );
+        while( ! data && ! sys->closed );
 
-                sys->chunk_count++;
+        if( data )
+        {
+            chunk->mdat_len =
+                find_chunk_mdat( p_this,
+                                 data,
+                                 data + chunk->data_len,
+                                 & chunk->mdat_data );
+            if( chunk->mdat_len == 0 ) {
+                chunk->mdat_len = chunk->data_len - (chunk->mdat_data - data);
             }
         }
 
-        vlc_cond_wait( & hds_stream->dl_cond,
-                       & hds_stream->dl_lock );
+        vlc_mutex_lock( & hds_stream->dl_lock );
+        if( data )
+        {
+            chunk->data = data;
+            chunk->downloading = false;
+            sys->chunk_count++;
+        }
     }
 
     vlc_mutex_unlock( & hds_stream->dl_lock );
@@ -1685,7 +1703,13 @@ static int Open( vlc_object_t *p_this )
     s->pf_seek = NULL;
     s->pf_control = Control;
 
-    if( vlc_clone( &p_sys->dl_thread, download_thread, s ) )
+    for( unsigned i = 0; i < MAX_HDS_DOWNLOADS; i++ )
+    {
+        if( vlc_clone( &p_sys->dl_threads[i], download_thread, s ) )
+            break;
+        p_sys->dl_thread_count++;
+    }
+    if( p_sys->dl_thread_count == 0 )
     {
         goto error;
     }
@@ -1716,11 +1740,18 @@ static void Close( vlc_object_t *p_this )
     hds_stream_t *stream = vlc_array_count(&p_sys->hds_streams) ?
         p_sys->hds_streams.pp_elems[0] : NULL;
 
-    p_sys->closed = true;
     if (stream)
-        vlc_cond_signal( & stream->dl_cond );
+    {
+        vlc_mutex_lock( & stream->dl_lock );
+        p_sys->closed = true;
+        vlc_cond_broadcast( & stream->dl_cond );
+        vlc_mutex_unlock( & stream->dl_lock );
+    }
+    else
+        p_sys->closed = true;
 
-    vlc_join( p_sys->dl_thread, NULL );
+    for( unsigned i = 0; i < p_sys->dl_thread_count; i++ )
+        vlc_join( p_sys->dl_threads[i], NULL );
 
     if( p_sys->live )
     {
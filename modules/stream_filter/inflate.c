@@ -30,13 +30,92 @@
 #include <vlc_plugin.h>
 #include <vlc_stream.h>
 
+/* Distance in decompressed bytes between two seek access points */
+#define INFLATE_SPAN (4 << 20)
+#define INFLATE_WINDOW 32768
+
+/* State to resume decompression at a deflate block boundary */
+struct inflate_point
+{
+    uint64_t out; /* decompressed offset */
+    uint64_t in; /* offset of the first complete byte in the source */
+    int bits; /* bits of the previous byte still to be decoded */
+    unsigned window_len;
+    unsigned char window[INFLATE_WINDOW];
+};
+
 typedef struct
 {
     z_stream zstream;
     bool eof;
+    bool can_seek;
+    int bits; /* window bits of the stream header */
+    uint64_t offset; /* current decompressed offset */
+    uint64_t in_offset; /* source offset of the input buffer end */
+    uint64_t indexed; /* highest decompressed offset of the index */
+    struct inflate_point **points;
+    size_t point_count;
+    unsigned window_pos; /* write position in the circular window */
+    unsigned char window[INFLATE_WINDOW];
     unsigned char buffer[16384];
 } stream_sys_t;
 
+static void WindowAppend(stream_sys_t *sys, const unsigned char *p, size_t len)
+{
+    if (len >= INFLATE_WINDOW)
+    {
+        memcpy(sys->window, p + len - INFLATE_WINDOW, INFLATE_WINDOW);
+        sys->window_pos = 0;
+        return;
+    }
+
+    size_t head = INFLATE_WINDOW - sys->window_pos;
+    if (head > len)
+        head = len;
+    memcpy(sys->window + sys->window_pos, p, head);
+    memcpy(sys->window, p + head, len - head);
+    sys->window_pos = (sys->window_pos + len) % INFLATE_WINDOW;
+}
+
+static void AddPoint(stream_t *stream)
+{
+    stream_sys_t *sys = stream->p_sys;
+    struct inflate_point *pt = malloc(sizeof (*pt));
+    if (unlikely(pt == NULL))
+        return;
+
+    struct inflate_point **tab = realloc(sys->points,
+                                 (sys->point_count + 1) * sizeof (*tab));
+    if (unlikely(tab == NULL))
+    {
+        free(pt);
+        return;
+    }
+    sys->points = tab;
+
+    pt->out = sys->offset;
+    pt->in = sys->in_offset - sys->zstream.avail_in;
+    pt->bits = sys->zstream.data_type & 7;
+
+    if (sys->offset >= INFLATE_WINDOW)
+    {   /* Linearize the circular window */
+        size_t tail = INFLATE_WINDOW - sys->window_pos;
+
+        memcpy(pt->window, sys->window + sys->window_pos, tail);
+        memcpy(pt->window + tail, sys->window, sys->window_pos);
+        pt->window_len = INFLATE_WINDOW;
+    }
+    else
+    {
+        memcpy(pt->window, sys->window, sys->offset);
+        pt->window_len = sys->offset;
+    }
+
+    tab[sys->point_count++] = pt;
+    msg_Dbg(stream, "seek point %zu at %"PRIu64" (source %"PRIu64")",
+            sys->point_count, pt->out, pt->in);
+}
+
 static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -48,63 +127,183 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
     sys->zstream.next_out = buf;
     sys->zstream.avail_out = buflen;
 
-    if (sys->zstream.avail_in == 0)
-        sys->zstream.next_in = sys->buffer;
+    /* Stop at each block boundary so that seek points can be recorded, but
+     * do not return before some data was output: zero would mean EOF. */
+    while (sys->zstream.avail_out == buflen)
+    {
+        if (sys->zstream.avail_in == 0)
+            sys->zstream.next_in = sys->buffer;
 
-    val = (sys->buffer + sizeof (sys->buffer))
-        - (sys->zstream.next_in + sys->zstream.avail_in);
+        val = (sys->buffer + sizeof (sys->buffer))
+            - (sys->zstream.next_in + sys->zstream.avail_in);
 
-    if (val > 0)
-    {   /* Fill input buffer if there is space left */
-        val = vlc_stream_Read(stream->s,
+        if (val > 0)
+        {   /* Fill input buffer if there is space left */
+            val = vlc_stream_Read(stream->s,
                           sys->zstream.next_in + sys->zstream.avail_in, val);
-        if (val >= 0)
-            sys->zstream.avail_in += val;
+            if (val >= 0)
+            {
+                sys->zstream.avail_in += val;
+                sys->in_offset += val;
+            }
+        }
+
+        if (sys->zstream.avail_in == 0)
+        {
+            msg_Err(stream, "unexpected end of stream");
+            return 0;
+        }
+
+        unsigned char *out = sys->zstream.next_out;
+
+        val = inflate(&sys->zstream, Z_BLOCK);
+
+        size_t len = sys->zstream.next_out - out;
+        if (len > 0)
+        {
+            WindowAppend(sys, out, len);
+            sys->offset += len;
+        }
+
+        switch (val)
+        {
+            case Z_STREAM_END:
+                msg_Dbg(stream, "end of stream");
+                sys->eof = true;
+                return buflen - sys->zstream.avail_out;
+            case Z_OK:
+                /* At the end of a block that is not the last one */
+                if ((sys->zstream.data_type & 0xC0) == 0x80
+                 && sys->can_seek && sys->offset > sys->indexed
+                 && sys->offset - sys->indexed >= INFLATE_SPAN)
+                {
+                    AddPoint(stream);
+                    sys->indexed = sys->offset;
+                }
+                continue;
+            case Z_DATA_ERROR:
+                msg_Err(stream, "corrupt stream");
+                sys->eof = true;
+                return -1;
+            case Z_BUF_ERROR:
+                if (sys->zstream.next_in == sys->buffer)
+                    break;
+
+                memmove(sys->buffer, sys->zstream.next_in,
+                        sys->zstream.avail_in);
+                sys->zstream.next_in = sys->buffer;
+                continue;
+        }
+
+        msg_Err(stream, "unhandled decompression error (%zd)", val);
+        return -1;
     }
 
-    if (sys->zstream.avail_in == 0)
-    {
-        msg_Err(stream, "unexpected end of stream");
+    return buflen - sys->zstream.avail_out;
+}
+
+static int Restart(stream_t *stream, const struct inflate_point *pt)
+{
+    stream_sys_t *sys = stream->p_sys;
+    uint64_t in = (pt != NULL) ? pt->in - (pt->bits ? 1 : 0) : 0;
+
+    if (vlc_stream_Seek(stream->s, in))
+        return -1;
+
+    sys->zstream.next_in = sys->buffer;
+    sys->zstream.avail_in = 0;
+    sys->in_offset = in;
+    sys->eof = false;
+
+    if (pt == NULL)
+    {   /* Back to the stream header */
+        if (inflateReset2(&sys->zstream, sys->bits) != Z_OK)
+            return -1;
+        sys->offset = 0;
+        sys->window_pos = 0;
         return 0;
     }
 
-    val = inflate(&sys->zstream, Z_SYNC_FLUSH);
-    switch (val)
+    /* Resume as raw deflate in the middle of the stream */
+    if (inflateReset2(&sys->zstream, -15) != Z_OK)
+        return -1;
+
+    if (pt->bits)
     {
-        case Z_STREAM_END:
-            msg_Dbg(stream, "end of stream");
-            sys->eof = true;
-            /* fall through */
-        case Z_OK:
-            return buflen - sys->zstream.avail_out;
-        case Z_DATA_ERROR:
-            msg_Err(stream, "corrupt stream");
-            sys->eof = true;
-            return -1;
-        case Z_BUF_ERROR:
-            if (sys->zstream.next_in == sys->buffer)
-                break;
+        uint8_t c;
 
-            memmove(sys->buffer, sys->zstream.next_in, sys->zstream.avail_in);
-            sys->zstream.next_in = sys->buffer;
-            return Read(stream, buf, buflen);
+        if (vlc_stream_Read(stream->s, &c, 1) < 1)
+            return -1;
+        sys->in_offset++;
+        inflatePrime(&sys->zstream, pt->bits, c >> (8 - pt->bits));
     }
 
-    msg_Err(stream, "unhandled decompression error (%zd)", val);
-    return -1;
+    if (inflateSetDictionary(&sys->zstream, pt->window,
+                             pt->window_len) != Z_OK)
+        return -1;
+
+    sys->offset = pt->out;
+    sys->window_pos = 0;
+    WindowAppend(sys, pt->window, pt->window_len);
+    return 0;
 }
 
 static int Seek(stream_t *stream, uint64_t offset)
 {
-    (void) stream; (void) offset;
-    return -1;
+    stream_sys_t *sys = stream->p_sys;
+
+    if (!sys->can_seek)
+        return -1;
+
+    /* Find the closest seek point before the target */
+    const struct inflate_point *pt = NULL;
+    size_t lo = 0, hi = sys->point_count;
+
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+
+        if (sys->points[mid]->out <= offset)
+        {
+            pt = sys->points[mid];
+            lo = mid + 1;
+        }
+        else
+            hi = mid;
+    }
+
+    /* Rewind if needed, or jump forward if a seek point is ahead */
+    if (offset < sys->offset || (pt != NULL && pt->out > sys->offset))
+    {
+        if (Restart(stream, pt))
+        {
+            msg_Err(stream, "cannot restart decompression");
+            sys->eof = true;
+            return -1;
+        }
+    }
+
+    while (sys->offset < offset)
+    {
+        unsigned char dummy[8192];
+        uint64_t len = offset - sys->offset;
+        ssize_t val = Read(stream, dummy,
+                           len < sizeof (dummy) ? len : sizeof (dummy));
+        if (val <= 0)
+            return -1;
+    }
+    return 0;
 }
 
 static int Control(stream_t *stream, int query, va_list args)
 {
+    stream_sys_t *sys = stream->p_sys;
+
     switch (query)
     {
         case STREAM_CAN_SEEK:
+            *va_arg(args, bool *) = sys->can_seek;
+            break;
         case STREAM_CAN_FASTSEEK:
             *va_arg(args, bool *) = false;
             break;
@@ -125,6 +324,7 @@ static int Control(stream_t *stream, int query, va_list args)
         case STREAM_SET_PRIVATE_ID_STATE:
         case STREAM_SET_PRIVATE_ID_CA:
         case STREAM_GET_PRIVATE_ID_STATE:
+        case STREAM_SET_READ_HINT:
             return VLC_EGENERIC;
         default:
             msg_Err(stream, "unimplemented query (%d) in control", query);
@@ -161,6 +361,18 @@ static int Open(vlc_object_t *obj)
     sys->zstream.zfree = Z_NULL;
     sys->zstream.opaque = Z_NULL;
     sys->eof = false;
+    sys->bits = bits;
+    sys->offset = 0;
+    sys->in_offset = 0;
+    sys->indexed = 0;
+    sys->points = NULL;
+    sys->point_count = 0;
+    sys->window_pos = 0;
+
+    /* Seeking restarts from the beginning or from a seek point */
+    if (vlc_stream_Tell(stream->s) != 0
+     || vlc_stream_Control(stream->s, STREAM_CAN_SEEK, &sys->can_seek))
+        sys->can_seek = false;
 
     int ret = inflateInit2(&sys->zstream, bits);
     if (ret != Z_OK)
@@ -182,6 +394,9 @@ static void Close (vlc_object_t *obj)
     stream_sys_t *sys = stream->p_sys;
 
     inflateEnd(&sys->zstream);
+    for (size_t i = 0; i < sys->point_count; i++)
+        free(sys->points[i]);
+    free(sys->points);
     free(sys);
 }
 
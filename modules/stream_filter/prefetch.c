@@ -46,6 +46,11 @@ struct stream_ctrl
             int id;
             bool state;
         } id_state;
+        struct
+        {
+            uint64_t offset;
+            uint64_t length;
+        } hint;
     };
 };
 
@@ -74,6 +79,8 @@ typedef struct
     size_t       buffer_size;
     char        *buffer;
     size_t       seek_threshold;
+    uint64_t     hint_offset; /* range hinted by STREAM_SET_READ_HINT */
+    uint64_t     hint_end;
 
     struct stream_ctrl *controls;
 } stream_sys_t;
@@ -141,8 +148,12 @@ static void *Thread(void *data)
         if (unlikely(ctrl != NULL))
         {
             sys->controls = ctrl->next;
-            ThreadControl(stream, ctrl->query, ctrl->id_state.id,
-                          ctrl->id_state.state);
+            if (ctrl->query == STREAM_SET_READ_HINT)
+                ThreadControl(stream, ctrl->query, ctrl->hint.offset,
+                              ctrl->hint.length);
+            else
+                ThreadControl(stream, ctrl->query, ctrl->id_state.id,
+                              ctrl->id_state.state);
             free(ctrl);
             continue;
         }
@@ -238,8 +249,21 @@ static void *Thread(void *data)
             sys->buffer_length -= len;
         }
 
-        size_t offset = (sys->buffer_offset + sys->buffer_length)
-                        % sys->buffer_size;
+        /* Do not read ahead past the end of the hinted range, until the
+         * reader gets there (or goes elsewhere). */
+        uint64_t buffer_end = sys->buffer_offset + sys->buffer_length;
+        if (stream_offset >= sys->hint_offset && stream_offset < sys->hint_end)
+        {
+            if (buffer_end >= sys->hint_end)
+            {
+                vlc_cond_wait(&sys->wait_space, &sys->lock);
+                continue;
+            }
+            if (len > sys->hint_end - buffer_end)
+                len = sys->hint_end - buffer_end;
+        }
+
+        size_t offset = buffer_end % sys->buffer_size;
          /* Do not step past the sharp edge of the circular buffer */
         if (offset + len > sys->buffer_size)
             len = sys->buffer_size - offset;
@@ -412,6 +436,26 @@ static int Control(stream_t *stream, int query, va_list args)
             vlc_mutex_unlock(&sys->lock);
             break;
         }
+        case STREAM_SET_READ_HINT:
+        {
+            struct stream_ctrl *ctrl = malloc(sizeof (*ctrl)), **pp;
+            if (unlikely(ctrl == NULL))
+                return VLC_ENOMEM;
+
+            ctrl->next = NULL;
+            ctrl->query = query;
+            ctrl->hint.offset = va_arg(args, uint64_t);
+            ctrl->hint.length = va_arg(args, uint64_t);
+            vlc_mutex_lock(&sys->lock);
+            sys->hint_offset = ctrl->hint.offset;
+            sys->hint_end = ctrl->hint.length < UINT64_MAX - ctrl->hint.offset
+                          ? ctrl->hint.offset + ctrl->hint.length : UINT64_MAX;
+            for (pp = &sys->controls; *pp != NULL; pp = &((*pp)->next));
+            *pp = ctrl;
+            vlc_cond_signal(&sys->wait_space);
+            vlc_mutex_unlock(&sys->lock);
+            break;
+        }
         case STREAM_SET_PRIVATE_ID_CA:
         case STREAM_GET_PRIVATE_ID_STATE:
             return VLC_EGENERIC;
@@ -467,6 +511,8 @@ static int Open(vlc_object_t *obj)
     sys->buffer_length = 0;
     sys->buffer_size = var_InheritInteger(obj, "prefetch-buffer-size") << 10u;
     sys->seek_threshold = var_InheritInteger(obj, "prefetch-seek-threshold");
+    sys->hint_offset = 0;
+    sys->hint_end = 0;
     sys->controls = NULL;
 
     uint64_t size = stream_Size(stream->s);
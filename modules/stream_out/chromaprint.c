@@ -61,7 +61,7 @@ vlc_module_begin ()
     set_capability( "sout output", 0 )
     add_shortcut( "chromaprint" )
     set_subcategory( SUBCAT_SOUT_STREAM )
-    add_integer( "duration", 90, DURATION_TEXT, DURATION_LONGTEXT )
+    add_integer( "duration", CHROMAPRINT_DEFAULT_DURATION, DURATION_TEXT, DURATION_LONGTEXT )
     set_callbacks( Open, Close )
 vlc_module_end ()
 
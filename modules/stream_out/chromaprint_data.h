@@ -25,3 +25,6 @@ struct chromaprint_fingerprint_t
 };
 
 typedef struct chromaprint_fingerprint_t chromaprint_fingerprint_t;
+
+/* Default length of the fingerprinted audio, in seconds */
+#define CHROMAPRINT_DEFAULT_DURATION 90
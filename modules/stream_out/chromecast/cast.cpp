@@ -399,8 +399,9 @@ void sout_access_out_sys_t::putCopy(block_t *p_block)
         assert(m_copy_size == 0);
         m_copy_last = &m_copy_chain;
     }
+    for (block_t *p_cur = p_block; p_cur != NULL; p_cur = p_cur->p_next)
+        m_copy_size += p_cur->i_buffer;
     block_ChainLastAppend(&m_copy_last, p_block);
-    m_copy_size += p_block->i_buffer;
 }
 
 void sout_access_out_sys_t::restoreCopy()
@@ -472,7 +473,10 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
     while (m_client && vlc_fifo_GetBytes(m_fifo) < i_min_buffer && !m_eof)
         vlc_fifo_Wait(m_fifo);
 
-    block_t *p_block = NULL;
+    /* Gather the blocks to send: they are copied once, directly into the
+     * answer body, and the chain is kept as is for the copy */
+    block_t *p_chain = NULL;
+    size_t i_chain_size = 0;
     if (m_client && vlc_fifo_GetBytes(m_fifo) > 0)
     {
         /* if less data is available, then we must be EOF */
@@ -481,31 +485,16 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
             assert(m_eof);
             i_min_buffer = vlc_fifo_GetBytes(m_fifo);
         }
-        block_t *p_first = vlc_fifo_DequeueUnlocked(m_fifo);
 
-        assert(p_first);
-        size_t i_total_size = p_first->i_buffer;
-        block_t *p_next = NULL, *p_cur = p_first;
-
-        while (i_total_size < i_min_buffer)
+        block_t **pp_last = &p_chain;
+        while (i_chain_size < i_min_buffer)
         {
-            p_next = vlc_fifo_DequeueUnlocked(m_fifo);
+            block_t *p_next = vlc_fifo_DequeueUnlocked(m_fifo);
             assert(p_next);
-            i_total_size += p_next->i_buffer;
-            p_cur->p_next = p_next;
-            p_cur = p_cur->p_next;
+            i_chain_size += p_next->i_buffer;
+            *pp_last = p_next;
+            pp_last = &p_next->p_next;
         }
-        assert(i_total_size >= i_min_buffer);
-
-        if (p_next != NULL)
-        {
-            p_block = block_Alloc(i_total_size);
-            if (p_block)
-                block_ChainExtract(p_first, p_block->p_buffer, p_block->i_buffer);
-            block_ChainRelease(p_first);
-        }
-        else
-            p_block = p_first;
 
         if (vlc_fifo_GetBytes(m_fifo) < HTTPD_BUFFER_PACE)
             m_intf->setPacing(false);
@@ -516,7 +505,7 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
     answer->i_type   = HTTPD_MSG_ANSWER;
     answer->i_status = 200;
 
-    if (p_block)
+    if (p_chain)
     {
         if (answer->i_body_offset == 0)
         {
@@ -526,7 +515,7 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
         }
 
         const bool send_header = answer->i_body_offset == 0 && m_header != NULL;
-        size_t i_answer_size = p_block->i_buffer;
+        size_t i_answer_size = i_chain_size;
         if (send_header)
             i_answer_size += m_header->i_buffer;
 
@@ -541,10 +530,11 @@ int sout_access_out_sys_t::url_cb(httpd_client_t *cl, httpd_message_t *answer,
                 memcpy(answer->p_body, m_header->p_buffer, m_header->i_buffer);
                 i_block_offset = m_header->i_buffer;
             }
-            memcpy(&answer->p_body[i_block_offset], p_block->p_buffer, p_block->i_buffer);
+            block_ChainExtract(p_chain, &answer->p_body[i_block_offset],
+                               i_chain_size);
         }
 
-        putCopy(p_block);
+        putCopy(p_chain);
     }
     if (!answer->i_body)
         httpd_MsgAdd(answer, "Connection", "close");
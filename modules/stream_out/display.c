@@ -164,7 +164,9 @@ static int Send( sout_stream_t *p_stream, void *id, vlc_frame_t *frames )
 
         frames->p_next = NULL;
 
-        if( id != NULL && frames->i_buffer > 0 )
+        /* The decoders may write to their input */
+        if( id != NULL && frames->i_buffer > 0
+         && (frames = vlc_frame_Writable( frames )) != NULL )
             vlc_input_decoder_Decode( id_sys->dec, frames, false );
 
         frames = p_next;
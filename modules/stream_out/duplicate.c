@@ -28,6 +28,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_sout.h>
@@ -67,10 +69,23 @@ typedef struct
 
     int             i_nb_select;
     char            **ppsz_select;
+
+    /* Branch description ("key chain") of the streams attached through the
+     * hub, NULL for the static dst ones */
+    int             i_nb_branches;
+    char            **ppsz_branches;
+
+    /* Live ES, replayed on the branches attached later on */
+    int             i_nb_ids;
+    void            **pp_ids;
+
+    char            *psz_hub;
+    vlc_mutex_t     lock;
 } sout_stream_sys_t;
 
 typedef struct
 {
+    es_format_t         fmt;
     int                 i_nb_ids;
     void                **pp_ids;
 } sout_stream_id_sys_t;
@@ -92,12 +107,14 @@ static int Control( sout_stream_t *p_stream, int i_query, va_list args )
         {
             sout_stream_id_sys_t *id = va_arg(args, void *);
             void *spu_hl = va_arg(args, void *);
+            vlc_mutex_lock( &p_sys->lock );
             for( int i = 0; i < id->i_nb_ids; i++ )
             {
                 if( id->pp_ids[i] )
                     sout_StreamControl( p_sys->pp_streams[i], i_query,
                                         id->pp_ids[i], spu_hl );
             }
+            vlc_mutex_unlock( &p_sys->lock );
             return VLC_SUCCESS;
         }
     }
@@ -109,6 +126,140 @@ static const struct sout_stream_operations ops = {
     Add, Del, Send, Control, NULL, SetPCR,
 };
 
+/*****************************************************************************
+ * Hub:
+ *****************************************************************************/
+/* With hub=<name>, the branch list is read from the <name> variable of the
+ * libvlc instance: one branch per line, a key without spaces followed by the
+ * branch chain. When it changes, the branches gone from the list are closed
+ * and the new ones are opened and fed with the running ES, so that outputs
+ * come and go without touching the input. */
+static void HubDetach( sout_stream_t *p_stream, int i_stream )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    sout_stream_t *out = p_sys->pp_streams[i_stream];
+
+    msg_Dbg( p_stream, " * detaching `%s'", p_sys->ppsz_branches[i_stream] );
+    for( int i = 0; i < p_sys->i_nb_ids; i++ )
+    {
+        sout_stream_id_sys_t *id = p_sys->pp_ids[i];
+
+        if( id->pp_ids[i_stream] )
+            sout_StreamIdDel( out, id->pp_ids[i_stream] );
+        TAB_ERASE( id->i_nb_ids, id->pp_ids, i_stream );
+    }
+    sout_StreamChainDelete( out, p_stream->p_next );
+
+    free( p_sys->ppsz_select[i_stream] );
+    free( p_sys->ppsz_branches[i_stream] );
+    TAB_ERASE( p_sys->i_nb_streams, p_sys->pp_streams, i_stream );
+    TAB_ERASE( p_sys->i_nb_select, p_sys->ppsz_select, i_stream );
+    TAB_ERASE( p_sys->i_nb_branches, p_sys->ppsz_branches, i_stream );
+}
+
+static void HubAttach( sout_stream_t *p_stream, const char *psz_branch )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    const char *psz_chain = strchr( psz_branch, ' ' );
+
+    if( psz_chain == NULL )
+    {
+        msg_Err( p_stream, " * ignore invalid branch `%s'", psz_branch );
+        return;
+    }
+    psz_chain += strspn( psz_chain, " " );
+
+    msg_Dbg( p_stream, " * attaching `%s'", psz_chain );
+    sout_stream_t *out = sout_StreamChainNew( VLC_OBJECT(p_stream), psz_chain,
+                                              p_stream->p_next );
+    char *psz_dup = strdup( psz_branch );
+    if( out == NULL || psz_dup == NULL )
+    {
+        msg_Err( p_stream, "cannot attach `%s'", psz_chain );
+        if( out != NULL )
+            sout_StreamChainDelete( out, p_stream->p_next );
+        free( psz_dup );
+        return;
+    }
+
+    TAB_APPEND( p_sys->i_nb_streams, p_sys->pp_streams, out );
+    TAB_APPEND( p_sys->i_nb_select, p_sys->ppsz_select, NULL );
+    TAB_APPEND( p_sys->i_nb_branches, p_sys->ppsz_branches, psz_dup );
+
+    for( int i = 0; i < p_sys->i_nb_ids; i++ )
+    {
+        sout_stream_id_sys_t *id = p_sys->pp_ids[i];
+        void *id_new = sout_StreamIdAdd( out, &id->fmt );
+
+        TAB_APPEND( id->i_nb_ids, id->pp_ids, id_new );
+    }
+}
+
+static bool HubListed( const char *psz_list, const char *psz_branch )
+{
+    size_t i_len = strlen( psz_branch );
+
+    for( const char *psz = psz_list; psz != NULL; psz = strchr( psz, '\n' ) )
+    {
+        if( *psz == '\n' )
+            psz++;
+        if( !strncmp( psz, psz_branch, i_len )
+         && ( psz[i_len] == '\n' || psz[i_len] == '\0' ) )
+            return true;
+    }
+    return false;
+}
+
+static void HubUpdate( sout_stream_t *p_stream, const char *psz_list )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    if( psz_list == NULL )
+        psz_list = "";
+
+    for( int i = p_sys->i_nb_branches - 1; i >= 0; i-- )
+    {
+        if( p_sys->ppsz_branches[i] != NULL
+         && !HubListed( psz_list, p_sys->ppsz_branches[i] ) )
+            HubDetach( p_stream, i );
+    }
+
+    char *psz_dup = strdup( psz_list );
+    if( psz_dup == NULL )
+        return;
+
+    char *psz_save;
+    for( char *psz_branch = strtok_r( psz_dup, "\n", &psz_save );
+         psz_branch != NULL; psz_branch = strtok_r( NULL, "\n", &psz_save ) )
+    {
+        int i;
+        for( i = 0; i < p_sys->i_nb_branches; i++ )
+            if( p_sys->ppsz_branches[i] != NULL
+             && !strcmp( p_sys->ppsz_branches[i], psz_branch ) )
+                break;
+        if( i == p_sys->i_nb_branches )
+            HubAttach( p_stream, psz_branch );
+    }
+    free( psz_dup );
+}
+
+static int HubChanged( vlc_object_t *p_this, const char *psz_var,
+                       vlc_value_t oldval, vlc_value_t newval, void *p_data )
+{
+    sout_stream_t *p_stream = p_data;
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    VLC_UNUSED(oldval); VLC_UNUSED(newval);
+
+    /* Apply the current value rather than newval, so that racing updates
+     * converge on the last one */
+    vlc_mutex_lock( &p_sys->lock );
+    char *psz_list = var_GetString( p_this, psz_var );
+    HubUpdate( p_stream, psz_list );
+    vlc_mutex_unlock( &p_sys->lock );
+    free( psz_list );
+    return VLC_SUCCESS;
+}
+
 /*****************************************************************************
  * Open:
  *****************************************************************************/
@@ -126,6 +277,10 @@ static int Open( vlc_object_t *p_this )
 
     TAB_INIT( p_sys->i_nb_streams, p_sys->pp_streams );
     TAB_INIT( p_sys->i_nb_select, p_sys->ppsz_select );
+    TAB_INIT( p_sys->i_nb_branches, p_sys->ppsz_branches );
+    TAB_INIT( p_sys->i_nb_ids, p_sys->pp_ids );
+    p_sys->psz_hub = NULL;
+    vlc_mutex_init( &p_sys->lock );
 
     char **ppsz_select = NULL;
 
@@ -143,6 +298,7 @@ static int Open( vlc_object_t *p_this )
             {
                 TAB_APPEND( p_sys->i_nb_streams, p_sys->pp_streams, s );
                 TAB_APPEND( p_sys->i_nb_select,  p_sys->ppsz_select, NULL );
+                TAB_APPEND( p_sys->i_nb_branches, p_sys->ppsz_branches, NULL );
                 ppsz_select = &p_sys->ppsz_select[p_sys->i_nb_select - 1];
             }
         }
@@ -164,13 +320,20 @@ static int Open( vlc_object_t *p_this )
                 }
             }
         }
+        else if( !strcmp( p_cfg->psz_name, "hub" ) )
+        {
+            free( p_sys->psz_hub );
+            p_sys->psz_hub = NULL;
+            if( p_cfg->psz_value && *p_cfg->psz_value )
+                p_sys->psz_hub = strdup( p_cfg->psz_value );
+        }
         else
         {
             msg_Err( p_stream, " * ignore unknown option `%s'", p_cfg->psz_name );
         }
     }
 
-    if( p_sys->i_nb_streams == 0 )
+    if( p_sys->i_nb_streams == 0 && p_sys->psz_hub == NULL )
     {
         msg_Err( p_stream, "no destination given" );
         free( p_sys );
@@ -180,6 +343,21 @@ static int Open( vlc_object_t *p_this )
 
     p_stream->p_sys = p_sys;
     p_stream->ops = &ops;
+
+    if( p_sys->psz_hub != NULL )
+    {
+        vlc_object_t *vlc = VLC_OBJECT(vlc_object_instance(p_stream));
+
+        msg_Dbg( p_stream, " * publishing hub `%s'", p_sys->psz_hub );
+        var_Create( vlc, p_sys->psz_hub, VLC_VAR_STRING );
+        var_AddCallback( vlc, p_sys->psz_hub, HubChanged, p_stream );
+
+        vlc_mutex_lock( &p_sys->lock );
+        char *psz_list = var_GetString( vlc, p_sys->psz_hub );
+        HubUpdate( p_stream, psz_list );
+        vlc_mutex_unlock( &p_sys->lock );
+        free( psz_list );
+    }
     return VLC_SUCCESS;
 }
 
@@ -192,13 +370,25 @@ static void Close( vlc_object_t * p_this )
     sout_stream_sys_t *p_sys = p_stream->p_sys;
 
     msg_Dbg( p_stream, "closing a duplication" );
+    if( p_sys->psz_hub != NULL )
+    {
+        vlc_object_t *vlc = VLC_OBJECT(vlc_object_instance(p_stream));
+
+        var_DelCallback( vlc, p_sys->psz_hub, HubChanged, p_stream );
+        var_Destroy( vlc, p_sys->psz_hub );
+        free( p_sys->psz_hub );
+    }
+
+    assert( p_sys->i_nb_ids == 0 );
     for( int i = 0; i < p_sys->i_nb_streams; i++ )
     {
         sout_StreamChainDelete(p_sys->pp_streams[i], p_stream->p_next);
         free( p_sys->ppsz_select[i] );
+        free( p_sys->ppsz_branches[i] );
     }
     free( p_sys->pp_streams );
     free( p_sys->ppsz_select );
+    free( p_sys->ppsz_branches );
 
     free( p_sys );
 }
@@ -206,6 +396,24 @@ static void Close( vlc_object_t * p_this )
 /*****************************************************************************
  * Add:
  *****************************************************************************/
+static void DelLocked( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    for( int i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
+    {
+        if( id->pp_ids[i_stream] )
+        {
+            sout_stream_t *out = p_sys->pp_streams[i_stream];
+            sout_StreamIdDel( out, id->pp_ids[i_stream] );
+        }
+    }
+
+    free( id->pp_ids );
+    es_format_Clean( &id->fmt );
+    free( id );
+}
+
 static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
@@ -216,11 +424,17 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
     if( !id )
         return NULL;
 
+    if( es_format_Copy( &id->fmt, p_fmt ) != VLC_SUCCESS )
+    {
+        free( id );
+        return NULL;
+    }
     TAB_INIT( id->i_nb_ids, id->pp_ids );
 
     msg_Dbg( p_stream, "duplicated a new stream codec=%4.4s (es=%d group=%d)",
              (char*)&p_fmt->i_codec, p_fmt->i_id, p_fmt->i_group );
 
+    vlc_mutex_lock( &p_sys->lock );
     for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
     {
         void *id_new = NULL;
@@ -251,11 +465,15 @@ static void *Add( sout_stream_t *p_stream, const es_format_t *p_fmt )
         TAB_APPEND( id->i_nb_ids, id->pp_ids, id_new );
     }
 
-    if( i_valid_streams <= 0 )
+    /* A hub keeps the ES even without outputs, for the branches to come */
+    if( i_valid_streams <= 0 && p_sys->psz_hub == NULL )
     {
-        Del( p_stream, id );
-        return NULL;
+        DelLocked( p_stream, id );
+        id = NULL;
     }
+    else
+        TAB_APPEND( p_sys->i_nb_ids, p_sys->pp_ids, id );
+    vlc_mutex_unlock( &p_sys->lock );
 
     return id;
 }
@@ -267,19 +485,11 @@ static void Del( sout_stream_t *p_stream, void *_id )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
-    int               i_stream;
 
-    for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
-    {
-        if( id->pp_ids[i_stream] )
-        {
-            sout_stream_t *out = p_sys->pp_streams[i_stream];
-            sout_StreamIdDel( out, id->pp_ids[i_stream] );
-        }
-    }
-
-    free( id->pp_ids );
-    free( id );
+    vlc_mutex_lock( &p_sys->lock );
+    TAB_REMOVE( p_sys->i_nb_ids, p_sys->pp_ids, id );
+    DelLocked( p_stream, id );
+    vlc_mutex_unlock( &p_sys->lock );
 }
 
 /*****************************************************************************
@@ -291,6 +501,12 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
     sout_stream_t     *p_dup_stream;
     int               i_stream;
+    int               i_outputs = 0;
+
+    vlc_mutex_lock( &p_sys->lock );
+    for( i_stream = 0; i_stream < p_sys->i_nb_streams; i_stream++ )
+        if( id->pp_ids[i_stream] )
+            i_outputs++;
 
     /* Loop through the linked list of buffers */
     while( p_buffer )
@@ -299,13 +515,24 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 
         p_buffer->p_next = NULL;
 
+        /* The outputs share the payload, those writing to it copy it */
+        if( i_outputs > 1 )
+        {
+            p_buffer = block_MakeShared( p_buffer );
+            if( unlikely(p_buffer == NULL) )
+            {
+                p_buffer = p_next;
+                continue;
+            }
+        }
+
         for( i_stream = 0; i_stream < p_sys->i_nb_streams - 1; i_stream++ )
         {
             p_dup_stream = p_sys->pp_streams[i_stream];
 
             if( id->pp_ids[i_stream] )
             {
-                block_t *p_dup = block_Duplicate( p_buffer );
+                block_t *p_dup = block_Share( p_buffer );
 
                 if( p_dup )
                     sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_dup );
@@ -324,6 +551,7 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 
         p_buffer = p_next;
     }
+    vlc_mutex_unlock( &p_sys->lock );
     return VLC_SUCCESS;
 }
 
@@ -331,10 +559,12 @@ static void SetPCR( sout_stream_t *stream, vlc_tick_t pcr )
 {
     sout_stream_sys_t *sys = stream->p_sys;
 
+    vlc_mutex_lock( &sys->lock );
     for ( int i = 0; i < sys->i_nb_streams; ++i )
     {
         sout_StreamSetPCR( sys->pp_streams[i], pcr );
     }
+    vlc_mutex_unlock( &sys->lock );
 }
 
 /*****************************************************************************
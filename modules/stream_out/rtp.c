@@ -1324,6 +1324,34 @@ static int  HttpCallback( httpd_file_sys_t *p_args,
 /****************************************************************************
  * RTP send
  ****************************************************************************/
+/* Maximum number of packets sent with a single system call */
+#define RTP_BATCH 64
+
+/**
+ * Sends packets on a socket.
+ * @return the number of packets sent, or -1 if the first one failed
+ */
+static int SendBatch( int fd, block_t *const *pkts, unsigned count )
+{
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr msgs[RTP_BATCH];
+    struct iovec iov[RTP_BATCH];
+
+    for( unsigned i = 0; i < count; i++ )
+    {
+        iov[i].iov_base = pkts[i]->p_buffer;
+        iov[i].iov_len = pkts[i]->i_buffer;
+        msgs[i].msg_hdr = (struct msghdr) { .msg_iov = &iov[i], .msg_iovlen = 1 };
+    }
+    return sendmmsg( fd, msgs, count, 0 );
+#else
+    for( unsigned i = 0; i < count; i++ )
+        if( send( fd, pkts[i]->p_buffer, pkts[i]->i_buffer, 0 ) == -1 )
+            return i ? (int)i : -1;
+    return count;
+#endif
+}
+
 static void* ThreadSend( void *data )
 {
     vlc_thread_set_name("vlc-rt-send");
@@ -1338,31 +1366,66 @@ static void* ThreadSend( void *data )
 #endif
     sout_stream_id_sys_t *id = data;
     vlc_tick_t i_caching = id->i_caching;
-    block_t *out;
+    block_t *next = NULL; /* dequeued, not due yet */
 
-    while ((out = vlc_queue_DequeueKillable(&id->queue, &id->dead)) != NULL)
+    for( ;; )
     {
+        block_t *batch[RTP_BATCH];
+        unsigned count = 0;
+
+        if( next == NULL )
+            next = vlc_queue_DequeueKillable(&id->queue, &id->dead);
+        if( next == NULL )
+            break;
+
+        vlc_tick_wait (next->i_dts + i_caching);
+
+        /* The packets already due are sent together: this does not change
+         * the pacing, and saves system calls when the sender lags behind or
+         * when the packetizer gives several packets the same date. */
+        vlc_tick_t now = vlc_tick_now();
+        vlc_queue_Lock(&id->queue);
+        do
+        {
+            batch[count++] = next;
+            next = NULL;
+            if( count == RTP_BATCH )
+                break;
+            next = vlc_queue_DequeueUnlocked(&id->queue);
+        }
+        while( next != NULL && next->i_dts + i_caching <= now );
+        vlc_queue_Unlock(&id->queue);
+
 #ifdef HAVE_SRTP
         if( id->srtp )
         {   /* FIXME: this is awfully inefficient */
-            size_t len = out->i_buffer;
-            out = block_Realloc( out, 0, len + 10 );
-            out->i_buffer = len;
+            unsigned protected = 0;
 
-            int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
-            if( val )
+            for( unsigned i = 0; i < count; i++ )
             {
-                msg_Dbg( id->p_stream, "SRTP sending error: %s",
-                         vlc_strerror_c(val) );
-                block_Release( out );
-                continue;
+                block_t *out = batch[i];
+                size_t len = out->i_buffer;
+                out = block_Realloc( out, 0, len + 10 );
+                if( unlikely(out == NULL) )
+                    continue;
+                out->i_buffer = len;
+
+                int val = srtp_send( id->srtp, out->p_buffer, &len, len + 10 );
+                if( val )
+                {
+                    msg_Dbg( id->p_stream, "SRTP sending error: %s",
+                             vlc_strerror_c(val) );
+                    block_Release( out );
+                    continue;
+                }
+                out->i_buffer = len;
+                batch[protected++] = out;
             }
-            out->i_buffer = len;
+            count = protected;
+            if( count == 0 )
+                continue;
         }
 #endif
-        vlc_tick_wait (out->i_dts + i_caching);
-
-        ssize_t len = out->i_buffer;
 
         vlc_mutex_lock( &id->lock_sink );
         unsigned deadc = 0; /* How many dead sockets? */
@@ -1373,26 +1436,43 @@ static void* ThreadSend( void *data )
 #ifdef HAVE_SRTP
             if( !id->srtp ) /* FIXME: SRTCP support */
 #endif
-                SendRTCP( id->sinkv[i].rtcp, out );
+                for( unsigned j = 0; j < count; j++ )
+                    SendRTCP( id->sinkv[i].rtcp, batch[j] );
 
-            if( send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 ) == -1
-             && net_errno != EAGAIN && net_errno != EWOULDBLOCK
-             && net_errno != ENOBUFS && net_errno != ENOMEM )
+            for( unsigned sent = 0; sent < count; )
             {
-                int type;
-                getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
-                            &type, &(socklen_t){ sizeof(type) });
-                if( type == SOCK_DGRAM )
+                int val = SendBatch( id->sinkv[i].rtp_fd, batch + sent,
+                                     count - sent );
+                if( val >= 0 )
+                {
+                    sent += val;
+                    continue;
+                }
+
+                if( net_errno != EAGAIN && net_errno != EWOULDBLOCK
+                 && net_errno != ENOBUFS && net_errno != ENOMEM )
+                {
+                    int type;
+                    getsockopt( id->sinkv[i].rtp_fd, SOL_SOCKET, SO_TYPE,
+                                &type, &(socklen_t){ sizeof(type) });
+                    if( type != SOCK_DGRAM )
+                    {   /* Broken connection */
+                        deadv[deadc++] = id->sinkv[i].rtp_fd;
+                        break;
+                    }
                     /* ICMP soft error: ignore and retry */
-                    send( id->sinkv[i].rtp_fd, out->p_buffer, len, 0 );
-                else
-                    /* Broken connection */
-                    deadv[deadc++] = id->sinkv[i].rtp_fd;
+                    send( id->sinkv[i].rtp_fd, batch[sent]->p_buffer,
+                          batch[sent]->i_buffer, 0 );
+                }
+                sent++; /* drop the failing packet */
             }
         }
-        id->i_seq_sent_next = ntohs(((uint16_t *) out->p_buffer)[1]) + 1;
+        id->i_seq_sent_next =
+            ntohs(((uint16_t *) batch[count - 1]->p_buffer)[1]) + 1;
         vlc_mutex_unlock( &id->lock_sink );
-        block_Release( out );
+
+        for( unsigned i = 0; i < count; i++ )
+            block_Release( batch[i] );
 
         for( unsigned i = 0; i < deadc; i++ )
         {
@@ -1400,6 +1480,9 @@ static void* ThreadSend( void *data )
             rtp_del_sink( id, deadv[i] );
         }
     }
+
+    if( next != NULL )
+        block_Release( next );
     return NULL;
 }
 
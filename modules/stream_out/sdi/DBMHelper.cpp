@@ -24,8 +24,11 @@
 
 #include <vlc_common.h>
 #include <vlc_es.h>
+#include <vlc_picture.h>
 #include <vlc_decklink.h>
 
+#include <new>
+
 #include "DBMHelper.hpp"
 
 #ifdef HAVE_ARPA_INET_H
@@ -168,3 +171,84 @@ const char * Helper::ErrorToString(long i_code)
     }
     return NULL;
 }
+
+PictureFrame::PictureFrame(picture_t *pic, long w, long h)
+    : refs(1), picture(picture_Hold(pic)), width(w), height(h)
+{
+}
+
+PictureFrame::~PictureFrame()
+{
+    picture_Release(picture);
+}
+
+PictureFrame * PictureFrame::Create(picture_t *picture, long width, long height)
+{
+    /* The card expects unpadded 8 bits 4:2:2 lines */
+    const plane_t *p = &picture->p[0];
+    if(picture->format.i_chroma != VLC_CODEC_UYVY ||
+       p->i_pitch != width * 2 || p->i_lines < height)
+        return NULL;
+    return new (std::nothrow) PictureFrame(picture, width, height);
+}
+
+HRESULT PictureFrame::QueryInterface(REFIID, LPVOID *)
+{
+    return E_NOINTERFACE;
+}
+
+ULONG PictureFrame::AddRef(void)
+{
+    return refs.fetch_add(1) + 1;
+}
+
+ULONG PictureFrame::Release(void)
+{
+    ULONG count = refs.fetch_sub(1) - 1;
+    if(count == 0)
+        delete this;
+    return count;
+}
+
+long PictureFrame::GetWidth(void)
+{
+    return width;
+}
+
+long PictureFrame::GetHeight(void)
+{
+    return height;
+}
+
+long PictureFrame::GetRowBytes(void)
+{
+    return picture->p[0].i_pitch;
+}
+
+BMDPixelFormat PictureFrame::GetPixelFormat(void)
+{
+    return bmdFormat8BitYUV;
+}
+
+BMDFrameFlags PictureFrame::GetFlags(void)
+{
+    return bmdFrameFlagDefault;
+}
+
+HRESULT PictureFrame::GetBytes(void **buffer)
+{
+    *buffer = picture->p[0].p_pixels;
+    return S_OK;
+}
+
+HRESULT PictureFrame::GetTimecode(BMDTimecodeFormat, IDeckLinkTimecode **timecode)
+{
+    *timecode = NULL;
+    return S_FALSE;
+}
+
+HRESULT PictureFrame::GetAncillaryData(IDeckLinkVideoFrameAncillary **ancillary)
+{
+    *ancillary = NULL;
+    return S_FALSE;
+}
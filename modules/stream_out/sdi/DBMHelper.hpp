@@ -21,6 +21,8 @@
 #ifndef DBMHELPER_HPP
 #define DBMHELPER_HPP
 
+#include <atomic>
+
 namespace Decklink
 {
     class Helper
@@ -32,6 +34,37 @@ namespace Decklink
                                                            BMDDisplayMode = bmdModeUnknown);
             static const char *ErrorToString(long i_code);
     };
+
+    /* Video frame scheduled straight from the memory of a picture */
+    class PictureFrame : public IDeckLinkVideoFrame
+    {
+        public:
+            /* Returns NULL if the picture layout does not fit the card */
+            static PictureFrame * Create(picture_t *, long width, long height);
+
+            HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, LPVOID *) override;
+            ULONG STDMETHODCALLTYPE AddRef(void) override;
+            ULONG STDMETHODCALLTYPE Release(void) override;
+
+            long STDMETHODCALLTYPE GetWidth(void) override;
+            long STDMETHODCALLTYPE GetHeight(void) override;
+            long STDMETHODCALLTYPE GetRowBytes(void) override;
+            BMDPixelFormat STDMETHODCALLTYPE GetPixelFormat(void) override;
+            BMDFrameFlags STDMETHODCALLTYPE GetFlags(void) override;
+            HRESULT STDMETHODCALLTYPE GetBytes(void **) override;
+            HRESULT STDMETHODCALLTYPE GetTimecode(BMDTimecodeFormat,
+                                                  IDeckLinkTimecode **) override;
+            HRESULT STDMETHODCALLTYPE GetAncillaryData(IDeckLinkVideoFrameAncillary **) override;
+
+        private:
+            PictureFrame(picture_t *, long, long);
+            virtual ~PictureFrame();
+
+            std::atomic<ULONG> refs;
+            picture_t *picture;
+            long width;
+            long height;
+    };
 }
 
 #endif
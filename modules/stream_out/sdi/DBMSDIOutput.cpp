@@ -750,13 +750,20 @@ int DBMSDIOutput::doProcessVideo(picture_t *picture, block_t *p_cc)
     HRESULT result;
     int w, h, stride, length, ret = VLC_EGENERIC;
     BMDTimeValue scheduleTime;
-    IDeckLinkMutableVideoFrame *pDLVideoFrame = NULL;
+    IDeckLinkMutableVideoFrame *pDLVideoFrame;
+    IDeckLinkVideoFrame *pFrame = NULL;
     w = video.configuredfmt.video.i_visible_width;
     h = video.configuredfmt.video.i_visible_height;
 
     if(FAKE_DRIVER)
         goto end;
 
+    /* 8 bits pictures are scheduled without copy, if their lines fit */
+    if(!video.tenbits)
+        pFrame = Decklink::PictureFrame::Create(picture, w, h);
+    if(pFrame)
+        goto schedule;
+
     result = p_output->CreateVideoFrame(w, h, w*3,
                                         video.tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV,
                                         bmdFrameFlagDefault, &pDLVideoFrame);
@@ -764,6 +771,7 @@ int DBMSDIOutput::doProcessVideo(picture_t *picture, block_t *p_cc)
         msg_Err(p_stream, "Failed to create video frame:0x%" PRIHR, result);
         goto error;
     }
+    pFrame = pDLVideoFrame;
 
     void *frame_bytes;
     pDLVideoFrame->GetBytes((void**)&frame_bytes);
@@ -816,12 +824,12 @@ int DBMSDIOutput::doProcessVideo(picture_t *picture, block_t *p_cc)
         memcpy(dst, src, w * 2 /* bpp */);
     }
 
-
+schedule:
     // compute frame duration in CLOCK_FREQ units
     length = (frameduration * CLOCK_FREQ) / timescale;
     picture->date -= clock.offset;
     scheduleTime = picture->date + DECKLINK_SCHED_OFFSET;
-    result = p_output->ScheduleVideoFrame(pDLVideoFrame, scheduleTime, length, CLOCK_FREQ);
+    result = p_output->ScheduleVideoFrame(pFrame, scheduleTime, length, CLOCK_FREQ);
     if (result != S_OK) {
         msg_Err(p_stream, "Dropped Video frame %" PRId64 ":0x%" PRIHR,
                 picture->date, result);
@@ -844,8 +852,8 @@ error:
         block_Release(p_cc);
 
     picture_Release(picture);
-    if (pDLVideoFrame)
-        pDLVideoFrame->Release();
+    if (pFrame)
+        pFrame->Release();
 
     return ret;
 }
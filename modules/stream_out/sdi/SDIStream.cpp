@@ -336,6 +336,7 @@ void AbstractDecodedStream::decoderThread()
                     p_owner->b_error = true;
                     break;
                 case VLCDEC_RELOAD:
+                case VLCDEC_FALLBACK:
                     p_owner->b_error = true;
                     if(p_block)
                         block_Release(p_block);
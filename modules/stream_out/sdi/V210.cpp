@@ -26,14 +26,9 @@
 
 #include <vlc_picture.h>
 
-using namespace sdi;
+#include "../../video_chroma/v210.h"
 
-static inline unsigned clip(unsigned a)
-{
-    if      (a < 4) return 4;
-    else if (a > 1019) return 1019;
-    else               return a;
-}
+using namespace sdi;
 
 static inline void put_le32(uint8_t **p, uint32_t d)
 {
@@ -45,53 +40,18 @@ void V210::Convert(const picture_t *pic, unsigned dst_stride, void *frame_bytes)
 {
     unsigned width = pic->format.i_width;
     unsigned height = pic->format.i_height;
-    unsigned payload_size = ((width * 8 + 11) / 12) * 4;
+    unsigned payload_size = (width + 5) / 6 * 16;
     unsigned line_padding = (payload_size < dst_stride) ? dst_stride - payload_size : 0;
-    unsigned h, w;
     uint8_t *dst = (uint8_t*)frame_bytes;
 
-    const uint16_t *y = (const uint16_t*)pic->p[0].p_pixels;
-    const uint16_t *u = (const uint16_t*)pic->p[1].p_pixels;
-    const uint16_t *v = (const uint16_t*)pic->p[2].p_pixels;
-
-#define WRITE_PIXELS(a, b, c)           \
-    do {                                \
-        val =   clip(*a++);             \
-        val |= (clip(*b++) << 10) |     \
-               (clip(*c++) << 20);      \
-        put_le32(&dst, val);           \
-    } while (0)
-
-    for (h = 0; h < height; h++) {
-        uint32_t val = 0;
-        for (w = 0; w + 5 < width; w += 6) {
-            WRITE_PIXELS(u, y, v);
-            WRITE_PIXELS(y, u, y);
-            WRITE_PIXELS(v, y, u);
-            WRITE_PIXELS(y, v, y);
-        }
-        if (w + 1 < width) {
-            WRITE_PIXELS(u, y, v);
-
-            val = clip(*y++);
-            if (w + 2 == width)
-                put_le32(&dst, val);
-#undef WRITE_PIXELS
-        }
-        if (w + 3 < width) {
-            val |= (clip(*u++) << 10) | (clip(*y++) << 20);
-            put_le32(&dst, val);
-
-            val = clip(*v++) | (clip(*y++) << 10);
-            put_le32(&dst, val);
-        }
-
-        memset(dst, 0, line_padding);
-        dst += line_padding;
+    for (unsigned h = 0; h < height; h++) {
+        const uint16_t *y = (const uint16_t *)&pic->p[0].p_pixels[h * pic->p[0].i_pitch];
+        const uint16_t *u = (const uint16_t *)&pic->p[1].p_pixels[h * pic->p[1].i_pitch];
+        const uint16_t *v = (const uint16_t *)&pic->p[2].p_pixels[h * pic->p[2].i_pitch];
 
-        y += pic->p[0].i_pitch / 2 - width;
-        u += pic->p[1].i_pitch / 2 - width / 2;
-        v += pic->p[2].i_pitch / 2 - width / 2;
+        v210_PackLine(dst, y, u, v, width);
+        memset(dst + payload_size, 0, line_padding);
+        dst += payload_size + line_padding;
     }
 }
 
@@ -317,6 +317,9 @@ static void* EncoderThread( void *obj )
         {
             /* release lock while encoding */
             vlc_mutex_unlock( &p_enc->lock_out );
+            /* The picture was decoded by another thread, maybe on another
+             * NUMA node */
+            picture_MoveLocal( p_pic );
             p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
             picture_Release( p_pic );
             vlc_mutex_lock( &p_enc->lock_out );
@@ -440,6 +443,9 @@ block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t
     picture_Hold( p_pic );
     picture_fifo_Push( p_enc->pp_pics, p_pic );
     vlc_cond_signal( &p_enc->cond );
+    /* pick what was encoded in the meantime */
+    block_t *p_data = p_enc->p_buffers;
+    p_enc->p_buffers = NULL;
     vlc_mutex_unlock( &p_enc->lock_out );
-    return NULL;
+    return p_data;
 }
@@ -57,6 +57,13 @@
 #define FPS_TEXT N_("Video frame-rate")
 #define FPS_LONGTEXT N_( \
     "Target output frame rate for the video stream." )
+#define RENDITIONS_TEXT N_("Additional video renditions")
+#define RENDITIONS_LONGTEXT N_( \
+    "Comma separated list of extra video renditions, as " \
+    "WIDTHxHEIGHT@BITRATE, encoded from the same decoded pictures " \
+    "and output as their own elementary streams (eg: " \
+    "1280x720@3000,0x360@800). A zero width or height keeps the " \
+    "aspect ratio." )
 #define DEINTERLACE_TEXT N_("Deinterlace video")
 #define DEINTERLACE_LONGTEXT N_( \
     "Deinterlace the video before encoding." )
@@ -123,14 +130,15 @@
 
 #define THREADS_TEXT N_("Number of threads")
 #define THREADS_LONGTEXT N_( \
-    "Number of threads used for the transcoding." )
+    "Number of threads used for the transcoding. When set, video filtering " \
+    "and encoding also run in their own threads." )
 #define HP_TEXT N_("High priority")
 #define HP_LONGTEXT N_( \
     "Runs the optional encoder thread at the OUTPUT priority instead of " \
     "VIDEO." )
 #define POOL_TEXT N_("Picture pool size")
 #define POOL_LONGTEXT N_( "Defines how many pictures we allow to be in pool "\
-    "between decoder/encoder threads when threads > 0" )
+    "between decoder/filters/encoder threads when threads > 0" )
 #define FORWARD_PCR_TEXT N_( "Forward PCR" )
 #define FORWARD_PCR_LONGTEXT N_( \
     "Enable PCR events forwarding to the next stream." )
@@ -180,6 +188,8 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_string( SOUT_CFG_PREFIX "renditions", NULL, RENDITIONS_TEXT,
+                RENDITIONS_LONGTEXT )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "audio encoder", "none",
@@ -226,7 +236,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "renditions", NULL
 };
 
 /*****************************************************************************
@@ -330,6 +340,60 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->video.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
 }
 
+static void SetVideoRenditionsConfig( sout_stream_t *p_stream,
+                                      sout_stream_sys_t *p_sys )
+{
+    p_sys->p_vrenditions_cfg = NULL;
+    p_sys->i_vrenditions = 0;
+
+    char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "renditions" );
+    if( !psz_string || !*psz_string || !p_sys->venc_cfg.i_codec )
+    {
+        free( psz_string );
+        return;
+    }
+
+    char *psz_save;
+    for( char *psz = strtok_r( psz_string, ",", &psz_save ); psz != NULL;
+         psz = strtok_r( NULL, ",", &psz_save ) )
+    {
+        char *end;
+        unsigned width = strtoul( psz, &end, 10 );
+        unsigned height = 0, bitrate = 0;
+        if( *end == 'x' )
+            height = strtoul( end + 1, &end, 10 );
+        if( *end == '@' )
+            bitrate = strtoul( end + 1, &end, 10 );
+        if( *end != '\0' || (!width && !height && !bitrate) )
+        {
+            msg_Warn( p_stream, "invalid rendition `%s'", psz );
+            continue;
+        }
+
+        transcode_encoder_config_t *p_cfgs =
+            realloc( p_sys->p_vrenditions_cfg,
+                     sizeof(*p_cfgs) * (p_sys->i_vrenditions + 1) );
+        if( !p_cfgs )
+            break;
+        p_sys->p_vrenditions_cfg = p_cfgs;
+
+        /* Same encoder and options as the main video, which owns the
+         * strings and options chain */
+        transcode_encoder_config_t *p_cfg = &p_cfgs[p_sys->i_vrenditions++];
+        *p_cfg = p_sys->venc_cfg;
+        p_cfg->video.f_scale = 0;
+        p_cfg->video.i_width = width;
+        p_cfg->video.i_height = height;
+        p_cfg->video.i_maxwidth = p_cfg->video.i_maxheight = 0;
+        if( bitrate )
+            p_cfg->video.i_bitrate = bitrate < 16000 ? bitrate * 1000 : bitrate;
+
+        msg_Dbg( p_stream, "video rendition %ux%u %ukb/s",
+                 width, height, p_cfg->video.i_bitrate / 1000 );
+    }
+    free( psz_string );
+}
+
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "senc" );
@@ -437,6 +501,7 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.f_scale,
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
     }
+    SetVideoRenditionsConfig( p_stream, p_sys );
 
     /* Video Filter Parameters */
     sout_filters_config_init( &p_sys->vfilters_cfg );
@@ -457,6 +522,10 @@ static int Open( vlc_object_t *p_this )
         free( psz_string );
     }
 
+    if( var_GetInteger( p_stream, SOUT_CFG_PREFIX "threads" ) > 0 )
+        p_sys->vfilters_cfg.video.i_queue_size =
+            var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
+
     /* Subpictures SOURCES parameters (not related to subtitles stream) */
     psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "sfilter" );
     if( psz_string && *psz_string )
@@ -494,6 +563,7 @@ static void Close( vlc_object_t * p_this )
     sout_stream_t       *p_stream = (sout_stream_t*)p_this;
     sout_stream_sys_t   *p_sys = p_stream->p_sys;
 
+    free( p_sys->p_vrenditions_cfg );
     transcode_encoder_config_clean( &p_sys->venc_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
 
@@ -733,7 +803,7 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
             vlc_mutex_unlock( &p_sys->lock );
-            transcode_video_clean( id );
+            transcode_video_clean( p_stream, id );
             break;
         case SPU_ES:
             dec_Delete( id->p_decoder );
@@ -770,6 +840,14 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
             goto error;
     }
 
+    /* The decoders may write to their input */
+    if( p_buffer != NULL )
+    {
+        p_buffer = block_Writable( p_buffer );
+        if( unlikely(p_buffer == NULL) )
+            return VLC_ENOMEM;
+    }
+
     sout_stream_sys_t *sys = p_stream->p_sys;
     if( p_buffer != NULL && sys->pcr_forwarding_enabled )
     {
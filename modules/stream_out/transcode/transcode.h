@@ -18,6 +18,7 @@ typedef struct
             config_chain_t  *p_deinterlace_cfg;
             char            *psz_spu_sources;
             bool             b_reorient;
+            unsigned         i_queue_size; /* threaded filter stage if > 0 */
         } video;
     };
 } sout_filters_config_t;
@@ -53,6 +54,8 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    transcode_encoder_config_t *p_vrenditions_cfg; /**< borrow venc_cfg strings */
+    size_t i_vrenditions;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -74,6 +77,16 @@ typedef struct
 
 struct aout_filters;
 
+/* Extra video encoding, from the main encoder input pictures */
+typedef struct
+{
+    const transcode_encoder_config_t *p_cfg;
+    transcode_encoder_t *encoder;
+    filter_chain_t *p_conv; /**< scaler/converter from the main encoder input */
+    void *downstream_id;
+    block_t *p_out; /**< protected by the output fifo lock */
+} transcode_rendition_t;
+
 struct sout_stream_id_sys_t
 {
     bool            b_transcode;
@@ -133,6 +146,21 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             transcode_rendition_t *p_renditions;
+             size_t i_renditions;
+             /* filters and conversion, between the decoder and encoder */
+             struct
+             {
+                 vlc_thread_t thread;
+                 vlc_mutex_t lock;
+                 vlc_cond_t wait; /* pictures to filter, or abort */
+                 vlc_cond_t idle; /* all queued pictures are filtered */
+                 vlc_sem_t room;
+                 vlc_picture_chain_t pics;
+                 bool b_busy;
+                 bool b_abort;
+                 bool b_threaded;
+             } filter_stage;
          };
          struct
          {
@@ -222,7 +250,7 @@ int  transcode_audio_init   ( sout_stream_t *, const es_format_t *,
 
 /* VIDEO */
 
-void transcode_video_clean  ( sout_stream_id_sys_t * );
+void transcode_video_clean  ( sout_stream_t *, sout_stream_id_sys_t * );
 int  transcode_video_process( sout_stream_t *, sout_stream_id_sys_t *,
                                      block_t *, block_t ** );
 int transcode_video_get_output_dimensions( sout_stream_id_sys_t *,
@@ -114,11 +114,169 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
                                          const es_format_t *p_dst,
                                          sout_stream_id_sys_t *id );
 
+static void transcode_video_filter_stage_wait( sout_stream_id_sys_t *id );
+
+/* Converts to the encoder format. When the source is made of hardware
+ * surfaces, scale them first while they are still on the device, so that
+ * only the final size is downloaded, or nothing if the encoder takes the
+ * surfaces as is. */
+static int transcode_video_conv_append( vlc_object_t *p_obj,
+                                        filter_chain_t *p_chain,
+                                        const es_format_t *p_src,
+                                        vlc_video_context *vctx,
+                                        const es_format_t *p_dst )
+{
+    const vlc_chroma_description_t *p_dsc =
+        vlc_fourcc_GetChromaDescription( p_src->video.i_chroma );
+
+    if( vctx != NULL && p_dsc != NULL && p_dsc->plane_count == 0 &&
+        p_src->video.i_chroma != p_dst->video.i_chroma &&
+        ( p_src->video.i_width != p_dst->video.i_width ||
+          p_src->video.i_height != p_dst->video.i_height ) )
+    {
+        es_format_t scaled;
+        es_format_Init( &scaled, VIDEO_ES, p_src->video.i_chroma );
+        video_format_Copy( &scaled.video, &p_dst->video );
+        scaled.video.i_chroma = p_src->video.i_chroma;
+
+        filter_chain_Reset( p_chain, p_src, vctx, p_dst );
+        int ret = filter_chain_AppendConverter( p_chain, &scaled );
+        es_format_Clean( &scaled );
+        if( ret == VLC_SUCCESS &&
+            filter_chain_AppendConverter( p_chain, NULL ) == VLC_SUCCESS )
+        {
+            msg_Dbg( p_obj, "scaling %4.4s surfaces before conversion",
+                     (const char *) &p_src->video.i_chroma );
+            return VLC_SUCCESS;
+        }
+    }
+
+    filter_chain_Reset( p_chain, p_src, vctx, p_dst );
+    return filter_chain_AppendConverter( p_chain, NULL );
+}
+
+static void transcode_video_renditions_update( sout_stream_t *p_stream,
+                                               sout_stream_id_sys_t *id,
+                                               vlc_video_context *vctx )
+{
+    const es_format_t *p_src = transcode_encoder_format_in( id->encoder );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+
+        transcode_remove_filters( &r->p_conv );
+
+        if( r->encoder == NULL )
+        {
+            struct encoder_owner *p_enc_owner = (struct encoder_owner *)
+                sout_EncoderCreate( VLC_OBJECT(p_stream), sizeof(struct encoder_owner) );
+            if( unlikely(p_enc_owner == NULL) )
+                continue;
+            p_enc_owner->id = id;
+            p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+
+            r->encoder = transcode_encoder_new( &p_enc_owner->enc, p_src );
+            if( !r->encoder )
+                continue;
+
+            transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                                               &id->p_decoder->fmt_out.video,
+                                               r->p_cfg, &p_src->video,
+                                               vctx, r->encoder );
+            if( transcode_encoder_open( r->encoder, r->p_cfg ) != VLC_SUCCESS )
+            {
+                msg_Err( p_stream, "cannot open encoder for rendition %zu", i );
+                continue;
+            }
+        }
+        else if( !transcode_encoder_opened( r->encoder ) )
+            continue;
+
+        /* Scale and convert from the main encoder input */
+        const es_format_t *encoder_fmt = transcode_encoder_format_in( r->encoder );
+        if( !video_format_IsSimilar( &encoder_fmt->video, &p_src->video ) )
+        {
+            filter_owner_t chain_owner = {
+               .video = &transcode_filter_video_cbs,
+               .sys = id,
+            };
+            r->p_conv = filter_chain_NewVideo( p_stream, false, &chain_owner );
+            if( r->p_conv )
+            {
+                if( transcode_video_conv_append( VLC_OBJECT(p_stream), r->p_conv,
+                                                 p_src, vctx, encoder_fmt ) != VLC_SUCCESS )
+                {
+                    msg_Err( p_stream, "cannot convert to rendition %zu", i );
+                    transcode_remove_filters( &r->p_conv );
+                    transcode_encoder_close( r->encoder );
+                }
+            }
+        }
+    }
+}
+
+static void transcode_video_renditions_add( sout_stream_t *p_stream,
+                                            sout_stream_id_sys_t *id )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        if( r->downstream_id || !r->encoder ||
+            !transcode_encoder_opened( r->encoder ) )
+            continue;
+
+        const es_format_t *fmt = transcode_encoder_format_out( r->encoder );
+        es_format_t tmp;
+        es_format_Init( &tmp, fmt->i_cat, fmt->i_codec );
+        es_format_Copy( &tmp, fmt );
+        tmp.i_id = -1; /* must not collide with the main video */
+        tmp.i_group = id->p_decoder->fmt_in->i_group;
+        free( tmp.psz_description );
+        if( asprintf( &tmp.psz_description, "%ux%u %ukb/s",
+                      fmt->video.i_visible_width, fmt->video.i_visible_height,
+                      fmt->i_bitrate / 1000 ) == -1 )
+            tmp.psz_description = NULL;
+        r->downstream_id = sout_StreamIdAdd( p_stream->p_next, &tmp );
+        es_format_Clean( &tmp );
+    }
+}
+
+static void transcode_video_renditions_encode( sout_stream_id_sys_t *id,
+                                               picture_t *p_pic )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        if( !r->encoder || !transcode_encoder_opened( r->encoder ) )
+            continue;
+
+        /* shared with the main encoder, unless converted */
+        picture_t *p_in = picture_Hold( p_pic );
+        if( r->p_conv )
+            p_in = filter_chain_VideoFilter( r->p_conv, p_in );
+        if( !p_in )
+            continue;
+
+        block_t *p_encoded = transcode_encoder_encode( r->encoder, p_in );
+        picture_Release( p_in );
+        if( p_encoded )
+        {
+            vlc_fifo_Lock( id->output_fifo );
+            block_ChainAppend( &r->p_out, p_encoded );
+            vlc_fifo_Unlock( id->output_fifo );
+        }
+    }
+}
+
 static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vctx )
 {
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
     sout_stream_id_sys_t *id = p_owner->id;
 
+    /* Pictures already queued must go through the previous chains */
+    transcode_video_filter_stage_wait( id );
+
     vlc_mutex_lock(&id->fifo.lock);
     if( id->encoder != NULL && transcode_encoder_opened( id->encoder ) )
     {
@@ -210,13 +368,15 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
         if ( !id->p_final_conv_static )
             id->p_final_conv_static =
                filter_chain_NewVideo( p_owner->p_stream, false, &chain_owner );
-         filter_chain_Reset( id->p_final_conv_static,
-               out_fmt,
-               enc_vctx,
-               encoder_fmt);
-         if( filter_chain_AppendConverter( id->p_final_conv_static, NULL ) != VLC_SUCCESS )
+         if( transcode_video_conv_append( VLC_OBJECT(p_owner->p_stream),
+                                          id->p_final_conv_static,
+                                          out_fmt, enc_vctx,
+                                          encoder_fmt ) != VLC_SUCCESS )
              goto error;
+         enc_vctx = filter_chain_GetVideoCtxOut( id->p_final_conv_static );
     }
+
+    transcode_video_renditions_update( p_owner->p_stream, id, enc_vctx );
     vlc_mutex_unlock(&id->fifo.lock);
 
     if( !id->downstream_id )
@@ -224,6 +384,7 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
             id->pf_transcode_downstream_add( p_owner->p_stream,
                                              id->p_decoder->fmt_in,
                                              transcode_encoder_format_out( id->encoder ) );
+    transcode_video_renditions_add( p_owner->p_stream, id );
     msg_Info( p_dec, "video format update succeed" );
 
 end:
@@ -251,14 +412,9 @@ static picture_t *video_new_buffer_encoder( transcode_encoder_t *p_enc )
 static int transcode_process_picture( sout_stream_id_sys_t *id,
                                       picture_t *p_pic, block_t **out);
 
-static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+static void transcode_video_queue_output( sout_stream_id_sys_t *id,
+                                          int ret, block_t *p_block )
 {
-    struct decoder_owner *p_owner = dec_get_owner( p_dec );
-    sout_stream_id_sys_t *id = p_owner->id;
-
-    block_t *p_block = NULL;
-    int ret = transcode_process_picture( id, p_pic, &p_block );
-
     if( p_block == NULL )
         return;
 
@@ -275,6 +431,96 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
     vlc_fifo_Unlock( id->output_fifo );
 }
 
+static void* FilterThread( void *obj )
+{
+    vlc_thread_set_name("vlc-tc-filters");
+
+    sout_stream_id_sys_t *id = obj;
+    int canc = vlc_savecancel ();
+
+    vlc_mutex_lock( &id->filter_stage.lock );
+
+    for( ;; )
+    {
+        while( !id->filter_stage.b_abort &&
+               vlc_picture_chain_IsEmpty( &id->filter_stage.pics ) )
+            vlc_cond_wait( &id->filter_stage.wait, &id->filter_stage.lock );
+
+        if( id->filter_stage.b_abort )
+            break;
+
+        picture_t *p_pic = vlc_picture_chain_PopFront( &id->filter_stage.pics );
+        id->filter_stage.b_busy = true;
+        vlc_mutex_unlock( &id->filter_stage.lock );
+        vlc_sem_post( &id->filter_stage.room );
+
+        /* release lock while filtering, and pushing to the encoder */
+        block_t *p_block = NULL;
+        int ret = transcode_process_picture( id, p_pic, &p_block );
+        transcode_video_queue_output( id, ret, p_block );
+
+        vlc_mutex_lock( &id->filter_stage.lock );
+        id->filter_stage.b_busy = false;
+        if( vlc_picture_chain_IsEmpty( &id->filter_stage.pics ) )
+            vlc_cond_broadcast( &id->filter_stage.idle );
+    }
+
+    vlc_mutex_unlock( &id->filter_stage.lock );
+
+    vlc_restorecancel (canc);
+
+    return NULL;
+}
+
+static void transcode_video_filter_stage_wait( sout_stream_id_sys_t *id )
+{
+    if( !id->filter_stage.b_threaded )
+        return;
+
+    vlc_mutex_lock( &id->filter_stage.lock );
+    while( id->filter_stage.b_busy ||
+           !vlc_picture_chain_IsEmpty( &id->filter_stage.pics ) )
+        vlc_cond_wait( &id->filter_stage.idle, &id->filter_stage.lock );
+    vlc_mutex_unlock( &id->filter_stage.lock );
+}
+
+static void transcode_video_filter_stage_stop( sout_stream_id_sys_t *id )
+{
+    if( !id->filter_stage.b_threaded )
+        return;
+
+    vlc_mutex_lock( &id->filter_stage.lock );
+    id->filter_stage.b_abort = true;
+    vlc_cond_signal( &id->filter_stage.wait );
+    vlc_mutex_unlock( &id->filter_stage.lock );
+    vlc_join( id->filter_stage.thread, NULL );
+    id->filter_stage.b_threaded = false;
+
+    picture_t *p_pic;
+    while( (p_pic = vlc_picture_chain_PopFront( &id->filter_stage.pics )) )
+        picture_Release( p_pic );
+}
+
+static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+{
+    struct decoder_owner *p_owner = dec_get_owner( p_dec );
+    sout_stream_id_sys_t *id = p_owner->id;
+
+    if( id->filter_stage.b_threaded )
+    {
+        vlc_sem_wait( &id->filter_stage.room );
+        vlc_mutex_lock( &id->filter_stage.lock );
+        vlc_picture_chain_Append( &id->filter_stage.pics, p_pic );
+        vlc_cond_signal( &id->filter_stage.wait );
+        vlc_mutex_unlock( &id->filter_stage.lock );
+        return;
+    }
+
+    block_t *p_block = NULL;
+    int ret = transcode_process_picture( id, p_pic, &p_block );
+    transcode_video_queue_output( id, ret, p_block );
+}
+
 int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
                           sout_stream_id_sys_t *id )
 {
@@ -307,12 +553,36 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
     id->p_decoder->pf_decode = NULL;
     id->p_decoder->pf_get_cc = NULL;
 
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    if( p_sys->i_vrenditions > 0 )
+    {
+        id->p_renditions = calloc( p_sys->i_vrenditions, sizeof(*id->p_renditions) );
+        if( !id->p_renditions )
+        {
+            es_format_Clean( &id->decoder_out );
+            block_FifoRelease( id->output_fifo );
+            return VLC_ENOMEM;
+        }
+        id->i_renditions = p_sys->i_vrenditions;
+        for( size_t i = 0; i < id->i_renditions; i++ )
+            id->p_renditions[i].p_cfg = &p_sys->p_vrenditions_cfg[i];
+    }
+
+    vlc_mutex_init( &id->filter_stage.lock );
+    vlc_cond_init( &id->filter_stage.wait );
+    vlc_cond_init( &id->filter_stage.idle );
+    vlc_picture_chain_Init( &id->filter_stage.pics );
+    id->filter_stage.b_busy = false;
+    id->filter_stage.b_abort = false;
+    id->filter_stage.b_threaded = false;
+
     id->p_decoder->p_module =
         module_need_var( id->p_decoder, "video decoder", "codec" );
 
     if( !id->p_decoder->p_module )
     {
         msg_Err( p_stream, "cannot find video decoder" );
+        free( id->p_renditions );
         es_format_Clean( &id->decoder_out );
         return VLC_EGENERIC;
     }
@@ -322,6 +592,18 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
         es_format_Copy( &id->decoder_out, &id->p_decoder->fmt_out );
     }
 
+    /* Run filters and conversions in their own thread, so that decoding,
+     * filtering and encoding can be pipelined */
+    const unsigned i_queue_size = id->p_filterscfg->video.i_queue_size;
+    if( i_queue_size > 0 )
+    {
+        vlc_sem_init( &id->filter_stage.room, i_queue_size );
+        if( vlc_clone( &id->filter_stage.thread, FilterThread, id ) )
+            msg_Warn( p_stream, "cannot create video filters thread" );
+        else
+            id->filter_stage.b_threaded = true;
+    }
+
     return VLC_SUCCESS;
 }
 
@@ -394,8 +676,22 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
     return VLC_SUCCESS;
 }
 
-void transcode_video_clean( sout_stream_id_sys_t *id )
+void transcode_video_clean( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
 {
+    transcode_video_filter_stage_stop( id );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        if( r->encoder )
+            transcode_encoder_delete( r->encoder );
+        transcode_remove_filters( &r->p_conv );
+        block_ChainRelease( r->p_out );
+        if( r->downstream_id )
+            sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+    }
+    free( id->p_renditions );
+
     /* Close encoder, but only if one was opened. */
     if ( id->encoder )
         transcode_encoder_delete( id->encoder );
@@ -536,6 +832,7 @@ static int transcode_process_picture( sout_stream_id_sys_t *id,
             {
                 /* If a packetizer is used, multiple blocks might be returned, in w */
                 block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
+                transcode_video_renditions_encode( id, p_in );
                 picture_Release( p_in );
                 block_ChainAppend( out, p_encoded );
             }
@@ -563,6 +860,10 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( id->encoder == NULL )
         return VLC_SUCCESS;
 
+    /* Pending pictures must reach the encoder before draining it */
+    if( in == NULL )
+        transcode_video_filter_stage_wait( id );
+
     vlc_fifo_Lock( id->output_fifo );
     if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
     {
@@ -583,5 +884,30 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( b_eos )
         tag_last_block_with_flag( out, BLOCK_FLAG_END_OF_SEQUENCE );
 
+    for( size_t i = 0; i < id->i_renditions && !has_error; i++ )
+    {
+        transcode_rendition_t *r = &id->p_renditions[i];
+        if( !r->downstream_id )
+            continue;
+
+        vlc_fifo_Lock( id->output_fifo );
+        if( in == NULL && transcode_encoder_opened( r->encoder ) )
+            transcode_encoder_drain( r->encoder, &r->p_out );
+        block_t *p_out = r->p_out;
+        r->p_out = NULL;
+        vlc_fifo_Unlock( id->output_fifo );
+
+        if( b_eos )
+            tag_last_block_with_flag( &p_out, BLOCK_FLAG_END_OF_SEQUENCE );
+
+        while( p_out )
+        {
+            block_t *p_next = p_out->p_next;
+            p_out->p_next = NULL;
+            sout_StreamIdSend( p_stream->p_next, r->downstream_id, p_out );
+            p_out = p_next;
+        }
+    }
+
     return has_error ? VLC_EGENERIC : VLC_SUCCESS;
 }
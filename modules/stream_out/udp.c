@@ -29,6 +29,9 @@
 #ifdef HAVE_ARPA_INET_H
 #include <arpa/inet.h>
 #endif
+#ifdef HAVE_NETINET_UDP_H
+#include <netinet/udp.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_block.h>
@@ -46,8 +49,14 @@ struct sout_stream_udp
     session_descriptor_t *sap;
     int fd;
     uint_fast16_t mtu;
+    bool gso;
 };
 
+/* Maximum number of datagrams sent per system call */
+#define UDP_BATCH 32
+/* Largest UDP payload (over IPv4) */
+#define UDP_PAYLOAD_MAX 65507
+
 static void *Add(sout_stream_t *stream, const es_format_t *fmt)
 {
     struct sout_stream_udp *sys = stream->p_sys;
@@ -145,39 +154,159 @@ static int Control(sout_stream_t *stream, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+#ifdef UDP_SEGMENT
+/**
+ * Sends a batch of datagrams as a single UDP GSO (generic segmentation
+ * offload) buffer, if they all have the same size, bar the last one.
+ */
+static ssize_t SendSegmented(sout_access_out_t *access,
+                             const struct msghdr *hdrs, unsigned count,
+                             const size_t *sizes)
+{
+    struct sout_stream_udp *sys = access->p_sys;
+    size_t segment = sizes[0], total = 0;
+
+    if (!sys->gso || count < 2)
+        return -1;
+
+    for (unsigned i = 0; i < count; i++) {
+        if (sizes[i] > segment || (sizes[i] < segment && i + 1 < count))
+            return -1;
+        total += sizes[i];
+    }
+
+    if (total > UDP_PAYLOAD_MAX)
+        return -1;
+
+    /* The datagrams I/O vectors are contiguous */
+    union {
+        char buf[CMSG_SPACE(sizeof (uint16_t))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr hdr = {
+        .msg_iov = hdrs[0].msg_iov,
+        .msg_iovlen = (hdrs[count - 1].msg_iov - hdrs[0].msg_iov)
+                      + hdrs[count - 1].msg_iovlen,
+        .msg_control = control.buf,
+        .msg_controllen = sizeof (control.buf),
+    };
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+    uint16_t size = segment;
+
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof (size));
+    memcpy(CMSG_DATA(cmsg), &size, sizeof (size));
+
+    ssize_t val = sendmsg(sys->fd, &hdr, 0);
+    if (val < 0) {
+        switch (errno) {
+            case EINVAL:
+            case EIO:
+            case ENOPROTOOPT:
+            case EOPNOTSUPP:
+                msg_Dbg(access, "segmentation offload not supported: %s",
+                        vlc_strerror_c(errno));
+                sys->gso = false;
+        }
+    }
+    return val;
+}
+#endif
+
+static ssize_t SendBatch(sout_access_out_t *access,
+                         const struct msghdr *hdrs, unsigned count,
+                         const size_t *sizes)
+{
+    struct sout_stream_udp *sys = access->p_sys;
+    ssize_t total = 0;
+
+#ifdef UDP_SEGMENT
+    total = SendSegmented(access, hdrs, count, sizes);
+    if (total >= 0)
+        return total;
+    total = 0;
+#else
+    (void) sizes;
+#endif
+
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr msgs[UDP_BATCH];
+
+    for (unsigned i = 0; i < count; i++)
+        msgs[i].msg_hdr = hdrs[i];
+
+    for (unsigned i = 0; i < count;) {
+        int val = sendmmsg(sys->fd, msgs + i, count - i, 0);
+
+        if (val < 0) {
+            msg_Err(access, "send error: %s", vlc_strerror_c(errno));
+            i++; /* drop the failing datagram */
+            continue;
+        }
+
+        for (int j = 0; j < val; j++)
+            total += msgs[i + j].msg_len;
+        i += val;
+    }
+#else
+    for (unsigned i = 0; i < count; i++) {
+        ssize_t val = sendmsg(sys->fd, &hdrs[i], 0);
+
+        if (val < 0)
+            msg_Err(access, "send error: %s", vlc_strerror_c(errno));
+        else
+            total += val;
+    }
+#endif
+    return total;
+}
+
 static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
 {
     struct sout_stream_udp *sys = access->p_sys;
     ssize_t total = 0;
 
+    /* Blocks are gathered into datagrams of at most MTU bytes, and the
+     * datagrams of a single write are sent together. The blocks of a write
+     * are due at the same time, so this does not affect the pacing. */
     while (block != NULL) {
-        struct iovec iov[16];
+        struct iovec iov[64];
+        struct msghdr hdrs[UDP_BATCH];
+        size_t sizes[UDP_BATCH];
         block_t *unsent = block;
-        unsigned iovlen = 0;
-        size_t tosend = 0;
+        unsigned iovlen = 0, count = 0;
 
-        /* Count how many blocks to gather */
         do {
-            if (iovlen >= ARRAY_SIZE(iov))
-                break;
-            if (unsent->i_buffer + tosend > sys->mtu && likely(iovlen > 0))
+            unsigned first = iovlen;
+            size_t tosend = 0;
+
+            /* Count how many blocks to gather */
+            while (unsent != NULL && iovlen < ARRAY_SIZE(iov)) {
+                if (unsent->i_buffer + tosend > sys->mtu
+                 && likely(iovlen > first))
+                    break;
+
+                iov[iovlen].iov_base = unsent->p_buffer;
+                iov[iovlen].iov_len = unsent->i_buffer;
+                iovlen++;
+                tosend += unsent->i_buffer;
+                unsent = unsent->p_next;
+            }
+
+            if (iovlen == first)
                 break;
 
-            iov[iovlen].iov_base = unsent->p_buffer;
-            iov[iovlen].iov_len = unsent->i_buffer;
-            iovlen++;
-            tosend += unsent->i_buffer;
-            unsent = unsent->p_next;
-        } while (unsent != NULL);
+            hdrs[count] = (struct msghdr) {
+                .msg_iov = iov + first,
+                .msg_iovlen = iovlen - first,
+            };
+            sizes[count] = tosend;
+            count++;
+        } while (unsent != NULL && count < ARRAY_SIZE(hdrs));
 
         /* Send */
-        struct msghdr hdr = { .msg_iov = iov, .msg_iovlen = iovlen };
-        ssize_t val = sendmsg(sys->fd, &hdr, 0);
-
-        if (val < 0)
-            msg_Err(access, "send error: %s", vlc_strerror_c(errno));
-        else
-            total += val;
+        total += SendBatch(access, hdrs, count, sizes);
 
         /* Free */
         do {
@@ -308,6 +437,7 @@ static int Open(vlc_object_t *obj)
     sys->access = access;
     sys->fd = fd;
     sys->mtu = var_InheritInteger(stream, "mtu");
+    sys->gso = true;
 
     sout_mux_t *mux = sout_MuxNew(access, muxmod);
     if (mux == NULL) {
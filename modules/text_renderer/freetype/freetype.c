@@ -1231,6 +1231,9 @@ static int Create( filter_t *p_filter )
     if( !p_sys->ftcache )
         goto error;
 
+    /* This is only an optimization, do without it on error */
+    p_sys->shaped_runs = ShapedRunCacheNew();
+
     p_sys->i_scale = 100;
 
     /* default style to apply to incomplete segments styles */
@@ -1297,6 +1300,9 @@ static void Destroy( filter_t *p_filter )
         DumpFamilies( p_sys->fs );
 #endif
 
+    if( p_sys->shaped_runs )
+        vlc_lru_Release( p_sys->shaped_runs );
+
     if( p_sys->ftcache )
         vlc_ftcache_Delete( p_sys->ftcache );
 
@@ -41,6 +41,7 @@
 #include <vlc_common.h>
 #include <vlc_filter.h>
 #include <vlc_text_style.h>
+#include <vlc_memstream.h>
 
 /* Freetype */
 #include <ft2build.h>
@@ -107,7 +108,7 @@ typedef struct run_desc_t
 #ifdef HAVE_HARFBUZZ
     hb_script_t                 script;
     hb_direction_t              direction;
-    hb_buffer_t                *p_buffer;
+    struct shaped_run_t        *p_shaped;
 #endif
 
 } run_desc_t;
@@ -679,6 +680,135 @@ static int ItemizeParagraph( filter_t *p_filter, paragraph_t *p_paragraph )
 }
 
 #ifdef HAVE_HARFBUZZ
+/* Number of shaped runs kept in cache */
+#define SHAPED_RUN_CACHE_SIZE 256
+
+/**
+ * Output of HarfBuzz for a run, shared between the paragraphs
+ * and the cache of shaped runs
+ */
+typedef struct shaped_run_t
+{
+    unsigned             i_refcount;
+    unsigned             i_glyph_count;
+    hb_glyph_info_t     *p_infos;
+    hb_glyph_position_t *p_positions;
+} shaped_run_t;
+
+static void ShapedRunRelease( shaped_run_t *p_shaped )
+{
+    assert( p_shaped->i_refcount );
+    if( --p_shaped->i_refcount == 0 )
+    {
+        free( p_shaped->p_infos );
+        free( p_shaped->p_positions );
+        free( p_shaped );
+    }
+}
+
+static void ShapedRunCacheRelease( void *priv, void *value )
+{
+    VLC_UNUSED( priv );
+    ShapedRunRelease( value );
+}
+
+vlc_lru *ShapedRunCacheNew( void )
+{
+    return vlc_lru_New( SHAPED_RUN_CACHE_SIZE, ShapedRunCacheRelease, NULL );
+}
+
+/**
+ * The shaping of a run only depends on its font face and size, its script,
+ * its direction and its code points.
+ */
+static char *ShapedRunKey( const paragraph_t *p_paragraph,
+                           const run_desc_t *p_run,
+                           const vlc_ftcache_metrics_t *p_metrics )
+{
+    const vlc_face_id_t *p_faceid = p_run->p_faceid;
+    struct vlc_memstream stream;
+
+    if( vlc_memstream_open( &stream ) )
+        return NULL;
+
+    vlc_memstream_printf( &stream, "%s#%u#%u#%d,%d,%"PRIx32",%d:",
+                          p_faceid->psz_filename, p_faceid->idx,
+                          p_faceid->charmap_index,
+                          p_metrics->width_px, p_metrics->height_px,
+                          (uint32_t) p_run->script, (int) p_run->direction );
+    for( int i = p_run->i_start_offset; i < p_run->i_end_offset; ++i )
+        vlc_memstream_printf( &stream, "%"PRIx32",",
+                              (uint32_t) p_paragraph->p_code_points[ i ] );
+
+    if( vlc_memstream_close( &stream ) )
+        return NULL;
+    return stream.ptr;
+}
+
+static shaped_run_t *ShapeRun( filter_t *p_filter, FT_Face p_face,
+                               const paragraph_t *p_paragraph,
+                               const run_desc_t *p_run )
+{
+    shaped_run_t *p_shaped = NULL;
+
+    hb_font_t *p_hb_font = hb_ft_font_create( p_face, 0 );
+    if( !p_hb_font )
+    {
+        msg_Err( p_filter, "ShapeRun(): hb_ft_font_create() error" );
+        return NULL;
+    }
+
+    hb_buffer_t *p_buffer = hb_buffer_create();
+    if( !p_buffer )
+    {
+        msg_Err( p_filter, "ShapeRun(): hb_buffer_create() error" );
+        hb_font_destroy( p_hb_font );
+        return NULL;
+    }
+
+    hb_buffer_set_direction( p_buffer, p_run->direction );
+    hb_buffer_set_script( p_buffer, p_run->script );
+    hb_buffer_add_utf32( p_buffer,
+                         p_paragraph->p_code_points + p_run->i_start_offset,
+                         p_run->i_end_offset - p_run->i_start_offset, 0,
+                         p_run->i_end_offset - p_run->i_start_offset );
+    hb_shape( p_hb_font, p_buffer, 0, 0 );
+    hb_font_destroy( p_hb_font );
+
+    unsigned int i_glyph_count;
+    const hb_glyph_info_t *p_infos =
+            hb_buffer_get_glyph_infos( p_buffer, &i_glyph_count );
+    const hb_glyph_position_t *p_positions =
+            hb_buffer_get_glyph_positions( p_buffer, &i_glyph_count );
+    if( i_glyph_count == 0 )
+    {
+        msg_Err( p_filter, "ShapeRun() invalid glyph count in shaped run" );
+        goto out;
+    }
+
+    p_shaped = malloc( sizeof( *p_shaped ) );
+    if( !p_shaped )
+        goto out;
+
+    p_shaped->i_refcount = 1;
+    p_shaped->i_glyph_count = i_glyph_count;
+    p_shaped->p_infos = vlc_alloc( i_glyph_count, sizeof( *p_infos ) );
+    p_shaped->p_positions = vlc_alloc( i_glyph_count, sizeof( *p_positions ) );
+    if( !p_shaped->p_infos || !p_shaped->p_positions )
+    {
+        ShapedRunRelease( p_shaped );
+        p_shaped = NULL;
+        goto out;
+    }
+
+    memcpy( p_shaped->p_infos, p_infos, i_glyph_count * sizeof( *p_infos ) );
+    memcpy( p_shaped->p_positions, p_positions,
+            i_glyph_count * sizeof( *p_positions ) );
+out:
+    hb_buffer_destroy( p_buffer );
+    return p_shaped;
+}
+
 /**
  * Shape an itemized paragraph using HarfBuzz.
  * This is where the glyphs of complex scripts get their positions
@@ -737,47 +867,38 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
         metrics.height_px = ConvertToLiveSize( p_filter, p_style );
         metrics.width_px = GetFontWidthForStyle( p_style, metrics.height_px );
 
-        FT_Face p_face = vlc_ftcache_LoadFaceByID( p_sys->ftcache, p_faceid, &metrics );
-        if(!p_face)
-            goto error;
-
-        hb_font_t *p_hb_font = hb_ft_font_create( p_face, 0 );
-        if( !p_hb_font )
+        /* Karaoke and roll-up captions render the same runs over and over,
+         * only reshape the runs which are not in the cache. */
+        char *psz_key = NULL;
+        if( p_sys->shaped_runs )
         {
-            msg_Err( p_filter,
-                     "ShapeParagraphHarfBuzz(): hb_ft_font_create() error" );
-            goto error;
+            psz_key = ShapedRunKey( p_paragraph, p_run, &metrics );
+            if( psz_key )
+                p_run->p_shaped = vlc_lru_Get( p_sys->shaped_runs, psz_key );
         }
 
-        p_run->p_buffer = hb_buffer_create();
-        if( !p_run->p_buffer )
+        if( p_run->p_shaped )
+            p_run->p_shaped->i_refcount++;
+        else
         {
-            msg_Err( p_filter,
-                     "ShapeParagraphHarfBuzz(): hb_buffer_create() error" );
-            hb_font_destroy( p_hb_font );
-            goto error;
-        }
-
-        hb_buffer_set_direction( p_run->p_buffer, p_run->direction );
-        hb_buffer_set_script( p_run->p_buffer, p_run->script );
-        hb_buffer_add_utf32( p_run->p_buffer,
-                             p_paragraph->p_code_points + p_run->i_start_offset,
-                             p_run->i_end_offset - p_run->i_start_offset, 0,
-                             p_run->i_end_offset - p_run->i_start_offset );
-        hb_shape( p_hb_font, p_run->p_buffer, 0, 0 );
-
-        hb_font_destroy( p_hb_font );
-        p_hb_font = 0;
+            FT_Face p_face = vlc_ftcache_LoadFaceByID( p_sys->ftcache, p_faceid, &metrics );
+            if( p_face )
+                p_run->p_shaped = ShapeRun( p_filter, p_face, p_paragraph, p_run );
+            if( !p_run->p_shaped )
+            {
+                free( psz_key );
+                goto error;
+            }
 
-        const unsigned length = hb_buffer_get_length( p_run->p_buffer );
-        if( length == 0 )
-        {
-            msg_Err( p_filter,
-                     "ShapeParagraphHarfBuzz() invalid glyph count in shaped run" );
-            goto error;
+            if( psz_key )
+            {
+                p_run->p_shaped->i_refcount++;
+                vlc_lru_Insert( p_sys->shaped_runs, psz_key, p_run->p_shaped );
+            }
         }
+        free( psz_key );
 
-        i_total_glyphs += length;
+        i_total_glyphs += p_run->p_shaped->i_glyph_count;
     }
 
     p_new_paragraph = NewParagraph( p_filter, i_total_glyphs,
@@ -800,11 +921,9 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
     for( int i = 0; i < p_paragraph->i_runs_count; ++i )
     {
         run_desc_t *p_run = p_paragraph->p_runs + i;
-        unsigned int i_glyph_count;
-        const hb_glyph_info_t *p_infos =
-                hb_buffer_get_glyph_infos( p_run->p_buffer, &i_glyph_count );;
-        const hb_glyph_position_t *p_positions =
-                hb_buffer_get_glyph_positions( p_run->p_buffer, &i_glyph_count );
+        const unsigned int i_glyph_count = p_run->p_shaped->i_glyph_count;
+        const hb_glyph_info_t *p_infos = p_run->p_shaped->p_infos;
+        const hb_glyph_position_t *p_positions = p_run->p_shaped->p_positions;
         for( unsigned int j = 0; j < i_glyph_count; ++j )
         {
             /*
@@ -851,7 +970,8 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
 
     for( int i = 0; i < p_paragraph->i_runs_count; ++i )
     {
-        hb_buffer_destroy( p_paragraph->p_runs[ i ].p_buffer );
+        ShapedRunRelease( p_paragraph->p_runs[ i ].p_shaped );
+        p_paragraph->p_runs[ i ].p_shaped = NULL;
     }
     FreeParagraph( *p_old_paragraph );
     *p_old_paragraph = p_new_paragraph;
@@ -861,8 +981,9 @@ static int ShapeParagraphHarfBuzz( filter_t *p_filter,
 error:
     for( int i = 0; i < p_paragraph->i_runs_count; ++i )
     {
-        if( p_paragraph->p_runs[ i ].p_buffer )
-            hb_buffer_destroy( p_paragraph->p_runs[ i ].p_buffer );
+        if( p_paragraph->p_runs[ i ].p_shaped )
+            ShapedRunRelease( p_paragraph->p_runs[ i ].p_shaped );
+        p_paragraph->p_runs[ i ].p_shaped = NULL;
     }
 
     if( p_new_paragraph )
@@ -870,6 +991,11 @@ error:
 
     return i_ret;
 }
+#else
+vlc_lru *ShapedRunCacheNew( void )
+{
+    return NULL;
+}
 #endif
 
 #ifdef HAVE_FRIBIDI
@@ -94,6 +94,13 @@ typedef struct
     line_desc_t *p_laid;
 } layout_text_block_t;
 
+/**
+ * Creates the cache of runs shaped by LayoutTextBlock().
+ *
+ * \return the cache, or NULL if the text is not shaped or on error
+ */
+vlc_lru *ShapedRunCacheNew( void );
+
 /**
  * Layout the text with shaping, bidirectional support, and font fallback if available.
  *
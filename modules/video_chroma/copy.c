@@ -35,6 +35,32 @@
 #include <assert.h>
 
 #include "copy.h"
+
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# define COPY_AVX2 1
+# include <immintrin.h>
+# ifdef HAVE_AVX512_INTRINSICS
+#  define COPY_AVX512 1
+# endif
+#endif
+
+#if defined(__ARM_NEON)
+# define COPY_NEON 1
+# include <arm_neon.h>
+#endif
+
+#if defined(__wasm_simd128__)
+# define COPY_WASM 1
+# include <wasm_simd128.h>
+#endif
+
+#ifdef COPY_TEST_NOOPTIM
+# undef COPY_AVX2
+# undef COPY_AVX512
+# undef COPY_NEON
+# undef COPY_WASM
+#endif
+
 static void CopyPlane(uint8_t *dst, size_t dst_pitch,
                       const uint8_t *src, size_t src_pitch,
                       unsigned height, int bitshift);
@@ -609,6 +635,471 @@ static void SSE_Copy420_P_to_SP(picture_t *dst, const uint8_t *src[static 3],
 #undef COPY64
 #endif /* CAN_COMPILE_SSE2 */
 
+#if defined(COPY_AVX2) || defined(COPY_NEON) || defined(COPY_WASM)
+/* Scalar heads and tails of the vector lines */
+static void CopyLine(uint8_t *dst, const uint8_t *src, size_t size,
+                     int bitshift)
+{
+    if (bitshift == 0)
+    {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    uint16_t *dst16 = (uint16_t *) dst;
+    const uint16_t *src16 = (const uint16_t *) src;
+    if (bitshift > 0)
+        for (size_t x = 0; x < size / 2; x++)
+            dst16[x] = src16[x] >> (bitshift & 0xf);
+    else
+        for (size_t x = 0; x < size / 2; x++)
+            dst16[x] = src16[x] << ((-bitshift) & 0xf);
+}
+
+static void SplitLine(uint8_t *dstu, uint8_t *dstv, const uint8_t *src,
+                      size_t count, unsigned pixel_size, int bitshift)
+{
+    if (pixel_size == 1)
+    {
+        for (size_t x = 0; x < count; x++)
+        {
+            dstu[x] = src[2*x+0];
+            dstv[x] = src[2*x+1];
+        }
+        return;
+    }
+
+    uint16_t *dstu16 = (uint16_t *) dstu, *dstv16 = (uint16_t *) dstv;
+    const uint16_t *src16 = (const uint16_t *) src;
+    for (size_t x = 0; x < count; x++)
+    {
+        uint16_t u = src16[2*x+0], v = src16[2*x+1];
+        if (bitshift > 0)
+        {
+            u >>= bitshift & 0xf;
+            v >>= bitshift & 0xf;
+        }
+        else if (bitshift < 0)
+        {
+            u <<= (-bitshift) & 0xf;
+            v <<= (-bitshift) & 0xf;
+        }
+        dstu16[x] = u;
+        dstv16[x] = v;
+    }
+}
+#endif
+
+#ifdef COPY_AVX2
+/* The non-temporal loads read USWC (GPU) memory at full speed, and the
+ * non-temporal stores do not evict the caches with a frame that is not
+ * read back soon. */
+
+#ifdef COPY_AVX512
+VLC_AVX512
+static void AVX512_CopyLine(uint8_t *dst, const uint8_t *src, size_t size,
+                            int bitshift)
+{
+    size_t x = __MIN(size, (-(uintptr_t) src) & 63);
+    if (bitshift != 0 && (x & 1))
+        x = size; /* misaligned samples */
+    CopyLine(dst, src, x, bitshift);
+
+    const __m128i shift = _mm_cvtsi32_si128(bitshift > 0 ? bitshift : -bitshift);
+    const bool nt = (((uintptr_t) dst + x) & 63) == 0;
+    for (; x + 64 <= size; x += 64)
+    {
+        __m512i v = _mm512_stream_load_si512((void *)(uintptr_t)(src + x));
+        if (bitshift > 0)
+            v = _mm512_srl_epi16(v, shift);
+        else if (bitshift < 0)
+            v = _mm512_sll_epi16(v, shift);
+        if (nt)
+            _mm512_stream_si512((void *)(dst + x), v);
+        else
+            _mm512_storeu_si512((void *)(dst + x), v);
+    }
+    CopyLine(dst + x, src + x, size - x, bitshift);
+}
+
+VLC_AVX512
+static void AVX512_SplitLine16(uint8_t *dstu, uint8_t *dstv,
+                               const uint8_t *src, size_t count, int bitshift)
+{
+    size_t x = ((-(uintptr_t) src) & 63) / 4;
+    if (((uintptr_t) src & 3) || x > count)
+        x = count;
+    SplitLine(dstu, dstv, src, x, 2, bitshift);
+
+    const __m128i shift = _mm_cvtsi32_si128(bitshift > 0 ? bitshift : -bitshift);
+    const __m512i mask = _mm512_set1_epi32(0xffff);
+    const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; x + 32 <= count; x += 32)
+    {
+        __m512i a = _mm512_stream_load_si512((void *)(uintptr_t)(src + 4 * x));
+        __m512i b = _mm512_stream_load_si512((void *)(uintptr_t)(src + 4 * x + 64));
+        __m512i u = _mm512_packus_epi32(_mm512_and_si512(a, mask),
+                                        _mm512_and_si512(b, mask));
+        /* the zero masked forms avoid spurious uninitialized warnings of
+         * some GCC versions on the plain ones */
+        __m512i v = _mm512_packus_epi32(_mm512_maskz_srli_epi32(0xffff, a, 16),
+                                        _mm512_maskz_srli_epi32(0xffff, b, 16));
+        u = _mm512_maskz_permutexvar_epi64(0xff, order, u);
+        v = _mm512_maskz_permutexvar_epi64(0xff, order, v);
+        if (bitshift > 0)
+        {
+            u = _mm512_srl_epi16(u, shift);
+            v = _mm512_srl_epi16(v, shift);
+        }
+        else if (bitshift < 0)
+        {
+            u = _mm512_sll_epi16(u, shift);
+            v = _mm512_sll_epi16(v, shift);
+        }
+        _mm512_storeu_si512((void *)(dstu + 2 * x), u);
+        _mm512_storeu_si512((void *)(dstv + 2 * x), v);
+    }
+    SplitLine(dstu + 2 * x, dstv + 2 * x, src + 4 * x, count - x, 2, bitshift);
+}
+#endif
+
+VLC_AVX2
+static void AVX2_CopyLine(uint8_t *dst, const uint8_t *src, size_t size,
+                          int bitshift)
+{
+    size_t x = __MIN(size, (-(uintptr_t) src) & 31);
+    if (bitshift != 0 && (x & 1))
+        x = size; /* misaligned samples */
+    CopyLine(dst, src, x, bitshift);
+
+    const __m128i shift = _mm_cvtsi32_si128(bitshift > 0 ? bitshift : -bitshift);
+    const bool nt = (((uintptr_t) dst + x) & 31) == 0;
+    for (; x + 32 <= size; x += 32)
+    {
+        __m256i v = _mm256_stream_load_si256((const __m256i *)(src + x));
+        if (bitshift > 0)
+            v = _mm256_srl_epi16(v, shift);
+        else if (bitshift < 0)
+            v = _mm256_sll_epi16(v, shift);
+        if (nt)
+            _mm256_stream_si256((__m256i *)(dst + x), v);
+        else
+            _mm256_storeu_si256((__m256i *)(dst + x), v);
+    }
+    CopyLine(dst + x, src + x, size - x, bitshift);
+}
+
+VLC_AVX2
+static void AVX2_SplitLine8(uint8_t *dstu, uint8_t *dstv,
+                            const uint8_t *src, size_t count)
+{
+    size_t x = ((-(uintptr_t) src) & 31) / 2;
+    if (((uintptr_t) src & 1) || x > count)
+        x = count;
+    SplitLine(dstu, dstv, src, x, 1, 0);
+
+    /* even bytes then odd bytes of each lane */
+    const __m256i deinterleave = _mm256_setr_epi8(
+        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    for (; x + 32 <= count; x += 32)
+    {
+        __m256i a = _mm256_stream_load_si256((const __m256i *)(src + 2 * x));
+        __m256i b = _mm256_stream_load_si256((const __m256i *)(src + 2 * x + 32));
+        a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, deinterleave), 0xd8);
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, deinterleave), 0xd8);
+        _mm256_storeu_si256((__m256i *)(dstu + x),
+                            _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(dstv + x),
+                            _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    SplitLine(dstu + x, dstv + x, src + 2 * x, count - x, 1, 0);
+}
+
+VLC_AVX2
+static void AVX2_SplitLine16(uint8_t *dstu, uint8_t *dstv,
+                             const uint8_t *src, size_t count, int bitshift)
+{
+    size_t x = ((-(uintptr_t) src) & 31) / 4;
+    if (((uintptr_t) src & 3) || x > count)
+        x = count;
+    SplitLine(dstu, dstv, src, x, 2, bitshift);
+
+    const __m128i shift = _mm_cvtsi32_si128(bitshift > 0 ? bitshift : -bitshift);
+    const __m256i mask = _mm256_set1_epi32(0xffff);
+    for (; x + 16 <= count; x += 16)
+    {
+        __m256i a = _mm256_stream_load_si256((const __m256i *)(src + 4 * x));
+        __m256i b = _mm256_stream_load_si256((const __m256i *)(src + 4 * x + 32));
+        __m256i u = _mm256_packus_epi32(_mm256_and_si256(a, mask),
+                                        _mm256_and_si256(b, mask));
+        __m256i v = _mm256_packus_epi32(_mm256_srli_epi32(a, 16),
+                                        _mm256_srli_epi32(b, 16));
+        u = _mm256_permute4x64_epi64(u, 0xd8);
+        v = _mm256_permute4x64_epi64(v, 0xd8);
+        if (bitshift > 0)
+        {
+            u = _mm256_srl_epi16(u, shift);
+            v = _mm256_srl_epi16(v, shift);
+        }
+        else if (bitshift < 0)
+        {
+            u = _mm256_sll_epi16(u, shift);
+            v = _mm256_sll_epi16(v, shift);
+        }
+        _mm256_storeu_si256((__m256i *)(dstu + 2 * x), u);
+        _mm256_storeu_si256((__m256i *)(dstv + 2 * x), v);
+    }
+    SplitLine(dstu + 2 * x, dstv + 2 * x, src + 4 * x, count - x, 2, bitshift);
+}
+
+VLC_AVX2
+static void AVX2_CopyPlane(uint8_t *dst, size_t dst_pitch,
+                           const uint8_t *src, size_t src_pitch,
+                           unsigned height, int bitshift)
+{
+    const size_t copy_pitch = __MIN(src_pitch, dst_pitch);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+#ifdef COPY_AVX512
+        if (vlc_CPU_AVX512())
+            AVX512_CopyLine(dst, src, copy_pitch, bitshift);
+        else
+#endif
+            AVX2_CopyLine(dst, src, copy_pitch, bitshift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+    _mm_sfence();
+}
+
+VLC_AVX2
+static void AVX2_SplitPlanes(uint8_t *dstu, size_t dstu_pitch,
+                             uint8_t *dstv, size_t dstv_pitch,
+                             const uint8_t *src, size_t src_pitch,
+                             unsigned height, unsigned pixel_size,
+                             int bitshift)
+{
+    const size_t count = __MIN(__MIN(src_pitch / (2 * pixel_size),
+                                     dstu_pitch / pixel_size),
+                               dstv_pitch / pixel_size);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+        if (pixel_size == 1)
+            AVX2_SplitLine8(dstu, dstv, src, count);
+#ifdef COPY_AVX512
+        else if (vlc_CPU_AVX512())
+            AVX512_SplitLine16(dstu, dstv, src, count, bitshift);
+#endif
+        else
+            AVX2_SplitLine16(dstu, dstv, src, count, bitshift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+    _mm_sfence();
+}
+
+static void AVX2_Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
+                                 const size_t src_pitch[static 2],
+                                 unsigned height, unsigned pixel_size,
+                                 int bitshift)
+{
+    AVX2_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
+                   src[0], src_pitch[0], height, bitshift);
+    AVX2_SplitPlanes(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                     dst->p[2].p_pixels, dst->p[2].i_pitch,
+                     src[1], src_pitch[1], (height+1)/2, pixel_size, bitshift);
+}
+#endif /* COPY_AVX2 */
+
+#ifdef COPY_NEON
+static void NEON_CopyPlane(uint8_t *dst, size_t dst_pitch,
+                           const uint8_t *src, size_t src_pitch,
+                           unsigned height, int bitshift)
+{
+    const size_t copy_pitch = __MIN(src_pitch, dst_pitch);
+
+    if (bitshift == 0 || ((uintptr_t) src & 1) || ((uintptr_t) dst & 1))
+    {
+        CopyPlane(dst, dst_pitch, src, src_pitch, height, bitshift);
+        return;
+    }
+
+    /* negative counts shift right */
+    const int16x8_t shift = vdupq_n_s16(-bitshift);
+    for (unsigned y = 0; y < height; y++)
+    {
+        const uint16_t *src16 = (const uint16_t *) src;
+        uint16_t *dst16 = (uint16_t *) dst;
+        size_t x = 0;
+
+        for (; x + 8 <= copy_pitch / 2; x += 8)
+            vst1q_u16(dst16 + x, vshlq_u16(vld1q_u16(src16 + x), shift));
+        CopyLine((uint8_t *)(dst16 + x), (const uint8_t *)(src16 + x),
+                 copy_pitch - 2 * x, bitshift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+
+static void NEON_SplitPlanes(uint8_t *dstu, size_t dstu_pitch,
+                             uint8_t *dstv, size_t dstv_pitch,
+                             const uint8_t *src, size_t src_pitch,
+                             unsigned height, unsigned pixel_size,
+                             int bitshift)
+{
+    const size_t count = __MIN(__MIN(src_pitch / (2 * pixel_size),
+                                     dstu_pitch / pixel_size),
+                               dstv_pitch / pixel_size);
+    const int16x8_t shift = vdupq_n_s16(-bitshift);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+        size_t x = 0;
+
+        if (pixel_size == 1)
+        {
+            for (; x + 16 <= count; x += 16)
+            {
+                uint8x16x2_t uv = vld2q_u8(src + 2 * x);
+                vst1q_u8(dstu + x, uv.val[0]);
+                vst1q_u8(dstv + x, uv.val[1]);
+            }
+        }
+        else if (!((uintptr_t) src & 1))
+        {
+            const uint16_t *src16 = (const uint16_t *) src;
+            uint16_t *dstu16 = (uint16_t *) dstu, *dstv16 = (uint16_t *) dstv;
+
+            for (; x + 8 <= count; x += 8)
+            {
+                uint16x8x2_t uv = vld2q_u16(src16 + 2 * x);
+                vst1q_u16(dstu16 + x, vshlq_u16(uv.val[0], shift));
+                vst1q_u16(dstv16 + x, vshlq_u16(uv.val[1], shift));
+            }
+        }
+        SplitLine(dstu + pixel_size * x, dstv + pixel_size * x,
+                  src + 2 * pixel_size * x, count - x, pixel_size, bitshift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+static void NEON_Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
+                                 const size_t src_pitch[static 2],
+                                 unsigned height, unsigned pixel_size,
+                                 int bitshift)
+{
+    NEON_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
+                   src[0], src_pitch[0], height, bitshift);
+    NEON_SplitPlanes(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                     dst->p[2].p_pixels, dst->p[2].i_pitch,
+                     src[1], src_pitch[1], (height+1)/2, pixel_size, bitshift);
+}
+#endif /* COPY_NEON */
+
+#ifdef COPY_WASM
+static inline v128_t WASM_Shift16(v128_t v, int bitshift)
+{
+    if (bitshift > 0)
+        return wasm_u16x8_shr(v, bitshift & 0xf);
+    return wasm_i16x8_shl(v, (-bitshift) & 0xf);
+}
+
+static void WASM_CopyPlane(uint8_t *dst, size_t dst_pitch,
+                           const uint8_t *src, size_t src_pitch,
+                           unsigned height, int bitshift)
+{
+    const size_t copy_pitch = __MIN(src_pitch, dst_pitch);
+
+    if (bitshift == 0)
+    {
+        CopyPlane(dst, dst_pitch, src, src_pitch, height, bitshift);
+        return;
+    }
+
+    /* WebAssembly loads and stores need no alignment */
+    for (unsigned y = 0; y < height; y++)
+    {
+        size_t x = 0;
+
+        for (; x + 16 <= copy_pitch; x += 16)
+            wasm_v128_store(dst + x,
+                            WASM_Shift16(wasm_v128_load(src + x), bitshift));
+        CopyLine(dst + x, src + x, copy_pitch - x, bitshift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+
+static void WASM_SplitPlanes(uint8_t *dstu, size_t dstu_pitch,
+                             uint8_t *dstv, size_t dstv_pitch,
+                             const uint8_t *src, size_t src_pitch,
+                             unsigned height, unsigned pixel_size,
+                             int bitshift)
+{
+    const size_t count = __MIN(__MIN(src_pitch / (2 * pixel_size),
+                                     dstu_pitch / pixel_size),
+                               dstv_pitch / pixel_size);
+
+    for (unsigned y = 0; y < height; y++)
+    {
+        size_t x = 0;
+
+        if (pixel_size == 1)
+        {
+            for (; x + 16 <= count; x += 16)
+            {
+                v128_t a = wasm_v128_load(src + 2 * x);
+                v128_t b = wasm_v128_load(src + 2 * x + 16);
+                wasm_v128_store(dstu + x, wasm_i8x16_shuffle(a, b,
+                    0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30));
+                wasm_v128_store(dstv + x, wasm_i8x16_shuffle(a, b,
+                    1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31));
+            }
+        }
+        else
+        {
+            for (; x + 8 <= count; x += 8)
+            {
+                v128_t a = wasm_v128_load(src + 4 * x);
+                v128_t b = wasm_v128_load(src + 4 * x + 16);
+                v128_t u = wasm_i16x8_shuffle(a, b, 0, 2, 4, 6, 8, 10, 12, 14);
+                v128_t v = wasm_i16x8_shuffle(a, b, 1, 3, 5, 7, 9, 11, 13, 15);
+                if (bitshift != 0)
+                {
+                    u = WASM_Shift16(u, bitshift);
+                    v = WASM_Shift16(v, bitshift);
+                }
+                wasm_v128_store(dstu + 2 * x, u);
+                wasm_v128_store(dstv + 2 * x, v);
+            }
+        }
+        SplitLine(dstu + pixel_size * x, dstv + pixel_size * x,
+                  src + 2 * pixel_size * x, count - x, pixel_size, bitshift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+static void WASM_Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
+                                 const size_t src_pitch[static 2],
+                                 unsigned height, unsigned pixel_size,
+                                 int bitshift)
+{
+    WASM_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
+                   src[0], src_pitch[0], height, bitshift);
+    WASM_SplitPlanes(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                     dst->p[2].p_pixels, dst->p[2].i_pitch,
+                     src[1], src_pitch[1], (height+1)/2, pixel_size, bitshift);
+}
+#endif /* COPY_WASM */
+
 static void CopyPlane(uint8_t *dst, size_t dst_pitch,
                       const uint8_t *src, size_t src_pitch,
                       unsigned height, int bitshift)
@@ -648,6 +1139,11 @@ void CopyPacked(picture_t *dst, const uint8_t *src, const size_t src_pitch,
     assert(src); assert(src_pitch);
     assert(height);
 
+#ifdef COPY_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch, src, src_pitch,
+                              height, 0);
+#endif
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE4_1())
         return SSE_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch, src, src_pitch,
@@ -664,6 +1160,16 @@ void Copy420_SP_to_SP(picture_t *dst, const uint8_t *src[static 2],
                       const copy_cache_t *cache)
 {
     ASSERT_2PLANES;
+#ifdef COPY_AVX2
+    if (vlc_CPU_AVX2())
+    {
+        AVX2_CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
+                       src[0], src_pitch[0], height, 0);
+        AVX2_CopyPlane(dst->p[1].p_pixels, dst->p[1].i_pitch,
+                       src[1], src_pitch[1], (height+1)/2, 0);
+        return;
+    }
+#endif
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_SP_to_SP(dst, src, src_pitch, height, cache);
@@ -741,12 +1247,24 @@ void Copy420_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
                      const copy_cache_t *cache)
 {
     ASSERT_2PLANES;
+#ifdef COPY_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_Copy420_SP_to_P(dst, src, src_pitch, height, 1, 0);
+#endif
 #ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return SSE_Copy420_SP_to_P(dst, src, src_pitch, height, 1, 0, cache);
 #else
     VLC_UNUSED(cache);
 #endif
+#ifdef COPY_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_Copy420_SP_to_P(dst, src, src_pitch, height, 1, 0);
+#endif
+#ifdef COPY_WASM
+    /* SIMD is a build-time feature of the WebAssembly module */
+    return WASM_Copy420_SP_to_P(dst, src, src_pitch, height, 1, 0);
+#endif
 
     CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
               src[0], src_pitch[0], height, 0);
@@ -762,12 +1280,23 @@ void Copy420_16_SP_to_P(picture_t *dst, const uint8_t *src[static 2],
     ASSERT_2PLANES;
     assert(bitshift >= -6 && bitshift <= 6 && (bitshift % 2 == 0));
 
+#ifdef COPY_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_Copy420_SP_to_P(dst, src, src_pitch, height, 2, bitshift);
+#endif
 #ifdef CAN_COMPILE_SSE3
     if (vlc_CPU_SSSE3())
         return SSE_Copy420_SP_to_P(dst, src, src_pitch, height, 2, bitshift, cache);
 #else
     VLC_UNUSED(cache);
 #endif
+#ifdef COPY_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_Copy420_SP_to_P(dst, src, src_pitch, height, 2, bitshift);
+#endif
+#ifdef COPY_WASM
+    return WASM_Copy420_SP_to_P(dst, src, src_pitch, height, 2, bitshift);
+#endif
 
     CopyPlane(dst->p[0].p_pixels, dst->p[0].i_pitch,
               src[0], src_pitch[0], height, bitshift);
@@ -982,7 +1511,8 @@ static const struct test_conv convs[] = {
                 { VLC_CODEC_NV12, 0, .conv = Copy420_P_to_SP } },
     },
     { .src_chroma = VLC_CODEC_P010,
-      .dsts = { { VLC_CODEC_I420_10L, 6, .conv16 = Copy420_16_SP_to_P } },
+      .dsts = { { VLC_CODEC_I420_10L, 6, .conv16 = Copy420_16_SP_to_P },
+                { VLC_CODEC_P010, 0, .conv = Copy420_SP_to_SP } },
     },
     { .src_chroma = VLC_CODEC_I420_10L,
       .dsts = { { VLC_CODEC_P010, -6, .conv16 = Copy420_16_P_to_SP } },
@@ -40,6 +40,7 @@
 #endif
 
 #include "i420_yuy2.h"
+#include "slices.h"
 
 #define SRC_FOURCC  "I420,IYUV,YV12"
 
@@ -78,11 +79,11 @@ vlc_module_begin ()
 #endif
 vlc_module_end ()
 
-VIDEO_FILTER_WRAPPER( I420_YUY2 )
-VIDEO_FILTER_WRAPPER( I420_YVYU )
-VIDEO_FILTER_WRAPPER( I420_UYVY )
+CHROMA_SLICES_WRAPPER( I420_YUY2 )
+CHROMA_SLICES_WRAPPER( I420_YVYU )
+CHROMA_SLICES_WRAPPER( I420_UYVY )
 #if defined (PLUGIN_PLAIN)
-VIDEO_FILTER_WRAPPER( I420_Y211 )
+CHROMA_SLICES_WRAPPER( I420_Y211 )
 #endif
 
 static const struct vlc_filter_operations *
@@ -134,10 +135,19 @@ static int Activate( filter_t *p_filter )
         return VLC_EGENERIC;
 
     /* Find the adequate filter function depending on the output format. */
-    p_filter->ops = GetFilterOperations( p_filter );
-    if( p_filter->ops == NULL )
+    const struct vlc_filter_operations *ops = GetFilterOperations( p_filter );
+    if( ops == NULL )
         return VLC_EGENERIC;
 
+    /* Bands of 4 lines keep every conversion path usable */
+    p_filter->p_sys = chroma_slices_New( p_filter,
+                                         p_filter->fmt_in.video.i_y_offset
+                                         + p_filter->fmt_in.video.i_visible_height,
+                                         4 );
+    if( p_filter->p_sys == NULL )
+        return VLC_ENOMEM;
+    p_filter->ops = ops;
+
     return VLC_SUCCESS;
 }
 
@@ -158,7 +168,7 @@ static inline unsigned long long read_cycles(void)
  *****************************************************************************/
 VLC_TARGET
 static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint8_t *p_line1, *p_line2 = p_dest->p->p_pixels;
     uint8_t *p_y1, *p_y2 = p_source->Y_PIXELS;
@@ -193,10 +203,10 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
     vector unsigned char y_vec;
 
     if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 32 ) |
-           ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 2 ) ) )
+           ( i_lines % 2 ) ) )
     {
         /* Width is a multiple of 32, we take 2 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             VEC_NEXT_LINES( );
             for( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 32 ; i_x-- ; )
@@ -210,10 +220,10 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
 #warning FIXME: converting widths % 16 but !widths % 32 is broken on altivec
 #if 0
     else if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 16 ) |
-                ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 4 ) ) )
+                ( i_lines % 4 ) ) )
     {
         /* Width is only a multiple of 16, we take 4 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 4 ; i_y-- ; )
+        for( i_y = i_lines / 4 ; i_y-- ; )
         {
             /* Line 1 and 2, pixels 0 to ( width - 16 ) */
             VEC_NEXT_LINES( );
@@ -261,7 +271,7 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
                                - ( p_filter->fmt_out.video.i_x_offset * 2 );
 
 #if !defined(PLUGIN_SSE2)
-    for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+    for( i_y = i_lines / 2 ; i_y-- ; )
     {
         p_line1 = p_line2;
         p_line2 += p_dest->p->i_pitch;
@@ -301,7 +311,7 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
         ((intptr_t)p_line2|(intptr_t)p_y2))) )
     {
         /* use faster SSE2 aligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -327,7 +337,7 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
     else
     {
         /* use slower SSE2 unaligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -361,7 +371,7 @@ static void I420_YUY2( filter_t *p_filter, picture_t *p_source,
  *****************************************************************************/
 VLC_TARGET
 static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint8_t *p_line1, *p_line2 = p_dest->p->p_pixels;
     uint8_t *p_y1, *p_y2 = p_source->Y_PIXELS;
@@ -396,10 +406,10 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
     vector unsigned char y_vec;
 
     if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 32 ) |
-           ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 2 ) ) )
+           ( i_lines % 2 ) ) )
     {
         /* Width is a multiple of 32, we take 2 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             VEC_NEXT_LINES( );
             for( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 32 ; i_x-- ; )
@@ -411,10 +421,10 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
         }
     }
     else if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 16 ) |
-                ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 4 ) ) )
+                ( i_lines % 4 ) ) )
     {
         /* Width is only a multiple of 16, we take 4 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 4 ; i_y-- ; )
+        for( i_y = i_lines / 4 ; i_y-- ; )
         {
             /* Line 1 and 2, pixels 0 to ( width - 16 ) */
             VEC_NEXT_LINES( );
@@ -461,7 +471,7 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
                                - ( p_filter->fmt_out.video.i_x_offset * 2 );
 
 #if !defined(PLUGIN_SSE2)
-    for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+    for( i_y = i_lines / 2 ; i_y-- ; )
     {
         p_line1 = p_line2;
         p_line2 += p_dest->p->i_pitch;
@@ -500,7 +510,7 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
         ((intptr_t)p_line2|(intptr_t)p_y2))) )
     {
         /* use faster SSE2 aligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -526,7 +536,7 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
     else
     {
         /* use slower SSE2 unaligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -559,7 +569,7 @@ static void I420_YVYU( filter_t *p_filter, picture_t *p_source,
  *****************************************************************************/
 VLC_TARGET
 static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint8_t *p_line1, *p_line2 = p_dest->p->p_pixels;
     uint8_t *p_y1, *p_y2 = p_source->Y_PIXELS;
@@ -594,10 +604,10 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
     vector unsigned char y_vec;
 
     if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 32 ) |
-           ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 2 ) ) )
+           ( i_lines % 2 ) ) )
     {
         /* Width is a multiple of 32, we take 2 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             VEC_NEXT_LINES( );
             for( i_x = (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) / 32 ; i_x-- ; )
@@ -609,10 +619,10 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
         }
     }
     else if( !( ( (p_filter->fmt_in.video.i_x_offset + p_filter->fmt_in.video.i_visible_width) % 16 ) |
-                ( (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) % 4 ) ) )
+                ( i_lines % 4 ) ) )
     {
         /* Width is only a multiple of 16, we take 4 lines at a time */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 4 ; i_y-- ; )
+        for( i_y = i_lines / 4 ; i_y-- ; )
         {
             /* Line 1 and 2, pixels 0 to ( width - 16 ) */
             VEC_NEXT_LINES( );
@@ -659,7 +669,7 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
                                - ( p_filter->fmt_out.video.i_x_offset * 2 );
 
 #if !defined(PLUGIN_SSE2)
-    for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+    for( i_y = i_lines / 2 ; i_y-- ; )
     {
         p_line1 = p_line2;
         p_line2 += p_dest->p->i_pitch;
@@ -698,7 +708,7 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
         ((intptr_t)p_line2|(intptr_t)p_y2))) )
     {
         /* use faster SSE2 aligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -724,7 +734,7 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
     else
     {
         /* use slower SSE2 unaligned fetch and store */
-        for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+        for( i_y = i_lines / 2 ; i_y-- ; )
         {
             p_line1 = p_line2;
             p_line2 += p_dest->p->i_pitch;
@@ -757,7 +767,7 @@ static void I420_UYVY( filter_t *p_filter, picture_t *p_source,
  *****************************************************************************/
 #if defined (PLUGIN_PLAIN)
 static void I420_Y211( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint8_t *p_line1, *p_line2 = p_dest->p->p_pixels;
     uint8_t *p_y1, *p_y2 = p_source->Y_PIXELS;
@@ -776,7 +786,7 @@ static void I420_Y211( filter_t *p_filter, picture_t *p_source,
                                - p_dest->p->i_visible_pitch
                                - ( p_filter->fmt_out.video.i_x_offset * 2 );
 
-    for( i_y = (p_filter->fmt_in.video.i_y_offset + p_filter->fmt_in.video.i_visible_height) / 2 ; i_y-- ; )
+    for( i_y = i_lines / 2 ; i_y-- ; )
     {
         p_line1 = p_line2;
         p_line2 += p_dest->p->i_pitch;
@@ -34,6 +34,8 @@
 #include <vlc_filter.h>
 #include <vlc_picture.h>
 
+#include "slices.h"
+
 #define SRC_FOURCC  "I422,J422"
 #define DEST_FOURCC "I420,IYUV,J420,YV12,YUVA"
 
@@ -50,9 +52,9 @@ vlc_module_begin ()
     set_callback_video_converter( Activate, 60 )
 vlc_module_end ()
 
-VIDEO_FILTER_WRAPPER( I422_I420 )
-VIDEO_FILTER_WRAPPER( I422_YV12 )
-VIDEO_FILTER_WRAPPER( I422_YUVA )
+CHROMA_SLICES_WRAPPER( I422_I420 )
+CHROMA_SLICES_WRAPPER( I422_YV12 )
+CHROMA_SLICES_WRAPPER( I422_YUVA )
 
 /*****************************************************************************
  * Activate: allocate a chroma function
@@ -99,6 +101,11 @@ static int Activate( filter_t *p_filter )
         default:
             return -1;
     }
+
+    p_filter->p_sys = chroma_slices_New( p_filter,
+                                         p_filter->fmt_in.video.i_height, 2 );
+    if( p_filter->p_sys == NULL )
+        return VLC_ENOMEM;
     return 0;
 }
 
@@ -108,14 +115,14 @@ static int Activate( filter_t *p_filter )
  * I422_I420: planar YUV 4:2:2 to planar I420 4:2:0 Y:U:V
  *****************************************************************************/
 static void I422_I420( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint16_t i_dpy = p_dest->p[Y_PLANE].i_pitch;
     uint16_t i_spy = p_source->p[Y_PLANE].i_pitch;
     uint16_t i_dpuv = p_dest->p[U_PLANE].i_pitch;
     uint16_t i_spuv = p_source->p[U_PLANE].i_pitch;
     uint16_t i_width = p_filter->fmt_in.video.i_width;
-    uint16_t i_y = p_filter->fmt_in.video.i_height;
+    uint16_t i_y = i_lines;
     uint8_t *p_dy = p_dest->Y_PIXELS + (i_y-1)*i_dpy;
     uint8_t *p_y = p_source->Y_PIXELS + (i_y-1)*i_spy;
     uint8_t *p_du = p_dest->U_PIXELS + (i_y/2-1)*i_dpuv;
@@ -137,14 +144,14 @@ static void I422_I420( filter_t *p_filter, picture_t *p_source,
  * I422_YV12: planar YUV 4:2:2 to planar YV12 4:2:0 Y:V:U
  *****************************************************************************/
 static void I422_YV12( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
     uint16_t i_dpy = p_dest->p[Y_PLANE].i_pitch;
     uint16_t i_spy = p_source->p[Y_PLANE].i_pitch;
     uint16_t i_dpuv = p_dest->p[U_PLANE].i_pitch;
     uint16_t i_spuv = p_source->p[U_PLANE].i_pitch;
     uint16_t i_width = p_filter->fmt_in.video.i_width;
-    uint16_t i_y = p_filter->fmt_in.video.i_height;
+    uint16_t i_y = i_lines;
     uint8_t *p_dy = p_dest->Y_PIXELS + (i_y-1)*i_dpy;
     uint8_t *p_y = p_source->Y_PIXELS + (i_y-1)*i_spy;
     uint8_t *p_du = p_dest->V_PIXELS + (i_y/2-1)*i_dpuv; /* U and V are swapped */
@@ -166,9 +173,9 @@ static void I422_YV12( filter_t *p_filter, picture_t *p_source,
  * I422_YUVA: planar YUV 4:2:2 to planar YUVA 4:2:0:4 Y:U:V:A
  *****************************************************************************/
 static void I422_YUVA( filter_t *p_filter, picture_t *p_source,
-                                           picture_t *p_dest )
+                                           picture_t *p_dest, unsigned i_lines )
 {
-    I422_I420( p_filter, p_source, p_dest );
+    I422_I420( p_filter, p_source, p_dest, i_lines );
     memset( p_dest->p[A_PLANE].p_pixels, 0xff,
                 p_dest->p[A_PLANE].i_lines * p_dest->p[A_PLANE].i_pitch );
 }
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * slices.c: band threaded chroma conversion helper
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+#include <vlc_slices.h>
+
+#include "slices.h"
+
+/* Automatic threading is only used from this picture area */
+#define SLICES_MIN_AREA (1920 * 1080)
+
+struct chroma_slices
+{
+    vlc_slices_t *slices;
+    unsigned i_lines;
+    unsigned i_align;
+};
+
+struct chroma_slice_job
+{
+    const chroma_slices_t *owner;
+    filter_t *p_filter;
+    picture_t *p_src;
+    picture_t *p_dst;
+    chroma_slice_cb cb;
+};
+
+static void RunBand(void *opaque, unsigned i_slice, unsigned i_slices)
+{
+    const struct chroma_slice_job *job = opaque;
+    const chroma_slices_t *slices = job->owner;
+    unsigned i_start, i_end;
+    picture_t src, dst;
+
+    vlc_slices_GetRange(slices->i_lines, i_slice, i_slices, slices->i_align,
+                        &i_start, &i_end);
+    vlc_slices_GetView(&src, job->p_src, i_start, i_end);
+    vlc_slices_GetView(&dst, job->p_dst, i_start, i_end);
+    job->cb(job->p_filter, &src, &dst, i_end - i_start);
+}
+
+chroma_slices_t *chroma_slices_New(filter_t *p_filter, unsigned i_lines,
+                                   unsigned i_align)
+{
+    unsigned i_threads = var_InheritInteger(p_filter, "chroma-threads");
+    /* Conversions are cheaper than filters, only thread large pictures */
+    if (i_threads == 0
+     && (uint64_t)p_filter->fmt_in.video.i_width * i_lines < SLICES_MIN_AREA)
+        i_threads = 1;
+
+    chroma_slices_t *slices = malloc(sizeof(*slices));
+    if (unlikely(slices == NULL))
+        return NULL;
+
+    slices->slices = vlc_slices_New(p_filter, i_threads,
+                                    p_filter->fmt_in.video.i_width, i_lines);
+    if (unlikely(slices->slices == NULL))
+    {
+        free(slices);
+        return NULL;
+    }
+    slices->i_lines = i_lines;
+    slices->i_align = i_align;
+    return slices;
+}
+
+void chroma_slices_Delete(chroma_slices_t *slices)
+{
+    vlc_slices_Delete(slices->slices);
+    free(slices);
+}
+
+void chroma_slices_Run(chroma_slices_t *slices, filter_t *p_filter,
+                       picture_t *p_src, picture_t *p_dst, chroma_slice_cb cb)
+{
+    if (vlc_slices_Count(slices->slices) == 1)
+    {
+        cb(p_filter, p_src, p_dst, slices->i_lines);
+        return;
+    }
+
+    struct chroma_slice_job job = {
+        .owner = slices, .p_filter = p_filter,
+        .p_src = p_src, .p_dst = p_dst, .cb = cb,
+    };
+    vlc_slices_Run(slices->slices, RunBand, &job);
+}
+
+void chroma_slices_Close(filter_t *p_filter)
+{
+    chroma_slices_Delete(p_filter->p_sys);
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * slices.h: band threaded chroma conversion helper
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_VIDEOCHROMA_SLICES_H_
+#define VLC_VIDEOCHROMA_SLICES_H_
+
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+/**
+ * Converts a band of pictures.
+ *
+ * The source and destination pictures are views starting at the first line
+ * of the band, and i_lines is the number of (luma) lines of the band. The
+ * function must not write any state shared with other bands.
+ */
+typedef void (*chroma_slice_cb)(filter_t *, picture_t *, picture_t *,
+                                unsigned i_lines);
+
+typedef struct chroma_slices chroma_slices_t;
+
+/**
+ * Creates the conversion helper of a filter.
+ *
+ * \param i_lines number of lines converted for each picture
+ * \param i_align alignment of the bands (in lines), for subsampled planes
+ *
+ * The pictures are converted on the calling thread only when threading is
+ * disabled ("chroma-threads") or the pictures are too small to benefit.
+ */
+chroma_slices_t *chroma_slices_New(filter_t *, unsigned i_lines,
+                                   unsigned i_align);
+void chroma_slices_Delete(chroma_slices_t *);
+
+/**
+ * Converts the pictures, splitting them in horizontal bands.
+ */
+void chroma_slices_Run(chroma_slices_t *, filter_t *,
+                       picture_t *p_src, picture_t *p_dst, chroma_slice_cb);
+
+/**
+ * Close callback for filters whose p_sys is the helper.
+ */
+void chroma_slices_Close(filter_t *);
+
+/**
+ * Same as VIDEO_FILTER_WRAPPER for slice converters: p_filter->p_sys must
+ * be a chroma_slices_t.
+ */
+#define CHROMA_SLICES_WRAPPER( name )                                   \
+    static void name (filter_t *, picture_t *, picture_t *, unsigned);  \
+    static picture_t *name ## _Filter ( filter_t *p_filter,             \
+                                        picture_t *p_pic )              \
+    {                                                                   \
+        picture_t *p_outpic = filter_NewPicture( p_filter );            \
+        if( p_outpic )                                                  \
+        {                                                               \
+            chroma_slices_Run( p_filter->p_sys, p_filter,               \
+                               p_pic, p_outpic, name );                 \
+            picture_CopyProperties( p_outpic, p_pic );                  \
+        }                                                               \
+        picture_Release( p_pic );                                       \
+        return p_outpic;                                                \
+    }                                                                   \
+    static const struct vlc_filter_operations name ## _ops = {          \
+        .filter_video = name ## _Filter, .close = chroma_slices_Close,  \
+    };
+
+#endif
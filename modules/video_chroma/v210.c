@@ -0,0 +1,536 @@
+/*****************************************************************************
+ * v210.c: v210 packing and unpacking
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+
+#include "v210.h"
+
+#if defined(CAN_COMPILE_SSSE3) && defined(HAVE_SSE2_INTRINSICS)
+# define V210_SSSE3 1
+# include <tmmintrin.h>
+# ifdef __SSSE3__
+#  define VLC_SSSE3
+# else
+#  define VLC_SSSE3 __attribute__ ((__target__ ("ssse3")))
+# endif
+#endif
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# define V210_AVX2 1
+# include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && !defined(WORDS_BIGENDIAN)
+# define V210_NEON 1
+# include <arm_neon.h>
+#endif
+
+/*
+ * Each group of 6 pixels is made of the words:
+ *   U0 Y0 V0, Y1 U1 Y2, V1 Y3 U2, Y4 V2 Y5
+ * with the first sample in the 10 least significant bits.
+ */
+
+static void UnpackGroup(const uint8_t *src, uint16_t y[6], uint16_t u[3],
+                        uint16_t v[3])
+{
+    uint32_t w0 = GetDWLE(src), w1 = GetDWLE(src + 4),
+             w2 = GetDWLE(src + 8), w3 = GetDWLE(src + 12);
+
+    u[0] =  w0        & 0x3FF;
+    y[0] = (w0 >> 10) & 0x3FF;
+    v[0] = (w0 >> 20) & 0x3FF;
+    y[1] =  w1        & 0x3FF;
+    u[1] = (w1 >> 10) & 0x3FF;
+    y[2] = (w1 >> 20) & 0x3FF;
+    v[1] =  w2        & 0x3FF;
+    y[3] = (w2 >> 10) & 0x3FF;
+    u[2] = (w2 >> 20) & 0x3FF;
+    y[4] =  w3        & 0x3FF;
+    v[2] = (w3 >> 10) & 0x3FF;
+    y[5] = (w3 >> 20) & 0x3FF;
+}
+
+static inline uint32_t clip(unsigned a)
+{
+    if      (a < 4)    return 4;
+    else if (a > 1019) return 1019;
+    else               return a;
+}
+
+static void PackGroup(uint8_t *dst, const uint16_t y[6], const uint16_t u[3],
+                      const uint16_t v[3])
+{
+    SetDWLE(dst,      clip(u[0]) | (clip(y[0]) << 10) | (clip(v[0]) << 20));
+    SetDWLE(dst + 4,  clip(y[1]) | (clip(u[1]) << 10) | (clip(y[2]) << 20));
+    SetDWLE(dst + 8,  clip(v[1]) | (clip(y[3]) << 10) | (clip(u[2]) << 20));
+    SetDWLE(dst + 12, clip(y[4]) | (clip(v[2]) << 10) | (clip(y[5]) << 20));
+}
+
+/*
+ * The vector kernels convert whole groups, and return the count of
+ * converted pixels, a multiple of 6.
+ *
+ * The x86 kernels store 8 luma and 4 chroma samples per group: the extra
+ * samples are overwritten by the next group, or by the scalar tail, which
+ * always follows.
+ */
+#ifdef V210_SSSE3
+# define M(x) ((char)(x))
+# define Z M(0x80)
+/* From ab = U0 Y1 V1 Y4 Y0 U1 Y3 V2 and cc = V0 Y2 U2 Y5 */
+# define UNPACK_Y_AB    8, 9, 2, 3, Z, Z,12,13, 6, 7, Z, Z, Z, Z, Z, Z
+# define UNPACK_Y_CC    Z, Z, Z, Z, 2, 3, Z, Z, Z, Z, 6, 7, Z, Z, Z, Z
+# define UNPACK_UV_AB   0, 1,10,11, Z, Z, Z, Z, Z, Z, 4, 5,14,15, Z, Z
+# define UNPACK_UV_CC   Z, Z, Z, Z, 4, 5, Z, Z, 0, 1, Z, Z, Z, Z, Z, Z
+/* To the words low, middle and high samples, from Y and UV interleaved */
+# define PACK_A_UV      0, 1, Z, Z, Z, Z, Z, Z, 6, 7, Z, Z, Z, Z, Z, Z
+# define PACK_A_Y       Z, Z, Z, Z, 2, 3, Z, Z, Z, Z, Z, Z, 8, 9, Z, Z
+# define PACK_B_UV      Z, Z, Z, Z, 4, 5, Z, Z, Z, Z, Z, Z,10,11, Z, Z
+# define PACK_B_Y       0, 1, Z, Z, Z, Z, Z, Z, 6, 7, Z, Z, Z, Z, Z, Z
+# define PACK_C_UV      2, 3, Z, Z, Z, Z, Z, Z, 8, 9, Z, Z, Z, Z, Z, Z
+# define PACK_C_Y       Z, Z, Z, Z, 4, 5, Z, Z, Z, Z, Z, Z,10,11, Z, Z
+
+VLC_SSSE3
+static unsigned SSSE3_Unpack(const uint8_t *src, uint16_t *y, uint16_t *u,
+                             uint16_t *v, unsigned width)
+{
+    const __m128i mask = _mm_set1_epi32(0x3FF);
+    const __m128i y_ab = _mm_setr_epi8(UNPACK_Y_AB);
+    const __m128i y_cc = _mm_setr_epi8(UNPACK_Y_CC);
+    const __m128i uv_ab = _mm_setr_epi8(UNPACK_UV_AB);
+    const __m128i uv_cc = _mm_setr_epi8(UNPACK_UV_CC);
+    unsigned x = 0;
+
+    for (; x + 8 <= width; x += 6, src += 16) {
+        __m128i w = _mm_loadu_si128((const __m128i *)src);
+        __m128i a = _mm_and_si128(w, mask);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(w, 10), mask);
+        __m128i c = _mm_and_si128(_mm_srli_epi32(w, 20), mask);
+        __m128i ab = _mm_packs_epi32(a, b);
+        __m128i cc = _mm_packs_epi32(c, c);
+        __m128i yy = _mm_or_si128(_mm_shuffle_epi8(ab, y_ab),
+                                  _mm_shuffle_epi8(cc, y_cc));
+        __m128i uv = _mm_or_si128(_mm_shuffle_epi8(ab, uv_ab),
+                                  _mm_shuffle_epi8(cc, uv_cc));
+
+        _mm_storeu_si128((__m128i *)&y[x], yy);
+        _mm_storel_epi64((__m128i *)&u[x / 2], uv);
+        _mm_storel_epi64((__m128i *)&v[x / 2], _mm_srli_si128(uv, 8));
+    }
+    return x;
+}
+
+VLC_SSSE3
+static unsigned SSSE3_Pack(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                           const uint16_t *v, unsigned width)
+{
+    const __m128i lo = _mm_set1_epi16(4), hi = _mm_set1_epi16(1019);
+    const __m128i a_uv = _mm_setr_epi8(PACK_A_UV), a_y = _mm_setr_epi8(PACK_A_Y);
+    const __m128i b_uv = _mm_setr_epi8(PACK_B_UV), b_y = _mm_setr_epi8(PACK_B_Y);
+    const __m128i c_uv = _mm_setr_epi8(PACK_C_UV), c_y = _mm_setr_epi8(PACK_C_Y);
+    unsigned x = 0;
+
+    for (; x + 8 <= width; x += 6, dst += 16) {
+        __m128i yy = _mm_loadu_si128((const __m128i *)&y[x]);
+        __m128i uv = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&u[x / 2]),
+                                        _mm_loadl_epi64((const __m128i *)&v[x / 2]));
+
+        yy = _mm_min_epi16(_mm_max_epi16(yy, lo), hi);
+        uv = _mm_min_epi16(_mm_max_epi16(uv, lo), hi);
+
+        __m128i a = _mm_or_si128(_mm_shuffle_epi8(uv, a_uv), _mm_shuffle_epi8(yy, a_y));
+        __m128i b = _mm_or_si128(_mm_shuffle_epi8(uv, b_uv), _mm_shuffle_epi8(yy, b_y));
+        __m128i c = _mm_or_si128(_mm_shuffle_epi8(uv, c_uv), _mm_shuffle_epi8(yy, c_y));
+        __m128i w = _mm_or_si128(a, _mm_or_si128(_mm_slli_epi32(b, 10),
+                                                 _mm_slli_epi32(c, 20)));
+        _mm_storeu_si128((__m128i *)dst, w);
+    }
+    return x;
+}
+#endif
+
+#ifdef V210_AVX2
+/* Two groups per vector, one per 128-bit lane, with the SSSE3 shuffles */
+VLC_AVX2
+static unsigned AVX2_Unpack(const uint8_t *src, uint16_t *y, uint16_t *u,
+                            uint16_t *v, unsigned width)
+{
+    const __m256i mask = _mm256_set1_epi32(0x3FF);
+    const __m256i y_ab = _mm256_setr_epi8(UNPACK_Y_AB, UNPACK_Y_AB);
+    const __m256i y_cc = _mm256_setr_epi8(UNPACK_Y_CC, UNPACK_Y_CC);
+    const __m256i uv_ab = _mm256_setr_epi8(UNPACK_UV_AB, UNPACK_UV_AB);
+    const __m256i uv_cc = _mm256_setr_epi8(UNPACK_UV_CC, UNPACK_UV_CC);
+    unsigned x = 0;
+
+    for (; x + 14 <= width; x += 12, src += 32) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)src);
+        __m256i a = _mm256_and_si256(w, mask);
+        __m256i b = _mm256_and_si256(_mm256_srli_epi32(w, 10), mask);
+        __m256i c = _mm256_and_si256(_mm256_srli_epi32(w, 20), mask);
+        __m256i ab = _mm256_packs_epi32(a, b);
+        __m256i cc = _mm256_packs_epi32(c, c);
+        __m256i yy = _mm256_or_si256(_mm256_shuffle_epi8(ab, y_ab),
+                                     _mm256_shuffle_epi8(cc, y_cc));
+        __m256i uv = _mm256_or_si256(_mm256_shuffle_epi8(ab, uv_ab),
+                                     _mm256_shuffle_epi8(cc, uv_cc));
+        __m128i uv0 = _mm256_castsi256_si128(uv);
+        __m128i uv1 = _mm256_extracti128_si256(uv, 1);
+
+        /* The second group overwrites the extra samples of the first one */
+        _mm_storeu_si128((__m128i *)&y[x], _mm256_castsi256_si128(yy));
+        _mm_storeu_si128((__m128i *)&y[x + 6], _mm256_extracti128_si256(yy, 1));
+        _mm_storel_epi64((__m128i *)&u[x / 2], uv0);
+        _mm_storel_epi64((__m128i *)&u[x / 2 + 3], uv1);
+        _mm_storel_epi64((__m128i *)&v[x / 2], _mm_srli_si128(uv0, 8));
+        _mm_storel_epi64((__m128i *)&v[x / 2 + 3], _mm_srli_si128(uv1, 8));
+    }
+    return x;
+}
+
+VLC_AVX2
+static unsigned AVX2_Pack(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                          const uint16_t *v, unsigned width)
+{
+    const __m256i lo = _mm256_set1_epi16(4), hi = _mm256_set1_epi16(1019);
+    const __m256i a_uv = _mm256_setr_epi8(PACK_A_UV, PACK_A_UV);
+    const __m256i a_y = _mm256_setr_epi8(PACK_A_Y, PACK_A_Y);
+    const __m256i b_uv = _mm256_setr_epi8(PACK_B_UV, PACK_B_UV);
+    const __m256i b_y = _mm256_setr_epi8(PACK_B_Y, PACK_B_Y);
+    const __m256i c_uv = _mm256_setr_epi8(PACK_C_UV, PACK_C_UV);
+    const __m256i c_y = _mm256_setr_epi8(PACK_C_Y, PACK_C_Y);
+    unsigned x = 0;
+
+    for (; x + 14 <= width; x += 12, dst += 32) {
+        __m128i y0 = _mm_loadu_si128((const __m128i *)&y[x]);
+        __m128i y1 = _mm_loadu_si128((const __m128i *)&y[x + 6]);
+        __m128i uv0 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&u[x / 2]),
+                                         _mm_loadl_epi64((const __m128i *)&v[x / 2]));
+        __m128i uv1 = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&u[x / 2 + 3]),
+                                         _mm_loadl_epi64((const __m128i *)&v[x / 2 + 3]));
+        __m256i yy = _mm256_inserti128_si256(_mm256_castsi128_si256(y0), y1, 1);
+        __m256i uv = _mm256_inserti128_si256(_mm256_castsi128_si256(uv0), uv1, 1);
+
+        yy = _mm256_min_epi16(_mm256_max_epi16(yy, lo), hi);
+        uv = _mm256_min_epi16(_mm256_max_epi16(uv, lo), hi);
+
+        __m256i a = _mm256_or_si256(_mm256_shuffle_epi8(uv, a_uv),
+                                    _mm256_shuffle_epi8(yy, a_y));
+        __m256i b = _mm256_or_si256(_mm256_shuffle_epi8(uv, b_uv),
+                                    _mm256_shuffle_epi8(yy, b_y));
+        __m256i c = _mm256_or_si256(_mm256_shuffle_epi8(uv, c_uv),
+                                    _mm256_shuffle_epi8(yy, c_y));
+        __m256i w = _mm256_or_si256(a, _mm256_or_si256(_mm256_slli_epi32(b, 10),
+                                                       _mm256_slli_epi32(c, 20)));
+        _mm256_storeu_si256((__m256i *)dst, w);
+    }
+    return x;
+}
+#endif
+
+#ifdef V210_NEON
+/* Four groups per iteration, with the words deinterleaved by the loads */
+static unsigned NEON_Unpack(const uint8_t *src, uint16_t *y, uint16_t *u,
+                            uint16_t *v, unsigned width)
+{
+    const uint32x4_t mask = vdupq_n_u32(0x3FF);
+    unsigned x = 0;
+
+    for (; x + 24 <= width; x += 24, src += 64) {
+        uint32x4x4_t w = vld4q_u32((const uint32_t *)src);
+        uint32x4x3_t yy;
+        uint16x4x3_t uu, vv;
+
+        /* Pairs of luma samples */
+        yy.val[0] = vorrq_u32(vandq_u32(vshrq_n_u32(w.val[0], 10), mask),
+                              vshlq_n_u32(vandq_u32(w.val[1], mask), 16));
+        yy.val[1] = vorrq_u32(vandq_u32(vshrq_n_u32(w.val[1], 20), mask),
+                              vshlq_n_u32(vandq_u32(vshrq_n_u32(w.val[2], 10), mask), 16));
+        yy.val[2] = vorrq_u32(vandq_u32(w.val[3], mask),
+                              vshlq_n_u32(vandq_u32(vshrq_n_u32(w.val[3], 20), mask), 16));
+        uu.val[0] = vmovn_u32(vandq_u32(w.val[0], mask));
+        uu.val[1] = vmovn_u32(vandq_u32(vshrq_n_u32(w.val[1], 10), mask));
+        uu.val[2] = vmovn_u32(vandq_u32(vshrq_n_u32(w.val[2], 20), mask));
+        vv.val[0] = vmovn_u32(vandq_u32(vshrq_n_u32(w.val[0], 20), mask));
+        vv.val[1] = vmovn_u32(vandq_u32(w.val[2], mask));
+        vv.val[2] = vmovn_u32(vandq_u32(vshrq_n_u32(w.val[3], 10), mask));
+
+        vst3q_u32((uint32_t *)&y[x], yy);
+        vst3_u16(&u[x / 2], uu);
+        vst3_u16(&v[x / 2], vv);
+    }
+    return x;
+}
+
+static unsigned NEON_Pack(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                          const uint16_t *v, unsigned width)
+{
+    const uint16x8_t lo = vdupq_n_u16(4), hi = vdupq_n_u16(1019);
+    const uint16x4_t lo4 = vdup_n_u16(4), hi4 = vdup_n_u16(1019);
+    const uint32x4_t mask = vdupq_n_u32(0xFFFF);
+    unsigned x = 0;
+
+    for (; x + 24 <= width; x += 24, dst += 64) {
+        /* Y0|Y3, Y1|Y4 and Y2|Y5 pairs of each group */
+        uint16x8x3_t yy = vld3q_u16(&y[x]);
+        uint16x4x3_t uu = vld3_u16(&u[x / 2]);
+        uint16x4x3_t vv = vld3_u16(&v[x / 2]);
+        uint32x4_t p[3], cu[3], cv[3];
+
+        for (int i = 0; i < 3; i++) {
+            p[i] = vreinterpretq_u32_u16(vminq_u16(vmaxq_u16(yy.val[i], lo), hi));
+            cu[i] = vmovl_u16(vmin_u16(vmax_u16(uu.val[i], lo4), hi4));
+            cv[i] = vmovl_u16(vmin_u16(vmax_u16(vv.val[i], lo4), hi4));
+        }
+
+        uint32x4x4_t w;
+        w.val[0] = vorrq_u32(cu[0], vorrq_u32(vshlq_n_u32(vandq_u32(p[0], mask), 10),
+                                              vshlq_n_u32(cv[0], 20)));
+        w.val[1] = vorrq_u32(vandq_u32(p[1], mask),
+                             vorrq_u32(vshlq_n_u32(cu[1], 10),
+                                       vshlq_n_u32(vandq_u32(p[2], mask), 20)));
+        w.val[2] = vorrq_u32(cv[1], vorrq_u32(vshlq_n_u32(vshrq_n_u32(p[0], 16), 10),
+                                              vshlq_n_u32(cu[2], 20)));
+        w.val[3] = vorrq_u32(vshrq_n_u32(p[1], 16),
+                             vorrq_u32(vshlq_n_u32(cv[2], 10),
+                                       vshlq_n_u32(vshrq_n_u32(p[2], 16), 20)));
+        vst4q_u32((uint32_t *)dst, w);
+    }
+    return x;
+}
+#endif
+
+static unsigned UnpackVector(const uint8_t *src, uint16_t *y, uint16_t *u,
+                             uint16_t *v, unsigned width)
+{
+#ifdef V210_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_Unpack(src, y, u, v, width);
+#endif
+#ifdef V210_SSSE3
+    if (vlc_CPU_SSSE3())
+        return SSSE3_Unpack(src, y, u, v, width);
+#endif
+#ifdef V210_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_Unpack(src, y, u, v, width);
+#endif
+    VLC_UNUSED(src); VLC_UNUSED(y); VLC_UNUSED(u); VLC_UNUSED(v);
+    VLC_UNUSED(width);
+    return 0;
+}
+
+static unsigned PackVector(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                           const uint16_t *v, unsigned width)
+{
+#ifdef V210_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_Pack(dst, y, u, v, width);
+#endif
+#ifdef V210_SSSE3
+    if (vlc_CPU_SSSE3())
+        return SSSE3_Pack(dst, y, u, v, width);
+#endif
+#ifdef V210_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_Pack(dst, y, u, v, width);
+#endif
+    VLC_UNUSED(dst); VLC_UNUSED(y); VLC_UNUSED(u); VLC_UNUSED(v);
+    VLC_UNUSED(width);
+    return 0;
+}
+
+static void UnpackTail(const uint8_t *src, uint16_t *y, uint16_t *u,
+                       uint16_t *v, unsigned x, unsigned width)
+{
+    for (src += x / 6 * 16; x + 6 <= width; x += 6, src += 16)
+        UnpackGroup(src, &y[x], &u[x / 2], &v[x / 2]);
+
+    if (x < width) {
+        uint16_t ty[6], tu[3], tv[3];
+
+        UnpackGroup(src, ty, tu, tv);
+        memcpy(&y[x], ty, (width - x) * sizeof (*y));
+        memcpy(&u[x / 2], tu, (width - x + 1) / 2 * sizeof (*u));
+        memcpy(&v[x / 2], tv, (width - x + 1) / 2 * sizeof (*v));
+    }
+}
+
+static void PackTail(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                     const uint16_t *v, unsigned x, unsigned width)
+{
+    for (dst += x / 6 * 16; x + 6 <= width; x += 6, dst += 16)
+        PackGroup(dst, &y[x], &u[x / 2], &v[x / 2]);
+
+    if (x < width) {
+        uint16_t ty[6] = { 0 }, tu[3] = { 0 }, tv[3] = { 0 };
+
+        memcpy(ty, &y[x], (width - x) * sizeof (*y));
+        memcpy(tu, &u[x / 2], (width - x + 1) / 2 * sizeof (*u));
+        memcpy(tv, &v[x / 2], (width - x + 1) / 2 * sizeof (*v));
+        PackGroup(dst, ty, tu, tv);
+    }
+}
+
+void v210_UnpackLine(const uint8_t *src, uint16_t *y, uint16_t *u,
+                     uint16_t *v, unsigned width)
+{
+    unsigned x = UnpackVector(src, y, u, v, width);
+
+    UnpackTail(src, y, u, v, x, width);
+}
+
+void v210_PackLine(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                   const uint16_t *v, unsigned width)
+{
+    unsigned x = PackVector(dst, y, u, v, width);
+
+    PackTail(dst, y, u, v, x, width);
+}
+
+#ifdef V210_TEST
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned (*unpack_fn)(const uint8_t *, uint16_t *, uint16_t *,
+                              uint16_t *, unsigned);
+typedef unsigned (*pack_fn)(uint8_t *, const uint16_t *, const uint16_t *,
+                            const uint16_t *, unsigned);
+
+static unsigned C_Unpack(const uint8_t *src, uint16_t *y, uint16_t *u,
+                         uint16_t *v, unsigned width)
+{
+    VLC_UNUSED(src); VLC_UNUSED(y); VLC_UNUSED(u); VLC_UNUSED(v);
+    VLC_UNUSED(width);
+    return 0;
+}
+
+static unsigned C_Pack(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                       const uint16_t *v, unsigned width)
+{
+    VLC_UNUSED(dst); VLC_UNUSED(y); VLC_UNUSED(u); VLC_UNUSED(v);
+    VLC_UNUSED(width);
+    return 0;
+}
+
+static const struct
+{
+    const char *name;
+    unpack_fn unpack;
+    pack_fn pack;
+} kernels[] = {
+#ifdef V210_AVX2
+    { "AVX2", AVX2_Unpack, AVX2_Pack },
+#endif
+#ifdef V210_SSSE3
+    { "SSSE3", SSSE3_Unpack, SSSE3_Pack },
+#endif
+#ifdef V210_NEON
+    { "NEON", NEON_Unpack, NEON_Pack },
+#endif
+    { "C", C_Unpack, C_Pack },
+};
+
+static bool has_kernel(const char *name)
+{
+#ifdef V210_AVX2
+    if (!strcmp(name, "AVX2"))
+        return vlc_CPU_AVX2();
+#endif
+#ifdef V210_SSSE3
+    if (!strcmp(name, "SSSE3"))
+        return vlc_CPU_SSSE3();
+#endif
+#ifdef V210_NEON
+    if (!strcmp(name, "NEON"))
+        return vlc_CPU_ARM_NEON();
+#endif
+    VLC_UNUSED(name);
+    return true;
+}
+
+int main(void)
+{
+    static const unsigned widths[] = {
+        1, 2, 5, 6, 7, 8, 12, 13, 14, 20, 24, 25, 30, 47, 48, 50, 720, 1280,
+        1920, 3840,
+    };
+
+    srand(0);
+    for (size_t k = 0; k < ARRAY_SIZE(kernels); k++) {
+        if (!has_kernel(kernels[k].name))
+            continue;
+        for (size_t i = 0; i < ARRAY_SIZE(widths); i++) {
+            const unsigned width = widths[i], cwidth = (width + 1) / 2;
+            const size_t size = v210_LineSize(width);
+            uint8_t *line = malloc(size), *ref = malloc(size);
+            uint16_t *y = malloc(width * 2), *u = malloc(cwidth * 2),
+                     *v = malloc(cwidth * 2);
+            uint16_t *y2 = malloc(width * 2), *u2 = malloc(cwidth * 2),
+                     *v2 = malloc(cwidth * 2);
+            assert(line && ref && y && u && v && y2 && u2 && v2);
+
+            for (unsigned x = 0; x < width; x++)
+                y[x] = rand() & 0x3FF;
+            for (unsigned x = 0; x < cwidth; x++) {
+                u[x] = rand() & 0x3FF;
+                v[x] = rand() & 0x3FF;
+            }
+            memset(line, 0, size);
+            memset(ref, 0, size);
+
+            /* Packing matches the scalar code */
+            PackTail(line, y, u, v,
+                     kernels[k].pack(line, y, u, v, width), width);
+            PackTail(ref, y, u, v, 0, width);
+            assert(!memcmp(line, ref, size));
+
+            /* Unpacking restores the clipped samples */
+            UnpackTail(line, y2, u2, v2,
+                       kernels[k].unpack(line, y2, u2, v2, width), width);
+            for (unsigned x = 0; x < width; x++)
+                assert(y2[x] == clip(y[x]));
+            for (unsigned x = 0; x < cwidth; x++)
+                assert(u2[x] == clip(u[x]) && v2[x] == clip(v[x]));
+
+            /* Unpacking ignores the 2 padding bits */
+            for (size_t j = 0; j < size; j++)
+                line[j] = rand();
+            UnpackTail(line, y, u, v, 0, width);
+            UnpackTail(line, y2, u2, v2,
+                       kernels[k].unpack(line, y2, u2, v2, width), width);
+            assert(!memcmp(y, y2, width * 2));
+            assert(!memcmp(u, u2, cwidth * 2) && !memcmp(v, v2, cwidth * 2));
+
+            free(line); free(ref);
+            free(y); free(u); free(v);
+            free(y2); free(u2); free(v2);
+        }
+        printf("v210 %s kernels: OK\n", kernels[k].name);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,63 @@
+/*****************************************************************************
+ * v210.h: v210 packing and unpacking
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_VIDEOCHROMA_V210_H_
+#define VLC_VIDEOCHROMA_V210_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * v210 stores 6 pixels of 10-bit 4:2:2 in 4 little-endian 32-bit words, and
+ * pads the lines to 48 pixels (128 bytes).
+ */
+
+/**
+ * Returns the minimum size of a v210 line, in bytes.
+ */
+static inline size_t v210_LineSize(unsigned width)
+{
+    return (width + 47) / 48 * 128;
+}
+
+/**
+ * Unpacks a v210 line to planar 10-bit 4:2:2 lines.
+ *
+ * The chroma lines get (width + 1) / 2 samples.
+ */
+void v210_UnpackLine(const uint8_t *src, uint16_t *y, uint16_t *u,
+                     uint16_t *v, unsigned width);
+
+/**
+ * Packs planar 10-bit 4:2:2 lines to a v210 line.
+ *
+ * The samples are clipped to the 4-1019 range, as the other values are
+ * reserved for the SDI timing references. The last group of 6 pixels is
+ * written in full, that is (width + 5) / 6 * 16 bytes.
+ */
+void v210_PackLine(uint8_t *dst, const uint16_t *y, const uint16_t *u,
+                   const uint16_t *v, unsigned width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * v210_i422.c: v210 to and from planar or semi-planar 10-bit YUV
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "v210.h"
+
+static int Activate(filter_t *);
+
+vlc_module_begin ()
+    set_description(N_("Conversions from and to v210"))
+    set_callback_video_converter(Activate, 150)
+vlc_module_end ()
+
+typedef struct
+{
+    /* Line buffers for the P010 conversions, 2 lines of chroma */
+    uint16_t *y;
+    uint16_t *u[2];
+    uint16_t *v[2];
+} filter_sys_t;
+
+VIDEO_FILTER_WRAPPER(V210_I422)
+VIDEO_FILTER_WRAPPER(I422_V210)
+VIDEO_FILTER_WRAPPER_CLOSE(V210_P010, Close)
+VIDEO_FILTER_WRAPPER_CLOSE(P010_V210, Close)
+
+static void V210_I422(filter_t *filter, picture_t *src, picture_t *dst)
+{
+    const unsigned width = filter->fmt_out.video.i_width;
+    const unsigned height = filter->fmt_out.video.i_height;
+
+    for (unsigned i = 0; i < height; i++)
+        v210_UnpackLine(&src->p[0].p_pixels[i * src->p[0].i_pitch],
+            (uint16_t *)&dst->p[0].p_pixels[i * dst->p[0].i_pitch],
+            (uint16_t *)&dst->p[1].p_pixels[i * dst->p[1].i_pitch],
+            (uint16_t *)&dst->p[2].p_pixels[i * dst->p[2].i_pitch], width);
+}
+
+static void I422_V210(filter_t *filter, picture_t *src, picture_t *dst)
+{
+    const unsigned width = filter->fmt_out.video.i_width;
+    const unsigned height = filter->fmt_out.video.i_height;
+
+    for (unsigned i = 0; i < height; i++)
+        v210_PackLine(&dst->p[0].p_pixels[i * dst->p[0].i_pitch],
+            (const uint16_t *)&src->p[0].p_pixels[i * src->p[0].i_pitch],
+            (const uint16_t *)&src->p[1].p_pixels[i * src->p[1].i_pitch],
+            (const uint16_t *)&src->p[2].p_pixels[i * src->p[2].i_pitch],
+            width);
+}
+
+/* P010 stores the 10 bits in the most significant bits */
+static void V210_P010(filter_t *filter, picture_t *src, picture_t *dst)
+{
+    filter_sys_t *sys = filter->p_sys;
+    const unsigned width = filter->fmt_out.video.i_width;
+    const unsigned height = filter->fmt_out.video.i_height;
+    const unsigned cwidth = width / 2;
+
+    for (unsigned i = 0; i < height; i++) {
+        uint16_t *y = (uint16_t *)&dst->p[0].p_pixels[i * dst->p[0].i_pitch];
+
+        v210_UnpackLine(&src->p[0].p_pixels[i * src->p[0].i_pitch],
+                        sys->y, sys->u[i & 1], sys->v[i & 1], width);
+        for (unsigned x = 0; x < width; x++)
+            y[x] = sys->y[x] << 6;
+
+        if ((i & 1) == 0)
+            continue;
+
+        /* Average the chroma of both lines */
+        uint16_t *uv = (uint16_t *)&dst->p[1].p_pixels[i / 2 * dst->p[1].i_pitch];
+        for (unsigned x = 0; x < cwidth; x++) {
+            uv[2 * x]     = ((sys->u[0][x] + sys->u[1][x] + 1) >> 1) << 6;
+            uv[2 * x + 1] = ((sys->v[0][x] + sys->v[1][x] + 1) >> 1) << 6;
+        }
+    }
+}
+
+static void P010_V210(filter_t *filter, picture_t *src, picture_t *dst)
+{
+    filter_sys_t *sys = filter->p_sys;
+    const unsigned width = filter->fmt_out.video.i_width;
+    const unsigned height = filter->fmt_out.video.i_height;
+    const unsigned cwidth = width / 2;
+
+    for (unsigned i = 0; i < height; i++) {
+        const uint16_t *y =
+            (const uint16_t *)&src->p[0].p_pixels[i * src->p[0].i_pitch];
+
+        for (unsigned x = 0; x < width; x++)
+            sys->y[x] = y[x] >> 6;
+
+        /* Both lines of a pair share the chroma line */
+        if ((i & 1) == 0) {
+            const uint16_t *uv =
+                (const uint16_t *)&src->p[1].p_pixels[i / 2 * src->p[1].i_pitch];
+
+            for (unsigned x = 0; x < cwidth; x++) {
+                sys->u[0][x] = uv[2 * x] >> 6;
+                sys->v[0][x] = uv[2 * x + 1] >> 6;
+            }
+        }
+        v210_PackLine(&dst->p[0].p_pixels[i * dst->p[0].i_pitch],
+                      sys->y, sys->u[0], sys->v[0], width);
+    }
+}
+
+static void Close(filter_t *filter)
+{
+    filter_sys_t *sys = filter->p_sys;
+
+    free(sys->y);
+    free(sys);
+}
+
+static int Activate(filter_t *filter)
+{
+    const video_format_t *in = &filter->fmt_in.video;
+    const video_format_t *out = &filter->fmt_out.video;
+
+    if (in->i_width != out->i_width || in->i_height != out->i_height
+     || in->orientation != out->orientation
+     || (in->i_width & 1) != 0)
+        return VLC_EGENERIC;
+
+    if (in->i_chroma == VLC_CODEC_V210) {
+        if (out->i_chroma == VLC_CODEC_I422_10L) {
+            filter->ops = &V210_I422_ops;
+            return VLC_SUCCESS;
+        }
+        if (out->i_chroma != VLC_CODEC_P010)
+            return VLC_EGENERIC;
+        filter->ops = &V210_P010_ops;
+    } else if (out->i_chroma == VLC_CODEC_V210) {
+        if (in->i_chroma == VLC_CODEC_I422_10L) {
+            filter->ops = &I422_V210_ops;
+            return VLC_SUCCESS;
+        }
+        if (in->i_chroma != VLC_CODEC_P010)
+            return VLC_EGENERIC;
+        filter->ops = &P010_V210_ops;
+    } else
+        return VLC_EGENERIC;
+
+    /* P010 subsamples the chroma vertically */
+    if ((in->i_height & 1) != 0)
+        return VLC_EGENERIC;
+
+    filter_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    const size_t cwidth = in->i_width / 2;
+
+    /* One allocation for all the line buffers */
+    sys->y = vlc_alloc(in->i_width + 4 * cwidth, sizeof (uint16_t));
+    if (unlikely(sys->y == NULL)) {
+        free(sys);
+        return VLC_ENOMEM;
+    }
+    sys->u[0] = sys->y + in->i_width;
+    sys->u[1] = sys->u[0] + cwidth;
+    sys->v[0] = sys->u[1] + cwidth;
+    sys->v[1] = sys->v[0] + cwidth;
+    filter->p_sys = sys;
+    return VLC_SUCCESS;
+}
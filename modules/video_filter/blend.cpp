@@ -31,8 +31,28 @@
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
+#include <vlc_cpu.h>
 #include "filter_picture.h"
 
+#include <cstring>
+
+#if defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
+# define BLEND_SSE2 1
+# include <emmintrin.h>
+#endif
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# define BLEND_AVX2 1
+# include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+# define BLEND_NEON 1
+# include <arm_neon.h>
+#endif
+#if defined(__wasm_simd128__)
+# define BLEND_WASM 1
+# include <wasm_simd128.h>
+#endif
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -120,10 +140,13 @@ public:
     void merge(unsigned dx, const CPixel &spx, unsigned a, bool full)
     {
         ::merge(getPointer(0, dx), spx.i, a);
-        if (full) {
-            ::merge(getPointer(1, dx), spx.j, a);
-            ::merge(getPointer(2, dx), spx.k, a);
-        }
+        if (full)
+            mergeChroma(dx, spx, a);
+    }
+    void mergeChroma(unsigned dx, const CPixel &spx, unsigned a)
+    {
+        ::merge(getPointer(1, dx), spx.j, a);
+        ::merge(getPointer(2, dx), spx.k, a);
     }
     bool isFull(unsigned dx) const
     {
@@ -140,7 +163,6 @@ public:
         if (has_alpha)
             data[3] += picture->p[3].i_pitch;
     }
-private:
     pixel *getPointer(unsigned plane, unsigned dx) const
     {
         if (plane == 1 || plane == 2)
@@ -148,6 +170,7 @@ private:
 
         return (pixel*)&data[plane][(x + dx) /  1 * sizeof(pixel)];
     }
+private:
     uint8_t *data[4];
 };
 
@@ -170,10 +193,13 @@ public:
     void merge(unsigned dx, const CPixel &spx, unsigned a, bool full)
     {
         ::merge(getPointer(0, dx), spx.i, a);
-        if (full) {
-            ::merge(&getPointer(1, dx)[ swap_uv], spx.j, a);
-            ::merge(&getPointer(1, dx)[!swap_uv], spx.k, a);
-        }
+        if (full)
+            mergeChroma(dx, spx, a);
+    }
+    void mergeChroma(unsigned dx, const CPixel &spx, unsigned a)
+    {
+        ::merge(&getPointer(1, dx)[ swap_uv], spx.j, a);
+        ::merge(&getPointer(1, dx)[!swap_uv], spx.k, a);
     }
     bool isFull(unsigned dx) const
     {
@@ -186,7 +212,6 @@ public:
         if ((y % 2) == 0)
             data[1] += picture->p[1].i_pitch;
     }
-private:
     uint8_t *getPointer(unsigned plane, unsigned dx) const
     {
         if (plane == 0)
@@ -194,6 +219,7 @@ private:
         else
             return &data[plane][(x + dx) / 2 * 2];
     }
+private:
     uint8_t *data[2];
 };
 
@@ -528,6 +554,217 @@ private:
 
 } // namespace
 
+/* The vector kernels blend a plane line, with the same rounding as merge(),
+ * skipping the fully transparent vectors. They return the count of blended
+ * pixels. */
+#ifdef BLEND_SSE2
+VLC_SSE
+static inline __m128i SSE2_Div255(__m128i v)
+{
+    v = _mm_add_epi16(v, _mm_srli_epi16(v, 8));
+    return _mm_srli_epi16(_mm_add_epi16(v, _mm_set1_epi16(1)), 8);
+}
+
+VLC_SSE
+static inline __m128i SSE2_Merge(__m128i d, __m128i s, __m128i a, __m128i alpha)
+{
+    __m128i f = SSE2_Div255(_mm_mullo_epi16(a, alpha));
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(255), f), d),
+                              _mm_mullo_epi16(s, f));
+    return SSE2_Div255(v);
+}
+
+VLC_SSE
+static unsigned SSE2_BlendPlane(uint8_t *dst, const uint8_t *src,
+                                const uint8_t *srca, unsigned width, int alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i va = _mm_set1_epi16(alpha);
+    unsigned x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&srca[x]);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)) == 0xffff)
+            continue;
+
+        __m128i s = _mm_loadu_si128((const __m128i *)&src[x]);
+        __m128i d = _mm_loadu_si128((const __m128i *)&dst[x]);
+        __m128i lo = SSE2_Merge(_mm_unpacklo_epi8(d, zero),
+                                _mm_unpacklo_epi8(s, zero),
+                                _mm_unpacklo_epi8(a, zero), va);
+        __m128i hi = SSE2_Merge(_mm_unpackhi_epi8(d, zero),
+                                _mm_unpackhi_epi8(s, zero),
+                                _mm_unpackhi_epi8(a, zero), va);
+        _mm_storeu_si128((__m128i *)&dst[x], _mm_packus_epi16(lo, hi));
+    }
+    return x;
+}
+#endif
+
+#ifdef BLEND_AVX2
+VLC_AVX2
+static inline __m256i AVX2_Div255(__m256i v)
+{
+    v = _mm256_add_epi16(v, _mm256_srli_epi16(v, 8));
+    return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_set1_epi16(1)), 8);
+}
+
+VLC_AVX2
+static inline __m256i AVX2_Merge(__m256i d, __m256i s, __m256i a, __m256i alpha)
+{
+    __m256i f = AVX2_Div255(_mm256_mullo_epi16(a, alpha));
+    __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(_mm256_set1_epi16(255), f), d),
+                                 _mm256_mullo_epi16(s, f));
+    return AVX2_Div255(v);
+}
+
+VLC_AVX2
+static unsigned AVX2_BlendPlane(uint8_t *dst, const uint8_t *src,
+                                const uint8_t *srca, unsigned width, int alpha)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i va = _mm256_set1_epi16(alpha);
+    unsigned x = 0;
+
+    /* Unpacking and packing both work within 128-bit lanes: the pixels
+     * come back in order. */
+    for (; x + 32 <= width; x += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&srca[x]);
+        if (_mm256_testz_si256(a, a))
+            continue;
+
+        __m256i s = _mm256_loadu_si256((const __m256i *)&src[x]);
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dst[x]);
+        __m256i lo = AVX2_Merge(_mm256_unpacklo_epi8(d, zero),
+                                _mm256_unpacklo_epi8(s, zero),
+                                _mm256_unpacklo_epi8(a, zero), va);
+        __m256i hi = AVX2_Merge(_mm256_unpackhi_epi8(d, zero),
+                                _mm256_unpackhi_epi8(s, zero),
+                                _mm256_unpackhi_epi8(a, zero), va);
+        _mm256_storeu_si256((__m256i *)&dst[x], _mm256_packus_epi16(lo, hi));
+    }
+    return x;
+}
+#endif
+
+#ifdef BLEND_NEON
+static inline uint8x8_t NEON_Div255(uint16x8_t v)
+{
+    v = vsraq_n_u16(v, v, 8);
+    return vshrn_n_u16(vaddq_u16(v, vdupq_n_u16(1)), 8);
+}
+
+static inline uint8x8_t NEON_Merge(uint8x8_t d, uint8x8_t s, uint8x8_t a,
+                                   uint8x8_t alpha)
+{
+    uint8x8_t f = NEON_Div255(vmull_u8(a, alpha));
+    uint16x8_t v = vmull_u8(vsub_u8(vdup_n_u8(255), f), d);
+    return NEON_Div255(vmlal_u8(v, s, f));
+}
+
+static unsigned NEON_BlendPlane(uint8_t *dst, const uint8_t *src,
+                                const uint8_t *srca, unsigned width, int alpha)
+{
+    const uint8x8_t va = vdup_n_u8(alpha);
+    unsigned x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t a = vld1q_u8(&srca[x]);
+        uint8x8_t any = vorr_u8(vget_low_u8(a), vget_high_u8(a));
+        if (vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0)
+            continue;
+
+        uint8x16_t s = vld1q_u8(&src[x]);
+        uint8x16_t d = vld1q_u8(&dst[x]);
+        vst1q_u8(&dst[x],
+                 vcombine_u8(NEON_Merge(vget_low_u8(d), vget_low_u8(s),
+                                        vget_low_u8(a), va),
+                             NEON_Merge(vget_high_u8(d), vget_high_u8(s),
+                                        vget_high_u8(a), va)));
+    }
+    return x;
+}
+#endif
+
+#ifdef BLEND_WASM
+static inline v128_t WASM_Div255(v128_t v)
+{
+    v = wasm_i16x8_add(v, wasm_u16x8_shr(v, 8));
+    return wasm_u16x8_shr(wasm_i16x8_add(v, wasm_i16x8_splat(1)), 8);
+}
+
+static inline v128_t WASM_Merge(v128_t d, v128_t s, v128_t a, v128_t alpha)
+{
+    v128_t f = WASM_Div255(wasm_i16x8_mul(a, alpha));
+    v128_t v = wasm_i16x8_add(wasm_i16x8_mul(wasm_i16x8_sub(wasm_i16x8_splat(255), f), d),
+                              wasm_i16x8_mul(s, f));
+    return WASM_Div255(v);
+}
+
+static unsigned WASM_BlendPlane(uint8_t *dst, const uint8_t *src,
+                                const uint8_t *srca, unsigned width, int alpha)
+{
+    const v128_t va = wasm_i16x8_splat(alpha);
+    unsigned x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        v128_t a = wasm_v128_load(&srca[x]);
+        if (!wasm_v128_any_true(a))
+            continue;
+
+        v128_t s = wasm_v128_load(&src[x]);
+        v128_t d = wasm_v128_load(&dst[x]);
+        v128_t lo = WASM_Merge(wasm_u16x8_extend_low_u8x16(d),
+                               wasm_u16x8_extend_low_u8x16(s),
+                               wasm_u16x8_extend_low_u8x16(a), va);
+        v128_t hi = WASM_Merge(wasm_u16x8_extend_high_u8x16(d),
+                               wasm_u16x8_extend_high_u8x16(s),
+                               wasm_u16x8_extend_high_u8x16(a), va);
+        wasm_v128_store(&dst[x], wasm_u8x16_narrow_i16x8(lo, hi));
+    }
+    return x;
+}
+#endif
+
+static unsigned BlendPlane(uint8_t *dst, const uint8_t *src,
+                           const uint8_t *srca, unsigned width, int alpha)
+{
+#ifdef BLEND_AVX2
+    if (vlc_CPU_AVX2())
+        return AVX2_BlendPlane(dst, src, srca, width, alpha);
+#endif
+#ifdef BLEND_SSE2
+    if (vlc_CPU_SSE2())
+        return SSE2_BlendPlane(dst, src, srca, width, alpha);
+#endif
+#ifdef BLEND_NEON
+    if (vlc_CPU_ARM_NEON())
+        return NEON_BlendPlane(dst, src, srca, width, alpha);
+#endif
+#ifdef BLEND_WASM
+    return WASM_BlendPlane(dst, src, srca, width, alpha);
+#endif
+    VLC_UNUSED(dst); VLC_UNUSED(src); VLC_UNUSED(srca);
+    VLC_UNUSED(width); VLC_UNUSED(alpha);
+    return 0;
+}
+
+/* It returns the count of leading fully transparent pixels */
+static unsigned CountTransparent(const uint8_t *srca, unsigned width)
+{
+    unsigned x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        uint64_t a;
+        memcpy(&a, &srca[x], sizeof(a));
+        if (a != 0)
+            break;
+    }
+    while (x < width && srca[x] == 0)
+        x++;
+    return x;
+}
+
 template <class TDst, class TSrc, class TConvert>
 void Blend(const CPicture &dst_data, const CPicture &src_data,
            unsigned width, unsigned height, int alpha)
@@ -557,6 +794,88 @@ void Blend(const CPicture &dst_data, const CPicture &src_data,
     }
 }
 
+/* Same as Blend() for YUVA subpictures, but without converting the fully
+ * transparent spans */
+template <class TDst, class TConvert>
+void BlendYUVA(const CPicture &dst_data, const CPicture &src_data,
+               unsigned width, unsigned height, int alpha)
+{
+    CPictureYUVA src(src_data);
+    TDst dst(dst_data);
+    TConvert convert(dst_data.getFormat(), src_data.getFormat());
+
+    for (unsigned y = 0; y < height; y++) {
+        const uint8_t *srca = src.getPointer(3, 0);
+
+        for (unsigned x = 0; x < width; x++) {
+            x += CountTransparent(&srca[x], width - x);
+            if (x >= width)
+                break;
+
+            unsigned a = div255(alpha * srca[x]);
+            if (a <= 0)
+                continue;
+
+            CPixel spx;
+
+            src.get(&spx, x);
+            convert(spx);
+
+            if (dst.isFull(x))
+                dst.merge(x, spx, a, true);
+            else
+                dst.merge(x, spx, a, false);
+        }
+        src.nextLine();
+        dst.nextLine();
+    }
+}
+
+/* YUVA subpictures onto 8-bit 4:2:0 pictures: the luma plane is blended
+ * with the vector kernels, then the chroma planes where the subpicture is
+ * not transparent. */
+template <class TDst>
+void BlendYUVA420(const CPicture &dst_data, const CPicture &src_data,
+                  unsigned width, unsigned height, int alpha)
+{
+    CPictureYUVA src(src_data);
+    TDst dst(dst_data);
+
+    for (unsigned y = 0; y < height; y++) {
+        const uint8_t *srcy = src.getPointer(0, 0);
+        const uint8_t *srca = src.getPointer(3, 0);
+        uint8_t *dsty = dst.getPointer(0, 0);
+
+        for (unsigned x = BlendPlane(dsty, srcy, srca, width, alpha);
+             x < width; x++) {
+            unsigned a = div255(alpha * srca[x]);
+            if (a > 0)
+                ::merge(&dsty[x], srcy[x], a);
+        }
+
+        if (dst.isFull(0) || dst.isFull(1)) {
+            for (unsigned x = 0; x < width; x++) {
+                x += CountTransparent(&srca[x], width - x);
+                if (x >= width)
+                    break;
+                if (!dst.isFull(x))
+                    continue;
+
+                unsigned a = div255(alpha * srca[x]);
+                if (a <= 0)
+                    continue;
+
+                CPixel spx;
+
+                src.get(&spx, x);
+                dst.mergeChroma(x, spx, a);
+            }
+        }
+        src.nextLine();
+        dst.nextLine();
+    }
+}
+
 typedef void (*blend_function_t)(const CPicture &dst_data, const CPicture &src_data,
                                  unsigned width, unsigned height, int alpha);
 
@@ -569,14 +888,19 @@ static const struct {
 } blends[] = {
 #undef RGB
 #undef YUV
+#undef YUV420
 #define RGB(csp, picture, cvt) \
-    { csp, VLC_CODEC_YUVA, Blend<picture, CPictureYUVA, compose<cvt, convertYuv8ToRgb> > }, \
+    { csp, VLC_CODEC_YUVA, BlendYUVA<picture, compose<cvt, convertYuv8ToRgb> > }, \
     { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<cvt, convertNone> > }, \
     { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<cvt, convertYuvpToRgba> > }
 #define YUV(csp, picture, cvt) \
-    { csp, VLC_CODEC_YUVA, Blend<picture, CPictureYUVA, compose<cvt, convertNone> > }, \
+    { csp, VLC_CODEC_YUVA, BlendYUVA<picture, compose<cvt, convertNone> > }, \
     { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<cvt, convertRgbToYuv8> > }, \
     { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<cvt, convertYuvpToYuva8> > }
+#define YUV420(csp, picture) \
+    { csp, VLC_CODEC_YUVA, BlendYUVA420<picture> }, \
+    { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<convertNone, convertRgbToYuv8> > }, \
+    { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<convertNone, convertYuvpToYuva8> > }
 
     RGB(VLC_CODEC_RGB15,    CPictureRGB16,    convertRgbToRgbSmall),
     RGB(VLC_CODEC_RGB16,    CPictureRGB16,    convertRgbToRgbSmall),
@@ -590,11 +914,11 @@ static const struct {
 
     YUV(VLC_CODEC_I411,     CPictureI411_8,   convertNone),
 
-    YUV(VLC_CODEC_YV12,     CPictureYV12,     convertNone),
-    YUV(VLC_CODEC_NV12,     CPictureNV12,     convertNone),
-    YUV(VLC_CODEC_NV21,     CPictureNV21,     convertNone),
-    YUV(VLC_CODEC_J420,     CPictureI420_8,   convertNone),
-    YUV(VLC_CODEC_I420,     CPictureI420_8,   convertNone),
+    YUV420(VLC_CODEC_YV12,  CPictureYV12),
+    YUV420(VLC_CODEC_NV12,  CPictureNV12),
+    YUV420(VLC_CODEC_NV21,  CPictureNV21),
+    YUV420(VLC_CODEC_J420,  CPictureI420_8),
+    YUV420(VLC_CODEC_I420,  CPictureI420_8),
 #ifdef WORDS_BIGENDIAN
     YUV(VLC_CODEC_I420_9B,  CPictureI420_16,  convert8To9Bits),
     YUV(VLC_CODEC_I420_10B, CPictureI420_16,  convert8To10Bits),
@@ -634,6 +958,7 @@ static const struct {
 
 #undef RGB
 #undef YUV
+#undef YUV420
 };
 
 struct filter_sys_t {
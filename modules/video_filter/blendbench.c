@@ -59,7 +59,9 @@ static picture_t *Filter( filter_t *, picture_t * );
 #define BASE_IMAGE_LONGTEXT N_("The image which will be used to blend onto")
 
 #define BASE_CHROMA_TEXT N_("Chroma for the base image")
-#define BASE_CHROMA_LONGTEXT N_("Chroma which the base image will be loaded in")
+#define BASE_CHROMA_LONGTEXT N_("Chroma which the base image will be loaded " \
+                                "in. Several comma-separated chromas are " \
+                                "benchmarked one after the other")
 
 #define BLEND_IMAGE_TEXT N_("Image which will be blended")
 #define BLEND_IMAGE_LONGTEXT N_("The image blended onto the base image")
@@ -69,6 +71,7 @@ static picture_t *Filter( filter_t *, picture_t * );
                                  " in")
 
 #define CFG_PREFIX "blendbench-"
+#define BASE_CHROMA_MAX 8
 
 vlc_module_begin ()
     set_description( N_("Blending benchmark filter") )
@@ -109,10 +112,10 @@ typedef struct
     bool b_done;
     int i_loops, i_alpha;
 
-    picture_t *p_base_image;
+    picture_t *pp_base_images[BASE_CHROMA_MAX];
+    unsigned i_base_images;
     picture_t *p_blend_image;
 
-    vlc_fourcc_t i_base_chroma;
     vlc_fourcc_t i_blend_chroma;
 } filter_sys_t;
 
@@ -177,15 +180,34 @@ static int Create( filter_t *p_filter )
                                                   CFG_PREFIX "alpha" );
 
     psz_temp = var_CreateGetStringCommand( p_filter, CFG_PREFIX "base-chroma" );
-    p_sys->i_base_chroma = !psz_temp || strlen( psz_temp ) != 4 ? 0 :
-        VLC_FOURCC( psz_temp[0], psz_temp[1], psz_temp[2], psz_temp[3] );
     psz_cmd = var_CreateGetStringCommand( p_filter, CFG_PREFIX "base-image" );
-    i_ret = blendbench_LoadImage( VLC_OBJECT(p_filter), &p_sys->p_base_image,
-                                  p_sys->i_base_chroma, psz_cmd, "Base" );
+    p_sys->i_base_images = 0;
+    i_ret = VLC_SUCCESS;
+
+    char *psz_chroma, *psz_save;
+    for( psz_chroma = psz_temp ? strtok_r( psz_temp, ",", &psz_save ) : NULL;
+         psz_chroma != NULL && p_sys->i_base_images < BASE_CHROMA_MAX;
+         psz_chroma = strtok_r( NULL, ",", &psz_save ) )
+    {
+        vlc_fourcc_t i_chroma = strlen( psz_chroma ) != 4 ? 0 :
+            VLC_FOURCC( psz_chroma[0], psz_chroma[1], psz_chroma[2],
+                        psz_chroma[3] );
+
+        i_ret = blendbench_LoadImage( VLC_OBJECT(p_filter),
+                    &p_sys->pp_base_images[p_sys->i_base_images],
+                    i_chroma, psz_cmd, "Base" );
+        if( i_ret != VLC_SUCCESS )
+            break;
+        p_sys->i_base_images++;
+    }
     free( psz_temp );
     free( psz_cmd );
+    if( i_ret == VLC_SUCCESS && p_sys->i_base_images == 0 )
+        i_ret = VLC_EGENERIC;
     if( i_ret != VLC_SUCCESS )
     {
+        for( unsigned i = 0; i < p_sys->i_base_images; i++ )
+            picture_Release( p_sys->pp_base_images[i] );
         free( p_sys );
         return i_ret;
     }
@@ -203,7 +225,8 @@ static int Create( filter_t *p_filter )
 
     if( i_ret != VLC_SUCCESS )
     {
-        picture_Release( p_sys->p_base_image );
+        for( unsigned i = 0; i < p_sys->i_base_images; i++ )
+            picture_Release( p_sys->pp_base_images[i] );
         free( p_sys );
 
         return VLC_EGENERIC;
@@ -219,47 +242,45 @@ static void Destroy( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
 
-    picture_Release( p_sys->p_base_image );
+    for( unsigned i = 0; i < p_sys->i_base_images; i++ )
+        picture_Release( p_sys->pp_base_images[i] );
     picture_Release( p_sys->p_blend_image );
+    free( p_sys );
 }
 
 /*****************************************************************************
- * Render: displays previously rendered output
+ * Benchmark: blends the blend image onto one base image
  *****************************************************************************/
-static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+static void Benchmark( filter_t *p_filter, picture_t *p_base )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     filter_t *p_blend;
-
-    if( p_sys->b_done )
-        return p_pic;
+    const vlc_fourcc_t i_chroma = p_base->format.i_chroma;
 
     p_blend = vlc_object_create( p_filter, sizeof(filter_t) );
     if( !p_blend )
-    {
-        picture_Release( p_pic );
-        return NULL;
-    }
-    p_blend->fmt_out.video = p_sys->p_base_image->format;
+        return;
+    p_blend->fmt_out.video = p_base->format;
     p_blend->fmt_in.video = p_sys->p_blend_image->format;
     p_blend->p_module = module_need( p_blend, "video blending", NULL, false );
     if( !p_blend->p_module )
     {
-        picture_Release( p_pic );
+        msg_Err( p_filter, "Cannot blend onto %4.4s", (const char *)&i_chroma );
         vlc_object_delete(p_blend);
-        return NULL;
+        return;
     }
     assert( p_blend->ops != NULL );
 
     vlc_tick_t time = vlc_tick_now();
     for( int i_iter = 0; i_iter < p_sys->i_loops; ++i_iter )
     {
-        filter_Blend( p_blend, p_sys->p_base_image,
+        filter_Blend( p_blend, p_base,
                       0, 0, p_sys->p_blend_image, p_sys->i_alpha );
     }
     time = vlc_tick_now() - time;
 
-    msg_Info( p_filter, "Blended %d images in %f sec", p_sys->i_loops,
+    msg_Info( p_filter, "Blended %d images onto %4.4s in %f sec",
+              p_sys->i_loops, (const char *)&i_chroma,
               secf_from_vlc_tick(time) );
     msg_Info( p_filter, "Speed is: %f images/second, %f pixels/second",
               (float) p_sys->i_loops / time * CLOCK_FREQ,
@@ -271,6 +292,20 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
     module_unneed( p_blend, p_blend->p_module );
 
     vlc_object_delete(p_blend);
+}
+
+/*****************************************************************************
+ * Render: displays previously rendered output
+ *****************************************************************************/
+static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->b_done )
+        return p_pic;
+
+    for( unsigned i = 0; i < p_sys->i_base_images; i++ )
+        Benchmark( p_filter, p_sys->pp_base_images[i] );
 
     p_sys->b_done = true;
     return p_pic;
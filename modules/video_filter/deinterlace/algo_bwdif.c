@@ -0,0 +1,425 @@
+/*****************************************************************************
+ * algo_bwdif.c : Bwdif algorithm for the VLC deinterlacer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * Based on vf_bwdif.c from the FFmpeg project:
+ * Copyright (C) 2016 Thomas Mundt <loudmax@yahoo.de>
+ * Based on yadif, Copyright (C) 2006-2011 Michael Niedermayer
+ *                                         2010 James Darnley
+ * and w3fdif, Copyright (C) 2012 British Broadcasting Corporation
+ *                                2014 Paul B Mahol
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include <vlc_picture.h>
+#include <vlc_filter.h>
+
+#include "deinterlace.h" /* filter_sys_t */
+#include "common.h"      /* FFMIN3 et al. */
+#include "helpers.h"     /* RenderSlices() */
+
+#include "algo_bwdif.h"
+
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# include <immintrin.h>
+#endif
+
+/*****************************************************************************
+ * Line interpolation
+ *****************************************************************************/
+
+/* Low-pass and high-pass filter coefficients of w3fdif, and coefficients of
+ * the cubic spatial interpolation, in Q13 */
+#define COEF_LF_0 4309
+#define COEF_LF_1 213
+#define COEF_HF_0 5570
+#define COEF_HF_1 3801
+#define COEF_HF_2 1016
+#define COEF_SP_0 5077
+#define COEF_SP_1 981
+
+/* Interpolates w pixels of a line. refs is the pitch in pixels, prefs and
+ * mrefs the offsets of the lines below and above (mirrored on the borders).
+ * b_line selects the full filter, for lines with 4 lines on each side.
+ * Otherwise, the spatial check is only done if b_spat. */
+#define BWDIF_FILTER( pixel, b_line, b_spat ) \
+    do { \
+        pixel *dst = p_dst; \
+        const pixel *prev = p_prev; \
+        const pixel *cur  = p_cur; \
+        const pixel *next = p_next; \
+        const pixel *prev2 = parity ? prev : cur; \
+        const pixel *next2 = parity ? cur  : next; \
+        const ptrdiff_t prefs2 = 2 * refs, mrefs2 = -2 * refs; \
+        const ptrdiff_t prefs3 = 3 * refs, mrefs3 = -3 * refs; \
+        const ptrdiff_t prefs4 = 4 * refs, mrefs4 = -4 * refs; \
+        VLC_UNUSED(prefs3); VLC_UNUSED(mrefs3); \
+        VLC_UNUSED(prefs4); VLC_UNUSED(mrefs4); \
+ \
+        for( int x = 0; x < w; x++ ) \
+        { \
+            int c = cur[x + mrefs]; \
+            int d = (prev2[x] + next2[x]) >> 1; \
+            int e = cur[x + prefs]; \
+            int temporal_diff0 = abs(prev2[x] - next2[x]); \
+            int temporal_diff1 = (abs(prev[x + mrefs] - c) \
+                                + abs(prev[x + prefs] - e)) >> 1; \
+            int temporal_diff2 = (abs(next[x + mrefs] - c) \
+                                + abs(next[x + prefs] - e)) >> 1; \
+            int diff = FFMAX3(temporal_diff0 >> 1, temporal_diff1, \
+                              temporal_diff2); \
+            int interpol; \
+ \
+            if( diff == 0 ) \
+            { \
+                dst[x] = d; \
+                continue; \
+            } \
+ \
+            if( (b_line) || (b_spat) ) \
+            { \
+                int b = ((prev2[x + mrefs2] + next2[x + mrefs2]) >> 1) - c; \
+                int f = ((prev2[x + prefs2] + next2[x + prefs2]) >> 1) - e; \
+                int dc = d - c; \
+                int de = d - e; \
+                int max = FFMAX3(de, dc, FFMIN(b, f)); \
+                int min = FFMIN3(de, dc, FFMAX(b, f)); \
+                diff = FFMAX3(diff, min, -max); \
+            } \
+ \
+            if( !(b_line) ) \
+                interpol = (c + e) >> 1; \
+            else if( abs(c - e) > temporal_diff0 ) \
+                interpol = (((COEF_HF_0 * (prev2[x] + next2[x]) \
+                    - COEF_HF_1 * (prev2[x + mrefs2] + next2[x + mrefs2] \
+                                 + prev2[x + prefs2] + next2[x + prefs2]) \
+                    + COEF_HF_2 * (prev2[x + mrefs4] + next2[x + mrefs4] \
+                                 + prev2[x + prefs4] + next2[x + prefs4])) >> 2) \
+                    + COEF_LF_0 * (c + e) \
+                    - COEF_LF_1 * (cur[x + mrefs3] + cur[x + prefs3])) >> 13; \
+            else \
+                interpol = (COEF_SP_0 * (c + e) \
+                    - COEF_SP_1 * (cur[x + mrefs3] + cur[x + prefs3])) >> 13; \
+ \
+            if( interpol > d + diff ) \
+                interpol = d + diff; \
+            else if( interpol < d - diff ) \
+                interpol = d - diff; \
+ \
+            dst[x] = VLC_CLIP(interpol, 0, clip_max); \
+        } \
+    } while(0)
+
+void BwdifLine8C( void *p_dst, const void *p_prev, const void *p_cur,
+                  const void *p_next, int w, ptrdiff_t refs,
+                  int parity, int clip_max )
+{
+    const ptrdiff_t prefs = refs, mrefs = -refs;
+    BWDIF_FILTER( uint8_t, true, true );
+}
+
+void BwdifLine16C( void *p_dst, const void *p_prev, const void *p_cur,
+                   const void *p_next, int w, ptrdiff_t refs,
+                   int parity, int clip_max )
+{
+    const ptrdiff_t prefs = refs, mrefs = -refs;
+    BWDIF_FILTER( uint16_t, true, true );
+}
+
+static void BwdifEdge8( void *p_dst, const void *p_prev, const void *p_cur,
+                        const void *p_next, int w, ptrdiff_t refs,
+                        ptrdiff_t prefs, ptrdiff_t mrefs,
+                        int parity, int clip_max, bool b_spat )
+{
+    BWDIF_FILTER( uint8_t, false, b_spat );
+}
+
+static void BwdifEdge16( void *p_dst, const void *p_prev, const void *p_cur,
+                         const void *p_next, int w, ptrdiff_t refs,
+                         ptrdiff_t prefs, ptrdiff_t mrefs,
+                         int parity, int clip_max, bool b_spat )
+{
+    BWDIF_FILTER( uint16_t, false, b_spat );
+}
+
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+/* 8 pixels at a time, in 32-bit lanes. The "8-bit" loads widen the pixels. */
+#define LOAD8(p)  _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i *)(p) ) )
+#define LOAD16(p) _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)(p) ) )
+
+#define BWDIF_AVX2( pixel, LOAD, STORE ) \
+    do { \
+        pixel *dst = p_dst; \
+        const pixel *prev = p_prev; \
+        const pixel *cur  = p_cur; \
+        const pixel *next = p_next; \
+        const pixel *prev2 = parity ? prev : cur; \
+        const pixel *next2 = parity ? cur  : next; \
+        const __m256i zero = _mm256_setzero_si256(); \
+        const __m256i max_pixel = _mm256_set1_epi32( clip_max ); \
+ \
+        assert( w % 8 == 0 ); \
+        for( int x = 0; x < w; x += 8 ) \
+        { \
+            __m256i c  = LOAD( &cur[x - refs] ); \
+            __m256i e  = LOAD( &cur[x + refs] ); \
+            __m256i p2 = LOAD( &prev2[x] ); \
+            __m256i n2 = LOAD( &next2[x] ); \
+            __m256i sum2 = _mm256_add_epi32( p2, n2 ); \
+            __m256i d  = _mm256_srai_epi32( sum2, 1 ); \
+ \
+            __m256i td0 = _mm256_abs_epi32( _mm256_sub_epi32( p2, n2 ) ); \
+            __m256i td1 = _mm256_srai_epi32( _mm256_add_epi32( \
+                _mm256_abs_epi32( _mm256_sub_epi32( LOAD( &prev[x - refs] ), c ) ), \
+                _mm256_abs_epi32( _mm256_sub_epi32( LOAD( &prev[x + refs] ), e ) ) ), 1 ); \
+            __m256i td2 = _mm256_srai_epi32( _mm256_add_epi32( \
+                _mm256_abs_epi32( _mm256_sub_epi32( LOAD( &next[x - refs] ), c ) ), \
+                _mm256_abs_epi32( _mm256_sub_epi32( LOAD( &next[x + refs] ), e ) ) ), 1 ); \
+            __m256i diff = _mm256_max_epi32( _mm256_srai_epi32( td0, 1 ), \
+                                             _mm256_max_epi32( td1, td2 ) ); \
+            /* Static pixels are taken from the temporal average */ \
+            __m256i still = _mm256_cmpeq_epi32( diff, zero ); \
+ \
+            /* Spatial check */ \
+            __m256i sum2m2 = _mm256_add_epi32( LOAD( &prev2[x - 2 * refs] ), \
+                                               LOAD( &next2[x - 2 * refs] ) ); \
+            __m256i sum2p2 = _mm256_add_epi32( LOAD( &prev2[x + 2 * refs] ), \
+                                               LOAD( &next2[x + 2 * refs] ) ); \
+            __m256i b  = _mm256_sub_epi32( _mm256_srai_epi32( sum2m2, 1 ), c ); \
+            __m256i f  = _mm256_sub_epi32( _mm256_srai_epi32( sum2p2, 1 ), e ); \
+            __m256i dc = _mm256_sub_epi32( d, c ); \
+            __m256i de = _mm256_sub_epi32( d, e ); \
+            __m256i max = _mm256_max_epi32( _mm256_max_epi32( de, dc ), \
+                                            _mm256_min_epi32( b, f ) ); \
+            __m256i min = _mm256_min_epi32( _mm256_min_epi32( de, dc ), \
+                                            _mm256_max_epi32( b, f ) ); \
+            diff = _mm256_max_epi32( _mm256_max_epi32( diff, min ), \
+                                     _mm256_sub_epi32( zero, max ) ); \
+ \
+            /* Interpolation */ \
+            __m256i ce  = _mm256_add_epi32( c, e ); \
+            __m256i c3  = _mm256_add_epi32( LOAD( &cur[x - 3 * refs] ), \
+                                            LOAD( &cur[x + 3 * refs] ) ); \
+            __m256i sp  = _mm256_srai_epi32( _mm256_sub_epi32( \
+                _mm256_mullo_epi32( ce, _mm256_set1_epi32( COEF_SP_0 ) ), \
+                _mm256_mullo_epi32( c3, _mm256_set1_epi32( COEF_SP_1 ) ) ), 13 ); \
+            __m256i sum4 = _mm256_add_epi32( \
+                _mm256_add_epi32( LOAD( &prev2[x - 4 * refs] ), \
+                                  LOAD( &next2[x - 4 * refs] ) ), \
+                _mm256_add_epi32( LOAD( &prev2[x + 4 * refs] ), \
+                                  LOAD( &next2[x + 4 * refs] ) ) ); \
+            __m256i hf  = _mm256_srai_epi32( _mm256_add_epi32( \
+                _mm256_mullo_epi32( sum2, _mm256_set1_epi32( COEF_HF_0 ) ), \
+                _mm256_sub_epi32( \
+                    _mm256_mullo_epi32( sum4, _mm256_set1_epi32( COEF_HF_2 ) ), \
+                    _mm256_mullo_epi32( _mm256_add_epi32( sum2m2, sum2p2 ), \
+                                        _mm256_set1_epi32( COEF_HF_1 ) ) ) ), 2 ); \
+            hf = _mm256_srai_epi32( _mm256_sub_epi32( _mm256_add_epi32( hf, \
+                _mm256_mullo_epi32( ce, _mm256_set1_epi32( COEF_LF_0 ) ) ), \
+                _mm256_mullo_epi32( c3, _mm256_set1_epi32( COEF_LF_1 ) ) ), 13 ); \
+            __m256i moving = _mm256_cmpgt_epi32( \
+                _mm256_abs_epi32( _mm256_sub_epi32( c, e ) ), td0 ); \
+            __m256i interpol = _mm256_blendv_epi8( sp, hf, moving ); \
+ \
+            interpol = _mm256_min_epi32( interpol, _mm256_add_epi32( d, diff ) ); \
+            interpol = _mm256_max_epi32( interpol, _mm256_sub_epi32( d, diff ) ); \
+            interpol = _mm256_min_epi32( _mm256_max_epi32( interpol, zero ), \
+                                         max_pixel ); \
+            interpol = _mm256_blendv_epi8( interpol, d, still ); \
+ \
+            /* Narrow to 16 bits: the values are within the pixel range */ \
+            __m256i out = _mm256_permute4x64_epi64( \
+                _mm256_packus_epi32( interpol, interpol ), 0x08 ); \
+            STORE( &dst[x], _mm256_castsi256_si128( out ) ); \
+        } \
+    } while(0)
+
+#define STORE8(p, v)  _mm_storel_epi64( (__m128i *)(p), _mm_packus_epi16( v, v ) )
+#define STORE16(p, v) _mm_storeu_si128( (__m128i *)(p), v )
+
+VLC_AVX2
+void BwdifLine8AVX2( void *p_dst, const void *p_prev, const void *p_cur,
+                     const void *p_next, int w, ptrdiff_t refs,
+                     int parity, int clip_max )
+{
+    BWDIF_AVX2( uint8_t, LOAD8, STORE8 );
+}
+
+VLC_AVX2
+void BwdifLine16AVX2( void *p_dst, const void *p_prev, const void *p_cur,
+                      const void *p_next, int w, ptrdiff_t refs,
+                      int parity, int clip_max )
+{
+    BWDIF_AVX2( uint16_t, LOAD16, STORE16 );
+}
+#endif
+
+/*****************************************************************************
+ * Frame rendering
+ *****************************************************************************/
+
+struct bwdif_job
+{
+    picture_t *p_dst;
+    picture_t *p_prev;
+    picture_t *p_cur;
+    picture_t *p_next;
+    int i_field;
+    int i_parity;
+};
+
+static void RenderBwdifSlice( filter_t *p_filter, void *p_opaque,
+                              unsigned i_slice, unsigned i_slices )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const struct bwdif_job *p_job = p_opaque;
+    const unsigned i_pixel_size = p_sys->chroma->pixel_size;
+    const int i_clip_max = i_pixel_size == 1 ? 255
+                         : (1 << p_sys->chroma->pixel_bits) - 1;
+
+    for( int n = 0; n < p_job->p_dst->i_planes; n++ )
+    {
+        const plane_t *prevp = &p_job->p_prev->p[n];
+        const plane_t *curp  = &p_job->p_cur->p[n];
+        const plane_t *nextp = &p_job->p_next->p[n];
+        plane_t *dstp        = &p_job->p_dst->p[n];
+
+        const int h = dstp->i_visible_lines;
+        const int w = dstp->i_visible_pitch / i_pixel_size;
+        const int w8 = w & ~7;
+        const ptrdiff_t refs = curp->i_pitch / i_pixel_size;
+        unsigned i_start, i_end;
+
+        assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
+        vlc_slices_GetRange( h, i_slice, i_slices, 2, &i_start, &i_end );
+
+        for( int y = i_start; y < (int)i_end; y++ )
+        {
+            uint8_t *dst        = &dstp->p_pixels[y * dstp->i_pitch];
+            const uint8_t *prev = &prevp->p_pixels[y * curp->i_pitch];
+            const uint8_t *cur  = &curp->p_pixels[y * curp->i_pitch];
+            const uint8_t *next = &nextp->p_pixels[y * curp->i_pitch];
+
+            if( (y % 2) == p_job->i_field || p_job->i_parity == 2 )
+            {
+                memcpy( dst, cur, dstp->i_visible_pitch );
+            }
+            else if( y < 4 || y + 5 > h )
+            {
+                /* Mirror the missing lines on the borders, and do the
+                 * spatial checks only when enough data */
+                const ptrdiff_t prefs = y + 1 < h ? refs : -refs;
+                const ptrdiff_t mrefs = y > 0 ? -refs : refs;
+                const bool b_spat = y >= 2 && y + 3 <= h;
+
+                if( i_pixel_size == 1 )
+                    BwdifEdge8( dst, prev, cur, next, w, refs, prefs, mrefs,
+                                p_job->i_parity, i_clip_max, b_spat );
+                else
+                    BwdifEdge16( dst, prev, cur, next, w, refs, prefs, mrefs,
+                                 p_job->i_parity, i_clip_max, b_spat );
+            }
+            else
+            {
+                if( w8 > 0 )
+                    p_sys->pf_bwdif_line( dst, prev, cur, next, w8, refs,
+                                          p_job->i_parity, i_clip_max );
+                if( w8 < w )
+                {
+                    const size_t i_offset = w8 * i_pixel_size;
+                    if( i_pixel_size == 1 )
+                        BwdifLine8C( dst + i_offset, prev + i_offset,
+                                     cur + i_offset, next + i_offset, w - w8,
+                                     refs, p_job->i_parity, i_clip_max );
+                    else
+                        BwdifLine16C( dst + i_offset, prev + i_offset,
+                                      cur + i_offset, next + i_offset, w - w8,
+                                      refs, p_job->i_parity, i_clip_max );
+                }
+            }
+        }
+    }
+}
+
+int RenderBwdifSingle( filter_t *p_filter, picture_t *p_dst, picture_t *p_src )
+{
+    return RenderBwdif( p_filter, p_dst, p_src, 0, 0 );
+}
+
+int RenderBwdif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
+                 int i_order, int i_field )
+{
+    VLC_UNUSED(p_src);
+
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    /* */
+    assert( i_order >= 0 && i_order <= 2 ); /* 2 = soft field repeat */
+    assert( i_field == 0 || i_field == 1 );
+
+    /* As the pitches must match, use ONLY pictures coming from picture_New()! */
+    picture_t *p_prev = p_sys->context.pp_history[0];
+    picture_t *p_cur  = p_sys->context.pp_history[1];
+    picture_t *p_next = p_sys->context.pp_history[2];
+
+    /* Same parity and soft field repeat handling as RenderYadif(),
+       where 2 means "bypass filter". */
+    int i_parity;
+    if( p_cur  &&  p_cur->i_nb_fields > 2 )
+        i_parity = (i_order + 1) % 3; /* 1, *2*, 0 */
+    else
+        i_parity = (i_order + 1) % 2; /* 1, 0 */
+
+    /* Filter if we have all the pictures we need */
+    if( p_prev && p_cur && p_next )
+    {
+        struct bwdif_job job = {
+            .p_dst = p_dst, .p_prev = p_prev, .p_cur = p_cur, .p_next = p_next,
+            .i_field = i_field, .i_parity = i_parity,
+        };
+        RenderSlices( p_filter, RenderBwdifSlice, &job );
+
+        p_sys->context.i_frame_offset = 1; /* p_cur will be rendered at next frame, too */
+
+        return VLC_SUCCESS;
+    }
+    else if( !p_prev && !p_cur && p_next )
+    {
+        /* NOTE: For the first frame, we use the default frame offset
+                 as set by Open() or SetFilterMethod(). It is always 0. */
+
+        /* FIXME not good as it does not use i_order/i_field */
+        RenderX( p_filter, p_dst, p_next );
+        return VLC_SUCCESS;
+    }
+    else
+    {
+        p_sys->context.i_frame_offset = 1; /* p_cur will be rendered at next frame */
+
+        return VLC_EGENERIC;
+    }
+}
@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * algo_bwdif.h : Bwdif algorithm for the VLC deinterlacer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_DEINTERLACE_ALGO_BWDIF_H
+#define VLC_DEINTERLACE_ALGO_BWDIF_H 1
+
+/**
+ * \file
+ * Bwdif ("Bob Weaver" deinterlacing filter), from FFmpeg.
+ *
+ * It follows the Yadif motion adaptation, but interpolates with the w3fdif
+ * filter coefficients: a cubic spatial interpolation in static areas, and
+ * a temporal high-frequency compensation where there is motion.
+ */
+
+/* Forward declarations */
+struct filter_t;
+struct picture_t;
+
+/*****************************************************************************
+ * Functions
+ *****************************************************************************/
+
+/**
+ * Bwdif deinterlacer. One field is copied as-is (i_field), the other is
+ * interpolated.
+ *
+ * This is used exactly like RenderYadif(): it needs three frames in the
+ * history buffer, renders the *previous* input frame (i_frame_offset = 1),
+ * and supports soft field repeat and framerate doubling the same way.
+ *
+ * @param p_filter The filter instance. Must be non-NULL.
+ * @param p_dst Output frame. Must be allocated by caller.
+ * @param p_src Input frame. Must exist.
+ * @param i_order Temporal field number: 0 = first, 1 = second, 2 = rep. first.
+ * @param i_field Keep which field? 0 = top field, 1 = bottom field.
+ * @return VLC error code (int).
+ * @retval VLC_SUCCESS The requested field was rendered into p_dst.
+ * @retval VLC_EGENERIC Frame dropped; only occurs at the second frame after start.
+ * @see RenderYadif()
+ */
+int RenderBwdif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
+                 int i_order, int i_field );
+
+/**
+ * Same as RenderBwdif() but with no framerate doubling
+ */
+int RenderBwdifSingle( filter_t *p_filter, picture_t *p_dst, picture_t *p_src );
+
+/**
+ * Generic Bwdif line interpolation routines. No acceleration.
+ * @see bwdif_line_cb
+ */
+void BwdifLine8C( void *dst, const void *prev, const void *cur,
+                  const void *next, int w, ptrdiff_t refs,
+                  int parity, int clip_max );
+void BwdifLine16C( void *dst, const void *prev, const void *cur,
+                   const void *next, int w, ptrdiff_t refs,
+                   int parity, int clip_max );
+
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+/**
+ * AVX2 Bwdif line interpolation routines.
+ * @see bwdif_line_cb
+ */
+void BwdifLine8AVX2( void *dst, const void *prev, const void *cur,
+                     const void *next, int w, ptrdiff_t refs,
+                     int parity, int clip_max );
+void BwdifLine16AVX2( void *dst, const void *prev, const void *cur,
+                      const void *next, int w, ptrdiff_t refs,
+                      int parity, int clip_max );
+#endif
+
+#endif
@@ -143,6 +143,57 @@ static void DarkenField( picture_t *p_dst,
     } /* if process_chroma */
 }
 
+struct phosphor_job
+{
+    picture_t *p_dst;
+    picture_t *p_in_top;
+    picture_t *p_in_bottom;
+    compose_chroma_t cc;
+    int i_field;
+};
+
+/**
+ * Renders a slice of the output frame: composes it from the fields, and
+ * darkens the old field.
+ *
+ * The slices start on a multiple of 4 lines, so that the fields of the
+ * slices match the fields of the frame, also for 4:2:0 chroma.
+ */
+static void RenderPhosphorSlice( filter_t *p_filter, void *p_opaque,
+                                 unsigned i_slice, unsigned i_slices )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const struct phosphor_job *p_job = p_opaque;
+    picture_t dst, in_top, in_bottom;
+    unsigned i_start, i_end;
+
+    vlc_slices_GetRange( p_job->p_dst->p[Y_PLANE].i_visible_lines,
+                         i_slice, i_slices, 4, &i_start, &i_end );
+    vlc_slices_GetView( &dst, p_job->p_dst, i_start, i_end );
+    vlc_slices_GetView( &in_top, p_job->p_in_top, i_start, i_end );
+    vlc_slices_GetView( &in_bottom, p_job->p_in_bottom, i_start, i_end );
+
+    ComposeFrame( p_filter, &dst, &in_top, &in_bottom, p_job->cc,
+                  p_filter->fmt_in.video.i_chroma == VLC_CODEC_YV12 );
+
+    /* Simulate phosphor light output decay for the old field.
+
+       The dimmer can also be switched off in the configuration, but that is
+       more of a technical curiosity or an educational toy for advanced users
+       than a useful deinterlacer mode (although it does make telecined
+       material look slightly better than without any filtering).
+
+       In most use cases the dimmer is used.
+    */
+    if( p_sys->phosphor.i_dimmer_strength > 0 )
+    {
+            DarkenField( &dst, !p_job->i_field,
+                p_sys->phosphor.i_dimmer_strength,
+                p_sys->chroma->p[1].h.num == p_sys->chroma->p[1].h.den &&
+                p_sys->chroma->p[2].h.num == p_sys->chroma->p[2].h.den );
+    }
+}
+
 /*****************************************************************************
  * Public functions
  *****************************************************************************/
@@ -216,22 +267,10 @@ int RenderPhosphor( filter_t *p_filter,
             break;
         }
     }
-    ComposeFrame( p_filter, p_dst, p_in_top, p_in_bottom, cc, p_filter->fmt_in.video.i_chroma == VLC_CODEC_YV12 );
-
-    /* Simulate phosphor light output decay for the old field.
-
-       The dimmer can also be switched off in the configuration, but that is
-       more of a technical curiosity or an educational toy for advanced users
-       than a useful deinterlacer mode (although it does make telecined
-       material look slightly better than without any filtering).
-
-       In most use cases the dimmer is used.
-    */
-    if( p_sys->phosphor.i_dimmer_strength > 0 )
-    {
-            DarkenField( p_dst, !i_field, p_sys->phosphor.i_dimmer_strength,
-                p_sys->chroma->p[1].h.num == p_sys->chroma->p[1].h.den &&
-                p_sys->chroma->p[2].h.num == p_sys->chroma->p[2].h.den );
-    }
+    struct phosphor_job job = {
+        .p_dst = p_dst, .p_in_top = p_in_top, .p_in_bottom = p_in_bottom,
+        .cc = cc, .i_field = i_field,
+    };
+    RenderSlices( p_filter, RenderPhosphorSlice, &job );
     return VLC_SUCCESS;
 }
@@ -31,6 +31,7 @@
 #include <vlc_picture.h>
 
 #include "deinterlace.h" /* filter_sys_t */
+#include "helpers.h"     /* RenderSlices() */
 
 #include "algo_x.h"
 
@@ -295,9 +296,19 @@ static inline void XDeintBand8x8C( uint8_t *dst, int i_dst,
  * Public functions
  *****************************************************************************/
 
-int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
+struct x_job
+{
+    picture_t *p_outpic;
+    picture_t *p_pic;
+};
+
+static void RenderXSlice( filter_t *p_filter, void *p_opaque,
+                          unsigned i_slice, unsigned i_slices )
 {
     VLC_UNUSED(p_filter);
+    const struct x_job *p_job = p_opaque;
+    picture_t *p_outpic = p_job->p_outpic;
+    picture_t *p_pic = p_job->p_pic;
     int i_plane;
 
     /* Copy image and skip lines */
@@ -313,8 +324,12 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
         const int i_src = p_pic->p[i_plane].i_pitch;
 
         int y, x;
+        unsigned y_start, y_end;
+
+        /* Slices of whole block lines, the last one does the last line */
+        vlc_slices_GetRange( i_mby, i_slice, i_slices, 1, &y_start, &y_end );
 
-        for( y = 0; y < i_mby; y++ )
+        for( y = y_start; y < (int)y_end; y++ )
         {
             uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
             uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
@@ -323,7 +338,7 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
         }
 
         /* Last line (C only)*/
-        if( i_mody )
+        if( i_mody && i_slice + 1 == i_slices )
         {
             uint8_t *dst = &p_outpic->p[i_plane].p_pixels[8*y*i_dst];
             uint8_t *src = &p_pic->p[i_plane].p_pixels[8*y*i_src];
@@ -340,6 +355,12 @@ int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
                 XDeintNxN( dst, i_dst, src, i_src, i_modx, i_mody );
         }
     }
+}
+
+int RenderX( filter_t *p_filter, picture_t *p_outpic, picture_t *p_pic )
+{
+    struct x_job job = { .p_outpic = p_outpic, .p_pic = p_pic };
 
+    RenderSlices( p_filter, RenderXSlice, &job );
     return VLC_SUCCESS;
 }
@@ -280,6 +280,12 @@ static int Mouse( filter_t *p_filter,
                                     "Best simulation, but requires more CPU "\
                                     "and memory bandwidth.")
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_("Number of threads used by the Yadif, Bwdif, "\
+                            "X and Phosphor methods, each rendering a slice "\
+                            "of the picture. Default: 0 (automatic, for "\
+                            "pictures from 720p).")
+
 #define PHOSPHOR_DIMMER_TEXT N_("Phosphor old field dimmer strength")
 #define PHOSPHOR_DIMMER_LONGTEXT N_("This controls the strength of the "\
                                     "darkening filter that simulates CRT TV "\
@@ -304,6 +310,8 @@ vlc_module_begin ()
                 PHOSPHOR_DIMMER_LONGTEXT )
         change_integer_list( phosphor_dimmer_list, phosphor_dimmer_list_text )
         change_safe ()
+    add_integer_with_range( FILTER_CFG_PREFIX "threads", 0, 0, VLC_SLICES_MAX,
+                            THREADS_TEXT, THREADS_LONGTEXT )
     set_deinterlace_callback( Open )
 vlc_module_end ()
 
@@ -318,7 +326,7 @@ vlc_module_end ()
  * and reading logic for them implemented in Open().
  */
 static const char *const ppsz_filter_options[] = {
-    "mode", "phosphor-chroma", "phosphor-dimmer",
+    "mode", "phosphor-chroma", "phosphor-dimmer", "threads",
     NULL
 };
 
@@ -355,6 +363,10 @@ static struct filter_mode_t filter_mode [] = {
                  { false, true, false, false }, false, true },
     { "yadif2x", .pf_render_ordered = RenderYadif,
                  { true, true, false, false }, false, true },
+    { "bwdif", .pf_render_single_pic = RenderBwdifSingle,
+                 { false, true, false, false }, false, true },
+    { "bwdif2x", .pf_render_ordered = RenderBwdif,
+                 { true, true, false, false }, false, true },
     { "x", .pf_render_single_pic = RenderX,
                  { false, false, false, false }, false, false },
     { "phosphor", .pf_render_ordered = RenderPhosphor,
@@ -477,8 +489,11 @@ int Mouse( filter_t *p_filter,
  */
 static void Close( filter_t *p_filter )
 {
+    filter_sys_t *p_sys = p_filter->p_sys;
+
     Flush( p_filter );
-    free( p_filter->p_sys );
+    vlc_slices_Delete( p_sys->p_slices );
+    free( p_sys );
 }
 
 static const struct vlc_filter_operations filter_ops = {
@@ -490,6 +505,7 @@ static const struct vlc_filter_operations filter_ops = {
 
 static struct deinterlace_functions funcs = {
     { Merge8BitGeneric, Merge16BitGeneric, },
+    { BwdifLine8C, BwdifLine16C, },
 };
 
 /*****************************************************************************
@@ -552,6 +568,8 @@ notsupp:
 
     IVTCClearState( p_filter );
 
+    vlc_CPU_functions_init_once("deinterlace functions", &funcs);
+
 #if defined(CAN_COMPILE_C_ALTIVEC)
     if( pixel_size == 1 && vlc_CPU_ALTIVEC() )
         p_sys->pf_merge = MergeAltivec;
@@ -566,13 +584,31 @@ notsupp:
     else
 #endif
     {
-        vlc_CPU_functions_init_once("deinterlace functions", &funcs);
         p_sys->pf_merge = funcs.merges[vlc_ctz(pixel_size)];
 #if defined(__i386__) || defined(__x86_64__)
         p_sys->pf_end_merge = NULL;
 #endif
     }
 
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+    if( vlc_CPU_AVX2() )
+        p_sys->pf_bwdif_line = pixel_size == 1 ? BwdifLine8AVX2
+                                               : BwdifLine16AVX2;
+    else
+#endif
+        p_sys->pf_bwdif_line = funcs.bwdif_lines[vlc_ctz(pixel_size)];
+
+    p_sys->p_slices = vlc_slices_New( p_filter,
+                        var_GetInteger( p_filter, FILTER_CFG_PREFIX "threads" ),
+                        p_filter->fmt_in.video.i_visible_width,
+                        p_filter->fmt_in.video.i_visible_height );
+    if( unlikely(p_sys->p_slices == NULL) )
+    {
+        free( psz_mode );
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
     /* */
     video_format_t fmt;
     GetOutputFormat( p_filter, &fmt, &p_filter->fmt_in.video );
@@ -39,9 +39,12 @@ struct vlc_object_t;
 #include "algo_basic.h"
 #include "algo_x.h"
 #include "algo_yadif.h"
+#include "algo_bwdif.h"
 #include "algo_phosphor.h"
 #include "algo_ivtc.h"
 #include "common.h"
+#include "helpers.h"
+#include "merge.h"
 
 /*****************************************************************************
  * Local data
@@ -50,12 +53,12 @@ struct vlc_object_t;
 /** Available deinterlace modes. */
 static const char *const mode_list[] = {
     "discard", "blend", "mean", "bob", "linear", "x",
-    "yadif", "yadif2x", "phosphor", "ivtc" };
+    "yadif", "yadif2x", "bwdif", "bwdif2x", "phosphor", "ivtc" };
 
 /** User labels for the available deinterlace modes. */
 static const char *const mode_list_text[] = {
     N_("Discard"), N_("Blend"), N_("Mean"), N_("Bob"), N_("Linear"), "X",
-    "Yadif", "Yadif (2x)", N_("Phosphor"), N_("Film NTSC (IVTC)") };
+    "Yadif", "Yadif (2x)", "Bwdif", "Bwdif (2x)", N_("Phosphor"), N_("Film NTSC (IVTC)") };
 
 /*****************************************************************************
  * Data structures
@@ -74,6 +77,11 @@ typedef struct
     /** Merge finalization routine for SSE */
     void (*pf_end_merge) ( void );
 #endif
+    /** Bwdif line interpolation routine: C, AVX2, NEON, ... */
+    bwdif_line_cb pf_bwdif_line;
+
+    /** Slice threads of the yadif, bwdif, X and phosphor algorithms */
+    vlc_slices_t *p_slices;
 
     struct deinterlace_ctx   context;
 
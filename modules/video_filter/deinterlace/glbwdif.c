@@ -0,0 +1,518 @@
+/*****************************************************************************
+ * glbwdif.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_picture.h>
+#include <vlc_plugin.h>
+#include <vlc_modules.h>
+#include <vlc_opengl.h>
+#include <vlc_filter.h>
+
+#include "video_output/opengl/filter.h"
+#include "video_output/opengl/gl_api.h"
+#include "video_output/opengl/gl_common.h"
+#include "video_output/opengl/gl_util.h"
+#include "video_output/opengl/sampler.h"
+
+/*
+ * Motion adaptive deinterlacing with the Bwdif algorithm (see algo_bwdif.c),
+ * on each plane of the input.
+ *
+ * Each input plane is first copied to a history texture, so that the
+ * previous frame is available. As the filter cannot delay the pictures, it
+ * interpolates the second field of the current frame from the previous and
+ * current frames only, i.e. Bwdif without the look-ahead temporal check.
+ */
+
+struct plane {
+    GLuint textures[2];
+    GLuint framebuffers[2];
+    /** Index of the current frame in textures, the other is the previous */
+    unsigned cur;
+    /** Date of the current frame, to update the history once per picture */
+    vlc_tick_t pts;
+    bool has_history;
+};
+
+struct sys {
+    struct vlc_gl_sampler *sampler;
+
+    struct plane planes[PICTURE_PLANE_MAX];
+    unsigned plane_count;
+
+    GLuint vbo_copy;
+    GLuint vbo_quad;
+
+    struct {
+        GLuint id;
+        GLint vertex_pos;
+        GLint tex_coords_in;
+    } copy;
+
+    struct {
+        GLuint id;
+        GLint vertex_pos;
+        GLint tex_coords_in;
+        GLint prev_tex;
+        GLint cur_tex;
+        GLint height;
+        GLint first_field;
+    } bwdif;
+};
+
+static const char *const VERTEX_SHADER =
+    "attribute vec2 vertex_pos;\n"
+    "attribute vec2 tex_coords_in;\n"
+    "varying vec2 tex_coords;\n"
+    "void main() {\n"
+    "  gl_Position = vec4(vertex_pos, 0.0, 1.0);\n"
+    "  tex_coords = tex_coords_in;\n"
+    "}\n";
+
+static const char *const COPY_FRAGMENT_SHADER =
+    "varying vec2 tex_coords;\n"
+    "void main() {\n"
+    "  gl_FragColor = vlc_texture(tex_coords);\n"
+    "}\n";
+
+/* The history textures are in picture coordinates: the lines are counted
+ * from the top, while the texture coordinates go upwards. */
+static const char *const BWDIF_FRAGMENT_SHADER =
+    "varying vec2 tex_coords;\n"
+    "uniform sampler2D prev_tex;\n"
+    "uniform sampler2D cur_tex;\n"
+    "uniform float height;\n"
+    "uniform float first_field;\n"
+    "vec4 prev(float lines) {\n"
+    "  return texture2D(prev_tex, tex_coords - vec2(0.0, lines / height));\n"
+    "}\n"
+    "vec4 cur(float lines) {\n"
+    "  return texture2D(cur_tex, tex_coords - vec2(0.0, lines / height));\n"
+    "}\n"
+    "void main() {\n"
+    "  float line = floor((1.0 - tex_coords.y) * height);\n"
+    "  vec4 pix = cur(0.0);\n"
+    "  if (mod(line, 2.0) == first_field) {\n"
+    "    gl_FragColor = pix;\n"
+    "    return;\n"
+    "  }\n"
+    /* prev2 is the previous frame and next2 the current one */
+    "  float up = line > 0.5 ? -1.0 : 1.0;\n"
+    "  float down = line < height - 1.5 ? 1.0 : -1.0;\n"
+    "  vec4 c = cur(up);\n"
+    "  vec4 e = cur(down);\n"
+    "  vec4 p0 = prev(0.0);\n"
+    "  vec4 d = (p0 + pix) / 2.0;\n"
+    "  vec4 td0 = abs(p0 - pix);\n"
+    "  vec4 td1 = (abs(prev(up) - c) + abs(prev(down) - e)) / 2.0;\n"
+    "  vec4 diff = max(td0 / 2.0, td1);\n"
+    "  vec4 still = vec4(equal(diff, vec4(0.0)));\n"
+    "  bool full = line >= 4.0 && line + 5.0 <= height;\n"
+    "  if (line >= 2.0 && line + 3.0 <= height) {\n"
+    "    vec4 b = (prev(-2.0) + cur(-2.0)) / 2.0 - c;\n"
+    "    vec4 f = (prev(2.0) + cur(2.0)) / 2.0 - e;\n"
+    "    vec4 dc = d - c;\n"
+    "    vec4 de = d - e;\n"
+    "    vec4 mx = max(max(de, dc), min(b, f));\n"
+    "    vec4 mn = min(min(de, dc), max(b, f));\n"
+    "    diff = max(max(diff, mn), -mx);\n"
+    "  }\n"
+    "  vec4 interpol = (c + e) / 2.0;\n"
+    "  if (full) {\n"
+    "    vec4 c3 = cur(-3.0) + cur(3.0);\n"
+    "    vec4 sp = (5077.0 * (c + e) - 981.0 * c3) / 8192.0;\n"
+    "    vec4 hf = ((5570.0 * (p0 + pix)\n"
+    "              - 3801.0 * (prev(-2.0) + cur(-2.0) + prev(2.0) + cur(2.0))\n"
+    "              + 1016.0 * (prev(-4.0) + cur(-4.0) + prev(4.0) + cur(4.0)))\n"
+    "              / 4.0 + 4309.0 * (c + e) - 213.0 * c3) / 8192.0;\n"
+    "    interpol = mix(sp, hf, vec4(greaterThan(abs(c - e), td0)));\n"
+    "  }\n"
+    "  interpol = clamp(interpol, d - diff, d + diff);\n"
+    "  gl_FragColor = mix(clamp(interpol, 0.0, 1.0), d, still);\n"
+    "}\n";
+
+static void
+DeleteHistory(struct vlc_gl_filter *filter)
+{
+    struct sys *sys = filter->sys;
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    for (unsigned i = 0; i < sys->plane_count; ++i)
+    {
+        vt->DeleteFramebuffers(2, sys->planes[i].framebuffers);
+        vt->DeleteTextures(2, sys->planes[i].textures);
+    }
+    sys->plane_count = 0;
+}
+
+static int
+InitHistory(struct vlc_gl_filter *filter, const struct vlc_gl_format *glfmt)
+{
+    struct sys *sys = filter->sys;
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    GLint draw_framebuffer;
+    vt->GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+
+    int ret = VLC_SUCCESS;
+    for (unsigned i = 0; i < glfmt->tex_count; ++i)
+    {
+        struct plane *plane = &sys->planes[i];
+
+        vt->GenFramebuffers(2, plane->framebuffers);
+        vt->GenTextures(2, plane->textures);
+        plane->cur = 0;
+        plane->has_history = false;
+        sys->plane_count++;
+
+        for (unsigned j = 0; j < 2; ++j)
+        {
+            vt->BindTexture(GL_TEXTURE_2D, plane->textures[j]);
+            vt->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, glfmt->tex_widths[i],
+                           glfmt->tex_heights[i], 0, GL_RGBA,
+                           GL_UNSIGNED_BYTE, NULL);
+            /* The lines of the fields must not be interpolated */
+            vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            vt->BindFramebuffer(GL_FRAMEBUFFER, plane->framebuffers[j]);
+            vt->FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                     GL_TEXTURE_2D, plane->textures[j], 0);
+            if (vt->CheckFramebufferStatus(GL_FRAMEBUFFER)
+                    != GL_FRAMEBUFFER_COMPLETE)
+                ret = VLC_EGENERIC;
+        }
+
+        if (ret != VLC_SUCCESS)
+            break;
+    }
+
+    vt->BindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
+
+    if (ret != VLC_SUCCESS)
+        DeleteHistory(filter);
+    return ret;
+}
+
+static void
+SetupAttribs(const opengl_vtable_t *vt, GLint vertex_pos, GLint tex_coords_in)
+{
+    const GLsizei stride = 4 * sizeof(float);
+
+    vt->EnableVertexAttribArray(vertex_pos);
+    vt->VertexAttribPointer(vertex_pos, 2, GL_FLOAT, GL_FALSE, stride,
+                            (const void *) 0);
+
+    intptr_t offset = 2 * sizeof(float);
+    vt->EnableVertexAttribArray(tex_coords_in);
+    vt->VertexAttribPointer(tex_coords_in, 2, GL_FLOAT, GL_FALSE, stride,
+                            (const void *) offset);
+}
+
+/* Copy the input plane to the history, in picture coordinates */
+static void
+UpdateHistory(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
+              const struct vlc_gl_input_meta *meta)
+{
+    struct sys *sys = filter->sys;
+    struct plane *plane = &sys->planes[meta->plane];
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    /* The first picture is also its own previous frame */
+    unsigned count = plane->has_history ? 1 : 2;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        plane->cur = !plane->cur;
+
+        vt->BindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                            plane->framebuffers[plane->cur]);
+
+        vt->UseProgram(sys->copy.id);
+
+        struct vlc_gl_sampler *sampler = sys->sampler;
+        vlc_gl_sampler_SelectPlane(sampler, meta->plane);
+        vlc_gl_sampler_Update(sampler, pic);
+        vlc_gl_sampler_Load(sampler);
+
+        vt->BindBuffer(GL_ARRAY_BUFFER, sys->vbo_copy);
+        SetupAttribs(vt, sys->copy.vertex_pos, sys->copy.tex_coords_in);
+        vt->DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    plane->pts = meta->pts;
+    plane->has_history = true;
+}
+
+static int
+Draw(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
+     const struct vlc_gl_input_meta *meta)
+{
+    struct sys *sys = filter->sys;
+    struct plane *plane = &sys->planes[meta->plane];
+
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    if (pic->mtx_has_changed)
+    {
+        float coords[] = {
+            0, 1,
+            0, 0,
+            1, 1,
+            1, 0,
+        };
+
+        /* Transform coordinates in place */
+        vlc_gl_picture_ToTexCoords(pic, 4, coords, coords);
+
+        const float data[] = {
+            -1,  1, coords[0], coords[1],
+            -1, -1, coords[2], coords[3],
+             1,  1, coords[4], coords[5],
+             1, -1, coords[6], coords[7],
+        };
+        vt->BindBuffer(GL_ARRAY_BUFFER, sys->vbo_copy);
+        vt->BufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
+    }
+
+    /* The same picture may be drawn several times */
+    if (!plane->has_history || plane->pts != meta->pts)
+    {
+        GLint draw_framebuffer;
+        vt->GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+
+        UpdateHistory(filter, pic, meta);
+
+        vt->BindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
+    }
+
+    vt->UseProgram(sys->bwdif.id);
+
+    vt->ActiveTexture(GL_TEXTURE0);
+    vt->BindTexture(GL_TEXTURE_2D, plane->textures[!plane->cur]);
+    vt->Uniform1i(sys->bwdif.prev_tex, 0);
+    vt->ActiveTexture(GL_TEXTURE1);
+    vt->BindTexture(GL_TEXTURE_2D, plane->textures[plane->cur]);
+    vt->Uniform1i(sys->bwdif.cur_tex, 1);
+    vt->ActiveTexture(GL_TEXTURE0);
+
+    const struct vlc_gl_format *glfmt = &sys->sampler->glfmt;
+    vt->Uniform1f(sys->bwdif.height, glfmt->tex_heights[meta->plane]);
+    /* The first field is kept, the second one is interpolated */
+    vt->Uniform1f(sys->bwdif.first_field, meta->top_field_first ? 0.f : 1.f);
+
+    vt->BindBuffer(GL_ARRAY_BUFFER, sys->vbo_quad);
+    SetupAttribs(vt, sys->bwdif.vertex_pos, sys->bwdif.tex_coords_in);
+
+    vt->Clear(GL_COLOR_BUFFER_BIT);
+    vt->DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    return VLC_SUCCESS;
+}
+
+static void
+Close(struct vlc_gl_filter *filter)
+{
+    struct sys *sys = filter->sys;
+
+    vlc_gl_sampler_Delete(sys->sampler);
+
+    const opengl_vtable_t *vt = &filter->api->vt;
+    DeleteHistory(filter);
+    vt->DeleteProgram(sys->copy.id);
+    vt->DeleteProgram(sys->bwdif.id);
+    vt->DeleteBuffers(1, &sys->vbo_copy);
+    vt->DeleteBuffers(1, &sys->vbo_quad);
+
+    free(sys);
+}
+
+static int
+Open(struct vlc_gl_filter *filter, const config_chain_t *config,
+     const struct vlc_gl_format *glfmt, struct vlc_gl_tex_size *size_out)
+{
+    (void) config;
+    (void) size_out;
+
+    static const struct vlc_gl_filter_ops ops = {
+        .draw = Draw,
+        .close = Close,
+    };
+    filter->ops = &ops;
+    filter->config.filter_planes = true;
+
+    struct vlc_gl_sampler *sampler =
+        vlc_gl_sampler_New(filter->gl, filter->api, glfmt, true);
+    if (!sampler)
+        return VLC_EGENERIC;
+
+    struct sys *sys = filter->sys = malloc(sizeof(*sys));
+    if (!sys)
+    {
+        vlc_gl_sampler_Delete(sampler);
+        return VLC_EGENERIC;
+    }
+
+    sys->sampler = sampler;
+    sys->plane_count = 0;
+    sys->copy.id = 0;
+    sys->bwdif.id = 0;
+
+    const char *shader_version;
+    const char *shader_precision;
+    if (filter->api->is_gles)
+    {
+        shader_version = "#version 100\n";
+        shader_precision = "precision highp float;\n";
+    }
+    else
+    {
+        shader_version = "#version 120\n";
+        shader_precision = "";
+    }
+
+    const char *extensions = sampler->shader.extensions
+                           ? sampler->shader.extensions : "";
+
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    const char *vertex_shader[] = { shader_version, VERTEX_SHADER };
+    const char *copy_shader[] = {
+        shader_version,
+        extensions,
+        shader_precision,
+        sampler->shader.body,
+        COPY_FRAGMENT_SHADER,
+    };
+    const char *bwdif_shader[] = {
+        shader_version,
+        shader_precision,
+        BWDIF_FRAGMENT_SHADER,
+    };
+
+    sys->copy.id =
+        vlc_gl_BuildProgram(VLC_OBJECT(filter), vt,
+                            ARRAY_SIZE(vertex_shader), vertex_shader,
+                            ARRAY_SIZE(copy_shader), copy_shader);
+    if (!sys->copy.id)
+        goto error;
+
+    vlc_gl_sampler_FetchLocations(sampler, sys->copy.id);
+
+    sys->copy.vertex_pos = vt->GetAttribLocation(sys->copy.id, "vertex_pos");
+    assert(sys->copy.vertex_pos != -1);
+
+    sys->copy.tex_coords_in = vt->GetAttribLocation(sys->copy.id,
+                                                    "tex_coords_in");
+    assert(sys->copy.tex_coords_in != -1);
+
+    sys->bwdif.id =
+        vlc_gl_BuildProgram(VLC_OBJECT(filter), vt,
+                            ARRAY_SIZE(vertex_shader), vertex_shader,
+                            ARRAY_SIZE(bwdif_shader), bwdif_shader);
+    if (!sys->bwdif.id)
+        goto error;
+
+    sys->bwdif.vertex_pos = vt->GetAttribLocation(sys->bwdif.id, "vertex_pos");
+    assert(sys->bwdif.vertex_pos != -1);
+
+    sys->bwdif.tex_coords_in = vt->GetAttribLocation(sys->bwdif.id,
+                                                     "tex_coords_in");
+    assert(sys->bwdif.tex_coords_in != -1);
+
+#define GET_LOC(name) \
+    sys->bwdif.name = vt->GetUniformLocation(sys->bwdif.id, #name); \
+    assert(sys->bwdif.name != -1)
+
+    GET_LOC(prev_tex);
+    GET_LOC(cur_tex);
+    GET_LOC(height);
+    GET_LOC(first_field);
+#undef GET_LOC
+
+    if (InitHistory(filter, glfmt) != VLC_SUCCESS)
+    {
+        msg_Err(filter, "could not create the deinterlacing history");
+        goto error;
+    }
+
+    vt->GenBuffers(1, &sys->vbo_copy);
+    vt->GenBuffers(1, &sys->vbo_quad);
+
+    /* The output is drawn in picture coordinates, as the history */
+    static const float quad[] = {
+        -1,  1, 0, 1,
+        -1, -1, 0, 0,
+         1,  1, 1, 1,
+         1, -1, 1, 0,
+    };
+    vt->BindBuffer(GL_ARRAY_BUFFER, sys->vbo_quad);
+    vt->BufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    return VLC_SUCCESS;
+
+error:
+    if (sys->copy.id)
+        vt->DeleteProgram(sys->copy.id);
+    if (sys->bwdif.id)
+        vt->DeleteProgram(sys->bwdif.id);
+    vlc_gl_sampler_Delete(sampler);
+    free(sys);
+    return VLC_EGENERIC;
+}
+
+static int OpenVideoFilter(vlc_object_t *obj)
+{
+    filter_t *filter = (filter_t*)obj;
+
+    char *mode = var_InheritString(obj, "deinterlace-mode");
+    bool is_supported = mode != NULL
+        && (!strcmp(mode, "bwdif") || !strcmp(mode, "yadif"));
+    free(mode);
+
+    if (!is_supported)
+        return VLC_EGENERIC;
+
+    module_t *module = vlc_gl_WrapOpenGLFilter(filter, "glbwdif");
+    if (module == NULL)
+        return VLC_EGENERIC;
+
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_shortname("bwdif")
+    set_description("OpenGL Bwdif deinterlace filter")
+    set_subcategory(SUBCAT_VIDEO_VFILTER)
+
+    set_capability("video filter", 0)
+    set_callback(OpenVideoFilter)
+    add_shortcut("glbwdif")
+
+    add_submodule()
+        set_capability("opengl filter", 0)
+        set_callback_opengl_filter(Open)
+        add_shortcut("glbwdif")
+vlc_module_end()
@@ -452,3 +452,33 @@ int CalculateInterlaceScore( const picture_t* p_pic_top,
     return i_score;
 }
 #undef T
+
+/*****************************************************************************
+ * Slice threading
+ *****************************************************************************/
+
+struct slice_job
+{
+    filter_t *p_filter;
+    slice_render_cb pf_render;
+    void *p_opaque;
+};
+
+static void RenderSlice( void *p_data, unsigned i_slice, unsigned i_slices )
+{
+    const struct slice_job *p_job = p_data;
+
+    p_job->pf_render( p_job->p_filter, p_job->p_opaque, i_slice, i_slices );
+}
+
+/* See header for function doc. */
+void RenderSlices( filter_t *p_filter, slice_render_cb pf_render,
+                   void *p_opaque )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    struct slice_job job = {
+        .p_filter = p_filter, .pf_render = pf_render, .p_opaque = p_opaque,
+    };
+
+    vlc_slices_Run( p_sys->p_slices, RenderSlice, &job );
+}
@@ -29,11 +29,29 @@
  * some of the advanced algorithms.
  */
 
+#include <vlc_common.h>
+#include <vlc_slices.h>
+
 /* Forward declarations */
 struct filter_t;
 struct picture_t;
 struct plane_t;
 
+/**
+ * Renders one slice of a picture.
+ *
+ * Slices must only write the output lines of their own range, as given by
+ * vlc_slices_GetRange() or vlc_slices_GetView(). They are run concurrently.
+ *
+ * @param p_filter The filter instance.
+ * @param p_opaque Algorithm data given to RenderSlices().
+ * @param i_slice Slice index, from 0 to i_slices - 1.
+ * @param i_slices Number of slices of the picture.
+ * @see RenderSlices()
+ */
+typedef void (*slice_render_cb)( filter_t *p_filter, void *p_opaque,
+                                 unsigned i_slice, unsigned i_slices );
+
 /**
  * Chroma operation types for composing 4:2:0 frames.
  * @see ComposeFrame()
@@ -165,4 +183,17 @@ int EstimateNumBlocksWithMotion( const picture_t* p_prev,
 int CalculateInterlaceScore( const picture_t* p_pic_top,
                              const picture_t* p_pic_bot );
 
+/**
+ * Renders all the slices of a picture, and waits for them.
+ *
+ * The slices run on the slice threads of the filter, the first one on the
+ * calling thread.
+ *
+ * @param p_filter The filter instance.
+ * @param pf_render Slice rendering function.
+ * @param p_opaque Algorithm data passed to pf_render.
+ */
+void RenderSlices( filter_t *p_filter, slice_render_cb pf_render,
+                   void *p_opaque );
+
 #endif
@@ -49,6 +49,25 @@
 
 typedef void (*merge_cb)(void *d, const void *s1, const void *s2, size_t len);
 
+/**
+ * Interpolate a line of the missing field with the Bwdif algorithm.
+ *
+ * The line must have at least 4 lines on each side in the pictures, i.e.
+ * this is not used for the borders.
+ *
+ * \param dst Output line
+ * \param prev Same line in the previous frame
+ * \param cur Same line in the current frame
+ * \param next Same line in the next frame
+ * \param w number of pixels, a multiple of 8
+ * \param refs pitch of the pictures, in pixels
+ * \param parity 1 if the field is the first field of the current frame
+ * \param clip_max maximum pixel value
+ */
+typedef void (*bwdif_line_cb)(void *dst, const void *prev, const void *cur,
+                              const void *next, int w, ptrdiff_t refs,
+                              int parity, int clip_max);
+
 /**
  * Deinterlacing optimisation callbacks.
  */
@@ -58,6 +77,8 @@ struct deinterlace_functions {
      * The first array entries are indexed by the binary order of magnitude
      * of the element size in bytes: 0 for 8-bit, 1 for 16-bit. */
     merge_cb merges[2];
+    /** Bwdif line interpolation, indexed as merges */
+    bwdif_line_cb bwdif_lines[2];
 };
 
 /*****************************************************************************
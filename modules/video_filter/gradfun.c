@@ -35,6 +35,7 @@
 #include <vlc_cpu.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
+#include <vlc_slices.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -53,6 +54,11 @@ static int  Open (filter_t *);
 #define STRENGTH_TEXT N_("Strength")
 #define STRENGTH_LONGTEXT N_("Strength used to modify the value of a pixel")
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_("Number of threads, each filtering a slice of " \
+                            "the picture. Default: 0 (automatic, for " \
+                            "pictures from 720p).")
+
 vlc_module_begin()
     set_description(N_("Gradfun video filter"))
     set_shortname(N_("Gradfun"))
@@ -62,6 +68,8 @@ vlc_module_begin()
                            RADIUS_TEXT, RADIUS_LONGTEXT)
     add_float_with_range(CFG_PREFIX "strength", 1.2, STRENGTH_MIN, STRENGTH_MAX,
                          STRENGTH_TEXT, STRENGTH_LONGTEXT)
+    add_integer_with_range(CFG_PREFIX "threads", 0, 0, VLC_SLICES_MAX,
+                           THREADS_TEXT, THREADS_LONGTEXT)
 
     set_callback_video_filter(Open)
 vlc_module_end()
@@ -80,6 +88,18 @@ vlc_module_end()
 #else
 #   define HAVE_SSSE3 0
 #endif
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+#   define HAVE_AVX2 1
+#   include <immintrin.h>
+#else
+#   define HAVE_AVX2 0
+#endif
+#if defined(__ARM_NEON)
+#   define HAVE_NEON 1
+#   include <arm_neon.h>
+#else
+#   define HAVE_NEON 0
+#endif
 // FIXME too restrictive
 #ifdef __x86_64__
 #   define HAVE_6REGS 1
@@ -99,6 +119,7 @@ typedef struct
     float            strength;
     int              radius;
     const vlc_chroma_description_t *chroma;
+    vlc_slices_t *slices;
     struct vf_priv_s cfg;
 } filter_sys_t;
 
@@ -116,6 +137,15 @@ static int Open(filter_t *filter)
     if (!sys)
         return VLC_ENOMEM;
 
+    sys->slices = vlc_slices_New(filter,
+                        var_InheritInteger(filter, CFG_PREFIX "threads"),
+                        filter->fmt_in.video.i_visible_width,
+                        filter->fmt_in.video.i_visible_height);
+    if (!sys->slices) {
+        free(sys);
+        return VLC_ENOMEM;
+    }
+
     vlc_mutex_init(&sys->lock);
     sys->chroma   = chroma;
     sys->strength = var_CreateGetFloatCommand(filter,   CFG_PREFIX "strength");
@@ -129,18 +159,36 @@ static int Open(filter_t *filter)
     cfg->radius      = 0;
     cfg->buf         = NULL;
 
+#if HAVE_AVX2
+    if (vlc_CPU_AVX2())
+        cfg->blur_line = blur_line_avx2;
+    else
+#endif
 #if HAVE_SSE2 && HAVE_6REGS
     if (vlc_CPU_SSE2())
         cfg->blur_line = blur_line_sse2;
     else
 #endif
+#if HAVE_NEON
+        cfg->blur_line   = blur_line_neon;
+#else
         cfg->blur_line   = blur_line_c;
+#endif
+#if HAVE_AVX2
+    if (vlc_CPU_AVX2())
+        cfg->filter_line = filter_line_avx2;
+    else
+#endif
 #if HAVE_SSSE3
     if (vlc_CPU_SSSE3())
         cfg->filter_line = filter_line_ssse3;
     else
 #endif
+#if HAVE_NEON
+        cfg->filter_line = filter_line_neon;
+#else
         cfg->filter_line = filter_line_c;
+#endif
 
     filter->p_sys = sys;
     filter->ops   = &Filter_ops;
@@ -154,9 +202,53 @@ static void Close(filter_t *filter)
     var_DelCallback(filter, CFG_PREFIX "radius",   Callback, NULL);
     var_DelCallback(filter, CFG_PREFIX "strength", Callback, NULL);
     aligned_free(sys->cfg.buf);
+    vlc_slices_Delete(sys->slices);
     free(sys);
 }
 
+struct gradfun_job
+{
+    filter_t  *filter;
+    picture_t *src;
+    picture_t *dst;
+};
+
+static void FilterSlice(void *opaque, unsigned slice, unsigned slices)
+{
+    const struct gradfun_job *job = opaque;
+    filter_sys_t *sys = job->filter->p_sys;
+    const video_format_t *fmt = &job->filter->fmt_in.video;
+    struct vf_priv_s *cfg = &sys->cfg;
+
+    for (int i = 0; i < job->dst->i_planes; i++) {
+        const plane_t *srcp = &job->src->p[i];
+        plane_t       *dstp = &job->dst->p[i];
+
+        const vlc_chroma_description_t *chroma = sys->chroma;
+        int w = fmt->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
+        int h = fmt->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
+        int r = (cfg->radius  * chroma->p[i].w.num / chroma->p[i].w.den +
+                 cfg->radius  * chroma->p[i].h.num / chroma->p[i].h.den) / 2;
+        r = VLC_CLIP((r + 1) & ~1, RADIUS_MIN, RADIUS_MAX);
+        if (__MIN(w, h) > 2 * r && cfg->buf) {
+            /* Slices start past the first blur window, and before the
+             * last one */
+            unsigned count = __MIN(slices, __MAX(h / (4 * r), 1));
+            unsigned y_start, y_end;
+
+            if (slice >= count)
+                continue;
+            vlc_slices_GetRange(h, slice, count, 2, &y_start, &y_end);
+            filter_plane(cfg, cfg->buf + slice * cfg->buf_stride,
+                         dstp->p_pixels, srcp->p_pixels,
+                         w, h, dstp->i_pitch, srcp->i_pitch, r,
+                         y_start, y_end);
+        } else if (slice == 0) {
+            plane_CopyPixels(dstp, srcp);
+        }
+    }
+}
+
 static void Filter(filter_t *filter, picture_t *src, picture_t *dst)
 {
     filter_sys_t *sys = filter->p_sys;
@@ -171,28 +263,15 @@ static void Filter(filter_t *filter, picture_t *src, picture_t *dst)
 
     cfg->thresh = (1 << 15) / strength;
     if (cfg->radius != radius) {
-        cfg->radius = radius;
-        cfg->buf    = aligned_alloc(16,
-                                   (((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32) * sizeof(*cfg->buf));
+        cfg->radius     = radius;
+        cfg->buf_stride = ((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32;
+        aligned_free(cfg->buf);
+        cfg->buf        = aligned_alloc(16, cfg->buf_stride * sizeof(*cfg->buf)
+                                            * vlc_slices_Count(sys->slices));
     }
 
-    for (int i = 0; i < dst->i_planes; i++) {
-        const plane_t *srcp = &src->p[i];
-        plane_t       *dstp = &dst->p[i];
-
-        const vlc_chroma_description_t *chroma = sys->chroma;
-        int w = fmt->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
-        int h = fmt->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
-        int r = (cfg->radius  * chroma->p[i].w.num / chroma->p[i].w.den +
-                 cfg->radius  * chroma->p[i].h.num / chroma->p[i].h.den) / 2;
-        r = VLC_CLIP((r + 1) & ~1, RADIUS_MIN, RADIUS_MAX);
-        if (__MIN(w, h) > 2 * r && cfg->buf) {
-            filter_plane(cfg, dstp->p_pixels, srcp->p_pixels,
-                         w, h, dstp->i_pitch, srcp->i_pitch, r);
-        } else {
-            plane_CopyPixels(dstp, srcp);
-        }
-    }
+    struct gradfun_job job = { .filter = filter, .src = src, .dst = dst };
+    vlc_slices_Run(sys->slices, FilterSlice, &job);
 }
 
 static int Callback(vlc_object_t *object, char const *cmd,
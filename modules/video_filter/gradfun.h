@@ -31,7 +31,8 @@
 struct vf_priv_s {
     int thresh;
     int radius;
-    uint16_t *buf;
+    uint16_t *buf;      /* work buffers of the slices */
+    size_t buf_stride;
     void (*filter_line)(uint8_t *dst, uint8_t *src, uint16_t *dc,
                         int width, int thresh, const uint16_t *dithers);
     void (*blur_line)(uint16_t *dc, uint16_t *buf, uint16_t *buf1,
@@ -172,19 +173,158 @@ static void blur_line_sse2(uint16_t *dc, uint16_t *buf, uint16_t *buf1,
 }
 #endif // HAVE_6REGS && HAVE_SSE2
 
-static void filter_plane(struct vf_priv_s *ctx, uint8_t *dst, uint8_t *src,
-                         int width, int height, int dstride, int sstride, int r)
+#if HAVE_AVX2
+/* Same rounding as filter_line_ssse3() */
+VLC_AVX2
+static void filter_line_avx2(uint8_t *dst, uint8_t *src, uint16_t *dc,
+                             int width, int thresh, const uint16_t *dithers)
+{
+    const __m128i dith = _mm_load_si128((const __m128i *)dithers);
+    const __m256i dith2 = _mm256_broadcastsi128_si256(dith);
+    const __m256i thresh2 = _mm256_set1_epi16(thresh);
+    const __m256i c127 = _mm256_set1_epi16(127);
+    int x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i dc8 = _mm_loadu_si128((const __m128i *)&dc[x/2]);
+        __m256i dcx = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_unpacklo_epi16(dc8, dc8)),
+                _mm_unpackhi_epi16(dc8, dc8), 1);
+        __m256i pix = _mm256_slli_epi16(_mm256_cvtepu8_epi16(
+                _mm_loadu_si128((const __m128i *)&src[x])), 7);
+        __m256i delta = _mm256_sub_epi16(dcx, pix);
+        __m256i m = _mm256_mulhi_epu16(_mm256_abs_epi16(delta), thresh2);
+        m = _mm256_min_epi16(_mm256_sub_epi16(m, c127),
+                             _mm256_setzero_si256());
+        m = _mm256_slli_epi16(_mm256_mullo_epi16(m, m), 1);
+        pix = _mm256_add_epi16(pix, dith2);
+        pix = _mm256_add_epi16(pix, _mm256_mulhrs_epi16(delta, m));
+        pix = _mm256_srai_epi16(pix, 7);
+        _mm_storeu_si128((__m128i *)&dst[x],
+                         _mm_packus_epi16(_mm256_castsi256_si128(pix),
+                                          _mm256_extracti128_si256(pix, 1)));
+    }
+    if (x + 8 <= width) {
+        __m128i dcx = _mm_loadl_epi64((const __m128i *)&dc[x/2]);
+        dcx = _mm_unpacklo_epi16(dcx, dcx);
+        __m128i pix = _mm_slli_epi16(_mm_cvtepu8_epi16(
+                _mm_loadl_epi64((const __m128i *)&src[x])), 7);
+        __m128i delta = _mm_sub_epi16(dcx, pix);
+        __m128i m = _mm_mulhi_epu16(_mm_abs_epi16(delta),
+                                    _mm256_castsi256_si128(thresh2));
+        m = _mm_min_epi16(_mm_sub_epi16(m, _mm256_castsi256_si128(c127)),
+                          _mm_setzero_si128());
+        m = _mm_slli_epi16(_mm_mullo_epi16(m, m), 1);
+        pix = _mm_add_epi16(pix, dith);
+        pix = _mm_add_epi16(pix, _mm_mulhrs_epi16(delta, m));
+        pix = _mm_srai_epi16(pix, 7);
+        _mm_storel_epi64((__m128i *)&dst[x], _mm_packus_epi16(pix, pix));
+        x += 8;
+    }
+    if (x < width)
+        filter_line_c(dst+x, src+x, dc+x/2, width-x, thresh, dithers);
+}
+
+/* The first line of the ring buffer may alias dc + 16: it is read before dc
+ * is written, as in the other versions */
+VLC_AVX2
+static void blur_line_avx2(uint16_t *dc, uint16_t *buf, uint16_t *buf1,
+                           uint8_t *src, int sstride, int width)
+{
+    const __m256i ones = _mm256_set1_epi8(1);
+    int x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m256i v = _mm256_add_epi16(
+            _mm256_maddubs_epi16(
+                _mm256_loadu_si256((const __m256i *)&src[2*x]), ones),
+            _mm256_maddubs_epi16(
+                _mm256_loadu_si256((const __m256i *)&src[2*x+sstride]), ones));
+        v = _mm256_add_epi16(v, _mm256_loadu_si256((const __m256i *)&buf1[x]));
+        __m256i old = _mm256_loadu_si256((const __m256i *)&buf[x]);
+        _mm256_storeu_si256((__m256i *)&buf[x], v);
+        _mm256_storeu_si256((__m256i *)&dc[x], _mm256_sub_epi16(v, old));
+    }
+    if (x < width)
+        blur_line_c(dc+x, buf+x, buf1+x, src+2*x, sstride, width-x);
+}
+#endif // HAVE_AVX2
+
+#if HAVE_NEON
+/* Same rounding as filter_line_ssse3() */
+static void filter_line_neon(uint8_t *dst, uint8_t *src, uint16_t *dc,
+                             int width, int thresh, const uint16_t *dithers)
+{
+    const int16x8_t dith = vld1q_s16((const int16_t *)dithers);
+    const uint16x4_t thresh4 = vdup_n_u16(thresh);
+    int x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        uint16x4x2_t dc2 = vzip_u16(vld1_u16(&dc[x/2]), vld1_u16(&dc[x/2]));
+        int16x8_t dcx = vreinterpretq_s16_u16(vcombine_u16(dc2.val[0],
+                                                           dc2.val[1]));
+        int16x8_t pix = vreinterpretq_s16_u16(vshll_n_u8(vld1_u8(&src[x]), 7));
+        int16x8_t delta = vsubq_s16(dcx, pix);
+        uint16x8_t ad = vreinterpretq_u16_s16(vabsq_s16(delta));
+        int16x8_t m = vreinterpretq_s16_u16(vcombine_u16(
+            vshrn_n_u32(vmull_u16(vget_low_u16(ad), thresh4), 16),
+            vshrn_n_u32(vmull_u16(vget_high_u16(ad), thresh4), 16)));
+        m = vminq_s16(vsubq_s16(m, vdupq_n_s16(127)), vdupq_n_s16(0));
+        m = vshlq_n_s16(vmulq_s16(m, m), 1);
+        pix = vaddq_s16(pix, dith);
+        pix = vaddq_s16(pix, vqrdmulhq_s16(delta, m));
+        vst1_u8(&dst[x], vqshrun_n_s16(pix, 7));
+    }
+    if (x < width)
+        filter_line_c(dst+x, src+x, dc+x/2, width-x, thresh, dithers);
+}
+
+static void blur_line_neon(uint16_t *dc, uint16_t *buf, uint16_t *buf1,
+                           uint8_t *src, int sstride, int width)
+{
+    int x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t v = vpaddlq_u8(vld1q_u8(&src[2*x]));
+        v = vpadalq_u8(v, vld1q_u8(&src[2*x+sstride]));
+        v = vaddq_u16(v, vld1q_u16(&buf1[x]));
+        uint16x8_t old = vld1q_u16(&buf[x]);
+        vst1q_u16(&buf[x], v);
+        vst1q_u16(&dc[x], vsubq_u16(v, old));
+    }
+    if (x < width)
+        blur_line_c(dc+x, buf+x, buf1+x, src+2*x, sstride, width-x);
+}
+#endif // HAVE_NEON
+
+/*
+ * Filters the lines [y_start, y_end[ of a plane, with a work buffer of its
+ * own, so that slices of the plane can be filtered concurrently.
+ * y_start is even, and either 0 or in [r, height - r[.
+ *
+ * The blur is a running sum over the last r pairs of lines, kept as
+ * (16-bit wrapping) prefix sums in a ring of r lines. A slice not starting
+ * at the top first sums the r pairs of lines its blur window starts with,
+ * from zero: only the differences of the prefix sums matter.
+ */
+static void filter_plane(struct vf_priv_s *ctx, uint16_t *work,
+                         uint8_t *dst, uint8_t *src,
+                         int width, int height, int dstride, int sstride, int r,
+                         int y_start, int y_end)
 {
     int bstride = ((width+15)&~15)/2;
-    int y;
+    int y = __MAX(y_start, r);
     uint32_t dc_factor = (1<<21)/(r*r);
-    uint16_t *dc = ctx->buf+16;
-    uint16_t *buf = ctx->buf+bstride+32;
+    uint16_t *dc = work+16;
+    uint16_t *buf = work+bstride+32;
     int thresh = ctx->thresh;
+    int first = (y+r)/2 - r;
 
     memset(dc, 0, (bstride+16)*sizeof(*buf));
-    for (y=0; y<r; y++)
-        ctx->blur_line(dc, buf+y*bstride, buf+(y-1)*bstride, src+2*y*sstride, sstride, width/2);
+    for (int l = first; l < first+r; l++)
+        ctx->blur_line(dc, buf+(l%r)*bstride,
+                       l == first ? buf-bstride : buf+((l-1)%r)*bstride,
+                       src+2*l*sstride, sstride, width/2);
     for (;;) {
         if (y < height-r) {
             int mod = ((y+r)/2)%r;
@@ -203,14 +343,13 @@ static void filter_plane(struct vf_priv_s *ctx, uint8_t *dst, uint8_t *src,
             for (x=-r/2; x<0; x++)
                 dc[x] = dc[0];
         }
-        if (y == r) {
+        if (y == r && y_start == 0) {
             for (y=0; y<r; y++)
                 ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
         }
         ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
-        if (++y >= height) break;
+        if (++y >= y_end) break;
         ctx->filter_line(dst+y*dstride, src+y*sstride, dc-r/2, width, thresh, dither[y&7]);
-        if (++y >= height) break;
+        if (++y >= y_end) break;
     }
 }
-
@@ -30,10 +30,15 @@
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
 #include "filter_picture.h"
+#include <vlc_slices.h>
 
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+# include <immintrin.h>
+#endif
 
 #include "hqdn3d.h"
 
@@ -57,6 +62,10 @@ static int DenoiseCallback( vlc_object_t *p_this, char const *psz_var,
 #define CHROMA_SPAT_TEXT        N_("Spatial chroma strength (0-254)")
 #define LUMA_TEMP_TEXT          N_("Temporal luma strength (0-254)")
 #define CHROMA_TEMP_TEXT        N_("Temporal chroma strength (0-254)")
+#define THREADS_TEXT            N_("Threads")
+#define THREADS_LONGTEXT        N_("Number of threads, each filtering a " \
+                                   "slice of the picture. Default: 0 " \
+                                   "(automatic, for pictures from 720p).")
 
 vlc_module_begin()
     set_shortname(N_("HQ Denoiser 3D"))
@@ -71,6 +80,8 @@ vlc_module_begin()
             LUMA_TEMP_TEXT, NULL)
     add_float_with_range(FILTER_PREFIX "chroma-temp", 4.5, 0.0, 254.0,
             CHROMA_TEMP_TEXT, NULL)
+    add_integer_with_range(FILTER_PREFIX "threads", 0, 0, VLC_SLICES_MAX,
+            THREADS_TEXT, THREADS_LONGTEXT)
 
     add_shortcut("hqdn3d")
 
@@ -78,9 +89,13 @@ vlc_module_begin()
 vlc_module_end()
 
 static const char *const filter_options[] = {
-    "luma-spat", "chroma-spat", "luma-temp", "chroma-temp", NULL
+    "luma-spat", "chroma-spat", "luma-temp", "chroma-temp", "threads", NULL
 };
 
+/* Lines filtered by each pass when running on a single thread, so that the
+ * horizontally filtered lines are still in the cache for the second pass */
+#define DENOISE_BAND 16
+
 /*****************************************************************************
  * filter_sys_t
  *****************************************************************************/
@@ -90,6 +105,8 @@ typedef struct
     int w[3], h[3];
 
     struct vf_priv_s cfg;
+    vlc_slices_t *slices;
+    denoise_columns_t pf_columns;
     bool   b_recalc_coefs;
     vlc_mutex_t coefs_mutex;
     float  luma_spat, luma_temp, chroma_spat, chroma_temp;
@@ -106,7 +123,7 @@ static int Open(filter_t *filter)
     const video_format_t *fmt_out = &filter->fmt_out.video;
     const vlc_fourcc_t fourcc_in  = fmt_in->i_chroma;
     const vlc_fourcc_t fourcc_out = fmt_out->i_chroma;
-    int wmax = 0;
+    int wmax = 0, hmax = 0;
 
     const vlc_chroma_description_t *chroma =
             vlc_fourcc_GetChromaDescription(fourcc_in);
@@ -133,16 +150,40 @@ static int Open(filter_t *filter)
         sys->w[i] = fmt_in->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
         if (sys->w[i] > wmax) wmax = sys->w[i];
         sys->h[i] = fmt_out->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
+        if (sys->h[i] > hmax) hmax = sys->h[i];
     }
-    cfg->Line = malloc(wmax*sizeof(unsigned int));
-    if (!cfg->Line) {
+
+    config_ChainParse(filter, FILTER_PREFIX, filter_options,
+                      filter->p_cfg);
+
+    sys->slices = vlc_slices_New(filter,
+                        var_GetInteger(filter, FILTER_PREFIX "threads"),
+                        filter->fmt_in.video.i_visible_width,
+                        filter->fmt_in.video.i_visible_height);
+    if (!sys->slices) {
         free(sys);
         return VLC_ENOMEM;
     }
 
-    config_ChainParse(filter, FILTER_PREFIX, filter_options,
-                      filter->p_cfg);
+    /* The slices filter the whole plane horizontally before filtering it
+     * vertically, whereas a single thread alternates on bands of lines */
+    if (vlc_slices_Count(sys->slices) > 1)
+        cfg->Spatial = vlc_alloc((size_t)wmax * hmax, sizeof(unsigned int));
+    else
+        cfg->Spatial = vlc_alloc((size_t)wmax * (DENOISE_BAND + 1),
+                                 sizeof(unsigned int));
+    if (!cfg->Spatial) {
+        vlc_slices_Delete(sys->slices);
+        free(sys);
+        return VLC_ENOMEM;
+    }
 
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+    if (vlc_CPU_AVX2())
+        sys->pf_columns = deNoiseColumnsAVX2;
+    else
+#endif
+        sys->pf_columns = deNoiseColumns;
 
     vlc_mutex_init( &sys->coefs_mutex );
     sys->b_recalc_coefs = true;
@@ -183,13 +224,96 @@ static void Close(filter_t *filter)
     for (int i = 0; i < 3; ++i) {
         free(cfg->Frame[i]);
     }
-    free(cfg->Line);
+    free(cfg->Spatial);
+    vlc_slices_Delete(sys->slices);
     free(sys);
 }
 
 /*****************************************************************************
  * Filter
  *****************************************************************************/
+struct denoise_job
+{
+    const plane_t *src;
+    plane_t *dst;
+    unsigned int *Spatial;
+    unsigned short *FrameAnt;
+    int W, H;
+    const int *SpatialCoefs;
+    const int *TemporalCoefs;
+    bool spatial, temporal;
+    denoise_columns_t pf_columns;
+};
+
+static void DenoiseColumns(const struct denoise_job *job, int Y,
+                           unsigned int *Line, int X, int W)
+{
+    job->pf_columns((job->spatial && Y > 0) ? Line - job->W : NULL, Line,
+                    job->temporal ? &job->FrameAnt[Y * job->W + X] : NULL,
+                    &job->dst->p_pixels[Y * job->dst->i_pitch + X], W,
+                    job->SpatialCoefs, job->TemporalCoefs);
+}
+
+/* First pass of a slice: lines */
+static void DenoiseLinesSlice(void *opaque, unsigned slice, unsigned slices)
+{
+    const struct denoise_job *job = opaque;
+    unsigned y0, y1;
+
+    vlc_slices_GetRange(job->H, slice, slices, 1, &y0, &y1);
+    deNoiseLines(&job->src->p_pixels[y0 * job->src->i_pitch],
+                 &job->Spatial[y0 * job->W], job->W, y1 - y0,
+                 job->src->i_pitch, job->SpatialCoefs);
+}
+
+/* Second pass of a slice: columns, aligned for the vector routines */
+static void DenoiseColumnsSlice(void *opaque, unsigned slice, unsigned slices)
+{
+    const struct denoise_job *job = opaque;
+    unsigned x0, x1;
+
+    vlc_slices_GetRange(job->W, slice, slices, 8, &x0, &x1);
+    for (int Y = 0; Y < job->H; Y++)
+        DenoiseColumns(job, Y, &job->Spatial[Y * job->W + x0], x0, x1 - x0);
+}
+
+static bool deNoisePlane(filter_sys_t *sys, const plane_t *src, plane_t *dst,
+                         unsigned short **FrameAntPtr, int W, int H,
+                         const int *spatial, const int *temporal)
+{
+    struct denoise_job job = {
+        .src = src, .dst = dst, .Spatial = sys->cfg.Spatial,
+        .W = W, .H = H, .SpatialCoefs = spatial, .TemporalCoefs = temporal,
+        .spatial = spatial[0] != 0,
+        /* Without spatial filtering, the previous frame is always updated */
+        .temporal = temporal[0] != 0 || spatial[0] == 0,
+        .pf_columns = sys->pf_columns,
+    };
+
+    job.FrameAnt = deNoiseFrameAnt(FrameAntPtr, src->p_pixels, W, H,
+                                   src->i_pitch);
+    if (!job.FrameAnt)
+        return false;
+
+    if (vlc_slices_Count(sys->slices) > 1) {
+        vlc_slices_Run(sys->slices, DenoiseLinesSlice, &job);
+        vlc_slices_Run(sys->slices, DenoiseColumnsSlice, &job);
+        return true;
+    }
+
+    /* The first line of Spatial keeps the last line of the previous band */
+    for (int Y = 0; Y < H; Y += DENOISE_BAND) {
+        int n = __MIN(DENOISE_BAND, H - Y);
+
+        deNoiseLines(&src->p_pixels[Y * src->i_pitch], &job.Spatial[W],
+                     W, n, src->i_pitch, spatial);
+        for (int i = 0; i < n; i++)
+            DenoiseColumns(&job, Y + i, &job.Spatial[(i + 1) * W], 0, W);
+        memcpy(job.Spatial, &job.Spatial[n * W], W * sizeof(*job.Spatial));
+    }
+    return true;
+}
+
 static picture_t *Filter(filter_t *filter, picture_t *src)
 {
     picture_t *dst;
@@ -219,30 +343,17 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
     }
     vlc_mutex_unlock( &sys->coefs_mutex );
 
-    deNoise(src->p[0].p_pixels, dst->p[0].p_pixels,
-            cfg->Line, &cfg->Frame[0], sys->w[0], sys->h[0],
-            src->p[0].i_pitch, dst->p[0].i_pitch,
-            cfg->Coefs[0],
-            cfg->Coefs[0],
-            cfg->Coefs[1]);
-    deNoise(src->p[1].p_pixels, dst->p[1].p_pixels,
-            cfg->Line, &cfg->Frame[1], sys->w[1], sys->h[1],
-            src->p[1].i_pitch, dst->p[1].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
-    deNoise(src->p[2].p_pixels, dst->p[2].p_pixels,
-            cfg->Line, &cfg->Frame[2], sys->w[2], sys->h[2],
-            src->p[2].i_pitch, dst->p[2].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
-
-    if(unlikely(!cfg->Frame[0] || !cfg->Frame[1] || !cfg->Frame[2]))
-    {
-        picture_Release( src );
-        picture_Release( dst );
-        return NULL;
+    for (int i = 0; i < 3; ++i) {
+        /* Luma and chroma strengths */
+        const int *spatial  = cfg->Coefs[i ? 2 : 0];
+        const int *temporal = cfg->Coefs[i ? 3 : 1];
+
+        if (!deNoisePlane(sys, &src->p[i], &dst->p[i], &cfg->Frame[i],
+                          sys->w[i], sys->h[i], spatial, temporal)) {
+            picture_Release( src );
+            picture_Release( dst );
+            return NULL;
+        }
     }
 
     return CopyInfoAndRelease(dst, src);
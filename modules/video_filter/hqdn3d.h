@@ -32,146 +32,185 @@
 
 struct vf_priv_s {
         int Coefs[4][512*16];
-        unsigned int *Line;
+        unsigned int *Spatial;
         unsigned short *Frame[3];
 };
 
 
 /***************************************************************************/
 
-static /*inline*/ unsigned int LowPassMul(unsigned int PrevMul, unsigned int CurrMul, int* Coef){
+static inline unsigned int LowPassMul(unsigned int PrevMul, unsigned int CurrMul, const int* Coef){
 //    int dMul= (PrevMul&0xFFFFFF)-(CurrMul&0xFFFFFF);
     int dMul= PrevMul-CurrMul;
     unsigned int d=((dMul+0x10007FF)>>12);
     return CurrMul + Coef[d];
 }
 
-static void deNoiseTemporal(
-                    unsigned char *Frame,        // mpi->planes[x]
-                    unsigned char *FrameDest,    // dmpi->planes[x]
-                    unsigned short *FrameAnt,
-                    int W, int H, int sStride, int dStride,
-                    int *Temporal)
+/*
+ * The denoiser runs in two passes, so that they can be split in slices and
+ * vectorized: the horizontal low-pass of the lines, which only depends on
+ * the left neighbors, then the vertical and temporal low-passes, which only
+ * depend on the pixels above and on the previous frame.
+ */
+
+/* Horizontal low-pass of H lines into Spatial (W pixels per line). The
+ * recursion is serial along a line, so four lines are filtered together. */
+static void deNoiseLines(const unsigned char *Frame,  // mpi->planes[x]
+                         unsigned int *Spatial,
+                         int W, int H, int sStride,
+                         const int *Horizontal)
 {
-    unsigned int PixelDst;
+    long Y = 0;
+
+    if(!Horizontal[0]){
+        for (; Y < H; Y++){
+            for (long X = 0; X < W; X++)
+                Spatial[X] = Frame[X]<<16;
+            Frame += sStride;
+            Spatial += W;
+        }
+        return;
+    }
 
-    for (long Y = 0; Y < H; Y++){
-        for (long X = 0; X < W; X++){
-            PixelDst = LowPassMul(FrameAnt[X]<<8, Frame[X]<<16, Temporal);
-            FrameAnt[X] = ((PixelDst+0x1000007F)>>8);
-            FrameDest[X]= ((PixelDst+0x10007FFF)>>16);
+    for (; Y + 4 <= H; Y += 4){
+        const unsigned char *F0 = Frame, *F1 = F0 + sStride,
+                            *F2 = F1 + sStride, *F3 = F2 + sStride;
+        unsigned int *S0 = Spatial, *S1 = S0 + W, *S2 = S1 + W, *S3 = S2 + W;
+        /* First pixel on each line doesn't have previous pixel */
+        unsigned int P0 = S0[0] = F0[0]<<16, P1 = S1[0] = F1[0]<<16,
+                     P2 = S2[0] = F2[0]<<16, P3 = S3[0] = F3[0]<<16;
+
+        for (long X = 1; X < W; X++){
+            S0[X] = P0 = LowPassMul(P0, F0[X]<<16, Horizontal);
+            S1[X] = P1 = LowPassMul(P1, F1[X]<<16, Horizontal);
+            S2[X] = P2 = LowPassMul(P2, F2[X]<<16, Horizontal);
+            S3[X] = P3 = LowPassMul(P3, F3[X]<<16, Horizontal);
         }
+        Frame += 4 * sStride;
+        Spatial += 4 * W;
+    }
+
+    for (; Y < H; Y++){
+        unsigned int PixelAnt = Spatial[0] = Frame[0]<<16;
+        for (long X = 1; X < W; X++)
+            Spatial[X] = PixelAnt = LowPassMul(PixelAnt, Frame[X]<<16, Horizontal);
         Frame += sStride;
-        FrameDest += dStride;
-        FrameAnt += W;
+        Spatial += W;
     }
 }
 
-static void deNoiseSpacial(
-                    unsigned char *Frame,        // mpi->planes[x]
-                    unsigned char *FrameDest,    // dmpi->planes[x]
-                    unsigned int *LineAnt,       // vf->priv->Line (width bytes)
-                    int W, int H, int sStride, int dStride,
-                    int *Horizontal, int *Vertical)
+/* Vertical and temporal low-passes of W pixels of a line.
+ * LineAnt is the line above (NULL on the first line or without spatial
+ * filtering), FrameAnt the line of the previous frame (NULL without
+ * temporal filtering). */
+typedef void (*denoise_columns_t)(const unsigned int *LineAnt,
+                                  unsigned int *Line,
+                                  unsigned short *FrameAnt,
+                                  unsigned char *FrameDest,
+                                  int W, const int *Vertical,
+                                  const int *Temporal);
+
+static void deNoiseColumns(const unsigned int *LineAnt,
+                           unsigned int *Line,
+                           unsigned short *FrameAnt,
+                           unsigned char *FrameDest,   // dmpi->planes[x]
+                           int W, const int *Vertical, const int *Temporal)
 {
-    long sLineOffs = 0, dLineOffs = 0;
-    unsigned int PixelAnt;
-    unsigned int PixelDst;
-
-    /* First pixel has no left nor top neighbor. */
-    PixelDst = LineAnt[0] = PixelAnt = Frame[0]<<16;
-    FrameDest[0]= ((PixelDst+0x10007FFF)>>16);
-
-    /* First line has no top neighbor, only left. */
-    for (long X = 1; X < W; X++){
-        PixelDst = LineAnt[X] = LowPassMul(PixelAnt, Frame[X]<<16, Horizontal);
+    for (long X = 0; X < W; X++){
+        unsigned int PixelDst = Line[X];
+        if (LineAnt)
+            PixelDst = Line[X] = LowPassMul(LineAnt[X], PixelDst, Vertical);
+        if (FrameAnt){
+            PixelDst = LowPassMul(FrameAnt[X]<<8, PixelDst, Temporal);
+            FrameAnt[X] = ((PixelDst+0x1000007F)>>8);
+        }
         FrameDest[X]= ((PixelDst+0x10007FFF)>>16);
     }
+}
 
-    for (long Y = 1; Y < H; Y++){
-        sLineOffs += sStride, dLineOffs += dStride;
-        /* First pixel on each line doesn't have previous pixel */
-        PixelAnt = Frame[sLineOffs]<<16;
-        PixelDst = LineAnt[0] = LowPassMul(LineAnt[0], PixelAnt, Vertical);
-        FrameDest[dLineOffs]= ((PixelDst+0x10007FFF)>>16);
-
-        for (long X = 1; X < W; X++){
-            /* The rest are normal */
-            PixelAnt = LowPassMul(PixelAnt, Frame[sLineOffs+X]<<16, Horizontal);
-            PixelDst = LineAnt[X] = LowPassMul(LineAnt[X], PixelAnt, Vertical);
-            FrameDest[dLineOffs+X]= ((PixelDst+0x10007FFF)>>16);
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+/* Same as deNoiseColumns(), with the coefficients fetched by gathers */
+VLC_AVX2
+static void deNoiseColumnsAVX2(const unsigned int *LineAnt,
+                               unsigned int *Line,
+                               unsigned short *FrameAnt,
+                               unsigned char *FrameDest,
+                               int W, const int *Vertical,
+                               const int *Temporal)
+{
+    const __m256i round_d   = _mm256_set1_epi32(0x10007FF);
+    const __m256i round_ant = _mm256_set1_epi32(0x1000007F);
+    const __m256i round_dst = _mm256_set1_epi32(0x10007FFF);
+    /* Bytes 1-2 (>>8 & 0xFFFF) and byte 2 (>>16 & 0xFF) of each pixel */
+    const __m256i pick_ant = _mm256_setr_epi8(
+        1, 2, 5, 6, 9, 10, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1,
+        1, 2, 5, 6, 9, 10, 13, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i pick_dst = _mm256_setr_epi8(
+        2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i merge_ant = _mm256_setr_epi32(0, 1, 4, 5, 0, 0, 0, 0);
+    const __m256i merge_dst = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    long X = 0;
+
+    for (; X + 8 <= W; X += 8){
+        __m256i PixelDst = _mm256_loadu_si256((const __m256i *)&Line[X]);
+        __m256i d;
+
+        if (LineAnt){
+            d = _mm256_loadu_si256((const __m256i *)&LineAnt[X]);
+            d = _mm256_srai_epi32(_mm256_add_epi32(
+                    _mm256_sub_epi32(d, PixelDst), round_d), 12);
+            PixelDst = _mm256_add_epi32(PixelDst,
+                    _mm256_i32gather_epi32(Vertical, d, 4));
+            _mm256_storeu_si256((__m256i *)&Line[X], PixelDst);
+        }
+        if (FrameAnt){
+            d = _mm256_cvtepu16_epi32(
+                    _mm_loadu_si128((const __m128i *)&FrameAnt[X]));
+            d = _mm256_srai_epi32(_mm256_add_epi32(_mm256_sub_epi32(
+                    _mm256_slli_epi32(d, 8), PixelDst), round_d), 12);
+            PixelDst = _mm256_add_epi32(PixelDst,
+                    _mm256_i32gather_epi32(Temporal, d, 4));
+
+            __m256i ant = _mm256_add_epi32(PixelDst, round_ant);
+            ant = _mm256_permutevar8x32_epi32(
+                    _mm256_shuffle_epi8(ant, pick_ant), merge_ant);
+            _mm_storeu_si128((__m128i *)&FrameAnt[X],
+                             _mm256_castsi256_si128(ant));
         }
+
+        __m256i dst = _mm256_add_epi32(PixelDst, round_dst);
+        dst = _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(dst, pick_dst), merge_dst);
+        _mm_storel_epi64((__m128i *)&FrameDest[X],
+                         _mm256_castsi256_si128(dst));
     }
+
+    deNoiseColumns(LineAnt ? LineAnt + X : NULL, Line + X,
+                   FrameAnt ? FrameAnt + X : NULL, FrameDest + X,
+                   W - X, Vertical, Temporal);
 }
+#endif
 
-static void deNoise(unsigned char *Frame,        // mpi->planes[x]
-                    unsigned char *FrameDest,    // dmpi->planes[x]
-                    unsigned int *LineAnt,      // vf->priv->Line (width bytes)
-                    unsigned short **FrameAntPtr,
-                    int W, int H, int sStride, int dStride,
-                    int *Horizontal, int *Vertical, int *Temporal)
+/* Previous frame of a plane, initialized from the current one the first
+ * time */
+static unsigned short *deNoiseFrameAnt(unsigned short **FrameAntPtr,
+                                       const unsigned char *Frame,
+                                       int W, int H, int sStride)
 {
-    long sLineOffs = 0, dLineOffs = 0;
-    unsigned int PixelAnt;
-    unsigned int PixelDst;
     unsigned short* FrameAnt=(*FrameAntPtr);
 
     if(!FrameAnt){
         (*FrameAntPtr)=FrameAnt=malloc(W*H*sizeof(unsigned short));
         if(!FrameAnt)
-            return;
+            return NULL;
         for (long Y = 0; Y < H; Y++){
             unsigned short* dst=&FrameAnt[Y*W];
-            unsigned char* src=Frame+Y*sStride;
+            const unsigned char* src=Frame+Y*sStride;
             for (long X = 0; X < W; X++) dst[X]=src[X]<<8;
         }
     }
-
-    if(!Horizontal[0] && !Vertical[0]){
-        deNoiseTemporal(Frame, FrameDest, FrameAnt,
-                        W, H, sStride, dStride, Temporal);
-        return;
-    }
-    if(!Temporal[0]){
-        deNoiseSpacial(Frame, FrameDest, LineAnt,
-                       W, H, sStride, dStride, Horizontal, Vertical);
-        return;
-    }
-
-    /* First pixel has no left nor top neighbor. Only previous frame */
-    LineAnt[0] = PixelAnt = Frame[0]<<16;
-    PixelDst = LowPassMul(FrameAnt[0]<<8, PixelAnt, Temporal);
-    FrameAnt[0] = ((PixelDst+0x1000007F)>>8);
-    FrameDest[0]= ((PixelDst+0x10007FFF)>>16);
-
-    /* First line has no top neighbor. Only left one for each pixel and
-     * last frame */
-    for (long X = 1; X < W; X++){
-        LineAnt[X] = PixelAnt = LowPassMul(PixelAnt, Frame[X]<<16, Horizontal);
-        PixelDst = LowPassMul(FrameAnt[X]<<8, PixelAnt, Temporal);
-        FrameAnt[X] = ((PixelDst+0x1000007F)>>8);
-        FrameDest[X]= ((PixelDst+0x10007FFF)>>16);
-    }
-
-    for (long Y = 1; Y < H; Y++){
-        unsigned short* LinePrev=&FrameAnt[Y*W];
-        sLineOffs += sStride, dLineOffs += dStride;
-        /* First pixel on each line doesn't have previous pixel */
-        PixelAnt = Frame[sLineOffs]<<16;
-        LineAnt[0] = LowPassMul(LineAnt[0], PixelAnt, Vertical);
-        PixelDst = LowPassMul(LinePrev[0]<<8, LineAnt[0], Temporal);
-        LinePrev[0] = ((PixelDst+0x1000007F)>>8);
-        FrameDest[dLineOffs]= ((PixelDst+0x10007FFF)>>16);
-
-        for (long X = 1; X < W; X++){
-            /* The rest are normal */
-            PixelAnt = LowPassMul(PixelAnt, Frame[sLineOffs+X]<<16, Horizontal);
-            LineAnt[X] = LowPassMul(LineAnt[X], PixelAnt, Vertical);
-            PixelDst = LowPassMul(LinePrev[X]<<8, LineAnt[X], Temporal);
-            LinePrev[X] = ((PixelDst+0x1000007F)>>8);
-            FrameDest[dLineOffs+X]= ((PixelDst+0x10007FFF)>>16);
-        }
-    }
+    return FrameAnt;
 }
 
 
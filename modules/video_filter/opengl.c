@@ -37,7 +37,7 @@
 #include "../video_output/opengl/interop.h"
 
 #define OPENGL_CFG_PREFIX "opengl-"
-static const char *const opengl_options[] = { "filter", NULL };
+static const char *const opengl_options[] = { "filter", "fusion", NULL };
 
 typedef struct
 {
@@ -236,6 +236,9 @@ static int Open( vlc_object_t *obj )
         goto filters_new_failure;
     }
 
+    bool fusion = var_InheritBool(filter, OPENGL_CFG_PREFIX "fusion");
+    vlc_gl_filters_EnableFusion(sys->filters, fusion);
+
     int ret;
 
     ret = LoadFilters(sys, glfilters_config);
@@ -305,6 +308,9 @@ gl_create_failure:
 
 #define FILTER_LIST_TEXT N_( "OpenGL filter" )
 #define FILTER_LIST_LONGTEXT N_( "List of OpenGL filters to execute" )
+#define FUSION_TEXT N_( "Fuse pointwise filters" )
+#define FUSION_LONGTEXT N_( "Execute consecutive pointwise OpenGL filters " \
+                            "in a single rendering pass" )
 
 vlc_module_begin()
     set_shortname( N_("opengl") )
@@ -315,4 +321,5 @@ vlc_module_begin()
     set_callback( Open )
     add_module_list( "opengl-filter", "opengl filter", NULL,
                      FILTER_LIST_TEXT, FILTER_LIST_LONGTEXT )
+    add_bool( "opengl-fusion", false, FUSION_TEXT, FUSION_LONGTEXT )
 vlc_module_end()
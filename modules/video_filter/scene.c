@@ -50,7 +50,8 @@ static void Destroy     ( filter_t * );
 static picture_t *Filter( filter_t *, picture_t * );
 
 static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic );
-static void SavePicture( filter_t *, picture_t * );
+static void SnapshotCut( filter_t *p_filter, picture_t *p_pic );
+static void SavePicture( filter_t *, picture_t *, int64_t );
 
 /*****************************************************************************
  * Module descriptor
@@ -72,6 +73,14 @@ static void SavePicture( filter_t *, picture_t * );
 #define RATIO_LONGTEXT N_( "Ratio of images to record. "\
                            "3 means that one image out of three is recorded." )
 
+#define CUT_TEXT N_( "Scene cut threshold" )
+#define CUT_LONGTEXT N_( "Record only the first image of each shot, " \
+                         "detected when the luma histogram differs from " \
+                         "the previous image by more than this fraction. " \
+                         "The filenames then have the timestamp of the " \
+                         "image in milliseconds as number. " \
+                         "0 records at the recording ratio instead." )
+
 #define PREFIX_TEXT N_( "Filename prefix" )
 #define PREFIX_LONGTEXT N_( "Prefix of the output images filenames. Output " \
                             "filenames will have the \"prefixNUMBER.format\" "\
@@ -113,14 +122,20 @@ vlc_module_begin ()
     /* Snapshot method */
     add_integer_with_range( CFG_PREFIX "ratio", 50, 1, INT_MAX,
                             RATIO_TEXT, RATIO_LONGTEXT )
+    add_float_with_range( CFG_PREFIX "cut-threshold", 0., 0., 1.,
+                          CUT_TEXT, CUT_LONGTEXT )
 
     set_callback_video_filter( Create )
 vlc_module_end ()
 
 static const char *const ppsz_vfilter_options[] = {
-    "format", "width", "height", "ratio", "prefix", "path", "replace", NULL
+    "format", "width", "height", "ratio", "cut-threshold", "prefix", "path",
+    "replace", NULL
 };
 
+#define CUT_BINS 64
+#define CUT_STEP 4 /* Sample one luma pixel out of 4 in each direction */
+
 typedef struct scene_t {
     picture_t       *p_pic;
     video_format_t  format;
@@ -143,6 +158,10 @@ typedef struct
     int32_t i_ratio;  /* save every n-th frame */
     int32_t i_frames; /* frames count */
     bool  b_replace;
+
+    float f_cut;      /* scene cut threshold, 0 if disabled */
+    bool  b_histogram;
+    uint32_t pi_histogram[CUT_BINS]; /* of the previous image */
 } filter_sys_t;
 
 /*****************************************************************************
@@ -189,6 +208,15 @@ static int Create( filter_t *p_filter )
     if( p_sys->i_ratio <= 0)
         p_sys->i_ratio = 1;
     p_sys->b_replace = var_CreateGetBool( p_filter, CFG_PREFIX "replace" );
+    p_sys->f_cut = var_CreateGetFloat( p_filter, CFG_PREFIX "cut-threshold" );
+    if( p_sys->f_cut > 0.f
+     && ( !vlc_fourcc_IsYUV( p_filter->fmt_in.video.i_chroma )
+       || p_chroma->plane_count < 2 || p_chroma->pixel_size != 1 ) )
+    {
+        msg_Warn( p_filter, "scene cuts need 8-bits planar YUV, "
+                  "using the ratio" );
+        p_sys->f_cut = 0.f;
+    }
     p_sys->psz_prefix = var_CreateGetString( p_filter, CFG_PREFIX "prefix" );
     p_sys->psz_path = var_GetNonEmptyString( p_filter, CFG_PREFIX "path" );
     if( p_sys->psz_path == NULL )
@@ -235,11 +263,83 @@ static void Destroy( filter_t *p_filter )
  *****************************************************************************/
 static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
 {
-    /* TODO: think of some funky algorithm to detect scene changes. */
-    SnapshotRatio( p_filter, p_pic );
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( p_sys->f_cut > 0.f )
+        SnapshotCut( p_filter, p_pic );
+    else
+        SnapshotRatio( p_filter, p_pic );
     return p_pic;
 }
 
+static void SetSize( filter_sys_t *p_sys, const picture_t *p_pic )
+{
+    if( (p_sys->i_width <= 0) && (p_sys->i_height > 0) )
+    {
+        p_sys->i_width = (p_pic->format.i_width * p_sys->i_height) / p_pic->format.i_height;
+    }
+    else if( (p_sys->i_height <= 0) && (p_sys->i_width > 0) )
+    {
+        p_sys->i_height = (p_pic->format.i_height * p_sys->i_width) / p_pic->format.i_width;
+    }
+    else if( (p_sys->i_width <= 0) && (p_sys->i_height <= 0) )
+    {
+        p_sys->i_width = p_pic->format.i_width;
+        p_sys->i_height = p_pic->format.i_height;
+    }
+}
+
+/* Luma histogram of a subsampled picture */
+static void GetHistogram( const picture_t *p_pic, uint32_t *pi_histogram )
+{
+    const plane_t *p_luma = &p_pic->p[Y_PLANE];
+
+    memset( pi_histogram, 0, CUT_BINS * sizeof( *pi_histogram ) );
+
+    for( int y = 0; y < p_luma->i_visible_lines; y += CUT_STEP )
+    {
+        const uint8_t *p_line = &p_luma->p_pixels[y * p_luma->i_pitch];
+
+        for( int x = 0; x < p_luma->i_visible_pitch; x += CUT_STEP )
+            pi_histogram[p_line[x] / (256 / CUT_BINS)]++;
+    }
+}
+
+static void SnapshotCut( filter_t *p_filter, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    uint32_t pi_histogram[CUT_BINS];
+    uint64_t i_diff = 0, i_total = 0;
+
+    if( !p_pic ) return;
+
+    p_sys->i_frames++;
+    GetHistogram( p_pic, pi_histogram );
+
+    for( unsigned i = 0; i < CUT_BINS; i++ )
+    {
+        int64_t i_delta = (int64_t)pi_histogram[i] - p_sys->pi_histogram[i];
+
+        i_diff += i_delta < 0 ? -i_delta : i_delta;
+        i_total += pi_histogram[i];
+    }
+    memcpy( p_sys->pi_histogram, pi_histogram, sizeof( pi_histogram ) );
+
+    /* Half the L1 distance is the fraction of pixels that changed bins */
+    if( p_sys->b_histogram
+     && ( i_total == 0 || i_diff <= 2 * p_sys->f_cut * i_total ) )
+        return;
+    p_sys->b_histogram = true;
+
+    int64_t i_ms = p_pic->date != VLC_TICK_INVALID
+                 ? MS_FROM_VLC_TICK( p_pic->date - VLC_TICK_0 ) : 0;
+
+    msg_Dbg( p_filter, "scene cut at frame %"PRId32" (%"PRId64" ms)",
+             p_sys->i_frames, i_ms );
+    SetSize( p_sys, p_pic );
+    SavePicture( p_filter, p_pic, i_ms );
+}
+
 static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -256,32 +356,21 @@ static void SnapshotRatio( filter_t *p_filter, picture_t *p_pic )
     if( p_sys->scene.p_pic )
         picture_Release( p_sys->scene.p_pic );
 
-    if( (p_sys->i_width <= 0) && (p_sys->i_height > 0) )
-    {
-        p_sys->i_width = (p_pic->format.i_width * p_sys->i_height) / p_pic->format.i_height;
-    }
-    else if( (p_sys->i_height <= 0) && (p_sys->i_width > 0) )
-    {
-        p_sys->i_height = (p_pic->format.i_height * p_sys->i_width) / p_pic->format.i_width;
-    }
-    else if( (p_sys->i_width <= 0) && (p_sys->i_height <= 0) )
-    {
-        p_sys->i_width = p_pic->format.i_width;
-        p_sys->i_height = p_pic->format.i_height;
-    }
+    SetSize( p_sys, p_pic );
 
     p_sys->scene.p_pic = picture_NewFromFormat( &p_pic->format );
     if( p_sys->scene.p_pic )
     {
         picture_Copy( p_sys->scene.p_pic, p_pic );
-        SavePicture( p_filter, p_sys->scene.p_pic );
+        SavePicture( p_filter, p_sys->scene.p_pic, p_sys->i_frames );
     }
 }
 
 /*****************************************************************************
  * Save Picture to disk
  *****************************************************************************/
-static void SavePicture( filter_t *p_filter, picture_t *p_pic )
+static void SavePicture( filter_t *p_filter, picture_t *p_pic,
+                         int64_t i_number )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     video_format_t fmt_in, fmt_out;
@@ -306,9 +395,9 @@ static void SavePicture( filter_t *p_filter, picture_t *p_pic )
                           p_sys->psz_path, p_sys->psz_prefix,
                           p_sys->psz_format );
     else
-        i_ret = asprintf( &psz_filename, "%s" DIR_SEP "%s%05d.%s",
+        i_ret = asprintf( &psz_filename, "%s" DIR_SEP "%s%05"PRId64".%s",
                           p_sys->psz_path, p_sys->psz_prefix,
-                          p_sys->i_frames, p_sys->psz_format );
+                          i_number, p_sys->psz_format );
 
     if( i_ret == -1 )
     {
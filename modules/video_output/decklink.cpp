@@ -677,15 +677,23 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
     h = vd->fmt->i_height;
 
     IDeckLinkMutableVideoFrame *pDLVideoFrame;
+    IDeckLinkVideoFrame *pFrame = NULL;
+
+    /* 8 bits pictures are scheduled without copy, if their lines fit */
+    if (!sys->video.tenbits)
+        pFrame = Decklink::PictureFrame::Create(picture, w, h);
+    if (pFrame)
+        goto schedule;
+
     result = sys->p_output->CreateVideoFrame(w, h, w*3,
         sys->video.tenbits ? bmdFormat10BitYUV : bmdFormat8BitYUV,
         bmdFrameFlagDefault, &pDLVideoFrame);
 
     if (result != S_OK) {
         msg_Err(vd, "Failed to create video frame:0x%" PRIHR, result);
-        pDLVideoFrame = NULL;
         goto end;
     }
+    pFrame = pDLVideoFrame;
 
     void *frame_bytes;
     pDLVideoFrame->GetBytes((void**)&frame_bytes);
@@ -729,12 +737,12 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
         memcpy(dst, src, w * 2 /* bpp */);
     }
 
-
+schedule:
     // compute frame duration in CLOCK_FREQ units
     length = (sys->frameduration * CLOCK_FREQ) / sys->timescale;
 
     date -= sys->offset;
-    result = sys->p_output->ScheduleVideoFrame(pDLVideoFrame,
+    result = sys->p_output->ScheduleVideoFrame(pFrame,
         date, length, CLOCK_FREQ);
 
     if (result != S_OK) {
@@ -755,8 +763,8 @@ static void PrepareVideo(vout_display_t *vd, picture_t *picture, subpicture_t *,
     }
 
 end:
-    if (pDLVideoFrame)
-        pDLVideoFrame->Release();
+    if (pFrame)
+        pFrame->Release();
 }
 
 static int ControlVideo(vout_display_t *vd, int query)
@@ -189,3 +189,59 @@ uint32_t vlc_drm_dumb_get_fb_id(const picture_t *pic)
     assert(picbuf->fb_id != 0);
     return picbuf->fb_id;
 }
+
+uint32_t vlc_drm_prime_add_fb(struct vlc_logger *log, int fd,
+                              uint_fast32_t drm_fourcc,
+                              unsigned width, unsigned height,
+                              unsigned planes, const int *fds,
+                              const uint32_t *offsets,
+                              const uint32_t *pitches,
+                              const uint64_t *modifiers)
+{
+    struct drm_mode_fb_cmd2 cmd = {
+        .width = width,
+        .height = height,
+        .pixel_format = drm_fourcc,
+    };
+    uint32_t fb_id = 0;
+    unsigned i;
+
+    assert(planes <= ARRAY_SIZE(cmd.handles));
+
+    for (i = 0; i < planes; i++) {
+        struct drm_prime_handle prime = {
+            .fd = fds[i],
+        };
+
+        if (vlc_drm_ioctl(fd, DRM_IOCTL_PRIME_FD_TO_HANDLE, &prime) < 0) {
+            vlc_error(log, "DRM PRIME import error: %s", vlc_strerror(errno));
+            goto out;
+        }
+
+        cmd.handles[i] = prime.handle;
+        cmd.offsets[i] = offsets[i];
+        cmd.pitches[i] = pitches[i];
+        cmd.modifier[i] = modifiers[i];
+        if (modifiers[i] != DRM_FORMAT_MOD_INVALID)
+            cmd.flags = DRM_MODE_FB_MODIFIERS;
+    }
+
+    if (vlc_drm_ioctl(fd, DRM_IOCTL_MODE_ADDFB2, &cmd) < 0)
+        vlc_error(log, "DRM framebuffer addition error: %s",
+                  vlc_strerror(errno));
+    else
+        fb_id = cmd.fb_id;
+out:
+    /* The frame buffer holds its own references to the buffer objects.
+     * Planes of a same object share one handle, close it only once. */
+    while (i > 0) {
+        struct drm_gem_close cl = { .handle = cmd.handles[--i] };
+        bool dup = false;
+
+        for (unsigned j = 0; j < i; j++)
+            dup |= cmd.handles[j] == cl.handle;
+        if (!dup)
+            vlc_drm_ioctl(fd, DRM_IOCTL_GEM_CLOSE, &cl);
+    }
+    return fb_id;
+}
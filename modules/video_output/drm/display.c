@@ -34,8 +34,10 @@
 #endif
 
 #ifndef HAVE_LIBDRM
+# include <drm/drm_fourcc.h>
 # include <drm/drm_mode.h>
 #else
+# include <drm_fourcc.h>
 # include <drm_mode.h>
 #endif
 
@@ -44,7 +46,21 @@
 #include <vlc_vout_display.h>
 #include <vlc_picture.h>
 #include <vlc_window.h>
+#include <vlc_fs.h>
 #include "vlc_drm.h"
+#ifdef HAVE_VAAPI
+# include <va/va_drmcommon.h>
+# include "../../hw/vaapi/vlc_vaapi.h"
+# if VA_CHECK_VERSION(1, 1, 0)
+#  define HAVE_VAAPI_PRIME 1
+# endif
+#endif
+#ifdef HAVE_V4L2M2M
+# include "../../codec/v4l2m2m.h"
+#endif
+#if defined(HAVE_VAAPI_PRIME) || defined(HAVE_V4L2M2M)
+# define HAVE_PRIME 1
+#endif
 
 #include <assert.h>
 
@@ -63,12 +79,24 @@
 
 typedef struct vout_display_sys_t {
     picture_t       *buffers[MAXHWBUF];
+#ifdef HAVE_PRIME
+    /* Imported hardware decoded pictures, when scanned out directly */
+    struct {
+        picture_t   *pic;
+        uint32_t    fb_id;
+    } prime[MAXHWBUF];
+    void (*import)(vout_display_t *, picture_t *, unsigned int);
+#endif
+    bool            zero_copy;
 
     unsigned int    front_buf;
+    unsigned int    back_buf;
 /*
  * modeset information
  */
     uint32_t        plane_id;
+    unsigned int    crtc_index;
+    vlc_tick_t      refresh_period;
 } vout_display_sys_t;
 
 static int Control(vout_display_t *vd, int query)
@@ -86,13 +114,124 @@ static int Control(vout_display_t *vd, int query)
     return VLC_EGENERIC;
 }
 
+#ifdef HAVE_PRIME
+static void PrimeRelease(vout_display_t *vd, unsigned int i)
+{
+    vout_display_sys_t *sys = vd->sys;
+
+    if (sys->prime[i].pic == NULL)
+        return;
+
+    vlc_drm_ioctl(vd->cfg->window->display.drm_fd, DRM_IOCTL_MODE_RMFB,
+                  &sys->prime[i].fb_id);
+    picture_Release(sys->prime[i].pic);
+    sys->prime[i].pic = NULL;
+    sys->prime[i].fb_id = 0;
+}
+#endif
+
+#ifdef HAVE_VAAPI_PRIME
+/**
+ * Imports a VA-API surface as a DRM frame buffer, without copying.
+ *
+ * The picture is held until its frame buffer is replaced, so that the decoder
+ * does not reuse the surface while it is scanned out.
+ */
+static void PrimeImport(vout_display_t *vd, picture_t *pic, unsigned int i)
+{
+    vout_display_sys_t *sys = vd->sys;
+    int fd = vd->cfg->window->display.drm_fd;
+    VADisplay dpy = vlc_vaapi_PicGetDisplay(pic);
+    VASurfaceID surface = vlc_vaapi_PicGetSurface(pic);
+    VADRMPRIMESurfaceDescriptor desc;
+
+    PrimeRelease(vd, i);
+
+    if (vaSyncSurface(dpy, surface) != VA_STATUS_SUCCESS
+     || vlc_vaapi_ExportSurfaceHandle(VLC_OBJECT(vd), dpy, surface,
+                                      VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2,
+                                      VA_EXPORT_SURFACE_READ_ONLY
+                                      | VA_EXPORT_SURFACE_COMPOSED_LAYERS,
+                                      &desc))
+        return;
+
+    /* With composed layers, all planes are described by the first layer */
+    int fds[4];
+    uint64_t modifiers[4];
+    unsigned planes = desc.layers[0].num_planes;
+
+    for (unsigned j = 0; j < planes; j++) {
+        unsigned obj = desc.layers[0].object_index[j];
+
+        fds[j] = desc.objects[obj].fd;
+        modifiers[j] = desc.objects[obj].drm_format_modifier;
+    }
+
+    uint32_t fb_id = vlc_drm_prime_add_fb(vd->obj.logger, fd,
+                                          desc.layers[0].drm_format,
+                                          desc.width, desc.height, planes,
+                                          fds, desc.layers[0].offset,
+                                          desc.layers[0].pitch, modifiers);
+
+    for (unsigned j = 0; j < desc.num_objects; j++)
+        vlc_close(desc.objects[j].fd);
+
+    if (fb_id != 0) {
+        sys->prime[i].pic = picture_Hold(pic);
+        sys->prime[i].fb_id = fb_id;
+    }
+}
+#endif
+
+#ifdef HAVE_V4L2M2M
+/**
+ * Imports the DMA buffers of a V4L2 decoded picture as a DRM frame buffer.
+ *
+ * The picture is held until its frame buffer is replaced, so that the decoder
+ * does not reuse the capture buffer while it is scanned out.
+ */
+static void V4L2Import(vout_display_t *vd, picture_t *pic, unsigned int i)
+{
+    vout_display_sys_t *sys = vd->sys;
+    const struct v4l2m2m_pic_context *pctx = v4l2m2m_GetPicContext(pic);
+    vlc_fourcc_t chroma = v4l2m2m_GetChroma(pic->context->vctx);
+    uint64_t modifiers[PICTURE_PLANE_MAX];
+
+    PrimeRelease(vd, i);
+
+    for (unsigned j = 0; j < pctx->planes; j++)
+        modifiers[j] = DRM_FORMAT_MOD_INVALID;
+
+    uint32_t fb_id = vlc_drm_prime_add_fb(vd->obj.logger,
+                                          vd->cfg->window->display.drm_fd,
+                                          vlc_drm_fourcc(chroma),
+                                          pctx->width, pctx->height,
+                                          pctx->planes, pctx->fds,
+                                          pctx->offsets, pctx->pitches,
+                                          modifiers);
+    if (fb_id != 0) {
+        sys->prime[i].pic = picture_Hold(pic);
+        sys->prime[i].fb_id = fb_id;
+    }
+}
+#endif
+
 static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
                     vlc_tick_t date)
 {
     VLC_UNUSED(subpic); VLC_UNUSED(date);
     vout_display_sys_t *sys = vd->sys;
 
-    picture_Copy(sys->buffers[sys->front_buf], pic);
+#ifdef HAVE_PRIME
+    if (sys->zero_copy)
+        sys->import(vd, pic, sys->back_buf);
+    else
+#endif
+        picture_Copy(sys->buffers[sys->back_buf], pic);
+
+    sys->back_buf++;
+    if (sys->back_buf == MAXHWBUF)
+        sys->back_buf = 0;
 }
 
 static void Display(vout_display_t *vd, picture_t *picture)
@@ -101,15 +240,24 @@ static void Display(vout_display_t *vd, picture_t *picture)
     vout_display_sys_t *sys = vd->sys;
     vlc_window_t *wnd = vd->cfg->window;
     const video_format_t *fmt = vd->fmt;
-    picture_t *pic = sys->buffers[sys->front_buf];
     vout_display_place_t place;
+    uint32_t fb_id;
+
+#ifdef HAVE_PRIME
+    if (sys->zero_copy) {
+        fb_id = sys->prime[sys->front_buf].fb_id;
+        if (fb_id == 0) /* The import failed, keep the previous picture. */
+            goto out;
+    } else
+#endif
+        fb_id = vlc_drm_dumb_get_fb_id(sys->buffers[sys->front_buf]);
 
     vout_display_PlacePicture(&place, vd->fmt, &vd->cfg->display);
 
     struct drm_mode_set_plane sp = {
         .plane_id = sys->plane_id,
         .crtc_id = wnd->handle.crtc,
-        .fb_id = vlc_drm_dumb_get_fb_id(pic),
+        .fb_id = fb_id,
         .crtc_x = place.x,
         .crtc_y = place.y,
         .crtc_w = place.width,
@@ -123,9 +271,25 @@ static void Display(vout_display_t *vd, picture_t *picture)
 
     if (vlc_drm_ioctl(wnd->display.drm_fd, DRM_IOCTL_MODE_SETPLANE, &sp) < 0) {
         msg_Err(vd, "DRM plane setting error: %s", vlc_strerror_c(errno));
-        return;
+        goto out;
     }
 
+    /* Report the last vertical blanking, without waiting */
+    union drm_wait_vblank vbl = {
+        .request = {
+            .type = DRM_VBLANK_RELATIVE
+                  | ((sys->crtc_index << DRM_VBLANK_HIGH_CRTC_SHIFT)
+                     & DRM_VBLANK_HIGH_CRTC_MASK),
+            .sequence = 0,
+        },
+    };
+
+    if (vlc_drm_ioctl(wnd->display.drm_fd, DRM_IOCTL_WAIT_VBLANK, &vbl) >= 0)
+        vout_display_SendEventPresented(vd,
+            vlc_tick_from_sec(vbl.reply.tval_sec)
+                + VLC_TICK_FROM_US(vbl.reply.tval_usec),
+            sys->refresh_period);
+out:
     sys->front_buf++;
     if (sys->front_buf == MAXHWBUF)
         sys->front_buf = 0;
@@ -138,6 +302,13 @@ static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
 
+#ifdef HAVE_PRIME
+    if (sys->zero_copy) {
+        for (unsigned int i = 0; i < ARRAY_SIZE(sys->prime); i++)
+            PrimeRelease(vd, i);
+        return;
+    }
+#endif
     for (size_t i = 0; i < ARRAY_SIZE(sys->buffers); i++)
         picture_Release(sys->buffers[i]);
 }
@@ -187,6 +358,71 @@ static int Open(vout_display_t *vd,
 
     msg_Dbg(vd, "using DRM CRTC object ID %"PRIu32", index %d",
             wnd->handle.crtc, crtc_index);
+    sys->crtc_index = crtc_index;
+
+    struct drm_mode_crtc crtc = { .crtc_id = wnd->handle.crtc };
+
+    sys->refresh_period = 0;
+    if (vlc_drm_ioctl(fd, DRM_IOCTL_MODE_GETCRTC, &crtc) >= 0
+     && crtc.mode_valid && crtc.mode.clock > 0) {
+        /* The pixel clock is in kHz */
+        sys->refresh_period =
+            vlc_tick_from_samples((int64_t)crtc.mode.htotal * crtc.mode.vtotal,
+                                  crtc.mode.clock * 1000);
+        msg_Dbg(vd, "refresh period %"PRId64" us",
+                US_FROM_VLC_TICK(sys->refresh_period));
+    }
+
+    sys->zero_copy = false;
+#ifdef HAVE_PRIME
+    /* Scan hardware decoded pictures out directly, if a plane can take them
+     * as they are. Planes cannot rotate though. */
+    uint_fast32_t prime_fourcc = 0;
+
+    if (drm_fourcc == 0 && context != NULL
+     && vd->source->orientation == ORIENT_NORMAL)
+        switch (vlc_video_context_GetType(context)) {
+# ifdef HAVE_VAAPI_PRIME
+            case VLC_VIDEO_CONTEXT_VAAPI:
+                if (vd->source->i_chroma != VLC_CODEC_VAAPI_420
+                 && vd->source->i_chroma != VLC_CODEC_VAAPI_420_10BPP)
+                    break;
+                prime_fourcc = vlc_drm_fourcc(
+                    vd->source->i_chroma == VLC_CODEC_VAAPI_420_10BPP
+                        ? VLC_CODEC_P010 : VLC_CODEC_NV12);
+                sys->import = PrimeImport;
+                break;
+# endif
+# ifdef HAVE_V4L2M2M
+            case VLC_VIDEO_CONTEXT_V4L2M2M:
+                if (vd->source->i_chroma != VLC_CODEC_V4L2M2M_OPAQUE)
+                    break;
+                prime_fourcc = vlc_drm_fourcc(v4l2m2m_GetChroma(context));
+                sys->import = V4L2Import;
+                break;
+# endif
+            default:
+                break;
+        }
+
+    if (prime_fourcc != 0) {
+        bool overlay;
+
+        sys->plane_id = vlc_drm_get_crtc_video_plane(fd, crtc_index,
+                                                     prime_fourcc, &overlay);
+        if (sys->plane_id != 0) {
+            msg_Dbg(vd, "using DRM %s plane ID %"PRIu32" for zero-copy",
+                    overlay ? "overlay" : "primary", sys->plane_id);
+
+            for (size_t i = 0; i < ARRAY_SIZE(sys->prime); i++) {
+                sys->prime[i].pic = NULL;
+                sys->prime[i].fb_id = 0;
+            }
+            sys->zero_copy = true;
+            goto done;
+        }
+    }
+#endif
 
     size_t nfmt;
     sys->plane_id = vlc_drm_get_crtc_primary_plane(fd, crtc_index, &nfmt);
@@ -228,9 +464,14 @@ static int Open(vout_display_t *vd,
             return -ENOBUFS;
         }
     }
-
-    sys->front_buf = 0;
     *fmtp = fmt;
+#ifdef HAVE_PRIME
+done:
+#endif
+    sys->front_buf = 0;
+    sys->back_buf = 0;
+    /* One buffer is scanned out, the others can be prepared ahead */
+    vd->info.queue_depth = MAXHWBUF - 1;
     vd->sys = sys;
     vd->ops = &ops;
 
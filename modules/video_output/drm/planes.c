@@ -262,3 +262,78 @@ out:
     free(fmts);
     return drm_fourcc;
 }
+
+static bool vlc_drm_plane_has_format(int fd, uint_fast32_t plane_id,
+                                     size_t nfmt, uint_fast32_t drm_fourcc)
+{
+    uint32_t *fmts = vlc_alloc(nfmt, sizeof (*fmts));
+    if (unlikely(fmts == NULL))
+        return false;
+
+    struct drm_mode_get_plane plane = {
+        .plane_id = plane_id,
+        .count_format_types = nfmt,
+        .format_type_ptr = (uintptr_t)(void *)fmts,
+    };
+    bool found = false;
+
+    if (vlc_drm_ioctl(fd, DRM_IOCTL_MODE_GETPLANE, &plane) >= 0) {
+        if (nfmt > plane.count_format_types)
+            nfmt = plane.count_format_types;
+
+        for (size_t i = 0; i < nfmt && !found; i++)
+            found = fmts[i] == drm_fourcc;
+    }
+
+    free(fmts);
+    return found;
+}
+
+uint_fast32_t vlc_drm_get_crtc_video_plane(int fd, unsigned int idx,
+                                           uint_fast32_t drm_fourcc,
+                                           bool *restrict overlay)
+{
+    assert(idx < 32); /* Don't mix up object IDs and indices! */
+
+    uint32_t *planes;
+    ssize_t count = vlc_drm_get_planes(fd, &planes);
+    if (count < 0)
+        return 0;
+
+    uint_fast32_t ret = 0;
+
+    for (ssize_t i = 0; i < count; i++) {
+        struct drm_mode_get_plane plane = {
+            .plane_id = planes[i],
+        };
+        uint64_t planetype;
+
+        if (vlc_drm_ioctl(fd, DRM_IOCTL_MODE_GETPLANE, &plane) < 0
+         || !((plane.possible_crtcs >> idx) & 1)
+         || vlc_drm_get_plane_prop(fd, planes[i], "type", &planetype)
+         || !vlc_drm_plane_has_format(fd, planes[i],
+                                      plane.count_format_types, drm_fourcc))
+            continue;
+
+        switch (planetype) {
+            case VLC_DRM_PLANE_TYPE_OVERLAY:
+                /* A plane already in use by somebody else is not free. */
+                if (plane.crtc_id != 0 || plane.fb_id != 0)
+                    continue;
+                *overlay = true;
+                ret = planes[i];
+                goto out;
+            case VLC_DRM_PLANE_TYPE_PRIMARY:
+                ret = planes[i];
+                break;
+        }
+    }
+
+    if (ret == 0)
+        errno = ENOTSUP;
+    else
+        *overlay = false;
+out:
+    free(planes);
+    return ret;
+}
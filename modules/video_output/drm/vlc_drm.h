@@ -96,6 +96,32 @@ picture_t *vlc_drm_dumb_alloc_fb(struct vlc_logger *, int fd,
 
 uint32_t vlc_drm_dumb_get_fb_id(const picture_t *pic);
 
+/**
+ * Imports DMA buffers as a DRM frame buffer.
+ *
+ * The DMA buffer file descriptors are not consumed: the caller can close them
+ * or keep them as soon as this function returns.
+ *
+ * \param fd DRM device file descriptor
+ * \param drm_fourcc DRM pixel format
+ * \param width frame buffer width in pixels
+ * \param height frame buffer height in pixels
+ * \param planes number of planes (up to 4)
+ * \param fds DMA buffer file descriptor of each plane
+ * \param offsets byte offset of each plane within its DMA buffer
+ * \param pitches byte pitch of each plane
+ * \param modifiers format modifier of each plane
+ * \return a DRM frame buffer identifier (to be freed with
+ * DRM_IOCTL_MODE_RMFB), or zero on error.
+ */
+uint32_t vlc_drm_prime_add_fb(struct vlc_logger *, int fd,
+                              uint_fast32_t drm_fourcc,
+                              unsigned width, unsigned height,
+                              unsigned planes, const int *fds,
+                              const uint32_t *offsets,
+                              const uint32_t *pitches,
+                              const uint64_t *modifiers);
+
 /**
  * Finds the index of a CRTC.
  *
@@ -120,6 +146,22 @@ int vlc_drm_get_crtc_index(int fd, uint_fast32_t crtc_id);
 uint_fast32_t vlc_drm_get_crtc_primary_plane(int fd, unsigned int idx,
                                              size_t *nfmts);
 
+/**
+ * Finds a plane to scan video out.
+ *
+ * This looks for a free overlay plane of a CRTC supporting a given DRM pixel
+ * format, falling back to the primary plane if it supports the format.
+ *
+ * \param fd DRM device file descriptor
+ * \param idx CRTC object index (as returned by vlc_drm_get_crtc_index())
+ * \param drm_fourcc DRM pixel format the plane must support
+ * \param[out] overlay storage space for whether the plane is an overlay
+ * \return the plane object ID or zero on error
+ */
+uint_fast32_t vlc_drm_get_crtc_video_plane(int fd, unsigned int idx,
+                                           uint_fast32_t drm_fourcc,
+                                           bool *overlay);
+
 /**
  * Finds the best matching DRM format.
  *
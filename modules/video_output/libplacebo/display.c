@@ -41,6 +41,14 @@
 #include <libplacebo/swapchain.h>
 #include <libplacebo/shaders/lut.h>
 
+#ifdef HAVE_VAAPI
+# include <va/va_drmcommon.h>
+# include "../../hw/vaapi/vlc_vaapi.h"
+# if VA_CHECK_VERSION(1, 1, 0)
+#  define HAVE_VAAPI_PRIME 1
+# endif
+#endif
+
 typedef struct vout_display_sys_t
 {
     vlc_placebo_t *pl;
@@ -77,6 +85,17 @@ typedef struct vout_display_sys_t
 #if PL_API_VER >= 185
     struct pl_dovi_metadata dovi_metadata;
 #endif
+
+#ifdef HAVE_VAAPI_PRIME
+    // Decoder surfaces, imported once as textures (see ImportVaapi)
+    vlc_video_context *vctx;
+    vlc_fourcc_t sw_chroma;
+    struct {
+        VASurfaceID id;
+        pl_tex tex[2];
+    } imported[32];
+    int num_imported;
+#endif
 } vout_display_sys_t;
 
 // Display callbacks
@@ -132,6 +151,19 @@ static int Open(vout_display_t *vd,
 
     vlc_placebo_ReleaseCurrent(sys->pl);
 
+#ifdef HAVE_VAAPI_PRIME
+    // Sample the decoder surfaces directly, if the GPU can import them
+    if (context != NULL
+     && vlc_video_context_GetType(context) == VLC_VIDEO_CONTEXT_VAAPI
+     && vlc_vaapi_IsChromaOpaque(vd->source->i_chroma)
+     && (gpu->import_caps.tex & PL_HANDLE_DMA_BUF)) {
+        fmt->i_chroma = vd->source->i_chroma;
+        sys->sw_chroma = fmt->i_chroma == VLC_CODEC_VAAPI_420_10BPP
+                       ? VLC_CODEC_P010 : VLC_CODEC_NV12;
+        sys->vctx = vlc_video_context_Hold(context);
+        msg_Dbg(vd, "importing VAAPI surfaces as DMA buffers");
+    } else
+#endif
     // Attempt using the input format as the display format
     if (vlc_placebo_FormatSupported(gpu, vd->source->i_chroma)) {
         fmt->i_chroma = vd->source->i_chroma;
@@ -153,6 +185,10 @@ static int Open(vout_display_t *vd,
     }
     sys->yuv_chroma_loc = vlc_fourcc_IsYUV(fmt->i_chroma) ?
                           vlc_placebo_ChromaLoc(fmt) : PL_CHROMA_UNKNOWN;
+#ifdef HAVE_VAAPI_PRIME
+    if (sys->vctx != NULL)
+        sys->yuv_chroma_loc = vlc_placebo_ChromaLoc(fmt);
+#endif
 
     // Hard-coded list of supported subtitle chromas (non-planar only!)
     static const vlc_fourcc_t subfmts[] = {
@@ -183,6 +219,101 @@ error:
     return VLC_EGENERIC;
 }
 
+#ifdef HAVE_VAAPI_PRIME
+static void FlushImported(vout_display_sys_t *sys)
+{
+    for (int i = 0; i < sys->num_imported; i++) {
+        pl_tex_destroy(sys->pl->gpu, &sys->imported[i].tex[0]);
+        pl_tex_destroy(sys->pl->gpu, &sys->imported[i].tex[1]);
+    }
+    sys->num_imported = 0;
+}
+
+// Wraps the luma and chroma planes of a VAAPI surface into textures, without
+// any copy. The surfaces of the decoder pool are imported only once.
+static bool ImportVaapi(vout_display_t *vd, picture_t *pic,
+                        const video_format_t *fmt, struct pl_frame *img)
+{
+    vout_display_sys_t *sys = vd->sys;
+    pl_gpu gpu = sys->pl->gpu;
+    VADisplay dpy = vlc_vaapi_PicGetDisplay(pic);
+    VASurfaceID id = vlc_vaapi_PicGetSurface(pic);
+
+    if (vaSyncSurface(dpy, id) != VA_STATUS_SUCCESS)
+        return false;
+
+    int idx = 0;
+    while (idx < sys->num_imported && sys->imported[idx].id != id)
+        idx++;
+
+    if (idx == sys->num_imported) {
+        if (idx == (int) ARRAY_SIZE(sys->imported)) {
+            // The decoder pool was replaced, start over
+            FlushImported(sys);
+            idx = 0;
+        }
+
+        VADRMPRIMESurfaceDescriptor desc;
+        if (vlc_vaapi_ExportSurfaceHandle(VLC_OBJECT(vd), dpy, id,
+                                          VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2,
+                                          VA_EXPORT_SURFACE_READ_ONLY
+                                          | VA_EXPORT_SURFACE_SEPARATE_LAYERS,
+                                          &desc))
+            return false;
+
+        bool ok = desc.num_layers == 2;
+        for (int i = 0; ok && i < 2; i++) {
+            const uint32_t obj = desc.layers[i].object_index[0];
+            pl_fmt plfmt = pl_find_fourcc(gpu, desc.layers[i].drm_format);
+            if (plfmt == NULL) {
+                msg_Warn(vd, "cannot import DRM format %4.4s",
+                         (const char *) &desc.layers[i].drm_format);
+                ok = false;
+                break;
+            }
+
+            sys->imported[idx].tex[i] = pl_tex_create(gpu, &(struct pl_tex_params) {
+                .w = i == 0 ? desc.width : (desc.width + 1) / 2,
+                .h = i == 0 ? desc.height : (desc.height + 1) / 2,
+                .format = plfmt,
+                .sampleable = true,
+                .import_handle = PL_HANDLE_DMA_BUF,
+                .shared_mem = {
+                    .handle.fd = desc.objects[obj].fd,
+                    .size = desc.objects[obj].size,
+                    .offset = desc.layers[i].offset[0],
+                    .drm_format_mod = desc.objects[obj].drm_format_modifier,
+                    .stride_w = desc.layers[i].pitch[0],
+                },
+            });
+            ok = sys->imported[idx].tex[i] != NULL;
+        }
+
+        // The textures hold their own references to the buffers
+        for (uint32_t i = 0; i < desc.num_objects; i++)
+            vlc_close(desc.objects[i].fd);
+
+        if (!ok) {
+            pl_tex_destroy(gpu, &sys->imported[idx].tex[0]);
+            pl_tex_destroy(gpu, &sys->imported[idx].tex[1]);
+            return false;
+        }
+        sys->imported[idx].id = id;
+        sys->num_imported = idx + 1;
+    }
+
+    img->num_planes = vlc_placebo_PlaneComponents(fmt, img->planes);
+    assert(img->num_planes == 2);
+
+    for (int i = 0; i < 2; i++)
+        img->planes[i].texture = sys->imported[idx].tex[i];
+    if (sys->yuv_chroma_loc != PL_CHROMA_UNKNOWN)
+        pl_chroma_location_offset(sys->yuv_chroma_loc, &img->planes[1].shift_x,
+                                  &img->planes[1].shift_y);
+    return true;
+}
+#endif
+
 static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
@@ -193,10 +324,18 @@ static void Close(vout_display_t *vd)
             pl_tex_destroy(gpu, &sys->plane_tex[i]);
         for (int i = 0; i < sys->num_overlays; i++)
             pl_tex_destroy(gpu, &sys->overlay_tex[i]);
+#ifdef HAVE_VAAPI_PRIME
+        FlushImported(sys);
+#endif
         pl_renderer_destroy(&sys->renderer);
         vlc_placebo_ReleaseCurrent(sys->pl);
     }
 
+#ifdef HAVE_VAAPI_PRIME
+    if (sys->vctx != NULL)
+        vlc_video_context_Release(sys->vctx);
+#endif
+
     if (sys->overlays) {
         free(sys->overlays);
         free(sys->overlay_parts);
@@ -235,10 +374,17 @@ static void PictureRender(vout_display_t *vd, picture_t *pic,
     bool need_vflip = frame.flipped;
 #endif
 
+    video_format_t fmt = *vd->fmt;
+#ifdef HAVE_VAAPI_PRIME
+    // The imported surfaces are sampled as their software equivalent
+    if (sys->vctx != NULL)
+        fmt.i_chroma = sys->sw_chroma;
+#endif
+
     struct pl_frame img = {
         .num_planes = pic->i_planes,
-        .color      = vlc_placebo_ColorSpace(vd->fmt),
-        .repr       = vlc_placebo_ColorRepr(vd->fmt),
+        .color      = vlc_placebo_ColorSpace(&fmt),
+        .repr       = vlc_placebo_ColorRepr(&fmt),
         .crop = {
             .x0 = pic->format.i_x_offset,
             .y0 = pic->format.i_y_offset,
@@ -265,25 +411,36 @@ static void PictureRender(vout_display_t *vd, picture_t *pic,
         vlc_placebo_HdrMetadata(hdm, &img.color.hdr);
     }
 
-    // Upload the image data for each plane
-    struct pl_plane_data data[4];
-    if (!vlc_placebo_PlaneData(pic, data, NULL)) {
-        // This should never happen, in theory
-        assert(!"Failed processing the picture_t into pl_plane_data!?");
-    }
-
-    for (int i = 0; i < pic->i_planes; i++) {
-        struct pl_plane *plane = &img.planes[i];
-        if (!pl_upload_plane(gpu, plane, &sys->plane_tex[i], &data[i])) {
-            msg_Err(vd, "Failed uploading image data!");
+#ifdef HAVE_VAAPI_PRIME
+    if (sys->vctx != NULL) {
+        if (!ImportVaapi(vd, pic, &fmt, &img)) {
+            msg_Err(vd, "Failed importing the VAAPI surface!");
             failed = true;
             goto done;
         }
+    } else
+#endif
+    {
+        // Upload the image data for each plane
+        struct pl_plane_data data[4];
+        if (!vlc_placebo_PlaneData(pic, data, NULL)) {
+            // This should never happen, in theory
+            assert(!"Failed processing the picture_t into pl_plane_data!?");
+        }
+
+        for (int i = 0; i < pic->i_planes; i++) {
+            struct pl_plane *plane = &img.planes[i];
+            if (!pl_upload_plane(gpu, plane, &sys->plane_tex[i], &data[i])) {
+                msg_Err(vd, "Failed uploading image data!");
+                failed = true;
+                goto done;
+            }
 
-        // Matches only the chroma planes, never luma or alpha
-        if (sys->yuv_chroma_loc != PL_CHROMA_UNKNOWN && i != 0 && i != 3)
-            pl_chroma_location_offset(sys->yuv_chroma_loc, &plane->shift_x,
-                                      &plane->shift_y);
+            // Matches only the chroma planes, never luma or alpha
+            if (sys->yuv_chroma_loc != PL_CHROMA_UNKNOWN && i != 0 && i != 3)
+                pl_chroma_location_offset(sys->yuv_chroma_loc, &plane->shift_x,
+                                          &plane->shift_y);
+        }
     }
 
     struct pl_frame target;
@@ -58,6 +58,8 @@ vlc_gl_filter_New(struct vlc_gl_t *gl, const struct vlc_gl_api *api)
     filter->module = NULL;
 
     vlc_list_init(&priv->blend_subfilters);
+    vlc_list_init(&priv->fused_subfilters);
+    priv->fusion = NULL;
 
     /* Expose a const pointer to the OpenGL format publicly */
     filter->glfmt_in = &priv->glfmt_in;
@@ -93,18 +95,12 @@ vlc_gl_filter_LoadModule(vlc_object_t *parent, const char *name,
         return VLC_EGENERIC;
 
     assert(filter->ops->draw);
+    assert(!filter->ops->get_pointwise
+           || (filter->ops->fetch_pointwise_locations
+            && filter->ops->load_pointwise));
     return VLC_SUCCESS;
 }
 
-static void
-DeleteFramebuffersOut(struct vlc_gl_filter_priv *priv)
-{
-    const opengl_vtable_t *vt = &priv->filter.api->vt;
-
-    vt->DeleteFramebuffers(priv->tex_count, priv->framebuffers_out);
-    vt->DeleteTextures(priv->tex_count, priv->textures_out);
-}
-
 static void
 DeleteFramebufferMSAA(struct vlc_gl_filter_priv *priv)
 {
@@ -132,8 +128,13 @@ vlc_gl_filter_Delete(struct vlc_gl_filter *filter)
         vlc_gl_filter_Delete(subfilter);
     }
 
-    if (priv->tex_count)
-        DeleteFramebuffersOut(priv);
+    /* The fusion program has been deleted by the filter chain */
+    assert(!priv->fusion);
+    vlc_list_foreach(subfilter_priv, &priv->fused_subfilters, node)
+    {
+        struct vlc_gl_filter *subfilter = &subfilter_priv->filter;
+        vlc_gl_filter_Delete(subfilter);
+    }
 
     if (filter->config.msaa_level)
         DeleteFramebufferMSAA(priv);
@@ -141,76 +142,6 @@ vlc_gl_filter_Delete(struct vlc_gl_filter *filter)
     vlc_object_delete(&filter->obj);
 }
 
-static int
-InitPlane(struct vlc_gl_filter_priv *priv, unsigned plane, GLsizei width,
-          GLsizei height)
-{
-    const opengl_vtable_t *vt = &priv->filter.api->vt;
-
-    GLuint framebuffer = priv->framebuffers_out[plane];
-    GLuint texture = priv->textures_out[plane];
-
-    vt->BindTexture(GL_TEXTURE_2D, texture);
-    vt->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
-                   GL_UNSIGNED_BYTE, NULL);
-    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    /* iOS needs GL_CLAMP_TO_EDGE or power-of-two textures */
-    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    /* Create a framebuffer and attach the texture */
-    vt->BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-    vt->FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                             GL_TEXTURE_2D, texture, 0);
-
-    GLenum status = vt->CheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE)
-        return VLC_EGENERIC;
-
-    return VLC_SUCCESS;
-}
-
-static int
-InitFramebuffersOut(struct vlc_gl_filter_priv *priv)
-{
-    assert(priv->size_out.width > 0 && priv->size_out.height > 0);
-
-    /* Not initialized yet */
-    assert(priv->tex_count == 0);
-
-    const opengl_vtable_t *vt = &priv->filter.api->vt;
-
-    struct vlc_gl_filter *filter = &priv->filter;
-    if (filter->config.filter_planes)
-        priv->tex_count = priv->glfmt_in.tex_count;
-    else
-        priv->tex_count = 1;
-
-    vt->GenFramebuffers(priv->tex_count, priv->framebuffers_out);
-    vt->GenTextures(priv->tex_count, priv->textures_out);
-
-    memcpy(priv->tex_widths, priv->plane_widths,
-           priv->tex_count * sizeof(*priv->tex_widths));
-    memcpy(priv->tex_heights, priv->plane_heights,
-           priv->tex_count * sizeof(*priv->tex_heights));
-
-    for (unsigned i = 0; i < priv->tex_count; ++i)
-    {
-        /* Init one framebuffer and texture for each plane */
-        int ret =
-            InitPlane(priv, i, priv->tex_widths[i], priv->tex_heights[i]);
-        if (ret != VLC_SUCCESS)
-        {
-            DeleteFramebuffersOut(priv);
-            return ret;
-        }
-    }
-
-    return VLC_SUCCESS;
-}
-
 static int
 InitFramebufferMSAA(struct vlc_gl_filter_priv *priv, unsigned msaa_level)
 {
@@ -242,28 +173,13 @@ InitFramebufferMSAA(struct vlc_gl_filter_priv *priv, unsigned msaa_level)
 }
 
 int
-vlc_gl_filter_InitFramebuffers(struct vlc_gl_filter *filter, bool has_out)
+vlc_gl_filter_InitFramebuffers(struct vlc_gl_filter *filter)
 {
     struct vlc_gl_filter_priv *priv = vlc_gl_filter_PRIV(filter);
 
     unsigned msaa_level = priv->filter.config.msaa_level;
     if (msaa_level)
-    {
-        int ret = InitFramebufferMSAA(priv, msaa_level);
-        if (ret != VLC_SUCCESS)
-            return ret;
-    }
-
-    /* Every non-blend filter needs its own framebuffer, except the last one */
-    if (has_out)
-    {
-        int ret = InitFramebuffersOut(priv);
-        if (ret != VLC_SUCCESS)
-        {
-            DeleteFramebufferMSAA(priv);
-            return ret;
-        }
-    }
+        return InitFramebufferMSAA(priv, msaa_level);
 
     return VLC_SUCCESS;
 }
@@ -316,21 +232,5 @@ vlc_gl_filter_ApplyOutputSize(struct vlc_gl_filter *filter)
                                            priv->size_out.height);
     }
 
-    if (priv->tex_count)
-    {
-        memcpy(priv->tex_widths, priv->plane_widths,
-               priv->tex_count * sizeof(*priv->tex_widths));
-        memcpy(priv->tex_heights, priv->plane_heights,
-               priv->tex_count * sizeof(*priv->tex_heights));
-
-        for (unsigned plane = 0; plane < priv->tex_count; ++plane)
-        {
-            vt->BindTexture(GL_TEXTURE_2D, priv->textures_out[plane]);
-            vt->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, priv->tex_widths[plane],
-                           priv->tex_heights[plane], 0, GL_RGBA,
-                           GL_UNSIGNED_BYTE, NULL);
-        }
-    }
-
     GL_ASSERT_NOERROR(vt);
 }
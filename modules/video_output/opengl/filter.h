@@ -41,7 +41,10 @@ struct vlc_gl_tex_size {
 struct vlc_gl_input_meta {
     vlc_tick_t pts;
     unsigned plane;
+    /** Field order of the (interlaced) input picture */
+    bool top_field_first;
     const vlc_video_dovi_metadata_t *dovi_rpu;
+    const vlc_video_hdr_dynamic_metadata_t *hdr10plus;
 };
 
 typedef int
@@ -99,6 +102,41 @@ struct vlc_gl_filter_ops {
      */
     void (*on_input_size_change)(struct vlc_gl_filter *filter,
                                  const struct vlc_gl_tex_size *size);
+
+    /**
+     * Get the GLSL code of a pointwise filter (optional)
+     *
+     * A pointwise filter computes each output pixel from the input pixel at
+     * the same location only, without changing the size. If fusion is
+     * enabled, consecutive pointwise filters are executed in a single
+     * rendering pass (see vlc_gl_filters_EnableFusion()); draw() is not
+     * called anymore in that case.
+     *
+     * The code must define the function:
+     *
+     *     vec4 <prefix>fragment(vec4 color);
+     *
+     * and every other global identifier it declares (uniforms, functions)
+     * must start with the prefix too.
+     *
+     * If set, fetch_pointwise_locations() and load_pointwise() must be set.
+     *
+     * \return the code (to be freed by the caller), NULL on error
+     */
+    char *(*get_pointwise)(struct vlc_gl_filter *filter, const char *prefix);
+
+    /**
+     * Fetch the locations of the uniforms of the pointwise code in the
+     * program using it
+     */
+    void (*fetch_pointwise_locations)(struct vlc_gl_filter *filter,
+                                      GLuint program, const char *prefix);
+
+    /**
+     * Load the uniforms of the pointwise code in the current program
+     */
+    void (*load_pointwise)(struct vlc_gl_filter *filter,
+                           const struct vlc_gl_input_meta *meta);
 };
 
 /**
@@ -54,6 +54,16 @@
  * small offset:
  *
  *     ./vlc file.mkv --video-filter='opengl{filter=mock{plane}}'
+ *
+ * It can also be used as a pointwise filter, tinting the video with a color
+ * depending on the angle (and rotating with the timestamps if a speed is
+ * specified):
+ *
+ *     ./vlc file.mkv --video-filter='opengl{filter=mock{tint,speed=10}}'
+ *
+ * Consecutive pointwise filters may be executed in a single pass:
+ *
+ *     ./vlc file.mkv --video-filter='opengl{filter="mock{tint}:mock{tint,angle=90}",fusion}'
  */
 #ifdef HAVE_CONFIG_H
 # include "config.h"
@@ -77,7 +87,7 @@
 #define MOCK_CFG_PREFIX "mock-"
 
 static const char *const filter_options[] = {
-    "angle", "mask", "msaa", "plane", "speed", NULL
+    "angle", "mask", "msaa", "plane", "speed", "tint", NULL
 };
 
 struct sys {
@@ -94,6 +104,7 @@ struct sys {
         GLint vertex_color; // blend (non-mask) only
         GLint tex_coords_in; // plane only
         GLint offset;
+        GLint tint; // tint only
     } loc;
 
     float theta0;
@@ -103,12 +114,18 @@ struct sys {
     float ar;
 };
 
-static void
-InitMatrix(struct sys *sys, vlc_tick_t pts)
+static float
+GetTheta(struct sys *sys, vlc_tick_t pts)
 {
     float time_sec = secf_from_vlc_tick(pts);
     /* Full cycle in 60 seconds if speed = 1 */
-    float theta = sys->theta0 + sys->speed * time_sec * 2 * 3.141592f / 60;
+    return sys->theta0 + sys->speed * time_sec * 2 * 3.141592f / 60;
+}
+
+static void
+InitMatrix(struct sys *sys, vlc_tick_t pts)
+{
+    float theta = GetTheta(sys, pts);
     float cos_theta = cos(theta);
     float sin_theta = sin(theta);
     float ar = sys->ar;
@@ -269,6 +286,102 @@ DrawPlane(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
     return VLC_SUCCESS;
 }
 
+static char *
+GetTintCode(struct vlc_gl_filter *filter, const char *prefix)
+{
+    (void) filter;
+
+    char *code;
+    int ret = asprintf(&code,
+                       "uniform vec3 %stint;\n"
+                       "vec4 %sfragment(vec4 color) {\n"
+                       "  return vec4(color.rgb * %stint, color.a);\n"
+                       "}\n", prefix, prefix, prefix);
+    return ret < 0 ? NULL : code;
+}
+
+static void
+FetchTintLocations(struct vlc_gl_filter *filter, GLuint program,
+                   const char *prefix)
+{
+    struct sys *sys = filter->sys;
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%stint", prefix);
+    sys->loc.tint = vt->GetUniformLocation(program, name);
+    assert(sys->loc.tint != -1);
+}
+
+static void
+LoadTint(struct vlc_gl_filter *filter, const struct vlc_gl_input_meta *meta)
+{
+    struct sys *sys = filter->sys;
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    /* Rotate the hue of the tint (by thirds of a turn between components) */
+    float theta = GetTheta(sys, meta->pts);
+    vt->Uniform3f(sys->loc.tint, 0.75f + 0.25f * cosf(theta),
+                                 0.75f + 0.25f * cosf(theta - 2.094395f),
+                                 0.75f + 0.25f * cosf(theta + 2.094395f));
+}
+
+static int
+DrawTint(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
+         const struct vlc_gl_input_meta *meta)
+{
+    struct sys *sys = filter->sys;
+
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    vt->UseProgram(sys->program_id);
+
+    struct vlc_gl_sampler *sampler = sys->sampler;
+    vlc_gl_sampler_Update(sampler, pic);
+    vlc_gl_sampler_Load(sampler);
+
+    LoadTint(filter, meta);
+
+    vt->BindBuffer(GL_ARRAY_BUFFER, sys->vbo);
+
+    if (pic->mtx_has_changed)
+    {
+        float coords[] = {
+            0, 1,
+            0, 0,
+            1, 1,
+            1, 0,
+        };
+
+        /* Transform coordinates in place */
+        vlc_gl_picture_ToTexCoords(pic, 4, coords, coords);
+
+        const float data[] = {
+            -1,  1, coords[0], coords[1],
+            -1, -1, coords[2], coords[3],
+             1,  1, coords[4], coords[5],
+             1, -1, coords[6], coords[7],
+        };
+        vt->BufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
+    }
+
+    const GLsizei stride = 4 * sizeof(float);
+
+    vt->EnableVertexAttribArray(sys->loc.vertex_pos);
+    vt->VertexAttribPointer(sys->loc.vertex_pos, 2, GL_FLOAT, GL_FALSE, stride,
+                            (const void *) 0);
+
+    intptr_t offset = 2 * sizeof(float);
+    vt->EnableVertexAttribArray(sys->loc.tex_coords_in);
+    vt->VertexAttribPointer(sys->loc.tex_coords_in, 2, GL_FLOAT, GL_FALSE,
+                            stride, (const void *) offset);
+
+    vt->Clear(GL_COLOR_BUFFER_BIT);
+    vt->DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    return VLC_SUCCESS;
+}
+
 static void
 Close(struct vlc_gl_filter *filter)
 {
@@ -568,6 +681,103 @@ InitPlane(struct vlc_gl_filter *filter, const struct vlc_gl_format *glfmt)
     return VLC_SUCCESS;
 }
 
+static int
+InitTint(struct vlc_gl_filter *filter, const struct vlc_gl_format *glfmt)
+{
+    struct sys *sys = filter->sys;
+    const opengl_vtable_t *vt = &filter->api->vt;
+
+    struct vlc_gl_sampler *sampler =
+        vlc_gl_sampler_New(filter->gl, filter->api, glfmt, false);
+    if (!sampler)
+        return VLC_EGENERIC;
+
+    sys->sampler = sampler;
+
+    static const char *const VERTEX_SHADER_BODY =
+        "attribute vec2 vertex_pos;\n"
+        "attribute vec2 tex_coords_in;\n"
+        "varying vec2 tex_coords;\n"
+        "void main() {\n"
+        "  gl_Position = vec4(vertex_pos, 0.0, 1.0);\n"
+        "  tex_coords = tex_coords_in;\n"
+        "}\n";
+
+    static const char *const FRAGMENT_SHADER_BODY =
+        "varying vec2 tex_coords;\n"
+        "void main() {\n"
+        "  gl_FragColor = fragment(vlc_texture(tex_coords));\n"
+        "}\n";
+
+    /* The same code is used when the filter is fused with others, with a
+     * prefix */
+    char *tint_code = GetTintCode(filter, "");
+    if (!tint_code)
+        return VLC_EGENERIC;
+
+    const char *extensions = sampler->shader.extensions
+                           ? sampler->shader.extensions : "";
+
+    const char *shader_version;
+    const char *shader_precision;
+    if (filter->api->is_gles)
+    {
+        shader_version = "#version 100\n";
+        shader_precision = "precision highp float;\n";
+    }
+    else
+    {
+        shader_version = "#version 120\n";
+        shader_precision = "";
+    }
+
+    const char *vertex_shader[] = {
+        shader_version,
+        VERTEX_SHADER_BODY,
+    };
+    const char *fragment_shader[] = {
+        shader_version,
+        extensions,
+        shader_precision,
+        sampler->shader.body,
+        tint_code,
+        FRAGMENT_SHADER_BODY,
+    };
+
+    GLuint program_id =
+        vlc_gl_BuildProgram(VLC_OBJECT(filter), vt,
+                            ARRAY_SIZE(vertex_shader), vertex_shader,
+                            ARRAY_SIZE(fragment_shader), fragment_shader);
+    free(tint_code);
+    if (!program_id)
+        return VLC_EGENERIC;
+
+    sys->program_id = program_id;
+
+    vlc_gl_sampler_FetchLocations(sampler, program_id);
+    FetchTintLocations(filter, program_id, "");
+
+    sys->loc.vertex_pos = vt->GetAttribLocation(sys->program_id, "vertex_pos");
+    assert(sys->loc.vertex_pos != -1);
+
+    sys->loc.tex_coords_in = vt->GetAttribLocation(sys->program_id,
+                                                   "tex_coords_in");
+    assert(sys->loc.tex_coords_in != -1);
+
+    vt->GenBuffers(1, &sys->vbo);
+
+    static const struct vlc_gl_filter_ops ops = {
+        .draw = DrawTint,
+        .close = Close,
+        .get_pointwise = GetTintCode,
+        .fetch_pointwise_locations = FetchTintLocations,
+        .load_pointwise = LoadTint,
+    };
+    filter->ops = &ops;
+
+    return VLC_SUCCESS;
+}
+
 static int
 Open(struct vlc_gl_filter *filter, const config_chain_t *config,
      const struct vlc_gl_format *glfmt, struct vlc_gl_tex_size *size_out)
@@ -576,6 +786,7 @@ Open(struct vlc_gl_filter *filter, const config_chain_t *config,
 
     bool mask = var_InheritBool(filter, MOCK_CFG_PREFIX "mask");
     bool plane = var_InheritBool(filter, MOCK_CFG_PREFIX "plane");
+    bool tint = var_InheritBool(filter, MOCK_CFG_PREFIX "tint");
     float angle = var_InheritFloat(filter, MOCK_CFG_PREFIX "angle");
     float speed = var_InheritFloat(filter, MOCK_CFG_PREFIX "speed");
     int msaa = var_InheritInteger(filter, MOCK_CFG_PREFIX "msaa");
@@ -591,6 +802,8 @@ Open(struct vlc_gl_filter *filter, const config_chain_t *config,
         ret = InitPlane(filter, glfmt);
     else if (mask)
         ret = InitMask(filter, glfmt);
+    else if (tint)
+        ret = InitTint(filter, glfmt);
     else
         ret = InitBlend(filter);
 
@@ -601,8 +814,9 @@ Open(struct vlc_gl_filter *filter, const config_chain_t *config,
     sys->theta0 = angle * M_PI / 180; /* angle in degrees, theta0 in radians */
     sys->speed = speed;
 
-    /* MSAA is not supported for plane filters */
-    filter->config.msaa_level = plane ? 0 : msaa;
+    /* MSAA is not supported for plane filters, and useless for pointwise
+     * filters */
+    filter->config.msaa_level = plane || (tint && !mask) ? 0 : msaa;
 
     return VLC_SUCCESS;
 
@@ -626,6 +840,8 @@ vlc_module_begin()
         change_volatile()
     add_bool(MOCK_CFG_PREFIX "plane", false, NULL, NULL)
         change_volatile()
+    add_bool(MOCK_CFG_PREFIX "tint", false, NULL, NULL)
+        change_volatile()
     add_integer(MOCK_CFG_PREFIX "msaa", 4, NULL, NULL)
         change_volatile()
 vlc_module_end()
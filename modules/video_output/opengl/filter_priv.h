@@ -43,10 +43,11 @@ struct vlc_gl_filter_priv {
     GLsizei plane_widths[PICTURE_PLANE_MAX];
     GLsizei plane_heights[PICTURE_PLANE_MAX];
 
-    /* owned (this filter must delete it) */
+    /* Not owned: provided by the filter chain, which shares them between
+     * filters (see vlc_gl_filters_InitFramebuffers()) */
     GLuint framebuffers_out[PICTURE_PLANE_MAX];
 
-    /* owned (each attached to framebuffers_out[i]) */
+    /* Not owned (each attached to framebuffers_out[i]) */
     GLuint textures_out[PICTURE_PLANE_MAX];
     GLsizei tex_widths[PICTURE_PLANE_MAX];
     GLsizei tex_heights[PICTURE_PLANE_MAX];
@@ -63,6 +64,13 @@ struct vlc_gl_filter_priv {
      * filter chain to simplify the rendering code */
     struct vlc_list blend_subfilters; /**< list of vlc_gl_filter_priv.node */
 
+    /* Pointwise filters executed in the same rendering pass as this one, if
+     * fusion is enabled */
+    struct vlc_list fused_subfilters; /**< list of vlc_gl_filter_priv.node */
+    /* Program executing this filter and its fused subfilters, NULL if there
+     * are none (owned by the filter chain) */
+    struct vlc_gl_fusion *fusion;
+
     bool has_picture;
 };
 
@@ -87,13 +95,17 @@ vlc_gl_filter_LoadModule(vlc_object_t *parent, const char *name,
 void
 vlc_gl_filter_Delete(struct vlc_gl_filter *filter);
 
+/** Init the MSAA framebuffer, if any (the output framebuffers are provided by
+ * the filter chain) */
 int
-vlc_gl_filter_InitFramebuffers(struct vlc_gl_filter *filter, bool is_last);
+vlc_gl_filter_InitFramebuffers(struct vlc_gl_filter *filter);
 
 /** Recompute plane count, widths and heights after size_out have changed */
 void
 vlc_gl_filter_InitPlaneSizes(struct vlc_gl_filter *filter);
 
+/** Recompute the plane sizes and the MSAA renderbuffer after size_out have
+ * changed (the output textures are reassigned by the filter chain) */
 void
 vlc_gl_filter_ApplyOutputSize(struct vlc_gl_filter *filter);
 
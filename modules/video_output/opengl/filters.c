@@ -28,8 +28,11 @@
 #include <vlc_common.h>
 #include <vlc_ancillary.h>
 #include <vlc_list.h>
+#include <vlc_memstream.h>
+#include <vlc_vector.h>
 
 #include "filter_priv.h"
+#include "gl_util.h"
 #include "importer_priv.h"
 
 /* The filter chain contains the sequential list of filters.
@@ -61,7 +64,7 @@
  *     |  +- logo3           (blend)
  *     +- renderer           (non-blend)
  *
- * An output framebuffer is created for each non-blend filters. It is used as
+ * An output framebuffer is assigned to each non-blend filters. It is used as
  * draw framebuffer for that filter and all its associated blend filters.
  *
  * If the first filter is a blend filter, then a "draw" filter is automatically
@@ -110,8 +113,66 @@
  *     +- renderer           msaa_level=2
  *     |  +- logo_msaa2      msaa_level=2
  *     +- draw               msaa_level=0
+ *
+ *
+ * ## Output textures
+ *
+ * The output textures (and their framebuffers) are not owned by the filters,
+ * but by a pool in the filter chain. A filter only reads the output of the
+ * previous one, so the output of a filter may be reused by the filter two
+ * steps further: a chain of any length only needs two textures per plane
+ * size, used in turn.
+ *
+ * When the output size changes, the textures are reassigned, reusing the
+ * ones having the right size, so that they are only reallocated when
+ * necessary.
+ *
+ *
+ * ## Fusion
+ *
+ * If enabled (see vlc_gl_filters_EnableFusion()), consecutive pointwise
+ * filters (providing get_pointwise()) are executed in a single rendering
+ * pass, instead of one pass (and one intermediate texture) each. The first
+ * one of a sequence executes the fused program, and the following ones are
+ * stored as its fused subfilters:
+ *
+ *     +- adjust             (pointwise)
+ *     |  +- sepia           (pointwise, fused)
+ *     |  +- logo            (blend)
+ *     +- renderer           (non-blend)
+ *
+ * A filter may not be fused with the previous one if the latter has blend
+ * subfilters, since they must draw before it. The blend subfilters of a fused
+ * filter draw over the output of the fused pass.
  */
 
+/* Output texture of the pool */
+struct vlc_gl_filters_texture {
+    GLuint texture;
+    GLuint framebuffer;
+    GLsizei width;
+    GLsizei height;
+    /* Index of the filter drawing to it in the chain, -1 if unused */
+    int writer;
+};
+
+/* Program executing a sequence of pointwise filters */
+struct vlc_gl_fusion {
+    struct vlc_gl_sampler *sampler;
+
+    GLuint program_id;
+
+    GLuint vbo;
+
+    struct {
+        GLint vertex_pos;
+        GLint tex_coords_in;
+    } loc;
+
+    unsigned count;
+    struct vlc_gl_filter *filters[];
+};
+
 struct vlc_gl_filters {
     struct vlc_gl_t *gl;
     const struct vlc_gl_api *api;
@@ -124,6 +185,12 @@ struct vlc_gl_filters {
 
     struct vlc_list list; /**< list of vlc_gl_filter.node */
 
+    /** Output textures of the filters */
+    struct VLC_VECTOR(struct vlc_gl_filters_texture) textures;
+
+    /** Execute consecutive pointwise filters in a single pass */
+    bool fusion;
+
     struct vlc_gl_filters_viewport {
         int x;
         int y;
@@ -135,9 +202,16 @@ struct vlc_gl_filters {
         /** Last updated picture PTS */
         vlc_tick_t pts;
 
+        /** Field order of the last updated picture */
+        bool top_field_first;
+
         /** Dolby Vision RPU metadata for the last picture, if any */
         vlc_video_dovi_metadata_t dovi_rpu;
         int has_dovi;
+
+        /** HDR10+ metadata for the last picture, if any */
+        vlc_video_hdr_dynamic_metadata_t hdr10plus;
+        bool has_hdr10plus;
     } pic;
 };
 
@@ -160,28 +234,68 @@ vlc_gl_filters_New(struct vlc_gl_t *gl, const struct vlc_gl_api *api,
     filters->api = api;
     filters->interop = interop;
     vlc_list_init(&filters->list);
+    vlc_vector_init(&filters->textures);
+    filters->fusion = false;
 
     memset(&filters->viewport, 0, sizeof(filters->viewport));
     filters->pic.pts = VLC_TICK_INVALID;
     filters->pic.has_dovi = 0;
+    filters->pic.has_hdr10plus = false;
 
     return filters;
 }
 
+static void
+DeleteFusion(struct vlc_gl_filters *filters, struct vlc_gl_fusion *fusion)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    vt->DeleteProgram(fusion->program_id);
+    vt->DeleteBuffers(1, &fusion->vbo);
+    vlc_gl_sampler_Delete(fusion->sampler);
+    free(fusion);
+}
+
+static void
+DeleteTexture(struct vlc_gl_filters *filters,
+              struct vlc_gl_filters_texture *tex)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    vt->DeleteFramebuffers(1, &tex->framebuffer);
+    vt->DeleteTextures(1, &tex->texture);
+}
+
 void
 vlc_gl_filters_Delete(struct vlc_gl_filters *filters)
 {
     struct vlc_gl_filter_priv *priv;
     vlc_list_foreach(priv, &filters->list, node)
     {
+        if (priv->fusion)
+        {
+            DeleteFusion(filters, priv->fusion);
+            priv->fusion = NULL;
+        }
+
         struct vlc_gl_filter *filter = &priv->filter;
         vlc_gl_filter_Delete(filter);
     }
 
+    for (size_t i = 0; i < filters->textures.size; ++i)
+        DeleteTexture(filters, &filters->textures.data[i]);
+    vlc_vector_destroy(&filters->textures);
+
     vlc_gl_importer_Delete(filters->importer);
     free(filters);
 }
 
+void
+vlc_gl_filters_EnableFusion(struct vlc_gl_filters *filters, bool enable)
+{
+    filters->fusion = enable;
+}
+
 struct vlc_gl_filter *
 vlc_gl_filters_Append(struct vlc_gl_filters *filters, const char *name,
                       const config_chain_t *config)
@@ -288,6 +402,424 @@ vlc_gl_filters_Append(struct vlc_gl_filters *filters, const char *name,
     return filter;
 }
 
+static int
+InitTexture(struct vlc_gl_filters *filters, struct vlc_gl_filters_texture *tex,
+            GLsizei width, GLsizei height)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    vt->GenTextures(1, &tex->texture);
+    vt->GenFramebuffers(1, &tex->framebuffer);
+
+    vt->BindTexture(GL_TEXTURE_2D, tex->texture);
+    vt->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+                   GL_UNSIGNED_BYTE, NULL);
+    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    /* iOS needs GL_CLAMP_TO_EDGE or power-of-two textures */
+    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    vt->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    /* Attach the texture to the framebuffer */
+    vt->BindFramebuffer(GL_FRAMEBUFFER, tex->framebuffer);
+    vt->FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             GL_TEXTURE_2D, tex->texture, 0);
+
+    GLenum status = vt->CheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        DeleteTexture(filters, tex);
+        return VLC_EGENERIC;
+    }
+
+    tex->width = width;
+    tex->height = height;
+    return VLC_SUCCESS;
+}
+
+/* Get a texture for the output of the filter at the given index */
+static struct vlc_gl_filters_texture *
+AcquireTexture(struct vlc_gl_filters *filters, int index, GLsizei width,
+               GLsizei height)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    struct vlc_gl_filters_texture *tex = NULL;
+    for (size_t i = 0; i < filters->textures.size; ++i)
+    {
+        struct vlc_gl_filters_texture *candidate = &filters->textures.data[i];
+
+        /* Still written by the current filter, or read by it (written by the
+         * previous one) */
+        if (candidate->writer != -1 && candidate->writer >= index - 1)
+            continue;
+
+        if (candidate->width == width && candidate->height == height)
+        {
+            tex = candidate;
+            break;
+        }
+
+        if (!tex)
+            tex = candidate;
+    }
+
+    if (!tex)
+    {
+        struct vlc_gl_filters_texture new_tex;
+        if (InitTexture(filters, &new_tex, width, height) != VLC_SUCCESS)
+            return NULL;
+
+        if (!vlc_vector_push(&filters->textures, new_tex))
+        {
+            DeleteTexture(filters, &new_tex);
+            return NULL;
+        }
+        tex = &filters->textures.data[filters->textures.size - 1];
+    }
+    else if (tex->width != width || tex->height != height)
+    {
+        /* Reuse a texture of another size */
+        vt->BindTexture(GL_TEXTURE_2D, tex->texture);
+        vt->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+                       GL_UNSIGNED_BYTE, NULL);
+        tex->width = width;
+        tex->height = height;
+    }
+
+    tex->writer = index;
+    return tex;
+}
+
+/* (Re)assign the output textures of all the filters but the last one */
+static int
+AssignTextures(struct vlc_gl_filters *filters)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    /* Save the current bindings to restore them at the end */
+    GLint read_framebuffer;
+    GLint draw_framebuffer;
+    vt->GetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer);
+    vt->GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+
+    for (size_t i = 0; i < filters->textures.size; ++i)
+        filters->textures.data[i].writer = -1;
+
+    int ret = VLC_SUCCESS;
+    int index = 0;
+
+    struct vlc_gl_filter_priv *priv;
+    vlc_list_foreach(priv, &filters->list, node)
+    {
+        if (vlc_list_is_last(&priv->node, &filters->list))
+        {
+            /* The last filter draws to the default framebuffer */
+            priv->tex_count = 0;
+            break;
+        }
+
+        priv->tex_count = priv->plane_count;
+        for (unsigned i = 0; i < priv->tex_count; ++i)
+        {
+            struct vlc_gl_filters_texture *tex =
+                AcquireTexture(filters, index, priv->plane_widths[i],
+                               priv->plane_heights[i]);
+            if (!tex)
+            {
+                priv->tex_count = i;
+                ret = VLC_EGENERIC;
+                goto end;
+            }
+
+            priv->textures_out[i] = tex->texture;
+            priv->framebuffers_out[i] = tex->framebuffer;
+            priv->tex_widths[i] = tex->width;
+            priv->tex_heights[i] = tex->height;
+        }
+
+        ++index;
+    }
+
+    /* Release the textures not needed anymore */
+    for (size_t i = filters->textures.size; i-- > 0;)
+    {
+        if (filters->textures.data[i].writer == -1)
+        {
+            DeleteTexture(filters, &filters->textures.data[i]);
+            vlc_vector_remove(&filters->textures, i);
+        }
+    }
+
+end:
+    /* Restore bindings */
+    vt->BindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+    vt->BindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
+
+    return ret;
+}
+
+static bool
+IsPointwise(struct vlc_gl_filter_priv *priv)
+{
+    struct vlc_gl_filter *filter = &priv->filter;
+
+    /* Resizable filters are not pointwise */
+    return filter->ops->get_pointwise && !filter->ops->request_output_size;
+}
+
+static void
+FuseFilters(struct vlc_gl_filters *filters)
+{
+    struct vlc_gl_filter_priv *head = NULL;
+
+    struct vlc_gl_filter_priv *priv;
+    vlc_list_foreach(priv, &filters->list, node)
+    {
+        if (!IsPointwise(priv))
+        {
+            head = NULL;
+            continue;
+        }
+
+        /* A pointwise filter may not change the size or operate on planes */
+        assert(!priv->filter.config.filter_planes);
+
+        if (!head || !vlc_list_is_empty(&head->blend_subfilters))
+        {
+            /* Start a new sequence */
+            head = priv;
+            continue;
+        }
+
+        assert(priv->size_out.width == head->size_out.width
+            && priv->size_out.height == head->size_out.height);
+
+        vlc_list_remove(&priv->node);
+        vlc_list_append(&priv->node, &head->fused_subfilters);
+
+        /* Its blend subfilters now draw over the output of the fused pass */
+        struct vlc_gl_filter_priv *subfilter_priv;
+        vlc_list_foreach(subfilter_priv, &priv->blend_subfilters, node)
+        {
+            vlc_list_remove(&subfilter_priv->node);
+            vlc_list_append(&subfilter_priv->node, &head->blend_subfilters);
+        }
+    }
+}
+
+#define FUSION_PREFIX_SIZE sizeof("vlc_fused4294967295_")
+
+static void
+GetFusionPrefix(char prefix[static FUSION_PREFIX_SIZE], unsigned index)
+{
+    snprintf(prefix, FUSION_PREFIX_SIZE, "vlc_fused%u_", index);
+}
+
+static struct vlc_gl_fusion *
+NewFusion(struct vlc_gl_filters *filters, struct vlc_gl_filter_priv *head)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    unsigned count = 1;
+    struct vlc_gl_filter_priv *subfilter_priv;
+    vlc_list_foreach(subfilter_priv, &head->fused_subfilters, node)
+        ++count;
+
+    struct vlc_gl_fusion *fusion =
+        malloc(sizeof(*fusion) + count * sizeof(fusion->filters[0]));
+    if (!fusion)
+        return NULL;
+
+    fusion->count = 0;
+    fusion->filters[fusion->count++] = &head->filter;
+    vlc_list_foreach(subfilter_priv, &head->fused_subfilters, node)
+        fusion->filters[fusion->count++] = &subfilter_priv->filter;
+    assert(fusion->count == count);
+
+    fusion->sampler =
+        vlc_gl_sampler_New(filters->gl, filters->api, &head->glfmt_in, false);
+    if (!fusion->sampler)
+    {
+        free(fusion);
+        return NULL;
+    }
+
+    static const char *const VERTEX_SHADER_BODY =
+        "attribute vec2 vertex_pos;\n"
+        "attribute vec2 tex_coords_in;\n"
+        "varying vec2 tex_coords;\n"
+        "void main() {\n"
+        "  gl_Position = vec4(vertex_pos, 0.0, 1.0);\n"
+        "  tex_coords = tex_coords_in;\n"
+        "}\n";
+
+    const char *shader_version;
+    const char *shader_precision;
+    if (filters->api->is_gles)
+    {
+        shader_version = "#version 100\n";
+        shader_precision = "precision highp float;\n";
+    }
+    else
+    {
+        shader_version = "#version 120\n";
+        shader_precision = "";
+    }
+
+    struct vlc_gl_sampler *sampler = fusion->sampler;
+
+    struct vlc_memstream ms;
+    if (vlc_memstream_open(&ms))
+        goto error;
+
+    vlc_memstream_puts(&ms, shader_version);
+    if (sampler->shader.extensions)
+        vlc_memstream_puts(&ms, sampler->shader.extensions);
+    vlc_memstream_puts(&ms, shader_precision);
+    vlc_memstream_puts(&ms, sampler->shader.body);
+
+    char prefix[FUSION_PREFIX_SIZE];
+    for (unsigned i = 0; i < count; ++i)
+    {
+        struct vlc_gl_filter *filter = fusion->filters[i];
+
+        GetFusionPrefix(prefix, i);
+        char *code = filter->ops->get_pointwise(filter, prefix);
+        if (!code)
+        {
+            if (!vlc_memstream_close(&ms))
+                free(ms.ptr);
+            goto error;
+        }
+        vlc_memstream_puts(&ms, code);
+        free(code);
+    }
+
+    vlc_memstream_puts(&ms, "varying vec2 tex_coords;\n"
+                            "void main() {\n"
+                            "  vec4 color = vlc_texture(tex_coords);\n");
+    for (unsigned i = 0; i < count; ++i)
+    {
+        /* Clamp like the intermediate textures would */
+        GetFusionPrefix(prefix, i);
+        vlc_memstream_printf(&ms,
+                             "  color = clamp(%sfragment(color), 0.0, 1.0);\n",
+                             prefix);
+    }
+    vlc_memstream_puts(&ms, "  gl_FragColor = color;\n"
+                            "}\n");
+
+    if (vlc_memstream_close(&ms))
+        goto error;
+
+    const char *vertex_shader[] = {
+        shader_version,
+        VERTEX_SHADER_BODY,
+    };
+    const char *fragment_shader[] = {
+        ms.ptr,
+    };
+
+    GLuint program_id =
+        vlc_gl_BuildProgram(VLC_OBJECT(filters->gl), vt,
+                            ARRAY_SIZE(vertex_shader), vertex_shader,
+                            ARRAY_SIZE(fragment_shader), fragment_shader);
+    free(ms.ptr);
+    if (!program_id)
+        goto error;
+
+    fusion->program_id = program_id;
+
+    vlc_gl_sampler_FetchLocations(sampler, program_id);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        struct vlc_gl_filter *filter = fusion->filters[i];
+
+        GetFusionPrefix(prefix, i);
+        filter->ops->fetch_pointwise_locations(filter, program_id, prefix);
+    }
+
+    fusion->loc.vertex_pos = vt->GetAttribLocation(program_id, "vertex_pos");
+    assert(fusion->loc.vertex_pos != -1);
+
+    fusion->loc.tex_coords_in = vt->GetAttribLocation(program_id,
+                                                      "tex_coords_in");
+    assert(fusion->loc.tex_coords_in != -1);
+
+    vt->GenBuffers(1, &fusion->vbo);
+
+    msg_Dbg(filters->gl, "%u OpenGL filters fused in a single pass", count);
+
+    return fusion;
+
+error:
+    vlc_gl_sampler_Delete(fusion->sampler);
+    free(fusion);
+    return NULL;
+}
+
+static int
+DrawFusion(struct vlc_gl_filters *filters, struct vlc_gl_fusion *fusion,
+           const struct vlc_gl_picture *pic,
+           const struct vlc_gl_input_meta *meta)
+{
+    const opengl_vtable_t *vt = &filters->api->vt;
+
+    vt->UseProgram(fusion->program_id);
+
+    struct vlc_gl_sampler *sampler = fusion->sampler;
+    vlc_gl_sampler_Update(sampler, pic);
+    vlc_gl_sampler_Load(sampler);
+
+    for (unsigned i = 0; i < fusion->count; ++i)
+    {
+        struct vlc_gl_filter *filter = fusion->filters[i];
+        filter->ops->load_pointwise(filter, meta);
+    }
+
+    vt->BindBuffer(GL_ARRAY_BUFFER, fusion->vbo);
+
+    if (pic->mtx_has_changed)
+    {
+        float coords[] = {
+            0, 1,
+            0, 0,
+            1, 1,
+            1, 0,
+        };
+
+        /* Transform coordinates in place */
+        vlc_gl_picture_ToTexCoords(pic, 4, coords, coords);
+
+        const float data[] = {
+            -1,  1, coords[0], coords[1],
+            -1, -1, coords[2], coords[3],
+             1,  1, coords[4], coords[5],
+             1, -1, coords[6], coords[7],
+        };
+        vt->BufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
+    }
+
+    const GLsizei stride = 4 * sizeof(float);
+
+    vt->EnableVertexAttribArray(fusion->loc.vertex_pos);
+    vt->VertexAttribPointer(fusion->loc.vertex_pos, 2, GL_FLOAT, GL_FALSE,
+                            stride, (const void *) 0);
+
+    intptr_t offset = 2 * sizeof(float);
+    vt->EnableVertexAttribArray(fusion->loc.tex_coords_in);
+    vt->VertexAttribPointer(fusion->loc.tex_coords_in, 2, GL_FLOAT, GL_FALSE,
+                            stride, (const void *) offset);
+
+    vt->Clear(GL_COLOR_BUFFER_BIT);
+    vt->DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    return VLC_SUCCESS;
+}
+
 int
 vlc_gl_filters_InitFramebuffers(struct vlc_gl_filters *filters)
 {
@@ -302,6 +834,9 @@ vlc_gl_filters_InitFramebuffers(struct vlc_gl_filters *filters)
     vt->GetIntegerv(GL_RENDERBUFFER_BINDING, &renderbuffer);
     vt->GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
 
+    if (filters->fusion)
+        FuseFilters(filters);
+
     vlc_list_foreach(priv, &filters->list, node)
     {
         /* Compute the highest msaa_level among the filter and its subfilters */
@@ -345,15 +880,24 @@ vlc_gl_filters_InitFramebuffers(struct vlc_gl_filters *filters)
     {
         struct vlc_gl_filter *filter = &priv->filter;
 
-        bool is_last = vlc_list_is_last(&priv->node, &filters->list);
-        /* Every non-blend filter needs its own framebuffer, except the last
-         * one */
-        bool has_out = !is_last;
-        int ret = vlc_gl_filter_InitFramebuffers(filter, has_out);
+        int ret = vlc_gl_filter_InitFramebuffers(filter);
         if (ret != VLC_SUCCESS)
             return ret;
+
+        if (!vlc_list_is_empty(&priv->fused_subfilters))
+        {
+            priv->fusion = NewFusion(filters, priv);
+            if (!priv->fusion)
+                return VLC_EGENERIC;
+        }
     }
 
+    /* Every non-blend filter needs an output framebuffer, except the last
+     * one */
+    int ret = AssignTextures(filters);
+    if (ret != VLC_SUCCESS)
+        return ret;
+
     /* Restore bindings */
     vt->BindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
     vt->BindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
@@ -373,6 +917,7 @@ vlc_gl_filters_UpdatePicture(struct vlc_gl_filters *filters,
         return ret;
 
     filters->pic.pts = picture->date;
+    filters->pic.top_field_first = picture->b_top_field_first;
 
     struct vlc_ancillary *dovi = picture_GetAncillary(picture, VLC_ANCILLARY_ID_DOVI);
     filters->pic.has_dovi = !!dovi;
@@ -381,6 +926,14 @@ vlc_gl_filters_UpdatePicture(struct vlc_gl_filters *filters,
                sizeof(filters->pic.dovi_rpu));
     }
 
+    struct vlc_ancillary *hdr10plus =
+        picture_GetAncillary(picture, VLC_ANCILLARY_ID_HDR10PLUS);
+    filters->pic.has_hdr10plus = hdr10plus != NULL;
+    if (hdr10plus) {
+        memcpy(&filters->pic.hdr10plus, vlc_ancillary_GetData(hdr10plus),
+               sizeof(filters->pic.hdr10plus));
+    }
+
     struct vlc_gl_filter_priv *first_filter =
         vlc_list_first_entry_or_null(&filters->list, struct vlc_gl_filter_priv,
                                      node);
@@ -404,7 +957,10 @@ vlc_gl_filters_Draw(struct vlc_gl_filters *filters)
     struct vlc_gl_input_meta meta = {
         .pts = filters->pic.pts,
         .plane = 0,
+        .top_field_first = filters->pic.top_field_first,
         .dovi_rpu = filters->pic.has_dovi ? &filters->pic.dovi_rpu : NULL,
+        .hdr10plus = filters->pic.has_hdr10plus ? &filters->pic.hdr10plus
+                                                : NULL,
     };
 
     struct vlc_gl_picture direct_pic;
@@ -479,7 +1035,9 @@ vlc_gl_filters_Draw(struct vlc_gl_filters *filters)
                 vt->Viewport(0, 0, priv->tex_widths[0], priv->tex_heights[0]);
 
             meta.plane = 0;
-            int ret = filter->ops->draw(filter, pic, &meta);
+            int ret = priv->fusion
+                    ? DrawFusion(filters, priv->fusion, pic, &meta)
+                    : filter->ops->draw(filter, pic, &meta);
             if (ret != VLC_SUCCESS)
                 return ret;
 
@@ -558,7 +1116,7 @@ vlc_gl_filters_SetOutputSize(struct vlc_gl_filters *filters, unsigned width,
         /* The filter may have modified the requested size */
         priv->size_out = req;
 
-        /* Recreate the framebuffers/textures with the new size */
+        /* Update the planes and the MSAA framebuffer with the new size */
         vlc_gl_filter_ApplyOutputSize(filter);
 
         resized = true;
@@ -580,5 +1138,9 @@ vlc_gl_filters_SetOutputSize(struct vlc_gl_filters *filters, unsigned width,
         next = filter;
     }
 
-    return resized ? VLC_SUCCESS : VLC_EGENERIC;
+    if (!resized)
+        return VLC_EGENERIC;
+
+    /* Reassign the output textures with the new sizes */
+    return AssignTextures(filters);
 }
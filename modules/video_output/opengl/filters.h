@@ -67,6 +67,18 @@ struct vlc_gl_filter *
 vlc_gl_filters_Append(struct vlc_gl_filters *filters, const char *name,
                       const config_chain_t *config);
 
+/**
+ * Execute consecutive pointwise filters in a single rendering pass
+ *
+ * This function must be called before vlc_gl_filters_InitFramebuffers().
+ * Fusion is disabled by default.
+ *
+ * \param filters the filter chain
+ * \param enable true to enable fusion
+ */
+void
+vlc_gl_filters_EnableFusion(struct vlc_gl_filters *filters, bool enable);
+
 /**
  * Init the framebuffers for the appended filters.
  *
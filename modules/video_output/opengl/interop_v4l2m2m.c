@@ -0,0 +1,257 @@
+/*****************************************************************************
+ * interop_v4l2m2m.c: OpenGL V4L2 memory-to-memory DMA buffers interop
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <vlc_common.h>
+#include <vlc_window.h>
+#include <vlc_codec.h>
+#include <vlc_plugin.h>
+
+#include "gl_util.h"
+#include "interop.h"
+
+#include "../../codec/v4l2m2m.h"
+
+#define DRM_FORMAT_MOD_LINEAR 0ULL
+
+struct priv
+{
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES;
+
+    struct
+    {
+        EGLDisplay display;
+        EGLDisplay (*getCurrentDisplay)();
+        const char *(*queryString)(EGLDisplay, EGLint);
+        EGLImage (*createImageKHR)(EGLDisplay, EGLContext, EGLenum target, EGLClientBuffer buffer,
+                const EGLint *attrib_list);
+        void (*destroyImageKHR)(EGLDisplay, EGLImage image);
+    } egl;
+
+    struct
+    {
+        PFNGLBINDTEXTUREPROC BindTexture;
+    } gl;
+
+    EGLint drm_fourcc;
+};
+
+static int
+egl_update(const struct vlc_gl_interop *interop, uint32_t textures[],
+           const int32_t tex_width[], const int32_t tex_height[],
+           picture_t *pic, const size_t *plane_offset)
+{
+    (void) plane_offset;
+    struct priv *priv = interop->priv;
+    const struct v4l2m2m_pic_context *pctx = v4l2m2m_GetPicContext(pic);
+
+    int egl_color_space;
+    switch (interop->fmt_in.space)
+    {
+        case COLOR_SPACE_BT601:
+            egl_color_space = EGL_ITU_REC601_EXT;
+            break;
+        case COLOR_SPACE_BT2020:
+            egl_color_space = EGL_ITU_REC2020_EXT;
+            break;
+        default:
+            egl_color_space = EGL_ITU_REC709_EXT;
+            break;
+    }
+
+    int egl_color_range = interop->fmt_in.color_range == COLOR_RANGE_FULL
+                        ? EGL_YUV_FULL_RANGE_EXT : EGL_YUV_NARROW_RANGE_EXT;
+
+    static const EGLint plane_attrs[3][5] = {
+        { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT,
+          EGL_DMA_BUF_PLANE0_PITCH_EXT, EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT,
+          EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT },
+        { EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT,
+          EGL_DMA_BUF_PLANE1_PITCH_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT,
+          EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT },
+        { EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT,
+          EGL_DMA_BUF_PLANE2_PITCH_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT,
+          EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT },
+    };
+    EGLint attribs[6 + 3 * 10 + 5];
+    size_t n = 0;
+
+    attribs[n++] = EGL_WIDTH;
+    attribs[n++] = tex_width[0];
+    attribs[n++] = EGL_HEIGHT;
+    attribs[n++] = tex_height[0];
+    attribs[n++] = EGL_LINUX_DRM_FOURCC_EXT;
+    attribs[n++] = priv->drm_fourcc;
+
+    for (unsigned i = 0; i < pctx->planes && i < ARRAY_SIZE(plane_attrs); i++)
+    {
+        attribs[n++] = plane_attrs[i][0];
+        attribs[n++] = pctx->fds[i];
+        attribs[n++] = plane_attrs[i][1];
+        attribs[n++] = pctx->offsets[i];
+        attribs[n++] = plane_attrs[i][2];
+        attribs[n++] = pctx->pitches[i];
+        attribs[n++] = plane_attrs[i][3];
+        attribs[n++] = DRM_FORMAT_MOD_LINEAR & 0xffffffff;
+        attribs[n++] = plane_attrs[i][4];
+        attribs[n++] = (DRM_FORMAT_MOD_LINEAR >> 32) & 0xffffffff;
+    }
+
+    attribs[n++] = EGL_YUV_COLOR_SPACE_HINT_EXT;
+    attribs[n++] = egl_color_space;
+    attribs[n++] = EGL_SAMPLE_RANGE_HINT_EXT;
+    attribs[n++] = egl_color_range;
+    attribs[n++] = EGL_NONE;
+    assert(n <= ARRAY_SIZE(attribs));
+
+    EGLImageKHR egl_image = priv->egl.createImageKHR(priv->egl.display, EGL_NO_CONTEXT,
+                                                     EGL_LINUX_DMA_BUF_EXT, NULL,
+                                                     attribs);
+    if (egl_image == NULL)
+        return VLC_EGENERIC;
+
+    priv->gl.BindTexture(interop->tex_target, textures[0]);
+    priv->glEGLImageTargetTexture2DOES(interop->tex_target, egl_image);
+    priv->egl.destroyImageKHR(priv->egl.display, egl_image);
+    return VLC_SUCCESS;
+}
+
+static void
+Close(struct vlc_gl_interop *interop)
+{
+    struct priv *priv = interop->priv;
+
+    free(priv);
+}
+
+static int
+Open(vlc_object_t *obj)
+{
+    struct vlc_gl_interop *interop = (void *) obj;
+
+    if (interop->vctx == NULL
+     || vlc_video_context_GetType(interop->vctx) != VLC_VIDEO_CONTEXT_V4L2M2M
+     || interop->fmt_in.i_chroma != VLC_CODEC_V4L2M2M_OPAQUE)
+        return VLC_EGENERIC;
+
+    struct priv *priv = interop->priv = calloc(1, sizeof(struct priv));
+    if (unlikely(priv == NULL))
+        return VLC_ENOMEM;
+
+    switch (v4l2m2m_GetChroma(interop->vctx))
+    {
+        case VLC_CODEC_NV12:
+            priv->drm_fourcc = VLC_FOURCC('N', 'V', '1', '2');
+            break;
+        case VLC_CODEC_I420:
+            priv->drm_fourcc = VLC_FOURCC('Y', 'U', '1', '2');
+            break;
+        default:
+            goto error;
+    }
+
+    /* The planes are sampled together, as a single external texture */
+    interop->tex_count = 1;
+    interop->texs[0] = (struct vlc_gl_tex_cfg) {
+        .w = {1, 1},
+        .h = {1, 1},
+        .internal = GL_RGBA,
+        .format = GL_RGBA,
+        .type = GL_UNSIGNED_BYTE,
+    };
+
+    struct vlc_gl_extension_vt extension_vt;
+    vlc_gl_LoadExtensionFunctions(interop->gl, &extension_vt);
+
+    /* GL_OES_EGL_image_external is required for GL_TEXTURE_EXTERNAL_OES */
+    if (!vlc_gl_HasExtension(&extension_vt, "GL_OES_EGL_image_external"))
+        goto error;
+
+    priv->egl.getCurrentDisplay = vlc_gl_GetProcAddress(interop->gl, "eglGetCurrentDisplay");
+    if (priv->egl.getCurrentDisplay == NULL)
+        goto error;
+
+    priv->egl.display = priv->egl.getCurrentDisplay();
+    if (priv->egl.display == EGL_NO_DISPLAY)
+        goto error;
+
+    priv->egl.queryString = vlc_gl_GetProcAddress(interop->gl, "eglQueryString");
+    if (priv->egl.queryString == NULL)
+        goto error;
+
+    /* EGL_EXT_image_dma_buf_import implies EGL_KHR_image_base */
+    const char *eglexts = priv->egl.queryString(priv->egl.display, EGL_EXTENSIONS);
+    if (eglexts == NULL || !vlc_gl_StrHasToken(eglexts, "EGL_EXT_image_dma_buf_import"))
+        goto error;
+
+    priv->egl.createImageKHR =
+        vlc_gl_GetProcAddress(interop->gl, "eglCreateImageKHR");
+    if (priv->egl.createImageKHR == NULL)
+        goto error;
+
+    priv->egl.destroyImageKHR =
+        vlc_gl_GetProcAddress(interop->gl, "eglDestroyImageKHR");
+    if (priv->egl.destroyImageKHR == NULL)
+        goto error;
+
+    priv->glEGLImageTargetTexture2DOES =
+        vlc_gl_GetProcAddress(interop->gl, "glEGLImageTargetTexture2DOES");
+    if (priv->glEGLImageTargetTexture2DOES == NULL)
+        goto error;
+
+    priv->gl.BindTexture =
+        vlc_gl_GetProcAddress(interop->gl, "glBindTexture");
+    if (priv->gl.BindTexture == NULL)
+        goto error;
+
+    /* The pictures are uploaded upside-down */
+    video_format_TransformBy(&interop->fmt_out, TRANSFORM_VFLIP);
+
+    interop->tex_target = GL_TEXTURE_EXTERNAL_OES;
+    interop->fmt_out.i_chroma = VLC_CODEC_RGB32;
+    interop->fmt_out.space = COLOR_SPACE_UNDEF;
+
+    static const struct vlc_gl_interop_ops ops = {
+        .update_textures = egl_update,
+        .close = Close,
+    };
+    interop->ops = &ops;
+    return VLC_SUCCESS;
+
+error:
+    free(priv);
+    return VLC_EGENERIC;
+}
+
+vlc_module_begin ()
+    set_description("V4L2 M2M OpenGL surface converter")
+    set_capability("glinterop", 1)
+    set_callback(Open)
+    set_subcategory(SUBCAT_VIDEO_VOUT)
+    add_shortcut("v4l2m2m")
+vlc_module_end ()
@@ -705,8 +705,6 @@ static int
 Draw(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
      const struct vlc_gl_input_meta *meta)
 {
-    (void) meta;
-
     struct vlc_gl_renderer *renderer = filter->sys;
 
     const opengl_vtable_t *vt = renderer->vt;
@@ -717,6 +715,7 @@ Draw(struct vlc_gl_filter *filter, const struct vlc_gl_picture *pic,
 
     struct vlc_gl_sampler *sampler = renderer->sampler;
     vlc_gl_sampler_Update(sampler, pic);
+    vlc_gl_sampler_UpdateHdrMetadata(sampler, meta->hdr10plus);
     vlc_gl_sampler_Load(sampler);
 
     if (pic->mtx_has_changed)
@@ -53,12 +53,22 @@ struct vlc_gl_sampler_priv {
         GLint Textures[PICTURE_PLANE_MAX];
         GLint TexSizes[PICTURE_PLANE_MAX]; /* for GL_TEXTURE_RECTANGLE */
         GLint ConvMatrix;
+        GLint HdrPeak;
         GLint *pl_vars, *pl_descs; /* for pl_sh_res */
     } uloc;
 
     bool yuv_color;
     GLfloat conv_matrix[4*4];
 
+#ifndef HAVE_LIBPLACEBO_GL
+    /* Built-in HDR tone mapping */
+    struct {
+        bool enabled;
+        float static_peak; /* from the format, relative to the SDR white */
+        float peak; /* of the current picture */
+    } hdr;
+#endif
+
 #ifdef HAVE_LIBPLACEBO_GL
     /* libplacebo context */
     pl_log pl_log;
@@ -261,6 +271,11 @@ sampler_base_fetch_locations(struct vlc_gl_sampler *sampler, GLuint program)
         assert(priv->uloc.ConvMatrix != -1);
     }
 
+#ifndef HAVE_LIBPLACEBO_GL
+    if (priv->hdr.enabled)
+        priv->uloc.HdrPeak = vt->GetUniformLocation(program, "HdrPeak");
+#endif
+
     struct vlc_gl_format *glfmt = &sampler->glfmt;
 
     assert(glfmt->tex_count < 10); /* to guarantee variable names length */
@@ -307,6 +322,11 @@ sampler_base_load(struct vlc_gl_sampler *sampler)
         vt->UniformMatrix4fv(priv->uloc.ConvMatrix, 1, GL_FALSE,
                              priv->conv_matrix);
 
+#ifndef HAVE_LIBPLACEBO_GL
+    if (priv->hdr.enabled && priv->uloc.HdrPeak != -1)
+        vt->Uniform1f(priv->uloc.HdrPeak, priv->hdr.peak);
+#endif
+
     for (unsigned i = 0; i < glfmt->tex_count; ++i)
     {
         vt->Uniform1i(priv->uloc.Textures[i], i);
@@ -692,6 +712,137 @@ error:
 }
 #endif
 
+static unsigned
+GetFramebufferDepth(struct vlc_gl_sampler_priv *priv)
+{
+    GLint fb_depth = 0;
+#if !defined(USE_OPENGL_ES2)
+    const opengl_vtable_t *vt = priv->vt;
+    /* fetch framebuffer depth (we are already bound to the default one). */
+    if (vt->GetFramebufferAttachmentParameteriv != NULL)
+        vt->GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT,
+                                                GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE,
+                                                &fb_depth);
+#else
+    (void) priv;
+#endif
+    return fb_depth > 0 ? fb_depth : 8;
+}
+
+#ifndef HAVE_LIBPLACEBO_GL
+/* Reference white of SDR signals in HDR, in cd/m² (ITU-R BT.2408) */
+#define SDR_WHITE_NITS 203.f
+
+static float
+GetStaticPeak(const video_format_t *fmt)
+{
+    /* Nominal peak of the HLG reference display, and fallback for PQ */
+    float nits = 1000.f;
+
+    if (fmt->transfer == TRANSFER_FUNC_SMPTE_ST2084)
+    {
+        if (fmt->lighting.MaxCLL > 0)
+            nits = fmt->lighting.MaxCLL;
+        else if (fmt->mastering.max_luminance > 0)
+            nits = fmt->mastering.max_luminance / 10000.f;
+    }
+    return __MAX(nits / SDR_WHITE_NITS, 1.f);
+}
+
+/*
+ * Generate vlc_hdr_map(), converting HDR or wide gamut RGB to SDR BT.709 in a
+ * single pass: linearization, BT.2390 tone mapping of the brightest
+ * component, gamut mapping, BT.1886 encoding and dithering.
+ *
+ * Linear values are relative to the SDR reference white, and the signal
+ * peak is the HdrPeak uniform, so that it can follow dynamic metadata.
+ */
+static bool
+AddHdrMapping(struct vlc_gl_sampler_priv *priv, struct vlc_memstream *ms,
+              const video_format_t *fmt)
+{
+    const bool pq = fmt->transfer == TRANSFER_FUNC_SMPTE_ST2084;
+    const bool hlg = fmt->transfer == TRANSFER_FUNC_HLG;
+    const bool wide = fmt->primaries == COLOR_PRIMARIES_BT2020;
+
+    if (!pq && !hlg && !wide)
+        return false;
+
+#define ADD(x) vlc_memstream_puts(ms, x)
+#define ADDF(x, ...) vlc_memstream_printf(ms, x, ##__VA_ARGS__)
+
+    if (pq || hlg)
+        ADD("uniform float HdrPeak;\n"
+            "float vlc_pq_to_linear(float x) {\n"
+            " x = pow(max(x, 0.0), 1.0 / 78.84375);\n"
+            " x = max(x - 0.8359375, 0.0) / (18.8515625 - 18.6875 * x);\n"
+            " return pow(x, 1.0 / 0.1593017578125) * (10000.0 / 203.0);\n"
+            "}\n"
+            "float vlc_linear_to_pq(float x) {\n"
+            " x = pow(max(x, 0.0) * (203.0 / 10000.0), 0.1593017578125);\n"
+            " return pow((0.8359375 + 18.8515625 * x) / (1.0 + 18.6875 * x),\n"
+            "            78.84375);\n"
+            "}\n"
+            /* BT.2390 EETF, in the PQ domain, for an SDR peak at 1.0 */
+            "vec3 vlc_tone_map(vec3 c) {\n"
+            " float sig = max(max(c.r, c.g), c.b);\n"
+            " float peak_pq = vlc_linear_to_pq(HdrPeak);\n"
+            " float max_lum = vlc_linear_to_pq(1.0) / peak_pq;\n"
+            " float ks = 1.5 * max_lum - 0.5;\n"
+            " float e = min(vlc_linear_to_pq(sig) / peak_pq, 1.0);\n"
+            " if (e > ks) {\n"
+            "  float t = (e - ks) / (1.0 - ks);\n"
+            "  float t2 = t * t;\n"
+            "  float t3 = t2 * t;\n"
+            "  e = (2.0 * t3 - 3.0 * t2 + 1.0) * ks\n"
+            "    + (t3 - 2.0 * t2 + t) * (1.0 - ks)\n"
+            "    + (-2.0 * t3 + 3.0 * t2) * max_lum;\n"
+            " }\n"
+            " return c * (vlc_pq_to_linear(e * peak_pq) / max(sig, 1e-6));\n"
+            "}\n");
+
+    ADD("vec3 vlc_hdr_map(vec3 c) {\n");
+    if (pq)
+        ADD(" c = vec3(vlc_pq_to_linear(c.r), vlc_pq_to_linear(c.g),\n"
+            "          vlc_pq_to_linear(c.b));\n");
+    else if (hlg)
+        /* Inverse OETF, then OOTF of the 1000 cd/m² reference display */
+        ADD(" c = max(c, 0.0);\n"
+            " c = mix(c * c / 3.0,\n"
+            "         (exp((c - 0.55991073) / 0.17883277) + 0.28466892) / 12.0,\n"
+            "         step(0.5, c));\n"
+            " c *= pow(max(dot(c, vec3(0.2627, 0.6780, 0.0593)), 1e-6), 0.2)\n"
+            "      * (1000.0 / 203.0);\n");
+    else
+        ADD(" c = pow(max(c, 0.0), vec3(2.4));\n");
+
+    if (pq || hlg)
+        ADD(" c = vlc_tone_map(c);\n");
+
+    if (wide)
+        /* BT.2020 to BT.709 primaries, out of gamut colors are desaturated
+         * towards their luminance */
+        ADD(" c = vec3(dot(vec3( 1.6605, -0.5876, -0.0728), c),\n"
+            "          dot(vec3(-0.1246,  1.1329, -0.0083), c),\n"
+            "          dot(vec3(-0.0182, -0.1006,  1.1187), c));\n"
+            " float y = dot(vec3(0.2126, 0.7152, 0.0722), c);\n"
+            " float m = min(min(c.r, c.g), c.b);\n"
+            " if (m < 0.0 && y > 0.0)\n"
+            "  c = mix(vec3(y), c, y / (y - m));\n");
+
+    unsigned depth = GetFramebufferDepth(priv);
+    ADDF(" c = pow(clamp(c, 0.0, 1.0), vec3(1.0 / 2.4));\n"
+         " float noise = fract(sin(dot(gl_FragCoord.xy,\n"
+         "                             vec2(12.9898, 78.233))) * 43758.5453);\n"
+         " return c + (noise - 0.5) / %u.0;\n"
+         "}\n", (1u << depth) - 1);
+
+#undef ADD
+#undef ADDF
+    return true;
+}
+#endif
+
 static int
 opengl_fragment_shader_init(struct vlc_gl_sampler *sampler, bool expose_planes)
 {
@@ -781,20 +932,7 @@ opengl_fragment_shader_init(struct vlc_gl_sampler *sampler, bool expose_planes)
             if (override > 0)
                 out_bits = override;
             else
-            {
-                GLint fb_depth = 0;
-#if !defined(USE_OPENGL_ES2)
-                const opengl_vtable_t *vt = priv->vt;
-                /* fetch framebuffer depth (we are already bound to the default one). */
-                if (vt->GetFramebufferAttachmentParameteriv != NULL)
-                    vt->GetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT,
-                                                            GL_FRAMEBUFFER_ATTACHMENT_GREEN_SIZE,
-                                                            &fb_depth);
-#endif
-                if (fb_depth <= 0)
-                    fb_depth = 8;
-                out_bits = fb_depth;
-            }
+                out_bits = GetFramebufferDepth(priv);
 
             pl_shader_dither(sh, out_bits, &priv->dither_state, &(struct pl_dither_params) {
                 .method   = method,
@@ -833,12 +971,12 @@ opengl_fragment_shader_init(struct vlc_gl_sampler *sampler, bool expose_planes)
         ADD(res->glsl);
     }
 #else
-    if (fmt->transfer == TRANSFER_FUNC_SMPTE_ST2084 ||
-        fmt->primaries == COLOR_PRIMARIES_BT2020)
+    priv->hdr.enabled = AddHdrMapping(priv, &ms, fmt);
+    if (priv->hdr.enabled)
     {
-        // no warning for HLG because it's more or less backwards-compatible
-        msg_Warn(priv->gl, "VLC needs to be built with support for libplacebo "
-                 "in order to display wide gamut or HDR signals correctly.");
+        priv->hdr.static_peak = priv->hdr.peak = GetStaticPeak(fmt);
+        msg_Dbg(priv->gl, "mapping HDR/wide gamut to SDR (peak: %.0f cd/m²)",
+                priv->hdr.peak * SDR_WHITE_NITS);
     }
 #endif
 
@@ -897,6 +1035,9 @@ opengl_fragment_shader_init(struct vlc_gl_sampler *sampler, bool expose_planes)
             ADDF(" result = %s(result);\n", res->name);
         }
     }
+#else
+    if (priv->hdr.enabled)
+        ADD(" result.rgb = vlc_hdr_map(result.rgb);\n");
 #endif
 
     ADD(" return result;\n"
@@ -1040,6 +1181,29 @@ vlc_gl_sampler_Update(struct vlc_gl_sampler *sampler,
     return VLC_SUCCESS;
 }
 
+void
+vlc_gl_sampler_UpdateHdrMetadata(struct vlc_gl_sampler *sampler,
+                                 const vlc_video_hdr_dynamic_metadata_t *hdr10plus)
+{
+#ifndef HAVE_LIBPLACEBO_GL
+    struct vlc_gl_sampler_priv *priv = PRIV(sampler);
+    float peak = priv->hdr.static_peak;
+
+    if (hdr10plus != NULL
+     && sampler->glfmt.fmt.transfer == TRANSFER_FUNC_SMPTE_ST2084)
+    {
+        /* Brightest component of the scene, normalized to 10000 cd/m² */
+        float maxscl = __MAX(__MAX(hdr10plus->maxscl[0], hdr10plus->maxscl[1]),
+                             hdr10plus->maxscl[2]);
+        if (maxscl > 0.f)
+            peak = __MAX(maxscl * 10000.f / SDR_WHITE_NITS, 1.f);
+    }
+    priv->hdr.peak = peak;
+#else
+    (void) sampler; (void) hdr10plus;
+#endif
+}
+
 void
 vlc_gl_sampler_SelectPlane(struct vlc_gl_sampler *sampler, unsigned plane)
 {
@@ -183,6 +183,19 @@ int
 vlc_gl_sampler_Update(struct vlc_gl_sampler *sampler,
                       const struct vlc_gl_picture *picture);
 
+/**
+ * Update the HDR dynamic metadata of the input picture
+ *
+ * Without libplacebo, the built-in tone mapping adapts to the peak of the
+ * scene. Otherwise, this does nothing.
+ *
+ * \param sampler the sampler
+ * \param hdr10plus the metadata of the picture, NULL if it has none
+ */
+void
+vlc_gl_sampler_UpdateHdrMetadata(struct vlc_gl_sampler *sampler,
+                                 const vlc_video_hdr_dynamic_metadata_t *hdr10plus);
+
 /**
  * Select the plane to expose
  *
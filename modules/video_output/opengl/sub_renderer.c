@@ -55,6 +55,11 @@ typedef struct {
 
     float    tex_width;
     float    tex_height;
+
+    /* Picture and crop uploaded to the texture */
+    picture_t *picture;
+    unsigned x_offset;
+    unsigned y_offset;
 } gl_region_t;
 
 struct vlc_gl_sub_renderer
@@ -206,6 +211,8 @@ vlc_gl_sub_renderer_Delete(struct vlc_gl_sub_renderer *sr)
     {
         if (sr->regions[i].texture)
             sr->vt->DeleteTextures(1, &sr->regions[i].texture);
+        if (sr->regions[i].picture)
+            picture_Release(sr->regions[i].picture);
     }
     free(sr->regions);
 
@@ -257,6 +264,29 @@ vlc_gl_sub_renderer_Prepare(struct vlc_gl_sub_renderer *sr, subpicture_t *subpic
             glr->bottom = -2.0 * (r->i_y + r->fmt.i_visible_height) / subpicture->i_original_picture_height + 1.0;
 
             glr->texture = 0;
+            glr->picture = NULL;
+            glr->x_offset = r->fmt.i_x_offset;
+            glr->y_offset = r->fmt.i_y_offset;
+
+            /* The SPU core keeps rendering unchanged regions into the same
+               picture: reuse the texture as is if it was uploaded from the
+               same picture and crop by the previous call. */
+            for (int j = 0; j < last_count; j++) {
+                if (last[j].texture &&
+                    last[j].picture == r->p_picture &&
+                    last[j].x_offset == glr->x_offset &&
+                    last[j].y_offset == glr->y_offset &&
+                    last[j].width  == glr->width &&
+                    last[j].height == glr->height) {
+                    glr->texture = last[j].texture;
+                    glr->picture = last[j].picture;
+                    memset(&last[j], 0, sizeof(last[j]));
+                    break;
+                }
+            }
+            if (glr->picture != NULL)
+                continue;
+
             /* Try to recycle the textures allocated by the previous
                call to this function. */
             for (int j = 0; j < last_count; j++) {
@@ -264,6 +294,8 @@ vlc_gl_sub_renderer_Prepare(struct vlc_gl_sub_renderer *sr, subpicture_t *subpic
                     last[j].width  == glr->width &&
                     last[j].height == glr->height) {
                     glr->texture = last[j].texture;
+                    if (last[j].picture)
+                        picture_Release(last[j].picture);
                     memset(&last[j], 0, sizeof(last[j]));
                     break;
                 }
@@ -292,6 +324,7 @@ vlc_gl_sub_renderer_Prepare(struct vlc_gl_sub_renderer *sr, subpicture_t *subpic
                                                     r->p_picture, &pixels_offset);
             if (ret != VLC_SUCCESS)
                 break;
+            glr->picture = picture_Hold(r->p_picture);
         }
     }
     else
@@ -303,6 +336,8 @@ vlc_gl_sub_renderer_Prepare(struct vlc_gl_sub_renderer *sr, subpicture_t *subpic
     for (int i = 0; i < last_count; i++) {
         if (last[i].texture)
             vlc_gl_interop_DeleteTextures(interop, &last[i].texture);
+        if (last[i].picture)
+            picture_Release(last[i].picture);
     }
     free(last);
 
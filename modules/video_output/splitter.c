@@ -35,12 +35,28 @@
 #include <vlc_vout_display.h>
 #include <vlc_video_splitter.h>
 
+enum vlc_vidsplit_request {
+    VLC_VIDSPLIT_PREPARE,
+    VLC_VIDSPLIT_DISPLAY,
+    VLC_VIDSPLIT_STOP,
+};
+
 struct vlc_vidsplit_part {
     vlc_window_t *window;
     vout_display_t *display;
     vlc_sem_t lock;
     unsigned width;
     unsigned height;
+
+    /* Each display renders on its own thread, so that the outputs are not
+     * serialized behind each other. */
+    vlc_thread_t thread;
+    bool has_thread;
+    vlc_sem_t start;
+    vlc_sem_t done;
+    enum vlc_vidsplit_request request;
+    picture_t *picture;
+    vlc_tick_t date;
 };
 
 typedef struct vout_display_sys_t {
@@ -51,47 +67,105 @@ typedef struct vout_display_sys_t {
     struct vlc_vidsplit_part *parts;
 } vout_display_sys_t;
 
+static void vlc_vidsplit_Run(struct vlc_vidsplit_part *part)
+{
+    picture_t *pic = part->picture;
+
+    if (pic == NULL)
+        return;
+
+    switch (part->request) {
+        case VLC_VIDSPLIT_PREPARE:
+            if (part->display != NULL)
+                pic = vout_display_Prepare(part->display, pic, NULL,
+                                           part->date);
+            else {
+                picture_Release(pic);
+                pic = NULL;
+            }
+            break;
+        case VLC_VIDSPLIT_DISPLAY:
+            if (part->display != NULL)
+                vout_display_Display(part->display, pic);
+            picture_Release(pic);
+            pic = NULL;
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+    part->picture = pic;
+}
+
+static void *vlc_vidsplit_Thread(void *data)
+{
+    struct vlc_vidsplit_part *part = data;
+
+    vlc_thread_set_name("vlc-vidsplit");
+
+    for (;;) {
+        vlc_sem_wait(&part->start);
+        if (part->request == VLC_VIDSPLIT_STOP)
+            break;
+        vlc_vidsplit_Run(part);
+        vlc_sem_post(&part->done);
+    }
+    return NULL;
+}
+
+/* Runs a request on all the displays in parallel, and waits for them */
+static void vlc_vidsplit_Dispatch(vout_display_sys_t *sys,
+                                  enum vlc_vidsplit_request request)
+{
+    int n = sys->splitter.i_output;
+
+    for (int i = 0; i < n; i++) {
+        struct vlc_vidsplit_part *part = &sys->parts[i];
+
+        part->request = request;
+        if (part->has_thread)
+            vlc_sem_post(&part->start);
+        else
+            vlc_vidsplit_Run(part);
+    }
+
+    for (int i = 0; i < n; i++)
+        if (sys->parts[i].has_thread)
+            vlc_sem_wait(&sys->parts[i].done);
+}
+
 static void vlc_vidsplit_Prepare(vout_display_t *vd, picture_t *pic,
                                  subpicture_t *subpic, vlc_tick_t date)
 {
     vout_display_sys_t *sys = vd->sys;
+    int ret;
 
     picture_Hold(pic);
     (void) subpic;
 
     vlc_mutex_lock(&sys->lock);
-    if (video_splitter_Filter(&sys->splitter, sys->pictures, pic)) {
-        vlc_mutex_unlock(&sys->lock);
-
-        for (int i = 0; i < sys->splitter.i_output; i++)
-            sys->pictures[i] = NULL;
-        return;
-    }
+    ret = video_splitter_Filter(&sys->splitter, sys->pictures, pic);
     vlc_mutex_unlock(&sys->lock);
 
+    /* The parts are locked until displayed, even if the filter failed */
     for (int i = 0; i < sys->splitter.i_output; i++) {
         struct vlc_vidsplit_part *part = &sys->parts[i];
 
         vlc_sem_wait(&part->lock);
-        sys->pictures[i] = vout_display_Prepare(part->display,
-                                                sys->pictures[i], NULL, date);
+        part->picture = (ret == VLC_SUCCESS) ? sys->pictures[i] : NULL;
+        part->date = date;
     }
+
+    vlc_vidsplit_Dispatch(sys, VLC_VIDSPLIT_PREPARE);
 }
 
 static void vlc_vidsplit_Display(vout_display_t *vd, picture_t *picture)
 {
     vout_display_sys_t *sys = vd->sys;
 
-    for (int i = 0; i < sys->splitter.i_output; i++) {
-        struct vlc_vidsplit_part *part = &sys->parts[i];
+    vlc_vidsplit_Dispatch(sys, VLC_VIDSPLIT_DISPLAY);
 
-        if (sys->pictures[i] != NULL)
-        {
-            vout_display_Display(part->display, sys->pictures[i]);
-            picture_Release(sys->pictures[i]);
-        }
-        vlc_sem_post(&part->lock);
-    }
+    for (int i = 0; i < sys->splitter.i_output; i++)
+        vlc_sem_post(&sys->parts[i].lock);
 
     (void) picture;
 }
@@ -120,6 +194,12 @@ static void vlc_vidsplit_Close(vout_display_t *vd)
         struct vlc_vidsplit_part *part = &sys->parts[i];
         vout_display_t *display;
 
+        if (part->has_thread) {
+            part->request = VLC_VIDSPLIT_STOP;
+            vlc_sem_post(&part->start);
+            vlc_join(part->thread, NULL);
+        }
+
         vlc_sem_wait(&part->lock);
         display = part->display;
         part->display = NULL;
@@ -291,6 +371,10 @@ static int vlc_vidsplit_Open(vout_display_t *vd,
         struct vlc_vidsplit_part *part = &sys->parts[i];
 
         vlc_sem_init(&part->lock, 1);
+        vlc_sem_init(&part->start, 0);
+        vlc_sem_init(&part->done, 0);
+        part->has_thread = false;
+        part->picture = NULL;
         part->display = NULL;
         part->width = 1;
         part->height = 1;
@@ -321,6 +405,10 @@ static int vlc_vidsplit_Open(vout_display_t *vd,
 
         part->display = display;
         vlc_sem_post(&part->lock);
+
+        /* Without a thread, the display renders inline */
+        part->has_thread = vlc_clone(&part->thread, vlc_vidsplit_Thread,
+                                     part) == 0;
     }
 
     vd->ops = &ops;
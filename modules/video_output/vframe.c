@@ -0,0 +1,227 @@
+/*****************************************************************************
+ * vframe.c: decoded video frames output for LibVLC applications
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Unlike vmem, this output does not copy the pictures into application
+ * buffers: the decoded pictures themselves are handed over, held until the
+ * application releases them. Hardware pictures are handed over as their
+ * surfaces, if the platform has a way to share them.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_vout_display.h>
+#include <vlc_fs.h>
+#include "vframe.h"
+
+#ifdef HAVE_VAAPI
+# include <va/va_drmcommon.h>
+# include "../hw/vaapi/vlc_vaapi.h"
+# if VA_CHECK_VERSION(1, 1, 0)
+#  define HAVE_VAAPI_PRIME 1
+# endif
+#endif
+#ifdef _WIN32
+# define COBJMACROS
+# include "../video_chroma/d3d11_fmt.h"
+#endif
+#ifdef __APPLE__
+# include "../codec/vt_utils.h"
+#endif
+
+static int Open(vout_display_t *vd,
+                video_format_t *fmtp, vlc_video_context *context);
+
+vlc_module_begin()
+    set_description(N_("Video frames output"))
+    set_shortname(N_("Video frames"))
+
+    set_subcategory(SUBCAT_VIDEO_VOUT)
+
+    set_callback_display(Open, 0)
+vlc_module_end()
+
+typedef struct vout_display_sys_t {
+    vlc_vframe_cb cb;
+    void *opaque;
+    enum vlc_video_context_type type; /* 0 for CPU pictures */
+} vout_display_sys_t;
+
+#ifdef HAVE_VAAPI_PRIME
+/* Exports the surface as a single DMA buffer with all the planes */
+static bool ExportDmabuf(vout_display_t *vd, picture_t *pic,
+                         struct vlc_vframe_surface *surface)
+{
+    VADisplay dpy = vlc_vaapi_PicGetDisplay(pic);
+    VASurfaceID id = vlc_vaapi_PicGetSurface(pic);
+    VADRMPRIMESurfaceDescriptor desc;
+
+    if (vaSyncSurface(dpy, id) != VA_STATUS_SUCCESS
+     || vlc_vaapi_ExportSurfaceHandle(VLC_OBJECT(vd), dpy, id,
+                                      VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2,
+                                      VA_EXPORT_SURFACE_READ_ONLY
+                                      | VA_EXPORT_SURFACE_COMPOSED_LAYERS,
+                                      &desc))
+        return false;
+
+    if (desc.num_objects != 1) {
+        msg_Dbg(vd, "surface split in %"PRIu32" buffers", desc.num_objects);
+        for (unsigned i = 0; i < desc.num_objects; i++)
+            vlc_close(desc.objects[i].fd);
+        return false;
+    }
+
+    vlc_fourcc_t chroma = pic->format.i_chroma == VLC_CODEC_VAAPI_420_10BPP
+                        ? VLC_CODEC_P010 : VLC_CODEC_NV12;
+    const vlc_chroma_description_t *dsc =
+        vlc_fourcc_GetChromaDescription(chroma);
+
+    surface->type = VLC_VFRAME_SURFACE_DMABUF;
+    surface->chroma = chroma;
+    surface->fd = desc.objects[0].fd;
+    surface->planes = __MIN(desc.layers[0].num_planes, PICTURE_PLANE_MAX);
+    for (unsigned i = 0; i < surface->planes; i++) {
+        surface->offsets[i] = desc.layers[0].offset[i];
+        surface->pitches[i] = desc.layers[0].pitch[i];
+        surface->lines[i] = desc.height * dsc->p[i].h.num / dsc->p[i].h.den;
+    }
+    return true;
+}
+#endif
+
+static void Display(vout_display_t *vd, picture_t *pic)
+{
+    vout_display_sys_t *sys = vd->sys;
+    struct vlc_vframe_surface surface = {
+        .type = VLC_VFRAME_SURFACE_NONE,
+        .fd = -1,
+    };
+
+    switch (sys->type) {
+#ifdef HAVE_VAAPI_PRIME
+        case VLC_VIDEO_CONTEXT_VAAPI:
+            if (!ExportDmabuf(vd, pic, &surface))
+                return;
+            break;
+#endif
+#ifdef _WIN32
+        case VLC_VIDEO_CONTEXT_D3D11VA: {
+            picture_sys_d3d11_t *p_sys = ActiveD3D11PictureSys(pic);
+
+            surface.type = VLC_VFRAME_SURFACE_D3D11;
+            surface.handle = p_sys->texture[0];
+            surface.index = p_sys->slice_index;
+            break;
+        }
+#endif
+#ifdef __APPLE__
+        case VLC_VIDEO_CONTEXT_CVPX:
+            surface.type = VLC_VFRAME_SURFACE_CVPIXELBUFFER;
+            surface.handle = cvpxpic_get_ref(pic);
+            break;
+#endif
+        default:
+            assert(sys->type == 0);
+            break;
+    }
+
+    /* The application releases the picture whenever it is done with it */
+    sys->cb(sys->opaque, picture_Hold(pic), &surface);
+}
+
+static void Close(vout_display_t *vd)
+{
+    free(vd->sys);
+}
+
+static int Control(vout_display_t *vd, int query)
+{
+    (void) vd;
+
+    switch (query) {
+        case VOUT_DISPLAY_CHANGE_DISPLAY_SIZE:
+        case VOUT_DISPLAY_CHANGE_DISPLAY_FILLED:
+        case VOUT_DISPLAY_CHANGE_ZOOM:
+        case VOUT_DISPLAY_CHANGE_SOURCE_ASPECT:
+        case VOUT_DISPLAY_CHANGE_SOURCE_CROP:
+            return VLC_SUCCESS;
+    }
+    return VLC_EGENERIC;
+}
+
+static const struct vlc_display_operations ops = {
+    .close = Close,
+    .display = Display,
+    .control = Control,
+};
+
+static int Open(vout_display_t *vd,
+                video_format_t *fmtp, vlc_video_context *context)
+{
+    vlc_vframe_cb cb = var_InheritAddress(vd, "vframe-cb");
+    if (cb == NULL)
+        return VLC_EGENERIC;
+
+    enum vlc_video_context_type type = 0;
+
+    if (context != NULL) {
+        /* Only the surfaces that applications can import are handed over */
+        type = vlc_video_context_GetType(context);
+        switch (type) {
+#ifdef HAVE_VAAPI_PRIME
+            case VLC_VIDEO_CONTEXT_VAAPI:
+                if (fmtp->i_chroma != VLC_CODEC_VAAPI_420
+                 && fmtp->i_chroma != VLC_CODEC_VAAPI_420_10BPP)
+                    return VLC_EGENERIC;
+                break;
+#endif
+#ifdef _WIN32
+            case VLC_VIDEO_CONTEXT_D3D11VA:
+                break;
+#endif
+#ifdef __APPLE__
+            case VLC_VIDEO_CONTEXT_CVPX:
+                break;
+#endif
+            default:
+                return VLC_EGENERIC;
+        }
+    }
+
+    vout_display_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    sys->cb = cb;
+    sys->opaque = var_InheritAddress(vd, "vframe-data");
+    sys->type = type;
+
+    /* The pictures are handed over as decoded, so the format stays */
+    (void) fmtp;
+    vd->sys = sys;
+    vd->ops = &ops;
+    return VLC_SUCCESS;
+}
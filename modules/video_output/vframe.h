@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * vframe.h: decoded video frames output, shared with LibVLC
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_VFRAME_H
+#define VLC_VFRAME_H 1
+
+#include <vlc_picture.h>
+
+/* NOTE: the values must match libvlc_video_surface_type_t */
+enum vlc_vframe_surface_type
+{
+    VLC_VFRAME_SURFACE_NONE,
+    VLC_VFRAME_SURFACE_DMABUF,
+    VLC_VFRAME_SURFACE_D3D11,
+    VLC_VFRAME_SURFACE_CVPIXELBUFFER,
+};
+
+/**
+ * Hardware surface of a frame.
+ *
+ * For CPU pictures, the type is VLC_VFRAME_SURFACE_NONE and the planes are
+ * those of the picture.
+ */
+struct vlc_vframe_surface
+{
+    enum vlc_vframe_surface_type type;
+    vlc_fourcc_t chroma; /**< Chroma of the DMA buffer, 0 for others */
+    void *handle; /**< Texture or pixel buffer, valid while the picture is */
+    unsigned index; /**< Array slice of the texture */
+    int fd; /**< DMA buffer owned by the frame, or -1 */
+    unsigned planes;
+    size_t offsets[PICTURE_PLANE_MAX]; /**< Planes within the DMA buffer */
+    unsigned pitches[PICTURE_PLANE_MAX];
+    unsigned lines[PICTURE_PLANE_MAX];
+};
+
+/**
+ * Frame callback ("vframe-cb" variable).
+ *
+ * The callee takes over the picture reference and the DMA buffer.
+ */
+typedef void (*vlc_vframe_cb)(void *opaque, picture_t *pic,
+                              const struct vlc_vframe_surface *surface);
+
+#endif
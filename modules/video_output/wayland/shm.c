@@ -29,12 +29,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <time.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #include <wayland-client.h>
 #include "viewporter-client-protocol.h"
+#include "presentation-time-client-protocol.h"
 #include "registry.h"
 
 #include <vlc_common.h>
@@ -51,8 +53,19 @@ typedef struct vout_display_sys_t
     struct wl_shm *shm;
     struct wp_viewporter *viewporter;
     struct wp_viewport *viewport;
+    struct wp_presentation *presentation;
+    bool presentation_monotonic;
 
     size_t active_buffers;
+    size_t active_feedbacks;
+
+    /* Buffers prepared and not attached yet */
+    struct {
+        picture_t *picture;
+        struct wl_buffer *buffer;
+    } queue[MAX_PICTURES];
+    size_t queue_first;
+    size_t queue_count;
 } vout_display_sys_t;
 
 struct buffer_data
@@ -84,8 +97,6 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
 {
     VLC_UNUSED(date);
     vout_display_sys_t *sys = vd->sys;
-    struct wl_display *display = sys->embed->display.wl;
-    struct wl_surface *surface = sys->embed->handle.wl;
     struct picture_buffer_t *picbuf = pic->p_sys;
 
     if (picbuf->fd == -1)
@@ -128,25 +139,96 @@ static void Prepare(vout_display_t *vd, picture_t *pic, subpicture_t *subpic,
     picture_Hold(pic);
 
     wl_buffer_add_listener(buf, &buffer_cbs, d);
-    wl_surface_attach(surface, buf, 0, 0);
-    wl_surface_damage(surface, 0, 0, vd->cfg->display.width, vd->cfg->display.height);
-    wl_display_flush(display);
+
+    assert(sys->queue_count < MAX_PICTURES);
+    size_t last = (sys->queue_first + sys->queue_count) % MAX_PICTURES;
+    sys->queue[last].picture = pic;
+    sys->queue[last].buffer = buf;
+    sys->queue_count++;
 
     sys->active_buffers++;
 
     (void) subpic;
 }
 
+static void feedback_sync_output_cb(void *data,
+                                    struct wp_presentation_feedback *feedback,
+                                    struct wl_output *output)
+{
+    (void) data; (void) feedback; (void) output;
+}
+
+static void feedback_presented_cb(void *data,
+                                  struct wp_presentation_feedback *feedback,
+                                  uint32_t tv_sec_hi, uint32_t tv_sec_lo,
+                                  uint32_t tv_nsec, uint32_t refresh,
+                                  uint32_t seq_hi, uint32_t seq_lo,
+                                  uint32_t flags)
+{
+    vout_display_t *vd = data;
+    vout_display_sys_t *sys = vd->sys;
+
+    if (sys->presentation_monotonic)
+    {
+        uint64_t sec = ((uint64_t)tv_sec_hi << 32) | tv_sec_lo;
+
+        vout_display_SendEventPresented(vd,
+            vlc_tick_from_sec(sec) + VLC_TICK_FROM_NS(tv_nsec),
+            VLC_TICK_FROM_NS(refresh));
+    }
+
+    wp_presentation_feedback_destroy(feedback);
+    sys->active_feedbacks--;
+    (void) seq_hi; (void) seq_lo; (void) flags;
+}
+
+static void feedback_discarded_cb(void *data,
+                                  struct wp_presentation_feedback *feedback)
+{
+    vout_display_t *vd = data;
+    vout_display_sys_t *sys = vd->sys;
+
+    wp_presentation_feedback_destroy(feedback);
+    sys->active_feedbacks--;
+}
+
+static const struct wp_presentation_feedback_listener feedback_cbs =
+{
+    feedback_sync_output_cb,
+    feedback_presented_cb,
+    feedback_discarded_cb,
+};
+
 static void Display(vout_display_t *vd, picture_t *pic)
 {
     vout_display_sys_t *sys = vd->sys;
     struct wl_display *display = sys->embed->display.wl;
     struct wl_surface *surface = sys->embed->handle.wl;
 
+    if (sys->queue_count == 0 || sys->queue[sys->queue_first].picture != pic)
+        return; /* Prepare failed */
+
+    struct wl_buffer *buf = sys->queue[sys->queue_first].buffer;
+    sys->queue_first = (sys->queue_first + 1) % MAX_PICTURES;
+    sys->queue_count--;
+
+    wl_surface_attach(surface, buf, 0, 0);
+    wl_surface_damage(surface, 0, 0, vd->cfg->display.width, vd->cfg->display.height);
+
+    if (sys->presentation != NULL)
+    {
+        struct wp_presentation_feedback *feedback =
+            wp_presentation_feedback(sys->presentation, surface);
+
+        if (likely(feedback != NULL))
+        {
+            wp_presentation_feedback_add_listener(feedback, &feedback_cbs, vd);
+            sys->active_feedbacks++;
+        }
+    }
+
     wl_surface_commit(surface);
     wl_display_roundtrip_queue(display, sys->eventq);
-
-    (void) pic;
 }
 
 static int ResetPictures(vout_display_t *vd, video_format_t *fmt)
@@ -231,6 +313,23 @@ static const struct wl_shm_listener shm_cbs =
     shm_format_cb,
 };
 
+static void presentation_clock_id_cb(void *data,
+                                     struct wp_presentation *presentation,
+                                     uint32_t clk_id)
+{
+    vout_display_t *vd = data;
+    vout_display_sys_t *sys = vd->sys;
+
+    /* The flip dates are only usable in the VLC clock */
+    sys->presentation_monotonic = clk_id == CLOCK_MONOTONIC;
+    (void) presentation;
+}
+
+static const struct wp_presentation_listener presentation_cbs =
+{
+    presentation_clock_id_cb,
+};
+
 static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
@@ -241,7 +340,7 @@ static void Close(vout_display_t *vd)
     wl_surface_commit(surface);
 
     /* Wait until all picture buffers are released by the server */
-    while (sys->active_buffers > 0) {
+    while (sys->active_buffers > 0 || sys->active_feedbacks > 0) {
         msg_Dbg(vd, "%zu buffer(s) still active", sys->active_buffers);
         wl_display_roundtrip_queue(display, sys->eventq);
     }
@@ -251,6 +350,8 @@ static void Close(vout_display_t *vd)
         wp_viewport_destroy(sys->viewport);
     if (sys->viewporter != NULL)
         wp_viewporter_destroy(sys->viewporter);
+    if (sys->presentation != NULL)
+        wp_presentation_destroy(sys->presentation);
     wl_shm_destroy(sys->shm);
     wl_display_flush(display);
     wl_event_queue_destroy(sys->eventq);
@@ -279,7 +380,12 @@ static int Open(vout_display_t *vd,
     sys->embed = NULL;
     sys->eventq = NULL;
     sys->shm = NULL;
+    sys->presentation = NULL;
+    sys->presentation_monotonic = false;
     sys->active_buffers = 0;
+    sys->active_feedbacks = 0;
+    sys->queue_first = 0;
+    sys->queue_count = 0;
 
     /* Get window */
     sys->embed = vd->cfg->window;
@@ -304,6 +410,12 @@ static int Open(vout_display_t *vd,
                       vlc_wl_interface_bind(registry, "wp_viewporter",
                                             &wp_viewporter_interface, NULL);
 
+    sys->presentation = (struct wp_presentation *)
+                        vlc_wl_interface_bind(registry, "wp_presentation",
+                                              &wp_presentation_interface, NULL);
+    if (sys->presentation != NULL)
+        wp_presentation_add_listener(sys->presentation, &presentation_cbs, vd);
+
     wl_shm_add_listener(sys->shm, &shm_cbs, vd);
     wl_display_roundtrip_queue(display, sys->eventq);
 
@@ -338,6 +450,7 @@ static int Open(vout_display_t *vd,
 
     fmtp->i_chroma = VLC_CODEC_RGB32;
 
+    vd->info.queue_depth = 2;
     vd->ops = &ops;
 
     vlc_wl_registry_destroy(registry);
@@ -179,16 +179,11 @@ static void Close( vlc_object_t *p_this )
 static int Filter( video_splitter_t *p_splitter,
                    picture_t *pp_dst[], picture_t *p_src )
 {
-    if( video_splitter_NewPicture( p_splitter, pp_dst ) )
-    {
-        picture_Release( p_src );
-        return VLC_EGENERIC;
-    }
-
-    for( int i = 0; i < p_splitter->i_output; i++ )
-        picture_Copy( pp_dst[i], p_src );
+    /* The outputs share the source picture, which none of them modifies */
+    for( int i = 1; i < p_splitter->i_output; i++ )
+        pp_dst[i] = picture_Hold( p_src );
+    pp_dst[0] = p_src;
 
-    picture_Release( p_src );
     return VLC_SUCCESS;
 }
 
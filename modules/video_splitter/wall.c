@@ -216,11 +216,12 @@ static int Open( vlc_object_t *p_this )
 
             video_splitter_output_t *p_cfg = &p_splitter->p_output[p_output->i_output];
 
+            /* The outputs are crop windows of the source picture */
             video_format_Copy( &p_cfg->fmt, &p_splitter->fmt );
-            p_cfg->fmt.i_visible_width  =
-            p_cfg->fmt.i_width          = p_output->i_width;
-            p_cfg->fmt.i_visible_height =
-            p_cfg->fmt.i_height         = p_output->i_height;
+            p_cfg->fmt.i_x_offset       += p_output->i_left;
+            p_cfg->fmt.i_y_offset       += p_output->i_top;
+            p_cfg->fmt.i_visible_width   = p_output->i_width;
+            p_cfg->fmt.i_visible_height  = p_output->i_height;
             p_cfg->fmt.i_sar_num        = p_splitter->fmt.i_sar_num;
             p_cfg->fmt.i_sar_den        = p_splitter->fmt.i_sar_den;
             p_cfg->psz_module = NULL;
@@ -250,12 +251,7 @@ static int Filter( video_splitter_t *p_splitter, picture_t *pp_dst[], picture_t
 {
     video_splitter_sys_t *p_sys = p_splitter->p_sys;
 
-    if( video_splitter_NewPicture( p_splitter, pp_dst ) )
-    {
-        picture_Release( p_src );
-        return VLC_EGENERIC;
-    }
-
+    /* Each output references the source pixels, only the crop differs */
     for( int y = 0; y < p_sys->i_row; y++ )
     {
         for( int x = 0; x < p_sys->i_col; x++ )
@@ -264,22 +260,24 @@ static int Filter( video_splitter_t *p_splitter, picture_t *pp_dst[], picture_t
             if( !p_output->b_active )
                 continue;
 
-            picture_t *p_dst = pp_dst[p_output->i_output];
-
-            /* */
-            for( int i = 0; i < p_src->i_planes; i++ )
+            picture_t *p_dst = picture_Clone( p_src );
+            if( p_dst == NULL )
             {
-                const plane_t *p0 = p_src->p;
-                plane_t p = p_src->p[i];
-                const int i_y = p_output->i_top  * p.i_visible_pitch
-                                                   / p0->i_visible_pitch;
-                const int i_x = p_output->i_left * p.i_visible_lines
-                                                   / p0->i_visible_lines;
-
-                p.p_pixels += i_y * p.i_pitch + i_x * p.i_pixel_pitch;
-                plane_CopyPixels(p_dst->p + i, &p);
+                for( int i = 0; i < p_output->i_output; i++ )
+                    picture_Release( pp_dst[i] );
+                picture_Release( p_src );
+                return VLC_EGENERIC;
             }
-            picture_CopyProperties(p_dst, p_src);
+
+            const video_format_t *p_fmt =
+                &p_splitter->p_output[p_output->i_output].fmt;
+            p_dst->format.i_x_offset       = p_fmt->i_x_offset;
+            p_dst->format.i_y_offset       = p_fmt->i_y_offset;
+            p_dst->format.i_visible_width  = p_fmt->i_visible_width;
+            p_dst->format.i_visible_height = p_fmt->i_visible_height;
+            picture_CopyProperties( p_dst, p_src );
+
+            pp_dst[p_output->i_output] = p_dst;
         }
     }
 
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * analysis.c : Shared spectrum analysis of the visualizations
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <math.h>
+
+#include "analysis.h"
+
+int visual_analysis_Init( visual_analysis_t *p_analysis, vlc_object_t *p_obj,
+                          unsigned i_channels )
+{
+    window_param wind_param;
+
+    assert( i_channels > 0 && i_channels <= AOUT_CHAN_MAX );
+
+    /* The FFT and window tables only depend on the configuration */
+    p_analysis->p_fft = visual_fft_init();
+    if( p_analysis->p_fft == NULL )
+    {
+        msg_Err( p_obj, "unable to initialize FFT transform" );
+        return VLC_ENOMEM;
+    }
+
+    window_get_param( p_obj, &wind_param );
+    p_analysis->wind_ctx = (window_context){ NULL, 0 };
+    if( !window_init( FFT_BUFFER_SIZE, &wind_param, &p_analysis->wind_ctx ) )
+    {
+        msg_Err( p_obj, "unable to initialize FFT window" );
+        fft_close( p_analysis->p_fft );
+        return VLC_ENOMEM;
+    }
+
+    p_analysis->i_channels = i_channels;
+    p_analysis->p_block = NULL;
+    return VLC_SUCCESS;
+}
+
+void visual_analysis_Clean( visual_analysis_t *p_analysis )
+{
+    window_close( &p_analysis->wind_ctx );
+    fft_close( p_analysis->p_fft );
+}
+
+void visual_analysis_SetBlock( visual_analysis_t *p_analysis,
+                               const block_t *p_block )
+{
+    p_analysis->p_block = p_block;
+    p_analysis->b_spectrum = false;
+    p_analysis->b_peaks = false;
+}
+
+/* Converts a sample to int16_t, pasted from float32tos16.c */
+static inline int16_t ToS16( float f )
+{
+    union { float f; int32_t i; } u;
+
+    u.f = f + 384.f;
+    if( u.i > 0x43c07fff )
+        return 32767;
+    if( u.i < 0x43bf8000 )
+        return -32768;
+    return u.i - 0x43c00000;
+}
+
+static void ComputeSpectrum( visual_analysis_t *p_analysis )
+{
+    const block_t *p_block = p_analysis->p_block;
+    const float *p_samples = (const float *)p_block->p_buffer;
+    const unsigned i_channels = p_analysis->i_channels;
+    float *p_output = p_analysis->p_power;
+    int16_t p_buffer1[FFT_BUFFER_SIZE];   /* Buffer on which we perform
+                                             the FFT (first channel) */
+
+    /* Only convert the samples of the first channel used by the FFT, the
+     * block is repeated if it is too short */
+    for( unsigned i = 0, j = 0; i < FFT_BUFFER_SIZE; i++ )
+    {
+        p_output[i] = 0;
+        p_buffer1[i] = ToS16( p_samples[j * i_channels] );
+        if( ++j == p_block->i_nb_samples )
+            j = 0;
+    }
+
+    window_scale_in_place( p_buffer1, &p_analysis->wind_ctx );
+    fft_perform( p_buffer1, p_output, p_analysis->p_fft );
+}
+
+const float *visual_analysis_GetSpectrum( visual_analysis_t *p_analysis )
+{
+    assert( p_analysis->p_block != NULL );
+
+    if( !p_analysis->b_spectrum )
+    {
+        if( p_analysis->p_block->i_nb_samples > 0 )
+            ComputeSpectrum( p_analysis );
+        else
+            memset( p_analysis->p_power, 0, sizeof( p_analysis->p_power ) );
+        p_analysis->b_spectrum = true;
+    }
+    return p_analysis->p_power;
+}
+
+static void ComputePeaks( visual_analysis_t *p_analysis )
+{
+    const block_t *p_block = p_analysis->p_block;
+    const float *p_sample = (const float *)p_block->p_buffer;
+    const unsigned i_channels = p_analysis->i_channels;
+    float *pf_peaks = p_analysis->pf_peaks;
+
+    for( unsigned c = 0; c < i_channels; c++ )
+        pf_peaks[c] = 0.f;
+
+    for( unsigned i = 0; i < p_block->i_nb_samples; i++ )
+    {
+        for( unsigned c = 0; c < i_channels; c++ )
+        {
+            float f = fabsf( p_sample[c] );
+            pf_peaks[c] = f > pf_peaks[c] ? f : pf_peaks[c];
+        }
+        p_sample += i_channels;
+    }
+}
+
+float visual_analysis_GetPeak( visual_analysis_t *p_analysis,
+                               unsigned i_channel )
+{
+    assert( p_analysis->p_block != NULL );
+    assert( i_channel < p_analysis->i_channels );
+
+    if( !p_analysis->b_peaks )
+    {
+        ComputePeaks( p_analysis );
+        p_analysis->b_peaks = true;
+    }
+    return p_analysis->pf_peaks[i_channel];
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * analysis.h : Shared spectrum analysis of the visualizations
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_VISUAL_ANALYSIS_H_
+#define VLC_VISUAL_ANALYSIS_H_
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_block.h>
+
+#include "fft.h"
+#include "window.h"
+
+/* Analysis of the current audio block, computed on demand and at most once
+ * per block, whatever the number of effects using it. It is meant to be used
+ * from the visualization thread, not from the audio output one. */
+typedef struct
+{
+    fft_state *p_fft;
+    window_context wind_ctx;
+    unsigned i_channels;
+
+    const block_t *p_block;
+    bool b_spectrum;
+    bool b_peaks;
+
+    /* Raw FFT result of the first channel */
+    float p_power[FFT_BUFFER_SIZE];
+    /* Peak absolute sample value of each channel */
+    float pf_peaks[AOUT_CHAN_MAX];
+} visual_analysis_t;
+
+int visual_analysis_Init( visual_analysis_t *, vlc_object_t *,
+                          unsigned i_channels );
+void visual_analysis_Clean( visual_analysis_t * );
+
+/* Sets the block to analyze (FL32 samples of i_channels channels). The block
+ * must stay valid until the next call. */
+void visual_analysis_SetBlock( visual_analysis_t *, const block_t * );
+
+/* Power spectrum of the first channel, windowed, as returned by
+ * fft_perform(): FFT_BUFFER_SIZE values, the ones above FFT_BUFFER_SIZE / 2
+ * being 0 */
+const float *visual_analysis_GetSpectrum( visual_analysis_t * );
+
+/* Peak absolute sample value of a channel */
+float visual_analysis_GetPeak( visual_analysis_t *, unsigned i_channel );
+
+#endif /* include-guard */
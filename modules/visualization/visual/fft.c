@@ -25,6 +25,10 @@
 #include <stdlib.h>
 #include "fft.h"
 
+#ifdef __SSE__
+# include <xmmintrin.h>
+#endif
+
 #include <math.h>
 #ifndef PI
  #ifdef M_PI
@@ -40,7 +44,8 @@
 static void fft_prepare(const sound_sample *input, float * re, float * im,
                         const unsigned int *bitReverse);
 static void fft_calculate(float * re, float * im,
-                          const float *costable, const float *sintable );
+                          const float *twiddle_real,
+                          const float *twiddle_imag);
 static void fft_output(const float *re, const float *im, float *output);
 static int reverseBits(unsigned int initial);
 
@@ -67,11 +72,16 @@ fft_state *visual_fft_init(void)
     {
         p_state->bitReverse[i] = reverseBits(i);
     }
-    for(i = 0; i < FFT_BUFFER_SIZE / 2; i++)
+    for(unsigned exchanges = 1; exchanges < FFT_BUFFER_SIZE; exchanges <<= 1)
     {
-        float j = 2 * PI * i / FFT_BUFFER_SIZE;
-        p_state->costable[i] = cos(j);
-        p_state->sintable[i] = sin(j);
+        unsigned factfact = FFT_BUFFER_SIZE / 2 / exchanges;
+
+        for(i = 0; i < exchanges; i++)
+        {
+            float j = 2 * PI * (i * factfact) / FFT_BUFFER_SIZE;
+            p_state->twiddle_real[exchanges - 1 + i] = cos(j);
+            p_state->twiddle_imag[exchanges - 1 + i] = sin(j);
+        }
     }
 
     return p_state;
@@ -91,7 +101,8 @@ void fft_perform(const sound_sample *input, float *output, fft_state *state) {
     fft_prepare(input, state->real, state->imag, state->bitReverse );
 
     /* Do the actual FFT */
-    fft_calculate(state->real, state->imag, state->costable, state->sintable);
+    fft_calculate(state->real, state->imag, state->twiddle_real,
+                  state->twiddle_imag);
 
     /* Convert the FFT output into intensities */
     fft_output(state->real, state->imag, output);
@@ -151,46 +162,55 @@ static void fft_output(const float * re, const float * im, float *output)
 /*
  * Actually perform the FFT
  */
-static void fft_calculate(float * re, float * im, const float *costable, const float *sintable )
+static void fft_calculate(float * re, float * im, const float *twiddle_real,
+                          const float *twiddle_imag)
 {
-    unsigned int i, j, k;
-    unsigned int exchanges;
-    float fact_real, fact_imag;
-    float tmp_real, tmp_imag;
-    unsigned int factfact;
-
-    /* Set up some variables to reduce calculation in the loops */
-    exchanges = 1;
-    factfact = FFT_BUFFER_SIZE / 2;
+    unsigned int exchanges, j, k;
 
     /* Loop through the divide and conquer steps */
-    for(i = FFT_BUFFER_SIZE_LOG; i != 0; i--) {
-        /* In this step, we have 2 ^ (i - 1) exchange groups, each with
-         * 2 ^ (FFT_BUFFER_SIZE_LOG - i) exchanges
+    for(exchanges = 1; exchanges < FFT_BUFFER_SIZE; exchanges <<= 1) {
+        /* In this step, we have FFT_BUFFER_SIZE / (2 * exchanges) exchange
+         * groups, each with exchanges exchanges. The factor of the j-th
+         * exchange of a group is such that factor ^ (exchanges) = -1
+         * So, real = cos(j * PI / exchanges),
+         *     imag = sin(j * PI / exchanges)
          */
-        /* Loop through the exchanges in a group */
-        for(j = 0; j != exchanges; j++) {
-            /* Work out factor for this exchange
-             * factor ^ (exchanges) = -1
-             * So, real = cos(j * PI / exchanges),
-             *     imag = sin(j * PI / exchanges)
-             */
-            fact_real = costable[j * factfact];
-            fact_imag = sintable[j * factfact];
-
-            /* Loop through all the exchange groups */
-            for(k = j; k < FFT_BUFFER_SIZE; k += exchanges << 1) {
-                int k1 = k + exchanges;
-                tmp_real = fact_real * re[k1] - fact_imag * im[k1];
-                tmp_imag = fact_real * im[k1] + fact_imag * re[k1];
-                re[k1] = re[k] - tmp_real;
-                im[k1] = im[k] - tmp_imag;
-                re[k]  += tmp_real;
-                im[k]  += tmp_imag;
+        const float *fact_real = &twiddle_real[exchanges - 1];
+        const float *fact_imag = &twiddle_imag[exchanges - 1];
+
+        /* Loop through all the exchange groups */
+        for(k = 0; k < FFT_BUFFER_SIZE; k += exchanges << 1) {
+            float *restrict re0 = &re[k];
+            float *restrict im0 = &im[k];
+            float *restrict re1 = &re[k + exchanges];
+            float *restrict im1 = &im[k + exchanges];
+
+            /* Loop through the exchanges of the group: the accesses are
+             * contiguous, so that they can be vectorized */
+            j = 0;
+#ifdef __SSE__
+            for(; j + 4 <= exchanges; j += 4) {
+                __m128 fr = _mm_loadu_ps(&fact_real[j]);
+                __m128 fi = _mm_loadu_ps(&fact_imag[j]);
+                __m128 r0 = _mm_loadu_ps(&re0[j]), i0 = _mm_loadu_ps(&im0[j]);
+                __m128 r1 = _mm_loadu_ps(&re1[j]), i1 = _mm_loadu_ps(&im1[j]);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(fr, r1), _mm_mul_ps(fi, i1));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(fr, i1), _mm_mul_ps(fi, r1));
+                _mm_storeu_ps(&re1[j], _mm_sub_ps(r0, tr));
+                _mm_storeu_ps(&im1[j], _mm_sub_ps(i0, ti));
+                _mm_storeu_ps(&re0[j], _mm_add_ps(r0, tr));
+                _mm_storeu_ps(&im0[j], _mm_add_ps(i0, ti));
+            }
+#endif
+            for(; j < exchanges; j++) {
+                float tmp_real = fact_real[j] * re1[j] - fact_imag[j] * im1[j];
+                float tmp_imag = fact_real[j] * im1[j] + fact_imag[j] * re1[j];
+                re1[j] = re0[j] - tmp_real;
+                im1[j] = im0[j] - tmp_imag;
+                re0[j] += tmp_real;
+                im0[j] += tmp_imag;
             }
         }
-        exchanges <<= 1;
-        factfact >>= 1;
     }
 }
 
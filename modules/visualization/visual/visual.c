@@ -181,6 +181,7 @@ typedef struct
     picture_pool_t  *pool;
     visual_effect_t **effect;
     int             i_effect;
+    visual_analysis_t analysis;
     bool            dead;
     vlc_thread_t    thread;
 } filter_sys_t;
@@ -206,6 +207,14 @@ static int Open( vlc_object_t *p_this )
         return VLC_EGENERIC;
     p_sys->pool = NULL;
 
+    const unsigned i_channels = aout_FormatNbChannels( &p_filter->fmt_in.audio );
+    if( visual_analysis_Init( &p_sys->analysis, VLC_OBJECT(p_filter),
+                              i_channels ) )
+    {
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
     int width = var_InheritInteger( p_filter , "effect-width");
     int height = var_InheritInteger( p_filter , "effect-height");
     /* No resolution under 400x532 and no odd dimension */
@@ -231,11 +240,12 @@ static int Open( vlc_object_t *p_this )
             break;
         p_effect->i_width     = width;
         p_effect->i_height    = height;
-        p_effect->i_nb_chans  = aout_FormatNbChannels( &p_filter->fmt_in.audio);
+        p_effect->i_nb_chans  = i_channels;
         p_effect->i_idx_left  = 0;
         p_effect->i_idx_right = __MIN( 1, p_effect->i_nb_chans-1 );
 
         p_effect->p_data   = NULL;
+        p_effect->p_analysis = &p_sys->analysis;
         p_effect->pf_run   = NULL;
 
         for( unsigned i = 0; i < effectc; i++ )
@@ -342,6 +352,7 @@ error:
     for( int i = 0; i < p_sys->i_effect; i++ )
         free( p_sys->effect[i] );
     free( p_sys->effect );
+    visual_analysis_Clean( &p_sys->analysis );
     free( p_sys );
     return VLC_EGENERIC;
 }
@@ -363,7 +374,9 @@ static block_t *DoRealWork( filter_t *p_filter, block_t *p_in_buf )
                 p_outpic->p[i].i_visible_lines * p_outpic->p[i].i_pitch );
     }
 
-    /* We can now call our visualization effects */
+    /* We can now call our visualization effects, the analysis of the
+     * block is computed once for all of them */
+    visual_analysis_SetBlock( &p_sys->analysis, p_in_buf );
     for( int i = 0; i < p_sys->i_effect; i++ )
     {
 #define p_effect p_sys->effect[i]
@@ -430,5 +443,6 @@ static void Close( filter_t * p_filter )
 
     picture_pool_Release(p_sys->pool);
     free( p_sys->effect );
+    visual_analysis_Clean( &p_sys->analysis );
     free( p_sys );
 }
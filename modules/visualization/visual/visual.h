@@ -20,6 +20,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
  *****************************************************************************/
 
+#include "analysis.h"
+
 typedef struct visual_effect_t visual_effect_t;
 typedef int (*visual_run_t)(visual_effect_t *, vlc_object_t *,
                             const block_t *, picture_t *);
@@ -30,6 +32,7 @@ struct visual_effect_t
     visual_run_t pf_run;
     visual_free_t pf_free;
     void *     p_data; /* The effect stores whatever it wants here */
+    visual_analysis_t *p_analysis; /* Shared analysis of the current block */
     int        i_width;
     int        i_height;
     int        i_nb_chans;
@@ -48,9 +48,23 @@ typedef struct
     vlc_mutex_t lock;
     module_t *module; /**< Output plugin (or NULL if inactive) */
     bool bitexact;
+    bool low_latency;
 
     vlc_aout_stream *main_stream;
 
+    /* Output left started by the last deleted stream, to be reused by the
+     * next stream of the same format (protected by lock) */
+    struct
+    {
+        bool started;
+        atomic_bool stale; /**< restart requested while idle */
+        int input_profile;
+        audio_sample_format_t input_format;
+        audio_sample_format_t filter_format;
+        audio_sample_format_t mixer_format;
+        aout_filters_cfg_t filters_cfg;
+    } idle;
+
     struct
     {
         vlc_mutex_t lock;
@@ -112,6 +126,17 @@ int aout_OutputNew(audio_output_t *aout, vlc_aout_stream *stream,
                    audio_sample_format_t *filter_fmt,
                    aout_filters_cfg_t *filters_cfg);
 void aout_OutputDelete( audio_output_t * p_aout );
+void aout_OutputKeepIdle(audio_output_t *aout, int input_profile,
+                         const audio_sample_format_t *fmt,
+                         const audio_sample_format_t *filter_fmt,
+                         const audio_sample_format_t *mixer_fmt,
+                         const aout_filters_cfg_t *filters_cfg);
+bool aout_OutputTakeIdle(audio_output_t *aout, vlc_aout_stream *stream,
+                         int input_profile, const audio_sample_format_t *fmt,
+                         audio_sample_format_t *filter_fmt,
+                         audio_sample_format_t *mixer_fmt,
+                         aout_filters_cfg_t *filters_cfg);
+void aout_OutputStopIdle(audio_output_t *aout);
 
 vlc_audio_meter_plugin *
 aout_AddMeterPlugin(audio_output_t *aout, const char *chain,
@@ -197,6 +222,7 @@ filter_t *aout_filter_Create(vlc_object_t *obj, const filter_owner_t *restrict o
                              const char *type, const char *name,
                              const audio_sample_format_t *infmt,
                              const audio_sample_format_t *outfmt,
+                             const audio_replay_gain_t *replay_gain,
                              config_chain_t *cfg, bool const_fmt);
 
 #endif /* !LIBVLC_AOUT_INTERNAL_H */
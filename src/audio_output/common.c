@@ -339,6 +339,11 @@ do { \
     }
 }
 
+/* Samples (per channel) processed at a time, so that the interleaved
+ * samples of many channels stay in the data cache while each plane is
+ * (de)interleaved. */
+#define AOUT_INTERLEAVE_BLOCK 256
+
 /**
  * Interleaves audio samples within a block of samples.
  * \param dst destination buffer for interleaved samples
@@ -355,11 +360,22 @@ void aout_Interleave( void *restrict dst, const void *const *srcv,
 #define INTERLEAVE_TYPE(type) \
 do { \
     type *d = dst; \
-    for( size_t i = 0; i < chans; i++ ) { \
-        const type *s = srcv[i]; \
-        for( size_t j = 0, k = 0; j < samples; j++, k += chans ) \
-            d[k] = *(s++); \
-        d++; \
+    if( chans == 2 ) { \
+        const type *l = srcv[0], *r = srcv[1]; \
+        for( size_t j = 0; j < samples; j++ ) { \
+            d[2 * j] = l[j]; \
+            d[2 * j + 1] = r[j]; \
+        } \
+        break; \
+    } \
+    for( size_t j0 = 0; j0 < samples; j0 += AOUT_INTERLEAVE_BLOCK ) { \
+        size_t n = __MIN( samples - j0, AOUT_INTERLEAVE_BLOCK ); \
+        for( size_t i = 0; i < chans; i++ ) { \
+            const type *s = (const type *)srcv[i] + j0; \
+            type *dc = d + j0 * chans + i; \
+            for( size_t j = 0, k = 0; j < n; j++, k += chans ) \
+                dc[k] = s[j]; \
+        } \
     } \
 } while(0)
 
@@ -392,10 +408,22 @@ void aout_Deinterleave( void *restrict dst, const void *restrict src,
 do { \
     type *d = dst; \
     const type *s = src; \
-    for( size_t i = 0; i < chans; i++ ) { \
-        for( size_t j = 0, k = 0; j < samples; j++, k += chans ) \
-            *(d++) = s[k]; \
-        s++; \
+    if( chans == 2 ) { \
+        type *r = d + samples; \
+        for( size_t j = 0; j < samples; j++ ) { \
+            d[j] = s[2 * j]; \
+            r[j] = s[2 * j + 1]; \
+        } \
+        break; \
+    } \
+    for( size_t j0 = 0; j0 < samples; j0 += AOUT_INTERLEAVE_BLOCK ) { \
+        size_t n = __MIN( samples - j0, AOUT_INTERLEAVE_BLOCK ); \
+        for( size_t i = 0; i < chans; i++ ) { \
+            const type *sc = s + j0 * chans + i; \
+            type *dc = d + i * samples + j0; \
+            for( size_t j = 0, k = 0; j < n; j++, k += chans ) \
+                dc[j] = sc[k]; \
+        } \
     } \
 } while(0)
 
@@ -45,6 +45,7 @@ struct vlc_aout_stream
     aout_volume_t *volume;
     aout_filters_t *filters;
     aout_filters_cfg_t filters_cfg;
+    audio_replay_gain_t replay_gain;
 
     atomic_bool drained;
     _Atomic vlc_tick_t drain_deadline;
@@ -58,6 +59,7 @@ struct vlc_aout_stream
         bool discontinuity;
         vlc_tick_t request_delay;
         vlc_tick_t delay;
+        bool offline; /**< Not synchronized to the system clock */
     } sync;
     vlc_tick_t original_pts;
 
@@ -96,6 +98,14 @@ struct vlc_aout_stream
     audio_sample_format_t mixer_format;
 
     atomic_uchar restart;
+    bool paused;
+
+    /* Fade-in of a stream reusing an idle output */
+    struct
+    {
+        unsigned position;
+        unsigned length;
+    } fade;
 
     atomic_uint buffers_lost;
     atomic_uint buffers_played;
@@ -256,8 +266,14 @@ vlc_aout_stream * vlc_aout_stream_New(audio_output_t *p_aout,
     stream->volume = NULL;
     if (!owner->bitexact)
         stream->volume = aout_volume_New (p_aout, cfg->replay_gain);
+    if (cfg->replay_gain != NULL)
+        stream->replay_gain = *cfg->replay_gain;
+    else
+        memset(&stream->replay_gain, 0, sizeof (stream->replay_gain));
 
     atomic_init(&stream->restart, 0);
+    stream->paused = false;
+    stream->fade.position = stream->fade.length = 0;
     stream->input_profile = cfg->profile;
     stream->filter_format = stream->mixer_format = stream->input_format = *p_format;
 
@@ -271,6 +287,7 @@ vlc_aout_stream * vlc_aout_stream_New(audio_output_t *p_aout,
 
     stream->sync.rate = 1.f;
     stream->sync.resamp_type = AOUT_RESAMPLING_NONE;
+    stream->sync.offline = var_InheritBool(p_aout, "offline");
     stream->sync.delay = stream->sync.request_delay = 0;
     stream_Discontinuity(stream);
 
@@ -283,8 +300,18 @@ vlc_aout_stream * vlc_aout_stream_New(audio_output_t *p_aout,
 
     stream->filters = NULL;
     stream->filters_cfg = AOUT_FILTERS_CFG_INIT;
-    if (aout_OutputNew(p_aout, stream, &stream->mixer_format, stream->input_profile,
-                       &stream->filter_format, &stream->filters_cfg))
+    if (aout_OutputTakeIdle(p_aout, stream, stream->input_profile,
+                            &stream->input_format, &stream->filter_format,
+                            &stream->mixer_format, &stream->filters_cfg))
+    {
+        vlc_tick_t fade = VLC_TICK_FROM_MS(
+            var_InheritInteger(p_aout, "audio-transition-fade"));
+        stream->fade.length = samples_from_vlc_tick(fade,
+                                                    stream->mixer_format.i_rate);
+    }
+    else if (aout_OutputNew(p_aout, stream, &stream->mixer_format,
+                            stream->input_profile, &stream->filter_format,
+                            &stream->filters_cfg))
         goto error;
 
     vlc_audio_meter_Reset(&owner->meter, &stream->mixer_format);
@@ -295,6 +322,7 @@ vlc_aout_stream * vlc_aout_stream_New(audio_output_t *p_aout,
             aout_volume_SetFormat(stream->volume, stream->mixer_format.i_format);
 
         /* Create the audio filtering "input" pipeline */
+        stream->filters_cfg.replay_gain = stream->replay_gain;
         stream->filters = aout_FiltersNewWithClock(VLC_OBJECT(p_aout), cfg->clock,
                                                    &stream->filter_format,
                                                    &stream->mixer_format,
@@ -315,8 +343,20 @@ error:
     return stream;
 }
 
+/* Whether the output can be left started for the next stream */
+static bool stream_CanKeepOutput(vlc_aout_stream *stream)
+{
+    aout_owner_t *owner = aout_stream_owner(stream);
+
+    return !owner->bitexact && !stream->paused
+        && AOUT_FMT_LINEAR(&stream->mixer_format)
+        && atomic_load_explicit(&stream->restart, memory_order_relaxed) == 0;
+}
+
 /**
  * Stops all plugins involved in the audio output.
+ *
+ * A linear output is only flushed, and kept started for the next stream.
  */
 void vlc_aout_stream_Delete (vlc_aout_stream *stream)
 {
@@ -329,7 +369,12 @@ void vlc_aout_stream_Delete (vlc_aout_stream *stream)
         vlc_audio_meter_Reset(&owner->meter, NULL);
         if (stream->filters)
             aout_FiltersDelete (aout, stream->filters);
-        aout_OutputDelete (aout);
+        if (stream_CanKeepOutput(stream))
+            aout_OutputKeepIdle(aout, stream->input_profile,
+                                &stream->input_format, &stream->filter_format,
+                                &stream->mixer_format, &stream->filters_cfg);
+        else
+            aout_OutputDelete (aout);
     }
     if (stream->volume != NULL)
         aout_volume_Delete(stream->volume);
@@ -387,6 +432,7 @@ static int stream_CheckReady (vlc_aout_stream *stream)
 
         if (stream->mixer_format.i_format && !owner->bitexact)
         {
+            stream->filters_cfg.replay_gain = stream->replay_gain;
             stream->filters = aout_FiltersNewWithClock(VLC_OBJECT(aout),
                                                        stream->sync.clock,
                                                        &stream->filter_format,
@@ -425,6 +471,39 @@ void vlc_aout_stream_RequestRestart(vlc_aout_stream *stream, unsigned mode)
  * Buffer management
  */
 
+static void stream_FadeIn(vlc_aout_stream *stream, block_t *block)
+{
+    const audio_sample_format_t *fmt = &stream->mixer_format;
+    const unsigned channels = fmt->i_channels;
+
+    for (size_t i = 0; i < block->i_nb_samples
+                    && stream->fade.position < stream->fade.length; i++)
+    {
+        float gain = (float) stream->fade.position++ / stream->fade.length;
+
+        switch (fmt->i_format)
+        {
+            case VLC_CODEC_FL32:
+            {
+                float *p = (float *) block->p_buffer + i * channels;
+                for (unsigned c = 0; c < channels; c++)
+                    p[c] *= gain;
+                break;
+            }
+            case VLC_CODEC_S16N:
+            {
+                int16_t *p = (int16_t *) block->p_buffer + i * channels;
+                for (unsigned c = 0; c < channels; c++)
+                    p[c] = lroundf(p[c] * gain);
+                break;
+            }
+            default:
+                stream->fade.position = stream->fade.length;
+                return;
+        }
+    }
+}
+
 static void stream_StopResampling(vlc_aout_stream *stream)
 {
     assert(stream->filters);
@@ -482,6 +561,14 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
      * late). */
     drift = -drift;
 
+    /* In low-latency mode, there is not enough buffering to absorb the EBU
+     * tolerances: resynchronize as soon as the drift exceeds half of the
+     * target output latency. */
+    const vlc_tick_t max_pts_delay = owner->low_latency
+        ? AOUT_LOW_LATENCY_TIME / 2 : AOUT_MAX_PTS_DELAY;
+    const vlc_tick_t max_pts_advance = owner->low_latency
+        ? AOUT_LOW_LATENCY_TIME / 2 : AOUT_MAX_PTS_ADVANCE;
+
     /* Late audio output.
      * This can happen due to insufficient caching, scheduling jitter
      * or bug in the decoder. Ideally, the output would seek backward. But that
@@ -489,7 +576,7 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
      * where supported. The other alternative is to flush the buffers
      * completely. */
     if (drift > (stream->sync.discontinuity ? 0
-                : lroundf(+3 * AOUT_MAX_PTS_DELAY / rate)))
+                : lroundf(+3 * max_pts_delay / rate)))
     {
         if (tracer != NULL)
             vlc_tracer_TraceEvent(tracer, "RENDER", stream->str_id, "late_flush");
@@ -509,7 +596,7 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
     /* Early audio output.
      * This is rare except at startup when the buffers are still empty. */
     if (drift < (stream->sync.discontinuity ? 0
-                : lroundf(-3 * AOUT_MAX_PTS_ADVANCE / rate)))
+                : lroundf(-3 * max_pts_advance / rate)))
     {
         if (!stream->sync.discontinuity)
         {
@@ -530,7 +617,7 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
         return;
 
     /* Resampling */
-    if (drift > +AOUT_MAX_PTS_DELAY
+    if (drift > +max_pts_delay
      && stream->sync.resamp_type != AOUT_RESAMPLING_UP)
     {
         if (tracer != NULL)
@@ -540,7 +627,7 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
         stream->sync.resamp_type = AOUT_RESAMPLING_UP;
         stream->sync.resamp_start_drift = +drift;
     }
-    if (drift < -AOUT_MAX_PTS_ADVANCE
+    if (drift < -max_pts_advance
      && stream->sync.resamp_type != AOUT_RESAMPLING_DOWN)
     {
         if (tracer != NULL)
@@ -748,6 +835,9 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
     if (stream->volume != NULL)
         aout_volume_Amplify(stream->volume, block);
 
+    if (stream->fade.position < stream->fade.length)
+        stream_FadeIn(stream, block);
+
     /* Update delay */
     if (stream->sync.request_delay != stream->sync.delay)
     {
@@ -761,7 +851,8 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
 
     /* Drift correction */
     vlc_tick_t system_now = vlc_tick_now();
-    stream_Synchronize(stream, system_now, original_pts);
+    if (!stream->sync.offline)
+        stream_Synchronize(stream, system_now, original_pts);
 
     vlc_tick_t play_date =
         vlc_clock_ConvertToSystem(stream->sync.clock, system_now, original_pts,
@@ -803,6 +894,15 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
     /* Output */
     stream->sync.discontinuity = false;
     stream->timing.played_samples += block->i_nb_samples;
+
+    struct vlc_tracer *tracer = aout_stream_tracer(stream);
+    if (tracer != NULL)
+        vlc_tracer_Trace(tracer, VLC_TRACE("type", "AOUT"),
+                         VLC_TRACE("id", stream->str_id),
+                         VLC_TRACE("stream", "PLAY"),
+                         VLC_TRACE("pts", original_pts),
+                         VLC_TRACE("play_date", play_date), VLC_TRACE_END);
+
     aout->play(aout, block, play_date);
 
     atomic_fetch_add_explicit(&stream->buffers_played, 1, memory_order_relaxed);
@@ -834,6 +934,7 @@ void vlc_aout_stream_ChangePause(vlc_aout_stream *stream, bool paused, vlc_tick_
             vlc_tracer_TraceEvent(tracer, "RENDER", stream->str_id,
                                   paused ? "paused" : "resumed");
 
+        stream->paused = paused;
         if (aout->pause != NULL)
             aout->pause(aout, paused, date);
         else if (paused)
@@ -934,7 +1035,7 @@ void vlc_aout_stream_Drain(vlc_aout_stream *stream)
         vlc_tick_t drain_deadline = vlc_tick_now();
 
         vlc_tick_t delay;
-        if (stream_GetDelay(stream, &delay) == 0)
+        if (!stream->sync.offline && stream_GetDelay(stream, &delay) == 0)
             drain_deadline += delay;
         /* else the deadline is now, and vlc_aout_stream_IsDrained() will
          * return true on the first call. */
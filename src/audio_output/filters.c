@@ -58,6 +58,7 @@ filter_t *aout_filter_Create(vlc_object_t *obj, const filter_owner_t *restrict o
                              const char *type, const char *name,
                              const audio_sample_format_t *infmt,
                              const audio_sample_format_t *outfmt,
+                             const audio_replay_gain_t *replay_gain,
                              config_chain_t *cfg, bool const_fmt)
 {
     filter_t *filter = vlc_custom_create (obj, sizeof (*filter), type);
@@ -69,6 +70,8 @@ filter_t *aout_filter_Create(vlc_object_t *obj, const filter_owner_t *restrict o
     filter->p_cfg = cfg;
     filter->fmt_in.audio = *infmt;
     filter->fmt_in.i_codec = infmt->i_format;
+    if (replay_gain != NULL)
+        filter->fmt_in.audio_replay_gain = *replay_gain;
     filter->fmt_out.audio = *outfmt;
     filter->fmt_out.i_codec = outfmt->i_format;
 
@@ -109,7 +112,7 @@ static filter_t *FindConverter (vlc_object_t *obj,
                                 const audio_sample_format_t *outfmt)
 {
     return aout_filter_Create(obj, NULL, "audio converter", NULL, infmt, outfmt,
-                              NULL, true);
+                              NULL, NULL, true);
 }
 
 static filter_t *FindResampler (vlc_object_t *obj,
@@ -118,7 +121,7 @@ static filter_t *FindResampler (vlc_object_t *obj,
 {
     char *modlist = var_InheritString(obj, "audio-resampler");
     filter_t *filter = aout_filter_Create(obj, NULL, "audio resampler", modlist,
-                                          infmt, outfmt, NULL, true);
+                                          infmt, outfmt, NULL, NULL, true);
     free(modlist);
     return filter;
 }
@@ -230,7 +233,7 @@ static int aout_FiltersPipelineCreate(vlc_object_t *obj, struct aout_filter *tab
             "audio renderer" : "audio converter";
 
         filter_t *f = aout_filter_Create(obj, NULL, filter_type, NULL,
-                                         &input, &output, NULL, true);
+                                         &input, &output, NULL, NULL, true);
 
         if (f == NULL)
         {
@@ -450,6 +453,7 @@ static int AppendFilter(vlc_object_t *obj, const char *type, const char *name,
                         aout_filters_t *restrict filters,
                         audio_sample_format_t *restrict infmt,
                         const audio_sample_format_t *restrict outfmt,
+                        const audio_replay_gain_t *replay_gain,
                         config_chain_t *cfg)
 {
     const unsigned max = sizeof (filters->tab) / sizeof (filters->tab[0]);
@@ -466,7 +470,8 @@ static int AppendFilter(vlc_object_t *obj, const char *type, const char *name,
     };
     const filter_owner_t owner = { .sys = &owner_sys };
     filter_t *filter = aout_filter_Create(obj, &owner, type, name,
-                                          infmt, outfmt, cfg, false);
+                                          infmt, outfmt, replay_gain, cfg,
+                                          false);
     if (filter == NULL)
     {
         msg_Err (obj, "cannot add user %s \"%s\" (skipped)", type, name);
@@ -530,7 +535,7 @@ static int AppendRemapFilter(vlc_object_t *obj, aout_filters_t *restrict filters
     free(config_ChainCreate(&name, &cfg, str));
     if (name != NULL && cfg != NULL)
         ret = AppendFilter(obj, "audio filter", name, filters,
-                           infmt, outfmt, cfg);
+                           infmt, outfmt, NULL, cfg);
     else
         ret = -1;
 
@@ -633,7 +638,8 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, const vlc_clock_t *c
     if (var_InheritBool (obj, "audio-time-stretch"))
     {
         if (AppendFilter(obj, "audio filter", "scaletempo",
-                         filters, &input_format, &output_format, NULL) == 0)
+                         filters, &input_format, &output_format,
+                         NULL, NULL) == 0)
             filters->rate_filter = filters->tab[filters->count - 1].f;
     }
 
@@ -642,6 +648,8 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, const vlc_clock_t *c
                           cfg->remap);
 
     /* Now add user filters */
+    const audio_replay_gain_t *replay_gain =
+        cfg != NULL ? &cfg->replay_gain : NULL;
     char *str = var_InheritString (obj, "audio-filter");
     if (str != NULL)
     {
@@ -649,7 +657,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, const vlc_clock_t *c
         while ((name = strsep (&p, " :")) != NULL)
         {
             AppendFilter(obj, "audio filter", name, filters,
-                         &input_format, &output_format, NULL);
+                         &input_format, &output_format, replay_gain, NULL);
         }
         free (str);
     }
@@ -657,7 +665,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, const vlc_clock_t *c
     char *visual = var_InheritString(obj, "audio-visual");
     if (visual != NULL && strcasecmp(visual, "none"))
         AppendFilter(obj, "visualization", visual, filters,
-                     &input_format, &output_format, NULL);
+                     &input_format, &output_format, NULL, NULL);
     free(visual);
 
     /* convert to the output format (minus resampling) if necessary */
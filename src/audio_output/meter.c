@@ -81,7 +81,7 @@ vlc_audio_meter_CreatePluginFilter(struct vlc_audio_meter *meter, vlc_audio_mete
     };
 
     return aout_filter_Create(meter->parent, &owner, "audio meter", plugin->name,
-                              meter->fmt, meter->fmt, plugin->cfg, true);
+                              meter->fmt, meter->fmt, NULL, plugin->cfg, true);
 }
 
 vlc_audio_meter_plugin *
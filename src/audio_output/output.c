@@ -67,15 +67,16 @@ static void aout_TimingNotify(audio_output_t *aout, vlc_tick_t system_ts,
                               vlc_tick_t audio_ts)
 {
     aout_owner_t *owner = aout_owner (aout);
-    assert(owner->main_stream);
-    vlc_aout_stream_NotifyTiming(owner->main_stream, system_ts, audio_ts);
+    /* No stream while the output is idle */
+    if (owner->main_stream != NULL)
+        vlc_aout_stream_NotifyTiming(owner->main_stream, system_ts, audio_ts);
 }
 
 static void aout_DrainedNotify(audio_output_t *aout)
 {
     aout_owner_t *owner = aout_owner (aout);
-    assert(owner->main_stream);
-    vlc_aout_stream_NotifyDrained(owner->main_stream);
+    if (owner->main_stream != NULL)
+        vlc_aout_stream_NotifyDrained(owner->main_stream);
 }
 
 /**
@@ -157,6 +158,8 @@ static void aout_RestartNotify (audio_output_t *aout, unsigned mode)
     aout_owner_t *owner = aout_owner (aout);
     if (owner->main_stream)
         vlc_aout_stream_RequestRestart(owner->main_stream, mode);
+    else
+        atomic_store_explicit(&owner->idle.stale, true, memory_order_relaxed);
 }
 
 void aout_InputRequestRestart(audio_output_t *aout)
@@ -262,6 +265,8 @@ audio_output_t *aout_New (vlc_object_t *parent)
     vlc_audio_meter_Init(&owner->meter, aout);
 
     owner->main_stream = NULL;
+    owner->idle.started = false;
+    atomic_init(&owner->idle.stale, false);
 
     /* Audio output module callbacks */
     var_Create (aout, "volume", VLC_VAR_FLOAT);
@@ -382,6 +387,7 @@ audio_output_t *aout_New (vlc_object_t *parent)
     var_Create (aout, "equalizer-preset", VLC_VAR_STRING | VLC_VAR_DOINHERIT);
 
     owner->bitexact = var_InheritBool (aout, "audio-bitexact");
+    owner->low_latency = var_InheritBool (aout, "audio-low-latency");
 
     return aout;
 }
@@ -402,6 +408,8 @@ static void aout_Destroy (audio_output_t *aout)
     aout_owner_t *owner = aout_owner (aout);
 
     vlc_mutex_lock(&owner->lock);
+    if (owner->idle.started)
+        aout->stop(aout);
     module_unneed (aout, owner->module);
     /* Protect against late call from intf.c */
     aout->volume_set = NULL;
@@ -819,6 +827,92 @@ void aout_OutputDelete (audio_output_t *aout)
     vlc_mutex_unlock(&owner->lock);
 }
 
+/**
+ * Detaches the audio output stream but keeps the output started, so that the
+ * next stream of the same format plays without restarting it.
+ * \note This can only be called after a successful aout_OutputNew().
+ * \warning The caller must NOT hold the audio output lock.
+ */
+void aout_OutputKeepIdle(audio_output_t *aout, int input_profile,
+                         const audio_sample_format_t *fmt,
+                         const audio_sample_format_t *filter_fmt,
+                         const audio_sample_format_t *mixer_fmt,
+                         const aout_filters_cfg_t *filters_cfg)
+{
+    aout_owner_t *owner = aout_owner(aout);
+
+    aout->flush(aout);
+
+    vlc_mutex_lock(&owner->lock);
+    owner->main_stream = NULL;
+    owner->idle.started = true;
+    atomic_store_explicit(&owner->idle.stale, false, memory_order_relaxed);
+    owner->idle.input_profile = input_profile;
+    owner->idle.input_format = *fmt;
+    owner->idle.filter_format = *filter_fmt;
+    owner->idle.mixer_format = *mixer_fmt;
+    owner->idle.filters_cfg = *filters_cfg;
+    vlc_mutex_unlock(&owner->lock);
+}
+
+/**
+ * Attaches a new stream to the idle output if it was started for the same
+ * input format, or stops the idle output otherwise.
+ * \return true if the output was reused, false if aout_OutputNew() must be
+ * called
+ * \warning The caller must NOT hold the audio output lock.
+ */
+bool aout_OutputTakeIdle(audio_output_t *aout, vlc_aout_stream *stream,
+                         int input_profile, const audio_sample_format_t *fmt,
+                         audio_sample_format_t *filter_fmt,
+                         audio_sample_format_t *mixer_fmt,
+                         aout_filters_cfg_t *filters_cfg)
+{
+    aout_owner_t *owner = aout_owner(aout);
+    bool reuse = false;
+
+    vlc_mutex_lock(&owner->lock);
+    if (owner->idle.started)
+    {
+        assert(owner->main_stream == NULL);
+        reuse = !atomic_load_explicit(&owner->idle.stale, memory_order_relaxed)
+             && input_profile == owner->idle.input_profile
+             && AOUT_FMTS_IDENTICAL(fmt, &owner->idle.input_format)
+             && fmt->i_channels == owner->idle.input_format.i_channels;
+        if (reuse)
+        {
+            owner->main_stream = stream;
+            *filter_fmt = owner->idle.filter_format;
+            *mixer_fmt = owner->idle.mixer_format;
+            *filters_cfg = owner->idle.filters_cfg;
+        }
+        else
+            aout->stop(aout);
+        owner->idle.started = false;
+    }
+    vlc_mutex_unlock(&owner->lock);
+
+    if (reuse)
+        msg_Dbg(aout, "reusing the started output");
+    return reuse;
+}
+
+/**
+ * Stops the output left started by the last stream, if any.
+ */
+void aout_OutputStopIdle(audio_output_t *aout)
+{
+    aout_owner_t *owner = aout_owner(aout);
+
+    vlc_mutex_lock(&owner->lock);
+    if (owner->idle.started)
+    {
+        aout->stop(aout);
+        owner->idle.started = false;
+    }
+    vlc_mutex_unlock(&owner->lock);
+}
+
 /**
  * Gets the volume of the audio output stream (independent of mute).
  * \return Current audio volume (0. = silent, 1. = nominal),
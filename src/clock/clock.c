@@ -25,12 +25,33 @@
 #include <vlc_aout.h>
 #include <assert.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <vlc_tracer.h>
 #include "clock.h"
 #include "clock_internal.h"
 
 #define COEFF_THRESHOLD 0.2 /* between 0.8 and 1.2 */
 
+/**
+ * Main clocks sharing a time reference in the process
+ *
+ * The first main clock joining a group leads it: its outputs drive the
+ * reference as usual. The main clocks joining later follow the leader:
+ * their clocks are all slaves and convert timestamps with the leader
+ * reference.
+ */
+struct vlc_clock_group
+{
+    vlc_mutex_t lock;
+    vlc_clock_main_t *leader;
+    unsigned refs;
+    struct vlc_clock_group *next;
+    char name[];
+};
+
+static vlc_mutex_t groups_lock = VLC_STATIC_MUTEX;
+static struct vlc_clock_group *groups = NULL;
+
 struct vlc_clock_main_t
 {
     struct vlc_logger *logger;
@@ -61,6 +82,24 @@ struct vlc_clock_main_t
     clock_point_t first_pcr;
     vlc_tick_t output_dejitter; /* Delay used to absorb the output clock jitter */
     vlc_tick_t input_dejitter; /* Delay used to absorb the input jitter */
+
+    struct vlc_clock_group *group;
+    bool group_leader;
+
+    /**
+     * Copy of the linear function parameters, published with a sequence lock
+     * so that outputs can convert timestamps without taking the lock.
+     * Writers hold the lock; seq is odd while a write is in progress.
+     */
+    struct
+    {
+        atomic_uint seq;
+        _Atomic vlc_tick_t offset;
+        _Atomic double coeff;
+        _Atomic double rate;
+        _Atomic vlc_tick_t delay;
+        _Atomic vlc_tick_t pause_date;
+    } snapshot;
 };
 
 struct vlc_clock_t
@@ -72,9 +111,11 @@ struct vlc_clock_t
     vlc_tick_t (*set_delay)(vlc_clock_t *clock, vlc_tick_t delay);
     vlc_tick_t (*to_system_locked)(vlc_clock_t *clock, vlc_tick_t system_now,
                                    vlc_tick_t ts, double rate);
+    bool (*to_system_lockless)(vlc_clock_t *clock, vlc_tick_t ts, double rate,
+                               vlc_tick_t *system);
 
     vlc_clock_main_t *owner;
-    vlc_tick_t delay;
+    _Atomic vlc_tick_t delay; /* written locked, within a snapshot write */
     unsigned priority;
     const char *track_str_id;
 
@@ -91,6 +132,105 @@ static vlc_tick_t main_stream_to_system(vlc_clock_main_t *main_clock,
             + main_clock->offset;
 }
 
+static void vlc_clock_main_write_begin(vlc_clock_main_t *main_clock)
+{
+    vlc_mutex_assert(&main_clock->lock);
+    unsigned seq = atomic_load_explicit(&main_clock->snapshot.seq,
+                                        memory_order_relaxed);
+    assert((seq & 1) == 0);
+    atomic_store_explicit(&main_clock->snapshot.seq, seq + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void vlc_clock_main_write_end(vlc_clock_main_t *main_clock)
+{
+    vlc_mutex_assert(&main_clock->lock);
+    atomic_store_explicit(&main_clock->snapshot.offset, main_clock->offset,
+                          memory_order_relaxed);
+    atomic_store_explicit(&main_clock->snapshot.coeff, main_clock->coeff,
+                          memory_order_relaxed);
+    atomic_store_explicit(&main_clock->snapshot.rate, main_clock->rate,
+                          memory_order_relaxed);
+    atomic_store_explicit(&main_clock->snapshot.delay, main_clock->delay,
+                          memory_order_relaxed);
+    atomic_store_explicit(&main_clock->snapshot.pause_date,
+                          main_clock->pause_date, memory_order_relaxed);
+
+    unsigned seq = atomic_load_explicit(&main_clock->snapshot.seq,
+                                        memory_order_relaxed);
+    assert(seq & 1);
+    atomic_store_explicit(&main_clock->snapshot.seq, seq + 1,
+                          memory_order_release);
+}
+
+struct vlc_clock_snapshot
+{
+    vlc_tick_t offset;
+    double coeff;
+    double rate;
+    vlc_tick_t main_delay;
+    vlc_tick_t pause_date;
+    vlc_tick_t delay;
+};
+
+/**
+ * Read the published parameters without locking
+ *
+ * @return false if a writer is active, in which case the caller should fall
+ * back to the locked path rather than spin
+ */
+static bool vlc_clock_read_snapshot(vlc_clock_t *clock,
+                                    struct vlc_clock_snapshot *snap)
+{
+    vlc_clock_main_t *main_clock = clock->owner;
+
+    unsigned seq = atomic_load_explicit(&main_clock->snapshot.seq,
+                                        memory_order_acquire);
+    if (seq & 1)
+        return false;
+
+    snap->offset = atomic_load_explicit(&main_clock->snapshot.offset,
+                                        memory_order_relaxed);
+    snap->coeff = atomic_load_explicit(&main_clock->snapshot.coeff,
+                                       memory_order_relaxed);
+    snap->rate = atomic_load_explicit(&main_clock->snapshot.rate,
+                                      memory_order_relaxed);
+    snap->main_delay = atomic_load_explicit(&main_clock->snapshot.delay,
+                                            memory_order_relaxed);
+    snap->pause_date = atomic_load_explicit(&main_clock->snapshot.pause_date,
+                                            memory_order_relaxed);
+    snap->delay = atomic_load_explicit(&clock->delay, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&main_clock->snapshot.seq,
+                                memory_order_relaxed) == seq;
+}
+
+static bool vlc_clock_main_is_follower(const vlc_clock_main_t *main_clock)
+{
+    return main_clock->group != NULL && !main_clock->group_leader;
+}
+
+/* Lock order: follower main clock, then group, then leader main clock */
+static vlc_tick_t vlc_clock_group_to_system(vlc_clock_main_t *main_clock,
+                                            vlc_tick_t ts)
+{
+    struct vlc_clock_group *group = main_clock->group;
+    vlc_tick_t system = VLC_TICK_INVALID;
+
+    vlc_mutex_lock(&group->lock);
+    vlc_clock_main_t *leader = group->leader;
+    if (leader != NULL)
+    {
+        vlc_mutex_lock(&leader->lock);
+        system = main_stream_to_system(leader, ts);
+        vlc_mutex_unlock(&leader->lock);
+    }
+    vlc_mutex_unlock(&group->lock);
+    return system;
+}
+
 static void vlc_clock_main_reset(vlc_clock_main_t *main_clock)
 {
     main_clock->coeff = 1.0f;
@@ -140,6 +280,8 @@ static vlc_tick_t vlc_clock_master_update(vlc_clock_t *clock,
      * anything but only notify the new clock point. */
     if (system_now != VLC_TICK_MAX)
     {
+        vlc_clock_main_write_begin(main_clock);
+
         if (main_clock->offset != VLC_TICK_INVALID
          && ts != main_clock->last.stream)
         {
@@ -199,6 +341,7 @@ static vlc_tick_t vlc_clock_master_update(vlc_clock_t *clock,
         main_clock->last = clock_point_Create(system_now, ts);
 
         main_clock->rate = rate;
+        vlc_clock_main_write_end(main_clock);
         vlc_cond_broadcast(&main_clock->cond);
     }
 
@@ -214,6 +357,7 @@ static void vlc_clock_master_reset(vlc_clock_t *clock)
     vlc_clock_main_t *main_clock = clock->owner;
 
     vlc_mutex_lock(&main_clock->lock);
+    vlc_clock_main_write_begin(main_clock);
     vlc_clock_main_reset(main_clock);
 
     assert(main_clock->delay <= 0);
@@ -234,6 +378,7 @@ static void vlc_clock_master_reset(vlc_clock_t *clock)
         }
     }
 
+    vlc_clock_main_write_end(main_clock);
     vlc_mutex_unlock(&main_clock->lock);
 
     vlc_clock_on_update(clock, VLC_TICK_INVALID, VLC_TICK_INVALID, 1.f, 0, 0);
@@ -243,6 +388,7 @@ static vlc_tick_t vlc_clock_master_set_delay(vlc_clock_t *clock, vlc_tick_t dela
 {
     vlc_clock_main_t *main_clock = clock->owner;
     vlc_mutex_lock(&main_clock->lock);
+    vlc_clock_main_write_begin(main_clock);
 
     vlc_tick_t delta = delay - clock->delay;
 
@@ -261,6 +407,7 @@ static vlc_tick_t vlc_clock_master_set_delay(vlc_clock_t *clock, vlc_tick_t dela
     assert(main_clock->delay <= 0);
     assert(clock->delay >= 0);
 
+    vlc_clock_main_write_end(main_clock);
     vlc_cond_broadcast(&main_clock->cond);
     vlc_mutex_unlock(&main_clock->lock);
     return delta;
@@ -310,7 +457,9 @@ static vlc_tick_t vlc_clock_slave_to_system_locked(vlc_clock_t *clock,
     if (main_clock->pause_date != VLC_TICK_INVALID)
         return VLC_TICK_MAX;
 
-    vlc_tick_t system = main_stream_to_system(main_clock, ts);
+    vlc_tick_t system = vlc_clock_main_is_follower(main_clock)
+                      ? vlc_clock_group_to_system(main_clock, ts)
+                      : main_stream_to_system(main_clock, ts);
     if (system == VLC_TICK_INVALID)
     {
         /* We don't have a master sync point, let's fallback to a monotonic ref
@@ -337,6 +486,42 @@ static vlc_tick_t vlc_clock_master_to_system_locked(vlc_clock_t *clock,
     return system + clock->delay * rate;
 }
 
+static bool vlc_clock_slave_to_system_lockless(vlc_clock_t *clock,
+                                               vlc_tick_t ts, double rate,
+                                               vlc_tick_t *system)
+{
+    struct vlc_clock_snapshot snap;
+    if (!vlc_clock_read_snapshot(clock, &snap))
+        return false;
+
+    if (snap.pause_date != VLC_TICK_INVALID)
+    {
+        *system = VLC_TICK_MAX;
+        return true;
+    }
+    /* The monotonic fallback modifies the reference point */
+    if (snap.offset == VLC_TICK_INVALID)
+        return false;
+
+    *system = ((vlc_tick_t) (ts * snap.coeff / snap.rate)) + snap.offset
+            + (snap.delay - snap.main_delay) * rate;
+    return true;
+}
+
+static bool vlc_clock_master_to_system_lockless(vlc_clock_t *clock,
+                                                vlc_tick_t ts, double rate,
+                                                vlc_tick_t *system)
+{
+    struct vlc_clock_snapshot snap;
+    if (!vlc_clock_read_snapshot(clock, &snap)
+     || snap.offset == VLC_TICK_INVALID)
+        return false;
+
+    *system = ((vlc_tick_t) (ts * snap.coeff / snap.rate)) + snap.offset
+            + snap.delay * rate;
+    return true;
+}
+
 static vlc_tick_t vlc_clock_slave_update(vlc_clock_t *clock,
                                          vlc_tick_t system_now,
                                          vlc_tick_t ts, double rate,
@@ -354,11 +539,13 @@ static vlc_tick_t vlc_clock_slave_update(vlc_clock_t *clock,
         return VLC_TICK_MAX;
     }
 
-    vlc_mutex_lock(&main_clock->lock);
-
-    vlc_tick_t computed = clock->to_system_locked(clock, system_now, ts, rate);
-
-    vlc_mutex_unlock(&main_clock->lock);
+    vlc_tick_t computed;
+    if (!clock->to_system_lockless(clock, ts, rate, &computed))
+    {
+        vlc_mutex_lock(&main_clock->lock);
+        computed = clock->to_system_locked(clock, system_now, ts, rate);
+        vlc_mutex_unlock(&main_clock->lock);
+    }
 
     vlc_clock_on_update(clock, computed, ts, rate, frame_rate, frame_rate_base);
     return computed - system_now;
@@ -382,7 +569,9 @@ static vlc_tick_t vlc_clock_slave_set_delay(vlc_clock_t *clock, vlc_tick_t delay
     vlc_clock_main_t *main_clock = clock->owner;
     vlc_mutex_lock(&main_clock->lock);
 
+    vlc_clock_main_write_begin(main_clock);
     clock->delay = delay;
+    vlc_clock_main_write_end(main_clock);
 
     vlc_cond_broadcast(&main_clock->cond);
     vlc_mutex_unlock(&main_clock->lock);
@@ -456,19 +645,30 @@ vlc_clock_main_t *vlc_clock_main_New(struct vlc_logger *parent_logger, struct vl
         clock_point_Create(VLC_TICK_INVALID, VLC_TICK_INVALID);
 
     main_clock->pause_date = VLC_TICK_INVALID;
+    main_clock->group = NULL;
+    main_clock->group_leader = false;
     main_clock->input_dejitter = DEFAULT_PTS_DELAY;
     main_clock->output_dejitter = AOUT_MAX_PTS_ADVANCE * 2;
 
     AvgInit(&main_clock->coeff_avg, 10);
     AvgResetAndFill(&main_clock->coeff_avg, main_clock->coeff);
 
+    atomic_init(&main_clock->snapshot.seq, 0);
+    atomic_init(&main_clock->snapshot.offset, main_clock->offset);
+    atomic_init(&main_clock->snapshot.coeff, main_clock->coeff);
+    atomic_init(&main_clock->snapshot.rate, main_clock->rate);
+    atomic_init(&main_clock->snapshot.delay, main_clock->delay);
+    atomic_init(&main_clock->snapshot.pause_date, main_clock->pause_date);
+
     return main_clock;
 }
 
 void vlc_clock_main_Reset(vlc_clock_main_t *main_clock)
 {
     vlc_mutex_lock(&main_clock->lock);
+    vlc_clock_main_write_begin(main_clock);
     vlc_clock_main_reset(main_clock);
+    vlc_clock_main_write_end(main_clock);
     main_clock->first_pcr =
         clock_point_Create(VLC_TICK_INVALID, VLC_TICK_INVALID);
     vlc_mutex_unlock(&main_clock->lock);
@@ -510,6 +710,7 @@ void vlc_clock_main_ChangePause(vlc_clock_main_t *main_clock, vlc_tick_t now,
     vlc_mutex_lock(&main_clock->lock);
     assert(paused == (main_clock->pause_date == VLC_TICK_INVALID));
 
+    vlc_clock_main_write_begin(main_clock);
     if (paused)
         main_clock->pause_date = now;
     else
@@ -531,12 +732,83 @@ void vlc_clock_main_ChangePause(vlc_clock_main_t *main_clock, vlc_tick_t now,
         main_clock->pause_date = VLC_TICK_INVALID;
         vlc_cond_broadcast(&main_clock->cond);
     }
+    vlc_clock_main_write_end(main_clock);
     vlc_mutex_unlock(&main_clock->lock);
 }
 
+int vlc_clock_main_JoinGroup(vlc_clock_main_t *main_clock, const char *name)
+{
+    assert(main_clock->group == NULL);
+    assert(main_clock->master == NULL && main_clock->input_master == NULL);
+
+    vlc_mutex_lock(&groups_lock);
+    struct vlc_clock_group *group = groups;
+    while (group != NULL && strcmp(group->name, name) != 0)
+        group = group->next;
+
+    if (group == NULL)
+    {
+        size_t len = strlen(name) + 1;
+        group = malloc(sizeof (*group) + len);
+        if (group == NULL)
+        {
+            vlc_mutex_unlock(&groups_lock);
+            return VLC_ENOMEM;
+        }
+        vlc_mutex_init(&group->lock);
+        group->leader = NULL;
+        group->refs = 0;
+        memcpy(group->name, name, len);
+        group->next = groups;
+        groups = group;
+    }
+    group->refs++;
+    vlc_mutex_unlock(&groups_lock);
+
+    vlc_mutex_lock(&group->lock);
+    main_clock->group_leader = group->leader == NULL;
+    if (main_clock->group_leader)
+        group->leader = main_clock;
+    vlc_mutex_unlock(&group->lock);
+    main_clock->group = group;
+
+    if (main_clock->logger != NULL)
+        vlc_debug(main_clock->logger, "%s clock group \"%s\"",
+                  main_clock->group_leader ? "leading" : "following", name);
+    return VLC_SUCCESS;
+}
+
+static void vlc_clock_main_LeaveGroup(vlc_clock_main_t *main_clock)
+{
+    struct vlc_clock_group *group = main_clock->group;
+
+    if (main_clock->group_leader)
+    {
+        /* The followers fall back to their own reference until another
+         * main clock joins and leads the group. */
+        vlc_mutex_lock(&group->lock);
+        assert(group->leader == main_clock);
+        group->leader = NULL;
+        vlc_mutex_unlock(&group->lock);
+    }
+
+    vlc_mutex_lock(&groups_lock);
+    if (--group->refs == 0)
+    {
+        struct vlc_clock_group **pp = &groups;
+        while (*pp != group)
+            pp = &(*pp)->next;
+        *pp = group->next;
+        free(group);
+    }
+    vlc_mutex_unlock(&groups_lock);
+}
+
 void vlc_clock_main_Delete(vlc_clock_main_t *main_clock)
 {
     assert(main_clock->rc == 1);
+    if (main_clock->group != NULL)
+        vlc_clock_main_LeaveGroup(main_clock);
     if (main_clock->logger != NULL)
         vlc_LogDestroy(main_clock->logger);
     free(main_clock);
@@ -572,12 +844,27 @@ vlc_tick_t vlc_clock_ConvertToSystemLocked(vlc_clock_t *clock,
     return clock->to_system_locked(clock, system_now, ts, rate);
 }
 
+vlc_tick_t vlc_clock_ConvertToSystem(vlc_clock_t *clock, vlc_tick_t system_now,
+                                     vlc_tick_t ts, double rate)
+{
+    vlc_tick_t system;
+    if (clock->to_system_lockless(clock, ts, rate, &system))
+        return system;
+
+    vlc_clock_main_t *main_clock = clock->owner;
+    vlc_mutex_lock(&main_clock->lock);
+    system = clock->to_system_locked(clock, system_now, ts, rate);
+    vlc_mutex_unlock(&main_clock->lock);
+    return system;
+}
+
 static void vlc_clock_set_master_callbacks(vlc_clock_t *clock)
 {
     clock->update = vlc_clock_master_update;
     clock->reset = vlc_clock_master_reset;
     clock->set_delay = vlc_clock_master_set_delay;
     clock->to_system_locked = vlc_clock_master_to_system_locked;
+    clock->to_system_lockless = vlc_clock_master_to_system_lockless;
 }
 
 static void vlc_clock_set_slave_callbacks(vlc_clock_t *clock)
@@ -586,6 +873,7 @@ static void vlc_clock_set_slave_callbacks(vlc_clock_t *clock)
     clock->reset = vlc_clock_slave_reset;
     clock->set_delay = vlc_clock_slave_set_delay;
     clock->to_system_locked = vlc_clock_slave_to_system_locked;
+    clock->to_system_lockless = vlc_clock_slave_to_system_lockless;
 }
 
 static vlc_clock_t *vlc_clock_main_Create(vlc_clock_main_t *main_clock,
@@ -600,7 +888,7 @@ static vlc_clock_t *vlc_clock_main_Create(vlc_clock_main_t *main_clock,
 
     clock->owner = main_clock;
     clock->track_str_id = track_str_id;
-    clock->delay = 0;
+    atomic_init(&clock->delay, 0);
     clock->cbs = cbs;
     clock->cbs_data = cbs_data;
     clock->priority = priority;
@@ -622,7 +910,8 @@ vlc_clock_t *vlc_clock_main_CreateMaster(vlc_clock_main_t *main_clock,
     vlc_mutex_lock(&main_clock->lock);
     assert(main_clock->master == NULL);
 
-    if (main_clock->input_master == NULL)
+    if (main_clock->input_master == NULL
+     && !vlc_clock_main_is_follower(main_clock))
         vlc_clock_set_master_callbacks(clock);
     else
         vlc_clock_set_slave_callbacks(clock);
@@ -652,7 +941,10 @@ vlc_clock_t *vlc_clock_main_CreateInputMaster(vlc_clock_main_t *main_clock)
     if (main_clock->master != NULL)
         vlc_clock_set_slave_callbacks(main_clock->master);
 
-    vlc_clock_set_master_callbacks(clock);
+    if (vlc_clock_main_is_follower(main_clock))
+        vlc_clock_set_slave_callbacks(clock);
+    else
+        vlc_clock_set_master_callbacks(clock);
     main_clock->input_master = clock;
     main_clock->rc++;
     vlc_mutex_unlock(&main_clock->lock);
@@ -716,7 +1008,11 @@ void vlc_clock_Delete(vlc_clock_t *clock)
         /* Don't reset the main clock if the master has been overridden by the
          * input master */
         if (main_clock->input_master != NULL)
+        {
+            vlc_clock_main_write_begin(main_clock);
             vlc_clock_main_reset(main_clock);
+            vlc_clock_main_write_end(main_clock);
+        }
         main_clock->master = NULL;
     }
     main_clock->rc--;
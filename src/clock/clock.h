@@ -64,6 +64,18 @@ vlc_clock_main_t *vlc_clock_main_New(struct vlc_logger *parent_logger, struct vl
  */
 void vlc_clock_main_Delete(vlc_clock_main_t *main_clock);
 
+/**
+ * Join the named clock group of the process
+ *
+ * The first main clock to join a group leads it. The following ones play
+ * their tracks as slaves of the leader reference, so that several inputs
+ * stay in sync (e.g. for video walls).
+ *
+ * This must be called before any clock is created from the main clock. The
+ * group is left when the main clock is deleted.
+ */
+int vlc_clock_main_JoinGroup(vlc_clock_main_t *main_clock, const char *name);
+
 /**
  * Reset the vlc_clock_main_t
  */
@@ -218,15 +230,15 @@ vlc_tick_t vlc_clock_ConvertToSystemLocked(vlc_clock_t *clock,
                                            vlc_tick_t system_now, vlc_tick_t ts,
                                            double rate);
 
-static inline vlc_tick_t
-vlc_clock_ConvertToSystem(vlc_clock_t *clock, vlc_tick_t system_now,
-                          vlc_tick_t ts, double rate)
-{
-    vlc_clock_Lock(clock);
-    vlc_tick_t system =
-        vlc_clock_ConvertToSystemLocked(clock, system_now, ts, rate);
-    vlc_clock_Unlock(clock);
-    return system;
-}
+/**
+ * This function converts a timestamp from stream to system
+ *
+ * The clock mutex must not be locked. Once the master has set a reference
+ * point, the conversion does not take the lock.
+ *
+ * @return the valid system time or VLC_TICK_MAX when the clock is paused
+ */
+vlc_tick_t vlc_clock_ConvertToSystem(vlc_clock_t *clock, vlc_tick_t system_now,
+                                     vlc_tick_t ts, double rate);
 
 #endif /*CLOCK_H*/
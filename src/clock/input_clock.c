@@ -98,6 +98,9 @@
 /* */
 #define INPUT_CLOCK_LATE_COUNT (3)
 
+/* Number of PCR arrival dates used to estimate the jitter of live sources */
+#define INPUT_CLOCK_ARRIVAL_COUNT (128)
+
 /* */
 struct input_clock_t
 {
@@ -121,6 +124,15 @@ struct input_clock_t
         unsigned i_index;
     } late;
 
+    /* Arrival statistics: delay of each clock update relative to the
+     * drift-corrected reference, whether late or early */
+    struct
+    {
+        vlc_tick_t  pi_value[INPUT_CLOCK_ARRIVAL_COUNT];
+        unsigned i_index;
+        unsigned i_count;
+    } arrival;
+
     /* Reference point */
     clock_point_t ref;
     bool          b_has_reference;
@@ -178,6 +190,9 @@ input_clock_t *input_clock_New( float rate )
     for( int i = 0; i < INPUT_CLOCK_LATE_COUNT; i++ )
         cl->late.pi_value[i] = 0;
 
+    cl->arrival.i_index = 0;
+    cl->arrival.i_count = 0;
+
     cl->rate = rate;
     cl->i_pts_delay = 0;
     cl->b_paused = false;
@@ -244,6 +259,9 @@ vlc_tick_t input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
         cl->i_next_drift_update = VLC_TICK_INVALID;
         AvgReset( &cl->drift );
 
+        cl->arrival.i_index = 0;
+        cl->arrival.i_count = 0;
+
         /* Feed synchro with a new reference point. */
         cl->b_has_reference = true;
         cl->ref = clock_point_Create( __MAX( CR_MEAN_PTS_GAP, i_ck_system ),
@@ -287,6 +305,14 @@ vlc_tick_t input_clock_Update( input_clock_t *cl, vlc_object_t *p_log,
      * the goal of the clock here */
     const vlc_tick_t i_system_expected = ClockStreamToSystem( cl, i_ck_stream + AvgGet( &cl->drift ) );
     const vlc_tick_t i_late = __MAX(0, ( i_ck_system - cl->i_pts_delay ) - i_system_expected);
+
+    if( !b_can_pace_control && !b_reset_reference )
+    {
+        cl->arrival.pi_value[cl->arrival.i_index] = i_ck_system - i_system_expected;
+        cl->arrival.i_index = ( cl->arrival.i_index + 1 ) % INPUT_CLOCK_ARRIVAL_COUNT;
+        if( cl->arrival.i_count < INPUT_CLOCK_ARRIVAL_COUNT )
+            cl->arrival.i_count++;
+    }
     if( i_late > 0 )
     {
         cl->late.pi_value[cl->late.i_index] = i_late;
@@ -474,6 +500,43 @@ vlc_tick_t input_clock_GetJitter( input_clock_t *cl )
     return i_pts_delay + i_late_median;
 }
 
+void input_clock_LowerJitter( input_clock_t *cl, vlc_tick_t i_pts_delay )
+{
+    if( i_pts_delay >= cl->i_pts_delay )
+        return;
+
+    /* The late values were measured against the previous delay, and the
+     * arrival statistics are what lowered it: forget them */
+    for( int i = 0; i < INPUT_CLOCK_LATE_COUNT; i++ )
+        cl->late.pi_value[i] = 0;
+    cl->late.i_index = 0;
+
+    cl->i_pts_delay = i_pts_delay;
+}
+
+static int CompareTick( const void *a, const void *b )
+{
+    const vlc_tick_t *ta = a, *tb = b;
+    return (*ta > *tb) - (*ta < *tb);
+}
+
+vlc_tick_t input_clock_GetJitterTarget( input_clock_t *cl, unsigned i_percentile )
+{
+    /* Wait for a full window, so that a single burst cannot be missed */
+    if( cl->arrival.i_count < INPUT_CLOCK_ARRIVAL_COUNT )
+        return VLC_TICK_INVALID;
+
+    vlc_tick_t pi_sorted[INPUT_CLOCK_ARRIVAL_COUNT];
+    memcpy( pi_sorted, cl->arrival.pi_value, sizeof(pi_sorted) );
+    qsort( pi_sorted, INPUT_CLOCK_ARRIVAL_COUNT, sizeof(*pi_sorted),
+           CompareTick );
+
+    unsigned i_rank = ( INPUT_CLOCK_ARRIVAL_COUNT * __MIN(i_percentile, 100) + 99 ) / 100;
+    if( i_rank > 0 )
+        i_rank--;
+    return __MAX( pi_sorted[i_rank], 0 );
+}
+
 /*****************************************************************************
  * ClockStreamToSystem: converts a movie clock to system date
  *****************************************************************************/
@@ -127,8 +127,22 @@ void input_clock_SetJitter( input_clock_t *,
 
 /**
  * This function returns an estimation of the pts_delay needed to avoid rebufferization.
- * XXX in the current implementation, the pts_delay will never be decreased.
+ * XXX the pts_delay is only ever decreased by input_clock_LowerJitter().
  */
 vlc_tick_t input_clock_GetJitter( input_clock_t * );
 
+/**
+ * This function lowers the pts_delay set by input_clock_SetJitter().
+ *
+ * It is a no-op if the new value is not smaller than the current one.
+ */
+void input_clock_LowerJitter( input_clock_t *, vlc_tick_t i_pts_delay );
+
+/**
+ * This function returns the delay covering the given percentile of the
+ * arrival dates of the last clock updates from a source which is not
+ * pace-controlled, or VLC_TICK_INVALID if there are not enough of them yet.
+ */
+vlc_tick_t input_clock_GetJitterTarget( input_clock_t *, unsigned i_percentile );
+
 #endif
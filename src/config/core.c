@@ -38,6 +38,7 @@
 #include "configuration.h"
 #include "modules/modules.h"
 #include "misc/rcu.h"
+#include "misc/variables.h"
 
 static vlc_mutex_t config_lock = VLC_STATIC_MUTEX;
 static atomic_bool config_dirty = ATOMIC_VAR_INIT(false);
@@ -148,6 +149,7 @@ void config_PutPsz(const char *psz_name, const char *psz_value)
     vlc_param_SetString(vlc_param_Find(psz_name), psz_value);
     vlc_mutex_unlock(&config_lock);
     atomic_store_explicit(&config_dirty, true, memory_order_release);
+    var_InvalidateHandles(psz_name);
 }
 
 void config_PutInt(const char *name, int64_t i_value)
@@ -169,6 +171,7 @@ void config_PutInt(const char *name, int64_t i_value)
     p_config->value.i = i_value;
     vlc_mutex_unlock(&config_lock);
     atomic_store_explicit(&config_dirty, true, memory_order_release);
+    var_InvalidateHandles(name);
 }
 
 void config_PutFloat(const char *name, float f_value)
@@ -193,6 +196,7 @@ void config_PutFloat(const char *name, float f_value)
     p_config->value.f = f_value;
     vlc_mutex_unlock(&config_lock);
     atomic_store_explicit(&config_dirty, true, memory_order_release);
+    var_InvalidateHandles(name);
 }
 
 ssize_t config_GetIntChoices(const char *name,
@@ -525,6 +529,7 @@ void config_ResetAll(void)
     }
     vlc_mutex_unlock(&config_lock);
     atomic_store_explicit(&config_dirty, true, memory_order_release);
+    var_InvalidateHandles(NULL);
 }
 
 
@@ -24,8 +24,10 @@
 
 #include <vlc_common.h>
 #include <vlc_threads.h>
+#include "misc/thread_policy.h"
 
 void (vlc_thread_set_name)(const char *name)
 {
     pthread_setname_np(name);
+    vlc_thread_policy_SetName(name);
 }
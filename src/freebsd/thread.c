@@ -34,6 +34,7 @@
 
 #include <vlc_common.h>
 #include <vlc_atomic.h>
+#include "misc/thread_policy.h"
 
 unsigned long vlc_thread_id(void)
 {
@@ -48,6 +49,7 @@ unsigned long vlc_thread_id(void)
 void (vlc_thread_set_name)(const char *name)
 {
     pthread_set_name_np(pthread_self(), name);
+    vlc_thread_policy_SetName(name);
 }
 
 static int vlc_umtx_wake(void *addr, int nr)
@@ -32,6 +32,7 @@
 #include <vlc_url.h>
 #include <vlc_modules.h>
 #include <vlc_interrupt.h>
+#include <vlc_tracer.h>
 
 #include <libvlc.h>
 #include "stream.h"
@@ -230,6 +231,11 @@ static block_t *AStreamReadBlock(stream_t *s, bool *restrict eof)
             priv->input ? input_priv(priv->input)->stats : NULL;
         if (stats != NULL)
             input_rate_Add(&stats->input_bitrate, block->i_buffer);
+
+        struct vlc_tracer *tracer = vlc_object_get_tracer(VLC_OBJECT(s));
+        if (tracer != NULL)
+            vlc_tracer_TraceStreamSize(tracer, "ACCESS", access->psz_url,
+                                       "READ", block->i_buffer);
     }
 
     return block;
@@ -254,6 +260,11 @@ static ssize_t AStreamReadStream(stream_t *s, void *buf, size_t len)
             priv->input ? input_priv(priv->input)->stats : NULL;
         if (stats != NULL)
             input_rate_Add(&stats->input_bitrate, val);
+
+        struct vlc_tracer *tracer = vlc_object_get_tracer(VLC_OBJECT(s));
+        if (tracer != NULL)
+            vlc_tracer_TraceStreamSize(tracer, "ACCESS", access->psz_url,
+                                       "READ", val);
     }
 
     return val;
@@ -41,6 +41,7 @@
 #include <vlc_meta.h>
 #include <vlc_dialog.h>
 #include <vlc_modules.h>
+#include <vlc_hash.h>
 #include <vlc_decoder.h>
 #include <vlc_picture_pool.h>
 #include <vlc_tracer.h>
@@ -54,6 +55,7 @@
 #include "libvlc.h"
 
 #include "../video_output/vout_internal.h"
+#include "../modules/modules.h"
 
 
 /**
@@ -117,6 +119,8 @@ struct vlc_input_decoder_t
     decoder_t        dec;
     es_format_t      dec_fmt_in;
     input_resource_t*p_resource;
+    struct vlc_probe_memo *probe_memo;
+    bool             probe_transient; /* a decoder device was requested */
     vlc_clock_t     *p_clock;
     const char *psz_id;
 
@@ -156,6 +160,26 @@ struct vlc_input_decoder_t
     /* pool to use when the decoder doesn't use its own */
     struct picture_pool_t *out_pool;
 
+    /* Pipelined packetizer stage (dec-pipeline), running the packetizer in
+     * its own thread and feeding packetized frames to p_fifo */
+    struct
+    {
+        bool enabled;
+        vlc_thread_t thread;
+        block_fifo_t *fifo; /* unpacketized input frames */
+        vlc_cond_t wait; /* signaled when a frame is dequeued from fifo */
+        atomic_uint flush_gen;
+        /* Protected by the pipeline fifo lock */
+        bool flushing;
+        bool draining;
+        bool busy;
+        bool aborting;
+        /* Last packetizer format sent to the decoder, protected by p_fifo
+         * lock while fmt_pending is set */
+        es_format_t fmt;
+        bool fmt_pending;
+    } pipeline;
+
     /*
      * 3 threads can read/write these output variables, the DecoderThread, the
      * input thread, and the ModuleThread. The ModuleThread is either the
@@ -200,6 +224,12 @@ struct vlc_input_decoder_t
     bool paused, output_paused;
 
     bool error;
+    /* Set after a fallback, until the replacement decoder gets a keyframe */
+    bool fallback_wait_keyframe;
+    /* Only the keyframes are decoded (keyframes-only) */
+    bool keyframes_only;
+    /* Frames in the fifo when the current frame was dequeued */
+    size_t queue_depth;
 
     /* Waiting */
     bool b_waiting;
@@ -238,6 +268,10 @@ struct vlc_input_decoder_t
 #define DECODER_SPU_VOUT_WAIT_DURATION   VLC_TICK_FROM_MS(200)
 #define BLOCK_FLAG_CORE_PRIVATE_RELOADED (1 << BLOCK_FLAG_CORE_PRIVATE_SHIFT)
 
+/* Maximum number of packetized frames queued by the pipelined packetizer
+ * ahead of the decoder */
+#define DECODER_PIPELINE_DEPTH 8
+
 #define decoder_Notify(decoder_priv, event, ...) \
     if (decoder_priv->cbs && decoder_priv->cbs->event) \
         decoder_priv->cbs->event(decoder_priv, __VA_ARGS__, \
@@ -360,17 +394,92 @@ static void Decoder_UpdateOutState(vlc_input_decoder_t *owner)
         Decoder_ChangeOutputDelay(owner, owner->delay);
 }
 
+/* Negative probe memo key: modules rejecting an ES are not probed again for
+ * the following ES of the same input with the same key. It covers the format
+ * properties that decoders check when probing. */
+struct decoder_probe_key
+{
+    vlc_fourcc_t i_codec;
+    vlc_fourcc_t i_original_fourcc;
+    int i_profile;
+    int i_level;
+    union
+    {
+        struct
+        {
+            vlc_fourcc_t i_chroma;
+            unsigned i_width;
+            unsigned i_height;
+        } video;
+        struct
+        {
+            unsigned i_rate;
+            unsigned i_bitspersample;
+            unsigned i_blockalign;
+            uint16_t i_physical_channels;
+            uint8_t i_channels;
+        } audio;
+    };
+    unsigned i_extra;
+    uint8_t extra_md5[VLC_HASH_MD5_DIGEST_SIZE];
+    uint8_t i_cat;
+    bool b_packetized;
+};
+
+static void DecoderProbeKeyInit( struct decoder_probe_key *key,
+                                 const es_format_t *fmt )
+{
+    memset( key, 0, sizeof(*key) ); /* compared byte-wise */
+    key->i_codec = fmt->i_codec;
+    key->i_original_fourcc = fmt->i_original_fourcc;
+    key->i_profile = fmt->i_profile;
+    key->i_level = fmt->i_level;
+    switch( fmt->i_cat )
+    {
+        case VIDEO_ES:
+            key->video.i_chroma = fmt->video.i_chroma;
+            key->video.i_width = fmt->video.i_width;
+            key->video.i_height = fmt->video.i_height;
+            break;
+        case AUDIO_ES:
+            key->audio.i_rate = fmt->audio.i_rate;
+            key->audio.i_bitspersample = fmt->audio.i_bitspersample;
+            key->audio.i_blockalign = fmt->audio.i_blockalign;
+            key->audio.i_physical_channels = fmt->audio.i_physical_channels;
+            key->audio.i_channels = fmt->audio.i_channels;
+            break;
+        default:
+            break;
+    }
+    key->i_extra = fmt->i_extra;
+    if( fmt->i_extra > 0 )
+    {
+        vlc_hash_md5_t md5;
+        vlc_hash_md5_Init( &md5 );
+        vlc_hash_md5_Update( &md5, fmt->p_extra, fmt->i_extra );
+        vlc_hash_md5_Finish( &md5, key->extra_md5, sizeof(key->extra_md5) );
+    }
+    key->i_cat = fmt->i_cat;
+    key->b_packetized = fmt->b_packetized;
+}
+
 /**
  * Load a decoder module
  */
 static int LoadDecoder( decoder_t *p_dec, bool b_packetizer, es_format_t *fmt_in,
-                        const es_format_t *restrict p_fmt )
+                        const es_format_t *restrict p_fmt,
+                        struct vlc_probe_memo *memo, bool *transient )
 {
     decoder_Init( p_dec, fmt_in, p_fmt );
 
     p_dec->b_frame_drop_allowed = true;
 
+    struct decoder_probe_key key;
+    DecoderProbeKeyInit( &key, p_fmt );
+    static_assert( sizeof(key) <= VLC_PROBE_MEMO_KEY_MAX, "key too big" );
+
     /* Find a suitable decoder/packetizer module */
+    const char *cap, *varname;
     if( !b_packetizer )
     {
         static const char caps[ES_CATEGORY_COUNT][16] = {
@@ -378,11 +487,25 @@ static int LoadDecoder( decoder_t *p_dec, bool b_packetizer, es_format_t *fmt_in
             [AUDIO_ES] = "audio decoder",
             [SPU_ES] = "spu decoder",
         };
-        p_dec->p_module = module_need_var( p_dec, caps[p_dec->fmt_in->i_cat],
-                                           "codec" );
+        cap = caps[p_dec->fmt_in->i_cat];
+        varname = "codec";
     }
     else
-        p_dec->p_module = module_need_var( p_dec, "packetizer", "packetizer" );
+    {
+        cap = "packetizer";
+        varname = "packetizer";
+    }
+
+    char *names = var_InheritString( p_dec, varname );
+    if( names != NULL )
+    {
+        p_dec->p_module = module_need_memo( VLC_OBJECT(p_dec), cap, names,
+                                            false, memo, &key, sizeof(key),
+                                            transient );
+        free( names );
+    }
+    else
+        p_dec->p_module = NULL;
 
     if( !p_dec->p_module )
     {
@@ -427,7 +550,8 @@ static int DecoderThread_Reload( vlc_input_decoder_t *p_owner,
         }
     }
 
-    if( LoadDecoder( p_dec, false, &p_owner->dec_fmt_in, &fmt_in ) )
+    if( LoadDecoder( p_dec, false, &p_owner->dec_fmt_in, &fmt_in,
+                     p_owner->probe_memo, &p_owner->probe_transient ) )
     {
         p_owner->error = true;
         es_format_Clean( &fmt_in );
@@ -611,44 +735,56 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
     p_owner->vctx = vctx ? vlc_video_context_Hold(vctx) : NULL;
 
     // configure the new vout
+    unsigned dpb_size;
+    switch( p_dec->fmt_in->i_codec )
+    {
+    case VLC_CODEC_HEVC:
+    case VLC_CODEC_H264:
+    case VLC_CODEC_DIRAC: /* FIXME valid ? */
+        dpb_size = 18;
+        break;
+    case VLC_CODEC_AV1:
+        dpb_size = 8; /* NUM_REF_FRAMES from the AV1 spec */
+        break;
+    case VLC_CODEC_VP9:
+        dpb_size = 8; /* NUM_REF_FRAMES from the VP9 spec */
+        break;
+    case VLC_CODEC_MP4V:
+    case VLC_CODEC_VP5:
+    case VLC_CODEC_VP6:
+    case VLC_CODEC_VP6F:
+    case VLC_CODEC_VP8:
+        dpb_size = 3;
+        break;
+    default:
+        dpb_size = 2;
+        break;
+    }
+    const unsigned pool_size = dpb_size + p_dec->i_extra_picture_buffers + 1;
+
     vlc_fifo_Lock(p_owner->p_fifo);
+    /* The pool also grows when the decoder needs more pictures than before,
+     * e.g. if the reordering depth increased, as it would block waiting for
+     * pictures otherwise. */
     if ( p_owner->out_pool == NULL )
     {
-        unsigned dpb_size;
-        switch( p_dec->fmt_in->i_codec )
-        {
-        case VLC_CODEC_HEVC:
-        case VLC_CODEC_H264:
-        case VLC_CODEC_DIRAC: /* FIXME valid ? */
-            dpb_size = 18;
-            break;
-        case VLC_CODEC_AV1:
-            dpb_size = 8; /* NUM_REF_FRAMES from the AV1 spec */
-            break;
-        case VLC_CODEC_MP4V:
-        case VLC_CODEC_VP5:
-        case VLC_CODEC_VP6:
-        case VLC_CODEC_VP6F:
-        case VLC_CODEC_VP8:
-            dpb_size = 3;
-            break;
-        default:
-            dpb_size = 2;
-            break;
-        }
-        picture_pool_t *pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video,
-                            dpb_size + p_dec->i_extra_picture_buffers + 1 );
-
-        if( pool == NULL)
+        p_owner->out_pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video,
+                                                        pool_size );
+        if( p_owner->out_pool == NULL )
         {
-            msg_Err(p_dec, "Failed to create a pool of %d %4.4s pictures",
-                           dpb_size + p_dec->i_extra_picture_buffers + 1,
-                           (char*)&p_dec->fmt_out.video.i_chroma);
+            msg_Err(p_dec, "Failed to create a pool of %u %4.4s pictures",
+                           pool_size, (char*)&p_dec->fmt_out.video.i_chroma);
             vlc_fifo_Unlock(p_owner->p_fifo);
             goto error;
         }
-
-        p_owner->out_pool = pool;
+    }
+    else if ( picture_pool_GetSize( p_owner->out_pool ) < pool_size )
+    {
+        if( picture_pool_Resize( p_owner->out_pool, pool_size ) )
+            msg_Warn(p_dec, "Failed to grow the pool to %u %4.4s pictures",
+                     pool_size, (char*)&p_dec->fmt_out.video.i_chroma);
+        else
+            msg_Dbg(p_dec, "growing the pool to %u pictures", pool_size);
     }
 
     vout_configuration_t cfg = {
@@ -799,6 +935,9 @@ static vlc_decoder_device * ModuleThread_GetDecoderDevice( decoder_t *p_dec )
     if( !var_InheritBool( p_dec, "hw-dec" ) )
         return NULL;
 
+    /* Hardware decoders may fail for lack of resources: do not remember it */
+    p_owner->probe_transient = true;
+
     int created_vout = CreateVoutIfNeeded(p_owner);
     if (created_vout == -1)
         return NULL;  // error
@@ -1038,6 +1177,19 @@ static inline void DecoderUpdatePreroll( vlc_tick_t *pi_preroll, const vlc_frame
         *pi_preroll = __MIN( *pi_preroll, p->i_pts );
 }
 
+static void TracePacketized( vlc_input_decoder_t *p_owner,
+                             decoder_t *p_packetizer,
+                             const vlc_frame_t *frame )
+{
+    struct vlc_tracer *tracer = vlc_object_get_tracer( &p_packetizer->obj );
+
+    if( tracer == NULL )
+        return;
+    for( ; frame != NULL; frame = frame->p_next )
+        vlc_tracer_TraceStreamDTS( tracer, "PACKETIZER", p_owner->psz_id,
+                                   "OUT", frame->i_pts, frame->i_dts );
+}
+
 #ifdef ENABLE_SOUT
 
 static void DecoderSendSubstream(vlc_input_decoder_t *p_owner)
@@ -1091,6 +1243,8 @@ static void DecoderThread_ProcessSout( vlc_input_decoder_t *p_owner, vlc_frame_t
     while( ( sout_frame =
                  p_dec->pf_packetize( p_dec, ppframe ) ) )
     {
+        TracePacketized( p_owner, p_dec, sout_frame );
+
         if( p_owner->p_sout_input == NULL )
         {
             vlc_fifo_Lock(p_owner->p_fifo);
@@ -1174,13 +1328,21 @@ static void DecoderPlayCc( vlc_input_decoder_t *p_owner, vlc_frame_t *p_cc,
     uint64_t i_bitmap = p_owner->cc.desc.i_608_channels |
                         p_owner->cc.desc.i_708_channels;
 
-    for( int i=0; i_bitmap > 0; i_bitmap >>= 1, i++ )
+    /* The last created decoder gets the original, others a copy */
+    int i_last = -1;
+    for( int i=0; i<MAX_CC_DECODERS; i++ )
+    {
+        if( ((i_bitmap >> i) & 1) && p_owner->cc.pp_decoder[i] )
+            i_last = i;
+    }
+
+    for( int i=0; i<=i_last; i++ )
     {
         vlc_input_decoder_t *p_ccowner = p_owner->cc.pp_decoder[i];
-        if( !p_ccowner )
+        if( !((i_bitmap >> i) & 1) || !p_ccowner )
             continue;
 
-        if( i_bitmap > 1 )
+        if( i < i_last )
         {
             block_FifoPut( p_ccowner->p_fifo, block_Duplicate(p_cc) );
         }
@@ -1371,6 +1533,47 @@ static void ModuleThread_QueueThumbnail( decoder_t *p_dec, picture_t *p_pic )
 
 }
 
+/* Drops the decoded samples outside of the content of a gapless stream */
+static vlc_frame_t *DecoderTrimAudio( vlc_input_decoder_t *p_owner,
+                                      vlc_frame_t *p_audio )
+{
+    const audio_gapless_t *gapless = &p_owner->dec.fmt_in->audio_gapless;
+    const audio_format_t *fmt = &p_owner->fmt.audio;
+
+    if( ( gapless->i_priming == 0 && gapless->i_samples == 0 )
+     || !AOUT_FMT_LINEAR( fmt ) || fmt->i_rate == 0
+     || fmt->i_bytes_per_frame == 0 || fmt->i_frame_length != 1 )
+        return p_audio;
+
+    /* Position of the block in the stream */
+    const int64_t i_first = samples_from_vlc_tick( p_audio->i_pts - VLC_TICK_0,
+                                                   fmt->i_rate );
+    const int64_t i_count = p_audio->i_nb_samples;
+    int64_t i_start = (int64_t) gapless->i_priming - i_first;
+    int64_t i_end = gapless->i_samples == 0 ? i_count :
+        (int64_t) ( gapless->i_priming + gapless->i_samples ) - i_first;
+
+    if( i_start < 0 )
+        i_start = 0;
+    if( i_end > i_count )
+        i_end = i_count;
+    if( i_start == 0 && i_end == i_count )
+        return p_audio;
+    if( i_start >= i_end )
+    {
+        block_Release( p_audio );
+        return NULL;
+    }
+
+    p_audio->p_buffer += i_start * fmt->i_bytes_per_frame;
+    p_audio->i_nb_samples = i_end - i_start;
+    p_audio->i_buffer = p_audio->i_nb_samples * fmt->i_bytes_per_frame;
+    p_audio->i_pts += vlc_tick_from_samples( i_start, fmt->i_rate );
+    p_audio->i_length = vlc_tick_from_samples( p_audio->i_nb_samples,
+                                               fmt->i_rate );
+    return p_audio;
+}
+
 static int ModuleThread_PlayAudio( vlc_input_decoder_t *p_owner, vlc_frame_t *p_audio )
 {
     decoder_t *p_dec = &p_owner->dec;
@@ -1398,6 +1601,10 @@ static int ModuleThread_PlayAudio( vlc_input_decoder_t *p_owner, vlc_frame_t *p_
         return VLC_SUCCESS;
     }
 
+    p_audio = DecoderTrimAudio( p_owner, p_audio );
+    if( p_audio == NULL )
+        return VLC_SUCCESS;
+
     bool prerolled = p_owner->i_preroll_end != PREROLL_NONE;
     if( prerolled && p_owner->i_preroll_end > p_audio->i_pts )
     {
@@ -1532,7 +1739,30 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
                             frame->i_pts, frame->i_dts );
     }
 
+    if( unlikely( p_owner->fallback_wait_keyframe ) && frame != NULL )
+    {
+        /* The fallback decoder has no references: skip the frames that
+         * depend on the previous ones, the last picture stays displayed. */
+        if( frame->i_flags & BLOCK_FLAG_TYPE_MASK & ~BLOCK_FLAG_TYPE_I )
+        {
+            block_Release( frame );
+            return;
+        }
+        p_owner->fallback_wait_keyframe = false;
+    }
+
+    if( p_owner->keyframes_only && frame != NULL
+     && ( frame->i_flags & BLOCK_FLAG_TYPE_MASK & ~BLOCK_FLAG_TYPE_I ) )
+    {
+        block_Release( frame );
+        return;
+    }
+
+    vlc_tick_t decode_start = vlc_tick_now();
     int ret = p_dec->pf_decode( p_dec, frame );
+    if( frame != NULL )
+        decoder_Notify( p_owner, on_new_decode_stats,
+                        vlc_tick_now() - decode_start, p_owner->queue_depth );
     switch( ret )
     {
         case VLCDEC_SUCCESS:
@@ -1552,11 +1782,80 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
             else /* We prefer loosing this frame than an infinite recursion */
                 block_Release( frame );
             break;
+        case VLCDEC_FALLBACK:
+        {
+            struct decoder_probe_key key;
+            DecoderProbeKeyInit( &key, p_dec->fmt_in );
+
+            msg_Warn( p_dec, "decoder module \"%s\" failed, falling back",
+                      module_get_name( p_dec->p_module, false ) );
+            if( p_owner->probe_memo != NULL )
+                vlc_probe_memo_AddRuntimeFailure( p_owner->probe_memo,
+                                                  p_dec->p_module,
+                                                  &key, sizeof(key) );
+            RequestReload( p_owner );
+            if( unlikely( frame == NULL ) )
+                break;
+            if( p_dec->fmt_in->i_cat == VIDEO_ES )
+                p_owner->fallback_wait_keyframe = true;
+            if( !( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_RELOADED ) )
+            {
+                frame->i_flags |= BLOCK_FLAG_CORE_PRIVATE_RELOADED;
+                DecoderThread_ProcessInput( p_owner, frame );
+            }
+            else
+                block_Release( frame );
+            break;
+        }
         default:
             vlc_assert_unreachable();
     }
 }
 
+/**
+ * Applies the packetizer format change signaled by the pipelined packetizer
+ *
+ * The packetizer thread only publishes a new format once every frame of the
+ * previous format has been dequeued, so the decoder can be reloaded before
+ * decoding the next frame.
+ */
+static int DecoderThread_UpdatePipelineFormat( vlc_input_decoder_t *p_owner )
+{
+    decoder_t *p_dec = &p_owner->dec;
+    es_format_t fmt;
+    int ret = VLC_SUCCESS;
+
+    vlc_fifo_Lock( p_owner->p_fifo );
+    bool pending = p_owner->pipeline.fmt_pending;
+    if( pending )
+    {
+        ret = es_format_Copy( &fmt, &p_owner->pipeline.fmt );
+        p_owner->pipeline.fmt_pending = false;
+        vlc_cond_broadcast( &p_owner->wait_fifo );
+    }
+    vlc_fifo_Unlock( p_owner->p_fifo );
+
+    if( !pending )
+        return VLC_SUCCESS;
+    if( ret != VLC_SUCCESS )
+    {
+        p_owner->error = true;
+        return ret;
+    }
+
+    if( !es_format_IsSimilar( p_dec->fmt_in, &fmt ) )
+    {
+        msg_Dbg( p_dec, "restarting module due to input format change");
+
+        /* Drain the decoder module */
+        DecoderThread_DecodeBlock( p_owner, NULL );
+
+        ret = DecoderThread_Reload( p_owner, &fmt, RELOAD_DECODER );
+    }
+    es_format_Clean( &fmt );
+    return ret;
+}
+
 /**
  * Decode a frame
  *
@@ -1584,15 +1883,20 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_
             goto error;
     }
 
-    bool packetize = p_owner->p_packetizer != NULL;
+    /* With a pipelined packetizer, frames are already packetized and the
+     * preroll is updated by the packetizer thread. */
+    bool packetize = p_owner->p_packetizer != NULL && !p_owner->pipeline.enabled;
     if( frame )
     {
         if( frame->i_buffer <= 0 )
             goto error;
 
-        vlc_fifo_Lock(p_owner->p_fifo);
-        DecoderUpdatePreroll( &p_owner->i_preroll_end, frame );
-        vlc_fifo_Unlock(p_owner->p_fifo);
+        if( !p_owner->pipeline.enabled )
+        {
+            vlc_fifo_Lock(p_owner->p_fifo);
+            DecoderUpdatePreroll( &p_owner->i_preroll_end, frame );
+            vlc_fifo_Unlock(p_owner->p_fifo);
+        }
         if( unlikely( frame->i_flags & BLOCK_FLAG_CORE_PRIVATE_RELOADED ) )
         {
             /* This frame has already been packetized */
@@ -1600,6 +1904,10 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_
         }
     }
 
+    if( p_owner->pipeline.enabled
+     && DecoderThread_UpdatePipelineFormat( p_owner ) != VLC_SUCCESS )
+        goto error;
+
 #ifdef ENABLE_SOUT
     if( p_owner->p_sout != NULL )
     {
@@ -1616,6 +1924,8 @@ static void DecoderThread_ProcessInput( vlc_input_decoder_t *p_owner, vlc_frame_
         while( (packetized_frame =
                 p_packetizer->pf_packetize( p_packetizer, ppframe ) ) )
         {
+            TracePacketized( p_owner, p_packetizer, packetized_frame );
+
             if( !es_format_IsSimilar( p_dec->fmt_in, &p_packetizer->fmt_out ) )
             {
                 msg_Dbg( p_dec, "restarting module due to input format change");
@@ -1670,7 +1980,9 @@ static void DecoderThread_Flush( vlc_input_decoder_t *p_owner )
     if( p_owner->error )
         return;
 
-    if( p_packetizer != NULL && p_packetizer->pf_flush != NULL )
+    /* The pipelined packetizer is flushed by its own thread */
+    if( p_packetizer != NULL && p_packetizer->pf_flush != NULL
+     && !p_owner->pipeline.enabled )
         p_packetizer->pf_flush( p_packetizer );
 
     if ( p_dec->pf_flush != NULL )
@@ -1765,6 +2077,7 @@ static void *DecoderThread( void *p_data )
 
         vlc_cond_signal( &p_owner->wait_fifo );
 
+        p_owner->queue_depth = vlc_fifo_GetCount( p_owner->p_fifo );
         vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
         if( frame == NULL )
         {
@@ -1803,6 +2116,158 @@ static void *DecoderThread( void *p_data )
     return NULL;
 }
 
+static bool DecoderPipeline_IsStale( vlc_input_decoder_t *p_owner,
+                                     unsigned flush_gen )
+{
+    vlc_fifo_Assert( p_owner->p_fifo );
+    return p_owner->aborting
+        || atomic_load( &p_owner->pipeline.flush_gen ) != flush_gen;
+}
+
+/**
+ * Packetizes a frame (or drains the packetizer if frame is NULL) and queues
+ * the packetized frames to the decoder fifo
+ *
+ * \param flush_gen the flush generation when the frame was dequeued, output
+ * frames are dropped if the decoder was flushed in the meantime
+ */
+static void DecoderPipeline_Packetize( vlc_input_decoder_t *p_owner,
+                                       vlc_frame_t *frame, unsigned flush_gen )
+{
+    decoder_t *p_packetizer = p_owner->p_packetizer;
+    vlc_frame_t **ppframe = NULL;
+
+    if( frame != NULL )
+    {
+        if( frame->i_buffer == 0 )
+        {
+            block_Release( frame );
+            return;
+        }
+
+        vlc_fifo_Lock( p_owner->p_fifo );
+        DecoderUpdatePreroll( &p_owner->i_preroll_end, frame );
+        vlc_fifo_Unlock( p_owner->p_fifo );
+        ppframe = &frame;
+    }
+
+    vlc_frame_t *packetized_frame;
+    while( (packetized_frame =
+            p_packetizer->pf_packetize( p_packetizer, ppframe ) ) )
+    {
+        TracePacketized( p_owner, p_packetizer, packetized_frame );
+
+        bool fmt_changed = !es_format_IsSimilar( &p_owner->pipeline.fmt,
+                                                 &p_packetizer->fmt_out );
+
+        if( p_packetizer->pf_get_cc )
+            PacketizerGetCc( p_owner, p_packetizer );
+
+        vlc_fifo_Lock( p_owner->p_fifo );
+        if( fmt_changed )
+        {
+            /* The decoder must consume all frames of the previous format
+             * before being reloaded with the new one. */
+            while( ( !vlc_fifo_IsEmpty( p_owner->p_fifo )
+                  || p_owner->pipeline.fmt_pending )
+                && !DecoderPipeline_IsStale( p_owner, flush_gen ) )
+                vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+
+            if( !DecoderPipeline_IsStale( p_owner, flush_gen ) )
+            {
+                es_format_Clean( &p_owner->pipeline.fmt );
+                if( es_format_Copy( &p_owner->pipeline.fmt,
+                                    &p_packetizer->fmt_out ) == VLC_SUCCESS )
+                    p_owner->pipeline.fmt_pending = true;
+                else
+                    p_owner->error = true;
+            }
+        }
+        else
+        {
+            while( vlc_fifo_GetCount( p_owner->p_fifo ) >= DECODER_PIPELINE_DEPTH
+                && !DecoderPipeline_IsStale( p_owner, flush_gen ) )
+                vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+        }
+
+        if( DecoderPipeline_IsStale( p_owner, flush_gen ) )
+        {
+            vlc_fifo_Unlock( p_owner->p_fifo );
+            block_ChainRelease( packetized_frame );
+            continue;
+        }
+
+        vlc_fifo_QueueUnlocked( p_owner->p_fifo, packetized_frame );
+        vlc_fifo_Unlock( p_owner->p_fifo );
+    }
+
+    if( ppframe == NULL )
+    {
+        /* The packetizer is drained, now drain the decoder */
+        vlc_fifo_Lock( p_owner->p_fifo );
+        if( !DecoderPipeline_IsStale( p_owner, flush_gen ) )
+        {
+            p_owner->b_draining = true;
+            vlc_fifo_Signal( p_owner->p_fifo );
+        }
+        vlc_fifo_Unlock( p_owner->p_fifo );
+    }
+}
+
+/**
+ * The pipelined packetizer main loop
+ *
+ * Packetizing runs concurrently with the DecoderThread, so that parsing of
+ * the next frame overlaps with the decoding of the current one.
+ */
+static void *DecoderPipeline_Thread( void *p_data )
+{
+    vlc_input_decoder_t *p_owner = p_data;
+    block_fifo_t *fifo = p_owner->pipeline.fifo;
+    decoder_t *p_packetizer = p_owner->p_packetizer;
+
+    vlc_thread_set_name( "vlc-dec-pktz" );
+
+    vlc_fifo_Lock( fifo );
+    while( !p_owner->pipeline.aborting )
+    {
+        if( p_owner->pipeline.flushing )
+        {
+            p_owner->pipeline.flushing = false;
+            vlc_fifo_Unlock( fifo );
+
+            if( p_packetizer->pf_flush != NULL )
+                p_packetizer->pf_flush( p_packetizer );
+
+            vlc_fifo_Lock( fifo );
+            continue;
+        }
+
+        vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( fifo );
+        if( frame == NULL )
+        {
+            if( likely(!p_owner->pipeline.draining) )
+            {
+                vlc_fifo_Wait( fifo );
+                continue;
+            }
+            p_owner->pipeline.draining = false;
+        }
+
+        unsigned flush_gen = atomic_load( &p_owner->pipeline.flush_gen );
+        p_owner->pipeline.busy = true;
+        vlc_cond_signal( &p_owner->pipeline.wait );
+        vlc_fifo_Unlock( fifo );
+
+        DecoderPipeline_Packetize( p_owner, frame, flush_gen );
+
+        vlc_fifo_Lock( fifo );
+        p_owner->pipeline.busy = false;
+    }
+    vlc_fifo_Unlock( fifo );
+    return NULL;
+}
+
 static const struct decoder_owner_callbacks dec_video_cbs =
 {
     .video = {
@@ -1871,6 +2336,8 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->p_clock = cfg->clock;
     p_owner->i_preroll_end = PREROLL_NONE;
     p_owner->p_resource = cfg->resource;
+    p_owner->probe_memo = cfg->probe_memo;
+    p_owner->probe_transient = false;
     p_owner->cbs = cfg->cbs;
     p_owner->cbs_userdata = cfg->cbs_data;
     p_owner->p_aout = NULL;
@@ -1897,6 +2364,9 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->b_has_data = false;
 
     p_owner->error = false;
+    p_owner->queue_depth = 0;
+    p_owner->keyframes_only = fmt->i_cat == VIDEO_ES && cfg->sout == NULL
+                           && var_InheritBool( p_dec, "keyframes-only" );
 
     p_owner->flushing = false;
     p_owner->b_draining = false;
@@ -1906,6 +2376,17 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->mouse_event = NULL;
     p_owner->mouse_opaque = NULL;
 
+    p_owner->pipeline.enabled = false;
+    p_owner->pipeline.fifo = NULL;
+    p_owner->pipeline.flushing = false;
+    p_owner->pipeline.draining = false;
+    p_owner->pipeline.busy = false;
+    p_owner->pipeline.aborting = false;
+    p_owner->pipeline.fmt_pending = false;
+    atomic_init( &p_owner->pipeline.flush_gen, 0 );
+    vlc_cond_init( &p_owner->pipeline.wait );
+    es_format_Init( &p_owner->pipeline.fmt, fmt->i_cat, 0 );
+
     es_format_Init( &p_owner->fmt, fmt->i_cat, 0 );
 
     /* decoder fifo */
@@ -1928,7 +2409,8 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
             vlc_custom_create( p_parent, sizeof( decoder_t ), "packetizer" );
         if( p_owner->p_packetizer )
         {
-            if( LoadDecoder( p_owner->p_packetizer, true, &p_owner->pktz_fmt_in, fmt ) )
+            if( LoadDecoder( p_owner->p_packetizer, true, &p_owner->pktz_fmt_in,
+                             fmt, cfg->probe_memo, NULL ) )
             {
                 vlc_object_delete(p_owner->p_packetizer);
                 p_owner->p_packetizer = NULL;
@@ -1939,6 +2421,15 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
                 fmt = &p_owner->p_packetizer->fmt_out;
             }
         }
+
+        if( p_owner->p_packetizer != NULL
+         && var_InheritBool( p_parent, "dec-pipeline" ) )
+        {
+            p_owner->pipeline.fifo = block_FifoNew();
+            if( p_owner->pipeline.fifo != NULL
+             && es_format_Copy( &p_owner->pipeline.fmt, fmt ) == VLC_SUCCESS )
+                p_owner->pipeline.enabled = true;
+        }
     }
 
     switch( fmt->i_cat )
@@ -1961,7 +2452,8 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     }
 
     /* Find a suitable decoder/packetizer module */
-    if( LoadDecoder( p_dec, cfg->sout != NULL, &p_owner->dec_fmt_in, fmt ) )
+    if( LoadDecoder( p_dec, cfg->sout != NULL, &p_owner->dec_fmt_in, fmt,
+                     cfg->probe_memo, &p_owner->probe_transient ) )
         return p_owner;
 
     assert( p_dec->fmt_in->i_cat == p_dec->fmt_out.i_cat && fmt->i_cat == p_dec->fmt_in->i_cat);
@@ -2090,6 +2582,9 @@ static void DeleteDecoder( vlc_input_decoder_t *p_owner, enum es_format_category
         vlc_meta_Delete( p_owner->p_description );
 
     block_FifoRelease( p_owner->p_fifo );
+    if( p_owner->pipeline.fifo != NULL )
+        block_FifoRelease( p_owner->pipeline.fifo );
+    es_format_Clean( &p_owner->pipeline.fmt );
     decoder_Destroy( p_owner->p_packetizer );
     decoder_Destroy( &p_owner->dec );
 }
@@ -2155,6 +2650,14 @@ decoder_New( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     }
 #endif
 
+    if( p_owner->pipeline.enabled
+     && vlc_clone( &p_owner->pipeline.thread, DecoderPipeline_Thread, p_owner ) )
+    {
+        msg_Warn( p_dec, "cannot spawn packetizer thread, "
+                  "packetizing in the decoder thread" );
+        p_owner->pipeline.enabled = false;
+    }
+
     if( !vlc_input_decoder_IsSynchronous( p_owner ) )
     {
         /* Spawn the decoder thread in asynchronous scenario. */
@@ -2214,11 +2717,21 @@ void vlc_input_decoder_Delete( vlc_input_decoder_t *p_owner )
 {
     decoder_t *p_dec = &p_owner->dec;
 
+    if( p_owner->pipeline.enabled )
+    {
+        vlc_fifo_Lock( p_owner->pipeline.fifo );
+        p_owner->pipeline.aborting = true;
+        vlc_fifo_Signal( p_owner->pipeline.fifo );
+        vlc_fifo_Unlock( p_owner->pipeline.fifo );
+    }
+
     vlc_fifo_Lock( p_owner->p_fifo );
     p_owner->aborting = true;
     p_owner->flushing = true;
     p_owner->b_waiting = false;
     vlc_fifo_Signal( p_owner->p_fifo );
+    /* Unblock the pipelined packetizer waiting for the decoder */
+    vlc_cond_broadcast( &p_owner->wait_fifo );
 
     /* Make sure we aren't waiting/decoding anymore */
     vlc_cond_signal( &p_owner->wait_request );
@@ -2251,6 +2764,8 @@ void vlc_input_decoder_Delete( vlc_input_decoder_t *p_owner )
     }
     vlc_fifo_Unlock( p_owner->p_fifo );
 
+    if( p_owner->pipeline.enabled )
+        vlc_join( p_owner->pipeline.thread, NULL );
     if( !vlc_input_decoder_IsSynchronous( p_owner ) )
         vlc_join( p_owner->thread, NULL );
 
@@ -2283,17 +2798,26 @@ void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, vlc_frame_t *frame,
         return;
     }
 
-    vlc_fifo_Lock( p_owner->p_fifo );
+    /* With a pipelined packetizer, the input fifo is the packetizer one */
+    block_fifo_t *fifo = p_owner->p_fifo;
+    vlc_cond_t *wait = &p_owner->wait_fifo;
+    if( p_owner->pipeline.enabled )
+    {
+        fifo = p_owner->pipeline.fifo;
+        wait = &p_owner->pipeline.wait;
+    }
+
+    vlc_fifo_Lock( fifo );
     if( !b_do_pace )
     {
         /* FIXME: ideally we would check the time amount of data
          * in the FIFO instead of its size. */
         /* 400 MiB, i.e. ~ 50mb/s for 60s */
-        if( vlc_fifo_GetBytes( p_owner->p_fifo ) > 400*1024*1024 )
+        if( vlc_fifo_GetBytes( fifo ) > 400*1024*1024 )
         {
             msg_Warn( &p_owner->dec, "decoder/packetizer fifo full (data not "
                       "consumed quickly enough), resetting fifo!" );
-            block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+            block_ChainRelease( vlc_fifo_DequeueAllUnlocked( fifo ) );
             frame->i_flags |= BLOCK_FLAG_DISCONTINUITY;
         }
     }
@@ -2302,18 +2826,30 @@ void vlc_input_decoder_Decode( vlc_input_decoder_t *p_owner, vlc_frame_t *frame,
     {   /* The FIFO is not consumed when waiting, so pacing would deadlock VLC.
          * Locking is not necessary as b_waiting is only read, not written by
          * the decoder thread. */
-        while( vlc_fifo_GetCount( p_owner->p_fifo ) >= 10 )
-            vlc_fifo_WaitCond( p_owner->p_fifo, &p_owner->wait_fifo );
+        while( vlc_fifo_GetCount( fifo ) >= 10 )
+            vlc_fifo_WaitCond( fifo, wait );
     }
 
-    vlc_fifo_QueueUnlocked( p_owner->p_fifo, frame );
-    vlc_fifo_Unlock( p_owner->p_fifo );
+    vlc_fifo_QueueUnlocked( fifo, frame );
+    vlc_fifo_Unlock( fifo );
 }
 
 bool vlc_input_decoder_IsEmpty( vlc_input_decoder_t * p_owner )
 {
     assert( !p_owner->b_waiting );
 
+    if( p_owner->pipeline.enabled )
+    {
+        /* Frames being packetized are not yet in the decoder fifo */
+        block_fifo_t *fifo = p_owner->pipeline.fifo;
+        vlc_fifo_Lock( fifo );
+        bool pending = !vlc_fifo_IsEmpty( fifo ) || p_owner->pipeline.busy
+                    || p_owner->pipeline.draining;
+        vlc_fifo_Unlock( fifo );
+        if( pending )
+            return false;
+    }
+
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !vlc_fifo_IsEmpty( p_owner->p_fifo ) || p_owner->b_draining )
     {
@@ -2356,6 +2892,17 @@ void vlc_input_decoder_Drain( vlc_input_decoder_t *p_owner )
         return;
     }
 
+    if( p_owner->pipeline.enabled )
+    {
+        /* The packetizer thread will request the decoder to drain once the
+         * packetizer is drained. */
+        vlc_fifo_Lock( p_owner->pipeline.fifo );
+        p_owner->pipeline.draining = true;
+        vlc_fifo_Signal( p_owner->pipeline.fifo );
+        vlc_fifo_Unlock( p_owner->pipeline.fifo );
+        return;
+    }
+
     vlc_fifo_Lock( p_owner->p_fifo );
     p_owner->b_draining = true;
     vlc_fifo_Signal( p_owner->p_fifo );
@@ -2370,10 +2917,26 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
 {
     enum es_format_category_e cat = p_owner->dec.fmt_in->i_cat;
 
+    if( p_owner->pipeline.enabled )
+    {
+        block_fifo_t *fifo = p_owner->pipeline.fifo;
+        vlc_fifo_Lock( fifo );
+        block_ChainRelease( vlc_fifo_DequeueAllUnlocked( fifo ) );
+        p_owner->pipeline.flushing = true;
+        p_owner->pipeline.draining = false;
+        /* Frames being packetized will be dropped */
+        atomic_fetch_add( &p_owner->pipeline.flush_gen, 1 );
+        vlc_fifo_Signal( fifo );
+        vlc_cond_signal( &p_owner->pipeline.wait );
+        vlc_fifo_Unlock( fifo );
+    }
+
     vlc_fifo_Lock( p_owner->p_fifo );
 
     /* Empty the fifo */
     block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    if( p_owner->pipeline.enabled )
+        vlc_cond_broadcast( &p_owner->wait_fifo );
 
     /* Don't need to wait for the DecoderThread to flush. Indeed, if called a
      * second time, this function will clear the FIFO again before anything was
@@ -2382,6 +2945,11 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
     p_owner->flushing = true;
     p_owner->b_draining = false;
 
+    /* Generate a new thumbnail after a seek, even if the decoder is still
+     * waiting (buffering) since the previous one */
+    if( p_owner->dec.cbs == &dec_thumbnailer_cbs )
+        p_owner->b_first = true;
+
     /* Flush video/spu decoder when paused: increment frames_countdown in order
      * to display one frame/subtitle */
     if( p_owner->paused && ( cat == VIDEO_ES || cat == SPU_ES )
@@ -2479,6 +3047,7 @@ int vlc_input_decoder_SetCcState( vlc_input_decoder_t *p_owner, vlc_fourcc_t cod
             .sout = p_owner->p_sout,
             .input_type = INPUT_TYPE_NONE,
             .cbs = NULL, .cbs_data = NULL,
+            .probe_memo = p_owner->probe_memo,
         };
 
         p_ccowner = vlc_input_decoder_New( VLC_OBJECT(p_dec), &cfg );
@@ -2663,7 +3232,17 @@ void vlc_input_decoder_GetStatus( vlc_input_decoder_t *p_owner,
 
 size_t vlc_input_decoder_GetFifoSize( vlc_input_decoder_t *p_owner )
 {
-    return block_FifoSize( p_owner->p_fifo );
+    vlc_fifo_Lock( p_owner->p_fifo );
+    size_t size = vlc_fifo_GetBytes( p_owner->p_fifo );
+    vlc_fifo_Unlock( p_owner->p_fifo );
+
+    if( p_owner->pipeline.enabled )
+    {
+        vlc_fifo_Lock( p_owner->pipeline.fifo );
+        size += vlc_fifo_GetBytes( p_owner->pipeline.fifo );
+        vlc_fifo_Unlock( p_owner->pipeline.fifo );
+    }
+    return size;
 }
 
 static bool DecoderHasVbi( decoder_t *dec )
@@ -43,6 +43,9 @@ struct vlc_input_decoder_callbacks {
                                void *userdata);
     void (*on_new_audio_stats)(vlc_input_decoder_t *decoder, unsigned decoded,
                                unsigned lost, unsigned played, void *userdata);
+    void (*on_new_decode_stats)(vlc_input_decoder_t *decoder,
+                                vlc_tick_t decode_time, size_t queue_depth,
+                                void *userdata);
 
     /* requests */
     int (*get_attachments)(vlc_input_decoder_t *decoder,
@@ -50,6 +53,8 @@ struct vlc_input_decoder_callbacks {
                            void *userdata);
 };
 
+struct vlc_probe_memo;
+
 struct vlc_input_decoder_cfg
 {
     const es_format_t *fmt;
@@ -60,6 +65,8 @@ struct vlc_input_decoder_cfg
     enum input_type input_type;
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_data;
+    /* Modules that failed for a codec are not probed again (can be NULL) */
+    struct vlc_probe_memo *probe_memo;
 };
 
 vlc_input_decoder_t *
@@ -69,6 +69,67 @@ static const char *demux_NameFromMimeType(const char *mime)
     return (type != NULL) ? type->name : "any";
 }
 
+static bool demux_IsTS(const uint8_t *buf, size_t len)
+{
+    /* Require a few consecutive sync bytes: 0x47 alone is too common */
+    if (len < 4 * 188)
+        return false;
+    for (size_t i = 0; i < 4; i++)
+        if (buf[i * 188] != 0x47)
+            return false;
+    return true;
+}
+
+/**
+ * Classifies the container from its first bytes.
+ *
+ * Only unambiguous signatures are listed: the matching module is probed
+ * first, as if forced, while the other modules remain as fallback.
+ */
+static const char *demux_NameFromContent(stream_t *s)
+{
+    static const struct
+    {
+        char name[8];
+        unsigned char offset;
+        unsigned char size;
+        char magic[12];
+    } magics[] =
+    {
+        { "mkv",  0, 4, "\x1A\x45\xDF\xA3" },
+        { "mp4",  4, 4, "ftyp" },
+        { "ogg",  0, 4, "OggS" },
+        { "flac", 0, 4, "fLaC" },
+        { "avi",  8, 4, "AVI " },
+        { "wav",  8, 4, "WAVE" },
+        { "ps",   0, 4, "\x00\x00\x01\xBA" },
+        { "asf",  0, 8, "\x30\x26\xB2\x75\x8E\x66\xCF\x11" },
+    };
+    const uint8_t *buf;
+    ssize_t len = vlc_stream_Peek(s, &buf, 4 * 188);
+
+    if (len <= 0)
+        return "any";
+
+    for (size_t i = 0; i < ARRAY_SIZE(magics); i++)
+    {
+        if ((size_t)len < magics[i].offset + magics[i].size)
+            continue;
+        if (memcmp(buf + magics[i].offset, magics[i].magic,
+                   magics[i].size) == 0)
+        {
+            /* RIFF based formats share the same header */
+            if (magics[i].offset == 8 && memcmp(buf, "RIFF", 4) != 0)
+                continue;
+            return magics[i].name;
+        }
+    }
+
+    if (demux_IsTS(buf, len))
+        return "ts";
+    return "any";
+}
+
 demux_t *demux_New( vlc_object_t *p_obj, const char *module, const char *url,
                     stream_t *s, es_out_t *out )
 {
@@ -79,6 +140,7 @@ demux_t *demux_New( vlc_object_t *p_obj, const char *module, const char *url,
 struct vlc_demux_private
 {
     module_t *module;
+    unsigned readdir_batches;
 };
 
 static void demux_DestroyDemux(demux_t *demux)
@@ -133,6 +195,7 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_input,
 
     assert(s != NULL);
     priv = vlc_stream_Private(p_demux);
+    priv->readdir_batches = 0;
 
     p_demux->p_input_item = p_input ? input_GetItem(p_input) : NULL;
     p_demux->psz_name = strdup(module);
@@ -173,6 +236,16 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_input,
             module = demux_NameFromMimeType(type);
             free(type);
         }
+
+        /* Narrow the probe list from the content, so that the expensive
+         * probes of the other modules are skipped in the common case */
+        if (strcasecmp(module, "any") == 0
+         && var_InheritBool(p_obj, "demux-sniff"))
+        {
+            module = demux_NameFromContent(s);
+            if (strcasecmp(module, "any") && !b_preparsing)
+                msg_Dbg(p_obj, "content looks like \"%s\"", module);
+        }
         strict = false;
     }
 
@@ -213,19 +286,27 @@ int demux_Demux(demux_t *demux)
         return demux->pf_demux(demux);
 
     if (demux->pf_readdir != NULL && demux->p_input_item != NULL) {
+        struct vlc_demux_private *priv = vlc_stream_Private(demux);
         input_item_node_t *node = input_item_node_Create(demux->p_input_item);
 
         if (unlikely(node == NULL))
             return VLC_DEMUXER_EGENERIC;
 
-        if (vlc_stream_ReadDir(demux, node)) {
+        int ret = vlc_stream_ReadDir(demux, node);
+        if (ret < 0) {
              input_item_node_Delete(node);
              return VLC_DEMUXER_EGENERIC;
         }
 
+        /* Playlists may be posted in several batches, so that the items
+         * show up while the rest of the file is being parsed. */
+        node->b_continued = priv->readdir_batches++ > 0;
+        node->b_partial = ret == VLC_DEMUXER_READDIR_MORE;
+
         if (es_out_Control(demux->out, ES_OUT_POST_SUBNODE, node))
             input_item_node_Delete(node);
-        return VLC_DEMUXER_EOF;
+        return ret == VLC_DEMUXER_READDIR_MORE ? VLC_DEMUXER_SUCCESS
+                                               : VLC_DEMUXER_EOF;
     }
 
     return VLC_DEMUXER_SUCCESS;
@@ -751,6 +832,7 @@ static demux_t *demux_FilterNew( demux_t *p_next, const char *p_name )
         return NULL;
 
     priv = vlc_stream_Private(p_demux);
+    priv->readdir_batches = 0;
     p_demux->s            = p_next;
     p_demux->p_input_item = NULL;
     p_demux->p_sys        = NULL;
@@ -53,6 +53,7 @@
 #include "item.h"
 
 #include "../stream_output/stream_output.h"
+#include "../modules/modules.h"
 
 #include <vlc_iso_lang.h>
 
@@ -133,6 +134,11 @@ struct es_out_id_t
     vlc_input_decoder_t   *p_dec_record;
     vlc_clock_t *p_clock;
 
+    /* Demuxed blocks kept for recording, oldest first */
+    block_t     *p_record_preroll;
+    block_t     **pp_record_preroll_last;
+    size_t      i_record_preroll_size;
+
     /* Used by vlc_clock_cbs, need to be const during the lifetime of the clock */
     bool master;
 
@@ -210,6 +216,7 @@ typedef struct
     vlc_tick_t  i_pts_jitter;
     int         i_cr_average;
     float       rate;
+    vlc_tick_t  i_jitter_check; /* next check of the adaptive jitter */
 
     /* */
     bool        b_paused;
@@ -227,12 +234,16 @@ typedef struct
 
     /* Record */
     sout_stream_t *p_sout_record;
+    vlc_tick_t    i_record_preroll;
 
     /* Used only to limit debugging output */
     int         i_prev_stream_level;
 
     unsigned    cc_decoder;
 
+    /* Decoders that failed to open for a given codec */
+    struct vlc_probe_memo probe_memo;
+
     es_out_t out;
 } es_out_sys_t;
 
@@ -445,6 +456,26 @@ decoder_on_new_audio_stats(vlc_input_decoder_t *decoder, unsigned decoded, unsig
                               memory_order_relaxed);
 }
 
+static void
+decoder_on_new_decode_stats(vlc_input_decoder_t *decoder, vlc_tick_t decode_time,
+                            size_t queue_depth, void *userdata)
+{
+    (void) decoder;
+
+    es_out_id_t *id = userdata;
+    es_out_t *out = id->out;
+    es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
+
+    if (!p_sys->p_input)
+        return;
+
+    struct input_stats *stats = input_priv(p_sys->p_input)->stats;
+    if (!stats)
+        return;
+
+    input_stats_AddDecode(stats, decode_time, queue_depth);
+}
+
 static int
 decoder_get_attachments(vlc_input_decoder_t *decoder,
                         input_attachment_t ***ppp_attachment,
@@ -468,6 +499,7 @@ static const struct vlc_input_decoder_callbacks decoder_cbs = {
     .on_thumbnail_ready = decoder_on_thumbnail_ready,
     .on_new_video_stats = decoder_on_new_video_stats,
     .on_new_audio_stats = decoder_on_new_audio_stats,
+    .on_new_decode_stats = decoder_on_new_decode_stats,
     .get_attachments = decoder_get_attachments,
 };
 
@@ -606,6 +638,7 @@ static void EsOutDelete( es_out_t *out )
     EsOutPropsCleanup( &p_sys->audio );
     EsOutPropsCleanup( &p_sys->sub );
 
+    vlc_probe_memo_Clean( &p_sys->probe_memo );
     free( p_sys );
 }
 
@@ -744,6 +777,71 @@ static void EsOutSetDelay( es_out_t *out, int i_cat, vlc_tick_t i_delay )
     EsOutUpdateDelayJitter(out);
 }
 
+/* Upper bound of the pre-roll of a single ES, whatever its duration */
+#define RECORD_PREROLL_MAX_SIZE (64 * 1024 * 1024)
+
+static void EsOutRecordPrerollClear( es_out_id_t *es )
+{
+    block_ChainRelease( es->p_record_preroll );
+    es->p_record_preroll = NULL;
+    es->pp_record_preroll_last = &es->p_record_preroll;
+    es->i_record_preroll_size = 0;
+}
+
+static void EsOutRecordPrerollAppend( es_out_sys_t *p_sys, es_out_id_t *es,
+                                      const block_t *p_block )
+{
+    block_t *p_dup = block_Duplicate( p_block );
+    if( unlikely(p_dup == NULL) )
+        return;
+
+    block_ChainLastAppend( &es->pp_record_preroll_last, p_dup );
+    es->i_record_preroll_size += p_dup->i_buffer;
+
+    /* Drop the oldest blocks out of the window. Undated blocks are kept
+     * with their dated predecessor. */
+    vlc_tick_t i_last = p_dup->i_dts != VLC_TICK_INVALID ? p_dup->i_dts
+                                                         : p_dup->i_pts;
+    for( ;; )
+    {
+        block_t *p_head = es->p_record_preroll;
+        if( p_head == p_dup )
+            break;
+
+        vlc_tick_t i_head = p_head->i_dts != VLC_TICK_INVALID ? p_head->i_dts
+                                                              : p_head->i_pts;
+        if( es->i_record_preroll_size <= RECORD_PREROLL_MAX_SIZE &&
+            ( i_last == VLC_TICK_INVALID || i_head == VLC_TICK_INVALID ||
+              i_last - i_head <= p_sys->i_record_preroll ) )
+            break;
+
+        es->p_record_preroll = p_head->p_next;
+        es->i_record_preroll_size -= p_head->i_buffer;
+        block_Release( p_head );
+    }
+}
+
+/* Hands the pre-roll over to the record decoder, without copying it again.
+ * The record stream output starts on a key frame of its own. */
+static void EsOutRecordPrerollFlush( es_out_sys_t *p_sys, es_out_id_t *es )
+{
+    block_t *p_block = es->p_record_preroll;
+
+    es->p_record_preroll = NULL;
+    es->pp_record_preroll_last = &es->p_record_preroll;
+    es->i_record_preroll_size = 0;
+
+    while( p_block != NULL )
+    {
+        block_t *p_next = p_block->p_next;
+
+        p_block->p_next = NULL;
+        vlc_input_decoder_Decode( es->p_dec_record, p_block,
+                                  input_priv(p_sys->p_input)->b_out_pace_control );
+        p_block = p_next;
+    }
+}
+
 static int EsOutSetRecord(  es_out_t *out, bool b_record, const char *dir_path )
 {
     es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
@@ -823,6 +921,11 @@ static int EsOutSetRecord(  es_out_t *out, bool b_record, const char *dir_path )
 
             if( p_es->p_dec_record && p_sys->b_buffering )
                 vlc_input_decoder_StartWait( p_es->p_dec_record );
+
+            if( p_es->p_dec_record )
+                EsOutRecordPrerollFlush( p_sys, p_es );
+            else
+                EsOutRecordPrerollClear( p_es );
         }
     }
     else
@@ -924,6 +1027,8 @@ static void EsOutChangePosition( es_out_t *out, bool b_flush,
         {
             if( b_flush && p_es != p_next_frame_es )
                 vlc_input_decoder_Flush( p_es->p_dec );
+            /* The pre-roll is only meaningful over continuous playback */
+            EsOutRecordPrerollClear( p_es );
             if( !p_sys->b_buffering )
             {
                 vlc_input_decoder_StartWait( p_es->p_dec );
@@ -1464,6 +1569,14 @@ static es_out_pgrm_t *EsOutProgramAdd( es_out_t *out, input_source_t *source, in
         return NULL;
     }
 
+    char *psz_group = var_InheritString( p_input, "clock-group" );
+    if( psz_group != NULL )
+    {
+        if( vlc_clock_main_JoinGroup( p_pgrm->p_main_clock, psz_group ) )
+            msg_Warn( p_input, "cannot join clock group %s", psz_group );
+        free( psz_group );
+    }
+
     p_pgrm->p_input_clock = input_clock_New( p_sys->rate );
     if( !p_pgrm->p_input_clock )
     {
@@ -1789,8 +1902,8 @@ static void EsOutProgramEpg( es_out_t *out, input_source_t *source,
     epg = *p_epg;
     epg.psz_name = EsOutProgramGetProgramName( p_pgrm );
 
-    input_item_SetEpg( p_item, &epg, p_sys->p_pgrm && (p_epg->i_source_id == p_sys->p_pgrm->i_id) );
-    input_SendEventMetaEpg( p_sys->p_input );
+    if( input_item_SetEpg( p_item, &epg, p_sys->p_pgrm && (p_epg->i_source_id == p_sys->p_pgrm->i_id) ) )
+        input_SendEventMetaEpg( p_sys->p_input );
 
     free( epg.psz_name );
 
@@ -2165,6 +2278,9 @@ static es_out_id_t *EsOutAddLocked( es_out_t *out, input_source_t *source,
     es->psz_title = EsGetTitle(es);
     es->p_dec = NULL;
     es->p_dec_record = NULL;
+    es->p_record_preroll = NULL;
+    es->pp_record_preroll_last = &es->p_record_preroll;
+    es->i_record_preroll_size = 0;
     es->p_clock = NULL;
     es->master = false;
     es->cc.type = 0;
@@ -2296,6 +2412,7 @@ static void EsOutCreateDecoder( es_out_t *out, es_out_id_t *p_es )
         .input_type = p_sys->input_type,
         .cbs = &decoder_cbs,
         .cbs_data = p_es,
+        .probe_memo = &p_sys->probe_memo,
     };
     dec = vlc_input_decoder_New( VLC_OBJECT(p_input), &cfg );
     if( dec != NULL )
@@ -2367,6 +2484,7 @@ static void EsOutDestroyDecoder( es_out_t *out, es_out_id_t *p_es )
         vlc_input_decoder_Delete( p_es->p_dec_record );
         p_es->p_dec_record = NULL;
     }
+    EsOutRecordPrerollClear( p_es );
 
     es_format_Clean( &p_es->fmt_out );
 }
@@ -2953,7 +3071,8 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
     /* Check for sout mode */
     if( input_priv(p_input)->p_sout )
     {
-        bool async = !sout_StreamIsSynchronous(input_priv(p_input)->p_sout);
+        bool async = input_priv(p_input)->b_offline
+                  || !sout_StreamIsSynchronous(input_priv(p_input)->p_sout);
 
         if( input_priv(p_input)->b_out_pace_control != async )
         {
@@ -2971,6 +3090,8 @@ static int EsOutSend( es_out_t *out, es_out_id_t *es, block_t *p_block )
             vlc_input_decoder_Decode( es->p_dec_record, p_dup,
                                       input_priv(p_input)->b_out_pace_control );
     }
+    else if( p_sys->i_record_preroll > 0 )
+        EsOutRecordPrerollAppend( p_sys, es, p_block );
     vlc_input_decoder_Decode( es->p_dec, p_block,
                               input_priv(p_input)->b_out_pace_control );
 
@@ -3093,6 +3214,54 @@ static void EsOutDelLocked( es_out_t *out, es_out_id_t *es )
     EsRelease(es);
 }
 
+/* Period of the adaptive jitter checks */
+#define JITTER_CHECK_PERIOD VLC_TICK_FROM_SEC(1)
+/* Maximum decrease of the jitter at each check. The outputs catch up by
+ * resampling the audio and dropping the late pictures, so keep it at a
+ * speed-up that goes unnoticed (2%). */
+#define JITTER_LOWER_STEP VLC_TICK_FROM_MS(20)
+
+/**
+ * Lowers the jitter compensation of a live source back towards the
+ * configured percentile of its observed PCR arrival jitter.
+ */
+static void EsOutAdaptJitter( es_out_t *out, es_out_pgrm_t *p_pgrm,
+                              vlc_tick_t i_now )
+{
+    es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
+    input_thread_private_t *priv = input_priv(p_sys->p_input);
+
+    if( p_sys->i_pts_jitter <= 0 )
+        return;
+    if( p_sys->i_jitter_check != VLC_TICK_INVALID && i_now < p_sys->i_jitter_check )
+        return;
+    p_sys->i_jitter_check = i_now + JITTER_CHECK_PERIOD;
+
+    vlc_tick_t i_target = input_clock_GetJitterTarget( p_pgrm->p_input_clock,
+                                                       priv->i_jitter_percentile );
+    if( i_target == VLC_TICK_INVALID )
+        return;
+
+    /* Jitter needed on top of the configured delays */
+    i_target = __MAX( 0, i_target - p_sys->i_pts_delay - p_sys->i_tracks_pts_delay );
+    if( i_target >= p_sys->i_pts_jitter )
+        return;
+
+    p_sys->i_pts_jitter = __MAX( i_target, p_sys->i_pts_jitter - JITTER_LOWER_STEP );
+    msg_Dbg( p_sys->p_input, "jitter lowered to %d ms (target %d ms)",
+             (int)MS_FROM_VLC_TICK(p_sys->i_pts_jitter),
+             (int)MS_FROM_VLC_TICK(i_target) );
+
+    const vlc_tick_t i_pts_delay = p_sys->i_pts_delay + p_sys->i_pts_jitter
+                                 + p_sys->i_tracks_pts_delay;
+    es_out_pgrm_t *pgrm;
+    vlc_list_foreach(pgrm, &p_sys->programs, node)
+    {
+        input_clock_LowerJitter( pgrm->p_input_clock, i_pts_delay );
+        vlc_clock_main_SetInputDejitter( pgrm->p_main_clock, i_pts_delay );
+    }
+}
+
 static void EsOutDel( es_out_t *out, es_out_id_t *es )
 {
     es_out_sys_t *p_sys = container_of(out, es_out_sys_t, out);
@@ -3440,6 +3609,9 @@ static int EsOutVaControlLocked( es_out_t *out, input_source_t *source,
                                         p_sys->i_pts_delay, i_new_jitter,
                                         p_sys->i_cr_average );
             }
+            else if( priv->i_jitter_percentile > 0 && !b_low_delay &&
+                     !input_CanPaceControl( p_sys->p_input ) )
+                EsOutAdaptJitter( out, p_pgrm, vlc_tick_now() );
         }
         return VLC_SUCCESS;
     }
@@ -4051,6 +4223,9 @@ es_out_t *input_EsOutNew( input_thread_t *p_input, input_source_t *main_source,
     vlc_list_init(&p_sys->es);
     vlc_list_init(&p_sys->es_slaves);
 
+    vlc_probe_memo_Init( &p_sys->probe_memo,
+        input_resource_GetDecoderFailures( input_priv(p_input)->p_resource ) );
+
     /* */
     EsOutPropsInit( &p_sys->video, true, p_input, input_type,
                     ES_OUT_ES_POLICY_AUTO,
@@ -4070,6 +4245,9 @@ es_out_t *input_EsOutNew( input_thread_t *p_input, input_source_t *main_source,
 
     p_sys->i_pause_date = -1;
 
+    p_sys->i_record_preroll =
+        VLC_TICK_FROM_SEC( var_InheritInteger( p_input, "input-record-preroll" ) );
+
     p_sys->rate = rate;
 
     p_sys->b_buffering = true;
@@ -92,10 +92,7 @@ typedef struct attribute_packed
 {
     ts_cmd_header_t header;
     es_out_id_t *p_es;
-    union{
-        block_t *p_block;
-        int     i_offset;  /* We do not use file > INT_MAX */
-    };
+    block_t *p_block;
 } ts_cmd_send_t;
 
 typedef struct attribute_packed
@@ -199,14 +196,9 @@ struct ts_storage_t
 #endif
     size_t  i_file_max; /* Max size in bytes */
     int64_t i_file_size;/* Current size in bytes */
-    FILE    *p_filew;   /* FILE handle for data writing */
-    FILE    *p_filer;   /* FILE handle for data reading */
-
-    /* */
-    uint8_t *p_cmd_r;
-    uint8_t *p_cmd_w;
-    uint8_t *p_cmd_buf;
-    size_t   i_cmd_buf;
+    int64_t i_file_read;/* Bytes already read back */
+    FILE    *p_filew;   /* FILE handle for commands and data writing */
+    FILE    *p_filer;   /* FILE handle for commands and data reading */
 };
 
 typedef struct
@@ -295,11 +287,10 @@ static void         *TsRun( void * );
 
 static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size_max );
 static void         TsStorageDelete( ts_storage_t * );
-static void         TsStoragePack( ts_storage_t *p_storage );
 static bool         TsStorageIsFull( ts_storage_t *, const ts_cmd_t *p_cmd );
 static bool         TsStorageIsEmpty( ts_storage_t * );
-static void         TsStoragePushCmd( ts_storage_t *, const ts_cmd_t *p_cmd, bool b_flush );
-static void         TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush );
+static void         TsStoragePushCmd( ts_storage_t *, ts_cmd_t *p_cmd );
+static int          TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush );
 
 static void CmdClean( ts_cmd_t * );
 
@@ -1004,14 +995,13 @@ static void TsPushCmd( ts_thread_t *p_ts, ts_cmd_t *p_cmd )
         }
         else
         {
-            TsStoragePack( p_ts->p_storage_w );
             p_ts->p_storage_w->p_next = p_storage;
             p_ts->p_storage_w = p_storage;
         }
     }
 
     /* TODO return error and warn the user (but only once) */
-    TsStoragePushCmd( p_ts->p_storage_w, p_cmd, p_ts->p_storage_r == p_ts->p_storage_w );
+    TsStoragePushCmd( p_ts->p_storage_w, p_cmd );
 
     vlc_cond_signal( &p_ts->wait );
 
@@ -1021,20 +1011,24 @@ static int TsPopCmdLocked( ts_thread_t *p_ts, ts_cmd_t *p_cmd, bool b_flush )
 {
     vlc_mutex_assert( &p_ts->lock );
 
-    if( TsStorageIsEmpty( p_ts->p_storage_r ) )
-        return VLC_EGENERIC;
+    int i_ret;
+    do
+    {
+        if( TsStorageIsEmpty( p_ts->p_storage_r ) )
+            return VLC_EGENERIC;
 
-    TsStoragePopCmd( p_ts->p_storage_r, p_cmd, b_flush );
+        i_ret = TsStoragePopCmd( p_ts->p_storage_r, p_cmd, b_flush );
 
-    while( TsStorageIsEmpty( p_ts->p_storage_r ) )
-    {
-        ts_storage_t *p_next = p_ts->p_storage_r->p_next;
-        if( !p_next )
-            break;
+        while( TsStorageIsEmpty( p_ts->p_storage_r ) )
+        {
+            ts_storage_t *p_next = p_ts->p_storage_r->p_next;
+            if( !p_next )
+                break;
 
-        TsStorageDelete( p_ts->p_storage_r );
-        p_ts->p_storage_r = p_next;
-    }
+            TsStorageDelete( p_ts->p_storage_r );
+            p_ts->p_storage_r = p_next;
+        }
+    } while( i_ret != VLC_SUCCESS );
 
     return VLC_SUCCESS;
 }
@@ -1222,9 +1216,6 @@ static void *TsRun( void *p_data )
 /*****************************************************************************
  *
  *****************************************************************************/
-#define MAX_COMMAND_SIZE sizeof(ts_cmd_t)
-#define TS_STORAGE_COMMAND_PREALLOC 30000
-
 static const size_t TsStorageSizeofCommand[] =
 {
     [C_ADD] = sizeof(ts_cmd_add_t),
@@ -1275,19 +1266,8 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
     /* */
     p_storage->i_file_max = i_tmp_size_max;
     p_storage->i_file_size = 0;
+    p_storage->i_file_read = 0;
 
-    /* */
-    p_storage->p_cmd_buf = vlc_alloc( TS_STORAGE_COMMAND_PREALLOC, MAX_COMMAND_SIZE );
-    p_storage->i_cmd_buf = TS_STORAGE_COMMAND_PREALLOC * MAX_COMMAND_SIZE;
-    p_storage->p_cmd_w = p_storage->p_cmd_buf;
-    p_storage->p_cmd_r = p_storage->p_cmd_buf;
-    //fprintf( stderr, "\nSTORAGE name=%s size=%d KiB\n", p_storage->psz_file, p_storage->i_cmd_max * sizeof(*p_storage->p_cmd) /1024 );
-
-    if( !p_storage->p_cmd_buf )
-    {
-        TsStorageDelete( p_storage );
-        return NULL;
-    }
     return p_storage;
 error:
     free( psz_file );
@@ -1297,15 +1277,13 @@ error:
 
 static void TsStorageDelete( ts_storage_t *p_storage )
 {
-    while( p_storage->p_cmd_r < p_storage->p_cmd_w )
+    while( !TsStorageIsEmpty( p_storage ) )
     {
         ts_cmd_t cmd;
 
-        TsStoragePopCmd( p_storage, &cmd, true );
-
-        CmdClean( &cmd );
+        if( TsStoragePopCmd( p_storage, &cmd, true ) == VLC_SUCCESS )
+            CmdClean( &cmd );
     }
-    free( p_storage->p_cmd_buf );
 
     fclose( p_storage->p_filer );
     fclose( p_storage->p_filew );
@@ -1316,113 +1294,119 @@ static void TsStorageDelete( ts_storage_t *p_storage )
     free( p_storage );
 }
 
-static void TsStoragePack( ts_storage_t *p_storage )
+static size_t TsStorageSizeofData( const ts_cmd_t *p_cmd )
 {
-    /* Try to release a bit of memory */
-    if( (size_t)(p_storage->p_cmd_w - p_storage->p_cmd_buf) == p_storage->i_cmd_buf )
-        return;
-
-    size_t i_realloc = p_storage->p_cmd_w - p_storage->p_cmd_buf;
-    uint8_t *p_realloc = realloc( p_storage->p_cmd_buf, i_realloc );
-    if( p_realloc )
-    {
-        p_storage->p_cmd_r = p_realloc + (p_storage->p_cmd_r - p_storage->p_cmd_buf);
-        p_storage->p_cmd_w = p_realloc + i_realloc;
-        p_storage->i_cmd_buf = i_realloc;
-        p_storage->p_cmd_buf = p_realloc;
-    }
+    if( p_cmd->header.i_type != C_SEND )
+        return 0;
+    return sizeof(*p_cmd->send.p_block) + p_cmd->send.p_block->i_buffer;
 }
 
 static bool TsStorageIsFull( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
 {
-    if( p_cmd && p_cmd->header.i_type == C_SEND && p_storage->p_cmd_w )
-    {
-        size_t i_size = sizeof(*p_cmd->send.p_block) + p_cmd->send.p_block->i_buffer;
+    size_t i_size = TsStorageSizeofCommand[p_cmd->header.i_type]
+                  + TsStorageSizeofData( p_cmd );
 
-        if( p_storage->i_file_size + i_size >= p_storage->i_file_max )
-            return true;
-    }
-    return (size_t)(p_storage->p_cmd_w - p_storage->p_cmd_buf) > p_storage->i_cmd_buf - MAX_COMMAND_SIZE;
+    /* A single oversized command still gets its own storage */
+    return p_storage->i_file_size > 0 &&
+           p_storage->i_file_size + i_size >= p_storage->i_file_max;
 }
 
 static bool TsStorageIsEmpty( ts_storage_t *p_storage )
 {
-    return !p_storage || p_storage->p_cmd_r >= p_storage->p_cmd_w;
+    return !p_storage || p_storage->i_file_read >= p_storage->i_file_size;
 }
 
-static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bool b_flush )
+static void TsStoragePushCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd )
 {
     assert( !TsStorageIsFull( p_storage, p_cmd ) );
-    ts_cmd_t cmd;
-    memcpy(&cmd, p_cmd, TsStorageSizeofCommand[p_cmd->header.i_type]);
+    FILE *p_filew = p_storage->p_filew;
+    const size_t i_cmdsize = TsStorageSizeofCommand[p_cmd->header.i_type];
 
-    if( cmd.header.i_type == C_SEND )
+    /* The command is stored in the file, followed by the block for C_SEND,
+     * so that the memory used does not depend on the amount of commands */
+    bool b_ok = fwrite( p_cmd, i_cmdsize, 1, p_filew ) == 1;
+    if( b_ok && p_cmd->header.i_type == C_SEND )
     {
-        block_t *p_block = cmd.send.p_block;
-
-        cmd.send.p_block = NULL;
-        cmd.send.i_offset = ftell( p_storage->p_filew );
+        const block_t *p_block = p_cmd->send.p_block;
 
-        if( fwrite( p_block, sizeof(*p_block), 1, p_storage->p_filew ) != 1 )
-        {
-            block_Release( p_block );
-            return;
-        }
-        p_storage->i_file_size += sizeof(*p_block);
-        if( p_block->i_buffer > 0 )
-        {
-            if( fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_storage->p_filew ) != 1 )
-            {
-                block_Release( p_block );
-                return;
-            }
-        }
-        p_storage->i_file_size += p_block->i_buffer;
-        block_Release( p_block );
+        b_ok = fwrite( p_block, sizeof(*p_block), 1, p_filew ) == 1 &&
+               ( p_block->i_buffer == 0 ||
+                 fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_filew ) == 1 );
+    }
 
-        if( b_flush )
-            fflush( p_storage->p_filew );
+    if( !b_ok )
+    {
+        /* Drop the partially written command */
+        fseek( p_filew, p_storage->i_file_size, SEEK_SET );
+        CmdClean( p_cmd );
+        return;
     }
-    size_t i_cmdsize = TsStorageSizeofCommand[ cmd.header.i_type ];
-    memcpy( p_storage->p_cmd_w, &cmd, i_cmdsize );
-    p_storage->p_cmd_w += i_cmdsize;
+
+    p_storage->i_file_size += i_cmdsize + TsStorageSizeofData( p_cmd );
+    if( p_cmd->header.i_type == C_SEND )
+        block_Release( p_cmd->send.p_block );
 }
 
-static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush )
+static int TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush )
 {
     assert( !TsStorageIsEmpty( p_storage ) );
+    FILE *p_filer = p_storage->p_filer;
+
+    /* Make the pending writes visible to the reader (this is a no-op when
+     * nothing is buffered, e.g. once the writer moved to the next storage) */
+    fflush( p_storage->p_filew );
+
+    uint8_t *p_raw = (uint8_t *)p_cmd;
+    if( fread( p_raw, 1, 1, p_filer ) != 1 ||
+        (size_t)p_cmd->header.i_type >= ARRAY_SIZE(TsStorageSizeofCommand) )
+        goto error;
 
-    p_cmd->header.i_type = p_storage->p_cmd_r[0];
     size_t i_cmdsize = TsStorageSizeofCommand[ p_cmd->header.i_type ];
-    memcpy(p_cmd, p_storage->p_cmd_r, i_cmdsize);
-    p_storage->p_cmd_r += i_cmdsize;
+    if( fread( &p_raw[1], i_cmdsize - 1, 1, p_filer ) != 1 )
+        goto error;
+    p_storage->i_file_read += i_cmdsize;
 
     if( p_cmd->header.i_type == C_SEND )
     {
         block_t block;
 
-        if( !b_flush &&
-            !fseek( p_storage->p_filer, p_cmd->send.i_offset, SEEK_SET ) &&
-            fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
+        p_cmd->send.p_block = NULL;
+        if( fread( &block, sizeof(block), 1, p_filer ) != 1 )
+            goto error;
+        p_storage->i_file_read += sizeof(block) + block.i_buffer;
+
+        if( b_flush )
+        {
+            if( fseek( p_filer, block.i_buffer, SEEK_CUR ) )
+                goto error;
+            return VLC_SUCCESS;
+        }
+
+        block_t *p_block = block_Alloc( block.i_buffer );
+        if( p_block )
         {
-            block_t *p_block = block_Alloc( block.i_buffer );
-            if( p_block )
+            p_block->i_dts      = block.i_dts;
+            p_block->i_pts      = block.i_pts;
+            p_block->i_flags    = block.i_flags;
+            p_block->i_length   = block.i_length;
+            p_block->i_nb_samples = block.i_nb_samples;
+            if( fread( p_block->p_buffer, block.i_buffer, 1, p_filer ) != 1 &&
+                block.i_buffer > 0 )
             {
-                p_block->i_dts      = block.i_dts;
-                p_block->i_pts      = block.i_pts;
-                p_block->i_flags    = block.i_flags;
-                p_block->i_length   = block.i_length;
-                p_block->i_nb_samples = block.i_nb_samples;
-                p_block->i_buffer = fread( p_block->p_buffer, 1, block.i_buffer, p_storage->p_filer );
+                block_Release( p_block );
+                goto error;
             }
             p_cmd->send.p_block = p_block;
         }
-        else
-        {
-            //perror( "TsStoragePopCmd" );
-            p_cmd->send.p_block = block_Alloc( 1 );
-        }
+        else if( fseek( p_filer, block.i_buffer, SEEK_CUR ) )
+            goto error;
     }
+    return VLC_SUCCESS;
+
+error:
+    /* The rest of this storage cannot be read back */
+    p_storage->i_file_read = p_storage->i_file_size;
+    return VLC_EGENERIC;
 }
 
 /*****************************************************************************
@@ -297,4 +297,13 @@ static inline void input_SendEventBookmark(input_thread_t *p_input)
     });
 }
 
+static inline void input_SendEventWaitingAtEof(input_thread_t *p_input,
+                                               unsigned seek_count)
+{
+    input_SendEvent(p_input, &(struct vlc_input_event) {
+        .type = INPUT_EVENT_WAITING_AT_EOF,
+        .seek_count = seek_count,
+    });
+}
+
 #endif
@@ -43,6 +43,7 @@
 #include "resource.h"
 #include "stream.h"
 #include "stream_output/stream_output.h"
+#include "misc/thread_policy.h"
 
 #include <vlc_aout.h>
 #include <vlc_dialog.h>
@@ -84,6 +85,7 @@ static int InputSourceInit( input_source_t *in, input_thread_t *p_input,
                             const char *psz_mrl,
                             const char *psz_forced_demux, bool b_in_can_fail );
 static void InputSourceDestroy( input_source_t * );
+static bool InputIsPreloading( input_thread_t * );
 static void InputSourceMeta( input_thread_t *, input_source_t *, vlc_meta_t * );
 
 /* TODO */
@@ -125,7 +127,17 @@ int input_Start( input_thread_t *p_input )
     if( priv->type == INPUT_TYPE_PREPARSING )
         func = Preparse;
 
-    assert( !priv->is_running );
+    if( priv->is_running )
+    {
+        /* Let a preloaded input open its demuxer */
+        vlc_mutex_lock( &priv->lock_control );
+        assert( priv->is_preloading );
+        priv->is_preloading = false;
+        vlc_cond_signal( &priv->wait_control );
+        vlc_mutex_unlock( &priv->lock_control );
+        return VLC_SUCCESS;
+    }
+
     /* Create thread and wait for its readiness. */
     priv->is_running = !vlc_clone( &priv->thread, func, priv );
     if( !priv->is_running )
@@ -136,6 +148,30 @@ int input_Start( input_thread_t *p_input )
     return VLC_SUCCESS;
 }
 
+int input_Preload( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    assert( priv->type == INPUT_TYPE_NONE );
+    assert( !priv->is_running );
+    priv->is_preloading = true;
+    int ret = input_Start( p_input );
+    if( ret != VLC_SUCCESS )
+        priv->is_preloading = false;
+    return ret;
+}
+
+bool input_IsPreloaded( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    vlc_mutex_lock( &priv->lock_control );
+    bool preloaded = priv->is_preloading && priv->is_preloaded
+                  && !priv->is_stopped;
+    vlc_mutex_unlock( &priv->lock_control );
+    return preloaded;
+}
+
 /**
  * Request a running input thread to stop and die
  *
@@ -190,6 +226,12 @@ void input_SetPosition( input_thread_t *p_input, double f_position, bool b_fast
     input_ControlPush( p_input, INPUT_CONTROL_SET_POSITION, &param );
 }
 
+void input_SetWaitAtEof( input_thread_t *p_input )
+{
+    assert( !input_priv(p_input)->is_running );
+    input_priv(p_input)->b_wait_at_eof = true;
+}
+
 /**
  * Get the item from an input thread
  * FIXME it does not increase ref count of the item.
@@ -266,12 +308,19 @@ input_thread_t *input_Create( vlc_object_t *p_parent,
     priv->i_state = INIT_S;
     priv->is_running = false;
     priv->is_stopped = false;
+    priv->is_preloading = false;
+    priv->is_preloaded = false;
     priv->b_recording = false;
     priv->rate = 1.f;
     priv->normal_time = VLC_TICK_0;
     TAB_INIT( priv->i_attachment, priv->attachment );
     priv->p_sout   = NULL;
-    priv->b_out_pace_control = priv->type == INPUT_TYPE_THUMBNAILING;
+    priv->b_offline = priv->type == INPUT_TYPE_NONE
+                   && var_InheritBool( p_input, "offline" );
+    priv->b_out_pace_control = priv->type == INPUT_TYPE_THUMBNAILING
+                            || priv->b_offline;
+    priv->b_wait_at_eof = false;
+    priv->i_seek_count = 0;
     priv->p_renderer = p_renderer && priv->type != INPUT_TYPE_PREPARSING ?
                 vlc_renderer_item_hold( p_renderer ) : NULL;
 
@@ -339,7 +388,6 @@ input_thread_t *input_Create( vlc_object_t *p_parent,
         priv->p_resource = input_resource_Hold( p_resource );
     else
         priv->p_resource = input_resource_New( VLC_OBJECT( p_input ) );
-    input_resource_SetInput( priv->p_resource, p_input );
 
     /* Init control buffer */
     vlc_mutex_init( &priv->lock_control );
@@ -352,6 +400,7 @@ input_thread_t *input_Create( vlc_object_t *p_parent,
 
     priv->b_low_delay = var_InheritBool( p_input, "low-delay" );
     priv->i_jitter_max = VLC_TICK_FROM_MS(var_InheritInteger( p_input, "clock-jitter" ));
+    priv->i_jitter_percentile = var_InheritInteger( p_input, "clock-jitter-percentile" );
 
     /* Remove 'Now playing' info as it is probably outdated */
     input_item_SetNowPlaying( p_item, NULL );
@@ -363,6 +412,8 @@ input_thread_t *input_Create( vlc_object_t *p_parent,
     else
         priv->stats = NULL;
 
+    priv->thread_policy = vlc_thread_policy_New( VLC_OBJECT(p_input) );
+
     priv->p_es_out_display = input_EsOutNew( p_input, priv->master, priv->rate,
                                              priv->type );
     if( !priv->p_es_out_display )
@@ -398,6 +449,8 @@ static void Destroy(input_thread_t *input)
 
     if (priv->stats != NULL)
         input_stats_Destroy(priv->stats);
+    if (priv->thread_policy != NULL)
+        vlc_thread_policy_Release(priv->thread_policy);
 
     for (size_t i = 0; i < priv->i_control; i++)
     {
@@ -419,6 +472,8 @@ static void *Run( void *data )
     input_thread_private_t *priv = data;
     input_thread_t *p_input = &priv->input;
 
+    if( priv->thread_policy != NULL )
+        vlc_thread_policy_Enter( vlc_thread_policy_Hold( priv->thread_policy ) );
     vlc_thread_set_name("vlc-input");
 
     vlc_interrupt_set(&priv->interrupt);
@@ -432,6 +487,8 @@ static void *Run( void *data )
     }
 
     input_SendEventDead( p_input );
+    if( priv->thread_policy != NULL )
+        vlc_thread_policy_Leave();
     return NULL;
 }
 
@@ -440,6 +497,8 @@ static void *Preparse( void *data )
     input_thread_private_t *priv = data;
     input_thread_t *p_input = &priv->input;
 
+    if( priv->thread_policy != NULL )
+        vlc_thread_policy_Enter( vlc_thread_policy_Hold( priv->thread_policy ) );
     vlc_thread_set_name("vlc-preparse");
 
     vlc_interrupt_set(&priv->interrupt);
@@ -454,6 +513,8 @@ static void *Preparse( void *data )
     }
 
     input_SendEventDead( p_input );
+    if( priv->thread_policy != NULL )
+        vlc_thread_policy_Leave();
     return NULL;
 }
 
@@ -622,6 +683,7 @@ static void MainLoop( input_thread_t *p_input, bool b_interactive )
     bool b_pause_after_eof = b_interactive &&
                            var_InheritBool( p_input, "play-and-pause" );
     bool b_paused_at_eof = false;
+    unsigned i_waiting_at_eof_seek_count = UINT_MAX;
 
     demux_t *p_demux = input_priv(p_input)->master->p_demux;
     const bool b_can_demux = p_demux->pf_demux != NULL
@@ -658,6 +720,17 @@ static void MainLoop( input_thread_t *p_input, bool b_interactive )
                 msg_Dbg( p_input, "waiting decoder fifos to empty" );
                 i_wakeup = vlc_tick_now() + INPUT_IDLE_SLEEP;
             }
+            else if( input_priv(p_input)->b_wait_at_eof )
+            {
+                /* Wait for the next control (seek or stop) */
+                unsigned i_seek_count = input_priv(p_input)->i_seek_count;
+                if( i_waiting_at_eof_seek_count != i_seek_count )
+                {
+                    msg_Dbg( p_input, "waiting at EOF" );
+                    input_SendEventWaitingAtEof( p_input, i_seek_count );
+                    i_waiting_at_eof_seek_count = i_seek_count;
+                }
+            }
             /* Pause after eof only if the input is pausable.
              * This way we won't trigger timeshifting for nothing */
             else if( b_pause_after_eof && input_priv(p_input)->master->b_can_pause )
@@ -1258,6 +1331,10 @@ static int Init( input_thread_t * p_input )
     input_thread_private_t *priv = input_priv(p_input);
     input_source_t *master;
 
+    /* A preloaded input becomes the resource one once started */
+    if( !InputIsPreloading( p_input ) )
+        input_resource_SetInput( priv->p_resource, p_input );
+
     /* */
     input_ChangeState( p_input, OPENING_S, VLC_TICK_INVALID );
     input_SendEventCache( p_input, 0.0 );
@@ -1328,7 +1405,8 @@ static int Init( input_thread_t * p_input )
 #ifdef ENABLE_SOUT
     if( priv->type != INPUT_TYPE_PREPARSING && priv->p_sout )
     {
-        priv->b_out_pace_control = sout_StreamIsSynchronous(priv->p_sout);
+        priv->b_out_pace_control = priv->b_offline
+                                || sout_StreamIsSynchronous(priv->p_sout);
         msg_Dbg( p_input, "starting in %ssync mode",
                  priv->b_out_pace_control ? "a" : "" );
     }
@@ -1373,7 +1451,8 @@ error:
         if( input_priv(p_input)->p_sout )
             input_resource_PutSout( input_priv(p_input)->p_resource,
                                     input_priv(p_input)->p_sout );
-        input_resource_SetInput( input_priv(p_input)->p_resource, NULL );
+        if( !InputIsPreloading( p_input ) )
+            input_resource_SetInput( input_priv(p_input)->p_resource, NULL );
         if( input_priv(p_input)->p_resource )
         {
             input_resource_Release( input_priv(p_input)->p_resource );
@@ -1441,7 +1520,8 @@ static void End( input_thread_t * p_input )
     /* */
     input_resource_PutSout( input_priv(p_input)->p_resource,
                             input_priv(p_input)->p_sout );
-    input_resource_SetInput( input_priv(p_input)->p_resource, NULL );
+    if( !InputIsPreloading( p_input ) )
+        input_resource_SetInput( input_priv(p_input)->p_resource, NULL );
     if( input_priv(p_input)->p_resource )
     {
         input_resource_Release( input_priv(p_input)->p_resource );
@@ -1949,6 +2029,7 @@ static bool Control( input_thread_t *p_input,
         case INPUT_CONTROL_JUMP_POSITION:
         {
             const bool absolute = i_type == INPUT_CONTROL_SET_POSITION;
+            priv->i_seek_count++;
             if( priv->b_recording )
             {
                 msg_Err( p_input, "INPUT_CONTROL_SET_POSITION ignored while recording" );
@@ -1982,6 +2063,8 @@ static bool Control( input_thread_t *p_input,
             const bool absolute = i_type == INPUT_CONTROL_SET_TIME;
             int i_ret;
 
+            priv->i_seek_count++;
+
             if( priv->b_recording )
             {
                 msg_Err( p_input, "INPUT_CONTROL_SET_TIME ignored while recording" );
@@ -2518,6 +2601,42 @@ InputStreamHandleAnchor( input_thread_t *p_input, input_source_t *source,
     return VLC_SUCCESS;
 }
 
+static bool InputIsPreloading( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    vlc_mutex_lock( &priv->lock_control );
+    bool preloading = priv->is_preloading;
+    vlc_mutex_unlock( &priv->lock_control );
+    return preloading;
+}
+
+/* Waits for input_Start() if the input is preloading, returns false if it was
+ * stopped instead */
+static bool InputWaitPreload( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    vlc_mutex_lock( &priv->lock_control );
+    if( !priv->is_preloading )
+    {
+        vlc_mutex_unlock( &priv->lock_control );
+        return true;
+    }
+
+    msg_Dbg( p_input, "preloaded, waiting to be started" );
+    priv->is_preloaded = true;
+    while( priv->is_preloading && !priv->is_stopped )
+        vlc_cond_wait( &priv->wait_control, &priv->lock_control );
+    bool stopped = priv->is_stopped;
+    vlc_mutex_unlock( &priv->lock_control );
+
+    if( stopped )
+        return false;
+    input_resource_SetInput( priv->p_resource, p_input );
+    return true;
+}
+
 static demux_t *InputDemuxNew( input_thread_t *p_input, es_out_t *p_es_out,
                                input_source_t *p_source, const char *url,
                                const char *psz_demux, const char *psz_anchor )
@@ -2534,6 +2653,14 @@ static demux_t *InputDemuxNew( input_thread_t *p_input, es_out_t *p_es_out,
 
     p_stream = stream_FilterAutoNew( p_stream );
 
+    /* A preloaded input keeps its access opened, and prefetching, until it
+     * is started */
+    if( priv->master == p_source && !InputWaitPreload( p_input ) )
+    {
+        vlc_stream_Delete( p_stream );
+        return NULL;
+    }
+
     if( p_stream->pf_read == NULL && p_stream->pf_block == NULL
      && p_stream->pf_readdir == NULL )
     {   /* Combined access/demux, no stream filtering */
@@ -149,6 +149,9 @@ typedef enum input_event_type_e
 
     /* Thumbnail generation */
     INPUT_EVENT_THUMBNAIL_READY,
+
+    /* EOF reached, waiting for a seek (see input_SetWaitAtEof()) */
+    INPUT_EVENT_WAITING_AT_EOF,
 } input_event_type_e;
 
 #define VLC_INPUT_CAPABILITIES_SEEKABLE (1<<0)
@@ -307,6 +310,8 @@ struct vlc_input_event
         float subs_fps;
         /* INPUT_EVENT_THUMBNAIL_READY */
         picture_t *thumbnail;
+        /* INPUT_EVENT_WAITING_AT_EOF: number of seek requests handled */
+        unsigned seek_count;
     };
 };
 
@@ -325,6 +330,23 @@ input_thread_t * input_Create( vlc_object_t *p_parent,
 
 int input_Start( input_thread_t * );
 
+/**
+ * Start an input thread ahead of time.
+ *
+ * The thread opens the access and its stream filters, then waits before
+ * probing the demuxer until input_Start() is called. The input only becomes
+ * the one of the resource once started.
+ */
+int input_Preload( input_thread_t * );
+
+/**
+ * Tell if a preloading input waits for input_Start(), with its access opened.
+ *
+ * Once this returns true, the input can only fail after input_Start() or
+ * input_Stop().
+ */
+bool input_IsPreloaded( input_thread_t * );
+
 void input_Stop( input_thread_t * );
 
 void input_Close( input_thread_t * );
@@ -333,6 +355,19 @@ void input_SetTime( input_thread_t *, vlc_tick_t i_time, bool b_fast );
 
 void input_SetPosition( input_thread_t *, double f_position, bool b_fast );
 
+/**
+ * Keep the input alive at the end of the stream
+ *
+ * Instead of ending, the input sends INPUT_EVENT_WAITING_AT_EOF and waits for
+ * a seek (or input_Stop()). The event is sent once per seek request and
+ * carries the number of handled seek requests, so that the listener can
+ * ignore the ones sent before its last seek. This allows to generate several
+ * thumbnails from the same input.
+ *
+ * Must be called before input_Start().
+ */
+void input_SetWaitAtEof( input_thread_t * );
+
 /**
  * Set the delay of an ES identifier
  */
@@ -463,6 +498,8 @@ typedef struct input_thread_private_t
     int         i_state;
     bool        is_running;
     bool        is_stopped;
+    bool        is_preloading; /* waits for input_Start() before demuxing */
+    bool        is_preloaded;  /* access opened, waiting for input_Start() */
     bool        b_recording;
     float       rate;
     vlc_tick_t  normal_time;
@@ -474,9 +511,13 @@ typedef struct input_thread_private_t
     /* Delays */
     bool        b_low_delay;
     vlc_tick_t  i_jitter_max;
+    unsigned    i_jitter_percentile; /* 0 if the jitter never decreases */
 
     /* Output */
     bool            b_out_pace_control; /* XXX Move it ot es_sout ? */
+    bool            b_offline; /* paced by the outputs only */
+    bool            b_wait_at_eof;
+    unsigned        i_seek_count;
     sout_stream_t   *p_sout;            /* Idem ? */
     es_out_t        *p_es_out;
     es_out_t        *p_es_out_display;
@@ -510,6 +551,9 @@ typedef struct input_thread_private_t
     /* Stats counters */
     struct input_stats *stats;
 
+    /* Placement and priority of the threads, or NULL */
+    struct vlc_thread_policy *thread_policy;
+
     /* Buffer of pending actions */
     vlc_mutex_t lock_control;
     vlc_cond_t  wait_control;
@@ -703,9 +747,9 @@ void vlc_audio_replay_gain_MergeFromMeta( audio_replay_gain_t *p_dst,
 /* stats.c */
 typedef struct input_rate_t
 {
-    vlc_mutex_t lock;
-    uintmax_t updates;
-    uintmax_t value;
+    atomic_uintmax_t updates;
+    atomic_uintmax_t value;
+    /* Only used by input_stats_Compute() */
     struct
     {
         uintmax_t  value;
@@ -720,6 +764,8 @@ struct input_stats {
     atomic_uintmax_t demux_discontinuity;
     atomic_uintmax_t decoded_audio;
     atomic_uintmax_t decoded_video;
+    atomic_uintmax_t decode_time[INPUT_STATS_DECODE_TIME_BUCKETS];
+    atomic_size_t decoder_queue_max;
     atomic_uintmax_t played_abuffers;
     atomic_uintmax_t lost_abuffers;
     atomic_uintmax_t displayed_pictures;
@@ -730,6 +776,7 @@ struct input_stats {
 struct input_stats *input_stats_Create(void);
 void input_stats_Destroy(struct input_stats *);
 void input_rate_Add(input_rate_t *, uintmax_t);
+void input_stats_AddDecode(struct input_stats *, vlc_tick_t, size_t);
 void input_stats_Compute(struct input_stats *, input_stats_t*);
 
 #endif
@@ -892,37 +892,136 @@ static int InputItemAddInfo( input_item_t *p_i,
 }
 #endif
 
-void input_item_SetEpg( input_item_t *p_item, const vlc_epg_t *p_update, bool b_current_source )
+static bool EpgStrEquals( const char *a, const char *b )
 {
-    vlc_epg_t *p_epg = vlc_epg_Duplicate( p_update );
-    if( !p_epg )
-        return;
+    return a == b || (a != NULL && b != NULL && !strcmp( a, b ));
+}
+
+static bool EpgEventEquals( const vlc_epg_event_t *a, const vlc_epg_event_t *b )
+{
+    if( a->i_id != b->i_id || a->i_start != b->i_start ||
+        a->i_duration != b->i_duration || a->i_rating != b->i_rating ||
+        a->i_description_items != b->i_description_items ||
+        !EpgStrEquals( a->psz_name, b->psz_name ) ||
+        !EpgStrEquals( a->psz_short_description, b->psz_short_description ) ||
+        !EpgStrEquals( a->psz_description, b->psz_description ) )
+        return false;
+
+    for( int i = 0; i < a->i_description_items; i++ )
+        if( !EpgStrEquals( a->description_items[i].psz_key,
+                           b->description_items[i].psz_key ) ||
+            !EpgStrEquals( a->description_items[i].psz_value,
+                           b->description_items[i].psz_value ) )
+            return false;
+    return true;
+}
+
+/* Merges a new version of a table into the stored one, keeping the events
+ * that did not change instead of copying the whole schedule again.
+ * Returns whether the stored table changed. */
+static bool EpgMerge( vlc_epg_t *p_epg, const vlc_epg_t *p_update )
+{
+    vlc_epg_event_t **pp_event = NULL;
+    bool b_changed = p_epg->i_event != p_update->i_event ||
+                     p_epg->b_present != p_update->b_present;
+
+    if( p_update->i_event > 0 )
+    {
+        pp_event = vlc_alloc( p_update->i_event, sizeof(*pp_event) );
+        if( unlikely(pp_event == NULL) )
+            return false;
+    }
+
+    /* Both tables are sorted by start time */
+    size_t i_event = 0;
+    vlc_epg_event_t *p_current = NULL;
+    for( size_t i = 0, j = 0; i < p_update->i_event; i++ )
+    {
+        const vlc_epg_event_t *p_evt = p_update->pp_event[i];
+        vlc_epg_event_t *p_new = NULL;
+
+        while( j < p_epg->i_event && p_epg->pp_event[j]->i_start < p_evt->i_start )
+            j++;
+        if( j < p_epg->i_event && EpgEventEquals( p_epg->pp_event[j], p_evt ) )
+        {
+            p_new = p_epg->pp_event[j];
+            p_epg->pp_event[j++] = NULL;
+        }
+        else
+        {
+            p_new = vlc_epg_event_Duplicate( p_evt );
+            if( p_new == NULL )
+                continue;
+            b_changed = true;
+        }
+
+        if( p_update->p_current == p_evt )
+            p_current = p_new;
+        pp_event[i_event++] = p_new;
+    }
+
+    /* Drop the events that are gone or were replaced */
+    for( size_t j = 0; j < p_epg->i_event; j++ )
+        if( p_epg->pp_event[j] != NULL )
+        {
+            vlc_epg_event_Delete( p_epg->pp_event[j] );
+            b_changed = true;
+        }
+    free( p_epg->pp_event );
+    p_epg->pp_event = pp_event;
+    p_epg->i_event = i_event;
+
+    if( p_epg->p_current != p_current )
+    {
+        p_epg->p_current = p_current;
+        b_changed = true;
+    }
+    p_epg->b_present = p_update->b_present;
+
+    if( !EpgStrEquals( p_epg->psz_name, p_update->psz_name ) )
+    {
+        free( p_epg->psz_name );
+        p_epg->psz_name = p_update->psz_name ? strdup( p_update->psz_name ) : NULL;
+        b_changed = true;
+    }
+    return b_changed;
+}
+
+bool input_item_SetEpg( input_item_t *p_item, const vlc_epg_t *p_update, bool b_current_source )
+{
+    vlc_epg_t *p_epg = NULL;
+    bool b_changed;
 
     vlc_mutex_lock( &p_item->lock );
 
     /* */
-    vlc_epg_t **pp_epg = NULL;
     for( int i = 0; i < p_item->i_epg; i++ )
     {
         if( p_item->pp_epg[i]->i_source_id == p_update->i_source_id &&
             p_item->pp_epg[i]->i_id == p_update->i_id )
         {
-            pp_epg = &p_item->pp_epg[i];
+            p_epg = p_item->pp_epg[i];
             break;
         }
     }
 
-    /* replace with new version */
-    if( pp_epg )
+    /* merge the new version */
+    if( p_epg )
     {
-        vlc_epg_Delete( *pp_epg );
-        if( *pp_epg == p_item->p_epg_table ) /* current table can have changed */
+        b_changed = EpgMerge( p_epg, p_update );
+        if( p_epg == p_item->p_epg_table ) /* current table can have changed */
             p_item->p_epg_table = NULL;
-        *pp_epg = p_epg;
     }
     else
     {
+        p_epg = vlc_epg_Duplicate( p_update );
+        if( !p_epg )
+        {
+            vlc_mutex_unlock( &p_item->lock );
+            return false;
+        }
         TAB_APPEND( p_item->i_epg, p_item->pp_epg, p_epg );
+        b_changed = true;
     }
 
     if( b_current_source && p_epg->b_present )
@@ -930,6 +1029,9 @@ void input_item_SetEpg( input_item_t *p_item, const vlc_epg_t *p_update, bool b_
 
     vlc_mutex_unlock( &p_item->lock );
 
+    if( !b_changed )
+        return false;
+
 #ifdef EPG_DEBUG
     char *psz_epg;
     if( asprintf( &psz_epg, "EPG %s", p_epg->psz_name ? p_epg->psz_name : "unknown" ) < 0 )
@@ -967,6 +1069,7 @@ signal:
 #endif
     vlc_event_send( &p_item->event_manager,
                     &(vlc_event_t){ .type = vlc_InputItemInfoChanged, } );
+    return true;
 }
 
 void input_item_ChangeEPGSource( input_item_t *p_item, int i_source_id )
@@ -1243,6 +1346,8 @@ input_item_node_t *input_item_node_Create( input_item_t *p_input )
 
     p_node->i_children = 0;
     p_node->pp_children = NULL;
+    p_node->b_continued = false;
+    p_node->b_partial = false;
 
     return p_node;
 }
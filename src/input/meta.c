@@ -30,15 +30,186 @@
 #include <vlc_common.h>
 #include <vlc_url.h>
 #include <vlc_arrays.h>
+#include <vlc_atomic.h>
 #include <vlc_modules.h>
 #include <vlc_charset.h>
 
 #include "input_internal.h"
 #include "../preparser/art.h"
 
+/* Meta values are shared, immutable and reference-counted strings: copying
+ * the meta of an item only takes references. The values that tend to be
+ * the same across a library (artist, album, genre...) are also interned,
+ * so that a single copy of them is kept. */
+struct vlc_meta_str
+{
+    struct vlc_meta_str *next; /**< next in the hash bucket, if interned */
+    vlc_atomic_rc_t rc;
+    uint32_t hash;
+    bool interned;
+    char str[];
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    struct vlc_meta_str **buckets;
+    size_t size;
+    size_t count;
+} meta_strings = { VLC_STATIC_MUTEX, NULL, 0, 0 };
+
+static bool vlc_meta_IsInterned( vlc_meta_type_t meta_type )
+{
+    switch( meta_type )
+    {
+        case vlc_meta_Artist:
+        case vlc_meta_Genre:
+        case vlc_meta_Copyright:
+        case vlc_meta_Album:
+        case vlc_meta_Date:
+        case vlc_meta_Setting:
+        case vlc_meta_Language:
+        case vlc_meta_Publisher:
+        case vlc_meta_EncodedBy:
+        case vlc_meta_TrackTotal:
+        case vlc_meta_Director:
+        case vlc_meta_Season:
+        case vlc_meta_ShowName:
+        case vlc_meta_AlbumArtist:
+        case vlc_meta_DiscNumber:
+        case vlc_meta_DiscTotal:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint32_t vlc_meta_Hash( const char *str )
+{
+    uint32_t hash = 2166136261u; /* FNV-1a */
+    for( ; *str; str++ )
+        hash = (hash ^ (unsigned char)*str) * 16777619u;
+    return hash;
+}
+
+static void vlc_meta_StringsGrow( void )
+{
+    size_t size = meta_strings.size ? meta_strings.size * 2 : 256;
+    struct vlc_meta_str **buckets = calloc( size, sizeof(*buckets) );
+    if( unlikely(buckets == NULL) )
+        return; /* keep the longer chains */
+
+    for( size_t i = 0; i < meta_strings.size; i++ )
+    {
+        struct vlc_meta_str *ms = meta_strings.buckets[i];
+        while( ms != NULL )
+        {
+            struct vlc_meta_str *next = ms->next;
+            ms->next = buckets[ms->hash % size];
+            buckets[ms->hash % size] = ms;
+            ms = next;
+        }
+    }
+    free( meta_strings.buckets );
+    meta_strings.buckets = buckets;
+    meta_strings.size = size;
+}
+
+static struct vlc_meta_str *vlc_meta_StrNew( const char *str, uint32_t hash,
+                                             bool interned )
+{
+    size_t len = strlen( str ) + 1;
+    struct vlc_meta_str *ms = malloc( sizeof(*ms) + len );
+    if( unlikely(ms == NULL) )
+        return NULL;
+
+    ms->next = NULL;
+    vlc_atomic_rc_init( &ms->rc );
+    ms->hash = hash;
+    ms->interned = interned;
+    memcpy( ms->str, str, len );
+    return ms;
+}
+
+static char *vlc_meta_StrCreate( vlc_meta_type_t meta_type, const char *str )
+{
+    struct vlc_meta_str *ms;
+
+    if( !vlc_meta_IsInterned( meta_type ) )
+    {
+        ms = vlc_meta_StrNew( str, 0, false );
+        return ms != NULL ? ms->str : NULL;
+    }
+
+    uint32_t hash = vlc_meta_Hash( str );
+
+    vlc_mutex_lock( &meta_strings.lock );
+    if( meta_strings.size > 0 )
+        for( ms = meta_strings.buckets[hash % meta_strings.size];
+             ms != NULL; ms = ms->next )
+            if( ms->hash == hash && strcmp( ms->str, str ) == 0 )
+            {
+                vlc_atomic_rc_inc( &ms->rc );
+                vlc_mutex_unlock( &meta_strings.lock );
+                return ms->str;
+            }
+
+    if( meta_strings.count >= meta_strings.size )
+        vlc_meta_StringsGrow();
+
+    ms = NULL;
+    if( likely(meta_strings.size > 0) )
+        ms = vlc_meta_StrNew( str, hash, true );
+    if( likely(ms != NULL) )
+    {
+        struct vlc_meta_str **pp = &meta_strings.buckets[hash % meta_strings.size];
+        ms->next = *pp;
+        *pp = ms;
+        meta_strings.count++;
+    }
+    vlc_mutex_unlock( &meta_strings.lock );
+    return ms != NULL ? ms->str : NULL;
+}
+
+static char *vlc_meta_StrHold( char *str )
+{
+    struct vlc_meta_str *ms = container_of( str, struct vlc_meta_str, str );
+    vlc_atomic_rc_inc( &ms->rc );
+    return str;
+}
+
+static void vlc_meta_StrRelease( char *str )
+{
+    if( str == NULL )
+        return;
+
+    struct vlc_meta_str *ms = container_of( str, struct vlc_meta_str, str );
+
+    if( !ms->interned )
+    {
+        if( vlc_atomic_rc_dec( &ms->rc ) )
+            free( ms );
+        return;
+    }
+
+    /* Interned strings are only looked up and dropped with the lock held, so
+     * that a string cannot be found while it is being destroyed. */
+    vlc_mutex_lock( &meta_strings.lock );
+    if( vlc_atomic_rc_dec( &ms->rc ) )
+    {
+        struct vlc_meta_str **pp = &meta_strings.buckets[ms->hash % meta_strings.size];
+        while( *pp != ms )
+            pp = &(*pp)->next;
+        *pp = ms->next;
+        meta_strings.count--;
+        free( ms );
+    }
+    vlc_mutex_unlock( &meta_strings.lock );
+}
+
 struct vlc_meta_t
 {
-    char * ppsz_meta[VLC_META_TYPE_COUNT];
+    char * ppsz_meta[VLC_META_TYPE_COUNT]; /**< shared strings */
 
     vlc_dictionary_t extra_tags;
 
@@ -115,7 +286,7 @@ static void vlc_meta_FreeExtraKey( void *p_data, void *p_obj )
 void vlc_meta_Delete( vlc_meta_t *m )
 {
     for( int i = 0; i < VLC_META_TYPE_COUNT ; i++ )
-        free( m->ppsz_meta[i] );
+        vlc_meta_StrRelease( m->ppsz_meta[i] );
     vlc_dictionary_clear( &m->extra_tags, vlc_meta_FreeExtraKey, NULL );
     free( m );
 }
@@ -128,9 +299,10 @@ void vlc_meta_Delete( vlc_meta_t *m )
 
 void vlc_meta_Set( vlc_meta_t *p_meta, vlc_meta_type_t meta_type, const char *psz_val )
 {
-    free( p_meta->ppsz_meta[meta_type] );
     assert( psz_val == NULL || IsUTF8( psz_val ) );
-    p_meta->ppsz_meta[meta_type] = psz_val ? strdup( psz_val ) : NULL;
+    char *str = psz_val ? vlc_meta_StrCreate( meta_type, psz_val ) : NULL;
+    vlc_meta_StrRelease( p_meta->ppsz_meta[meta_type] );
+    p_meta->ppsz_meta[meta_type] = str;
 }
 
 const char *vlc_meta_Get( const vlc_meta_t *p_meta, vlc_meta_type_t meta_type )
@@ -188,8 +360,8 @@ void vlc_meta_Merge( vlc_meta_t *dst, const vlc_meta_t *src )
     {
         if( src->ppsz_meta[i] )
         {
-            free( dst->ppsz_meta[i] );
-            dst->ppsz_meta[i] = strdup( src->ppsz_meta[i] );
+            vlc_meta_StrRelease( dst->ppsz_meta[i] );
+            dst->ppsz_meta[i] = vlc_meta_StrHold( src->ppsz_meta[i] );
         }
     }
 
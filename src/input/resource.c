@@ -40,6 +40,7 @@
 #include "../stream_output/stream_output.h"
 #include "../audio_output/aout_internal.h"
 #include "../video_output/vout_internal.h"
+#include "../modules/modules.h"
 #include "input_interface.h"
 #include "event.h"
 #include "resource.h"
@@ -84,6 +85,9 @@ struct input_resource_t
 
     bool            b_aout_busy;
     audio_output_t *p_aout;
+
+    /* Modules that failed while decoding, kept across inputs */
+    struct vlc_probe_memo decoder_failures;
 };
 
 #define resource_GetFirstVoutRsc(resource) \
@@ -304,6 +308,25 @@ void input_resource_ResetAout( input_resource_t *p_resource )
         aout_Release( p_aout );
 }
 
+void input_resource_StopFreeAout( input_resource_t *p_resource )
+{
+    audio_output_t *p_aout = NULL;
+
+    vlc_mutex_lock( &p_resource->lock_hold );
+    if( p_resource->p_aout != NULL && !p_resource->b_aout_busy )
+    {
+        p_aout = p_resource->p_aout;
+        aout_Hold( p_aout );
+    }
+    vlc_mutex_unlock( &p_resource->lock_hold );
+
+    if( p_aout != NULL )
+    {
+        aout_OutputStopIdle( p_aout );
+        aout_Release( p_aout );
+    }
+}
+
 /* Common */
 input_resource_t *input_resource_New( vlc_object_t *p_parent )
 {
@@ -324,6 +347,7 @@ input_resource_t *input_resource_New( vlc_object_t *p_parent )
     p_resource->p_parent = p_parent;
     vlc_mutex_init( &p_resource->lock );
     vlc_mutex_init( &p_resource->lock_hold );
+    vlc_probe_memo_Init( &p_resource->decoder_failures, NULL );
     return p_resource;
 }
 
@@ -338,6 +362,7 @@ void input_resource_Release( input_resource_t *p_resource )
         aout_Release( p_resource->p_aout );
 
     vout_Release( p_resource->p_vout_dummy );
+    vlc_probe_memo_Clean( &p_resource->decoder_failures );
     free( p_resource );
 }
 
@@ -347,6 +372,11 @@ input_resource_t *input_resource_Hold( input_resource_t *p_resource )
     return p_resource;
 }
 
+struct vlc_probe_memo *input_resource_GetDecoderFailures( input_resource_t *p_resource )
+{
+    return &p_resource->decoder_failures;
+}
+
 void input_resource_SetInput( input_resource_t *p_resource, input_thread_t *p_input )
 {
     vlc_mutex_lock( &p_resource->lock );
@@ -373,13 +403,20 @@ static void input_resource_PutVoutLocked(input_resource_t *p_resource,
         *vout_state = vout_rsc->started ? INPUT_RESOURCE_VOUT_STOPPED
                                         : INPUT_RESOURCE_VOUT_NOTCHANGED;
 
+    const bool b_free = vout_rsc == resource_GetFirstVoutRsc(p_resource);
+
     if (vout_rsc->started)
     {
-        vout_StopDisplay(vout_rsc->vout);
+        /* Keep the display of the free vout running, so that the next input
+         * starts at once if its video format is the same */
+        if (b_free)
+            vout_ParkDisplay(vout_rsc->vout);
+        else
+            vout_StopDisplay(vout_rsc->vout);
         vout_rsc->started = false;
     }
 
-    if (vout_rsc == resource_GetFirstVoutRsc(p_resource))
+    if (b_free)
     {
         assert(p_resource->vout_rsc_free == NULL || p_resource->vout_rsc_free == vout_rsc);
 
@@ -89,6 +89,12 @@ void input_resource_HoldVouts( input_resource_t *, vout_thread_t ***, size_t * )
 
 void input_resource_StopFreeVout( input_resource_t * );
 
+/**
+ * This function stops the audio output left started by the last stream, if
+ * the aout is not used by a decoder.
+ */
+void input_resource_StopFreeAout( input_resource_t * );
+
 /**
  * This function holds the input_resource_t itself
  */
@@ -96,4 +102,10 @@ input_resource_t *input_resource_Hold( input_resource_t * );
 
 void input_resource_ResetAout( input_resource_t * );
 
+/**
+ * This function returns the memo of the decoder modules that failed at run
+ * time, to be used as the runtime memo of the per-input probe memos.
+ */
+struct vlc_probe_memo *input_resource_GetDecoderFailures( input_resource_t * );
+
 #endif
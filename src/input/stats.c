@@ -35,15 +35,30 @@
  */
 static void input_rate_Init(input_rate_t *rate)
 {
-    vlc_mutex_init(&rate->lock);
-    rate->updates = 0;
-    rate->value = 0;
+    atomic_init(&rate->updates, 0);
+    atomic_init(&rate->value, 0);
     rate->samples[0].date = VLC_TICK_INVALID;
     rate->samples[1].date = VLC_TICK_INVALID;
 }
 
-static float stats_GetRate(const input_rate_t *rate)
+/**
+ * Samples a counter value and computes its rate.
+ *
+ * This is only ever called from the input thread, so the samples need no
+ * locking, whereas the counter is updated from any thread.
+ */
+static float input_rate_Compute(input_rate_t *rate, uintmax_t value)
 {
+    /* Ignore samples within a second of another */
+    vlc_tick_t now = vlc_tick_now();
+    if (rate->samples[0].date == VLC_TICK_INVALID
+     || (now - rate->samples[0].date) >= VLC_TICK_FROM_SEC(1))
+    {
+        rate->samples[1] = rate->samples[0];
+        rate->samples[0].value = value;
+        rate->samples[0].date = now;
+    }
+
     if (rate->samples[1].date == VLC_TICK_INVALID)
         return 0.;
 
@@ -63,6 +78,9 @@ struct input_stats *input_stats_Create(void)
     atomic_init(&stats->demux_discontinuity, 0);
     atomic_init(&stats->decoded_audio, 0);
     atomic_init(&stats->decoded_video, 0);
+    for (size_t i = 0; i < INPUT_STATS_DECODE_TIME_BUCKETS; i++)
+        atomic_init(&stats->decode_time[i], 0);
+    atomic_init(&stats->decoder_queue_max, 0);
     atomic_init(&stats->played_abuffers, 0);
     atomic_init(&stats->lost_abuffers, 0);
     atomic_init(&stats->displayed_pictures, 0);
@@ -79,21 +97,33 @@ void input_stats_Destroy(struct input_stats *stats)
 void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
 {
     /* Input */
-    vlc_mutex_lock(&stats->input_bitrate.lock);
-    st->i_read_packets = stats->input_bitrate.updates;
-    st->i_read_bytes = stats->input_bitrate.value;
-    st->f_input_bitrate = stats_GetRate(&stats->input_bitrate);
-    vlc_mutex_unlock(&stats->input_bitrate.lock);
-
-    vlc_mutex_lock(&stats->demux_bitrate.lock);
-    st->i_demux_read_bytes = stats->demux_bitrate.value;
-    st->f_demux_bitrate = stats_GetRate(&stats->demux_bitrate);
-    vlc_mutex_unlock(&stats->demux_bitrate.lock);
+    st->i_read_packets = atomic_load_explicit(&stats->input_bitrate.updates,
+                                              memory_order_relaxed);
+    st->i_read_bytes = atomic_load_explicit(&stats->input_bitrate.value,
+                                            memory_order_relaxed);
+    st->f_input_bitrate = input_rate_Compute(&stats->input_bitrate,
+                                             st->i_read_bytes);
+
+    /* Demux */
+    st->i_demux_read_packets =
+        atomic_load_explicit(&stats->demux_bitrate.updates,
+                             memory_order_relaxed);
+    st->i_demux_read_bytes = atomic_load_explicit(&stats->demux_bitrate.value,
+                                                  memory_order_relaxed);
+    st->f_demux_bitrate = input_rate_Compute(&stats->demux_bitrate,
+                                             st->i_demux_read_bytes);
     st->i_demux_corrupted = atomic_load_explicit(&stats->demux_corrupted,
                                                  memory_order_relaxed);
     st->i_demux_discontinuity = atomic_load_explicit(
                     &stats->demux_discontinuity, memory_order_relaxed);
 
+    /* Decoders */
+    for (size_t i = 0; i < INPUT_STATS_DECODE_TIME_BUCKETS; i++)
+        st->pi_decode_time[i] = atomic_load_explicit(&stats->decode_time[i],
+                                                     memory_order_relaxed);
+    st->i_decoder_queue_max = atomic_exchange_explicit(
+                    &stats->decoder_queue_max, 0, memory_order_relaxed);
+
     /* Aout */
     st->i_decoded_audio = atomic_load_explicit(&stats->decoded_audio,
                                                memory_order_relaxed);
@@ -115,28 +145,35 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
 
 /** Update a counter element with new values
  * \param p_counter the counter to update
- * \param val the vlc_value union containing the new value to aggregate. For
- * more information on how data is aggregated, \see stats_Create
+ * \param val the value to aggregate
  */
 void input_rate_Add(input_rate_t *counter, uintmax_t val)
 {
-    vlc_mutex_lock(&counter->lock);
-    counter->updates++;
-    counter->value += val;
-
-    /* Ignore samples within a second of another */
-    vlc_tick_t now = vlc_tick_now();
-    if (counter->samples[0].date != VLC_TICK_INVALID
-     && (now - counter->samples[0].date) < VLC_TICK_FROM_SEC(1))
-    {
-        vlc_mutex_unlock(&counter->lock);
-        return;
-    }
-
-    memcpy(counter->samples + 1, counter->samples,
-           sizeof (counter->samples[0]));
+    atomic_fetch_add_explicit(&counter->updates, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->value, val, memory_order_relaxed);
+}
 
-    counter->samples[0].value = counter->value;
-    counter->samples[0].date = now;
-    vlc_mutex_unlock(&counter->lock);
+/**
+ * Accounts for one decode call
+ * \param decode_time time spent in the decoder
+ * \param queue_depth frames waiting in the decoder input queue
+ */
+void input_stats_AddDecode(struct input_stats *stats, vlc_tick_t decode_time,
+                           size_t queue_depth)
+{
+    size_t bucket = 0;
+
+    for (vlc_tick_t ms = MS_FROM_VLC_TICK(decode_time);
+         ms > 0 && bucket < INPUT_STATS_DECODE_TIME_BUCKETS - 1; ms >>= 1)
+        bucket++;
+    atomic_fetch_add_explicit(&stats->decode_time[bucket], 1,
+                              memory_order_relaxed);
+
+    size_t max = atomic_load_explicit(&stats->decoder_queue_max,
+                                      memory_order_relaxed);
+    while (queue_depth > max
+        && !atomic_compare_exchange_weak_explicit(&stats->decoder_queue_max,
+                                                  &max, queue_depth,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
 }
@@ -883,6 +883,13 @@ int vlc_stream_vaControl(stream_t *s, int cmd, va_list args)
                 return s->ops->stream.set_private_id_ca(s, payload);
             }
             return VLC_EGENERIC;
+        case STREAM_SET_READ_HINT:
+            if (s->ops->stream.set_read_hint != NULL) {
+                uint64_t offset = va_arg(args, uint64_t);
+                uint64_t length = va_arg(args, uint64_t);
+                return s->ops->stream.set_read_hint(s, offset, length);
+            }
+            return VLC_EGENERIC;
         default:
             vlc_assert_unreachable();
     }
@@ -154,6 +154,7 @@ static int Control( stream_t *s, int i_query, va_list args )
             return VLC_EGENERIC;
 
         case STREAM_SET_PAUSE_STATE:
+        case STREAM_SET_READ_HINT:
             break; /* nothing to do */
 
         case STREAM_SET_PRIVATE_ID_STATE:
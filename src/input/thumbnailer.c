@@ -57,15 +57,19 @@ struct vlc_thumbnailer_request_t
     vlc_atomic_rc_t rc;
     vlc_thumbnailer_t *thumbnailer;
 
-    struct seek_target seek_target;
+    /* Thumbnails to generate from the same input, in order */
+    struct seek_target *seek_targets;
+    size_t seek_target_count;
     bool fast_seek;
     input_item_t *item;
     /**
-     * A positive value will be used as the timeout duration
+     * A positive value will be used as the timeout duration (for each
+     * thumbnail)
      * VLC_TICK_INVALID means no timeout
      */
     vlc_tick_t timeout;
-    vlc_thumbnailer_cb cb;
+    vlc_thumbnailer_cb cb; /**< single request callback */
+    vlc_thumbnailer_batch_cb batch_cb; /**< batch request callback */
     void* userdata;
 
     vlc_mutex_t lock;
@@ -76,6 +80,8 @@ struct vlc_thumbnailer_request_t
         INTERRUPTED,
         ENDED,
     } status;
+    bool input_ended; /**< end of stream or error */
+    unsigned seek_count; /**< number of seek requests sent to the input */
     picture_t *pic;
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
@@ -85,25 +91,42 @@ static void RunnableRun(void *);
 
 static task_t *
 TaskNew(vlc_thumbnailer_t *thumbnailer, input_item_t *item,
-        struct seek_target seek_target, bool fast_seek,
-        vlc_thumbnailer_cb cb, void *userdata, vlc_tick_t timeout)
+        const struct seek_target *seek_targets, size_t seek_target_count,
+        bool fast_seek, vlc_thumbnailer_cb cb, vlc_thumbnailer_batch_cb batch_cb,
+        void *userdata, vlc_tick_t timeout)
 {
+    assert(seek_target_count > 0);
+    assert(!cb != !batch_cb);
+
     task_t *task = malloc(sizeof(*task));
     if (!task)
         return NULL;
 
+    task->seek_targets = vlc_alloc(seek_target_count,
+                                   sizeof(*task->seek_targets));
+    if (!task->seek_targets)
+    {
+        free(task);
+        return NULL;
+    }
+    memcpy(task->seek_targets, seek_targets,
+           seek_target_count * sizeof(*seek_targets));
+    task->seek_target_count = seek_target_count;
+
     vlc_atomic_rc_init(&task->rc);
     task->thumbnailer = thumbnailer;
     task->item = item;
-    task->seek_target = seek_target;
     task->fast_seek = fast_seek;
     task->cb = cb;
+    task->batch_cb = batch_cb;
     task->userdata = userdata;
     task->timeout = timeout;
 
     vlc_mutex_init(&task->lock);
     vlc_cond_init(&task->cond_ended);
     task->status = RUNNING;
+    task->input_ended = false;
+    task->seek_count = 0;
     task->pic = NULL;
 
     task->runnable.run = RunnableRun;
@@ -120,13 +143,31 @@ TaskRelease(task_t *task)
     if (!vlc_atomic_rc_dec(&task->rc))
         return;
     input_item_Release(task->item);
+    free(task->seek_targets);
     free(task);
 }
 
-static void NotifyThumbnail(task_t *task, picture_t *pic)
+static void NotifyThumbnail(task_t *task, size_t index, picture_t *pic)
 {
-    assert(task->cb);
-    task->cb(task->userdata, pic);
+    if (task->batch_cb)
+        task->batch_cb(task->userdata, index, pic);
+    else
+    {
+        assert(task->cb);
+        task->cb(task->userdata, pic);
+    }
+}
+
+static void Seek(input_thread_t *input, const struct seek_target *target,
+                 bool fast_seek)
+{
+    if (target->type == VLC_THUMBNAILER_SEEK_TIME)
+        input_SetTime(input, target->time, fast_seek);
+    else
+    {
+        assert(target->type == VLC_THUMBNAILER_SEEK_POS);
+        input_SetPosition(input, target->pos, fast_seek);
+    }
 }
 
 static void
@@ -135,6 +176,7 @@ on_thumbnailer_input_event( input_thread_t *input,
 {
     VLC_UNUSED(input);
     if ( event->type != INPUT_EVENT_THUMBNAIL_READY &&
+         event->type != INPUT_EVENT_WAITING_AT_EOF &&
          ( event->type != INPUT_EVENT_STATE || ( event->state.value != ERROR_S &&
                                                  event->state.value != END_S ) ) )
          return;
@@ -142,11 +184,23 @@ on_thumbnailer_input_event( input_thread_t *input,
     task_t *task = userdata;
 
     vlc_mutex_lock(&task->lock);
+    if (event->type == INPUT_EVENT_STATE)
+        /* No more thumbnails can be generated from this input */
+        task->input_ended = true;
+
+    if (event->type == INPUT_EVENT_WAITING_AT_EOF
+     && event->seek_count != task->seek_count)
+    {
+        /* EOF reached before the last seek request was handled */
+        vlc_mutex_unlock(&task->lock);
+        return;
+    }
+
     if (task->status != RUNNING)
     {
         /* We may receive a THUMBNAIL_READY event followed by an
-         * INPUT_EVENT_STATE (end of stream), we must only consider the first
-         * one. */
+         * INPUT_EVENT_STATE (end of stream) or INPUT_EVENT_WAITING_AT_EOF, we
+         * must only consider the first one. */
         vlc_mutex_unlock(&task->lock);
         return;
     }
@@ -168,22 +222,26 @@ RunnableRun(void *userdata)
     task_t *task = userdata;
     vlc_thumbnailer_t *thumbnailer = task->thumbnailer;
 
-    vlc_tick_t now = vlc_tick_now();
-
     input_thread_t* input =
             input_Create( thumbnailer->parent, on_thumbnailer_input_event, task,
                           task->item, INPUT_TYPE_THUMBNAILING, NULL, NULL );
     if (!input)
         goto error;
 
-    if (task->seek_target.type == VLC_THUMBNAILER_SEEK_TIME)
-        input_SetTime(input, task->seek_target.time, task->fast_seek);
-    else
+    if (task->fast_seek)
     {
-        assert(task->seek_target.type == VLC_THUMBNAILER_SEEK_POS);
-        input_SetPosition(input, task->seek_target.pos, task->fast_seek);
+        /* The demuxer seeks to the closest keyframe: do not decode the
+         * following non-reference frames to output the thumbnail */
+        var_Create(input, "avcodec-skip-frame", VLC_VAR_INTEGER);
+        var_SetInteger(input, "avcodec-skip-frame", 3 /* non-key */);
     }
 
+    if (task->seek_target_count > 1)
+        input_SetWaitAtEof(input);
+
+    task->seek_count = 1;
+    Seek(input, &task->seek_targets[0], task->fast_seek);
+
     int ret = input_Start(input);
     if (ret != VLC_SUCCESS)
     {
@@ -191,31 +249,58 @@ RunnableRun(void *userdata)
         goto error;
     }
 
-    vlc_mutex_lock(&task->lock);
-    if (task->timeout == VLC_TICK_INVALID)
+    /* All the thumbnails of a batch are generated from the same input (and
+     * decoder), by seeking from one target to the next */
+    for (size_t i = 0; i < task->seek_target_count; ++i)
     {
-        while (task->status == RUNNING)
-            vlc_cond_wait(&task->cond_ended, &task->lock);
-    }
-    else
-    {
-        vlc_tick_t deadline = now + task->timeout;
-        int timeout = 0;
-        while (task->status == RUNNING && timeout == 0)
-            timeout =
-                vlc_cond_timedwait(&task->cond_ended, &task->lock, deadline);
-    }
-    picture_t* pic = task->pic;
-    task->pic = NULL;
+        vlc_tick_t now = vlc_tick_now();
+
+        vlc_mutex_lock(&task->lock);
+        if (i > 0)
+        {
+            if (task->status == INTERRUPTED)
+            {
+                vlc_mutex_unlock(&task->lock);
+                break;
+            }
+            task->status = task->input_ended ? ENDED : RUNNING;
+            if (task->status == RUNNING)
+            {
+                task->seek_count++;
+                vlc_mutex_unlock(&task->lock);
+                Seek(input, &task->seek_targets[i], task->fast_seek);
+                vlc_mutex_lock(&task->lock);
+            }
+        }
+
+        if (task->timeout == VLC_TICK_INVALID)
+        {
+            while (task->status == RUNNING)
+                vlc_cond_wait(&task->cond_ended, &task->lock);
+        }
+        else
+        {
+            vlc_tick_t deadline = now + task->timeout;
+            int timeout = 0;
+            while (task->status == RUNNING && timeout == 0)
+                timeout =
+                    vlc_cond_timedwait(&task->cond_ended, &task->lock, deadline);
+        }
+        picture_t* pic = task->pic;
+        task->pic = NULL;
+
+        bool notify = task->status != INTERRUPTED;
+        vlc_mutex_unlock(&task->lock);
 
-    bool notify = task->status != INTERRUPTED;
-    vlc_mutex_unlock(&task->lock);
+        if (notify)
+            NotifyThumbnail(task, i, pic);
 
-    if (notify)
-        NotifyThumbnail(task, pic);
+        if (pic)
+            picture_Release(pic);
 
-    if (pic)
-        picture_Release(pic);
+        if (!notify)
+            break;
+    }
 
     input_Stop(input);
     input_Close(input);
@@ -235,13 +320,15 @@ Interrupt(task_t *task)
 }
 
 static task_t *
-RequestCommon(vlc_thumbnailer_t *thumbnailer, struct seek_target seek_target,
+RequestCommon(vlc_thumbnailer_t *thumbnailer,
+              const struct seek_target *seek_targets, size_t count,
               enum vlc_thumbnailer_seek_speed speed, input_item_t *item,
-              vlc_tick_t timeout, vlc_thumbnailer_cb cb, void *userdata)
+              vlc_tick_t timeout, vlc_thumbnailer_cb cb,
+              vlc_thumbnailer_batch_cb batch_cb, void *userdata)
 {
     bool fast_seek = speed == VLC_THUMBNAILER_SEEK_FAST;
-    task_t *task = TaskNew(thumbnailer, item, seek_target, fast_seek, cb,
-                           userdata, timeout);
+    task_t *task = TaskNew(thumbnailer, item, seek_targets, count, fast_seek,
+                           cb, batch_cb, userdata, timeout);
     if (!task)
         return NULL;
 
@@ -263,8 +350,8 @@ vlc_thumbnailer_RequestByTime( vlc_thumbnailer_t *thumbnailer,
         .type = VLC_THUMBNAILER_SEEK_TIME,
         .time = time,
     };
-    return RequestCommon(thumbnailer, seek_target, speed, item, timeout, cb,
-                         userdata);
+    return RequestCommon(thumbnailer, &seek_target, 1, speed, item, timeout,
+                         cb, NULL, userdata);
 }
 
 task_t *
@@ -277,8 +364,52 @@ vlc_thumbnailer_RequestByPos( vlc_thumbnailer_t *thumbnailer,
         .type = VLC_THUMBNAILER_SEEK_POS,
         .pos = pos,
     };
-    return RequestCommon(thumbnailer, seek_target, speed, item, timeout, cb,
-                         userdata);
+    return RequestCommon(thumbnailer, &seek_target, 1, speed, item, timeout,
+                         cb, NULL, userdata);
+}
+
+task_t *
+vlc_thumbnailer_RequestBatchByTime( vlc_thumbnailer_t *thumbnailer,
+                                    const vlc_tick_t *times, size_t count,
+                                    enum vlc_thumbnailer_seek_speed speed,
+                                    input_item_t *item, vlc_tick_t timeout,
+                                    vlc_thumbnailer_batch_cb cb,
+                                    void* userdata )
+{
+    if (count == 0)
+        return NULL;
+
+    struct seek_target *seek_targets = vlc_alloc(count, sizeof(*seek_targets));
+    if (!seek_targets)
+        return NULL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        seek_targets[i].type = VLC_THUMBNAILER_SEEK_TIME;
+        seek_targets[i].time = times[i];
+    }
+
+    task_t *task = RequestCommon(thumbnailer, seek_targets, count, speed, item,
+                                 timeout, NULL, cb, userdata);
+    free(seek_targets);
+    return task;
+}
+
+void vlc_thumbnailer_SetPriority( vlc_thumbnailer_t *thumbnailer, task_t *task,
+                                  enum vlc_thumbnailer_priority priority )
+{
+    static const enum vlc_executor_priority priorities[] = {
+        [VLC_THUMBNAILER_PRIORITY_BACKGROUND] = VLC_EXECUTOR_PRIORITY_LOW,
+        [VLC_THUMBNAILER_PRIORITY_NORMAL] = VLC_EXECUTOR_PRIORITY_NORMAL,
+        [VLC_THUMBNAILER_PRIORITY_VISIBLE] = VLC_EXECUTOR_PRIORITY_HIGH,
+    };
+    assert(priority < ARRAY_SIZE(priorities));
+
+    /* Move the request to the queue of its new priority, if it is not
+     * started yet. The executor keeps its reference meanwhile. */
+    if (vlc_executor_Cancel(thumbnailer->executor, &task->runnable))
+        vlc_executor_SubmitWithPriority(thumbnailer->executor, &task->runnable,
+                                        priorities[priority]);
 }
 
 void vlc_thumbnailer_DestroyRequest( vlc_thumbnailer_t* thumbnailer, task_t* task )
@@ -42,6 +42,7 @@
 
 #include <vlc_player.h>
 #include <vlc_stream.h>
+#include <vlc_memstream.h>
 #include "vlm_internal.h"
 #include "vlm_event.h"
 #include <vlc_sout.h>
@@ -56,6 +57,34 @@
 
 static void* Manage( void * );
 
+static enum vlm_state_e vlm_StateFromPlayer(vlc_player_t *player,
+                                            enum vlc_player_state new_state)
+{
+    switch (new_state)
+    {
+        case VLC_PLAYER_STATE_STOPPED:
+            return vlc_player_GetError(player) ? VLM_ERROR_S : VLM_INIT_S;
+        case VLC_PLAYER_STATE_STARTED:
+            return VLM_OPENING_S;
+        case VLC_PLAYER_STATE_PLAYING:
+            return VLM_PLAYING_S;
+        case VLC_PLAYER_STATE_PAUSED:
+            return VLM_PAUSE_S;
+        case VLC_PLAYER_STATE_STOPPING:
+            return vlc_player_GetError(player) ? VLM_ERROR_S : VLM_END_S;
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
+static void vlm_SignalStateChanged(vlm_t *p_vlm)
+{
+    vlc_mutex_lock( &p_vlm->lock_manage );
+    p_vlm->input_state_changed = true;
+    vlc_cond_signal( &p_vlm->wait_manage );
+    vlc_mutex_unlock( &p_vlm->lock_manage );
+}
+
 static void player_on_state_changed(vlc_player_t *player,
                                     enum vlc_player_state new_state, void *data)
 {
@@ -72,33 +101,31 @@ static void player_on_state_changed(vlc_player_t *player,
             break;
         }
     }
-    enum vlm_state_e vlm_state;
-    switch (new_state)
+    enum vlm_state_e vlm_state = vlm_StateFromPlayer(player, new_state);
+    vlm_SendEventMediaInstanceState( p_vlm, p_media->cfg.id, p_media->cfg.psz_name, psz_instance_name, vlm_state );
+
+    vlm_SignalStateChanged( p_vlm );
+}
+
+static void source_on_state_changed(vlc_player_t *player,
+                                    enum vlc_player_state new_state, void *data)
+{
+    vlm_source_sys_t *p_source = data;
+    vlm_t *p_vlm = libvlc_priv( vlc_object_instance(p_source->p_parent) )->p_vlm;
+    assert( p_vlm );
+
+    /* The branches are only modified with the player locked */
+    enum vlm_state_e vlm_state = vlm_StateFromPlayer(player, new_state);
+    for( int i = 0; i < p_source->i_branch; i++ )
     {
-        case VLC_PLAYER_STATE_STOPPED:
-            vlm_state = vlc_player_GetError(player) ? VLM_ERROR_S : VLM_INIT_S;
-            break;
-        case VLC_PLAYER_STATE_STARTED:
-            vlm_state = VLM_OPENING_S;
-            break;
-        case VLC_PLAYER_STATE_PLAYING:
-            vlm_state = VLM_PLAYING_S;
-            break;
-        case VLC_PLAYER_STATE_PAUSED:
-            vlm_state = VLM_PAUSE_S;
-            break;
-        case VLC_PLAYER_STATE_STOPPING:
-            vlm_state = vlc_player_GetError(player) ? VLM_ERROR_S : VLM_END_S;
-            break;
-        default:
-            vlc_assert_unreachable();
+        vlm_media_instance_sys_t *p_instance = p_source->branch[i];
+        vlm_media_t *p_cfg = &p_instance->p_media->cfg;
+
+        vlm_SendEventMediaInstanceState( p_vlm, p_cfg->id, p_cfg->psz_name,
+                                         p_instance->psz_name, vlm_state );
     }
-    vlm_SendEventMediaInstanceState( p_vlm, p_media->cfg.id, p_media->cfg.psz_name, psz_instance_name, vlm_state );
 
-    vlc_mutex_lock( &p_vlm->lock_manage );
-    p_vlm->input_state_changed = true;
-    vlc_cond_signal( &p_vlm->wait_manage );
-    vlc_mutex_unlock( &p_vlm->lock_manage );
+    vlm_SignalStateChanged( p_vlm );
 }
 
 static vlc_mutex_t vlm_mutex = VLC_STATIC_MUTEX;
@@ -143,6 +170,7 @@ vlm_t *vlm_New( libvlc_int_t *libvlc, const char *psz_vlmconf )
     p_vlm->i_id = 1;
     TAB_INIT( p_vlm->i_media, p_vlm->media );
     TAB_INIT( p_vlm->i_schedule, p_vlm->schedule );
+    TAB_INIT( p_vlm->i_source, p_vlm->source );
     var_Create( p_vlm, "intf-event", VLC_VAR_ADDRESS );
 
     if( vlc_clone( &p_vlm->thread, Manage, p_vlm ) )
@@ -201,6 +229,7 @@ void vlm_Delete( vlm_t *p_vlm )
     vlc_mutex_lock( &p_vlm->lock );
     vlm_ControlInternal( p_vlm, VLM_CLEAR_MEDIAS );
     TAB_CLEAN( p_vlm->i_media, p_vlm->media );
+    assert( p_vlm->i_source == 0 );
 
     vlm_ControlInternal( p_vlm, VLM_CLEAR_SCHEDULES );
     TAB_CLEAN( p_vlm->i_schedule, p_vlm->schedule );
@@ -429,6 +458,220 @@ static int vlm_MediaDescriptionCheck( vlm_t *p_vlm, vlm_media_t *p_cfg )
 }
 
 
+/*****************************************************************************
+ * Shared inputs
+ *****************************************************************************/
+static void vlm_ItemSetInput( input_item_t *p_item, const char *psz_input )
+{
+    if( strstr( psz_input, "://" ) == NULL )
+    {
+        char *psz_uri = vlc_path2uri( psz_input, NULL );
+        input_item_SetURI( p_item, psz_uri );
+        free( psz_uri );
+    }
+    else
+        input_item_SetURI( p_item, psz_input );
+}
+
+static bool vlm_SourceMatch( const vlm_source_sys_t *p_source,
+                             const vlm_media_t *p_cfg, int i_input_index )
+{
+    if( strcmp( p_source->psz_input, p_cfg->ppsz_input[i_input_index] )
+     || p_source->i_option != p_cfg->i_option )
+        return false;
+    for( int i = 0; i < p_cfg->i_option; i++ )
+        if( strcmp( p_source->ppsz_option[i], p_cfg->ppsz_option[i] ) )
+            return false;
+    return true;
+}
+
+static void vlm_SourceDelete( vlm_t *p_vlm, vlm_source_sys_t *p_source )
+{
+    if( p_source->player )
+    {
+        vlc_player_Lock( p_source->player );
+        if( p_source->listener )
+            vlc_player_RemoveListener( p_source->player, p_source->listener );
+        vlc_player_Stop( p_source->player );
+        vlc_player_Unlock( p_source->player );
+        vlc_player_Delete( p_source->player );
+    }
+    if( p_source->psz_hub )
+    {
+        var_Destroy( vlc_object_instance(p_vlm), p_source->psz_hub );
+        free( p_source->psz_hub );
+    }
+    if( p_source->p_parent )
+        vlc_object_delete( p_source->p_parent );
+    if( p_source->p_item )
+        input_item_Release( p_source->p_item );
+
+    for( int i = 0; i < p_source->i_option; i++ )
+        free( p_source->ppsz_option[i] );
+    TAB_CLEAN( p_source->i_option, p_source->ppsz_option );
+    assert( p_source->i_branch == 0 );
+    free( p_source->psz_input );
+    free( p_source );
+}
+
+static vlm_source_sys_t *vlm_SourceNew( vlm_t *p_vlm, const vlm_media_t *p_cfg,
+                                        int i_input_index )
+{
+    vlm_source_sys_t *p_source = calloc( 1, sizeof(*p_source) );
+    if( !p_source )
+        return NULL;
+
+    TAB_INIT( p_source->i_branch, p_source->branch );
+    TAB_INIT( p_source->i_option, p_source->ppsz_option );
+    p_source->psz_input = strdup( p_cfg->ppsz_input[i_input_index] );
+    if( !p_source->psz_input
+     || asprintf( &p_source->psz_hub, "vlm-hub-%p", (void *)p_source ) == -1 )
+    {
+        p_source->psz_hub = NULL;
+        goto error;
+    }
+    var_Create( vlc_object_instance(p_vlm), p_source->psz_hub, VLC_VAR_STRING );
+
+    p_source->p_item = input_item_New( NULL, NULL );
+    if( !p_source->p_item )
+        goto error;
+    vlm_ItemSetInput( p_source->p_item, p_source->psz_input );
+
+    char *psz_buffer;
+    if( asprintf( &psz_buffer, "sout=#duplicate{hub=%s}",
+                  p_source->psz_hub ) != -1 )
+    {
+        input_item_AddOption( p_source->p_item, psz_buffer, VLC_INPUT_OPTION_TRUSTED );
+        free( psz_buffer );
+    }
+    for( int i = 0; i < p_cfg->i_option; i++ )
+    {
+        input_item_AddOption( p_source->p_item, p_cfg->ppsz_option[i], VLC_INPUT_OPTION_TRUSTED );
+        TAB_APPEND( p_source->i_option, p_source->ppsz_option,
+                    strdup( p_cfg->ppsz_option[i] ) );
+    }
+
+    p_source->p_parent = vlc_object_create( p_vlm, sizeof (vlc_object_t) );
+    if( !p_source->p_parent )
+        goto error;
+
+    p_source->player = vlc_player_New( p_source->p_parent,
+                                       VLC_PLAYER_LOCK_NORMAL, NULL, NULL );
+    if( !p_source->player )
+        goto error;
+
+    static const struct vlc_player_cbs cbs = {
+        .on_state_changed = source_on_state_changed,
+    };
+    vlc_player_Lock( p_source->player );
+    p_source->listener =
+        vlc_player_AddListener( p_source->player, &cbs, p_source );
+    vlc_player_Unlock( p_source->player );
+    if( !p_source->listener )
+        goto error;
+
+    msg_Dbg( p_vlm, "sharing input `%s'", p_source->psz_input );
+    TAB_APPEND( p_vlm->i_source, p_vlm->source, p_source );
+    return p_source;
+
+error:
+    vlm_SourceDelete( p_vlm, p_source );
+    return NULL;
+}
+
+static void vlm_SourceStart( vlm_source_sys_t *p_source )
+{
+    vlc_player_Lock( p_source->player );
+    if( !vlc_player_IsStarted( p_source->player ) )
+    {
+        /* (re)start the input, once opened or after it ended */
+        if( vlc_player_GetCurrentMedia( p_source->player ) == NULL )
+            vlc_player_SetCurrentMedia( p_source->player, p_source->p_item );
+        vlc_player_Start( p_source->player );
+    }
+    vlc_player_Unlock( p_source->player );
+}
+
+/* Publish the output of every attached instance as a branch of the hub */
+static void vlm_SourcePublish( vlm_t *p_vlm, vlm_source_sys_t *p_source )
+{
+    struct vlc_memstream stream;
+
+    vlc_memstream_open( &stream );
+    for( int i = 0; i < p_source->i_branch; i++ )
+    {
+        const char *psz_output = p_source->branch[i]->p_media->cfg.psz_output;
+
+        if( psz_output == NULL )
+            continue;
+        if( *psz_output == '#' )
+            psz_output++;
+        vlc_memstream_printf( &stream, "%p %s\n",
+                              (void *)p_source->branch[i], psz_output );
+    }
+    if( vlc_memstream_close( &stream ) )
+        return;
+
+    var_SetString( vlc_object_instance(p_vlm), p_source->psz_hub, stream.ptr );
+    free( stream.ptr );
+}
+
+static int vlm_SourceAttach( vlm_t *p_vlm, vlm_media_instance_sys_t *p_instance,
+                             int i_input_index )
+{
+    const vlm_media_t *p_cfg = &p_instance->p_media->cfg;
+    vlm_source_sys_t *p_source = NULL;
+
+    for( int i = 0; i < p_vlm->i_source; i++ )
+    {
+        if( vlm_SourceMatch( p_vlm->source[i], p_cfg, i_input_index ) )
+        {
+            p_source = p_vlm->source[i];
+            break;
+        }
+    }
+    if( !p_source )
+    {
+        p_source = vlm_SourceNew( p_vlm, p_cfg, i_input_index );
+        if( !p_source )
+            return VLC_ENOMEM;
+    }
+
+    vlc_player_Lock( p_source->player );
+    TAB_APPEND( p_source->i_branch, p_source->branch, p_instance );
+    vlc_player_Unlock( p_source->player );
+    p_instance->p_source = p_source;
+    p_instance->player = p_source->player;
+    p_instance->i_index = i_input_index;
+
+    /* Publish before (re)starting, so that the hub opens with its branches */
+    vlm_SourcePublish( p_vlm, p_source );
+
+    vlm_SourceStart( p_source );
+    return VLC_SUCCESS;
+}
+
+static void vlm_SourceDetach( vlm_t *p_vlm, vlm_media_instance_sys_t *p_instance )
+{
+    vlm_source_sys_t *p_source = p_instance->p_source;
+
+    vlc_player_Lock( p_source->player );
+    TAB_REMOVE( p_source->i_branch, p_source->branch, p_instance );
+    vlc_player_Unlock( p_source->player );
+    p_instance->p_source = NULL;
+    p_instance->player = NULL;
+
+    if( p_source->i_branch > 0 )
+    {
+        vlm_SourcePublish( p_vlm, p_source );
+        return;
+    }
+
+    msg_Dbg( p_vlm, "closing shared input `%s'", p_source->psz_input );
+    TAB_REMOVE( p_vlm->i_source, p_vlm->source, p_source );
+    vlm_SourceDelete( p_vlm, p_source );
+}
+
 /* Called after a media description is changed/added */
 static int vlm_OnMediaUpdate( vlm_t *p_vlm, vlm_media_sys_t *p_media )
 {
@@ -438,6 +681,13 @@ static int vlm_OnMediaUpdate( vlm_t *p_vlm, vlm_media_sys_t *p_media )
 
     /* TODO add support of var vlm_media_broadcast */
 
+    /* The hubs only reopen the branches whose output changed */
+    for( int i = 0; i < p_media->i_instance; i++ )
+    {
+        if( p_media->instance[i]->p_source )
+            vlm_SourcePublish( p_vlm, p_media->instance[i]->p_source );
+    }
+
     vlm_SendEventMediaChanged( p_vlm, p_cfg->id, p_cfg->psz_name );
     return VLC_SUCCESS;
 }
@@ -594,6 +844,11 @@ static vlm_media_instance_sys_t *vlm_MediaInstanceNew( vlm_media_sys_t *p_media,
     p_instance->psz_name = NULL;
     if( psz_name )
         p_instance->psz_name = strdup( psz_name );
+    p_instance->p_media = p_media;
+
+    /* The player of a shared instance is the one of its source */
+    if( p_media->cfg.broadcast.b_shared )
+        return p_instance;
 
     p_instance->p_item = input_item_New( NULL, NULL );
     if (!p_instance->p_item)
@@ -634,6 +889,20 @@ error:
 }
 static void vlm_MediaInstanceDelete( vlm_t *p_vlm, int64_t id, vlm_media_instance_sys_t *p_instance, vlm_media_sys_t *p_media )
 {
+    if( p_instance->p_item == NULL )
+    {
+        /* Shared instance */
+        if( p_instance->p_source )
+        {
+            vlm_SourceDetach( p_vlm, p_instance );
+            vlm_SendEventMediaInstanceStopped( p_vlm, id, p_media->cfg.psz_name );
+        }
+        TAB_REMOVE( p_media->i_instance, p_media->instance, p_instance );
+        free( p_instance->psz_name );
+        free( p_instance );
+        return;
+    }
+
     vlc_player_t *player = p_instance->player;
 
     vlc_player_Lock(player);
@@ -654,6 +923,36 @@ static void vlm_MediaInstanceDelete( vlm_t *p_vlm, int64_t id, vlm_media_instanc
 }
 
 
+static int vlm_MediaInstanceStartShared( vlm_t *p_vlm, vlm_media_instance_sys_t *p_instance, int i_input_index )
+{
+    vlm_media_sys_t *p_media = p_instance->p_media;
+    vlm_media_t *p_cfg = &p_media->cfg;
+
+    if( p_instance->p_source )
+    {
+        if( vlm_SourceMatch( p_instance->p_source, p_cfg, i_input_index ) )
+        {
+            /* Already a branch of that input, restart it if it ended */
+            p_instance->i_index = i_input_index;
+            vlm_SourceStart( p_instance->p_source );
+            return VLC_SUCCESS;
+        }
+
+        vlm_SourceDetach( p_vlm, p_instance );
+        vlm_SendEventMediaInstanceStopped( p_vlm, p_cfg->id, p_cfg->psz_name );
+    }
+
+    int i_ret = vlm_SourceAttach( p_vlm, p_instance, i_input_index );
+    if( i_ret != VLC_SUCCESS )
+    {
+        vlm_MediaInstanceDelete( p_vlm, p_cfg->id, p_instance, p_media );
+        return i_ret;
+    }
+
+    vlm_SendEventMediaInstanceStarted( p_vlm, p_cfg->id, p_cfg->psz_name );
+    return VLC_SUCCESS;
+}
+
 static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *psz_id, int i_input_index )
 {
     vlm_media_sys_t *p_media = vlm_ControlMediaGetById( p_vlm, id );
@@ -674,7 +973,7 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
         if( !p_instance )
             return VLC_ENOMEM;
 
-        if( p_cfg->psz_output != NULL )
+        if( p_instance->p_item != NULL && p_cfg->psz_output != NULL )
         {
             char *psz_buffer;
             if( asprintf( &psz_buffer, "sout=%s", p_cfg->psz_output ) != -1 )
@@ -684,11 +983,14 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
             }
         }
 
-        for( int i = 0; i < p_cfg->i_option; i++ )
+        for( int i = 0; p_instance->p_item != NULL && i < p_cfg->i_option; i++ )
             input_item_AddOption( p_instance->p_item, p_cfg->ppsz_option[i], VLC_INPUT_OPTION_TRUSTED );
         TAB_APPEND( p_media->i_instance, p_media->instance, p_instance );
     }
 
+    if( p_instance->p_item == NULL )
+        return vlm_MediaInstanceStartShared( p_vlm, p_instance, i_input_index );
+
     /* Stop old instance */
     vlc_player_t *player = p_instance->player;
     vlc_player_Lock(player);
@@ -698,6 +1000,7 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
         {
             if (vlc_player_IsPaused(player))
                 vlc_player_Resume(player);
+            vlc_player_Unlock(player);
             return VLC_SUCCESS;
         }
 
@@ -709,15 +1012,7 @@ static int vlm_ControlMediaInstanceStart( vlm_t *p_vlm, int64_t id, const char *
 
     /* Start new one */
     p_instance->i_index = i_input_index;
-    if( strstr( p_media->cfg.ppsz_input[p_instance->i_index], "://" ) == NULL )
-    {
-        char *psz_uri = vlc_path2uri(
-                          p_media->cfg.ppsz_input[p_instance->i_index], NULL );
-        input_item_SetURI( p_instance->p_item, psz_uri ) ;
-        free( psz_uri );
-    }
-    else
-        input_item_SetURI( p_instance->p_item, p_media->cfg.ppsz_input[p_instance->i_index] ) ;
+    vlm_ItemSetInput( p_instance->p_item, p_media->cfg.ppsz_input[p_instance->i_index] );
 
     vlc_player_SetCurrentMedia(player, p_instance->p_item);
     vlc_player_Start(player);
@@ -755,6 +1050,10 @@ static int vlm_ControlMediaInstancePause( vlm_t *p_vlm, int64_t id, const char *
     if( !p_instance )
         return VLC_EGENERIC;
 
+    /* Do not pause or seek the other broadcasts of a shared input */
+    if( p_instance->p_source && p_instance->p_source->i_branch > 1 )
+        return VLC_EGENERIC;
+
     vlc_player_Lock(p_instance->player);
     vlc_player_TogglePause(p_instance->player);
     vlc_player_Unlock(p_instance->player);
@@ -793,6 +1092,10 @@ static int vlm_ControlMediaInstanceSetTimePosition( vlm_t *p_vlm, int64_t id, co
     if( !p_instance )
         return VLC_EGENERIC;
 
+    /* Do not pause or seek the other broadcasts of a shared input */
+    if( p_instance->p_source && p_instance->p_source->i_branch > 1 )
+        return VLC_EGENERIC;
+
     vlc_player_Lock(p_instance->player);
     if( i_time >= 0 )
         vlc_player_SetTime(p_instance->player, VLC_TICK_FROM_US(i_time));
@@ -28,6 +28,8 @@
 #include "input_interface.h"
 
 /* Private */
+typedef struct vlm_source_sys_t vlm_source_sys_t;
+
 typedef struct
 {
     /* instance name */
@@ -41,10 +43,37 @@ typedef struct
     vlc_player_t *player;
     vlc_player_listener_id *listener;
 
+    /* shared input this instance is a branch of, or NULL
+     * (player then points to the player of the source) */
+    vlm_source_sys_t *p_source;
+    struct vlm_media_sys_t *p_media;
+
 } vlm_media_instance_sys_t;
 
+/* Input shared by the running instances of the shared broadcasts with the
+ * same input and options, each adding its output as a branch of the
+ * duplicate hub of the source */
+struct vlm_source_sys_t
+{
+    char *psz_input;
+    int i_option;
+    char **ppsz_option;
 
-typedef struct
+    /* name of the hub variable, on the libvlc instance */
+    char *psz_hub;
+
+    vlc_object_t *p_parent;
+    input_item_t *p_item;
+    vlc_player_t *player;
+    vlc_player_listener_id *listener;
+
+    /* attached instances, modified with the player locked */
+    int i_branch;
+    vlm_media_instance_sys_t **branch;
+};
+
+
+typedef struct vlm_media_sys_t
 {
     struct vlc_object_t obj;
     vlm_media_t cfg;
@@ -97,6 +126,10 @@ struct vlm_t
     /* Schedule list */
     int            i_schedule;
     vlm_schedule_sys_t **schedule;
+
+    /* Shared inputs */
+    int              i_source;
+    vlm_source_sys_t **source;
 };
 
 int vlm_ControlInternal( vlm_t *p_vlm, int i_query, ... );
@@ -323,6 +323,7 @@ static int ExecuteHelp( vlm_message_t **pp_status )
     MessageAddChild( "option (option_name)[=value]" );
     MessageAddChild( "enabled|disabled" );
     MessageAddChild( "loop|unloop" );
+    MessageAddChild( "share|noshare" );
 
     message_child = MessageAdd( "Schedule Proprieties Syntax:" );
     MessageAddChild( "enabled|disabled" );
@@ -732,6 +733,14 @@ static int ExecuteMediaProperty( vlm_t *p_vlm, int64_t id, bool b_new,
         {
             p_cfg->broadcast.b_loop = false;
         }
+        else if( !strcmp( psz_option, "share" ) )
+        {
+            p_cfg->broadcast.b_shared = true;
+        }
+        else if( !strcmp( psz_option, "noshare" ) )
+        {
+            p_cfg->broadcast.b_shared = false;
+        }
         else
         {
             fprintf( stderr, "PROP: name=%s unknown\n", psz_option );
@@ -1287,6 +1296,8 @@ static vlm_message_t *vlm_ShowMedia( vlm_media_sys_t *p_media )
 
     vlm_MessageAdd( p_msg,
                     vlm_MessageNew( "loop", p_cfg->broadcast.b_loop ? "yes" : "no" ) );
+    vlm_MessageAdd( p_msg,
+                    vlm_MessageNew( "shared", p_cfg->broadcast.b_shared ? "yes" : "no" ) );
 
     p_msg_sub = vlm_MessageAdd( p_msg, vlm_MessageSimpleNew( "inputs" ) );
     for( i = 0; i < p_cfg->i_input; i++ )
@@ -1594,6 +1605,8 @@ static char *Save( vlm_t *vlm )
 
         if( p_cfg->broadcast.b_loop )
             vlc_memstream_puts( &stream, " loop" );
+        if( p_cfg->broadcast.b_shared )
+            vlc_memstream_puts( &stream, " share" );
         vlc_memstream_putc( &stream, '\n' );
 
         for( int j = 0; j < p_cfg->i_input; j++ )
@@ -90,6 +90,16 @@ static const char *const ppsz_snap_formats[] =
     "This is the verbosity level (0=only errors and " \
     "standard messages, 1=warnings, 2=debug).")
 
+#define LOG_ASYNC_TEXT N_("Asynchronous logging")
+#define LOG_ASYNC_LONGTEXT N_( \
+    "Output the messages from a separate thread when debug messages are " \
+    "enabled, so that logging does not slow the other threads down.")
+
+#define LOG_RATE_TEXT N_("Messages rate limit")
+#define LOG_RATE_LONGTEXT N_( \
+    "Maximum number of messages per second from each object when logging " \
+    "asynchronously, errors excepted (0=unlimited).")
+
 #define OPEN_TEXT N_("Default stream")
 #define OPEN_LONGTEXT N_( \
     "This stream will always be opened at VLC startup." )
@@ -132,6 +142,12 @@ static const char *const ppsz_snap_formats[] =
     "This may result on audio not working if the output can't adapt to the " \
     "input format.")
 
+#define AUDIO_LOW_LATENCY_TEXT N_("Low-latency audio output")
+#define AUDIO_LOW_LATENCY_LONGTEXT N_( \
+    "Request the smallest output buffers the audio device supports and " \
+    "resynchronize with tighter tolerances. This is meant for live " \
+    "monitoring and may cause glitches on loaded systems.")
+
 #define AUDIO_TEXT N_("Enable audio")
 #define AUDIO_LONGTEXT N_( \
     "You can completely disable the audio output. The audio " \
@@ -242,6 +258,13 @@ static const char *const ppsz_mix_mode_texts[] = {
     "This allows playing audio at lower or higher speed without " \
     "affecting the audio pitch" )
 
+#define AUDIO_TRANSITION_FADE_TEXT N_( \
+    "Fade-in between items (ms)" )
+#define AUDIO_TRANSITION_FADE_LONGTEXT N_( \
+    "When consecutive items of the same audio format are played through " \
+    "the same audio output, fade the beginning of the next item in during " \
+    "this time. 0 disables it." )
+
 
 static const char *const ppsz_replay_gain_mode[] = {
     "none", "track", "album" };
@@ -365,12 +388,13 @@ static const char * const  ppsz_deinterlace_text[] = {
     "Deinterlace method to use for video processing.")
 static const char * const ppsz_deinterlace_mode[] = {
     "auto", "discard", "blend", "mean", "bob",
-    "linear", "x", "yadif", "yadif2x", "phosphor",
+    "linear", "x", "yadif", "yadif2x", "bwdif", "bwdif2x", "phosphor",
     "ivtc"
 };
 static const char * const ppsz_deinterlace_mode_text[] = {
     N_("Auto"), N_("Discard"), N_("Blend"), N_("Mean"), N_("Bob"),
-    N_("Linear"), "X", "Yadif", "Yadif (2x)", N_("Phosphor"),
+    N_("Linear"), "X", "Yadif", "Yadif (2x)", "Bwdif", "Bwdif (2x)",
+    N_("Phosphor"),
     N_("Film NTSC (IVTC)")
 };
 
@@ -406,6 +430,11 @@ static const char *const screensaver_texts[] = {
     "picture quality, for instance deinterlacing, or distort " \
     "the video.")
 
+#define CHROMA_THREADS_TEXT N_("Chroma conversion threads")
+#define CHROMA_THREADS_LONGTEXT N_( \
+    "Number of threads converting large pictures in horizontal bands, " \
+    "for the chroma converters supporting it (0: automatic, 1: disabled).")
+
 #define SNAP_PATH_TEXT N_("Video snapshot directory (or filename)")
 #define SNAP_PATH_LONGTEXT N_( \
     "Directory where the video snapshots will be stored.")
@@ -495,6 +524,18 @@ static const char *const fit_descriptions[] = {
     "Enables framedropping on MPEG2 stream. Framedropping " \
     "occurs when your computer is not powerful enough" )
 
+#define KEYFRAMES_ONLY_TEXT N_("Decode only keyframes")
+#define KEYFRAMES_ONLY_LONGTEXT N_( \
+    "Only the video keyframes are demuxed and decoded, if the demuxer or " \
+    "the packetizer can tell them apart. This is useful for indexing and " \
+    "thumbnailing jobs." )
+
+#define RENDER_AHEAD_TEXT N_("Render pictures ahead")
+#define RENDER_AHEAD_LONGTEXT N_( \
+    "Prepare the next pictures while the current one waits to be shown, " \
+    "with the video outputs that can queue pictures. This hides the " \
+    "rendering time of heavy subtitles or OSD.")
+
 #define DROP_LATE_FRAMES_TEXT N_("Drop late frames")
 #define DROP_LATE_FRAMES_LONGTEXT N_( \
     "This drops frames that are late (arrive to the video output after " \
@@ -555,6 +596,13 @@ static const char *const fit_descriptions[] = {
     "This defines the maximum input delay jitter that the synchronization " \
     "algorithms should try to compensate (in milliseconds)." )
 
+#define CLOCK_JITTER_PERCENTILE_TEXT N_("Adaptive clock jitter")
+#define CLOCK_JITTER_PERCENTILE_LONGTEXT N_( \
+    "The delay added to compensate the jitter of live sources is normally " \
+    "never reduced. If not zero, it is brought back down gradually, by " \
+    "playing slightly faster, to the delay covering this percentile of " \
+    "the recent clock updates." )
+
 #define CLOCK_MASTER_TEXT N_("Clock master source")
 #define CLOCK_MASTER_LONGTEXT N_( "Select the clock master source:\n" \
     "auto: best clock source, input if the access can't be paced " \
@@ -566,6 +614,19 @@ static const char *const fit_descriptions[] = {
     "clock (Fallback to Monotonic if there is no audio tracks).\n" \
     "monotonic: all tracks are driven by the monotonic clock of the system.")
 
+#define OFFLINE_TEXT N_("Offline processing")
+#define OFFLINE_LONGTEXT N_( \
+    "Process the media as fast as possible instead of in real time: the " \
+    "input is only paced by the outputs, the pictures are displayed as soon " \
+    "as they are decoded and the audio is not synchronized. This is meant " \
+    "for batch processing with outputs that do not play in real time " \
+    "(amem, afile, vmem...).")
+
+#define CLOCK_GROUP_TEXT N_("Clock group")
+#define CLOCK_GROUP_LONGTEXT N_( \
+    "Inputs of this process using the same clock group name play in sync: " \
+    "the first input to start drives the clock of the following ones.")
+
 static const char *const ppsz_clock_master_values[] = {
     "auto", "input", "audio", "monotonic",
 };
@@ -752,6 +813,11 @@ static const char* const ppsz_restore_playback_desc[] = {
     "When possible, the input stream will be recorded instead of using " \
     "the stream output module" )
 
+#define INPUT_RECORD_PREROLL_TEXT N_("Record pre-roll (seconds)")
+#define INPUT_RECORD_PREROLL_LONGTEXT N_( \
+    "Keep this many seconds of the played tracks in memory so that " \
+    "recording includes what was just played. 0 disables the pre-roll." )
+
 #define INPUT_TIMESHIFT_PATH_TEXT N_("Timeshift directory")
 #define INPUT_TIMESHIFT_PATH_LONGTEXT N_( \
     "Directory used to store the timeshift temporary files." )
@@ -1001,6 +1067,13 @@ static const char* const ppsz_restore_playback_desc[] = {
     "VLC will fallback automatically to software decoders in case of " \
     "hardware decoder failure." )
 
+#define DEC_PIPELINE_TEXT N_("Pipelined packetizing")
+#define DEC_PIPELINE_LONGTEXT N_( \
+    "Run the packetizer in its own thread, ahead of the decoder, so that " \
+    "parsing of the next frame overlaps with decoding of the current one. " \
+    "This can improve the throughput of high bitrate streams on " \
+    "multi-core systems." )
+
 #define DEC_DEV_TEXT N_("Preferred decoder hardware device")
 #define DEC_DEV_LONGTEXT N_("This allows hardware decoding when available.")
 
@@ -1087,10 +1160,61 @@ static const char* const ppsz_restore_playback_desc[] = {
     "the correct demuxer is not automatically detected. You should not "\
     "set this as a global option unless you really know what you are doing." )
 
+#define DEMUX_SNIFF_TEXT N_("Detect the container from its content")
+#define DEMUX_SNIFF_LONGTEXT N_( \
+    "Check the first bytes of the stream for well-known container " \
+    "signatures, and try the matching demultiplexer first. This speeds " \
+    "up opening streams whose demultiplexer has a low priority (such as " \
+    "MPEG-TS). Other demultiplexers are still tried if it fails." )
+
 #define TRACER_TEXT N_("Tracer module")
 #define TRACER_LONGTEXT N_( \
     "This allow to select which tracer module you want to use." )
 
+#define FRAME_BUDGET_TEXT N_("Frame memory budget (MiB)")
+#define FRAME_BUDGET_LONGTEXT N_( \
+    "Above this amount of data frames, the adaptive streams stop buffering " \
+    "beyond their minimum. 0 means unlimited.")
+
+#define PICTURE_BUDGET_TEXT N_("Picture memory budget (MiB)")
+#define PICTURE_BUDGET_LONGTEXT N_( \
+    "Amount of software picture buffers reported as the budget of the " \
+    "pictures. 0 means unlimited.")
+
+#define CACHE_BUDGET_TEXT N_("Cache memory budget (MiB)")
+#define CACHE_BUDGET_LONGTEXT N_( \
+    "Above this amount of cached content, the caches evict their entries " \
+    "whatever their own size limit. 0 means unlimited.")
+
+#define HUGE_PAGES_TEXT N_("Huge pages for large buffers")
+#define HUGE_PAGES_LONGTEXT N_( \
+    "Back the large picture and frame buffers with transparent huge pages, " \
+    "to reduce the TLB misses on high resolution video.")
+
+#define NUMA_LOCAL_TEXT N_("Move large buffers to the consuming NUMA node")
+#define NUMA_LOCAL_LONGTEXT N_( \
+    "Migrate the large picture and frame buffers to the memory of the " \
+    "processor that consumes them, such as the encoder thread when " \
+    "transcoding, on NUMA systems.")
+
+#define THREAD_AFFINITY_TEXT N_("Thread CPU affinity")
+#define THREAD_AFFINITY_LONGTEXT N_( \
+    "Restrict the threads to this list of processors, such as \"0-3,8\". " \
+    "Set on a media, it applies to the threads of its input only.")
+
+#define THREAD_PRIORITIES_TEXT N_("Thread priorities")
+#define THREAD_PRIORITIES_LONGTEXT N_( \
+    "Scheduling class of the threads by role, such as " \
+    "\"vout=high,aout=realtime,prefetch=background\". The roles are " \
+    "input, decoder, aout, vout, sout, prefetch and background; the " \
+    "classes are default, background, high and realtime. Raising the " \
+    "priority may require privileges.")
+
+#define THREAD_CGROUP_TEXT N_("Thread control group")
+#define THREAD_CGROUP_LONGTEXT N_( \
+    "Path of a threaded control group (version 2) to move the threads to " \
+    "(Linux only).")
+
 #define VLM_CONF_TEXT N_("VLM configuration file")
 #define VLM_CONF_LONGTEXT N_( \
     "Read a VLM configuration file as soon as VLM is started." )
@@ -1104,6 +1228,11 @@ static const char* const ppsz_restore_playback_desc[] = {
     "Scan plugin directories for new plugins at startup. " \
     "This increases the startup time of VLC.")
 
+#define PRELOAD_MODULES_TEXT N_("Preloaded modules")
+#define PRELOAD_MODULES_LONGTEXT N_( \
+    "Comma-separated list of modules to load in the background at startup, " \
+    "rather than when they are first used.")
+
 #define KEYSTORE_TEXT N_("Preferred keystore list")
 #define KEYSTORE_LONGTEXT N_( \
     "List of keystores that VLC will use in priority." )
@@ -1174,7 +1303,7 @@ static const char *const clock_sources_text[] = {
 
 #define PREPARSE_TEXT N_( "Automatically preparse items")
 #define PREPARSE_LONGTEXT N_( \
-    "Automatically preparse items added to the playlist " \
+    "Automatically preparse the playlist items following the current one " \
     "(to retrieve some metadata)." )
 
 #define PREPARSE_TIMEOUT_TEXT N_( "Preparsing timeout" )
@@ -1185,6 +1314,16 @@ static const char *const clock_sources_text[] = {
 #define PREPARSE_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to preparse items" )
 
+#define PREPARSE_NETWORK_THREADS_TEXT N_( "Network preparsing threads" )
+#define PREPARSE_NETWORK_THREADS_LONGTEXT N_( \
+    "Maximum number of threads used to preparse network items. These " \
+    "mostly wait for the network, and do not delay the local items." )
+
+#define PREPARSE_CACHE_TEXT N_( "Preparsing cache" )
+#define PREPARSE_CACHE_LONGTEXT N_( \
+    "Store the preparsing results of local files in the cache directory, " \
+    "and reuse them while the files do not change." )
+
 #define FETCH_ART_THREADS_TEXT N_( "Fetch-art threads" )
 #define FETCH_ART_THREADS_LONGTEXT N_( \
     "Maximum number of threads used to fetch art" )
@@ -1245,6 +1384,12 @@ static const char *const psz_recursive_list_text[] = {
 #define PAP_LONGTEXT N_( \
     "Pause each item in the playlist on the last frame." )
 
+#define PRELOAD_TEXT N_("Preload the next item")
+#define PRELOAD_LONGTEXT N_( \
+    "Open the next playlist item this many seconds before the end of the " \
+    "current one, so that it starts without waiting for its access. " \
+    "0 disables preloading." )
+
 #define SP_TEXT N_("Start paused")
 #define SP_LONGTEXT N_( \
     "Pause each item in the playlist on the first frame." )
@@ -1599,12 +1744,17 @@ vlc_module_begin ()
 
     add_bool( "audio-time-stretch", true,
               AUDIO_TIME_STRETCH_TEXT, AUDIO_TIME_STRETCH_LONGTEXT )
+    add_integer_with_range( "audio-transition-fade", 0, 0, 10000,
+                            AUDIO_TRANSITION_FADE_TEXT,
+                            AUDIO_TRANSITION_FADE_LONGTEXT )
 
     set_subcategory( SUBCAT_AUDIO_AOUT )
     add_module("aout", "audio output", "any", AOUT_TEXT, AOUT_LONGTEXT)
         change_short('A')
     add_string( "role", "video", ROLE_TEXT, ROLE_LONGTEXT )
         change_string_list( ppsz_roles, ppsz_roles_text )
+    add_bool( "audio-low-latency", false, AUDIO_LOW_LATENCY_TEXT,
+              AUDIO_LOW_LATENCY_LONGTEXT )
 
     set_subcategory( SUBCAT_AUDIO_AFILTER )
         add_bool( "audio-bitexact", false, AUDIO_BITEXACT_TEXT,
@@ -1635,9 +1785,14 @@ vlc_module_begin ()
         change_private ()
     add_bool( "drop-late-frames", true, DROP_LATE_FRAMES_TEXT,
               DROP_LATE_FRAMES_LONGTEXT )
+    add_bool( "render-ahead", true, RENDER_AHEAD_TEXT,
+              RENDER_AHEAD_LONGTEXT )
     /* Used in vout_synchro */
     add_bool( "skip-frames", true, SKIP_FRAMES_TEXT,
               SKIP_FRAMES_LONGTEXT )
+    add_bool( "keyframes-only", false, KEYFRAMES_ONLY_TEXT,
+              KEYFRAMES_ONLY_LONGTEXT )
+        change_safe ()
     add_bool( "quiet-synchro", false, QUIET_SYNCHRO_TEXT,
               QUIET_SYNCHRO_LONGTEXT )
     add_bool( "keyboard-events", true, KEYBOARD_EVENTS_TEXT,
@@ -1736,6 +1891,9 @@ vlc_module_begin ()
     set_subcategory( SUBCAT_VIDEO_VFILTER )
     add_module_list("video-filter", "video filter", NULL,
                     VIDEO_FILTER_TEXT, VIDEO_FILTER_LONGTEXT)
+    add_integer( "chroma-threads", 0,
+                 CHROMA_THREADS_TEXT, CHROMA_THREADS_LONGTEXT )
+        change_integer_range( 0, 16 )
 
 #if 0
     add_string( "pixel-ratio", "1", PIXEL_RATIO_TEXT, PIXEL_RATIO_TEXT )
@@ -1972,14 +2130,23 @@ vlc_module_begin ()
     add_integer( "clock-jitter", 5000, CLOCK_JITTER_TEXT,
               CLOCK_JITTER_LONGTEXT )
         change_safe()
+    add_integer_with_range( "clock-jitter-percentile", 0, 0, 100,
+                            CLOCK_JITTER_PERCENTILE_TEXT,
+                            CLOCK_JITTER_PERCENTILE_LONGTEXT )
+        change_safe()
     add_string( "clock-master", "auto",
                  CLOCK_MASTER_TEXT, CLOCK_MASTER_LONGTEXT )
         change_string_list( ppsz_clock_master_values, ppsz_clock_master_descriptions )
+    add_string( "clock-group", NULL, CLOCK_GROUP_TEXT, CLOCK_GROUP_LONGTEXT )
+    add_bool( "offline", false, OFFLINE_TEXT, OFFLINE_LONGTEXT )
 
     add_directory("input-record-path", NULL,
                   INPUT_RECORD_PATH_TEXT, INPUT_RECORD_PATH_LONGTEXT)
     add_bool( "input-record-native", true, INPUT_RECORD_NATIVE_TEXT,
               INPUT_RECORD_NATIVE_LONGTEXT )
+    add_integer_with_range( "input-record-preroll", 0, 0, 600,
+                            INPUT_RECORD_PREROLL_TEXT,
+                            INPUT_RECORD_PREROLL_LONGTEXT )
 
     add_directory("input-timeshift-path", NULL,
                   INPUT_TIMESHIFT_PATH_TEXT, INPUT_TIMESHIFT_PATH_LONGTEXT)
@@ -1998,12 +2165,14 @@ vlc_module_begin ()
 
     add_module("demux", "demux", "any", DEMUX_TEXT, DEMUX_LONGTEXT)
     add_string( "demux-filter", NULL, DEMUX_FILTER_TEXT, DEMUX_FILTER_LONGTEXT )
+    add_bool( "demux-sniff", true, DEMUX_SNIFF_TEXT, DEMUX_SNIFF_LONGTEXT )
 
     //set_subcategory( SUBCAT_INPUT_ACODEC )
     set_subcategory( SUBCAT_INPUT_VCODEC )
 
     add_string( "codec", "any", CODEC_TEXT, CODEC_LONGTEXT )
     add_bool( "hw-dec", true, HW_DEC_TEXT, HW_DEC_LONGTEXT )
+    add_bool( "dec-pipeline", false, DEC_PIPELINE_TEXT, DEC_PIPELINE_LONGTEXT )
     add_obsolete_string( "encoder" ) /* since 4.0.0 */
     add_module("dec-dev", "decoder device", "any", DEC_DEV_TEXT, DEC_DEV_LONGTEXT)
 
@@ -2068,6 +2237,8 @@ vlc_module_begin ()
     add_bool( "plugins-scan", true, PLUGINS_SCAN_TEXT,
               PLUGINS_SCAN_LONGTEXT )
         change_volatile ()
+    add_string( "preload-modules", NULL, PRELOAD_MODULES_TEXT,
+                PRELOAD_MODULES_LONGTEXT )
 #endif
     add_string( "keystore", NULL, KEYSTORE_TEXT,
                 KEYSTORE_LONGTEXT )
@@ -2093,6 +2264,21 @@ vlc_module_begin ()
         change_string_list( clock_sources, clock_sources_text )
 #endif
 
+    add_integer_with_range( "frame-memory-budget", 0, 0, 1 << 20,
+                            FRAME_BUDGET_TEXT, FRAME_BUDGET_LONGTEXT )
+    add_integer_with_range( "picture-memory-budget", 0, 0, 1 << 20,
+                            PICTURE_BUDGET_TEXT, PICTURE_BUDGET_LONGTEXT )
+    add_integer_with_range( "cache-memory-budget", 0, 0, 1 << 20,
+                            CACHE_BUDGET_TEXT, CACHE_BUDGET_LONGTEXT )
+    add_bool( "huge-pages", false, HUGE_PAGES_TEXT, HUGE_PAGES_LONGTEXT )
+    add_bool( "numa-local", false, NUMA_LOCAL_TEXT, NUMA_LOCAL_LONGTEXT )
+    add_string( "thread-affinity", NULL, THREAD_AFFINITY_TEXT,
+                THREAD_AFFINITY_LONGTEXT )
+    add_string( "thread-priorities", NULL, THREAD_PRIORITIES_TEXT,
+                THREAD_PRIORITIES_LONGTEXT )
+    add_string( "thread-cgroup", NULL, THREAD_CGROUP_TEXT,
+                THREAD_CGROUP_LONGTEXT )
+
 /* Playlist options */
     set_subcategory( SUBCAT_PLAYLIST_GENERAL )
     add_category_hint(N_("Playlist"), PLAYLIST_CAT_LONGTEXT)
@@ -2111,6 +2297,8 @@ vlc_module_begin ()
     add_bool( "play-and-pause", false, PAP_TEXT, PAP_LONGTEXT )
         change_safe()
     add_bool( "start-paused", false, SP_TEXT, SP_LONGTEXT )
+    add_integer_with_range( "playlist-preload", 5, 0, 60,
+                            PRELOAD_TEXT, PRELOAD_LONGTEXT )
     add_bool( "playlist-autostart", true,
               AUTOSTART_TEXT, AUTOSTART_LONGTEXT )
     add_bool( "playlist-cork", true, CORK_TEXT, CORK_LONGTEXT )
@@ -2142,6 +2330,13 @@ vlc_module_begin ()
     add_integer( "preparse-threads", 1, PREPARSE_THREADS_TEXT,
                  PREPARSE_THREADS_LONGTEXT )
 
+    add_integer( "preparse-network-threads", 4,
+                 PREPARSE_NETWORK_THREADS_TEXT,
+                 PREPARSE_NETWORK_THREADS_LONGTEXT )
+
+    add_bool( "preparse-cache", false, PREPARSE_CACHE_TEXT,
+              PREPARSE_CACHE_LONGTEXT )
+
     add_integer( "fetch-art-threads", 1, FETCH_ART_THREADS_TEXT,
                  FETCH_ART_THREADS_LONGTEXT )
 
@@ -2193,6 +2388,8 @@ vlc_module_begin ()
     add_integer( "verbose", 0, VERBOSE_TEXT, VERBOSE_LONGTEXT )
         change_short('v')
         change_volatile ()
+    add_bool( "log-async", true, LOG_ASYNC_TEXT, LOG_ASYNC_LONGTEXT )
+    add_integer( "log-rate-limit", 0, LOG_RATE_TEXT, LOG_RATE_LONGTEXT )
 #if !defined(_WIN32) && !defined(__OS2__)
     add_obsolete_bool( "daemon" ) /* since 4.0.0 */
         change_short('d')
@@ -42,6 +42,9 @@
 #include "config/configuration.h"
 #include "preparser/preparser.h"
 #include "media_source/media_source.h"
+#include "misc/picture.h"
+#include "misc/mempolicy.h"
+#include "misc/thread_policy.h"
 
 #include <stdio.h>                                              /* sprintf() */
 #include <string.h>
@@ -95,6 +98,9 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->main_playlist = NULL;
     priv->p_vlm = NULL;
     priv->media_source_provider = NULL;
+    priv->p_thumbnailer = NULL;
+    priv->image_cache = NULL;
+    priv->preloading = false;
 
     vlc_ExitInit( &priv->exit );
 
@@ -118,6 +124,86 @@ static void libvlc_AddInterfaces(libvlc_int_t *libvlc, const char *varname)
     free(str);
 }
 
+#ifdef HAVE_DYNAMIC_PLUGINS
+static void *libvlc_PreloadThread(void *data)
+{
+    libvlc_int_t *libvlc = data;
+    char *list = var_InheritString(libvlc, "preload-modules");
+
+    vlc_thread_set_name("vlc-preload");
+
+    if (list == NULL)
+        return NULL;
+
+    char *state;
+
+    for (const char *name = strtok_r(list, ",:", &state); name != NULL;
+         name = strtok_r(NULL, ",:", &state))
+    {
+        module_t *module = module_find(name);
+
+        if (module == NULL)
+        {
+            msg_Warn(libvlc, "cannot preload unknown module \"%s\"", name);
+            continue;
+        }
+        /* Map the plug-in now, rather than on first use by module_need() */
+        if (vlc_plugin_Map(libvlc->obj.logger, module->plugin))
+            msg_Warn(libvlc, "cannot preload module \"%s\"", name);
+    }
+    free(list);
+    return NULL;
+}
+
+static void libvlc_Preload(libvlc_int_t *libvlc)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    char *list = var_InheritString(libvlc, "preload-modules");
+
+    if (list == NULL)
+        return;
+    free(list);
+
+    priv->preloading = vlc_clone(&priv->preloader, libvlc_PreloadThread,
+                                 libvlc) == 0;
+}
+#else
+# define libvlc_Preload(libvlc) (void)(libvlc)
+#endif
+
+static input_preparser_t *libvlc_GetPreparser(libvlc_int_t *libvlc)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    input_preparser_t *parser;
+
+    vlc_mutex_lock(&priv->lock);
+    if (priv->parser == NULL)
+        priv->parser = input_preparser_New(VLC_OBJECT(libvlc));
+    parser = priv->parser;
+    vlc_mutex_unlock(&priv->lock);
+    return parser;
+}
+
+/**
+ * Gets the thumbnailer of a libvlc instance, creating it on first use.
+ */
+vlc_thumbnailer_t *libvlc_GetThumbnailer(libvlc_int_t *libvlc)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    vlc_thumbnailer_t *thumbnailer;
+
+    vlc_mutex_lock(&priv->lock);
+    if (priv->p_thumbnailer == NULL)
+    {
+        priv->p_thumbnailer = vlc_thumbnailer_Create(VLC_OBJECT(libvlc));
+        if (priv->p_thumbnailer == NULL)
+            msg_Warn(libvlc, "Failed to instantiate thumbnailer");
+    }
+    thumbnailer = priv->p_thumbnailer;
+    vlc_mutex_unlock(&priv->lock);
+    return thumbnailer;
+}
+
 /**
  * Initialize a libvlc instance
  * This function initializes a previously allocated libvlc instance:
@@ -181,6 +267,10 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
 
     vlc_LogInit(p_libvlc);
     vlc_tracer_Init(p_libvlc);
+    vlc_memaccount_Init(p_libvlc);
+    vlc_mempolicy_Init(p_libvlc);
+    vlc_thread_policy_Init(p_libvlc);
+    libvlc_Preload(p_libvlc);
 
     /*
      * Support for gettext
@@ -217,23 +307,12 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
             msg_Warn( p_libvlc, "Media library initialization failed" );
     }
 
-    priv->p_thumbnailer = vlc_thumbnailer_Create( VLC_OBJECT( p_libvlc ) );
-    if ( priv->p_thumbnailer == NULL )
-        msg_Warn( p_libvlc, "Failed to instantiate thumbnailer" );
-
     /*
      * Initialize hotkey handling
      */
     if( libvlc_InternalActionsInit( p_libvlc ) != VLC_SUCCESS )
         goto error;
 
-    /*
-     * Meta data handling
-     */
-    priv->parser = input_preparser_New(VLC_OBJECT(p_libvlc));
-    if( !priv->parser )
-        goto error;
-
     priv->media_source_provider = vlc_media_source_provider_New( VLC_OBJECT( p_libvlc ) );
     if( !priv->media_source_provider )
         goto error;
@@ -342,8 +421,14 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
 {
     libvlc_priv_t *priv = libvlc_priv (p_libvlc);
 
-    if (priv->parser != NULL)
-        input_preparser_Deactivate(priv->parser);
+    if (priv->preloading)
+        vlc_join(priv->preloader, NULL);
+
+    vlc_mutex_lock(&priv->lock);
+    input_preparser_t *parser = priv->parser;
+    vlc_mutex_unlock(&priv->lock);
+    if (parser != NULL)
+        input_preparser_Deactivate(parser);
 
     /* Ask the interfaces to stop and destroy them */
     msg_Dbg( p_libvlc, "removing all interfaces" );
@@ -389,10 +474,16 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
 
     libvlc_InternalActionsClean( p_libvlc );
 
+    if( priv->image_cache )
+        vlc_image_cache_Delete( priv->image_cache );
+
     /* Save the configuration */
     if( !var_InheritBool( p_libvlc, "ignore-config" ) )
         config_AutoSaveConfigFile( p_libvlc );
 
+    picture_FlushRecycled();
+    vlc_thread_policy_Deinit(p_libvlc);
+
     vlc_LogDestroy(p_libvlc->obj.logger);
     vlc_tracer_Destroy(p_libvlc);
     /* Free module bank. It is refcounted, so we call this each time  */
@@ -456,12 +547,12 @@ int vlc_MetadataRequest(libvlc_int_t *libvlc, input_item_t *item,
                         void *cbs_userdata,
                         int timeout, void *id)
 {
-    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    input_preparser_t *parser = libvlc_GetPreparser(libvlc);
 
-    if (unlikely(priv->parser == NULL))
+    if (unlikely(parser == NULL))
         return VLC_ENOMEM;
 
-    return input_preparser_Push( priv->parser, item, i_options, cbs,
+    return input_preparser_Push( parser, item, i_options, cbs,
                                  cbs_userdata, timeout, id );
 }
 
@@ -476,12 +567,8 @@ int libvlc_MetadataRequest(libvlc_int_t *libvlc, input_item_t *item,
                            void *cbs_userdata,
                            int timeout, void *id)
 {
-    libvlc_priv_t *priv = libvlc_priv(libvlc);
     assert(i_options & META_REQUEST_OPTION_SCOPE_ANY);
 
-    if (unlikely(priv->parser == NULL))
-        return VLC_ENOMEM;
-
     vlc_mutex_lock( &item->lock );
     if( item->i_preparse_depth == 0 )
         item->i_preparse_depth = 1;
@@ -499,13 +586,13 @@ int libvlc_ArtRequest(libvlc_int_t *libvlc, input_item_t *item,
                       const input_fetcher_callbacks_t *cbs,
                       void *cbs_userdata)
 {
-    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    input_preparser_t *parser = libvlc_GetPreparser(libvlc);
     assert(i_options & META_REQUEST_OPTION_FETCH_ANY);
 
-    if (unlikely(priv->parser == NULL))
+    if (unlikely(parser == NULL))
         return VLC_ENOMEM;
 
-    input_preparser_fetcher_Push(priv->parser, item, i_options,
+    input_preparser_fetcher_Push(parser, item, i_options,
                                  cbs, cbs_userdata);
     return VLC_SUCCESS;
 }
@@ -519,9 +606,13 @@ int libvlc_ArtRequest(libvlc_int_t *libvlc, input_item_t *item,
 void libvlc_MetadataCancel(libvlc_int_t *libvlc, void *id)
 {
     libvlc_priv_t *priv = libvlc_priv(libvlc);
+    input_preparser_t *parser;
 
-    if (unlikely(priv->parser == NULL))
-        return;
+    /* Nothing to cancel if nothing was requested */
+    vlc_mutex_lock(&priv->lock);
+    parser = priv->parser;
+    vlc_mutex_unlock(&priv->lock);
 
-    input_preparser_Cancel(priv->parser, id);
+    if (parser != NULL)
+        input_preparser_Cancel(parser, id);
 }
@@ -65,6 +65,11 @@ typedef struct vlc_tracer vlc_tracer_t;
 void vlc_tracer_Init(libvlc_int_t *);
 void vlc_tracer_Destroy(libvlc_int_t *);
 
+/*
+ * Memory accounting
+ */
+void vlc_memaccount_Init(libvlc_int_t *);
+
 /*
  * LibVLC exit event handling
  */
@@ -165,6 +170,48 @@ void vlc_objres_clear(vlc_object_t *obj);
 void vlc_objres_remove(vlc_object_t *obj, void *data,
                        bool (*match)(void *, void *));
 
+/*
+ * Networking
+ */
+struct addrinfo;
+
+/**
+ * Resolves a host name, through a process-wide cache.
+ *
+ * This is like vlc_getaddrinfo_i11e(), but the successful resolutions are
+ * kept for a short while.
+ *
+ * @note The result must be freed with vlc_freeaddrinfo_cached().
+ */
+int vlc_getaddrinfo_cached(const char *node, unsigned port,
+                           const struct addrinfo *hints,
+                           struct addrinfo **res);
+
+void vlc_freeaddrinfo_cached(struct addrinfo *res);
+
+/**
+ * Connects a stream socket to the first reachable address of a list.
+ *
+ * The connection attempts are staggered and race each other, alternating
+ * the address families, as per RFC 8305 (Happy Eyeballs).
+ *
+ * @param timeout maximum time to wait for each connection attempt,
+ *                or VLC_TICK_INVALID to wait indefinitely
+ * @return a connected non-blocking socket, or -1 on error
+ */
+int net_ConnectAddrInfo(vlc_object_t *obj, const struct addrinfo *res,
+                        vlc_tick_t timeout);
+
+/*
+ * Images
+ */
+struct vlc_image_cache;
+
+/**
+ * Destroys the decoded images cache of an instance.
+ */
+void vlc_image_cache_Delete(struct vlc_image_cache *);
+
 /**
  * Private LibVLC instance data.
  */
@@ -186,12 +233,15 @@ typedef struct libvlc_priv_t
     vlc_keystore      *p_memory_keystore; ///< memory keystore
     intf_thread_t *interfaces;  ///< Linked-list of interfaces
     vlc_playlist_t *main_playlist;
-    struct input_preparser_t *parser; ///< Input item meta data handler
+    struct input_preparser_t *parser; ///< Lazily instantiated meta data handler
     vlc_media_source_provider_t *media_source_provider;
     vlc_actions_t *actions; ///< Hotkeys handler
     struct vlc_medialibrary_t *p_media_library; ///< Media library instance
     struct vlc_thumbnailer_t *p_thumbnailer; ///< Lazily instantiated media thumbnailer
+    struct vlc_image_cache *image_cache; ///< Lazily instantiated decoded images cache
     struct vlc_tracer *tracer; ///< Tracer callbacks
+    vlc_thread_t preloader; ///< Background plugins mapping
+    bool preloading;
 
     /* Exit callback */
     vlc_exit_t       exit;
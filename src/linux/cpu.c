@@ -111,6 +111,7 @@ unsigned vlc_CPU_raw(void)
     {
         char *p, *cap;
         uint_fast32_t core_caps = 0;
+        unsigned avx512 = 0;
 
         if (strncmp(line, "flags", 5))
             continue;
@@ -134,7 +135,11 @@ unsigned vlc_CPU_raw(void)
                 core_caps |= VLC_CPU_AVX;
             if (!strcmp (cap, "avx2"))
                 core_caps |= VLC_CPU_AVX2;
+            if (!strcmp (cap, "avx512f") || !strcmp (cap, "avx512bw"))
+                avx512++;
         }
+        if (avx512 == 2)
+            core_caps |= VLC_CPU_AVX512;
 
         /* Take the intersection of capabilities of each processor */
         all_caps &= core_caps;
@@ -40,6 +40,7 @@
 
 #include <vlc_common.h>
 #include <vlc_atomic.h>
+#include "misc/thread_policy.h"
 
 unsigned long vlc_thread_id(void)
 {
@@ -54,6 +55,7 @@ unsigned long vlc_thread_id(void)
 void (vlc_thread_set_name)(const char *name)
 {
     prctl(PR_SET_NAME, name);
+    vlc_thread_policy_SetName(name);
 }
 
 static int sys_futex(void *addr, int op, unsigned val,
@@ -162,9 +162,22 @@ media_subtree_changed(input_item_t *media, input_item_node_t *node,
         return;
     }
 
-    vlc_media_tree_ClearChildren(subtree_root);
-    vlc_media_tree_AddSubtree(subtree_root, node);
-    vlc_media_tree_Notify(tree, on_children_reset, subtree_root);
+    if (node->b_continued)
+    {
+        /* a further batch of the same subtree */
+        int count = subtree_root->i_children;
+        vlc_media_tree_AddSubtree(subtree_root, node);
+        if (subtree_root->i_children > count)
+            vlc_media_tree_Notify(tree, on_children_added, subtree_root,
+                                  &subtree_root->pp_children[count],
+                                  subtree_root->i_children - count);
+    }
+    else
+    {
+        vlc_media_tree_ClearChildren(subtree_root);
+        vlc_media_tree_AddSubtree(subtree_root, node);
+        vlc_media_tree_Notify(tree, on_children_reset, subtree_root);
+    }
     vlc_media_tree_Unlock(tree);
 }
 
@@ -0,0 +1,254 @@
+/*****************************************************************************
+ * misc/cachefile.c: files of the user cache directory
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/stat.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_cachefile.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_strings.h>
+#include <vlc_vector.h>
+
+struct vlc_cachefile
+{
+    vlc_object_t *obj;
+    FILE *file;
+    char *dir;
+    char *path;
+    char *tmp;
+};
+
+static char *GetDir(const char *name)
+{
+    char *cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    if (cachedir == NULL)
+        return NULL;
+
+    char *dir;
+    if (asprintf(&dir, "%s" DIR_SEP "%s", cachedir, name) == -1)
+        dir = NULL;
+    free(cachedir);
+    return dir;
+}
+
+static char *GetPath(const char *dir, const char *key)
+{
+    vlc_hash_md5_t md5;
+    char hex[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_md5_Init(&md5);
+    vlc_hash_md5_Update(&md5, key, strlen(key));
+    vlc_hash_FinishHex(&md5, hex);
+
+    char *path;
+    if (asprintf(&path, "%s" DIR_SEP "%s", dir, hex) == -1)
+        path = NULL;
+    return path;
+}
+
+char *vlc_cachefile_GetPath(const char *name, const char *key)
+{
+    char *dir = GetDir(name);
+    if (dir == NULL)
+        return NULL;
+
+    char *path = GetPath(dir, key);
+    free(dir);
+    return path;
+}
+
+FILE *vlc_cachefile_Open(const char *name, const char *key)
+{
+    char *path = vlc_cachefile_GetPath(name, key);
+    if (path == NULL)
+        return NULL;
+
+    FILE *file = vlc_fopen(path, "rt");
+    free(path);
+    return file;
+}
+
+#undef vlc_cachefile_Create
+vlc_cachefile_t *vlc_cachefile_Create(vlc_object_t *obj, const char *name,
+                                      const char *key)
+{
+    vlc_cachefile_t *entry = malloc(sizeof (*entry));
+    if (unlikely(entry == NULL))
+        return NULL;
+
+    char *cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    if (cachedir != NULL)
+    {
+        vlc_mkdir(cachedir, 0700);
+        free(cachedir);
+    }
+
+    entry->obj = obj;
+    entry->dir = GetDir(name);
+    if (entry->dir == NULL)
+        goto error;
+    vlc_mkdir(entry->dir, 0700);
+
+    entry->path = GetPath(entry->dir, key);
+    if (entry->path == NULL)
+        goto error_dir;
+    if (asprintf(&entry->tmp, "%s.%lu.tmp", entry->path,
+                 (unsigned long) vlc_thread_id()) == -1)
+        goto error_path;
+
+    entry->file = vlc_fopen(entry->tmp, "wt");
+    if (entry->file == NULL)
+    {
+        msg_Dbg(obj, "cannot write cache file %s: %s", entry->tmp,
+                vlc_strerror_c(errno));
+        free(entry->tmp);
+        goto error_path;
+    }
+    return entry;
+
+error_path:
+    free(entry->path);
+error_dir:
+    free(entry->dir);
+error:
+    free(entry);
+    return NULL;
+}
+
+FILE *vlc_cachefile_GetFile(vlc_cachefile_t *entry)
+{
+    return entry->file;
+}
+
+static void Release(vlc_cachefile_t *entry)
+{
+    free(entry->tmp);
+    free(entry->path);
+    free(entry->dir);
+    free(entry);
+}
+
+void vlc_cachefile_Abort(vlc_cachefile_t *entry)
+{
+    fclose(entry->file);
+    vlc_unlink(entry->tmp);
+    Release(entry);
+}
+
+struct cache_item
+{
+    char *path;
+    time_t mtime;
+    uint64_t size;
+};
+
+static int CompareItems(const void *a, const void *b)
+{
+    const struct cache_item *ia = a, *ib = b;
+
+    return (ia->mtime > ib->mtime) - (ia->mtime < ib->mtime);
+}
+
+/* Removes the oldest files of the directory until it fits in max_size,
+ * except the entry just stored */
+static void Evict(vlc_object_t *obj, const char *dirpath, const char *keep,
+                  uint64_t max_size)
+{
+    DIR *dir = vlc_opendir(dirpath);
+    if (dir == NULL)
+        return;
+
+    struct VLC_VECTOR(struct cache_item) items = VLC_VECTOR_INITIALIZER;
+    uint64_t total = 0;
+    const char *name;
+
+    while ((name = vlc_readdir(dir)) != NULL)
+    {
+        struct cache_item item;
+        struct stat st;
+
+        if (name[0] == '.')
+            continue;
+        if (asprintf(&item.path, "%s" DIR_SEP "%s", dirpath, name) == -1)
+            break;
+        if (vlc_stat(item.path, &st) || !S_ISREG(st.st_mode))
+        {
+            free(item.path);
+            continue;
+        }
+        item.mtime = st.st_mtime;
+        item.size = st.st_size;
+        total += item.size;
+        if (!strcmp(item.path, keep))
+        {
+            free(item.path);
+            continue;
+        }
+        if (!vlc_vector_push(&items, item))
+        {
+            free(item.path);
+            break;
+        }
+    }
+    closedir(dir);
+
+    if (total > max_size)
+    {
+        size_t removed = 0;
+
+        qsort(items.data, items.size, sizeof (items.data[0]), CompareItems);
+        for (size_t i = 0; i < items.size && total > max_size; i++)
+            if (vlc_unlink(items.data[i].path) == 0)
+            {
+                total -= items.data[i].size;
+                removed++;
+            }
+        msg_Dbg(obj, "%zu old entries removed from %s", removed, dirpath);
+    }
+
+    for (size_t i = 0; i < items.size; i++)
+        free(items.data[i].path);
+    vlc_vector_destroy(&items);
+}
+
+int vlc_cachefile_Commit(vlc_cachefile_t *entry, uint64_t max_size)
+{
+    bool error = ferror(entry->file);
+    int ret = VLC_SUCCESS;
+
+    if (fclose(entry->file) || error || vlc_rename(entry->tmp, entry->path))
+    {
+        msg_Dbg(entry->obj, "cannot store cache file %s", entry->path);
+        vlc_unlink(entry->tmp);
+        ret = VLC_EGENERIC;
+    }
+    else
+        Evict(entry->obj, entry->dir, entry->path, max_size);
+
+    Release(entry);
+    return ret;
+}
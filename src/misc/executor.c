@@ -46,8 +46,16 @@ struct vlc_executor_thread {
 
     /** The current task executed by the thread, NULL if none */
     struct vlc_runnable *current_task;
+
+    /** True while the current task is blocked on I/O */
+    bool blocking;
 };
 
+#define PRIORITY_COUNT (VLC_EXECUTOR_PRIORITY_HIGH + 1)
+
+/** The executor thread running on the calling thread, if any */
+static thread_local struct vlc_executor_thread *current_thread;
+
 /**
  * The executor (also vlc_executor_t, exposed as opaque type in the public
  * header).
@@ -55,7 +63,7 @@ struct vlc_executor_thread {
 struct vlc_executor {
     vlc_mutex_t lock;
 
-    /** Maximum number of threads to run the tasks */
+    /** Maximum number of tasks running (and not blocked on I/O) */
     unsigned max_threads;
 
     /** List of active vlc_executor_thread */
@@ -67,43 +75,72 @@ struct vlc_executor {
     /* Number of tasks requested but not finished. */
     unsigned unfinished;
 
+    /** Number of threads executing a task */
+    unsigned nbusy;
+
+    /** Number of busy threads blocked on I/O (see vlc_executor_BeginIO()) */
+    unsigned nblocking;
+
     /** Wait for the executor to be idle (i.e. unfinished == 0) */
     vlc_cond_t idle_wait;
 
-    /** Queue of vlc_runnable */
-    struct vlc_list queue;
+    /** Queues of vlc_runnable, one per priority */
+    struct vlc_list queues[PRIORITY_COUNT];
 
-    /** Wait for the queue to be non-empty */
+    /** Wait for a queued runnable to be allowed to run */
     vlc_cond_t queue_wait;
 
     /** True if executor deletion is requested */
     bool closing;
 };
 
+static bool
+QueueIsEmpty(vlc_executor_t *executor)
+{
+    for (int i = 0; i < PRIORITY_COUNT; ++i)
+        if (!vlc_list_is_empty(&executor->queues[i]))
+            return false;
+    return true;
+}
+
 static void
-QueuePush(vlc_executor_t *executor, struct vlc_runnable *runnable)
+QueuePush(vlc_executor_t *executor, struct vlc_runnable *runnable,
+          enum vlc_executor_priority priority)
 {
     vlc_mutex_assert(&executor->lock);
+    assert(priority < PRIORITY_COUNT);
 
-    vlc_list_append(&runnable->node, &executor->queue);
+    vlc_list_append(&runnable->node, &executor->queues[priority]);
     vlc_cond_signal(&executor->queue_wait);
 }
 
+static bool
+CanRun(vlc_executor_t *executor)
+{
+    /* Threads blocked on I/O do not count against max_threads */
+    return !QueueIsEmpty(executor)
+        && executor->nbusy - executor->nblocking < executor->max_threads;
+}
+
 static struct vlc_runnable *
 QueueTake(vlc_executor_t *executor)
 {
     vlc_mutex_assert(&executor->lock);
 
-    while (!executor->closing && vlc_list_is_empty(&executor->queue))
+    while (!executor->closing && !CanRun(executor))
         vlc_cond_wait(&executor->queue_wait, &executor->lock);
 
     if (executor->closing)
         return NULL;
 
-    struct vlc_runnable *runnable =
-        vlc_list_first_entry_or_null(&executor->queue, struct vlc_runnable,
-                                     node);
-    assert(runnable);
+    /* Serve the highest priority first, in submission order */
+    struct vlc_runnable *runnable = NULL;
+    for (int i = PRIORITY_COUNT - 1; runnable == NULL; --i)
+    {
+        assert(i >= 0);
+        runnable = vlc_list_first_entry_or_null(&executor->queues[i],
+                                                struct vlc_runnable, node);
+    }
     vlc_list_remove(&runnable->node);
 
     /* Set links to NULL to know that it has been taken by a thread in
@@ -120,6 +157,7 @@ ThreadRun(void *userdata)
     vlc_executor_t *executor = thread->owner;
 
     vlc_thread_set_name("vlc-exec-runner");
+    current_thread = thread;
 
     vlc_mutex_lock(&executor->lock);
 
@@ -128,13 +166,17 @@ ThreadRun(void *userdata)
     while ((runnable = QueueTake(executor)))
     {
         thread->current_task = runnable;
+        executor->nbusy++;
         vlc_mutex_unlock(&executor->lock);
 
         /* Execute the user-provided runnable, without the executor lock */
         runnable->run(runnable->userdata);
 
         vlc_mutex_lock(&executor->lock);
+        assert(!thread->blocking);
         thread->current_task = NULL;
+        assert(executor->nbusy > 0);
+        executor->nbusy--;
 
         vlc_thread_set_name("vlc-exec-runner");
 
@@ -152,7 +194,7 @@ ThreadRun(void *userdata)
 static int
 SpawnThread(vlc_executor_t *executor)
 {
-    assert(executor->nthreads < executor->max_threads);
+    assert(executor->nthreads < 2 * executor->max_threads);
 
     struct vlc_executor_thread *thread = malloc(sizeof(*thread));
     if (!thread)
@@ -160,6 +202,7 @@ SpawnThread(vlc_executor_t *executor)
 
     thread->owner = executor;
     thread->current_task = NULL;
+    thread->blocking = false;
 
     if (vlc_clone(&thread->thread, ThreadRun, thread))
     {
@@ -186,9 +229,12 @@ vlc_executor_New(unsigned max_threads)
     executor->max_threads = max_threads;
     executor->nthreads = 0;
     executor->unfinished = 0;
+    executor->nbusy = 0;
+    executor->nblocking = 0;
 
     vlc_list_init(&executor->threads);
-    vlc_list_init(&executor->queue);
+    for (int i = 0; i < PRIORITY_COUNT; ++i)
+        vlc_list_init(&executor->queues[i]);
 
     vlc_cond_init(&executor->idle_wait);
     vlc_cond_init(&executor->queue_wait);
@@ -206,23 +252,84 @@ vlc_executor_New(unsigned max_threads)
     return executor;
 }
 
+static void
+SpawnThreadIfNeeded(vlc_executor_t *executor)
+{
+    vlc_mutex_assert(&executor->lock);
+
+    /* Up to max_threads extra threads replace the ones blocked on I/O */
+    unsigned limit = executor->max_threads
+                   + __MIN(executor->nblocking, executor->max_threads);
+    unsigned queued = executor->unfinished - executor->nbusy;
+    unsigned idle = executor->nthreads - executor->nbusy;
+
+    if (queued > idle && executor->nthreads < limit)
+        /* If it fails, this is not an error, there is at least one thread */
+        SpawnThread(executor);
+}
+
 void
-vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable)
+vlc_executor_SubmitWithPriority(vlc_executor_t *executor,
+                                struct vlc_runnable *runnable,
+                                enum vlc_executor_priority priority)
 {
     vlc_mutex_lock(&executor->lock);
 
     assert(!executor->closing);
 
-    QueuePush(executor, runnable);
+    QueuePush(executor, runnable, priority);
 
-    if (++executor->unfinished > executor->nthreads
-            && executor->nthreads < executor->max_threads)
-        /* If it fails, this is not an error, there is at least one thread */
-        SpawnThread(executor);
+    ++executor->unfinished;
+    SpawnThreadIfNeeded(executor);
 
     vlc_mutex_unlock(&executor->lock);
 }
 
+void
+vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable)
+{
+    vlc_executor_SubmitWithPriority(executor, runnable,
+                                    VLC_EXECUTOR_PRIORITY_NORMAL);
+}
+
+void
+vlc_executor_BeginIO(void)
+{
+    struct vlc_executor_thread *thread = current_thread;
+    if (thread == NULL)
+        return; /* not called from a runnable */
+
+    vlc_executor_t *executor = thread->owner;
+
+    vlc_mutex_lock(&executor->lock);
+    assert(thread->current_task != NULL);
+    assert(!thread->blocking);
+    thread->blocking = true;
+    executor->nblocking++;
+
+    /* Let another task run meanwhile */
+    SpawnThreadIfNeeded(executor);
+    vlc_cond_signal(&executor->queue_wait);
+    vlc_mutex_unlock(&executor->lock);
+}
+
+void
+vlc_executor_EndIO(void)
+{
+    struct vlc_executor_thread *thread = current_thread;
+    if (thread == NULL)
+        return;
+
+    vlc_executor_t *executor = thread->owner;
+
+    vlc_mutex_lock(&executor->lock);
+    assert(thread->blocking);
+    thread->blocking = false;
+    assert(executor->nblocking > 0);
+    executor->nblocking--;
+    vlc_mutex_unlock(&executor->lock);
+}
+
 bool
 vlc_executor_Cancel(vlc_executor_t *executor, struct vlc_runnable *runnable)
 {
@@ -264,7 +371,7 @@ vlc_executor_Delete(vlc_executor_t *executor)
     executor->closing = true;
 
     /* All the tasks must be canceled on delete */
-    assert(vlc_list_is_empty(&executor->queue));
+    assert(QueueIsEmpty(executor));
 
     vlc_mutex_unlock(&executor->lock);
 
@@ -283,7 +390,7 @@ vlc_executor_Delete(vlc_executor_t *executor)
     }
 
     /* The queue must still be empty (no runnable submitted a new runnable) */
-    assert(vlc_list_is_empty(&executor->queue));
+    assert(QueueIsEmpty(executor));
 
     /* There are no tasks anymore */
     assert(!executor->unfinished);
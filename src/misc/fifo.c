@@ -29,17 +29,30 @@
 #include <stdlib.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_block.h>
 #include "libvlc.h"
 
 /**
  * Internal state for block queues
+ *
+ * Single-producer FIFOs (see vlc_fifo_NewSPSC()) also have a lock-free inbox
+ * (a LIFO stack) where vlc_fifo_Put() pushes blocks without locking. Blocks
+ * are moved from the inbox into the queue, in order, whenever the queue is
+ * accessed with the lock held.
  */
 struct vlc_fifo_t
 {
     vlc_queue_t         q;
     size_t              i_depth;
     size_t              i_size;
+
+    bool                spsc;
+    _Atomic(block_t *)  inbox;
+    /* Inbox accounting, may transiently under-estimate by in-flight puts */
+    atomic_size_t       inbox_depth;
+    atomic_size_t       inbox_size;
+    atomic_bool         parked;
 };
 
 static_assert (offsetof (block_fifo_t, q) == 0, "Problems in <vlc_block.h>");
@@ -49,20 +62,88 @@ bool vlc_fifo_Held(const block_fifo_t *fifo)
     return vlc_mutex_held(&fifo->q.lock);
 }
 
+/**
+ * Moves the blocks from the inbox of a locked FIFO to its queue.
+ */
+static void vlc_fifo_Absorb(block_fifo_t *fifo)
+{
+    vlc_mutex_assert(&fifo->q.lock);
+
+    if (!fifo->spsc)
+        return;
+
+    block_t *stack = atomic_exchange(&fifo->inbox, NULL);
+    if (stack == NULL)
+        return;
+
+    /* Reverse the stack into the queue order */
+    block_t *list = NULL;
+    size_t depth = 0, size = 0;
+
+    while (stack != NULL)
+    {
+        block_t *next = stack->p_next;
+
+        stack->p_next = list;
+        list = stack;
+        depth++;
+        size += stack->i_buffer;
+        stack = next;
+    }
+
+    atomic_fetch_sub_explicit(&fifo->inbox_depth, depth, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&fifo->inbox_size, size, memory_order_relaxed);
+    fifo->i_depth += depth;
+    fifo->i_size += size;
+    vlc_queue_EnqueueUnlocked(&fifo->q, list);
+}
+
 size_t vlc_fifo_GetCount(const block_fifo_t *fifo)
 {
     vlc_mutex_assert(&fifo->q.lock);
+    if (fifo->spsc)
+        return fifo->i_depth
+             + atomic_load_explicit(&fifo->inbox_depth, memory_order_relaxed);
     return fifo->i_depth;
 }
 
 size_t vlc_fifo_GetBytes(const block_fifo_t *fifo)
 {
     vlc_mutex_assert(&fifo->q.lock);
+    if (fifo->spsc)
+        return fifo->i_size
+             + atomic_load_explicit(&fifo->inbox_size, memory_order_relaxed);
     return fifo->i_size;
 }
 
+bool vlc_fifo_IsEmpty(const block_fifo_t *fifo)
+{
+    if (fifo->spsc && atomic_load(&fifo->inbox) != NULL)
+        return false;
+    return vlc_queue_IsEmpty(&fifo->q);
+}
+
+void vlc_fifo_Wait(block_fifo_t *fifo)
+{
+    if (!fifo->spsc)
+    {
+        vlc_queue_Wait(&fifo->q);
+        return;
+    }
+
+    /* Tell the producer to signal, unless it has already pushed a block, in
+     * which case this returns spuriously. */
+    atomic_store(&fifo->parked, true);
+    if (atomic_load(&fifo->inbox) == NULL)
+        vlc_queue_Wait(&fifo->q);
+    atomic_store(&fifo->parked, false);
+}
+
 void vlc_fifo_QueueUnlocked(block_fifo_t *fifo, block_t *block)
 {
+    /* Preserve the order with blocks already in the inbox */
+    vlc_fifo_Absorb(fifo);
+
     for (block_t *b = block; b != NULL; b = b->p_next) {
         fifo->i_depth++;
         fifo->i_size += b->i_buffer;
@@ -71,8 +152,47 @@ void vlc_fifo_QueueUnlocked(block_fifo_t *fifo, block_t *block)
     vlc_queue_EnqueueUnlocked(&fifo->q, block);
 }
 
+void vlc_fifo_Put(block_fifo_t *fifo, block_t *block)
+{
+    if (!fifo->spsc)
+    {
+        vlc_fifo_Lock(fifo);
+        vlc_fifo_QueueUnlocked(fifo, block);
+        vlc_fifo_Unlock(fifo);
+        return;
+    }
+
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+        block_t *top = atomic_load_explicit(&fifo->inbox, memory_order_relaxed);
+
+        /* The consumer only ever empties the inbox, so this cannot loop more
+         * than once per consumer access. */
+        do
+            block->p_next = top;
+        while (!atomic_compare_exchange_weak(&fifo->inbox, &top, block));
+
+        atomic_fetch_add_explicit(&fifo->inbox_depth, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&fifo->inbox_size, block->i_buffer,
+                                  memory_order_relaxed);
+        block = next;
+    }
+
+    /* Only wake the consumer up if it is (about to be) waiting */
+    if (atomic_load(&fifo->parked))
+    {
+        vlc_fifo_Lock(fifo);
+        vlc_fifo_Signal(fifo);
+        vlc_fifo_Unlock(fifo);
+    }
+}
+
 block_t *vlc_fifo_DequeueUnlocked(block_fifo_t *fifo)
 {
+    if (vlc_queue_IsEmpty(&fifo->q))
+        vlc_fifo_Absorb(fifo);
+
     block_t *block = vlc_queue_DequeueUnlocked(&fifo->q);
 
     if (block != NULL) {
@@ -87,12 +207,13 @@ block_t *vlc_fifo_DequeueUnlocked(block_fifo_t *fifo)
 
 block_t *vlc_fifo_DequeueAllUnlocked(block_fifo_t *fifo)
 {
+    vlc_fifo_Absorb(fifo);
     fifo->i_depth = 0;
     fifo->i_size = 0;
     return vlc_queue_DequeueAllUnlocked(&fifo->q);
 }
 
-block_fifo_t *vlc_fifo_New( void )
+static block_fifo_t *vlc_fifo_Create(bool spsc)
 {
     block_fifo_t *p_fifo = malloc( sizeof( block_fifo_t ) );
 
@@ -100,11 +221,26 @@ block_fifo_t *vlc_fifo_New( void )
         vlc_queue_Init(&p_fifo->q, offsetof (block_t, p_next));
         p_fifo->i_depth = 0;
         p_fifo->i_size = 0;
+        p_fifo->spsc = spsc;
+        atomic_init(&p_fifo->inbox, NULL);
+        atomic_init(&p_fifo->inbox_depth, 0);
+        atomic_init(&p_fifo->inbox_size, 0);
+        atomic_init(&p_fifo->parked, false);
     }
 
     return p_fifo;
 }
 
+block_fifo_t *vlc_fifo_New( void )
+{
+    return vlc_fifo_Create(false);
+}
+
+block_fifo_t *vlc_fifo_NewSPSC( void )
+{
+    return vlc_fifo_Create(true);
+}
+
 void vlc_fifo_Delete( block_fifo_t *p_fifo )
 {
     vlc_fifo_Empty(p_fifo);
@@ -135,6 +271,8 @@ block_t *vlc_fifo_Show( block_fifo_t *p_fifo )
     block_t *b;
 
     vlc_fifo_Lock(p_fifo);
+    if (p_fifo->q.first == NULL)
+        vlc_fifo_Absorb(p_fifo);
     assert(p_fifo->q.first != NULL);
     b = (block_t *)p_fifo->q.first;
     vlc_fifo_Unlock(p_fifo);
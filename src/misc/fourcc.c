@@ -542,6 +542,7 @@ static const vlc_fourcc_t p_list_YUV[] = {
     VLC_CODEC_YUV_SEMIPLANAR_444,
     VLC_CODEC_YUV_PACKED,
     VLC_CODEC_I411, VLC_CODEC_YUV_PLANAR_410, VLC_CODEC_Y211,
+    VLC_CODEC_V210,
     VLC_CODEC_YUV_PLANAR_420_16,
     VLC_CODEC_YUV_SEMIPLANAR_420_16,
     VLC_CODEC_YUV_PLANAR_422_16,
@@ -811,6 +812,7 @@ static const struct
         VLC_CODEC_Y410, 0 },                   PACKED_FMT(4, 32) },
 
     { { VLC_CODEC_Y211, 0 },                   { 1, { {{1,4}, {1,1}} }, 4, 32 } },
+    { { VLC_CODEC_V210, 0 },                   { 1, { {{2,3}, {1,1}} }, 4, 32 } },
     { { VLC_CODEC_XYZ12,  0 },                 PACKED_FMT(6, 48) },
 
     { { VLC_CODEC_VDPAU_VIDEO, VLC_CODEC_VDPAU_OUTPUT },
@@ -837,6 +839,8 @@ static const struct
 
     { { VLC_CODEC_GST_MEM_OPAQUE, 0 },         FAKE_FMT() },
 
+    { { VLC_CODEC_V4L2M2M_OPAQUE, 0 },         FAKE_FMT() },
+
     { { VLC_CODEC_VAAPI_420, VLC_CODEC_VAAPI_420_10BPP },
                                                FAKE_FMT() },
 
@@ -34,9 +34,11 @@
 #include <vlc_common.h>
 #include <vlc_atomic.h>
 #include <vlc_frame.h>
+#include <vlc_memaccount.h>
 #include <vlc_fs.h>
 
 #include "ancillary.h"
+#include "mempolicy.h"
 
 #ifndef NDEBUG
 static void vlc_frame_Check (vlc_frame_t *frame)
@@ -95,6 +97,8 @@ static void vlc_frame_generic_Release (vlc_frame_t *frame)
 {
     /* That is always true for frames allocated with vlc_frame_Alloc(). */
     assert (frame->p_start == (unsigned char *)(frame + 1));
+    vlc_memaccount_Remove(VLC_MEMACCOUNT_FRAME,
+                          sizeof (*frame) + frame->i_size);
     free (frame);
 }
 
@@ -129,6 +133,8 @@ vlc_frame_t *vlc_frame_Alloc (size_t size)
     if (unlikely(f == NULL))
         return NULL;
 
+    vlc_memaccount_Add(VLC_MEMACCOUNT_FRAME, alloc);
+    vlc_mempolicy_Advise(f, alloc);
     vlc_frame_Init(f, &vlc_frame_generic_cbs, f + 1, alloc - sizeof (*f));
     static_assert ((VLC_FRAME_PADDING % VLC_FRAME_ALIGN) == 0,
                    "VLC_FRAME_PADDING must be a multiple of VLC_FRAME_ALIGN");
@@ -138,6 +144,242 @@ vlc_frame_t *vlc_frame_Alloc (size_t size)
     return f;
 }
 
+/*
+ * Pooled frames
+ *
+ * Frames are recycled through per-thread caches, one per power-of-two size
+ * class. As frames are typically allocated by one thread (access, demux) and
+ * released by another (decoder, muxer), overflowing thread caches return
+ * batches of frames to a shared depot, from which starved thread caches are
+ * refilled.
+ */
+#define VLC_FRAME_POOL_MIN_SHIFT 9  /* 512 bytes */
+#define VLC_FRAME_POOL_MAX_SHIFT 17 /* 128 KiB */
+#define VLC_FRAME_POOL_CLASSES \
+    (VLC_FRAME_POOL_MAX_SHIFT - VLC_FRAME_POOL_MIN_SHIFT + 1)
+/** Maximum number of frames per size class in a thread cache */
+#define VLC_FRAME_POOL_THREAD_MAX 64
+/** Number of frames moved at once between a thread cache and the depot */
+#define VLC_FRAME_POOL_BATCH (VLC_FRAME_POOL_THREAD_MAX / 2)
+/** Maximum number of bytes per size class in the depot */
+#define VLC_FRAME_POOL_DEPOT_BYTES (4 << 20)
+
+struct vlc_frame_pool_class
+{
+    vlc_frame_t *first;
+    size_t count;
+};
+
+struct vlc_frame_pool_cache
+{
+    struct vlc_frame_pool_class classes[VLC_FRAME_POOL_CLASSES];
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    struct vlc_frame_pool_class classes[VLC_FRAME_POOL_CLASSES];
+} vlc_frame_depot = { VLC_STATIC_MUTEX, { { NULL, 0 } } };
+
+static atomic_uint_least64_t vlc_frame_pool_hits = 0;
+static atomic_uint_least64_t vlc_frame_pool_misses = 0;
+
+static vlc_threadvar_t vlc_frame_pool_key;
+static vlc_once_t vlc_frame_pool_once = VLC_STATIC_ONCE;
+
+static size_t vlc_frame_pool_ClassSize(unsigned index)
+{
+    return (size_t)1 << (VLC_FRAME_POOL_MIN_SHIFT + index);
+}
+
+static void vlc_frame_pool_FreeList(vlc_frame_t *frame)
+{
+    while (frame != NULL)
+    {
+        vlc_frame_t *next = frame->p_next;
+        free(frame);
+        frame = next;
+    }
+}
+
+static void vlc_frame_pool_CacheDestroy(void *data)
+{
+    struct vlc_frame_pool_cache *cache = data;
+
+    for (unsigned i = 0; i < VLC_FRAME_POOL_CLASSES; i++)
+        vlc_frame_pool_FreeList(cache->classes[i].first);
+    free(cache);
+}
+
+static void vlc_frame_pool_InitOnce(void *data)
+{
+    bool *ok = data;
+    *ok = vlc_threadvar_create(&vlc_frame_pool_key,
+                               vlc_frame_pool_CacheDestroy) == 0;
+}
+
+static struct vlc_frame_pool_cache *vlc_frame_pool_GetCache(void)
+{
+    static bool key_ok;
+
+    vlc_once(&vlc_frame_pool_once, vlc_frame_pool_InitOnce, &key_ok);
+    if (unlikely(!key_ok))
+        return NULL;
+
+    struct vlc_frame_pool_cache *cache = vlc_threadvar_get(vlc_frame_pool_key);
+    if (cache == NULL)
+    {
+        cache = calloc(1, sizeof (*cache));
+        if (unlikely(cache == NULL))
+            return NULL;
+        if (vlc_threadvar_set(vlc_frame_pool_key, cache))
+        {
+            free(cache);
+            return NULL;
+        }
+    }
+    return cache;
+}
+
+static void vlc_frame_pool_Release(vlc_frame_t *frame)
+{
+    /* The whole allocation is a power of two */
+    size_t alloc = sizeof (*frame) + frame->i_size;
+    unsigned index = ctz(alloc) - VLC_FRAME_POOL_MIN_SHIFT;
+    assert(index < VLC_FRAME_POOL_CLASSES);
+    assert(alloc == vlc_frame_pool_ClassSize(index));
+    /* Only the frames in use are accounted, not the cached ones */
+    vlc_memaccount_Remove(VLC_MEMACCOUNT_FRAME, alloc);
+
+    struct vlc_frame_pool_cache *cache = vlc_frame_pool_GetCache();
+    if (unlikely(cache == NULL))
+    {
+        free(frame);
+        return;
+    }
+
+    struct vlc_frame_pool_class *tc = &cache->classes[index];
+    frame->p_next = tc->first;
+    tc->first = frame;
+    tc->count++;
+
+    if (tc->count <= VLC_FRAME_POOL_THREAD_MAX)
+        return;
+
+    /* Return a batch to the depot, or to the heap if the depot is full */
+    vlc_frame_t *batch = tc->first, *last = batch;
+    for (unsigned i = 1; i < VLC_FRAME_POOL_BATCH; i++)
+        last = last->p_next;
+    tc->first = last->p_next;
+    tc->count -= VLC_FRAME_POOL_BATCH;
+
+    struct vlc_frame_pool_class *dc = &vlc_frame_depot.classes[index];
+    size_t max = VLC_FRAME_POOL_DEPOT_BYTES / alloc;
+
+    vlc_mutex_lock(&vlc_frame_depot.lock);
+    if (dc->count + VLC_FRAME_POOL_BATCH <= max)
+    {
+        last->p_next = dc->first;
+        dc->first = batch;
+        dc->count += VLC_FRAME_POOL_BATCH;
+        batch = NULL;
+    }
+    else
+        last->p_next = NULL;
+    vlc_mutex_unlock(&vlc_frame_depot.lock);
+
+    vlc_frame_pool_FreeList(batch);
+}
+
+static const struct vlc_frame_callbacks vlc_frame_pool_cbs =
+{
+    vlc_frame_pool_Release,
+};
+
+static vlc_frame_t *vlc_frame_pool_Get(unsigned index)
+{
+    struct vlc_frame_pool_cache *cache = vlc_frame_pool_GetCache();
+    if (unlikely(cache == NULL))
+        return NULL;
+
+    struct vlc_frame_pool_class *tc = &cache->classes[index];
+    if (tc->first == NULL)
+    {   /* Refill from the depot */
+        struct vlc_frame_pool_class *dc = &vlc_frame_depot.classes[index];
+
+        vlc_mutex_lock(&vlc_frame_depot.lock);
+        if (dc->first != NULL)
+        {
+            vlc_frame_t *last = dc->first;
+            size_t count = 1;
+
+            while (count < VLC_FRAME_POOL_BATCH && last->p_next != NULL)
+            {
+                last = last->p_next;
+                count++;
+            }
+            tc->first = dc->first;
+            tc->count = count;
+            dc->first = last->p_next;
+            dc->count -= count;
+            last->p_next = NULL;
+        }
+        vlc_mutex_unlock(&vlc_frame_depot.lock);
+
+        if (tc->first == NULL)
+            return NULL;
+    }
+
+    vlc_frame_t *f = tc->first;
+    tc->first = f->p_next;
+    tc->count--;
+    return f;
+}
+
+vlc_frame_t *vlc_frame_AllocPooled(size_t size)
+{
+    /* 2 * VLC_FRAME_PADDING: pre + post padding */
+    const size_t alloc = sizeof (vlc_frame_t) + VLC_FRAME_ALIGN + (2 * VLC_FRAME_PADDING)
+                       + size;
+    if (unlikely(alloc <= size)
+     || alloc > vlc_frame_pool_ClassSize(VLC_FRAME_POOL_CLASSES - 1))
+        return vlc_frame_Alloc(size);
+
+    /* Round up to the next power of two */
+    unsigned shift = (sizeof (alloc) * 8) - clz(alloc - 1);
+    unsigned index = shift > VLC_FRAME_POOL_MIN_SHIFT
+                   ? shift - VLC_FRAME_POOL_MIN_SHIFT : 0;
+    size_t class_size = vlc_frame_pool_ClassSize(index);
+
+    vlc_frame_t *f = vlc_frame_pool_Get(index);
+    if (f != NULL)
+        atomic_fetch_add_explicit(&vlc_frame_pool_hits, 1,
+                                  memory_order_relaxed);
+    else
+    {
+        atomic_fetch_add_explicit(&vlc_frame_pool_misses, 1,
+                                  memory_order_relaxed);
+        f = malloc(class_size);
+        if (unlikely(f == NULL))
+            return NULL;
+    }
+
+    vlc_memaccount_Add(VLC_MEMACCOUNT_FRAME, class_size);
+    vlc_frame_Init(f, &vlc_frame_pool_cbs, f + 1, class_size - sizeof (*f));
+    f->p_buffer += VLC_FRAME_PADDING + VLC_FRAME_ALIGN - 1;
+    f->p_buffer = (void *)(((uintptr_t)f->p_buffer) & ~(VLC_FRAME_ALIGN - 1));
+    f->i_buffer = size;
+    return f;
+}
+
+void vlc_frame_GetPoolStats(struct vlc_frame_pool_stats *stats)
+{
+    stats->hits = atomic_load_explicit(&vlc_frame_pool_hits,
+                                       memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&vlc_frame_pool_misses,
+                                         memory_order_relaxed);
+}
+
 void vlc_frame_Release(vlc_frame_t *frame)
 {
 #ifndef NDEBUG
@@ -151,7 +393,10 @@ void vlc_frame_Release(vlc_frame_t *frame)
 
 static vlc_frame_t *vlc_frame_ReallocDup( vlc_frame_t *frame, ssize_t i_prebody, size_t requested )
 {
-    vlc_frame_t *p_rea = vlc_frame_Alloc( requested );
+    /* Pooled frames stay pooled */
+    vlc_frame_t *p_rea = frame->cbs == &vlc_frame_pool_cbs
+                       ? vlc_frame_AllocPooled( requested )
+                       : vlc_frame_Alloc( requested );
     if( p_rea == NULL )
         return NULL;
 
@@ -248,6 +493,11 @@ vlc_frame_t *vlc_frame_Realloc (vlc_frame_t *frame, ssize_t prebody, size_t body
     return rea;
 }
 
+void vlc_frame_MoveLocal(vlc_frame_t *frame)
+{
+    vlc_mempolicy_MoveLocal(frame->p_buffer, frame->i_buffer);
+}
+
 static void vlc_frame_heap_Release (vlc_frame_t *frame)
 {
     free (frame->p_start);
@@ -271,6 +521,124 @@ vlc_frame_t *vlc_frame_heap_Alloc (void *addr, size_t length)
     return vlc_frame_Init(frame, &vlc_frame_heap_cbs, addr, length);
 }
 
+struct vlc_frame_shared
+{
+    vlc_atomic_rc_t rc;
+    vlc_frame_t *frame; /* owner of the payload */
+};
+
+struct vlc_frame_view
+{
+    vlc_frame_t self;
+    struct vlc_frame_shared *shared;
+};
+
+static void vlc_frame_view_Release (vlc_frame_t *frame)
+{
+    struct vlc_frame_view *view =
+        container_of(frame, struct vlc_frame_view, self);
+    struct vlc_frame_shared *shared = view->shared;
+
+    if (vlc_atomic_rc_dec(&shared->rc))
+    {
+        vlc_frame_Release(shared->frame);
+        free(shared);
+    }
+    free(view);
+}
+
+static const struct vlc_frame_callbacks vlc_frame_view_cbs =
+{
+    vlc_frame_view_Release,
+};
+
+static vlc_frame_t *vlc_frame_view_New(struct vlc_frame_shared *shared,
+                                       const vlc_frame_t *src)
+{
+    struct vlc_frame_view *view = malloc(sizeof (*view));
+    if (unlikely(view == NULL))
+        return NULL;
+
+    /* No spare room: the payload is read-only */
+    vlc_frame_Init(&view->self, &vlc_frame_view_cbs, src->p_buffer,
+                   src->i_buffer);
+    vlc_frame_CopyProperties(&view->self, src);
+    view->shared = shared;
+    return &view->self;
+}
+
+vlc_frame_t *vlc_frame_MakeShared(vlc_frame_t *frame)
+{
+    if (frame->cbs == &vlc_frame_view_cbs)
+        return frame;
+
+    struct vlc_frame_shared *shared = malloc(sizeof (*shared));
+    if (unlikely(shared == NULL))
+    {
+        vlc_frame_Release(frame);
+        return NULL;
+    }
+
+    vlc_frame_t *view = vlc_frame_view_New(shared, frame);
+    if (unlikely(view == NULL))
+    {
+        free(shared);
+        vlc_frame_Release(frame);
+        return NULL;
+    }
+
+    vlc_atomic_rc_init(&shared->rc);
+    shared->frame = frame;
+    view->p_next = frame->p_next;
+    frame->p_next = NULL;
+    return view;
+}
+
+vlc_frame_t *vlc_frame_Share(const vlc_frame_t *frame)
+{
+    if (frame->cbs != &vlc_frame_view_cbs)
+        return vlc_frame_Duplicate(frame);
+
+    const struct vlc_frame_view *view =
+        container_of(frame, const struct vlc_frame_view, self);
+    vlc_frame_t *dup = vlc_frame_view_New(view->shared, frame);
+
+    if (likely(dup != NULL))
+        vlc_atomic_rc_inc(&view->shared->rc);
+    return dup;
+}
+
+vlc_frame_t *vlc_frame_Writable(vlc_frame_t *frame)
+{
+    if (frame->cbs != &vlc_frame_view_cbs)
+        return frame;
+
+    struct vlc_frame_view *view =
+        container_of(frame, struct vlc_frame_view, self);
+    struct vlc_frame_shared *shared = view->shared;
+    vlc_frame_t *rea;
+
+    if (vlc_atomic_rc_get(&shared->rc) == 1)
+    {   /* Last reference: take the payload back from its owner */
+        rea = shared->frame;
+        rea->p_buffer = frame->p_buffer;
+        rea->i_buffer = frame->i_buffer;
+        rea->p_next = frame->p_next;
+        vlc_frame_CopyProperties(rea, frame);
+
+        vlc_ancillary_array_Clear(&frame->priv_ancillaries);
+        free(shared);
+        free(view);
+        return rea;
+    }
+
+    rea = vlc_frame_Duplicate(frame);
+    if (likely(rea != NULL))
+        rea->p_next = frame->p_next;
+    vlc_frame_Release(frame);
+    return rea;
+}
+
 #ifdef HAVE_MMAP
 # include <sys/mman.h>
 
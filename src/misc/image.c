@@ -35,6 +35,7 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <sys/stat.h>
 
 #include <vlc_common.h>
 #include <vlc_codec.h>
@@ -45,6 +46,8 @@
 #include <vlc_stream.h>
 #include <vlc_fs.h>
 #include <vlc_sout.h>
+#include <vlc_url.h>
+#include <vlc_list.h>
 #include <libvlc.h>
 #include <vlc_modules.h>
 
@@ -186,6 +189,10 @@ static picture_t *ImageRead( image_handler_t *p_image, block_t *p_block,
         }
     }
 
+    /* Let the decoder downscale while decoding if it can */
+    var_SetInteger( p_image->p_dec, "image-target-width", p_fmt_out->i_width );
+    var_SetInteger( p_image->p_dec, "image-target-height", p_fmt_out->i_height );
+
     p_block->i_pts = p_block->i_dts = vlc_tick_now();
     int ret = p_image->p_dec->pf_decode( p_image->p_dec, p_block );
     if( ret == VLCDEC_SUCCESS )
@@ -292,6 +299,207 @@ static picture_t *ImageRead( image_handler_t *p_image, block_t *p_block,
     return p_pic;
 }
 
+/*****************************************************************************
+ * Decoded image cache, shared by all the image handlers of an instance
+ *****************************************************************************/
+#define IMAGE_CACHE_MAX_SIZE (16 << 20)
+
+struct vlc_image_cache
+{
+    vlc_mutex_t lock;
+    struct vlc_list entries; /* most recently used first */
+    size_t i_size;
+};
+
+struct image_cache_key
+{
+    const char *psz_url;
+    /* requested output format */
+    vlc_fourcc_t i_chroma;
+    unsigned i_width;
+    unsigned i_height;
+    /* local file state, to notice modified files */
+    time_t i_mtime;
+    off_t i_filesize;
+};
+
+struct image_cache_entry
+{
+    struct vlc_list node;
+    char *psz_url;
+    struct image_cache_key key;
+    video_format_t fmt;
+    picture_t *p_pic;
+    size_t i_size;
+};
+
+static void ImageCacheEntryDelete( struct image_cache_entry *p_entry )
+{
+    picture_Release( p_entry->p_pic );
+    video_format_Clean( &p_entry->fmt );
+    free( p_entry->psz_url );
+    free( p_entry );
+}
+
+void vlc_image_cache_Delete( struct vlc_image_cache *p_cache )
+{
+    struct image_cache_entry *p_entry;
+    vlc_list_foreach( p_entry, &p_cache->entries, node )
+        ImageCacheEntryDelete( p_entry );
+    free( p_cache );
+}
+
+static struct vlc_image_cache *ImageCacheGet( vlc_object_t *p_obj )
+{
+    libvlc_priv_t *priv = libvlc_priv( vlc_object_instance( p_obj ) );
+    struct vlc_image_cache *p_cache;
+
+    vlc_mutex_lock( &priv->lock );
+    if( priv->image_cache == NULL )
+    {
+        p_cache = malloc( sizeof(*p_cache) );
+        if( p_cache != NULL )
+        {
+            vlc_mutex_init( &p_cache->lock );
+            vlc_list_init( &p_cache->entries );
+            p_cache->i_size = 0;
+            priv->image_cache = p_cache;
+        }
+    }
+    p_cache = priv->image_cache;
+    vlc_mutex_unlock( &priv->lock );
+    return p_cache;
+}
+
+static bool ImageCacheMakeKey( struct image_cache_key *p_key, const char *psz_url,
+                               const video_format_t *p_fmt )
+{
+    /* attachments are only unique within their input */
+    if( !strncasecmp( psz_url, "attachment://", 13 ) )
+        return false;
+
+    p_key->psz_url = psz_url;
+    p_key->i_chroma = p_fmt->i_chroma;
+    p_key->i_width = p_fmt->i_width;
+    p_key->i_height = p_fmt->i_height;
+    p_key->i_mtime = 0;
+    p_key->i_filesize = -1;
+
+    char *psz_path = vlc_uri2path( psz_url );
+    if( psz_path != NULL )
+    {
+        struct stat st;
+        int ret = vlc_stat( psz_path, &st );
+        free( psz_path );
+        if( ret )
+            return false;
+        p_key->i_mtime = st.st_mtime;
+        p_key->i_filesize = st.st_size;
+    }
+    return true;
+}
+
+static bool ImageCacheKeyEqual( const struct image_cache_key *a,
+                                const struct image_cache_key *b )
+{
+    return a->i_chroma == b->i_chroma && a->i_width == b->i_width &&
+           a->i_height == b->i_height && a->i_mtime == b->i_mtime &&
+           a->i_filesize == b->i_filesize && !strcmp( a->psz_url, b->psz_url );
+}
+
+static picture_t *ImageCacheCopy( picture_t *p_src, const video_format_t *p_fmt )
+{
+    picture_t *p_pic = picture_NewFromFormat( p_fmt );
+    if( p_pic != NULL )
+        picture_Copy( p_pic, p_src );
+    return p_pic;
+}
+
+static picture_t *ImageCacheLookup( struct vlc_image_cache *p_cache,
+                                    const struct image_cache_key *p_key,
+                                    video_format_t *p_fmt_out )
+{
+    struct image_cache_entry *p_entry, *p_found = NULL;
+    picture_t *p_pic = NULL;
+
+    vlc_mutex_lock( &p_cache->lock );
+    vlc_list_foreach( p_entry, &p_cache->entries, node )
+        if( ImageCacheKeyEqual( &p_entry->key, p_key ) )
+        {
+            p_found = p_entry;
+            break;
+        }
+    if( p_found != NULL )
+    {
+        vlc_list_remove( &p_found->node );
+        vlc_list_prepend( &p_found->node, &p_cache->entries );
+        video_format_Clean( p_fmt_out );
+        video_format_Copy( p_fmt_out, &p_found->fmt );
+        p_pic = picture_Hold( p_found->p_pic );
+    }
+    vlc_mutex_unlock( &p_cache->lock );
+
+    if( p_pic == NULL )
+        return NULL;
+
+    /* Callers may draw on the picture, never hand out the cached one */
+    picture_t *p_copy = ImageCacheCopy( p_pic, p_fmt_out );
+    picture_Release( p_pic );
+    return p_copy;
+}
+
+static void ImageCacheInsert( struct vlc_image_cache *p_cache,
+                              const struct image_cache_key *p_key,
+                              picture_t *p_pic, const video_format_t *p_fmt )
+{
+    size_t i_size = 0;
+    for( int i = 0; i < p_pic->i_planes; i++ )
+        i_size += (size_t)p_pic->p[i].i_pitch * p_pic->p[i].i_lines;
+    if( i_size > IMAGE_CACHE_MAX_SIZE / 4 )
+        return;
+
+    struct image_cache_entry *p_entry = malloc( sizeof(*p_entry) );
+    if( p_entry == NULL )
+        return;
+    p_entry->psz_url = strdup( p_key->psz_url );
+    p_entry->p_pic = ImageCacheCopy( p_pic, p_fmt );
+    if( p_entry->psz_url == NULL || p_entry->p_pic == NULL )
+    {
+        if( p_entry->p_pic != NULL )
+            picture_Release( p_entry->p_pic );
+        free( p_entry->psz_url );
+        free( p_entry );
+        return;
+    }
+    p_entry->key = *p_key;
+    p_entry->key.psz_url = p_entry->psz_url;
+    video_format_Copy( &p_entry->fmt, p_fmt );
+    p_entry->i_size = i_size;
+
+    vlc_mutex_lock( &p_cache->lock );
+    struct image_cache_entry *p_old;
+    vlc_list_foreach( p_old, &p_cache->entries, node )
+        if( ImageCacheKeyEqual( &p_old->key, p_key ) )
+        {
+            vlc_list_remove( &p_old->node );
+            p_cache->i_size -= p_old->i_size;
+            ImageCacheEntryDelete( p_old );
+            break;
+        }
+    /* Evict the least recently used images */
+    while( p_cache->i_size + i_size > IMAGE_CACHE_MAX_SIZE )
+    {
+        p_old = vlc_list_last_entry_or_null( &p_cache->entries,
+                                             struct image_cache_entry, node );
+        vlc_list_remove( &p_old->node );
+        p_cache->i_size -= p_old->i_size;
+        ImageCacheEntryDelete( p_old );
+    }
+    vlc_list_prepend( &p_entry->node, &p_cache->entries );
+    p_cache->i_size += i_size;
+    vlc_mutex_unlock( &p_cache->lock );
+}
+
 static picture_t *ImageReadUrl( image_handler_t *p_image, const char *psz_url,
                                 video_format_t *p_fmt_out )
 {
@@ -300,6 +508,18 @@ static picture_t *ImageReadUrl( image_handler_t *p_image, const char *psz_url,
     stream_t *p_stream = NULL;
     uint64_t i_size;
 
+    struct vlc_image_cache *p_cache = ImageCacheGet( p_image->p_parent );
+    struct image_cache_key key;
+    if( p_cache != NULL && !ImageCacheMakeKey( &key, psz_url, p_fmt_out ) )
+        p_cache = NULL;
+
+    if( p_cache != NULL )
+    {
+        p_pic = ImageCacheLookup( p_cache, &key, p_fmt_out );
+        if( p_pic != NULL )
+            return p_pic;
+    }
+
     p_stream = vlc_stream_NewURL( p_image->p_parent, psz_url );
 
     if( !p_stream )
@@ -340,6 +560,9 @@ static picture_t *ImageReadUrl( image_handler_t *p_image, const char *psz_url,
 
     es_format_Clean( &fmtin );
 
+    if( p_pic != NULL && p_cache != NULL )
+        ImageCacheInsert( p_cache, &key, p_pic, p_fmt_out );
+
     return p_pic;
 error:
     vlc_stream_Delete( p_stream );
@@ -513,6 +736,14 @@ static int ImageWriteUrl( image_handler_t *p_image, picture_t *p_pic,
  *
  */
 
+static bool IsSameCrop( const video_format_t *a, const video_format_t *b )
+{
+    return a->i_width == b->i_width && a->i_height == b->i_height &&
+           a->i_visible_width == b->i_visible_width &&
+           a->i_visible_height == b->i_visible_height &&
+           a->i_x_offset == b->i_x_offset && a->i_y_offset == b->i_y_offset;
+}
+
 static picture_t *ImageConvert( image_handler_t *p_image, picture_t *p_pic,
                                 const video_format_t *p_fmt_in,
                                 video_format_t *p_fmt_out )
@@ -539,9 +770,18 @@ static picture_t *ImageConvert( image_handler_t *p_image, picture_t *p_pic,
     if( !p_fmt_out->i_sar_num ) p_fmt_out->i_sar_num = p_fmt_in->i_sar_num;
     if( !p_fmt_out->i_sar_den ) p_fmt_out->i_sar_den = p_fmt_in->i_sar_den;
 
+    /* Hardware converters (e.g. scaling on the GPU before the download) are
+     * set up for their sizes and video context, unlike the software ones */
     if( p_image->p_converter &&
         ( p_image->p_converter->fmt_in.video.i_chroma != p_fmt_in->i_chroma ||
-          p_image->p_converter->fmt_out.video.i_chroma != p_fmt_out->i_chroma ) )
+          p_image->p_converter->fmt_out.video.i_chroma != p_fmt_out->i_chroma ||
+          ( p_image->p_converter->vctx_in != NULL &&
+            ( p_image->p_converter->vctx_in != picture_GetVideoContext(p_pic) ||
+              !IsSameCrop( &p_image->p_converter->fmt_in.video, p_fmt_in ) ||
+              p_image->p_converter->fmt_out.video.i_visible_width !=
+                  p_fmt_out->i_visible_width ||
+              p_image->p_converter->fmt_out.video.i_visible_height !=
+                  p_fmt_out->i_visible_height ) ) ) )
     {
         /* We need to restart a new filter */
         DeleteConverter( p_image->p_converter );
@@ -696,6 +936,9 @@ static decoder_t *CreateDecoder( image_handler_t *p_image, const es_format_t *fm
     };
     p_dec->cbs = &dec_cbs;
 
+    var_Create( p_dec, "image-target-width", VLC_VAR_INTEGER );
+    var_Create( p_dec, "image-target-height", VLC_VAR_INTEGER );
+
     /* Find a suitable decoder module */
     p_dec->p_module = module_need_var( p_dec, "video decoder", "codec" );
     if( !p_dec->p_module )
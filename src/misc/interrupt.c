@@ -54,6 +54,9 @@ void vlc_interrupt_init(vlc_interrupt_t *ctx)
     ctx->interrupted = false;
     atomic_init(&ctx->killed, false);
     ctx->callback = NULL;
+#ifndef _WIN32
+    ctx->wake_fd[0] = ctx->wake_fd[1] = -1;
+#endif
 }
 
 vlc_interrupt_t *vlc_interrupt_create(void)
@@ -71,6 +74,14 @@ vlc_interrupt_t *vlc_interrupt_create(void)
 void vlc_interrupt_deinit(vlc_interrupt_t *ctx)
 {
     assert(ctx->callback == NULL);
+#ifndef _WIN32
+    if (ctx->wake_fd[0] != -1)
+    {
+        if (ctx->wake_fd[1] != ctx->wake_fd[0])
+            vlc_close(ctx->wake_fd[1]);
+        vlc_close(ctx->wake_fd[0]);
+    }
+#endif
 }
 
 void vlc_interrupt_destroy(vlc_interrupt_t *ctx)
@@ -296,35 +307,65 @@ static void vlc_poll_i11e_wake(void *opaque)
     vlc_restorecancel(canc);
 }
 
+/**
+ * Gets the event file descriptor(s) of the interruption context, creating
+ * them on first use. They are kept until the context is deinitialized, so
+ * that an interruptible wait costs no extra system calls unless it actually
+ * gets interrupted.
+ */
+static int *vlc_poll_i11e_fd(vlc_interrupt_t *ctx)
+{
+    int *fd = ctx->wake_fd;
+
+    if (likely(fd[0] != -1))
+        return fd;
+
+    int canc = vlc_savecancel();
+# if defined (HAVE_EVENTFD) && defined (EFD_CLOEXEC) && defined (EFD_NONBLOCK)
+    fd[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd[0] != -1)
+        fd[1] = fd[0];
+    else
+# endif
+    if (vlc_pipe(fd) == 0)
+        fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+    else
+        fd[0] = fd[1] = -1;
+    vlc_restorecancel(canc);
+
+    return (fd[0] != -1) ? fd : NULL;
+}
+
+/**
+ * Consumes the pending wake-up event(s), if any. This must only be called
+ * once no callback can write anymore, i.e. after vlc_interrupt_finish().
+ */
+static void vlc_poll_i11e_drain(const int *fd)
+{
+    uint64_t dummy[8];
+    int canc = vlc_savecancel();
+
+    while (read(fd[0], dummy, sizeof (dummy)) == sizeof (dummy));
+    vlc_restorecancel(canc);
+}
+
 static void vlc_poll_i11e_cleanup(void *opaque)
 {
     vlc_interrupt_t *ctx = opaque;
-    int *fd = ctx->data;
 
-    vlc_interrupt_finish(ctx);
-    if (fd[1] != fd[0])
-        vlc_close(fd[1]);
-    vlc_close(fd[0]);
+    /* The callback may have been invoked: leave the event idle. */
+    if (vlc_interrupt_finish(ctx))
+        vlc_poll_i11e_drain(ctx->wake_fd);
 }
 
 static int vlc_poll_i11e_inner(struct pollfd *restrict fds, unsigned nfds,
                                int timeout, vlc_interrupt_t *ctx,
                                struct pollfd *restrict ufd)
 {
-    int fd[2];
+    int *fd = vlc_poll_i11e_fd(ctx);
     int ret = -1;
-    int canc;
 
-    /* TODO: cache this */
-# if defined (HAVE_EVENTFD) && defined (EFD_CLOEXEC)
-    canc = vlc_savecancel();
-    fd[0] = eventfd(0, EFD_CLOEXEC);
-    vlc_restorecancel(canc);
-    if (fd[0] != -1)
-        fd[1] = fd[0];
-    else
-# endif
-    if (vlc_pipe(fd))
+    if (unlikely(fd == NULL))
     {
         vlc_testcancel();
         errno = ENOMEM;
@@ -348,25 +389,17 @@ static int vlc_poll_i11e_inner(struct pollfd *restrict fds, unsigned nfds,
         fds[i].revents = ufd[i].revents;
 
     if (ret > 0 && ufd[nfds].revents)
-    {
-        uint64_t dummy;
-
-        read(fd[0], &dummy, sizeof (dummy));
         ret--;
-    }
     vlc_cleanup_pop();
 
+    /* The event is only ever signaled through an interruption, and it is
+     * consumed here so that it is idle for the next wait. */
     if (vlc_interrupt_finish(ctx))
     {
+        vlc_poll_i11e_drain(fd);
         errno = EINTR;
         ret = -1;
     }
-
-    canc = vlc_savecancel();
-    if (fd[1] != fd[0])
-        vlc_close(fd[1]);
-    vlc_close(fd[0]);
-    vlc_restorecancel(canc);
     return ret;
 }
 
@@ -36,5 +36,8 @@ struct vlc_interrupt
     atomic_bool killed;
     void (*callback)(void *);
     void *data;
+#ifndef _WIN32
+    int wake_fd[2]; /* cached event file descriptor(s) for vlc_poll_i11e() */
+#endif
 };
 #endif
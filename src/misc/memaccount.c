@@ -0,0 +1,105 @@
+/*****************************************************************************
+ * memaccount.c: memory accounting
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_memaccount.h>
+#include "../libvlc.h"
+
+/* Frames and pictures are allocated without any object, so the accounting
+ * is process-wide, as is the budget of the latest initialized instance. */
+static struct
+{
+    atomic_size_t used;
+    atomic_size_t peak;
+    atomic_size_t budget;
+} accounts[VLC_MEMACCOUNT_COUNT];
+
+void vlc_memaccount_Add(enum vlc_memaccount_type type, size_t size)
+{
+    assert(type < VLC_MEMACCOUNT_COUNT);
+
+    size_t used = atomic_fetch_add_explicit(&accounts[type].used, size,
+                                            memory_order_relaxed) + size;
+    size_t peak = atomic_load_explicit(&accounts[type].peak,
+                                       memory_order_relaxed);
+
+    while (used > peak
+        && !atomic_compare_exchange_weak_explicit(&accounts[type].peak, &peak,
+                                                  used, memory_order_relaxed,
+                                                  memory_order_relaxed));
+}
+
+void vlc_memaccount_Remove(enum vlc_memaccount_type type, size_t size)
+{
+    assert(type < VLC_MEMACCOUNT_COUNT);
+    atomic_fetch_sub_explicit(&accounts[type].used, size,
+                              memory_order_relaxed);
+}
+
+bool vlc_memaccount_IsOverBudget(enum vlc_memaccount_type type)
+{
+    assert(type < VLC_MEMACCOUNT_COUNT);
+
+    size_t budget = atomic_load_explicit(&accounts[type].budget,
+                                         memory_order_relaxed);
+
+    return budget != 0
+        && atomic_load_explicit(&accounts[type].used,
+                                memory_order_relaxed) > budget;
+}
+
+void vlc_memaccount_GetStats(enum vlc_memaccount_type type,
+                             struct vlc_memaccount_stats *stats)
+{
+    assert(type < VLC_MEMACCOUNT_COUNT);
+
+    stats->used = atomic_load_explicit(&accounts[type].used,
+                                       memory_order_relaxed);
+    stats->peak = atomic_load_explicit(&accounts[type].peak,
+                                       memory_order_relaxed);
+    stats->budget = atomic_load_explicit(&accounts[type].budget,
+                                         memory_order_relaxed);
+}
+
+void vlc_memaccount_Init(libvlc_int_t *libvlc)
+{
+    static const char names[VLC_MEMACCOUNT_COUNT][24] = {
+        [VLC_MEMACCOUNT_FRAME] = "frame-memory-budget",
+        [VLC_MEMACCOUNT_PICTURE] = "picture-memory-budget",
+        [VLC_MEMACCOUNT_CACHE] = "cache-memory-budget",
+    };
+
+    for (size_t i = 0; i < VLC_MEMACCOUNT_COUNT; i++)
+    {
+        /* In MiB */
+        int64_t budget = var_InheritInteger(libvlc, names[i]);
+
+        atomic_store_explicit(&accounts[i].budget,
+                              budget > 0 ? (size_t)budget << 20 : 0,
+                              memory_order_relaxed);
+    }
+}
@@ -0,0 +1,109 @@
+/*****************************************************************************
+ * mempolicy.c: placement of the large buffers
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdatomic.h>
+#include <stdint.h>
+#ifdef __linux__
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <linux/mempolicy.h>
+#endif
+
+#include <vlc_common.h>
+#include "mempolicy.h"
+
+static atomic_bool huge_pages;
+static atomic_bool numa_local;
+
+void vlc_mempolicy_Init(libvlc_int_t *libvlc)
+{
+    atomic_store_explicit(&huge_pages, var_InheritBool(libvlc, "huge-pages"),
+                          memory_order_relaxed);
+    atomic_store_explicit(&numa_local, var_InheritBool(libvlc, "numa-local"),
+                          memory_order_relaxed);
+}
+
+#ifdef __linux__
+/* Whole pages within a buffer, as the kernel only handles those */
+static size_t vlc_mempolicy_Pages(const void *base, size_t size,
+                                  uintptr_t *restrict start)
+{
+    const uintptr_t mask = sysconf(_SC_PAGESIZE) - 1;
+    uintptr_t begin = ((uintptr_t)base + mask) & ~mask;
+    uintptr_t end = ((uintptr_t)base + size) & ~mask;
+
+    *start = begin;
+    return end > begin ? end - begin : 0;
+}
+#endif
+
+void vlc_mempolicy_Advise(void *base, size_t size)
+{
+#if defined (__linux__) && defined (MADV_HUGEPAGE)
+    if (size < VLC_MEMPOLICY_MIN_SIZE
+     || !atomic_load_explicit(&huge_pages, memory_order_relaxed))
+        return;
+
+    uintptr_t start;
+    size_t length = vlc_mempolicy_Pages(base, size, &start);
+
+    /* Only the aligned 2 MiB extents will actually use huge pages */
+    if (length > 0)
+        madvise((void *)start, length, MADV_HUGEPAGE);
+#else
+    VLC_UNUSED(base); VLC_UNUSED(size);
+#endif
+}
+
+void vlc_mempolicy_MoveLocal(const void *base, size_t size)
+{
+#if defined (__linux__) && defined (SYS_mbind) && defined (SYS_get_mempolicy) \
+ && defined (SYS_getcpu)
+    if (size < VLC_MEMPOLICY_MIN_SIZE
+     || !atomic_load_explicit(&numa_local, memory_order_relaxed))
+        return;
+
+    uintptr_t start;
+    size_t length = vlc_mempolicy_Pages(base, size, &start);
+    unsigned cpu, node;
+    int page_node;
+
+    if (length == 0
+     || syscall(SYS_getcpu, &cpu, &node, NULL)
+     || syscall(SYS_get_mempolicy, &page_node, NULL, 0UL, (void *)start,
+                MPOL_F_NODE | MPOL_F_ADDR))
+        return;
+
+    /* Buffers are recycled: most of the time, they are already in place.
+     * Checking the first page is good enough as buffers move as a whole. */
+    if ((unsigned)page_node == node)
+        return;
+
+    syscall(SYS_mbind, (void *)start, length, MPOL_LOCAL, NULL, 0UL,
+            MPOL_MF_MOVE);
+#else
+    VLC_UNUSED(base); VLC_UNUSED(size);
+#endif
+}
@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * mempolicy.h: placement of the large buffers
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_MEMPOLICY_H
+#define LIBVLC_MEMPOLICY_H 1
+
+/** Buffers below this size are left alone */
+#define VLC_MEMPOLICY_MIN_SIZE (2 << 20)
+
+/**
+ * Reads the policy (--huge-pages, --numa-local) of an instance.
+ *
+ * As for the memory accounting, the policy is process-wide.
+ */
+void vlc_mempolicy_Init(libvlc_int_t *);
+
+/**
+ * Applies the policy to a newly allocated buffer.
+ *
+ * Large buffers are backed with transparent huge pages if enabled.
+ */
+void vlc_mempolicy_Advise(void *base, size_t size);
+
+/**
+ * Migrates a large buffer to the NUMA node of the calling thread.
+ *
+ * This does nothing unless enabled, or if the buffer is already local.
+ */
+void vlc_mempolicy_MoveLocal(const void *base, size_t size);
+
+#endif
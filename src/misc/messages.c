@@ -37,6 +37,7 @@
 #include <assert.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_interface.h>
 #include <vlc_charset.h>
 #include <vlc_modules.h>
@@ -417,6 +418,246 @@ static struct vlc_logger *vlc_LogModuleCreate(vlc_object_t *parent)
     return &module->frontend;
 }
 
+/**
+ * Asynchronous message log.
+ *
+ * The calling threads only format their messages into fixed-size records of
+ * a lock-free ring, and a background thread passes them to the actual log.
+ * Messages are dropped, and counted, rather than waited for when the ring is
+ * full or when an object exceeds its rate.
+ */
+#define VLC_LOG_ASYNC_RECORDS 512 /* power of 2 */
+#define VLC_LOG_ASYNC_BUCKETS 64
+
+struct vlc_log_record {
+    atomic_size_t seq;
+    int type;
+    vlc_log_t meta;
+    char *long_msg; /* if the message does not fit in msg */
+    char module[32];
+    char header[64];
+    char msg[384];
+};
+
+struct vlc_logger_async {
+    struct vlc_logger logger;
+    struct vlc_logger *backend;
+    vlc_thread_t thread;
+    atomic_size_t tail; /* next record to fill */
+    size_t head; /* next record to output, thread only */
+    atomic_uint sleeping;
+    atomic_bool stop;
+    atomic_size_t dropped;
+    unsigned rate; /* per object per second, 0 if unlimited */
+    struct {
+        atomic_uint period;
+        atomic_uint count;
+    } buckets[VLC_LOG_ASYNC_BUCKETS]; /* objects are hashed, not tracked */
+    struct vlc_log_record records[VLC_LOG_ASYNC_RECORDS];
+};
+
+static bool vlc_LogAsyncOverRate(struct vlc_logger_async *async, int type,
+                                 uintptr_t id)
+{
+    if (async->rate == 0 || type == VLC_MSG_ERR)
+        return false;
+
+    unsigned period = SEC_FROM_VLC_TICK(vlc_tick_now());
+    size_t index = ((id >> 4) ^ (id >> 12)) % VLC_LOG_ASYNC_BUCKETS;
+    __typeof__ (async->buckets[0]) *bucket = &async->buckets[index];
+
+    /* Racy reset: the limit is approximate */
+    if (atomic_load_explicit(&bucket->period, memory_order_relaxed) != period)
+    {
+        atomic_store_explicit(&bucket->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&bucket->period, period, memory_order_relaxed);
+    }
+    return atomic_fetch_add_explicit(&bucket->count, 1,
+                                     memory_order_relaxed) >= async->rate;
+}
+
+static void vlc_vaLogAsync(void *d, int type, const vlc_log_t *item,
+                           const char *format, va_list ap)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, logger);
+
+    if (vlc_LogAsyncOverRate(async, type, item->i_object_id))
+    {
+        atomic_fetch_add_explicit(&async->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    /* Reserve a free record */
+    struct vlc_log_record *rec;
+    size_t pos = atomic_load_explicit(&async->tail, memory_order_relaxed);
+    for (;;)
+    {
+        rec = &async->records[pos % VLC_LOG_ASYNC_RECORDS];
+
+        size_t seq = atomic_load_explicit(&rec->seq, memory_order_acquire);
+        if (seq == pos)
+        {
+            if (atomic_compare_exchange_weak_explicit(&async->tail, &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        }
+        else if ((ptrdiff_t)(seq - pos) < 0)
+        {   /* full */
+            atomic_fetch_add_explicit(&async->dropped, 1,
+                                      memory_order_relaxed);
+            return;
+        }
+        else
+            pos = atomic_load_explicit(&async->tail, memory_order_relaxed);
+    }
+
+    rec->type = type;
+    rec->meta = *item;
+    strlcpy(rec->module, item->psz_module, sizeof (rec->module));
+    rec->meta.psz_module = rec->module;
+    if (item->psz_header != NULL)
+    {
+        strlcpy(rec->header, item->psz_header, sizeof (rec->header));
+        rec->meta.psz_header = rec->header;
+    }
+
+    va_list aq;
+    va_copy(aq, ap);
+    int len = vsnprintf(rec->msg, sizeof (rec->msg), format, ap);
+    rec->long_msg = NULL;
+    if ((size_t)len >= sizeof (rec->msg) && vasprintf(&rec->long_msg,
+                                                       format, aq) == -1)
+        rec->long_msg = NULL;
+    va_end(aq);
+
+    /* Publish, then wake the thread up if it waits */
+    atomic_store(&rec->seq, pos + 1);
+    if (atomic_load(&async->sleeping) != 0
+     && atomic_exchange(&async->sleeping, 0) != 0)
+        vlc_atomic_notify_one(&async->sleeping);
+}
+
+static void vlc_LogAsyncOutput(struct vlc_logger *backend, int type,
+                               const vlc_log_t *item, const char *format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    backend->ops->log(backend, type, item, format, ap);
+    va_end(ap);
+}
+
+static void *vlc_LogAsyncThread(void *data)
+{
+    struct vlc_logger_async *async = data;
+    struct vlc_logger *backend = async->backend;
+
+    vlc_thread_set_name("vlc-log");
+
+    for (;;)
+    {
+        struct vlc_log_record *rec =
+            &async->records[async->head % VLC_LOG_ASYNC_RECORDS];
+
+        if (atomic_load(&rec->seq) == async->head + 1)
+        {
+            vlc_LogAsyncOutput(backend, rec->type, &rec->meta, "%s",
+                               rec->long_msg != NULL ? rec->long_msg
+                                                     : rec->msg);
+            free(rec->long_msg);
+            atomic_store_explicit(&rec->seq,
+                                  async->head + VLC_LOG_ASYNC_RECORDS,
+                                  memory_order_release);
+            async->head++;
+            continue;
+        }
+
+        size_t dropped = atomic_exchange_explicit(&async->dropped, 0,
+                                                  memory_order_relaxed);
+        if (dropped > 0)
+        {
+            const vlc_log_t meta = {
+                .psz_object_type = "logger",
+                .psz_module = "main",
+                .file = __FILE__,
+                .line = __LINE__,
+                .func = __func__,
+                .tid = vlc_thread_id(),
+            };
+
+            vlc_LogAsyncOutput(backend, VLC_MSG_WARN, &meta,
+                               "%zu messages dropped", dropped);
+        }
+
+        if (atomic_load(&async->stop))
+            break;
+
+        /* Sleep until a record is published */
+        atomic_store(&async->sleeping, 1);
+        if (atomic_load(&rec->seq) != async->head + 1
+         && !atomic_load(&async->stop))
+            vlc_atomic_wait(&async->sleeping, 1);
+        atomic_store(&async->sleeping, 0);
+    }
+    return NULL;
+}
+
+static void vlc_LogAsyncClose(void *d)
+{
+    struct vlc_logger *logger = d;
+    struct vlc_logger_async *async =
+        container_of(logger, struct vlc_logger_async, logger);
+
+    /* The thread outputs the remaining records first */
+    atomic_store(&async->stop, true);
+    atomic_store(&async->sleeping, 0);
+    vlc_atomic_notify_one(&async->sleeping);
+    vlc_join(async->thread, NULL);
+
+    async->backend->ops->destroy(async->backend);
+    free(async);
+}
+
+static const struct vlc_logger_operations async_ops = {
+    vlc_vaLogAsync,
+    vlc_LogAsyncClose,
+};
+
+static struct vlc_logger *vlc_LogAsyncCreate(struct vlc_logger *backend,
+                                             unsigned rate)
+{
+    struct vlc_logger_async *async = malloc(sizeof (*async));
+    if (unlikely(async == NULL))
+        return NULL;
+
+    async->logger.ops = &async_ops;
+    async->backend = backend;
+    atomic_init(&async->tail, 0);
+    async->head = 0;
+    atomic_init(&async->sleeping, 0);
+    atomic_init(&async->stop, false);
+    atomic_init(&async->dropped, 0);
+    async->rate = rate;
+    for (size_t i = 0; i < VLC_LOG_ASYNC_BUCKETS; i++)
+    {
+        atomic_init(&async->buckets[i].period, 0);
+        atomic_init(&async->buckets[i].count, 0);
+    }
+    for (size_t i = 0; i < VLC_LOG_ASYNC_RECORDS; i++)
+        atomic_init(&async->records[i].seq, i);
+
+    if (vlc_clone(&async->thread, vlc_LogAsyncThread, async))
+    {
+        free(async);
+        return NULL;
+    }
+    return &async->logger;
+}
+
 /**
  * Initializes the messages logging subsystem and drain the early messages to
  * the configured log.
@@ -426,6 +667,18 @@ void vlc_LogInit(libvlc_int_t *vlc)
     struct vlc_logger *logger = vlc_LogModuleCreate(VLC_OBJECT(vlc));
     if (logger == NULL)
         logger = &discard_log;
+    /* Formatting and output only slow the other threads down noticeably
+     * with the debug messages */
+    else if (var_InheritBool(vlc, "log-async")
+          && var_InheritInteger(vlc, "verbose") >= VLC_MSG_DBG - VLC_MSG_ERR)
+    {
+        int64_t rate = var_InheritInteger(vlc, "log-rate-limit");
+        struct vlc_logger *async =
+            vlc_LogAsyncCreate(logger, rate > 0 ? rate : 0);
+
+        if (async != NULL)
+            logger = async;
+    }
 
     vlc_LogSwitch(vlc->obj.logger, logger);
 }
@@ -37,8 +37,10 @@
 #include "picture.h"
 #include <vlc_image.h>
 #include <vlc_block.h>
+#include <vlc_memaccount.h>
 
 #include "ancillary.h"
+#include "mempolicy.h"
 
 static void PictureDestroyContext( picture_t *p_picture )
 {
@@ -62,6 +64,139 @@ static void picture_DestroyDummy( picture_t *p_picture )
     (void) p_picture;
 }
 
+/*
+ * Recently freed picture buffers, kept for the pictures of the same size
+ * allocated next, e.g. when a decoder or video output is recreated.
+ * They remain accounted as picture memory.
+ */
+#define RECYCLED_MAX 32
+#define RECYCLED_BYTES_MAX (256 << 20)
+#define RECYCLED_DELAY VLC_TICK_FROM_SEC(5)
+
+struct recycled_buffer
+{
+    void *base;
+    size_t size;
+    int fd;
+    vlc_tick_t date;
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    size_t count;
+    size_t bytes;
+    struct recycled_buffer buffers[RECYCLED_MAX];
+} recycler = { .lock = VLC_STATIC_MUTEX };
+
+/* Removes a buffer from the recycler, lock held */
+static struct recycled_buffer RecyclerTake(size_t index)
+{
+    struct recycled_buffer buf = recycler.buffers[index];
+
+    recycler.buffers[index] = recycler.buffers[--recycler.count];
+    recycler.bytes -= buf.size;
+    return buf;
+}
+
+/* Removes the buffers unused for too long, lock held */
+static size_t RecyclerExpire(vlc_tick_t now, struct recycled_buffer *expired)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < recycler.count;)
+        if (now - recycler.buffers[i].date >= RECYCLED_DELAY)
+            expired[n++] = RecyclerTake(i);
+        else
+            i++;
+    return n;
+}
+
+static void RecyclerFree(const struct recycled_buffer *bufs, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        vlc_memaccount_Remove(VLC_MEMACCOUNT_PICTURE, bufs[i].size);
+        picture_Deallocate(bufs[i].fd, bufs[i].base, bufs[i].size);
+    }
+}
+
+static void *picture_AllocateRecycled(int *restrict fdp, size_t size)
+{
+    struct recycled_buffer expired[RECYCLED_MAX];
+    void *base = NULL;
+    size_t n;
+
+    vlc_mutex_lock(&recycler.lock);
+    n = RecyclerExpire(vlc_tick_now(), expired);
+    for (size_t i = 0; i < recycler.count; i++)
+        if (recycler.buffers[i].size == size)
+        {
+            struct recycled_buffer buf = RecyclerTake(i);
+
+            *fdp = buf.fd;
+            base = buf.base;
+            break;
+        }
+    vlc_mutex_unlock(&recycler.lock);
+    RecyclerFree(expired, n);
+
+    if (base == NULL)
+    {
+        base = picture_Allocate(fdp, size);
+        if (base != NULL)
+        {
+            vlc_memaccount_Add(VLC_MEMACCOUNT_PICTURE, size);
+            vlc_mempolicy_Advise(base, size);
+        }
+    }
+    return base;
+}
+
+static void picture_DeallocateRecycled(int fd, void *base, size_t size)
+{
+    struct recycled_buffer evicted[RECYCLED_MAX + 1];
+    size_t n;
+
+    evicted[0] = (struct recycled_buffer){ base, size, fd, vlc_tick_now() };
+    if (size > RECYCLED_BYTES_MAX / 4
+     || vlc_memaccount_IsOverBudget(VLC_MEMACCOUNT_PICTURE))
+    {
+        RecyclerFree(evicted, 1);
+        return;
+    }
+
+    vlc_mutex_lock(&recycler.lock);
+    n = RecyclerExpire(evicted[0].date, evicted + 1);
+    /* Evict the oldest buffers to make room */
+    while (recycler.count == RECYCLED_MAX
+        || recycler.bytes + size > RECYCLED_BYTES_MAX)
+    {
+        size_t oldest = 0;
+
+        for (size_t i = 1; i < recycler.count; i++)
+            if (recycler.buffers[i].date < recycler.buffers[oldest].date)
+                oldest = i;
+        evicted[++n] = RecyclerTake(oldest);
+    }
+    recycler.buffers[recycler.count++] = evicted[0];
+    recycler.bytes += size;
+    vlc_mutex_unlock(&recycler.lock);
+    RecyclerFree(evicted + 1, n);
+}
+
+void picture_FlushRecycled(void)
+{
+    struct recycled_buffer bufs[RECYCLED_MAX];
+    size_t n = 0;
+
+    vlc_mutex_lock(&recycler.lock);
+    while (recycler.count > 0)
+        bufs[n++] = RecyclerTake(0);
+    vlc_mutex_unlock(&recycler.lock);
+    RecyclerFree(bufs, n);
+}
+
 /**
  * Destroys a picture allocated with picture_NewFromFormat().
  */
@@ -70,7 +205,7 @@ static void picture_DestroyFromFormat(picture_t *pic)
     picture_buffer_t *res = pic->p_sys;
 
     if (res != NULL)
-        picture_Deallocate(res->fd, res->base, res->size);
+        picture_DeallocateRecycled(res->fd, res->base, res->size);
 }
 
 VLC_WEAK void *picture_Allocate(int *restrict fdp, size_t size)
@@ -306,7 +441,7 @@ picture_t *picture_NewFromFormat(const video_format_t *restrict fmt)
     if (unlikely(pic_size >= PICTURE_SW_SIZE_MAX))
         goto error;
 
-    unsigned char *buf = picture_Allocate(&res->fd, pic_size);
+    unsigned char *buf = picture_AllocateRecycled(&res->fd, pic_size);
     if (unlikely(buf == NULL))
         goto error;
 
@@ -426,6 +561,18 @@ void picture_Copy( picture_t *p_dst, const picture_t *p_src )
     picture_CopyProperties( p_dst, p_src );
 }
 
+void picture_MoveLocal(picture_t *picture)
+{
+    for (int i = 0; i < picture->i_planes; i++)
+    {
+        const plane_t *p = &picture->p[i];
+
+        if (p->p_pixels != NULL)
+            vlc_mempolicy_MoveLocal(p->p_pixels,
+                                    (size_t)p->i_lines * p->i_pitch);
+    }
+}
+
 static void picture_DestroyClone(picture_t *clone)
 {
     picture_t *picture = ((picture_priv_t *)clone)->gc.opaque;
@@ -41,4 +41,9 @@ typedef struct
 void *picture_Allocate(int *, size_t);
 void picture_Deallocate(int, void *, size_t);
 
+/**
+ * Frees the buffers kept for the next pictures of the same size.
+ */
+void picture_FlushRecycled(void);
+
 picture_t * picture_InternalClone(picture_t *, void (*pf_destroy)(picture_t *), void *);
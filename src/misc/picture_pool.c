@@ -45,8 +45,12 @@ struct picture_pool_t {
 
     unsigned long long available;
     vlc_atomic_rc_t    refs;
-    unsigned short     picture_count;
-    picture_t  *picture[];
+    unsigned short     picture_count; /* slots in service */
+    unsigned short     capacity; /* slots */
+    bool               released;
+    bool               resizable;
+    video_format_t     fmt; /* if resizable */
+    picture_t  *picture[]; /* NULL if the slot holds no picture */
 };
 
 static void picture_pool_Destroy(picture_pool_t *pool)
@@ -54,13 +58,21 @@ static void picture_pool_Destroy(picture_pool_t *pool)
     if (!vlc_atomic_rc_dec(&pool->refs))
         return;
 
+    if (pool->resizable)
+        video_format_Clean(&pool->fmt);
     aligned_free(pool);
 }
 
 void picture_pool_Release(picture_pool_t *pool)
 {
-    for (unsigned i = 0; i < pool->picture_count; i++)
-        picture_Release(pool->picture[i]);
+    /* The slots beyond the pool size, if any, no longer change */
+    vlc_mutex_lock(&pool->lock);
+    pool->released = true;
+    vlc_mutex_unlock(&pool->lock);
+
+    for (unsigned i = 0; i < pool->capacity; i++)
+        if (pool->picture[i] != NULL)
+            picture_Release(pool->picture[i]);
     picture_pool_Destroy(pool);
 }
 
@@ -71,15 +83,27 @@ static void picture_pool_ReleaseClone(picture_t *clone)
     picture_pool_t *pool = (void *)(sys & ~(POOL_MAX - 1));
     unsigned offset = sys & (POOL_MAX - 1);
     picture_t *picture = pool->picture[offset];
-
-    picture_Release(picture);
+    bool retired;
 
     vlc_mutex_lock(&pool->lock);
     assert(!(pool->available & (1ULL << offset)));
-    pool->available |= 1ULL << offset;
-    vlc_cond_signal(&pool->wait);
+    retired = offset >= pool->picture_count;
+    if (!retired)
+    {
+        pool->available |= 1ULL << offset;
+        vlc_cond_signal(&pool->wait);
+    }
+    else if (!pool->released)
+        /* The pool shrank while the picture was in use */
+        pool->picture[offset] = NULL;
+    else
+        retired = false;
     vlc_mutex_unlock(&pool->lock);
 
+    picture_Release(picture);
+    if (retired)
+        picture_Release(picture);
+
     picture_pool_Destroy(pool);
 }
 
@@ -98,13 +122,11 @@ static picture_t *picture_pool_ClonePicture(picture_pool_t *pool,
     return clone;
 }
 
-picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
+static picture_pool_t *picture_pool_Alloc(unsigned count, unsigned capacity,
+                                          picture_t *const *tab)
 {
-    if (unlikely(count > POOL_MAX))
-        return NULL;
-
     picture_pool_t *pool;
-    size_t size = sizeof (*pool) + count * sizeof (picture_t *);
+    size_t size = sizeof (*pool) + capacity * sizeof (picture_t *);
 
     size += (-size) & (POOL_MAX - 1);
     pool = aligned_alloc(POOL_MAX, size);
@@ -119,10 +141,23 @@ picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
         pool->available = (1ULL << count) - 1;
     vlc_atomic_rc_init(&pool->refs);
     pool->picture_count = count;
+    pool->capacity = capacity;
+    pool->released = false;
+    pool->resizable = false;
     memcpy(pool->picture, tab, count * sizeof (picture_t *));
+    for (unsigned i = count; i < capacity; i++)
+        pool->picture[i] = NULL;
     return pool;
 }
 
+picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
+{
+    if (unlikely(count > POOL_MAX))
+        return NULL;
+
+    return picture_pool_Alloc(count, count, tab);
+}
+
 picture_pool_t *picture_pool_NewFromFormat(const video_format_t *fmt,
                                            unsigned count)
 {
@@ -140,10 +175,12 @@ picture_pool_t *picture_pool_NewFromFormat(const video_format_t *fmt,
             goto error;
     }
 
-    picture_pool_t *pool = picture_pool_New(count, picture);
+    /* Pools of allocated pictures can be resized */
+    picture_pool_t *pool = picture_pool_Alloc(count, POOL_MAX, picture);
     if (!pool)
         goto error;
 
+    pool->resizable = video_format_Copy(&pool->fmt, fmt) == VLC_SUCCESS;
     return pool;
 
 error:
@@ -152,6 +189,74 @@ error:
     return NULL;
 }
 
+/* Takes the slots from count out of service, pool lock held */
+static unsigned picture_pool_Shrink(picture_pool_t *pool, unsigned count,
+                                    picture_t **unused)
+{
+    unsigned n = 0;
+
+    /* The pictures in use are released when they are returned */
+    for (unsigned i = count; i < pool->picture_count; i++)
+        if (pool->available & (1ULL << i))
+        {
+            pool->available &= ~(1ULL << i);
+            unused[n++] = pool->picture[i];
+            pool->picture[i] = NULL;
+        }
+    pool->picture_count = count;
+    return n;
+}
+
+int picture_pool_Resize(picture_pool_t *pool, unsigned count)
+{
+    picture_t *unused[POOL_MAX];
+    unsigned long long empty = 0;
+    unsigned n = 0, old;
+
+    if (!pool->resizable || count == 0 || count > pool->capacity)
+        return VLC_EGENERIC;
+
+    vlc_mutex_lock(&pool->lock);
+    old = pool->picture_count;
+    if (count < old)
+        n = picture_pool_Shrink(pool, count, unused);
+    else
+    {
+        /* The retired pictures still in use return to service as is */
+        for (unsigned i = old; i < count; i++)
+            if (pool->picture[i] == NULL)
+                empty |= 1ULL << i;
+        pool->picture_count = count;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    while (n > 0)
+        picture_Release(unused[--n]);
+
+    for (unsigned i = old; i < count; i++)
+    {
+        if (!(empty & (1ULL << i)))
+            continue;
+
+        picture_t *picture = picture_NewFromFormat(&pool->fmt);
+
+        vlc_mutex_lock(&pool->lock);
+        if (unlikely(picture == NULL))
+        {
+            n = picture_pool_Shrink(pool, i, unused);
+            vlc_mutex_unlock(&pool->lock);
+            while (n > 0)
+                picture_Release(unused[--n]);
+            return VLC_ENOMEM;
+        }
+        pool->picture[i] = picture;
+        pool->available |= 1ULL << i;
+        vlc_cond_signal(&pool->wait);
+        vlc_mutex_unlock(&pool->lock);
+    }
+    return VLC_SUCCESS;
+}
+
 picture_pool_t *picture_pool_Reserve(picture_pool_t *master, unsigned count)
 {
     if (count == 0)
@@ -216,5 +321,11 @@ picture_t *picture_pool_Wait(picture_pool_t *pool)
 
 unsigned picture_pool_GetSize(const picture_pool_t *pool)
 {
-    return pool->picture_count;
+    picture_pool_t *p = (picture_pool_t *)pool;
+    unsigned count;
+
+    vlc_mutex_lock(&p->lock);
+    count = p->picture_count;
+    vlc_mutex_unlock(&p->lock);
+    return count;
 }
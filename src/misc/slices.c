@@ -0,0 +1,165 @@
+/*****************************************************************************
+ * misc/slices.c: slice threading of picture processing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include <vlc_executor.h>
+#include <vlc_picture.h>
+#include <vlc_slices.h>
+
+/* Slices smaller than this are not worth a thread */
+#define SLICES_MIN_LINES 64
+/* Automatic threading is only used from this picture area */
+#define SLICES_MIN_AREA  (1280 * 720)
+
+struct vlc_slice_task
+{
+    struct vlc_runnable runnable;
+    vlc_slices_t *owner;
+    unsigned slice;
+};
+
+struct vlc_slices
+{
+    vlc_executor_t *executor;
+    unsigned count;
+
+    /* Current job */
+    vlc_slice_cb cb;
+    void *opaque;
+
+    struct vlc_slice_task tasks[];
+};
+
+static void RunSlice(void *userdata)
+{
+    struct vlc_slice_task *task = userdata;
+    vlc_slices_t *slices = task->owner;
+
+    slices->cb(slices->opaque, task->slice, slices->count);
+}
+
+#undef vlc_slices_New
+vlc_slices_t *vlc_slices_New(vlc_object_t *obj, unsigned threads,
+                             unsigned width, unsigned height)
+{
+    unsigned count = threads;
+
+    if (count == 0)
+    {
+        if ((uint64_t)width * height >= SLICES_MIN_AREA)
+            count = vlc_GetCPUCount();
+        else
+            count = 1;
+    }
+    count = VLC_CLIP(count, 1, VLC_SLICES_MAX);
+    count = __MIN(count, __MAX(height / SLICES_MIN_LINES, 1));
+
+    vlc_slices_t *slices = malloc(sizeof (*slices)
+                                  + sizeof (slices->tasks[0]) * count);
+    if (unlikely(slices == NULL))
+        return NULL;
+
+    slices->executor = NULL;
+    slices->count = count;
+
+    if (count > 1)
+    {
+        slices->executor = vlc_executor_New(count - 1);
+        if (slices->executor == NULL)
+            slices->count = 1;
+    }
+
+    for (unsigned i = 0; i < slices->count; i++)
+    {
+        struct vlc_slice_task *task = &slices->tasks[i];
+        task->runnable.run = RunSlice;
+        task->runnable.userdata = task;
+        task->owner = slices;
+        task->slice = i;
+    }
+
+    if (slices->count > 1)
+        msg_Dbg(obj, "processing in %u slices", slices->count);
+    return slices;
+}
+
+void vlc_slices_Delete(vlc_slices_t *slices)
+{
+    if (slices->executor != NULL)
+        vlc_executor_Delete(slices->executor);
+    free(slices);
+}
+
+unsigned vlc_slices_Count(const vlc_slices_t *slices)
+{
+    return slices->count;
+}
+
+void vlc_slices_Run(vlc_slices_t *slices, vlc_slice_cb cb, void *opaque)
+{
+    if (slices->count == 1)
+    {
+        cb(opaque, 0, 1);
+        return;
+    }
+
+    slices->cb = cb;
+    slices->opaque = opaque;
+
+    for (unsigned i = 1; i < slices->count; i++)
+        vlc_executor_Submit(slices->executor, &slices->tasks[i].runnable);
+    RunSlice(&slices->tasks[0]);
+    vlc_executor_WaitIdle(slices->executor);
+}
+
+void vlc_slices_GetView(picture_t *view, const picture_t *pic,
+                        unsigned start, unsigned end)
+{
+    const vlc_chroma_description_t *dsc =
+        vlc_fourcc_GetChromaDescription(pic->format.i_chroma);
+    const bool last = end >= (unsigned)pic->p[0].i_visible_lines;
+
+    *view = *pic;
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        unsigned num = 1, den = 1;
+        if (dsc != NULL && (unsigned)i < dsc->plane_count)
+        {
+            num = dsc->p[i].h.num;
+            den = dsc->p[i].h.den;
+        }
+
+        const plane_t *plane = &pic->p[i];
+        const int first = start * num / den;
+        int lines = plane->i_visible_lines - first;
+        if (!last)
+            lines = __MIN(lines, (int)(end * num / den) - first);
+        lines = __MAX(lines, 0);
+
+        view->p[i].p_pixels += (ptrdiff_t)first * plane->i_pitch;
+        view->p[i].i_lines = lines;
+        view->p[i].i_visible_lines = lines;
+    }
+}
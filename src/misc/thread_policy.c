@@ -0,0 +1,500 @@
+/*****************************************************************************
+ * thread_policy.c: placement and priority of the threads
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <sched.h>
+#endif
+#ifdef __linux__
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/resource.h>
+#endif
+#ifdef __APPLE__
+# include <pthread/qos.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_fs.h>
+#include "thread_policy.h"
+
+/** Number of CPUs an affinity can refer to */
+#define VLC_THREAD_POLICY_CPUS 1024
+/** Real-time priority of the SCHED_RR threads, from the minimum */
+#define VLC_THREAD_POLICY_RT_PRIORITY 4
+
+enum vlc_thread_class
+{
+    VLC_THREAD_CLASS_DEFAULT,
+    VLC_THREAD_CLASS_BACKGROUND,
+    VLC_THREAD_CLASS_HIGH,
+    VLC_THREAD_CLASS_REALTIME,
+};
+
+static const char *const class_names[] = {
+    [VLC_THREAD_CLASS_DEFAULT] = "default",
+    [VLC_THREAD_CLASS_BACKGROUND] = "background",
+    [VLC_THREAD_CLASS_HIGH] = "high",
+    [VLC_THREAD_CLASS_REALTIME] = "realtime",
+};
+
+static const char *const role_names[] = {
+    [VLC_THREAD_ROLE_INPUT] = "input",
+    [VLC_THREAD_ROLE_DECODER] = "decoder",
+    [VLC_THREAD_ROLE_AUDIO] = "aout",
+    [VLC_THREAD_ROLE_VIDEO] = "vout",
+    [VLC_THREAD_ROLE_SOUT] = "sout",
+    [VLC_THREAD_ROLE_PREFETCH] = "prefetch",
+    [VLC_THREAD_ROLE_BACKGROUND] = "background",
+};
+
+#define VLC_THREAD_ROLE_COUNT ARRAY_SIZE(role_names)
+
+/* Thread name prefixes of the roles. The audio is played from the audio
+ * decoder thread, so that it belongs with the audio outputs. */
+static const struct
+{
+    const char *prefix;
+    enum vlc_thread_role role;
+} role_prefixes[] = {
+    { "vlc-input",       VLC_THREAD_ROLE_INPUT },
+    { "vlc-dec-audio",   VLC_THREAD_ROLE_AUDIO },
+    { "vlc-dec",         VLC_THREAD_ROLE_DECODER },
+    { "vlc-mmdevice",    VLC_THREAD_ROLE_AUDIO },
+    { "vlc-audiotrack",  VLC_THREAD_ROLE_AUDIO },
+    { "vlc-winstore",    VLC_THREAD_ROLE_AUDIO },
+    { "vlc-vout",        VLC_THREAD_ROLE_VIDEO },
+    { "vlc-spu-prerend", VLC_THREAD_ROLE_VIDEO },
+    { "vlc-encoder",     VLC_THREAD_ROLE_SOUT },
+    { "vlc-tc-filters",  VLC_THREAD_ROLE_SOUT },
+    { "vlc-rt-send",     VLC_THREAD_ROLE_SOUT },
+    { "vlc-SDI",         VLC_THREAD_ROLE_SOUT },
+    { "vlc-DBMSDI",      VLC_THREAD_ROLE_SOUT },
+    { "vlc-prefetch",    VLC_THREAD_ROLE_PREFETCH },
+    { "vlc-axs-cache",   VLC_THREAD_ROLE_PREFETCH },
+    { "vlc-timeshift",   VLC_THREAD_ROLE_PREFETCH },
+    { "vlc-http-range",  VLC_THREAD_ROLE_PREFETCH },
+    { "vlc-adapt-dl",    VLC_THREAD_ROLE_PREFETCH },
+    { "vlc-preparse",    VLC_THREAD_ROLE_BACKGROUND },
+    { "vlc-run-",        VLC_THREAD_ROLE_BACKGROUND },
+    { "vlc-acoustid",    VLC_THREAD_ROLE_BACKGROUND },
+    { "vlc-addon-",      VLC_THREAD_ROLE_BACKGROUND },
+};
+
+struct vlc_thread_policy
+{
+    vlc_atomic_rc_t rc;
+    struct vlc_logger *logger;
+    unsigned id;
+    atomic_bool warned;
+
+    uint8_t classes[VLC_THREAD_ROLE_COUNT];
+    bool has_cpus;
+    uint64_t cpus[VLC_THREAD_POLICY_CPUS / 64];
+    char *cgroup;
+};
+
+static vlc_mutex_t default_lock = VLC_STATIC_MUTEX;
+static struct vlc_thread_policy *default_policy;
+static libvlc_int_t *default_owner;
+static atomic_uint policy_ids = 1;
+
+static thread_local struct vlc_thread_policy *current;
+static thread_local enum vlc_thread_role current_role;
+/* What was applied to the calling thread */
+static thread_local unsigned applied_id;
+static thread_local uint8_t applied_class;
+
+/* Parses a CPU list, such as "0-3,8" */
+static int ParseCPUs(struct vlc_thread_policy *policy, const char *str)
+{
+    while (*str != '\0')
+    {
+        char *end;
+        unsigned long first = strtoul(str, &end, 10), last = first;
+
+        if (end == str)
+            return VLC_EGENERIC;
+        if (*end == '-')
+        {
+            str = end + 1;
+            last = strtoul(str, &end, 10);
+            if (end == str)
+                return VLC_EGENERIC;
+        }
+        if (first > last || last >= VLC_THREAD_POLICY_CPUS)
+            return VLC_EGENERIC;
+
+        for (unsigned long i = first; i <= last; i++)
+            policy->cpus[i / 64] |= UINT64_C(1) << (i % 64);
+
+        if (*end == ',')
+            end++;
+        else if (*end != '\0')
+            return VLC_EGENERIC;
+        str = end;
+    }
+    policy->has_cpus = true;
+    return VLC_SUCCESS;
+}
+
+/* Parses the classes of the roles, such as "vout=realtime,aout=realtime" */
+static void ParseClasses(vlc_object_t *obj, struct vlc_thread_policy *policy,
+                         char *str)
+{
+    char *saveptr;
+
+    for (char *tok = strtok_r(str, ",", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, ",", &saveptr))
+    {
+        char *value = strchr(tok, '=');
+        size_t role, cls;
+
+        if (value != NULL)
+            *(value++) = '\0';
+
+        for (role = 1; role < VLC_THREAD_ROLE_COUNT; role++)
+            if (!strcmp(tok, role_names[role]))
+                break;
+        for (cls = 0; value != NULL && cls < ARRAY_SIZE(class_names); cls++)
+            if (!strcmp(value, class_names[cls]))
+                break;
+
+        if (role == VLC_THREAD_ROLE_COUNT || value == NULL
+         || cls == ARRAY_SIZE(class_names))
+        {
+            msg_Warn(obj, "invalid thread priority \"%s\"", tok);
+            continue;
+        }
+        policy->classes[role] = cls;
+    }
+}
+
+/* An empty string, as set to clear an option, is no setting */
+static char *InheritString(vlc_object_t *obj, const char *name)
+{
+    char *str = var_InheritString(obj, name);
+
+    if (str != NULL && *str == '\0')
+    {
+        free(str);
+        str = NULL;
+    }
+    return str;
+}
+
+struct vlc_thread_policy *vlc_thread_policy_New(vlc_object_t *obj)
+{
+    char *cpus = InheritString(obj, "thread-affinity");
+    char *classes = InheritString(obj, "thread-priorities");
+    char *cgroup = InheritString(obj, "thread-cgroup");
+
+    if (cpus == NULL && classes == NULL && cgroup == NULL)
+        return NULL;
+
+    struct vlc_thread_policy *policy = calloc(1, sizeof (*policy));
+    if (unlikely(policy == NULL))
+    {
+        free(cpus);
+        free(classes);
+        free(cgroup);
+        return NULL;
+    }
+
+    vlc_atomic_rc_init(&policy->rc);
+    /* The threads may outlive the object, not the instance */
+    policy->logger = vlc_object_logger(VLC_OBJECT(vlc_object_instance(obj)));
+    policy->id = atomic_fetch_add_explicit(&policy_ids, 1,
+                                           memory_order_relaxed);
+    atomic_init(&policy->warned, false);
+
+    if (cpus != NULL && ParseCPUs(policy, cpus))
+    {
+        msg_Warn(obj, "invalid thread affinity \"%s\"", cpus);
+        memset(policy->cpus, 0, sizeof (policy->cpus));
+        policy->has_cpus = false;
+    }
+    if (classes != NULL)
+        ParseClasses(obj, policy, classes);
+    policy->cgroup = cgroup;
+
+    free(cpus);
+    free(classes);
+    return policy;
+}
+
+struct vlc_thread_policy *vlc_thread_policy_Hold(struct vlc_thread_policy *policy)
+{
+    vlc_atomic_rc_inc(&policy->rc);
+    return policy;
+}
+
+void vlc_thread_policy_Release(struct vlc_thread_policy *policy)
+{
+    if (!vlc_atomic_rc_dec(&policy->rc))
+        return;
+
+    free(policy->cgroup);
+    free(policy);
+}
+
+void vlc_thread_policy_Init(libvlc_int_t *libvlc)
+{
+    struct vlc_thread_policy *policy = vlc_thread_policy_New(VLC_OBJECT(libvlc));
+
+    if (policy == NULL)
+        return;
+
+    vlc_mutex_lock(&default_lock);
+    if (default_policy == NULL)
+    {
+        default_policy = policy;
+        default_owner = libvlc;
+        policy = NULL;
+    }
+    vlc_mutex_unlock(&default_lock);
+
+    if (policy != NULL)
+        vlc_thread_policy_Release(policy);
+}
+
+void vlc_thread_policy_Deinit(libvlc_int_t *libvlc)
+{
+    struct vlc_thread_policy *policy = NULL;
+
+    vlc_mutex_lock(&default_lock);
+    if (default_owner == libvlc)
+    {
+        policy = default_policy;
+        default_policy = NULL;
+        default_owner = NULL;
+    }
+    vlc_mutex_unlock(&default_lock);
+
+    if (policy != NULL)
+        vlc_thread_policy_Release(policy);
+}
+
+static void Warn(struct vlc_thread_policy *policy, const char *what, int err)
+{
+    /* The same failure would be reported by every thread */
+    if (!atomic_exchange_explicit(&policy->warned, true, memory_order_relaxed))
+        vlc_warning(policy->logger, "cannot set the thread %s: %s", what,
+                    vlc_strerror_c(err));
+}
+
+static void SetAffinity(struct vlc_thread_policy *policy)
+{
+#if defined (__linux__)
+    cpu_set_t set;
+
+    static_assert (VLC_THREAD_POLICY_CPUS <= CPU_SETSIZE, "CPU set too small");
+    CPU_ZERO(&set);
+    for (unsigned i = 0; i < VLC_THREAD_POLICY_CPUS; i++)
+        if (policy->cpus[i / 64] & (UINT64_C(1) << (i % 64)))
+            CPU_SET(i, &set);
+
+    if (sched_setaffinity(0, sizeof (set), &set))
+        Warn(policy, "affinity", errno);
+#elif defined (_WIN32) && !defined (VLC_WINSTORE_APP)
+    /* Only the first processor group is supported */
+    DWORD_PTR mask = (DWORD_PTR)policy->cpus[0];
+
+    if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+        Warn(policy, "affinity", EINVAL);
+#else
+    VLC_UNUSED(policy);
+#endif
+}
+
+static void JoinCgroup(struct vlc_thread_policy *policy)
+{
+#ifdef __linux__
+    /* The cgroup (v2) must be threaded, within the domain of the process */
+    char *path;
+    if (asprintf(&path, "%s/cgroup.threads", policy->cgroup) == -1)
+        return;
+
+    int fd = vlc_open(path, O_WRONLY);
+    free(path);
+    if (fd == -1)
+    {
+        Warn(policy, "cgroup", errno);
+        return;
+    }
+
+    char tid[24];
+    int len = snprintf(tid, sizeof (tid), "%lu\n", vlc_thread_id());
+    if (write(fd, tid, len) != len)
+        Warn(policy, "cgroup", errno);
+    vlc_close(fd);
+#else
+    VLC_UNUSED(policy);
+#endif
+}
+
+static int SetClass(enum vlc_thread_class cls)
+{
+#if defined (__linux__)
+    struct sched_param param = { .sched_priority = 0 };
+    int policy = SCHED_OTHER, nice = 0;
+
+    switch (cls)
+    {
+        case VLC_THREAD_CLASS_BACKGROUND:
+            nice = 10;
+            break;
+        case VLC_THREAD_CLASS_HIGH:
+            nice = -10;
+            break;
+        case VLC_THREAD_CLASS_REALTIME:
+            policy = SCHED_RR;
+            param.sched_priority = sched_get_priority_min(SCHED_RR)
+                                 + VLC_THREAD_POLICY_RT_PRIORITY;
+            break;
+        default:
+            break;
+    }
+
+    int val = pthread_setschedparam(pthread_self(), policy, &param);
+    if (val != 0)
+        return val;
+    /* The nice value is per thread on Linux */
+    if (policy == SCHED_OTHER
+     && setpriority(PRIO_PROCESS, vlc_thread_id(), nice))
+        return errno;
+    return 0;
+#elif defined (__APPLE__)
+    static const qos_class_t classes[] = {
+        [VLC_THREAD_CLASS_DEFAULT] = QOS_CLASS_DEFAULT,
+        [VLC_THREAD_CLASS_BACKGROUND] = QOS_CLASS_BACKGROUND,
+        [VLC_THREAD_CLASS_HIGH] = QOS_CLASS_USER_INITIATED,
+        [VLC_THREAD_CLASS_REALTIME] = QOS_CLASS_USER_INTERACTIVE,
+    };
+
+    return pthread_set_qos_class_self_np(classes[cls], 0);
+#elif defined (_WIN32)
+    static const int priorities[] = {
+        [VLC_THREAD_CLASS_DEFAULT] = THREAD_PRIORITY_NORMAL,
+        [VLC_THREAD_CLASS_BACKGROUND] = THREAD_PRIORITY_LOWEST,
+        [VLC_THREAD_CLASS_HIGH] = THREAD_PRIORITY_ABOVE_NORMAL,
+        [VLC_THREAD_CLASS_REALTIME] = THREAD_PRIORITY_TIME_CRITICAL,
+    };
+
+    return SetThreadPriority(GetCurrentThread(), priorities[cls]) ? 0 : EPERM;
+#else
+    VLC_UNUSED(cls);
+    return ENOSYS;
+#endif
+}
+
+static void Apply(void)
+{
+    struct vlc_thread_policy *policy = current;
+
+    if (policy != NULL)
+        vlc_thread_policy_Hold(policy);
+    else
+    {
+        vlc_mutex_lock(&default_lock);
+        if (default_policy != NULL)
+            policy = vlc_thread_policy_Hold(default_policy);
+        vlc_mutex_unlock(&default_lock);
+        if (policy == NULL)
+            return;
+    }
+
+    if (applied_id != policy->id)
+    {
+        applied_id = policy->id;
+        if (policy->has_cpus)
+            SetAffinity(policy);
+        if (policy->cgroup != NULL)
+            JoinCgroup(policy);
+    }
+
+    uint8_t cls = policy->classes[current_role];
+    if (cls != applied_class)
+    {
+        int val = SetClass(cls);
+
+        /* Without the privilege, the real-time threads get a high priority,
+         * if that is allowed */
+        if (val != 0 && cls == VLC_THREAD_CLASS_REALTIME)
+            val = SetClass(VLC_THREAD_CLASS_HIGH);
+        if (val != 0)
+            Warn(policy, "priority", val);
+        /* Do not retry on failures either */
+        applied_class = cls;
+    }
+
+    vlc_thread_policy_Release(policy);
+}
+
+struct vlc_thread_policy *vlc_thread_policy_Get(void)
+{
+    return (current != NULL) ? vlc_thread_policy_Hold(current) : NULL;
+}
+
+void vlc_thread_policy_Enter(struct vlc_thread_policy *policy)
+{
+    vlc_thread_policy_Leave();
+    current = policy;
+    Apply();
+}
+
+void vlc_thread_policy_Leave(void)
+{
+    if (current != NULL)
+    {
+        vlc_thread_policy_Release(current);
+        current = NULL;
+    }
+}
+
+void vlc_thread_policy_SetName(const char *name)
+{
+    enum vlc_thread_role role = VLC_THREAD_ROLE_OTHER;
+
+    for (size_t i = 0; i < ARRAY_SIZE(role_prefixes); i++)
+        if (!strncmp(name, role_prefixes[i].prefix,
+                     strlen(role_prefixes[i].prefix)))
+        {
+            role = role_prefixes[i].role;
+            break;
+        }
+
+    current_role = role;
+    Apply();
+}
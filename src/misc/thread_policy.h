@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * thread_policy.h: placement and priority of the threads
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_THREAD_POLICY_H
+#define LIBVLC_THREAD_POLICY_H 1
+
+/**
+ * Thread roles, from the names the threads give themselves with
+ * vlc_thread_set_name().
+ */
+enum vlc_thread_role
+{
+    VLC_THREAD_ROLE_OTHER,
+    VLC_THREAD_ROLE_INPUT,
+    VLC_THREAD_ROLE_DECODER,
+    VLC_THREAD_ROLE_AUDIO, /**< audio decoders, which also play, and outputs */
+    VLC_THREAD_ROLE_VIDEO, /**< video outputs */
+    VLC_THREAD_ROLE_SOUT,
+    VLC_THREAD_ROLE_PREFETCH,
+    VLC_THREAD_ROLE_BACKGROUND, /**< preparser, thumbnailer, fetchers */
+};
+
+struct vlc_thread_policy;
+
+/**
+ * Reads the default policy (--thread-affinity, --thread-priorities,
+ * --thread-cgroup) of an instance.
+ *
+ * It applies to the threads that run outside of an input. As for the memory
+ * policy, it is process-wide: the first instance setting one keeps it until
+ * vlc_thread_policy_Deinit().
+ */
+void vlc_thread_policy_Init(libvlc_int_t *);
+void vlc_thread_policy_Deinit(libvlc_int_t *);
+
+/**
+ * Creates the policy of an object, such as an input, from its options.
+ *
+ * \return the policy, or NULL if none is set
+ */
+struct vlc_thread_policy *vlc_thread_policy_New(vlc_object_t *);
+
+struct vlc_thread_policy *vlc_thread_policy_Hold(struct vlc_thread_policy *);
+void vlc_thread_policy_Release(struct vlc_thread_policy *);
+
+/**
+ * Gets a reference to the policy of the calling thread, if any.
+ *
+ * vlc_clone() hands it to the new thread, so that the threads started by an
+ * input follow its policy.
+ */
+struct vlc_thread_policy *vlc_thread_policy_Get(void);
+
+/**
+ * Sets the policy of the calling thread, and applies it.
+ *
+ * \param policy the policy (its reference is taken over), or NULL to use
+ *               the default policy
+ */
+void vlc_thread_policy_Enter(struct vlc_thread_policy *policy);
+
+/**
+ * Releases the policy of the calling thread.
+ *
+ * It must be called before a thread having entered a policy exits.
+ */
+void vlc_thread_policy_Leave(void);
+
+/**
+ * Classifies the calling thread from its name, and applies its policy.
+ *
+ * This is called by vlc_thread_set_name().
+ */
+void vlc_thread_policy_SetName(const char *name);
+
+#endif
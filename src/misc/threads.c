@@ -26,6 +26,9 @@
 #include <errno.h>
 #include <limits.h>
 #include <stdatomic.h>
+#ifdef VLC_MUTEX_STATS
+# include <stdio.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_atomic.h>
@@ -102,6 +105,91 @@ bool vlc_mutex_held(const vlc_mutex_t *mtx)
                                                    memory_order_relaxed);
 }
 
+/*** Adaptive spinning ***/
+
+/* Upper bound of the busy-wait iterations before sleeping on a contended
+ * mutex. Most VLC critical sections are much shorter than a futex
+ * sleep/wake round trip. */
+#define VLC_MUTEX_SPIN_MAX 128
+
+static inline void vlc_cpu_relax(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __asm__ volatile ("pause" ::: "memory");
+#elif defined(__GNUC__) && (defined(__aarch64__) || \
+      (defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7))
+    __asm__ volatile ("yield" ::: "memory");
+#else
+    atomic_signal_fence(memory_order_seq_cst);
+#endif
+}
+
+/* Spinning is useless if the lock owner cannot run concurrently */
+static unsigned vlc_mutex_spin_max(void)
+{
+    static atomic_uint max = UINT_MAX;
+    unsigned val = atomic_load_explicit(&max, memory_order_relaxed);
+
+    if (unlikely(val == UINT_MAX)) {
+        val = (vlc_GetCPUCount() > 1) ? VLC_MUTEX_SPIN_MAX : 0;
+        atomic_store_explicit(&max, val, memory_order_relaxed);
+    }
+    return val;
+}
+
+/* Per-thread estimate of the useful spin count, as with the glibc adaptive
+ * mutexes: it follows the iterations that successful spins took. */
+static thread_local unsigned vlc_mutex_spins = 10;
+
+#ifdef VLC_MUTEX_STATS
+static atomic_ulong vlc_mutex_stats_contended = 0;
+static atomic_ulong vlc_mutex_stats_spun = 0;
+static atomic_ulong vlc_mutex_stats_slept = 0;
+
+# define VLC_MUTEX_STAT(name) \
+    atomic_fetch_add_explicit(&vlc_mutex_stats_##name, 1, memory_order_relaxed)
+
+__attribute__((destructor))
+static void vlc_mutex_stats_print(void)
+{
+    fprintf(stderr, "mutex: %lu contended, %lu acquired spinning, "
+            "%lu slept\n",
+            atomic_load(&vlc_mutex_stats_contended),
+            atomic_load(&vlc_mutex_stats_spun),
+            atomic_load(&vlc_mutex_stats_slept));
+}
+#else
+# define VLC_MUTEX_STAT(name) (void)0
+#endif
+
+static bool vlc_mutex_spin(vlc_mutex_t *mtx)
+{
+    unsigned max = vlc_mutex_spin_max();
+    if (max == 0)
+        return false;
+
+    unsigned limit = 2 * vlc_mutex_spins + 10;
+    if (limit > max)
+        limit = max;
+
+    for (unsigned i = 0; i < limit; i++) {
+        unsigned value = 0;
+
+        vlc_cpu_relax();
+
+        if (atomic_load_explicit(&mtx->value, memory_order_relaxed) == 0
+         && atomic_compare_exchange_weak_explicit(&mtx->value, &value, 1,
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            vlc_mutex_spins += ((int)i - (int)vlc_mutex_spins) / 8;
+            return true;
+        }
+    }
+
+    vlc_mutex_spins += ((int)limit - (int)vlc_mutex_spins) / 8;
+    return false;
+}
+
 void vlc_mutex_lock(vlc_mutex_t *mtx)
 {
     /* This is the Drepper (non-recursive) mutex algorithm
@@ -113,10 +201,22 @@ void vlc_mutex_lock(vlc_mutex_t *mtx)
     if (vlc_mutex_trylock(mtx) == 0)
         return;
 
+    VLC_MUTEX_STAT(contended);
+
+    /* Busy-wait a little first: the owner is likely to release soon. */
+    if (vlc_mutex_spin(mtx)) {
+        VLC_MUTEX_STAT(spun);
+        atomic_store_explicit(&mtx->owner, vlc_thread_id(),
+                              memory_order_relaxed);
+        return;
+    }
+
     int canc = vlc_savecancel(); /* locking is never a cancellation point */
 
-    while (atomic_exchange_explicit(&mtx->value, 2, memory_order_acquire))
+    while (atomic_exchange_explicit(&mtx->value, 2, memory_order_acquire)) {
+        VLC_MUTEX_STAT(slept);
         vlc_atomic_wait(&mtx->value, 2);
+    }
 
     vlc_restorecancel(canc);
     atomic_store_explicit(&mtx->owner, vlc_thread_id(), memory_order_relaxed);
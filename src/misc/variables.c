@@ -38,6 +38,7 @@
 #include <vlc_common.h>
 #include <vlc_arrays.h>
 #include <vlc_charset.h>
+#include <vlc_atomic.h>
 #include "libvlc.h"
 #include "variables.h"
 #include "config/configuration.h"
@@ -97,9 +98,47 @@ struct variable_t
     /** Registered list callbacks */
     callback_entry_t    *list_callbacks;
 
+    /** Generation of the variables with this name */
+    atomic_uint *generation;
+
     vlc_cond_t   wait;
 };
 
+/**
+ * Generations of the variable values, by name hash.
+ *
+ * A generation changes whenever a variable with a name hashing to it is
+ * created, destroyed or set, or the configuration item of that name changes,
+ * so that the variable handles do not need to track the variables they
+ * inherit from. Names sharing a generation only cause spurious lookups.
+ */
+#define VAR_GENERATIONS 256
+
+static atomic_uint generations[VAR_GENERATIONS];
+
+static atomic_uint *var_Generation(const char *name)
+{
+    uint_fast32_t hash = 2166136261u; /* FNV-1a */
+
+    while (*name)
+        hash = ((hash ^ (unsigned char)*(name++)) * 16777619u) & 0xffffffff;
+    return &generations[hash % VAR_GENERATIONS];
+}
+
+static void var_Invalidate(atomic_uint *generation)
+{
+    atomic_fetch_add_explicit(generation, 1, memory_order_release);
+}
+
+void var_InvalidateHandles(const char *name)
+{
+    if (name != NULL)
+        var_Invalidate(var_Generation(name));
+    else
+        for (size_t i = 0; i < VAR_GENERATIONS; i++)
+            var_Invalidate(&generations[i]);
+}
+
 static int CmpBool( vlc_value_t v, vlc_value_t w )
 {
     return v.b_bool ? w.b_bool ? 0 : 1 : w.b_bool ? -1 : 0;
@@ -296,6 +335,7 @@ int (var_Create)( vlc_object_t *p_this, const char *psz_name, int i_type )
 
     p_var->psz_name = strdup( psz_name );
     p_var->psz_text = NULL;
+    p_var->generation = var_Generation( psz_name );
 
     p_var->i_type = i_type & ~VLC_VAR_DOINHERIT;
 
@@ -364,7 +404,10 @@ int (var_Create)( vlc_object_t *p_this, const char *psz_name, int i_type )
     if( unlikely(pp_var == NULL) )
         ret = VLC_ENOMEM;
     else if( (p_oldvar = *pp_var) == p_var ) /* Variable create */
+    {
+        var_Invalidate( p_var->generation );
         p_var = NULL; /* Variable created */
+    }
     else /* Variable already exists */
     {
         assert (((i_type ^ p_oldvar->i_type) & VLC_VAR_CLASS) == 0);
@@ -395,6 +438,7 @@ void (var_Destroy)(vlc_object_t *p_this, const char *psz_name)
     {
         assert(!p_var->b_incallback);
         tdelete( p_var, &p_priv->var_root, varcmp );
+        var_Invalidate( p_var->generation );
     }
     else
     {
@@ -409,6 +453,7 @@ void (var_Destroy)(vlc_object_t *p_this, const char *psz_name)
 
 static void CleanupVar( void *var )
 {
+    var_Invalidate( ((variable_t *)var)->generation );
     Destroy( var );
 }
 
@@ -457,6 +502,7 @@ int (var_Change)(vlc_object_t *p_this, const char *psz_name, int i_action, ...)
             assert(p_var->ops->pf_free == FreeDummy);
             p_var->step = va_arg(ap, vlc_value_t);
             CheckValue( p_var, &p_var->val );
+            var_Invalidate( p_var->generation );
             break;
         case VLC_VAR_GETSTEP:
             switch (p_var->i_type & VLC_VAR_TYPE)
@@ -543,6 +589,7 @@ int (var_Change)(vlc_object_t *p_this, const char *psz_name, int i_action, ...)
             p_var->val = newval;
             /* Free data if needed */
             p_var->ops->pf_free( &oldval );
+            var_Invalidate( p_var->generation );
             break;
         case VLC_VAR_GETCHOICES:
         {
@@ -644,6 +691,7 @@ int (var_GetAndSet)(vlc_object_t *p_this, const char *psz_name, int i_action,
     /*  Check boundaries */
     CheckValue( p_var, &p_var->val );
     *p_val = p_var->val;
+    var_Invalidate( p_var->generation );
 
     /* Deal with callbacks.*/
     TriggerCallback( p_this, p_var, psz_name, oldval );
@@ -707,6 +755,7 @@ int (var_SetChecked)(vlc_object_t *p_this, const char *psz_name,
 
     /* Set the variable */
     p_var->val = val;
+    var_Invalidate( p_var->generation );
 
     /* Deal with callbacks */
     TriggerCallback( p_this, p_var, psz_name, oldval );
@@ -1070,6 +1119,67 @@ int var_Inherit( vlc_object_t *p_this, const char *psz_name, int i_type,
     return VLC_SUCCESS;
 }
 
+struct vlc_var_handle
+{
+    vlc_object_t *obj;
+    int type;
+    atomic_uint *generations; /**< generation of the name */
+    unsigned generation; /**< generation of the value */
+    vlc_value_t value;
+    char name[];
+};
+
+vlc_var_handle_t *(var_HandleNew)(vlc_object_t *obj, const char *name,
+                                  int type)
+{
+    size_t len = strlen(name) + 1;
+    vlc_var_handle_t *handle = malloc(sizeof (*handle) + len);
+    if (unlikely(handle == NULL))
+        return NULL;
+
+    type &= VLC_VAR_CLASS;
+    assert(type == VLC_VAR_BOOL || type == VLC_VAR_INTEGER
+        || type == VLC_VAR_FLOAT || type == VLC_VAR_STRING);
+
+    handle->obj = obj;
+    handle->type = type;
+    memcpy(handle->name, name, len);
+    handle->generations = var_Generation(name);
+    handle->generation = atomic_load_explicit(handle->generations,
+                                              memory_order_acquire);
+    var_Inherit(obj, name, type, &handle->value);
+    return handle;
+}
+
+void var_HandleDelete(vlc_var_handle_t *handle)
+{
+    if (handle->type == VLC_VAR_STRING)
+        free(handle->value.psz_string);
+    free(handle);
+}
+
+const vlc_value_t *var_HandleGet(vlc_var_handle_t *handle)
+{
+    unsigned current = atomic_load_explicit(handle->generations,
+                                            memory_order_acquire);
+
+    if (likely(current == handle->generation))
+        return &handle->value;
+
+    /* A variable with this name (or the same hash) changed */
+    vlc_value_t value;
+
+    if (var_Inherit(handle->obj, handle->name, handle->type,
+                    &value) == VLC_SUCCESS)
+    {
+        if (handle->type == VLC_VAR_STRING)
+            free(handle->value.psz_string);
+        handle->value = value;
+    }
+    handle->generation = current;
+    return &handle->value;
+}
+
 int (var_InheritURational)(vlc_object_t *object,
                            unsigned *num, unsigned *den,
                            const char *var)
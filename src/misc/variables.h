@@ -50,6 +50,15 @@ struct vlc_object_internals
 
 extern void var_DestroyAll( vlc_object_t * );
 
+/**
+ * Invalidates the values of the variable handles of a given name.
+ *
+ * Called when a configuration item changes.
+ *
+ * \param name variable name, or NULL for all the variables
+ */
+void var_InvalidateHandles(const char *name);
+
 /**
  * Return a list of all variable names
  *
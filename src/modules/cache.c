@@ -208,9 +208,8 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
         for (unsigned i = 0; i < cfg->list_count; i++)
         {
             LOAD_STRING (cfg->list.psz[i]);
-            if (cfg->list.psz[i] == NULL /* NULL -> empty string */
-             && (cfg->list.psz[i] = calloc (1, 1)) == NULL)
-                goto error;
+            if (cfg->list.psz[i] == NULL) /* NULL -> empty string */
+                cfg->list.psz[i] = "";
         }
     }
     else
@@ -234,13 +233,19 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
         LOAD_ARRAY(cfg->list.i, cfg->list_count);
     }
 
+    /* Most options have no choices list: do not allocate anything then */
+    if (cfg->list_count == 0)
+    {
+        cfg->list_text = NULL;
+        return 0;
+    }
+
     cfg->list_text = xmalloc (cfg->list_count * sizeof (char *));
     for (unsigned i = 0; i < cfg->list_count; i++)
     {
         LOAD_STRING (cfg->list_text[i]);
-        if (cfg->list_text[i] == NULL /* NULL -> empty string */
-         && (cfg->list_text[i] = calloc (1, 1)) == NULL)
-            goto error;
+        if (cfg->list_text[i] == NULL) /* NULL -> empty string */
+            cfg->list_text[i] = "";
     }
 
     return 0;
@@ -265,9 +265,8 @@ done:
     return module;
 }
 
-static int generic_start(void *func, bool forced, va_list ap)
+static int generic_activate(void *func, bool forced, vlc_object_t *obj)
 {
-    vlc_object_t *obj = va_arg(ap, vlc_object_t *);
     int (*activate)(vlc_object_t *) = func;
     int ret;
 
@@ -278,6 +277,13 @@ static int generic_start(void *func, bool forced, va_list ap)
     return ret;
 }
 
+static int generic_start(void *func, bool forced, va_list ap)
+{
+    vlc_object_t *obj = va_arg(ap, vlc_object_t *);
+
+    return generic_activate(func, forced, obj);
+}
+
 #undef module_need
 module_t *module_need(vlc_object_t *obj, const char *cap, const char *name,
                       bool strict)
@@ -294,6 +300,127 @@ module_t *module_need(vlc_object_t *obj, const char *cap, const char *name,
     return module;
 }
 
+struct vlc_probe_memo_entry
+{
+    const void *activate;
+    size_t keylen;
+    unsigned char key[VLC_PROBE_MEMO_KEY_MAX];
+};
+
+void vlc_probe_memo_Init(struct vlc_probe_memo *memo,
+                         struct vlc_probe_memo *runtime)
+{
+    vlc_mutex_init(&memo->lock);
+    memo->entries = NULL;
+    memo->count = 0;
+    memo->runtime = runtime;
+}
+
+void vlc_probe_memo_Clean(struct vlc_probe_memo *memo)
+{
+    free(memo->entries);
+}
+
+static bool vlc_probe_memo_Has(struct vlc_probe_memo *memo,
+                               const void *activate,
+                               const void *key, size_t keylen)
+{
+    bool found = false;
+
+    vlc_mutex_lock(&memo->lock);
+    for (size_t i = 0; i < memo->count && !found; i++)
+    {
+        const struct vlc_probe_memo_entry *entry = &memo->entries[i];
+
+        found = entry->activate == activate && entry->keylen == keylen
+             && memcmp(entry->key, key, keylen) == 0;
+    }
+    vlc_mutex_unlock(&memo->lock);
+    return found;
+}
+
+static void vlc_probe_memo_Add(struct vlc_probe_memo *memo,
+                               const void *activate,
+                               const void *key, size_t keylen)
+{
+    vlc_mutex_lock(&memo->lock);
+    struct vlc_probe_memo_entry *entries =
+        realloc(memo->entries, (memo->count + 1) * sizeof (*entries));
+    if (likely(entries != NULL))
+    {
+        struct vlc_probe_memo_entry *entry = &entries[memo->count++];
+
+        entry->activate = activate;
+        entry->keylen = keylen;
+        memcpy(entry->key, key, keylen);
+        memo->entries = entries;
+    }
+    vlc_mutex_unlock(&memo->lock);
+}
+
+void vlc_probe_memo_AddRuntimeFailure(struct vlc_probe_memo *memo,
+                                      const module_t *module,
+                                      const void *key, size_t keylen)
+{
+    assert(keylen <= VLC_PROBE_MEMO_KEY_MAX);
+
+    if (memo->runtime != NULL)
+        memo = memo->runtime;
+    if (!vlc_probe_memo_Has(memo, module->pf_activate, key, keylen))
+        vlc_probe_memo_Add(memo, module->pf_activate, key, keylen);
+}
+
+static int memo_start(void *func, bool forced, va_list ap)
+{
+    vlc_object_t *obj = va_arg(ap, vlc_object_t *);
+    struct vlc_probe_memo *memo = va_arg(ap, struct vlc_probe_memo *);
+    const void *key = va_arg(ap, const void *);
+    size_t keylen = va_arg(ap, size_t);
+    bool *transient = va_arg(ap, bool *);
+
+    if (memo->runtime != NULL
+     && vlc_probe_memo_Has(memo->runtime, func, key, keylen))
+        return VLC_EGENERIC;
+
+    /* Modules explicitly requested by name are always probed */
+    if (forced)
+        return generic_activate(func, forced, obj);
+
+    if (vlc_probe_memo_Has(memo, func, key, keylen))
+        return VLC_EGENERIC;
+
+    if (transient != NULL)
+        *transient = false;
+
+    int ret = generic_activate(func, forced, obj);
+    if (ret == VLC_EGENERIC && (transient == NULL || !*transient))
+        vlc_probe_memo_Add(memo, func, key, keylen);
+    return ret;
+}
+
+module_t *module_need_memo(vlc_object_t *obj, const char *cap,
+                           const char *name, bool strict,
+                           struct vlc_probe_memo *memo,
+                           const void *key, size_t keylen, bool *transient)
+{
+    if (memo == NULL)
+        return module_need(obj, cap, name, strict);
+
+    assert(keylen <= VLC_PROBE_MEMO_KEY_MAX);
+
+    const bool b_force_backup = obj->force; /* FIXME: remove this */
+    module_t *module = vlc_module_load(obj->logger, cap, name, strict,
+                                       memo_start, obj, memo, key, keylen,
+                                       transient);
+    if (module != NULL) {
+        var_Create(obj, "module-name", VLC_VAR_STRING);
+        var_SetString(obj, "module-name", module_get_object(module));
+    }
+
+    obj->force = b_force_backup;
+    return module;
+}
+
 #undef module_unneed
 void module_unneed(vlc_object_t *obj, module_t *module)
 {
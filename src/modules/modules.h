@@ -128,6 +128,70 @@ void *vlc_plugin_Symbol(struct vlc_logger *, vlc_plugin_t *, const char *name);
  */
 size_t module_list_cap(module_t *const **tab, const char *name);
 
+/**
+ * Negative probe memo.
+ *
+ * Remembers which modules failed to probe for a given key (e.g. a codec), so
+ * that they are not probed again and again for the same key (e.g. for each
+ * elementary stream of the same input).
+ */
+struct vlc_probe_memo
+{
+    vlc_mutex_t lock;
+    struct vlc_probe_memo_entry *entries;
+    size_t count;
+    /** Modules that failed while running, possibly longer-lived (or NULL) */
+    struct vlc_probe_memo *runtime;
+};
+
+#define VLC_PROBE_MEMO_KEY_MAX 64
+
+/**
+ * Initializes a probe memo.
+ *
+ * \param runtime memo of the runtime failures to check as well, typically
+ *                owned by a longer-lived object (or NULL)
+ */
+void vlc_probe_memo_Init(struct vlc_probe_memo *,
+                         struct vlc_probe_memo *runtime);
+void vlc_probe_memo_Clean(struct vlc_probe_memo *);
+
+/**
+ * Remembers a module that failed after probing successfully.
+ *
+ * This is meant for modules that cannot handle the data after all, e.g.
+ * hardware decoders failing mid-stream. The failure is added to the runtime
+ * memo if there is one, in which case the module is skipped even if it is
+ * forced by name. Otherwise, it is remembered like a probe failure.
+ */
+void vlc_probe_memo_AddRuntimeFailure(struct vlc_probe_memo *,
+                                      const module_t *,
+                                      const void *key, size_t keylen);
+
+/**
+ * Finds and instantiates the best module, skipping memoized failures.
+ *
+ * This is the same as module_need(), except that the modules that failed to
+ * probe for the given key, and that are not forced by name, are not probed
+ * again. Failures are added to the memo. Runtime failures are never probed
+ * again.
+ *
+ * The key must cover everything the modules base their decision on, so that
+ * a failure for a key holds for any later probe with the same key.
+ *
+ * \param memo negative probe memo (or NULL to disable memoization)
+ * \param key opaque key, compared byte-wise
+ * \param keylen size of the key (up to VLC_PROBE_MEMO_KEY_MAX bytes)
+ * \param transient cleared before each module is probed, and set by the
+ *                  caller (typically from a module callback) if the failure
+ *                  may depend on transient conditions, such as hardware
+ *                  resources, in which case it is not remembered (or NULL)
+ */
+module_t *module_need_memo(vlc_object_t *obj, const char *cap,
+                           const char *name, bool strict,
+                           struct vlc_probe_memo *memo,
+                           const void *key, size_t keylen, bool *transient);
+
 int vlc_bindtextdomain (const char *);
 
 /* Low-level OS-dependent handler */
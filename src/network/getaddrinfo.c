@@ -35,6 +35,8 @@
 
 #include <sys/types.h>
 #include <vlc_network.h>
+#include <vlc_tick.h>
+#include "libvlc.h"
 
 int vlc_getnameinfo( const struct sockaddr *sa, int salen,
                      char *host, int hostlen, int *portnum, int flags )
@@ -128,3 +130,167 @@ int vlc_getaddrinfo_i11e(const char *node, unsigned port,
     return vlc_getaddrinfo(node, port, hints, res);
 }
 #endif
+
+/* getaddrinfo() does not expose the time-to-live of the DNS records: keep the
+ * results for a short while, which covers the bursts of connections to the
+ * same host (playlist, art, keys, next item). */
+#define VLC_GAI_CACHE_SIZE 16
+#define VLC_GAI_CACHE_LIFETIME VLC_TICK_FROM_SEC(60)
+
+struct vlc_addrinfo_node
+{
+    struct addrinfo ai;
+    struct sockaddr_storage addr;
+};
+
+struct vlc_gai_cache_entry
+{
+    char *node;
+    unsigned port;
+    struct addrinfo hints;
+    vlc_tick_t expiry;
+    struct addrinfo *res;
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    unsigned count;
+    struct vlc_gai_cache_entry entries[VLC_GAI_CACHE_SIZE];
+} gai_cache = { .lock = VLC_STATIC_MUTEX, .count = 0 };
+
+/* Copies a list of socket addresses into a single allocation */
+static struct addrinfo *vlc_addrinfo_dup(const struct addrinfo *res)
+{
+    size_t count = 0;
+
+    for (const struct addrinfo *p = res; p != NULL; p = p->ai_next)
+        if (p->ai_addrlen <= sizeof (struct sockaddr_storage))
+            count++;
+
+    if (count == 0)
+        return NULL;
+
+    struct vlc_addrinfo_node *nodes = vlc_alloc(count, sizeof (*nodes));
+    if (unlikely(nodes == NULL))
+        return NULL;
+
+    struct vlc_addrinfo_node *n = nodes;
+    for (const struct addrinfo *p = res; p != NULL; p = p->ai_next)
+    {
+        if (p->ai_addrlen > sizeof (struct sockaddr_storage))
+            continue;
+
+        n->ai = *p;
+        n->ai.ai_canonname = NULL;
+        n->ai.ai_addr = (struct sockaddr *)&n->addr;
+        n->ai.ai_next = (n + 1 < nodes + count) ? &n[1].ai : NULL;
+        memcpy(&n->addr, p->ai_addr, p->ai_addrlen);
+        n++;
+    }
+    return &nodes->ai;
+}
+
+static bool vlc_gai_cache_match(unsigned i, const char *node, unsigned port,
+                                const struct addrinfo *hints)
+{
+    const struct addrinfo *h = &gai_cache.entries[i].hints;
+
+    return gai_cache.entries[i].port == port
+        && h->ai_flags == hints->ai_flags
+        && h->ai_family == hints->ai_family
+        && h->ai_socktype == hints->ai_socktype
+        && h->ai_protocol == hints->ai_protocol
+        && strcmp(gai_cache.entries[i].node, node) == 0;
+}
+
+static void vlc_gai_cache_remove(unsigned i)
+{
+    free(gai_cache.entries[i].node);
+    vlc_freeaddrinfo_cached(gai_cache.entries[i].res);
+    gai_cache.count--;
+    memmove(gai_cache.entries + i, gai_cache.entries + i + 1,
+            (gai_cache.count - i) * sizeof (gai_cache.entries[0]));
+}
+
+static void vlc_gai_cache_add(const char *node, unsigned port,
+                              const struct addrinfo *hints,
+                              const struct addrinfo *res)
+{
+    char *name = strdup(node);
+    struct addrinfo *copy = vlc_addrinfo_dup(res);
+
+    if (unlikely(name == NULL || copy == NULL))
+    {
+        free(name);
+        vlc_freeaddrinfo_cached(copy);
+        return;
+    }
+
+    vlc_mutex_lock(&gai_cache.lock);
+    for (unsigned i = 0; i < gai_cache.count; i++)
+        if (vlc_gai_cache_match(i, node, port, hints))
+        {   /* Resolved concurrently by another thread */
+            vlc_gai_cache_remove(i);
+            break;
+        }
+
+    if (gai_cache.count == VLC_GAI_CACHE_SIZE)
+        vlc_gai_cache_remove(0); /* oldest */
+
+    gai_cache.entries[gai_cache.count++] = (struct vlc_gai_cache_entry) {
+        .node = name,
+        .port = port,
+        .hints = *hints,
+        .expiry = vlc_tick_now() + VLC_GAI_CACHE_LIFETIME,
+        .res = copy,
+    };
+    vlc_mutex_unlock(&gai_cache.lock);
+}
+
+int vlc_getaddrinfo_cached(const char *node, unsigned port,
+                           const struct addrinfo *hints,
+                           struct addrinfo **res)
+{
+    if (node != NULL)
+    {
+        vlc_tick_t now = vlc_tick_now();
+
+        vlc_mutex_lock(&gai_cache.lock);
+        for (unsigned i = 0; i < gai_cache.count; i++)
+        {
+            if (!vlc_gai_cache_match(i, node, port, hints))
+                continue;
+
+            if (now >= gai_cache.entries[i].expiry)
+            {
+                vlc_gai_cache_remove(i);
+                break;
+            }
+
+            *res = vlc_addrinfo_dup(gai_cache.entries[i].res);
+            vlc_mutex_unlock(&gai_cache.lock);
+            return (*res != NULL) ? 0 : EAI_MEMORY;
+        }
+        vlc_mutex_unlock(&gai_cache.lock);
+    }
+
+    struct addrinfo *list;
+    int val = vlc_getaddrinfo_i11e(node, port, hints, &list);
+    if (val != 0)
+        return val;
+
+    /* Failures are not cached */
+    if (node != NULL)
+        vlc_gai_cache_add(node, port, hints, list);
+
+    *res = vlc_addrinfo_dup(list);
+    freeaddrinfo(list);
+    return (*res != NULL) ? 0 : EAI_MEMORY;
+}
+
+void vlc_freeaddrinfo_cached(struct addrinfo *res)
+{
+    /* The first node is at the start of the allocation */
+    free(res);
+}
@@ -50,6 +50,9 @@
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
+#ifdef HAVE_NETINET_TCP_H
+# include <netinet/tcp.h>
+#endif
 
 #ifdef HAVE_POLL_H
 # include <poll.h>
@@ -68,6 +71,10 @@
 #define HTTPD_CL_BUFSIZE 10000
 #endif
 
+/* Unsent data kept in the kernel for a stream client: beyond that, the
+ * client waits in the shared stream buffer instead (TCP_NOTSENT_LOWAT) */
+#define HTTPD_STREAM_LOWAT 65536
+
 static void httpd_ClientDestroy(httpd_client_t *cl);
 static void httpd_AppendData(httpd_stream_t *stream, uint8_t *p_data, int i_data);
 
@@ -161,6 +168,10 @@ struct httpd_client_t
      */
     int64_t i_keyframe_wait_to_pass;
 
+    /* Stream sent straight from its circular buffer (or NULL) */
+    httpd_stream_t *stream;
+    bool b_stream_blocked; /* waiting for the socket to be writable */
+
     /* */
     httpd_message_t query;  /* client -> httpd */
     httpd_message_t answer; /* httpd -> client */
@@ -646,47 +657,8 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
         return VLC_SUCCESS;
 
     if (answer->i_body_offset > 0) {
-        int     i_pos;
-
-        if (answer->i_body_offset >= stream->i_buffer_pos)
-            return VLC_EGENERIC;    /* wait, no data available */
-
-        if (cl->i_keyframe_wait_to_pass >= 0) {
-            if (stream->i_last_keyframe_seen_pos <= cl->i_keyframe_wait_to_pass)
-                /* still waiting for the next keyframe */
-                return VLC_EGENERIC;
-
-            /* seek to the new keyframe */
-            answer->i_body_offset = stream->i_last_keyframe_seen_pos;
-            cl->i_keyframe_wait_to_pass = -1;
-        }
-
-        if (answer->i_body_offset + stream->i_buffer_size < stream->i_buffer_pos)
-            answer->i_body_offset = stream->i_buffer_last_pos; /* this client isn't fast enough */
-
-        i_pos   = answer->i_body_offset % stream->i_buffer_size;
-        int64_t i_write = stream->i_buffer_pos - answer->i_body_offset;
-
-        if (i_write > HTTPD_CL_BUFSIZE)
-            i_write = HTTPD_CL_BUFSIZE;
-        else if (i_write <= 0)
-            return VLC_EGENERIC;    /* wait, no data available */
-
-        /* Don't go past the end of the circular buffer */
-        i_write = __MIN(i_write, stream->i_buffer_size - i_pos);
-
-        /* using HTTPD_MSG_ANSWER -> data available */
-        answer->i_proto  = HTTPD_PROTO_HTTP;
-        answer->i_version= 0;
-        answer->i_type   = HTTPD_MSG_ANSWER;
-
-        answer->i_body = i_write;
-        answer->p_body = xmalloc(i_write);
-        memcpy(answer->p_body, &stream->p_buffer[i_pos], i_write);
-
-        answer->i_body_offset += i_write;
-
-        return VLC_SUCCESS;
+        /* The data is sent by httpd_StreamClientSend() */
+        return VLC_EGENERIC;
     } else {
         answer->i_proto  = HTTPD_PROTO_HTTP;
         answer->i_version= 0;
@@ -720,10 +692,15 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
                 memcpy(answer->p_body, stream->p_header, stream->i_header);
             }
             answer->i_body_offset = stream->i_buffer_last_pos;
-            if (stream->b_has_keyframes)
-                cl->i_keyframe_wait_to_pass = stream->i_last_keyframe_seen_pos;
-            else
-                cl->i_keyframe_wait_to_pass = -1;
+            cl->i_keyframe_wait_to_pass = -1;
+            if (stream->b_has_keyframes) {
+                if (stream->i_last_keyframe_seen_pos + stream->i_buffer_size
+                        >= stream->i_buffer_pos)
+                    /* burst from the last keyframe, still in the buffer */
+                    answer->i_body_offset = stream->i_last_keyframe_seen_pos;
+                else
+                    cl->i_keyframe_wait_to_pass = stream->i_last_keyframe_seen_pos;
+            }
             vlc_mutex_unlock(&stream->lock);
         } else {
             httpd_MsgAdd(answer, "Content-Length", "0");
@@ -757,10 +734,90 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
 
         httpd_MsgAdd(answer, "Connection", "close");
 
+        if (answer->i_body_offset > 0) {
+            cl->stream = stream;
+#ifdef TCP_NOTSENT_LOWAT
+            setsockopt(vlc_tls_GetFD(cl->sock), IPPROTO_TCP, TCP_NOTSENT_LOWAT,
+                       &(int){ HTTPD_STREAM_LOWAT }, sizeof (int));
+#endif
+        }
+
         return VLC_SUCCESS;
     }
 }
 
+/**
+ * Sends stream data to a client, straight from the circular buffer shared by
+ * all the clients of the stream (without any intermediate copy).
+ *
+ * \return 0 if data was sent (or the client died), -1 if the client must
+ * wait for more data or for its socket to be writable (b_stream_blocked)
+ */
+static int httpd_StreamClientSend(httpd_stream_t *stream, httpd_client_t *cl)
+{
+    int64_t *offset = &cl->answer.i_body_offset;
+
+    cl->b_stream_blocked = false;
+
+    vlc_mutex_lock(&stream->lock);
+    if (*offset >= stream->i_buffer_pos)
+        goto wait; /* no data available */
+
+    if (cl->i_keyframe_wait_to_pass >= 0) {
+        if (stream->i_last_keyframe_seen_pos <= cl->i_keyframe_wait_to_pass)
+            /* still waiting for the next keyframe */
+            goto wait;
+
+        /* seek to the new keyframe */
+        *offset = stream->i_last_keyframe_seen_pos;
+        cl->i_keyframe_wait_to_pass = -1;
+    }
+
+    if (*offset + stream->i_buffer_size < stream->i_buffer_pos)
+        *offset = stream->i_buffer_last_pos; /* this client isn't fast enough */
+
+    int64_t i_write = stream->i_buffer_pos - *offset;
+    if (i_write <= 0)
+        goto wait;
+    if (i_write > HTTPD_CL_BUFSIZE)
+        i_write = HTTPD_CL_BUFSIZE;
+
+    /* Wrap around the end of the circular buffer */
+    size_t i_pos = *offset % stream->i_buffer_size;
+    size_t i_first = __MIN((size_t)i_write, stream->i_buffer_size - i_pos);
+    struct iovec iov[2] = {
+        { .iov_base = &stream->p_buffer[i_pos], .iov_len = i_first },
+        { .iov_base = stream->p_buffer, .iov_len = i_write - i_first },
+    };
+
+    vlc_tls_t *sock = cl->sock;
+    ssize_t i_len = sock->ops->writev(sock, iov, iov[1].iov_len ? 2 : 1);
+    vlc_mutex_unlock(&stream->lock);
+
+    if (i_len < 0) {
+#if defined(_WIN32)
+        if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+        if (errno == EAGAIN)
+#endif
+        {
+            cl->b_stream_blocked = true;
+            return -1;
+        }
+
+        /* Connection failed, or hung up (EPIPE) */
+        cl->i_state = HTTPD_CLIENT_DEAD;
+        return 0;
+    }
+
+    *offset += i_len;
+    return 0;
+
+wait:
+    vlc_mutex_unlock(&stream->lock);
+    return -1;
+}
+
 httpd_stream_t *httpd_StreamNew(httpd_host_t *host,
                                  const char *psz_url, const char *psz_mime,
                                  const char *psz_user, const char *psz_password)
@@ -1250,6 +1307,8 @@ static httpd_client_t *httpd_ClientNew(vlc_tls_t *sock)
     cl->i_buffer_size = HTTPD_CL_BUFSIZE;
     cl->i_buffer = 0;
     cl->p_buffer = xmalloc(cl->i_buffer_size);
+    cl->stream = NULL;
+    cl->b_stream_blocked = false;
     cl->i_keyframe_wait_to_pass = -1;
     cl->b_stream_mode = false;
 
@@ -1636,7 +1695,8 @@ static int httpd_ClientSend(httpd_client_t *cl)
     cl->i_buffer += i_len;
 
     if (cl->i_buffer >= cl->i_buffer_size) {
-        if (cl->answer.i_body == 0  && cl->answer.i_body_offset > 0) {
+        if (cl->answer.i_body == 0  && cl->answer.i_body_offset > 0
+         && cl->stream == NULL) {
             /* catch more body data */
             int     i_msg = cl->query.i_type;
             int64_t i_offset = cl->answer.i_body_offset;
@@ -1741,6 +1801,10 @@ static void httpdLoop(httpd_host_t *host)
             case HTTPD_CLIENT_SENDING:
                 val = httpd_ClientSend(cl);
                 break;
+            case HTTPD_CLIENT_WAITING:
+                if (cl->stream != NULL)
+                    val = httpd_StreamClientSend(cl->stream, cl);
+                break;
             case HTTPD_CLIENT_TLS_HS_IN:
             case HTTPD_CLIENT_TLS_HS_OUT:
                 httpd_ClientTlsHandshake(host, cl);
@@ -1924,6 +1988,7 @@ static void httpdLoop(httpd_host_t *host)
                     bool do_close = false;
 
                     cl->url = NULL;
+                    cl->stream = NULL;
 
                     if (cl->query.i_proto != HTTPD_PROTO_HTTP
                      || cl->query.i_version > 0)
@@ -1964,6 +2029,13 @@ static void httpdLoop(httpd_host_t *host)
                 break;
 
             case HTTPD_CLIENT_WAITING: {
+                if (cl->stream != NULL) {
+                    /* Wait for the socket if it is full, else for data */
+                    if (cl->b_stream_blocked)
+                        pufd->events = POLLOUT;
+                    break;
+                }
+
                 int64_t i_offset = cl->answer.i_body_offset;
                 int i_msg = cl->query.i_type;
 
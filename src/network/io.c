@@ -50,6 +50,7 @@
 #include <vlc_common.h>
 #include <vlc_network.h>
 #include <vlc_interrupt.h>
+#include "libvlc.h"
 #if defined (_WIN32)
 #   undef EINPROGRESS
 #   define EINPROGRESS WSAEWOULDBLOCK
@@ -116,98 +117,165 @@ int net_Socket (vlc_object_t *p_this, int family, int socktype,
     return fd;
 }
 
-int (net_Connect)(vlc_object_t *obj, const char *host, int serv,
-                  int type, int proto)
+/* RFC 8305 recommended delay between two connection attempts */
+#define NET_CONNECT_ATTEMPT_DELAY VLC_TICK_FROM_MS(250)
+#define NET_CONNECT_MAX_ATTEMPTS 16
+
+int net_ConnectAddrInfo(vlc_object_t *obj, const struct addrinfo *res,
+                        vlc_tick_t timeout)
 {
-    struct addrinfo hints = {
-        .ai_socktype = type,
-        .ai_protocol = proto,
-        .ai_flags = AI_NUMERICSERV | AI_IDN,
-    }, *res;
-    int ret = -1;
+    const struct addrinfo *addrv[NET_CONNECT_MAX_ATTEMPTS];
+    unsigned addrc = 0;
 
-    int val = vlc_getaddrinfo_i11e(host, serv, &hints, &res);
-    if (val)
+    /* Alternate the address families, starting with the preferred one */
+    for (const struct addrinfo *a = res, *b = res;
+         (a != NULL || b != NULL) && addrc < ARRAY_SIZE(addrv);)
     {
-        msg_Err(obj, "cannot resolve %s port %d : %s", host, serv,
-                gai_strerror (val));
-        return -1;
+        while (a != NULL && a->ai_family != res->ai_family)
+            a = a->ai_next;
+        if (a != NULL)
+        {
+            addrv[addrc++] = a;
+            a = a->ai_next;
+        }
+
+        while (b != NULL && b->ai_family == res->ai_family)
+            b = b->ai_next;
+        if (b != NULL && addrc < ARRAY_SIZE(addrv))
+        {
+            addrv[addrc++] = b;
+            b = b->ai_next;
+        }
     }
 
-    vlc_tick_t timeout = VLC_TICK_FROM_MS(var_InheritInteger(obj,
-                                                             "ipv4-timeout"));
+    struct pollfd ufdv[ARRAY_SIZE(addrv)];
+    unsigned ufdc = 0, pending = 0, next = 0;
+    vlc_tick_t attempt = VLC_TICK_INVALID, deadline = VLC_TICK_INVALID;
+    int fd = -1;
 
-    for (struct addrinfo *ptr = res; ptr != NULL; ptr = ptr->ai_next)
+    while (fd == -1 && !vlc_killed())
     {
-        int fd = net_Socket(obj, ptr->ai_family,
-                            ptr->ai_socktype, ptr->ai_protocol);
-        if (fd == -1)
-        {
-            msg_Dbg(obj, "socket error: %s", vlc_strerror_c(net_errno));
-            continue;
-        }
+        vlc_tick_t now = vlc_tick_now();
 
-        if (connect(fd, ptr->ai_addr, ptr->ai_addrlen))
+        /* Start the next attempt if the previous ones failed or are slow */
+        if (next < addrc && (pending == 0 || now >= attempt))
         {
+            const struct addrinfo *ai = addrv[next++];
+            int sfd = net_Socket(obj, ai->ai_family, ai->ai_socktype,
+                                 ai->ai_protocol);
+            if (sfd == -1)
+            {
+                msg_Dbg(obj, "socket error: %s", vlc_strerror_c(net_errno));
+                attempt = now;
+                continue;
+            }
+
+            if (connect(sfd, ai->ai_addr, ai->ai_addrlen) == 0)
+            {
+                fd = sfd;
+                break;
+            }
+
             if (net_errno != EINPROGRESS && errno != EINTR)
             {
                 msg_Err(obj, "connection failed: %s",
                         vlc_strerror_c(net_errno));
-                goto next_ai;
+                net_Close(sfd);
+                attempt = now;
+                continue;
             }
 
-            struct pollfd ufd;
-            vlc_tick_t deadline = VLC_TICK_INVALID;
-
-            ufd.fd = fd;
-            ufd.events = POLLOUT;
-            deadline = vlc_tick_now() + timeout;
-
-            do
-            {
-                vlc_tick_t now = vlc_tick_now();
+            ufdv[ufdc].fd = sfd;
+            ufdv[ufdc].events = POLLOUT;
+            ufdc++;
+            pending++;
+            attempt = now + NET_CONNECT_ATTEMPT_DELAY;
+            if (timeout != VLC_TICK_INVALID)
+                deadline = now + timeout;
+            continue;
+        }
 
-                if (vlc_killed())
-                    goto next_ai;
+        if (pending == 0)
+            break; /* all attempts failed */
 
-                if (now > deadline)
-                    now = deadline;
+        if (deadline != VLC_TICK_INVALID && now >= deadline)
+        {
+            msg_Warn(obj, "connection timed out");
+            break;
+        }
 
-                val = vlc_poll_i11e(&ufd, 1, MS_FROM_VLC_TICK(deadline - now));
-            }
-            while (val == -1 && errno == EINTR);
+        vlc_tick_t wakeup = deadline;
+        if (next < addrc && (wakeup == VLC_TICK_INVALID || attempt < wakeup))
+            wakeup = attempt;
 
-            switch (val)
-            {
-                 case -1: /* error */
-                     msg_Err(obj, "polling error: %s", vlc_strerror_c(errno));
-                     goto next_ai;
+        int val = vlc_poll_i11e(ufdv, ufdc, (wakeup != VLC_TICK_INVALID)
+                     ? MS_FROM_VLC_TICK(wakeup - __MIN(now, wakeup)) : -1);
+        if (val == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            msg_Err(obj, "polling error: %s", vlc_strerror_c(errno));
+            break;
+        }
 
-                 case 0: /* timeout */
-                     msg_Warn(obj, "connection timed out");
-                     goto next_ai;
-            }
+        for (unsigned i = 0; i < ufdc && val > 0; i++)
+        {
+            if (ufdv[i].fd == -1 || ufdv[i].revents == 0)
+                continue;
+            val--;
 
             /* There is NO WAY around checking SO_ERROR.
              * Don't ifdef it out!!! */
-            if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &val,
-                           &(socklen_t){ sizeof (val) }) || val)
+            int err;
+            if (getsockopt(ufdv[i].fd, SOL_SOCKET, SO_ERROR, &err,
+                           &(socklen_t){ sizeof (err) }) == 0 && err == 0)
             {
-                msg_Err(obj, "connection failed: %s", vlc_strerror_c(val));
-                goto next_ai;
+                fd = ufdv[i].fd;
+                ufdv[i].fd = -1;
+                break;
             }
+
+            msg_Err(obj, "connection failed: %s", vlc_strerror_c(err));
+            net_Close(ufdv[i].fd);
+            ufdv[i].fd = -1;
+            pending--;
+            attempt = now; /* try the next address right away */
         }
+    }
+
+    /* Abort the other attempts */
+    for (unsigned i = 0; i < ufdc; i++)
+        if (ufdv[i].fd != -1)
+            net_Close(ufdv[i].fd);
 
+    if (fd != -1)
         msg_Dbg(obj, "connection succeeded (socket = %d)", fd);
-        ret = fd; /* success! */
-        break;
+    return fd;
+}
 
-next_ai: /* failure */
-        net_Close(fd);
+int (net_Connect)(vlc_object_t *obj, const char *host, int serv,
+                  int type, int proto)
+{
+    struct addrinfo hints = {
+        .ai_socktype = type,
+        .ai_protocol = proto,
+        .ai_flags = AI_NUMERICSERV | AI_IDN,
+    }, *res;
+
+    int val = vlc_getaddrinfo_cached(host, serv, &hints, &res);
+    if (val)
+    {
+        msg_Err(obj, "cannot resolve %s port %d : %s", host, serv,
+                gai_strerror (val));
+        return -1;
     }
 
-    freeaddrinfo(res);
-    return ret;
+    vlc_tick_t timeout = VLC_TICK_FROM_MS(var_InheritInteger(obj,
+                                                             "ipv4-timeout"));
+    int fd = net_ConnectAddrInfo(obj, res, timeout);
+
+    vlc_freeaddrinfo_cached(res);
+    return fd;
 }
 
 int *net_Listen (vlc_object_t *p_this, const char *psz_host,
@@ -49,6 +49,7 @@
 #include <vlc_common.h>
 #include <vlc_tls.h>
 #include <vlc_interrupt.h>
+#include "libvlc.h"
 
 ssize_t vlc_tls_Read(vlc_tls_t *session, void *buf, size_t len, bool waitall)
 {
@@ -440,7 +441,7 @@ vlc_tls_t *vlc_tls_SocketOpenTCP(vlc_object_t *obj, const char *name,
     assert(name != NULL);
     msg_Dbg(obj, "resolving %s ...", name);
 
-    int val = vlc_getaddrinfo_i11e(name, port, &hints, &res);
+    int val = vlc_getaddrinfo_cached(name, port, &hints, &res);
     if (val != 0)
     {   /* TODO: C locale for gai_strerror() */
         msg_Err(obj, "cannot resolve %s port %u: %s", name, port,
@@ -450,20 +451,15 @@ vlc_tls_t *vlc_tls_SocketOpenTCP(vlc_object_t *obj, const char *name,
 
     msg_Dbg(obj, "connecting to %s port %u ...", name, port);
 
-    /* TODO: implement RFC8305 */
-    for (const struct addrinfo *p = res; p != NULL; p = p->ai_next)
-    {
-        vlc_tls_t *tls = vlc_tls_SocketOpenAddrInfo(p, false);
-        if (tls == NULL)
-        {
-            msg_Err(obj, "connection error: %s", vlc_strerror_c(errno));
-            continue;
-        }
+    int fd = net_ConnectAddrInfo(obj, res, VLC_TICK_INVALID);
+    vlc_freeaddrinfo_cached(res);
+    if (fd == -1)
+        return NULL;
 
-        freeaddrinfo(res);
-        return tls;
-    }
+    setsockopt(fd, SOL_TCP, TCP_NODELAY, &(int){ 1 }, sizeof (int));
 
-    freeaddrinfo(res);
-    return NULL;
+    vlc_tls_t *tls = vlc_tls_SocketOpen(fd);
+    if (unlikely(tls == NULL))
+        net_Close(fd);
+    return tls;
 }
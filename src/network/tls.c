@@ -33,6 +33,9 @@
 #endif
 #include <assert.h>
 #include <errno.h>
+#ifdef HAVE_NETINET_TCP_H
+# include <netinet/tcp.h>
+#endif
 #ifndef SOL_TCP
 # define SOL_TCP IPPROTO_TCP
 #endif
@@ -226,7 +229,7 @@ vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *creds, const char *name,
 
     msg_Dbg(creds, "resolving %s ...", name);
 
-    int val = vlc_getaddrinfo_i11e(name, port, &hints, &res);
+    int val = vlc_getaddrinfo_cached(name, port, &hints, &res);
     if (val != 0)
     {   /* TODO: C locale for gai_strerror() */
         msg_Err(creds, "cannot resolve %s port %u: %s", name, port,
@@ -234,28 +237,41 @@ vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *creds, const char *name,
         return NULL;
     }
 
-    for (const struct addrinfo *p = res; p != NULL; p = p->ai_next)
-    {
-        vlc_tls_t *tcp = vlc_tls_SocketOpenAddrInfo(p, true);
+    vlc_tls_t *tcp;
+
+    if (res->ai_next == NULL)
+    {   /* Single address: TCP Fast Open with the TLS client hello */
+        tcp = vlc_tls_SocketOpenAddrInfo(res, true);
         if (tcp == NULL)
-        {
             msg_Err(creds, "socket error: %s", vlc_strerror_c(errno));
-            continue;
+    }
+    else
+    {   /* Race the addresses, see net_ConnectAddrInfo() */
+        int fd = net_ConnectAddrInfo(VLC_OBJECT(creds), res, VLC_TICK_INVALID);
+
+        tcp = NULL;
+        if (fd != -1)
+        {
+            setsockopt(fd, SOL_TCP, TCP_NODELAY, &(int){ 1 },
+                       sizeof (int));
+            tcp = vlc_tls_SocketOpen(fd);
+            if (unlikely(tcp == NULL))
+                net_Close(fd);
         }
+    }
+    vlc_freeaddrinfo_cached(res);
 
+    if (tcp != NULL)
+    {
         vlc_tls_t *tls = vlc_tls_ClientSessionCreate(creds, tcp, name, service,
                                                      alpn, alp);
         if (tls != NULL)
-        {   /* Success! */
-            freeaddrinfo(res);
-            return tls;
-        }
+            return tls; /* Success! */
 
         msg_Err(creds, "connection error: %s", vlc_strerror_c(errno));
         vlc_tls_SessionDelete(tcp);
     }
 
     /* Failure! */
-    freeaddrinfo(res);
     return NULL;
 }
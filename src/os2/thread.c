@@ -33,6 +33,7 @@
 #include <vlc_common.h>
 
 #include "libvlc.h"
+#include "misc/thread_policy.h"
 #include <stdarg.h>
 #include <assert.h>
 #include <limits.h>
@@ -511,7 +512,7 @@ unsigned long vlc_thread_id (void)
 
 void (vlc_thread_set_name)(const char *name)
 {
-    VLC_UNUSED(name);
+    vlc_thread_policy_SetName(name);
 }
 
 /*** Thread cancellation ***/
@@ -93,10 +93,24 @@ vlc_player_input_UpdateTime(struct vlc_player_input *input)
 int
 vlc_player_input_Start(struct vlc_player_input *input)
 {
+    const bool preloaded = input_IsPreloaded(input->thread);
     int ret = input_Start(input->thread);
     if (ret != VLC_SUCCESS)
         return ret;
     input->started = true;
+
+    if (preloaded)
+    {
+        vlc_player_t *player = input->player;
+
+        /* Report what was kept silent while preloading */
+        vlc_player_input_HandleState(input, VLC_PLAYER_STATE_STARTED,
+                                     VLC_TICK_INVALID);
+        for (enum es_format_category_e i = UNKNOWN_ES; i < DATA_ES; ++i)
+            if (input->cat_delays[i] != 0)
+                vlc_player_SendEvent(player, on_category_delay_changed, i,
+                                     input->cat_delays[i]);
+    }
     return ret;
 }
 
@@ -211,7 +225,10 @@ vlc_player_input_HandleState(struct vlc_player_input *input,
                                         VLC_TICK_INVALID);
 
             if (input == player->input)
+            {
                 player->input = NULL;
+                vlc_player_PublishLists(player);
+            }
 
             if (player->started)
             {
@@ -723,6 +740,34 @@ vlc_player_input_HandleVoutEvent(struct vlc_player_input *input,
     }
 }
 
+static void
+vlc_player_input_HandlePreloadEvent(struct vlc_player_input *input,
+                                    const struct vlc_input_event *event)
+{
+    vlc_player_t *player = input->player;
+
+    switch (event->type)
+    {
+        case INPUT_EVENT_STATE:
+        case INPUT_EVENT_CACHE:
+        case INPUT_EVENT_ITEM_META:
+        case INPUT_EVENT_ITEM_EPG:
+        case INPUT_EVENT_STATISTICS:
+            /* Nothing to report until it is started */
+            break;
+        case INPUT_EVENT_DEAD:
+            /* The next media will be opened again when needed */
+            vlc_player_destructor_AddJoinablePreload(player, input);
+            break;
+        default:
+            /* An access that is also a demuxer (that creates programs or
+             * tracks before being started) cannot be preloaded */
+            if (player->preload.input == input)
+                vlc_player_CancelPreload(player);
+            break;
+    }
+}
+
 static void
 input_thread_Events(input_thread_t *input_thread,
                     const struct vlc_input_event *event, void *user_data)
@@ -761,6 +806,13 @@ input_thread_Events(input_thread_t *input_thread,
 
     vlc_mutex_lock(&player->lock);
 
+    if (input->preloading)
+    {
+        vlc_player_input_HandlePreloadEvent(input, event);
+        vlc_mutex_unlock(&player->lock);
+        return;
+    }
+
     switch (event->type)
     {
         case INPUT_EVENT_STATE:
@@ -824,13 +876,23 @@ input_thread_Events(input_thread_t *input_thread,
                 vlc_player_UpdateTimer(player, NULL, false, &point,
                                        input->normal_time, 0, 0);
             }
+
+            if (input == player->input && player->preload.delay != 0
+             && input->length != VLC_TICK_INVALID
+             && input->time != VLC_TICK_INVALID
+             && input->length - input->time <= player->preload.delay)
+                vlc_player_PreloadNextMedia(player);
             break;
         }
         case INPUT_EVENT_PROGRAM:
             vlc_player_input_HandleProgramEvent(input, &event->program);
+            if (input == player->input)
+                vlc_player_PublishLists(player);
             break;
         case INPUT_EVENT_ES:
             vlc_player_input_HandleEsEvent(input, &event->es);
+            if (input == player->input)
+                vlc_player_PublishLists(player);
             break;
         case INPUT_EVENT_TITLE:
             vlc_player_input_HandleTitleEvent(input, &event->title);
@@ -935,7 +997,7 @@ vlc_player_input_GetSelectedTrackStringIds(struct vlc_player_input *input,
 }
 
 struct vlc_player_input *
-vlc_player_input_New(vlc_player_t *player, input_item_t *item)
+vlc_player_input_New(vlc_player_t *player, input_item_t *item, bool preload)
 {
     struct vlc_player_input *input = malloc(sizeof(*input));
     if (!input)
@@ -943,6 +1005,7 @@ vlc_player_input_New(vlc_player_t *player, input_item_t *item)
 
     input->player = player;
     input->started = false;
+    input->preloading = preload;
     input->playing = false;
 
     input->state = VLC_PLAYER_STATE_STOPPED;
@@ -998,15 +1061,16 @@ vlc_player_input_New(vlc_player_t *player, input_item_t *item)
     }
     vlc_player_input_RestoreMlStates(input, false);
 
-    if (player->video_string_ids)
+    /* The tracks string ids are the ones of the current media */
+    if (player->video_string_ids && !preload)
         vlc_player_input_SelectTracksByStringIds(input, VIDEO_ES,
                                                  player->video_string_ids);
 
-    if (player->audio_string_ids)
+    if (player->audio_string_ids && !preload)
         vlc_player_input_SelectTracksByStringIds(input, AUDIO_ES,
                                                  player->audio_string_ids);
 
-    if (player->sub_string_ids)
+    if (player->sub_string_ids && !preload)
         vlc_player_input_SelectTracksByStringIds(input, SPU_ES,
                                                  player->sub_string_ids);
 
@@ -1029,7 +1093,7 @@ vlc_player_input_New(vlc_player_t *player, input_item_t *item)
             int ret = input_ControlPush(input->thread,
                                         INPUT_CONTROL_SET_CATEGORY_DELAY,
                                         &param);
-            if (ret == VLC_SUCCESS)
+            if (ret == VLC_SUCCESS && !preload)
                 vlc_player_SendEvent(player, on_category_delay_changed, i,
                                      cat_delays[i]);
         }
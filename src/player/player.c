@@ -67,6 +67,75 @@ vlc_player_PrepareNextMedia(vlc_player_t *player)
     player->next_media_requested = true;
 }
 
+static bool
+vlc_player_CanPreload(vlc_player_t *player, input_item_t *media)
+{
+    /* The stream output is owned by a single input at a time */
+    if (player->renderer)
+        return false;
+
+    char *sout = var_InheritString(player, "sout");
+    free(sout);
+    if (sout)
+        return false;
+
+    bool can_preload = true;
+    vlc_mutex_lock(&media->lock);
+    for (int i = 0; i < media->i_options && can_preload; ++i)
+    {
+        const char *opt = media->ppsz_options[i];
+        if (*opt == ':')
+            opt++;
+        if (!strncmp(opt, "sout", 4))
+            can_preload = false;
+    }
+    vlc_mutex_unlock(&media->lock);
+    return can_preload;
+}
+
+void
+vlc_player_PreloadNextMedia(vlc_player_t *player)
+{
+    vlc_player_assert_locked(player);
+
+    if (player->preload.done || !player->started
+     || player->media_stopped_action != VLC_PLAYER_MEDIA_STOPPED_CONTINUE)
+        return;
+    player->preload.done = true;
+
+    vlc_player_PrepareNextMedia(player);
+    if (!player->next_media
+     || !vlc_player_CanPreload(player, player->next_media))
+        return;
+
+    struct vlc_player_input *input =
+        vlc_player_input_New(player, player->next_media, true);
+    if (!input)
+        return;
+
+    if (input_Preload(input->thread) != VLC_SUCCESS)
+    {
+        vlc_player_input_Delete(input);
+        return;
+    }
+    player->preload.input = input;
+}
+
+void
+vlc_player_CancelPreload(vlc_player_t *player)
+{
+    vlc_player_assert_locked(player);
+
+    struct vlc_player_input *input = player->preload.input;
+    if (!input)
+        return;
+    player->preload.input = NULL;
+
+    /* Deleted by the destructor thread once dead */
+    vlc_list_append(&input->node, &player->destructor.preloads);
+    input_Stop(input->thread);
+}
+
 int
 vlc_player_OpenNextMedia(vlc_player_t *player)
 {
@@ -99,8 +168,26 @@ vlc_player_OpenNextMedia(vlc_player_t *player)
         player->media = player->next_media;
         player->next_media = NULL;
 
-        struct vlc_player_input *input = player->input =
-            vlc_player_input_New(player, player->media);
+        /* Only take the preloaded input if it is about to be started, and if
+         * its access could be opened */
+        struct vlc_player_input *input = player->preload.input;
+        if (input && player->started
+         && (player->media_stopped_action == VLC_PLAYER_MEDIA_STOPPED_CONTINUE
+          || player->media_stopped_action == VLC_PLAYER_MEDIA_STOPPED_EXIT)
+         && input_IsPreloaded(input->thread))
+        {
+            player->preload.input = NULL;
+            input->preloading = false;
+        }
+        else
+        {
+            vlc_player_CancelPreload(player);
+            input = vlc_player_input_New(player, player->media, false);
+        }
+        player->preload.done = false;
+
+        player->input = input;
+        vlc_player_PublishLists(player);
         if (!input)
         {
             input_item_Release(player->media);
@@ -143,7 +230,8 @@ static void
 vlc_player_destructor_AddInput(vlc_player_t *player,
                                struct vlc_player_input *input)
 {
-    if (input->started)
+    /* A preloaded input has a running thread to stop too */
+    if (input->started || input_IsPreloaded(input->thread))
     {
         input->started = false;
         /* Add this input to the stop list: it will be stopped by the
@@ -189,6 +277,19 @@ vlc_player_destructor_AddJoinableInput(vlc_player_t *player,
     vlc_player_destructor_AddInput(player, input);
 }
 
+void
+vlc_player_destructor_AddJoinablePreload(vlc_player_t *player,
+                                         struct vlc_player_input *input)
+{
+    if (player->preload.input == input)
+        player->preload.input = NULL;
+    else
+        vlc_list_remove(&input->node);
+
+    vlc_list_append(&input->node, &player->destructor.joinable_preloads);
+    vlc_cond_signal(&player->destructor.wait);
+}
+
 static bool vlc_player_destructor_IsEmpty(vlc_player_t *player)
 {
     return vlc_list_is_empty(&player->destructor.inputs)
@@ -208,15 +309,27 @@ vlc_player_destructor_Thread(void *data)
     /* Terminate this thread when the player is deleting (vlc_player_Delete()
      * was called) and when all input_thread_t all stopped and released. */
     while (!player->deleting
-        || !vlc_player_destructor_IsEmpty(player))
+        || !vlc_player_destructor_IsEmpty(player)
+        || !vlc_list_is_empty(&player->destructor.preloads)
+        || !vlc_list_is_empty(&player->destructor.joinable_preloads))
     {
         /* Wait for an input to stop or close. No while loop here since we want
          * to leave this code path when the player is deleting. */
         if (vlc_list_is_empty(&player->destructor.inputs)
-         && vlc_list_is_empty(&player->destructor.joinable_inputs))
+         && vlc_list_is_empty(&player->destructor.joinable_inputs)
+         && vlc_list_is_empty(&player->destructor.joinable_preloads)
+         && player->retired_lists == NULL)
             vlc_cond_wait(&player->destructor.wait, &player->lock);
 
+        vlc_player_ReclaimLists(player);
+
         struct vlc_player_input *input;
+        vlc_list_foreach(input, &player->destructor.joinable_preloads, node)
+        {
+            vlc_list_remove(&input->node);
+            vlc_player_input_Delete(input);
+        }
+
         vlc_list_foreach(input, &player->destructor.inputs, node)
         {
             vlc_player_input_HandleState(input, VLC_PLAYER_STATE_STOPPING,
@@ -247,7 +360,10 @@ vlc_player_destructor_Thread(void *data)
             const bool started = player->started;
             vlc_player_Unlock(player);
             if (!started)
+            {
                 input_resource_StopFreeVout(player->resource);
+                input_resource_StopFreeAout(player->resource);
+            }
             if (!keep_sout)
                 input_resource_TerminateSout(player->resource);
             vlc_player_Lock(player);
@@ -1028,6 +1144,7 @@ vlc_player_SetCurrentMedia(vlc_player_t *player, input_item_t *media)
     {
         vlc_player_destructor_AddInput(player, player->input);
         player->input = NULL;
+        vlc_player_PublishLists(player);
     }
 
     assert(media == player->next_media);
@@ -1118,7 +1235,7 @@ float
 vlc_player_GetAssociatedSubsFPS(vlc_player_t *player)
 {
     vlc_player_assert_locked(player);
-    return var_GetFloat(player, "sub-fps");
+    return var_HandleGetFloat(player->handles.sub_fps);
 }
 
 void
@@ -1132,6 +1249,8 @@ vlc_player_InvalidateNextMedia(vlc_player_t *player)
     }
     player->next_media_requested = false;
 
+    vlc_player_CancelPreload(player);
+    player->preload.done = false;
 }
 
 int
@@ -1161,7 +1280,7 @@ vlc_player_Start(vlc_player_t *player)
     if (!player->input)
     {
         /* Possible if the player was stopped by the user */
-        player->input = vlc_player_input_New(player, player->media);
+        player->input = vlc_player_input_New(player, player->media, false);
 
         if (!player->input)
             return VLC_ENOMEM;
@@ -1198,6 +1317,7 @@ vlc_player_Stop(vlc_player_t *player)
 
     vlc_player_destructor_AddInput(player, input);
     player->input = NULL;
+    vlc_player_PublishLists(player);
     return VLC_SUCCESS;
 }
 
@@ -1287,7 +1407,7 @@ vlc_player_GetRate(vlc_player_t *player)
     if (input)
         return input->rate;
     else
-        return var_GetFloat(player, "rate");
+        return var_HandleGetFloat(player->handles.rate);
 }
 
 void
@@ -1775,6 +1895,8 @@ vlc_player_IsTrackCategoryEnabled(vlc_player_t *player,
                                   enum es_format_category_e cat)
 {
     assert(cat >= UNKNOWN_ES && cat <= DATA_ES);
+    if (player->handles.enabled[cat] != NULL)
+        return var_HandleGetBool(player->handles.enabled[cat]);
     return var_GetBool(player, cat2vars[cat].var);
 }
 
@@ -1788,7 +1910,7 @@ vlc_player_SetSubtitleTextScale(vlc_player_t *player, unsigned scale)
 unsigned
 vlc_player_GetSubtitleTextScale(vlc_player_t *player)
 {
-    return var_GetInteger(player, "sub-text-scale");
+    return var_HandleGetInteger(player->handles.sub_text_scale);
 }
 
 int
@@ -1882,6 +2004,23 @@ vlc_player_InitLocks(vlc_player_t *player, enum vlc_player_lock_type lock_type)
     vlc_cond_init(&player->destructor.wait);
 }
 
+static void
+vlc_player_DeleteHandles(vlc_player_t *player)
+{
+    vlc_var_handle_t *handles[] = {
+        player->handles.rate,
+        player->handles.sub_fps,
+        player->handles.sub_text_scale,
+        player->handles.enabled[VIDEO_ES],
+        player->handles.enabled[AUDIO_ES],
+        player->handles.enabled[SPU_ES],
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(handles); ++i)
+        if (handles[i] != NULL)
+            var_HandleDelete(handles[i]);
+}
+
 void
 vlc_player_Delete(vlc_player_t *player)
 {
@@ -1891,8 +2030,11 @@ vlc_player_Delete(vlc_player_t *player)
     {
         vlc_player_destructor_AddInput(player, player->input);
         player->input = NULL;
+        vlc_player_PublishLists(player);
     }
 
+    vlc_player_CancelPreload(player);
+
     player->deleting = true;
     vlc_cond_signal(&player->destructor.wait);
 
@@ -1915,6 +2057,8 @@ vlc_player_Delete(vlc_player_t *player)
     free(player->sub_string_ids);
 
     vlc_player_DestroyTimer(player);
+    vlc_player_DestroyLists(player);
+    vlc_player_DeleteHandles(player);
 
     vlc_player_aout_Deinit(player);
     var_DelCallback(player, "corks", vlc_player_CorkCallback, player);
@@ -1954,6 +2098,8 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type,
     vlc_list_init(&player->destructor.inputs);
     vlc_list_init(&player->destructor.stopping_inputs);
     vlc_list_init(&player->destructor.joinable_inputs);
+    vlc_list_init(&player->destructor.preloads);
+    vlc_list_init(&player->destructor.joinable_preloads);
     player->media_stopped_action = VLC_PLAYER_MEDIA_STOPPED_CONTINUE;
     player->start_paused = false;
     player->pause_on_cork = false;
@@ -1963,6 +2109,8 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type,
     player->media_provider_data = media_provider_data;
     player->media = NULL;
     player->input = NULL;
+    atomic_init(&player->lists, NULL);
+    player->retired_lists = NULL;
     player->global_state = VLC_PLAYER_STATE_STOPPED;
     player->started = false;
 
@@ -1973,8 +2121,14 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type,
     player->next_media_requested = false;
     player->next_media = NULL;
 
+    player->preload.delay =
+        VLC_TICK_FROM_SEC(var_InheritInteger(player, "playlist-preload"));
+    player->preload.input = NULL;
+    player->preload.done = false;
+
     player->video_string_ids = player->audio_string_ids =
     player->sub_string_ids = NULL;
+    memset(&player->handles, 0, sizeof(player->handles));
 
 #define VAR_CREATE(var, flag) do { \
     if (var_Create(player, var, flag) != VLC_SUCCESS) \
@@ -2018,6 +2172,21 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type,
     }
 #undef VAR_CREATE
 
+#define VAR_HANDLE(handle, var, type) do { \
+    handle = var_HandleNew(player, var, type); \
+    if (handle == NULL) \
+        goto error; \
+} while(0)
+
+    VAR_HANDLE(player->handles.rate, "rate", VLC_VAR_FLOAT);
+    VAR_HANDLE(player->handles.sub_fps, "sub-fps", VLC_VAR_FLOAT);
+    VAR_HANDLE(player->handles.sub_text_scale, "sub-text-scale",
+               VLC_VAR_INTEGER);
+    for (int cat = VIDEO_ES; cat <= SPU_ES; ++cat)
+        VAR_HANDLE(player->handles.enabled[cat], cat2vars[cat].var,
+                   VLC_VAR_BOOL);
+#undef VAR_HANDLE
+
     player->resource = input_resource_New(VLC_OBJECT(player));
 
     if (!player->resource)
@@ -2046,6 +2215,7 @@ error:
     var_DelCallback(player, "corks", vlc_player_CorkCallback, player);
     if (player->resource)
         input_resource_Release(player->resource);
+    vlc_player_DeleteHandles(player);
 
     vlc_object_delete(player);
     return NULL;
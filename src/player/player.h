@@ -59,6 +59,9 @@ struct vlc_player_input
     vlc_player_t *player;
     bool started;
 
+    /* Opened ahead of time for the next media, its events are not reported */
+    bool preloading;
+
     /* Monitor the OPENING_S -> PLAYING_S transition. */
     bool playing;
 
@@ -260,6 +263,17 @@ struct vlc_player_t
     bool next_media_requested;
     input_item_t *next_media;
 
+    struct
+    {
+        /* Time before the end of the current media to preload the next one,
+         * 0 to disable */
+        vlc_tick_t delay;
+        /* Input of the next media, waiting to be started */
+        struct vlc_player_input *input;
+        /* A preload was attempted for the next media */
+        bool done;
+    } preload;
+
     char *video_string_ids;
     char *audio_string_ids;
     char *sub_string_ids;
@@ -285,9 +299,28 @@ struct vlc_player_t
         struct vlc_list inputs;
         struct vlc_list stopping_inputs;
         struct vlc_list joinable_inputs;
+        /* Cancelled preloads, stopping or joinable */
+        struct vlc_list preloads;
+        struct vlc_list joinable_preloads;
     } destructor;
 
     struct vlc_player_timer timer;
+
+    /* Snapshot of the track and program lists of the current input,
+     * published with RCU for lock-free readers */
+    struct vlc_player_lists *_Atomic lists;
+    /* Replaced snapshots, freed by the destructor thread after a grace
+     * period */
+    struct vlc_player_lists *retired_lists;
+
+    /* Variables read by the getters, used with the player locked */
+    struct
+    {
+        vlc_var_handle_t *rate;
+        vlc_var_handle_t *sub_fps;
+        vlc_var_handle_t *sub_text_scale;
+        vlc_var_handle_t *enabled[ES_CATEGORY_COUNT];
+    } handles;
 };
 
 #ifndef NDEBUG
@@ -348,6 +381,12 @@ vlc_player_OpenNextMedia(vlc_player_t *player);
 void
 vlc_player_PrepareNextMedia(vlc_player_t *player);
 
+void
+vlc_player_PreloadNextMedia(vlc_player_t *player);
+
+void
+vlc_player_CancelPreload(vlc_player_t *player);
+
 void
 vlc_player_destructor_AddStoppingInput(vlc_player_t *player,
                                        struct vlc_player_input *input);
@@ -356,6 +395,10 @@ void
 vlc_player_destructor_AddJoinableInput(vlc_player_t *player,
                                        struct vlc_player_input *input);
 
+void
+vlc_player_destructor_AddJoinablePreload(vlc_player_t *player,
+                                         struct vlc_player_input *input);
+
 /*
  * player_track.c
  */
@@ -388,6 +431,18 @@ vlc_player_track_vector_FindById(vlc_player_track_vector *vec, vlc_es_id_t *id,
 int
 vlc_player_GetFirstSelectedTrackId(const vlc_player_track_vector* tracks);
 
+/* Publish the lists of the current input, the player must be locked */
+void
+vlc_player_PublishLists(vlc_player_t *player);
+
+/* Free the replaced lists, the player must be locked (it is unlocked
+ * meanwhile) */
+void
+vlc_player_ReclaimLists(vlc_player_t *player);
+
+void
+vlc_player_DestroyLists(vlc_player_t *player);
+
 /*
  * player_title.c
  */
@@ -422,7 +477,7 @@ vlc_player_input_FindTrackById(struct vlc_player_input *input, vlc_es_id_t *id,
                                size_t *idx);
 
 struct vlc_player_input *
-vlc_player_input_New(vlc_player_t *player, input_item_t *item);
+vlc_player_input_New(vlc_player_t *player, input_item_t *item, bool preload);
 
 void
 vlc_player_input_Delete(struct vlc_player_input *input);
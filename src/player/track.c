@@ -26,6 +26,7 @@
 
 #include <vlc_common.h>
 #include "player.h"
+#include "misc/rcu.h"
 
 static char *
 vlc_player_program_DupTitle(int id, const char *title)
@@ -219,3 +220,235 @@ vlc_player_GetFirstSelectedTrackId(const vlc_player_track_vector* tracks)
     }
     return -1;
 }
+
+struct vlc_player_lists
+{
+    struct
+    {
+        size_t count;
+        struct vlc_player_track **array;
+    } tracks[DATA_ES];
+    size_t program_count;
+    struct vlc_player_program **programs;
+    struct vlc_player_lists *next; /* retired lists */
+};
+
+void
+vlc_player_track_DeleteList(struct vlc_player_track **tracks, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        vlc_player_track_Delete(tracks[i]);
+    free(tracks);
+}
+
+void
+vlc_player_program_DeleteList(struct vlc_player_program **programs,
+                              size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        vlc_player_program_Delete(programs[i]);
+    free(programs);
+}
+
+static void
+vlc_player_lists_Delete(struct vlc_player_lists *lists)
+{
+    for (int cat = VIDEO_ES; cat < DATA_ES; ++cat)
+        vlc_player_track_DeleteList(lists->tracks[cat].array,
+                                    lists->tracks[cat].count);
+    vlc_player_program_DeleteList(lists->programs, lists->program_count);
+    free(lists);
+}
+
+static struct vlc_player_track **
+vlc_player_track_CopyArray(struct vlc_player_track *const *src, size_t count)
+{
+    if (count == 0)
+        return NULL;
+
+    struct vlc_player_track **array = vlc_alloc(count, sizeof (*array));
+    if (array == NULL)
+        return NULL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        array[i] = vlc_player_track_Dup(src[i]);
+        if (array[i] == NULL)
+        {
+            vlc_player_track_DeleteList(array, i);
+            return NULL;
+        }
+    }
+    return array;
+}
+
+static struct vlc_player_program **
+vlc_player_program_CopyArray(struct vlc_player_program *const *src,
+                             size_t count)
+{
+    if (count == 0)
+        return NULL;
+
+    struct vlc_player_program **array = vlc_alloc(count, sizeof (*array));
+    if (array == NULL)
+        return NULL;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        array[i] = vlc_player_program_Dup(src[i]);
+        if (array[i] == NULL)
+        {
+            vlc_player_program_DeleteList(array, i);
+            return NULL;
+        }
+    }
+    return array;
+}
+
+static struct vlc_player_lists *
+vlc_player_lists_New(struct vlc_player_input *input)
+{
+    struct vlc_player_lists *lists = calloc(1, sizeof (*lists));
+    if (lists == NULL)
+        return NULL;
+
+    for (int cat = VIDEO_ES; cat < DATA_ES; ++cat)
+    {
+        vlc_player_track_vector *vec =
+            vlc_player_input_GetTrackVector(input, cat);
+        if (vec->size == 0)
+            continue;
+
+        struct vlc_player_track **array = vlc_alloc(vec->size,
+                                                    sizeof (*array));
+        if (array == NULL)
+            goto error;
+        lists->tracks[cat].array = array;
+
+        for (size_t i = 0; i < vec->size; ++i)
+        {
+            array[i] = vlc_player_track_Dup(&vec->data[i]->t);
+            if (array[i] == NULL)
+                goto error;
+            lists->tracks[cat].count++;
+        }
+    }
+
+    lists->programs =
+        vlc_player_program_CopyArray(input->program_vector.data,
+                                     input->program_vector.size);
+    if (lists->programs == NULL && input->program_vector.size > 0)
+        goto error;
+    lists->program_count = input->program_vector.size;
+    return lists;
+
+error:
+    vlc_player_lists_Delete(lists);
+    return NULL;
+}
+
+void
+vlc_player_PublishLists(vlc_player_t *player)
+{
+    vlc_player_assert_locked(player);
+
+    struct vlc_player_lists *lists = NULL;
+
+    if (player->input != NULL)
+        lists = vlc_player_lists_New(player->input);
+    /* On allocation failure, readers see empty lists. */
+
+    struct vlc_player_lists *old =
+        atomic_exchange_explicit(&player->lists, lists, memory_order_acq_rel);
+    if (old != NULL)
+    {   /* Readers may still use it: wait for the grace period from the
+         * destructor thread, rather than with the player locked. */
+        old->next = player->retired_lists;
+        player->retired_lists = old;
+        vlc_cond_signal(&player->destructor.wait);
+    }
+}
+
+static void
+vlc_player_lists_DeleteChain(struct vlc_player_lists *lists)
+{
+    while (lists != NULL)
+    {
+        struct vlc_player_lists *next = lists->next;
+        vlc_player_lists_Delete(lists);
+        lists = next;
+    }
+}
+
+void
+vlc_player_ReclaimLists(vlc_player_t *player)
+{
+    vlc_player_assert_locked(player);
+
+    struct vlc_player_lists *retired = player->retired_lists;
+    if (retired == NULL)
+        return;
+    player->retired_lists = NULL;
+
+    vlc_player_Unlock(player);
+    vlc_rcu_synchronize();
+    vlc_player_lists_DeleteChain(retired);
+    vlc_player_Lock(player);
+}
+
+void
+vlc_player_DestroyLists(vlc_player_t *player)
+{
+    struct vlc_player_lists *lists =
+        atomic_load_explicit(&player->lists, memory_order_relaxed);
+
+    if (lists != NULL)
+        vlc_player_lists_Delete(lists);
+    /* The destructor thread is joined: no readers are left */
+    vlc_player_lists_DeleteChain(player->retired_lists);
+}
+
+struct vlc_player_track **
+vlc_player_CopyTrackList(vlc_player_t *player, enum es_format_category_e cat,
+                         size_t *count)
+{
+    struct vlc_player_track **tracks = NULL;
+
+    *count = 0;
+    if (cat <= UNKNOWN_ES || cat >= DATA_ES)
+        return NULL;
+
+    vlc_rcu_read_lock();
+    const struct vlc_player_lists *lists =
+        atomic_load_explicit(&player->lists, memory_order_acquire);
+    if (lists != NULL)
+    {
+        tracks = vlc_player_track_CopyArray(lists->tracks[cat].array,
+                                            lists->tracks[cat].count);
+        if (tracks != NULL)
+            *count = lists->tracks[cat].count;
+    }
+    vlc_rcu_read_unlock();
+    return tracks;
+}
+
+struct vlc_player_program **
+vlc_player_CopyProgramList(vlc_player_t *player, size_t *count)
+{
+    struct vlc_player_program **programs = NULL;
+
+    *count = 0;
+
+    vlc_rcu_read_lock();
+    const struct vlc_player_lists *lists =
+        atomic_load_explicit(&player->lists, memory_order_acquire);
+    if (lists != NULL)
+    {
+        programs = vlc_player_program_CopyArray(lists->programs,
+                                                lists->program_count);
+        if (programs != NULL)
+            *count = lists->program_count;
+    }
+    vlc_rcu_read_unlock();
+    return programs;
+}
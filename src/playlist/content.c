@@ -76,11 +76,7 @@ vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count)
     vlc_playlist_Notify(playlist, on_items_added, index, items, count);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    for (size_t i = index; i < index + count; ++i)
-    {
-        vlc_playlist_item_t *item = playlist->items.data[i];
-        vlc_playlist_AutoPreparse(playlist, item->media);
-    }
+    vlc_playlist_AutoPreparseRange(playlist, index, count);
 }
 
 static void
@@ -175,7 +171,7 @@ vlc_playlist_ItemReplaced(vlc_playlist_t *playlist, size_t index)
                         &playlist->items.data[index], 1);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    vlc_playlist_AutoPreparse(playlist, playlist->items.data[index]->media);
+    vlc_playlist_AutoPreparseRange(playlist, index, 1);
 }
 
 size_t
@@ -197,8 +193,19 @@ vlc_playlist_IndexOf(vlc_playlist_t *playlist, const vlc_playlist_item_t *item)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    ssize_t index;
-    vlc_vector_index_of(&playlist->items, item, &index);
+    if (item->index < playlist->items.size
+     && playlist->items.data[item->index] == item)
+        return item->index;
+
+    /* the hints are outdated, refresh them all at once so that the next
+     * lookups are immediate until the playlist content changes */
+    ssize_t index = -1;
+    for (size_t i = 0; i < playlist->items.size; ++i)
+    {
+        playlist->items.data[i]->index = i;
+        if (playlist->items.data[i] == item)
+            index = i;
+    }
     return index;
 }
 
@@ -323,6 +330,77 @@ vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
         vlc_player_InvalidateNextMedia(playlist->player);
 }
 
+void
+vlc_playlist_RemoveIndices(vlc_playlist_t *playlist,
+                           const size_t sorted_indices[], size_t count)
+{
+    vlc_playlist_AssertLocked(playlist);
+    assert(count > 0);
+
+    playlist_item_vector_t *items = &playlist->items;
+
+    if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
+    {
+        vlc_playlist_item_t **removed = vlc_alloc(count, sizeof(*removed));
+        if (likely(removed))
+        {
+            for (size_t i = 0; i < count; ++i)
+                removed[i] = items->data[sorted_indices[i]];
+            randomizer_Remove(&playlist->randomizer, removed, count);
+            free(removed);
+        }
+        else
+            for (size_t i = 0; i < count; ++i)
+                randomizer_Remove(&playlist->randomizer,
+                                  &items->data[sorted_indices[i]], 1);
+    }
+
+    struct vlc_playlist_state state;
+    vlc_playlist_state_Save(playlist, &state);
+
+    /* compact the vector in a single pass */
+    bool current_removed = false;
+    ssize_t current = -1;
+    size_t next = 0; /* next index to remove in sorted_indices */
+    size_t size = 0;
+    for (size_t i = 0; i < items->size; ++i)
+    {
+        vlc_playlist_item_t *item = items->data[i];
+
+        while (next < count && sorted_indices[next] < i)
+            next++;
+        if (next < count && sorted_indices[next] == i)
+        {
+            if ((ssize_t) i == playlist->current)
+                current_removed = true;
+            vlc_playlist_item_Release(item);
+            continue;
+        }
+
+        /* if the current item has been removed, select the first item after
+         * it, like vlc_playlist_Remove() */
+        if ((ssize_t) i == playlist->current
+         || (current_removed && current == -1))
+            current = size;
+        items->data[size++] = item;
+    }
+    items->size = size;
+    vlc_vector_autoshrink(items);
+
+    playlist->current = current;
+    playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
+    playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
+
+    /* a single event rather than one per removed slice */
+    vlc_playlist_Notify(playlist, on_items_reset, items->data, items->size);
+    vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    if (current_removed)
+        vlc_playlist_SetCurrentMedia(playlist, playlist->current);
+    else
+        vlc_player_InvalidateNextMedia(playlist->player);
+}
+
 static int
 vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
                      input_item_t *media)
@@ -28,6 +28,12 @@ typedef struct input_item_t input_item_t;
 void
 vlc_playlist_ClearItems(vlc_playlist_t *playlist);
 
+/* remove the items at the given indices, sorted in ascending order, and
+ * notify the listeners by a single reset event */
+void
+vlc_playlist_RemoveIndices(vlc_playlist_t *playlist,
+                           const size_t sorted_indices[], size_t count);
+
 /* expand an item (replace it by the given media array) */
 int
 vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
@@ -28,6 +28,7 @@
 #include "notify.h"
 #include "playlist.h"
 #include "player.h"
+#include "preparse.h"
 
 static void
 vlc_playlist_PlaybackOrderChanged(vlc_playlist_t *playlist)
@@ -328,6 +329,10 @@ vlc_playlist_SetCurrentIndex(vlc_playlist_t *playlist, ssize_t index)
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
     vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    if (index != -1)
+        vlc_playlist_AutoPreparseRange(playlist, index,
+                                       VLC_PLAYLIST_PREPARSE_AHEAD);
 }
 
 bool
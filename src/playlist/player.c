@@ -70,6 +70,10 @@ player_on_current_media_changed(vlc_player_t *player, input_item_t *new_media,
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
     vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    if (index != -1)
+        vlc_playlist_AutoPreparseRange(playlist, index,
+                                       VLC_PLAYLIST_PREPARSE_AHEAD);
 }
 
 static void
@@ -29,6 +29,7 @@
 #include "content.h"
 #include "item.h"
 #include "player.h"
+#include "preparse.h"
 
 vlc_playlist_t *
 vlc_playlist_New(vlc_object_t *parent)
@@ -53,6 +54,7 @@ vlc_playlist_New(vlc_object_t *parent)
     playlist->repeat = VLC_PLAYLIST_PLAYBACK_REPEAT_NONE;
     playlist->order = VLC_PLAYLIST_PLAYBACK_ORDER_NORMAL;
     playlist->idgen = 0;
+    vlc_vector_init(&playlist->expansions);
 #ifdef TEST_PLAYLIST
     playlist->libvlc = NULL;
     playlist->auto_preparse = false;
@@ -72,6 +74,7 @@ vlc_playlist_Delete(vlc_playlist_t *playlist)
 
     vlc_playlist_PlayerDestroy(playlist);
     randomizer_Destroy(&playlist->randomizer);
+    vlc_playlist_ClearExpansions(playlist);
     vlc_playlist_ClearItems(playlist);
     free(playlist);
 }
@@ -45,6 +45,16 @@ typedef struct input_item_t input_item_t;
 
 typedef struct VLC_VECTOR(vlc_playlist_item_t *) playlist_item_vector_t;
 
+/* media whose subitems are being received in several batches */
+struct vlc_playlist_expansion
+{
+    input_item_t *media;
+    vlc_playlist_item_t *last; /**< where to insert the next batch after */
+};
+
+typedef struct VLC_VECTOR(struct vlc_playlist_expansion)
+        playlist_expansion_vector_t;
+
 struct vlc_playlist
 {
     vlc_player_t *player;
@@ -61,6 +71,7 @@ struct vlc_playlist
     enum vlc_playlist_playback_repeat repeat;
     enum vlc_playlist_playback_order order;
     uint64_t idgen;
+    playlist_expansion_vector_t expansions;
 };
 
 /* Also disable vlc_assert_locked in tests since the symbol is not exported */
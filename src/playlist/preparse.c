@@ -62,18 +62,106 @@ vlc_playlist_ExpandItem(vlc_playlist_t *playlist, size_t index,
     return ret;
 }
 
+static ssize_t
+vlc_playlist_FindExpansion(vlc_playlist_t *playlist, input_item_t *media)
+{
+    for (size_t i = 0; i < playlist->expansions.size; ++i)
+        if (playlist->expansions.data[i].media == media)
+            return i;
+    return -1;
+}
+
+static void
+vlc_playlist_RemoveExpansion(vlc_playlist_t *playlist, size_t i)
+{
+    struct vlc_playlist_expansion *exp = &playlist->expansions.data[i];
+    input_item_Release(exp->media);
+    vlc_playlist_item_Release(exp->last);
+    vlc_vector_remove(&playlist->expansions, i);
+}
+
+void
+vlc_playlist_ClearExpansions(vlc_playlist_t *playlist)
+{
+    while (playlist->expansions.size > 0)
+        vlc_playlist_RemoveExpansion(playlist, playlist->expansions.size - 1);
+    vlc_vector_destroy(&playlist->expansions);
+}
+
+static void
+vlc_playlist_TrackExpansion(vlc_playlist_t *playlist, input_item_t *media,
+                            vlc_playlist_item_t *last)
+{
+    ssize_t i = vlc_playlist_FindExpansion(playlist, media);
+    if (i != -1)
+        vlc_playlist_RemoveExpansion(playlist, i);
+
+    struct vlc_playlist_expansion exp = { .media = media, .last = last };
+    if (!vlc_vector_push(&playlist->expansions, exp))
+        return;
+
+    input_item_Hold(media);
+    vlc_playlist_item_Hold(last);
+}
+
+static int
+vlc_playlist_ExpandItemNext(vlc_playlist_t *playlist,
+                            input_item_node_t *subitems)
+{
+    ssize_t i = vlc_playlist_FindExpansion(playlist, subitems->p_item);
+    if (i == -1)
+        return VLC_ENOENT;
+
+    struct vlc_playlist_expansion *exp = &playlist->expansions.data[i];
+    /* the previous items may have been removed meanwhile */
+    ssize_t index = vlc_playlist_IndexOf(playlist, exp->last);
+    int ret = VLC_ENOENT;
+    if (index != -1)
+    {
+        media_vector_t flatten = VLC_VECTOR_INITIALIZER;
+        vlc_playlist_CollectChildren(playlist, &flatten, subitems);
+
+        ret = vlc_playlist_Insert(playlist, index + 1, flatten.data,
+                                  flatten.size);
+        if (ret == VLC_SUCCESS && flatten.size > 0)
+        {
+            vlc_playlist_item_Release(exp->last);
+            exp->last = playlist->items.data[index + flatten.size];
+            vlc_playlist_item_Hold(exp->last);
+        }
+        vlc_vector_destroy(&flatten);
+    }
+
+    if (ret != VLC_SUCCESS || !subitems->b_partial)
+        vlc_playlist_RemoveExpansion(playlist, i);
+    return ret;
+}
+
 int
 vlc_playlist_ExpandItemFromNode(vlc_playlist_t *playlist,
                                 input_item_node_t *subitems)
 {
     vlc_playlist_AssertLocked(playlist);
+    if (subitems->b_continued)
+        return vlc_playlist_ExpandItemNext(playlist, subitems);
+
     input_item_t *media = subitems->p_item;
     ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
     if (index == -1)
         return VLC_ENOENT;
 
     /* replace the item by its flatten subtree */
-    return vlc_playlist_ExpandItem(playlist, index, subitems);
+    size_t size = playlist->items.size;
+    int ret = vlc_playlist_ExpandItem(playlist, index, subitems);
+    if (ret != VLC_SUCCESS || !subitems->b_partial)
+        return ret;
+
+    /* more batches will follow, remember where they go */
+    size_t count = playlist->items.size + 1 - size;
+    if (count > 0)
+        vlc_playlist_TrackExpansion(playlist, media,
+                                    playlist->items.data[index + count - 1]);
+    return VLC_SUCCESS;
 }
 
 static void
@@ -92,13 +180,25 @@ static void
 on_preparse_ended(input_item_t *media,
                   enum input_item_preparse_status status, void *userdata)
 {
-    VLC_UNUSED(media); /* retrieved by subtree->p_item */
     vlc_playlist_t *playlist = userdata;
 
-    if (status != ITEM_PREPARSE_DONE)
+    /* skipped items never added any subitems, and may be reported
+     * synchronously, with the playlist locked */
+    if (status == ITEM_PREPARSE_SKIPPED)
         return;
 
     vlc_playlist_Lock(playlist);
+    /* the subitems may have been interrupted before the last batch */
+    ssize_t i = vlc_playlist_FindExpansion(playlist, media);
+    if (i != -1)
+        vlc_playlist_RemoveExpansion(playlist, i);
+
+    if (status != ITEM_PREPARSE_DONE)
+    {
+        vlc_playlist_Unlock(playlist);
+        return;
+    }
+
     ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
     if (index != -1)
         vlc_playlist_Notify(playlist, on_items_updated, index,
@@ -133,3 +233,31 @@ vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input)
     if (playlist->auto_preparse && !input_item_IsPreparsed(input))
         vlc_playlist_Preparse(playlist, input);
 }
+
+void
+vlc_playlist_AutoPreparseRange(vlc_playlist_t *playlist, size_t index,
+                               size_t count)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    if (!playlist->auto_preparse)
+        return;
+
+    /* only the items near the current one are preparsed automatically, the
+     * others are preparsed on demand (vlc_playlist_Preparse()) */
+    size_t start = playlist->current != -1 ? (size_t) playlist->current : 0;
+    size_t end = start + VLC_PLAYLIST_PREPARSE_AHEAD;
+
+    if (index < start)
+    {
+        if (index + count <= start)
+            return;
+        count -= start - index;
+        index = start;
+    }
+    if (end > playlist->items.size)
+        end = playlist->items.size;
+
+    for (size_t i = index; i < index + count && i < end; ++i)
+        vlc_playlist_AutoPreparse(playlist, playlist->items.data[i]->media);
+}
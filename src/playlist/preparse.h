@@ -26,15 +26,36 @@
 typedef struct vlc_playlist vlc_playlist_t;
 typedef struct input_item_node_t input_item_node_t;
 
+/* Number of items automatically preparsed from the current one */
+#define VLC_PLAYLIST_PREPARSE_AHEAD 16
+
 void
 vlc_playlist_AutoPreparse(vlc_playlist_t *playlist, input_item_t *input);
 
+/**
+ * Automatically preparse the items of the range that are near the current
+ * item.
+ */
+void
+vlc_playlist_AutoPreparseRange(vlc_playlist_t *playlist, size_t index,
+                               size_t count);
+
 int
 vlc_playlist_ExpandItem(vlc_playlist_t *playlist, size_t index,
                         input_item_node_t *node);
 
+/**
+ * Expand the item of the subtree root into its children.
+ *
+ * A subtree posted in several batches (see input_item_node_t.b_continued)
+ * replaces the item on the first batch, then each following batch is
+ * inserted right after the items of the previous ones.
+ */
 int
 vlc_playlist_ExpandItemFromNode(vlc_playlist_t *playlist,
                                 input_item_node_t *subitems);
 
+void
+vlc_playlist_ClearExpansions(vlc_playlist_t *playlist);
+
 #endif
@@ -32,6 +32,9 @@
 #include <vlc_rand.h>
 #include "randomizer.h"
 
+/* Minimal number of items to remove them in a single pass */
+#define RANDOMIZER_REMOVE_MANY_MIN 8
+
 /**
  * \addtogroup playlist_randomizer Playlist randomizer helper
  * \ingroup playlist
@@ -524,12 +527,67 @@ randomizer_RemoveOne(struct randomizer *r, const vlc_playlist_item_t *item)
     randomizer_RemoveAt(r, index);
 }
 
+static int
+randomizer_CompareItems(const void *lhs, const void *rhs)
+{
+    uintptr_t a = (uintptr_t) *(vlc_playlist_item_t *const *) lhs;
+    uintptr_t b = (uintptr_t) *(vlc_playlist_item_t *const *) rhs;
+    return a < b ? -1 : a > b;
+}
+
+/* Remove many items in a single pass, instead of one lookup and one move per
+ * item */
+static bool
+randomizer_RemoveMany(struct randomizer *r, vlc_playlist_item_t *const items[],
+                      size_t count)
+{
+    vlc_playlist_item_t **sorted = vlc_alloc(count, sizeof(*sorted));
+    if (unlikely(!sorted))
+        return false;
+    memcpy(sorted, items, count * sizeof(*sorted));
+    qsort(sorted, count, sizeof(*sorted), randomizer_CompareItems);
+
+    /* keep the relative order of the remaining items, so that each part
+     * (selected, unordered, history) stays ordered */
+    size_t head = r->head;
+    size_t history = r->history;
+    size_t next = r->next;
+    size_t size = 0;
+    for (size_t i = 0; i < r->items.size; ++i)
+    {
+        vlc_playlist_item_t *item = r->items.data[i];
+        if (bsearch(&item, sorted, count, sizeof(*sorted),
+                    randomizer_CompareItems))
+        {
+            if (i < r->head)
+                head--;
+            if (i < r->history)
+                history--;
+            if (i < r->next)
+                next--;
+        }
+        else
+            r->items.data[size++] = item;
+    }
+    assert(r->items.size - size == count); /* items must exist */
+
+    r->items.size = size;
+    r->head = head;
+    r->history = history;
+    r->next = next;
+
+    free(sorted);
+    return true;
+}
+
 void
 randomizer_Remove(struct randomizer *r, vlc_playlist_item_t *const items[],
                   size_t count)
 {
-    for (size_t i = 0; i < count; ++i)
-        randomizer_RemoveOne(r, items[i]);
+    if (count < RANDOMIZER_REMOVE_MANY_MIN
+     || !randomizer_RemoveMany(r, items, count))
+        for (size_t i = 0; i < count; ++i)
+            randomizer_RemoveOne(r, items[i]);
 
     vlc_vector_autoshrink(&r->items);
 }
@@ -22,6 +22,7 @@
 # include "config.h"
 #endif
 
+#include "content.h"
 #include "item.h"
 #include "playlist.h"
 
@@ -77,11 +78,27 @@ vlc_playlist_FindIndices(vlc_playlist_t *playlist,
     }
 }
 
+/* Beyond this number of slices, the removed items are notified by a single
+ * reset event */
+#define VLC_PLAYLIST_MAX_REMOVED_SLICES 16
+
 static void
 vlc_playlist_RemoveBySlices(vlc_playlist_t *playlist, size_t sorted_indices[],
                             size_t count)
 {
     assert(count > 0);
+
+    size_t slices = 1;
+    for (size_t i = 1; i < count; ++i)
+        if (sorted_indices[i] != sorted_indices[i - 1] + 1)
+            slices++;
+    if (slices > VLC_PLAYLIST_MAX_REMOVED_SLICES)
+    {
+        /* avoid one move of the remaining items and one event per slice */
+        vlc_playlist_RemoveIndices(playlist, sorted_indices, count);
+        return;
+    }
+
     size_t last_index = sorted_indices[count - 1];
     size_t slice_size = 1;
     /* size_t is unsigned, take care not to test for non-negativity */
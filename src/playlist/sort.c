@@ -23,6 +23,7 @@
 #endif
 
 #include <vlc_common.h>
+#include <vlc_executor.h>
 #include <vlc_rand.h>
 #include <vlc_sort.h>
 #include <vlc_strings.h>
@@ -31,17 +32,26 @@
 #include "notify.h"
 #include "playlist.h"
 
+/* Minimal number of items sorted by each executor task */
+#define SORT_TASK_MIN_ITEMS 8192
+
 /**
  * Struct containing a copy of (parsed) media metadata, used for sorting
  * without locking all the items.
+ *
+ * The strings compared case-insensitively are stored lowercase, and the
+ * strings compared by collation come with their collation key, so that the
+ * comparisons do not depend on the locale.
  */
 struct vlc_playlist_item_meta {
     vlc_playlist_item_t *item;
     size_t index;
     const char *title_or_name;
+    const char *title_or_name_key;
     vlc_tick_t duration;
     const char *artist;
     const char *album;
+    const char *album_key;
     const char *album_artist;
     const char *genre;
     const char *url;
@@ -71,6 +81,44 @@ vlc_playlist_item_meta_CopyString(const char **to, const char *from)
     return VLC_SUCCESS;
 }
 
+static int
+vlc_playlist_item_meta_CopyLowerString(const char **to, const char *from)
+{
+    int ret = vlc_playlist_item_meta_CopyString(to, from);
+    if (ret == VLC_SUCCESS && *to)
+        for (char *p = (char *) *to; *p; ++p)
+            *p = vlc_ascii_tolower(*p);
+    return ret;
+}
+
+/* Copy a string along with its collation key, i.e. a string such that
+ * strcmp() on the keys gives the same result as strcoll() on the strings */
+static int
+vlc_playlist_item_meta_CopyCollatedString(const char **to, const char **key,
+                                          const char *from)
+{
+    if (!from)
+    {
+        *to = *key = NULL;
+        return VLC_SUCCESS;
+    }
+
+    size_t len = strxfrm(NULL, from, 0);
+    char *buf = malloc(len + 1);
+    if (unlikely(!buf))
+        return VLC_ENOMEM;
+    strxfrm(buf, from, len + 1);
+
+    *to = strdup(from);
+    if (unlikely(!*to))
+    {
+        free(buf);
+        return VLC_ENOMEM;
+    }
+    *key = buf;
+    return VLC_SUCCESS;
+}
+
 static int
 vlc_playlist_item_meta_GetNumber(const char * str, int64_t * to)
 {
@@ -106,8 +154,8 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Title);
             if (EMPTY_STR(value))
                 value = media->psz_name;
-            return vlc_playlist_item_meta_CopyString(&meta->title_or_name,
-                                                     value);
+            return vlc_playlist_item_meta_CopyCollatedString(
+                        &meta->title_or_name, &meta->title_or_name_key, value);
         }
         case VLC_PLAYLIST_SORT_KEY_DURATION:
         {
@@ -122,24 +170,26 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
         {
             const char *value = input_item_GetMetaLocked(media,
                                                          vlc_meta_Artist);
-            return vlc_playlist_item_meta_CopyString(&meta->artist, value);
+            return vlc_playlist_item_meta_CopyLowerString(&meta->artist, value);
         }
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
         {
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Album);
-            return vlc_playlist_item_meta_CopyString(&meta->album, value);
+            return vlc_playlist_item_meta_CopyCollatedString(&meta->album,
+                                                             &meta->album_key,
+                                                             value);
         }
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
         {
             const char *value = input_item_GetMetaLocked(media,
                                                          vlc_meta_AlbumArtist);
-            return vlc_playlist_item_meta_CopyString(&meta->album_artist,
-                                                     value);
+            return vlc_playlist_item_meta_CopyLowerString(&meta->album_artist,
+                                                          value);
         }
         case VLC_PLAYLIST_SORT_KEY_GENRE:
         {
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Genre);
-            return vlc_playlist_item_meta_CopyString(&meta->genre, value);
+            return vlc_playlist_item_meta_CopyLowerString(&meta->genre, value);
         }
         case VLC_PLAYLIST_SORT_KEY_DATE:
         {
@@ -216,8 +266,10 @@ static void
 vlc_playlist_item_meta_DestroyFields(struct vlc_playlist_item_meta *meta)
 {
     free((void *) meta->title_or_name);
+    free((void *) meta->title_or_name_key);
     free((void *) meta->artist);
     free((void *) meta->album);
+    free((void *) meta->album_key);
     free((void *) meta->album_artist);
     free((void *) meta->genre);
     free((void *) meta->url);
@@ -273,21 +325,41 @@ vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
     free(meta);
 }
 
+/* the strings are already lowercase */
 static inline int
 CompareStrings(const char *a, const char *b)
 {
     if (a && b)
-        return strcasecmp(a, b);
+        return strcmp(a, b);
     if (!a && !b)
         return 0;
     return a ? 1 : -1;
 }
 
+/* same as vlc_filenamecmp(), using the precomputed collation keys */
 static inline int
-CompareFilenameStrings(const char *a, const char *b)
+CompareFilenameStrings(const char *a, const char *a_key,
+                       const char *b, const char *b_key)
 {
     if (a && b)
-        return vlc_filenamecmp(a, b);
+    {
+        size_t i;
+        char ca, cb;
+
+        for (i = 0; (ca = a[i]) == (cb = b[i]); i++)
+            if (ca == '\0')
+                return 0;
+
+        if ((unsigned)(ca - '0') > 9 || (unsigned)(cb - '0') > 9)
+            return strcmp(a_key, b_key);
+
+        unsigned long long ua = strtoull(a + i, NULL, 10);
+        unsigned long long ub = strtoull(b + i, NULL, 10);
+        if (ua == ub)
+            return strcmp(a_key, b_key);
+
+        return (ua > ub) ? +1 : -1;
+    }
     if (!a && !b)
         return 0;
     return a ? 1 : -1;
@@ -333,13 +405,15 @@ CompareMetaByKey(const struct vlc_playlist_item_meta *a,
     switch (key)
     {
         case VLC_PLAYLIST_SORT_KEY_TITLE:
-            return CompareFilenameStrings(a->title_or_name, b->title_or_name);
+            return CompareFilenameStrings(a->title_or_name, a->title_or_name_key,
+                                          b->title_or_name, b->title_or_name_key);
         case VLC_PLAYLIST_SORT_KEY_DURATION:
             return CompareIntegers(a->duration, b->duration);
         case VLC_PLAYLIST_SORT_KEY_ARTIST:
             return CompareStrings(a->artist, b->artist);
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
-            return CompareFilenameStrings(a->album, b->album);
+            return CompareFilenameStrings(a->album, a->album_key,
+                                          b->album, b->album_key);
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
             return CompareStrings(a->album_artist, b->album_artist);
         case VLC_PLAYLIST_SORT_KEY_GENRE:
@@ -408,33 +482,159 @@ vlc_playlist_DeleteMetaArray(struct vlc_playlist_item_meta *array[],
                              size_t count)
 {
     for (size_t i = 0; i < count; ++i)
-        vlc_playlist_item_meta_Delete(array[i]);
+        if (array[i])
+            vlc_playlist_item_meta_Delete(array[i]);
     free(array);
 }
 
+/* Gather the metadata of a range of items, and sort them */
+struct sort_task
+{
+    struct vlc_runnable runnable;
+    vlc_playlist_item_t **items;
+    struct vlc_playlist_item_meta **array;
+    size_t start;
+    size_t count;
+    struct sort_request *req;
+    int ret;
+};
+
+static void
+RunSortTask(void *userdata)
+{
+    struct sort_task *task = userdata;
+    const struct sort_request *req = task->req;
+    struct vlc_playlist_item_meta **array = &task->array[task->start];
+
+    for (size_t i = 0; i < task->count; ++i)
+    {
+        size_t index = task->start + i;
+        array[i] = vlc_playlist_item_meta_New(index, task->items[index],
+                                              req->criteria, req->count);
+        if (unlikely(!array[i]))
+        {
+            task->ret = VLC_ENOMEM;
+            return;
+        }
+    }
+
+    vlc_qsort(array, task->count, sizeof(*array), compare_meta, task->req);
+    task->ret = VLC_SUCCESS;
+}
+
+/* Merge the sorted runs of the array, pairwise */
+static int
+vlc_playlist_MergeRuns(struct vlc_playlist_item_meta **array, size_t size,
+                       size_t run, struct sort_request *req)
+{
+    struct vlc_playlist_item_meta **tmp = vlc_alloc(size, sizeof(*tmp));
+    if (unlikely(!tmp))
+        return VLC_ENOMEM;
+
+    struct vlc_playlist_item_meta **src = array;
+    struct vlc_playlist_item_meta **dst = tmp;
+    for (; run < size; run *= 2)
+    {
+        for (size_t lo = 0; lo < size; lo += 2 * run)
+        {
+            size_t mid = lo + run < size ? lo + run : size;
+            size_t hi = mid + run < size ? mid + run : size;
+            size_t i = lo, j = mid, k = lo;
+
+            while (i < mid && j < hi)
+                dst[k++] = compare_meta(&src[j], &src[i], req) < 0 ? src[j++]
+                                                                   : src[i++];
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+
+        struct vlc_playlist_item_meta **swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != array)
+        memcpy(array, src, size * sizeof(*array));
+    free(tmp);
+    return VLC_SUCCESS;
+}
+
+/**
+ * Sort the metadata of the playlist items.
+ *
+ * Large playlists are split into ranges gathered and sorted in parallel, then
+ * merged.
+ */
 static struct vlc_playlist_item_meta **
-vlc_playlist_NewMetaArray(vlc_playlist_t *playlist,
-        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+vlc_playlist_SortMetaArray(vlc_playlist_t *playlist, struct sort_request *req)
 {
-    struct vlc_playlist_item_meta **array =
-            vlc_alloc(playlist->items.size, sizeof(*array));
+    size_t size = playlist->items.size;
 
+    /* NULL entries are skipped on deletion */
+    struct vlc_playlist_item_meta **array = vlc_alloc(size, sizeof(*array));
     if (unlikely(!array))
         return NULL;
+    for (size_t i = 0; i < size; ++i)
+        array[i] = NULL;
 
-    size_t i;
-    for (i = 0; i < playlist->items.size; ++i)
+    size_t task_count = size / SORT_TASK_MIN_ITEMS;
+    unsigned cpus = vlc_GetCPUCount();
+    if (task_count > cpus)
+        task_count = cpus;
+
+    vlc_executor_t *executor = task_count > 1
+                             ? vlc_executor_New(task_count) : NULL;
+    if (!executor)
+        task_count = 1;
+
+    struct sort_task *tasks = vlc_alloc(task_count, sizeof(*tasks));
+    if (unlikely(!tasks))
     {
-        array[i] = vlc_playlist_item_meta_New(i, playlist->items.data[i],
-                                              criteria, count);
-        if (unlikely(!array[i]))
-            break;
+        if (executor)
+            vlc_executor_Delete(executor);
+        free(array);
+        return NULL;
+    }
+
+    /* equal runs (except the last one), as expected by the merge */
+    size_t run = (size + task_count - 1) / task_count;
+    for (size_t i = 0; i < task_count; ++i)
+    {
+        struct sort_task *task = &tasks[i];
+        task->runnable.run = RunSortTask;
+        task->runnable.userdata = task;
+        task->items = playlist->items.data;
+        task->array = array;
+        task->start = i * run;
+        task->count = i + 1 < task_count ? run : size - task->start;
+        task->req = req;
+        task->ret = VLC_EGENERIC;
     }
 
-    if (i < playlist->items.size)
+    if (executor)
     {
-        /* allocation failure */
-        vlc_playlist_DeleteMetaArray(array, i);
+        for (size_t i = 0; i < task_count; ++i)
+            vlc_executor_Submit(executor, &tasks[i].runnable);
+        vlc_executor_WaitIdle(executor);
+        vlc_executor_Delete(executor);
+    }
+    else
+        RunSortTask(&tasks[0]);
+
+    int ret = VLC_SUCCESS;
+    for (size_t i = 0; i < task_count; ++i)
+        if (tasks[i].ret != VLC_SUCCESS)
+            ret = tasks[i].ret;
+    free(tasks);
+
+    if (ret == VLC_SUCCESS && task_count > 1)
+        ret = vlc_playlist_MergeRuns(array, size, run, req);
+
+    if (unlikely(ret != VLC_SUCCESS))
+    {
+        vlc_playlist_DeleteMetaArray(array, size);
         return NULL;
     }
 
@@ -453,15 +653,13 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
                                  ? playlist->items.data[playlist->current]
                                  : NULL;
 
+    struct sort_request req = { criteria, count };
+
     struct vlc_playlist_item_meta **array =
-        vlc_playlist_NewMetaArray(playlist, criteria, count);
+        vlc_playlist_SortMetaArray(playlist, &req);
     if (unlikely(!array))
         return VLC_ENOMEM;
 
-    struct sort_request req = { criteria, count };
-
-    vlc_qsort(array, playlist->items.size, sizeof(*array), compare_meta, &req);
-
     /* apply the sorting result to the playlist */
     for (size_t i = 0; i < playlist->items.size; ++i)
         playlist->items.data[i] = array[i]->item;
@@ -1554,6 +1554,59 @@ test_request_remove_adapt(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_request_remove_many_slices(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL);
+    assert(playlist);
+
+    input_item_t *media[100];
+    CreateDummyMediaArray(media, 100);
+
+    /* initial playlist with 100 items */
+    int ret = vlc_playlist_Append(playlist, media, 100);
+    assert(ret == VLC_SUCCESS);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_reset = callback_on_items_reset,
+        .on_items_removed = callback_on_items_removed,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    playlist->current = 50;
+
+    /* remove the items at even indices, i.e. 50 slices */
+    vlc_playlist_item_t *items_to_remove[50];
+    for (size_t i = 0; i < 50; ++i)
+        items_to_remove[i] = vlc_playlist_Get(playlist, 2 * i);
+
+    ret = vlc_playlist_RequestRemove(playlist, items_to_remove, 50, 0);
+    assert(ret == VLC_SUCCESS);
+
+    assert(vlc_playlist_Count(playlist) == 50);
+    for (size_t i = 0; i < 50; ++i)
+        EXPECT_AT(i, 2 * i + 1);
+
+    /* the current item has been removed, the next one is selected */
+    assert(playlist->current == 25);
+
+    /* the slices are notified by a single reset event */
+    assert(ctx.vec_items_removed.size == 0);
+    assert(ctx.vec_items_reset.size == 1);
+    assert(ctx.vec_items_reset.data[0].count == 50);
+    assert(ctx.vec_items_reset.data[0].state.playlist_size == 50);
+    assert(ctx.vec_items_reset.data[0].state.current == 25);
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 100);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_request_move_with_matching_hint(void)
 {
@@ -2349,6 +2402,61 @@ test_sort(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_sort_large(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL);
+    assert(playlist);
+
+    /* large enough to be sorted by several tasks, 3 items per title (with
+     * the same number of digits, so that the title order is numerical) */
+    enum { COUNT = 30000 };
+    input_item_t **media = malloc(COUNT * sizeof(*media));
+    input_item_t **shuffled = malloc(COUNT * sizeof(*shuffled));
+    size_t *initial_pos = malloc(COUNT * sizeof(*initial_pos));
+    assert(media && shuffled && initial_pos);
+
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        media[i] = CreateDummyMedia(10000 + i / 3);
+        assert(media[i]);
+        media[i]->i_duration = i; /* only used to identify the media */
+    }
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        size_t index = (i * 7919) % COUNT;
+        shuffled[i] = media[index];
+        initial_pos[index] = i;
+    }
+
+    int ret = vlc_playlist_Append(playlist, shuffled, COUNT);
+    assert(ret == VLC_SUCCESS);
+
+    struct vlc_playlist_sort_criterion criteria[] = {
+        { VLC_PLAYLIST_SORT_KEY_TITLE, VLC_PLAYLIST_SORT_ORDER_ASCENDING },
+    };
+
+    ret = vlc_playlist_Sort(playlist, criteria, 1);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_playlist_Count(playlist) == COUNT);
+
+    for (size_t i = 1; i < COUNT; ++i)
+    {
+        size_t a = vlc_playlist_Get(playlist, i - 1)->media->i_duration;
+        size_t b = vlc_playlist_Get(playlist, i)->media->i_duration;
+        /* sorted by title, then by initial position */
+        assert(a / 3 <= b / 3);
+        if (a / 3 == b / 3)
+            assert(initial_pos[a] < initial_pos[b]);
+    }
+
+    DestroyMediaArray(media, COUNT);
+    free(media);
+    free(shuffled);
+    free(initial_pos);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_stable_sort(void)
 {
@@ -2448,6 +2556,7 @@ int main(void)
     test_request_remove_with_matching_hint();
     test_request_remove_without_hint();
     test_request_remove_adapt();
+    test_request_remove_many_slices();
     test_request_move_with_matching_hint();
     test_request_move_without_hint();
     test_request_move_adapt();
@@ -2459,6 +2568,7 @@ int main(void)
     test_shuffle();
     test_sort();
     test_stable_sort();
+    test_sort_large();
     return 0;
 }
 
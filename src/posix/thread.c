@@ -31,6 +31,7 @@
 #include <vlc_common.h>
 
 #include "libvlc.h"
+#include "misc/thread_policy.h"
 #include <stdarg.h>
 #include <stdatomic.h>
 #include <stdnoreturn.h>
@@ -48,6 +49,9 @@
 #ifdef HAVE_EXECINFO_H
 # include <execinfo.h>
 #endif
+#ifdef __EMSCRIPTEN__
+# include <emscripten/threading.h>
+#endif
 #if defined(__SunOS)
 # include <sys/processor.h>
 # include <sys/pset.h>
@@ -182,12 +186,60 @@ static int vlc_clone_attr (vlc_thread_t *th, pthread_attr_t *attr,
     return ret;
 }
 
+struct vlc_thread_start
+{
+    void *(*entry) (void *);
+    void *data;
+    struct vlc_thread_policy *policy;
+};
+
+static void vlc_thread_leave_policy (void *data)
+{
+    VLC_UNUSED(data);
+    vlc_thread_policy_Leave ();
+}
+
+static void *vlc_thread_start (void *opaque)
+{
+    struct vlc_thread_start start = *(struct vlc_thread_start *)opaque;
+    void *ret;
+
+    free (opaque);
+    vlc_thread_policy_Enter (start.policy);
+    pthread_cleanup_push (vlc_thread_leave_policy, NULL);
+    ret = start.entry (start.data);
+    pthread_cleanup_pop (1);
+    return ret;
+}
+
 int vlc_clone (vlc_thread_t *th, void *(*entry) (void *), void *data)
 {
     pthread_attr_t attr;
+    struct vlc_thread_policy *policy = vlc_thread_policy_Get ();
 
     pthread_attr_init (&attr);
-    return vlc_clone_attr (th, &attr, entry, data);
+    if (policy == NULL)
+        return vlc_clone_attr (th, &attr, entry, data);
+
+    /* The new thread follows the policy of its creator, e.g. its input */
+    struct vlc_thread_start *start = malloc (sizeof (*start));
+    if (unlikely(start == NULL))
+    {
+        vlc_thread_policy_Release (policy);
+        pthread_attr_destroy (&attr);
+        return ENOMEM;
+    }
+    start->entry = entry;
+    start->data = data;
+    start->policy = policy;
+
+    int ret = vlc_clone_attr (th, &attr, vlc_thread_start, start);
+    if (ret != 0)
+    {
+        vlc_thread_policy_Release (policy);
+        free (start);
+    }
+    return ret;
 }
 
 void vlc_join(vlc_thread_t th, void **result)
@@ -206,7 +258,7 @@ VLC_WEAK unsigned long vlc_thread_id(void)
 
 VLC_WEAK void (vlc_thread_set_name)(const char *name)
 {
-    VLC_UNUSED(name);
+    vlc_thread_policy_SetName(name);
 }
 
 void vlc_cancel(vlc_thread_t th)
@@ -282,7 +334,13 @@ void vlc_tick_sleep (vlc_tick_t delay)
 
 unsigned vlc_GetCPUCount(void)
 {
-#if defined(HAVE_SCHED_GETAFFINITY)
+#if defined(__EMSCRIPTEN__)
+    /* The affinity of the web workers is not exposed, this is the value of
+     * navigator.hardwareConcurrency. */
+    int count = emscripten_num_logical_cores();
+    return (count > 0) ? (unsigned)count : 1;
+
+#elif defined(HAVE_SCHED_GETAFFINITY)
     cpu_set_t cpu;
 
     CPU_ZERO(&cpu);
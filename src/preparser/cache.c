@@ -0,0 +1,323 @@
+/*****************************************************************************
+ * cache.c: persistent cache of preparsing results
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/stat.h>
+#include <inttypes.h>
+
+#include <vlc_common.h>
+#include <vlc_cachefile.h>
+#include <vlc_input_item.h>
+#include <vlc_meta.h>
+#include <vlc_es.h>
+#include <vlc_fs.h>
+#include <vlc_strings.h>
+#include <vlc_url.h>
+
+#include "input/item.h"
+#include "cache.h"
+
+/*
+ * One file per item, named after the MD5 of its URI, in the "preparse"
+ * sub-directory of the user cache directory. The file is a list of lines:
+ *
+ *   vlc-preparse <version> <file size> <file mtime>
+ *   duration <ticks>
+ *   meta <type> <base64 value>
+ *   es <cat> <codec> <original fourcc> <id> <group> <bitrate> <profile>
+ *      <level> <9 category specific values> <base64 language> <base64 desc>
+ *
+ * Missing strings are written as "-".
+ */
+#define CACHE_VERSION 1
+#define CACHE_ES_PARAMS 9
+
+/* Size limit of the cache directory */
+#define CACHE_MAX_SIZE (16 << 20)
+
+/* Returns the URI of the item if it is a local file, and its status */
+static char *CacheGetURI( input_item_t *item, struct stat *st )
+{
+    char *uri = input_item_GetURI( item );
+    if( uri == NULL )
+        return NULL;
+
+    /* Only local files have a reliable identity (size and mtime) */
+    char *path = vlc_uri2path( uri );
+    if( path == NULL || vlc_stat( path, st ) || !S_ISREG( st->st_mode ) )
+    {
+        free( path );
+        free( uri );
+        return NULL;
+    }
+    free( path );
+    return uri;
+}
+
+static void WriteString( FILE *file, const char *str )
+{
+    char *b64 = str != NULL && *str ? vlc_b64_encode( str ) : NULL;
+    fprintf( file, " %s", b64 != NULL ? b64 : "-" );
+    free( b64 );
+}
+
+static char *ReadString( const char *str )
+{
+    return strcmp( str, "-" ) ? vlc_b64_decode( str ) : NULL;
+}
+
+/* Split the next space-separated token in place */
+static char *NextToken( char **str )
+{
+    char *token = *str + strspn( *str, " \n" );
+    if( *token == '\0' )
+        return NULL;
+
+    size_t len = strcspn( token, " \n" );
+    *str = token + len;
+    if( **str != '\0' )
+        *(*str)++ = '\0';
+    return token;
+}
+
+static void WriteEs( FILE *file, const es_format_t *fmt )
+{
+    unsigned params[CACHE_ES_PARAMS] = { 0 };
+
+    switch( fmt->i_cat )
+    {
+        case VIDEO_ES:
+            params[0] = fmt->video.i_width;
+            params[1] = fmt->video.i_height;
+            params[2] = fmt->video.i_visible_width;
+            params[3] = fmt->video.i_visible_height;
+            params[4] = fmt->video.i_frame_rate;
+            params[5] = fmt->video.i_frame_rate_base;
+            params[6] = fmt->video.i_sar_num;
+            params[7] = fmt->video.i_sar_den;
+            params[8] = fmt->video.orientation;
+            break;
+        case AUDIO_ES:
+            params[0] = fmt->audio.i_channels;
+            params[1] = fmt->audio.i_rate;
+            params[2] = fmt->audio.i_physical_channels;
+            params[3] = fmt->audio.i_bitspersample;
+            break;
+        default:
+            break;
+    }
+
+    fprintf( file, "es %d %"PRIu32" %"PRIu32" %d %d %u %d %d",
+             fmt->i_cat, fmt->i_codec, fmt->i_original_fourcc, fmt->i_id,
+             fmt->i_group, fmt->i_bitrate, fmt->i_profile, fmt->i_level );
+    for( int i = 0; i < CACHE_ES_PARAMS; i++ )
+        fprintf( file, " %u", params[i] );
+    WriteString( file, fmt->psz_language );
+    WriteString( file, fmt->psz_description );
+    fputc( '\n', file );
+}
+
+static es_format_t *ReadEs( char *line )
+{
+    int cat, id, group, profile, level, end;
+    uint32_t codec, ofourcc;
+    unsigned bitrate, p[CACHE_ES_PARAMS];
+
+    if( sscanf( line, "es %d %"SCNu32" %"SCNu32" %d %d %u %d %d "
+                "%u %u %u %u %u %u %u %u %u%n",
+                &cat, &codec, &ofourcc, &id, &group, &bitrate, &profile,
+                &level, &p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6],
+                &p[7], &p[8], &end ) != 17 )
+        return NULL;
+    if( cat <= UNKNOWN_ES || cat > DATA_ES )
+        return NULL;
+
+    char *strings = line + end;
+    char *lang = NextToken( &strings );
+    char *desc = NextToken( &strings );
+    if( lang == NULL || desc == NULL )
+        return NULL;
+
+    es_format_t *fmt = malloc( sizeof( *fmt ) );
+    if( fmt == NULL )
+        return NULL;
+
+    es_format_Init( fmt, cat, codec );
+    fmt->i_original_fourcc = ofourcc;
+    fmt->i_id = id;
+    fmt->i_group = group;
+    fmt->i_bitrate = bitrate;
+    fmt->i_profile = profile;
+    fmt->i_level = level;
+
+    switch( cat )
+    {
+        case VIDEO_ES:
+            fmt->video.i_width = p[0];
+            fmt->video.i_height = p[1];
+            fmt->video.i_visible_width = p[2];
+            fmt->video.i_visible_height = p[3];
+            fmt->video.i_frame_rate = p[4];
+            fmt->video.i_frame_rate_base = p[5];
+            fmt->video.i_sar_num = p[6];
+            fmt->video.i_sar_den = p[7];
+            fmt->video.orientation = p[8] <= ORIENT_MAX ? p[8] : ORIENT_NORMAL;
+            break;
+        case AUDIO_ES:
+            fmt->audio.i_channels = p[0];
+            fmt->audio.i_rate = p[1];
+            fmt->audio.i_physical_channels = p[2];
+            fmt->audio.i_bitspersample = p[3];
+            break;
+        default:
+            break;
+    }
+
+    fmt->psz_language = ReadString( lang );
+    fmt->psz_description = ReadString( desc );
+    return fmt;
+}
+
+int input_preparser_cache_Load( vlc_object_t *obj, input_item_t *item )
+{
+    struct stat st;
+    char *uri = CacheGetURI( item, &st );
+    if( uri == NULL )
+        return VLC_EGENERIC;
+
+    FILE *file = vlc_cachefile_Open( "preparse", uri );
+    free( uri );
+    if( file == NULL )
+        return VLC_EGENERIC;
+
+    char *line = NULL;
+    size_t linesize = 0;
+    int ret = VLC_EGENERIC;
+
+    vlc_tick_t duration = INPUT_DURATION_UNSET;
+    char *metas[VLC_META_TYPE_COUNT] = { NULL };
+    es_format_t **es = NULL;
+    int i_es = 0;
+
+    /* Header: the entry is stale if the file changed */
+    unsigned version;
+    uintmax_t size;
+    intmax_t mtime;
+    if( getline( &line, &linesize, file ) == -1
+     || sscanf( line, "vlc-preparse %u %ju %jd", &version, &size,
+                &mtime ) != 3
+     || version != CACHE_VERSION
+     || size != (uintmax_t) st.st_size || mtime != (intmax_t) st.st_mtime )
+        goto end;
+
+    while( getline( &line, &linesize, file ) != -1 )
+    {
+        int type, end;
+        int64_t ticks;
+
+        if( sscanf( line, "duration %"SCNd64, &ticks ) == 1 )
+            duration = ticks;
+        else
+        if( sscanf( line, "meta %d%n", &type, &end ) == 1 )
+        {
+            char *values = line + end;
+            char *value = NextToken( &values );
+            if( type < 0 || type >= VLC_META_TYPE_COUNT || value == NULL )
+                goto end;
+            free( metas[type] );
+            metas[type] = ReadString( value );
+        }
+        else
+        if( !strncmp( line, "es ", 3 ) )
+        {
+            es_format_t *fmt = ReadEs( line );
+            if( fmt == NULL )
+                goto end;
+            TAB_APPEND( i_es, es, fmt );
+        }
+        else
+            goto end;
+    }
+
+    /* The whole entry is valid: apply it */
+    if( duration != INPUT_DURATION_UNSET )
+        input_item_SetDuration( item, duration );
+    for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
+        if( metas[i] != NULL )
+            input_item_SetMeta( item, i, metas[i] );
+    for( int i = 0; i < i_es; i++ )
+        input_item_UpdateTracksInfo( item, es[i] );
+
+    msg_Dbg( obj, "preparsing results of %s restored from the cache",
+             item->psz_uri );
+    ret = VLC_SUCCESS;
+
+end:
+    for( int i = 0; i < i_es; i++ )
+    {
+        es_format_Clean( es[i] );
+        free( es[i] );
+    }
+    TAB_CLEAN( i_es, es );
+    for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
+        free( metas[i] );
+    free( line );
+    fclose( file );
+    return ret;
+}
+
+void input_preparser_cache_Store( vlc_object_t *obj, input_item_t *item )
+{
+    struct stat st;
+    char *uri = CacheGetURI( item, &st );
+    if( uri == NULL )
+        return;
+
+    vlc_cachefile_t *entry = vlc_cachefile_Create( obj, "preparse", uri );
+    free( uri );
+    if( entry == NULL )
+        return;
+
+    FILE *file = vlc_cachefile_GetFile( entry );
+    fprintf( file, "vlc-preparse %u %ju %jd\n", CACHE_VERSION,
+             (uintmax_t) st.st_size, (intmax_t) st.st_mtime );
+
+    vlc_mutex_lock( &item->lock );
+    if( item->i_duration != INPUT_DURATION_UNSET )
+        fprintf( file, "duration %"PRId64"\n", item->i_duration );
+    if( item->p_meta != NULL )
+        for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
+        {
+            const char *value = vlc_meta_Get( item->p_meta, i );
+            if( value == NULL || !*value )
+                continue;
+            fprintf( file, "meta %d", i );
+            WriteString( file, value );
+            fputc( '\n', file );
+        }
+    for( int i = 0; i < item->i_es; i++ )
+        WriteEs( file, item->es[i] );
+    vlc_mutex_unlock( &item->lock );
+
+    vlc_cachefile_Commit( entry, CACHE_MAX_SIZE );
+}
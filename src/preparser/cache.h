@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * cache.h: persistent cache of preparsing results
+ *****************************************************************************
+ * Copyright (C) 2024 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef _INPUT_PREPARSER_CACHE_H
+#define _INPUT_PREPARSER_CACHE_H 1
+
+#include <vlc_input_item.h>
+
+/**
+ * Restore the preparsing results of a local file item
+ *
+ * The entry is only used if the size and modification time of the file did
+ * not change since it was stored. No access module is opened.
+ *
+ * @return VLC_SUCCESS if the item was filled from the cache
+ */
+int input_preparser_cache_Load( vlc_object_t *, input_item_t * );
+
+/**
+ * Store the preparsing results (duration, meta and tracks) of a local file
+ * item
+ */
+void input_preparser_cache_Store( vlc_object_t *, input_item_t * );
+
+#endif
@@ -32,6 +32,7 @@
 #include <vlc_memstream.h>
 #include <vlc_meta_fetcher.h>
 #include <vlc_executor.h>
+#include <vlc_vector.h>
 
 #include "art.h"
 #include "libvlc.h"
@@ -45,6 +46,8 @@ struct input_fetcher_t {
     vlc_executor_t *executor_downloader;
 
     vlc_dictionary_t album_cache;
+    vlc_dictionary_t album_lookups; /**< pending network lookups, by album */
+    vlc_dictionary_t album_misses; /**< albums without art, by album */
     vlc_object_t* owner;
 
     vlc_mutex_t lock;
@@ -58,6 +61,7 @@ struct task {
     int options;
     const input_fetcher_callbacks_t *cbs;
     void *userdata;
+    char *album_key; /**< set if the task resolves a pending album lookup */
 
     vlc_interrupt_t interrupt;
 
@@ -65,6 +69,14 @@ struct task {
     struct vlc_list node; /**< node of input_fetcher_t.submitted_tasks */
 };
 
+/* Tasks waiting for the network lookup of the same album */
+struct album_lookup {
+    struct VLC_VECTOR(struct task *) waiters;
+};
+
+/* Delay before looking up again an album without art */
+#define FETCHER_MISS_TTL VLC_TICK_FROM_SEC(600)
+
 static void RunDownloader(void *);
 static void RunSearchLocal(void *);
 static void RunSearchNetwork(void *);
@@ -84,6 +96,7 @@ TaskNew(input_fetcher_t *fetcher, vlc_executor_t *executor, input_item_t *item,
     task->options = options;
     task->cbs = cbs;
     task->userdata = userdata;
+    task->album_key = NULL;
 
     vlc_interrupt_init(&task->interrupt);
 
@@ -109,6 +122,7 @@ TaskDelete(struct task *task)
 {
     input_item_Release(task->item);
     vlc_interrupt_deinit(&task->interrupt);
+    free(task->album_key);
     free(task);
 }
 
@@ -131,13 +145,16 @@ FetcherRemoveTask(input_fetcher_t *fetcher, struct task *task)
 static int
 Submit(input_fetcher_t *fetcher, vlc_executor_t *executor, input_item_t *item,
        input_item_meta_request_option_t options,
-       const input_fetcher_callbacks_t *cbs, void *userdata)
+       const input_fetcher_callbacks_t *cbs, void *userdata, char *album_key)
 {
     struct task *task =
         TaskNew(fetcher, executor, item, options, cbs, userdata);
     if (!task)
         return VLC_ENOMEM;
 
+    /* the new task takes over the pending album lookup, if any */
+    task->album_key = album_key;
+
     FetcherAddTask(fetcher, task);
     vlc_executor_Submit(task->executor, &task->runnable);
 
@@ -219,6 +236,120 @@ static void AddAlbumCache( input_fetcher_t* fetcher, input_item_t* item,
     free( key );
 }
 
+static void NotifyArtFetchEnded(struct task *task, bool fetched)
+{
+    if (task->cbs && task->cbs->on_art_fetch_ended)
+        task->cbs->on_art_fetch_ended(task->item, fetched, task->userdata);
+}
+
+enum album_lookup_status
+{
+    ALBUM_LOOKUP_RUN, /**< the task must search by itself */
+    ALBUM_LOOKUP_PARKED, /**< the task waits for another lookup */
+    ALBUM_LOOKUP_MISS, /**< the album is known to have no art */
+};
+
+static enum album_lookup_status
+AlbumLookupBegin( input_fetcher_t *fetcher, struct task *task )
+{
+    char *key = CreateCacheKey( task->item );
+    if( key == NULL )
+        return ALBUM_LOOKUP_RUN;
+
+    enum album_lookup_status status = ALBUM_LOOKUP_RUN;
+
+    vlc_mutex_lock( &fetcher->lock );
+    vlc_tick_t *deadline = vlc_dictionary_value_for_key( &fetcher->album_misses,
+                                                         key );
+    if( deadline != NULL && *deadline > vlc_tick_now() )
+        status = ALBUM_LOOKUP_MISS;
+    else
+    {
+        if( deadline != NULL )
+            vlc_dictionary_remove_value_for_key( &fetcher->album_misses, key,
+                                                 FreeCacheEntry, NULL );
+
+        struct album_lookup *lookup =
+            vlc_dictionary_value_for_key( &fetcher->album_lookups, key );
+        if( lookup != NULL )
+        {
+            if( vlc_vector_push( &lookup->waiters, task ) )
+                status = ALBUM_LOOKUP_PARKED;
+        }
+        else
+        {
+            lookup = malloc( sizeof( *lookup ) );
+            if( lookup != NULL )
+            {
+                vlc_vector_init( &lookup->waiters );
+                vlc_dictionary_insert( &fetcher->album_lookups, key, lookup );
+                task->album_key = key;
+                key = NULL;
+            }
+        }
+    }
+    vlc_mutex_unlock( &fetcher->lock );
+
+    free( key );
+    return status;
+}
+
+static void AlbumLookupMiss( input_fetcher_t *fetcher, const char *key )
+{
+    vlc_tick_t *deadline = malloc( sizeof( *deadline ) );
+    if( unlikely( deadline == NULL ) )
+        return;
+    *deadline = vlc_tick_now() + FETCHER_MISS_TTL;
+
+    vlc_mutex_lock( &fetcher->lock );
+    vlc_dictionary_remove_value_for_key( &fetcher->album_misses, key,
+                                         FreeCacheEntry, NULL );
+    vlc_dictionary_insert( &fetcher->album_misses, key, deadline );
+    vlc_mutex_unlock( &fetcher->lock );
+}
+
+/**
+ * Completes the tasks waiting for the lookup owned by the given task.
+ *
+ * Once the art has been fetched, the waiters only need a pass through the
+ * downloader, which picks the art from the album cache.
+ */
+static void AlbumLookupEnd( input_fetcher_t *fetcher, struct task *task,
+                            bool found )
+{
+    char *key = task->album_key;
+    if( key == NULL )
+        return;
+    task->album_key = NULL;
+
+    vlc_mutex_lock( &fetcher->lock );
+    struct album_lookup *lookup =
+        vlc_dictionary_value_for_key( &fetcher->album_lookups, key );
+    vlc_dictionary_remove_value_for_key( &fetcher->album_lookups, key,
+                                         NULL, NULL );
+    vlc_mutex_unlock( &fetcher->lock );
+    free( key );
+
+    assert( lookup != NULL );
+
+    struct task *waiter;
+    vlc_vector_foreach( waiter, &lookup->waiters )
+    {
+        if( !found ||
+            Submit( fetcher, fetcher->executor_downloader, waiter->item,
+                    waiter->options, waiter->cbs, waiter->userdata,
+                    NULL ) != VLC_SUCCESS )
+        {
+            input_item_SetArtNotFound( waiter->item, true );
+            NotifyArtFetchEnded( waiter, false );
+        }
+        FetcherRemoveTask( fetcher, waiter );
+        TaskDelete( waiter );
+    }
+    vlc_vector_destroy( &lookup->waiters );
+    free( lookup );
+}
+
 static int InvokeModule( input_fetcher_t* fetcher, input_item_t* item,
                          int scope, char const* type )
 {
@@ -285,20 +416,18 @@ static int SearchByScope(struct task *task, int scope)
     {
         AddAlbumCache( fetcher, task->item, false );
         int ret = Submit(fetcher, fetcher->executor_downloader, item,
-                         task->options, task->cbs, task->userdata);
+                         task->options, task->cbs, task->userdata,
+                         task->album_key);
         if (ret == VLC_SUCCESS)
+        {
+            task->album_key = NULL;
             return VLC_SUCCESS;
+        }
     }
 
     return VLC_EGENERIC;
 }
 
-static void NotifyArtFetchEnded(struct task *task, bool fetched)
-{
-    if (task->cbs && task->cbs->on_art_fetch_ended)
-        task->cbs->on_art_fetch_ended(task->item, fetched, task->userdata);
-}
-
 static void RunDownloader(void *userdata)
 {
     vlc_thread_set_name("vlc-run-fetcher");
@@ -366,6 +495,7 @@ out:
 
     free( psz_arturl );
     NotifyArtFetchEnded(task, psz_arturl != NULL);
+    AlbumLookupEnd(fetcher, task, psz_arturl != NULL);
     FetcherRemoveTask(fetcher, task);
     TaskDelete(task);
     return;
@@ -375,6 +505,9 @@ error:
 
     FREENULL( psz_arturl );
     NotifyArtFetchEnded(task, false);
+    if (task->album_key)
+        AlbumLookupMiss(fetcher, task->album_key);
+    AlbumLookupEnd(fetcher, task, false);
     FetcherRemoveTask(fetcher, task);
     TaskDelete(task);
 }
@@ -395,7 +528,7 @@ static void RunSearchLocal(void *userdata)
         task->options & META_REQUEST_OPTION_FETCH_NETWORK )
     {
         int ret = Submit(fetcher, fetcher->executor_network, task->item,
-                         task->options, task->cbs, task->userdata);
+                         task->options, task->cbs, task->userdata, NULL);
         if (ret != VLC_SUCCESS)
             NotifyArtFetchEnded(task, false);
     }
@@ -417,6 +550,20 @@ static void RunSearchNetwork(void *userdata)
     vlc_thread_set_name("vlc-run-searchn");
 
     struct task *task = userdata;
+    input_fetcher_t *fetcher = task->fetcher;
+
+    /* Tracks of the same album share a single lookup */
+    switch( AlbumLookupBegin( fetcher, task ) )
+    {
+        case ALBUM_LOOKUP_PARKED:
+            return; /* completed along with the pending lookup */
+        case ALBUM_LOOKUP_MISS:
+            input_item_SetArtNotFound( task->item, true );
+            NotifyArtFetchEnded(task, false);
+            goto end;
+        case ALBUM_LOOKUP_RUN:
+            break;
+    }
 
     vlc_interrupt_set(&task->interrupt);
 
@@ -424,11 +571,14 @@ static void RunSearchNetwork(void *userdata)
     {
         input_item_SetArtNotFound( task->item, true );
         NotifyArtFetchEnded(task, false);
+        if( task->album_key )
+            AlbumLookupMiss( fetcher, task->album_key );
+        AlbumLookupEnd( fetcher, task, false );
     }
 
     vlc_interrupt_set(NULL);
 
-    input_fetcher_t *fetcher = task->fetcher;
+end:
     FetcherRemoveTask(fetcher, task);
     TaskDelete(task);
 }
@@ -474,6 +624,8 @@ input_fetcher_t* input_fetcher_New( vlc_object_t* owner )
     vlc_list_init(&fetcher->submitted_tasks);
 
     vlc_dictionary_init( &fetcher->album_cache, 0 );
+    vlc_dictionary_init( &fetcher->album_lookups, 0 );
+    vlc_dictionary_init( &fetcher->album_misses, 0 );
 
     return fetcher;
 }
@@ -488,12 +640,15 @@ int input_fetcher_Push(input_fetcher_t* fetcher, input_item_t* item,
                              ? fetcher->executor_local
                              : fetcher->executor_network;
 
-    return Submit(fetcher, executor, item, options, cbs, cbs_userdata);
+    return Submit(fetcher, executor, item, options, cbs, cbs_userdata, NULL);
 }
 
 static void
 CancelAllTasks(input_fetcher_t *fetcher)
 {
+    struct vlc_list canceled_tasks;
+    vlc_list_init(&canceled_tasks);
+
     vlc_mutex_lock(&fetcher->lock);
 
     struct task *task;
@@ -502,14 +657,22 @@ CancelAllTasks(input_fetcher_t *fetcher)
         bool canceled = vlc_executor_Cancel(task->executor, &task->runnable);
         if (canceled)
         {
-            NotifyArtFetchEnded(task, false);
             vlc_list_remove(&task->node);
-            TaskDelete(task);
+            vlc_list_append(&task->node, &canceled_tasks);
         }
-        /* Otherwise, the task will be finished and destroyed after run() */
+        /* Otherwise, the task will be finished and destroyed after run(), or
+         * along with the album lookup it is waiting for */
     }
 
     vlc_mutex_unlock(&fetcher->lock);
+
+    vlc_list_foreach(task, &canceled_tasks, node)
+    {
+        NotifyArtFetchEnded(task, false);
+        /* the tasks waiting for the same album are canceled too */
+        AlbumLookupEnd(fetcher, task, false);
+        TaskDelete(task);
+    }
 }
 
 void input_fetcher_Delete( input_fetcher_t* fetcher )
@@ -521,5 +684,8 @@ void input_fetcher_Delete( input_fetcher_t* fetcher )
     vlc_executor_Delete(fetcher->executor_downloader);
 
     vlc_dictionary_clear( &fetcher->album_cache, FreeCacheEntry, NULL );
+    assert( vlc_dictionary_keys_count( &fetcher->album_lookups ) == 0 );
+    vlc_dictionary_clear( &fetcher->album_lookups, NULL, NULL );
+    vlc_dictionary_clear( &fetcher->album_misses, FreeCacheEntry, NULL );
     free( fetcher );
 }
@@ -30,22 +30,36 @@
 #include "input/input_internal.h"
 #include "preparser.h"
 #include "fetcher.h"
+#include "cache.h"
 
 struct input_preparser_t
 {
     vlc_object_t* owner;
     input_fetcher_t* fetcher;
-    vlc_executor_t *executor;
+    vlc_executor_t *executor_local;
+    vlc_executor_t *executor_network;
     vlc_tick_t default_timeout;
+    bool use_cache;
     atomic_bool deactivated;
 
     vlc_mutex_t lock;
     struct vlc_list submitted_tasks; /**< list of struct task */
+
+    /* Throughput of the current batch, i.e. since the queue was last empty
+     * (protected by lock) */
+    struct
+    {
+        unsigned pending; /**< submitted but not finished */
+        unsigned max_pending;
+        unsigned done;
+        vlc_tick_t start;
+    } stats;
 };
 
 struct task
 {
     input_preparser_t *preparser;
+    vlc_executor_t *executor;
     input_item_t *item;
     input_item_meta_request_option_t options;
     const input_preparser_callbacks_t *cbs;
@@ -59,6 +73,7 @@ struct task
     vlc_sem_t fetch_ended;
     atomic_int preparse_status;
     atomic_bool interrupted;
+    bool has_subtree;
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
@@ -68,8 +83,8 @@ struct task
 static void RunnableRun(void *);
 
 static struct task *
-TaskNew(input_preparser_t *preparser, input_item_t *item,
-        input_item_meta_request_option_t options,
+TaskNew(input_preparser_t *preparser, vlc_executor_t *executor,
+        input_item_t *item, input_item_meta_request_option_t options,
         const input_preparser_callbacks_t *cbs, void *userdata,
         void *id, vlc_tick_t timeout)
 {
@@ -80,6 +95,7 @@ TaskNew(input_preparser_t *preparser, input_item_t *item,
         return NULL;
 
     task->preparser = preparser;
+    task->executor = executor;
     task->item = item;
     task->options = options;
     task->cbs = cbs;
@@ -94,6 +110,7 @@ TaskNew(input_preparser_t *preparser, input_item_t *item,
     vlc_sem_init(&task->fetch_ended, 0);
     atomic_init(&task->preparse_status, ITEM_PREPARSE_SKIPPED);
     atomic_init(&task->interrupted, false);
+    task->has_subtree = false;
 
     task->runnable.run = RunnableRun;
     task->runnable.userdata = task;
@@ -113,14 +130,46 @@ PreparserAddTask(input_preparser_t *preparser, struct task *task)
 {
     vlc_mutex_lock(&preparser->lock);
     vlc_list_append(&task->node, &preparser->submitted_tasks);
+
+    if (preparser->stats.pending == 0)
+    {
+        preparser->stats.start = vlc_tick_now();
+        preparser->stats.done = 0;
+        preparser->stats.max_pending = 0;
+    }
+    if (++preparser->stats.pending > preparser->stats.max_pending)
+        preparser->stats.max_pending = preparser->stats.pending;
     vlc_mutex_unlock(&preparser->lock);
 }
 
+static void
+PreparserUnlinkTask(input_preparser_t *preparser, struct task *task,
+                    bool done)
+{
+    vlc_mutex_assert(&preparser->lock);
+    vlc_list_remove(&task->node);
+
+    assert(preparser->stats.pending > 0);
+    preparser->stats.pending--;
+    if (done)
+        preparser->stats.done++;
+
+    if (preparser->stats.pending == 0 && preparser->stats.done > 1)
+    {
+        vlc_tick_t elapsed = vlc_tick_now() - preparser->stats.start;
+        double secs = secf_from_vlc_tick(elapsed);
+        msg_Dbg(preparser->owner, "preparsed %u items in %.3f s "
+                "(%.1f items/s, max queue depth: %u)", preparser->stats.done,
+                secs, secs > 0. ? preparser->stats.done / secs : 0.,
+                preparser->stats.max_pending);
+    }
+}
+
 static void
 PreparserRemoveTask(input_preparser_t *preparser, struct task *task)
 {
     vlc_mutex_lock(&preparser->lock);
-    vlc_list_remove(&task->node);
+    PreparserUnlinkTask(preparser, task, true);
     vlc_mutex_unlock(&preparser->lock);
 }
 
@@ -161,6 +210,7 @@ OnParserSubtreeAdded(input_item_t *item, input_item_node_t *subtree,
     VLC_UNUSED(item);
     struct task *task = task_;
 
+    task->has_subtree = true;
     if (task->cbs && task->cbs->on_subtree_added)
         task->cbs->on_subtree_added(task->item, subtree, task->userdata);
 }
@@ -226,8 +276,12 @@ Fetch(struct task *task)
     if (ret != VLC_SUCCESS)
         return;
 
-    /* Wait until the end of fetching (fetching is not interruptible) */
+    /* Wait until the end of fetching (fetching is not interruptible). The
+     * fetcher runs on its own executors: let another item be parsed
+     * meanwhile. */
+    vlc_executor_BeginIO();
     vlc_sem_wait(&task->fetch_ended);
+    vlc_executor_EndIO();
 }
 
 static void
@@ -243,7 +297,21 @@ RunnableRun(void *userdata)
     if (atomic_load(&task->interrupted))
         goto end;
 
-    Parse(task, deadline);
+    input_preparser_t *preparser = task->preparser;
+    if (preparser->use_cache
+     && input_preparser_cache_Load(preparser->owner, task->item) == VLC_SUCCESS)
+        atomic_store_explicit(&task->preparse_status, ITEM_PREPARSE_DONE,
+                              memory_order_relaxed);
+    else
+    {
+        Parse(task, deadline);
+
+        /* Items with sub-items (playlists, directories) are not cached */
+        if (preparser->use_cache && !task->has_subtree
+         && atomic_load_explicit(&task->preparse_status,
+                                 memory_order_relaxed) == ITEM_PREPARSE_DONE)
+            input_preparser_cache_Store(preparser->owner, task->item);
+    }
 
     if (atomic_load(&task->interrupted))
         goto end;
@@ -257,8 +325,7 @@ RunnableRun(void *userdata)
 
 end:
     NotifyPreparseEnded(task);
-    input_preparser_t *preparser = task->preparser;
-    PreparserRemoveTask(preparser, task);
+    PreparserRemoveTask(task->preparser, task);
     TaskDelete(task);
 }
 
@@ -283,9 +350,23 @@ input_preparser_t* input_preparser_New( vlc_object_t *parent )
     if (max_threads < 1)
         max_threads = 1;
 
-    preparser->executor = vlc_executor_New(max_threads);
-    if (!preparser->executor)
+    preparser->executor_local = vlc_executor_New(max_threads);
+    if (!preparser->executor_local)
+    {
+        free(preparser);
+        return NULL;
+    }
+
+    /* Network items mostly wait for the server: preparse more of them in
+     * parallel, without delaying the local ones */
+    max_threads = var_InheritInteger(parent, "preparse-network-threads");
+    if (max_threads < 1)
+        max_threads = 1;
+
+    preparser->executor_network = vlc_executor_New(max_threads);
+    if (!preparser->executor_network)
     {
+        vlc_executor_Delete(preparser->executor_local);
         free(preparser);
         return NULL;
     }
@@ -295,12 +376,17 @@ input_preparser_t* input_preparser_New( vlc_object_t *parent )
     if (preparser->default_timeout < 0)
         preparser->default_timeout = 0;
 
+    preparser->use_cache = var_InheritBool(parent, "preparse-cache");
     preparser->owner = parent;
     preparser->fetcher = input_fetcher_New( parent );
     atomic_init( &preparser->deactivated, false );
 
     vlc_mutex_init(&preparser->lock);
     vlc_list_init(&preparser->submitted_tasks);
+    preparser->stats.pending = 0;
+    preparser->stats.max_pending = 0;
+    preparser->stats.done = 0;
+    preparser->stats.start = VLC_TICK_INVALID;
 
     if( unlikely( !preparser->fetcher ) )
         msg_Warn( parent, "unable to create art fetcher" );
@@ -343,14 +429,21 @@ int input_preparser_Push( input_preparser_t *preparser,
 
     vlc_tick_t timeout = timeout_ms == -1 ? preparser->default_timeout
                                           : VLC_TICK_FROM_MS(timeout_ms);
-    struct task *task =
-        TaskNew(preparser, item, i_options, cbs, cbs_userdata, id, timeout);
+    vlc_executor_t *executor = b_net ? preparser->executor_network
+                                     : preparser->executor_local;
+    struct task *task = TaskNew(preparser, executor, item, i_options, cbs,
+                                cbs_userdata, id, timeout);
     if( !task )
         return VLC_ENOMEM;
 
     PreparserAddTask(preparser, task);
 
-    vlc_executor_Submit(preparser->executor, &task->runnable);
+    /* Requests allowed to interact come from the user: serve them before the
+     * background ones */
+    enum vlc_executor_priority priority =
+        i_options & META_REQUEST_OPTION_DO_INTERACT
+            ? VLC_EXECUTOR_PRIORITY_HIGH : VLC_EXECUTOR_PRIORITY_NORMAL;
+    vlc_executor_SubmitWithPriority(executor, &task->runnable, priority);
     return VLC_SUCCESS;
 }
 
@@ -373,11 +466,11 @@ void input_preparser_Cancel( input_preparser_t *preparser, void *id )
         if (!id || task->id == id)
         {
             bool canceled =
-                vlc_executor_Cancel(preparser->executor, &task->runnable);
+                vlc_executor_Cancel(task->executor, &task->runnable);
             if (canceled)
             {
                 NotifyPreparseEnded(task);
-                vlc_list_remove(&task->node);
+                PreparserUnlinkTask(preparser, task, false);
                 TaskDelete(task);
             }
             else
@@ -400,7 +493,8 @@ void input_preparser_Delete( input_preparser_t *preparser )
     /* In case input_preparser_Deactivate() has not been called */
     input_preparser_Cancel(preparser, NULL);
 
-    vlc_executor_Delete(preparser->executor);
+    vlc_executor_Delete(preparser->executor_local);
+    vlc_executor_Delete(preparser->executor_network);
 
     if( preparser->fetcher )
         input_fetcher_Delete( preparser->fetcher );
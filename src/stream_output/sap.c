@@ -59,8 +59,8 @@ typedef struct sap_address_t
 {
     struct vlc_list         node;
 
-    vlc_thread_t            thread;
-    vlc_cond_t              wait;
+    /* Date of the next announcement, sessions are sent in turn */
+    vlc_tick_t              deadline;
 
     char                    group[NI_MAXNUMERICHOST];
     union {
@@ -79,6 +79,12 @@ typedef struct sap_address_t
 static struct vlc_list sap_addrs = VLC_LIST_INITIALIZER(&sap_addrs);
 static vlc_mutex_t sap_mutex = VLC_STATIC_MUTEX;
 
+/* A single thread schedules the announcements of all the addresses */
+static vlc_cond_t sap_wait = VLC_STATIC_COND;
+static vlc_thread_t sap_thread;
+/* Bumped whenever a thread is started, an older one then exits */
+static unsigned sap_generation;
+
 #define SAP_MAX_BUFFER 65534
 #define MIN_INTERVAL 2
 #define MAX_INTERVAL 300
@@ -104,7 +110,7 @@ static sap_address_t *AddressCreate (vlc_object_t *obj, const char *group)
     getsockname(fd, &addr->orig.a, &addr->origlen);
 
     addr->interval = var_CreateGetInteger (obj, "sap-interval");
-    vlc_cond_init (&addr->wait);
+    addr->deadline = vlc_tick_now ();
     addr->session_count = 0;
     vlc_list_init(&addr->sessions);
     return addr;
@@ -118,32 +124,51 @@ static void AddressDestroy (sap_address_t *addr)
 
 /**
  * main SAP handler thread
- * \param p_this the SAP Handler object
+ * \param data the generation of the thread
  * \return nothing
  */
-static void *RunThread (void *self)
+static void *RunThread (void *data)
 {
     vlc_thread_set_name("vlc-sap");
 
-    sap_address_t *addr = self;
+    const unsigned generation = (uintptr_t)data;
 
     vlc_mutex_lock(&sap_mutex);
 
-    while (!vlc_list_is_empty(&addr->sessions))
+    while (generation == sap_generation)
     {
-        session_descriptor_t *p_session;
-        vlc_tick_t deadline = vlc_tick_now();
+        sap_address_t *addr, *next = NULL;
 
-        assert (addr->session_count > 0);
+        /* Earliest address to announce on */
+        vlc_list_foreach (addr, &sap_addrs, node)
+            if (next == NULL || addr->deadline < next->deadline)
+                next = addr;
 
-        vlc_list_foreach (p_session, &addr->sessions, node)
-        {
-            send (addr->fd, p_session->data, p_session->length, 0);
-            deadline += vlc_tick_from_samples(addr->interval, addr->session_count);
+        if (next == NULL)
+            break;
 
-            if (vlc_cond_timedwait(&addr->wait, &sap_mutex, deadline) == 0)
-                break; /* list may have changed! */
+        if (vlc_tick_now() < next->deadline)
+        {
+            vlc_cond_timedwait(&sap_wait, &sap_mutex, next->deadline);
+            continue; /* lists may have changed! */
         }
+
+        session_descriptor_t *p_session =
+            vlc_list_first_entry_or_null(&next->sessions,
+                                         session_descriptor_t, node);
+        assert (p_session != NULL);
+        send (next->fd, p_session->data, p_session->length, 0);
+
+        /* Round robin over the sessions of the address */
+        vlc_list_remove(&p_session->node);
+        vlc_list_append(&p_session->node, &next->sessions);
+
+        next->deadline += vlc_tick_from_samples(next->interval,
+                                                next->session_count);
+        /* Do not burst to catch up after a stall */
+        vlc_tick_t now = vlc_tick_now();
+        if (next->deadline < now)
+            next->deadline = now;
     }
 
     vlc_mutex_unlock(&sap_mutex);
@@ -265,6 +290,8 @@ sout_AnnounceRegisterSDP (vlc_object_t *obj, const char *sdp,
 
     msg_Dbg (obj, "using SAP address: %s", psz_addr);
     vlc_mutex_lock (&sap_mutex);
+    bool idle = vlc_list_is_empty(&sap_addrs);
+
     vlc_list_foreach (sap_addr, &sap_addrs, node)
         if (!strcmp (psz_addr, sap_addr->group))
             goto matched;
@@ -275,8 +302,8 @@ sout_AnnounceRegisterSDP (vlc_object_t *obj, const char *sdp,
         vlc_mutex_unlock(&sap_mutex);
         return NULL;
     }
-matched:
     vlc_list_append(&sap_addr->node, &sap_addrs);
+matched:
 
     session_descriptor_t *session = malloc(sizeof (*session));
     if (unlikely(session == NULL))
@@ -294,7 +321,14 @@ matched:
 #endif
     vlc_memstream_putc(&stream, flags);
     vlc_memstream_putc(&stream, 0x00); /* No authentication length */
-    vlc_memstream_write(&stream, &(uint16_t){ vlc_tick_now() }, 2); /* ID hash */
+    /* ID hash: stable for a given SDP, so that receivers skip the
+     * repetitions, and never zero */
+    uint16_t hash = 0;
+    for (const char *p = sdp; *p; p++)
+        hash = (hash * 31) + (unsigned char)*p;
+    if (hash == 0)
+        hash = 1;
+    vlc_memstream_write(&stream, &hash, 2);
 
     switch (sap_addr->orig.a.sa_family)
     {
@@ -332,13 +366,20 @@ matched:
     session->addr = sap_addr;
     session->data = stream.ptr;
     session->length = stream.length;
-    vlc_list_append(&session->node, &sap_addr->sessions);
+    /* Announce the new session first */
+    vlc_list_prepend(&session->node, &sap_addr->sessions);
+    sap_addr->session_count++;
 
-    if (sap_addr->session_count++ == 0)
+    if (idle)
     {
-        if (vlc_clone(&sap_addr->thread, RunThread, sap_addr))
+        /* The previous thread, if any, is joined by its last user */
+        sap_generation++;
+        if (vlc_clone(&sap_thread, RunThread,
+                      (void *)(uintptr_t)sap_generation))
         {
             msg_Err(obj, "unable to spawn SAP announce thread");
+            vlc_list_remove(&session->node);
+            vlc_list_remove(&sap_addr->node);
             AddressDestroy(sap_addr);
             free(session->data);
             free(session);
@@ -347,7 +388,7 @@ matched:
         }
     }
     else
-        vlc_cond_signal(&sap_addr->wait);
+        vlc_cond_signal(&sap_wait);
 out:
     vlc_mutex_unlock(&sap_mutex);
     return session;
@@ -363,24 +404,29 @@ out:
 void sout_AnnounceUnRegister (vlc_object_t *obj, session_descriptor_t *session)
 {
     sap_address_t *addr = session->addr;
+    vlc_thread_t thread;
+    bool idle = false;
 
     msg_Dbg (obj, "removing SAP session");
     vlc_mutex_lock (&sap_mutex);
     vlc_list_remove(&session->node);
+    addr->session_count--;
 
     if (vlc_list_is_empty(&addr->sessions))
+    {
         /* Last session for this address -> unlink the address */
         vlc_list_remove(&addr->node);
+        AddressDestroy(addr);
 
-    addr->session_count--;
-    vlc_cond_signal(&addr->wait);
+        /* Last address -> the thread exits */
+        idle = vlc_list_is_empty(&sap_addrs);
+        thread = sap_thread;
+    }
+    vlc_cond_signal(&sap_wait);
     vlc_mutex_unlock(&sap_mutex);
 
-    if (vlc_list_is_empty(&addr->sessions))
-    {
-        vlc_join(addr->thread, NULL);
-        AddressDestroy(addr);
-    }
+    if (idle)
+        vlc_join(thread, NULL);
 
     free(session->data);
     free(session);
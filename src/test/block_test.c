@@ -86,11 +86,157 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_block_pooled (void)
+{
+    struct vlc_frame_pool_stats before, after;
+
+    vlc_frame_GetPoolStats (&before);
+
+    block_t *block = block_AllocPooled (188);
+    assert (block != NULL);
+    assert (block->i_buffer == 188);
+    assert (((uintptr_t)block->p_buffer % 32) == 0);
+    memcpy (block->p_buffer, text, sizeof (text));
+    block_Release (block);
+
+    /* Same size class: recycled */
+    block = block_AllocPooled (200);
+    assert (block != NULL);
+    assert (block->i_buffer == 200);
+
+    vlc_frame_GetPoolStats (&after);
+    assert (after.hits > before.hits);
+    assert (after.misses > before.misses);
+
+    block = block_Realloc (block, 100, 200 + 8192);
+    assert (block != NULL);
+    assert (block->i_buffer == 100 + 200 + 8192);
+    block_Release (block);
+
+    /* Too large for the pool */
+    block = block_AllocPooled (1 << 20);
+    assert (block != NULL);
+    assert (block->i_buffer == (1 << 20));
+    block_Release (block);
+}
+
+static void test_block_shared (void)
+{
+    block_t *block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    memcpy (block->p_buffer, text, sizeof (text));
+    block->i_pts = 42;
+
+    block_t *view = block_MakeShared (block);
+    assert (view != NULL);
+    assert (view->i_pts == 42);
+    assert (view->i_buffer == sizeof (text));
+
+    /* The payload is referenced */
+    block_t *share = block_Share (view);
+    assert (share != NULL);
+    assert (share->p_buffer == view->p_buffer);
+    assert (share->i_pts == 42);
+    share->i_pts = 7;
+    assert (view->i_pts == 42);
+
+    /* Prepending does not write to the shared buffer */
+    share = block_Realloc (share, 4, share->i_buffer);
+    assert (share != NULL);
+    assert (share->p_buffer + 4 != view->p_buffer);
+    assert (!memcmp (share->p_buffer + 4, text, sizeof (text)));
+    block_Release (share);
+
+    /* Copy on write while shared */
+    share = block_Share (view);
+    assert (share != NULL);
+    share = block_Writable (share);
+    assert (share != NULL);
+    assert (share->p_buffer != view->p_buffer);
+    assert (!memcmp (share->p_buffer, text, sizeof (text)));
+    block_Release (share);
+
+    /* The last reference gets the payload back */
+    uint8_t *payload = view->p_buffer;
+    view = block_Writable (view);
+    assert (view != NULL);
+    assert (view->p_buffer == payload);
+    assert (view->i_pts == 42);
+    block_Release (view);
+
+    /* Frames not made shareable are duplicated */
+    block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    share = block_Share (block);
+    assert (share != NULL);
+    assert (share->p_buffer != block->p_buffer);
+    assert (block_Writable (block) == block);
+    block_Release (share);
+    block_Release (block);
+}
+
+#define FIFO_BLOCKS 10000
+
+static void *test_fifo_producer (void *data)
+{
+    block_fifo_t *fifo = data;
+
+    for (unsigned i = 0; i < FIFO_BLOCKS; i++)
+    {
+        block_t *block = block_Alloc (i % 7);
+        assert (block != NULL);
+        block->i_dts = i;
+        block_FifoPut (fifo, block);
+    }
+    return NULL;
+}
+
+static void test_fifo_spsc (void)
+{
+    block_fifo_t *fifo = vlc_fifo_NewSPSC ();
+    assert (fifo != NULL);
+
+    block_t *block = block_Alloc (5);
+    assert (block != NULL);
+    block_FifoPut (fifo, block);
+    vlc_fifo_Lock (fifo);
+    assert (!vlc_fifo_IsEmpty (fifo));
+    assert (vlc_fifo_GetCount (fifo) == 1);
+    assert (vlc_fifo_GetBytes (fifo) == 5);
+    vlc_fifo_Unlock (fifo);
+    assert (block_FifoShow (fifo) == block);
+    assert (block_FifoGet (fifo) == block);
+    block_Release (block);
+
+    vlc_thread_t th;
+    int val = vlc_clone (&th, test_fifo_producer, fifo);
+    assert (val == 0);
+
+    for (unsigned i = 0; i < FIFO_BLOCKS; i++)
+    {
+        block = block_FifoGet (fifo);
+        assert (block->i_dts == (vlc_tick_t)i);
+        assert (block->i_buffer == i % 7);
+        block_Release (block);
+    }
+    vlc_join (th, NULL);
+
+    vlc_fifo_Lock (fifo);
+    assert (vlc_fifo_IsEmpty (fifo));
+    assert (vlc_fifo_GetCount (fifo) == 0);
+    assert (vlc_fifo_GetBytes (fifo) == 0);
+    vlc_fifo_Unlock (fifo);
+    block_FifoRelease (fifo);
+}
+
 int main (void)
 {
     test_block_File(false);
     test_block_File(true);
     test_block ();
+    test_block_pooled ();
+    test_block_shared ();
+    test_fifo_spsc ();
     return 0;
 }
 
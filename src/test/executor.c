@@ -271,6 +271,124 @@ static void test_task_chain(void)
         assert(array[i] == 2 * i);
 }
 
+struct order_data
+{
+    vlc_sem_t gate;
+    vlc_mutex_t lock;
+    int order[3];
+    int count;
+};
+
+struct order_task
+{
+    struct order_data *data;
+    int id;
+    struct vlc_runnable runnable;
+};
+
+static void RunGate(void *userdata)
+{
+    struct order_data *data = userdata;
+    vlc_sem_wait(&data->gate);
+}
+
+static void RunRecordOrder(void *userdata)
+{
+    struct order_task *task = userdata;
+    struct order_data *data = task->data;
+
+    vlc_mutex_lock(&data->lock);
+    assert(data->count < 3);
+    data->order[data->count++] = task->id;
+    vlc_mutex_unlock(&data->lock);
+}
+
+static void test_priority(void)
+{
+    vlc_executor_t *executor = vlc_executor_New(1);
+    assert(executor);
+
+    struct order_data data;
+    vlc_sem_init(&data.gate, 0);
+    vlc_mutex_init(&data.lock);
+    data.count = 0;
+
+    /* Occupy the single thread so that the next tasks are queued */
+    struct vlc_runnable gate = {
+        .run = RunGate,
+        .userdata = &data,
+    };
+    vlc_executor_Submit(executor, &gate);
+
+    static const enum vlc_executor_priority priorities[] = {
+        VLC_EXECUTOR_PRIORITY_LOW,
+        VLC_EXECUTOR_PRIORITY_NORMAL,
+        VLC_EXECUTOR_PRIORITY_HIGH,
+    };
+
+    struct order_task tasks[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        tasks[i].data = &data;
+        tasks[i].id = priorities[i];
+        tasks[i].runnable.run = RunRecordOrder;
+        tasks[i].runnable.userdata = &tasks[i];
+        vlc_executor_SubmitWithPriority(executor, &tasks[i].runnable,
+                                        priorities[i]);
+    }
+
+    vlc_sem_post(&data.gate);
+    vlc_executor_WaitIdle(executor);
+    vlc_executor_Delete(executor);
+
+    /* The queued tasks must have been run by decreasing priority */
+    assert(data.count == 3);
+    assert(data.order[0] == VLC_EXECUTOR_PRIORITY_HIGH);
+    assert(data.order[1] == VLC_EXECUTOR_PRIORITY_NORMAL);
+    assert(data.order[2] == VLC_EXECUTOR_PRIORITY_LOW);
+}
+
+static void RunWaitIO(void *userdata)
+{
+    vlc_sem_t *sem = userdata;
+
+    vlc_executor_BeginIO();
+    vlc_sem_wait(sem);
+    vlc_executor_EndIO();
+}
+
+static void RunPost(void *userdata)
+{
+    vlc_sem_t *sem = userdata;
+    vlc_sem_post(sem);
+}
+
+static void test_blocking_io(void)
+{
+    vlc_executor_t *executor = vlc_executor_New(1);
+    assert(executor);
+
+    vlc_sem_t sem;
+    vlc_sem_init(&sem, 0);
+
+    /* The first task waits for the second one: this only completes if the
+     * blocked task does not prevent the second one from running */
+    struct vlc_runnable waiter = {
+        .run = RunWaitIO,
+        .userdata = &sem,
+    };
+    struct vlc_runnable poster = {
+        .run = RunPost,
+        .userdata = &sem,
+    };
+
+    vlc_executor_Submit(executor, &waiter);
+    vlc_executor_Submit(executor, &poster);
+
+    vlc_executor_WaitIdle(executor);
+    vlc_executor_Delete(executor);
+}
+
 int main(void)
 {
     test_single_runnable();
@@ -278,5 +396,7 @@ int main(void)
     test_blocking_delete();
     test_cancel();
     test_task_chain();
+    test_priority();
+    test_blocking_io();
     return 0;
 }
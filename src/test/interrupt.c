@@ -87,6 +87,8 @@ static void test_context_simple(vlc_interrupt_t *ctx)
     vlc_interrupt_raise(ctx);
     assert(vlc_poll_i11e(NULL, 0, 1000000000) == -1);
     assert(errno == EINTR);
+    /* The interruption must not leak into the next wait */
+    assert(vlc_poll_i11e(NULL, 0, 1) == 0);
 
     c = 12;
     assert(vlc_write_i11e(fds[0], &c, 1) == 1);
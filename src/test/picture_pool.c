@@ -108,6 +108,59 @@ static void test(bool zombie)
             picture_Release(pics[i]);
 }
 
+static void test_resize(void)
+{
+    picture_t *pics[PICTURES];
+
+    pool = picture_pool_NewFromFormat(&fmt, PICTURES / 2);
+    assert(pool != NULL);
+
+    for (unsigned i = 0; i < PICTURES / 2; i++) {
+        pics[i] = picture_pool_Get(pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(pool) == NULL);
+
+    assert(picture_pool_Resize(pool, PICTURES) == VLC_SUCCESS);
+    for (unsigned i = PICTURES / 2; i < PICTURES; i++) {
+        pics[i] = picture_pool_Get(pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(pool) == NULL);
+
+    /* The pictures in use beyond the new size are not returned */
+    assert(picture_pool_Resize(pool, 2) == VLC_SUCCESS);
+    for (unsigned i = 0; i < PICTURES; i++)
+        picture_Release(pics[i]);
+    for (unsigned i = 0; i < 2; i++) {
+        pics[i] = picture_pool_Get(pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(pool) == NULL);
+
+    /* Retired pictures in use return to service */
+    assert(picture_pool_Resize(pool, 1) == VLC_SUCCESS);
+    assert(picture_pool_Resize(pool, 3) == VLC_SUCCESS);
+    picture_Release(pics[1]);
+    pics[1] = picture_pool_Get(pool);
+    assert(pics[1] != NULL);
+    pics[2] = picture_pool_Get(pool);
+    assert(pics[2] != NULL);
+    assert(picture_pool_Get(pool) == NULL);
+
+    picture_pool_Release(pool);
+    for (unsigned i = 0; i < 3; i++)
+        picture_Release(pics[i]);
+
+    /* Only pools of allocated pictures can be resized */
+    picture_t *pic = picture_NewFromFormat(&fmt);
+    assert(pic != NULL);
+    pool = picture_pool_New(1, &pic);
+    assert(pool != NULL);
+    assert(picture_pool_Resize(pool, 2) != VLC_SUCCESS);
+    picture_pool_Release(pool);
+}
+
 int main(void)
 {
     video_format_Setup(&fmt, VLC_CODEC_I420, 320, 200, 320, 200, 1, 1);
@@ -123,6 +176,7 @@ int main(void)
 
     test(false);
     test(true);
+    test_resize();
 
     return 0;
 }
@@ -354,6 +354,47 @@ static void test__vlc_tick_sleep()
     assert(elapsed >= VLC_TICK_FROM_MS(25));
 }
 
+/*
+ * Test mutual exclusion of contended short critical sections
+ */
+#define MUTEX_THREADS 4
+#define MUTEX_LOOPS 100000
+
+struct mutex_data
+{
+    vlc_mutex_t mutex;
+    unsigned long counter;
+};
+
+static void *thread_func_mutex(void *data)
+{
+    struct mutex_data *d = data;
+
+    for (unsigned i = 0; i < MUTEX_LOOPS; i++)
+    {
+        vlc_mutex_lock(&d->mutex);
+        d->counter++;
+        vlc_mutex_unlock(&d->mutex);
+    }
+    return NULL;
+}
+
+static void test__mutex_contention()
+{
+    struct mutex_data data;
+    vlc_thread_t threads[MUTEX_THREADS];
+
+    vlc_mutex_init(&data.mutex);
+    data.counter = 0;
+
+    for (unsigned i = 0; i < MUTEX_THREADS; i++)
+        TEST_THREAD_CLONE(&threads[i], thread_func_mutex, &data);
+    for (unsigned i = 0; i < MUTEX_THREADS; i++)
+        TEST_THREAD_JOIN(threads[i], NULL);
+
+    assert(data.counter == MUTEX_THREADS * MUTEX_LOOPS);
+}
+
 
 /*
  * Main function executing all tests above
@@ -369,6 +410,7 @@ int main(void)
     test__cond_wait_timeout();
     test__cond_broadcast();
     test__latch();
+    test__mutex_contention();
     test__vlc_tick_sleep_cancelation();
     test__vlc_tick_sleep();
 
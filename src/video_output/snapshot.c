@@ -34,6 +34,8 @@
 #include <vlc_fs.h>
 #include <vlc_strings.h>
 #include <vlc_block.h>
+#include <vlc_executor.h>
+#include <vlc_list.h>
 #include <vlc_vout.h>
 
 #include "snapshot.h"
@@ -46,8 +48,31 @@ struct vout_snapshot {
     bool        is_available;
     int         request_count;
     vlc_picture_chain_t pics;
+
+    /* Asynchronous requests, completed on the executor */
+    struct vlc_list requests;
+    vlc_executor_t *executor;
 };
 
+struct vout_snapshot_request {
+    struct vlc_runnable runnable;
+    struct vlc_list node;
+
+    vout_snapshot_cb cb;
+    void *opaque;
+    picture_t *picture;
+};
+
+static void RunRequest(void *userdata)
+{
+    struct vout_snapshot_request *req = userdata;
+
+    req->cb(req->opaque, req->picture);
+    if (req->picture != NULL)
+        picture_Release(req->picture);
+    free(req);
+}
+
 vout_snapshot_t *vout_snapshot_New(void)
 {
     vout_snapshot_t *snap = malloc(sizeof (*snap));
@@ -60,6 +85,8 @@ vout_snapshot_t *vout_snapshot_New(void)
     snap->is_available = true;
     snap->request_count = 0;
     vlc_picture_chain_Init( &snap->pics );
+    vlc_list_init(&snap->requests);
+    snap->executor = NULL;
     return snap;
 }
 
@@ -73,6 +100,11 @@ void vout_snapshot_Destroy(vout_snapshot_t *snap)
         picture_Release(picture);
     }
 
+    /* vout_snapshot_End() completed the asynchronous requests */
+    assert(vlc_list_is_empty(&snap->requests));
+    if (snap->executor != NULL)
+        vlc_executor_Delete(snap->executor);
+
     free(snap);
 }
 
@@ -85,8 +117,19 @@ void vout_snapshot_End(vout_snapshot_t *snap)
 
     snap->is_available = false;
 
+    /* Complete the pending asynchronous requests without picture */
+    struct vout_snapshot_request *req;
+    vlc_list_foreach(req, &snap->requests, node) {
+        vlc_list_remove(&req->node);
+        vlc_executor_Submit(snap->executor, &req->runnable);
+    }
+
     vlc_cond_broadcast(&snap->wait);
     vlc_mutex_unlock(&snap->lock);
+
+    /* Wait for the callbacks, so that none is called after the close */
+    if (snap->executor != NULL)
+        vlc_executor_WaitIdle(snap->executor);
 }
 
 /* */
@@ -116,6 +159,43 @@ picture_t *vout_snapshot_Get(vout_snapshot_t *snap, vlc_tick_t timeout)
     return picture;
 }
 
+int vout_snapshot_GetAsync(vout_snapshot_t *snap, vout_snapshot_cb cb,
+                           void *opaque)
+{
+    if (snap == NULL)
+        return VLC_EGENERIC;
+
+    struct vout_snapshot_request *req = malloc(sizeof (*req));
+    if (unlikely(req == NULL))
+        return VLC_ENOMEM;
+
+    req->runnable.run = RunRequest;
+    req->runnable.userdata = req;
+    req->cb = cb;
+    req->opaque = opaque;
+    req->picture = NULL;
+
+    vlc_mutex_lock(&snap->lock);
+    if (!snap->is_available)
+        goto error;
+
+    /* A single worker: the conversions are serialized, in request order */
+    if (snap->executor == NULL) {
+        snap->executor = vlc_executor_New(1);
+        if (snap->executor == NULL)
+            goto error;
+    }
+
+    vlc_list_append(&req->node, &snap->requests);
+    vlc_mutex_unlock(&snap->lock);
+    return VLC_SUCCESS;
+
+error:
+    vlc_mutex_unlock(&snap->lock);
+    free(req);
+    return VLC_EGENERIC;
+}
+
 bool vout_snapshot_IsRequested(vout_snapshot_t *snap)
 {
     if (snap == NULL)
@@ -123,7 +203,8 @@ bool vout_snapshot_IsRequested(vout_snapshot_t *snap)
 
     bool has_request = false;
     if (!vlc_mutex_trylock(&snap->lock)) {
-        has_request = snap->request_count > 0;
+        has_request = snap->request_count > 0 ||
+                      !vlc_list_is_empty(&snap->requests);
         vlc_mutex_unlock(&snap->lock);
     }
     return has_request;
@@ -150,6 +231,17 @@ void vout_snapshot_Set(vout_snapshot_t *snap,
         vlc_picture_chain_Append( &snap->pics, dup );
         snap->request_count--;
     }
+
+    /* Only reference the picture here, the callbacks convert it */
+    struct vout_snapshot_request *req;
+    vlc_list_foreach(req, &snap->requests, node) {
+        req->picture = picture_Clone(picture);
+        if (req->picture != NULL)
+            video_format_CopyCrop(&req->picture->format, fmt);
+
+        vlc_list_remove(&req->node);
+        vlc_executor_Submit(snap->executor, &req->runnable);
+    }
     vlc_cond_broadcast(&snap->wait);
     vlc_mutex_unlock(&snap->lock);
 }
@@ -24,6 +24,7 @@
 #define LIBVLC_VOUT_INTERNAL_SNAPSHOT_H
 
 #include <vlc_picture.h>
+#include <vlc_vout.h>
 
 typedef struct vout_snapshot vout_snapshot_t;
 
@@ -36,6 +37,14 @@ void vout_snapshot_End(vout_snapshot_t *);
 /* */
 picture_t *vout_snapshot_Get(vout_snapshot_t *, vlc_tick_t timeout);
 
+/**
+ * Request the next picture set by vout_snapshot_Set() asynchronously.
+ *
+ * The callback is called exactly once, on the snapshot worker thread, with a
+ * NULL picture if the snapshot ends before.
+ */
+int vout_snapshot_GetAsync(vout_snapshot_t *, vout_snapshot_cb, void *opaque);
+
 /**
  * It tells if they are pending snapshot request
  */
@@ -61,8 +61,23 @@
 #include "../clock/clock.h"
 #include "statistic.h"
 #include "chrono.h"
+#include "vsync.h"
 #include "control.h"
 
+/* Maximum number of pictures prepared ahead of their display */
+#define VOUT_RENDER_AHEAD_MAX 3
+
+/** Picture prepared for display */
+struct vout_presentation
+{
+    picture_t    *picture;
+    subpicture_t *subpic;
+    vlc_tick_t   pts;
+    vlc_tick_t   system_pts;
+    float        rate;
+    bool         render_now;
+};
+
 typedef struct vout_thread_sys_t
 {
     struct vout_thread_t obj;
@@ -98,6 +113,23 @@ typedef struct vout_thread_sys_t
     /* Statistics */
     vout_statistic_t statistic;
 
+    /* Display refreshes */
+    vout_vsync_t vsync;
+
+    /* Render-ahead: the pictures are prepared by the vout thread and
+     * displayed by the presenter thread */
+    struct {
+        vlc_mutex_t  lock;
+        vlc_cond_t   wait;
+        vlc_thread_t thread;
+        unsigned     depth; /**< prepared pictures allowed, 0 if disabled */
+        unsigned     first;
+        unsigned     count;
+        bool         presenting;
+        bool         stop;
+        struct vout_presentation queue[VOUT_RENDER_AHEAD_MAX];
+    } ahead;
+
     /* Subpicture unit */
     spu_t           *spu;
     vlc_fourcc_t    spu_blend_chroma;
@@ -130,6 +162,7 @@ typedef struct vout_thread_sys_t
 
     /* */
     bool            is_late_dropped;
+    bool            offline;
 
     /* */
     vlc_mouse_t     mouse;
@@ -145,6 +178,7 @@ typedef struct vout_thread_sys_t
     vout_display_cfg_t display_cfg;
     vout_display_t *display;
     vlc_queuedmutex_t display_lock;
+    bool            display_parked; /* display kept without thread */
 
     /* Video filter2 chain */
     struct {
@@ -269,6 +303,24 @@ void vout_GetResetStatistic(vout_thread_t *vout, unsigned *restrict displayed,
     vout_statistic_GetReset( &sys->statistic, displayed, lost, late );
 }
 
+void vout_ReportPresented(vout_thread_t *vout, vlc_tick_t date,
+                          vlc_tick_t refresh_period)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    assert(!sys->dummy);
+
+    unsigned missed = vout_vsync_Report(&sys->vsync, date, refresh_period);
+    if (missed > 0)
+    {
+        struct vlc_tracer *tracer = GetTracer(sys);
+        if (tracer != NULL)
+            vlc_tracer_TraceEvent(tracer, "RENDER", sys->str_id, "missed");
+        msg_Dbg(&vout->obj, "picture flipped late (missed %u refreshes)",
+                missed);
+        vout_statistic_AddLate(&sys->statistic, 1);
+    }
+}
+
 bool vout_IsEmpty(vout_thread_t *vout)
 {
     vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
@@ -427,6 +479,16 @@ int vout_GetSnapshot(vout_thread_t *vout,
     return VLC_SUCCESS;
 }
 
+int vout_GetSnapshotAsync(vout_thread_t *vout, vout_snapshot_cb cb,
+                          void *opaque)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    /* The dummy vout of the player never displays anything */
+    if (sys->dummy)
+        return VLC_EGENERIC;
+    return vout_snapshot_GetAsync(sys->snapshot, cb, opaque);
+}
+
 /* vout_Control* are usable by anyone at anytime */
 void vout_ChangeFullscreen(vout_thread_t *vout, const char *id)
 {
@@ -1005,6 +1067,11 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
         vout_chrono_Start(&sys->chrono.static_filter);
         picture = filter_chain_VideoFilter(sys->filter.chain_static, sys->displayed.decoded);
         vout_chrono_Stop(&sys->chrono.static_filter);
+
+        struct vlc_tracer *tracer = GetTracer(sys);
+        if (tracer != NULL && picture != NULL)
+            vlc_tracer_TraceStreamPTS(tracer, "VOUT", sys->str_id, "FILTER",
+                                      picture->date);
     }
 
     vlc_mutex_unlock(&sys->filter.lock);
@@ -1259,58 +1326,29 @@ static int PrerenderPicture(vout_thread_sys_t *sys, picture_t *filtered,
     return VLC_SUCCESS;
 }
 
-static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
+/* Waits until the display date and displays a prepared picture.
+ *
+ * The display lock must be held when the picture is displayed by the vout
+ * thread, and is released. */
+static void PresentPicture(vout_thread_sys_t *sys, struct vout_presentation *p,
+                           bool ahead)
 {
     vout_display_t *vd = sys->display;
-
-    vout_chrono_Start(&sys->chrono.render);
-
-    picture_t *filtered = FilterPictureInteractive(sys);
-    if (!filtered)
-        return VLC_EGENERIC;
-
-    vlc_clock_Lock(sys->clock);
-    sys->clock_nowait = false;
-    vlc_clock_Unlock(sys->clock);
-    vlc_queuedmutex_lock(&sys->display_lock);
-
-    picture_t *todisplay;
-    subpicture_t *subpic;
-    int ret = PrerenderPicture(sys, filtered, &render_now, &todisplay, &subpic);
-    if (ret != VLC_SUCCESS)
-    {
-        vlc_queuedmutex_unlock(&sys->display_lock);
-        return ret;
-    }
-
-    vlc_tick_t system_now = vlc_tick_now();
-    const vlc_tick_t pts = todisplay->date;
-    vlc_tick_t system_pts = render_now ? system_now :
-        vlc_clock_ConvertToSystem(sys->clock, system_now, pts, sys->rate);
-    if (unlikely(system_pts == VLC_TICK_MAX))
-    {
-        /* The clock is paused, it's too late to fallback to the previous
-         * picture, display the current picture anyway and force the rendering
-         * to now. */
-        system_pts = system_now;
-        render_now = true;
-    }
+    picture_t *todisplay = p->picture;
+    const vlc_tick_t pts = p->pts;
+    vlc_tick_t system_pts = p->system_pts;
 
     const unsigned frame_rate = todisplay->format.i_frame_rate;
     const unsigned frame_rate_base = todisplay->format.i_frame_rate_base;
 
-    if (vd->ops->prepare != NULL)
-        vd->ops->prepare(vd, todisplay, subpic, system_pts);
-
-    vout_chrono_Stop(&sys->chrono.render);
-
     struct vlc_tracer *tracer = GetTracer(sys);
-    system_now = vlc_tick_now();
-    if (!render_now)
+    vlc_tick_t system_now = vlc_tick_now();
+    if (!p->render_now)
     {
         const vlc_tick_t late = system_now - system_pts;
         if (unlikely(late > 0))
         {
+            vout_vsync_Cancel(&sys->vsync);
             if (tracer != NULL)
                 vlc_tracer_TraceEvent(tracer, "RENDER", sys->str_id, "late");
             msg_Dbg(vd, "picture displayed late (missing %"PRId64" ms)", MS_FROM_VLC_TICK(late));
@@ -1329,52 +1367,64 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
             vlc_clock_Lock(sys->clock);
 
             bool timed_out = false;
-            sys->wait_interrupted = false;
+            if (!ahead)
+                sys->wait_interrupted = false;
             while (!timed_out)
             {
                 vlc_tick_t deadline;
                 if (vlc_clock_IsPaused(sys->clock))
-                    deadline = max_deadline;
+                    deadline = system_pts = max_deadline;
                 else
                 {
-                    deadline = vlc_clock_ConvertToSystemLocked(sys->clock,
-                                                vlc_tick_now(), pts, sys->rate);
-                    if (deadline > max_deadline)
-                        deadline = max_deadline;
+                    system_pts = vlc_clock_ConvertToSystemLocked(sys->clock,
+                                                vlc_tick_now(), pts, p->rate);
+                    if (system_pts > max_deadline)
+                        deadline = system_pts = max_deadline;
+                    else
+                        /* Submit the picture during the refresh period
+                         * preceding its planned refresh */
+                        vout_vsync_Plan(&sys->vsync, system_pts, &deadline);
                 }
 
                 if (sys->clock_nowait)
                 {
                     /* A caller (the UI thread) awaits for the rendering to
                      * complete urgently, do not wait. */
-                    sys->wait_interrupted = true;
+                    if (!ahead)
+                        sys->wait_interrupted = true;
                     break;
                 }
 
-                system_pts = deadline;
                 timed_out = vlc_clock_Wait(sys->clock, deadline);
             }
             vlc_clock_Unlock(sys->clock);
         }
-        sys->displayed.date = system_pts;
+        if (!ahead)
+            sys->displayed.date = system_pts;
     }
     else
     {
-        sys->displayed.date = system_now;
+        if (!ahead)
+            sys->displayed.date = system_now;
         /* Tell the clock that the pts was forced */
         system_pts = VLC_TICK_MAX;
     }
-    vlc_tick_t drift = vlc_clock_UpdateVideo(sys->clock, system_pts, pts, sys->rate,
+    vlc_tick_t drift = vlc_clock_UpdateVideo(sys->clock, system_pts, pts, p->rate,
                                              frame_rate, frame_rate_base);
 
     /* Display the direct buffer returned by vout_RenderPicture */
+    if (ahead)
+        vlc_queuedmutex_lock(&sys->display_lock);
     vout_display_Display(vd, todisplay);
     vlc_queuedmutex_unlock(&sys->display_lock);
 
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "VOUT", sys->str_id, "DISPLAY", pts);
+
     picture_Release(todisplay);
 
-    if (subpic)
-        subpicture_Delete(subpic);
+    if (p->subpic)
+        subpicture_Delete(p->subpic);
 
     vout_statistic_AddDisplayed(&sys->statistic, 1);
 
@@ -1382,6 +1432,192 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
         vlc_tracer_TraceWithTs(tracer, system_pts, VLC_TRACE("type", "RENDER"),
                                VLC_TRACE("id", sys->str_id),
                                VLC_TRACE("drift", drift), VLC_TRACE_END);
+}
+
+static void *PresenterThread(void *data)
+{
+    vout_thread_sys_t *sys = data;
+
+    vlc_thread_set_name("vlc-vout-pres");
+
+    vlc_mutex_lock(&sys->ahead.lock);
+    for (;;)
+    {
+        while (sys->ahead.count == 0 && !sys->ahead.stop)
+            vlc_cond_wait(&sys->ahead.wait, &sys->ahead.lock);
+        if (sys->ahead.count == 0)
+            break;
+
+        struct vout_presentation p = sys->ahead.queue[sys->ahead.first];
+        sys->ahead.first = (sys->ahead.first + 1) % VOUT_RENDER_AHEAD_MAX;
+        sys->ahead.count--;
+        sys->ahead.presenting = true;
+        vlc_mutex_unlock(&sys->ahead.lock);
+
+        PresentPicture(sys, &p, true);
+
+        vlc_mutex_lock(&sys->ahead.lock);
+        sys->ahead.presenting = false;
+        vlc_cond_broadcast(&sys->ahead.wait);
+    }
+    vlc_mutex_unlock(&sys->ahead.lock);
+    return NULL;
+}
+
+/* Displays the pictures already prepared without waiting for their date,
+ * as the display expects every prepared picture to be displayed */
+static void FlushPresenter(vout_thread_sys_t *sys)
+{
+    vlc_mutex_lock(&sys->ahead.lock);
+    for (unsigned i = 0; i < sys->ahead.count; i++)
+    {
+        unsigned index = (sys->ahead.first + i) % VOUT_RENDER_AHEAD_MAX;
+        sys->ahead.queue[index].render_now = true;
+    }
+    vlc_mutex_unlock(&sys->ahead.lock);
+
+    /* Do not wait for the date of the picture being displayed */
+    VoutRenderWakeUpUrgent(sys);
+}
+
+static void StartPresenter(vout_thread_sys_t *sys)
+{
+    unsigned depth = sys->display->info.queue_depth;
+
+    sys->ahead.depth = 0;
+    if (depth <= 1 || !var_InheritBool(&sys->obj, "render-ahead"))
+        return;
+
+    sys->ahead.first = 0;
+    sys->ahead.count = 0;
+    sys->ahead.presenting = false;
+    sys->ahead.stop = false;
+
+    if (vlc_clone(&sys->ahead.thread, PresenterThread, sys))
+    {
+        msg_Warn(&sys->obj, "cannot render ahead");
+        return;
+    }
+
+    sys->ahead.depth = __MIN(depth, VOUT_RENDER_AHEAD_MAX);
+    msg_Dbg(&sys->obj, "rendering up to %u pictures ahead", sys->ahead.depth);
+}
+
+static void StopPresenter(vout_thread_sys_t *sys)
+{
+    if (sys->ahead.depth == 0)
+        return;
+
+    vlc_mutex_lock(&sys->ahead.lock);
+    sys->ahead.stop = true;
+    vlc_cond_broadcast(&sys->ahead.wait);
+    vlc_mutex_unlock(&sys->ahead.lock);
+
+    FlushPresenter(sys);
+    vlc_join(sys->ahead.thread, NULL);
+    sys->ahead.depth = 0;
+}
+
+/* Waits until a picture can be prepared ahead */
+static void WaitPresenter(vout_thread_sys_t *sys)
+{
+    vlc_mutex_lock(&sys->ahead.lock);
+    while (sys->ahead.count + sys->ahead.presenting >= sys->ahead.depth)
+        vlc_cond_wait(&sys->ahead.wait, &sys->ahead.lock);
+    vlc_mutex_unlock(&sys->ahead.lock);
+}
+
+static void QueuePresenter(vout_thread_sys_t *sys,
+                           const struct vout_presentation *p)
+{
+    vlc_mutex_lock(&sys->ahead.lock);
+    assert(sys->ahead.count < VOUT_RENDER_AHEAD_MAX);
+    unsigned last = (sys->ahead.first + sys->ahead.count)
+                  % VOUT_RENDER_AHEAD_MAX;
+    sys->ahead.queue[last] = *p;
+    sys->ahead.count++;
+    vlc_cond_broadcast(&sys->ahead.wait);
+    vlc_mutex_unlock(&sys->ahead.lock);
+}
+
+static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
+{
+    vout_display_t *vd = sys->display;
+
+    /* Prepare the picture while the previous ones wait to be displayed */
+    if (sys->ahead.depth > 0)
+        WaitPresenter(sys);
+
+    vout_chrono_Start(&sys->chrono.render);
+
+    picture_t *filtered = FilterPictureInteractive(sys);
+    if (!filtered)
+        return VLC_EGENERIC;
+
+    vlc_clock_Lock(sys->clock);
+    sys->clock_nowait = false;
+    vlc_clock_Unlock(sys->clock);
+    vlc_queuedmutex_lock(&sys->display_lock);
+
+    picture_t *todisplay;
+    subpicture_t *subpic;
+    int ret = PrerenderPicture(sys, filtered, &render_now, &todisplay, &subpic);
+    if (ret != VLC_SUCCESS)
+    {
+        vlc_queuedmutex_unlock(&sys->display_lock);
+        return ret;
+    }
+
+    vlc_tick_t system_now = vlc_tick_now();
+    const vlc_tick_t pts = todisplay->date;
+    vlc_tick_t system_pts = render_now ? system_now :
+        vlc_clock_ConvertToSystem(sys->clock, system_now, pts, sys->rate);
+    if (unlikely(system_pts == VLC_TICK_MAX))
+    {
+        /* The clock is paused, it's too late to fallback to the previous
+         * picture, display the current picture anyway and force the rendering
+         * to now. */
+        system_pts = system_now;
+        render_now = true;
+    }
+
+    /* Show the picture on the nearest refresh of the display */
+    vlc_tick_t system_refresh = system_pts;
+    if (render_now)
+        vout_vsync_Cancel(&sys->vsync);
+    else
+    {
+        vlc_tick_t system_deadline;
+        system_refresh = vout_vsync_Plan(&sys->vsync, system_pts,
+                                         &system_deadline);
+    }
+
+    if (vd->ops->prepare != NULL)
+        vd->ops->prepare(vd, todisplay, subpic, system_refresh);
+
+    struct vlc_tracer *tracer = GetTracer(sys);
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "VOUT", sys->str_id, "PREPARE", pts);
+
+    vout_chrono_Stop(&sys->chrono.render);
+
+    struct vout_presentation presentation = {
+        .picture = todisplay,
+        .subpic = subpic,
+        .pts = pts,
+        .system_pts = system_pts,
+        .rate = sys->rate,
+        .render_now = render_now,
+    };
+
+    if (sys->ahead.depth > 0)
+    {
+        vlc_queuedmutex_unlock(&sys->display_lock);
+        sys->displayed.date = render_now ? system_now : system_pts;
+        QueuePresenter(sys, &presentation);
+    }
+    else
+        PresentPicture(sys, &presentation, false);
 
     return VLC_SUCCESS;
 }
@@ -1475,6 +1711,22 @@ static vlc_tick_t DisplayPicture(vout_thread_sys_t *vout)
 
     UpdateDeinterlaceFilter(sys);
 
+    if (sys->offline && !sys->pause.is_on)
+    {
+        /* Display the pictures as soon as they are decoded: only the picture
+         * pool paces the decoder */
+        picture_t *next = PreparePicture(sys, false, true);
+        if (next == NULL)
+            /* vout_PutPicture() wakes the thread up */
+            return vlc_tick_now() + VOUT_REDISPLAY_DELAY;
+
+        if (sys->displayed.current != NULL)
+            picture_Release(sys->displayed.current);
+        sys->displayed.current = next;
+        RenderPicture(vout, true);
+        return VLC_TICK_INVALID;
+    }
+
     bool current_changed = UpdateCurrentPicture(sys);
     if (current_changed)
     {
@@ -1568,6 +1820,9 @@ static void vout_FlushUnlocked(vout_thread_sys_t *vout, bool below,
 
     picture_fifo_Flush(sys->decoder_fifo, date, below);
 
+    if (sys->ahead.depth > 0)
+        FlushPresenter(sys);
+
     vlc_queuedmutex_lock(&sys->display_lock);
     if (sys->display != NULL)
         vout_FilterFlush(sys->display);
@@ -1712,6 +1967,7 @@ static int vout_Start(vout_thread_sys_t *vout, vlc_video_context *vctx, const vo
 
     /* Reinitialize chrono to ensure we re-compute any new render timing. */
     VoutResetChronoLocked(sys);
+    vout_vsync_Reset(&sys->vsync);
 
     /* Setup the window size, protected by the display_lock */
     dcfg.display.width = sys->window_width;
@@ -1744,6 +2000,8 @@ static int vout_Start(vout_thread_sys_t *vout, vlc_video_context *vctx, const vo
     sys->spu_blend_chroma        = 0;
     sys->spu_blend               = NULL;
 
+    StartPresenter(sys);
+
     video_format_Print(VLC_OBJECT(&vout->obj), "original format", &sys->original);
     return VLC_SUCCESS;
 error:
@@ -1821,6 +2079,8 @@ static void vout_ReleaseDisplay(vout_thread_sys_t *vout)
 
     assert(sys->display != NULL);
 
+    StopPresenter(sys);
+
     if (sys->spu_blend != NULL)
         filter_DeleteBlend(sys->spu_blend);
 
@@ -1871,18 +2131,96 @@ static void vout_ReleaseDisplay(vout_thread_sys_t *vout)
     sys->str_id = NULL;
 }
 
-void vout_StopDisplay(vout_thread_t *vout)
+static void vout_StopThread(vout_thread_sys_t *sys)
 {
-    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
-
     atomic_store(&sys->control_is_terminated, true);
     // wake up so it goes back to the loop that will detect the terminated state
     vout_control_Wake(&sys->control);
     vlc_join(sys->thread, NULL);
+}
+
+void vout_StopDisplay(vout_thread_t *vout)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+
+    if (sys->display_parked)
+        sys->display_parked = false;
+    else
+        vout_StopThread(sys);
 
     vout_ReleaseDisplay(sys);
 }
 
+void vout_ParkDisplay(vout_thread_t *vout)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+
+    assert(sys->display != NULL && !sys->display_parked);
+    vout_StopThread(sys);
+    /* The presenter displays the pictures already prepared, with the clock
+     * of the previous input */
+    StopPresenter(sys);
+
+    /* Drop everything tied to the previous input, the last displayed picture
+     * stays on screen until the next one */
+    vout_FlushUnlocked(sys, true, VLC_TICK_MAX);
+
+    vlc_mutex_lock(&sys->window_lock);
+    vout_display_window_SetMouseHandler(sys->display_cfg.window, NULL, NULL);
+    vlc_mutex_unlock(&sys->window_lock);
+
+    if (sys->spu)
+        spu_Detach(sys->spu);
+
+    vlc_mutex_lock(&sys->clock_lock);
+    sys->clock = NULL;
+    vlc_mutex_unlock(&sys->clock_lock);
+    sys->str_id = NULL;
+    sys->display_parked = true;
+}
+
+/* Restarts a parked display for a new input with the same format */
+static int vout_ResumeDisplay(vout_thread_sys_t *sys,
+                              const vout_configuration_t *cfg,
+                              input_thread_t *input)
+{
+    vlc_mutex_lock(&sys->window_lock);
+    vout_display_window_SetMouseHandler(sys->display_cfg.window,
+                                        cfg->mouse_event, cfg->mouse_opaque);
+    vlc_mutex_unlock(&sys->window_lock);
+
+    sys->delay = 0;
+    sys->rate = 1.f;
+    sys->str_id = cfg->str_id;
+
+    vlc_mutex_lock(&sys->clock_lock);
+    sys->clock = cfg->clock;
+    vlc_mutex_unlock(&sys->clock_lock);
+
+    vlc_queuedmutex_lock(&sys->display_lock);
+    VoutResetChronoLocked(sys);
+    vlc_queuedmutex_unlock(&sys->display_lock);
+    vout_vsync_Reset(&sys->vsync);
+
+    sys->pause.is_on = false;
+    sys->pause.date  = VLC_TICK_INVALID;
+
+    sys->display_parked = false;
+    StartPresenter(sys);
+    atomic_store(&sys->control_is_terminated, false);
+    if (vlc_clone(&sys->thread, Thread, sys))
+    {
+        vout_ReleaseDisplay(sys);
+        return -1;
+    }
+
+    if (input != NULL && sys->spu)
+        spu_Attach(sys->spu, input);
+    vout_IntfReinit(cfg->vout);
+    msg_Dbg(cfg->vout, "reusing the parked display");
+    return 0;
+}
+
 static void vout_DisableWindow(vout_thread_sys_t *sys)
 {
     vlc_mutex_lock(&sys->window_lock);
@@ -2024,6 +2362,10 @@ vout_thread_t *vout_Create(vlc_object_t *object)
     sys->source.crop.mode = VOUT_CROP_NONE;
     sys->snapshot = vout_snapshot_New();
     vout_statistic_Init(&sys->statistic);
+    vout_vsync_Init(&sys->vsync);
+    vlc_mutex_init(&sys->ahead.lock);
+    vlc_cond_init(&sys->ahead.wait);
+    sys->ahead.depth = 0;
 
     /* Initialize subpicture unit */
     sys->spu = var_InheritBool(vout, "spu") || var_InheritBool(vout, "osd") ?
@@ -2039,6 +2381,7 @@ vout_thread_t *vout_Create(vlc_object_t *object)
     vout_InitInterlacingSupport(vout, &sys->private);
 
     sys->is_late_dropped = var_InheritBool(vout, "drop-late-frames");
+    sys->offline = var_InheritBool(vout, "offline");
 
     vlc_mutex_init(&sys->filter.lock);
 
@@ -2159,7 +2502,16 @@ int vout_Request(const vout_configuration_t *cfg, vlc_video_context *vctx, input
     video_format_t original;
     VoutFixFormat(&original, cfg->fmt);
 
-    if (vout_ChangeSource(cfg->vout, &original, vctx) == 0)
+    if (sys->display_parked)
+    {
+        if (vout_ChangeSource(cfg->vout, &original, vctx) == 0)
+        {
+            video_format_Clean(&original);
+            return vout_ResumeDisplay(sys, cfg, input);
+        }
+        vout_StopDisplay(cfg->vout);
+    }
+    else if (vout_ChangeSource(cfg->vout, &original, vctx) == 0)
     {
         video_format_Clean(&original);
         return 0;
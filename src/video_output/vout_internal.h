@@ -93,6 +93,14 @@ void vout_Stop(vout_thread_t *);
  */
 void vout_StopDisplay(vout_thread_t *);
 
+/**
+ * Stop the vout thread, but keep the display plugin running.
+ *
+ * The next vout_Request() reuses the display as is if the format and the
+ * video context are the same, and stops it otherwise.
+ */
+void vout_ParkDisplay(vout_thread_t *);
+
 /**
  * Set the new source format for a started vout
  *
@@ -223,6 +231,14 @@ void vout_ChangeSpuDelay( vout_thread_t *, size_t channel_id, vlc_tick_t delay )
 void vout_GetResetStatistic( vout_thread_t *p_vout, unsigned *pi_displayed,
                              unsigned *pi_lost, unsigned *pi_late );
 
+/**
+ * This function reports a flip of the display, with its refresh period.
+ *
+ * It is thread safe
+ */
+void vout_ReportPresented( vout_thread_t *p_vout, vlc_tick_t date,
+                           vlc_tick_t refresh_period );
+
 /**
  * This function will force to display the next picture while paused
  */
@@ -1113,6 +1113,9 @@ static void SpuRenderRegion(spu_t *spu,
         dst->i_y       = y_offset;
         dst->i_align   = 0;
         assert(!dst->p_picture);
+        /* Unchanged regions are output with the same (cached) picture from
+         * one rendering to the next, so that the displays can tell which
+         * regions they need to upload again. */
         dst->p_picture = picture_Hold(region_picture);
         int fade_alpha = 255;
         if (subpic->b_fade) {
@@ -49,6 +49,11 @@ static void VoutViewpointMoved(void *sys, const vlc_viewpoint_t *vp)
     var_SetAddress(vout, "viewpoint-moved", (void*)vp);
 }
 
+static void VoutPresented(void *sys, vlc_tick_t date, vlc_tick_t period)
+{
+    vout_ReportPresented(sys, date, period);
+}
+
 /* Minimum number of display picture */
 #define DISPLAY_PICTURE_COUNT (1)
 
@@ -61,7 +66,8 @@ vout_display_t *vout_OpenWrapper(vout_thread_t *vout, vout_thread_private_t *sys
 {
     vout_display_t *vd;
     vout_display_owner_t owner = {
-        .viewpoint_moved = VoutViewpointMoved, .sys = vout,
+        .viewpoint_moved = VoutViewpointMoved, .presented = VoutPresented,
+        .sys = vout,
     };
     const char *modlist;
     char *modlistbuf = NULL;
@@ -85,9 +91,12 @@ vout_display_t *vout_OpenWrapper(vout_thread_t *vout, vout_thread_private_t *sys
 
     const unsigned private_picture  = 4; /* XXX 3 for filter, 1 for SPU */
     const unsigned kept_picture     = 1; /* last displayed picture */
+    const unsigned queued_picture   = vd->info.queue_depth > 1 ?
+                                      vd->info.queue_depth - 1 : 0;
     const unsigned reserved_picture = DISPLAY_PICTURE_COUNT +
                                       private_picture +
-                                      kept_picture;
+                                      kept_picture +
+                                      queued_picture;
 
     picture_pool_t *display_pool = vout_GetPool(vd, reserved_picture);
     if (display_pool == NULL)
@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * vsync.h : vout refresh-locked presentation scheduling
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_VOUT_VSYNC_H
+# define LIBVLC_VOUT_VSYNC_H
+
+#include <vlc_threads.h>
+
+/* Reports older than this do not give a reliable phase anymore */
+#define VOUT_VSYNC_MAX_AGE VLC_TICK_FROM_SEC(2)
+
+/**
+ * Display refresh tracker.
+ *
+ * The display modules report the dates of the flips and the refresh period
+ * (from any thread). The vout thread snaps the presentation date of each
+ * picture to a refresh, so that a stable cadence is kept (3:2 for 24 fps on
+ * a 60 Hz display) even when the picture dates fall close to the middle of
+ * two refreshes.
+ */
+typedef struct {
+    vlc_mutex_t lock;
+    vlc_tick_t period;  /**< refresh period, 0 if unknown */
+    vlc_tick_t last;    /**< date of the last reported refresh */
+    vlc_tick_t target;  /**< refresh planned for the last displayed picture */
+    bool round_up;      /**< last rounding, for hysteresis */
+} vout_vsync_t;
+
+static inline void vout_vsync_Reset(vout_vsync_t *vsync)
+{
+    vlc_mutex_lock(&vsync->lock);
+    vsync->period = 0;
+    vsync->last = VLC_TICK_INVALID;
+    vsync->target = VLC_TICK_INVALID;
+    vsync->round_up = false;
+    vlc_mutex_unlock(&vsync->lock);
+}
+
+static inline void vout_vsync_Init(vout_vsync_t *vsync)
+{
+    vlc_mutex_init(&vsync->lock);
+    vout_vsync_Reset(vsync);
+}
+
+/**
+ * Reports a flip of the display.
+ *
+ * \param date system date of the refresh the last picture was shown on
+ * \param period refresh period, or 0 to keep the current estimation
+ * \return the number of refreshes the last picture was shown after its
+ * planned refresh (0 if on time or unknown)
+ */
+static inline unsigned vout_vsync_Report(vout_vsync_t *vsync,
+                                         vlc_tick_t date, vlc_tick_t period)
+{
+    unsigned missed = 0;
+
+    vlc_mutex_lock(&vsync->lock);
+    if (period > 0)
+    {
+        /* Smooth the variations of the reported period, but follow the
+         * mode changes immediately */
+        if (vsync->period == 0 || llabs(period - vsync->period) > period / 8)
+            vsync->period = period;
+        else
+            vsync->period = (7 * vsync->period + period) / 8;
+    }
+
+    if (vsync->target != VLC_TICK_INVALID && vsync->period > 0
+     && date > vsync->target + vsync->period / 2)
+        missed = (date - vsync->target + vsync->period / 2) / vsync->period;
+
+    vsync->last = date;
+    vsync->target = VLC_TICK_INVALID;
+    vlc_mutex_unlock(&vsync->lock);
+    return missed;
+}
+
+/**
+ * Plans the refresh a picture will be shown on.
+ *
+ * \param date system date the picture should be shown at
+ * \param deadline date the picture should be submitted to the display at,
+ * to be shown on that refresh [OUT]
+ * \return the date of the refresh, or date if the refresh is unknown
+ */
+static inline vlc_tick_t vout_vsync_Plan(vout_vsync_t *vsync, vlc_tick_t date,
+                                         vlc_tick_t *deadline)
+{
+    vlc_mutex_lock(&vsync->lock);
+    const vlc_tick_t period = vsync->period;
+    const vlc_tick_t last = vsync->last;
+
+    if (period == 0 || last == VLC_TICK_INVALID || date < last
+     || date - last > VOUT_VSYNC_MAX_AGE)
+    {
+        vlc_mutex_unlock(&vsync->lock);
+        *deadline = date;
+        return date;
+    }
+
+    vlc_tick_t count = (date - last) / period;
+    vlc_tick_t phase = (date - last) % period;
+
+    /* Round to the nearest refresh, but keep the previous rounding when the
+     * date is close to the middle of two refreshes, which would jitter */
+    bool round_up;
+    if (llabs(phase - period / 2) < period / 8)
+        round_up = vsync->round_up;
+    else
+        round_up = phase > period / 2;
+    vsync->round_up = round_up;
+
+    const vlc_tick_t refresh = last + (count + round_up) * period;
+    vsync->target = refresh;
+    vlc_mutex_unlock(&vsync->lock);
+
+    /* Anywhere during the previous refresh period is fine, take the middle
+     * to be robust to the scheduling jitter */
+    *deadline = refresh - period / 2;
+    return refresh;
+}
+
+/**
+ * Cancels the planned refresh of the current picture, when it is displayed
+ * late or regardless of its date.
+ */
+static inline void vout_vsync_Cancel(vout_vsync_t *vsync)
+{
+    vlc_mutex_lock(&vsync->lock);
+    vsync->target = VLC_TICK_INVALID;
+    vlc_mutex_unlock(&vsync->lock);
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include <vlc_charset.h>
 
 #include "libvlc.h"
+#include "misc/thread_policy.h"
 #include <stdarg.h>
 #include <stdatomic.h>
 #include <assert.h>
@@ -66,6 +67,7 @@ struct vlc_thread
 
     void        *(*entry) (void *);
     void          *data;
+    struct vlc_thread_policy *policy;
 };
 
 /*** Thread-specific variables (TLS) ***/
@@ -348,9 +350,11 @@ __stdcall vlc_entry (void *p)
     struct vlc_thread *th = p;
 
     current_thread_ctx = th;
+    vlc_thread_policy_Enter(th->policy);
     th->killable = true;
     th->data = th->entry (th->data);
     assert(th->data != VLC_THREAD_CANCELED); // don't hijack our internal values
+    vlc_thread_policy_Leave();
     current_thread_ctx = NULL;
 
     return 0;
@@ -367,6 +371,8 @@ int vlc_clone (vlc_thread_t *p_handle, void *(*entry) (void *),
     th->killable = false; /* not until vlc_entry() ! */
     atomic_init(&th->killed, false);
     th->cleaners = NULL;
+    /* The new thread follows the policy of its creator, e.g. its input */
+    th->policy = vlc_thread_policy_Get();
 
     HANDLE h;
 #ifdef VLC_WINSTORE_APP
@@ -381,6 +387,8 @@ int vlc_clone (vlc_thread_t *p_handle, void *(*entry) (void *),
     if (h == 0)
     {
         int err = errno;
+        if (th->policy != NULL)
+            vlc_thread_policy_Release(th->policy);
         free (th);
         return err;
     }
@@ -423,6 +431,7 @@ void (vlc_thread_set_name)(const char *name)
         SetThreadDescription_(GetCurrentThread(), wname);
         free(wname);
     }
+    vlc_thread_policy_SetName(name);
 }
 
 /*** Thread cancellation ***/
@@ -471,6 +480,7 @@ _Noreturn static void vlc_docancel(struct vlc_thread *th)
     for (vlc_cleanup_t *p = th->cleaners; p != NULL; p = p->next)
         p->proc (p->data);
 
+    vlc_thread_policy_Leave();
     th->data = VLC_THREAD_CANCELED;
 #ifdef VLC_WINSTORE_APP
     ExitThread(0);
@@ -82,6 +82,30 @@ static void test_audio_output (void)
     libvlc_release (vlc);
 }
 
+static void test_memory_stats (const char ** argv, int argc)
+{
+    const char *args[argc + 1];
+    libvlc_memory_stats_t stats;
+
+    test_log ("Testing libvlc_memory_get_stats()\n");
+
+    for (int i = 0; i < argc; i++)
+        args[i] = argv[i];
+    args[argc] = "--cache-memory-budget=3";
+
+    libvlc_instance_t *vlc = libvlc_new (argc + 1, args);
+    assert (vlc != NULL);
+
+    assert (libvlc_memory_get_stats (vlc, libvlc_memory_cache, &stats) == 0);
+    assert (stats.i_budget == 3 << 20);
+    assert (stats.i_used <= stats.i_peak);
+    assert (libvlc_memory_get_stats (vlc, libvlc_memory_frame, &stats) == 0);
+    assert (stats.i_budget == 0);
+    assert (libvlc_memory_get_stats (vlc, 42, &stats) == -1);
+
+    libvlc_release (vlc);
+}
+
 int main (void)
 {
     test_init();
@@ -89,6 +113,7 @@ int main (void)
     test_core (test_defaults_args, test_defaults_nargs);
     test_audiovideofilterlists (test_defaults_args, test_defaults_nargs);
     test_audio_output ();
+    test_memory_stats (test_defaults_args, test_defaults_nargs);
 
     return 0;
 }
@@ -22,6 +22,7 @@
 
 #include "test.h"
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 
 struct event_ctx
 {
@@ -706,6 +707,295 @@ static void test_media_player_multiple_instance(const char** argv, int argc)
     libvlc_media_player_release(player2);
 }
 
+struct frames_ctx
+{
+    vlc_sem_t sem;
+    libvlc_video_frame_t *frame;
+};
+
+static void on_video_frame(void *opaque, libvlc_video_frame_t *frame)
+{
+    struct frames_ctx *ctx = opaque;
+
+    /* Keep the first frame, beyond the callback and the playback */
+    if (ctx->frame == NULL)
+    {
+        ctx->frame = libvlc_video_frame_retain(frame);
+        vlc_sem_post(&ctx->sem);
+    }
+    libvlc_video_frame_release(frame);
+}
+
+static void test_media_player_video_frames(const char** argv, int argc)
+{
+    struct frames_ctx ctx = { .frame = NULL };
+    const char *file = "mock://video_track_count=1;video_width=320;"
+                       "video_height=240";
+
+    test_log ("Testing video frames of %s\n", file);
+    vlc_sem_init(&ctx.sem, 0);
+
+    libvlc_instance_t *vlc = libvlc_new (argc, argv);
+    assert (vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(file);
+    assert (md != NULL);
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media (vlc, md);
+    assert (mp != NULL);
+    libvlc_media_release (md);
+
+    libvlc_video_set_frame_callback(mp, on_video_frame, &ctx);
+    play_and_wait(mp);
+    vlc_sem_wait(&ctx.sem);
+
+    libvlc_media_player_stop_async (mp);
+    libvlc_media_player_release (mp);
+    libvlc_release (vlc);
+
+    libvlc_video_frame_format_t fmt;
+    libvlc_video_frame_get_format(ctx.frame, &fmt);
+    assert(strcmp(fmt.chroma, "I420") == 0);
+    assert(fmt.visible_width == 320 && fmt.visible_height == 240);
+    assert(libvlc_video_frame_get_surface(ctx.frame, NULL, NULL)
+           == libvlc_video_surface_none);
+
+    unsigned pitch, lines;
+    for (unsigned i = 0; i < 3; i++)
+    {
+        const uint8_t *pixels =
+            libvlc_video_frame_get_plane(ctx.frame, i, &pitch, &lines, NULL);
+        assert(pixels != NULL);
+        assert(pitch >= (i == 0 ? 320 : 160));
+        assert(lines >= (i == 0 ? 240 : 120));
+        (void) pixels[pitch * (lines - 1)];
+    }
+    assert(libvlc_video_frame_get_plane(ctx.frame, 3, &pitch, &lines,
+                                        NULL) == NULL);
+    assert(pitch == 0);
+
+    libvlc_video_frame_release(ctx.frame);
+}
+
+struct snapshot_ctx
+{
+    vlc_sem_t sem;
+    libvlc_picture_t *picture;
+    unsigned count;
+};
+
+static void on_snapshot(void *opaque, libvlc_picture_t *picture)
+{
+    struct snapshot_ctx *ctx = opaque;
+
+    if (picture != NULL)
+        libvlc_picture_retain(picture);
+    ctx->picture = picture;
+    ctx->count++;
+    vlc_sem_post(&ctx->sem);
+}
+
+static void test_media_player_snapshot(const char** argv, int argc)
+{
+    struct snapshot_ctx ctx = { .picture = NULL, .count = 0 };
+    const char *file = "mock://video_track_count=1;video_width=320;"
+                       "video_height=240;length=100000000";
+
+    test_log ("Testing asynchronous snapshots of %s\n", file);
+    vlc_sem_init(&ctx.sem, 0);
+
+    libvlc_instance_t *vlc = libvlc_new (argc, argv);
+    assert (vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(file);
+    assert (md != NULL);
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media (vlc, md);
+    assert (mp != NULL);
+    libvlc_media_release (md);
+
+    /* No video output yet */
+    assert(libvlc_video_take_snapshot_async(mp, 0, libvlc_picture_Png, 0, 0,
+                                            on_snapshot, &ctx) == -1);
+
+    play_and_wait(mp);
+
+    /* Wait for the actual video output */
+    int ret;
+    while ((ret = libvlc_video_take_snapshot_async(mp, 0, libvlc_picture_Png,
+                                                   160, 0, on_snapshot,
+                                                   &ctx)) != 0)
+        vlc_tick_sleep(VLC_TICK_FROM_MS(10));
+    vlc_sem_wait(&ctx.sem);
+    assert(ctx.count == 1);
+    if (ctx.picture != NULL)
+    {
+        assert(libvlc_picture_type(ctx.picture) == libvlc_picture_Png);
+        assert(libvlc_picture_get_width(ctx.picture) == 160);
+        assert(libvlc_picture_get_height(ctx.picture) == 120);
+        libvlc_picture_release(ctx.picture);
+    }
+    else
+        test_log("Snapshot not converted (missing modules?)\n");
+
+    /* A pending request is completed when the video output is closed */
+    ret = libvlc_video_take_snapshot_async(mp, 0, libvlc_picture_Png, 0, 0,
+                                           on_snapshot, &ctx);
+    if (ret == 0)
+    {
+        libvlc_media_player_stop_async (mp);
+        vlc_sem_wait(&ctx.sem);
+        assert(ctx.count == 2);
+        if (ctx.picture != NULL)
+            libvlc_picture_release(ctx.picture);
+    }
+    else
+        libvlc_media_player_stop_async (mp);
+
+    libvlc_media_player_release (mp);
+    libvlc_release (vlc);
+}
+
+struct audio_frames_ctx
+{
+    vlc_sem_t sem;
+    libvlc_audio_frame_t *frame;
+};
+
+static void on_audio_frame(void *opaque, libvlc_audio_frame_t *frame)
+{
+    struct audio_frames_ctx *ctx = opaque;
+
+    if (ctx->frame == NULL)
+    {
+        ctx->frame = libvlc_audio_frame_retain(frame);
+        vlc_sem_post(&ctx->sem);
+    }
+    libvlc_audio_frame_release(frame);
+}
+
+static void test_media_player_audio_frames(const char** argv, int argc)
+{
+    struct audio_frames_ctx ctx = { .frame = NULL };
+    const char *file = "mock://audio_track_count=1;audio_channels=6;"
+                       "audio_rate=48000";
+
+    test_log ("Testing audio frames of %s\n", file);
+    vlc_sem_init(&ctx.sem, 0);
+
+    libvlc_instance_t *vlc = libvlc_new (argc, argv);
+    assert (vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(file);
+    assert (md != NULL);
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media (vlc, md);
+    assert (mp != NULL);
+    libvlc_media_release (md);
+
+    libvlc_audio_set_frame_callback(mp, on_audio_frame, &ctx);
+    play_and_wait(mp);
+    vlc_sem_wait(&ctx.sem);
+
+    libvlc_media_player_stop_async (mp);
+    libvlc_media_player_release (mp);
+    libvlc_release (vlc);
+
+    /* The decoded format is kept */
+    char format[5];
+    unsigned rate, channels, count;
+    libvlc_audio_frame_get_format(ctx.frame, format, &rate, &channels);
+    assert(strcmp(format, "FL32") == 0);
+    assert(rate == 48000);
+    assert(channels == 6);
+
+    const float *samples = libvlc_audio_frame_get_samples(ctx.frame, &count);
+    assert(samples != NULL && count > 0);
+    (void) samples[count * channels - 1];
+
+    libvlc_audio_frame_release(ctx.frame);
+}
+
+struct offline_ctx
+{
+    atomic_uint video_frames;
+    atomic_uint audio_frames;
+};
+
+static void on_offline_video_frame(void *opaque, libvlc_video_frame_t *frame)
+{
+    struct offline_ctx *ctx = opaque;
+
+    atomic_fetch_add(&ctx->video_frames, 1);
+    libvlc_video_frame_release(frame);
+}
+
+static void on_offline_audio_frame(void *opaque, libvlc_audio_frame_t *frame)
+{
+    struct offline_ctx *ctx = opaque;
+
+    atomic_fetch_add(&ctx->audio_frames, 1);
+    libvlc_audio_frame_release(frame);
+}
+
+static void test_media_player_offline(const char** argv, int argc)
+{
+    struct offline_ctx ctx;
+    const vlc_tick_t length = VLC_TICK_FROM_SEC(60);
+    char file[256];
+
+    snprintf(file, sizeof (file), "mock://video_track_count=1;"
+             "audio_track_count=1;length=%"PRId64, length);
+    test_log ("Testing offline processing of %s\n", file);
+
+    atomic_init(&ctx.video_frames, 0);
+    atomic_init(&ctx.audio_frames, 0);
+
+    const char *args[argc + 1];
+    for (int i = 0; i < argc; i++)
+        args[i] = argv[i];
+    args[argc] = "--offline";
+
+    libvlc_instance_t *vlc = libvlc_new (argc + 1, args);
+    assert (vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(file);
+    assert (md != NULL);
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media (vlc, md);
+    assert (mp != NULL);
+    libvlc_media_release (md);
+
+    libvlc_video_set_frame_callback(mp, on_offline_video_frame, &ctx);
+    libvlc_audio_set_frame_callback(mp, on_offline_audio_frame, &ctx);
+
+    libvlc_event_manager_t *em = libvlc_media_player_event_manager(mp);
+    struct event_ctx ev;
+    event_ctx_init(&ev);
+    int res = libvlc_event_attach(em, libvlc_MediaPlayerStopping, on_event,
+                                  &ev);
+    assert(!res);
+
+    vlc_tick_t start = vlc_tick_now();
+    libvlc_media_player_play(mp);
+
+    /* The whole media is processed, far quicker than in real time */
+    event_ctx_wait(&ev);
+    libvlc_event_detach(em, libvlc_MediaPlayerStopping, on_event, &ev);
+    assert(vlc_tick_now() - start < length / 2);
+
+    libvlc_media_player_stop_async (mp);
+    libvlc_media_player_release (mp);
+    libvlc_release (vlc);
+
+    /* 25 fps and 40 ms audio blocks by default: nothing is dropped */
+    unsigned count = SEC_FROM_VLC_TICK(length) * 25;
+    test_log ("%u video and %u audio frames\n",
+              atomic_load(&ctx.video_frames), atomic_load(&ctx.audio_frames));
+    assert(atomic_load(&ctx.video_frames) >= count - 1);
+    assert(atomic_load(&ctx.audio_frames) >= count - 1);
+}
+
 int main (void)
 {
     test_init();
@@ -716,6 +1006,10 @@ int main (void)
     test_media_player_tracks (test_defaults_args, test_defaults_nargs);
     test_media_player_programs (test_defaults_args, test_defaults_nargs);
     test_media_player_multiple_instance (test_defaults_args, test_defaults_nargs);
+    test_media_player_video_frames (test_defaults_args, test_defaults_nargs);
+    test_media_player_audio_frames (test_defaults_args, test_defaults_nargs);
+    test_media_player_snapshot (test_defaults_args, test_defaults_nargs);
+    test_media_player_offline (test_defaults_args, test_defaults_nargs);
 
     return 0;
 }
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * remux.c: test libvlc_remux_t
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "test.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define REMUX_COUNT 4
+
+/* 10 seconds of media, remuxed well within the test timeout */
+static const char remux_sample[] =
+    "mock://audio_track_count=1;length=10000000";
+
+static void test_remux(const char **argv, int argc)
+{
+    char dst[REMUX_COUNT][sizeof ("/tmp/libvlc-remux-XXXXXX")];
+
+    test_log("Testing batch remuxing\n");
+
+    libvlc_instance_t *vlc = libvlc_new(argc, argv);
+    assert(vlc != NULL);
+
+    libvlc_remux_t *remux = libvlc_remux_new(vlc, 2);
+    assert(remux != NULL);
+
+    for (unsigned i = 0; i < REMUX_COUNT; i++)
+    {
+        strcpy(dst[i], "/tmp/libvlc-remux-XXXXXX");
+        int fd = mkstemp(dst[i]);
+        assert(fd != -1);
+        close(fd);
+
+        assert(libvlc_remux_add(remux, remux_sample, "wav", dst[i]) == 0);
+    }
+
+    vlc_tick_t start = vlc_tick_now();
+    assert(libvlc_remux_wait(remux) == 0);
+    /* Not paced by the clock */
+    assert(vlc_tick_now() - start < VLC_TICK_FROM_SEC(5));
+
+    for (unsigned i = 0; i < REMUX_COUNT; i++)
+    {
+        struct stat st;
+
+        assert(stat(dst[i], &st) == 0);
+        assert(st.st_size > 0);
+        unlink(dst[i]);
+    }
+
+    test_log("Testing batch remuxing failures\n");
+
+    assert(libvlc_remux_add(remux, "mock://error=1", "wav",
+                            "/tmp/libvlc-remux-error") == 0);
+    assert(libvlc_remux_wait(remux) == 1);
+    unlink("/tmp/libvlc-remux-error");
+
+    libvlc_remux_release(remux);
+    libvlc_release(vlc);
+}
+
+int main(void)
+{
+    test_init();
+
+    test_remux(test_defaults_args, test_defaults_nargs);
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************
+ * format.c: PCM format converter and (de)interleaving test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+const char vlc_module_name[] = "test_audio_format";
+
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_block.h>
+#include <vlc_filter.h>
+#include <vlc_modules.h>
+
+/* Odd count, so that the scalar tails of the vector kernels run too */
+#define SAMPLES 4099
+#define BENCH_SAMPLES (1 << 20)
+#define BENCH_LOOPS 16
+
+static uint32_t seed = 1;
+
+static double Random(void)
+{
+    seed = seed * 1103515245 + 12345;
+    /* Slightly out of [-1, 1] to check the clipping */
+    return ((double)(seed >> 8) / (1 << 23)) * 2.2 - 1.1;
+}
+
+/* Sample as a double in [-1, 1], from any linear format */
+static double Get(vlc_fourcc_t fourcc, const void *buf, size_t i)
+{
+    switch (fourcc)
+    {
+        case VLC_CODEC_S16N: return ((const int16_t *)buf)[i] / 32768.;
+        case VLC_CODEC_S32N: return ((const int32_t *)buf)[i] / 2147483648.;
+        case VLC_CODEC_FL32: return ((const float *)buf)[i];
+        case VLC_CODEC_FL64: return ((const double *)buf)[i];
+    }
+    vlc_assert_unreachable();
+}
+
+static void Set(vlc_fourcc_t fourcc, void *buf, size_t i, double v)
+{
+    switch (fourcc)
+    {
+        case VLC_CODEC_S16N:
+            ((int16_t *)buf)[i] = lround(VLC_CLIP(v * 32768., INT16_MIN, INT16_MAX));
+            break;
+        case VLC_CODEC_S32N:
+            ((int32_t *)buf)[i] = llround(VLC_CLIP(v * 2147483648., INT32_MIN, INT32_MAX));
+            break;
+        case VLC_CODEC_FL32: ((float *)buf)[i] = v; break;
+        case VLC_CODEC_FL64: ((double *)buf)[i] = v; break;
+        default: vlc_assert_unreachable();
+    }
+}
+
+static block_t *NewBlock(vlc_fourcc_t fourcc, size_t samples)
+{
+    block_t *block = block_Alloc(samples * aout_BitsPerSample(fourcc) / 8);
+    assert(block != NULL);
+    for (size_t i = 0; i < samples; i++)
+        Set(fourcc, block->p_buffer, i, Random());
+    return block;
+}
+
+static void test_convert(filter_t *filter, vlc_fourcc_t src, vlc_fourcc_t dst)
+{
+    es_format_t *in = &filter->fmt_in, *out = &filter->fmt_out;
+
+    es_format_Init(in, AUDIO_ES, src);
+    in->audio.i_format = src;
+    in->audio.i_rate = 48000;
+    in->audio.i_physical_channels = AOUT_CHANS_STEREO;
+    aout_FormatPrepare(&in->audio);
+    es_format_Init(out, AUDIO_ES, dst);
+    out->audio = in->audio;
+    out->audio.i_format = dst;
+    aout_FormatPrepare(&out->audio);
+
+    module_t *module = module_need(filter, "audio converter", "audio_format",
+                                   true);
+    assert(module != NULL);
+
+    /* Compare with a conversion through doubles */
+    const unsigned src_bits = aout_BitsPerSample(src);
+    const unsigned dst_bits = aout_BitsPerSample(dst);
+    double tolerance = 1.5 / (1 << (__MIN(__MIN(src_bits, dst_bits), 24) - 1));
+
+    block_t *block = NewBlock(src, SAMPLES);
+    double *ref = malloc(SAMPLES * sizeof (*ref));
+    assert(ref != NULL);
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        ref[i] = Get(src, block->p_buffer, i);
+        if (dst == VLC_CODEC_S16N || dst == VLC_CODEC_S32N)
+            ref[i] = VLC_CLIP(ref[i], -1., 1.);
+    }
+
+    block = filter->ops->filter_audio(filter, block);
+    assert(block != NULL);
+    assert(block->i_buffer == SAMPLES * dst_bits / 8);
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        double v = Get(dst, block->p_buffer, i);
+        if (fabs(v - ref[i]) > tolerance)
+        {
+            fprintf(stderr, "%4.4s->%4.4s: sample %zu: %f != %f\n",
+                    (const char *)&src, (const char *)&dst, i, v, ref[i]);
+            abort();
+        }
+    }
+    block_Release(block);
+    free(ref);
+
+    /* Benchmark */
+    vlc_tick_t total = 0;
+    for (unsigned i = 0; i < BENCH_LOOPS; i++)
+    {
+        block = NewBlock(src, BENCH_SAMPLES);
+        vlc_tick_t start = vlc_tick_now();
+        block = filter->ops->filter_audio(filter, block);
+        total += vlc_tick_now() - start;
+        assert(block != NULL);
+        block_Release(block);
+    }
+    printf("%4.4s->%4.4s: %7.1f Msamples/s\n",
+           (const char *)&src, (const char *)&dst,
+           (double)BENCH_SAMPLES * BENCH_LOOPS
+               / (total > 0 ? US_FROM_VLC_TICK(total) : 1));
+
+    module_unneed(filter, module);
+    es_format_Clean(in);
+    es_format_Clean(out);
+}
+
+static void test_interleave(vlc_fourcc_t fourcc, unsigned chans,
+                            unsigned samples)
+{
+    const size_t size = aout_BitsPerSample(fourcc) / 8;
+    uint8_t *planar = malloc(size * chans * samples);
+    uint8_t *packed = malloc(size * chans * samples);
+    uint8_t *back = malloc(size * chans * samples);
+    const void *planes[32];
+    assert(planar != NULL && packed != NULL && back != NULL);
+    assert(chans <= ARRAY_SIZE(planes));
+
+    for (size_t i = 0; i < chans * samples; i++)
+        Set(fourcc, planar, i, Random());
+    for (unsigned c = 0; c < chans; c++)
+        planes[c] = planar + c * samples * size;
+
+    vlc_tick_t start = vlc_tick_now();
+    aout_Interleave(packed, planes, samples, chans, fourcc);
+    aout_Deinterleave(back, packed, samples, chans, fourcc);
+    vlc_tick_t total = vlc_tick_now() - start;
+
+    for (unsigned c = 0; c < chans; c++)
+        for (unsigned j = 0; j < samples; j++)
+            assert(!memcmp(packed + (j * chans + c) * size,
+                           planar + (c * samples + j) * size, size));
+    assert(!memcmp(back, planar, size * chans * samples));
+
+    printf("%4.4s x%2u (de)interleave: %7.1f Msamples/s\n",
+           (const char *)&fourcc, chans,
+           (double)chans * samples * 2
+               / (total > 0 ? US_FROM_VLC_TICK(total) : 1));
+    free(back);
+    free(packed);
+    free(planar);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    filter_t *filter = vlc_object_create(vlc->p_libvlc_int, sizeof(*filter));
+    assert(filter != NULL);
+
+    static const vlc_fourcc_t formats[] = {
+        VLC_CODEC_S16N, VLC_CODEC_S32N, VLC_CODEC_FL32, VLC_CODEC_FL64,
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(formats); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(formats); j++)
+            if (i != j)
+                test_convert(filter, formats[i], formats[j]);
+
+    test_interleave(VLC_CODEC_S16N, 2, 48000);
+    test_interleave(VLC_CODEC_FL32, 2, 48000);
+    test_interleave(VLC_CODEC_FL32, 6, 48001);
+    test_interleave(VLC_CODEC_S32N, 32, 96000);
+
+    vlc_object_delete(filter);
+    libvlc_release(vlc);
+    return 0;
+}
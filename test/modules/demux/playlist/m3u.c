@@ -203,6 +203,73 @@ static int check2(const char *run, const input_item_node_t *p_node)
     return 0;
 }
 
+/* Entries are returned in batches, the group carries over between them */
+static int runbatchtest(const char *run, libvlc_instance_t *vlc)
+{
+    const unsigned count = 2500;
+    char *data;
+    size_t datasz;
+    FILE *memstream = open_memstream(&data, &datasz);
+    if(!memstream)
+        BAILOUT(run);
+    fputs("#EXTM3U\n#EXTGRP:group0\n", memstream);
+    for(unsigned i = 0; i < count; i++)
+        fprintf(memstream, "#EXTINF:1,name%u\n" NOPURI(%u) "\n", i, i);
+    if(fclose(memstream))
+        BAILOUT(run);
+
+    stream_t *s = vlc_stream_MemoryNew(vlc->p_libvlc_int, (uint8_t *)data, datasz, false);
+    if(!s)
+    {
+        free(data);
+        BAILOUT(run);
+    }
+
+    demux_t *pl = demux_New(VLC_OBJECT(vlc->p_libvlc_int), "m3u", INPUT_ITEM_URI_NOP, s, NULL);
+    if(!pl || !pl->pf_readdir)
+    {
+        vlc_stream_Delete(s);
+        BAILOUT(run);
+    }
+
+    int ret = 1;
+    unsigned total = 0, batches = 0;
+    input_item_t *p_item = input_item_New(NULL, NULL);
+    if(p_item)
+    {
+        for(;;)
+        {
+            input_item_node_t *p_node = input_item_node_Create(p_item);
+            if(!p_node)
+                break;
+            int val = pl->pf_readdir(pl, p_node);
+            batches++;
+            for(int i = 0; i < p_node->i_children; i++)
+            {
+                const input_item_t *p_child = p_node->pp_children[i]->p_item;
+                char name[16];
+                snprintf(name, sizeof(name), "name%u", total++);
+                const char *p = vlc_meta_Get(p_child->p_meta, vlc_meta_Publisher);
+                if(strcmp(name, p_child->psz_name) || !p || strcmp("group0", p))
+                    val = VLC_EGENERIC;
+            }
+            input_item_node_Delete(p_node);
+            if(val != VLC_DEMUXER_READDIR_MORE)
+            {
+                ret = val;
+                break;
+            }
+        }
+        input_item_Release(p_item);
+    }
+
+    demux_Delete(pl);
+
+    EXPECT(ret == VLC_SUCCESS);
+    EXPECT(total == count);
+    EXPECT(batches > 1);
+    return 0;
+}
 
 int main(void)
 {
@@ -217,6 +284,8 @@ int main(void)
         ret = runtest("run1", vlc, m3uplaylist1, sizeof(m3uplaylist1), check1);
     if(!ret)
         ret = runtest("run2", vlc, m3uplaylist2, sizeof(m3uplaylist2), check2);
+    if(!ret)
+        ret = runbatchtest("run3", vlc);
 
     libvlc_release(vlc);
     return ret;
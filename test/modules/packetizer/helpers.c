@@ -90,6 +90,82 @@ static int run_annexb_sets( const uint8_t *p_set, const uint8_t *p_end,
     return 0;
 }
 
+static const uint8_t * startcode_FindAnnexB_Ref( const uint8_t *p, const uint8_t *end )
+{
+    for( ; end - p >= 3; p++ )
+        if( p[0] == 0 && p[1] == 0 && p[2] == 1 )
+            return p;
+    return NULL;
+}
+
+static int run_annexb_random( void )
+{
+    const size_t i_data = 1 << 16;
+    uint8_t *p_data = malloc( i_data );
+    if( !p_data )
+        return 0;
+
+    /* Mostly zeros and ones, to get many partial and full matches */
+    srand( 42 );
+    for( size_t i = 0; i < i_data; i++ )
+        p_data[i] = ( rand() % 8 == 0 ) ? 1 : ( rand() % 4 ) ? 0 : rand();
+
+    printf("* Running tests on random set:\n");
+    for( unsigned i = 0; i < 2000; i++ )
+    {
+        /* Cover all alignments and tail lengths */
+        const uint8_t *p = &p_data[rand() % 256];
+        const uint8_t *end = &p_data[i_data - rand() % 256];
+        while( p != NULL )
+        {
+            const uint8_t *p_ref = startcode_FindAnnexB_Ref( p, end );
+            if( startcode_FindAnnexB_Bits( p, end ) != p_ref ||
+                startcode_FindAnnexB( p, end ) != p_ref )
+            {
+                free( p_data );
+                return 1;
+            }
+            p = p_ref ? p_ref + 1 + rand() % 64 : NULL;
+            if( p >= end )
+                break;
+        }
+    }
+
+    free( p_data );
+    return 0;
+}
+
+static int run_bytestream_skip( void )
+{
+    block_bytestream_t bs;
+    block_BytestreamInit( &bs );
+
+    const char *chunks[] = { "abcd", "", "efgh", "ijkl" };
+    for( size_t i = 0; i < ARRAY_SIZE(chunks); i++ )
+    {
+        block_t *b = block_Alloc( strlen( chunks[i] ) );
+        assert( b );
+        memcpy( b->p_buffer, chunks[i], b->i_buffer );
+        block_BytestreamPush( &bs, b );
+    }
+
+    printf("* Running tests on bytestream skip:\n");
+    uint8_t c;
+    assert( block_SkipToByte( &bs, 'a' ) == VLC_SUCCESS );
+    assert( block_PeekBytes( &bs, &c, 1 ) == VLC_SUCCESS && c == 'a' );
+    assert( block_SkipToByte( &bs, 'g' ) == VLC_SUCCESS );
+    assert( block_BytestreamRemaining( &bs ) == 6 );
+    assert( block_PeekBytes( &bs, &c, 1 ) == VLC_SUCCESS && c == 'g' );
+    block_SkipByte( &bs );
+    assert( block_SkipToByte( &bs, 'j' ) == VLC_SUCCESS );
+    assert( block_GetBytes( &bs, &c, 1 ) == VLC_SUCCESS && c == 'j' );
+    assert( block_SkipToByte( &bs, 'g' ) == VLC_EGENERIC );
+    assert( block_BytestreamRemaining( &bs ) == 0 );
+
+    block_BytestreamRelease( &bs );
+    return 0;
+}
+
 int main( void )
 {
     const uint8_t test1_annexbdata[] = { 0, 0, 0, 1, 0x55, 0x55, 0x55, 0x55, 0x55, // 9
@@ -134,5 +210,9 @@ int main( void )
             return i_ret;
     }
 
-    return 0;
+    i_ret = run_annexb_random();
+    if( i_ret != 0 )
+        return i_ret;
+
+    return run_bytestream_skip();
 }
@@ -217,9 +217,26 @@ static void test_annexb()
     test_iterators( NULL, 0, p_res, rgi_res );
 }
 
+static void test_nal_equals()
+{
+    const uint8_t sps3[] = { 0x00, 0x00, 0x01, 0x67, 0xf4, 0x00, 0x0a };
+    const uint8_t sps4[] = { 0x00, 0x00, 0x00, 0x01, 0x67, 0xf4, 0x00, 0x0a };
+    const uint8_t other[] = { 0x00, 0x00, 0x01, 0x67, 0xf4, 0x00, 0x0b };
+
+    /* the startcodes are not compared */
+    assert( hxxx_AnnexB_nal_equals( sps3, sizeof(sps3), sps4, sizeof(sps4) ) );
+    assert( hxxx_AnnexB_nal_equals( sps4, sizeof(sps4), sps3, sizeof(sps3) ) );
+    assert( !hxxx_AnnexB_nal_equals( sps3, sizeof(sps3), other, sizeof(other) ) );
+    assert( !hxxx_AnnexB_nal_equals( sps4, sizeof(sps4), sps3, sizeof(sps3) - 1 ) );
+    /* missing startcode */
+    assert( !hxxx_AnnexB_nal_equals( &sps3[3], sizeof(sps3) - 3,
+                                     &sps3[3], sizeof(sps3) - 3 ) );
+}
+
 int main( void )
 {
     test_annexb();
+    test_nal_equals();
 
     return 0;
 }
@@ -36,6 +36,8 @@ static struct scenario_data
     vlc_sem_t wait_stop;
     struct vlc_video_context *decoder_vctx;
     unsigned output_frame_count;
+    unsigned rendition_frame_count;
+    bool rendition_reported;
     bool converter_opened;
     bool encoder_opened;
     bool encoder_closed;
@@ -200,6 +202,28 @@ static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
     msg_Info(enc, "Encode");
 }
 
+static void encoder_i420_800_600_rendition_400_300(encoder_t *enc)
+{
+    /* The main encoder is opened first */
+    unsigned width = scenario_data.encoder_opened ? 400 : 800;
+    unsigned height = scenario_data.encoder_opened ? 300 : 600;
+    msg_Info(enc, "Setting up the encoder I420: %ux%u", width, height);
+    assert(enc->fmt_in.video.i_visible_width == width);
+    assert(enc->fmt_in.video.i_visible_height == height);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    scenario_data.encoder_opened = true;
+}
+
+static void encoder_encode_rendition(encoder_t *enc, picture_t *pic)
+{
+    assert(pic->format.i_visible_width == enc->fmt_in.video.i_visible_width);
+    assert(pic->format.i_visible_height == enc->fmt_in.video.i_visible_height);
+    if (pic->format.i_visible_width == 400)
+        ++scenario_data.rendition_frame_count;
+}
+
 static void encoder_close(encoder_t *enc)
 {
     (void)enc;
@@ -216,6 +240,20 @@ static void wait_output_10_frames_reported(const vlc_frame_t *out)
         vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void wait_output_rendition_reported(const vlc_frame_t *out)
+{
+    for (; out != NULL; out = out->p_next )
+        ++scenario_data.output_frame_count;
+
+    if (scenario_data.output_frame_count >= 10 &&
+        scenario_data.rendition_frame_count > 0 &&
+        !scenario_data.rendition_reported)
+    {
+        scenario_data.rendition_reported = true;
+        vlc_sem_post(&scenario_data.wait_stop);
+    }
+}
+
 static void wait_output_reported(const vlc_frame_t *out)
 {
     (void)out;
@@ -241,6 +279,17 @@ static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
     scenario_data.converter_opened = true;
 }
 
+static void converter_i420_scale_to_400_300(filter_t *filter)
+{
+    assert(filter->fmt_in.video.i_visible_width == 800);
+    assert(filter->fmt_in.video.i_visible_height == 600);
+    assert(filter->fmt_out.video.i_visible_width == 400);
+    assert(filter->fmt_out.video.i_visible_height == 300);
+    assert(filter->fmt_in.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_chroma == VLC_CODEC_I420);
+    scenario_data.converter_opened = true;
+}
+
 static void converter_i420_to_nv12_800_600(filter_t *filter)
     { converter_fixed_size(filter, VLC_CODEC_I420, VLC_CODEC_NV12, 800, 600); }
 
@@ -356,6 +405,40 @@ struct transcode_scenario transcode_scenarios[] =
     .encoder_close = encoder_close,
     .converter_setup = converter_nv12_to_i420_800_600_vctx,
     .report_output = wait_output_10_frames_reported,
+},{
+    /* Same with the filters and encoder running in their own threads */
+    .source = source_800_600,
+    .sout = "sout=#transcode{threads=2}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_nv12_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_to_nv12_800_600,
+    .report_output = wait_output_reported,
+},{
+    /* Pictures decoded before a format change must still go through the
+     * previous chain when filtering is threaded */
+    .source = source_800_600,
+    .sout = "sout=#transcode{threads=2,pool-size=4}:output_checker",
+    .decoder_setup = decoder_i420_800_600_vctx,
+    .decoder_decode = decoder_decode_vctx_update,
+    .encoder_setup = encoder_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_nv12_to_i420_800_600_vctx,
+    .report_output = wait_output_10_frames_reported,
+},{
+    /* A single decode and filtering, encoded twice */
+    .source = source_800_600,
+    .sout = "sout=#transcode{renditions=400x300@500}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_800_600_rendition_400_300,
+    .encoder_encode = encoder_encode_rendition,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_scale_to_400_300,
+    .report_output = wait_output_rendition_reported,
 },{
     /* Ensure that error are correctly forwarded back to the stream output
      * pipeline. */
@@ -372,6 +455,8 @@ void transcode_scenario_init(void)
 {
     scenario_data.decoder_vctx = NULL;
     scenario_data.output_frame_count = 0;
+    scenario_data.rendition_frame_count = 0;
+    scenario_data.rendition_reported = false;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
     vlc_sem_init(&scenario_data.wait_stop, 0);
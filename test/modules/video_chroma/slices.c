@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * slices.c: band threaded chroma conversion helper unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+const char vlc_module_name[] = "test_chroma_slices";
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include <stdatomic.h>
+
+#include "../../../modules/video_chroma/slices.h"
+
+static atomic_uint bands;
+
+/* Plain copy of the planes of the band */
+static void CopyBand(filter_t *filter, picture_t *src, picture_t *dst,
+                     unsigned lines)
+{
+    (void) filter;
+    assert(src->p[Y_PLANE].i_lines >= (int)lines);
+
+    for (int i = 0; i < src->i_planes; i++)
+        for (unsigned y = 0; y < lines * (i == Y_PLANE ? 2 : 1) / 2; y++)
+            memcpy(&dst->p[i].p_pixels[y * dst->p[i].i_pitch],
+                   &src->p[i].p_pixels[y * src->p[i].i_pitch],
+                   src->p[i].i_visible_pitch);
+    atomic_fetch_add(&bands, 1);
+}
+
+static void test_convert(filter_t *filter, unsigned width, unsigned height,
+                         int threads, unsigned expected_bands)
+{
+    video_format_t fmt;
+    video_format_Init(&fmt, VLC_CODEC_I420);
+    fmt.i_width = fmt.i_visible_width = width;
+    fmt.i_height = fmt.i_visible_height = height;
+    filter->fmt_in.video = fmt;
+
+    var_SetInteger(filter, "chroma-threads", threads);
+
+    picture_t *src = picture_NewFromFormat(&fmt);
+    picture_t *dst = picture_NewFromFormat(&fmt);
+    assert(src != NULL && dst != NULL);
+
+    for (int i = 0; i < src->i_planes; i++)
+        for (int y = 0; y < src->p[i].i_lines; y++)
+        {
+            memset(&src->p[i].p_pixels[y * src->p[i].i_pitch], (y * 3 + i) & 0xff,
+                   src->p[i].i_pitch);
+            memset(&dst->p[i].p_pixels[y * dst->p[i].i_pitch], 0,
+                   dst->p[i].i_pitch);
+        }
+
+    chroma_slices_t *slices = chroma_slices_New(filter, height, 2);
+    assert(slices != NULL);
+
+    for (unsigned run = 0; run < 3; run++)
+    {
+        atomic_store(&bands, 0);
+        chroma_slices_Run(slices, filter, src, dst, CopyBand);
+        assert(atomic_load(&bands) == expected_bands);
+    }
+    chroma_slices_Delete(slices);
+
+    for (int i = 0; i < src->i_planes; i++)
+    {
+        unsigned lines = height * (i == Y_PLANE ? 2 : 1) / 2;
+        for (unsigned y = 0; y < lines; y++)
+            assert(!memcmp(&dst->p[i].p_pixels[y * dst->p[i].i_pitch],
+                           &src->p[i].p_pixels[y * src->p[i].i_pitch],
+                           src->p[i].i_visible_pitch));
+    }
+
+    picture_Release(src);
+    picture_Release(dst);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    filter_t *filter = vlc_object_create(vlc->p_libvlc_int, sizeof(*filter));
+    assert(filter != NULL);
+    var_Create(filter, "chroma-threads", VLC_VAR_INTEGER);
+
+    /* disabled */
+    test_convert(filter, 3840, 2160, 1, 1);
+    /* bands on every line, last one shorter */
+    test_convert(filter, 3840, 2160, 4, 4);
+    test_convert(filter, 1920, 1082, 3, 3);
+    /* too few lines for the requested threads */
+    test_convert(filter, 1920, 130, 8, 2);
+    /* automatic threading ignores small pictures */
+    test_convert(filter, 640, 480, 0, 1);
+
+    vlc_object_delete(filter);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*****************************************************************************
+ * deinterlace.c: slice threaded deinterlacing unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+const char vlc_module_name[] = "test_deinterlace";
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "../../../modules/video_filter/deinterlace/deinterlace.h"
+
+static uint32_t seed = 1;
+
+static uint8_t Random(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+static picture_t *NewPicture(const video_format_t *fmt, unsigned frame)
+{
+    picture_t *pic = picture_NewFromFormat(fmt);
+    assert(pic != NULL);
+
+    /* Moving gradients with noise, so that all the interpolation paths
+     * are taken */
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        plane_t *p = &pic->p[i];
+        for (int y = 0; y < p->i_lines; y++)
+            for (int x = 0; x < p->i_pitch; x++)
+            {
+                uint8_t v = (x + 3 * frame) * ((y & 1) ? 2 : 1) + (y * 5);
+                if ((x / 16 + y / 16 + frame) & 1)
+                    v ^= Random() & 0x3f;
+                p->p_pixels[y * p->i_pitch + x] = v;
+            }
+        /* Keep the high bit depth samples in range */
+        if (p->i_pixel_pitch == 2)
+            for (int y = 0; y < p->i_lines; y++)
+                for (int x = 0; x < p->i_pitch / 2; x++)
+                    ((uint16_t *)&p->p_pixels[y * p->i_pitch])[x] &= 0x3ff;
+    }
+    return pic;
+}
+
+static bool PictureEquals(const picture_t *a, const picture_t *b)
+{
+    for (int i = 0; i < a->i_planes; i++)
+        for (int y = 0; y < a->p[i].i_visible_lines; y++)
+            if (memcmp(&a->p[i].p_pixels[y * a->p[i].i_pitch],
+                       &b->p[i].p_pixels[y * b->p[i].i_pitch],
+                       a->p[i].i_visible_pitch))
+                return false;
+    return true;
+}
+
+typedef int (*render_cb)(filter_t *, picture_t *, picture_t *, int, int);
+
+static int RenderXOrdered(filter_t *filter, picture_t *dst, picture_t *src,
+                          int order, int field)
+{
+    (void) order; (void) field;
+    return RenderX(filter, dst, src);
+}
+
+/* Renders with one thread and the C line filter, then with the given
+ * threads and line filter, and compares */
+static void test_render(filter_t *filter, render_cb render, vlc_fourcc_t chroma,
+                        unsigned width, unsigned height,
+                        unsigned threads, bwdif_line_cb line)
+{
+    filter_sys_t *sys = filter->p_sys;
+    video_format_t fmt;
+
+    sys->chroma = vlc_fourcc_GetChromaDescription(chroma);
+    video_format_Init(&fmt, chroma);
+    fmt.i_width = fmt.i_visible_width = width;
+    fmt.i_height = fmt.i_visible_height = height;
+    filter->fmt_in.video = fmt;
+
+    for (unsigned i = 0; i < HISTORY_SIZE; i++)
+        sys->context.pp_history[i] = NewPicture(&fmt, i);
+
+    picture_t *ref = picture_NewFromFormat(&fmt);
+    picture_t *out = picture_NewFromFormat(&fmt);
+    assert(ref != NULL && out != NULL);
+
+    for (int order = 0; order < 2; order++)
+    {
+        sys->pf_bwdif_line = sys->chroma->pixel_size == 1 ? BwdifLine8C
+                                                          : BwdifLine16C;
+        sys->p_slices = vlc_slices_New(filter, 1, width, height);
+        assert(sys->p_slices != NULL);
+        assert(vlc_slices_Count(sys->p_slices) == 1);
+        assert(render(filter, ref, sys->context.pp_history[2], order,
+                      order) == VLC_SUCCESS);
+        vlc_slices_Delete(sys->p_slices);
+
+        sys->pf_bwdif_line = line;
+        sys->p_slices = vlc_slices_New(filter, threads, width, height);
+        assert(sys->p_slices != NULL);
+        assert(vlc_slices_Count(sys->p_slices) == threads);
+        assert(render(filter, out, sys->context.pp_history[2], order,
+                      order) == VLC_SUCCESS);
+        vlc_slices_Delete(sys->p_slices);
+
+        assert(PictureEquals(ref, out));
+    }
+
+    picture_Release(ref);
+    picture_Release(out);
+    for (unsigned i = 0; i < HISTORY_SIZE; i++)
+    {
+        picture_Release(sys->context.pp_history[i]);
+        sys->context.pp_history[i] = NULL;
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    filter_t *filter = vlc_object_create(vlc->p_libvlc_int, sizeof(*filter));
+    assert(filter != NULL);
+
+    filter_sys_t sys = { .pf_merge = Merge8BitGeneric };
+    filter->p_sys = &sys;
+
+    test_render(filter, RenderBwdif, VLC_CODEC_I420, 1920, 1080, 4,
+                BwdifLine8C);
+    test_render(filter, RenderBwdif, VLC_CODEC_I420, 1282, 720, 3,
+                BwdifLine8C);
+    test_render(filter, RenderBwdif, VLC_CODEC_I420_10L, 1920, 1080, 4,
+                BwdifLine16C);
+    test_render(filter, RenderXOrdered, VLC_CODEC_I420, 1920, 1080, 5,
+                BwdifLine8C);
+#if defined(CAN_COMPILE_AVX2) && defined(HAVE_AVX2_INTRINSICS)
+    if (vlc_CPU_AVX2())
+    {
+        test_render(filter, RenderBwdif, VLC_CODEC_I420, 1920, 1080, 1,
+                    BwdifLine8AVX2);
+        test_render(filter, RenderBwdif, VLC_CODEC_I420, 724, 576, 2,
+                    BwdifLine8AVX2);
+        test_render(filter, RenderBwdif, VLC_CODEC_I420_10L, 1284, 720, 2,
+                    BwdifLine16AVX2);
+    }
+#endif
+
+    vlc_object_delete(filter);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -73,3 +73,34 @@ libvlc_instance_t *libvlc_create(const struct vlc_run_args *args)
 
     return vlc;
 }
+
+int64_t vlc_run_stats_now(void)
+{
+    return US_FROM_VLC_TICK(vlc_tick_now());
+}
+
+void vlc_run_stats_add(struct vlc_run_stats *stats, enum vlc_run_stage stage,
+                       int64_t duration, size_t frames)
+{
+    struct vlc_run_stage_stats *st = &stats->stages[stage];
+
+    if (st->calls == st->size)
+    {
+        size_t size = st->size ? st->size * 2 : 4096;
+        int64_t *durations = realloc(st->durations,
+                                     size * sizeof (*durations));
+        if (unlikely(durations == NULL))
+            return;
+        st->durations = durations;
+        st->size = size;
+    }
+    st->durations[st->calls++] = duration;
+    st->total += duration;
+    st->frames += frames;
+}
+
+void vlc_run_stats_clean(struct vlc_run_stats *stats)
+{
+    for (size_t i = 0; i < VLC_RUN_STAGE_COUNT; i++)
+        free(stats->stages[i].durations);
+}
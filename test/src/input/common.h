@@ -18,6 +18,7 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
  *****************************************************************************/
 
+#include <stdint.h>
 #include <vlc/vlc.h>
 
 #if 0
@@ -26,6 +27,29 @@
 #define debug(...) (void)0
 #endif
 
+enum vlc_run_stage
+{
+    VLC_RUN_STAGE_DEMUX,
+    VLC_RUN_STAGE_PACKETIZE,
+    VLC_RUN_STAGE_DECODE,
+    VLC_RUN_STAGE_COUNT
+};
+
+struct vlc_run_stage_stats
+{
+    int64_t *durations; /* of each call, in microseconds */
+    int64_t total; /* sum of the durations */
+    size_t calls;
+    size_t size;
+    uintmax_t frames; /* output by the stage */
+};
+
+struct vlc_run_stats
+{
+    struct vlc_run_stage_stats stages[VLC_RUN_STAGE_COUNT];
+    uintmax_t pictures; /* decoded video pictures */
+};
+
 struct vlc_run_args
 {
     /* force specific target name (demux or decoder name). NULL to don't force
@@ -37,8 +61,16 @@ struct vlc_run_args
 
     /* true to test demux controls */
     bool test_demux_controls;
+
+    /* per-stage timings, or NULL not to collect them */
+    struct vlc_run_stats *stats;
 };
 
 void vlc_run_args_init(struct vlc_run_args *args);
 
 libvlc_instance_t *libvlc_create(const struct vlc_run_args *args);
+
+int64_t vlc_run_stats_now(void);
+void vlc_run_stats_add(struct vlc_run_stats *stats, enum vlc_run_stage stage,
+                       int64_t duration, size_t frames);
+void vlc_run_stats_clean(struct vlc_run_stats *stats);
@@ -44,6 +44,7 @@ struct decoder_owner
     decoder_t dec;
     es_format_t fmt_in;
     decoder_t *packetizer;
+    struct vlc_run_stats *stats;
 };
 
 static inline struct decoder_owner *dec_get_owner(decoder_t *dec)
@@ -65,15 +66,33 @@ static vlc_decoder_device * get_no_device( decoder_t *dec )
     return NULL;
 }
 
+static void count_output(decoder_t *dec, bool picture)
+{
+    struct vlc_run_stats *stats = dec_get_owner(dec)->stats;
+
+    if (stats != NULL)
+    {
+        stats->stages[VLC_RUN_STAGE_DECODE].frames++;
+        if (picture)
+            stats->pictures++;
+    }
+}
+
 static void queue_video(decoder_t *dec, picture_t *pic)
 {
-    (void) dec;
+    count_output(dec, true);
     picture_Release(pic);
 }
 
-static void queue_audio(decoder_t *dec, block_t *p_block)
+static int update_audio_format(decoder_t *dec)
 {
     (void) dec;
+    return 0;
+}
+
+static void queue_audio(decoder_t *dec, block_t *p_block)
+{
+    count_output(dec, false);
     block_Release(p_block);
 }
 static void queue_cc(decoder_t *dec, block_t *p_block, const decoder_cc_desc_t *desc)
@@ -83,7 +102,7 @@ static void queue_cc(decoder_t *dec, block_t *p_block, const decoder_cc_desc_t *
 }
 static void queue_sub(decoder_t *dec, subpicture_t *p_subpic)
 {
-    (void) dec;
+    count_output(dec, false);
     subpicture_Delete(p_subpic);
 }
 
@@ -123,27 +142,37 @@ void test_decoder_destroy(decoder_t *decoder)
     struct decoder_owner *owner = dec_get_owner(decoder);
 
     es_format_Clean(&owner->fmt_in);
+    es_format_Clean(&dec_get_owner(owner->packetizer)->fmt_in);
     decoder_Destroy(owner->packetizer);
     decoder_Destroy(decoder);
 }
 
-decoder_t *test_decoder_create(vlc_object_t *parent, const es_format_t *fmt)
+decoder_t *test_decoder_create(vlc_object_t *parent, const es_format_t *fmt,
+                               struct vlc_run_stats *stats)
 {
     assert(parent && fmt);
     decoder_t *packetizer = NULL;
     decoder_t *decoder = NULL;
 
-    packetizer = vlc_object_create(parent, sizeof(*packetizer));
+    /* decoder_load() uses the owner of the packetizer too */
+    struct decoder_owner *packetizer_owner =
+        vlc_object_create(parent, sizeof(*packetizer_owner));
     struct decoder_owner *owner = vlc_object_create(parent, sizeof(*owner));
 
-    if (packetizer == NULL || owner == NULL)
+    if (packetizer_owner == NULL || owner == NULL)
     {
-        if (packetizer)
-            vlc_object_delete(packetizer);
+        if (packetizer_owner)
+            vlc_object_delete(&packetizer_owner->dec);
+        if (owner)
+            vlc_object_delete(&owner->dec);
         return NULL;
     }
+    packetizer = &packetizer_owner->dec;
+    packetizer_owner->packetizer = NULL;
+    packetizer_owner->stats = NULL;
     decoder = &owner->dec;
     owner->packetizer = packetizer;
+    owner->stats = stats;
 
     static const struct decoder_owner_callbacks dec_video_cbs =
     {
@@ -156,6 +185,7 @@ decoder_t *test_decoder_create(vlc_object_t *parent, const es_format_t *fmt)
     static const struct decoder_owner_callbacks dec_audio_cbs =
     {
         .audio = {
+            .format_update = update_audio_format,
             .queue = queue_audio,
         },
     };
@@ -193,6 +223,7 @@ decoder_t *test_decoder_create(vlc_object_t *parent, const es_format_t *fmt)
 
     if (decoder_load(decoder, false, &packetizer->fmt_out) != VLC_SUCCESS)
     {
+        es_format_Clean(&packetizer_owner->fmt_in);
         decoder_Destroy(packetizer);
         vlc_object_delete(decoder);
         return NULL;
@@ -201,6 +232,39 @@ decoder_t *test_decoder_create(vlc_object_t *parent, const es_format_t *fmt)
     return decoder;
 }
 
+static block_t *packetize(struct decoder_owner *owner, block_t **pp_block)
+{
+    decoder_t *packetizer = owner->packetizer;
+
+    if (owner->stats == NULL)
+        return packetizer->pf_packetize(packetizer, pp_block);
+
+    int64_t start = vlc_run_stats_now();
+    block_t *out = packetizer->pf_packetize(packetizer, pp_block);
+    int64_t duration = vlc_run_stats_now() - start;
+    size_t count = 0;
+
+    for (block_t *b = out; b != NULL; b = b->p_next)
+        count++;
+    vlc_run_stats_add(owner->stats, VLC_RUN_STAGE_PACKETIZE, duration, count);
+    return out;
+}
+
+static int decode(struct decoder_owner *owner, block_t *block)
+{
+    decoder_t *decoder = &owner->dec;
+
+    if (owner->stats == NULL)
+        return decoder->pf_decode(decoder, block);
+
+    /* The decoded frames are counted as they are queued */
+    int64_t start = vlc_run_stats_now();
+    int ret = decoder->pf_decode(decoder, block);
+    vlc_run_stats_add(owner->stats, VLC_RUN_STAGE_DECODE,
+                      vlc_run_stats_now() - start, 0);
+    return ret;
+}
+
 int test_decoder_process(decoder_t *decoder, block_t *p_block)
 {
     struct decoder_owner *owner = dec_get_owner(decoder);
@@ -216,8 +280,7 @@ int test_decoder_process(decoder_t *decoder, block_t *p_block)
 
     block_t **pp_block = p_block ? &p_block : NULL;
     block_t *p_packetized_block;
-    while ((p_packetized_block =
-                packetizer->pf_packetize(packetizer, pp_block)))
+    while ((p_packetized_block = packetize(owner, pp_block)))
     {
 
         if (!es_format_IsSimilar(decoder->fmt_in, &packetizer->fmt_out))
@@ -251,7 +314,7 @@ int test_decoder_process(decoder_t *decoder, block_t *p_block)
             block_t *p_next = p_packetized_block->p_next;
             p_packetized_block->p_next = NULL;
 
-            int ret = decoder->pf_decode(decoder, p_packetized_block);
+            int ret = decode(owner, p_packetized_block);
 
             if (ret == VLCDEC_ECRITICAL)
             {
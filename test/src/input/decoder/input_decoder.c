@@ -88,7 +88,7 @@ static int DecoderDecode(decoder_t *dec, block_t *block)
     struct input_decoder_scenario *scenario = &input_decoder_scenarios[current_scenario];
     assert(scenario->decoder_decode != NULL);
     int ret = scenario->decoder_decode(dec, pic);
-    if (ret != VLCDEC_RELOAD)
+    if (ret != VLCDEC_RELOAD && ret != VLCDEC_FALLBACK)
         block_Release(block);
     return ret;
 }
@@ -137,6 +137,23 @@ static int OpenDecoder(vlc_object_t *obj)
     return VLC_SUCCESS;
 }
 
+static int OpenFallbackDecoder(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t*)obj;
+
+    struct input_decoder_scenario *scenario = &input_decoder_scenarios[current_scenario];
+    if (scenario->decoder_fallback_setup == NULL)
+        return VLC_EGENERIC;
+
+    dec->pf_decode = DecoderDecode;
+    dec->pf_flush = DecoderFlush;
+    es_format_Clean(&dec->fmt_out);
+    es_format_Copy(&dec->fmt_out, dec->fmt_in);
+
+    scenario->decoder_fallback_setup(dec);
+    return VLC_SUCCESS;
+}
+
 static void DisplayPrepare(vout_display_t *vd, picture_t *picture,
         subpicture_t *subpic, vlc_tick_t date)
 {
@@ -296,6 +313,7 @@ static int OpenIntf(vlc_object_t *obj)
  * Inject the mocked modules as a static plugin:
  *  - access for triggering the correct decoder
  *  - decoder for generating video format and context
+ *  - fallback decoder, only loaded by the scenarios that need it
  *  - filter for generating video format and context
  **/
 vlc_module_begin()
@@ -311,6 +329,10 @@ vlc_module_begin()
         set_callbacks(OpenDecoder, CloseDecoder)
         set_capability("video decoder", INT_MAX)
 
+    add_submodule()
+        set_callbacks(OpenFallbackDecoder, CloseDecoder)
+        set_capability("video decoder", 1)
+
     add_submodule()
         set_callback(OpenWindow)
         set_capability("vout window", INT_MAX)
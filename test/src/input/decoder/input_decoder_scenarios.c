@@ -43,6 +43,7 @@ static struct scenario_data
     struct vlc_video_context *decoder_vctx;
     bool skip_decoder;
     bool has_reload;
+    bool has_fallback;
     bool stream_out_sent;
     size_t decoder_image_sent;
 } scenario_data;
@@ -246,6 +247,26 @@ static int decoder_decode_trigger_reload(decoder_t *dec, picture_t *pic)
     return VLCDEC_SUCCESS;
 }
 
+static void decoder_i420_800_600_once(decoder_t *dec)
+{
+    /* The module that failed must not be probed again */
+    assert(!scenario_data.has_fallback);
+    decoder_i420_800_600(dec);
+}
+
+static int decoder_decode_trigger_fallback(decoder_t *dec, picture_t *pic)
+{
+    (void)dec;
+    picture_Release(pic);
+
+    if (!scenario_data.has_fallback)
+    {
+        scenario_data.has_fallback = true;
+        return VLCDEC_FALLBACK;
+    }
+    return VLCDEC_SUCCESS;
+}
+
 static void display_prepare_signal(vout_display_t *vd, picture_t *pic)
 {
     (void)vd;
@@ -371,6 +392,14 @@ struct input_decoder_scenario input_decoder_scenarios[] =
     .decoder_setup = decoder_i420_800_600,
     .decoder_decode = decoder_decode_trigger_reload,
     .decoder_destroy = decoder_destroy_trigger_update,
+},
+{
+    /* Check that a decoder failing mid-stream is replaced by the next
+     * decoder module, and is not loaded again even if forced by name. */
+    .source = source_800_600,
+    .decoder_setup = decoder_i420_800_600_once,
+    .decoder_fallback_setup = decoder_i420_800_600_stop,
+    .decoder_decode = decoder_decode_trigger_fallback,
 }};
 size_t input_decoder_scenarios_count = ARRAY_SIZE(input_decoder_scenarios);
 
@@ -379,6 +408,7 @@ void input_decoder_scenario_init(void)
     scenario_data.decoder_vctx = NULL;
     scenario_data.skip_decoder = false;
     scenario_data.has_reload = false;
+    scenario_data.has_fallback = false;
     scenario_data.stream_out_sent = false;
     scenario_data.decoder_image_sent = 0;
     vlc_sem_init(&scenario_data.wait_stop, 0);
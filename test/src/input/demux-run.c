@@ -53,6 +53,7 @@ struct test_es_out_t
 {
     struct es_out_t out;
     struct es_out_id_t *ids;
+    struct vlc_run_stats *stats;
 #ifdef HAVE_DECODERS
     vlc_object_t *parent;
 #endif
@@ -83,7 +84,7 @@ static es_out_id_t *EsOutAdd(es_out_t *out, input_source_t* in, const es_format_
     ctx->ids = id;
 #ifdef HAVE_DECODERS
     es_format_Copy(&id->fmt, fmt);
-    id->decoder = test_decoder_create(ctx->parent, &id->fmt);
+    id->decoder = test_decoder_create(ctx->parent, &id->fmt, ctx->stats);
     if (id->decoder == NULL)
         es_format_Clean(&id->fmt);
 #endif
@@ -107,6 +108,8 @@ static int EsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
 
     //debug("[%p] Sent    ES: %zu\n", (void *)idd, block->i_buffer);
     EsOutCheckId(ctx, id);
+    if (ctx->stats != NULL)
+        ctx->stats->stages[VLC_RUN_STAGE_DEMUX].frames++;
 #ifdef HAVE_DECODERS
     if (id->decoder)
         test_decoder_process(id->decoder, block);
@@ -162,7 +165,7 @@ static int EsOutControl(es_out_t *out, input_source_t* in, int query, va_list ar
             es_out_id_t* id = va_arg(args, es_out_id_t*);
             EsOutCheckId(ctx, id);
             test_decoder_destroy(id->decoder);
-            test_decoder_create(ctx->parent, &id->fmt);
+            test_decoder_create(ctx->parent, &id->fmt, ctx->stats);
 #endif
             break;
         }
@@ -222,7 +225,8 @@ static const struct es_out_callbacks es_out_cbs =
     .destroy = EsOutDestroy,
 };
 
-static es_out_t *test_es_out_create(vlc_object_t *parent)
+static es_out_t *test_es_out_create(vlc_object_t *parent,
+                                    struct vlc_run_stats *stats)
 {
     struct test_es_out_t *ctx = malloc(sizeof (*ctx));
     if (ctx == NULL)
@@ -232,6 +236,7 @@ static es_out_t *test_es_out_create(vlc_object_t *parent)
     }
 
     ctx->ids = NULL;
+    ctx->stats = stats;
 
     es_out_t *out = &ctx->out;
     out->cbs = &es_out_cbs;
@@ -281,6 +286,24 @@ static void demux_get_meta(demux_t *demux)
     vlc_meta_Delete(p_meta);
 }
 
+static int demux_run_once(demux_t *demux, struct vlc_run_stats *stats)
+{
+    if (stats == NULL)
+        return demux_Demux(demux);
+
+    /* The ES output decodes synchronously: do not account for it */
+    struct vlc_run_stage_stats *pk = &stats->stages[VLC_RUN_STAGE_PACKETIZE];
+    struct vlc_run_stage_stats *dec = &stats->stages[VLC_RUN_STAGE_DECODE];
+    int64_t nested = pk->total + dec->total;
+    int64_t start = vlc_run_stats_now();
+    int val = demux_Demux(demux);
+    int64_t duration = vlc_run_stats_now() - start;
+
+    duration -= pk->total + dec->total - nested;
+    vlc_run_stats_add(stats, VLC_RUN_STAGE_DEMUX, duration, 0);
+    return val;
+}
+
 static int demux_process_stream(const struct vlc_run_args *args, stream_t *s)
 {
     const char *name = args->name;
@@ -290,7 +313,7 @@ static int demux_process_stream(const struct vlc_run_args *args, stream_t *s)
     if (s == NULL)
         return -1;
 
-    es_out_t *out = test_es_out_create(VLC_OBJECT(s));
+    es_out_t *out = test_es_out_create(VLC_OBJECT(s), args->stats);
     if (out == NULL)
         return -1;
 
@@ -306,7 +329,7 @@ static int demux_process_stream(const struct vlc_run_args *args, stream_t *s)
     uintmax_t i = 0;
     int val;
 
-    while ((val = demux_Demux(demux)) == VLC_DEMUXER_SUCCESS)
+    while ((val = demux_run_once(demux, args->stats)) == VLC_DEMUXER_SUCCESS)
     {
         if (args->test_demux_controls)
         {
@@ -35,7 +35,8 @@
 #include <unistd.h>
 
 #ifndef TEST_NET
-#define RAND_FILE_SIZE (1024 * 1024)
+/* Bigger than a cache_read track */
+#define RAND_FILE_SIZE (16 * 1024 * 1024)
 #else
 #define HTTP_URL "http://streams.videolan.org/streams/ogm/MJPEG.ogm"
 #define HTTP_MD5 "4eaf9e8837759b670694398a33f02bc0"
@@ -340,6 +341,13 @@ test( struct reader **pp_readers, unsigned int i_readers, const char *psz_md5 )
     PEEK_AT( i_size - 23, 46 );
     PEEK_AT( i_size / 2, 46 );
     PEEK_AT( 0, 46 );
+
+    /* Test header, then index at the end, then data */
+    READ_AT( 0, 4096 );
+    READ_AT( i_size - 4096, 4096 );
+    i_offset = 4096;
+    while( i_offset < i_size / 2 && ( i_ret = READ_AT( i_offset, 4096 ) ) > 0 )
+        i_offset += i_ret;
 }
 
 #ifndef TEST_NET
@@ -199,6 +199,167 @@ static void test_cancel_thumbnail( libvlc_instance_t* p_vlc )
     vlc_thumbnailer_Release( p_thumbnailer );
 }
 
+struct test_batch_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    size_t count;
+};
+
+static void thumbnailer_batch_callback( void* data, size_t index,
+                                        picture_t* thumbnail )
+{
+    struct test_batch_ctx* p_ctx = data;
+    vlc_mutex_lock( &p_ctx->lock );
+
+    assert( index == p_ctx->count && "Unexpected thumbnail order" );
+    assert( thumbnail != NULL );
+    assert( thumbnail->format.i_chroma == VLC_CODEC_ARGB );
+
+    p_ctx->count++;
+    vlc_cond_signal( &p_ctx->cond );
+    vlc_mutex_unlock( &p_ctx->lock );
+}
+
+static void test_batch_thumbnails( libvlc_instance_t* p_vlc )
+{
+    vlc_thumbnailer_t* p_thumbnailer = vlc_thumbnailer_Create(
+                VLC_OBJECT( p_vlc->p_libvlc_int ) );
+    assert( p_thumbnailer != NULL );
+
+    static const vlc_tick_t times[] = {
+        VLC_TICK_FROM_SEC( 1 ), VLC_TICK_FROM_SEC( 30 ), VLC_TICK_FROM_SEC( 10 ),
+        VLC_TICK_FROM_SEC( 59 ),
+    };
+
+    for ( int fast = 0; fast < 2; ++fast )
+    {
+        struct test_batch_ctx ctx;
+        vlc_cond_init( &ctx.cond );
+        vlc_mutex_init( &ctx.lock );
+        ctx.count = 0;
+
+        input_item_t* p_item = input_item_New(
+            "mock://video_track_count=1;audio_track_count=1;length=60000000;"
+            "video_chroma=ARGB", "mock item" );
+        assert( p_item != NULL );
+
+        vlc_mutex_lock( &ctx.lock );
+
+        vlc_thumbnailer_request_t* p_req =
+            vlc_thumbnailer_RequestBatchByTime( p_thumbnailer, times,
+                ARRAY_SIZE(times), fast ? VLC_THUMBNAILER_SEEK_FAST
+                                        : VLC_THUMBNAILER_SEEK_PRECISE,
+                p_item, VLC_TICK_INVALID, thumbnailer_batch_callback, &ctx );
+        assert( p_req != NULL );
+
+        while ( ctx.count < ARRAY_SIZE(times) )
+            vlc_cond_wait( &ctx.cond, &ctx.lock );
+
+        vlc_thumbnailer_DestroyRequest( p_thumbnailer, p_req );
+        vlc_mutex_unlock( &ctx.lock );
+
+        input_item_Release( p_item );
+    }
+    vlc_thumbnailer_Release( p_thumbnailer );
+}
+
+struct test_priority_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    int order[3];
+    size_t count;
+};
+
+static void thumbnailer_priority_callback( struct test_priority_ctx* p_ctx,
+                                           int id )
+{
+    vlc_mutex_lock( &p_ctx->lock );
+    assert( p_ctx->count < ARRAY_SIZE(p_ctx->order) );
+    p_ctx->order[p_ctx->count++] = id;
+    vlc_cond_signal( &p_ctx->cond );
+    vlc_mutex_unlock( &p_ctx->lock );
+}
+
+static void thumbnailer_priority_callback_0( void* data, picture_t* thumbnail )
+{
+    (void) thumbnail;
+    thumbnailer_priority_callback( data, 0 );
+}
+
+static void thumbnailer_priority_callback_1( void* data, picture_t* thumbnail )
+{
+    (void) thumbnail;
+    thumbnailer_priority_callback( data, 1 );
+}
+
+static void thumbnailer_priority_callback_2( void* data, picture_t* thumbnail )
+{
+    (void) thumbnail;
+    thumbnailer_priority_callback( data, 2 );
+}
+
+static void test_priority_thumbnails( libvlc_instance_t* p_vlc )
+{
+    vlc_thumbnailer_t* p_thumbnailer = vlc_thumbnailer_Create(
+                VLC_OBJECT( p_vlc->p_libvlc_int ) );
+    assert( p_thumbnailer != NULL );
+
+    struct test_priority_ctx ctx;
+    vlc_cond_init( &ctx.cond );
+    vlc_mutex_init( &ctx.lock );
+    ctx.count = 0;
+
+    /* Keeps the thumbnailer busy until its timeout, so that the next
+     * requests are queued (if it is not started yet, it stays first, as the
+     * first request made with its priority) */
+    input_item_t* p_busy = input_item_New(
+        "mock://video_track_count=0;audio_track_count=1;"
+        "can_control_pace=false;length=10000000", "mock busy item" );
+    input_item_t* p_item = input_item_New(
+        "mock://video_track_count=1;audio_track_count=0;length=60000000;"
+        "video_chroma=ARGB", "mock item" );
+    assert( p_busy != NULL && p_item != NULL );
+
+    vlc_thumbnailer_request_t* p_reqs[] = {
+        vlc_thumbnailer_RequestByTime( p_thumbnailer, VLC_TICK_FROM_SEC( 1 ),
+            VLC_THUMBNAILER_SEEK_FAST, p_busy, VLC_TICK_FROM_MS( 200 ),
+            thumbnailer_priority_callback_0, &ctx ),
+        vlc_thumbnailer_RequestByTime( p_thumbnailer, VLC_TICK_FROM_SEC( 1 ),
+            VLC_THUMBNAILER_SEEK_FAST, p_item, VLC_TICK_FROM_SEC( 1 ),
+            thumbnailer_priority_callback_1, &ctx ),
+        vlc_thumbnailer_RequestByTime( p_thumbnailer, VLC_TICK_FROM_SEC( 1 ),
+            VLC_THUMBNAILER_SEEK_FAST, p_item, VLC_TICK_FROM_SEC( 1 ),
+            thumbnailer_priority_callback_2, &ctx ),
+    };
+    for ( size_t i = 0; i < ARRAY_SIZE(p_reqs); ++i )
+        assert( p_reqs[i] != NULL );
+
+    /* The last request overtakes the second one */
+    vlc_thumbnailer_SetPriority( p_thumbnailer, p_reqs[0],
+                                 VLC_THUMBNAILER_PRIORITY_VISIBLE );
+    vlc_thumbnailer_SetPriority( p_thumbnailer, p_reqs[1],
+                                 VLC_THUMBNAILER_PRIORITY_BACKGROUND );
+    vlc_thumbnailer_SetPriority( p_thumbnailer, p_reqs[2],
+                                 VLC_THUMBNAILER_PRIORITY_VISIBLE );
+
+    vlc_mutex_lock( &ctx.lock );
+    while ( ctx.count < ARRAY_SIZE(ctx.order) )
+        vlc_cond_wait( &ctx.cond, &ctx.lock );
+    vlc_mutex_unlock( &ctx.lock );
+
+    assert( ctx.order[0] == 0 );
+    assert( ctx.order[1] == 2 );
+    assert( ctx.order[2] == 1 );
+
+    for ( size_t i = 0; i < ARRAY_SIZE(p_reqs); ++i )
+        vlc_thumbnailer_DestroyRequest( p_thumbnailer, p_reqs[i] );
+    input_item_Release( p_item );
+    input_item_Release( p_busy );
+    vlc_thumbnailer_Release( p_thumbnailer );
+}
+
 int main()
 {
     test_init();
@@ -212,6 +373,8 @@ int main()
 
     test_thumbnails( vlc );
     test_cancel_thumbnail( vlc );
+    test_batch_thumbnails( vlc );
+    test_priority_thumbnails( vlc );
 
     libvlc_release( vlc );
 }
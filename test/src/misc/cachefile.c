@@ -0,0 +1,137 @@
+/*****************************************************************************
+ * cachefile.c: test the files of the user cache directory
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <sys/stat.h>
+
+#include <vlc_common.h>
+#include <vlc_cachefile.h>
+#include <vlc_fs.h>
+
+#define ENTRY_SIZE 1000
+
+/* Returns the first character of an entry, or 0 if there is none */
+static int Load(const char *key)
+{
+    FILE *file = vlc_cachefile_Open("test", key);
+    if (file == NULL)
+        return 0;
+
+    int c = fgetc(file);
+    fclose(file);
+    return c;
+}
+
+static void Store(vlc_object_t *obj, const char *key, char c,
+                  uint64_t max_size)
+{
+    int previous = Load(key);
+    vlc_cachefile_t *entry = vlc_cachefile_Create(obj, "test", key);
+    assert(entry != NULL);
+
+    FILE *file = vlc_cachefile_GetFile(entry);
+    for (unsigned i = 0; i < ENTRY_SIZE; i++)
+        fputc(c, file);
+    fflush(file);
+
+    /* The previous entry is kept until committed */
+    assert(Load(key) == previous);
+    assert(vlc_cachefile_Commit(entry, max_size) == VLC_SUCCESS);
+    assert(Load(key) == c);
+}
+
+static unsigned CountEntries(const char *dirpath)
+{
+    DIR *dir = vlc_opendir(dirpath);
+    assert(dir != NULL);
+
+    unsigned count = 0;
+    const char *name;
+    while ((name = vlc_readdir(dir)) != NULL)
+        if (name[0] != '.')
+            count++;
+    closedir(dir);
+    return count;
+}
+
+int main(void)
+{
+    char tmpdir[] = "/tmp/vlc-test-cachefile-XXXXXX";
+
+    test_init();
+    assert(mkdtemp(tmpdir) != NULL);
+    setenv("XDG_CACHE_HOME", tmpdir, 1);
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    /* Store, replace and discard */
+    assert(Load("key1") == 0);
+    Store(obj, "key1", 'a', UINT64_MAX);
+    assert(Load("key1") == 'a');
+    Store(obj, "key1", 'b', UINT64_MAX);
+    assert(Load("key1") == 'b');
+
+    vlc_cachefile_t *entry = vlc_cachefile_Create(obj, "test", "key1");
+    assert(entry != NULL);
+    fputc('c', vlc_cachefile_GetFile(entry));
+    vlc_cachefile_Abort(entry);
+    assert(Load("key1") == 'b');
+
+    char *path = vlc_cachefile_GetPath("test", "key1");
+    assert(path != NULL);
+    char *dir = strdup(path);
+    assert(dir != NULL);
+    *strrchr(dir, DIR_SEP_CHAR) = '\0';
+    assert(CountEntries(dir) == 1);
+
+    /* The size limit keeps the entry just stored */
+    Store(obj, "key2", 'd', 2 * ENTRY_SIZE);
+    assert(CountEntries(dir) == 2);
+    Store(obj, "key3", 'e', 2 * ENTRY_SIZE);
+    assert(CountEntries(dir) == 2);
+    assert(Load("key3") == 'e');
+    Store(obj, "key4", 'f', ENTRY_SIZE / 2);
+    assert(CountEntries(dir) == 1);
+    assert(Load("key4") == 'f');
+
+    vlc_unlink(path);
+    free(path);
+    path = vlc_cachefile_GetPath("test", "key4");
+    assert(path != NULL);
+    vlc_unlink(path);
+    free(path);
+    rmdir(dir);
+    *strrchr(dir, DIR_SEP_CHAR) = '\0';
+    rmdir(dir);
+    rmdir(tmpdir);
+    free(dir);
+
+    libvlc_release(vlc);
+    return 0;
+}
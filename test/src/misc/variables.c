@@ -444,6 +444,55 @@ static void test_creation_and_type( libvlc_int_t *p_libvlc )
     assert( var_Get( p_libvlc, "bla", &val ) == VLC_ENOENT );
 }
 
+static void test_handles( libvlc_int_t *p_libvlc )
+{
+    vlc_object_t *obj = vlc_object_create( p_libvlc, sizeof( *obj ) );
+    assert( obj != NULL );
+
+    /* Inherited from the parent */
+    var_Create( p_libvlc, "bla", VLC_VAR_INTEGER );
+    var_SetInteger( p_libvlc, "bla", 4212 );
+    var_Create( p_libvlc, "bla-str", VLC_VAR_STRING );
+    var_SetString( p_libvlc, "bla-str", "foo" );
+
+    vlc_var_handle_t *handle = var_HandleNew( obj, "bla", VLC_VAR_INTEGER );
+    vlc_var_handle_t *str = var_HandleNew( obj, "bla-str", VLC_VAR_STRING );
+    assert( handle != NULL && str != NULL );
+
+    assert( var_HandleGetInteger( handle ) == 4212 );
+    assert( var_HandleGetInteger( handle ) == 4212 );
+    var_SetInteger( p_libvlc, "bla", 1337 );
+    assert( var_HandleGetInteger( handle ) == 1337 );
+
+    /* Overridden by the object itself */
+    var_Create( obj, "bla", VLC_VAR_INTEGER );
+    var_SetInteger( obj, "bla", -1 );
+    assert( var_HandleGetInteger( handle ) == -1 );
+    var_Destroy( obj, "bla" );
+    assert( var_HandleGetInteger( handle ) == 1337 );
+
+    assert( !strcmp( var_HandleGetString( str ), "foo" ) );
+    var_SetString( p_libvlc, "bla-str", "bar" );
+    assert( !strcmp( var_HandleGetString( str ), "bar" ) );
+
+    var_HandleDelete( str );
+    var_HandleDelete( handle );
+    var_Destroy( p_libvlc, "bla-str" );
+    var_Destroy( p_libvlc, "bla" );
+
+    /* Inherited from the configuration */
+    int64_t caching = config_GetInt( "file-caching" );
+    handle = var_HandleNew( obj, "file-caching", VLC_VAR_INTEGER );
+    assert( handle != NULL );
+    assert( var_HandleGetInteger( handle ) == caching );
+    config_PutInt( "file-caching", caching + 1 );
+    assert( var_HandleGetInteger( handle ) == caching + 1 );
+    config_PutInt( "file-caching", caching );
+    var_HandleDelete( handle );
+
+    vlc_object_delete( obj );
+}
+
 static void test_variables( libvlc_instance_t *p_vlc )
 {
     libvlc_int_t *p_libvlc = p_vlc->p_libvlc_int;
@@ -481,6 +530,9 @@ static void test_variables( libvlc_instance_t *p_vlc )
 
     test_log( "Testing type at creation\n" );
     test_creation_and_type( p_libvlc );
+
+    test_log( "Testing handles\n" );
+    test_handles( p_libvlc );
 }
 
 
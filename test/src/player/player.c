@@ -1123,6 +1123,22 @@ test_programs(struct ctx *ctx)
     }
     assert(vlc_player_GetProgramCount(player) == params.program_count);
 
+    /* The lock-free copy matches the locked getters */
+    {
+        size_t count;
+        struct vlc_player_program **prgms =
+            vlc_player_CopyProgramList(player, &count);
+        assert(count == params.program_count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const struct vlc_player_program *prgm =
+                vlc_player_GetProgramAt(player, i);
+            assert(prgms[i]->group_id == prgm->group_id);
+            assert(prgms[i]->selected == prgm->selected);
+        }
+        vlc_player_program_DeleteList(prgms, count);
+    }
+
     /* Select every programs ! */
     while (true)
     {
@@ -1316,6 +1332,23 @@ test_tracks(struct ctx *ctx, bool packetized)
         }
     }
 
+    /* The lock-free copies match the locked getters */
+    for (enum es_format_category_e cat = VIDEO_ES; cat < DATA_ES; ++cat)
+    {
+        size_t count;
+        struct vlc_player_track **tracks =
+            vlc_player_CopyTrackList(player, cat, &count);
+        assert(count == vlc_player_GetTrackCount(player, cat));
+        for (size_t i = 0; i < count; ++i)
+        {
+            const struct vlc_player_track *track =
+                vlc_player_GetTrackAt(player, cat, i);
+            assert(tracks[i]->es_id == track->es_id);
+            assert(tracks[i]->selected == track->selected);
+        }
+        vlc_player_track_DeleteList(tracks, count);
+    }
+
     static const enum es_format_category_e cats[] = {
         SPU_ES, VIDEO_ES, AUDIO_ES /* Test SPU before the vout is disabled */
     };
@@ -167,10 +167,21 @@ static int OpenWindow(vlc_window_t *wnd)
     return VLC_SUCCESS;
 }
 
+static void Prepare(vout_display_t *vd, picture_t *picture,
+                    subpicture_t *subpic, vlc_tick_t date)
+{
+    (void) subpic; (void) date;
+
+    struct vout_scenario *scenario = &vout_scenarios[current_scenario];
+    if (scenario->display_prepare != NULL)
+        scenario->display_prepare(vd, picture);
+}
+
 static void Display(vout_display_t *vd, picture_t *picture)
 {
-    (void) vd;
-    (void) picture;
+    struct vout_scenario *scenario = &vout_scenarios[current_scenario];
+    if (scenario->display_display != NULL)
+        scenario->display_display(vd, picture);
 }
 
 static int OpenDisplay(vout_display_t *vd, video_format_t *fmtp,
@@ -178,6 +189,7 @@ static int OpenDisplay(vout_display_t *vd, video_format_t *fmtp,
 {
     static const struct vlc_display_operations ops =
     {
+        .prepare = Prepare,
         .display = Display,
     };
     vd->ops = &ops;
@@ -40,6 +40,10 @@ static struct scenario_data
     bool test_finished;
 
     vlc_fourcc_t display_chroma;
+
+    /* Pictures prepared and not displayed yet */
+    picture_t *prepared[4];
+    unsigned prepared_count;
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -110,6 +114,25 @@ end:
     block_Release(block);
 }
 
+static void decoder_decode_queue(decoder_t *dec, block_t *block)
+{
+    if (scenario_data.test_finished)
+        goto end;
+
+    if (decoder_UpdateVideoOutput(dec, NULL) != 0)
+        goto end;
+
+    picture_t *pic = decoder_NewPicture(dec);
+    if (pic == NULL)
+        goto end;
+
+    pic->date = block->i_pts;
+    pic->b_progressive = true;
+    decoder_QueueVideo(dec, pic);
+end:
+    block_Release(block);
+}
+
 static int display_fixed_size(vout_display_t *vd, video_format_t *fmtp,
         struct vlc_video_context *vctx, vlc_fourcc_t chroma,
         unsigned width, unsigned height)
@@ -144,6 +167,45 @@ static int display_800_600_fail_second_time(
         struct vlc_video_context *vctx)
     { return display_fail_second_time(vd, fmtp, vctx, 800, 600); }
 
+static int display_render_ahead(vout_display_t *vd, video_format_t *fmtp,
+                                struct vlc_video_context *vctx)
+{
+    vd->info.queue_depth = 2;
+    return display_fixed_size(vd, fmtp, vctx, fmtp->i_chroma, 800, 600);
+}
+
+static void display_prepare_ahead(vout_display_t *vd, picture_t *pic)
+{
+    (void) vd;
+
+    /* No more than the queue depth may wait to be displayed */
+    if (scenario_data.test_finished)
+        return;
+
+    assert(scenario_data.prepared_count < 2);
+    scenario_data.prepared[scenario_data.prepared_count++] = pic;
+}
+
+static void display_display_ahead(vout_display_t *vd, picture_t *pic)
+{
+    (void) vd;
+
+    if (scenario_data.test_finished)
+        return;
+
+    /* The pictures are displayed in the order they were prepared */
+    assert(scenario_data.prepared_count > 0);
+    assert(scenario_data.prepared[0] == pic);
+    scenario_data.prepared[0] = scenario_data.prepared[1];
+    scenario_data.prepared_count--;
+
+    if (++scenario_data.display_picture_count == 10)
+    {
+        scenario_data.test_finished = true;
+        vlc_sem_post(&scenario_data.wait_stop);
+    }
+}
+
 const char source_800_600[] = "mock://video_track_count=1;length=100000000000;video_width=800;video_height=600";
 struct vout_scenario vout_scenarios[] =
 {{
@@ -151,6 +213,13 @@ struct vout_scenario vout_scenarios[] =
     .decoder_setup = decoder_rgba_800_600,
     .decoder_decode = decoder_decode_change_chroma,
     .display_setup = display_800_600_fail_second_time,
+},{
+    .source = source_800_600,
+    .decoder_setup = decoder_rgba_800_600,
+    .decoder_decode = decoder_decode_queue,
+    .display_setup = display_render_ahead,
+    .display_prepare = display_prepare_ahead,
+    .display_display = display_display_ahead,
 }};
 size_t vout_scenarios_count = ARRAY_SIZE(vout_scenarios);
 
@@ -161,6 +230,7 @@ void vout_scenario_init(void)
     scenario_data.converter_opened = false;
     scenario_data.display_opened = false;
     scenario_data.test_finished = false;
+    scenario_data.prepared_count = 0;
     vlc_sem_init(&scenario_data.wait_stop, 0);
 }
 
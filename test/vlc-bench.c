@@ -0,0 +1,153 @@
+/**
+ * @file vlc-bench.c
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Demuxes, packetizes and decodes files as fast as possible, and prints one
+ * JSON object per file with the timings of each stage.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+# include <sys/resource.h>
+#endif
+#include "src/input/demux-run.h"
+
+static const char *const stage_names[VLC_RUN_STAGE_COUNT] = {
+    [VLC_RUN_STAGE_DEMUX] = "demux",
+    [VLC_RUN_STAGE_PACKETIZE] = "packetize",
+    [VLC_RUN_STAGE_DECODE] = "decode",
+};
+
+static int cmp_duration(const void *a, const void *b)
+{
+    int64_t da = *(const int64_t *)a, db = *(const int64_t *)b;
+
+    return (da > db) - (da < db);
+}
+
+/* Nearest-rank percentile of sorted durations */
+static int64_t percentile(const struct vlc_run_stage_stats *st, unsigned p)
+{
+    size_t rank = (st->calls * p + 99) / 100;
+
+    return st->durations[rank > 0 ? rank - 1 : 0];
+}
+
+static void print_string(const char *str)
+{
+    putchar('"');
+    for (; *str != '\0'; str++)
+    {
+        unsigned char c = *str;
+
+        if (c == '"' || c == '\\')
+            printf("\\%c", c);
+        else if (c < 0x20)
+            printf("\\u%04x", c);
+        else
+            putchar(c);
+    }
+    putchar('"');
+}
+
+static void print_report(const char *path, int ret, int64_t wall,
+                         struct vlc_run_stats *stats)
+{
+    printf("{\"file\":");
+    print_string(path);
+    printf(",\"success\":%s,\"wall_us\":%"PRId64, ret ? "false" : "true",
+           wall);
+
+    uintmax_t frames = stats->stages[VLC_RUN_STAGE_DECODE].frames;
+    double secs = wall > 0 ? wall / 1000000. : 0.;
+    printf(",\"decoded_frames\":%ju,\"decoded_pictures\":%ju,"
+           "\"fps\":%.2f", frames, stats->pictures,
+           secs > 0. ? stats->pictures / secs : 0.);
+
+    printf(",\"stages\":{");
+    for (size_t i = 0; i < VLC_RUN_STAGE_COUNT; i++)
+    {
+        struct vlc_run_stage_stats *st = &stats->stages[i];
+
+        printf("%s\"%s\":{\"calls\":%zu,\"frames\":%ju,\"total_us\":%"PRId64,
+               i ? "," : "", stage_names[i], st->calls, st->frames,
+               st->total);
+        if (st->calls > 0)
+        {
+            qsort(st->durations, st->calls, sizeof (*st->durations),
+                  cmp_duration);
+            printf(",\"p50_us\":%"PRId64",\"p90_us\":%"PRId64
+                   ",\"p99_us\":%"PRId64",\"max_us\":%"PRId64,
+                   percentile(st, 50), percentile(st, 90),
+                   percentile(st, 99), st->durations[st->calls - 1]);
+        }
+        putchar('}');
+    }
+    putchar('}');
+
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        printf(",\"peak_rss_kb\":%ld", ru.ru_maxrss);
+#endif
+    printf("}\n");
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    struct vlc_run_args args;
+    vlc_run_args_init(&args);
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: [VLC_TARGET=demux] %s <filename>...\n",
+                argv[0]);
+        return 1;
+    }
+
+    int ret = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        struct vlc_run_stats stats;
+
+        memset(&stats, 0, sizeof (stats));
+        args.stats = &stats;
+
+        int64_t start = vlc_run_stats_now();
+        int val = vlc_demux_process_path(&args, argv[i]);
+        int64_t wall = vlc_run_stats_now() - start;
+
+        print_report(argv[i], val, wall, &stats);
+        vlc_run_stats_clean(&stats);
+        if (val)
+            ret = 1;
+    }
+    return ret;
+}
@@ -0,0 +1,348 @@
+/**
+ * @file vlc-filter-bench.c
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Runs every video converter, and the common video filters, on synthetic
+ * pictures of each size and chroma, and prints one JSON object per
+ * combination that a module accepts.
+ *
+ * The SIMD variants built as separate plugins (i420_rgb_sse2...) are
+ * benchmarked as modules of their own, next to their C counterparts.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <inttypes.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc/vlc.h>
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_modules.h>
+#include <vlc_picture.h>
+#include "../lib/libvlc_internal.h"
+
+#define BENCH_DURATION VLC_TICK_FROM_MS(200)
+#define BENCH_MIN_FRAMES 8
+#define BENCH_MAX_FRAMES 1000
+
+static const struct
+{
+    unsigned width, height;
+} sizes[] = {
+    { 720, 576 },
+    { 1280, 720 },
+    { 1920, 1080 },
+};
+
+static const vlc_fourcc_t chromas[] = {
+    VLC_CODEC_I420, VLC_CODEC_I422, VLC_CODEC_I444, VLC_CODEC_NV12,
+    VLC_CODEC_YUYV, VLC_CODEC_UYVY, VLC_CODEC_GREY, VLC_CODEC_I420_10L,
+    VLC_CODEC_P010, VLC_CODEC_RGB16, VLC_CODEC_RGB24, VLC_CODEC_RGB32,
+    VLC_CODEC_RGBA, VLC_CODEC_BGRA,
+};
+
+static const char *const filters[] = {
+    "adjust", "gradfun", "hqdn3d", "sharpen",
+};
+
+static const char *const deinterlace_modes[] = {
+    "blend", "bob", "linear", "x", "yadif", "yadif2x", "phosphor", "ivtc",
+};
+
+static char **only; /* module names given on the command line */
+static int only_count;
+
+static bool Selected(const char *name)
+{
+    if (only_count == 0)
+        return true;
+    for (int i = 0; i < only_count; i++)
+        if (strcmp(only[i], name) == 0)
+            return true;
+    return false;
+}
+
+static uint32_t seed = 1;
+
+/* Gradient with some noise, so that the denoisers have work to do */
+static void FillPicture(picture_t *pic)
+{
+    const vlc_chroma_description_t *desc =
+        vlc_fourcc_GetChromaDescription(pic->format.i_chroma);
+    /* High bit depth samples must stay within their range */
+    const unsigned size = desc != NULL ? desc->pixel_size : 1;
+    const unsigned bits = size == 2 ? desc->pixel_bits : 8;
+    const unsigned shift = pic->format.i_chroma == VLC_CODEC_P010 ? 6 : 0;
+
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        plane_t *p = &pic->p[i];
+
+        for (int y = 0; y < p->i_visible_lines; y++)
+        {
+            uint8_t *line = &p->p_pixels[y * p->i_pitch];
+
+            for (int x = 0; x < p->i_visible_pitch / (int)size; x++)
+            {
+                seed = seed * 1103515245 + 12345;
+                unsigned v = (x + y + i * 64 + ((seed >> 16) & 15))
+                           & ((1u << bits) - 1);
+                if (size == 2)
+                    ((uint16_t *)line)[x] = v << shift;
+                else
+                    line[x] = v;
+            }
+        }
+    }
+}
+
+static void SetupFormat(es_format_t *fmt, vlc_fourcc_t chroma,
+                        unsigned width, unsigned height)
+{
+    es_format_Init(fmt, VIDEO_ES, chroma);
+    video_format_Setup(&fmt->video, chroma, width, height, width, height,
+                       1, 1);
+    video_format_FixRgb(&fmt->video);
+    fmt->video.i_frame_rate = 25;
+    fmt->video.i_frame_rate_base = 1;
+}
+
+static int cmp_tick(const void *a, const void *b)
+{
+    vlc_tick_t ta = *(const vlc_tick_t *)a, tb = *(const vlc_tick_t *)b;
+
+    return (ta > tb) - (ta < tb);
+}
+
+static void ReleaseChain(picture_t *pic)
+{
+    while (pic != NULL)
+    {
+        picture_t *next = pic->p_next;
+        picture_Release(pic);
+        pic = next;
+    }
+}
+
+/* Feeds the same source picture to an opened filter, and prints its speed */
+static void Bench(filter_t *filter, const char *kind, const char *name,
+                  const char *mode)
+{
+    const video_format_t *in = &filter->fmt_in.video;
+    const video_format_t *out = &filter->fmt_out.video;
+    picture_t *src = picture_NewFromFormat(in);
+    vlc_tick_t *durations = malloc(BENCH_MAX_FRAMES * sizeof (*durations));
+    if (src == NULL || durations == NULL)
+    {
+        if (src != NULL)
+            picture_Release(src);
+        free(durations);
+        return;
+    }
+    FillPicture(src);
+    src->b_progressive = mode == NULL;
+    src->b_top_field_first = true;
+    src->i_nb_fields = 2;
+
+    /* The first picture warms the caches and the lazy initialisations up */
+    vlc_tick_t date = VLC_TICK_0;
+    src->date = date;
+    ReleaseChain(filter->ops->filter_video(filter, picture_Hold(src)));
+
+    size_t frames = 0, outputs = 0;
+    vlc_tick_t total = 0;
+    while (frames < BENCH_MAX_FRAMES
+        && (frames < BENCH_MIN_FRAMES || total < BENCH_DURATION))
+    {
+        date += VLC_TICK_FROM_MS(40);
+        src->date = date;
+
+        vlc_tick_t start = vlc_tick_now();
+        picture_t *pic = filter->ops->filter_video(filter, picture_Hold(src));
+        vlc_tick_t duration = vlc_tick_now() - start;
+
+        for (picture_t *p = pic; p != NULL; p = p->p_next)
+            outputs++;
+        ReleaseChain(pic);
+        durations[frames++] = duration;
+        total += duration;
+    }
+    picture_Release(src);
+
+    qsort(durations, frames, sizeof (*durations), cmp_tick);
+
+    double secs = total > 0 ? secf_from_vlc_tick(total) : 0.;
+    printf("{\"kind\":\"%s\",\"module\":\"%s\"", kind, name);
+    if (mode != NULL)
+        printf(",\"mode\":\"%s\"", mode);
+    printf(",\"in\":\"%4.4s\",\"out\":\"%4.4s\",\"width\":%u,\"height\":%u,"
+           "\"out_width\":%u,\"out_height\":%u,\"frames\":%zu,"
+           "\"outputs\":%zu,\"fps\":%.1f,\"mpixels_per_s\":%.1f,"
+           "\"p50_us\":%"PRId64",\"max_us\":%"PRId64"}\n",
+           (const char *)&in->i_chroma, (const char *)&out->i_chroma,
+           in->i_visible_width, in->i_visible_height,
+           out->i_visible_width, out->i_visible_height, frames, outputs,
+           secs > 0. ? frames / secs : 0.,
+           secs > 0. ? (double)in->i_visible_width * in->i_visible_height
+                       * frames / secs / 1000000. : 0.,
+           US_FROM_VLC_TICK(durations[frames / 2]),
+           US_FROM_VLC_TICK(durations[frames - 1]));
+    fflush(stdout);
+    free(durations);
+}
+
+/* Opens one module by name, for one input and output format */
+static void Run(vlc_object_t *parent, const char *cap, const char *name,
+                const char *mode, const es_format_t *fmt_in,
+                const es_format_t *fmt_out)
+{
+    filter_t *filter = vlc_object_create(parent, sizeof (*filter));
+    if (filter == NULL)
+        return;
+
+    es_format_Copy(&filter->fmt_in, fmt_in);
+    es_format_Copy(&filter->fmt_out, fmt_out);
+    if (mode != NULL)
+    {
+        /* Read by config_ChainParse() when the filter opens */
+        var_Create(filter, "sout-deinterlace-mode", VLC_VAR_STRING);
+        var_SetString(filter, "sout-deinterlace-mode", mode);
+    }
+
+    module_t *module = module_need(filter, cap, name, true);
+    if (module != NULL)
+    {
+        Bench(filter, mode != NULL ? "deinterlace" : cap, name, mode);
+        filter_Close(filter);
+        module_unneed(filter, module);
+    }
+
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_delete(filter);
+}
+
+static void RunConverters(vlc_object_t *parent, module_t **modules,
+                          size_t count)
+{
+    for (size_t s = 0; s < ARRAY_SIZE(sizes); s++)
+        for (size_t i = 0; i < ARRAY_SIZE(chromas); i++)
+        {
+            es_format_t fmt_in;
+            SetupFormat(&fmt_in, chromas[i], sizes[s].width, sizes[s].height);
+
+            for (size_t m = 0; m < count; m++)
+            {
+                const char *name = module_get_object(modules[m]);
+
+                /* The chain converter only combines the other ones */
+                if (!module_provides(modules[m], "video converter")
+                 || strcmp(name, "chain") == 0 || !Selected(name))
+                    continue;
+
+                for (size_t o = 0; o < ARRAY_SIZE(chromas); o++)
+                {
+                    es_format_t fmt_out;
+
+                    if (o == i)
+                        continue;
+                    SetupFormat(&fmt_out, chromas[o], sizes[s].width,
+                                sizes[s].height);
+                    Run(parent, "video converter", name, NULL, &fmt_in,
+                        &fmt_out);
+                    es_format_Clean(&fmt_out);
+                }
+
+                /* Scaling down to the next smaller size */
+                if (s > 0)
+                {
+                    es_format_t fmt_out;
+
+                    SetupFormat(&fmt_out, chromas[i], sizes[s - 1].width,
+                                sizes[s - 1].height);
+                    Run(parent, "video converter", name, NULL, &fmt_in,
+                        &fmt_out);
+                    es_format_Clean(&fmt_out);
+                }
+            }
+            es_format_Clean(&fmt_in);
+        }
+}
+
+static void RunFilters(vlc_object_t *parent)
+{
+    for (size_t s = 0; s < ARRAY_SIZE(sizes); s++)
+        for (size_t i = 0; i < ARRAY_SIZE(chromas); i++)
+        {
+            es_format_t fmt;
+            SetupFormat(&fmt, chromas[i], sizes[s].width, sizes[s].height);
+
+            for (size_t f = 0; f < ARRAY_SIZE(filters); f++)
+                if (Selected(filters[f]))
+                    Run(parent, "video filter", filters[f], NULL, &fmt, &fmt);
+
+            if (Selected("deinterlace"))
+                for (size_t d = 0; d < ARRAY_SIZE(deinterlace_modes); d++)
+                    Run(parent, "video filter", "deinterlace",
+                        deinterlace_modes[d], &fmt, &fmt);
+            es_format_Clean(&fmt);
+        }
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef TOP_BUILDDIR
+    setenv("VLC_PLUGIN_PATH", TOP_BUILDDIR"/modules", 1);
+    setenv("VLC_DATA_PATH", TOP_SRCDIR"/share", 1);
+    setenv("VLC_LIB_PATH", TOP_BUILDDIR"/modules", 1);
+#endif
+    setlocale(LC_ALL, "C");
+
+    if (argc > 1 && argv[1][0] == '-')
+    {
+        fprintf(stderr, "Usage: %s [module]...\n", argv[0]);
+        return 1;
+    }
+    only = argv + 1;
+    only_count = argc - 1;
+
+    const char *const args[] = { "--verbose", "-1" };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *root = VLC_OBJECT(vlc->p_libvlc_int);
+    size_t count;
+    module_t **modules = module_list_get(&count);
+
+    RunConverters(root, modules, count);
+    RunFilters(root);
+
+    module_list_free(modules);
+    libvlc_release(vlc);
+    return 0;
+}